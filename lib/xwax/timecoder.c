@@ -413,12 +413,12 @@ static inline void update_monitor(struct timecoder *tc, signed int x, signed int
     /* Decay the pixels already in the montior */
 
     if (++tc->mon_counter % MONITOR_DECAY_EVERY == 0) {
+        unsigned char *mon = tc->mon;
         int p;
 
-        for (p = 0; p < SQ(size); p++) {
-            if (tc->mon[p])
-                tc->mon[p] = tc->mon[p] * 7 / 8;
-        }
+        /* Branch-free, so it is vectorized; zero pixels stay zero */
+        for (p = 0; p < SQ(size); p++)
+            mon[p] = mon[p] * 7 / 8;
     }
 
     assert(ref > 0);
@@ -489,11 +489,14 @@ static void process_bitstream(struct timecoder *tc, signed int m)
  * Process a single sample from the incoming audio
  *
  * The two input signals (primary and secondary) are in the full range
- * of a signed int; ie. 32-bit signed.
+ * of a signed int; ie. 32-bit signed. The flags and the position step dx
+ * of the timecode definition are passed in by timecoder_submit(), which
+ * evaluates them once per block.
  */
 
-static void process_sample(struct timecoder *tc,
-			   signed int primary, signed int secondary)
+static inline void process_sample(struct timecoder *tc,
+                                  signed int primary, signed int secondary,
+                                  unsigned int flags, double dx)
 {
     detect_zero_crossing(&tc->primary, primary, tc->zero_alpha, tc->threshold);
     detect_zero_crossing(&tc->secondary, secondary, tc->zero_alpha, tc->threshold);
@@ -510,7 +513,7 @@ static void process_sample(struct timecoder *tc,
             forwards = (tc->primary.positive == tc->secondary.positive);
         }
 
-        if (tc->def->flags & SWITCH_PHASE)
+        if (flags & SWITCH_PHASE)
 	    forwards = !forwards;
 
         if (forwards != tc->forwards) { /* direction has changed */
@@ -524,20 +527,14 @@ static void process_sample(struct timecoder *tc,
 
     if (!tc->primary.swapped && !tc->secondary.swapped)
 	pitch_dt_observation(&tc->pitch, 0.0);
-    else {
-	double dx;
-
-	dx = 1.0 / tc->def->resolution / 4;
-	if (!tc->forwards)
-	    dx = -dx;
-	pitch_dt_observation(&tc->pitch, dx);
-    }
+    else
+	pitch_dt_observation(&tc->pitch, tc->forwards ? dx : -dx);
 
     /* If we have crossed the primary channel in the right polarity,
      * it's time to read off a timecode 0 or 1 value */
 
     if (tc->secondary.swapped &&
-       tc->primary.positive == ((tc->def->flags & SWITCH_POLARITY) == 0))
+       tc->primary.positive == ((flags & SWITCH_POLARITY) == 0))
     {
         signed int m;
 
@@ -587,29 +584,53 @@ void timecoder_cycle_definition(struct timecoder *tc)
  * PCM data is in the full range of signed short; ie. 16-bit signed.
  */
 
-void timecoder_submit(struct timecoder *tc, signed short *pcm, size_t npcm)
+/*
+ * Decode a block with the channel assignment and the monitor fixed, so
+ * the compiler generates a loop without these branches for each of the
+ * constant combinations passed by timecoder_submit()
+ */
+
+static inline void submit_block(struct timecoder *tc, const signed short *pcm,
+                                size_t npcm, bool left_primary, bool monitor)
 {
+    const unsigned int flags = tc->def->flags;
+    const double dx = 1.0 / tc->def->resolution / 4;
+
     while (npcm--) {
-	signed int left, right, primary, secondary;
+	signed int left, right;
 
         left = pcm[0] << 16;
         right = pcm[1] << 16;
 
-        if (tc->def->flags & SWITCH_PRIMARY) {
-            primary = left;
-            secondary = right;
-        } else {
-            primary = right;
-            secondary = left;
-        }
+        if (left_primary)
+            process_sample(tc, left, right, flags, dx);
+        else
+            process_sample(tc, right, left, flags, dx);
 
-	process_sample(tc, primary, secondary);
-        update_monitor(tc, left, right);
+        if (monitor)
+            update_monitor(tc, left, right);
 
         pcm += TIMECODER_CHANNELS;
     }
 }
 
+void timecoder_submit(struct timecoder *tc, signed short *pcm, size_t npcm)
+{
+    const bool left_primary = (tc->def->flags & SWITCH_PRIMARY) != 0;
+
+    if (tc->mon) {
+        if (left_primary)
+            submit_block(tc, pcm, npcm, true, true);
+        else
+            submit_block(tc, pcm, npcm, false, true);
+    } else {
+        if (left_primary)
+            submit_block(tc, pcm, npcm, true, false);
+        else
+            submit_block(tc, pcm, npcm, false, false);
+    }
+}
+
 /*
  * Get the last-known position of the timecode
  *
@@ -65,6 +65,16 @@ declare namespace engine {
      */
     function setValue(group: string, name: string, newValue: number): void;
 
+    /**
+     * Sets the values of multiple controls of the same group at once. This is
+     * faster than calling setValue for each control.
+     *
+     * @param group Group of the controls e.g. "[Channel1]"
+     * @param values Object with the control names as keys and the values to be set,
+     *               e.g. {play_indicator: 1, cue_indicator: 0}
+     */
+    function setValues(group: string, values: {[name: string]: number}): void;
+
     /**
      * Gets the control value normalized to a range of 0..1
      *
@@ -20,6 +20,12 @@ uniform float lastVisualIndex;
 
 uniform sampler2D waveformDataTexture;
 
+// The maxima of 2^level visual frames, see Waveform::buildMaxLevels()
+uniform int maxLevelCount;
+uniform int maxLevelsTextureStride;
+uniform float maxLevelOffsets[24];
+uniform sampler2D waveformMaxLevelsTexture;
+
 vec4 getWaveformData(float index) {
     vec2 uv_data;
     uv_data.y = splitStereoSignal ? floor(index / float(textureStride)) : max(floor(index / float(textureStride)), floor((index + 1) / float(textureStride)));
@@ -28,6 +34,32 @@ vec4 getWaveformData(float index) {
     return texture2D(waveformDataTexture, uv_data / float(textureStride));
 }
 
+vec4 getMaxLevelData(float index) {
+    vec2 uv_data;
+    uv_data.y = floor(index / float(maxLevelsTextureStride));
+    uv_data.x = floor(index - uv_data.y * float(maxLevelsTextureStride));
+    // Divide again to convert to normalized UV coordinates.
+    return texture2D(waveformMaxLevelsTexture, uv_data / float(maxLevelsTextureStride));
+}
+
+// Samples the maxima of all visual frames that are covered by a pixel of
+// the frame buffer when zoomed out, so that no peaks are skipped.
+vec4 getMaxWaveformData(float index) {
+    float framesPerPixel = (lastVisualIndex - firstVisualIndex) / framebufferSize.x;
+    // The smallest blocks that are not smaller than a pixel
+    int level = int(min(ceil(log2(max(framesPerPixel, 1.0))), float(maxLevelCount)));
+    if (level <= 0) {
+        return getWaveformData(index);
+    }
+    float frame = floor(index / 2.0);
+    float channel = index - frame * 2.0;
+    float levelIndex = maxLevelOffsets[level - 1] + floor(frame / exp2(float(level))) * 2.0;
+    if (!splitStereoSignal) {
+        return max(getMaxLevelData(levelIndex), getMaxLevelData(levelIndex + 1.0));
+    }
+    return getMaxLevelData(levelIndex + channel);
+}
+
 void main(void) {
     vec2 uv = gl_TexCoord[0].st;
     vec4 pixel = gl_FragCoord;
@@ -51,7 +83,7 @@ void main(void) {
     // to show other things (e.g. the axes lines) even when we are on a pixel
     // that does not have valid waveform data.
     if (new_currentIndex >= 0 && new_currentIndex <= waveformLength - 1) {
-      vec4 new_currentDataUnscaled = getWaveformData(new_currentIndex) * allGain;
+      vec4 new_currentDataUnscaled = getMaxWaveformData(new_currentIndex) * allGain;
 
       vec4 new_currentData = new_currentDataUnscaled;
       new_currentData.x *= lowGain;
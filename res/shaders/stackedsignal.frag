@@ -22,6 +22,12 @@ uniform float lastVisualIndex;
 
 uniform sampler2D waveformDataTexture;
 
+// The maxima of 2^level visual frames, see Waveform::buildMaxLevels()
+uniform int maxLevelCount;
+uniform int maxLevelsTextureStride;
+uniform float maxLevelOffsets[24];
+uniform sampler2D waveformMaxLevelsTexture;
+
 vec4 getWaveformData(float index) {
     vec2 uv_data;
     uv_data.y = floor(index / float(textureStride));
@@ -30,6 +36,29 @@ vec4 getWaveformData(float index) {
     return texture2D(waveformDataTexture, uv_data / float(textureStride));
 }
 
+vec4 getMaxLevelData(float index) {
+    vec2 uv_data;
+    uv_data.y = floor(index / float(maxLevelsTextureStride));
+    uv_data.x = floor(index - uv_data.y * float(maxLevelsTextureStride));
+    // Divide again to convert to normalized UV coordinates.
+    return texture2D(waveformMaxLevelsTexture, uv_data / float(maxLevelsTextureStride));
+}
+
+// Samples the maxima of all visual frames that are covered by a pixel of
+// the frame buffer when zoomed out, so that no peaks are skipped.
+vec4 getMaxWaveformData(float index) {
+    float framesPerPixel = (lastVisualIndex - firstVisualIndex) / framebufferSize.x;
+    // The smallest blocks that are not smaller than a pixel
+    int level = int(min(ceil(log2(max(framesPerPixel, 1.0))), float(maxLevelCount)));
+    if (level <= 0) {
+        return getWaveformData(index);
+    }
+    float frame = floor(index / 2.0);
+    float channel = index - frame * 2.0;
+    float levelIndex = maxLevelOffsets[level - 1] + floor(frame / exp2(float(level))) * 2.0;
+    return getMaxLevelData(levelIndex + channel);
+}
+
 bool nearBorder(float target, float test, float epsilon) {
     float dist = target - test;
     return (abs(dist) <= epsilon && dist > 0);
@@ -66,7 +95,7 @@ void main(void) {
         // waveform height, re-scale the maximum height to 1.
         const float scaleFactor = 1.0 / sqrt(3.0);
 
-        vec4 new_currentDataUnscaled = getWaveformData(new_currentIndex) * allGain;
+        vec4 new_currentDataUnscaled = getMaxWaveformData(new_currentIndex) * allGain;
         new_currentDataUnscaled.x *= scaleFactor;
         new_currentDataUnscaled.y *= scaleFactor;
         new_currentDataUnscaled.z *= scaleFactor;
@@ -4,6 +4,7 @@
 #include "audio/signalinfo.h"
 #include "audio/types.h"
 #include "util/assert.h"
+#include "util/indexrange.h"
 #include "util/types.h"
 
 /*
@@ -16,6 +17,8 @@
 
 #include "track/track_decl.h"
 
+class AnalyzerSpectrum;
+
 class Analyzer {
   public:
     virtual ~Analyzer() = default;
@@ -29,6 +32,56 @@ class Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) = 0;
 
+    // Analyzers that don't need the full bandwidth and the stereo image of
+    // the signal, e.g. for detecting the beats or the key, might accept a
+    // mono signal that has been decimated by AnalyzerDecimator instead.
+    virtual bool acceptsDecimatedSignal() const {
+        return false;
+    }
+
+    // Invoked instead of initialize() if the decimated signal is accepted.
+    // The sample rate and the frame length are those of the original
+    // signal. Frame positions of the received samples must be multiplied
+    // by the decimation factor.
+    virtual bool initializeDecimated(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength,
+            int decimationFactor) {
+        Q_UNUSED(track);
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(frameLength);
+        Q_UNUSED(decimationFactor);
+        DEBUG_ASSERT(!"The decimated signal is not accepted");
+        return false;
+    }
+
+    // Analyzers that process short-time spectra of the received signal
+    // might subscribe to a shared AnalyzerSpectrum instead of computing
+    // their own transforms. Invoked by the host after initialization.
+    virtual void subscribeSpectrum(AnalyzerSpectrum* pSpectrum) {
+        Q_UNUSED(pSpectrum);
+    }
+
+    // Analyzers might publish a coarse preview from a few short excerpts
+    // of the track that are decoded by seeking before all samples are
+    // processed in order. Only requested for tracks with the option
+    // previewWaveform after initialization.
+    virtual bool wantsPreview() const {
+        return false;
+    }
+
+    // The excerpt starts at the first frame of the range that it represents.
+    // Excerpts are passed in order and followed by a single finishPreview().
+    virtual void processPreviewExcerpt(
+            mixxx::IndexRange frameRange, const CSAMPLE* pIn, SINT count) {
+        Q_UNUSED(frameRange);
+        Q_UNUSED(pIn);
+        Q_UNUSED(count);
+    }
+
+    virtual void finishPreview() {
+    }
+
     // Analyze the next chunk of audio samples and return true if successful.
     // If processing fails the analysis can be aborted early by returning
     // false. After aborting the analysis only cleanup() will be invoked,
@@ -75,6 +128,40 @@ class AnalyzerWithState final {
         return m_active = m_analyzer->initialize(track, sampleRate, channelCount, frameLength);
     }
 
+    bool acceptsDecimatedSignal() const {
+        return m_analyzer->acceptsDecimatedSignal();
+    }
+
+    bool initializeDecimated(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength,
+            int decimationFactor) {
+        DEBUG_ASSERT(!m_active);
+        return m_active = m_analyzer->initializeDecimated(
+                track, sampleRate, frameLength, decimationFactor);
+    }
+
+    void subscribeSpectrum(AnalyzerSpectrum* pSpectrum) {
+        if (m_active) {
+            m_analyzer->subscribeSpectrum(pSpectrum);
+        }
+    }
+
+    bool wantsPreview() const {
+        return m_active && m_analyzer->wantsPreview();
+    }
+
+    void processPreviewExcerpt(
+            mixxx::IndexRange frameRange, const CSAMPLE* pIn, SINT count) {
+        DEBUG_ASSERT(m_active);
+        m_analyzer->processPreviewExcerpt(frameRange, pIn, count);
+    }
+
+    void finishPreview() {
+        DEBUG_ASSERT(m_active);
+        m_analyzer->finishPreview();
+    }
+
     void processSamples(const CSAMPLE* pIn, const int count) {
         if (m_active) {
             m_active = m_analyzer->processSamples(pIn, count);
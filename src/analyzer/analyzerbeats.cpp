@@ -4,6 +4,9 @@
 #include <QString>
 #include <QVector>
 #include <QtDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
@@ -12,6 +15,59 @@
 #include "library/rekordbox/rekordboxconstants.h"
 #include "track/beatfactory.h"
 #include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+// Long enough for a stable tempo estimate of the verification pass
+constexpr SINT kVerificationSecondsToAnalyze = 30;
+// The verification needs a few beats for a robust comparison
+constexpr int kMinVerificationBeats = 16;
+constexpr double kBpmTolerance = 0.5;
+constexpr double kPhaseToleranceSeconds = 0.025;
+// The beats from the BPM tag only share a phase with the detected beats if
+// the tag BPM is accurate over the whole verification pass
+constexpr double kMinPhaseCoherence = 0.9;
+
+/// The BPM of the median beat length of the detected beats
+mixxx::Bpm medianBpm(const QVector<mixxx::audio::FramePos>& beats,
+        mixxx::audio::SampleRate sampleRate) {
+    if (beats.size() < 2) {
+        return mixxx::Bpm();
+    }
+    QVector<double> beatLengths;
+    beatLengths.reserve(beats.size() - 1);
+    for (int i = 1; i < beats.size(); ++i) {
+        beatLengths.append(beats[i] - beats[i - 1]);
+    }
+    const auto median = beatLengths.begin() + beatLengths.size() / 2;
+    std::nth_element(beatLengths.begin(), median, beatLengths.end());
+    if (*median <= 0) {
+        return mixxx::Bpm();
+    }
+    return mixxx::Bpm(60.0 * sampleRate / *median);
+}
+
+/// The median distance of the detected beats to the closest imported beat
+double medianDistanceToBeats(const QVector<mixxx::audio::FramePos>& beats,
+        const mixxx::Beats& importedBeats) {
+    QVector<double> distances;
+    distances.reserve(beats.size());
+    for (const auto& beat : beats) {
+        const auto closestBeat = importedBeats.findClosestBeat(beat);
+        if (closestBeat.isValid()) {
+            distances.append(std::abs(beat - closestBeat));
+        }
+    }
+    if (distances.isEmpty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+    const auto median = distances.begin() + distances.size() / 2;
+    std::nth_element(distances.begin(), median, distances.end());
+    return *median;
+}
+
+} // namespace
 
 // static
 QList<mixxx::AnalyzerPluginInfo> AnalyzerBeats::availablePlugins() {
@@ -36,14 +92,53 @@ AnalyzerBeats::AnalyzerBeats(UserSettingsPointer pConfig, bool enforceBpmDetecti
           m_bPreferencesReanalyzeImported(false),
           m_bPreferencesFixedTempo(true),
           m_bPreferencesFastAnalysis(false),
+          m_decimationFactor(1),
           m_maxFramesToProcess(0),
-          m_currentFrame(0) {
+          m_currentFrame(0),
+          m_verificationFrames(0),
+          m_bImportedBeatsVerified(false) {
+}
+
+mixxx::AnalyzerPluginInfo AnalyzerBeats::configuredPlugin() const {
+    const QString pluginId = m_bpmSettings.getBeatPluginId();
+    const auto plugins = availablePlugins();
+    for (const auto& info : plugins) {
+        if (info.id() == pluginId) {
+            return info; // configured Plug-In available
+        }
+    }
+    return defaultPlugin();
 }
 
 bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
         mixxx::audio::SampleRate sampleRate,
         mixxx::audio::ChannelCount channelCount,
         SINT frameLength) {
+    return initializeInternal(track, sampleRate, channelCount, frameLength, 1);
+}
+
+bool AnalyzerBeats::acceptsDecimatedSignal() const {
+    return configuredPlugin().isMonoInputSupported();
+}
+
+bool AnalyzerBeats::initializeDecimated(const AnalyzerTrack& track,
+        mixxx::audio::SampleRate sampleRate,
+        SINT frameLength,
+        int decimationFactor) {
+    DEBUG_ASSERT(decimationFactor > 1);
+    DEBUG_ASSERT(sampleRate % decimationFactor == 0);
+    return initializeInternal(track,
+            mixxx::audio::SampleRate(sampleRate / decimationFactor),
+            mixxx::audio::ChannelCount::mono(),
+            (frameLength + decimationFactor - 1) / decimationFactor,
+            decimationFactor);
+}
+
+bool AnalyzerBeats::initializeInternal(const AnalyzerTrack& track,
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount channelCount,
+        SINT frameLength,
+        int decimationFactor) {
     if (frameLength <= 0) {
         return false;
     }
@@ -67,17 +162,7 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
     m_bPreferencesReanalyzeImported = m_bpmSettings.getReanalyzeImported();
     m_bPreferencesFastAnalysis = m_bpmSettings.getFastAnalysis();
 
-    const auto plugins = availablePlugins();
-    if (!plugins.isEmpty()) {
-        m_pluginId = defaultPlugin().id();
-        QString pluginId = m_bpmSettings.getBeatPluginId();
-        for (const auto& info : plugins) {
-            if (info.id() == pluginId) {
-                m_pluginId = pluginId; // configured Plug-In available
-                break;
-            }
-        }
-    }
+    m_pluginId = configuredPlugin().id();
 
     qDebug() << "AnalyzerBeats preference settings:"
              << "\nPlugin:" << m_pluginId
@@ -88,6 +173,7 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
 
     m_sampleRate = sampleRate;
     m_channelCount = channelCount;
+    m_decimationFactor = decimationFactor;
     // In fast analysis mode, skip processing after
     // kFastAnalysisSecondsToAnalyze seconds are analyzed.
     if (m_bPreferencesFastAnalysis) {
@@ -103,31 +189,77 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
 
     DEBUG_ASSERT(!m_pPlugin);
     if (bShouldAnalyze) {
-        if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
-        } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
+        m_pPlugin = createPlugin();
+        if (m_pPlugin) {
+            qDebug() << "Beat calculation started with plugin" << m_pluginId;
         } else {
-            // This must not happen, because we have already verified above
-            // that the PlugInId is valid
-            DEBUG_ASSERT(false);
+            qDebug() << "Beat calculation will not start.";
+            bShouldAnalyze = false;
         }
+    }
 
-        if (m_pPlugin) {
-            if (m_pPlugin->initialize(m_sampleRate)) {
-                qDebug() << "Beat calculation started with plugin" << m_pluginId;
-            } else {
-                qDebug() << "Beat calculation will not start.";
-                m_pPlugin.reset();
-                bShouldAnalyze = false;
+    // Beats that have been imported from other software or created from
+    // the BPM tag are verified first, which is much faster than the full
+    // detection if they are correct. Beats from a previous analysis are
+    // analyzed again with the current settings.
+    DEBUG_ASSERT(!m_pVerificationPlugin);
+    m_pImportedBeats.reset();
+    m_pVerifiedBeats.reset();
+    m_bImportedBeatsVerified = false;
+    m_verificationFrames = kVerificationSecondsToAnalyze * m_sampleRate;
+    const mixxx::BeatsPointer pBeats = track.getTrack()->getBeats();
+    if (bShouldAnalyze && pBeats && !m_bPreferencesFastAnalysis &&
+            m_verificationFrames < frameLength) {
+        const QString subVersion = pBeats->getSubVersion();
+        const bool fromBpmTag = subVersion.isEmpty() &&
+                pBeats->firstBeat() <= mixxx::audio::kStartFramePos;
+        const bool imported = subVersion.isEmpty() ||
+                subVersion == mixxx::rekordboxconstants::beatsSubversion;
+        // Only beat tracking finds the phase of the beats from the BPM tag
+        if (imported &&
+                (!fromBpmTag ||
+                        (m_pPlugin->supportsBeatTracking() &&
+                                m_bPreferencesFixedTempo))) {
+            m_pVerificationPlugin = createPlugin();
+            if (m_pVerificationPlugin) {
+                m_pImportedBeats = pBeats;
             }
-        } else {
-            bShouldAnalyze = false;
         }
     }
     return bShouldAnalyze;
 }
 
+std::unique_ptr<mixxx::AnalyzerBeatsPlugin> AnalyzerBeats::createPlugin() const {
+    std::unique_ptr<mixxx::AnalyzerBeatsPlugin> pPlugin;
+    if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
+        pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
+    } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
+        pPlugin = std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
+    } else {
+        // This must not happen, because we have already verified
+        // that the PlugInId is valid
+        DEBUG_ASSERT(false);
+        return nullptr;
+    }
+    if (!pPlugin->initialize(m_sampleRate)) {
+        return nullptr;
+    }
+    return pPlugin;
+}
+
+void AnalyzerBeats::subscribeSpectrum(AnalyzerSpectrum* pSpectrum) {
+    VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
+        return;
+    }
+    // The spectrum of the stems is not shared
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+        return;
+    }
+    if (m_pPlugin->subscribeSpectrum(pSpectrum)) {
+        qDebug() << "Beat calculation uses the shared spectrum";
+    }
+}
+
 bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
     bool bpmLock = pTrack->isBpmLocked();
     if (bpmLock) {
@@ -197,6 +329,9 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
+    if (m_bImportedBeatsVerified) {
+        return true; // silently ignore all remaining samples
+    }
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
@@ -236,18 +371,122 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
         return true; // silently ignore all remaining samples
     }
 
-    bool ret = m_pPlugin->processSamples(pBeatInput, count);
+    bool ret = m_channelCount == mixxx::audio::ChannelCount::mono()
+            ? m_pPlugin->processMonoSamples(pBeatInput, count)
+            : m_pPlugin->processSamples(pBeatInput, count);
+    if (ret && m_pVerificationPlugin && numFrames > 0) {
+        const SINT firstFrame = m_currentFrame - numFrames;
+        const SINT verificationCount = std::min(numFrames, m_verificationFrames - firstFrame) *
+                (count / numFrames);
+        ret = m_channelCount == mixxx::audio::ChannelCount::mono()
+                ? m_pVerificationPlugin->processMonoSamples(pBeatInput, verificationCount)
+                : m_pVerificationPlugin->processSamples(pBeatInput, verificationCount);
+        if (ret && m_currentFrame >= m_verificationFrames) {
+            m_bImportedBeatsVerified = verifyImportedBeats();
+            m_pVerificationPlugin.reset();
+            if (m_bImportedBeatsVerified) {
+                m_pPlugin.reset();
+            }
+        }
+    }
     if (pDrumChannel) {
         SampleUtil::free(pDrumChannel);
     }
     return ret;
 }
 
+bool AnalyzerBeats::verifyImportedBeats() {
+    DEBUG_ASSERT(m_pImportedBeats);
+    if (!m_pVerificationPlugin->finalize()) {
+        return false;
+    }
+    // The beats refer to the original signal
+    const auto sampleRate = mixxx::audio::SampleRate(m_sampleRate * m_decimationFactor);
+    const auto verificationEnd = mixxx::audio::FramePos(
+            static_cast<double>(m_verificationFrames) * m_decimationFactor);
+    QVector<mixxx::audio::FramePos> beats;
+    mixxx::Bpm bpm;
+    if (m_pVerificationPlugin->supportsBeatTracking()) {
+        beats = m_pVerificationPlugin->getBeats();
+        if (beats.size() < kMinVerificationBeats) {
+            return false;
+        }
+        if (m_decimationFactor > 1) {
+            for (auto& beat : beats) {
+                beat *= m_decimationFactor;
+            }
+        }
+        bpm = medianBpm(beats, sampleRate);
+    } else {
+        bpm = m_pVerificationPlugin->getBpm();
+    }
+    const mixxx::Bpm importedBpm = m_pImportedBeats->getBpmInRange(
+            mixxx::audio::kStartFramePos, verificationEnd);
+    if (!bpm.isValid() || !importedBpm.isValid() ||
+            std::abs(bpm.value() - importedBpm.value()) > kBpmTolerance) {
+        qDebug() << "Imported BPM" << importedBpm << "differs from the detected BPM"
+                 << bpm << "- analyzing the whole track";
+        return false;
+    }
+
+    const bool fromBpmTag = m_pImportedBeats->getSubVersion().isEmpty() &&
+            m_pImportedBeats->firstBeat() <= mixxx::audio::kStartFramePos;
+    if (!fromBpmTag) {
+        if (!beats.isEmpty() &&
+                medianDistanceToBeats(beats, *m_pImportedBeats) >
+                        kPhaseToleranceSeconds * sampleRate) {
+            qDebug() << "Imported beats are not aligned with the detected beats"
+                     << "- analyzing the whole track";
+            return false;
+        }
+        qDebug() << "Imported beats verified, keeping them";
+        return true;
+    }
+
+    // The phase of the detected beats, averaged on the circle of the tag
+    // BPM beat length
+    const double beatLength = 60.0 * sampleRate / importedBpm.value();
+    double sumSin = 0;
+    double sumCos = 0;
+    for (const auto& beat : std::as_const(beats)) {
+        const double angle = 2 * M_PI * std::fmod(beat.value(), beatLength) / beatLength;
+        sumSin += std::sin(angle);
+        sumCos += std::cos(angle);
+    }
+    const double coherence = std::hypot(sumSin, sumCos) / beats.size();
+    if (coherence < kMinPhaseCoherence) {
+        qDebug() << "Tag BPM" << importedBpm << "drifts from the detected beats"
+                 << "- analyzing the whole track";
+        return false;
+    }
+    double firstBeat = std::atan2(sumSin, sumCos) / (2 * M_PI) * beatLength;
+    if (firstBeat < 0) {
+        firstBeat += beatLength;
+    }
+    qDebug() << "Tag BPM" << importedBpm << "verified, first beat at" << firstBeat;
+    m_pVerifiedBeats = mixxx::Beats::fromConstTempo(sampleRate,
+            mixxx::audio::FramePos(firstBeat),
+            importedBpm,
+            BeatFactory::getPreferredSubVersion(
+                    getExtraVersionInfo(m_pluginId, m_bPreferencesFastAnalysis)));
+    return true;
+}
+
 void AnalyzerBeats::cleanup() {
     m_pPlugin.reset();
+    m_pVerificationPlugin.reset();
+    m_pImportedBeats.reset();
+    m_pVerifiedBeats.reset();
+    m_bImportedBeatsVerified = false;
 }
 
 void AnalyzerBeats::storeResults(TrackPointer pTrack) {
+    if (m_bImportedBeatsVerified) {
+        if (m_pVerifiedBeats) {
+            pTrack->trySetBeats(m_pVerifiedBeats);
+        }
+        return;
+    }
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return;
     }
@@ -257,16 +496,23 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
         return;
     }
 
+    // The beats refer to the original signal
+    const auto sampleRate = mixxx::audio::SampleRate(m_sampleRate * m_decimationFactor);
     mixxx::BeatsPointer pBeats;
     if (m_pPlugin->supportsBeatTracking()) {
         QVector<mixxx::audio::FramePos> beats = m_pPlugin->getBeats();
+        if (m_decimationFactor > 1) {
+            for (auto& beat : beats) {
+                beat *= m_decimationFactor;
+            }
+        }
         QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
                 m_pluginId, m_bPreferencesFastAnalysis);
         pBeats = BeatFactory::makePreferredBeats(
                 beats,
                 extraVersionInfo,
                 m_bPreferencesFixedTempo,
-                m_sampleRate);
+                sampleRate);
         qDebug() << "AnalyzerBeats plugin detected" << beats.size()
                  << "beats. Predominant BPM:"
                  << (pBeats ? pBeats->getBpmInRange(
@@ -278,7 +524,7 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
     } else {
         mixxx::Bpm bpm = m_pPlugin->getBpm();
         qDebug() << "AnalyzerBeats plugin detected constant BPM: " << bpm;
-        pBeats = mixxx::Beats::fromConstTempo(m_sampleRate, mixxx::audio::kStartFramePos, bpm);
+        pBeats = mixxx::Beats::fromConstTempo(sampleRate, mixxx::audio::kStartFramePos, bpm);
     }
 
     pTrack->trySetBeats(pBeats);
@@ -8,6 +8,7 @@
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/beatdetectionsettings.h"
 #include "preferences/usersettings.h"
+#include "track/beats.h"
 
 class AnalyzerBeats : public Analyzer {
   public:
@@ -23,12 +24,27 @@ class AnalyzerBeats : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
+    bool acceptsDecimatedSignal() const override;
+    bool initializeDecimated(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength,
+            int decimationFactor) override;
+    void subscribeSpectrum(AnalyzerSpectrum* pSpectrum) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
+    mixxx::AnalyzerPluginInfo configuredPlugin() const;
+    // The sample rate, channel count and frame length of the received signal
+    bool initializeInternal(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT frameLength,
+            int decimationFactor);
     bool shouldAnalyze(TrackPointer pTrack) const;
+    std::unique_ptr<mixxx::AnalyzerBeatsPlugin> createPlugin() const;
+    bool verifyImportedBeats();
     static QHash<QString, QString> getExtraVersionInfo(
             const QString& pluginId, bool bPreferencesFastAnalysis);
 
@@ -43,6 +59,19 @@ class AnalyzerBeats : public Analyzer {
 
     mixxx::audio::SampleRate m_sampleRate;
     mixxx::audio::ChannelCount m_channelCount;
+    // The received signal has been decimated by this factor
+    int m_decimationFactor;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
+
+    // Imported beats, or beats from the BPM tag, that are verified by a
+    // detection pass over the first m_verificationFrames frames. The full
+    // detection is only continued if they disagree.
+    mixxx::BeatsPointer m_pImportedBeats;
+    std::unique_ptr<mixxx::AnalyzerBeatsPlugin> m_pVerificationPlugin;
+    SINT m_verificationFrames;
+    bool m_bImportedBeatsVerified;
+    // The grid that replaces the beats from the BPM tag, null if the
+    // imported beats are kept unmodified
+    mixxx::BeatsPointer m_pVerifiedBeats;
 };
@@ -0,0 +1,260 @@
+#include "analyzer/analyzerdecimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "analyzer/constants.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalyzerDecimator");
+
+// The number of zero crossings of the windowed sinc on each side
+// of the kernel. Together with the Blackman window this suppresses
+// aliasing by more than 70 dB.
+constexpr SINT kKernelZeroCrossings = 16;
+
+// The cutoff frequency relative to the Nyquist frequency of the
+// decimated signal. All analyzers only look at much lower frequencies.
+constexpr double kCutoff = 0.8;
+
+// The kernel is padded with zeros to a multiple of this length
+constexpr SINT kKernelLanes = 8;
+
+// The independent partial sums allow the compiler to vectorize the loop
+// without reordering the additions, i.e. without -ffast-math.
+CSAMPLE dotProduct(const CSAMPLE* pIn, const CSAMPLE* pKernel, SINT length) {
+    DEBUG_ASSERT(length % kKernelLanes == 0);
+    CSAMPLE sums[kKernelLanes] = {};
+    for (SINT i = 0; i < length; i += kKernelLanes) {
+        for (SINT j = 0; j < kKernelLanes; ++j) {
+            sums[j] += pIn[i + j] * pKernel[i + j];
+        }
+    }
+    CSAMPLE sum = 0;
+    for (SINT j = 0; j < kKernelLanes; ++j) {
+        sum += sums[j];
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+AnalyzerDecimator::AnalyzerDecimator(std::vector<AnalyzerPtr> analyzers)
+        : m_decimatedSignal(analyzers.size(), false),
+          m_decimationFactor(1),
+          m_halfKernelLength(0),
+          m_inputLength(0),
+          m_inputFrameCount(0),
+          m_outputCount(0) {
+    m_analyzers.reserve(analyzers.size());
+    for (auto& pAnalyzer : analyzers) {
+        m_analyzers.emplace_back(std::move(pAnalyzer));
+    }
+}
+
+AnalyzerDecimator::~AnalyzerDecimator() = default;
+
+// static
+int AnalyzerDecimator::decimationFactor(
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount channelCount) {
+    // The analyzers mix the stems themselves
+    if (channelCount != mixxx::audio::ChannelCount::stereo() ||
+            sampleRate <= kMaxUndecimatedSampleRate) {
+        return 1;
+    }
+    int factor = 1;
+    while (factor < kMaxDecimationFactor &&
+            sampleRate % (factor * 2) == 0 &&
+            sampleRate / (factor * 2) >= kMinDecimatedSampleRate) {
+        factor *= 2;
+    }
+    return factor;
+}
+
+bool AnalyzerDecimator::initialize(const AnalyzerTrack& track,
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount channelCount,
+        SINT frameLength) {
+    m_decimationFactor = decimationFactor(sampleRate, channelCount);
+    m_spectrum.reset();
+    m_decimatedSpectrum.reset();
+    bool active = false;
+    for (std::size_t i = 0; i < m_analyzers.size(); ++i) {
+        auto& analyzer = m_analyzers[i];
+        m_decimatedSignal[i] = m_decimationFactor > 1 &&
+                analyzer.acceptsDecimatedSignal();
+        // Make sure not to short-circuit initialize(...)
+        if (m_decimatedSignal[i]
+                        ? analyzer.initializeDecimated(
+                                  track, sampleRate, frameLength, m_decimationFactor)
+                        : analyzer.initialize(
+                                  track, sampleRate, channelCount, frameLength)) {
+            active = true;
+        }
+        analyzer.subscribeSpectrum(
+                m_decimatedSignal[i] ? &m_decimatedSpectrum : &m_spectrum);
+    }
+    if (isDecimating()) {
+        kLogger.debug()
+                << "Decimating signal from"
+                << sampleRate
+                << "by factor"
+                << m_decimationFactor;
+        initializeFilter();
+    }
+    return active;
+}
+
+void AnalyzerDecimator::initializeFilter() {
+    DEBUG_ASSERT(m_decimationFactor > 1);
+    m_halfKernelLength = kKernelZeroCrossings * m_decimationFactor;
+    const SINT kernelLength = 2 * m_halfKernelLength + 1;
+    const SINT paddedKernelLength =
+            (kernelLength + kKernelLanes - 1) / kKernelLanes * kKernelLanes;
+
+    // Windowed sinc low-pass filter, normalized to unity gain
+    const double cutoff = kCutoff / m_decimationFactor;
+    m_kernel.assign(paddedKernelLength, 0);
+    double sum = 0;
+    for (SINT i = 0; i < kernelLength; ++i) {
+        const double x = M_PI * cutoff * (i - m_halfKernelLength);
+        const double sinc = x == 0 ? 1 : std::sin(x) / x;
+        const double phase = 2 * M_PI * i / (kernelLength - 1);
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2 * phase);
+        const double value = sinc * window;
+        m_kernel[i] = static_cast<CSAMPLE>(value);
+        sum += value;
+    }
+    for (auto& value : m_kernel) {
+        value = static_cast<CSAMPLE>(value / sum);
+    }
+
+    m_input = mixxx::SampleBuffer(paddedKernelLength + mixxx::kAnalysisFramesPerChunk);
+    m_output = mixxx::SampleBuffer(
+            mixxx::kAnalysisFramesPerChunk / m_decimationFactor + paddedKernelLength);
+    // The center of the kernel is aligned with the first frame
+    m_input.clear(m_halfKernelLength);
+    m_inputLength = m_halfKernelLength;
+    m_inputFrameCount = 0;
+    m_outputCount = 0;
+}
+
+bool AnalyzerDecimator::processSamples(const CSAMPLE* pIn, SINT count) {
+    for (std::size_t i = 0; i < m_analyzers.size(); ++i) {
+        if (!m_decimatedSignal[i]) {
+            m_analyzers[i].processSamples(pIn, count);
+        }
+    }
+    if (m_spectrum.hasSubscribers()) {
+        m_spectrum.processStereoSamples(pIn, count);
+    }
+    if (isDecimating()) {
+        const SINT numFrames = count / mixxx::kAnalysisChannels;
+        m_inputFrameCount += numFrames;
+        // Only a single slice unless invoked with more than a chunk
+        for (SINT offset = 0; offset < numFrames;) {
+            const SINT sliceFrames = math_min(
+                    numFrames - offset, mixxx::kAnalysisFramesPerChunk);
+            appendDownmix(pIn + offset * mixxx::kAnalysisChannels, sliceFrames);
+            decimate(m_output.size());
+            offset += sliceFrames;
+        }
+    }
+    return isActive();
+}
+
+void AnalyzerDecimator::appendDownmix(const CSAMPLE* pIn, SINT numFrames) {
+    DEBUG_ASSERT(m_inputLength + numFrames <= m_input.size());
+    CSAMPLE* pInput = m_input.data() + m_inputLength;
+    if (pIn) {
+        // The same downmix as DownmixAndOverlapHelper
+        for (SINT i = 0; i < numFrames; ++i) {
+            pInput[i] = (pIn[i * 2] + pIn[i * 2 + 1]) * 0.5f;
+        }
+    } else {
+        SampleUtil::clear(pInput, numFrames);
+    }
+    m_inputLength += numFrames;
+}
+
+void AnalyzerDecimator::decimate(SINT maxCount) {
+    const auto kernelLength = static_cast<SINT>(m_kernel.size());
+    CSAMPLE* pOutput = m_output.data();
+    SINT count = 0;
+    SINT start = 0;
+    // Only every m_decimationFactor-th sample of the filtered signal is
+    // computed, which is equivalent to a polyphase decimator.
+    while (start + kernelLength <= m_inputLength && count < maxCount) {
+        DEBUG_ASSERT(count < m_output.size());
+        pOutput[count++] = dotProduct(m_input.data() + start, m_kernel.data(), kernelLength);
+        start += m_decimationFactor;
+    }
+    // Keep the remaining input for the next output samples
+    std::copy(m_input.data() + start, m_input.data() + m_inputLength, m_input.data());
+    m_inputLength -= start;
+    m_outputCount += count;
+
+    if (count > 0) {
+        for (std::size_t i = 0; i < m_analyzers.size(); ++i) {
+            if (m_decimatedSignal[i]) {
+                m_analyzers[i].processSamples(pOutput, count);
+            }
+        }
+        if (m_decimatedSpectrum.hasSubscribers()) {
+            m_decimatedSpectrum.processMonoSamples(pOutput, count);
+        }
+    }
+}
+
+void AnalyzerDecimator::flush() {
+    const SINT totalCount =
+            (m_inputFrameCount + m_decimationFactor - 1) / m_decimationFactor;
+    while (m_outputCount < totalCount && isDecimating()) {
+        appendDownmix(nullptr, m_input.size() - m_inputLength);
+        decimate(totalCount - m_outputCount);
+    }
+}
+
+void AnalyzerDecimator::storeResults(TrackPointer pTrack) {
+    if (isDecimating()) {
+        flush();
+    }
+    m_spectrum.finalize();
+    m_decimatedSpectrum.finalize();
+    const AnalyzerTrack track(pTrack);
+    for (auto& analyzer : m_analyzers) {
+        analyzer.finish(track);
+    }
+}
+
+void AnalyzerDecimator::cleanup() {
+    for (auto& analyzer : m_analyzers) {
+        analyzer.cancel();
+    }
+    m_kernel.clear();
+    m_input = mixxx::SampleBuffer();
+    m_output = mixxx::SampleBuffer();
+    m_inputLength = 0;
+}
+
+bool AnalyzerDecimator::isActive() const {
+    return std::any_of(m_analyzers.begin(),
+            m_analyzers.end(),
+            [](const AnalyzerWithState& analyzer) {
+                return analyzer.isActive();
+            });
+}
+
+bool AnalyzerDecimator::isDecimating() const {
+    for (std::size_t i = 0; i < m_analyzers.size(); ++i) {
+        if (m_decimatedSignal[i] && m_analyzers[i].isActive()) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "analyzer/analyzerspectrum.h"
+#include "util/samplebuffer.h"
+
+/// Downmixes and decimates the signal once for all analyzers that don't
+/// need the full bandwidth, e.g. for detecting the beats or the key.
+///
+/// Analyzers that don't accept the decimated signal receive the original
+/// samples. Only stereo signals with a high resolution are decimated
+/// to a sample rate of at least kMinDecimatedSampleRate. The common
+/// sample rates of 44.1 and 48 kHz are passed through unmodified to
+/// get the same results as before.
+///
+/// The short-time spectra of both signals are computed once by a shared
+/// AnalyzerSpectrum for all analyzers that subscribe to them.
+///
+/// All analyzers are run sequentially, i.e. on the same worker of an
+/// AnalyzerPipeline.
+class AnalyzerDecimator : public Analyzer {
+  public:
+    static constexpr mixxx::audio::SampleRate::value_t kMinDecimatedSampleRate = 22050;
+    static constexpr mixxx::audio::SampleRate::value_t kMaxUndecimatedSampleRate = 48000;
+    static constexpr int kMaxDecimationFactor = 8;
+
+    explicit AnalyzerDecimator(std::vector<AnalyzerPtr> analyzers);
+    ~AnalyzerDecimator() override;
+
+    /// Returns 1 if the signal should not be decimated.
+    static int decimationFactor(
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount);
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT frameLength) override;
+    bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    void storeResults(TrackPointer pTrack) override;
+    void cleanup() override;
+
+  private:
+    void initializeFilter();
+
+    /// Downmixes the stereo samples and appends them to the input of
+    /// the filter, or silence if pIn is null.
+    void appendDownmix(const CSAMPLE* pIn, SINT numFrames);
+
+    /// Filters the buffered input and passes the decimated samples on
+    /// to the analyzers, at most maxCount.
+    void decimate(SINT maxCount);
+
+    /// Appends silence until the decimated signal is complete.
+    void flush();
+
+    bool isActive() const;
+    bool isDecimating() const;
+
+    // Declared before the analyzers that outlive their subscriptions
+    AnalyzerSpectrum m_spectrum;
+    AnalyzerSpectrum m_decimatedSpectrum;
+
+    std::vector<AnalyzerWithState> m_analyzers;
+    // Whether the analyzer at the same index receives the decimated signal
+    std::vector<bool> m_decimatedSignal;
+
+    int m_decimationFactor;
+    // The number of input samples on each side of the symmetric
+    // filter kernel, i.e. the filter delay
+    SINT m_halfKernelLength;
+    std::vector<CSAMPLE> m_kernel;
+    // The buffered mono input that starts at the first sample
+    // of the kernel for the next output sample
+    mixxx::SampleBuffer m_input;
+    SINT m_inputLength;
+    mixxx::SampleBuffer m_output;
+    // The number of frames of the original signal and the number
+    // of decimated samples for aligning the end of both signals
+    SINT m_inputFrameCount;
+    SINT m_outputCount;
+};
@@ -0,0 +1,110 @@
+#include "analyzer/analyzerfingerprint.h"
+
+#include <algorithm>
+
+#include "analyzer/analyzertrack.h"
+#include "library/library_prefs.h"
+#include "musicbrainz/chromaprinter.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalyzerFingerprint");
+
+} // anonymous namespace
+
+AnalyzerFingerprint::AnalyzerFingerprint(UserSettingsPointer pConfig)
+        : m_pConfig(pConfig),
+          m_pContext(nullptr),
+          m_remainingFrames(0) {
+}
+
+AnalyzerFingerprint::~AnalyzerFingerprint() {
+    cleanup();
+}
+
+// static
+bool AnalyzerFingerprint::isEnabled(UserSettingsPointer pConfig) {
+    return pConfig->getValue(
+            mixxx::library::prefs::kTagFetcherAnalyzeFingerprintConfigKey,
+            mixxx::library::prefs::kTagFetcherAnalyzeFingerprintDefault);
+}
+
+bool AnalyzerFingerprint::initialize(const AnalyzerTrack& track,
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount channelCount,
+        SINT frameLength) {
+    if (!track.getTrack()->getFingerprint().isEmpty()) {
+        // Only calculated once, the audio signal doesn't change
+        return false;
+    }
+    if (frameLength <= 0) {
+        return false;
+    }
+    DEBUG_ASSERT(!m_pContext);
+    m_pContext = chromaprint_new(CHROMAPRINT_ALGORITHM_DEFAULT);
+    // Stems are mixed down to stereo like by ChromaPrinter
+    if (!chromaprint_start(m_pContext,
+                static_cast<int>(sampleRate),
+                mixxx::audio::ChannelCount::stereo())) {
+        kLogger.warning() << "Failed to start fingerprinting";
+        cleanup();
+        return false;
+    }
+    m_channelCount = channelCount;
+    m_remainingFrames = std::min<SINT>(frameLength,
+            ChromaPrinter::kFingerprintDurationSeconds * sampleRate.value());
+    return true;
+}
+
+bool AnalyzerFingerprint::processSamples(const CSAMPLE* pIn, SINT count) {
+    if (m_remainingFrames <= 0) {
+        // The rest of the track is not needed
+        return true;
+    }
+    const SINT numFrames = std::min(count / m_channelCount, m_remainingFrames);
+    const SINT stereoCount = numFrames * mixxx::audio::ChannelCount::stereo();
+    const CSAMPLE* pStereo = pIn;
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+        if (stereoCount > static_cast<SINT>(m_stereoBuffer.size())) {
+            m_stereoBuffer.resize(stereoCount);
+        }
+        SampleUtil::mixMultichannelToStereo(
+                m_stereoBuffer.data(), pIn, numFrames, m_channelCount);
+        pStereo = m_stereoBuffer.data();
+    }
+    if (stereoCount > static_cast<SINT>(m_intBuffer.size())) {
+        m_intBuffer.resize(stereoCount);
+    }
+    SampleUtil::convertFloat32ToS16(m_intBuffer.data(), pStereo, stereoCount);
+    if (!chromaprint_feed(m_pContext, m_intBuffer.data(), static_cast<int>(stereoCount))) {
+        kLogger.warning() << "Failed to generate fingerprint from sample data";
+        return false;
+    }
+    m_remainingFrames -= numFrames;
+    return true;
+}
+
+void AnalyzerFingerprint::storeResults(TrackPointer pTrack) {
+    VERIFY_OR_DEBUG_ASSERT(m_pContext) {
+        return;
+    }
+    if (!chromaprint_finish(m_pContext)) {
+        kLogger.warning() << "Failed to finish fingerprint";
+        return;
+    }
+    const QString fingerprint = ChromaPrinter::encodeFingerprint(m_pContext);
+    if (!fingerprint.isEmpty()) {
+        pTrack->setFingerprint(fingerprint);
+    }
+}
+
+void AnalyzerFingerprint::cleanup() {
+    if (m_pContext) {
+        chromaprint_free(m_pContext);
+        m_pContext = nullptr;
+    }
+    m_remainingFrames = 0;
+}
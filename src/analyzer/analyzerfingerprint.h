@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chromaprint.h>
+
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "preferences/usersettings.h"
+
+/// Calculates the Chromaprint fingerprint of the beginning of a track
+/// from the decoded samples of the analysis, so the tag fetcher doesn't
+/// need to decode the file again for looking it up through AcoustID.
+///
+/// The fingerprint is the same as the one calculated by ChromaPrinter.
+/// Chromaprint downmixes and resamples the signal itself.
+class AnalyzerFingerprint : public Analyzer {
+  public:
+    explicit AnalyzerFingerprint(UserSettingsPointer pConfig);
+    ~AnalyzerFingerprint() override;
+
+    static bool isEnabled(UserSettingsPointer pConfig);
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT frameLength) override;
+    bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    void storeResults(TrackPointer pTrack) override;
+    void cleanup() override;
+
+  private:
+    UserSettingsPointer m_pConfig;
+    ChromaprintContext* m_pContext;
+    mixxx::audio::ChannelCount m_channelCount;
+    // The number of frames that are fingerprinted
+    SINT m_remainingFrames;
+    std::vector<CSAMPLE> m_stereoBuffer;
+    std::vector<SAMPLE> m_intBuffer;
+};
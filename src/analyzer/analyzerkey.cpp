@@ -1,6 +1,7 @@
 #include "analyzer/analyzerkey.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
@@ -10,10 +11,19 @@
 #include "analyzer/plugins/analyzerqueenmarykey.h"
 #include "proto/keys.pb.h"
 #include "track/keyfactory.h"
+#include "track/keyutils.h"
 #include "track/track.h"
+#include "util/math.h"
 
 namespace {
 constexpr int excludeFirstChannelMask = 0x1;
+
+// Segment analysis: the number and the length of the windows that are spread
+// over the track. Tracks that are too short for these to save much time
+// are analyzed completely.
+constexpr int kSegmentCount = 3;
+constexpr SINT kSegmentSeconds = 30;
+constexpr int kMinSegmentCoverageFactor = 2;
 } // namespace
 
 // static
@@ -37,18 +47,60 @@ mixxx::AnalyzerPluginInfo AnalyzerKey::defaultPlugin() {
 AnalyzerKey::AnalyzerKey(const KeyDetectionSettings& keySettings)
         : m_keySettings(keySettings),
           m_sampleRate(0),
+          m_decimationFactor(1),
           m_totalFrames(0),
           m_maxFramesToProcess(0),
           m_currentFrame(0),
+          m_segmentIndex(0),
+          m_segmentKey(mixxx::track::io::key::INVALID),
+          m_pluginStartFrame(0),
+          m_bSegmentsAgree(false),
           m_bPreferencesKeyDetectionEnabled(true),
           m_bPreferencesFastAnalysisEnabled(false),
+          m_bPreferencesSegmentAnalysisEnabled(false),
           m_bPreferencesReanalyzeEnabled(false) {
 }
 
+mixxx::AnalyzerPluginInfo AnalyzerKey::configuredPlugin() const {
+    const QString pluginId = m_keySettings.getKeyPluginId();
+    const auto plugins = availablePlugins();
+    for (const auto& info : plugins) {
+        if (info.id() == pluginId) {
+            return info; // configured Plug-In available
+        }
+    }
+    return defaultPlugin();
+}
+
 bool AnalyzerKey::initialize(const AnalyzerTrack& track,
         mixxx::audio::SampleRate sampleRate,
         mixxx::audio::ChannelCount channelCount,
         SINT frameLength) {
+    return initializeInternal(track, sampleRate, channelCount, frameLength, 1);
+}
+
+bool AnalyzerKey::acceptsDecimatedSignal() const {
+    return configuredPlugin().isMonoInputSupported();
+}
+
+bool AnalyzerKey::initializeDecimated(const AnalyzerTrack& track,
+        mixxx::audio::SampleRate sampleRate,
+        SINT frameLength,
+        int decimationFactor) {
+    DEBUG_ASSERT(decimationFactor > 1);
+    DEBUG_ASSERT(sampleRate % decimationFactor == 0);
+    return initializeInternal(track,
+            mixxx::audio::SampleRate(sampleRate / decimationFactor),
+            mixxx::audio::ChannelCount::mono(),
+            (frameLength + decimationFactor - 1) / decimationFactor,
+            decimationFactor);
+}
+
+bool AnalyzerKey::initializeInternal(const AnalyzerTrack& track,
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount channelCount,
+        SINT frameLength,
+        int decimationFactor) {
     if (frameLength <= 0) {
         return false;
     }
@@ -60,27 +112,22 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
     }
 
     m_bPreferencesFastAnalysisEnabled = m_keySettings.getFastAnalysis();
+    // Fast analysis only analyzes the beginning of the track anyway
+    m_bPreferencesSegmentAnalysisEnabled =
+            !m_bPreferencesFastAnalysisEnabled && m_keySettings.getSegmentAnalysis();
     m_bPreferencesReanalyzeEnabled = m_keySettings.getReanalyzeWhenSettingsChange();
 
-    const auto plugins = availablePlugins();
-    if (!plugins.isEmpty()) {
-        m_pluginId = defaultPlugin().id();
-        QString pluginId = m_keySettings.getKeyPluginId();
-        for (const auto& info : plugins) {
-            if (info.id() == pluginId) {
-                m_pluginId = pluginId; // configured Plug-In available
-                break;
-            }
-        }
-    }
+    m_pluginId = configuredPlugin().id();
 
     qDebug() << "AnalyzerKey preference settings:"
              << "\nPlugin:" << m_pluginId
              << "\nRe-analyze when settings change:" << m_bPreferencesReanalyzeEnabled
-             << "\nFast analysis:" << m_bPreferencesFastAnalysisEnabled;
+             << "\nFast analysis:" << m_bPreferencesFastAnalysisEnabled
+             << "\nSegment analysis:" << m_bPreferencesSegmentAnalysisEnabled;
 
     m_sampleRate = sampleRate;
     m_channelCount = channelCount;
+    m_decimationFactor = decimationFactor;
     m_totalFrames = frameLength;
     // In fast analysis mode, skip processing after
     // kFastAnalysisSecondsToAnalyze seconds are analyzed.
@@ -94,35 +141,89 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
     // if we can't load a stored track reanalyze it
     bool bShouldAnalyze = shouldAnalyze(track.getTrack());
 
-    DEBUG_ASSERT(!m_pPlugin);
-    if (bShouldAnalyze) {
-        if (m_pluginId == mixxx::AnalyzerQueenMaryKey::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryKey>();
-#if defined __KEYFINDER__
-        } else if (m_pluginId == mixxx::AnalyzerKeyFinder::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerKeyFinder>();
-#endif
-        } else {
-            // This must not happen, because we have already verified above
-            // that the PlugInId is valid
-            DEBUG_ASSERT(false);
+    m_segments.clear();
+    m_segmentIndex = 0;
+    m_segmentKey = mixxx::track::io::key::INVALID;
+    m_segmentKeyChanges.clear();
+    m_pluginStartFrame = 0;
+    m_bSegmentsAgree = false;
+    if (bShouldAnalyze && m_bPreferencesSegmentAnalysisEnabled) {
+        m_segments = selectSegments(*track.getTrack());
+        if (!m_segments.isEmpty()) {
+            m_pluginStartFrame = m_segments.first().startFrame;
         }
+    }
 
+    DEBUG_ASSERT(!m_pPlugin);
+    if (bShouldAnalyze) {
+        m_pPlugin = createPlugin();
         if (m_pPlugin) {
-            if (m_pPlugin->initialize(mixxx::audio::SampleRate(m_sampleRate))) {
-                qDebug() << "Key calculation started with plugin" << m_pluginId;
-            } else {
-                qDebug() << "Key calculation will not start.";
-                m_pPlugin.reset();
-                bShouldAnalyze = false;
-            }
+            qDebug() << "Key calculation started with plugin" << m_pluginId;
         } else {
+            qDebug() << "Key calculation will not start.";
             bShouldAnalyze = false;
         }
     }
     return bShouldAnalyze;
 }
 
+std::unique_ptr<mixxx::AnalyzerKeyPlugin> AnalyzerKey::createPlugin() const {
+    std::unique_ptr<mixxx::AnalyzerKeyPlugin> pPlugin;
+    if (m_pluginId == mixxx::AnalyzerQueenMaryKey::pluginInfo().id()) {
+        pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryKey>();
+#if defined __KEYFINDER__
+    } else if (m_pluginId == mixxx::AnalyzerKeyFinder::pluginInfo().id()) {
+        pPlugin = std::make_unique<mixxx::AnalyzerKeyFinder>();
+#endif
+    } else {
+        // This must not happen, because we have already verified
+        // that the PlugInId is valid
+        DEBUG_ASSERT(false);
+        return nullptr;
+    }
+    if (!pPlugin->initialize(mixxx::audio::SampleRate(m_sampleRate))) {
+        return nullptr;
+    }
+    return pPlugin;
+}
+
+QList<AnalyzerKey::Segment> AnalyzerKey::selectSegments(const Track& track) const {
+    // The segments are spread between the intro start and the outro end,
+    // which are placed at the first and the last sound by the silence
+    // analyzer. Without these the silence at the start and the end of the
+    // track is not excluded.
+    SINT firstFrame = 0;
+    SINT lastFrame = m_totalFrames;
+    const CuePointer pIntroCue = track.findCueByType(mixxx::CueType::Intro);
+    if (pIntroCue && pIntroCue->getPosition().isValid()) {
+        firstFrame = math_clamp(static_cast<SINT>(pIntroCue->getPosition().value()) /
+                        m_decimationFactor,
+                static_cast<SINT>(0),
+                m_totalFrames);
+    }
+    const CuePointer pOutroCue = track.findCueByType(mixxx::CueType::Outro);
+    if (pOutroCue && pOutroCue->getEndPosition().isValid()) {
+        lastFrame = math_clamp(static_cast<SINT>(pOutroCue->getEndPosition().value()) /
+                        m_decimationFactor,
+                firstFrame,
+                m_totalFrames);
+    }
+
+    const SINT segmentFrames = kSegmentSeconds * m_sampleRate;
+    const SINT regionFrames = lastFrame - firstFrame;
+    if (regionFrames < kMinSegmentCoverageFactor * kSegmentCount * segmentFrames) {
+        return {};
+    }
+    // Centered in equal parts of the region, so the segments don't overlap
+    QList<Segment> segments;
+    for (int i = 0; i < kSegmentCount; ++i) {
+        const SINT center = firstFrame + regionFrames * (2 * i + 1) / (2 * kSegmentCount);
+        const SINT startFrame = center - segmentFrames / 2;
+        segments.append(Segment{startFrame, startFrame + segmentFrames});
+    }
+    return segments;
+}
+
 bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
     bool bPreferencesFastAnalysisEnabled = m_keySettings.getFastAnalysis();
     QString pluginID = m_keySettings.getKeyPluginId();
@@ -135,8 +236,9 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
         QString version = keys.getVersion();
         QString subVersion = keys.getSubVersion();
 
-        QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
-                pluginID, bPreferencesFastAnalysisEnabled);
+        QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(pluginID,
+                bPreferencesFastAnalysisEnabled,
+                !bPreferencesFastAnalysisEnabled && m_keySettings.getSegmentAnalysis());
         QString newVersion = KeyFactory::getPreferredVersion();
         QString newSubVersion = KeyFactory::getPreferredSubVersion(extraVersionInfo);
 
@@ -157,16 +259,23 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
+    if (m_bSegmentsAgree) {
+        return true; // silently ignore remaining samples
+    }
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
 
-    SINT numFrames = count / m_channelCount;
+    const SINT numFrames = count / m_channelCount;
+    const SINT firstFrame = m_currentFrame;
     m_currentFrame += numFrames;
 
     if (m_currentFrame > m_maxFramesToProcess) {
         return true; // silently ignore remaining samples
     }
+    if (!m_segments.isEmpty() && m_currentFrame <= m_segments[m_segmentIndex].startFrame) {
+        return true; // skip the signal before the next segment
+    }
 
     const CSAMPLE* pKeyInput = pIn;
     CSAMPLE* pHarmonicMixedChannel = nullptr;
@@ -178,8 +287,8 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
         //
         // For NI STEM we mix all the stems together except the first one,
         // which contains drums or beats by convention.
-        count = numFrames * mixxx::audio::ChannelCount::stereo();
-        pHarmonicMixedChannel = SampleUtil::alloc(count);
+        pHarmonicMixedChannel = SampleUtil::alloc(
+                numFrames * mixxx::audio::ChannelCount::stereo());
         VERIFY_OR_DEBUG_ASSERT(pHarmonicMixedChannel) {
             return false;
         }
@@ -201,42 +310,137 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
         return false;
     }
 
-    bool ret = m_pPlugin->processSamples(pKeyInput, count);
+    const int inputChannels = pHarmonicMixedChannel
+            ? mixxx::audio::ChannelCount::stereo()
+            : static_cast<int>(m_channelCount);
+    bool ret = true;
+    SINT frame = firstFrame;
+    while (ret && frame < m_currentFrame) {
+        SINT endFrame = m_currentFrame;
+        if (!m_segments.isEmpty()) {
+            const Segment& segment = m_segments[m_segmentIndex];
+            if (frame < segment.startFrame) {
+                frame = std::min(segment.startFrame, m_currentFrame);
+                continue;
+            }
+            endFrame = std::min(segment.endFrame, m_currentFrame);
+        }
+        ret = feedPlugin(pKeyInput + (frame - firstFrame) * inputChannels,
+                endFrame - frame);
+        frame = endFrame;
+        if (ret && !m_segments.isEmpty() && frame >= m_segments[m_segmentIndex].endFrame) {
+            ret = finishSegment();
+            if (m_bSegmentsAgree) {
+                break;
+            }
+        }
+    }
     if (pHarmonicMixedChannel) {
         SampleUtil::free(pHarmonicMixedChannel);
     }
     return ret;
 }
 
+bool AnalyzerKey::feedPlugin(const CSAMPLE* pIn, SINT numFrames) {
+    if (m_channelCount == mixxx::audio::ChannelCount::mono()) {
+        return m_pPlugin->processMonoSamples(pIn, numFrames);
+    }
+    return m_pPlugin->processSamples(pIn, numFrames * mixxx::audio::ChannelCount::stereo());
+}
+
+bool AnalyzerKey::finishSegment() {
+    DEBUG_ASSERT(m_segmentIndex < m_segments.size());
+    const Segment segment = m_segments[m_segmentIndex];
+    if (!m_pPlugin->finalize()) {
+        qWarning() << "Key detection of segment" << m_segmentIndex << "failed";
+        return false;
+    }
+    KeyChangeList keyChanges = m_pPlugin->getKeyChanges();
+    const auto segmentKey = KeyUtils::calculateGlobalKey(keyChanges,
+            segment.endFrame - segment.startFrame,
+            m_sampleRate);
+    for (auto& keyChange : keyChanges) {
+        keyChange.second += segment.startFrame;
+    }
+    m_segmentKeyChanges.append(keyChanges);
+
+    if (m_segmentIndex == 0 || segmentKey == m_segmentKey) {
+        m_segmentKey = segmentKey;
+        ++m_segmentIndex;
+        if (m_segmentIndex == m_segments.size()) {
+            qDebug() << "Key detection segments agree on"
+                     << KeyUtils::keyDebugName(m_segmentKey);
+            m_bSegmentsAgree = true;
+            m_pPlugin.reset();
+            return true;
+        }
+        m_pluginStartFrame = m_segments[m_segmentIndex].startFrame;
+    } else {
+        // The track has already been decoded up to here, so only the
+        // remainder is analyzed completely
+        qDebug() << "Key detection segments disagree, analyzing the remaining track";
+        m_segments.clear();
+        m_pluginStartFrame = segment.endFrame;
+    }
+    m_pPlugin = createPlugin();
+    return m_pPlugin != nullptr;
+}
+
 void AnalyzerKey::cleanup() {
     m_pPlugin.reset();
+    m_segments.clear();
+    m_segmentKeyChanges.clear();
 }
 
 void AnalyzerKey::storeResults(TrackPointer tio) {
-    VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
-        return;
+    KeyChangeList key_changes;
+    if (m_bSegmentsAgree) {
+        key_changes.append(qMakePair(m_segmentKey, 0.0));
+    } else {
+        VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
+            return;
+        }
+        key_changes = m_segmentKeyChanges;
+        // Fails if the track has ended before the segment has been reached
+        if (m_pPlugin->finalize()) {
+            for (auto keyChange : m_pPlugin->getKeyChanges()) {
+                keyChange.second += m_pluginStartFrame;
+                key_changes.append(keyChange);
+            }
+        }
+        if (key_changes.isEmpty()) {
+            qWarning() << "Key detection failed";
+            return;
+        }
     }
-
-    if (!m_pPlugin->finalize()) {
-        qWarning() << "Key detection failed";
-        return;
+    // The key changes refer to the original signal
+    if (m_decimationFactor > 1) {
+        for (auto& keyChange : key_changes) {
+            keyChange.second *= m_decimationFactor;
+        }
     }
-
-    KeyChangeList key_changes = m_pPlugin->getKeyChanges();
-    QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
-            m_pluginId, m_bPreferencesFastAnalysisEnabled);
-    Keys track_keys = KeyFactory::makePreferredKeys(
-            key_changes, extraVersionInfo, m_sampleRate, m_totalFrames);
+    QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(m_pluginId,
+            m_bPreferencesFastAnalysisEnabled,
+            m_bPreferencesSegmentAnalysisEnabled);
+    Keys track_keys = KeyFactory::makePreferredKeys(key_changes,
+            extraVersionInfo,
+            mixxx::audio::SampleRate(m_sampleRate * m_decimationFactor),
+            m_totalFrames * m_decimationFactor);
     tio->setKeys(track_keys);
 }
 
 // static
 QHash<QString, QString> AnalyzerKey::getExtraVersionInfo(
-        const QString& pluginId, bool bPreferencesFastAnalysis) {
+        const QString& pluginId,
+        bool bPreferencesFastAnalysis,
+        bool bPreferencesSegmentAnalysis) {
     QHash<QString, QString> extraVersionInfo;
     extraVersionInfo["vamp_plugin_id"] = pluginId;
     if (bPreferencesFastAnalysis) {
         extraVersionInfo["fast_analysis"] = "1";
     }
+    if (bPreferencesSegmentAnalysis) {
+        extraVersionInfo["segment_analysis"] = "1";
+    }
     return extraVersionInfo;
 }
@@ -8,6 +8,7 @@
 #include "analyzer/analyzer.h"
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/keydetectionsettings.h"
+#include "track/keys.h"
 #include "track/track_decl.h"
 
 class AnalyzerKey : public Analyzer {
@@ -22,26 +23,66 @@ class AnalyzerKey : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
+    bool acceptsDecimatedSignal() const override;
+    bool initializeDecimated(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength,
+            int decimationFactor) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
+    // A window of the received signal in segment analysis mode
+    struct Segment {
+        SINT startFrame;
+        SINT endFrame;
+    };
+
     static QHash<QString, QString> getExtraVersionInfo(
-            const QString& pluginId, bool bPreferencesFastAnalysis);
+            const QString& pluginId,
+            bool bPreferencesFastAnalysis,
+            bool bPreferencesSegmentAnalysis);
 
+    mixxx::AnalyzerPluginInfo configuredPlugin() const;
+    // The sample rate, channel count and frame length of the received signal
+    bool initializeInternal(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT frameLength,
+            int decimationFactor);
     bool shouldAnalyze(TrackPointer tio) const;
+    std::unique_ptr<mixxx::AnalyzerKeyPlugin> createPlugin() const;
+    QList<Segment> selectSegments(const Track& track) const;
+    bool feedPlugin(const CSAMPLE* pIn, SINT numFrames);
+    bool finishSegment();
 
     KeyDetectionSettings m_keySettings;
     std::unique_ptr<mixxx::AnalyzerKeyPlugin> m_pPlugin;
     QString m_pluginId;
     mixxx::audio::SampleRate m_sampleRate;
     mixxx::audio::ChannelCount m_channelCount;
+    // The received signal has been decimated by this factor
+    int m_decimationFactor;
     SINT m_totalFrames;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
 
+    // Segment analysis analyzes the segments with a fresh plugin each until
+    // one of them disagrees about the key. The remainder of the track is
+    // then analyzed by a single plugin and the segments are cleared.
+    QList<Segment> m_segments;
+    int m_segmentIndex;
+    mixxx::track::io::key::ChromaticKey m_segmentKey;
+    // The key changes of the finished segments in received frames
+    KeyChangeList m_segmentKeyChanges;
+    // The frame from which the current plugin receives the signal
+    SINT m_pluginStartFrame;
+    // All segments agree about the key
+    bool m_bSegmentsAgree;
+
     bool m_bPreferencesKeyDetectionEnabled;
     bool m_bPreferencesFastAnalysisEnabled;
+    bool m_bPreferencesSegmentAnalysisEnabled;
     bool m_bPreferencesReanalyzeEnabled;
 };
@@ -0,0 +1,140 @@
+#include "analyzer/analyzerloudness.h"
+
+#include <replaygain.h>
+
+#include <QtDebug>
+
+#include "analyzer/analyzertrack.h"
+#include "analyzer/loudnessmeter.h"
+#include "track/track.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/timer.h"
+
+namespace {
+
+constexpr double kReplayGain2ReferenceLUFS = -18;
+
+// lib/replaygain expects samples in the range of 16-bit integers
+constexpr CSAMPLE kReplayGain1InputGain = 32767;
+
+} // anonymous namespace
+
+AnalyzerLoudness::AnalyzerLoudness(UserSettingsPointer pConfig)
+        : m_rgSettings(pConfig),
+          m_version(0) {
+}
+
+AnalyzerLoudness::~AnalyzerLoudness() = default;
+
+bool AnalyzerLoudness::initialize(const AnalyzerTrack& track,
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount channelCount,
+        SINT frameLength) {
+    m_version = m_rgSettings.getReplayGainAnalyzerVersion();
+    if (m_rgSettings.isAnalyzerDisabled(m_version, track.getTrack()) || frameLength <= 0) {
+        qDebug() << "Skipping AnalyzerLoudness";
+        return false;
+    }
+    VERIFY_OR_DEBUG_ASSERT(channelCount % mixxx::audio::ChannelCount::stereo() == 0) {
+        return false;
+    }
+    m_channelCount = channelCount;
+    if (m_version == 1) {
+        if (!m_pReplayGain) {
+            m_pReplayGain = std::make_unique<ReplayGain>();
+        }
+        if (!m_pReplayGain->initialise(sampleRate, mixxx::audio::ChannelCount::stereo())) {
+            qWarning() << "ReplayGain 1.0 analysis does not support a sample rate of"
+                       << sampleRate;
+            return false;
+        }
+    }
+    m_pLoudnessMeter = std::make_unique<LoudnessMeter>(sampleRate);
+    return true;
+}
+
+void AnalyzerLoudness::cleanup() {
+    m_pLoudnessMeter.reset();
+}
+
+bool AnalyzerLoudness::processSamples(const CSAMPLE* pIn, SINT count) {
+    VERIFY_OR_DEBUG_ASSERT(m_pLoudnessMeter) {
+        return false;
+    }
+    ScopedTimer t(QStringLiteral("AnalyzerLoudness::processSamples()"));
+    const SINT numFrames = count / m_channelCount;
+    const CSAMPLE* pStereo = pIn;
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+        // All stems are mixed together, like for playing the track
+        const SINT stereoCount = numFrames * mixxx::audio::ChannelCount::stereo();
+        if (stereoCount > static_cast<SINT>(m_stereoBuffer.size())) {
+            m_stereoBuffer.resize(stereoCount);
+        }
+        SampleUtil::mixMultichannelToStereo(
+                m_stereoBuffer.data(), pIn, numFrames, m_channelCount);
+        pStereo = m_stereoBuffer.data();
+    }
+    m_pLoudnessMeter->processStereoSamples(
+            pStereo, numFrames * mixxx::audio::ChannelCount::stereo());
+    if (m_version == 1) {
+        return processReplayGain1(pStereo, numFrames);
+    }
+    return true;
+}
+
+bool AnalyzerLoudness::processReplayGain1(const CSAMPLE* pIn, SINT numFrames) {
+    DEBUG_ASSERT(m_pReplayGain);
+    if (numFrames > static_cast<SINT>(m_leftBuffer.size())) {
+        m_leftBuffer.resize(numFrames);
+        m_rightBuffer.resize(numFrames);
+    }
+    SampleUtil::deinterleaveBuffer(m_leftBuffer.data(),
+            m_rightBuffer.data(),
+            pIn,
+            numFrames);
+    SampleUtil::applyGain(m_leftBuffer.data(), kReplayGain1InputGain, numFrames);
+    SampleUtil::applyGain(m_rightBuffer.data(), kReplayGain1InputGain, numFrames);
+    return m_pReplayGain->process(
+            m_leftBuffer.data(), m_rightBuffer.data(), numFrames);
+}
+
+std::optional<double> AnalyzerLoudness::replayGain1() {
+    DEBUG_ASSERT(m_pReplayGain);
+    const float gain = m_pReplayGain->end();
+    if (gain == GAIN_NOT_ENOUGH_SAMPLES) {
+        qWarning() << "ReplayGain 1.0 analysis failed";
+        return std::nullopt;
+    }
+    return gain;
+}
+
+std::optional<double> AnalyzerLoudness::replayGain2() const {
+    const double averageLufs = m_pLoudnessMeter->integratedLoudness();
+    // This catches 0 and the abnormal values for silent or very short tracks
+    if (!util_isnormal(averageLufs)) {
+        qWarning() << "ReplayGain 2.0 analysis failed: integrated loudness is"
+                   << averageLufs;
+        return std::nullopt;
+    }
+    return kReplayGain2ReferenceLUFS - averageLufs;
+}
+
+void AnalyzerLoudness::storeResults(TrackPointer pTrack) {
+    VERIFY_OR_DEBUG_ASSERT(m_pLoudnessMeter) {
+        return;
+    }
+    m_pLoudnessMeter->finalize();
+    const auto gain = m_version == 1 ? replayGain1() : replayGain2();
+    if (!gain) {
+        return;
+    }
+
+    mixxx::ReplayGain replayGain(pTrack->getReplayGain());
+    replayGain.setRatio(db2ratio(*gain));
+    replayGain.setPeak(m_pLoudnessMeter->truePeak());
+    pTrack->setReplayGain(replayGain);
+    qDebug() << "ReplayGain" << m_version << "result is" << *gain
+             << "dB with a true peak of" << m_pLoudnessMeter->truePeak()
+             << "for" << pTrack->getLocation();
+}
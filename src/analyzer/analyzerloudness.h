@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "preferences/replaygainsettings.h"
+
+class LoudnessMeter;
+class ReplayGain;
+
+/// Computes the ReplayGain of the selected version and the true peak of a
+/// track in a single pass.
+///
+/// ReplayGain 2.0 is derived from the integrated loudness according to
+/// EBU R128, ReplayGain 1.0 from the equal loudness filter of lib/replaygain.
+/// Multi-channel signals, i.e. stems, are mixed down to stereo once for
+/// all measurements.
+class AnalyzerLoudness : public Analyzer {
+  public:
+    explicit AnalyzerLoudness(UserSettingsPointer pConfig);
+    ~AnalyzerLoudness() override;
+
+    static bool isEnabled(const ReplayGainSettings& rgSettings) {
+        return rgSettings.getReplayGainAnalyzerEnabled();
+    }
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT frameLength) override;
+    bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    void storeResults(TrackPointer pTrack) override;
+    void cleanup() override;
+
+  private:
+    bool processReplayGain1(const CSAMPLE* pIn, SINT numFrames);
+
+    /// Returns the gain in dB or std::nullopt if undefined.
+    std::optional<double> replayGain1();
+    std::optional<double> replayGain2() const;
+
+    ReplayGainSettings m_rgSettings;
+    int m_version;
+    mixxx::audio::ChannelCount m_channelCount;
+    std::vector<CSAMPLE> m_stereoBuffer;
+    std::vector<CSAMPLE> m_leftBuffer;
+    std::vector<CSAMPLE> m_rightBuffer;
+    std::unique_ptr<LoudnessMeter> m_pLoudnessMeter;
+    std::unique_ptr<ReplayGain> m_pReplayGain;
+};
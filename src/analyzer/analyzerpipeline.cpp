@@ -0,0 +1,166 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/performancetimer.h"
+#include "util/realtime.h"
+
+class AnalyzerPipeline::Worker : public QThread {
+  public:
+    Worker(AnalyzerPipeline* pPipeline, int index)
+            : m_pPipeline(pPipeline),
+              m_index(index) {
+        setObjectName(QStringLiteral("AnalyzerPipeline %1").arg(index));
+    }
+
+  private:
+    void run() override {
+        m_pPipeline->runWorker(m_index);
+    }
+
+    AnalyzerPipeline* const m_pPipeline;
+    const int m_index;
+};
+
+AnalyzerPipeline::AnalyzerPipeline(int numWorkers,
+        int numBlocks,
+        SINT samplesPerBlock,
+        QThread::Priority priority)
+        : m_blockSamples(numBlocks, nullptr),
+          m_blockLengths(numBlocks, 0),
+          m_assignedAnalyzers(numWorkers),
+          m_consumedBlockCounts(numWorkers, 0),
+          m_committedBlockCount(0),
+          m_busyWorkerCount(0),
+          m_cancel(false),
+          m_stop(false) {
+    DEBUG_ASSERT(numWorkers > 0);
+    DEBUG_ASSERT(numBlocks > 0);
+    m_blocks.reserve(numBlocks);
+    for (int i = 0; i < numBlocks; ++i) {
+        m_blocks.emplace_back(samplesPerBlock);
+    }
+    m_workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>(this, i));
+        m_workers.back()->start(priority);
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_blockCommitted.notify_all();
+    for (const auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+}
+
+void AnalyzerPipeline::begin(std::vector<AnalyzerWithState>* pAnalyzers) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DEBUG_ASSERT(minConsumedBlockCount() == m_committedBlockCount);
+    for (auto& assignedAnalyzers : m_assignedAnalyzers) {
+        assignedAnalyzers.clear();
+    }
+    // Round-robin, only active analyzers need to process samples
+    std::size_t workerIndex = 0;
+    for (auto& analyzer : *pAnalyzers) {
+        if (!analyzer.isActive()) {
+            continue;
+        }
+        m_assignedAnalyzers[workerIndex].push_back(&analyzer);
+        workerIndex = (workerIndex + 1) % m_assignedAnalyzers.size();
+    }
+    m_analyzeDuration = mixxx::Duration::empty();
+}
+
+CSAMPLE* AnalyzerPipeline::nextBlock() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_blockConsumed.wait(lock, [this] {
+        return m_committedBlockCount - minConsumedBlockCount() < m_blocks.size();
+    });
+    return m_blocks[m_committedBlockCount % m_blocks.size()].data();
+}
+
+void AnalyzerPipeline::commitBlock(const CSAMPLE* pSamples, SINT numSamples) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto blockIndex = m_committedBlockCount % m_blocks.size();
+        DEBUG_ASSERT(pSamples >= m_blocks[blockIndex].data());
+        DEBUG_ASSERT(pSamples + numSamples <=
+                m_blocks[blockIndex].data() + m_blocks[blockIndex].size());
+        m_blockSamples[blockIndex] = pSamples;
+        m_blockLengths[blockIndex] = numSamples;
+        ++m_committedBlockCount;
+    }
+    m_blockCommitted.notify_all();
+}
+
+void AnalyzerPipeline::end(bool cancel) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (cancel) {
+        m_cancel = true;
+        m_blockConsumed.wait(lock, [this] { return m_busyWorkerCount == 0; });
+        std::fill(m_consumedBlockCounts.begin(),
+                m_consumedBlockCounts.end(),
+                m_committedBlockCount);
+        m_cancel = false;
+    } else {
+        m_blockConsumed.wait(lock, [this] {
+            return minConsumedBlockCount() == m_committedBlockCount;
+        });
+    }
+    for (auto& assignedAnalyzers : m_assignedAnalyzers) {
+        assignedAnalyzers.clear();
+    }
+}
+
+mixxx::Duration AnalyzerPipeline::analyzeDuration() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_analyzeDuration;
+}
+
+std::uint64_t AnalyzerPipeline::minConsumedBlockCount() const {
+    return *std::min_element(m_consumedBlockCounts.begin(), m_consumedBlockCounts.end());
+}
+
+void AnalyzerPipeline::runWorker(int workerIndex) {
+    mixxx::realtime::IdleWhilePlaying idleWhilePlaying;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_blockCommitted.wait(lock, [this, workerIndex] {
+            return m_stop ||
+                    (!m_cancel &&
+                            m_consumedBlockCounts[workerIndex] < m_committedBlockCount);
+        });
+        if (m_stop) {
+            return;
+        }
+        const auto blockIndex = m_consumedBlockCounts[workerIndex] % m_blocks.size();
+        const CSAMPLE* pBlock = m_blockSamples[blockIndex];
+        const SINT numSamples = m_blockLengths[blockIndex];
+        // Only modified by begin() and end() while no block is pending
+        const std::vector<AnalyzerWithState*>& analyzers = m_assignedAnalyzers[workerIndex];
+        ++m_busyWorkerCount;
+        lock.unlock();
+
+        idleWhilePlaying.update();
+
+        PerformanceTimer timer;
+        timer.start();
+        for (AnalyzerWithState* pAnalyzer : analyzers) {
+            pAnalyzer->processSamples(pBlock, static_cast<int>(numSamples));
+        }
+        const mixxx::Duration elapsed = timer.elapsed();
+
+        lock.lock();
+        --m_busyWorkerCount;
+        ++m_consumedBlockCounts[workerIndex];
+        m_analyzeDuration += elapsed;
+        // Notify while locked, the producer might be waiting for any worker
+        m_blockConsumed.notify_all();
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QThread>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/duration.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// Runs the analyzers of a single track concurrently.
+///
+/// The decoding thread writes each decoded block into one of a fixed number
+/// of block buffers. Every worker thread owns a subset of the analyzers and
+/// feeds all blocks in order to them. The workers only need to wait for each
+/// other when the slowest one is as many blocks behind the decoder as there
+/// are buffers, until then decoding and all analyzers run in parallel.
+class AnalyzerPipeline {
+  public:
+    AnalyzerPipeline(int numWorkers,
+            int numBlocks,
+            SINT samplesPerBlock,
+            QThread::Priority priority);
+    ~AnalyzerPipeline();
+
+    AnalyzerPipeline(const AnalyzerPipeline&) = delete;
+    AnalyzerPipeline& operator=(const AnalyzerPipeline&) = delete;
+
+    int numWorkers() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    /// Distribute the analyzers among the workers for the next track. The
+    /// analyzers must not be accessed until end() returns.
+    void begin(std::vector<AnalyzerWithState>* pAnalyzers);
+
+    /// Returns the buffer for the next block. Blocks while the slowest
+    /// worker still needs all buffers.
+    CSAMPLE* nextBlock();
+
+    /// Pass the decoded samples to all analyzers. They must be stored in
+    /// the block returned by nextBlock().
+    void commitBlock(const CSAMPLE* pSamples, SINT numSamples);
+
+    /// Wait until all committed blocks have been processed. Pending blocks
+    /// are skipped if cancel is set.
+    void end(bool cancel = false);
+
+    /// The accumulated time that the analyzers spent processing samples,
+    /// summed over all workers since the last begin().
+    mixxx::Duration analyzeDuration() const;
+
+  private:
+    class Worker;
+
+    void runWorker(int workerIndex);
+
+    std::uint64_t minConsumedBlockCount() const;
+
+    std::vector<mixxx::SampleBuffer> m_blocks;
+    std::vector<const CSAMPLE*> m_blockSamples;
+    std::vector<SINT> m_blockLengths;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_blockCommitted;
+    std::condition_variable m_blockConsumed;
+
+    // All guarded by m_mutex
+    std::vector<std::vector<AnalyzerWithState*>> m_assignedAnalyzers;
+    std::vector<std::uint64_t> m_consumedBlockCounts;
+    std::uint64_t m_committedBlockCount;
+    int m_busyWorkerCount;
+    mixxx::Duration m_analyzeDuration;
+    bool m_cancel;
+    bool m_stop;
+};
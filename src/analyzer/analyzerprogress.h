@@ -1,8 +1,8 @@
 #pragma once
 
+#include "util/duration.h"
 #include "util/math.h"
 
-
 typedef double AnalyzerProgress;
 
 constexpr AnalyzerProgress kAnalyzerProgressUnknown    = -1.0;
@@ -23,3 +23,31 @@ int analyzerProgressPercent(AnalyzerProgress analyzerProgress) {
             100 * (analyzerProgressClamped - kAnalyzerProgressNone) /
             (kAnalyzerProgressDone - kAnalyzerProgressNone)));
 }
+
+// Throughput statistics of the analysis, either for a single track or
+// accumulated over all tracks of a batch.
+struct AnalyzerThroughput {
+    int trackCount = 0;
+    // Time spent reading and decoding the audio data
+    mixxx::Duration decodeDuration;
+    // Time spent in the analyzers, summed up over all threads that
+    // processed the samples concurrently.
+    mixxx::Duration analyzeDuration;
+    // Wall clock time
+    mixxx::Duration elapsedDuration;
+
+    AnalyzerThroughput& operator+=(const AnalyzerThroughput& other) {
+        trackCount += other.trackCount;
+        decodeDuration += other.decodeDuration;
+        analyzeDuration += other.analyzeDuration;
+        elapsedDuration += other.elapsedDuration;
+        return *this;
+    }
+
+    double tracksPerMinute() const {
+        const double seconds = elapsedDuration.toDoubleSeconds();
+        return seconds > 0 ? trackCount * 60 / seconds : 0;
+    }
+};
+
+Q_DECLARE_METATYPE(AnalyzerThroughput);
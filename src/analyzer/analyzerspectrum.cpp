@@ -0,0 +1,189 @@
+#include <base/Window.h>
+#include <dsp/transforms/FFT.h>
+
+// Class header comes after library includes here since our preprocessor
+// definitions interfere with qm-dsp's headers.
+#include "analyzer/analyzerspectrum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "util/assert.h"
+
+class AnalyzerSpectrum::Transform final {
+  public:
+    Transform(int windowSize, int stepSize)
+            : m_windowSize(windowSize),
+              m_stepSize(stepSize),
+              m_window(HanningWindow, windowSize),
+              m_fft(windowSize),
+              m_windowed(windowSize),
+              m_reals(windowSize),
+              m_imags(windowSize),
+              m_magnitudes(windowSize / 2 + 1),
+              m_frameCount(0) {
+        DEBUG_ASSERT(windowSize % 2 == 0);
+        const bool initialized = m_helper.initialize(
+                windowSize, stepSize, [this](double* pWindow, size_t) {
+                    transform(pWindow);
+                    return true;
+                });
+        DEBUG_ASSERT(initialized);
+        Q_UNUSED(initialized);
+    }
+
+    bool hasConfiguration(int windowSize, int stepSize) const {
+        return m_windowSize == windowSize && m_stepSize == stepSize;
+    }
+
+    void addCallback(int id, FrameCallback callback) {
+        m_callbacks.emplace_back(id, std::move(callback));
+    }
+
+    /// Returns true if the callback has been found
+    bool removeCallback(int id) {
+        const auto it = std::find_if(m_callbacks.begin(),
+                m_callbacks.end(),
+                [id](const auto& callback) {
+                    return callback.first == id;
+                });
+        if (it == m_callbacks.end()) {
+            return false;
+        }
+        m_callbacks.erase(it);
+        return true;
+    }
+
+    bool hasCallbacks() const {
+        return !m_callbacks.empty();
+    }
+
+    void processStereoSamples(const CSAMPLE* pIn, SINT count) {
+        m_helper.processStereoSamples(pIn, count);
+    }
+
+    void processMonoSamples(const CSAMPLE* pIn, SINT count) {
+        m_helper.processMonoSamples(pIn, count);
+    }
+
+    void finalize() {
+        m_helper.finalize();
+    }
+
+  private:
+    void transform(const double* pWindow) {
+        m_window.cut(pWindow, m_windowed.data());
+        // Rotate the window to center the phase, like the phase vocoder
+        std::rotate(m_windowed.begin(),
+                m_windowed.begin() + m_windowSize / 2,
+                m_windowed.end());
+        m_fft.forward(m_windowed.data(), m_reals.data(), m_imags.data());
+        const int binCount = m_windowSize / 2 + 1;
+        for (int i = 0; i < binCount; ++i) {
+            m_magnitudes[i] = std::sqrt(m_reals[i] * m_reals[i] + m_imags[i] * m_imags[i]);
+        }
+
+        AnalyzerSpectrumFrame frame;
+        frame.centerFrame = static_cast<SINT>(m_frameCount) * m_stepSize;
+        frame.binCount = binCount;
+        frame.reals = m_reals.data();
+        frame.imags = m_imags.data();
+        frame.magnitudes = m_magnitudes.data();
+        ++m_frameCount;
+        for (const auto& callback : m_callbacks) {
+            callback.second(frame);
+        }
+    }
+
+    const int m_windowSize;
+    const int m_stepSize;
+    mixxx::DownmixAndOverlapHelper m_helper;
+    const Window<double> m_window;
+    FFTReal m_fft;
+    std::vector<double> m_windowed;
+    std::vector<double> m_reals;
+    std::vector<double> m_imags;
+    std::vector<double> m_magnitudes;
+    std::int64_t m_frameCount;
+    std::vector<std::pair<int, FrameCallback>> m_callbacks;
+};
+
+void AnalyzerSpectrum::Subscription::reset() {
+    if (m_pSpectrum) {
+        m_pSpectrum->unsubscribe(m_id);
+        m_pSpectrum = nullptr;
+    }
+}
+
+AnalyzerSpectrum::AnalyzerSpectrum()
+        : m_nextSubscriptionId(0),
+          m_processing(false) {
+}
+
+AnalyzerSpectrum::~AnalyzerSpectrum() {
+    // Subscriptions must not outlive the front-end
+    DEBUG_ASSERT(m_transforms.empty());
+}
+
+AnalyzerSpectrum::Subscription AnalyzerSpectrum::subscribe(
+        int windowSize,
+        int stepSize,
+        FrameCallback callback) {
+    VERIFY_OR_DEBUG_ASSERT(!m_processing) {
+        return Subscription();
+    }
+    VERIFY_OR_DEBUG_ASSERT(windowSize > 0 && windowSize % 2 == 0 &&
+            stepSize > 0 && stepSize <= windowSize) {
+        return Subscription();
+    }
+    const int id = m_nextSubscriptionId++;
+    auto it = std::find_if(m_transforms.begin(),
+            m_transforms.end(),
+            [windowSize, stepSize](const auto& pTransform) {
+                return pTransform->hasConfiguration(windowSize, stepSize);
+            });
+    if (it == m_transforms.end()) {
+        m_transforms.push_back(std::make_unique<Transform>(windowSize, stepSize));
+        it = m_transforms.end() - 1;
+    }
+    (*it)->addCallback(id, std::move(callback));
+    return Subscription(this, id);
+}
+
+void AnalyzerSpectrum::unsubscribe(int id) {
+    for (auto it = m_transforms.begin(); it != m_transforms.end(); ++it) {
+        if ((*it)->removeCallback(id)) {
+            if (!(*it)->hasCallbacks()) {
+                m_transforms.erase(it);
+            }
+            return;
+        }
+    }
+    DEBUG_ASSERT(!"Unknown subscription");
+}
+
+void AnalyzerSpectrum::processStereoSamples(const CSAMPLE* pIn, SINT count) {
+    m_processing = true;
+    for (const auto& pTransform : m_transforms) {
+        pTransform->processStereoSamples(pIn, count);
+    }
+}
+
+void AnalyzerSpectrum::processMonoSamples(const CSAMPLE* pIn, SINT count) {
+    m_processing = true;
+    for (const auto& pTransform : m_transforms) {
+        pTransform->processMonoSamples(pIn, count);
+    }
+}
+
+void AnalyzerSpectrum::finalize() {
+    for (const auto& pTransform : m_transforms) {
+        pTransform->finalize();
+    }
+}
+
+void AnalyzerSpectrum::reset() {
+    DEBUG_ASSERT(m_transforms.empty());
+    m_processing = false;
+}
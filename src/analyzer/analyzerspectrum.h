@@ -0,0 +1,119 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "analyzer/plugins/buffering_utils.h"
+#include "util/types.h"
+
+class FFTReal;
+template<typename T>
+class Window;
+
+/// A single frame of the short-time Fourier transform
+struct AnalyzerSpectrumFrame {
+    /// The index of the input frame at the center of the window
+    SINT centerFrame;
+    /// windowSize / 2 + 1 bins for each of the following arrays
+    int binCount;
+    const double* reals;
+    const double* imags;
+    const double* magnitudes;
+};
+
+/// The spectral front-end that computes the short-time Fourier transform
+/// of a mono downmix once for all subscribers.
+///
+/// Subscribers with the same window and step size share a transform. The
+/// frames are framed like DownmixAndOverlapHelper does, windowed with a
+/// Hann window and rotated by half a window before the transform like the
+/// phase vocoder of qm-dsp. This allows to pass them directly to
+/// DetectionFunction::processFrequencyDomain() with the same results as
+/// DetectionFunction::processTimeDomain().
+///
+/// The host first passes the samples to the subscribing analyzers and
+/// then to the front-end. Subscribers that stopped receiving samples,
+/// e.g. in fast analysis mode, should ignore all subsequent frames.
+class AnalyzerSpectrum final {
+  public:
+    using FrameCallback = std::function<void(const AnalyzerSpectrumFrame& frame)>;
+
+    /// Unsubscribes when destroyed. Must not outlive the front-end.
+    class Subscription final {
+      public:
+        Subscription()
+                : m_pSpectrum(nullptr),
+                  m_id(0) {
+        }
+        Subscription(Subscription&& that) noexcept
+                : m_pSpectrum(std::exchange(that.m_pSpectrum, nullptr)),
+                  m_id(that.m_id) {
+        }
+        Subscription& operator=(Subscription&& that) noexcept {
+            reset();
+            m_pSpectrum = std::exchange(that.m_pSpectrum, nullptr);
+            m_id = that.m_id;
+            return *this;
+        }
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+        ~Subscription() {
+            reset();
+        }
+
+        explicit operator bool() const {
+            return m_pSpectrum != nullptr;
+        }
+
+        void reset();
+
+      private:
+        friend class AnalyzerSpectrum;
+        Subscription(AnalyzerSpectrum* pSpectrum, int id)
+                : m_pSpectrum(pSpectrum),
+                  m_id(id) {
+        }
+
+        AnalyzerSpectrum* m_pSpectrum;
+        int m_id;
+    };
+
+    AnalyzerSpectrum();
+    ~AnalyzerSpectrum();
+
+    AnalyzerSpectrum(const AnalyzerSpectrum&) = delete;
+    AnalyzerSpectrum& operator=(const AnalyzerSpectrum&) = delete;
+
+    /// Only allowed before processing the first samples. The window
+    /// size must be even.
+    [[nodiscard]] Subscription subscribe(
+            int windowSize,
+            int stepSize,
+            FrameCallback callback);
+
+    bool hasSubscribers() const {
+        return !m_transforms.empty();
+    }
+
+    void processStereoSamples(const CSAMPLE* pIn, SINT count);
+    void processMonoSamples(const CSAMPLE* pIn, SINT count);
+
+    /// Pads the signal with silence like DownmixAndOverlapHelper
+    /// to complete the last frames.
+    void finalize();
+
+    /// Prepares the front-end for the next track. All subscriptions
+    /// must have been reset.
+    void reset();
+
+  private:
+    class Transform;
+
+    void unsubscribe(int id);
+
+    std::vector<std::unique_ptr<Transform>> m_transforms;
+    int m_nextSubscriptionId;
+    bool m_processing;
+};
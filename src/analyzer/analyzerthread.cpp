@@ -1,14 +1,18 @@
 #include "analyzer/analyzerthread.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "analyzer/analyzerbeats.h"
-#include "analyzer/analyzerebur128.h"
-#include "analyzer/analyzergain.h"
+#include "analyzer/analyzerdecimator.h"
+#include "analyzer/analyzerfingerprint.h"
 #include "analyzer/analyzerkey.h"
+#include "analyzer/analyzerloudness.h"
 #include "analyzer/analyzersilence.h"
 #include "analyzer/analyzerwaveform.h"
+#include "analyzer/audiodigest.h"
 #include "analyzer/constants.h"
+#include "engine/cachingreader/cachingreadertrackbuffersource.h"
 #include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
 #include "sources/audiosourcestereoproxy.h"
@@ -17,11 +21,14 @@
 #include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 #include "util/logger.h"
+#include "util/tracing.h"
 
 namespace {
 
 mixxx::Logger kLogger("AnalyzerThread");
 
+const QString kAppGroup = QStringLiteral("[App]");
+
 // NOTE(uklotzde, 2018-11-23): The parameterization for the analyzers
 // has not been touched while transforming the code from single- to
 // multi-threaded processing! Feel free to adjust this if justified.
@@ -34,6 +41,24 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// The number of decoded chunks the analyzers may lag behind the decoder
+// when running concurrently.
+constexpr int kPipelineChunks = 16;
+
+// Low priority analysis backs off while the audio callback uses more than
+// this fraction of its latency. The delay per chunk is limited to not stall
+// the analysis while the engine is permanently under heavy load.
+constexpr double kThrottleAudioLatencyUsage = 0.7;
+constexpr unsigned long kThrottleSleepMillis = 5;
+constexpr int kMaxThrottleSleepsPerChunk = 20;
+
+// The preview is decoded from this number of excerpts with a duration
+// of ~23 ms each at 44.1 kHz. This is fast enough for displaying the
+// overview almost immediately after loading a track.
+constexpr SINT kPreviewExcerptCount = 256;
+constexpr SINT kPreviewExcerptFrames = 1024;
+static_assert(kPreviewExcerptFrames <= mixxx::kAnalysisFramesPerChunk);
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -47,6 +72,7 @@ void registerMetaTypesOnce() {
     // AnalyzerProgress is just an alias/typedef and must be registered explicitly
     // by name!
     qRegisterMetaType<AnalyzerProgress>("AnalyzerProgress");
+    qRegisterMetaType<AnalyzerThroughput>();
 }
 
 } // anonymous namespace
@@ -60,12 +86,14 @@ AnalyzerThread::Pointer AnalyzerThread::createInstance(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        int numAnalyzerWorkers) {
     return Pointer(new AnalyzerThread(
                            id,
                            dbConnectionPool,
                            pConfig,
-                           modeFlags),
+                           modeFlags,
+                           numAnalyzerWorkers),
             deleteAnalyzerThread);
 }
 
@@ -73,7 +101,8 @@ AnalyzerThread::AnalyzerThread(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        int numAnalyzerWorkers)
         : WorkerThread(
             QString("AnalyzerThread %1").arg(id),
             (modeFlags & AnalyzerModeFlags::LowPriority ? QThread::LowPriority : QThread::InheritPriority)),
@@ -81,6 +110,7 @@ AnalyzerThread::AnalyzerThread(
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
+          m_numAnalyzerWorkers(numAnalyzerWorkers),
           m_nextTrack(2), // minimum capacity
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
@@ -93,33 +123,71 @@ void AnalyzerThread::doRun() {
     // before returning from this function.
     mixxx::DbConnectionPooler dbConnectionPooler;
 
-    if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+    if (m_dbConnectionPool) {
         dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
-        if (!dbConnectionPooler.isPooling()) {
-            kLogger.warning()
-                    << "Failed to obtain database connection for analyzer thread";
-            return;
-        }
-        QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
     }
-    if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
+    if (dbConnectionPooler.isPooling()) {
+        QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
+        // Results of duplicate files are reused by all analyzers
+        pAnalysisDao = std::make_unique<AnalysisDao>(m_pConfig);
+        pAnalysisDao->initialize(dbConnection);
+        if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+            m_analyzers.push_back(AnalyzerWithState(
+                    std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        }
+    } else if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+        kLogger.warning()
+                << "Failed to obtain database connection for analyzer thread";
+        return;
     }
-    if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+    if (AnalyzerLoudness::isEnabled(ReplayGainSettings(m_pConfig))) {
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerLoudness>(m_pConfig)));
     }
     // BPM detection might be disabled in the config, but can be overridden
     // and enabled by explicitly setting the mode flag.
     const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
+    // Beat and key detection share a decimated signal for tracks with
+    // a high sample rate
+    std::vector<AnalyzerPtr> decimatedAnalyzers;
+    decimatedAnalyzers.push_back(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection));
+    decimatedAnalyzers.push_back(std::make_unique<AnalyzerKey>(m_pConfig));
+    m_analyzers.push_back(AnalyzerWithState(
+            std::make_unique<AnalyzerDecimator>(std::move(decimatedAnalyzers))));
     m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
+    if (AnalyzerFingerprint::isEnabled(m_pConfig)) {
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerFingerprint>(m_pConfig)));
+    }
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    // More workers than analyzers would be idle
+    const int numAnalyzerWorkers = std::min(
+            m_numAnalyzerWorkers, static_cast<int>(m_analyzers.size()));
+    if (numAnalyzerWorkers > 0) {
+        kLogger.debug() << "Running analyzers on" << numAnalyzerWorkers << "worker threads";
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(
+                numAnalyzerWorkers,
+                kPipelineChunks,
+                mixxx::kAnalysisSamplesPerChunk,
+                m_modeFlags & AnalyzerModeFlags::LowPriority
+                        ? QThread::LowPriority
+                        : QThread::InheritPriority);
+    }
+
+    mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::Analyzer);
+    mixxx::tracing::registerCurrentThread(objectName());
     m_lastBusyProgressEmittedTimer.start();
 
+    if (m_modeFlags & AnalyzerModeFlags::LowPriority) {
+        // Missing without an engine, e.g. in mixxx-analyze
+        m_audioLatencyUsage.emplace(
+                ConfigKey(kAppGroup, QStringLiteral("audio_latency_usage")),
+                ControlFlag::AllowMissingOrInvalid);
+        if (!m_audioLatencyUsage->valid()) {
+            m_audioLatencyUsage.reset();
+        }
+    }
+
     mixxx::AudioSource::OpenParams openParams;
     openParams.setChannelCount(mixxx::kAnalysisMaxChannels);
 
@@ -127,9 +195,15 @@ void AnalyzerThread::doRun() {
         DEBUG_ASSERT(m_currentTrack.has_value());
         kLogger.debug() << "Analyzing" << m_currentTrack->getTrack()->getLocation();
 
-        // Get the audio
+        // Get the audio. Tracks that are loaded into a deck are read from
+        // the track buffer of the deck while it is filled, if available.
         mixxx::AudioSourcePointer audioSource =
-                SoundSourceProxy(m_currentTrack->getTrack()).openAudioSource(openParams);
+                CachingReaderTrackBufferSource::open(
+                        m_currentTrack->getTrack(), openParams);
+        if (!audioSource) {
+            audioSource = SoundSourceProxy(m_currentTrack->getTrack())
+                                  .openAudioSource(openParams);
+        }
         if (!audioSource) {
             kLogger.warning()
                     << "Failed to open file for analyzing:"
@@ -138,11 +212,26 @@ void AnalyzerThread::doRun() {
             continue;
         }
 
+        // Populate the cache with the decoded audio data while analyzing,
+        // unless it has been read from the cache
+        std::unique_ptr<mixxx::PcmCache::Writer> pCacheWriter =
+                mixxx::PcmCache::Writer::create(
+                        m_currentTrack->getTrack()->getFileInfo(),
+                        m_currentTrack->getTrack()->getType(),
+                        openParams,
+                        *audioSource);
+
         // If we have a non-even multi channel audio source (mono or )
         if (audioSource->getSignalInfo().getChannelCount() % mixxx::kAnalysisChannels) {
             audioSource = std::make_shared<mixxx::AudioSourceStereoProxy>(
                     audioSource,
                     mixxx::kAnalysisFramesPerChunk);
+            // Only the original signal is cached
+            pCacheWriter.reset();
+        }
+
+        if (pAnalysisDao) {
+            restoreAnalysesFromDuplicates(pAnalysisDao.get(), audioSource);
         }
 
         bool processTrack = false;
@@ -158,7 +247,10 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
-            const auto analysisResult = analyzeAudioSource(audioSource);
+            PerformanceTimer trackTimer;
+            trackTimer.start();
+            m_trackThroughput = AnalyzerThroughput();
+            const auto analysisResult = analyzeAudioSource(audioSource, pCacheWriter.get());
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
@@ -172,6 +264,9 @@ void AnalyzerThread::doRun() {
                 for (auto&& analyzer : m_analyzers) {
                     analyzer.finish(*m_currentTrack);
                 }
+                m_trackThroughput.trackCount = 1;
+                m_trackThroughput.elapsedDuration = trackTimer.elapsed();
+                emit throughput(m_id, m_trackThroughput);
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
                 for (auto&& analyzer : m_analyzers) {
@@ -187,6 +282,7 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pPipeline.reset();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -225,7 +321,9 @@ WorkerThread::TryFetchWorkItemsResult AnalyzerThread::tryFetchWorkItems() {
 }
 
 AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
-        const mixxx::AudioSourcePointer& audioSource) {
+        const mixxx::AudioSourcePointer& audioSource,
+        mixxx::PcmCache::Writer* pCacheWriter) {
+    MIXXX_TRACE_SCOPE("AnalyzerThread::analyzeAudioSource");
     DEBUG_ASSERT(m_currentTrack.has_value());
 
     DEBUG_ASSERT(
@@ -234,9 +332,111 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     // Analysis starts now
     emitBusyProgress(kAnalyzerProgressNone);
 
+    if (m_currentTrack->getOptions().previewWaveform) {
+        // Before the analyzers are handed over to the pipeline
+        previewAudioSource(audioSource);
+    }
+
+    if (m_pPipeline) {
+        m_pPipeline->begin(&m_analyzers);
+    }
+    const auto analysisResult = decodeAndAnalyzeAudioSource(audioSource, pCacheWriter);
+    if (m_pPipeline) {
+        m_pPipeline->end(analysisResult == AnalysisResult::Cancelled);
+        m_trackThroughput.analyzeDuration = m_pPipeline->analyzeDuration();
+    }
+    if (analysisResult == AnalysisResult::Finished && pCacheWriter) {
+        pCacheWriter->commit(audioSource->frameIndexRange());
+    }
+    return analysisResult;
+}
+
+void AnalyzerThread::restoreAnalysesFromDuplicates(
+        AnalysisDao* pAnalysisDao,
+        const mixxx::AudioSourcePointer& audioSource) {
+    const TrackPointer& pTrack = m_currentTrack->getTrack();
+    // The digest is only calculated once, when the track is analyzed
+    // for the first time
+    QByteArray audioDigest = pAnalysisDao->getAudioDigest(pTrack->getId());
+    if (audioDigest.isEmpty()) {
+        PerformanceTimer timer;
+        timer.start();
+        audioDigest = mixxx::digestAudioSource(
+                audioSource, mixxx::SampleBuffer::WritableSlice(m_sampleBuffer));
+        if (audioDigest.isEmpty()) {
+            return;
+        }
+        pAnalysisDao->saveAudioDigest(pTrack->getId(), audioDigest);
+        kLogger.debug()
+                << "Calculated audio digest of"
+                << pTrack->getId()
+                << "in"
+                << timer.elapsed().debugMillisWithUnit();
+    }
+    if (pAnalysisDao->restoreAnalysesFromDuplicates(pTrack.get(), audioDigest)) {
+        kLogger.info()
+                << "Reusing analysis results of duplicates for"
+                << pTrack->getLocation();
+    }
+}
+
+void AnalyzerThread::previewAudioSource(const mixxx::AudioSourcePointer& audioSource) {
+    std::vector<AnalyzerWithState*> previewAnalyzers;
+    for (auto&& analyzer : m_analyzers) {
+        if (analyzer.wantsPreview()) {
+            previewAnalyzers.push_back(&analyzer);
+        }
+    }
+    if (previewAnalyzers.empty()) {
+        return;
+    }
+
+    PerformanceTimer timer;
+    timer.start();
+    const mixxx::IndexRange frameRange = audioSource->frameIndexRange();
+    const SINT excerptCount = math_min(
+            kPreviewExcerptCount, frameRange.length() / kPreviewExcerptFrames);
+    for (SINT i = 0; i < excerptCount && !isStopping(); ++i) {
+        // Each excerpt represents the frames until the next excerpt
+        const SINT excerptStart = frameRange.start() + frameRange.length() * i / excerptCount;
+        const SINT excerptEnd = frameRange.start() + frameRange.length() * (i + 1) / excerptCount;
+        const auto readableSampleFrames =
+                audioSource->readSampleFrames(
+                        mixxx::WritableSampleFrames(
+                                mixxx::IndexRange::forward(
+                                        excerptStart, excerptStart + kPreviewExcerptFrames),
+                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+        const mixxx::IndexRange readableRange = readableSampleFrames.frameIndexRange();
+        if (readableRange.empty() || readableRange.start() >= excerptEnd) {
+            continue;
+        }
+        for (auto* pAnalyzer : previewAnalyzers) {
+            pAnalyzer->processPreviewExcerpt(
+                    mixxx::IndexRange::forward(readableRange.start(), excerptEnd),
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableLength());
+        }
+    }
+    for (auto* pAnalyzer : previewAnalyzers) {
+        pAnalyzer->finishPreview();
+    }
+    m_trackThroughput.decodeDuration += timer.elapsed();
+    kLogger.debug()
+            << "Published preview of"
+            << m_currentTrack->getTrack()->getId()
+            << "after"
+            << timer.elapsed().debugMillisWithUnit();
+}
+
+AnalyzerThread::AnalysisResult AnalyzerThread::decodeAndAnalyzeAudioSource(
+        const mixxx::AudioSourcePointer& audioSource,
+        mixxx::PcmCache::Writer* pCacheWriter) {
+    PerformanceTimer timer;
     mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
+        m_idleWhilePlaying.update();
+        throttleWhileEngineIsBusy();
         if (isStopping()) {
             return AnalysisResult::Cancelled;
         }
@@ -249,12 +449,19 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
-        // Request the next chunk of audio data
+        // Request the next chunk of audio data. When the analyzers run
+        // concurrently it is decoded directly into the next pipeline chunk.
+        const auto writableSlice = m_pPipeline
+                ? mixxx::SampleBuffer::WritableSlice(
+                          m_pPipeline->nextBlock(), mixxx::kAnalysisSamplesPerChunk)
+                : mixxx::SampleBuffer::WritableSlice(m_sampleBuffer);
+        timer.start();
         const auto readableSampleFrames =
                 audioSource->readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                writableSlice));
+        m_trackThroughput.decodeDuration += timer.elapsed();
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -299,10 +506,21 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            if (m_pPipeline) {
+                m_pPipeline->commitBlock(
                         readableSampleFrames.readableData(),
                         readableSampleFrames.readableLength());
+            } else {
+                timer.start();
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processSamples(
+                            readableSampleFrames.readableData(),
+                            readableSampleFrames.readableLength());
+                }
+                m_trackThroughput.analyzeDuration += timer.elapsed();
+            }
+            if (pCacheWriter) {
+                pCacheWriter->write(readableSampleFrames);
             }
         }
 
@@ -331,6 +549,18 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     return AnalysisResult::Finished;
 }
 
+void AnalyzerThread::throttleWhileEngineIsBusy() {
+    if (!m_audioLatencyUsage) {
+        return;
+    }
+    for (int i = 0; i < kMaxThrottleSleepsPerChunk &&
+            m_audioLatencyUsage->get() > kThrottleAudioLatencyUsage &&
+            !isStopping();
+            ++i) {
+        QThread::msleep(kThrottleSleepMillis);
+    }
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
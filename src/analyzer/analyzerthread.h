@@ -5,18 +5,24 @@
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
+#include "control/pollingcontrolproxy.h"
 #include "preferences/usersettings.h"
 #include "rigtorp/SPSCQueue.h"
 #include "sources/audiosource.h"
+#include "sources/pcmcache.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/db/dbconnectionpool.h"
 #include "util/performancetimer.h"
+#include "util/realtime.h"
 #include "util/samplebuffer.h"
 #include "util/workerthread.h"
 
+class AnalysisDao;
+
 enum AnalyzerModeFlags {
     None = 0x00,
     WithBeats = 0x01,
@@ -59,13 +65,17 @@ class AnalyzerThread : public WorkerThread {
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            int numAnalyzerWorkers = 0);
 
+    // The analyzers of each track are run concurrently on numAnalyzerWorkers
+    // additional threads. With 0 they are run sequentially by this thread.
     /*private*/ AnalyzerThread(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            int numAnalyzerWorkers);
     ~AnalyzerThread() override = default;
 
     int id() const {
@@ -88,6 +98,9 @@ class AnalyzerThread : public WorkerThread {
     // AnalyzerThreadProgress object and register it as a new meta type.
     void progress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress trackProgress);
 
+    // Emitted for each analyzed track before the Done progress
+    void throughput(int threadId, AnalyzerThroughput trackThroughput);
+
   protected:
     void doRun() override;
 
@@ -100,6 +113,7 @@ class AnalyzerThread : public WorkerThread {
     const mixxx::DbConnectionPoolPtr m_dbConnectionPool;
     const UserSettingsPointer m_pConfig;
     const AnalyzerModeFlags m_modeFlags;
+    const int m_numAnalyzerWorkers;
 
     /////////////////////////////////////////////////////////////////////////
     // Thread-safe atomic values
@@ -118,8 +132,19 @@ class AnalyzerThread : public WorkerThread {
 
     std::vector<AnalyzerWithState> m_analyzers;
 
+    // Only created if the analyzers run concurrently
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+
     mixxx::SampleBuffer m_sampleBuffer;
 
+    mixxx::realtime::IdleWhilePlaying m_idleWhilePlaying;
+
+    // Only monitored by low priority, i.e. batch analysis
+    std::optional<PollingControlProxy> m_audioLatencyUsage;
+
+    // Statistics of the current track
+    AnalyzerThroughput m_trackThroughput;
+
     std::optional<AnalyzerTrack> m_currentTrack;
 
     AnalyzerThreadState m_emittedState;
@@ -131,9 +156,30 @@ class AnalyzerThread : public WorkerThread {
         Finished,
         Cancelled,
     };
-    AnalysisResult analyzeAudioSource(
+    // Calculates the audio digest of the current track once and restores
+    // its missing results from duplicates with the same digest, such that
+    // the analyzers skip them.
+    void restoreAnalysesFromDuplicates(
+            AnalysisDao* pAnalysisDao,
             const mixxx::AudioSourcePointer& audioSource);
 
+    // Decodes short excerpts spread across the whole track for the
+    // analyzers that publish a coarse preview.
+    void previewAudioSource(const mixxx::AudioSourcePointer& audioSource);
+
+    // The decoded audio data is written into the cache if a pCacheWriter
+    // is provided.
+    AnalysisResult analyzeAudioSource(
+            const mixxx::AudioSourcePointer& audioSource,
+            mixxx::PcmCache::Writer* pCacheWriter);
+    AnalysisResult decodeAndAnalyzeAudioSource(
+            const mixxx::AudioSourcePointer& audioSource,
+            mixxx::PcmCache::Writer* pCacheWriter);
+
+    // Delays the next chunk for a limited time while the audio callback
+    // uses most of its time budget
+    void throttleWhileEngineIsBusy();
+
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
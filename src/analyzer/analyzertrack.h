@@ -10,6 +10,9 @@ class AnalyzerTrack {
     struct Options {
         /// If set, overrides whether the analysis should assume constant BPM.
         std::optional<bool> useFixedTempo;
+        /// If set, a coarse waveform summary is published before starting
+        /// the actual analysis, e.g. for tracks loaded into a deck.
+        bool previewWaveform = false;
     };
 
     explicit AnalyzerTrack(TrackPointer track, Options options = Options());
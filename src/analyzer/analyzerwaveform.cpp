@@ -9,6 +9,7 @@
 #include "track/track.h"
 #include "util/logger.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformcache.h"
 #include "waveform/waveformfactory.h"
 
 namespace {
@@ -87,6 +88,8 @@ bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
     m_currentStride = 0;
     m_currentSummaryStride = 0;
     m_channelCount = channelCount;
+    m_sampleRate = sampleRate;
+    m_pTrack = track.getTrack();
 
     //debug
     //m_waveform->dump();
@@ -112,6 +115,22 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     bool missingWaveform = pTrackWaveform.isNull();
     bool missingWavesummary = pTrackWaveformSummary.isNull();
 
+    if (trackId.isValid() && (missingWaveform || missingWavesummary)) {
+        // Shared with other players or kept since the track has been unloaded
+        const WaveformCache::Waveforms cachedWaveforms = WaveformCache::lookup(
+                trackId,
+                WaveformFactory::currentWaveformVersion(),
+                WaveformFactory::currentWaveformSummaryVersion());
+        if (missingWaveform && cachedWaveforms.pWaveform) {
+            pLoadedTrackWaveform = cachedWaveforms.pWaveform;
+            missingWaveform = false;
+        }
+        if (missingWavesummary && cachedWaveforms.pWaveformSummary) {
+            pLoadedTrackWaveformSummary = cachedWaveforms.pWaveformSummary;
+            missingWavesummary = false;
+        }
+    }
+
     if (trackId.isValid() && (missingWaveform || missingWavesummary)) {
         QList<AnalysisDao::AnalysisInfo> analyses =
                 m_analysisDao.getAnalysesForTrack(trackId);
@@ -127,6 +146,13 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
                     pLoadedTrackWaveform = ConstWaveformPointer(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
                     missingWaveform = false;
+                } else if (missingWaveform && vc == WaveformFactory::VC_UPGRADE) {
+                    AnalysisDao::AnalysisInfo upgradedAnalysis = analysis;
+                    pLoadedTrackWaveform = ConstWaveformPointer(
+                            WaveformFactory::upgradeWaveformFromAnalysis(
+                                    &upgradedAnalysis));
+                    m_analysisDao.saveAnalysis(&upgradedAnalysis);
+                    missingWaveform = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
                     m_analysisDao.deleteAnalysis(analysis.analysisId);
@@ -138,6 +164,13 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
                     pLoadedTrackWaveformSummary = ConstWaveformPointer(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
                     missingWavesummary = false;
+                } else if (missingWavesummary && vc == WaveformFactory::VC_UPGRADE) {
+                    AnalysisDao::AnalysisInfo upgradedAnalysis = analysis;
+                    pLoadedTrackWaveformSummary = ConstWaveformPointer(
+                            WaveformFactory::upgradeWaveformFromAnalysis(
+                                    &upgradedAnalysis));
+                    m_analysisDao.saveAnalysis(&upgradedAnalysis);
+                    missingWavesummary = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
                     m_analysisDao.deleteAnalysis(analysis.analysisId);
@@ -161,6 +194,9 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     // If we don't need to calculate the waveform/wavesummary, skip.
     if (!missingWaveform && !missingWavesummary) {
         kLogger.debug() << "loadStored - Stored waveform loaded";
+        WaveformCache::insert(trackId,
+                pLoadedTrackWaveform,
+                pLoadedTrackWaveformSummary);
         if (pLoadedTrackWaveform) {
             tio->setWaveform(pLoadedTrackWaveform);
         }
@@ -201,34 +237,16 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
 
     SINT numFrames = count / m_channelCount;
     count = numFrames * mixxx::audio::ChannelCount::stereo();
-    int stemCount = 0;
+    const int stemCount = m_channelCount > mixxx::audio::ChannelCount::stereo()
+            ? m_channelCount / mixxx::audio::ChannelCount::stereo()
+            : 0;
 
-    const CSAMPLE* pWaveformInput = pIn;
     CSAMPLE* pMixedChannel = nullptr;
-
-    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
-        DEBUG_ASSERT(0 == m_channelCount % mixxx::audio::ChannelCount::stereo());
-
-        pMixedChannel = SampleUtil::alloc(count);
-        VERIFY_OR_DEBUG_ASSERT(pMixedChannel) {
-            return false;
-        }
-        SampleUtil::mixMultichannelToStereo(pMixedChannel, pIn, numFrames, m_channelCount);
-        stemCount = m_channelCount / mixxx::audio::ChannelCount::stereo();
-        pWaveformInput = pMixedChannel;
-    }
-
-    // This should only append once if count is constant
-    if (count > m_buffers.size) {
-        m_buffers.low.resize(count);
-        m_buffers.mid.resize(count);
-        m_buffers.high.resize(count);
-        m_buffers.size = count;
+    const CSAMPLE* pWaveformInput = stereoSamples(pIn, numFrames, &pMixedChannel);
+    VERIFY_OR_DEBUG_ASSERT(pWaveformInput) {
+        return false;
     }
-
-    m_filters.low->process(pWaveformInput, &m_buffers.low[0], count);
-    m_filters.mid->process(pWaveformInput, &m_buffers.mid[0], count);
-    m_filters.high->process(pWaveformInput, &m_buffers.high[0], count);
+    filterSamples(pWaveformInput, count);
 
     m_waveform->setSaveState(Waveform::SaveState::NotSaved);
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
@@ -270,9 +288,8 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
             storeIfGreater(&m_stride.m_stemData[Right][s], cstem[Right]);
         }
 
-        m_stride.m_position++;
-
-        if (fmod(m_stride.m_position, m_stride.m_length) < 1) {
+        bool averageComplete = false;
+        if (m_stride.advance(&averageComplete)) {
             VERIFY_OR_DEBUG_ASSERT(m_currentStride + ChannelCount <= m_waveform->getDataSize()) {
                 qWarning() << "AnalyzerWaveform::process - currentStride > waveform size";
                 return false;
@@ -282,7 +299,7 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
             m_waveform->setCompletion(m_currentStride);
         }
 
-        if (fmod(m_stride.m_position, m_stride.m_averageLength) < 1) {
+        if (averageComplete) {
             VERIFY_OR_DEBUG_ASSERT(m_currentSummaryStride + ChannelCount <= m_waveformSummary->getDataSize()) {
                 qWarning() << "AnalyzerWaveform::process - current summary stride > waveform summary size";
                 return false;
@@ -312,7 +329,132 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
     return true;
 }
 
+const CSAMPLE* AnalyzerWaveform::stereoSamples(
+        const CSAMPLE* pIn, SINT numFrames, CSAMPLE** pMixedChannel) const {
+    *pMixedChannel = nullptr;
+    if (m_channelCount <= mixxx::audio::ChannelCount::stereo()) {
+        return pIn;
+    }
+    DEBUG_ASSERT(0 == m_channelCount % mixxx::audio::ChannelCount::stereo());
+    *pMixedChannel = SampleUtil::alloc(numFrames * mixxx::audio::ChannelCount::stereo());
+    if (!*pMixedChannel) {
+        return nullptr;
+    }
+    SampleUtil::mixMultichannelToStereo(*pMixedChannel, pIn, numFrames, m_channelCount);
+    return *pMixedChannel;
+}
+
+void AnalyzerWaveform::filterSamples(const CSAMPLE* pIn, SINT count) {
+    // This should only append once if count is constant
+    if (count > m_buffers.size) {
+        m_buffers.low.resize(count);
+        m_buffers.mid.resize(count);
+        m_buffers.high.resize(count);
+        m_buffers.size = count;
+    }
+
+    m_filters.low->process(pIn, &m_buffers.low[0], count);
+    m_filters.mid->process(pIn, &m_buffers.mid[0], count);
+    m_filters.high->process(pIn, &m_buffers.high[0], count);
+}
+
+bool AnalyzerWaveform::wantsPreview() const {
+    // Only before the actual analysis has started
+    return m_waveformSummary && m_currentSummaryStride == 0 && m_stride.m_position == 0;
+}
+
+void AnalyzerWaveform::processPreviewExcerpt(
+        mixxx::IndexRange frameRange, const CSAMPLE* pIn, SINT count) {
+    VERIFY_OR_DEBUG_ASSERT(m_waveformSummary) {
+        return;
+    }
+    const SINT numFrames = count / m_channelCount;
+    count = numFrames * mixxx::audio::ChannelCount::stereo();
+    CSAMPLE* pMixedChannel = nullptr;
+    const CSAMPLE* pWaveformInput = stereoSamples(pIn, numFrames, &pMixedChannel);
+    VERIFY_OR_DEBUG_ASSERT(pWaveformInput) {
+        return;
+    }
+    // The filters are reset before the actual analysis
+    filterSamples(pWaveformInput, count);
+
+    // Estimate the summary like averageStore() from the maxima of the
+    // strides of the main waveform. The first stride is skipped, because
+    // the filters have not settled after seeking.
+    const double strideLength = m_waveform->getAudioVisualRatio();
+    float strideMaxima[ChannelCount][BandCount] = {};
+    float sums[ChannelCount][BandCount] = {};
+    int strideCount = 0;
+    int skippedStrides = 0;
+    for (SINT frame = 0; frame < numFrames; ++frame) {
+        for (int channel = 0; channel < ChannelCount; ++channel) {
+            const SINT i = frame * ChannelCount + channel;
+            storeIfGreater(&strideMaxima[channel][AllBand], fabs(pWaveformInput[i]));
+            storeIfGreater(&strideMaxima[channel][Low], fabs(m_buffers.low[i]));
+            storeIfGreater(&strideMaxima[channel][Mid], fabs(m_buffers.mid[i]));
+            storeIfGreater(&strideMaxima[channel][High], fabs(m_buffers.high[i]));
+        }
+        if (fmod(frame + 1, strideLength) < 1) {
+            if (skippedStrides++ > 0) {
+                for (int channel = 0; channel < ChannelCount; ++channel) {
+                    for (int band = 0; band < BandCount; ++band) {
+                        sums[channel][band] += strideMaxima[channel][band];
+                    }
+                }
+                ++strideCount;
+            }
+            for (int channel = 0; channel < ChannelCount; ++channel) {
+                SampleUtil::clear(strideMaxima[channel], BandCount);
+            }
+        }
+    }
+    if (pMixedChannel) {
+        SampleUtil::free(pMixedChannel);
+    }
+    if (strideCount == 0) {
+        return;
+    }
+
+    WaveformData datum[ChannelCount];
+    for (int channel = 0; channel < ChannelCount; ++channel) {
+        const auto toByte = [&](int band) {
+            return static_cast<unsigned char>(std::min(255.0,
+                    m_stride.m_postScaleConversion * sums[channel][band] / strideCount +
+                            0.5));
+        };
+        datum[channel] = {};
+        datum[channel].filtered.all = toByte(AllBand);
+        datum[channel].filtered.low = toByte(Low);
+        datum[channel].filtered.mid = toByte(Mid);
+        datum[channel].filtered.high = toByte(High);
+    }
+    // Fill all visual samples of the summary that the excerpt represents
+    const double summaryRatio = m_waveformSummary->getAudioVisualRatio();
+    const int visualSampleCount = m_waveformSummary->getDataSize() / ChannelCount;
+    const int firstVisualSample = static_cast<int>(frameRange.start() / summaryRatio);
+    const int lastVisualSample = std::min(visualSampleCount,
+            static_cast<int>(std::ceil(frameRange.end() / summaryRatio)));
+    for (int visualSample = firstVisualSample; visualSample < lastVisualSample; ++visualSample) {
+        for (int channel = 0; channel < ChannelCount; ++channel) {
+            m_waveformSummaryData[visualSample * ChannelCount + channel] = datum[channel];
+        }
+    }
+}
+
+void AnalyzerWaveform::finishPreview() {
+    VERIFY_OR_DEBUG_ASSERT(m_waveformSummary) {
+        return;
+    }
+    // The actual analysis starts with settled filters
+    destroyFilters();
+    createFilters(m_sampleRate);
+    m_waveformSummary->setPreview(true);
+    // Notifies the overview about the preview
+    m_pTrack->setWaveformSummary(m_waveformSummary);
+}
+
 void AnalyzerWaveform::cleanup() {
+    m_pTrack.reset();
     m_waveform.clear();
     m_waveformData = nullptr;
     m_waveformSummary.clear();
@@ -324,6 +466,8 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
     if (m_waveform) {
         m_waveform->setSaveState(Waveform::SaveState::SavePending);
         m_waveform->setCompletion(m_waveform->getDataSize());
+        // Allows to render the zoomed out waveform efficiently
+        m_waveform->buildMaxLevels();
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
     }
@@ -331,12 +475,14 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
 
     // Force completion to waveform size
     if (m_waveformSummary) {
+        m_waveformSummary->setPreview(false);
         m_waveformSummary->setSaveState(Waveform::SaveState::SavePending);
         m_waveformSummary->setCompletion(m_waveformSummary->getDataSize());
         m_waveformSummary->setVersion(WaveformFactory::currentWaveformSummaryVersion());
         m_waveformSummary->setDescription(WaveformFactory::currentWaveformSummaryDescription());
     }
     tio->setWaveformSummary(m_waveformSummary);
+    WaveformCache::insert(tio->getId(), m_waveform, m_waveformSummary);
 
 #ifdef TEST_HEAT_MAP
     test_heatMap->save("heatMap.png");
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -33,6 +34,8 @@ struct WaveformStride {
 
     inline void reset() {
         m_position = 0;
+        m_nextStorePosition = nextStorePosition(m_position, m_length);
+        m_nextAverageStorePosition = nextStorePosition(m_position, m_averageLength);
         m_averageDivisor = 0;
         for (int i = 0; i < ChannelCount; ++i) {
             m_overallData[i] = 0.0f;
@@ -43,6 +46,40 @@ struct WaveformStride {
         }
     }
 
+    /// The next position after the given one that completes a stride, i.e.
+    /// the first one for which fmod(position, length) < 1. This avoids
+    /// the costly division for each frame.
+    static int nextStorePosition(int position, double length) {
+        if (!(length > 0)) {
+            return std::numeric_limits<int>::max();
+        }
+        // Starts one before the estimate to compensate rounding errors
+        int next = std::max(position + 1,
+                static_cast<int>(std::ceil(
+                        (std::floor(position / length) + 1) * length)) -
+                        1);
+        while (std::fmod(next, length) >= 1) {
+            ++next;
+        }
+        return next;
+    }
+
+    /// Advances to the next frame. Returns true if it completes a stride
+    /// of the waveform, and sets pAverageComplete if it also completes a
+    /// stride of the summary.
+    inline bool advance(bool* pAverageComplete) {
+        ++m_position;
+        *pAverageComplete = m_position == m_nextAverageStorePosition;
+        if (*pAverageComplete) {
+            m_nextAverageStorePosition = nextStorePosition(m_position, m_averageLength);
+        }
+        if (m_position != m_nextStorePosition) {
+            return false;
+        }
+        m_nextStorePosition = nextStorePosition(m_position, m_length);
+        return true;
+    }
+
     inline void store(WaveformData* data) {
         for (int i = 0; i < ChannelCount; ++i) {
             WaveformData& datum = *(data + i);
@@ -121,6 +158,8 @@ struct WaveformStride {
     int m_stemCount;
     double m_length;
     double m_averageLength;
+    int m_nextStorePosition;
+    int m_nextAverageStorePosition;
     int m_averagePosition;
     int m_averageDivisor;
 
@@ -134,6 +173,11 @@ struct WaveformStride {
     float m_postScaleConversion;
 };
 
+/// Calculates the waveform and its summary on the CPU of the analyzer
+/// thread. The low, mid and high bands are split by IIR filters, which
+/// depend on their previous output and therefore process a track
+/// sequentially. Batch analyses are parallelized by running one
+/// AnalyzerThread per core instead, there is no GPU backend.
 class AnalyzerWaveform : public Analyzer {
   public:
     AnalyzerWaveform(
@@ -145,6 +189,10 @@ class AnalyzerWaveform : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
+    bool wantsPreview() const override;
+    void processPreviewExcerpt(
+            mixxx::IndexRange frameRange, const CSAMPLE* pIn, SINT count) override;
+    void finishPreview() override;
     bool processSamples(const CSAMPLE* buffer, SINT count) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
@@ -155,12 +203,20 @@ class AnalyzerWaveform : public Analyzer {
     void storeCurrentStridePower();
     void resetCurrentStride();
 
+    /// Returns the stereo samples, downmixed into pMixedChannel
+    /// for stems. The caller must free pMixedChannel.
+    const CSAMPLE* stereoSamples(
+            const CSAMPLE* pIn, SINT numFrames, CSAMPLE** pMixedChannel) const;
+    void filterSamples(const CSAMPLE* pIn, SINT count);
+
     void createFilters(mixxx::audio::SampleRate sampleRate);
     void destroyFilters();
     void storeIfGreater(float* pDest, float source);
 
     mutable AnalysisDao m_analysisDao;
 
+    // Only needed for publishing the preview
+    TrackPointer m_pTrack;
     WaveformPointer m_waveform;
     WaveformPointer m_waveformSummary;
     WaveformData* m_waveformData;
@@ -171,6 +227,7 @@ class AnalyzerWaveform : public Analyzer {
     int m_currentStride;
     int m_currentSummaryStride;
     mixxx::audio::ChannelCount m_channelCount;
+    mixxx::audio::SampleRate m_sampleRate;
 
     struct Filters {
         std::unique_ptr<EngineFilterIIRBase> low;
@@ -0,0 +1,82 @@
+#include "analyzer/audiodigest.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr QCryptographicHash::Algorithm kAudioHashAlgorithm = QCryptographicHash::Sha256;
+
+constexpr SINT kExcerptCount = 16;
+constexpr SINT kExcerptFrames = 1024;
+
+void addData(QCryptographicHash* pCryptoHash, const void* pData, std::size_t size) {
+    pCryptoHash->addData(QByteArray::fromRawData(
+            static_cast<const char*>(pData), static_cast<int>(size)));
+}
+
+void addInteger(QCryptographicHash* pCryptoHash, qint64 value) {
+    const qint64 bigEndianValue = qToBigEndian(value);
+    addData(pCryptoHash, &bigEndianValue, sizeof(bigEndianValue));
+}
+
+} // anonymous namespace
+
+namespace mixxx {
+
+QByteArray digestAudioSource(
+        const AudioSourcePointer& audioSource,
+        SampleBuffer::WritableSlice tempBuffer) {
+    const IndexRange frameRange = audioSource->frameIndexRange();
+    if (frameRange.empty()) {
+        return QByteArray();
+    }
+    const auto& signalInfo = audioSource->getSignalInfo();
+    const SINT excerptFrames = math_min(kExcerptFrames, frameRange.length());
+    DEBUG_ASSERT(signalInfo.frames2samples(excerptFrames) <= tempBuffer.length());
+
+    QCryptographicHash cryptoHash(kAudioHashAlgorithm);
+    addInteger(&cryptoHash, signalInfo.getChannelCount());
+    addInteger(&cryptoHash, signalInfo.getSampleRate());
+    addInteger(&cryptoHash, frameRange.length());
+
+    const SINT excerptCount = math_clamp(
+            frameRange.length() / kExcerptFrames, SINT(1), kExcerptCount);
+    std::vector<qint16> quantizedSamples;
+    for (SINT i = 0; i < excerptCount; ++i) {
+        // Evenly distributed, the last one ends with the track
+        const SINT excerptStart = frameRange.start() +
+                (excerptCount > 1
+                                ? (frameRange.length() - excerptFrames) * i /
+                                        (excerptCount - 1)
+                                : 0);
+        const auto readableSampleFrames =
+                audioSource->readSampleFrames(
+                        WritableSampleFrames(
+                                IndexRange::forward(excerptStart, excerptFrames),
+                                tempBuffer));
+        // The position of incomplete excerpts must be distinguishable
+        addInteger(&cryptoHash, readableSampleFrames.frameIndexRange().start());
+        addInteger(&cryptoHash, readableSampleFrames.frameIndexRange().length());
+        const SINT sampleCount = readableSampleFrames.readableLength();
+        quantizedSamples.resize(sampleCount);
+        const CSAMPLE* pSamples = readableSampleFrames.readableData();
+        for (SINT j = 0; j < sampleCount; ++j) {
+            const auto value = std::lround(
+                    CSAMPLE_clamp(pSamples[j]) *
+                    std::numeric_limits<qint16>::max());
+            quantizedSamples[j] = qToBigEndian(static_cast<qint16>(value));
+        }
+        addData(&cryptoHash,
+                quantizedSamples.data(),
+                quantizedSamples.size() * sizeof(qint16));
+    }
+    return cryptoHash.result();
+}
+
+} // namespace mixxx
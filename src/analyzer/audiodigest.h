@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QByteArray>
+
+#include "sources/audiosource.h"
+#include "util/samplebuffer.h"
+
+namespace mixxx {
+
+/// Identifies the decoded audio signal of a track independent of its file,
+/// i.e. copies of the same audio with different tags or in another folder
+/// have the same digest. Only a fixed number of short excerpts are decoded
+/// and quantized to 16 bits to stay fast and tolerant to insignificant
+/// decoding errors. The digest also covers the properties of the signal.
+///
+/// The temporary buffer must fit 1024 frames of the audio source. Returns
+/// an empty digest if the audio source does not contain any frames.
+QByteArray digestAudioSource(
+        const AudioSourcePointer& audioSource,
+        SampleBuffer::WritableSlice tempBuffer);
+
+} // namespace mixxx
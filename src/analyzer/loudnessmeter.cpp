@@ -0,0 +1,260 @@
+#include "analyzer/loudnessmeter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr double kSubBlockSeconds = 0.1;
+constexpr int kSubBlocksPerBlock = 4;
+
+// BS.1770: LKFS = -0.691 + 10 * log10(weighted mean square)
+constexpr double kLoudnessOffset = -0.691;
+constexpr double kAbsoluteGateLufs = -70.0;
+constexpr double kRelativeGateLu = -10.0;
+
+// The taps of each phase of the interpolation filter. 12 taps at 4x
+// oversampling match the 48 taps of the example filter in BS.1770-4.
+constexpr SINT kTruePeakTaps = 12;
+
+// The number of frames that are deinterleaved at once
+constexpr SINT kTruePeakSliceFrames = 4096;
+
+double energyToLoudness(double energy) {
+    return kLoudnessOffset + 10 * std::log10(energy);
+}
+
+double loudnessToEnergy(double loudness) {
+    return std::pow(10.0, (loudness - kLoudnessOffset) / 10);
+}
+
+CSAMPLE dotProduct(const CSAMPLE* pIn, const CSAMPLE* pKernel) {
+    CSAMPLE sum = 0;
+    for (SINT i = 0; i < kTruePeakTaps; ++i) {
+        sum += pIn[i] * pKernel[i];
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+// static
+int LoudnessMeter::truePeakOversampling(mixxx::audio::SampleRate sampleRate) {
+    if (sampleRate < 96000) {
+        return 4;
+    }
+    if (sampleRate < 192000) {
+        return 2;
+    }
+    return 1;
+}
+
+LoudnessMeter::LoudnessMeter(mixxx::audio::SampleRate sampleRate)
+        : m_subBlockFrames(static_cast<SINT>(std::round(sampleRate * kSubBlockSeconds))),
+          m_subBlockFrameCount(0),
+          m_subBlockEnergy(0),
+          m_shelfState{},
+          m_highpassState{},
+          m_oversampling(truePeakOversampling(sampleRate)),
+          m_truePeakInputLength(0),
+          m_truePeak(0) {
+    DEBUG_ASSERT(sampleRate.isValid());
+    // The K-weighting filter of BS.1770 for arbitrary sample rates, with
+    // the same parameters as libebur128. 1st stage: high shelf
+    {
+        constexpr double f0 = 1681.974450955533;
+        constexpr double gain = 3.999843853973347;
+        constexpr double q = 0.7071752369554196;
+        const double k = std::tan(M_PI * f0 / sampleRate);
+        const double vh = std::pow(10.0, gain / 20);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1 + k / q + k * k;
+        m_shelfB[0] = (vh + vb * k / q + k * k) / a0;
+        m_shelfB[1] = 2 * (k * k - vh) / a0;
+        m_shelfB[2] = (vh - vb * k / q + k * k) / a0;
+        m_shelfA[0] = 1;
+        m_shelfA[1] = 2 * (k * k - 1) / a0;
+        m_shelfA[2] = (1 - k / q + k * k) / a0;
+    }
+    // 2nd stage: high pass
+    {
+        constexpr double f0 = 38.13547087602444;
+        constexpr double q = 0.5003270373238773;
+        const double k = std::tan(M_PI * f0 / sampleRate);
+        const double a0 = 1 + k / q + k * k;
+        m_highpassB[0] = 1;
+        m_highpassB[1] = -2;
+        m_highpassB[2] = 1;
+        m_highpassA[0] = 1;
+        m_highpassA[1] = 2 * (k * k - 1) / a0;
+        m_highpassA[2] = (1 - k / q + k * k) / a0;
+    }
+
+    if (m_oversampling > 1) {
+        // Windowed sinc for the intermediate phases, normalized to unity
+        // gain. The first phase would only pass the original samples.
+        m_phaseKernels.resize((m_oversampling - 1) * kTruePeakTaps);
+        for (int phase = 1; phase < m_oversampling; ++phase) {
+            CSAMPLE* pKernel = &m_phaseKernels[(phase - 1) * kTruePeakTaps];
+            double sum = 0;
+            for (SINT i = 0; i < kTruePeakTaps; ++i) {
+                const double t = static_cast<double>(phase) / m_oversampling +
+                        kTruePeakTaps / 2 - 1 - i;
+                const double x = M_PI * t;
+                const double sinc = std::sin(x) / x;
+                const double window = 0.5 * (1 + std::cos(x / (kTruePeakTaps / 2)));
+                pKernel[i] = static_cast<CSAMPLE>(sinc * window);
+                sum += sinc * window;
+            }
+            for (SINT i = 0; i < kTruePeakTaps; ++i) {
+                pKernel[i] = static_cast<CSAMPLE>(pKernel[i] / sum);
+            }
+        }
+        for (auto& input : m_truePeakInput) {
+            input = mixxx::SampleBuffer(kTruePeakTaps - 1 + kTruePeakSliceFrames);
+            // The center of the filter is aligned with the first frame
+            input.clear(kTruePeakTaps / 2 - 1);
+        }
+        m_truePeakInputLength = kTruePeakTaps / 2 - 1;
+    }
+}
+
+void LoudnessMeter::processStereoSamples(const CSAMPLE* pIn, SINT count) {
+    const SINT numFrames = count / mixxx::audio::ChannelCount::stereo();
+    applyKWeighting(pIn, numFrames);
+    if (m_oversampling > 1) {
+        for (SINT offset = 0; offset < numFrames;) {
+            const SINT sliceFrames = math_min(
+                    numFrames - offset, kTruePeakSliceFrames);
+            appendTruePeakInput(
+                    pIn + offset * mixxx::audio::ChannelCount::stereo(), sliceFrames);
+            measureTruePeak();
+            offset += sliceFrames;
+        }
+    } else {
+        m_truePeak = math_max(m_truePeak, SampleUtil::maxAbsAmplitude(pIn, count));
+    }
+}
+
+void LoudnessMeter::applyKWeighting(const CSAMPLE* pIn, SINT numFrames) {
+    for (SINT offset = 0; offset < numFrames;) {
+        // Until the end of the current sub-block
+        const SINT segmentFrames = math_min(
+                numFrames - offset, m_subBlockFrames - m_subBlockFrameCount);
+        double energy[2] = {};
+        for (SINT i = offset; i < offset + segmentFrames; ++i) {
+            // Transposed direct form II. The channels are independent
+            // lanes that can be processed in parallel.
+            for (int ch = 0; ch < 2; ++ch) {
+                const double x = pIn[i * 2 + ch];
+                const double shelf = m_shelfB[0] * x + m_shelfState[ch][0];
+                m_shelfState[ch][0] = m_shelfB[1] * x - m_shelfA[1] * shelf +
+                        m_shelfState[ch][1];
+                m_shelfState[ch][1] = m_shelfB[2] * x - m_shelfA[2] * shelf;
+                const double y = m_highpassB[0] * shelf + m_highpassState[ch][0];
+                m_highpassState[ch][0] = m_highpassB[1] * shelf -
+                        m_highpassA[1] * y + m_highpassState[ch][1];
+                m_highpassState[ch][1] = m_highpassB[2] * shelf - m_highpassA[2] * y;
+                energy[ch] += y * y;
+            }
+        }
+        m_subBlockEnergy += energy[0] + energy[1];
+        m_subBlockFrameCount += segmentFrames;
+        if (m_subBlockFrameCount == m_subBlockFrames) {
+            m_subBlockEnergies.push_back(m_subBlockEnergy / m_subBlockFrames);
+            m_subBlockEnergy = 0;
+            m_subBlockFrameCount = 0;
+        }
+        offset += segmentFrames;
+    }
+}
+
+void LoudnessMeter::appendTruePeakInput(const CSAMPLE* pIn, SINT numFrames) {
+    DEBUG_ASSERT(m_truePeakInputLength + numFrames <= m_truePeakInput[0].size());
+    CSAMPLE* pLeft = m_truePeakInput[0].data() + m_truePeakInputLength;
+    CSAMPLE* pRight = m_truePeakInput[1].data() + m_truePeakInputLength;
+    if (pIn) {
+        SampleUtil::deinterleaveBuffer(pLeft, pRight, pIn, numFrames);
+    } else {
+        SampleUtil::clear(pLeft, numFrames);
+        SampleUtil::clear(pRight, numFrames);
+    }
+    m_truePeakInputLength += numFrames;
+}
+
+void LoudnessMeter::measureTruePeak() {
+    const SINT count = m_truePeakInputLength - (kTruePeakTaps - 1);
+    if (count <= 0) {
+        return;
+    }
+    CSAMPLE peak = m_truePeak;
+    for (auto& input : m_truePeakInput) {
+        const CSAMPLE* pInput = input.data();
+        // The original samples
+        peak = math_max(peak,
+                SampleUtil::maxAbsAmplitude(pInput + kTruePeakTaps / 2 - 1, count));
+        // The interpolated samples in between
+        for (int phase = 1; phase < m_oversampling; ++phase) {
+            const CSAMPLE* pKernel = &m_phaseKernels[(phase - 1) * kTruePeakTaps];
+            for (SINT i = 0; i < count; ++i) {
+                peak = math_max(peak, std::abs(dotProduct(pInput + i, pKernel)));
+            }
+        }
+        // Keep the history for the next samples
+        std::copy(input.data() + count, input.data() + m_truePeakInputLength, input.data());
+    }
+    m_truePeakInputLength -= count;
+    m_truePeak = peak;
+}
+
+void LoudnessMeter::finalize() {
+    if (m_oversampling > 1) {
+        appendTruePeakInput(nullptr, kTruePeakTaps / 2);
+        measureTruePeak();
+    }
+}
+
+double LoudnessMeter::integratedLoudness() const {
+    const auto subBlockCount = static_cast<SINT>(m_subBlockEnergies.size());
+    if (subBlockCount < kSubBlocksPerBlock) {
+        return kLoudnessUndefined;
+    }
+    std::vector<double> blockEnergies;
+    blockEnergies.reserve(subBlockCount - kSubBlocksPerBlock + 1);
+    for (SINT i = kSubBlocksPerBlock; i <= subBlockCount; ++i) {
+        double energy = 0;
+        for (SINT j = i - kSubBlocksPerBlock; j < i; ++j) {
+            energy += m_subBlockEnergies[j];
+        }
+        blockEnergies.push_back(energy / kSubBlocksPerBlock);
+    }
+
+    const auto gatedMeanEnergy = [&blockEnergies](double threshold) {
+        double sum = 0;
+        SINT count = 0;
+        for (const double blockEnergy : blockEnergies) {
+            if (blockEnergy > threshold) {
+                sum += blockEnergy;
+                ++count;
+            }
+        }
+        return count > 0 ? sum / count : 0.0;
+    };
+    const double absoluteThreshold = loudnessToEnergy(kAbsoluteGateLufs);
+    const double absoluteGatedEnergy = gatedMeanEnergy(absoluteThreshold);
+    if (absoluteGatedEnergy <= 0) {
+        return kLoudnessUndefined;
+    }
+    const double relativeThreshold = loudnessToEnergy(
+            energyToLoudness(absoluteGatedEnergy) + kRelativeGateLu);
+    const double gatedEnergy = gatedMeanEnergy(
+            math_max(absoluteThreshold, relativeThreshold));
+    if (gatedEnergy <= 0) {
+        return kLoudnessUndefined;
+    }
+    return energyToLoudness(gatedEnergy);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// Measures the integrated loudness and the true peak of a stereo signal
+/// according to ITU-R BS.1770-4 / EBU R128 in a single pass.
+///
+/// Both channels are filtered in lockstep and the oversampling filter for
+/// the true peak works on contiguous deinterleaved samples. This allows the
+/// compiler to vectorize the inner loops without reordering operations,
+/// i.e. without -ffast-math.
+class LoudnessMeter final {
+  public:
+    /// The loudness of signals that are too short or silent
+    static constexpr double kLoudnessUndefined =
+            -std::numeric_limits<double>::infinity();
+
+    explicit LoudnessMeter(mixxx::audio::SampleRate sampleRate);
+
+    /// The oversampling factor for the true peak: 4x below 96 kHz,
+    /// 2x below 192 kHz and only the sample peak above.
+    static int truePeakOversampling(mixxx::audio::SampleRate sampleRate);
+
+    void processStereoSamples(const CSAMPLE* pIn, SINT count);
+
+    /// Completes the measurement of the true peak.
+    void finalize();
+
+    /// The gated loudness in LUFS or kLoudnessUndefined.
+    double integratedLoudness() const;
+
+    /// The maximum absolute amplitude of the oversampled signal of both
+    /// channels.
+    CSAMPLE truePeak() const {
+        return m_truePeak;
+    }
+
+  private:
+    void applyKWeighting(const CSAMPLE* pIn, SINT numFrames);
+    void appendTruePeakInput(const CSAMPLE* pIn, SINT numFrames);
+    void measureTruePeak();
+
+    // Squared and K-weighted energy of all complete 100 ms sub-blocks.
+    // The 400 ms gating blocks overlap by 75%, i.e. each one consists of
+    // four consecutive sub-blocks.
+    std::vector<double> m_subBlockEnergies;
+    const SINT m_subBlockFrames;
+    SINT m_subBlockFrameCount;
+    double m_subBlockEnergy;
+
+    // Coefficients and states of the two cascaded biquads for both
+    // channels. Normalized to a0 = 1.
+    double m_shelfB[3];
+    double m_shelfA[3];
+    double m_highpassB[3];
+    double m_highpassA[3];
+    double m_shelfState[2][2];
+    double m_highpassState[2][2];
+
+    // Polyphase interpolation filter
+    const int m_oversampling;
+    std::vector<CSAMPLE> m_phaseKernels;
+    mixxx::SampleBuffer m_truePeakInput[2];
+    SINT m_truePeakInputLength;
+    CSAMPLE m_truePeak;
+};
@@ -76,7 +76,7 @@ AnalyzerKeyFinder::AnalyzerKeyFinder()
 }
 
 AnalyzerPluginInfo AnalyzerKeyFinder::pluginInfo() {
-    return AnalyzerPluginInfo(pluginId, pluginAuthor, pluginName, false);
+    return AnalyzerPluginInfo(pluginId, pluginAuthor, pluginName, false, true);
 }
 
 bool AnalyzerKeyFinder::initialize(mixxx::audio::SampleRate sampleRate) {
@@ -104,6 +104,27 @@ bool AnalyzerKeyFinder::processSamples(const CSAMPLE* pIn, SINT iLen) {
     return true;
 }
 
+bool AnalyzerKeyFinder::processMonoSamples(const CSAMPLE* pIn, SINT iLen) {
+    if (m_audioData.getChannels() != 1 ||
+            m_audioData.getSampleCount() != static_cast<unsigned int>(iLen)) {
+        // KeyFinder downmixes the signal anyway. The size of the
+        // decimated chunks varies slightly.
+        const auto frameRate = m_audioData.getFrameRate();
+        m_audioData = KeyFinder::AudioData();
+        m_audioData.setFrameRate(frameRate);
+        m_audioData.setChannels(1);
+        m_audioData.addToSampleCount(iLen);
+    }
+
+    m_currentFrame += iLen;
+
+    for (SINT frame = 0; frame < iLen; frame++) {
+        m_audioData.setSampleByFrame(frame, 0, pIn[frame]);
+    }
+    m_keyFinder.progressiveChromagram(m_audioData, m_workspace);
+    return true;
+}
+
 bool AnalyzerKeyFinder::finalize() {
     m_keyFinder.finalChromagram(m_workspace);
     ChromaticKey finalKey = chromaticKeyFromKeyFinderKeyT(
@@ -19,6 +19,7 @@ class AnalyzerKeyFinder : public AnalyzerKeyPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processMonoSamples(const CSAMPLE* pIn, SINT iLen) override;
     bool finalize() override;
 
     KeyChangeList getKeyChanges() const override {
@@ -6,8 +6,11 @@
 #include "track/beats.h"
 #include "track/bpm.h"
 #include "track/keys.h"
+#include "util/assert.h"
 #include "util/types.h"
 
+class AnalyzerSpectrum;
+
 namespace mixxx {
 
 class AnalyzerPluginInfo {
@@ -15,11 +18,13 @@ class AnalyzerPluginInfo {
     AnalyzerPluginInfo(const QString& id,
             const QString& author,
             const QString& name,
-            bool isConstantTempoSupported)
+            bool isConstantTempoSupported,
+            bool isMonoInputSupported = false)
             : m_id(id),
               m_author(author),
               m_name(name),
-              m_isConstantTempoSupported(isConstantTempoSupported) {
+              m_isConstantTempoSupported(isConstantTempoSupported),
+              m_isMonoInputSupported(isMonoInputSupported) {
     }
 
     const QString& id() const {
@@ -38,11 +43,18 @@ class AnalyzerPluginInfo {
         return m_isConstantTempoSupported;
     }
 
+    /// Plugins that analyze a mono downmix of the signal also accept
+    /// mono samples, i.e. the decimated signal of AnalyzerDecimator.
+    bool isMonoInputSupported() const {
+        return m_isMonoInputSupported;
+    }
+
   private:
     QString m_id;
     QString m_author;
     QString m_name;
     bool m_isConstantTempoSupported;
+    bool m_isMonoInputSupported;
 };
 
 class AnalyzerPlugin {
@@ -62,6 +74,22 @@ class AnalyzerPlugin {
 
     virtual bool initialize(mixxx::audio::SampleRate sampleRate) = 0;
     virtual bool processSamples(const CSAMPLE* pIn, SINT iLen) = 0;
+    /// Only invoked if the plugin info declares that mono input is
+    /// supported. Must not be mixed with processSamples().
+    virtual bool processMonoSamples(const CSAMPLE* pIn, SINT iLen) {
+        Q_UNUSED(pIn);
+        Q_UNUSED(iLen);
+        DEBUG_ASSERT(!"Mono input is not supported");
+        return false;
+    }
+    /// Plugins that compute short-time spectra might subscribe to the
+    /// shared front-end instead. They keep receiving the samples for
+    /// keeping track of the analyzed range. Returns false if this is
+    /// not supported.
+    virtual bool subscribeSpectrum(AnalyzerSpectrum* pSpectrum) {
+        Q_UNUSED(pSpectrum);
+        return false;
+    }
     virtual bool finalize() = 0;
 };
 
@@ -40,7 +40,8 @@ DFConfig makeDetectionFunctionConfig(int stepSizeFrames, int windowSize) {
 
 AnalyzerQueenMaryBeats::AnalyzerQueenMaryBeats()
         : m_windowSize(0),
-          m_stepSizeFrames(0) {
+          m_stepSizeFrames(0),
+          m_receivedFrames(0) {
 }
 
 AnalyzerQueenMaryBeats::~AnalyzerQueenMaryBeats() {
@@ -48,6 +49,8 @@ AnalyzerQueenMaryBeats::~AnalyzerQueenMaryBeats() {
 
 bool AnalyzerQueenMaryBeats::initialize(mixxx::audio::SampleRate sampleRate) {
     m_detectionResults.clear();
+    m_spectrumSubscription.reset();
+    m_receivedFrames = 0;
     m_sampleRate = sampleRate;
     m_stepSizeFrames = static_cast<int>(m_sampleRate * kStepSecs);
     m_windowSize = MathUtilities::nextPowerOfTwo(m_sampleRate / kMaximumBinSizeHz);
@@ -71,11 +74,50 @@ bool AnalyzerQueenMaryBeats::processSamples(const CSAMPLE* pIn, SINT iLen) {
         return false;
     }
 
+    if (m_spectrumSubscription) {
+        m_receivedFrames += iLen / kAnalysisChannels;
+        return true;
+    }
     return m_helper.processStereoSamples(pIn, iLen);
 }
 
+bool AnalyzerQueenMaryBeats::processMonoSamples(const CSAMPLE* pIn, SINT iLen) {
+    if (!m_pDetectionFunction) {
+        return false;
+    }
+
+    if (m_spectrumSubscription) {
+        m_receivedFrames += iLen;
+        return true;
+    }
+    return m_helper.processMonoSamples(pIn, iLen);
+}
+
+bool AnalyzerQueenMaryBeats::subscribeSpectrum(AnalyzerSpectrum* pSpectrum) {
+    VERIFY_OR_DEBUG_ASSERT(m_pDetectionFunction) {
+        return false;
+    }
+    m_spectrumSubscription = pSpectrum->subscribe(
+            m_windowSize, m_stepSizeFrames, [this](const AnalyzerSpectrumFrame& frame) {
+                // The same frames that m_helper would provide for the
+                // received samples, including the padding when finalizing
+                if (frame.centerFrame > m_receivedFrames + m_windowSize / 2) {
+                    return;
+                }
+                m_detectionResults.push_back(
+                        m_pDetectionFunction->processFrequencyDomain(
+                                frame.reals, frame.imags));
+            });
+    return static_cast<bool>(m_spectrumSubscription);
+}
+
 bool AnalyzerQueenMaryBeats::finalize() {
-    m_helper.finalize();
+    if (m_spectrumSubscription) {
+        // The host has already finalized the spectrum
+        m_spectrumSubscription.reset();
+    } else {
+        m_helper.finalize();
+    }
 
     int nonZeroCount = static_cast<int>(m_detectionResults.size());
     while (nonZeroCount > 0 && m_detectionResults.at(nonZeroCount - 1) <= 0.0) {
@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+#include "analyzer/analyzerspectrum.h"
 #include "analyzer/plugins/analyzerplugin.h"
 #include "analyzer/plugins/buffering_utils.h"
 
@@ -20,6 +21,7 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
                 "qm-tempotracker:0",
                 QObject::tr("Queen Mary University London"),
                 QObject::tr("Queen Mary Tempo and Beat Tracker"),
+                true,
                 true);
     }
 
@@ -32,6 +34,8 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processMonoSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool subscribeSpectrum(AnalyzerSpectrum* pSpectrum) override;
     bool finalize() override;
 
     bool supportsBeatTracking() const override {
@@ -49,6 +53,9 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
     int m_windowSize;
     int m_stepSizeFrames;
     std::vector<double> m_detectionResults;
+    // Replaces m_helper while subscribed
+    AnalyzerSpectrum::Subscription m_spectrumSubscription;
+    SINT m_receivedFrames;
     QVector<mixxx::audio::FramePos> m_resultBeats;
 };
 
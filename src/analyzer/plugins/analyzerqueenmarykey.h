@@ -20,7 +20,8 @@ class AnalyzerQueenMaryKey : public AnalyzerKeyPlugin {
                 "qm-keydetector:2",
                 QObject::tr("Queen Mary University London"),
                 QObject::tr("Queen Mary Key Detector"),
-                false);
+                false,
+                true);
     }
 
     AnalyzerQueenMaryKey();
@@ -32,6 +33,7 @@ class AnalyzerQueenMaryKey : public AnalyzerKeyPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processMonoSamples(const CSAMPLE* pIn, SINT iLen) override;
     bool finalize() override;
 
     KeyChangeList getKeyChanges() const override {
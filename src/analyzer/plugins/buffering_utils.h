@@ -9,7 +9,8 @@ namespace mixxx {
 
 // This is used for downmixing a stereo buffer into mono and framing it into
 // overlapping windows as is typically necessary when taking a short-time
-// Fourier transform.
+// Fourier transform. Mono buffers that have already been downmixed are
+// only framed.
 class DownmixAndOverlapHelper {
   public:
     DownmixAndOverlapHelper() = default;
@@ -25,10 +26,14 @@ class DownmixAndOverlapHelper {
             const CSAMPLE* pInput,
             size_t inputStereoSamples);
 
+    bool processMonoSamples(
+            const CSAMPLE* pInput,
+            size_t inputMonoSamples);
+
     bool finalize();
 
   private:
-    bool processInner(const CSAMPLE* pInput, size_t numInputFrames);
+    bool processInner(const CSAMPLE* pInput, size_t numInputFrames, size_t numChannels);
 
     std::vector<double> m_buffer;
     // The window size in frames.
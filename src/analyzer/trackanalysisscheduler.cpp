@@ -1,5 +1,7 @@
 #include "analyzer/trackanalysisscheduler.h"
 
+#include <algorithm>
+
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzertrack.h"
 #include "moc_trackanalysisscheduler.cpp"
@@ -15,6 +17,15 @@ constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
+// Cores that are not occupied by a worker thread are used for running the
+// analyzers of each track concurrently.
+int numAnalyzerWorkersPerThread(int numWorkerThreads) {
+    if (numWorkerThreads <= 0) {
+        return 0;
+    }
+    return std::max(0, QThread::idealThreadCount() / numWorkerThreads - 1);
+}
+
 void deleteTrackAnalysisScheduler(TrackAnalysisScheduler* plainPtr) {
     if (plainPtr) {
         // Trigger stop
@@ -53,6 +64,14 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         const UserSettingsPointer& pConfig,
         AnalyzerModeFlags modeFlags)
         : m_pEnvironment(std::move(pEnvironment)),
+          m_pDbConnectionPool(pDbConnectionPool),
+          m_pConfig(pConfig),
+          m_modeFlags(modeFlags),
+          m_numAnalyzerWorkers(numAnalyzerWorkersPerThread(numWorkerThreads)),
+          m_priorityWorkerId(-1),
+          m_preemptedWorkerId(-1),
+          m_suspended(true),
+          m_prioritizedTracksCount(0),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
@@ -73,15 +92,7 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
     // 1st pass: Create worker threads
     m_workers.reserve(numWorkerThreads);
     for (int threadId = 0; threadId < numWorkerThreads; ++threadId) {
-        m_workers.emplace_back(AnalyzerThread::createInstance(
-                threadId,
-                pDbConnectionPool,
-                pConfig,
-                modeFlags));
-        connect(m_workers.back().thread(),
-                &AnalyzerThread::progress,
-                this,
-                &TrackAnalysisScheduler::onWorkerThreadProgress);
+        addWorker();
     }
     // 2nd pass: Start worker threads in a suspended state
     for (const auto& worker: m_workers) {
@@ -94,6 +105,25 @@ TrackAnalysisScheduler::~TrackAnalysisScheduler() {
     kLogger.debug() << "Destroying";
 }
 
+int TrackAnalysisScheduler::addWorker() {
+    const int threadId = static_cast<int>(m_workers.size());
+    m_workers.emplace_back(AnalyzerThread::createInstance(
+            threadId,
+            m_pDbConnectionPool,
+            m_pConfig,
+            m_modeFlags,
+            m_numAnalyzerWorkers));
+    connect(m_workers.back().thread(),
+            &AnalyzerThread::progress,
+            this,
+            &TrackAnalysisScheduler::onWorkerThreadProgress);
+    connect(m_workers.back().thread(),
+            &AnalyzerThread::throughput,
+            this,
+            &TrackAnalysisScheduler::onWorkerThreadThroughput);
+    return threadId;
+}
+
 void TrackAnalysisScheduler::emitProgressOrFinished() {
     // The finished() signal is emitted regardless of when the last
     // signal has been emitted
@@ -101,6 +131,17 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
         m_currentTrackProgress = kAnalyzerProgressUnknown;
         m_currentTrackNumber = 0;
         m_dequeuedTracksCount = 0;
+        if (m_throughput.trackCount > 0) {
+            m_throughput.elapsedDuration = m_throughputTimer.elapsed();
+            kLogger.info()
+                    << "Analyzed" << m_throughput.trackCount << "tracks in"
+                    << m_throughput.elapsedDuration.formatSecondsWithUnit()
+                    << "-" << m_throughput.tracksPerMinute() << "tracks/min,"
+                    << "decoding" << m_throughput.decodeDuration.formatSecondsWithUnit()
+                    << "analyzing" << m_throughput.analyzeDuration.formatSecondsWithUnit();
+            emit throughput(m_throughput);
+            m_throughput = AnalyzerThroughput();
+        }
         emit finished();
         return;
     }
@@ -179,6 +220,14 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
             totalTracksCount);
 }
 
+void TrackAnalysisScheduler::onWorkerThreadThroughput(
+        int threadId, AnalyzerThroughput trackThroughput) {
+    Q_UNUSED(threadId);
+    // The wall clock time of the whole batch is measured by the scheduler
+    trackThroughput.elapsedDuration = mixxx::Duration::empty();
+    m_throughput += trackThroughput;
+}
+
 void TrackAnalysisScheduler::onWorkerThreadProgress(
         int threadId,
         AnalyzerThreadState threadState,
@@ -202,6 +251,10 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
         worker.onAnalyzerProgress(analyzerProgress);
         submitNextTrack(&worker);
+        if (threadId == m_priorityWorkerId && !worker.isBusy()) {
+            // All prioritized tracks have been analyzed
+            releasePreemptedWorker();
+        }
         break;
     case AnalyzerThreadState::Busy:
         DEBUG_ASSERT(trackId.isValid());
@@ -220,7 +273,7 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
             DEBUG_ASSERT((analyzerProgress == kAnalyzerProgressDone) // success
                     || (analyzerProgress == kAnalyzerProgressUnknown)); // failure
             m_pendingTrackIds.erase(trackId);
-            worker.onAnalyzerProgress(analyzerProgress);
+            worker.onAnalyzerDone(analyzerProgress);
             emit trackProgress(trackId, analyzerProgress);
         }
         break;
@@ -236,13 +289,32 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
     emitProgressOrFinished();
 }
 
-bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
+bool TrackAnalysisScheduler::scheduleTrack(
+        AnalyzerScheduledTrack track, Priority priority) {
     VERIFY_OR_DEBUG_ASSERT(track.getTrackId().isValid()) {
         qWarning()
                 << "Cannot schedule track with invalid id"
                 << track.getTrackId();
         return false;
     }
+    if (priority == Priority::High) {
+        const auto prioritizedEnd = m_queuedTracks.begin() + m_prioritizedTracksCount;
+        const auto sameTrack = [&track](const AnalyzerScheduledTrack& queuedTrack) {
+            return queuedTrack.getTrackId() == track.getTrackId();
+        };
+        if (std::any_of(m_queuedTracks.begin(), prioritizedEnd, sameTrack)) {
+            // Already prioritized
+            return true;
+        }
+        // Move the track from the normal part of the queue
+        const auto it = std::find_if(prioritizedEnd, m_queuedTracks.end(), sameTrack);
+        if (it != m_queuedTracks.end()) {
+            m_queuedTracks.erase(it);
+        }
+        m_queuedTracks.insert(m_queuedTracks.begin() + m_prioritizedTracksCount, track);
+        ++m_prioritizedTracksCount;
+        return true;
+    }
     m_queuedTracks.push_back(track);
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
@@ -263,6 +335,7 @@ int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>&
 
 void TrackAnalysisScheduler::suspend() {
     kLogger.debug() << "Suspending";
+    m_suspended = true;
     for (auto& worker: m_workers) {
         worker.suspendThread();
     }
@@ -270,14 +343,78 @@ void TrackAnalysisScheduler::suspend() {
 
 void TrackAnalysisScheduler::resume() {
     kLogger.debug() << "Resuming";
+    m_suspended = false;
     for (auto& worker: m_workers) {
+        if (!worker.isPreempted()) {
+            worker.resumeThread();
+        }
+    }
+    preemptWorkerIfNeeded();
+}
+
+void TrackAnalysisScheduler::preemptWorkerIfNeeded() {
+    if (m_prioritizedTracksCount == 0 || m_preemptedWorkerId >= 0) {
+        return;
+    }
+    Worker* pPreemptedWorker = nullptr;
+    for (auto& worker : m_workers) {
+        if (!worker || worker.thread()->id() == m_priorityWorkerId) {
+            continue;
+        }
+        if (!worker.isBusy()) {
+            // This worker picks up the next prioritized track
+            return;
+        }
+        if (!worker.isPrioritized() && !pPreemptedWorker) {
+            pPreemptedWorker = &worker;
+        }
+    }
+    if (!pPreemptedWorker) {
+        // All workers are busy with prioritized tracks
+        return;
+    }
+    m_preemptedWorkerId = pPreemptedWorker->thread()->id();
+    kLogger.debug()
+            << "Suspending worker thread"
+            << m_preemptedWorkerId
+            << "in favor of prioritized tracks";
+    pPreemptedWorker->preempt();
+    if (m_priorityWorkerId < 0) {
+        m_priorityWorkerId = addWorker();
+        m_workers.back().thread()->start(kWorkerThreadPriority);
+        return;
+    }
+    // Only released after all prioritized tracks have been analyzed
+    auto& priorityWorker = m_workers.at(m_priorityWorkerId);
+    DEBUG_ASSERT(!priorityWorker.isBusy());
+    // Wakes up the idle thread that reports back and receives the next track
+    priorityWorker.resumeThread();
+}
+
+void TrackAnalysisScheduler::releasePreemptedWorker() {
+    if (m_preemptedWorkerId < 0) {
+        return;
+    }
+    auto& worker = m_workers.at(m_preemptedWorkerId);
+    m_preemptedWorkerId = -1;
+    worker.releasePreemption();
+    if (!m_suspended) {
         worker.resumeThread();
     }
 }
 
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
-    while (!m_queuedTracks.empty()) {
+    if (worker->isBusy()) {
+        return false;
+    }
+    // The priority worker is reserved for prioritized tracks and only
+    // runs while another worker is preempted
+    const bool isPriorityWorker = worker->thread()->id() == m_priorityWorkerId;
+    while (!m_queuedTracks.empty() &&
+            (!isPriorityWorker ||
+                    (m_prioritizedTracksCount > 0 && m_preemptedWorkerId >= 0))) {
+        const bool prioritized = m_prioritizedTracksCount > 0;
         AnalyzerScheduledTrack nextScheduledTrack = m_queuedTracks.front();
         TrackId nextTrackId = nextScheduledTrack.getTrackId();
         DEBUG_ASSERT(nextTrackId.isValid());
@@ -287,8 +424,12 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
             if (nextTrackPtr) {
                 AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
-                    if (worker->submitNextTrack(std::move(nextTrack))) {
-                        m_queuedTracks.pop_front();
+                    if (worker->submitNextTrack(std::move(nextTrack), prioritized)) {
+                        popQueuedTrack();
+                        if (m_pendingTrackIds.size() == 1 && m_throughput.trackCount == 0) {
+                            // First track of a new batch
+                            m_throughputTimer.start();
+                        }
                         ++m_dequeuedTracksCount;
                         return true;
                     } else {
@@ -319,12 +460,20 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     << nextTrackId;
         }
         // Skip this track
-        m_queuedTracks.pop_front();
+        popQueuedTrack();
         ++m_dequeuedTracksCount;
     }
     return false;
 }
 
+void TrackAnalysisScheduler::popQueuedTrack() {
+    DEBUG_ASSERT(!m_queuedTracks.empty());
+    m_queuedTracks.pop_front();
+    if (m_prioritizedTracksCount > 0) {
+        --m_prioritizedTracksCount;
+    }
+}
+
 void TrackAnalysisScheduler::stop() {
     kLogger.debug() << "Stopping";
     for (auto& worker: m_workers) {
@@ -333,6 +482,16 @@ void TrackAnalysisScheduler::stop() {
     // The worker threads are still running at this point
     // and m_workers must not be modified!
     m_queuedTracks.clear();
+    m_prioritizedTracksCount = 0;
+    m_preemptedWorkerId = -1;
     m_pendingTrackIds.clear();
     DEBUG_ASSERT((allTracksFinished()));
 }
+
+void TrackAnalysisScheduler::waitForWorkerThreads() {
+    for (const auto& worker : m_workers) {
+        if (worker) {
+            worker.thread()->wait();
+        }
+    }
+}
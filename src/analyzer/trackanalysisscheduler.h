@@ -9,6 +9,7 @@
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzerthread.h"
 #include "util/db/dbconnectionpool.h"
+#include "util/performancetimer.h"
 
 /// Callbacks for triggering side-effects in the outer context of
 /// TrackAnalysisScheduler.
@@ -27,6 +28,15 @@ class TrackAnalysisScheduler : public QObject {
 
   public:
     typedef std::unique_ptr<TrackAnalysisScheduler, void(*)(TrackAnalysisScheduler*)> Pointer;
+
+    enum class Priority {
+        Normal,
+        /// Analyzed before all tracks with a normal priority, e.g. tracks
+        /// that have been loaded into a deck. If all workers are busy one
+        /// of them is suspended in favor of an additional worker.
+        High,
+    };
+
     // Subclass that provides a default constructor and nothing else
     class NullPointer: public Pointer {
       public:
@@ -50,9 +60,15 @@ class TrackAnalysisScheduler : public QObject {
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
     // the caller must invoke resume() once.
-    bool scheduleTrack(AnalyzerScheduledTrack track);
+    bool scheduleTrack(AnalyzerScheduledTrack track,
+            Priority priority = Priority::Normal);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
+    // Blocks until all worker threads have exited after stop() has
+    // been invoked. Only needed if the host thread shuts down without
+    // returning to its event loop.
+    void waitForWorkerThreads();
+
   public slots:
     void suspend();
 
@@ -68,10 +84,13 @@ class TrackAnalysisScheduler : public QObject {
     void trackProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
     // Current average progress for all scheduled tracks and from all workers
     void progress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
+    // Statistics of all tracks that have been analyzed, emitted before finished()
+    void throughput(AnalyzerThroughput throughput);
     void finished();
 
   private slots:
     void onWorkerThreadProgress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress analyzerProgress);
+    void onWorkerThreadThroughput(int threadId, AnalyzerThroughput trackThroughput);
 
   private:
     // Owns an analyzer thread and buffers the most recent progress update
@@ -82,7 +101,10 @@ class TrackAnalysisScheduler : public QObject {
       public:
         explicit Worker(AnalyzerThread::Pointer thread = AnalyzerThread::NullPointer())
             : m_thread(std::move(thread)),
-              m_analyzerProgress(kAnalyzerProgressUnknown) {
+              m_analyzerProgress(kAnalyzerProgressUnknown),
+              m_busy(false),
+              m_prioritized(false),
+              m_preempted(false) {
         }
         Worker(const Worker&) = delete;
         Worker(Worker&&) = default;
@@ -100,9 +122,39 @@ class TrackAnalysisScheduler : public QObject {
             return m_analyzerProgress;
         }
 
-        bool submitNextTrack(const AnalyzerTrack& track) {
+        // From submitting a track until it has been reported as done
+        bool isBusy() const {
+            return m_busy;
+        }
+
+        // Whether the current track has been scheduled with a high priority
+        bool isPrioritized() const {
+            return m_prioritized;
+        }
+
+        bool isPreempted() const {
+            return m_preempted;
+        }
+
+        bool submitNextTrack(const AnalyzerTrack& track, bool prioritized) {
             DEBUG_ASSERT(m_thread);
-            return m_thread->submitNextTrack(std::move(track));
+            if (!m_thread->submitNextTrack(std::move(track))) {
+                return false;
+            }
+            m_busy = true;
+            m_prioritized = prioritized;
+            return true;
+        }
+
+        void preempt() {
+            DEBUG_ASSERT(m_busy);
+            m_preempted = true;
+            suspendThread();
+        }
+
+        // The thread is resumed by the caller
+        void releasePreemption() {
+            m_preempted = false;
         }
 
         void suspendThread() {
@@ -128,18 +180,39 @@ class TrackAnalysisScheduler : public QObject {
             m_analyzerProgress = analyzerProgress;
         }
 
+        void onAnalyzerDone(AnalyzerProgress analyzerProgress) {
+            onAnalyzerProgress(analyzerProgress);
+            m_busy = false;
+            m_prioritized = false;
+        }
+
         void onThreadExit() {
             DEBUG_ASSERT(m_thread);
             m_thread.reset();
             m_analyzerProgress = kAnalyzerProgressUnknown;
+            m_busy = false;
+            m_prioritized = false;
         }
 
       private:
         AnalyzerThread::Pointer m_thread;
         AnalyzerProgress m_analyzerProgress;
+        bool m_busy;
+        bool m_prioritized;
+        bool m_preempted;
     };
 
+    // Returns the id of the new worker thread that has not been started yet
+    int addWorker();
+
     bool submitNextTrack(Worker* worker);
+    void popQueuedTrack();
+
+    // Suspends a worker that is busy with a track of normal priority
+    // if prioritized tracks are waiting and no worker is available.
+    void preemptWorkerIfNeeded();
+    void releasePreemptedWorker();
+
     void emitProgressOrFinished();
 
     bool allTracksFinished() const {
@@ -149,9 +222,24 @@ class TrackAnalysisScheduler : public QObject {
 
     const std::unique_ptr<const TrackAnalysisSchedulerEnvironment> m_pEnvironment;
 
+    // Needed for creating the priority worker on demand
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
+    const AnalyzerModeFlags m_modeFlags;
+    const int m_numAnalyzerWorkers;
+
     std::vector<Worker> m_workers;
 
+    // The additional worker that only analyzes prioritized tracks
+    // while the preempted worker is suspended, or -1 if none.
+    int m_priorityWorkerId;
+    int m_preemptedWorkerId;
+
+    bool m_suspended;
+
+    // The prioritized tracks are queued in front of all other tracks
     std::deque<AnalyzerScheduledTrack> m_queuedTracks;
+    std::size_t m_prioritizedTracksCount;
 
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
@@ -165,4 +253,7 @@ class TrackAnalysisScheduler : public QObject {
 
     typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
+
+    AnalyzerThroughput m_throughput;
+    PerformanceTimer m_throughputTimer;
 };
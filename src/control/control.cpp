@@ -1,5 +1,7 @@
 #include "control/control.h"
 
+#include <atomic>
+
 #include "control/controlobject.h"
 #include "moc_control.cpp"
 #include "util/mutex.h"
@@ -25,17 +27,72 @@ constexpr Stat::ComputeFlags kComputeFlags = {Stat::COUNT,
         Stat::MIN,
         Stat::MAX};
 
-/// Mutex guarding access to s_qCOHash and s_qCOAliasHash.
-MMutex s_qCOHashMutex;
+/// Lock guarding access to s_qCOHash and s_qCOAliasHash. Lookups only
+/// need to lock for reading and don't block each other.
+MReadWriteLock s_qCOHashLock;
 
 /// Hash of ControlDoublePrivate instantiations.
 QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> s_qCOHash
-        GUARDED_BY(s_qCOHashMutex);
+        GUARDED_BY(s_qCOHashLock);
 
 /// Hash of aliases between ConfigKeys. Solely used for looking up the first
 /// alias associated with a key.
 QHash<ConfigKey, ConfigKey> s_qCOAliasHash
-        GUARDED_BY(s_qCOHashMutex);
+        GUARDED_BY(s_qCOHashLock);
+
+/// Incremented when keys that have been found before might resolve to
+/// a different control, which invalidates the lookup caches of all threads.
+/// Newly created and destroyed controls don't affect the cached entries.
+std::atomic<quint64> s_qCOHashGeneration{0};
+
+/// The controls that have been found by a thread, repeated lookups of
+/// the same key, e.g. while loading a skin or a controller mapping,
+/// don't need to lock s_qCOHashLock.
+struct ControlLookupCache {
+    quint64 generation = 0;
+    QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> controls;
+};
+
+ControlLookupCache& threadLocalLookupCache() {
+    thread_local ControlLookupCache s_lookupCache;
+    return s_lookupCache;
+}
+
+void invalidateLookupCaches() {
+    s_qCOHashGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+/// Returns nullptr if the control doesn't exist or has expired
+QSharedPointer<ControlDoublePrivate> findControl(const ConfigKey& key) {
+    ControlLookupCache& lookupCache = threadLocalLookupCache();
+    // Loaded before reading s_qCOHash, an invalidation that happens in
+    // between is detected by the next lookup
+    const quint64 generation = s_qCOHashGeneration.load(std::memory_order_acquire);
+    if (lookupCache.generation != generation) {
+        lookupCache.controls.clear();
+        lookupCache.generation = generation;
+    } else {
+        const auto it = lookupCache.controls.constFind(key);
+        if (it != lookupCache.controls.constEnd()) {
+            auto pControl = it.value().lock();
+            if (pControl) {
+                return pControl;
+            }
+            lookupCache.controls.erase(it);
+        }
+    }
+
+    QSharedPointer<ControlDoublePrivate> pControl;
+    {
+        const MReadLocker locker(&s_qCOHashLock);
+        // Expired entries are cleaned up by getAllInstances()
+        pControl = s_qCOHash.value(key).lock();
+    }
+    if (pControl) {
+        lookupCache.controls.insert(key, pControl);
+    }
+    return pControl;
+}
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
@@ -57,7 +114,7 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_pBehavior(nullptr),
           m_name(QString()),
           m_description(QString()),
-          m_value(defaultValue),
+          m_pValue(ControlValueArena::instance().allocate(defaultValue)),
           m_defaultValue(defaultValue),
           m_pCreatorCO(pCreatorCO),
           m_trackingKey(bTrack ? statTrackingKey.arg(key.group, key.item) : QString()),
@@ -68,22 +125,22 @@ ControlDoublePrivate::ControlDoublePrivate(
     if (bPersist) {
         UserSettingsPointer pConfig = s_pUserConfig;
         if (pConfig) {
-            m_value.setValue(pConfig->getValue(m_key, defaultValue));
+            m_pValue->setValue(pConfig->getValue(m_key, defaultValue));
         } else {
             DEBUG_ASSERT(!"Can't load persistent value s_pUserConfig is null");
         }
     }
 
     if (!m_trackingKey.isNull()) {
-        Stat::track(m_trackingKey, kStatType, kComputeFlags, m_value.getValue());
+        Stat::track(m_trackingKey, kStatType, kComputeFlags, m_pValue->getValue());
     }
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
-    s_qCOHashMutex.lock();
+    s_qCOHashLock.lockForWrite();
     //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
     s_qCOHash.remove(m_key);
-    s_qCOHashMutex.unlock();
+    s_qCOHashLock.unlock();
 
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
@@ -102,7 +159,7 @@ void ControlDoublePrivate::setUserConfig(const UserSettingsPointer& pConfig) {
 
 // static
 void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
-    MMutexLocker locker(&s_qCOHashMutex);
+    MWriteLocker locker(&s_qCOHashLock);
     VERIFY_OR_DEBUG_ASSERT(alias != key) {
         qWarning() << "cannot create alias with identical key" << key;
         return;
@@ -122,6 +179,8 @@ void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey&
 
     s_qCOAliasHash.insert(key, alias);
     s_qCOHash.insert(alias, pControl);
+    // The alias might have resolved to a different control before
+    invalidateLookupCaches();
 }
 
 // static
@@ -142,38 +201,27 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         return nullptr;
     }
 
-    // Scope for MMutexLocker.
-    {
-        const MMutexLocker locker(&s_qCOHashMutex);
-        const auto it = s_qCOHash.constFind(key);
-        if (it != s_qCOHash.constEnd()) {
-            auto pControl = it.value().lock();
-            if (pControl) {
-                auto actualKey = pControl->getKey();
-                if (actualKey != key) {
-                    qWarning()
-                            << "ControlObject accessed via deprecated key"
-                            << key.group << key.item
-                            << "- use"
-                            << actualKey.group << actualKey.item
-                            << "instead";
-                }
-
-                // Control object already exists
-                if (pCreatorCO) {
-                    qWarning()
-                            << "ControlObject"
-                            << key.group << key.item
-                            << "already created";
-                    DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
-                    return nullptr;
-                }
-                return pControl;
-            } else {
-                // The weak pointer has become invalid and can be cleaned up
-                s_qCOHash.erase(it);
-            }
+    if (auto pControl = findControl(key)) {
+        const auto& actualKey = pControl->getKey();
+        if (actualKey != key) {
+            qWarning()
+                    << "ControlObject accessed via deprecated key"
+                    << key.group << key.item
+                    << "- use"
+                    << actualKey.group << actualKey.item
+                    << "instead";
         }
+
+        // Control object already exists
+        if (pCreatorCO) {
+            qWarning()
+                    << "ControlObject"
+                    << key.group << key.item
+                    << "already created";
+            DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
+            return nullptr;
+        }
+        return pControl;
     }
 
     if (pCreatorCO) {
@@ -184,7 +232,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                         bTrack,
                         bPersist,
                         defaultValue));
-        const MMutexLocker locker(&s_qCOHashMutex);
+        const MWriteLocker locker(&s_qCOHashLock);
         //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
         s_qCOHash.insert(key, pControl);
         return pControl;
@@ -205,7 +253,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
         // Try again with the mutex locked to protect against creating two
         // ControlDoublePrivateConst objects. Access to s_defaultCO itself is
         // thread save.
-        MMutexLocker locker(&s_qCOHashMutex);
+        MWriteLocker locker(&s_qCOHashLock);
         defaultCO = s_pDefaultCO.lock();
         if (!defaultCO) {
             defaultCO = QSharedPointer<ControlDoublePrivate>(new ControlDoublePrivateConst());
@@ -218,7 +266,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstances() {
     QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
+    MWriteLocker locker(&s_qCOHashLock);
     result.reserve(s_qCOHash.size());
     for (auto it = s_qCOHash.constBegin(); it != s_qCOHash.constEnd(); ++it) {
         auto pControl = it.value().lock();
@@ -235,7 +283,7 @@ QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstance
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstances() {
     QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
+    MWriteLocker locker(&s_qCOHashLock);
     result.reserve(s_qCOHash.size());
     for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
         auto pControl = it.value().lock();
@@ -244,12 +292,13 @@ QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstanc
         }
     }
     s_qCOHash.clear();
+    invalidateLookupCaches();
     return result;
 }
 
 //static
 QHash<ConfigKey, ConfigKey> ControlDoublePrivate::getControlAliases() {
-    MMutexLocker locker(&s_qCOHashMutex);
+    MReadLocker locker(&s_qCOHashLock);
     // lock thread-unsafe copy constructors of QHash
     return s_qCOAliasHash;
 }
@@ -287,7 +336,7 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
     if (m_bIgnoreNops && get() == value) {
         return;
     }
-    m_value.setValue(value);
+    m_pValue->setValue(value);
     emit valueChanged(value, pSender);
 
     if (!m_trackingKey.isNull()) {
@@ -8,6 +8,7 @@
 
 #include "control/controlbehavior.h"
 #include "control/controlvalue.h"
+#include "control/controlvaluearena.h"
 #include "preferences/usersettings.h"
 
 class ControlObject;
@@ -97,7 +98,14 @@ class ControlDoublePrivate : public QObject {
     void setAndConfirm(double value, QObject* pSender);
     // Gets the control value.
     double get() const {
-        return m_value.getValue();
+        return m_pValue->getValue();
+    }
+
+    // The storage of the control value, which is valid as long as this
+    // control exists. Allows to read the value without accessing this
+    // object.
+    const ControlValueAtomic<double>* valueStorage() const {
+        return m_pValue.get();
     }
     // Resets the control value to its default.
     void reset();
@@ -194,8 +202,8 @@ class ControlDoublePrivate : public QObject {
     // User-visible, i18n description for what the control does.
     QString m_description;
 
-    // The control value.
-    ControlValueAtomic<double> m_value;
+    // The control value, allocated from the ControlValueArena.
+    const ControlValueArena::ValuePointer m_pValue;
     // The default control value.
     ControlValueAtomic<double> m_defaultValue;
 
@@ -26,6 +26,12 @@ class ControlObjectScript : public ControlProxy {
             return m_scriptConnections.first(); };
     void disconnectAllConnectionsToFunction(const QJSValue& function);
 
+    /// The control that is accessed, without looking up the key. Returns
+    /// nullptr if it has been deleted.
+    ControlObject* getControl() const {
+        return m_pControl->getCreatorCO();
+    }
+
     // Called from update();
     void emitValueChanged() override {
         emit trigger(get(), this);
@@ -0,0 +1,109 @@
+#include "control/controlupdatebus.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/thread_affinity.h"
+#include "util/time.h"
+
+namespace {
+
+bool isSameValue(double value, double lastValue) {
+    return value == lastValue || (std::isnan(value) && std::isnan(lastValue));
+}
+
+} // anonymous namespace
+
+ControlUpdateBus::ControlUpdateBus()
+        : m_nextSubscriptionId(1),
+          m_processing(false) {
+}
+
+// static
+ControlUpdateBus& ControlUpdateBus::instance() {
+    // Deliberately never destroyed, the controls of the remaining
+    // subscriptions must not be released during static destruction
+    static auto* const pInstance = new ControlUpdateBus();
+    return *pInstance;
+}
+
+quint64 ControlUpdateBus::subscribe(const ConfigKey& key,
+        QObject* pReceiver,
+        Callback callback,
+        int maxUpdatesPerSecond) {
+    DEBUG_ASSERT_MAIN_THREAD_AFFINITY();
+    DEBUG_ASSERT(pReceiver);
+    DEBUG_ASSERT(callback);
+    DEBUG_ASSERT(maxUpdatesPerSecond >= 0);
+    const quint64 id = m_nextSubscriptionId++;
+    PollingControlProxy control(key, ControlFlag::NoAssertIfMissing);
+    const double value = control.get();
+    m_subscriptions.push_back(std::make_unique<Subscription>(Subscription{
+            id,
+            std::move(control),
+            std::move(callback),
+            false,
+            maxUpdatesPerSecond > 0
+                    ? mixxx::Duration::fromNanos(1000000000 / maxUpdatesPerSecond)
+                    : mixxx::Duration(),
+            mixxx::Time::elapsed(),
+            value}));
+    QObject::connect(pReceiver, &QObject::destroyed, [this, id]() {
+        unsubscribe(id);
+    });
+    return id;
+}
+
+void ControlUpdateBus::unsubscribe(quint64 subscriptionId) {
+    DEBUG_ASSERT_MAIN_THREAD_AFFINITY();
+    const auto it = std::find_if(m_subscriptions.begin(),
+            m_subscriptions.end(),
+            [subscriptionId](const auto& pSubscription) {
+                return pSubscription->id == subscriptionId;
+            });
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+    if (m_processing) {
+        // Invoked by a callback, removed after processing
+        (*it)->cancelled = true;
+        return;
+    }
+    m_subscriptions.erase(it);
+}
+
+void ControlUpdateBus::process() {
+    DEBUG_ASSERT_MAIN_THREAD_AFFINITY();
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    m_processing = true;
+    // Subscriptions that are added by the callbacks are processed on the
+    // next tick
+    const std::size_t count = m_subscriptions.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        Subscription* pSubscription = m_subscriptions[i].get();
+        if (pSubscription->cancelled) {
+            continue;
+        }
+        if (now - pSubscription->lastUpdate < pSubscription->minInterval) {
+            continue;
+        }
+        const double value = pSubscription->control.get();
+        if (isSameValue(value, pSubscription->lastValue)) {
+            continue;
+        }
+        pSubscription->lastValue = value;
+        pSubscription->lastUpdate = now;
+        pSubscription->callback(value);
+    }
+
+    m_processing = false;
+
+    m_subscriptions.erase(
+            std::remove_if(m_subscriptions.begin(),
+                    m_subscriptions.end(),
+                    [](const auto& pSubscription) {
+                        return pSubscription->cancelled;
+                    }),
+            m_subscriptions.end());
+}
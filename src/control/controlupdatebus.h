@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QObject>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "control/pollingcontrolproxy.h"
+#include "preferences/configobject.h"
+#include "util/duration.h"
+
+/// Delivers the values of controls to GUI widgets once per GUI tick instead
+/// of on every change.
+///
+/// Controls that are changed by the engine in every audio callback, like the
+/// play position, emit valueChanged() far more often than the GUI is able to
+/// repaint. Subscribers receive at most one value per tick and only if it
+/// has changed since their previous update. A subscriber may further reduce
+/// the rate of its updates.
+///
+/// Must only be used from the main thread.
+class ControlUpdateBus final {
+  public:
+    using Callback = std::function<void(double value)>;
+
+    static ControlUpdateBus& instance();
+
+    /// The callback is invoked until the receiver is destroyed or the
+    /// subscription is cancelled. 0 updates per second delivers changes on
+    /// every tick. The value at the time of subscribing is not delivered.
+    /// Returns an id for unsubscribe().
+    quint64 subscribe(const ConfigKey& key,
+            QObject* pReceiver,
+            Callback callback,
+            int maxUpdatesPerSecond = 0);
+    void unsubscribe(quint64 subscriptionId);
+
+    /// Samples all subscribed controls, invoked by GuiTick
+    void process();
+
+  private:
+    ControlUpdateBus();
+
+    struct Subscription {
+        quint64 id;
+        PollingControlProxy control;
+        Callback callback;
+        bool cancelled;
+        mixxx::Duration minInterval;
+        mixxx::Duration lastUpdate;
+        double lastValue;
+    };
+
+    // Stable addresses, the callbacks might add or cancel subscriptions
+    std::vector<std::unique_ptr<Subscription>> m_subscriptions;
+    quint64 m_nextSubscriptionId;
+    bool m_processing;
+};
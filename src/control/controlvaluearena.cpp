@@ -0,0 +1,42 @@
+#include "control/controlvaluearena.h"
+
+#include "util/assert.h"
+
+ControlValueArena::ControlValueArena()
+        : m_lastBlockSize(kValuesPerBlock) {
+}
+
+// static
+ControlValueArena& ControlValueArena::instance() {
+    // Deliberately never destroyed, because controls might still be
+    // released during static destruction
+    static auto* const pInstance = new ControlValueArena();
+    return *pInstance;
+}
+
+ControlValueArena::ValuePointer ControlValueArena::allocate(double initialValue) {
+    Value* pValue;
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        if (!m_releasedValues.empty()) {
+            pValue = m_releasedValues.back();
+            m_releasedValues.pop_back();
+        } else {
+            if (m_lastBlockSize == kValuesPerBlock) {
+                m_blocks.push_back(std::make_unique<Block>());
+                m_lastBlockSize = 0;
+            }
+            pValue = &m_blocks.back()->values[m_lastBlockSize++];
+        }
+    }
+    pValue->setValue(initialValue);
+    return ValuePointer(pValue);
+}
+
+void ControlValueArena::release(Value* pValue) {
+    VERIFY_OR_DEBUG_ASSERT(pValue) {
+        return;
+    }
+    const std::lock_guard<std::mutex> locked(m_mutex);
+    m_releasedValues.push_back(pValue);
+}
@@ -25,6 +25,7 @@ class PollingControlProxy {
             m_pControl = ControlDoublePrivate::getDefaultControl();
         }
         DEBUG_ASSERT(m_pControl);
+        m_pValue = m_pControl->valueStorage();
     }
 
     bool valid() const {
@@ -33,7 +34,8 @@ class PollingControlProxy {
 
     /// Returns the value of the object. Thread safe, non-blocking.
     double get() const {
-        return m_pControl->get();
+        // Doesn't need to access the ControlDoublePrivate
+        return m_pValue->getValue();
     }
 
     /// Returns the bool interpretation of the value
@@ -73,4 +75,6 @@ class PollingControlProxy {
   private:
     // not null
     QSharedPointer<ControlDoublePrivate> m_pControl;
+    // not null, owned by m_pControl
+    const ControlValueAtomic<double>* m_pValue;
 };
@@ -4,56 +4,10 @@
 
 #include <algorithm>
 
+#include "controllers/bulk/bulkiothread.h"
 #include "controllers/bulk/bulksupported.h"
 #include "controllers/defs_controllers.h"
 #include "moc_bulkcontroller.cpp"
-#include "util/cmdlineargs.h"
-#include "util/time.h"
-#include "util/trace.h"
-
-BulkReader::BulkReader(libusb_device_handle *handle, unsigned char in_epaddr)
-        : QThread(),
-          m_phandle(handle),
-          m_stop(0),
-          m_in_epaddr(in_epaddr) {
-}
-
-BulkReader::~BulkReader() {
-}
-
-void BulkReader::stop() {
-    m_stop = 1;
-}
-
-void BulkReader::run() {
-    m_stop = 0;
-    unsigned char data[255];
-
-    while (m_stop.loadAcquire() == 0) {
-        // Blocked polling: The only problem with this is that we can't close
-        // the device until the block is released, which means the controller
-        // has to send more data
-        //result = hid_read_timeout(m_pHidDevice, data, 255, -1);
-
-        // This relieves that at the cost of higher CPU usage since we only
-        // block for a short while (500ms)
-        int transferred;
-        int result;
-
-        result = libusb_bulk_transfer(m_phandle,
-                                      m_in_epaddr,
-                                      data, sizeof(data),
-                                      &transferred, 500);
-        Trace timeout("BulkReader timeout");
-        if (result >= 0) {
-            Trace process("BulkReader process packet");
-            //qDebug() << "Read" << result << "bytes, pointer:" << data;
-            QByteArray byteArray(reinterpret_cast<char*>(data), transferred);
-            emit incomingData(byteArray, mixxx::Time::elapsed());
-        }
-    }
-    qDebug() << "Stopped Reader";
-}
 
 static QString get_string(libusb_device_handle* handle, uint8_t id) {
     unsigned char buf[128] = { 0 };
@@ -84,7 +38,6 @@ BulkController::BulkController(libusb_context* context,
 
     setInputDevice(true);
     setOutputDevice(true);
-    m_pReader = nullptr;
 }
 
 BulkController::~BulkController() {
@@ -169,6 +122,10 @@ int BulkController::open(const QString& resourcePath) {
         qCWarning(m_logBase) << "USB Bulk device" << getName() << "already open";
         return -1;
     }
+    VERIFY_OR_DEBUG_ASSERT(!m_pIoThread) {
+        qCWarning(m_logBase) << "BulkIoThread already present for" << getName();
+        return -1;
+    }
 
     /* Look up endpoint addresses in supported database */
 
@@ -212,24 +169,28 @@ int BulkController::open(const QString& resourcePath) {
 
     startEngine();
 
-    if (m_pReader != nullptr) {
-        qCWarning(m_logBase) << "BulkReader already present for" << getName();
-    } else if (m_pMapping &&
-            !(m_pMapping->getDeviceDirection() &
-                    LegacyControllerMapping::DeviceDirection::Incoming)) {
+    const bool readInput = !m_pMapping ||
+            m_pMapping->getDeviceDirection() &
+                    LegacyControllerMapping::DeviceDirection::Incoming;
+    if (!readInput) {
         qDebug() << "The mapping for the bulk device" << getName()
-                 << "doesn't require reading the data. Ignoring BulkReader "
-                    "setup.";
-    } else {
-        m_pReader = new BulkReader(m_phandle, m_inEndpointAddr);
-        m_pReader->setObjectName(QString("BulkReader %1").arg(getName()));
+                 << "doesn't require reading the data. Ignoring the input "
+                    "endpoint.";
+    }
+    m_pIoThread = std::make_unique<BulkIoThread>(m_context,
+            m_phandle,
+            m_inEndpointAddr,
+            m_outEndpointAddr,
+            readInput,
+            getName());
+    m_pIoThread->setObjectName(QString("BulkIoThread %1").arg(getName()));
 
-        connect(m_pReader, &BulkReader::incomingData, this, &BulkController::receive);
+    connect(m_pIoThread.get(), &BulkIoThread::incomingData, this, &BulkController::receive);
+
+    // Controller input needs to be prioritized since it can affect the
+    // audio directly, like when scratching
+    m_pIoThread->start(QThread::HighPriority);
 
-        // Controller input needs to be prioritized since it can affect the
-        // audio directly, like when scratching
-        m_pReader->start(QThread::HighPriority);
-    }
     applyMapping(resourcePath);
     setOpen(true);
     return 0;
@@ -243,25 +204,28 @@ int BulkController::close() {
 
     qCInfo(m_logBase) << "Shutting down USB Bulk device" << getName();
 
-    // Stop the reading thread
-    if (m_pReader == nullptr &&
-            m_pMapping->getDeviceDirection() &
-                    LegacyControllerMapping::DeviceDirection::Incoming) {
-        qCWarning(m_logBase) << "BulkReader not present for" << getName()
+    // Stop reading, but allow sending in the shutdown of the mapping
+    VERIFY_OR_DEBUG_ASSERT(m_pIoThread) {
+        qCWarning(m_logBase) << "BulkIoThread not present for" << getName()
                              << "yet the device is open!";
-    } else if (m_pReader) {
-        disconnect(m_pReader, &BulkReader::incomingData, this, &BulkController::receive);
-        m_pReader->stop();
-        qCInfo(m_logBase) << "  Waiting on reader to finish";
-        m_pReader->wait();
-        delete m_pReader;
-        m_pReader = nullptr;
+    }
+    else {
+        disconnect(m_pIoThread.get(), &BulkIoThread::incomingData, this, &BulkController::receive);
+        m_pIoThread->stopInput();
     }
 
     // Stop controller engine here to ensure it's done before the device is
     // closed in case it has any final parting messages
     stopEngine();
 
+    if (m_pIoThread) {
+        qCInfo(m_logBase) << "  Waiting on the IO thread to send the remaining data";
+        m_pIoThread->stopWhenAllSent();
+        m_pIoThread->wait();
+        logOutputStatistics();
+        m_pIoThread.reset();
+    }
+
     // Close device
     if (m_interfaceNumber.has_value()) {
         int error = libusb_release_interface(m_phandle, *m_interfaceNumber);
@@ -296,24 +260,32 @@ bool BulkController::sendBytes(const QByteArray& data) {
         return false;
     }
 
-    int ret;
-    int transferred;
-
-    // XXX: don't get drunk again.
-    ret = libusb_bulk_transfer(m_phandle,
-            m_outEndpointAddr,
-            (unsigned char*)data.constData(),
-            data.size(),
-            &transferred,
-            5000 // Send timeout in milliseconds
-    );
-    if (ret < 0) {
-        qCWarning(m_logOutput) << "Unable to send data to" << getName()
-                               << "serial #" << m_sUID << "-" << libusb_error_name(ret);
+    VERIFY_OR_DEBUG_ASSERT(m_pIoThread) {
         return false;
-    } else if (CmdlineArgs::Instance().getControllerDebug()) {
-        qCDebug(m_logOutput) << transferred << "bytes sent to" << getName()
-                             << "serial #" << m_sUID;
     }
+    // Queued, so the mapping isn't blocked by large transfers like the
+    // frames of a screen
+    m_pIoThread->send(data);
     return true;
 }
+
+void BulkController::logOutputStatistics() const {
+    const BulkIoThread::Statistics statistics = m_pIoThread->statistics();
+    if (statistics.transfers == 0) {
+        return;
+    }
+    const double elapsedSeconds = statistics.elapsed.toDoubleSeconds();
+    const double kibPerSecond = elapsedSeconds > 0
+            ? statistics.bytes / 1024.0 / elapsedSeconds
+            : 0;
+    const auto averageLatency = mixxx::Duration::fromNanos(
+            statistics.totalLatency.toIntegerNanos() /
+            static_cast<qint64>(statistics.transfers));
+    qCInfo(m_logOutput).nospace()
+            << "Sent " << statistics.bytes << " bytes in "
+            << statistics.transfers << " transfers to " << getName() << " ("
+            << kibPerSecond << " KiB/s), latency average "
+            << averageLatency.formatMicrosWithUnit() << ", max "
+            << statistics.maxLatency.formatMicrosWithUnit() << ", "
+            << statistics.failedTransfers << " failed transfers";
+}
@@ -1,36 +1,16 @@
 #pragma once
 
-#include <QAtomicInt>
-#include <QThread>
+#include <memory>
 #include <optional>
 
 #include "controllers/controller.h"
 #include "controllers/hid/legacyhidcontrollermapping.h"
 
+class BulkIoThread;
 struct libusb_device_handle;
 struct libusb_context;
 
 /// USB Bulk controller backend
-class BulkReader : public QThread {
-    Q_OBJECT
-  public:
-    BulkReader(libusb_device_handle *handle, unsigned char in_epaddr);
-    virtual ~BulkReader();
-
-    void stop();
-
-  signals:
-    void incomingData(const QByteArray& data, mixxx::Duration timestamp);
-
-  protected:
-    void run();
-
-  private:
-    libusb_device_handle* m_phandle;
-    QAtomicInt m_stop;
-    unsigned char m_in_epaddr;
-};
-
 class BulkController : public Controller {
     Q_OBJECT
   public:
@@ -97,6 +77,8 @@ class BulkController : public Controller {
     bool sendBytes(const QByteArray& data) override;
 
     bool matchProductInfo(const ProductInfo& product);
+    /// Logs the throughput and latency of the transfers of m_pIoThread
+    void logOutputStatistics() const;
 
     libusb_context* m_context;
     libusb_device_handle *m_phandle;
@@ -113,6 +95,6 @@ class BulkController : public Controller {
     QString m_product;
 
     QString m_sUID;
-    BulkReader* m_pReader;
+    std::unique_ptr<BulkIoThread> m_pIoThread;
     std::unique_ptr<LegacyHidControllerMapping> m_pMapping;
 };
@@ -0,0 +1,294 @@
+#include "controllers/bulk/bulkiothread.h"
+
+#include "moc_bulkiothread.cpp"
+#include "util/cmdlineargs.h"
+#include "util/time.h"
+#include "util/trace.h"
+
+namespace {
+
+// A multiple of the maximum packet size of full-speed and high-speed
+// endpoints, so a packet never overflows the transfer
+constexpr int kInputTransferSize = 512;
+
+// Input transfers are resubmitted when they time out, this only bounds the
+// time until a stop request is noticed
+constexpr unsigned int kInputTransferTimeoutMillis = 500;
+constexpr unsigned int kOutputTransferTimeoutMillis = 5000;
+
+// Bulk transfers to the same endpoint are completed in order, so a few of
+// them can be kept in flight without reordering the data. This keeps the
+// endpoint busy while the next transfer is submitted.
+constexpr int kMaxOutputTransfersInFlight = 4;
+
+// A few frames of a controller screen. Senders are blocked until the queue
+// falls below this size.
+constexpr qsizetype kMaxQueuedBytes = 2 * 1024 * 1024;
+
+#if LIBUSB_API_VERSION >= 0x01000105
+// The event handling is interrupted when data is queued or a stop is requested
+constexpr long kEventTimeoutMicros = 100000;
+#else
+// Without libusb_interrupt_event_handler() queued data can only be submitted
+// after the event handling has timed out
+constexpr long kEventTimeoutMicros = 1000;
+#endif
+
+QString loggingCategoryPrefix(const QString& deviceName) {
+    return QStringLiteral("controller.") +
+            RuntimeLoggingCategory::removeInvalidCharsFromCategory(deviceName.toLower());
+}
+
+} // namespace
+
+BulkIoThread::BulkIoThread(libusb_context* pContext,
+        libusb_device_handle* pHandle,
+        quint8 inEndpointAddr,
+        quint8 outEndpointAddr,
+        bool readInput,
+        const QString& deviceName)
+        : QThread(),
+          m_logInput(loggingCategoryPrefix(deviceName) + QStringLiteral(".input")),
+          m_logOutput(loggingCategoryPrefix(deviceName) + QStringLiteral(".output")),
+          m_pContext(pContext),
+          m_pHandle(pHandle),
+          m_inEndpointAddr(inEndpointAddr),
+          m_outEndpointAddr(outEndpointAddr),
+          m_readInput(readInput),
+          m_stopInput(0),
+          m_stopWhenAllSent(0),
+          m_inputTransfersInFlight(0),
+          m_outputTransfersInFlight(0),
+          m_inputBuffer(kInputTransferCount * kInputTransferSize),
+          m_queuedBytes(0),
+          m_outputErrorLogged(false) {
+    m_inputTransfers.fill(nullptr);
+}
+
+BulkIoThread::~BulkIoThread() {
+    DEBUG_ASSERT(m_inputTransfersInFlight.loadAcquire() == 0);
+    DEBUG_ASSERT(m_outputTransfersInFlight.loadAcquire() == 0);
+    for (libusb_transfer* pTransfer : m_inputTransfers) {
+        libusb_free_transfer(pTransfer);
+    }
+}
+
+void BulkIoThread::run() {
+    {
+        const auto lock = lockMutex(&m_statisticsMutex);
+        m_runTimer.start();
+    }
+    if (m_readInput) {
+        submitInputTransfers();
+    }
+
+    bool inputCancelled = false;
+    while (true) {
+        if (!inputCancelled && m_stopInput.loadAcquire() != 0) {
+            cancelInputTransfers();
+            inputCancelled = true;
+        }
+
+        submitQueuedOutput();
+
+        if (m_stopWhenAllSent.loadAcquire() != 0 &&
+                m_inputTransfersInFlight.loadAcquire() == 0 &&
+                m_outputTransfersInFlight.loadAcquire() == 0) {
+            const auto lock = lockMutex(&m_sendQueueMutex);
+            if (m_sendQueue.empty()) {
+                break;
+            }
+        }
+
+        // The context is shared by all bulk devices, so the callbacks of
+        // this device may also be invoked by the thread of another device
+        timeval timeout{0, kEventTimeoutMicros};
+        libusb_handle_events_timeout_completed(m_pContext, &timeout, nullptr);
+    }
+    qDebug() << "Stopped" << objectName();
+}
+
+void BulkIoThread::send(QByteArray data) {
+    auto lock = lockMutex(&m_sendQueueMutex);
+    // Data that exceeds the limit on its own is accepted by an empty queue
+    while (m_queuedBytes > 0 && m_queuedBytes + data.size() > kMaxQueuedBytes) {
+        m_sendQueueNotFull.wait(&m_sendQueueMutex);
+    }
+    m_queuedBytes += data.size();
+    m_sendQueue.push_back(OutputTransfer{this, std::move(data), mixxx::Time::elapsed()});
+    lock.unlock();
+    wakeUp();
+}
+
+void BulkIoThread::stopInput() {
+    m_stopInput.storeRelease(1);
+    wakeUp();
+}
+
+void BulkIoThread::stopWhenAllSent() {
+    m_stopInput.storeRelease(1);
+    m_stopWhenAllSent.storeRelease(1);
+    wakeUp();
+}
+
+BulkIoThread::Statistics BulkIoThread::statistics() const {
+    const auto lock = lockMutex(&m_statisticsMutex);
+    Statistics statistics = m_statistics;
+    if (m_runTimer.running()) {
+        statistics.elapsed = m_runTimer.elapsed();
+    }
+    return statistics;
+}
+
+void BulkIoThread::wakeUp() {
+#if LIBUSB_API_VERSION >= 0x01000105
+    libusb_interrupt_event_handler(m_pContext);
+#endif
+}
+
+void BulkIoThread::submitInputTransfers() {
+    for (std::size_t i = 0; i < m_inputTransfers.size(); ++i) {
+        libusb_transfer* pTransfer = libusb_alloc_transfer(0);
+        VERIFY_OR_DEBUG_ASSERT(pTransfer) {
+            return;
+        }
+        libusb_fill_bulk_transfer(pTransfer,
+                m_pHandle,
+                m_inEndpointAddr,
+                m_inputBuffer.data() + i * kInputTransferSize,
+                kInputTransferSize,
+                inputTransferCallback,
+                this,
+                kInputTransferTimeoutMillis);
+        m_inputTransfersInFlight.fetchAndAddRelease(1);
+        const int result = libusb_submit_transfer(pTransfer);
+        if (result < 0) {
+            m_inputTransfersInFlight.fetchAndSubRelease(1);
+            libusb_free_transfer(pTransfer);
+            qCWarning(m_logInput) << "Unable to read from" << objectName()
+                                  << "-" << libusb_error_name(result);
+            return;
+        }
+        m_inputTransfers[i] = pTransfer;
+    }
+}
+
+void BulkIoThread::cancelInputTransfers() {
+    for (libusb_transfer* pTransfer : m_inputTransfers) {
+        if (pTransfer) {
+            // Fails harmlessly for transfers that have completed already.
+            // These aren't resubmitted after a stop has been requested.
+            libusb_cancel_transfer(pTransfer);
+        }
+    }
+}
+
+void BulkIoThread::submitQueuedOutput() {
+    while (m_outputTransfersInFlight.loadAcquire() < kMaxOutputTransfersInFlight) {
+        auto lock = lockMutex(&m_sendQueueMutex);
+        if (m_sendQueue.empty()) {
+            return;
+        }
+        auto* pOutput = new OutputTransfer(std::move(m_sendQueue.front()));
+        m_sendQueue.pop_front();
+        m_queuedBytes -= pOutput->data.size();
+        lock.unlock();
+        m_sendQueueNotFull.wakeAll();
+
+        libusb_transfer* pTransfer = libusb_alloc_transfer(0);
+        VERIFY_OR_DEBUG_ASSERT(pTransfer) {
+            delete pOutput;
+            return;
+        }
+        libusb_fill_bulk_transfer(pTransfer,
+                m_pHandle,
+                m_outEndpointAddr,
+                reinterpret_cast<unsigned char*>(pOutput->data.data()),
+                static_cast<int>(pOutput->data.size()),
+                outputTransferCallback,
+                pOutput,
+                kOutputTransferTimeoutMillis);
+        m_outputTransfersInFlight.fetchAndAddRelease(1);
+        const int result = libusb_submit_transfer(pTransfer);
+        if (result < 0) {
+            m_outputTransfersInFlight.fetchAndSubRelease(1);
+            libusb_free_transfer(pTransfer);
+            delete pOutput;
+            const auto statisticsLock = lockMutex(&m_statisticsMutex);
+            ++m_statistics.failedTransfers;
+            if (!m_outputErrorLogged) {
+                qCWarning(m_logOutput) << "Unable to send data to" << objectName()
+                                       << "-" << libusb_error_name(result);
+                m_outputErrorLogged = true;
+            }
+        }
+    }
+}
+
+// static
+void LIBUSB_CALL BulkIoThread::inputTransferCallback(libusb_transfer* pTransfer) {
+    auto* pThread = static_cast<BulkIoThread*>(pTransfer->user_data);
+    const bool completed = pTransfer->status == LIBUSB_TRANSFER_COMPLETED ||
+            pTransfer->status == LIBUSB_TRANSFER_TIMED_OUT;
+    if (completed && pTransfer->actual_length > 0) {
+        Trace process("BulkIoThread process packet");
+        emit pThread->incomingData(
+                QByteArray(reinterpret_cast<const char*>(pTransfer->buffer),
+                        pTransfer->actual_length),
+                mixxx::Time::elapsed());
+    }
+
+    if (completed && pThread->m_stopInput.loadAcquire() == 0) {
+        const int result = libusb_submit_transfer(pTransfer);
+        if (result == 0) {
+            return;
+        }
+        qCWarning(pThread->m_logInput) << "Unable to read from" << pThread->objectName()
+                                       << "-" << libusb_error_name(result);
+    } else if (!completed && pTransfer->status != LIBUSB_TRANSFER_CANCELLED) {
+        qCWarning(pThread->m_logInput) << "Unable to read from" << pThread->objectName()
+                                       << "-" << libusb_error_name(pTransfer->status);
+    }
+    // The run loop notices this when the event handling returns, the thread
+    // may be destroyed afterwards
+    pThread->m_inputTransfersInFlight.fetchAndSubRelease(1);
+}
+
+// static
+void LIBUSB_CALL BulkIoThread::outputTransferCallback(libusb_transfer* pTransfer) {
+    auto* pOutput = static_cast<OutputTransfer*>(pTransfer->user_data);
+    BulkIoThread* pThread = pOutput->pThread;
+    const mixxx::Duration latency = mixxx::Time::elapsed() - pOutput->queuedAt;
+    const bool success = pTransfer->status == LIBUSB_TRANSFER_COMPLETED &&
+            pTransfer->actual_length == pTransfer->length;
+    {
+        const auto lock = lockMutex(&pThread->m_statisticsMutex);
+        if (success) {
+            ++pThread->m_statistics.transfers;
+            pThread->m_statistics.bytes += pTransfer->actual_length;
+            pThread->m_statistics.totalLatency += latency;
+            if (latency > pThread->m_statistics.maxLatency) {
+                pThread->m_statistics.maxLatency = latency;
+            }
+            pThread->m_outputErrorLogged = false;
+        } else {
+            ++pThread->m_statistics.failedTransfers;
+            if (!pThread->m_outputErrorLogged) {
+                // Logged once until a transfer succeeds again
+                qCWarning(pThread->m_logOutput)
+                        << "Unable to send data to" << pThread->objectName()
+                        << "-" << libusb_error_name(pTransfer->status);
+                pThread->m_outputErrorLogged = true;
+            }
+        }
+    }
+    if (success && CmdlineArgs::Instance().getControllerDebug()) {
+        qCDebug(pThread->m_logOutput) << pTransfer->actual_length << "bytes sent to"
+                                      << pThread->objectName() << "- Needed:"
+                                      << latency.formatMicrosWithUnit();
+    }
+    delete pOutput;
+    libusb_free_transfer(pTransfer);
+    // Last access, see inputTransferCallback()
+    pThread->m_outputTransfersInFlight.fetchAndSubRelease(1);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <libusb.h>
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QThread>
+#include <QWaitCondition>
+#include <array>
+#include <deque>
+#include <vector>
+
+#include "util/compatibility/qmutex.h"
+#include "util/duration.h"
+#include "util/performancetimer.h"
+#include "util/runtimeloggingcategory.h"
+
+/// Performs the asynchronous libusb IO of a USB bulk device.
+///
+/// Several input transfers are kept in flight, so no packets are lost while
+/// the data of a completed transfer is processed. The data that is sent by
+/// the mapping, or the frames of its screens, are queued and submitted by
+/// this thread with a limited number of transfers in flight. The sending
+/// thread only waits if the queue is full.
+class BulkIoThread : public QThread {
+    Q_OBJECT
+  public:
+    /// The output statistics since the thread has been started
+    struct Statistics {
+        quint64 transfers = 0;
+        quint64 failedTransfers = 0;
+        quint64 bytes = 0;
+        /// The time from queuing until the completion of a transfer
+        mixxx::Duration totalLatency;
+        mixxx::Duration maxLatency;
+        mixxx::Duration elapsed;
+    };
+
+    BulkIoThread(libusb_context* pContext,
+            libusb_device_handle* pHandle,
+            quint8 inEndpointAddr,
+            quint8 outEndpointAddr,
+            bool readInput,
+            const QString& deviceName);
+    ~BulkIoThread() override;
+
+    void run() override;
+
+    /// Queues the data for sending. Blocks while the queue is full.
+    void send(QByteArray data);
+
+    /// Cancels the input transfers, but keeps sending the queued data
+    void stopInput();
+    /// Stops the thread when the queued data has been sent. Use wait() for
+    /// the thread to finish.
+    void stopWhenAllSent();
+
+    Statistics statistics() const;
+
+  signals:
+    void incomingData(const QByteArray& data, mixxx::Duration timestamp);
+
+  private:
+    static constexpr std::size_t kInputTransferCount = 4;
+
+    struct OutputTransfer {
+        BulkIoThread* pThread;
+        QByteArray data;
+        mixxx::Duration queuedAt;
+    };
+
+    static void LIBUSB_CALL inputTransferCallback(libusb_transfer* pTransfer);
+    static void LIBUSB_CALL outputTransferCallback(libusb_transfer* pTransfer);
+
+    void submitInputTransfers();
+    void cancelInputTransfers();
+    void submitQueuedOutput();
+    void wakeUp();
+
+    const RuntimeLoggingCategory m_logInput;
+    const RuntimeLoggingCategory m_logOutput;
+
+    libusb_context* const m_pContext;
+    libusb_device_handle* const m_pHandle;
+    const quint8 m_inEndpointAddr;
+    const quint8 m_outEndpointAddr;
+    const bool m_readInput;
+
+    QAtomicInt m_stopInput;
+    QAtomicInt m_stopWhenAllSent;
+
+    // The transfers are completed by whichever thread handles the events
+    // of the shared libusb context, so these are only counted atomically
+    QAtomicInt m_inputTransfersInFlight;
+    QAtomicInt m_outputTransfersInFlight;
+
+    std::array<libusb_transfer*, kInputTransferCount> m_inputTransfers;
+    std::vector<unsigned char> m_inputBuffer;
+
+    QMutex m_sendQueueMutex;
+    QWaitCondition m_sendQueueNotFull;
+    std::deque<OutputTransfer> m_sendQueue;
+    qsizetype m_queuedBytes;
+
+    // Guards the members below
+    mutable QMutex m_statisticsMutex;
+    Statistics m_statistics;
+    PerformanceTimer m_runTimer;
+    bool m_outputErrorLogged;
+};
@@ -7,6 +7,8 @@
 #include "moc_controller.cpp"
 #include "util/cmdlineargs.h"
 #include "util/screensaver.h"
+#include "util/stat.h"
+#include "util/time.h"
 
 namespace {
 QString loggingCategoryPrefix(const QString& deviceName) {
@@ -24,7 +26,8 @@ Controller::Controller(const QString& deviceName)
           m_bIsOutputDevice(false),
           m_bIsInputDevice(false),
           m_bIsOpen(false),
-          m_bLearning(false) {
+          m_bLearning(false),
+          m_inputLatencyStatKey(QStringLiteral("Controller::inputLatency ") + deviceName) {
     m_userActivityInhibitTimer.start();
 }
 
@@ -142,6 +145,14 @@ void Controller::triggerActivity() {
     }
 }
 
+void Controller::trackInputLatency(mixxx::Duration latency) {
+    Stat::track(m_inputLatencyStatKey,
+            Stat::DURATION_MSEC,
+            Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX |
+                    Stat::SAMPLE_VARIANCE | Stat::HISTOGRAM,
+            latency.toDoubleMillis());
+}
+
 void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
     if (!m_pScriptEngineLegacy) {
         //qWarning() << "Controller::receive called with no active engine!";
@@ -178,7 +189,12 @@ void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
     }
 
     m_pScriptEngineLegacy->handleIncomingData(data);
+
+    // The timestamps of the subclasses that don't override this function
+    // are taken from mixxx::Time when reading the data from the device
+    trackInputLatency(mixxx::Time::elapsed() - timestamp);
 }
+
 void Controller::slotBeforeEngineShutdown() {
     /* Override this to get called before the JS engine shuts down */
     qCDebug(m_logInput) << "Engine shutdown";
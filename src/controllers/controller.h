@@ -153,6 +153,10 @@ class Controller : public QObject {
     // To be called when receiving events
     void triggerActivity();
 
+    // To be called after an input event has been handled with the time
+    // since the event has been received from the device
+    void trackInputLatency(mixxx::Duration latency);
+
     inline void setOutputDevice(bool outputDevice) {
         m_bIsOutputDevice = outputDevice;
     }
@@ -205,6 +209,7 @@ class Controller : public QObject {
     bool m_bIsOpen;
     bool m_bLearning;
     QElapsedTimer m_userActivityInhibitTimer;
+    const QString m_inputLatencyStatKey;
 
     friend class ControllerJSProxy;
     // accesses lots of our stuff, but in the same thread
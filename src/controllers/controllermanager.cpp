@@ -1,5 +1,6 @@
 #include "controllers/controllermanager.h"
 
+#include <QDir>
 #include <QSet>
 #include <QThread>
 
@@ -69,6 +70,9 @@ QFileInfo findMappingFile(const QString& pathOrFilename, const QStringList& path
 // kept for backwards compatibility.
 const QString kSettingsGroup = QLatin1String("[ControllerPreset]");
 
+const ConfigKey kThreadPerDeviceConfigKey =
+        ConfigKey(QStringLiteral("[Controller]"), QStringLiteral("ThreadPerDevice"));
+
 } // anonymous namespace
 
 QString firstAvailableFilename(QSet<QString>& filenames,
@@ -87,6 +91,19 @@ bool controllerCompare(Controller *a,Controller *b) {
     return a->getName() < b->getName();
 }
 
+template<typename Func>
+void ControllerManager::invokeOnControllerThread(Controller* pController, Func&& func) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    if (pController->thread() == QThread::currentThread()) {
+        func();
+        return;
+    }
+    // The controller thread never blocks on the thread of the ControllerManager
+    QMetaObject::invokeMethod(pController,
+            std::forward<Func>(func),
+            Qt::BlockingQueuedConnection);
+}
+
 ControllerManager::ControllerManager(UserSettingsPointer pConfig)
         : QObject(),
           m_pConfig(pConfig),
@@ -147,10 +164,15 @@ void ControllerManager::slotInitialize() {
 
     // Initialize mapping info parsers. This object is only for use in the main
     // thread. Do not touch it from within ControllerManager.
+    // Parsing all mapping files takes a while, the info headers of
+    // unmodified files are cached in the settings directory.
+    const QDir settingsDir(m_pConfig->getSettingsPath());
     m_pMainThreadUserMappingEnumerator = QSharedPointer<MappingInfoEnumerator>(
-            new MappingInfoEnumerator(userMappingsPath(m_pConfig)));
+            new MappingInfoEnumerator(userMappingsPath(m_pConfig),
+                    settingsDir.filePath(QStringLiteral("mappinginfo_user.cache"))));
     m_pMainThreadSystemMappingEnumerator = QSharedPointer<MappingInfoEnumerator>(
-            new MappingInfoEnumerator(resourceMappingsPath(m_pConfig)));
+            new MappingInfoEnumerator(resourceMappingsPath(m_pConfig),
+                    settingsDir.filePath(QStringLiteral("mappinginfo_system.cache"))));
 
     // Instantiate all enumerators. Enumerators can take a long time to
     // construct since they interact with host MIDI APIs.
@@ -170,6 +192,7 @@ void ControllerManager::slotInitialize() {
 
 void ControllerManager::slotShutdown() {
     stopPolling();
+    stopDedicatedThreads();
 
     // Clear m_enumerators before deleting the enumerators to prevent other code
     // paths from accessing them.
@@ -204,6 +227,14 @@ void ControllerManager::updateControllerList() {
         newDeviceList.append(pEnumerator->queryDevices());
     }
 
+    if (m_pConfig->getValue(kThreadPerDeviceConfigKey, false)) {
+        for (Controller* pController : std::as_const(newDeviceList)) {
+            if (!hasDedicatedThread(pController)) {
+                moveToDedicatedThread(pController);
+            }
+        }
+    }
+
     locker.relock();
     if (newDeviceList != m_controllers) {
         m_controllers = newDeviceList;
@@ -252,7 +283,9 @@ void ControllerManager::slotSetUpDevices() {
         QString name = pController->getName();
 
         if (pController->isOpen()) {
-            pController->close();
+            invokeOnControllerThread(pController, [pController] {
+                pController->close();
+            });
         }
 
         // The filename for this device name.
@@ -287,7 +320,9 @@ void ControllerManager::slotSetUpDevices() {
         pMapping->loadSettings(m_pConfig, pController->getName());
 
         // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-        pController->setMapping(std::move(pMapping));
+        invokeOnControllerThread(pController, [pController, &pMapping] {
+            pController->setMapping(std::move(pMapping));
+        });
 
         // If we are in safe mode, skip opening controllers.
         if (CmdlineArgs::Instance().getSafeMode()) {
@@ -297,7 +332,10 @@ void ControllerManager::slotSetUpDevices() {
 
         qDebug() << "Opening controller:" << name;
 
-        int value = pController->open(m_pConfig->getResourcePath());
+        int value = 0;
+        invokeOnControllerThread(pController, [this, pController, &value] {
+            value = pController->open(m_pConfig->getResourcePath());
+        });
         if (value != 0) {
             qWarning() << "There was a problem opening" << name;
             continue;
@@ -314,9 +352,21 @@ void ControllerManager::pollIfAnyControllersOpen() {
 
     bool shouldPoll = false;
     for (Controller* pController : controllers) {
-        if (pController->isOpen() && pController->isPolling()) {
-            shouldPoll = true;
+        const bool controllerShouldPoll = pController->isOpen() && pController->isPolling();
+        const auto dedicatedThread = m_dedicatedThreads.constFind(pController);
+        if (dedicatedThread == m_dedicatedThreads.constEnd()) {
+            shouldPoll = shouldPoll || controllerShouldPoll;
+            continue;
         }
+        // Polled on its own thread
+        QTimer* pPollTimer = dedicatedThread->pPollTimer;
+        invokeOnControllerThread(pController, [pPollTimer, controllerShouldPoll] {
+            if (!controllerShouldPoll) {
+                pPollTimer->stop();
+            } else if (!pPollTimer->isActive()) {
+                pPollTimer->start();
+            }
+        });
     }
     if (shouldPoll) {
         startPolling();
@@ -368,7 +418,7 @@ void ControllerManager::slotPollDevices() {
 
     mixxx::Duration start = mixxx::Time::elapsed();
     for (Controller* pDevice : std::as_const(m_controllers)) {
-        if (pDevice->isOpen() && pDevice->isPolling()) {
+        if (pDevice->isOpen() && pDevice->isPolling() && !hasDedicatedThread(pDevice)) {
             pDevice->poll();
         }
     }
@@ -385,10 +435,13 @@ void ControllerManager::openController(Controller* pController) {
     if (!pController) {
         return;
     }
-    if (pController->isOpen()) {
-        pController->close();
-    }
-    int result = pController->open(m_pConfig->getResourcePath());
+    int result = 0;
+    invokeOnControllerThread(pController, [this, pController, &result] {
+        if (pController->isOpen()) {
+            pController->close();
+        }
+        result = pController->open(m_pConfig->getResourcePath());
+    });
     pollIfAnyControllersOpen();
 
     // If successfully opened the device, apply the mapping and save the
@@ -405,7 +458,9 @@ void ControllerManager::closeController(Controller* pController) {
     if (!pController) {
         return;
     }
-    pController->close();
+    invokeOnControllerThread(pController, [pController] {
+        pController->close();
+    });
     pollIfAnyControllersOpen();
     // Update configuration to reflect controller is disabled.
     m_pConfig->setValue(
@@ -424,7 +479,9 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     ConfigKey key(kSettingsGroup, sanitizeDeviceName(pController->getName()));
     if (!pMapping) {
         // Unset the controller mapping for this controller
-        pController->setMapping(nullptr);
+        invokeOnControllerThread(pController, [pController] {
+            pController->setMapping(nullptr);
+        });
         m_pConfig->remove(key);
         emit mappingApplied(false);
         return;
@@ -439,7 +496,9 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     // startup next time
     m_pConfig->set(key, pMapping->filePath());
 
-    pController->setMapping(std::move(pMapping));
+    invokeOnControllerThread(pController, [pController, &pMapping] {
+        pController->setMapping(std::move(pMapping));
+    });
 
     if (bEnabled) {
         openController(pController);
@@ -449,6 +508,64 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     }
 }
 
+void ControllerManager::moveToDedicatedThread(Controller* pController) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(pController);
+    DEBUG_ASSERT(!pController->isOpen());
+
+    // The poll timer moves together with its parent
+    auto* pPollTimer = new QTimer(pController);
+    pPollTimer->setInterval(kPollInterval.toIntegerMillis());
+    // Same as slotPollDevices() for a single controller
+    connect(pPollTimer,
+            &QTimer::timeout,
+            pController,
+            [pController, skipPoll = false]() mutable {
+                if (skipPoll) {
+                    // skip poll in overload situation
+                    skipPoll = false;
+                    return;
+                }
+                const mixxx::Duration start = mixxx::Time::elapsed();
+                if (pController->isOpen() && pController->isPolling()) {
+                    pController->poll();
+                }
+                if (mixxx::Time::elapsed() - start > kPollInterval) {
+                    skipPoll = true;
+                }
+            });
+
+    auto* pThread = new QThread;
+    pThread->setObjectName(QStringLiteral("Controller ") + pController->getName());
+    pController->moveToThread(pThread);
+    // Controller processing needs to be prioritized since it can affect the
+    // audio directly, like when scratching
+    pThread->start(QThread::HighPriority);
+
+    m_dedicatedThreads.insert(pController, DedicatedThread{pThread, pPollTimer});
+    qDebug() << "Running controller" << pController->getName() << "on a dedicated thread";
+}
+
+void ControllerManager::stopDedicatedThreads() {
+    QThread* pManagerThread = thread();
+    for (auto it = m_dedicatedThreads.constBegin(); it != m_dedicatedThreads.constEnd(); ++it) {
+        Controller* pController = it.key();
+        QTimer* pPollTimer = it->pPollTimer;
+        // The engine must be stopped on the thread it lives in. Afterwards
+        // the controller is moved back, to be deleted with its enumerator.
+        invokeOnControllerThread(pController, [pController, pPollTimer, pManagerThread] {
+            if (pController->isOpen()) {
+                pController->close();
+            }
+            delete pPollTimer;
+            pController->moveToThread(pManagerThread);
+        });
+        it->pThread->quit();
+        it->pThread->wait();
+        delete it->pThread;
+    }
+    m_dedicatedThreads.clear();
+}
+
 // static
 QList<QString> ControllerManager::getMappingPaths(UserSettingsPointer pConfig) {
     QList<QString> scriptPaths;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QMutex>
 #include <QSharedPointer>
 #include <QTimer>
@@ -20,6 +21,12 @@ class ControllerEnumerator;
 bool controllerCompare(Controller *a, Controller *b);
 
 /// Manages enumeration/operation/deletion of hardware controllers.
+///
+/// By default, all controllers and their script engines share the thread of
+/// the ControllerManager. If [Controller],ThreadPerDevice is enabled, each
+/// controller is moved to a dedicated thread after enumeration, where its
+/// script engine runs and its input is polled. A mapping that keeps its
+/// engine busy doesn't delay the input of other controllers then.
 class ControllerManager : public QObject {
     Q_OBJECT
   public:
@@ -76,6 +83,25 @@ class ControllerManager : public QObject {
     void openController(Controller* pController);
     void closeController(Controller* pController);
 
+    void moveToDedicatedThread(Controller* pController);
+    void stopDedicatedThreads();
+    bool hasDedicatedThread(Controller* pController) const {
+        return m_dedicatedThreads.contains(pController);
+    }
+
+    // Invokes the function on the thread of the controller and waits until
+    // it has returned
+    template<typename Func>
+    void invokeOnControllerThread(Controller* pController, Func&& func);
+
+    // Only accessed by the thread of the ControllerManager
+    struct DedicatedThread {
+        QThread* pThread;
+        // Lives in pThread (as a child of the controller)
+        QTimer* pPollTimer;
+    };
+    QHash<Controller*, DedicatedThread> m_dedicatedThreads;
+
     UserSettingsPointer m_pConfig;
     ControllerLearningEventFilter* m_pControllerLearningEventFilter;
     QTimer m_pollTimer;
@@ -118,3 +118,33 @@ ProductInfo MappingInfo::parseHIDProduct(const QDomElement& element) const {
     product.interface_number = element.attribute("interface_number");
     return product;
 }
+
+QDataStream& operator<<(QDataStream& stream, const MappingInfo& info) {
+    stream << info.m_valid << info.m_path << info.m_dirPath << info.m_name
+           << info.m_author << info.m_description << info.m_forumlink
+           << info.m_wikilink;
+    stream << static_cast<qint32>(info.m_products.size());
+    for (const auto& product : info.m_products) {
+        stream << product.protocol << product.vendor_id << product.product_id
+               << product.interface_number << product.usage_page << product.usage
+               << product.in_epaddr << product.out_epaddr;
+    }
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, MappingInfo& info) {
+    stream >> info.m_valid >> info.m_path >> info.m_dirPath >> info.m_name >>
+            info.m_author >> info.m_description >> info.m_forumlink >>
+            info.m_wikilink;
+    qint32 productCount = 0;
+    stream >> productCount;
+    info.m_products.clear();
+    for (qint32 i = 0; i < productCount && stream.status() == QDataStream::Ok; ++i) {
+        ProductInfo product;
+        stream >> product.protocol >> product.vendor_id >> product.product_id >>
+                product.interface_number >> product.usage_page >> product.usage >>
+                product.in_epaddr >> product.out_epaddr;
+        info.m_products.append(std::move(product));
+    }
+    return stream;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QDataStream>
 #include <QDomElement>
 #include <QList>
 #include <QMap>
@@ -64,6 +65,10 @@ class MappingInfo {
         return m_products;
     }
 
+    /// Serialization for caching the parsed info headers
+    friend QDataStream& operator<<(QDataStream& stream, const MappingInfo& info);
+    friend QDataStream& operator>>(QDataStream& stream, MappingInfo& info);
+
   private:
     ProductInfo parseBulkProduct(const QDomElement& element) const;
     ProductInfo parseHIDProduct(const QDomElement& element) const;
@@ -1,10 +1,22 @@
 #include "controllers/controllermappinginfoenumerator.h"
 
+#include <QDateTime>
 #include <QDirIterator>
+#include <QFile>
+#include <QSaveFile>
 
 #include "controllers/defs_controllers.h"
+#include "util/logger.h"
 
 namespace {
+
+const mixxx::Logger kLogger("MappingInfoEnumerator");
+
+constexpr quint32 kCacheFileMagic = 0x4d584d49; // "MXMI"
+// Must be incremented whenever the serialization of MappingInfo changes
+constexpr quint32 kCacheFileVersion = 1;
+constexpr QDataStream::Version kCacheStreamVersion = QDataStream::Qt_5_15;
+
 bool mappingInfoNameComparator(const MappingInfo& a, const MappingInfo& b) {
     if (a.getDirPath() == b.getDirPath()) {
         // FIXME: Mixxx copies every loaded mapping into the user mapping folder
@@ -23,12 +35,15 @@ bool mappingInfoNameComparator(const MappingInfo& a, const MappingInfo& b) {
 }
 } // namespace
 
-MappingInfoEnumerator::MappingInfoEnumerator(const QString& searchPath)
-        : MappingInfoEnumerator(QList<QString>{searchPath}) {
+MappingInfoEnumerator::MappingInfoEnumerator(
+        const QString& searchPath, const QString& cacheFilePath)
+        : MappingInfoEnumerator(QList<QString>{searchPath}, cacheFilePath) {
 }
 
-MappingInfoEnumerator::MappingInfoEnumerator(const QStringList& searchPaths)
-        : m_controllerDirPaths(searchPaths) {
+MappingInfoEnumerator::MappingInfoEnumerator(
+        const QStringList& searchPaths, const QString& cacheFilePath)
+        : m_controllerDirPaths(searchPaths),
+          m_cacheFilePath(cacheFilePath) {
     loadSupportedMappings();
 }
 
@@ -50,6 +65,27 @@ void MappingInfoEnumerator::loadSupportedMappings() {
     m_hidMappings.clear();
     m_bulkMappings.clear();
 
+    const MappingInfoCache cache = readCache();
+    MappingInfoCache updatedCache;
+    int parsedCount = 0;
+    // Returns the info from the cache if the file has not been modified
+    const auto mappingInfo = [&](const QFileInfo& fileInfo) {
+        const QString path = fileInfo.absoluteFilePath();
+        const qint64 size = fileInfo.size();
+        const qint64 lastModifiedMillis = fileInfo.lastModified().toMSecsSinceEpoch();
+        const auto cached = cache.constFind(path);
+        if (cached != cache.constEnd() &&
+                cached->size == size &&
+                cached->lastModifiedMillis == lastModifiedMillis) {
+            updatedCache.insert(path, *cached);
+            return cached->info;
+        }
+        ++parsedCount;
+        MappingInfo info(path);
+        updatedCache.insert(path, CachedMappingInfo{size, lastModifiedMillis, info});
+        return info;
+    };
+
     for (const QString& dirPath : std::as_const(m_controllerDirPaths)) {
         QDirIterator it(dirPath);
         while (it.hasNext()) {
@@ -57,15 +93,22 @@ void MappingInfoEnumerator::loadSupportedMappings() {
             const QString path = it.filePath();
 
             if (path.endsWith(MIDI_MAPPING_EXTENSION, Qt::CaseInsensitive)) {
-                m_midiMappings.append(MappingInfo(path));
+                m_midiMappings.append(mappingInfo(it.fileInfo()));
             } else if (path.endsWith(HID_MAPPING_EXTENSION, Qt::CaseInsensitive)) {
-                m_hidMappings.append(MappingInfo(path));
+                m_hidMappings.append(mappingInfo(it.fileInfo()));
             } else if (path.endsWith(BULK_MAPPING_EXTENSION, Qt::CaseInsensitive)) {
-                m_bulkMappings.append(MappingInfo(path));
+                m_bulkMappings.append(mappingInfo(it.fileInfo()));
             }
         }
     }
 
+    // Also rewritten if files have been removed
+    if (parsedCount > 0 || updatedCache.size() != cache.size()) {
+        writeCache(updatedCache);
+    }
+    kLogger.debug() << "Parsed" << parsedCount << "of" << updatedCache.size()
+                    << "mapping files";
+
     std::sort(m_midiMappings.begin(), m_midiMappings.end(), mappingInfoNameComparator);
     std::sort(m_hidMappings.begin(), m_hidMappings.end(), mappingInfoNameComparator);
     std::sort(m_bulkMappings.begin(), m_bulkMappings.end(), mappingInfoNameComparator);
@@ -77,3 +120,60 @@ void MappingInfoEnumerator::loadSupportedMappings() {
     qDebug() << "Extension" << BULK_MAPPING_EXTENSION << "total"
              << m_bulkMappings.length() << "mappings";
 }
+
+MappingInfoEnumerator::MappingInfoCache MappingInfoEnumerator::readCache() const {
+    MappingInfoCache cache;
+    if (m_cacheFilePath.isEmpty()) {
+        return cache;
+    }
+    QFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not an error, the cache is created on the first run
+        return cache;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(kCacheStreamVersion);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != kCacheFileMagic || version != kCacheFileVersion || count < 0) {
+        kLogger.info() << "Ignoring outdated cache file" << m_cacheFilePath;
+        return cache;
+    }
+    cache.reserve(count);
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        CachedMappingInfo cached;
+        stream >> path >> cached.size >> cached.lastModifiedMillis >> cached.info;
+        cache.insert(path, std::move(cached));
+    }
+    if (stream.status() != QDataStream::Ok) {
+        kLogger.warning() << "Ignoring corrupt cache file" << m_cacheFilePath;
+        return MappingInfoCache();
+    }
+    return cache;
+}
+
+void MappingInfoEnumerator::writeCache(const MappingInfoCache& cache) const {
+    if (m_cacheFilePath.isEmpty()) {
+        return;
+    }
+    // Never leave a partially written cache file behind
+    QSaveFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to write cache file" << m_cacheFilePath
+                          << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(kCacheStreamVersion);
+    stream << kCacheFileMagic << kCacheFileVersion << static_cast<qint32>(cache.size());
+    for (auto it = cache.constBegin(); it != cache.constEnd(); ++it) {
+        stream << it.key() << it->size << it->lastModifiedMillis << it->info;
+    }
+    if (!file.commit()) {
+        kLogger.warning() << "Failed to write cache file" << m_cacheFilePath
+                          << file.errorString();
+    }
+}
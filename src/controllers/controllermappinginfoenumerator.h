@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QString>
 #include <QStringList>
@@ -7,18 +8,35 @@
 #include "controllers/controllermappinginfo.h"
 
 /// Enumerate list of available controller mapping mappings
+///
+/// If a cache file path is given, the parsed info headers are stored in that
+/// file and only mapping files whose size or modification time have changed
+/// are parsed again.
 class MappingInfoEnumerator {
   public:
-    MappingInfoEnumerator(const QString& searchPath);
-    MappingInfoEnumerator(const QStringList& searchPaths);
+    MappingInfoEnumerator(const QString& searchPath,
+            const QString& cacheFilePath = QString());
+    MappingInfoEnumerator(const QStringList& searchPaths,
+            const QString& cacheFilePath = QString());
 
     // Return cached list of mappings for this extension
     QList<MappingInfo> getMappingsByExtension(const QString& extension);
     void loadSupportedMappings();
 
   private:
+    struct CachedMappingInfo {
+        qint64 size;
+        qint64 lastModifiedMillis;
+        MappingInfo info;
+    };
+    typedef QHash<QString, CachedMappingInfo> MappingInfoCache;
+
+    MappingInfoCache readCache() const;
+    void writeCache(const MappingInfoCache& cache) const;
+
     // List of paths for controller mappings
     QList<QString> m_controllerDirPaths;
+    const QString m_cacheFilePath;
 
     QList<MappingInfo> m_hidMappings;
     QList<MappingInfo> m_midiMappings;
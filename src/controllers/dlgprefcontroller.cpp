@@ -3,8 +3,12 @@
 #include <QDir>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QHeaderView>
 #include <QInputDialog>
 #include <QKeyEvent>
+#include <QTableWidgetItem>
+#include <algorithm>
+#include <cmath>
 
 #include "controllers/controller.h"
 #include "controllers/controllerinputmappingtablemodel.h"
@@ -316,6 +320,35 @@ DlgPrefController::DlgPrefController(
             this,
             &DlgPrefController::slotOutputControlSearch);
 
+    // Script profile
+    m_ui.scriptProfileTableWidget->setColumnCount(5);
+    m_ui.scriptProfileTableWidget->setHorizontalHeaderLabels({
+            tr("Callback"),
+            tr("Calls"),
+            tr("Average [ms]"),
+            tr("Maximum [ms]"),
+            tr("Overruns"),
+    });
+    m_ui.scriptProfileTableWidget->horizontalHeader()->setSectionResizeMode(
+            0, QHeaderView::Stretch);
+    m_ui.scriptProfileTableWidget->verticalHeader()->hide();
+    connect(m_ui.btnRefreshScriptProfile,
+            &QAbstractButton::clicked,
+            this,
+            &DlgPrefController::slotRefreshScriptProfile);
+    connect(m_ui.btnResetScriptProfile,
+            &QAbstractButton::clicked,
+            this,
+            &DlgPrefController::slotResetScriptProfile);
+    connect(m_ui.controllerTabs,
+            &QTabWidget::currentChanged,
+            this,
+            [this](int index) {
+                if (m_ui.controllerTabs->widget(index) == m_ui.scriptProfileTab) {
+                    slotRefreshScriptProfile();
+                }
+            });
+
     // Store the index of the input and output mappings tabs
     m_inputMappingsTabIndex = m_ui.controllerTabs->indexOf(m_ui.inputMappingsTab);
     m_outputMappingsTabIndex = m_ui.controllerTabs->indexOf(m_ui.outputMappingsTab);
@@ -728,6 +761,52 @@ void DlgPrefController::enableWizardAndIOTabs(bool enable) {
     m_ui.outputMappingsTab->setEnabled(enable);
 }
 
+void DlgPrefController::slotRefreshScriptProfile() {
+    auto* pTable = m_ui.scriptProfileTableWidget;
+    pTable->setSortingEnabled(false);
+    pTable->setRowCount(0);
+    const auto pEngine = m_pController->getScriptEngine();
+    if (!pEngine) {
+        return;
+    }
+    auto statistics = pEngine->callbackStatistics();
+    // The callbacks that block the controller for the longest time first
+    std::sort(statistics.begin(), statistics.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.totalTime > rhs.totalTime;
+    });
+    pTable->setRowCount(statistics.size());
+    for (int row = 0; row < statistics.size(); ++row) {
+        const auto& callback = statistics.at(row);
+        // With microsecond precision
+        const auto millis = [](mixxx::Duration duration) {
+            return std::round(duration.toDoubleMillis() * 1000) / 1000;
+        };
+        const auto numberItem = [](double value) {
+            auto* pItem = new QTableWidgetItem();
+            // Sorted by the number
+            pItem->setData(Qt::DisplayRole, value);
+            pItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            return pItem;
+        };
+        pTable->setItem(row, 0, new QTableWidgetItem(callback.name));
+        pTable->setItem(row, 1, numberItem(callback.calls));
+        pTable->setItem(row,
+                2,
+                numberItem(millis(callback.totalTime) / std::max(callback.calls, 1)));
+        pTable->setItem(row, 3, numberItem(millis(callback.maxTime)));
+        pTable->setItem(row, 4, numberItem(callback.overruns));
+    }
+    pTable->setSortingEnabled(true);
+}
+
+void DlgPrefController::slotResetScriptProfile() {
+    const auto pEngine = m_pController->getScriptEngine();
+    if (pEngine) {
+        pEngine->resetCallbackStatistics();
+    }
+    slotRefreshScriptProfile();
+}
+
 QString DlgPrefController::mappingFilePathFromIndex(int index) const {
     if (index == 0) {
         // "No Mapping" item
@@ -63,6 +63,9 @@ class DlgPrefController : public DlgPreferencePage {
     /// Called when the Controller Learning Wizard is closed.
     void slotStopLearning();
     void enableWizardAndIOTabs(bool enable);
+    /// Shows the execution time of the mapping's script callbacks
+    void slotRefreshScriptProfile();
+    void slotResetScriptProfile();
 
 #ifdef MIXXX_USE_QML
     // Onboard screen controller.
@@ -21,6 +21,9 @@ constexpr size_t kMaxHidErrorMessageSize = 512;
 // the fastest possible rate of HID devices with USB HighSpeed or USB SuperSpeed interface is 8kHz
 constexpr int kSleepTimeWhenIdleMicros = 250;
 
+// Receivers that fall further behind are served with newly allocated buffers
+constexpr std::size_t kMaxPooledInputReports = 16;
+
 QString loggingCategoryPrefix(const QString& deviceName) {
     return QStringLiteral("controller.") +
             RuntimeLoggingCategory::removeInvalidCharsFromCategory(deviceName.toLower());
@@ -38,15 +41,12 @@ HidIoThread::HidIoThread(
           m_logOutput(loggingCategoryPrefix(deviceInfo.formatName()) +
                   QStringLiteral(".output")),
           m_pHidDevice(pHidDevice),
-          m_lastPollSize(0),
-          m_pollingBufferIndex(0),
           m_hidReadErrorLogged(false),
           m_globalOutputReportFifo(),
           m_runLoopSemaphore(1) {
     // Initializing isn't strictly necessary but is good practice.
-    for (int i = 0; i < kNumBuffers; i++) {
-        memset(m_pPollData[i], 0, kBufferSize);
-    }
+    memset(m_pPollData, 0, kBufferSize);
+    m_inputReportPool.reserve(kMaxPooledInputReports);
     m_outputReportIterator = m_outputReports.begin();
     m_state.storeRelease(static_cast<int>(HidIoThreadState::Initialized));
 }
@@ -97,7 +97,11 @@ void HidIoThread::pollBufferedInputReports() {
     // If the interval between two polls is to long, multiple buffered HID InputReports
     // will be processed at the same time.
     while (m_state.loadAcquire() == static_cast<int>(HidIoThreadState::InputOutputActive)) {
-        int bytesRead = hid_read(m_pHidDevice, m_pPollData[m_pollingBufferIndex], kBufferSize);
+        QByteArray& inputReport = nextInputReportBuffer();
+        inputReport.resize(kBufferSize);
+        int bytesRead = hid_read(m_pHidDevice,
+                reinterpret_cast<unsigned char*>(inputReport.data()),
+                kBufferSize);
         if (bytesRead < 0) {
             // -1 is the only error value according to hidapi documentation.
             DEBUG_ASSERT(bytesRead == -1);
@@ -122,14 +126,35 @@ void HidIoThread::pollBufferedInputReports() {
                 break;
             }
         }
-        processInputReport(bytesRead);
+        processInputReport(inputReport, bytesRead);
+    }
+}
+
+QByteArray& HidIoThread::nextInputReportBuffer() {
+    for (auto& buffer : m_inputReportPool) {
+        // The reference count is atomic, the receivers may release
+        // their shallow copies concurrently
+        if (buffer.isDetached()) {
+            return buffer;
+        }
     }
+    if (m_inputReportPool.size() < kMaxPooledInputReports) {
+        m_inputReportPool.emplace_back();
+        m_inputReportPool.back().reserve(kBufferSize);
+        return m_inputReportPool.back();
+    }
+    // Replacing an entry doesn't affect the receivers that still
+    // reference its previous buffer
+    QByteArray& buffer = m_inputReportPool[m_inputReportPool.size() - 1];
+    buffer = QByteArray();
+    buffer.reserve(kBufferSize);
+    return buffer;
 }
 
-void HidIoThread::processInputReport(int bytesRead) {
+void HidIoThread::processInputReport(QByteArray& inputReport, int bytesRead) {
     Trace process("HidIO processInputReport");
-    unsigned char* pPreviousBuffer = m_pPollData[(m_pollingBufferIndex + 1) % kNumBuffers];
-    unsigned char* pCurrentBuffer = m_pPollData[m_pollingBufferIndex];
+    // Doesn't reallocate the reserved memory
+    inputReport.resize(bytesRead);
     // Some controllers such as the Gemini GMX continuously send input reports even if it
     // is identical to the previous send input report. If this loop processed all those redundant
     // input report, it would be a big performance problem to run JS code for every  input report and
@@ -138,28 +163,25 @@ void HidIoThread::processInputReport(int bytesRead) {
     // have not encountered any controllers that send redundant input report with different report
     // IDs. If any such devices exist, this may be changed to use a separate buffer to store
     // the last input report for each report ID.
-    if (bytesRead == m_lastPollSize &&
-            memcmp(pCurrentBuffer, pPreviousBuffer, bytesRead) == 0) {
+    if (inputReport == m_lastInputReport) {
         return;
     }
-    // Cycle between buffers so the memcmp above does not require deep copying to another buffer.
-    m_pollingBufferIndex = (m_pollingBufferIndex + 1) % kNumBuffers;
-    m_lastPollSize = bytesRead;
-
-    // Convert array of bytes read in a JavaScript compatible return type, this is emitted as deep-copy, for thread safety.
-    // This eexecute callback function in JavaScript mapping and print to stdout in case of --controllerDebug
-    emit receive(QByteArray(reinterpret_cast<const char*>(pCurrentBuffer),
-                         bytesRead),
-            mixxx::Time::elapsed());
+    // The previous buffer is returned to the pool once the receivers are done
+    m_lastInputReport = inputReport;
+
+    // The buffer is emitted as shallow copy. It is not modified until all
+    // receivers have released it, see nextInputReportBuffer().
+    // This execute callback function in JavaScript mapping and print to stdout in case of --controllerDebug
+    emit receive(inputReport, mixxx::Time::elapsed());
 }
 
 QByteArray HidIoThread::getInputReport(quint8 reportID) {
     auto startOfHidGetInputReport = mixxx::Time::elapsed();
     auto hidDeviceLock = lockMutex(&m_hidDeviceAndPollMutex);
 
-    m_pPollData[m_pollingBufferIndex][0] = reportID;
+    m_pPollData[0] = reportID;
     int bytesRead = hid_get_input_report(
-            m_pHidDevice, m_pPollData[m_pollingBufferIndex], kBufferSize);
+            m_pHidDevice, m_pPollData, kBufferSize);
     if (bytesRead <= kReportIdSize) {
         // -1 is the only error value according to hidapi documentation.
         // Otherwise minimum possible value is 1, because 1 byte is for the reportID,
@@ -177,7 +199,7 @@ QByteArray HidIoThread::getInputReport(quint8 reportID) {
 
     // Convert array of bytes read in a JavaScript compatible return type, this is returned as deep-copy, for thread safety.
     QByteArray returnArray = QByteArray(
-            reinterpret_cast<char*>(m_pPollData[m_pollingBufferIndex] + kReportIdSize),
+            reinterpret_cast<char*>(m_pPollData + kReportIdSize),
             bytesRead - kReportIdSize);
 
     hidDeviceLock.unlock();
@@ -3,6 +3,7 @@
 #include <QSemaphore>
 #include <QThread>
 #include <map>
+#include <vector>
 
 #include "controllers/hid/hiddevice.h"
 #include "controllers/hid/hidioglobaloutputreportfifo.h"
@@ -57,7 +58,10 @@ class HidIoThread : public QThread {
     bool sendNextCachedOutputReport();
 
     void pollBufferedInputReports();
-    void processInputReport(int bytesRead);
+    /// Returns a buffer from m_inputReportPool that isn't referenced
+    /// by a receiver anymore
+    QByteArray& nextInputReportBuffer();
+    void processInputReport(QByteArray& inputReport, int bytesRead);
 
     const mixxx::hid::DeviceInfo m_deviceInfo;
     const RuntimeLoggingCategory m_logBase;
@@ -67,18 +71,22 @@ class HidIoThread : public QThread {
     /// This mutex must be locked for any hid device operation using the m_pHidDevice structure.
     /// If the hid_error functions is called after the hid device operation to get the error message,
     /// this mutex must not be unlocked before hid_error.
-    /// This mutex must be locked also, for access to m_pPollData, m_lastPollSize, m_pollingBufferIndex.
+    /// This mutex must be locked also, for access to m_pPollData, m_inputReportPool and
+    /// m_lastInputReport.
     QMutex m_hidDeviceAndPollMutex;
 
     /// const pointer to the C data structure, which hidapi uses for communication between functions
     hid_device* const
             m_pHidDevice;
 
-    static constexpr int kNumBuffers = 2;
     static constexpr int kBufferSize = 255;
-    unsigned char m_pPollData[kNumBuffers][kBufferSize];
-    int m_lastPollSize;
-    int m_pollingBufferIndex;
+    unsigned char m_pPollData[kBufferSize];
+    /// InputReports are read directly into these buffers, that are shared
+    /// with the receivers. A buffer is reused once all receivers have
+    /// released it, so no memory is allocated while the receivers keep up.
+    std::vector<QByteArray> m_inputReportPool;
+    /// Shares the buffer of the previously emitted InputReport
+    QByteArray m_lastInputReport;
     bool m_hidReadErrorLogged;
 
     /// Must be locked when a operation changes the size of the m_outputReports map,
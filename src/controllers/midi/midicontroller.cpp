@@ -2,7 +2,9 @@
 
 #include <QJSValue>
 #include <algorithm>
+#include <cmath>
 
+#include "control/control.h"
 #include "control/controlobject.h"
 #include "control/controlpotmeter.h"
 #include "controllers/defs_controllers.h"
@@ -13,8 +15,11 @@
 #include "errordialoghandler.h"
 #include "mixer/playermanager.h"
 #include "moc_midicontroller.cpp"
+#include "soundio/xrunrecorder.h"
+#include "util/inputtimestamp.h"
 #include "util/make_const_iterator.h"
 #include "util/math.h"
+#include "util/time.h"
 
 const QString kMakeInputHandlerError = QStringLiteral(
         "Invalid timer callback provided to midi.makeInputHandler. "
@@ -32,13 +37,77 @@ bool MidiInputHandleJSProxy::disconnect() {
     return m_pMidiController->removeInputMapping(m_inputMapping.key.key, m_inputMapping);
 }
 
+namespace {
+
+// A DIN MIDI port transmits 3125 bytes per second. USB-MIDI devices are
+// faster, but many of them start buffering output when sending much more.
+constexpr double kOutputBudgetBytesPerSecond = 4 * 3125.0;
+// Allows to update many outputs at once, e.g. after loading a track
+constexpr double kMaxOutputBudgetBytes = 1024.0;
+
+uint16_t scheduledShortMsgKey(unsigned char status, unsigned char byte1) {
+    // A Note Off replaces a pending Note On with the same note and vice versa
+    if (MidiUtils::opCodeFromStatus(status) == MidiOpCode::NoteOff) {
+        status = MidiUtils::statusFromOpCodeAndChannel(
+                MidiOpCode::NoteOn, MidiUtils::channelFromStatus(status));
+    }
+    return (static_cast<uint16_t>(status) << 8) | byte1;
+}
+
+bool isReplaceableShortMsg(unsigned char status, unsigned char byte1) {
+    switch (MidiUtils::opCodeFromStatus(status)) {
+    case MidiOpCode::NoteOff:
+    case MidiOpCode::NoteOn:
+    case MidiOpCode::PolyphonicKeyPressure:
+        return true;
+    case MidiOpCode::ControlChange:
+        // The order of (N)RPN parameter numbers and data entry matters
+        return byte1 != 0x06 && byte1 != 0x26 && (byte1 < 0x60 || byte1 > 0x65);
+    default:
+        return false;
+    }
+}
+
+int shortMsgBytes(unsigned char status) {
+    return MidiUtils::isMessageTwoBytes(status) ? 2 : 3;
+}
+
+// 128 status bytes with 128 controls each
+constexpr std::size_t kNumCompiledInputMappingKeys = 128 * 128;
+
+bool isCompiledInputMappingKey(MidiKey key) {
+    return key.status >= 0x80 && key.control <= 0x7F;
+}
+
+std::size_t compiledInputMappingIndex(MidiKey key) {
+    return (static_cast<std::size_t>(key.status & 0x7F) << 7) | key.control;
+}
+
+} // anonymous namespace
+
 MidiController::MidiController(const QString& deviceName)
-        : Controller(deviceName) {
+        : Controller(deviceName),
+          m_firstScheduledShortMsgSeq(0),
+          m_scheduledShortMsgTimer(this),
+          m_outputBudgetBytes(kMaxOutputBudgetBytes),
+          m_outputBudgetRefillTime(mixxx::Time::elapsed()),
+          m_outputThrottled(false),
+          m_droppedShortMsgCount(0),
+          m_sentShortMsgsCounter(QStringLiteral("MidiController::sentShortMsgs ") + deviceName),
+          m_droppedShortMsgsCounter(
+                  QStringLiteral("MidiController::droppedShortMsgs ") + deviceName),
+          m_inputMappingsCompiled(false) {
+    m_scheduledShortMsgTimer.setSingleShot(true);
+    connect(&m_scheduledShortMsgTimer,
+            &QTimer::timeout,
+            this,
+            &MidiController::sendScheduledShortMsgs);
 }
 
 void MidiController::slotBeforeEngineShutdown() {
     Controller::slotBeforeEngineShutdown();
     m_pMapping->removeInputHandlerMappings();
+    invalidateCompiledInputMappings();
 }
 
 MidiController::~MidiController() {
@@ -58,6 +127,7 @@ QString MidiController::mappingExtension() {
 void MidiController::setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) {
     m_pMutableMapping = pMapping;
     m_pMapping = downcastAndClone<LegacyMidiControllerMapping>(pMapping.get());
+    invalidateCompiledInputMappings();
 }
 
 QList<LegacyControllerMapping::ScriptFileInfo> MidiController::getMappingScriptFiles() {
@@ -92,9 +162,119 @@ QList<LegacyControllerMapping::ScreenInfo> MidiController::getMappingInfoScreens
 
 int MidiController::close() {
     destroyOutputHandlers();
+    // Includes the messages sent by the shutdown function of the mapping
+    flushScheduledShortMsgs(true);
+    clearScheduledShortMsgs();
     return 0;
 }
 
+void MidiController::scheduleShortMsg(unsigned char status,
+        unsigned char byte1,
+        unsigned char byte2) {
+    const bool replaceable = isReplaceableShortMsg(status, byte1);
+    if (replaceable) {
+        const uint16_t key = scheduledShortMsgKey(status, byte1);
+        const auto it = m_replaceableShortMsgSeqs.constFind(key);
+        if (it != m_replaceableShortMsgSeqs.constEnd()) {
+            // Keeps the position of the pending message
+            m_scheduledShortMsgs[it.value() - m_firstScheduledShortMsgSeq] =
+                    ScheduledShortMsg{status, byte1, byte2};
+            ++m_droppedShortMsgCount;
+            return;
+        }
+        m_replaceableShortMsgSeqs.insert(key,
+                m_firstScheduledShortMsgSeq + m_scheduledShortMsgs.size());
+    }
+    m_scheduledShortMsgs.push_back(ScheduledShortMsg{status, byte1, byte2});
+    if (!m_scheduledShortMsgTimer.isActive()) {
+        m_scheduledShortMsgTimer.start(0);
+    }
+}
+
+void MidiController::send(const QList<int>& data, unsigned int length) {
+    flushScheduledShortMsgs(true);
+    Controller::send(data, length);
+}
+
+void MidiController::sendScheduledShortMsgs() {
+    flushScheduledShortMsgs(false);
+}
+
+void MidiController::refillOutputBudget() {
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    m_outputBudgetBytes = math_min(kMaxOutputBudgetBytes,
+            m_outputBudgetBytes +
+                    (now - m_outputBudgetRefillTime).toDoubleSeconds() *
+                            kOutputBudgetBytesPerSecond);
+    m_outputBudgetRefillTime = now;
+}
+
+void MidiController::flushScheduledShortMsgs(bool ignoreBudget) {
+    refillOutputBudget();
+    int sentCount = 0;
+    while (!m_scheduledShortMsgs.empty()) {
+        const ScheduledShortMsg msg = m_scheduledShortMsgs.front();
+        const int bytes = shortMsgBytes(msg.status);
+        if (!ignoreBudget && m_outputBudgetBytes < bytes) {
+            break;
+        }
+        m_scheduledShortMsgs.pop_front();
+        const quint64 seq = m_firstScheduledShortMsgSeq++;
+        if (!isReplaceableShortMsg(msg.status, msg.byte1)) {
+            sendShortMsg(msg.status, msg.byte1, msg.byte2);
+            m_outputBudgetBytes -= bytes;
+            ++sentCount;
+            continue;
+        }
+        const uint16_t key = scheduledShortMsgKey(msg.status, msg.byte1);
+        const auto it = m_replaceableShortMsgSeqs.find(key);
+        DEBUG_ASSERT(it != m_replaceableShortMsgSeqs.end() && it.value() == seq);
+        m_replaceableShortMsgSeqs.erase(it);
+        // Resending the same value is only avoided while throttled, because
+        // some devices change the state of their LEDs on their own.
+        const uint16_t statusAndValue =
+                (static_cast<uint16_t>(msg.status) << 8) | msg.byte2;
+        const auto lastSent = m_lastSentShortMsgs.constFind(key);
+        if (m_outputThrottled &&
+                lastSent != m_lastSentShortMsgs.constEnd() &&
+                lastSent.value() == statusAndValue) {
+            ++m_droppedShortMsgCount;
+            continue;
+        }
+        sendShortMsg(msg.status, msg.byte1, msg.byte2);
+        m_outputBudgetBytes -= bytes;
+        m_lastSentShortMsgs.insert(key, statusAndValue);
+        ++sentCount;
+    }
+
+    if (sentCount > 0) {
+        m_sentShortMsgsCounter += sentCount;
+    }
+    if (m_droppedShortMsgCount > 0) {
+        m_droppedShortMsgsCounter += m_droppedShortMsgCount;
+        m_droppedShortMsgCount = 0;
+    }
+
+    m_outputThrottled = !m_scheduledShortMsgs.empty();
+    if (m_outputThrottled) {
+        // Wait until the next message fits into the budget
+        const double missingBytes = shortMsgBytes(m_scheduledShortMsgs.front().status) -
+                m_outputBudgetBytes;
+        m_scheduledShortMsgTimer.start(math_max(1,
+                static_cast<int>(std::ceil(
+                        missingBytes * 1000 / kOutputBudgetBytesPerSecond))));
+    }
+}
+
+void MidiController::clearScheduledShortMsgs() {
+    m_scheduledShortMsgTimer.stop();
+    m_firstScheduledShortMsgSeq += m_scheduledShortMsgs.size();
+    m_scheduledShortMsgs.clear();
+    m_replaceableShortMsgSeqs.clear();
+    m_lastSentShortMsgs.clear();
+    m_outputThrottled = false;
+}
+
 bool MidiController::matchMapping(const MappingInfo& mapping) {
     // Product info mapping not implemented for MIDI devices yet
     Q_UNUSED(mapping);
@@ -104,6 +284,8 @@ bool MidiController::matchMapping(const MappingInfo& mapping) {
 bool MidiController::applyMapping(const QString& resourcePath) {
     // Handles the engine
     bool result = Controller::applyMapping(resourcePath);
+    // The callback counters of the script mappings belong to the new engine
+    invalidateCompiledInputMappings();
 
     // Only execute this code if this is an output device
     if (isOutputDevice()) {
@@ -268,6 +450,63 @@ void MidiController::commitTemporaryInputMappings() {
         m_pMapping->addInputMapping(it.key(), it.value());
     }
     m_temporaryInputMappings.clear();
+    invalidateCompiledInputMappings();
+}
+
+void MidiController::compileInputMappings() {
+    const auto& inputMappings = m_pMapping->getInputMappings();
+    const auto pEngine = getScriptEngine();
+    m_compiledInputMappings.clear();
+    m_compiledInputMappings.reserve(inputMappings.size());
+    // One additional offset for the end of the last range
+    m_compiledInputMappingOffsets.assign(kNumCompiledInputMappingKeys + 1, 0);
+
+    // Mappings with the same key are adjacent in the QMultiHash, so a
+    // stable counting sort preserves their order
+    MidiKey key;
+    for (auto it = inputMappings.constBegin(); it != inputMappings.constEnd(); ++it) {
+        key.key = it.key();
+        if (isCompiledInputMappingKey(key)) {
+            ++m_compiledInputMappingOffsets[compiledInputMappingIndex(key) + 1];
+        }
+    }
+    for (std::size_t i = 1; i < m_compiledInputMappingOffsets.size(); ++i) {
+        m_compiledInputMappingOffsets[i] += m_compiledInputMappingOffsets[i - 1];
+    }
+    std::vector<quint32> nextPositions(
+            m_compiledInputMappingOffsets.cbegin(),
+            m_compiledInputMappingOffsets.cend() - 1);
+    m_compiledInputMappings.resize(m_compiledInputMappingOffsets.back());
+    for (auto it = inputMappings.constBegin(); it != inputMappings.constEnd(); ++it) {
+        key.key = it.key();
+        if (!isCompiledInputMappingKey(key)) {
+            continue;
+        }
+        const MidiInputMapping& mapping = it.value();
+        CompiledInputMapping& compiled = m_compiledInputMappings[
+                nextPositions[compiledInputMappingIndex(key)]++];
+        compiled.mapping = mapping;
+        const auto* pConfigKey = std::get_if<ConfigKey>(&mapping.control);
+        if (pConfigKey && !mapping.options.testFlag(MidiOption::Script)) {
+            // Missing controls are looked up again when a message is received
+            compiled.pControl = ControlDoublePrivate::getControl(
+                    *pConfigKey, ControlFlag::NoWarnIfMissing);
+        } else {
+            compiled.pControl.reset();
+        }
+        if (pEngine && mapping.options.testFlag(MidiOption::Script)) {
+            compiled.pCallbackCounters = pEngine->callbackCounters(pConfigKey
+                            ? pConfigKey->item
+                            : QStringLiteral("MIDI 0x%1 0x%2")
+                                      .arg(QString::number(key.status, 16)
+                                                      .rightJustified(2, '0'),
+                                              QString::number(key.control, 16)
+                                                      .rightJustified(2, '0')));
+        } else {
+            compiled.pCallbackCounters.reset();
+        }
+    }
+    m_inputMappingsCompiled = true;
 }
 
 void MidiController::receivedShortMessage(unsigned char status,
@@ -311,11 +550,36 @@ void MidiController::receivedShortMessage(unsigned char status,
         }
     }
 
-    for (auto [it, end] =
-                    m_pMapping->getInputMappings().equal_range(mappingKey.key);
-            it != end;
-            ++it) {
-        processInputMapping(it.value(), status, control, value, timestamp);
+    if (!isCompiledInputMappingKey(mappingKey)) {
+        for (auto [it, end] =
+                        m_pMapping->getInputMappings().equal_range(mappingKey.key);
+                it != end;
+                ++it) {
+            processInputMapping(it.value(), status, control, value, timestamp);
+        }
+        return;
+    }
+
+    if (!m_inputMappingsCompiled) {
+        compileInputMappings();
+    }
+    const std::size_t index = compiledInputMappingIndex(mappingKey);
+    // Script handlers that add or remove mappings only invalidate the
+    // compiled mappings, they are not modified while dispatching
+    for (quint32 i = m_compiledInputMappingOffsets[index];
+            i < m_compiledInputMappingOffsets[index + 1];
+            ++i) {
+        const CompiledInputMapping& compiled = m_compiledInputMappings[i];
+        ControlObject* pControl = compiled.pControl
+                ? compiled.pControl->getCreatorCO()
+                : nullptr;
+        processInputMapping(compiled.mapping,
+                status,
+                control,
+                value,
+                timestamp,
+                pControl,
+                compiled.pCallbackCounters.get());
     }
 }
 
@@ -323,8 +587,11 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
         unsigned char status,
         unsigned char control,
         unsigned char value,
-        mixxx::Duration timestamp) {
-    Q_UNUSED(timestamp)
+        mixxx::Duration timestamp,
+        ControlObject* pControl,
+        ScriptCallbackCounters* pCallbackCounters) {
+    // Seeks requested by the mapping are applied at the time of the message
+    const mixxx::ScopedInputTimestamp scopedTimestamp(timestamp);
     unsigned char channel = MidiUtils::channelFromStatus(status);
     MidiOpCode opCode = MidiUtils::opCodeFromStatus(status);
 
@@ -336,7 +603,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
 
         return std::visit(
                 MidiUtils::overloaded{
-                        [pEngine, this, channel, status, control, value](
+                        [pEngine, this, channel, status, control, value, pCallbackCounters](
                                 const ConfigKey& target) {
                             QJSValue function = pEngine->wrapFunctionCode(
                                     target.item, 5);
@@ -348,12 +615,12 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
                                     target.group,
                             };
 
-                            if (!pEngine->executeFunction(&function, args)) {
+                            if (!pEngine->executeFunction(&function, args, pCallbackCounters)) {
                                 qCWarning(m_logBase) << "MidiController: Invalid script function"
                                                      << target.item;
                             }
                         },
-                        [pEngine, this, channel, status, control, value](
+                        [pEngine, this, channel, status, control, value, pCallbackCounters](
                                 const std::shared_ptr<QJSValue>& target) {
                             const auto args = QJSValueList{
                                     channel,
@@ -362,7 +629,8 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
                                     status,
                             };
 
-                            if (!pEngine->executeFunction(target.get(), args)) {
+                            if (!pEngine->executeFunction(
+                                        target.get(), args, pCallbackCounters)) {
                                 qCWarning(m_logBase).nospace()
                                         << "MidiController: Invalid script "
                                            "anonymous function with args ["
@@ -379,7 +647,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
 
     // Only pass values on to valid ControlObjects.
     auto configKey = std::get<ConfigKey>(mapping.control);
-    ControlObject* pCO = ControlObject::getControl(configKey);
+    ControlObject* pCO = pControl ? pControl : ControlObject::getControl(configKey);
     if (pCO == nullptr) {
         return;
     }
@@ -489,6 +757,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
         }
     }
     pCO->setValueFromMidi(static_cast<MidiOpCode>(opCode), newValue);
+    XrunRecorder::recordControlEvent(pCO->getKey(), pCO->get());
 }
 
 double MidiController::computeValue(
@@ -632,6 +901,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
         if (pEngine == nullptr) {
             return;
         }
+        const mixxx::ScopedInputTimestamp scopedTimestamp(timestamp);
         pEngine->handleIncomingData(data);
         return;
     }
@@ -687,6 +957,7 @@ QJSValue MidiController::makeInputHandler(unsigned char status,
             std::make_shared<QJSValue>(scriptCode));
 
     m_pMapping->addInputMapping(inputMapping.key.key, inputMapping);
+    invalidateCompiledInputMappings();
     // The returned object can be used for disconnecting like this:
     // var connection = midi.makeInputHandler();
     // connection.disconnect();
@@ -695,5 +966,6 @@ QJSValue MidiController::makeInputHandler(unsigned char status,
 
 bool MidiController::removeInputMapping(
         uint16_t key, const MidiInputMapping& mapping) {
+    invalidateCompiledInputMappings();
     return m_pMapping->removeInputMapping(key, mapping);
 }
@@ -1,12 +1,20 @@
 #pragma once
 
+#include <QHash>
 #include <QJSValue>
+#include <QSharedPointer>
+#include <QTimer>
+#include <deque>
+#include <vector>
 
 #include "controllers/controller.h"
 #include "controllers/midi/legacymidicontrollermapping.h"
 #include "controllers/midi/midimessage.h"
+#include "controllers/scripting/scriptcallbackcounters.h"
 #include "controllers/softtakeover.h"
+#include "util/counter.h"
 
+class ControlDoublePrivate;
 class MidiOutputHandler;
 class MidiController;
 
@@ -70,6 +78,21 @@ class MidiController : public Controller {
             unsigned char byte1,
             unsigned char byte2) = 0;
 
+    /// Queues a short message that is sent by sendScheduledShortMsgs()
+    /// when control returns to the event loop of the controller thread.
+    ///
+    /// Until then a pending Note On/Off, Polyphonic Aftertouch or Control
+    /// Change message is replaced by a subsequent message with the same
+    /// status and first data byte. Messages are delayed to stay within the
+    /// output bandwidth budget of the device. While delayed, messages that
+    /// would resend the previously sent value are dropped.
+    void scheduleShortMsg(unsigned char status,
+            unsigned char byte1,
+            unsigned char byte2);
+
+    /// Sends all scheduled short messages first to preserve the order
+    void send(const QList<int>& data, unsigned int length = 0) override;
+
     /// Alias for send()
     /// The length parameter is here for backwards compatibility for when scripts
     /// were required to specify it.
@@ -96,27 +119,86 @@ class MidiController : public Controller {
     void slotBeforeEngineShutdown() override;
 
   private slots:
+    void sendScheduledShortMsgs();
     void learnTemporaryInputMappings(const MidiInputMappings& mappings);
     void clearTemporaryInputMappings();
     void commitTemporaryInputMappings();
 
   private:
+    // The execution of script mappings is only recorded in the callback
+    // statistics if pCallbackCounters is not null, i.e. for the compiled
+    // mappings
     void processInputMapping(
             const MidiInputMapping& mapping,
             unsigned char status,
             unsigned char control,
             unsigned char value,
-            mixxx::Duration timestamp);
+            mixxx::Duration timestamp,
+            ControlObject* pControl = nullptr,
+            ScriptCallbackCounters* pCallbackCounters = nullptr);
     void processInputMapping(
             const MidiInputMapping& mapping,
             const QByteArray& data,
             mixxx::Duration timestamp);
 
+    // Groups the input mappings by status and control and resolves their
+    // controls, so that incoming messages are dispatched without lookups
+    void compileInputMappings();
+    void invalidateCompiledInputMappings() {
+        m_inputMappingsCompiled = false;
+    }
+
     double computeValue(MidiOptions options, double _prevmidivalue, double _newmidivalue);
     void createOutputHandlers();
     void updateAllOutputs();
     void destroyOutputHandlers();
 
+    // Refills the output budget for the time that has elapsed since the
+    // previous invocation
+    void refillOutputBudget();
+    // Sends the scheduled messages that fit into the output budget or
+    // all of them if the budget is ignored
+    void flushScheduledShortMsgs(bool ignoreBudget);
+    void clearScheduledShortMsgs();
+
+    struct ScheduledShortMsg {
+        unsigned char status;
+        unsigned char byte1;
+        unsigned char byte2;
+    };
+    std::deque<ScheduledShortMsg> m_scheduledShortMsgs;
+    // The sequence number of the first scheduled message
+    quint64 m_firstScheduledShortMsgSeq;
+    // The sequence numbers of the scheduled messages that could be replaced
+    // by a subsequent message, keyed by status and first data byte
+    QHash<uint16_t, quint64> m_replaceableShortMsgSeqs;
+    // The status and second data byte of the previously sent messages,
+    // keyed like m_replaceableShortMsgSeqs
+    QHash<uint16_t, uint16_t> m_lastSentShortMsgs;
+    QTimer m_scheduledShortMsgTimer;
+    double m_outputBudgetBytes;
+    mixxx::Duration m_outputBudgetRefillTime;
+    // Set while messages are delayed to stay within the budget
+    bool m_outputThrottled;
+    // Replaced and dropped messages that have not been counted yet
+    int m_droppedShortMsgCount;
+    Counter m_sentShortMsgsCounter;
+    Counter m_droppedShortMsgsCounter;
+
+    struct CompiledInputMapping {
+        MidiInputMapping mapping;
+        // Null for script mappings and if the control didn't exist yet
+        QSharedPointer<ControlDoublePrivate> pControl;
+        // Only for script mappings, registered with the current script engine
+        ScriptCallbackCountersPointer pCallbackCounters;
+    };
+    // The mappings of a status and control in the same order as in the
+    // QMultiHash of m_pMapping. The range of a MidiKey starts at the offset
+    // with the index ((status & 0x7F) << 7) | control.
+    std::vector<CompiledInputMapping> m_compiledInputMappings;
+    std::vector<quint32> m_compiledInputMappingOffsets;
+    bool m_inputMappingsCompiled;
+
     QHash<uint16_t, MidiInputMapping> m_temporaryInputMappings;
     QList<MidiOutputHandler*> m_outputs;
     std::unique_ptr<LegacyMidiControllerMapping> m_pMapping;
@@ -143,7 +225,7 @@ class MidiControllerJSProxy : public ControllerJSProxy {
     Q_INVOKABLE void sendShortMsg(unsigned char status,
             unsigned char byte1,
             unsigned char byte2) {
-        m_pMidiController->sendShortMsg(status, byte1, byte2);
+        m_pMidiController->scheduleShortMsg(status, byte1, byte2);
     }
 
     Q_INVOKABLE void sendSysexMsg(const QList<int>& data, unsigned int length = 0) {
@@ -1,7 +1,10 @@
 #include "controllers/midi/portmidicontroller.h"
 
+#include <porttime.h>
+
 #include "controllers/midi/midiutils.h"
 #include "moc_portmidicontroller.cpp"
+#include "util/time.h"
 
 namespace {
 const QString kUnknownControllerName = QStringLiteral("Unknown PortMidiController");
@@ -130,9 +133,15 @@ bool PortMidiController::poll() {
         return false;
     }
 
+    // The timestamps are taken from the PortTime clock, that is implicitly
+    // used when opening the device. They are converted to the clock of
+    // mixxx::Time, which is also used by the engine.
+    const PmTimestamp polledAt = Pt_Time();
+    const mixxx::Duration polledAtTime = mixxx::Time::elapsed();
     for (int i = 0; i < numEvents; i++) {
         unsigned char status = Pm_MessageStatus(m_midiBuffer[i].message);
-        mixxx::Duration timestamp = mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp);
+        mixxx::Duration timestamp = polledAtTime -
+                mixxx::Duration::fromMillis(polledAt - m_midiBuffer[i].timestamp);
 
         if ((status & 0xF8) == 0xF8) {
             // Handle real-time MIDI messages at any time
@@ -188,6 +197,12 @@ bool PortMidiController::poll() {
             }
         }
     }
+
+    const PmTimestamp handledAt = Pt_Time();
+    for (int i = 0; i < numEvents; i++) {
+        trackInputLatency(mixxx::Duration::fromMillis(
+                handledAt - m_midiBuffer[i].timestamp));
+    }
     return numEvents > 0;
 }
 
@@ -1,6 +1,7 @@
 #include "controllers/rendering/controllerrenderingengine.h"
 
 #include <QOffscreenSurface>
+#include <QOpenGLBuffer>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions>
@@ -10,6 +11,7 @@
 #include <QQuickRenderTarget>
 #include <QQuickWindow>
 #include <QThread>
+#include <cstring>
 
 #include "controllers/controller.h"
 #include "controllers/controllerenginethreadcontrol.h"
@@ -33,6 +35,10 @@
 
 namespace {
 const mixxx::Logger kLogger("ControllerRenderingEngine");
+
+// Unchanged frames are still sent with this interval, in case the device
+// expects to receive frames regularly
+constexpr auto kMaxUnchangedFrameInterval = std::chrono::seconds(1);
 } // anonymous namespace
 
 using Clock = std::chrono::steady_clock;
@@ -42,6 +48,10 @@ ControllerRenderingEngine::ControllerRenderingEngine(
         gsl::not_null<ControllerEngineThreadControl*> engineThreadControl)
         : QObject(),
           m_screenInfo(info),
+          m_pixelPackBuffersSupported(false),
+          m_pixelPackBufferIndex(0),
+          m_pixelReadbackPending(false),
+          m_sceneChanged(true),
           m_GLDataFormat(GL_RGBA),
           m_GLDataType(GL_UNSIGNED_BYTE),
           m_isValid(true),
@@ -212,8 +222,23 @@ void ControllerRenderingEngine::setup(std::shared_ptr<QQmlEngine> qmlEngine) {
         return;
     }
 
+    // Mapping a range of a pixel pack buffer requires OpenGL (ES) 3.0
+    m_pixelPackBuffersSupported = m_context->format().majorVersion() >= 3;
+
     m_renderControl = std::make_unique<QQuickRenderControl>(this);
     m_quickWindow = std::make_unique<QQuickWindow>(m_renderControl.get());
+    // Emitted from the thread of the QML engine if items have changed
+    const auto setSceneChanged = [this] {
+        m_sceneChanged = true;
+    };
+    connect(m_renderControl.get(),
+            &QQuickRenderControl::renderRequested,
+            this,
+            setSceneChanged);
+    connect(m_renderControl.get(),
+            &QQuickRenderControl::sceneChanged,
+            this,
+            setSceneChanged);
 
     if (!qmlEngine->incubationController()) {
         qmlEngine->setIncubationController(m_quickWindow->incubationController());
@@ -244,8 +269,12 @@ void ControllerRenderingEngine::finish() {
                 });
         m_quickWindow.reset();
 
-        // Free the engine and FBO.
+        // Free the engine, FBO and pixel pack buffers.
         m_fbo.reset();
+        for (auto& pPixelPackBuffer : m_pixelPackBuffers) {
+            pPixelPackBuffer.reset();
+        }
+        m_pixelReadbackPending = false;
 
         m_context->doneCurrent();
     }
@@ -292,6 +321,21 @@ void ControllerRenderingEngine::renderFrame() {
 
     m_nextFrameStart = Clock::now();
 
+    if (!m_sceneChanged &&
+            m_nextFrameStart - m_lastFrameRendered < kMaxUnchangedFrameInterval) {
+        // Nothing to render, but the pending frame still needs to be sent
+        QImage pendingImage;
+        if (finishPixelReadback(&pendingImage)) {
+            emitFrame(std::move(pendingImage), m_pendingFrameTimestamp);
+        } else {
+            scheduleNextFrame();
+        }
+        m_context->doneCurrent();
+        return;
+    }
+    m_lastFrameRendered = m_nextFrameStart;
+    m_sceneChanged = false;
+
     m_renderControl->beginFrame();
 
     if (m_pEngineThreadControl) {
@@ -310,8 +354,6 @@ void ControllerRenderingEngine::renderFrame() {
     if (m_pEngineThreadControl) {
         m_pEngineThreadControl->resume();
     }
-    QImage fboImage(m_screenInfo.size, m_screenInfo.pixelFormat);
-
     VERIFY_OR_DEBUG_ASSERT(m_fbo->bind()) {
         kLogger.warning() << "Couldn't bind the FBO.";
     }
@@ -340,8 +382,23 @@ void ControllerRenderingEngine::renderFrame() {
     while ((glError = m_context->functions()->glGetError()) != GL_NO_ERROR) {
         kLogger.debug() << "Retrieved a previously unhandled GL error: " << glError;
     }
-    {
+    QImage fboImage;
+    bool framePending = false;
+    if (m_pixelPackBuffersSupported) {
+        // The pixels of the previous frame are available by now
+        framePending = finishPixelReadback(&fboImage);
+        if (startPixelReadback()) {
+            // The timestamp of this frame is used when it is sent
+            std::swap(timestamp, m_pendingFrameTimestamp);
+        } else {
+            kLogger.warning() << "Pixel pack buffers are not available, "
+                                 "reading pixels synchronously";
+            m_pixelPackBuffersSupported = false;
+        }
+    }
+    if (!m_pixelPackBuffersSupported) {
         ScopedTimer t(QStringLiteral("ControllerRenderingEngine::renderFrame::glReadPixels"));
+        fboImage = QImage(m_screenInfo.size, m_screenInfo.pixelFormat);
         m_context->functions()->glReadPixels(0,
                 0,
                 m_screenInfo.size.width(),
@@ -349,23 +406,90 @@ void ControllerRenderingEngine::renderFrame() {
                 m_GLDataFormat,
                 m_GLDataType,
                 fboImage.bits());
+        framePending = true;
     }
     glError = m_context->functions()->glGetError();
     VERIFY_OR_TERMINATE(glError == GL_NO_ERROR, "GLError: " << glError);
-    VERIFY_OR_DEBUG_ASSERT(!fboImage.isNull()) {
-        kLogger.warning() << "Screen frame is null!";
-    }
     VERIFY_OR_DEBUG_ASSERT(m_fbo->release()) {
         kLogger.debug() << "Couldn't release the FBO.";
     }
 
-    fboImage.mirror(false, true);
-
-    emit frameRendered(m_screenInfo, fboImage.copy(), timestamp);
+    if (framePending) {
+        VERIFY_OR_DEBUG_ASSERT(!fboImage.isNull()) {
+            kLogger.warning() << "Screen frame is null!";
+        }
+        emitFrame(std::move(fboImage), timestamp);
+    } else {
+        // The first frame is sent after rendering the next frame
+        scheduleNextFrame();
+    }
 
     m_context->doneCurrent();
 }
 
+bool ControllerRenderingEngine::startPixelReadback() {
+    ScopedTimer t(QStringLiteral("ControllerRenderingEngine::startPixelReadback"));
+    auto& pPixelPackBuffer = m_pixelPackBuffers[m_pixelPackBufferIndex];
+    if (!pPixelPackBuffer) {
+        pPixelPackBuffer = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::PixelPackBuffer);
+        pPixelPackBuffer->setUsagePattern(QOpenGLBuffer::StreamRead);
+        if (!pPixelPackBuffer->create() || !pPixelPackBuffer->bind()) {
+            pPixelPackBuffer.reset();
+            return false;
+        }
+        pPixelPackBuffer->allocate(static_cast<int>(
+                QImage(m_screenInfo.size, m_screenInfo.pixelFormat).sizeInBytes()));
+    } else if (!pPixelPackBuffer->bind()) {
+        return false;
+    }
+    // Returns immediately, the pixels are written to the bound buffer once
+    // rendering has finished
+    m_context->functions()->glReadPixels(0,
+            0,
+            m_screenInfo.size.width(),
+            m_screenInfo.size.height(),
+            m_GLDataFormat,
+            m_GLDataType,
+            nullptr);
+    pPixelPackBuffer->release();
+    m_pixelPackBufferIndex = (m_pixelPackBufferIndex + 1) % m_pixelPackBuffers.size();
+    m_pixelReadbackPending = true;
+    return true;
+}
+
+bool ControllerRenderingEngine::finishPixelReadback(QImage* pImage) {
+    if (!m_pixelReadbackPending) {
+        return false;
+    }
+    m_pixelReadbackPending = false;
+    ScopedTimer t(QStringLiteral("ControllerRenderingEngine::finishPixelReadback"));
+    // The buffer that has been written least recently
+    auto& pPixelPackBuffer = m_pixelPackBuffers[
+            (m_pixelPackBufferIndex + m_pixelPackBuffers.size() - 1) %
+            m_pixelPackBuffers.size()];
+    VERIFY_OR_DEBUG_ASSERT(pPixelPackBuffer && pPixelPackBuffer->bind()) {
+        return false;
+    }
+    QImage image(m_screenInfo.size, m_screenInfo.pixelFormat);
+    const void* pPixels = pPixelPackBuffer->mapRange(
+            0, static_cast<int>(image.sizeInBytes()), QOpenGLBuffer::RangeRead);
+    if (!pPixels) {
+        kLogger.warning() << "Couldn't map the pixel pack buffer";
+        pPixelPackBuffer->release();
+        return false;
+    }
+    std::memcpy(image.bits(), pPixels, image.sizeInBytes());
+    pPixelPackBuffer->unmap();
+    pPixelPackBuffer->release();
+    *pImage = std::move(image);
+    return true;
+}
+
+void ControllerRenderingEngine::emitFrame(QImage image, const QDateTime& timestamp) {
+    image.mirror(false, true);
+    emit frameRendered(m_screenInfo, std::move(image), timestamp);
+}
+
 bool ControllerRenderingEngine::stop() {
     m_pThread->quit();
     return m_pThread->wait();
@@ -389,6 +513,10 @@ void ControllerRenderingEngine::send(Controller* controller, const QByteArray& f
                 << "milliseconds and frame has" << frame.size() << "bytes";
     }
 
+    scheduleNextFrame();
+}
+
+void ControllerRenderingEngine::scheduleNextFrame() {
     m_nextFrameStart += std::chrono::microseconds(1000000 / m_screenInfo.target_fps);
 
     auto durationToWaitBeforeFrame =
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <QDateTime>
 #include <QObject>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
+#include <array>
 #include <chrono>
 #include <gsl/pointers>
 
@@ -13,6 +15,7 @@
 class Controller;
 class ControllerEngineThreadControl;
 class QOffscreenSurface;
+class QOpenGLBuffer;
 class QOpenGLContext;
 class QOpenGLFramebufferObject;
 class QQmlEngine;
@@ -84,7 +87,17 @@ class ControllerRenderingEngine : public QObject {
   private:
     virtual void prepare();
 
+    // Starts reading the pixels of the rendered frame into a pixel pack
+    // buffer. Returns false if pixel pack buffers are not supported.
+    bool startPixelReadback();
+    // Copies the pixels of the previously rendered frame. Returns false if
+    // no frame is pending.
+    bool finishPixelReadback(QImage* pImage);
+    void emitFrame(QImage image, const QDateTime& timestamp);
+    void scheduleNextFrame();
+
     std::chrono::time_point<std::chrono::steady_clock> m_nextFrameStart;
+    std::chrono::time_point<std::chrono::steady_clock> m_lastFrameRendered;
 
     LegacyControllerMapping::ScreenInfo m_screenInfo;
 
@@ -97,6 +110,19 @@ class ControllerRenderingEngine : public QObject {
 
     std::unique_ptr<QOpenGLFramebufferObject> m_fbo;
 
+    // The pixels of a frame are read into one buffer while the pixels of the
+    // previous frame are copied from the other one, so the GPU doesn't need
+    // to finish rendering before the pixels are read. This delays the frames
+    // by one frame.
+    std::array<std::unique_ptr<QOpenGLBuffer>, 2> m_pixelPackBuffers;
+    bool m_pixelPackBuffersSupported;
+    std::size_t m_pixelPackBufferIndex;
+    bool m_pixelReadbackPending;
+    QDateTime m_pendingFrameTimestamp;
+
+    // Set when the QML scene needs to be rendered again
+    bool m_sceneChanged;
+
     GLenum m_GLDataFormat;
     GLenum m_GLDataType;
 
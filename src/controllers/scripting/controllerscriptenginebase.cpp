@@ -1,6 +1,7 @@
 #include "controllers/scripting/controllerscriptenginebase.h"
 
 #include <QJSEngine>
+#include <algorithm>
 
 #include "controllers/controller.h"
 #include "controllers/scripting/colormapperjsproxy.h"
@@ -14,6 +15,8 @@
 #include "qml/asyncimageprovider.h"
 #endif
 #include "util/cmdlineargs.h"
+#include "util/compatibility/qmutex.h"
+#include "util/performancetimer.h"
 
 ControllerScriptEngineBase::ControllerScriptEngineBase(
         Controller* controller, const RuntimeLoggingCategory& logger)
@@ -116,8 +119,9 @@ void ControllerScriptEngineBase::reload() {
     initialize();
 }
 
-bool ControllerScriptEngineBase::executeFunction(
-        QJSValue* pFunctionObject, const QJSValueList& args) {
+bool ControllerScriptEngineBase::executeFunction(QJSValue* pFunctionObject,
+        const QJSValueList& args,
+        ScriptCallbackCounters* pCounters) {
     // This function is called from outside the controller engine, so we can't
     // use VERIFY_OR_DEBUG_ASSERT here
     if (!m_pJSEngine) {
@@ -134,7 +138,13 @@ bool ControllerScriptEngineBase::executeFunction(
     }
 
     // If it does happen to be a function, call it.
+    PerformanceTimer timer;
+    timer.start();
     QJSValue returnValue = pFunctionObject->call(args);
+    const mixxx::Duration duration = timer.elapsed();
+    if (pCounters) {
+        recordCallbackExecution(pCounters, duration);
+    }
     if (returnValue.isError()) {
         showScriptExceptionDialog(returnValue);
         return false;
@@ -142,6 +152,53 @@ bool ControllerScriptEngineBase::executeFunction(
     return true;
 }
 
+ScriptCallbackCountersPointer ControllerScriptEngineBase::callbackCounters(
+        const QString& callbackName) {
+    const auto locker = lockMutex(&m_callbackCountersMutex);
+    ScriptCallbackCountersPointer& pCounters = m_callbackCounters[callbackName];
+    if (!pCounters) {
+        pCounters = std::make_shared<ScriptCallbackCounters>(callbackName);
+    }
+    return pCounters;
+}
+
+void ControllerScriptEngineBase::recordCallbackExecution(
+        ScriptCallbackCounters* pCounters, mixxx::Duration duration) {
+    const int overruns = pCounters->record(duration);
+    if (overruns == 0) {
+        return;
+    }
+    qCWarning(m_logger).noquote()
+            << "Callback" << pCounters->name() << "took"
+            << duration.formatMillisWithUnit()
+            << "and blocked the controller, the budget is"
+            << kCallbackTimeBudget.formatMillisWithUnit()
+            << QStringLiteral("(%1 overruns)").arg(overruns);
+}
+
+QList<ControllerScriptEngineBase::CallbackStatistics>
+ControllerScriptEngineBase::callbackStatistics() const {
+    QList<CallbackStatistics> statistics;
+    const auto locker = lockMutex(&m_callbackCountersMutex);
+    statistics.reserve(m_callbackCounters.size());
+    for (const auto& pCounters : m_callbackCounters) {
+        CallbackStatistics callback = pCounters->statistics();
+        // Registered callbacks that have not been executed yet
+        if (callback.calls > 0) {
+            statistics.append(std::move(callback));
+        }
+    }
+    return statistics;
+}
+
+void ControllerScriptEngineBase::resetCallbackStatistics() {
+    const auto locker = lockMutex(&m_callbackCountersMutex);
+    // The counters are still referenced by the registered callbacks
+    for (const auto& pCounters : std::as_const(m_callbackCounters)) {
+        pCounters->reset();
+    }
+}
+
 void ControllerScriptEngineBase::showScriptExceptionDialog(
         const QJSValue& evaluationResult, bool bFatalError) {
     VERIFY_OR_DEBUG_ASSERT(evaluationResult.isError()) {
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <QHash>
 #include <QJSValue>
+#include <QList>
 #include <QMessageBox>
 #include <QMutex>
 #include <QQmlError>
 #include <QWaitCondition>
 #include <memory>
 
+#include "controllers/scripting/scriptcallbackcounters.h"
+#include "util/duration.h"
 #include "util/runtimeloggingcategory.h"
 #ifdef MIXXX_USE_QML
 #include "controllers/controllerenginethreadcontrol.h"
@@ -30,7 +34,25 @@ class ControllerScriptEngineBase : public QObject {
 
     virtual bool initialize();
 
-    bool executeFunction(QJSValue* pFunctionObject, const QJSValueList& arguments = {});
+    /// Calls the function and records its execution time in pCounters,
+    /// unless it is null.
+    bool executeFunction(QJSValue* pFunctionObject,
+            const QJSValueList& arguments = {},
+            ScriptCallbackCounters* pCounters = nullptr);
+
+    using CallbackStatistics = ScriptCallbackStatistics;
+    /// Callbacks that run longer block all other input of the controller
+    static constexpr mixxx::Duration kCallbackTimeBudget = ScriptCallbackCounters::kTimeBudget;
+
+    /// Returns the counters of the callbacks with the given name. Invoked
+    /// once when a callback is registered, not for every execution.
+    ScriptCallbackCountersPointer callbackCounters(const QString& callbackName);
+    /// Thread-safe, e.g. for displaying the statistics in the preferences
+    QList<CallbackStatistics> callbackStatistics() const;
+    void resetCallbackStatistics();
+    /// Warns if a callback has exceeded kCallbackTimeBudget for the first
+    /// time or longer than before.
+    void recordCallbackExecution(ScriptCallbackCounters* pCounters, mixxx::Duration duration);
 
     /// Shows a UI dialog notifying of a script evaluation error.
     /// Precondition: QJSValue.isError() == true
@@ -91,6 +113,10 @@ class ControllerScriptEngineBase : public QObject {
 #endif
     bool m_bTesting;
 
+  private:
+    mutable QMutex m_callbackCountersMutex;
+    QHash<QString, ScriptCallbackCountersPointer> m_callbackCounters;
+
 #ifdef MIXXX_USE_QML
   private:
     static inline std::shared_ptr<TrackCollectionManager> s_pTrackCollectionManager;
@@ -34,7 +34,7 @@ bool ControllerScriptModuleEngine::initialize() {
     }
 
     QJSValue initFunction = mod.property("init");
-    if (!executeFunction(&initFunction)) {
+    if (!executeFunction(&initFunction, {}, callbackCounters(QStringLiteral("init")).get())) {
         shutdown();
         return false;
     }
@@ -49,6 +49,8 @@ bool ControllerScriptModuleEngine::initialize() {
 }
 
 void ControllerScriptModuleEngine::shutdown() {
-    executeFunction(&m_shutdownFunction);
+    executeFunction(&m_shutdownFunction,
+            {},
+            callbackCounters(QStringLiteral("shutdown")).get());
     ControllerScriptEngineBase::shutdown();
 }
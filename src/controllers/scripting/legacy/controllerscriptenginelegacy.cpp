@@ -1,6 +1,10 @@
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
 #include <memory>
+#include <optional>
 
 #ifdef MIXXX_USE_QML
 #include <QDirIterator>
@@ -18,6 +22,7 @@
 #include "errordialoghandler.h"
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptenginelegacy.cpp"
+#include "util/compatibility/qmutex.h"
 #ifdef MIXXX_USE_QML
 #include "qml/qmlmixxxcontrollerscreen.h"
 #include "util/assert.h"
@@ -26,6 +31,40 @@
 using Clock = std::chrono::steady_clock;
 #endif
 
+namespace {
+
+// The decoded code of a script file, e.g. of the shared libraries like
+// common-controller-scripts.js and the components library that are
+// evaluated by the engine of every controller and on every reload.
+struct CachedScriptCode {
+    QDateTime lastModified;
+    qint64 size;
+    QString code;
+};
+
+QMutex s_scriptCodeCacheMutex;
+QHash<QString, CachedScriptCode> s_scriptCodeCache;
+
+// Returns the cached code of the file if it hasn't been modified since
+std::optional<QString> cachedScriptCode(const QFileInfo& scriptFile) {
+    const auto locker = lockMutex(&s_scriptCodeCacheMutex);
+    const auto it = s_scriptCodeCache.constFind(scriptFile.absoluteFilePath());
+    if (it == s_scriptCodeCache.constEnd() ||
+            it->lastModified != scriptFile.lastModified() ||
+            it->size != scriptFile.size()) {
+        return std::nullopt;
+    }
+    return it->code;
+}
+
+void cacheScriptCode(const QFileInfo& scriptFile, const QString& code) {
+    const auto locker = lockMutex(&s_scriptCodeCacheMutex);
+    s_scriptCodeCache.insert(scriptFile.absoluteFilePath(),
+            CachedScriptCode{scriptFile.lastModified(), scriptFile.size(), code});
+}
+
+} // anonymous namespace
+
 ControllerScriptEngineLegacy::ControllerScriptEngineLegacy(
         Controller* controller, const RuntimeLoggingCategory& logger)
         : ControllerScriptEngineBase(controller, logger) {
@@ -439,9 +478,10 @@ bool ControllerScriptEngineLegacy::initialize() {
             continue;
         }
         functionName.append(QStringLiteral(".incomingData"));
-        m_incomingDataFunctions.append(
+        m_incomingDataFunctions.append(IncomingDataFunction{
+                callbackCounters(functionName),
                 wrapArrayBufferCallback(
-                        wrapFunctionCode(functionName, 2)));
+                        wrapFunctionCode(functionName, 2))});
     }
 
 #ifdef MIXXX_USE_QML
@@ -666,7 +706,8 @@ bool ControllerScriptEngineLegacy::handleIncomingData(const QByteArray& data) {
     };
 
     for (auto&& function : m_incomingDataFunctions) {
-        ControllerScriptEngineBase::executeFunction(&function, args);
+        ControllerScriptEngineBase::executeFunction(
+                &function.function, args, function.pCallbackCounters.get());
     }
 
     return true;
@@ -690,8 +731,14 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
     qCDebug(m_logger) << "Loading"
                       << scriptFile.absoluteFilePath();
 
-    // Read in the script file
     QString filename = scriptFile.absoluteFilePath();
+    // The file info may be outdated if the file has just been changed
+    const QFileInfo currentScriptFile(filename);
+    if (const auto code = cachedScriptCode(currentScriptFile)) {
+        return evaluateScriptCode(*code, filename);
+    }
+
+    // Read in the script file
     QFile input(filename);
     if (!input.open(QIODevice::ReadOnly)) {
         qCWarning(m_logger) << QString(
@@ -726,7 +773,13 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
 
     QString scriptCode = QString(input.readAll()) + QStringLiteral("\n");
     input.close();
+    cacheScriptCode(currentScriptFile, scriptCode);
+
+    return evaluateScriptCode(scriptCode, filename);
+}
 
+bool ControllerScriptEngineLegacy::evaluateScriptCode(
+        const QString& scriptCode, const QString& filename) {
     QJSValue scriptFunction = m_pJSEngine->evaluate(scriptCode, filename);
     if (scriptFunction.isError()) {
         showScriptExceptionDialog(scriptFunction, true);
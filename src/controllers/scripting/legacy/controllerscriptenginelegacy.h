@@ -83,6 +83,7 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     };
 
     bool evaluateScriptFile(const QFileInfo& scriptFile);
+    bool evaluateScriptCode(const QString& scriptCode, const QString& filename);
 #ifdef MIXXX_USE_QML
     bool bindSceneToScreen(
             const LegacyControllerMapping::ScriptFileInfo& qmlFile,
@@ -126,7 +127,12 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     QList<LegacyControllerMapping::ScreenInfo> m_infoScreens;
     QString m_resourcePath;
 #endif
-    QList<QJSValue> m_incomingDataFunctions;
+    struct IncomingDataFunction {
+        // For the callback statistics
+        ScriptCallbackCountersPointer pCallbackCounters;
+        QJSValue function;
+    };
+    QList<IncomingDataFunction> m_incomingDataFunctions;
     QHash<QString, QJSValue> m_scriptWrappedFunctionCache;
     QList<LegacyControllerMapping::ScriptFileInfo> m_scriptFiles;
     QHash<QString, QJSValue> m_settings;
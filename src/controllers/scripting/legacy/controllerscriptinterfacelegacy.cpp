@@ -1,5 +1,6 @@
 #include "controllerscriptinterfacelegacy.h"
 
+#include <QJSValueIterator>
 #include <QStringEncoder>
 #include <gsl/pointers>
 
@@ -10,6 +11,7 @@
 #include "controllers/scripting/legacy/scriptconnectionjsproxy.h"
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptinterfacelegacy.cpp"
+#include "soundio/xrunrecorder.h"
 #include "util/cmdlineargs.h"
 #include "util/fpclassify.h"
 #include "util/make_const_iterator.h"
@@ -60,6 +62,11 @@ ControllerScriptInterfaceLegacy::~ControllerScriptInterfaceLegacy() {
     for (const int timerId : timerIds) {
         stopTimer(timerId);
     }
+    for (auto it = m_throttledConnectionTimers.constBegin();
+            it != m_throttledConnectionTimers.constEnd();
+            ++it) {
+        killTimer(it.key());
+    }
 
     // Prevents leaving decks in an unstable state
     //  if the controller is shut down while scratching
@@ -159,16 +166,49 @@ void ControllerScriptInterfaceLegacy::setValue(
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl &&
-                !m_st.ignore(
-                        pControl, coScript->getParameterForValue(newValue))) {
-            coScript->set(newValue);
+        setControlValue(coScript, newValue);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setValues(
+        const QString& group, const QJSValue& values) {
+    if (!values.isObject()) {
+        m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                "Script tried setting the values of %1 without passing an object")
+                                                       .arg(group));
+        return;
+    }
+
+    QJSValueIterator it(values);
+    while (it.hasNext()) {
+        it.next();
+        const double newValue = it.value().toNumber();
+        if (util_isnan(newValue)) {
+            m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                    "Script tried setting (%1, %2) to NotANumber (NaN)")
+                                                           .arg(group, it.name()));
+            continue;
+        }
+        ControlObjectScript* coScript = getControlObjectScript(group, it.name());
+        if (coScript != nullptr) {
+            setControlValue(coScript, newValue);
         }
     }
 }
 
+void ControllerScriptInterfaceLegacy::setControlValue(
+        ControlObjectScript* coScript, double newValue) {
+    // Mappings set many controls per incoming message, so the cached
+    // control is used instead of looking up the key in the global hash
+    ControlObject* pControl = coScript->getControl();
+    if (pControl &&
+            !m_st.ignore(
+                    pControl, coScript->getParameterForValue(newValue))) {
+        coScript->set(newValue);
+        XrunRecorder::recordControlEvent(pControl->getKey(), newValue);
+    }
+}
+
 double ControllerScriptInterfaceLegacy::getParameter(const QString& group, const QString& name) {
     ControlObjectScript* coScript = getControlObjectScript(group, name);
     if (coScript == nullptr) {
@@ -192,10 +232,10 @@ void ControllerScriptInterfaceLegacy::setParameter(
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
+        ControlObject* pControl = coScript->getControl();
         if (pControl && !m_st.ignore(pControl, newParameter)) {
             coScript->setParameter(newParameter);
+            XrunRecorder::recordControlEvent(pControl->getKey(), pControl->get());
         }
     }
 }
@@ -255,9 +295,32 @@ double ControllerScriptInterfaceLegacy::getDefaultParameter(
     return coScript->getParameterForValue(coScript->getDefault());
 }
 
-QJSValue ControllerScriptInterfaceLegacy::makeConnection(
-        const QString& group, const QString& name, const QJSValue& callback) {
-    return ControllerScriptInterfaceLegacy::makeConnectionInternal(group, name, callback, false);
+QJSValue ControllerScriptInterfaceLegacy::makeConnection(const QString& group,
+        const QString& name,
+        const QJSValue& callback,
+        const QJSValue& options) {
+    int minIntervalMillis = 0;
+    if (options.isObject()) {
+        const QJSValue minInterval = options.property(QStringLiteral("minInterval"));
+        if (!minInterval.isUndefined()) {
+            if (!minInterval.isNumber() || minInterval.toNumber() < 0) {
+                m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                        "Invalid minInterval passed to makeConnection for "
+                        "(%1, %2), it must be a number of milliseconds >= 0")
+                                .arg(group, name));
+                return QJSValue();
+            }
+            minIntervalMillis = minInterval.toInt();
+        }
+    } else if (!options.isUndefined()) {
+        m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                "Invalid options passed to makeConnection for (%1, %2), "
+                "they must be an object")
+                        .arg(group, name));
+        return QJSValue();
+    }
+    return ControllerScriptInterfaceLegacy::makeConnectionInternal(
+            group, name, callback, false, minIntervalMillis);
 }
 
 QJSValue ControllerScriptInterfaceLegacy::makeUnbufferedConnection(
@@ -265,8 +328,11 @@ QJSValue ControllerScriptInterfaceLegacy::makeUnbufferedConnection(
     return ControllerScriptInterfaceLegacy::makeConnectionInternal(group, name, callback, true);
 }
 
-QJSValue ControllerScriptInterfaceLegacy::makeConnectionInternal(
-        const QString& group, const QString& name, const QJSValue& callback, bool skipSuperseded) {
+QJSValue ControllerScriptInterfaceLegacy::makeConnectionInternal(const QString& group,
+        const QString& name,
+        const QJSValue& callback,
+        bool skipSuperseded,
+        int minIntervalMillis) {
     auto pJsEngine = m_pScriptEngineLegacy->jsEngine();
     VERIFY_OR_DEBUG_ASSERT(pJsEngine) {
         return QJSValue();
@@ -300,6 +366,9 @@ QJSValue ControllerScriptInterfaceLegacy::makeConnectionInternal(
     connection.callback = callback;
     connection.id = QUuid::createUuid();
     connection.skipSuperseded = skipSuperseded;
+    connection.minIntervalMillis = minIntervalMillis;
+    connection.callbackCounters = m_pScriptEngineLegacy->callbackCounters(
+            QStringLiteral("connection %1,%2").arg(group, name));
 
     if (coScript->addScriptConnection(connection)) {
         return pJsEngine->newQObject(
@@ -318,6 +387,16 @@ bool ControllerScriptInterfaceLegacy::removeScriptConnection(
         return false;
     }
 
+    // Drop a deferred callback
+    const auto it = m_throttledConnections.constFind(connection.id);
+    if (it != m_throttledConnections.constEnd()) {
+        if (it->timerId != 0) {
+            killTimer(it->timerId);
+            m_throttledConnectionTimers.remove(it->timerId);
+        }
+        m_throttledConnections.erase(it);
+    }
+
     return coScript->removeScriptConnection(connection);
 }
 
@@ -340,6 +419,37 @@ void ControllerScriptInterfaceLegacy::triggerScriptConnection(
     connection.executeCallback(coScript->get());
 }
 
+void ControllerScriptInterfaceLegacy::executeThrottledScriptConnection(
+        const ScriptConnection& connection, double value) {
+    auto it = m_throttledConnections.find(connection.id);
+    if (it == m_throttledConnections.end()) {
+        it = m_throttledConnections.insert(connection.id,
+                ThrottledConnection{connection, PerformanceTimer(), value, 0});
+    }
+    if (it->timerId != 0) {
+        // Coalesced with the pending callback
+        it->pendingValue = value;
+        return;
+    }
+    const qint64 elapsedMillis = it->sinceLastCallback.running()
+            ? it->sinceLastCallback.elapsed().toIntegerMillis()
+            : connection.minIntervalMillis;
+    if (elapsedMillis < connection.minIntervalMillis) {
+        it->pendingValue = value;
+        it->timerId = startTimer(
+                static_cast<int>(connection.minIntervalMillis - elapsedMillis),
+                Qt::PreciseTimer);
+        if (it->timerId != 0) {
+            m_throttledConnectionTimers.insert(it->timerId, connection.id);
+            return;
+        }
+        // Don't drop the value if no timer could be created
+    }
+    it->sinceLastCallback.start();
+    // The callback may disconnect and invalidate the iterator
+    connection.invokeCallback(value);
+}
+
 // This function is a legacy version of makeConnection with several alternate
 // ways of invoking it. The callback function can be passed either as a string of
 // JavaScript code that evaluates to a function or an actual JavaScript function.
@@ -522,6 +632,11 @@ int ControllerScriptInterfaceLegacy::beginTimer(
     TimerInfo info;
     info.callback = timerCallback;
     info.oneShot = oneShot;
+    const QString functionName = timerCallback.property(QStringLiteral("name")).toString();
+    info.pCallbackCounters = m_pScriptEngineLegacy->callbackCounters(
+            QStringLiteral("timer %1").arg(functionName.isEmpty()
+                            ? QStringLiteral("<anonymous>")
+                            : functionName));
     m_timers[timerId] = info;
     if (timerId == 0) {
         m_pScriptEngineLegacy->logOrThrowError(QStringLiteral("Script timer could not be created"));
@@ -562,6 +677,24 @@ void ControllerScriptInterfaceLegacy::stopScratchTimer(int timerId) {
 void ControllerScriptInterfaceLegacy::timerEvent(QTimerEvent* event) {
     int timerId = event->timerId();
 
+    // See if this is a deferred connection callback
+    const auto throttledIt = m_throttledConnectionTimers.constFind(timerId);
+    if (throttledIt != m_throttledConnectionTimers.constEnd()) {
+        killTimer(timerId);
+        const auto it = m_throttledConnections.find(throttledIt.value());
+        m_throttledConnectionTimers.erase(throttledIt);
+        if (it == m_throttledConnections.end()) {
+            return;
+        }
+        it->timerId = 0;
+        it->sinceLastCallback.start();
+        // Copy, because the callback may disconnect and remove it
+        const ScriptConnection connection = it->connection;
+        const double value = it->pendingValue;
+        connection.invokeCallback(value);
+        return;
+    }
+
     // See if this is a scratching timer
     if (m_scratchTimers.contains(timerId)) {
         scratchProcess(timerId);
@@ -584,7 +717,8 @@ void ControllerScriptInterfaceLegacy::timerEvent(QTimerEvent* event) {
         stopTimer(timerId);
     }
 
-    m_pScriptEngineLegacy->executeFunction(&timerTarget.callback);
+    m_pScriptEngineLegacy->executeFunction(
+            &timerTarget.callback, {}, timerTarget.pCallbackCounters.get());
 }
 
 void ControllerScriptInterfaceLegacy::softTakeover(
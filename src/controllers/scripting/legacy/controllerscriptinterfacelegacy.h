@@ -1,15 +1,18 @@
 #pragma once
 
+#include <QHash>
 #include <QJSValue>
 #include <QObject>
+#include <QUuid>
 
+#include "controllers/scripting/legacy/scriptconnection.h"
 #include "controllers/softtakeover.h"
 #include "util/alphabetafilter.h"
+#include "util/performancetimer.h"
 #include "util/runtimeloggingcategory.h"
 
 class ControllerScriptEngineLegacy;
 class ControlObjectScript;
-class ScriptConnection;
 class ConfigKey;
 
 /// ControllerScriptInterfaceLegacy is the legacy API for controller scripts to interact
@@ -58,6 +61,9 @@ class ControllerScriptInterfaceLegacy : public QObject {
     Q_INVOKABLE QJSValue getSetting(const QString& name);
     Q_INVOKABLE double getValue(const QString& group, const QString& name);
     Q_INVOKABLE void setValue(const QString& group, const QString& name, double newValue);
+    /// Sets multiple controls of a group at once, e.g.
+    /// engine.setValues("[Channel1]", {play_indicator: 1, cue_indicator: 0})
+    Q_INVOKABLE void setValues(const QString& group, const QJSValue& values);
     Q_INVOKABLE double getParameter(const QString& group, const QString& name);
     Q_INVOKABLE void setParameter(const QString& group, const QString& name, double newValue);
     Q_INVOKABLE double getParameterForValue(
@@ -65,9 +71,14 @@ class ControllerScriptInterfaceLegacy : public QObject {
     Q_INVOKABLE void reset(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultValue(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultParameter(const QString& group, const QString& name);
+    /// The optional options object may contain:
+    /// - minInterval: The callback is executed at most once per minInterval
+    ///   milliseconds, with the latest value of the control. Values that
+    ///   change in between are coalesced.
     Q_INVOKABLE QJSValue makeConnection(const QString& group,
             const QString& name,
-            const QJSValue& callback);
+            const QJSValue& callback,
+            const QJSValue& options = QJSValue());
     Q_INVOKABLE QJSValue makeUnbufferedConnection(const QString& group,
             const QString& name,
             const QJSValue& callback);
@@ -113,6 +124,9 @@ class ControllerScriptInterfaceLegacy : public QObject {
     bool removeScriptConnection(const ScriptConnection& conn);
     /// Execute a ScriptConnection's JS callback
     void triggerScriptConnection(const ScriptConnection& conn);
+    /// Executes the callback of a connection with a minimum interval now,
+    /// or defers it until the interval has elapsed
+    void executeThrottledScriptConnection(const ScriptConnection& conn, double value);
 
     /// Handler for timers that scripts set.
     virtual void timerEvent(QTimerEvent* event);
@@ -121,21 +135,36 @@ class ControllerScriptInterfaceLegacy : public QObject {
     QJSValue makeConnectionInternal(const QString& group,
             const QString& name,
             const QJSValue& callback,
-            bool skipSuperseded = false);
+            bool skipSuperseded = false,
+            int minIntervalMillis = 0);
 
     QByteArray convertCharsetInternal(QLatin1String targetCharset, const QString& value);
 
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
+    void setControlValue(ControlObjectScript* coScript, double newValue);
 
     SoftTakeoverCtrl m_st;
 
     struct TimerInfo {
         QJSValue callback;
         bool oneShot;
+        // For the callback statistics
+        ScriptCallbackCountersPointer pCallbackCounters;
     };
     QHash<int, TimerInfo> m_timers;
 
+    // The state of the connections with a minimum interval
+    struct ThrottledConnection {
+        ScriptConnection connection;
+        PerformanceTimer sinceLastCallback;
+        double pendingValue;
+        // The timer of the deferred callback, 0 if none is pending
+        int timerId;
+    };
+    QHash<QUuid, ThrottledConnection> m_throttledConnections;
+    QHash<int, QUuid> m_throttledConnectionTimers;
+
     QVarLengthArray<int> m_intervalAccumulator;
     QVarLengthArray<mixxx::Duration> m_lastMovement;
     QVarLengthArray<double> m_dx, m_rampTo, m_rampFactor;
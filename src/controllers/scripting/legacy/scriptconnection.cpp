@@ -1,9 +1,19 @@
 #include "controllers/scripting/legacy/scriptconnection.h"
 
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+#include "controllers/scripting/legacy/controllerscriptinterfacelegacy.h"
+#include "util/performancetimer.h"
 #include "util/trace.h"
 
 void ScriptConnection::executeCallback(double value) const {
+    if (minIntervalMillis > 0 && engineJSProxy != nullptr) {
+        engineJSProxy->executeThrottledScriptConnection(*this, value);
+        return;
+    }
+    invokeCallback(value);
+}
+
+void ScriptConnection::invokeCallback(double value) const {
     Trace executeCallbackTrace("JS %1 callback", key.item);
     const auto args = QJSValueList{
             value,
@@ -11,7 +21,12 @@ void ScriptConnection::executeCallback(double value) const {
             key.item,
     };
     QJSValue func = callback; // copy function because QJSValue::call is not const
+    PerformanceTimer timer;
+    timer.start();
     QJSValue result = func.call(args);
+    if (controllerEngine != nullptr && callbackCounters) {
+        controllerEngine->recordCallbackExecution(callbackCounters.get(), timer.elapsed());
+    }
     if (result.isError()) {
         if (controllerEngine != nullptr) {
             controllerEngine->showScriptExceptionDialog(result);
@@ -3,6 +3,7 @@
 #include <QJSValue>
 #include <QUuid>
 
+#include "controllers/scripting/scriptcallbackcounters.h"
 #include "preferences/configobject.h"
 
 class ControllerScriptEngineLegacy;
@@ -19,8 +20,16 @@ class ScriptConnection {
     ControllerScriptInterfaceLegacy* engineJSProxy;
     ControllerScriptEngineLegacy* controllerEngine;
     bool skipSuperseded;
+    /// If > 0 the callback is executed at most once per interval with the
+    /// latest value, see ControllerScriptInterfaceLegacy::makeConnection()
+    int minIntervalMillis = 0;
+    /// For the callback statistics, registered when the connection is made
+    ScriptCallbackCountersPointer callbackCounters;
 
+    /// Executes the callback, or defers it if the connection is throttled
     void executeCallback(double value) const;
+    /// Executes the callback immediately
+    void invokeCallback(double value) const;
 
     // Required for various QList methods and iteration to work.
     inline bool operator==(const ScriptConnection& other) const {
@@ -0,0 +1,39 @@
+#include "controllers/scripting/scriptcallbackcounters.h"
+
+int ScriptCallbackCounters::record(mixxx::Duration duration) {
+    const qint64 nanos = duration.toIntegerNanos();
+    m_calls.fetch_add(1, std::memory_order_relaxed);
+    m_totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    bool longest = false;
+    qint64 maxNanos = m_maxNanos.load(std::memory_order_relaxed);
+    while (nanos > maxNanos) {
+        if (m_maxNanos.compare_exchange_weak(maxNanos, nanos, std::memory_order_relaxed)) {
+            longest = true;
+            break;
+        }
+    }
+    if (duration <= kTimeBudget) {
+        return 0;
+    }
+    const int overruns = m_overruns.fetch_add(1, std::memory_order_relaxed) + 1;
+    return longest ? overruns : 0;
+}
+
+ScriptCallbackStatistics ScriptCallbackCounters::statistics() const {
+    ScriptCallbackStatistics statistics;
+    statistics.name = m_name;
+    statistics.calls = m_calls.load(std::memory_order_relaxed);
+    statistics.overruns = m_overruns.load(std::memory_order_relaxed);
+    statistics.totalTime = mixxx::Duration::fromNanos(
+            m_totalNanos.load(std::memory_order_relaxed));
+    statistics.maxTime = mixxx::Duration::fromNanos(
+            m_maxNanos.load(std::memory_order_relaxed));
+    return statistics;
+}
+
+void ScriptCallbackCounters::reset() {
+    m_calls.store(0, std::memory_order_relaxed);
+    m_overruns.store(0, std::memory_order_relaxed);
+    m_totalNanos.store(0, std::memory_order_relaxed);
+    m_maxNanos.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <memory>
+
+#include "util/duration.h"
+
+/// The execution time of the mapping callbacks with the same name
+struct ScriptCallbackStatistics {
+    QString name;
+    int calls = 0;
+    /// The number of calls that exceeded ScriptCallbackCounters::kTimeBudget
+    int overruns = 0;
+    mixxx::Duration totalTime;
+    mixxx::Duration maxTime;
+};
+
+/// The counters of the mapping callbacks with the same name. They are
+/// registered once when a connection, timer or input mapping is created, so
+/// recording an execution neither formats the name nor takes a lock. Only
+/// the controller thread records executions, the statistics may be read
+/// and reset from any thread.
+class ScriptCallbackCounters {
+  public:
+    /// Callbacks that run longer block all other input of the controller
+    static constexpr mixxx::Duration kTimeBudget = mixxx::Duration::fromMillis(5);
+
+    explicit ScriptCallbackCounters(const QString& name)
+            : m_name(name),
+              m_calls(0),
+              m_overruns(0),
+              m_totalNanos(0),
+              m_maxNanos(0) {
+    }
+
+    const QString& name() const {
+        return m_name;
+    }
+
+    /// Returns the number of overruns if the callback has exceeded
+    /// kTimeBudget for the first time or longer than before, and 0
+    /// otherwise.
+    int record(mixxx::Duration duration);
+
+    ScriptCallbackStatistics statistics() const;
+    void reset();
+
+  private:
+    const QString m_name;
+    std::atomic<int> m_calls;
+    std::atomic<int> m_overruns;
+    std::atomic<qint64> m_totalNanos;
+    std::atomic<qint64> m_maxNanos;
+};
+
+using ScriptCallbackCountersPointer = std::shared_ptr<ScriptCallbackCounters>;
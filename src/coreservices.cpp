@@ -1,8 +1,11 @@
 #include "coreservices.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QFileDialog>
+#include <QFuture>
 #include <QStandardPaths>
+#include <QtConcurrentRun>
 #include <QtGlobal>
 #include <gsl/pointers>
 
@@ -15,6 +18,7 @@
 #include "database/mixxxdb.h"
 #include "effects/effectsmanager.h"
 #include "engine/enginemixer.h"
+#include "engine/engineprofiler.h"
 #ifdef __RUBBERBAND__
 #include "engine/bufferscalers/rubberbandworkerpool.h"
 #endif
@@ -46,18 +50,30 @@
 #include "qml/qmlplayermanagerproxy.h"
 #include "qml/qmlplayerproxy.h"
 #endif
+#include "soundio/metricsserver.h"
 #include "soundio/soundmanager.h"
+#include "soundio/xrunrecorder.h"
+#ifdef __FFMPEG__
+#include "sources/httpblockreader.h"
+#endif
+#include "sources/pcmcache.h"
+#ifdef __MAD__
+#include "sources/mp3seekindexcache.h"
+#endif
 #include "sources/soundsourceproxy.h"
 #include "util/clipboard.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/font.h"
 #include "util/logger.h"
+#include "util/realtime.h"
 #include "util/screensavermanager.h"
 #include "util/statsmanager.h"
 #include "util/time.h"
+#include "util/tracing.h"
 #include "util/translations.h"
 #include "util/versionstore.h"
 #include "vinylcontrol/vinylcontrolmanager.h"
+#include "waveform/waveformcache.h"
 
 #ifdef __APPLE__
 #include "util/sandbox.h"
@@ -116,6 +132,40 @@ Bool __xErrorHandler(Display* display, XErrorEvent* event, xError* error) {
 
 #endif
 
+/// Logs the duration of each step of the startup, which is otherwise only
+/// available in developer mode.
+class StartupTimeline {
+  public:
+    StartupTimeline() {
+        m_timer.start();
+    }
+    ~StartupTimeline() {
+        finishStep();
+    }
+
+    void startStep(const QString& step) {
+        finishStep();
+        m_step = step;
+        m_stepStartMillis = m_timer.elapsed();
+    }
+
+  private:
+    void finishStep() {
+        if (m_step.isEmpty()) {
+            return;
+        }
+        const qint64 elapsedMillis = m_timer.elapsed();
+        kLogger.info() << "Startup step" << m_step << "took"
+                       << elapsedMillis - m_stepStartMillis << "ms, total"
+                       << elapsedMillis << "ms";
+        m_step.clear();
+    }
+
+    QElapsedTimer m_timer;
+    QString m_step;
+    qint64 m_stepStartMillis = 0;
+};
+
 inline QLocale inputLocale() {
     // Use the default config for local keyboard
     QInputMethod* pInputMethod = QGuiApplication::inputMethod();
@@ -141,6 +191,10 @@ CoreServices::CoreServices(const CmdlineArgs& args, QApplication* pApp)
     if (m_cmdlineArgs.getDeveloper()) {
         StatsManager::createInstance();
     }
+    if (m_cmdlineArgs.getTraceEnabled()) {
+        mixxx::tracing::setEnabled(true);
+        mixxx::tracing::registerCurrentThread(QStringLiteral("Main"));
+    }
     mixxx::Translations::initializeTranslations(
             m_pSettingsManager->settings(), pApp, m_cmdlineArgs.getLocale());
     initializeKeyboard();
@@ -160,6 +214,11 @@ CoreServices::~CoreServices() {
         StatsManager::destroy();
     }
 
+    if (m_cmdlineArgs.getTraceEnabled()) {
+        mixxx::tracing::setEnabled(false);
+        mixxx::tracing::writeChromeTrace(m_cmdlineArgs.getTracePath());
+    }
+
     // HACK: Save config again. We saved it once before doing some dangerous
     // stuff. We only really want to save it here, but the first one was just
     // a precaution. The earlier one can be removed when stuff is more stable
@@ -232,6 +291,8 @@ void CoreServices::initialize(QApplication* pApp) {
     }
 
     ScopedTimer t(QStringLiteral("CoreServices::initialize"));
+    StartupTimeline timeline;
+    timeline.startStep(QStringLiteral("sound sources and caches"));
 
     VERIFY_OR_DEBUG_ASSERT(SoundSourceProxy::registerProviders()) {
         qCritical() << "Failed to register any SoundSource providers";
@@ -255,13 +316,64 @@ void CoreServices::initialize(QApplication* pApp) {
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+    if (pConfig->getValue(ConfigKey("[PcmCache]", "enabled"), false)) {
+        const int maxSizeMB = pConfig->getValue(
+                ConfigKey("[PcmCache]", "max_size_mb"), 4096);
+        mixxx::PcmCache::initialize(
+                QDir(pConfig->getSettingsPath()).filePath("pcmcache"),
+                static_cast<qint64>(maxSizeMB) * 1024 * 1024);
+    }
+
+#ifdef __MAD__
+    // About 6 kB per minute, enough for 4000 tracks of 5 minutes
+    const int mp3SeekIndexCacheSizeMB = pConfig->getValue(
+            ConfigKey("[Mp3SeekIndexCache]", "max_size_mb"), 128);
+    if (mp3SeekIndexCacheSizeMB > 0) {
+        mixxx::Mp3SeekIndexCache::initialize(
+                QDir(pConfig->getSettingsPath()).filePath("mp3seekindex"),
+                static_cast<qint64>(mp3SeekIndexCacheSizeMB) * 1024 * 1024);
+    }
+#endif
+
+#ifdef __FFMPEG__
+    // The blocks of remote files that have been streamed
+    const int httpBlockCacheSizeMB = pConfig->getValue(
+            ConfigKey("[HttpBlockCache]", "max_size_mb"), 1024);
+    if (httpBlockCacheSizeMB > 0) {
+        mixxx::HttpBlockReader::initialize(
+                QDir(pConfig->getSettingsPath()).filePath("httpblocks"),
+                static_cast<qint64>(httpBlockCacheSizeMB) * 1024 * 1024);
+    }
+#endif
+
+    // Enough for the waveforms of about 10 tracks of 5 minutes
+    const int waveformCacheSizeMB = pConfig->getValue(
+            ConfigKey("[Waveform]", "CacheSizeMB"), 128);
+    if (waveformCacheSizeMB > 0) {
+        WaveformCache::initialize(
+                static_cast<qint64>(waveformCacheSizeMB) * 1024 * 1024);
+        m_waveformMemoryUsage = MemoryUsage::registerSubsystem(
+                QStringLiteral("Waveforms"),
+                &WaveformCache::retainedBytes,
+                &WaveformCache::trim);
+    }
+    m_pMemoryUsageMonitor = std::make_shared<MemoryUsageMonitor>(pConfig);
+
     QString resourcePath = pConfig->getResourcePath();
 
     emit initializationProgressUpdate(0, tr("fonts"));
-
-    FontUtils::initializeFonts(resourcePath); // takes a long time
+    // Adding the fonts takes a long time, but they are not needed before
+    // the first widget is created. Load them while the database, engine
+    // and devices are initialized.
+    QFuture<void> fontsInitialized = QtConcurrent::run([resourcePath] {
+        QElapsedTimer timer;
+        timer.start();
+        FontUtils::initializeFonts(resourcePath);
+        kLogger.info() << "Loading fonts took" << timer.elapsed() << "ms";
+    });
 
     emit initializationProgressUpdate(10, tr("database"));
+    timeline.startStep(QStringLiteral("database"));
     m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
     if (!m_pDbConnectionPool) {
         exit(-1);
@@ -277,8 +389,14 @@ void CoreServices::initialize(QApplication* pApp) {
     auto pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
 
     emit initializationProgressUpdate(20, tr("effects"));
+    timeline.startStep(QStringLiteral("effects"));
     m_pEffectsManager = std::make_shared<EffectsManager>(pConfig, pChannelHandleFactory);
 
+    // Before the engine allocates its buffers and starts its threads
+    mixxx::realtime::configure(mixxx::realtime::Settings::fromConfig(pConfig));
+
+    // The profiler is disabled until it is enabled in the developer tools
+    EngineProfiler::createInstance();
     m_pEngine = std::make_shared<EngineMixer>(
             pConfig,
             "[Master]",
@@ -290,10 +408,18 @@ void CoreServices::initialize(QApplication* pApp) {
 #endif
 
     emit initializationProgressUpdate(30, tr("audio interface"));
+    timeline.startStep(QStringLiteral("audio interface"));
     // Although m_pSoundManager is created here, m_pSoundManager->setupDevices()
     // needs to be called after m_pPlayerManager registers sound IO for each EngineChannel.
     m_pSoundManager = std::make_shared<SoundManager>(pConfig, m_pEngine.get());
     m_pEngine->registerNonEngineChannelSoundIO(gsl::make_not_null(m_pSoundManager.get()));
+    if (pConfig->getValue(ConfigKey("[App]", "xrun_capture"), false)) {
+        m_pXrunRecorder = std::make_shared<XrunRecorder>(pConfig);
+    }
+    if (pConfig->getValue(ConfigKey("[App]", "metrics_port"), 0) > 0) {
+        m_pMetricsServer = std::make_shared<MetricsServer>(
+                pConfig, m_pSoundManager.get(), m_pEngine.get());
+    }
 
     m_pRecordingManager = std::make_shared<RecordingManager>(pConfig, m_pEngine.get());
 
@@ -310,6 +436,7 @@ void CoreServices::initialize(QApplication* pApp) {
 #endif
 
     emit initializationProgressUpdate(40, tr("decks"));
+    timeline.startStep(QStringLiteral("decks"));
     // Create the player manager. (long)
     m_pPlayerManager = std::make_shared<PlayerManager>(
             pConfig,
@@ -356,7 +483,16 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
-    CoverArtCache::createInstance();
+    timeline.startStep(QStringLiteral("library"));
+    const int maxCoverArtThumbnailsMB = pConfig->getValue(
+            ConfigKey("[Library]", "cover_art_thumbnails_max_size_mb"), 64);
+    if (maxCoverArtThumbnailsMB > 0) {
+        CoverArtCache::createInstance(
+                QDir(pConfig->getSettingsPath()).filePath("coverart_thumbnails"),
+                static_cast<qint64>(maxCoverArtThumbnailsMB) * 1024 * 1024);
+    } else {
+        CoverArtCache::createInstance();
+    }
     Clipboard::createInstance();
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
@@ -378,6 +514,11 @@ void CoreServices::initialize(QApplication* pApp) {
     // the uninitialized singleton instance!
     m_pPlayerManager->bindToLibrary(m_pLibrary.get());
 
+    // The directory dialog below is the first widget
+    timeline.startStep(QStringLiteral("waiting for fonts"));
+    fontsInitialized.waitForFinished();
+    timeline.startStep(QStringLiteral("music directory"));
+
     bool musicDirAdded = false;
 
     if (m_pTrackCollectionManager->internalCollection()->loadRootDirs().isEmpty()) {
@@ -414,6 +555,7 @@ void CoreServices::initialize(QApplication* pApp) {
     }
 
     emit initializationProgressUpdate(60, tr("controllers"));
+    timeline.startStep(QStringLiteral("controllers"));
     // Initialize controller sub-system,
     // but do not set up controllers until the end of the application startup
     // (long)
@@ -632,10 +774,19 @@ void CoreServices::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "stopping pending Library tasks";
     m_pTrackCollectionManager->stopLibraryScan();
     m_pLibrary->stopPendingTasks();
+    m_pLibrary->saveStartupSnapshot();
 
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "saving configuration";
     m_pSettingsManager->save();
 
+    // XrunRecorder depends on SoundManager and Config
+    qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting XrunRecorder";
+    CLEAR_AND_CHECK_DELETED(m_pXrunRecorder);
+
+    // MetricsServer depends on SoundManager and Engine
+    qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting MetricsServer";
+    CLEAR_AND_CHECK_DELETED(m_pMetricsServer);
+
     // SoundManager depend on Engine and Config
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting SoundManager";
     CLEAR_AND_CHECK_DELETED(m_pSoundManager);
@@ -654,6 +805,10 @@ void CoreServices::finalize() {
     // CoverArtCache is fairly independent of everything else.
     CoverArtCache::destroy();
 
+    qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting MemoryUsageMonitor";
+    CLEAR_AND_CHECK_DELETED(m_pMemoryUsageMonitor);
+    m_waveformMemoryUsage.reset();
+
     Clipboard::destroy();
 
     // PlayerManager depends on Engine, SoundManager, VinylControlManager, and Config
@@ -684,6 +839,7 @@ void CoreServices::finalize() {
 #ifdef __RUBBERBAND__
     RubberBandWorkerPool::destroy();
 #endif
+    EngineProfiler::destroy();
 
     // Destroy PlayerInfo explicitly to release the track
     // pointers of tracks that were still loaded in decks
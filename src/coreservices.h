@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "preferences/settingsmanager.h"
+#include "util/memoryusage.h"
 #include "util/timer.h"
 
 class QApplication;
@@ -11,6 +12,8 @@ class KeyboardEventFilter;
 class EffectsManager;
 class EngineMixer;
 class SoundManager;
+class XrunRecorder;
+class MetricsServer;
 class PlayerManager;
 class RecordingManager;
 #ifdef __BROADCAST__
@@ -127,6 +130,8 @@ class CoreServices : public QObject {
     std::shared_ptr<EffectsManager> m_pEffectsManager;
     std::shared_ptr<EngineMixer> m_pEngine;
     std::shared_ptr<SoundManager> m_pSoundManager;
+    std::shared_ptr<XrunRecorder> m_pXrunRecorder;
+    std::shared_ptr<MetricsServer> m_pMetricsServer;
     std::shared_ptr<PlayerManager> m_pPlayerManager;
     std::shared_ptr<RecordingManager> m_pRecordingManager;
 #ifdef __BROADCAST__
@@ -146,6 +151,9 @@ class CoreServices : public QObject {
 
     std::shared_ptr<mixxx::ScreensaverManager> m_pScreensaverManager;
 
+    std::shared_ptr<MemoryUsageMonitor> m_pMemoryUsageMonitor;
+    MemoryUsage::Registration m_waveformMemoryUsage;
+
     std::unique_ptr<SkinControls> m_pSkinControls;
     std::unique_ptr<ControlPushButton> m_pTouchShift;
 
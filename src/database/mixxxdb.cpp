@@ -3,6 +3,7 @@
 #include <QDir>
 
 #include "database/schemamanager.h"
+#include "library/library_prefs.h"
 #include "moc_mixxxdb.cpp"
 #include "util/assert.h"
 #include "util/logger.h"
@@ -12,7 +13,7 @@
 const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 
 //static
-const int MixxxDb::kRequiredSchemaVersion = 39;
+const int MixxxDb::kRequiredSchemaVersion = 44;
 
 namespace {
 
@@ -30,6 +31,42 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+// The PRAGMA statements for tuning each connection. The journal mode is
+// persisted in the database file, so it is reverted explicitly when the
+// write-ahead log is disabled again.
+QStringList dbConnectionInitStatements(
+        const UserSettingsPointer& pConfig,
+        bool inMemoryConnection) {
+    QStringList statements;
+    if (!inMemoryConnection) {
+        if (pConfig->getValue(
+                    mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey,
+                    mixxx::library::prefs::kDatabaseWriteAheadLogDefault)) {
+            statements.append(QStringLiteral("PRAGMA journal_mode=WAL"));
+            // Still consistent after a crash, only the transactions that
+            // have been committed last might be lost after a power failure
+            statements.append(QStringLiteral("PRAGMA synchronous=NORMAL"));
+        } else {
+            statements.append(QStringLiteral("PRAGMA journal_mode=DELETE"));
+        }
+        const int mmapSizeMiB = pConfig->getValue(
+                mixxx::library::prefs::kDatabaseMmapSizeMiBConfigKey,
+                mixxx::library::prefs::kDatabaseMmapSizeMiBDefault);
+        if (mmapSizeMiB > 0) {
+            statements.append(QStringLiteral("PRAGMA mmap_size=%1")
+                                      .arg(static_cast<qint64>(mmapSizeMiB) * 1024 * 1024));
+        }
+    }
+    const int cacheSizeKiB = pConfig->getValue(
+            mixxx::library::prefs::kDatabaseCacheSizeKiBConfigKey,
+            mixxx::library::prefs::kDatabaseCacheSizeKiBDefault);
+    if (cacheSizeKiB > 0) {
+        // Negative values are interpreted as KiB instead of pages
+        statements.append(QStringLiteral("PRAGMA cache_size=-%1").arg(cacheSizeKiB));
+    }
+    return statements;
+}
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -58,6 +95,7 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    params.initStatements = dbConnectionInitStatements(pConfig, inMemoryConnection);
     return params;
 }
 
@@ -2,16 +2,20 @@
 
 #include <QDateTime>
 #include <QDir>
+#include <QScrollBar>
+#include <algorithm>
 
 #include "control/control.h"
 #include "moc_dlgdevelopertools.cpp"
 #include "util/logging.h"
+#include "util/memoryusage.h"
 #include "util/statsmanager.h"
 
 DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
                                      UserSettingsPointer pConfig)
         : QDialog(pParent),
-          m_pConfig(pConfig) {
+          m_pConfig(pConfig),
+          m_droppedProfiles(0) {
     setupUi(this);
 
     controlsTable->setModel(&m_controlProxyModel);
@@ -61,6 +65,22 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
 
     m_logCursor = logTextView->textCursor();
 
+    // Set up the engine profiler
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    profilerEnabled->setEnabled(pProfiler != nullptr);
+    connect(profilerEnabled,
+            &QCheckBox::toggled,
+            this,
+            &DlgDeveloperTools::slotProfilerEnabled);
+    connect(profilerReset,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotProfilerReset);
+    connect(profilerExport,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotProfilerExport);
+
     // Update at 2FPS.
     startTimer(500);
 
@@ -68,8 +88,21 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
     setAttribute(Qt::WA_DeleteOnClose);
 }
 
+DlgDeveloperTools::~DlgDeveloperTools() {
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler) {
+        pProfiler->removeConsumer(this);
+    }
+}
+
 void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
     Q_UNUSED(pEvent);
+    // Keep up with the engine to avoid dropping profiles
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler && pProfiler->hasConsumer(this)) {
+        pProfiler->dispatch();
+    }
+
     if (!isVisible()) {
         // nothing to do if we are not visible
         return;
@@ -100,6 +133,10 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
         if (pManager) {
             pManager->updateStats();
         }
+    } else if (toolTabWidget->currentWidget() == profilerTab) {
+        updateProfilerView();
+    } else if (toolTabWidget->currentWidget() == memoryTab) {
+        updateMemoryView();
     }
 }
 
@@ -145,3 +182,203 @@ void DlgDeveloperTools::slotLogSearch() {
     m_logCursor = logTextView->document()->find(textToFind, m_logCursor);
     logTextView->setTextCursor(m_logCursor);
 }
+
+void DlgDeveloperTools::slotProfilerEnabled(bool enabled) {
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (!pProfiler) {
+        return;
+    }
+    if (enabled) {
+        pProfiler->addConsumer(this);
+    } else {
+        pProfiler->removeConsumer(this);
+    }
+}
+
+void DlgDeveloperTools::slotProfilerReset() {
+    m_profileStatistics.reset();
+    m_droppedProfiles = 0;
+    updateProfilerView();
+}
+
+void DlgDeveloperTools::slotProfilerExport() {
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (!pProfiler) {
+        return;
+    }
+    if (pProfiler->hasConsumer(this)) {
+        pProfiler->dispatch();
+    }
+
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString traceFileName = m_pConfig->getSettingsPath() +
+            "/engine_trace_" + timestamp + ".json";
+    QFile traceFile(traceFileName);
+    if (!traceFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "open" << traceFileName << "failed";
+        return;
+    }
+    traceFile.write(m_profileStatistics.toChromeTrace(pProfiler->channelNames()));
+    profilerSummary->setText(tr("Saved %1").arg(traceFileName));
+}
+
+void DlgDeveloperTools::consumeProfiles(
+        const std::vector<EngineProfiler::CallbackProfile>& profiles,
+        int droppedProfiles) {
+    m_droppedProfiles += droppedProfiles;
+    for (const auto& profile : profiles) {
+        m_profileStatistics.add(profile);
+    }
+}
+
+void DlgDeveloperTools::updateProfilerView() {
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (!pProfiler) {
+        return;
+    }
+    const auto micros = [](double nanos) {
+        return QString::number(nanos / mixxx::Duration::kNanosPerMicro, 'f', 1);
+    };
+    const auto histogramRow = [&micros](const QString& name,
+                                      const EngineProfileStatistics::Histogram&
+                                              histogram) {
+        return QStringLiteral(
+                "<tr><td>%1</td><td align=right>%2</td><td align=right>%3</td>"
+                "<td align=right>%4</td><td align=right>%5</td>"
+                "<td align=right>%6</td></tr>")
+                .arg(name.toHtmlEscaped(),
+                        QString::number(histogram.count()),
+                        micros(histogram.meanNanos()),
+                        micros(histogram.percentileNanos(0.5)),
+                        micros(histogram.percentileNanos(0.99)),
+                        micros(histogram.maxNanos()));
+    };
+    const QString header = QStringLiteral(
+            "<tr><th align=left>%1</th><th>%2</th><th>%3</th><th>%4</th>"
+            "<th>%5</th><th>%6</th></tr>")
+                                   .arg(tr("Stage"),
+                                           tr("Count"),
+                                           tr("Mean [us]"),
+                                           tr("p50 [us]"),
+                                           tr("p99 [us]"),
+                                           tr("Max [us]"));
+
+    const EngineProfileStatistics::Histogram& callbacks =
+            m_profileStatistics.stage(EngineProfiler::Stage::Callback);
+    profilerSummary->setText(tr("%1 callbacks, %2 longer than their buffer, %3 dropped")
+                                     .arg(QString::number(callbacks.count()),
+                                             QString::number(m_profileStatistics
+                                                             .lateCallbacks()),
+                                             QString::number(m_droppedProfiles)));
+
+    // Histogram of the callback durations
+    QString html = QStringLiteral("<h3>%1</h3><table>").arg(tr("Callback Duration"));
+    int firstBucket = EngineProfileStatistics::Histogram::kNumBuckets;
+    int lastBucket = -1;
+    int maxCount = 0;
+    for (int bucket = 0; bucket < EngineProfileStatistics::Histogram::kNumBuckets;
+            ++bucket) {
+        const int count = callbacks.bucketCount(bucket);
+        if (count > 0) {
+            firstBucket = std::min(firstBucket, bucket);
+            lastBucket = bucket;
+            maxCount = std::max(maxCount, count);
+        }
+    }
+    constexpr int kMaxBarLength = 60;
+    for (int bucket = firstBucket; bucket <= lastBucket; ++bucket) {
+        const int count = callbacks.bucketCount(bucket);
+        const int barLength = (count * kMaxBarLength + maxCount - 1) / maxCount;
+        html += QStringLiteral(
+                "<tr><td align=right>&le; %1 us</td><td align=right>%2</td>"
+                "<td><tt>%3</tt></td></tr>")
+                        .arg(micros(EngineProfileStatistics::Histogram::
+                                             bucketUpperBoundNanos(bucket)),
+                                QString::number(count),
+                                QString(barLength, QChar(0x2588)));
+    }
+    html += QStringLiteral("</table>");
+
+    html += QStringLiteral("<h3>%1</h3><table cellspacing=4>").arg(tr("Engine"));
+    html += header;
+    for (int stage = 0; stage < EngineProfiler::kNumStages; ++stage) {
+        const auto profilerStage = static_cast<EngineProfiler::Stage>(stage);
+        const EngineProfileStatistics::Histogram& histogram =
+                m_profileStatistics.stage(profilerStage);
+        if (histogram.count() > 0) {
+            html += histogramRow(
+                    EngineProfileStatistics::stageName(profilerStage), histogram);
+        }
+    }
+    html += QStringLiteral("</table>");
+
+    const QStringList channelNames = pProfiler->channelNames();
+    for (int channel = 0; channel < EngineProfiler::kMaxChannels; ++channel) {
+        QString rows;
+        for (int stage = 0; stage < EngineProfiler::kNumChannelStages; ++stage) {
+            const auto channelStage = static_cast<EngineProfiler::ChannelStage>(stage);
+            const EngineProfileStatistics::Histogram& histogram =
+                    m_profileStatistics.channelStage(channel, channelStage);
+            if (histogram.count() > 0) {
+                rows += histogramRow(
+                        EngineProfileStatistics::channelStageName(channelStage),
+                        histogram);
+            }
+        }
+        if (rows.isEmpty()) {
+            continue;
+        }
+        const QString name = channel < channelNames.size()
+                ? channelNames[channel]
+                : QString::number(channel);
+        html += QStringLiteral("<h3>%1</h3><table cellspacing=4>")
+                        .arg(name.toHtmlEscaped());
+        html += header + rows + QStringLiteral("</table>");
+    }
+
+    // Keep the scroll position while the view is updated
+    const int scrollPosition = profilerView->verticalScrollBar()->value();
+    profilerView->setHtml(html);
+    profilerView->verticalScrollBar()->setValue(scrollPosition);
+}
+
+void DlgDeveloperTools::updateMemoryView() {
+    const auto mebibytes = [](qint64 bytes) {
+        return QString::number(static_cast<double>(bytes) / (1024 * 1024), 'f', 1);
+    };
+    const auto subsystems = mixxx::MemoryUsage::report();
+    qint64 totalBytes = 0;
+    QString html = QStringLiteral(
+            "<table cellspacing=4><tr><th align=left>%1</th><th>%2</th>"
+            "<th>%3</th><th>%4</th></tr>")
+                           .arg(tr("Subsystem"),
+                                   tr("Instances"),
+                                   tr("Size [MiB]"),
+                                   tr("Budget [MiB]"));
+    for (const auto& subsystem : subsystems) {
+        totalBytes += subsystem.bytes;
+        const qint64 budgetBytes =
+                mixxx::MemoryUsageMonitor::budgetBytes(m_pConfig, subsystem.name);
+        QString budget;
+        if (!subsystem.evictable) {
+            budget = tr("n/a");
+        } else if (budgetBytes > 0) {
+            budget = mebibytes(budgetBytes);
+        } else {
+            budget = tr("none");
+        }
+        html += QStringLiteral(
+                "<tr><td>%1</td><td align=right>%2</td><td align=right>%3</td>"
+                "<td align=right>%4</td></tr>")
+                        .arg(subsystem.name.toHtmlEscaped(),
+                                QString::number(subsystem.instanceCount),
+                                mebibytes(subsystem.bytes),
+                                budget);
+    }
+    html += QStringLiteral("</table>");
+    memorySummary->setText(tr("%1 MiB accounted in %2 subsystems")
+                                   .arg(mebibytes(totalBytes),
+                                           QString::number(subsystems.size())));
+    memoryView->setHtml(html);
+}
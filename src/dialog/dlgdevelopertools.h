@@ -6,13 +6,20 @@
 
 #include "control/controlsortfiltermodel.h"
 #include "dialog/ui_dlgdevelopertoolsdlg.h"
+#include "engine/engineprofiler.h"
 #include "preferences/usersettings.h"
 #include "util/statmodel.h"
 
-class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
+class DlgDeveloperTools : public QDialog,
+                          public Ui::DlgDeveloperTools,
+                          public EngineProfiler::Consumer {
     Q_OBJECT
   public:
     DlgDeveloperTools(QWidget* pParent, UserSettingsPointer pConfig);
+    ~DlgDeveloperTools() override;
+
+    void consumeProfiles(const std::vector<EngineProfiler::CallbackProfile>& profiles,
+            int droppedProfiles) override;
 
   protected:
     void timerEvent(QTimerEvent* pTimerEvent) override;
@@ -21,8 +28,14 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     void slotControlSearch(const QString& search);
     void slotLogSearch();
     void slotControlDump();
+    void slotProfilerEnabled(bool enabled);
+    void slotProfilerReset();
+    void slotProfilerExport();
 
   private:
+    void updateProfilerView();
+    void updateMemoryView();
+
     UserSettingsPointer m_pConfig;
     ControlSortFilterModel m_controlProxyModel;
 
@@ -31,4 +44,7 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
 
     QFile m_logFile;
     QTextCursor m_logCursor;
+
+    EngineProfileStatistics m_profileStatistics;
+    int m_droppedProfiles;
 };
@@ -320,12 +320,13 @@ void DlgReplaceCueColor::slotApply() {
     }
 
     // Flush cached tracks to database
-    const QSet<TrackId> cachedTrackIds = GlobalTrackCacheLocker().getCachedTrackIds();
-    for (const TrackId& trackId : cachedTrackIds) {
-        TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
-        if (pTrack) {
-            m_pTrackCollectionManager->saveTrack(pTrack);
-        }
+    QList<TrackPointer> cachedTracks;
+    {
+        GlobalTrackCacheLocker cacheLocker;
+        cachedTracks = cacheLocker.lookupTracksByIds(cacheLocker.getCachedTrackIds());
+    }
+    for (const TrackPointer& pTrack : std::as_const(cachedTracks)) {
+        m_pTrackCollectionManager->saveTrack(pTrack);
     }
 
     if (!selectQuery.exec()) {
@@ -25,6 +25,7 @@ EffectManifestPointer BalanceEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "Adjust the left/right balance and stereo width"));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setMetaknobDefault(0.5);
 
     EffectManifestParameterPointer balance = pManifest->addParameter();
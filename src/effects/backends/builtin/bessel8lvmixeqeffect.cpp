@@ -25,6 +25,7 @@ EffectManifestPointer Bessel8LVMixEQEffect::getManifest() {
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setIsMixingEQ(true);
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
     return pManifest;
@@ -66,6 +66,7 @@ EffectManifestPointer BiquadFullKillEQEffect::getManifest() {
                     "Isolator circuit to offer gentle slopes and full kill.") +
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setIsMixingEQ(true);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
@@ -1,7 +1,10 @@
 #include "effects/backends/builtin/bitcrushereffect.h"
 
+#include <algorithm>
+
 #include "effects/backends/effectmanifest.h"
 #include "engine/effects/engineeffectparameter.h"
+#include "util/defs.h"
 #include "util/sample.h"
 
 // static
@@ -20,6 +23,7 @@ EffectManifestPointer BitCrusherEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "Adds noise by the reducing the bit depth and sample rate"));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.1);
 
     EffectManifestParameterPointer depth = pManifest->addParameter();
     depth->setId("bit_depth");
@@ -49,13 +53,41 @@ EffectManifestPointer BitCrusherEffect::getManifest() {
     frequency->setNeutralPointOnScale(1.0);
     frequency->setRange(0.02, 1.0, 1.0);
 
+    EffectManifestParameterPointer oversampling = pManifest->addParameter();
+    oversampling->setId("oversampling");
+    oversampling->setName(QObject::tr("Oversampling"));
+    oversampling->setShortName(QObject::tr("Oversample"));
+    oversampling->setDescription(QObject::tr(
+            "Crushes the audio signal at a multiple of the sample rate to "
+            "avoid aliasing, which adds a latency of less than a millisecond."));
+    oversampling->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    oversampling->setRange(0, 1, 2);
+    oversampling->appendStep(qMakePair(QObject::tr("Off"), 0));
+    oversampling->appendStep(qMakePair(QObject::tr("2x"), 1));
+    oversampling->appendStep(qMakePair(QObject::tr("4x"), 2));
+
     return pManifest;
 }
 
+BitCrusherEffect::BitCrusherEffect()
+        : m_oversampled(StereoOversampler::kMaxFactor * kMaxEngineSamples) {
+}
+
 void BitCrusherEffect::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
     m_pBitDepthParameter = parameters.value("bit_depth");
     m_pDownsampleParameter = parameters.value("downsample");
+    m_pOversamplingParameter = parameters.value("oversampling");
+}
+
+int BitCrusherEffect::oversamplingFactor() const {
+    return m_pOversamplingParameter
+            ? 1 << std::clamp(m_pOversamplingParameter->toInt(), 0, 2)
+            : 1;
+}
+
+SINT BitCrusherEffect::getGroupDelayFrames() {
+    return StereoOversampler::latencyFrames(oversamplingFactor());
 }
 
 void BitCrusherEffect::processChannel(
@@ -80,20 +112,28 @@ void BitCrusherEffect::processChannel(
     // rarely used, to achieve equal loudness and maximum dynamic
     const CSAMPLE gainCorrection = (17 - bit_depth) / 8;
 
+    // The samples are held at the oversampled rate, so the steps are
+    // smoothed by the lowpass filter of the downsampler instead of aliasing
+    const int factor = oversamplingFactor();
+    pState->oversampler.setFactor(factor);
+    const CSAMPLE step = downsample / factor;
+    CSAMPLE* pOversampled = m_oversampled.data();
+    pState->oversampler.upsample(pOversampled, pInput, engineParameters.framesPerBuffer());
+
     for (SINT i = 0;
-            i < engineParameters.samplesPerBuffer();
+            i < engineParameters.samplesPerBuffer() * factor;
             i += engineParameters.channelCount()) {
-        pState->accumulator += downsample;
+        pState->accumulator += step;
 
         if (pState->accumulator >= 1.0) {
             pState->accumulator -= 1.0f;
             if (bit_depth < 16) {
                 pState->hold_l = floorf(SampleUtil::clampSample(
-                                                pInput[i] * gainCorrection) *
+                                                pOversampled[i] * gainCorrection) *
                                                  scale +
                                          0.5f) /
                         scale / gainCorrection;
-                pState->hold_r = floorf(SampleUtil::clampSample(pInput[i + 1] *
+                pState->hold_r = floorf(SampleUtil::clampSample(pOversampled[i + 1] *
                                                 gainCorrection) *
                                                  scale +
                                          0.5f) /
@@ -101,12 +141,15 @@ void BitCrusherEffect::processChannel(
             } else {
                 // Mixxx float has 24 bit depth, Audio CDs are 16 bit
                 // here we do not change the depth
-                pState->hold_l = pInput[i];
-                pState->hold_r = pInput[i + 1];
+                pState->hold_l = pOversampled[i];
+                pState->hold_r = pOversampled[i + 1];
             }
         }
 
-        pOutput[i] = pState->hold_l;
-        pOutput[i + 1] = pState->hold_r;
+        pOversampled[i] = pState->hold_l;
+        pOversampled[i + 1] = pState->hold_r;
     }
+
+    pState->oversampler.downsample(
+            pOutput, pOversampled, engineParameters.framesPerBuffer());
 }
@@ -3,7 +3,9 @@
 #include <QMap>
 
 #include "effects/backends/effectprocessor.h"
+#include "engine/filters/stereooversampler.h"
 #include "util/class.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 struct BitCrusherGroupState : public EffectState {
@@ -20,11 +22,12 @@ struct BitCrusherGroupState : public EffectState {
     CSAMPLE hold_r;
     // Accumulated fractions of a samplerate period.
     CSAMPLE accumulator;
+    StereoOversampler oversampler;
 };
 
 class BitCrusherEffect : public EffectProcessorImpl<BitCrusherGroupState> {
   public:
-    BitCrusherEffect() = default;
+    BitCrusherEffect();
     ~BitCrusherEffect() override = default;
 
     static QString getId();
@@ -41,13 +44,21 @@ class BitCrusherEffect : public EffectProcessorImpl<BitCrusherGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    SINT getGroupDelayFrames() override;
+
   private:
     QString debugString() const {
         return getId();
     }
 
+    int oversamplingFactor() const;
+
     EngineEffectParameterPointer m_pBitDepthParameter;
     EngineEffectParameterPointer m_pDownsampleParameter;
+    EngineEffectParameterPointer m_pOversamplingParameter;
+
+    // Shared by all states, which are processed one after another
+    mixxx::SampleBuffer m_oversampled;
 
     DISALLOW_COPY_AND_ASSIGN(BitCrusherEffect);
 };
@@ -36,6 +36,7 @@ EffectManifestPointer CompressorEffect::getManifest() {
     pManifest->setVersion("1.0");
     pManifest->setDescription("A single-band compressor effect");
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.1);
     pManifest->setMetaknobDefault(0.0);
 
     EffectManifestParameterPointer autoMakeUp = pManifest->addParameter();
@@ -0,0 +1,297 @@
+#include "effects/backends/builtin/convolutionimpulseresponse.h"
+
+#include <dsp/transforms/FFT.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+// The length of the longest impulse response is limited to bound the
+// memory of the channel states at high sample rates
+constexpr double kMaxImpulseResponseSeconds = 6.0;
+
+// -60 dB after the decay time (RT60)
+const double kDecayLogAmplitude = std::log(0.001);
+
+// The resampling filter extends over kResampleHalfTaps frames on each side
+// of the output position, or more frames of the input when downsampling
+constexpr int kResampleHalfTaps = 16;
+constexpr double kResampleCutoff = 0.9;
+
+double blackmanWindow(double distance, double halfWidth) {
+    const double x = M_PI * distance / halfWidth;
+    return 0.42 + 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+}
+
+// Calculates the spectra of the partitions of samples that start at offset.
+// Returns the number of partitions.
+int calculatePartitions(const std::vector<float>& samples,
+        std::size_t offset,
+        int partitionFrames,
+        int maxPartitions,
+        FFTReal* pFft,
+        std::vector<float>* pRe,
+        std::vector<float>* pIm) {
+    const int bins = partitionFrames + 1;
+    int numPartitions = 0;
+    if (samples.size() > offset) {
+        numPartitions = static_cast<int>(
+                (samples.size() - offset + partitionFrames - 1) / partitionFrames);
+    }
+    numPartitions = std::min(numPartitions, maxPartitions);
+    pRe->assign(static_cast<std::size_t>(numPartitions) * bins, 0.0f);
+    pIm->assign(static_cast<std::size_t>(numPartitions) * bins, 0.0f);
+
+    std::vector<double> input(2 * partitionFrames);
+    std::vector<double> re(2 * partitionFrames);
+    std::vector<double> im(2 * partitionFrames);
+    for (int partition = 0; partition < numPartitions; ++partition) {
+        // The second half is zero padding for the linear convolution
+        std::fill(input.begin(), input.end(), 0.0);
+        const std::size_t start = offset +
+                static_cast<std::size_t>(partition) * partitionFrames;
+        const std::size_t end = std::min(samples.size(), start + partitionFrames);
+        std::copy(samples.begin() + start, samples.begin() + end, input.begin());
+        pFft->forward(input.data(), re.data(), im.data());
+        for (int bin = 0; bin < bins; ++bin) {
+            (*pRe)[partition * bins + bin] = static_cast<float>(re[bin]);
+            (*pIm)[partition * bins + bin] = static_cast<float>(im[bin]);
+        }
+    }
+    return numPartitions;
+}
+
+} // namespace
+
+ConvolutionImpulseResponse::ConvolutionImpulseResponse(
+        mixxx::audio::SampleRate sampleRate, quint64 generation)
+        : m_sampleRate(sampleRate),
+          m_generation(generation),
+          m_numPartitions(0),
+          m_numTailPartitions(0) {
+}
+
+// static
+std::unique_ptr<ConvolutionImpulseResponse> ConvolutionImpulseResponse::create(
+        const std::vector<float> (&samples)[kChannels],
+        mixxx::audio::SampleRate sampleRate,
+        quint64 generation,
+        FFTReal* pFft,
+        FFTReal* pTailFft) {
+    auto pImpulseResponse = std::unique_ptr<ConvolutionImpulseResponse>(
+            new ConvolutionImpulseResponse(sampleRate, generation));
+    const int maxTailPartitions = static_cast<int>(std::ceil(
+            kMaxImpulseResponseSeconds * mixxx::audio::SampleRate::kValueMax /
+            kTailPartitionFrames));
+    for (int channel = 0; channel < kChannels; ++channel) {
+        const std::vector<float>& channelSamples = samples[channel];
+
+        std::vector<float>& reversedHead = pImpulseResponse->m_reversedHead[channel];
+        reversedHead.assign(kPartitionFrames, 0.0f);
+        const int headFrames = static_cast<int>(std::min<std::size_t>(
+                channelSamples.size(), kPartitionFrames));
+        for (int i = 0; i < headFrames; ++i) {
+            reversedHead[kPartitionFrames - 1 - i] = channelSamples[i];
+        }
+
+        const int numPartitions = calculatePartitions(channelSamples,
+                kPartitionFrames,
+                kPartitionFrames,
+                kMaxPartitions,
+                pFft,
+                &pImpulseResponse->m_partitionsRe[channel],
+                &pImpulseResponse->m_partitionsIm[channel]);
+        const int numTailPartitions = calculatePartitions(channelSamples,
+                kTailOffsetFrames,
+                kTailPartitionFrames,
+                maxTailPartitions,
+                pTailFft,
+                &pImpulseResponse->m_tailPartitionsRe[channel],
+                &pImpulseResponse->m_tailPartitionsIm[channel]);
+        // Both channels are processed with the same number of partitions
+        pImpulseResponse->m_numPartitions =
+                std::max(pImpulseResponse->m_numPartitions, numPartitions);
+        pImpulseResponse->m_numTailPartitions =
+                std::max(pImpulseResponse->m_numTailPartitions, numTailPartitions);
+    }
+    // Pad the channel with fewer partitions
+    for (int channel = 0; channel < kChannels; ++channel) {
+        pImpulseResponse->m_partitionsRe[channel].resize(
+                pImpulseResponse->m_numPartitions * kPartitionBins, 0.0f);
+        pImpulseResponse->m_partitionsIm[channel].resize(
+                pImpulseResponse->m_numPartitions * kPartitionBins, 0.0f);
+        pImpulseResponse->m_tailPartitionsRe[channel].resize(
+                pImpulseResponse->m_numTailPartitions * kTailPartitionBins, 0.0f);
+        pImpulseResponse->m_tailPartitionsIm[channel].resize(
+                pImpulseResponse->m_numTailPartitions * kTailPartitionBins, 0.0f);
+    }
+    return pImpulseResponse;
+}
+
+// static
+void ConvolutionImpulseResponse::synthesize(std::vector<float> (&samples)[kChannels],
+        double decaySeconds,
+        double damping,
+        mixxx::audio::SampleRate sampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(sampleRate.isValid() && decaySeconds > 0) {
+        for (auto& channelSamples : samples) {
+            channelSamples.clear();
+        }
+        return;
+    }
+    decaySeconds = std::min(decaySeconds, kMaxImpulseResponseSeconds);
+    const auto frames = static_cast<std::size_t>(decaySeconds * sampleRate.toDouble());
+    const double decayPerFrame = kDecayLogAmplitude / (decaySeconds * sampleRate.toDouble());
+    // The coefficient of the low pass filter decreases from 1 (no filtering)
+    // at the beginning to the minimum at the end of the impulse response
+    const double minCoefficient = 1.0 - 0.95 * std::clamp(damping, 0.0, 1.0);
+    const double coefficientPerFrame = std::log(minCoefficient) / frames;
+
+    for (int channel = 0; channel < kChannels; ++channel) {
+        std::vector<float>& channelSamples = samples[channel];
+        channelSamples.resize(frames);
+        // Explicitly seeded for reproducible impulse responses
+        std::minstd_rand generator(channel + 1);
+        std::uniform_real_distribution<double> noise(-1.0, 1.0);
+        double filtered = 0.0;
+        double energy = 0.0;
+        for (std::size_t i = 0; i < frames; ++i) {
+            const double coefficient = std::exp(coefficientPerFrame * i);
+            filtered += coefficient * (noise(generator) - filtered);
+            const double sample = filtered * std::exp(decayPerFrame * i);
+            channelSamples[i] = static_cast<float>(sample);
+            energy += sample * sample;
+        }
+        // Normalize to unit energy, so white noise keeps its level
+        if (energy > 0.0) {
+            const auto gain = static_cast<float>(1.0 / std::sqrt(energy));
+            for (float& sample : channelSamples) {
+                sample *= gain;
+            }
+        }
+    }
+}
+
+// static
+bool ConvolutionImpulseResponse::load(std::vector<float> (&samples)[kChannels],
+        const QString& filePath,
+        mixxx::audio::SampleRate sampleRate) {
+    for (auto& channelSamples : samples) {
+        channelSamples.clear();
+    }
+    VERIFY_OR_DEBUG_ASSERT(sampleRate.isValid()) {
+        return false;
+    }
+
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setChannelCount(mixxx::audio::ChannelCount::stereo());
+    mixxx::AudioSourcePointer pAudioSource =
+            SoundSourceProxy(Track::newTemporary(filePath)).openAudioSource(openParams);
+    if (!pAudioSource) {
+        return false;
+    }
+    const auto sourceSampleRate = pAudioSource->getSignalInfo().getSampleRate();
+    const auto frameRange = intersect(pAudioSource->frameIndexRange(),
+            mixxx::IndexRange::forward(pAudioSource->frameIndexMin(),
+                    static_cast<SINT>(kMaxImpulseResponseSeconds *
+                            sourceSampleRate.toDouble())));
+    if (frameRange.empty()) {
+        return false;
+    }
+    if (pAudioSource->getSignalInfo().getChannelCount() !=
+            mixxx::audio::ChannelCount::stereo()) {
+        pAudioSource = mixxx::AudioSourceStereoProxy::create(
+                pAudioSource, frameRange.length());
+    }
+
+    mixxx::SampleBuffer sampleBuffer(frameRange.length() * kChannels);
+    const auto readableSampleFrames = pAudioSource->readSampleFrames(
+            mixxx::WritableSampleFrames(frameRange,
+                    mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+    const SINT frames = readableSampleFrames.frameIndexRange().length();
+    if (frames == 0) {
+        return false;
+    }
+    const CSAMPLE* pSamples = readableSampleFrames.readableData();
+    for (int channel = 0; channel < kChannels; ++channel) {
+        std::vector<float>& channelSamples = samples[channel];
+        channelSamples.resize(frames);
+        for (SINT i = 0; i < frames; ++i) {
+            channelSamples[i] = pSamples[i * kChannels + channel];
+        }
+        resample(&channelSamples, sourceSampleRate, sampleRate);
+    }
+
+    // Normalize to the energy of the synthesized impulse responses, but
+    // keep the balance of the channels
+    double energy = 0.0;
+    for (const auto& channelSamples : samples) {
+        for (const float sample : channelSamples) {
+            energy += static_cast<double>(sample) * sample;
+        }
+    }
+    if (energy <= 0.0) {
+        for (auto& channelSamples : samples) {
+            channelSamples.clear();
+        }
+        return false;
+    }
+    const auto gain = static_cast<float>(std::sqrt(kChannels / energy));
+    for (auto& channelSamples : samples) {
+        for (float& sample : channelSamples) {
+            sample *= gain;
+        }
+    }
+    return true;
+}
+
+// static
+void ConvolutionImpulseResponse::resample(std::vector<float>* pSamples,
+        mixxx::audio::SampleRate sourceSampleRate,
+        mixxx::audio::SampleRate targetSampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(sourceSampleRate.isValid() && targetSampleRate.isValid()) {
+        return;
+    }
+    if (sourceSampleRate == targetSampleRate || pSamples->empty()) {
+        return;
+    }
+    const std::vector<float>& input = *pSamples;
+    // The number of input frames per output frame
+    const double ratio = sourceSampleRate.toDouble() / targetSampleRate.toDouble();
+    // The cutoff relative to the Nyquist frequency of the input
+    const double scale = std::min(1.0, 1.0 / ratio);
+    const double cutoff = kResampleCutoff * scale;
+    const double halfWidth = kResampleHalfTaps / scale;
+
+    const auto inputFrames = static_cast<std::ptrdiff_t>(input.size());
+    // Rounded up without floating point errors
+    const auto outputFrames = static_cast<std::size_t>(
+            (static_cast<qint64>(inputFrames) * targetSampleRate.value() +
+                    sourceSampleRate.value() - 1) /
+            sourceSampleRate.value());
+    std::vector<float> output(outputFrames);
+    for (std::size_t frame = 0; frame < outputFrames; ++frame) {
+        const double position = frame * ratio;
+        const auto first = std::max<std::ptrdiff_t>(0,
+                static_cast<std::ptrdiff_t>(std::ceil(position - halfWidth)));
+        const auto last = std::min<std::ptrdiff_t>(inputFrames - 1,
+                static_cast<std::ptrdiff_t>(std::floor(position + halfWidth)));
+        double sum = 0.0;
+        for (std::ptrdiff_t i = first; i <= last; ++i) {
+            const double distance = i - position;
+            const double x = M_PI * cutoff * distance;
+            const double sinc = distance == 0.0 ? 1.0 : std::sin(x) / x;
+            sum += input[i] * cutoff * sinc * blackmanWindow(distance, halfWidth);
+        }
+        output[frame] = static_cast<float>(sum);
+    }
+    pSamples->swap(output);
+}
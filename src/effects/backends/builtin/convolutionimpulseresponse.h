@@ -0,0 +1,146 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/class.h"
+#include "util/types.h"
+
+class FFTReal;
+
+/// A stereo impulse response that is split into the partitions of a
+/// non-uniformly partitioned convolution with three layers:
+///
+/// * The head is convolved directly in the time domain, without latency.
+/// * The following frames up to twice the tail partition length are convolved
+///   with uniformly partitioned FFT convolution in the audio thread. The
+///   latency of one partition is hidden behind the head.
+/// * The remaining frames are convolved with larger partitions in a background
+///   thread. The latency of two tail partitions is hidden behind the previous
+///   layers, which gives the thread the duration of a whole partition to
+///   process it.
+///
+/// The spectra are calculated once when the impulse response is created and
+/// shared by all channel states. Only the non-redundant half of each spectrum
+/// is stored.
+class ConvolutionImpulseResponse {
+  public:
+    /// The length of the head and of the partitions of the audio thread
+    static constexpr int kPartitionFrames = 128;
+    static constexpr int kPartitionBins = kPartitionFrames + 1;
+    /// The length of the partitions of the background thread
+    static constexpr int kTailPartitionFrames = 4096;
+    static constexpr int kTailPartitionBins = kTailPartitionFrames + 1;
+    /// The partitions of the audio thread cover the frames up to the latency
+    /// of the background thread
+    static constexpr int kMaxPartitions =
+            2 * kTailPartitionFrames / kPartitionFrames - 1;
+    static constexpr int kTailOffsetFrames = 2 * kTailPartitionFrames;
+
+    static constexpr int kChannels = 2;
+
+    /// Creates the partitions of an impulse response with one vector of
+    /// samples per channel. Called from the background thread, because
+    /// this allocates memory and is slow for long impulse responses.
+    static std::unique_ptr<ConvolutionImpulseResponse> create(
+            const std::vector<float> (&samples)[kChannels],
+            mixxx::audio::SampleRate sampleRate,
+            quint64 generation,
+            FFTReal* pFft,
+            FFTReal* pTailFft);
+
+    /// Synthesizes the impulse response of a diffuse room as exponentially
+    /// decaying noise. Each channel uses different noise for a wide stereo
+    /// image. Higher damping values cause high frequencies to decay more
+    /// quickly.
+    static void synthesize(std::vector<float> (&samples)[kChannels],
+            double decaySeconds,
+            double damping,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// Decodes the impulse response of a room from an audio file and
+    /// resamples it to the given sample rate. Mono files are used for both
+    /// channels and longer files are cut at the maximum length. Called from
+    /// the background thread. Returns false if the file cannot be decoded.
+    static bool load(std::vector<float> (&samples)[kChannels],
+            const QString& filePath,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// Resamples the samples of a single channel with a windowed sinc
+    /// filter, which also removes the frequencies above the new Nyquist
+    /// frequency
+    static void resample(std::vector<float>* pSamples,
+            mixxx::audio::SampleRate sourceSampleRate,
+            mixxx::audio::SampleRate targetSampleRate);
+
+    quint64 generation() const {
+        return m_generation;
+    }
+
+    mixxx::audio::SampleRate sampleRate() const {
+        return m_sampleRate;
+    }
+
+    /// The head in reverse order, as required for the direct convolution
+    const float* reversedHead(int channel) const {
+        return m_reversedHead[channel].data();
+    }
+
+    int numPartitions() const {
+        return m_numPartitions;
+    }
+
+    /// The spectrum of a partition of the audio thread
+    const float* partitionRe(int channel, int partition) const {
+        return &m_partitionsRe[channel][partition * kPartitionBins];
+    }
+    const float* partitionIm(int channel, int partition) const {
+        return &m_partitionsIm[channel][partition * kPartitionBins];
+    }
+
+    int numTailPartitions() const {
+        return m_numTailPartitions;
+    }
+
+    /// The spectrum of a partition of the background thread
+    const float* tailPartitionRe(int channel, int partition) const {
+        return &m_tailPartitionsRe[channel][partition * kTailPartitionBins];
+    }
+    const float* tailPartitionIm(int channel, int partition) const {
+        return &m_tailPartitionsIm[channel][partition * kTailPartitionBins];
+    }
+
+  private:
+    ConvolutionImpulseResponse(mixxx::audio::SampleRate sampleRate, quint64 generation);
+
+    const mixxx::audio::SampleRate m_sampleRate;
+    const quint64 m_generation;
+    int m_numPartitions;
+    int m_numTailPartitions;
+    std::vector<float> m_reversedHead[kChannels];
+    std::vector<float> m_partitionsRe[kChannels];
+    std::vector<float> m_partitionsIm[kChannels];
+    std::vector<float> m_tailPartitionsRe[kChannels];
+    std::vector<float> m_tailPartitionsIm[kChannels];
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionImpulseResponse);
+};
+
+/// Adds the product of the spectra a and b to the accumulated spectrum.
+/// Called in the inner loop of the convolution.
+inline void convolutionMultiplyAccumulate(double* pAccRe,
+        double* pAccIm,
+        const float* pARe,
+        const float* pAIm,
+        const float* pBRe,
+        const float* pBIm,
+        int bins) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < bins; ++i) {
+        pAccRe[i] += pARe[i] * pBRe[i] - pAIm[i] * pBIm[i];
+        pAccIm[i] += pARe[i] * pBIm[i] + pAIm[i] * pBRe[i];
+    }
+}
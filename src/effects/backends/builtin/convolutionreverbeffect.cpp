@@ -0,0 +1,392 @@
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+
+#include <dsp/transforms/FFT.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+
+#include "effects/backends/builtin/convolutionreverbthread.h"
+#include "effects/backends/effectmanifest.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "sources/soundsourceproxy.h"
+#include "util/cmdlineargs.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr int kChannels = ConvolutionImpulseResponse::kChannels;
+constexpr int kPartitionFrames = ConvolutionImpulseResponse::kPartitionFrames;
+constexpr int kPartitionBins = ConvolutionImpulseResponse::kPartitionBins;
+constexpr int kMaxPartitions = ConvolutionImpulseResponse::kMaxPartitions;
+constexpr int kTailFrames = ConvolutionImpulseResponse::kTailPartitionFrames;
+constexpr int kTailSlots = ConvolutionReverbGroupState::kTailSlots;
+
+// The parameters are quantized, so moving a knob only creates a new impulse
+// response for audible changes
+constexpr double kDecayStepSeconds = 0.05;
+constexpr double kDampingStep = 0.01;
+
+// The parameters of the synthesized impulse response that replaces a file
+// that cannot be decoded
+constexpr double kDefaultDecaySeconds = 2.0;
+constexpr double kDefaultDamping = 0.5;
+
+const QString kImpulseResponseDirectory = QStringLiteral("impulse_responses");
+
+double quantize(double value, double step) {
+    return std::round(value / step) * step;
+}
+
+// The audio files in the impulse response directory of the settings,
+// which are scanned once, because the steps of the manifest must match
+// the files of the thread
+const QStringList& impulseResponseFiles() {
+    static const QStringList s_files = [] {
+        QStringList files;
+        const QString& settingsPath = CmdlineArgs::Instance().getSettingsPath();
+        if (settingsPath.isEmpty()) {
+            return files;
+        }
+        const QDir dir(QDir(settingsPath).filePath(kImpulseResponseDirectory));
+        const QStringList fileNames = dir.entryList(
+                SoundSourceProxy::getSupportedFileNamePatterns(),
+                QDir::Files | QDir::Readable,
+                QDir::Name | QDir::IgnoreCase);
+        for (const QString& fileName : fileNames) {
+            files.append(dir.filePath(fileName));
+        }
+        return files;
+    }();
+    return s_files;
+}
+
+} // namespace
+
+ConvolutionReverbGroupState::ConvolutionReverbGroupState(
+        const mixxx::EngineParameters& engineParameters,
+        std::shared_ptr<ConvolutionReverbThread> pThread)
+        : EffectState(engineParameters),
+          sendPrevious(0),
+          partitionPos(0),
+          tailPartitionPos(0),
+          headPos(0),
+          spectraPos(0),
+          tailSeq(0),
+          tailInputSlots(kTailSlots * kChannels * kTailFrames),
+          tailInputSeq(0),
+          tailResetSeq(0),
+          tailOutputSlots(kTailSlots * kChannels * kTailFrames),
+          m_pThread(std::move(pThread)) {
+    for (int channel = 0; channel < kChannels; ++channel) {
+        mixxx::SampleBuffer(2 * kPartitionFrames).swap(headHistory[channel]);
+        mixxx::SampleBuffer(kPartitionFrames).swap(partitionInput[channel]);
+        mixxx::SampleBuffer(kPartitionFrames).swap(partitionOutput[channel]);
+        mixxx::SampleBuffer(kPartitionFrames).swap(partitionOverlap[channel]);
+        spectraRe[channel].resize(kMaxPartitions * kPartitionBins);
+        spectraIm[channel].resize(kMaxPartitions * kPartitionBins);
+        mixxx::SampleBuffer(kTailFrames).swap(tailOutput[channel]);
+    }
+    for (auto& slotSeq : tailOutputSlotSeqs) {
+        slotSeq = 0;
+    }
+    reset();
+    m_pThread->addState(this);
+}
+
+ConvolutionReverbGroupState::~ConvolutionReverbGroupState() {
+    m_pThread->removeState(this);
+}
+
+void ConvolutionReverbGroupState::reset() {
+    sendPrevious = 0;
+    partitionPos = 0;
+    tailPartitionPos = 0;
+    headPos = 0;
+    spectraPos = 0;
+    for (int channel = 0; channel < kChannels; ++channel) {
+        headHistory[channel].clear();
+        partitionInput[channel].clear();
+        partitionOutput[channel].clear();
+        partitionOverlap[channel].clear();
+        std::fill(spectraRe[channel].begin(), spectraRe[channel].end(), 0.0f);
+        std::fill(spectraIm[channel].begin(), spectraIm[channel].end(), 0.0f);
+        tailOutput[channel].clear();
+    }
+    // The partition that is recorded next starts without a tail
+    tailResetSeq.store(tailSeq, std::memory_order_release);
+}
+
+ConvolutionReverbEffect::ConvolutionReverbEffect()
+        : m_pThread(std::make_shared<ConvolutionReverbThread>(impulseResponseFiles())),
+          m_pFft(std::make_unique<FFTReal>(2 * kPartitionFrames)),
+          m_fftInput(2 * kPartitionFrames),
+          m_fftRe(2 * kPartitionFrames),
+          m_fftIm(2 * kPartitionFrames),
+          m_fftOutput(2 * kPartitionFrames),
+          m_lateTailCounter(QStringLiteral("ConvolutionReverbEffect late tail partitions")) {
+}
+
+ConvolutionReverbEffect::~ConvolutionReverbEffect() = default;
+
+// static
+QString ConvolutionReverbEffect::getId() {
+    return "org.mixxx.effects.convolutionreverb";
+}
+
+// static
+EffectManifestPointer ConvolutionReverbEffect::getManifest() {
+    EffectManifestPointer pManifest(new EffectManifest());
+    pManifest->setAddDryToWet(true);
+    pManifest->setEffectRampsFromDry(true);
+    // The longest impulse response and the latency of the tail partitions
+    pManifest->setTailLengthSeconds(6.5);
+
+    pManifest->setId(getId());
+    pManifest->setName(QObject::tr("Convolution Reverb"));
+    pManifest->setShortName(QObject::tr("Conv Reverb"));
+    pManifest->setAuthor("The Mixxx Team");
+    pManifest->setVersion("1.0");
+    pManifest->setDescription(QObject::tr(
+            "Convolves the signal with the impulse response of a diffuse room "
+            "for a natural, dense reverberation"));
+
+    EffectManifestParameterPointer decay = pManifest->addParameter();
+    decay->setId("decay");
+    decay->setName(QObject::tr("Decay"));
+    decay->setShortName(QObject::tr("Decay"));
+    decay->setDescription(QObject::tr(
+            "The time until the reverberation has faded out by 60 dB"));
+    decay->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    decay->setUnitsHint(EffectManifestParameter::UnitsHint::Seconds);
+    decay->setRange(0.5, kDefaultDecaySeconds, 6);
+
+    EffectManifestParameterPointer damping = pManifest->addParameter();
+    damping->setId("damping");
+    damping->setName(QObject::tr("Damping"));
+    damping->setShortName(QObject::tr("Damping"));
+    damping->setDescription(
+            QObject::tr("Higher damping values cause high frequencies to decay "
+                        "more quickly than low frequencies."));
+    damping->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    damping->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    damping->setRange(0, kDefaultDamping, 1);
+
+    EffectManifestParameterPointer send = pManifest->addParameter();
+    send->setId("send_amount");
+    send->setName(QObject::tr("Send"));
+    send->setShortName(QObject::tr("Send"));
+    send->setDescription(QObject::tr(
+            "How much of the signal to send in to the effect"));
+    send->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    send->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    send->setDefaultLinkType(EffectManifestParameter::LinkType::Linked);
+    send->setDefaultLinkInversion(EffectManifestParameter::LinkInversion::NotInverted);
+    send->setRange(0, 0, 1);
+
+    // Only offered if the user has put impulse responses into the directory
+    const QStringList& files = impulseResponseFiles();
+    if (!files.isEmpty()) {
+        EffectManifestParameterPointer impulseResponse = pManifest->addParameter();
+        impulseResponse->setId("impulse_response");
+        impulseResponse->setName(QObject::tr("Impulse Response"));
+        impulseResponse->setShortName(QObject::tr("IR"));
+        impulseResponse->setDescription(QObject::tr(
+                "Synthesized: The decay and damping shape the impulse response "
+                "of a diffuse room\n"
+                "Otherwise: The impulse response is loaded from the file in the "
+                "impulse_responses folder of the settings directory. Decay and "
+                "damping have no effect."));
+        impulseResponse->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+        impulseResponse->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+        impulseResponse->setRange(0, 0, files.size());
+        impulseResponse->appendStep(qMakePair(QObject::tr("Synthesized"), 0));
+        for (int i = 0; i < files.size(); ++i) {
+            impulseResponse->appendStep(
+                    qMakePair(QFileInfo(files.at(i)).completeBaseName(), i + 1));
+        }
+    }
+
+    return pManifest;
+}
+
+void ConvolutionReverbEffect::loadEngineEffectParameters(
+        const QMap<QString, EngineEffectParameterPointer>& parameters) {
+    m_pDecayParameter = parameters.value("decay");
+    m_pDampingParameter = parameters.value("damping");
+    m_pSendParameter = parameters.value("send_amount");
+    // Missing if there are no impulse response files
+    m_pImpulseResponseParameter = parameters.value("impulse_response");
+}
+
+ConvolutionReverbGroupState* ConvolutionReverbEffect::createSpecificState(
+        const mixxx::EngineParameters& engineParameters) {
+    return new ConvolutionReverbGroupState(engineParameters, m_pThread);
+}
+
+void ConvolutionReverbEffect::processChannel(
+        ConvolutionReverbGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+
+    const ConvolutionImpulseResponse* pImpulseResponse =
+            m_pThread->acquireImpulseResponse();
+    const int file = m_pImpulseResponseParameter
+            ? static_cast<int>(m_pImpulseResponseParameter->value())
+            : 0;
+    if (file > 0) {
+        // Moving the decay or damping knob must not decode the file again
+        m_pThread->requestImpulseResponse(kDefaultDecaySeconds,
+                kDefaultDamping,
+                file,
+                engineParameters.sampleRate());
+    } else {
+        m_pThread->requestImpulseResponse(
+                quantize(m_pDecayParameter->value(), kDecayStepSeconds),
+                quantize(m_pDampingParameter->value(), kDampingStep),
+                0,
+                engineParameters.sampleRate());
+    }
+
+    // Prevent replaying the old tail from the last time the effect was enabled
+    if (enableState == EffectEnableState::Enabling) {
+        pState->reset();
+    }
+
+    if (!pImpulseResponse) {
+        // The dry signal is added by the effect chain
+        SampleUtil::clear(pOutput, engineParameters.samplesPerBuffer());
+        return;
+    }
+
+    const auto sendCurrent = static_cast<CSAMPLE>(m_pSendParameter->value());
+    const SINT frames = engineParameters.framesPerBuffer();
+    const CSAMPLE sendDelta = (sendCurrent - pState->sendPrevious) / frames;
+    for (SINT frame = 0; frame < frames; ++frame) {
+        const CSAMPLE send = pState->sendPrevious + sendDelta * (frame + 1);
+        for (int channel = 0; channel < kChannels; ++channel) {
+            const CSAMPLE input = pInput[frame * kChannels + channel] * send;
+
+            // The head is convolved directly, so there is no latency
+            CSAMPLE* pHistory = pState->headHistory[channel].data();
+            pHistory[pState->headPos] = input;
+            pHistory[pState->headPos + kPartitionFrames] = input;
+            const float* pReversedHead = pImpulseResponse->reversedHead(channel);
+            const CSAMPLE* pWindow = pHistory + pState->headPos + 1;
+            CSAMPLE output = 0;
+            // note: LOOP VECTORIZED.
+            for (int i = 0; i < kPartitionFrames; ++i) {
+                output += pReversedHead[i] * pWindow[i];
+            }
+
+            output += pState->partitionOutput[channel][pState->partitionPos];
+            output += pState->tailOutput[channel][pState->tailPartitionPos];
+            pOutput[frame * kChannels + channel] = output;
+
+            pState->partitionInput[channel][pState->partitionPos] = input;
+            const int slot = static_cast<int>(pState->tailSeq % kTailSlots);
+            pState->tailInputSlots[(slot * kChannels + channel) * kTailFrames +
+                    pState->tailPartitionPos] = input;
+        }
+        pState->headPos = (pState->headPos + 1) % kPartitionFrames;
+        if (++pState->partitionPos == kPartitionFrames) {
+            processPartition(pState, pImpulseResponse);
+            pState->partitionPos = 0;
+        }
+        if (++pState->tailPartitionPos == kTailFrames) {
+            processTailPartition(pState);
+            pState->tailPartitionPos = 0;
+        }
+    }
+
+    // The ramping of the send parameter handles ramping when enabling, so
+    // this effect must handle ramping to dry when disabling itself (instead
+    // of being handled by EngineEffect::process).
+    if (enableState == EffectEnableState::Disabling) {
+        SampleUtil::applyRampingGain(pOutput, 1.0, 0.0, engineParameters.samplesPerBuffer());
+        pState->sendPrevious = 0;
+    } else {
+        pState->sendPrevious = sendCurrent;
+    }
+}
+
+void ConvolutionReverbEffect::processPartition(ConvolutionReverbGroupState* pState,
+        const ConvolutionImpulseResponse* pImpulseResponse) {
+    const int numPartitions = pImpulseResponse->numPartitions();
+    for (int channel = 0; channel < kChannels; ++channel) {
+        // The second half is zero padding for the linear convolution
+        const CSAMPLE* pInput = pState->partitionInput[channel].data();
+        std::copy(pInput, pInput + kPartitionFrames, m_fftInput.begin());
+        std::fill(m_fftInput.begin() + kPartitionFrames, m_fftInput.end(), 0.0);
+        m_pFft->forward(m_fftInput.data(), m_fftRe.data(), m_fftIm.data());
+
+        float* pSpectrumRe = &pState->spectraRe[channel][pState->spectraPos * kPartitionBins];
+        float* pSpectrumIm = &pState->spectraIm[channel][pState->spectraPos * kPartitionBins];
+        for (int bin = 0; bin < kPartitionBins; ++bin) {
+            pSpectrumRe[bin] = static_cast<float>(m_fftRe[bin]);
+            pSpectrumIm[bin] = static_cast<float>(m_fftIm[bin]);
+        }
+
+        // The delay line always holds kMaxPartitions spectra, so it does not
+        // need to be cleared when the length of the impulse response changes
+        std::fill(m_fftRe.begin(), m_fftRe.begin() + kPartitionBins, 0.0);
+        std::fill(m_fftIm.begin(), m_fftIm.begin() + kPartitionBins, 0.0);
+        for (int partition = 0; partition < numPartitions; ++partition) {
+            const int pos = (pState->spectraPos + kMaxPartitions - partition) %
+                    kMaxPartitions;
+            convolutionMultiplyAccumulate(m_fftRe.data(),
+                    m_fftIm.data(),
+                    &pState->spectraRe[channel][pos * kPartitionBins],
+                    &pState->spectraIm[channel][pos * kPartitionBins],
+                    pImpulseResponse->partitionRe(channel, partition),
+                    pImpulseResponse->partitionIm(channel, partition),
+                    kPartitionBins);
+        }
+        m_pFft->inverse(m_fftRe.data(), m_fftIm.data(), m_fftOutput.data());
+
+        // Overlap-add
+        CSAMPLE* pOutput = pState->partitionOutput[channel].data();
+        CSAMPLE* pOverlap = pState->partitionOverlap[channel].data();
+        for (int i = 0; i < kPartitionFrames; ++i) {
+            pOutput[i] = static_cast<CSAMPLE>(m_fftOutput[i]) + pOverlap[i];
+            pOverlap[i] = static_cast<CSAMPLE>(m_fftOutput[kPartitionFrames + i]);
+        }
+    }
+    pState->spectraPos = (pState->spectraPos + 1) % kMaxPartitions;
+}
+
+void ConvolutionReverbEffect::processTailPartition(ConvolutionReverbGroupState* pState) {
+    // Hand the recorded partition over to the thread
+    pState->tailInputSeq.store(pState->tailSeq + 1, std::memory_order_release);
+    m_pThread->wake();
+    ++pState->tailSeq;
+
+    // The thread has had the duration of a whole partition to convolve the
+    // partition that was recorded before the previous one
+    if (pState->tailSeq < 2) {
+        return;
+    }
+    const quint64 seq = pState->tailSeq - 2;
+    const int slot = static_cast<int>(seq % kTailSlots);
+    if (seq >= pState->tailResetSeq.load(std::memory_order_relaxed) &&
+            pState->tailOutputSlotSeqs[slot].load(std::memory_order_acquire) == seq + 1) {
+        for (int channel = 0; channel < kChannels; ++channel) {
+            SampleUtil::copy(pState->tailOutput[channel].data(),
+                    pState->tailOutputSlots.data((slot * kChannels + channel) * kTailFrames),
+                    kTailFrames);
+        }
+        return;
+    }
+    for (int channel = 0; channel < kChannels; ++channel) {
+        pState->tailOutput[channel].clear();
+    }
+    if (seq >= pState->tailResetSeq.load(std::memory_order_relaxed)) {
+        // The tail is missing for the duration of this partition
+        m_lateTailCounter += 1;
+    }
+}
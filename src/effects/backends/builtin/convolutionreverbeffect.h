@@ -0,0 +1,144 @@
+#pragma once
+
+#include <QMap>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/builtin/convolutionimpulseresponse.h"
+#include "effects/backends/effectprocessor.h"
+#include "util/class.h"
+#include "util/counter.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+class ConvolutionReverbThread;
+class FFTReal;
+
+class ConvolutionReverbGroupState : public EffectState {
+  public:
+    /// The number of tail partitions that are exchanged with the thread
+    static constexpr int kTailSlots = 4;
+
+    ConvolutionReverbGroupState(const mixxx::EngineParameters& engineParameters,
+            std::shared_ptr<ConvolutionReverbThread> pThread);
+    ~ConvolutionReverbGroupState() override;
+
+    /// Called from the audio thread to start without a tail, e.g. when
+    /// the effect is enabled again
+    void reset();
+
+    // Accessed from the audio thread
+    CSAMPLE sendPrevious;
+    // The position in the current partition and tail partition
+    int partitionPos;
+    int tailPartitionPos;
+    // Twice the length of the head, so the window of the direct
+    // convolution is contiguous
+    mixxx::SampleBuffer headHistory[ConvolutionImpulseResponse::kChannels];
+    int headPos;
+    mixxx::SampleBuffer partitionInput[ConvolutionImpulseResponse::kChannels];
+    mixxx::SampleBuffer partitionOutput[ConvolutionImpulseResponse::kChannels];
+    mixxx::SampleBuffer partitionOverlap[ConvolutionImpulseResponse::kChannels];
+    // The frequency-domain delay line with the spectra of the previous inputs
+    std::vector<float> spectraRe[ConvolutionImpulseResponse::kChannels];
+    std::vector<float> spectraIm[ConvolutionImpulseResponse::kChannels];
+    int spectraPos;
+    // The output of the thread for the current tail partition
+    mixxx::SampleBuffer tailOutput[ConvolutionImpulseResponse::kChannels];
+    // The number of the current tail partition of the input
+    quint64 tailSeq;
+
+    // Written by the audio thread, read by ConvolutionReverbThread. Both
+    // are indexed by the number of the tail partition modulo kTailSlots
+    // and contain the channels one after another.
+    mixxx::SampleBuffer tailInputSlots;
+    std::atomic<quint64> tailInputSeq;
+    // The tail partitions before this one are not processed after a reset
+    std::atomic<quint64> tailResetSeq;
+    // Written by ConvolutionReverbThread, read by the audio thread. Each
+    // slot is published with the number of its tail partition + 1.
+    mixxx::SampleBuffer tailOutputSlots;
+    std::atomic<quint64> tailOutputSlotSeqs[kTailSlots];
+
+    // Only accessed from ConvolutionReverbThread
+    struct ThreadState {
+        ThreadState()
+                : spectraPos(0),
+                  processedSeq(0),
+                  resetSeq(0) {
+        }
+        std::vector<float> spectraRe[ConvolutionImpulseResponse::kChannels];
+        std::vector<float> spectraIm[ConvolutionImpulseResponse::kChannels];
+        std::vector<double> overlap[ConvolutionImpulseResponse::kChannels];
+        int spectraPos;
+        quint64 processedSeq;
+        quint64 resetSeq;
+    } thread;
+
+  private:
+    const std::shared_ptr<ConvolutionReverbThread> m_pThread;
+};
+
+/// Convolves the signal with the impulse response of a room.
+///
+/// The impulse response is synthesized, or decoded from one of the audio
+/// files in the impulse_responses folder of the settings directory, and
+/// partitioned in a ConvolutionReverbThread whenever the parameters change.
+/// The audio thread switches to the new impulse response once it has been
+/// published, so decoding never blocks the audio thread. The later
+/// partitions of long impulse responses are also convolved in this thread.
+/// So the CPU load of each callback is constant and independent of the
+/// length of the impulse response.
+class ConvolutionReverbEffect : public EffectProcessorImpl<ConvolutionReverbGroupState> {
+  public:
+    ConvolutionReverbEffect();
+    ~ConvolutionReverbEffect() override;
+
+    static QString getId();
+    static EffectManifestPointer getManifest();
+
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override;
+
+    void processChannel(
+            ConvolutionReverbGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+
+  private:
+    QString debugString() const {
+        return getId();
+    }
+
+    /// The states share the thread, which is only destroyed with the last state
+    ConvolutionReverbGroupState* createSpecificState(
+            const mixxx::EngineParameters& engineParameters) override;
+
+    void processPartition(ConvolutionReverbGroupState* pState,
+            const ConvolutionImpulseResponse* pImpulseResponse);
+    void processTailPartition(ConvolutionReverbGroupState* pState);
+
+    EngineEffectParameterPointer m_pDecayParameter;
+    EngineEffectParameterPointer m_pDampingParameter;
+    EngineEffectParameterPointer m_pSendParameter;
+    EngineEffectParameterPointer m_pImpulseResponseParameter;
+
+    const std::shared_ptr<ConvolutionReverbThread> m_pThread;
+
+    // The FFT and its buffers are shared by all states of the audio thread
+    std::unique_ptr<FFTReal> m_pFft;
+    std::vector<double> m_fftInput;
+    std::vector<double> m_fftRe;
+    std::vector<double> m_fftIm;
+    std::vector<double> m_fftOutput;
+
+    Counter m_lateTailCounter;
+
+    friend class ConvolutionReverbEffectTest;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionReverbEffect);
+};
@@ -0,0 +1,264 @@
+#include "effects/backends/builtin/convolutionreverbthread.h"
+
+#include <dsp/transforms/FFT.h>
+
+#include <QtDebug>
+#include <algorithm>
+
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+#include "moc_convolutionreverbthread.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/realtime.h"
+
+namespace {
+
+constexpr int kChannels = ConvolutionImpulseResponse::kChannels;
+constexpr int kTailFrames = ConvolutionImpulseResponse::kTailPartitionFrames;
+constexpr int kTailBins = ConvolutionImpulseResponse::kTailPartitionBins;
+constexpr int kTailSlots = ConvolutionReverbGroupState::kTailSlots;
+
+void clearHistory(ConvolutionReverbGroupState::ThreadState* pThreadState) {
+    for (int channel = 0; channel < kChannels; ++channel) {
+        std::fill(pThreadState->spectraRe[channel].begin(),
+                pThreadState->spectraRe[channel].end(),
+                0.0f);
+        std::fill(pThreadState->spectraIm[channel].begin(),
+                pThreadState->spectraIm[channel].end(),
+                0.0f);
+        pThreadState->overlap[channel].assign(kTailFrames, 0.0);
+    }
+    pThreadState->spectraPos = 0;
+}
+
+} // namespace
+
+ConvolutionReverbThread::ConvolutionReverbThread(QStringList impulseResponseFiles)
+        : m_impulseResponseFiles(std::move(impulseResponseFiles)),
+          m_stop(false),
+          m_requestedDecaySeconds(0.0),
+          m_requestedDamping(0.0),
+          m_requestedFile(0),
+          m_requestedSampleRate(0),
+          m_requestSeq(0),
+          m_createdSeq(0),
+          m_pLatestImpulseResponse(nullptr),
+          m_usedGeneration(0),
+          m_pFft(std::make_unique<FFTReal>(
+                  2 * ConvolutionImpulseResponse::kPartitionFrames)),
+          m_pTailFft(std::make_unique<FFTReal>(2 * kTailFrames)),
+          m_fftInput(2 * kTailFrames),
+          m_fftRe(2 * kTailFrames),
+          m_fftIm(2 * kTailFrames),
+          m_fftOutput(2 * kTailFrames) {
+    setObjectName(QStringLiteral("ConvolutionReverbThread"));
+    // The audio thread needs the tail a partition after it has been handed
+    // over. Without real-time scheduling, the tail might be late under load,
+    // which is counted and replaced by silence.
+    start(QThread::HighPriority);
+}
+
+ConvolutionReverbThread::~ConvolutionReverbThread() {
+    m_stop = true;
+    m_semaphore.release();
+    wait();
+}
+
+void ConvolutionReverbThread::addState(ConvolutionReverbGroupState* pState) {
+    const auto locker = lockMutex(&m_mutex);
+    m_states.append(pState);
+}
+
+void ConvolutionReverbThread::removeState(ConvolutionReverbGroupState* pState) {
+    // Waits until the state is no longer processed
+    const auto locker = lockMutex(&m_mutex);
+    m_states.removeAll(pState);
+}
+
+void ConvolutionReverbThread::requestImpulseResponse(double decaySeconds,
+        double damping,
+        int file,
+        mixxx::audio::SampleRate sampleRate) {
+    // Only written by the audio thread
+    if (m_requestSeq.load(std::memory_order_relaxed) > 0 &&
+            m_requestedDecaySeconds.load(std::memory_order_relaxed) == decaySeconds &&
+            m_requestedDamping.load(std::memory_order_relaxed) == damping &&
+            m_requestedFile.load(std::memory_order_relaxed) == file &&
+            m_requestedSampleRate.load(std::memory_order_relaxed) == sampleRate.value()) {
+        return;
+    }
+    m_requestedDecaySeconds.store(decaySeconds, std::memory_order_relaxed);
+    m_requestedDamping.store(damping, std::memory_order_relaxed);
+    m_requestedFile.store(file, std::memory_order_relaxed);
+    m_requestedSampleRate.store(sampleRate.value(), std::memory_order_relaxed);
+    m_requestSeq.fetch_add(1, std::memory_order_release);
+    wake();
+}
+
+const ConvolutionImpulseResponse* ConvolutionReverbThread::acquireImpulseResponse() {
+    const ConvolutionImpulseResponse* pImpulseResponse =
+            m_pLatestImpulseResponse.load(std::memory_order_acquire);
+    if (pImpulseResponse) {
+        // Allows deleting the older impulse responses
+        m_usedGeneration.store(pImpulseResponse->generation(), std::memory_order_release);
+    }
+    return pImpulseResponse;
+}
+
+void ConvolutionReverbThread::run() {
+    mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::EffectWorker);
+    while (true) {
+        m_semaphore.acquire();
+        if (m_stop) {
+            break;
+        }
+        updateImpulseResponse();
+        const auto locker = lockMutex(&m_mutex);
+        for (ConvolutionReverbGroupState* pState : std::as_const(m_states)) {
+            processTailPartitions(pState);
+        }
+    }
+}
+
+void ConvolutionReverbThread::updateImpulseResponse() {
+    const quint64 requestSeq = m_requestSeq.load(std::memory_order_acquire);
+    if (requestSeq != m_createdSeq) {
+        // Requests that arrive in the meantime are coalesced
+        m_createdSeq = requestSeq;
+        const auto sampleRate = mixxx::audio::SampleRate(
+                m_requestedSampleRate.load(std::memory_order_relaxed));
+        std::vector<float> samples[kChannels];
+        const int file = m_requestedFile.load(std::memory_order_relaxed);
+        if (file > 0 && file <= m_impulseResponseFiles.size()) {
+            // Decoding and resampling a file takes a while, but the audio
+            // thread keeps using the previous impulse response meanwhile
+            const QString& filePath = m_impulseResponseFiles.at(file - 1);
+            if (!ConvolutionImpulseResponse::load(samples, filePath, sampleRate)) {
+                qWarning() << "ConvolutionReverbThread: Failed to decode the impulse response"
+                           << filePath;
+            }
+        }
+        if (samples[0].empty()) {
+            ConvolutionImpulseResponse::synthesize(samples,
+                    m_requestedDecaySeconds.load(std::memory_order_relaxed),
+                    m_requestedDamping.load(std::memory_order_relaxed),
+                    sampleRate);
+        }
+        // The sequence number increases with each request
+        auto pImpulseResponse = ConvolutionImpulseResponse::create(
+                samples, sampleRate, requestSeq, m_pFft.get(), m_pTailFft.get());
+        m_pLatestImpulseResponse.store(pImpulseResponse.get(), std::memory_order_release);
+        m_impulseResponses.push_back(std::move(pImpulseResponse));
+    }
+
+    // The audio thread never goes back to an older impulse response
+    const quint64 usedGeneration = m_usedGeneration.load(std::memory_order_acquire);
+    m_impulseResponses.erase(
+            std::remove_if(m_impulseResponses.begin(),
+                    m_impulseResponses.end(),
+                    [usedGeneration](const auto& pImpulseResponse) {
+                        return pImpulseResponse->generation() < usedGeneration;
+                    }),
+            m_impulseResponses.end());
+}
+
+void ConvolutionReverbThread::processTailPartitions(ConvolutionReverbGroupState* pState) {
+    ConvolutionReverbGroupState::ThreadState* pThreadState = &pState->thread;
+    const quint64 inputSeq = pState->tailInputSeq.load(std::memory_order_acquire);
+    if (inputSeq > pThreadState->processedSeq + kTailSlots - 2) {
+        // The output of the missed partitions is too late and their input
+        // slots are about to be overwritten. Only process the latest one.
+        pThreadState->processedSeq = inputSeq - 1;
+        clearHistory(pThreadState);
+    }
+    while (pThreadState->processedSeq < inputSeq) {
+        processTailPartition(pState, pThreadState->processedSeq);
+        ++pThreadState->processedSeq;
+    }
+}
+
+void ConvolutionReverbThread::processTailPartition(
+        ConvolutionReverbGroupState* pState, quint64 seq) {
+    ConvolutionReverbGroupState::ThreadState* pThreadState = &pState->thread;
+    const ConvolutionImpulseResponse* pImpulseResponse =
+            m_pLatestImpulseResponse.load(std::memory_order_relaxed);
+    const int numPartitions = pImpulseResponse ? pImpulseResponse->numTailPartitions() : 0;
+
+    const auto historySize = static_cast<std::size_t>(numPartitions) * kTailBins;
+    bool clear = pThreadState->overlap[0].empty();
+    if (pThreadState->spectraRe[0].size() != historySize) {
+        // The length of the impulse response has changed
+        for (int channel = 0; channel < kChannels; ++channel) {
+            pThreadState->spectraRe[channel].resize(historySize);
+            pThreadState->spectraIm[channel].resize(historySize);
+        }
+        clear = true;
+    }
+    const quint64 resetSeq = pState->tailResetSeq.load(std::memory_order_acquire);
+    if (resetSeq != pThreadState->resetSeq && seq >= resetSeq) {
+        // The audio thread has been reset while this partition was recorded
+        pThreadState->resetSeq = resetSeq;
+        clear = true;
+    }
+    if (clear) {
+        clearHistory(pThreadState);
+    }
+
+    const int slot = static_cast<int>(seq % kTailSlots);
+    for (int channel = 0; channel < kChannels; ++channel) {
+        const CSAMPLE* pInput = pState->tailInputSlots.data(
+                (slot * kChannels + channel) * kTailFrames);
+        CSAMPLE* pOutput = pState->tailOutputSlots.data(
+                (slot * kChannels + channel) * kTailFrames);
+        std::vector<double>& overlap = pThreadState->overlap[channel];
+        if (numPartitions == 0) {
+            for (int i = 0; i < kTailFrames; ++i) {
+                pOutput[i] = static_cast<CSAMPLE>(overlap[i]);
+            }
+            std::fill(overlap.begin(), overlap.end(), 0.0);
+            continue;
+        }
+
+        // The second half is zero padding for the linear convolution
+        std::copy(pInput, pInput + kTailFrames, m_fftInput.begin());
+        std::fill(m_fftInput.begin() + kTailFrames, m_fftInput.end(), 0.0);
+        m_pTailFft->forward(m_fftInput.data(), m_fftRe.data(), m_fftIm.data());
+
+        float* pSpectrumRe = &pThreadState->spectraRe[channel][
+                pThreadState->spectraPos * kTailBins];
+        float* pSpectrumIm = &pThreadState->spectraIm[channel][
+                pThreadState->spectraPos * kTailBins];
+        for (int bin = 0; bin < kTailBins; ++bin) {
+            pSpectrumRe[bin] = static_cast<float>(m_fftRe[bin]);
+            pSpectrumIm[bin] = static_cast<float>(m_fftIm[bin]);
+        }
+
+        // Each partition of the impulse response is multiplied with the
+        // spectrum of the input that is delayed accordingly
+        std::fill(m_fftRe.begin(), m_fftRe.begin() + kTailBins, 0.0);
+        std::fill(m_fftIm.begin(), m_fftIm.begin() + kTailBins, 0.0);
+        for (int partition = 0; partition < numPartitions; ++partition) {
+            const int pos = (pThreadState->spectraPos + numPartitions - partition) %
+                    numPartitions;
+            convolutionMultiplyAccumulate(m_fftRe.data(),
+                    m_fftIm.data(),
+                    &pThreadState->spectraRe[channel][pos * kTailBins],
+                    &pThreadState->spectraIm[channel][pos * kTailBins],
+                    pImpulseResponse->tailPartitionRe(channel, partition),
+                    pImpulseResponse->tailPartitionIm(channel, partition),
+                    kTailBins);
+        }
+        m_pTailFft->inverse(m_fftRe.data(), m_fftIm.data(), m_fftOutput.data());
+
+        // Overlap-add
+        for (int i = 0; i < kTailFrames; ++i) {
+            pOutput[i] = static_cast<CSAMPLE>(m_fftOutput[i] + overlap[i]);
+            overlap[i] = m_fftOutput[kTailFrames + i];
+        }
+    }
+    if (numPartitions > 0) {
+        pThreadState->spectraPos = (pThreadState->spectraPos + 1) % numPartitions;
+    }
+    // Publishes the output of the slot
+    pState->tailOutputSlotSeqs[slot].store(seq + 1, std::memory_order_release);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QStringList>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "effects/backends/builtin/convolutionimpulseresponse.h"
+
+class ConvolutionReverbGroupState;
+class FFTReal;
+
+/// Executes the non-realtime work of a ConvolutionReverbEffect. Creates the
+/// impulse responses when the parameters change, either synthesized or
+/// decoded from a file, and convolves the tail partitions of all channel
+/// states.
+///
+/// The impulse responses are owned by the thread and published to the
+/// audio thread as a pointer. An impulse response is only deleted after the
+/// audio thread has started to use a newer one.
+class ConvolutionReverbThread : public QThread {
+    Q_OBJECT
+  public:
+    /// The impulse response files are selected by their index + 1
+    explicit ConvolutionReverbThread(QStringList impulseResponseFiles);
+    ~ConvolutionReverbThread() override;
+
+    /// Called from the main thread
+    void addState(ConvolutionReverbGroupState* pState);
+    /// Called from the main thread. The state is not accessed afterwards.
+    void removeState(ConvolutionReverbGroupState* pState);
+
+    /// Called from the audio thread. Requests a new impulse response if
+    /// the parameters differ from the latest request. The impulse response
+    /// is synthesized if file is 0 or if the file cannot be decoded.
+    void requestImpulseResponse(double decaySeconds,
+            double damping,
+            int file,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// Called from the audio thread. Returns the latest impulse response
+    /// or nullptr if none has been created yet. The impulse response is
+    /// valid until the next call.
+    const ConvolutionImpulseResponse* acquireImpulseResponse();
+
+    /// Called from the audio thread after a tail partition of a state is
+    /// complete
+    void wake() {
+        m_semaphore.release();
+    }
+
+  protected:
+    void run() override;
+
+  private:
+    void updateImpulseResponse();
+    void processTailPartitions(ConvolutionReverbGroupState* pState);
+    void processTailPartition(ConvolutionReverbGroupState* pState, quint64 seq);
+
+    const QStringList m_impulseResponseFiles;
+
+    QSemaphore m_semaphore;
+    std::atomic<bool> m_stop;
+
+    // The parameters of the requested impulse response
+    std::atomic<double> m_requestedDecaySeconds;
+    std::atomic<double> m_requestedDamping;
+    std::atomic<int> m_requestedFile;
+    std::atomic<mixxx::audio::SampleRate::value_t> m_requestedSampleRate;
+    std::atomic<quint64> m_requestSeq;
+    quint64 m_createdSeq;
+
+    // Only accessed from this thread, except the latest impulse response
+    std::vector<std::unique_ptr<ConvolutionImpulseResponse>> m_impulseResponses;
+    std::atomic<const ConvolutionImpulseResponse*> m_pLatestImpulseResponse;
+    // The generation of the impulse response that is used by the audio thread
+    std::atomic<quint64> m_usedGeneration;
+
+    std::unique_ptr<FFTReal> m_pFft;
+    std::unique_ptr<FFTReal> m_pTailFft;
+    std::vector<double> m_fftInput;
+    std::vector<double> m_fftRe;
+    std::vector<double> m_fftIm;
+    std::vector<double> m_fftOutput;
+
+    // Protects m_states, which are processed while it is locked
+    QMutex m_mutex;
+    QList<ConvolutionReverbGroupState*> m_states;
+};
@@ -1,7 +1,10 @@
 #include "effects/backends/builtin/distortioneffect.h"
 
+#include <algorithm>
+
 #include "effects/backends/effectmanifest.h"
 #include "engine/effects/engineeffectparameter.h"
+#include "util/defs.h"
 
 namespace {
 inline CSAMPLE tanh_approx(CSAMPLE input) {
@@ -26,6 +29,7 @@ EffectManifestPointer DistortionEffect::getManifest() {
             "A Distortion effect with several modes ranging from soft to hard "
             "clipping.");
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.1);
     pManifest->setMetaknobDefault(0.0);
 
     EffectManifestParameterPointer mode = pManifest->addParameter();
@@ -51,9 +55,27 @@ EffectManifestPointer DistortionEffect::getManifest() {
     drive->setNeutralPointOnScale(0);
     drive->setRange(0, 0, 1);
 
+    EffectManifestParameterPointer oversampling = pManifest->addParameter();
+    oversampling->setId("oversampling");
+    oversampling->setName(QObject::tr("Oversampling"));
+    oversampling->setShortName(QObject::tr("Oversample"));
+    oversampling->setDescription(QObject::tr(
+            "Distorts the audio signal at a multiple of the sample rate to "
+            "avoid aliasing, which adds a latency of less than a millisecond."));
+    oversampling->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    oversampling->setRange(0, 1, 2);
+    oversampling->appendStep(qMakePair(QObject::tr("Off"), 0));
+    oversampling->appendStep(qMakePair(QObject::tr("2x"), 1));
+    oversampling->appendStep(qMakePair(QObject::tr("4x"), 2));
+
     return pManifest;
 }
 
+DistortionEffect::DistortionEffect()
+        : m_oversampled(StereoOversampler::kMaxFactor * kMaxEngineSamples),
+          m_dry(kMaxEngineSamples) {
+}
+
 DistortionGroupState::DistortionGroupState(
         const mixxx::EngineParameters& engineParameters)
         : EffectState(engineParameters),
@@ -87,6 +109,15 @@ void DistortionEffect::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
     m_pMode = parameters.value("mode");
     m_pDrive = parameters.value("drive");
+    m_pOversampling = parameters.value("oversampling");
+}
+
+int DistortionEffect::oversamplingFactor() const {
+    return m_pOversampling ? 1 << std::clamp(m_pOversampling->toInt(), 0, 2) : 1;
+}
+
+SINT DistortionEffect::getGroupDelayFrames() {
+    return StereoOversampler::latencyFrames(oversamplingFactor());
 }
 
 void DistortionEffect::processChannel(
@@ -99,15 +130,14 @@ void DistortionEffect::processChannel(
     Q_UNUSED(groupFeatures);
     Q_UNUSED(enableState);
 
-    // TODO: anti-aliasing
-
-    SINT numSamples = engineParameters.samplesPerBuffer();
+    SINT numFrames = engineParameters.framesPerBuffer();
     CSAMPLE driveParam = static_cast<CSAMPLE>(m_pDrive->value());
+    pState->m_oversampler.setFactor(oversamplingFactor());
 
+    // The output is delayed like the processed signal, because the latency
+    // is reported independent of the drive
     if (driveParam < 0.01) {
-        if (pOutput != pInput) {
-            SampleUtil::copy(pOutput, pInput, numSamples);
-        }
+        pState->m_oversampler.delay(pOutput, pInput, numFrames);
         return;
     }
 
@@ -124,9 +154,7 @@ void DistortionEffect::processChannel(
 
     default:
         // We should never enter here, but we act as a noop effect just in case.
-        if (pOutput != pInput) {
-            SampleUtil::copy(pOutput, pInput, numSamples);
-        }
+        pState->m_oversampler.delay(pOutput, pInput, numFrames);
         return;
     }
 }
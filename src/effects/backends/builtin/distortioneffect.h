@@ -1,8 +1,10 @@
 #pragma once
 
 #include "effects/backends/effectprocessor.h"
+#include "engine/filters/stereooversampler.h"
 #include "util/class.h"
 #include "util/sample.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class DistortionGroupState : public EffectState {
@@ -16,11 +18,13 @@ class DistortionGroupState : public EffectState {
 
     CSAMPLE m_previousMakeUpGain;
     CSAMPLE m_previousNormalizationGain;
+
+    StereoOversampler m_oversampler;
 };
 
 class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
   public:
-    DistortionEffect() = default;
+    DistortionEffect();
     ~DistortionEffect() override = default;
 
     static QString getId();
@@ -37,12 +41,16 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT getGroupDelayFrames() override;
+
   private:
     enum Mode {
         SoftClipping = 0,
         HardClipping = 1,
     };
 
+    int oversamplingFactor() const;
+
     struct SoftClippingParameters;
     struct HardClippingParameters;
 
@@ -53,31 +61,38 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
             const CSAMPLE* pInput,
             const mixxx::EngineParameters& engineParameters) {
         SINT numSamples = engineParameters.samplesPerBuffer();
+        SINT numFrames = engineParameters.framesPerBuffer();
+        StereoOversampler& oversampler = pState->m_oversampler;
+
+        // The input is read before the output is written, they might be the
+        // same buffer
+        CSAMPLE* pOversampled = m_oversampled.data();
+        oversampler.upsample(pOversampled, pInput, numFrames);
+        // The dry signal, aligned with the downsampled output
+        CSAMPLE* pDry = m_dry.data();
+        oversampler.delay(pDry, pInput, numFrames);
 
         // Normalize input
         pState->m_previousNormalizationGain =
                 SampleUtil::copyWithRampingNormalization(pOutput,
-                        pInput,
+                        pDry,
                         pState->m_previousNormalizationGain,
                         ModeParams::normalizationLevel,
                         numSamples);
 
-        // Apply drive gain
+        // Apply drive gain and waveshape at the oversampled rate, so the
+        // created harmonics are removed instead of aliased
+        const SINT numOversampledSamples = numSamples * oversampler.factor();
         CSAMPLE_GAIN driveGain = 1 + driveParam * ModeParams::maxDriveGain;
-        SampleUtil::copyWithRampingGain(
-                pOutput, pInput, pState->m_driveGain, driveGain, numSamples);
-
-        // Waveshape
-        for (SINT i = 0;
-                i < engineParameters.samplesPerBuffer();
-                i += engineParameters.channelCount()) {
-            for (int channel = 0; channel < engineParameters.channelCount(); ++channel) {
-                pOutput[i + channel] = ModeParams::process(pOutput[i + channel]);
-            }
+        SampleUtil::applyRampingGain(
+                pOversampled, pState->m_driveGain, driveGain, numOversampledSamples);
+        for (SINT i = 0; i < numOversampledSamples; ++i) {
+            pOversampled[i] = ModeParams::process(pOversampled[i]);
         }
+        oversampler.downsample(pOutput, pOversampled, numFrames);
 
         // Volume compensation
-        CSAMPLE pInputRMS = SampleUtil::rms(pInput, numSamples);
+        CSAMPLE pInputRMS = SampleUtil::rms(pDry, numSamples);
         CSAMPLE pOutputRMS = SampleUtil::rms(pOutput, numSamples);
         CSAMPLE_GAIN gain = pOutputRMS == CSAMPLE_ZERO
                 ? 1
@@ -97,7 +112,7 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
                 crossfadeParam,
                 numSamples);
         SampleUtil::addWithRampingGain(pOutput,
-                pInput,
+                pDry,
                 1 - pState->m_crossfadeParameter,
                 1 - crossfadeParam,
                 numSamples);
@@ -112,6 +127,11 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
 
     EngineEffectParameterPointer m_pMode;
     EngineEffectParameterPointer m_pDrive;
+    EngineEffectParameterPointer m_pOversampling;
+
+    // Shared by all states, which are processed one after another
+    mixxx::SampleBuffer m_oversampled;
+    mixxx::SampleBuffer m_dry;
 
     DISALLOW_COPY_AND_ASSIGN(DistortionEffect);
 };
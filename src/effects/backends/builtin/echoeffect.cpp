@@ -31,6 +31,8 @@ EffectManifestPointer EchoEffect::getManifest() {
 
     pManifest->setAddDryToWet(true);
     pManifest->setEffectRampsFromDry(true);
+    // The feedback may keep the echoes audible indefinitely
+    pManifest->setTailLengthSeconds(EffectManifest::kUnboundedTailLength);
 
     pManifest->setId(getId());
     pManifest->setName(QObject::tr("Echo"));
@@ -153,9 +155,18 @@ void EchoEffect::processChannel(
     }
 
     int delay_samples = delay_frames * engineParameters.channelCount();
-    VERIFY_OR_DEBUG_ASSERT(delay_samples <= pGroupState->delay_buf.size()) {
-        delay_samples = pGroupState->delay_buf.size();
+    const int max_delay_samples = EchoGroupState::kMaxDelaySeconds *
+            engineParameters.sampleRate() * engineParameters.channelCount();
+    VERIFY_OR_DEBUG_ASSERT(delay_samples <= max_delay_samples) {
+        delay_samples = max_delay_samples;
     }
+    // Until a larger buffer is available, the delay is limited to the current
+    // size and the previous delay is adjusted to the possibly moved write position
+    const SINT delay_buf_size = pGroupState->delay_buf.reserve(
+            delay_samples, &pGroupState->write_position);
+    delay_samples = std::min(delay_samples, static_cast<int>(delay_buf_size));
+    pGroupState->prev_delay_samples = std::min(
+            pGroupState->prev_delay_samples, static_cast<int>(delay_buf_size));
 
     int prev_read_position = pGroupState->write_position;
     decrementRing(&prev_read_position,
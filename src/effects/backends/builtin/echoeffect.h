@@ -5,27 +5,26 @@
 #include "effects/backends/effectprocessor.h"
 #include "engine/engine.h"
 #include "util/class.h"
-#include "util/samplebuffer.h"
+#include "util/delaybufferpool.h"
 
 class EchoGroupState : public EffectState {
   public:
     // 3 seconds max. This supports the full range of 2 beats for tempos down to
     // 40 BPM.
     static constexpr int kMaxDelaySeconds = 3;
+    // Enough for the default delay of half a beat down to 60 BPM. The buffer
+    // grows when a longer delay is set.
+    static constexpr double kInitialDelaySeconds = 0.5;
 
     EchoGroupState(const mixxx::EngineParameters& engineParameters)
-            : EffectState(engineParameters) {
-        audioParametersChanged(engineParameters);
+            : EffectState(engineParameters),
+              delay_buf(static_cast<SINT>(kInitialDelaySeconds *
+                      engineParameters.sampleRate() *
+                      engineParameters.channelCount())) {
         clear();
     }
     ~EchoGroupState() override = default;
 
-    void audioParametersChanged(const mixxx::EngineParameters& engineParameters) {
-        delay_buf = mixxx::SampleBuffer(kMaxDelaySeconds *
-                engineParameters.sampleRate() *
-                engineParameters.channelCount());
-    };
-
     void clear() {
         delay_buf.clear();
         prev_send = 0.0f;
@@ -35,7 +34,7 @@ class EchoGroupState : public EffectState {
         ping_pong = 0;
     };
 
-    mixxx::SampleBuffer delay_buf;
+    DelayBuffer delay_buf;
     CSAMPLE_GAIN prev_send;
     CSAMPLE_GAIN prev_feedback;
     int prev_delay_samples;
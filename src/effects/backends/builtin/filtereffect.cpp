@@ -26,6 +26,7 @@ EffectManifestPointer FilterEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "Allows only high or low frequencies to play."));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setMetaknobDefault(0.5);
 
     EffectManifestParameterPointer lpf = pManifest->addParameter();
@@ -70,7 +71,8 @@ FilterGroupState::FilterGroupState(const mixxx::EngineParameters& engineParamete
         : EffectState(engineParameters),
           m_loFreq(kMaxCorner),
           m_q(0.707106781),
-          m_hiFreq(kMinCorner) {
+          m_hiFreq(kMinCorner),
+          m_clampedQ(m_q) {
     m_buffer = mixxx::SampleBuffer(engineParameters.samplesPerBuffer());
     m_pLowFilter = new EngineFilterBiquad1Low(engineParameters.sampleRate(), m_loFreq, m_q, true);
     m_pHighFilter = new EngineFilterBiquad1High(engineParameters.sampleRate(), m_hiFreq, m_q, true);
@@ -128,8 +130,22 @@ void FilterEffect::processChannel(
             double qmax = 4 - 2 / 0.6 * ratio;
             clampedQ = math_min(clampedQ, qmax);
         }
-        pState->m_pLowFilter->setFrequencyCorners(engineParameters.sampleRate(), lpf, clampedQ);
-        pState->m_pHighFilter->setFrequencyCorners(engineParameters.sampleRate(), hpf, clampedQ);
+        // Only redesign the filters whose corner or resonance have changed,
+        // and not the resonance of a filter that stays disabled. Each new
+        // design is crossfaded with the old one, which processes the
+        // filter twice during the next buffer.
+        const bool qChanged = clampedQ != pState->m_clampedQ;
+        if (lpf != pState->m_loFreq ||
+                (qChanged && (lpf < kMaxCorner || pState->m_loFreq < kMaxCorner))) {
+            pState->m_pLowFilter->setFrequencyCorners(
+                    engineParameters.sampleRate(), lpf, clampedQ);
+        }
+        if (hpf != pState->m_hiFreq ||
+                (qChanged && (hpf > kMinCorner || pState->m_hiFreq > kMinCorner))) {
+            pState->m_pHighFilter->setFrequencyCorners(
+                    engineParameters.sampleRate(), hpf, clampedQ);
+        }
+        pState->m_clampedQ = clampedQ;
     }
 
     const CSAMPLE* pLpfInput = pState->m_buffer.data();
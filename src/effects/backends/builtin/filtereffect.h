@@ -21,6 +21,8 @@ struct FilterGroupState : public EffectState {
     double m_loFreq;
     double m_q;
     double m_hiFreq;
+    // The resonance that the filters have been designed with
+    double m_clampedQ;
 };
 
 class FilterEffect : public EffectProcessorImpl<FilterGroupState> {
@@ -25,6 +25,7 @@ EffectManifestPointer GraphicEQEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "An 8-band graphic equalizer based on biquad filters"));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setIsMainEQ(true);
 
     // Display rounded center frequencies for each filter
@@ -30,6 +30,7 @@ EffectManifestPointer LinkwitzRiley8EQEffect::getManifest() {
                         "crossover, constant phase shift, roll-off -48 "
                         "dB/octave).") +
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setIsMixingEQ(true);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
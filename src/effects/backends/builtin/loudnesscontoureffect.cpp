@@ -34,6 +34,7 @@ EffectManifestPointer LoudnessContourEffect::getManifest() {
             "Amplifies low and high frequencies at low volumes to compensate "
             "for reduced sensitivity of the human ear."));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setMetaknobDefault(1.0);
 
     EffectManifestParameterPointer loudness = pManifest->addParameter();
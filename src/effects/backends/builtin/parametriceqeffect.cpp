@@ -26,6 +26,7 @@ EffectManifestPointer ParametricEQEffect::getManifest() {
             "A gentle 2-band parametric equalizer based on biquad filters.\n"
             "It is designed as a complement to the steep mixing equalizers."));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setIsMainEQ(true);
 
     EffectManifestParameterPointer gain1 = pManifest->addParameter();
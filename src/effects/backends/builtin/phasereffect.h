@@ -2,6 +2,7 @@
 
 #include "effects/backends/effectprocessor.h"
 #include "util/class.h"
+#include "util/rampingvalue.h"
 #include "util/sample.h"
 #include "util/types.h"
 
@@ -10,7 +11,8 @@
 class PhaserGroupState final : public EffectState {
   public:
     PhaserGroupState(const mixxx::EngineParameters& engineParameters)
-            : EffectState(engineParameters) {
+            : EffectState(engineParameters),
+              depth(0) {
         clear();
     }
     ~PhaserGroupState() override = default;
@@ -18,7 +20,7 @@ class PhaserGroupState final : public EffectState {
     void clear() {
         leftPhase = 0;
         rightPhase = 0;
-        oldDepth = 0;
+        depth.reset(0);
         SampleUtil::clear(oldInLeft, MAXSTAGES);
         SampleUtil::clear(oldOutLeft, MAXSTAGES);
         SampleUtil::clear(oldInRight, MAXSTAGES);
@@ -31,7 +33,7 @@ class PhaserGroupState final : public EffectState {
     CSAMPLE oldOutRight[MAXSTAGES];
     CSAMPLE leftPhase;
     CSAMPLE rightPhase;
-    CSAMPLE_GAIN oldDepth;
+    SmoothedValue<CSAMPLE_GAIN> depth;
 };
 
 class PhaserEffect : public EffectProcessorImpl<PhaserGroupState> {
@@ -14,6 +14,8 @@ EffectManifestPointer ReverbEffect::getManifest() {
     EffectManifestPointer pManifest(new EffectManifest());
     pManifest->setAddDryToWet(true);
     pManifest->setEffectRampsFromDry(true);
+    // The decay may keep the reverb audible indefinitely
+    pManifest->setTailLengthSeconds(EffectManifest::kUnboundedTailLength);
 
     pManifest->setId(getId());
     pManifest->setName(QObject::tr("Reverb"));
@@ -63,6 +63,7 @@ EffectManifestPointer ThreeBandBiquadEQEffect::getManifest() {
                         "shelving high pass and kill switches.") +
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(1.0);
     pManifest->setIsMixingEQ(true);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), true);
@@ -20,6 +20,7 @@ EffectManifestPointer TremoloEffect::getManifest() {
     pManifest->setVersion("1.0");
     pManifest->setDescription(QObject::tr(
             "Cycles the volume up and down"));
+    pManifest->setTailLengthSeconds(0.1);
 
     EffectManifestParameterPointer depth = pManifest->addParameter();
     depth->setId("depth");
@@ -23,13 +23,18 @@
 /// the no-argument constructor be non-explicit.
 class EffectManifest {
   public:
+    /// The default tail length of effects that may produce sound from a
+    /// silent input indefinitely or whose tail length is unknown
+    static constexpr double kUnboundedTailLength = -1.0;
+
     EffectManifest()
             : m_backendType(EffectBackendType::Unknown),
               m_isMixingEQ(false),
               m_isMainEQ(false),
               m_effectRampsFromDry(false),
               m_bAddDryToWet(false),
-              m_metaknobDefault(0.0) {
+              m_metaknobDefault(0.0),
+              m_tailLengthSeconds(kUnboundedTailLength) {
     }
 
     /// Hack to store unique IDs in QComboBox models
@@ -154,6 +159,19 @@ class EffectManifest {
         m_metaknobDefault = metaknobDefault;
     }
 
+    /// The time after the input became silent until the output of the
+    /// effect is silent as well, for any values of the parameters. The
+    /// effect is not processed while its input has been silent for longer.
+    bool hasBoundedTailLength() const {
+        return m_tailLengthSeconds >= 0.0;
+    }
+    double tailLengthSeconds() const {
+        return m_tailLengthSeconds;
+    }
+    void setTailLengthSeconds(double tailLengthSeconds) {
+        m_tailLengthSeconds = tailLengthSeconds;
+    }
+
     bool operator==(const EffectManifest& other) const {
         return other.id() == m_id && other.backendType() == m_backendType;
     }
@@ -187,4 +205,5 @@ class EffectManifest {
     bool m_effectRampsFromDry;
     bool m_bAddDryToWet;
     double m_metaknobDefault;
+    double m_tailLengthSeconds;
 };
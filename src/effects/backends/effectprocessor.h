@@ -45,8 +45,11 @@
 ///
 /// EffectStates allocated on the main thread are passed as pointers to the
 /// EffectProcessorImpl in the audio callback thread via the EffectsMessenger.
-/// EffectStates are allocated and deallocated when a routing switch for an
-/// EffectChain is toggled and when a new EngineEffect is loaded into an EffectSlot.
+/// EffectStates are allocated when a routing switch for an EffectChain is
+/// toggled on and when a new EngineEffect is loaded into an EffectSlot. They
+/// are deallocated on the main thread some time after the routing switch has
+/// been toggled off, once the audio thread has confirmed that the chain is no
+/// longer processed for the input signal, see EffectChain.
 /// This allows for scaling up to an arbitrary number of input signals
 /// without wasting a lot of memory. (EffectStates could be (de)allocated when toggling
 /// the enable switches for EffectSlots as well, but the memory savings would be
@@ -79,6 +82,11 @@ class EffectProcessor {
     virtual void loadEngineEffectParameters(
             const QMap<QString, EngineEffectParameterPointer>& parameters) = 0;
     virtual bool hasStatesForInputChannel(ChannelHandle inputChannel) const = 0;
+    /// Deletes the states of the input channel. Must only be called while
+    /// the audio thread doesn't process the input channel.
+    virtual void releaseInputChannel(ChannelHandle inputChannel) = 0;
+    /// The number of allocated states for all input channels
+    virtual int numStates() const = 0;
 
     /// Called from the audio thread
     /// This method takes a buffer of audio samples as pInput, processes the buffer
@@ -233,6 +241,31 @@ class EffectProcessorImpl : public EffectProcessor {
         return false;
     }
 
+    void releaseInputChannel(ChannelHandle inputChannel) final {
+        if (inputChannel.handle() >= m_channelStateMatrix.size()) {
+            return;
+        }
+        if (kEffectDebugOutput) {
+            qDebug() << this << "EffectProcessorImpl::releaseInputChannel "
+                                "deleting EffectStates for input"
+                     << inputChannel;
+        }
+        // Leaves an empty vector as expected by initializeInputChannel()
+        m_channelStateMatrix[inputChannel].clear();
+    }
+
+    int numStates() const final {
+        int count = 0;
+        for (const auto& outputChannelStates : m_channelStateMatrix) {
+            for (const auto& pState : outputChannelStates) {
+                if (pState) {
+                    ++count;
+                }
+            }
+        }
+        return count;
+    }
+
   protected:
     /// Subclasses for external effects plugins may reimplement this, but
     /// subclasses for built-in effects should not.
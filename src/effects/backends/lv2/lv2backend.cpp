@@ -5,7 +5,9 @@
 #include "effects/backends/lv2/lv2effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
 
-LV2Backend::LV2Backend() {
+LV2Backend::LV2Backend()
+        : m_pWorkerThread(std::make_shared<LV2WorkerThread>()),
+          m_pUridMap(std::make_shared<LV2UridMap>()) {
     m_pWorld = lilv_world_new();
     initializeProperties();
     lilv_world_load_all(m_pWorld);
@@ -92,7 +94,8 @@ std::unique_ptr<EffectProcessor> LV2Backend::createProcessor(
     VERIFY_OR_DEBUG_ASSERT(pLV2Manifest) {
         return nullptr;
     }
-    return std::make_unique<LV2EffectProcessor>(pLV2Manifest);
+    return std::make_unique<LV2EffectProcessor>(
+            pLV2Manifest, m_pWorkerThread, m_pUridMap);
 }
 
 LV2EffectManifestPointer LV2Backend::getLV2Manifest(const QString& effectId) const {
@@ -2,8 +2,12 @@
 
 #include <lilv/lilv.h>
 
+#include <memory>
+
 #include "effects/backends/effectsbackend.h"
 #include "effects/backends/lv2/lv2manifest.h"
+#include "effects/backends/lv2/lv2uridmap.h"
+#include "effects/backends/lv2/lv2worker.h"
 #include "effects/defs.h"
 
 /// Refer to EffectsBackend for documentation
@@ -31,6 +35,9 @@ class LV2Backend : public EffectsBackend {
     LilvWorld* m_pWorld;
     QHash<QString, LilvNode*> m_properties;
     QHash<QString, LV2EffectManifestPointer> m_registeredEffects;
+    // Shared by all processors, the processors might outlive the backend
+    const std::shared_ptr<LV2WorkerThread> m_pWorkerThread;
+    const std::shared_ptr<LV2UridMap> m_pUridMap;
 
     QString debugString() const {
         return "LV2Backend";
@@ -1,14 +1,103 @@
 #include "effects/backends/lv2/lv2effectprocessor.h"
 
+#include <utility>
+
 #include "engine/effects/engineeffectparameter.h"
+#include "util/cmdlineargs.h"
 #include "util/defs.h"
+#include "util/sample.h"
+
+namespace {
+
+// A plugin that occasionally takes longer than a buffer, e.g. while
+// allocating memory, should not be bypassed immediately
+constexpr int kMaxConsecutiveOverruns = 8;
+
+} // namespace
+
+LV2EffectGroupState::~LV2EffectGroupState() {
+    if (m_pInstance && m_bypassed) {
+        qWarning() << "LV2 plugin" << lilv_instance_get_uri(m_pInstance)
+                   << "has been bypassed, because it exceeded the time "
+                      "budget of the audio thread";
+    }
+    // Stop the workers before the instances are freed. This also waits for
+    // a pending reset.
+    m_pWorker->stop();
+    m_pSpareWorker->stop();
+    for (LilvInstance* pInstance : {m_pInstance, m_pSpareInstance}) {
+        if (pInstance) {
+            lilv_instance_deactivate(pInstance);
+            lilv_instance_free(pInstance);
+        }
+    }
+}
+
+LilvInstance* LV2EffectGroupState::instantiate(const LilvPlugin* pPlugin,
+        const mixxx::EngineParameters& engineParameters,
+        const LV2UridMap& uridMap) {
+    DEBUG_ASSERT(!m_pInstance);
+    // Each instance schedules its work with its own worker
+    const LV2_Feature* features[] = {
+            m_pWorker->feature(),
+            uridMap.feature(),
+            nullptr};
+    m_pInstance = lilv_plugin_instantiate(
+            pPlugin, engineParameters.sampleRate(), features);
+    if (!m_pInstance) {
+        return nullptr;
+    }
+    const LV2_Feature* spareFeatures[] = {
+            m_pSpareWorker->feature(),
+            uridMap.feature(),
+            nullptr};
+    m_pSpareInstance = lilv_plugin_instantiate(
+            pPlugin, engineParameters.sampleRate(), spareFeatures);
+    return m_pInstance;
+}
+
+void LV2EffectGroupState::startWorkers() {
+    m_pWorker->setInstance(m_pInstance);
+    if (m_pSpareInstance) {
+        m_pSpareWorker->setInstance(m_pSpareInstance);
+    }
+}
+
+void LV2EffectGroupState::swapInstances() {
+    if (!m_pSpareInstance || m_pSpareWorker->isResetPending()) {
+        return;
+    }
+    std::swap(m_pInstance, m_pSpareInstance);
+    std::swap(m_pWorker, m_pSpareWorker);
+    m_pSpareWorker->requestReset();
+}
 
-LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest)
+bool LV2EffectGroupState::reportRunTime(bool overrun) {
+    if (!overrun) {
+        m_overruns = 0;
+        return false;
+    }
+    if (++m_overruns < kMaxConsecutiveOverruns) {
+        return false;
+    }
+    m_bypassed.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest,
+        std::shared_ptr<LV2WorkerThread> pWorkerThread,
+        std::shared_ptr<LV2UridMap> pUridMap)
         : m_pManifest(pManifest),
+          m_pWorkerThread(std::move(pWorkerThread)),
+          m_pUridMap(std::move(pUridMap)),
           m_LV2parameters(nullptr),
           m_pPlugin(pManifest->getPlugin()),
           m_audioPortIndices(pManifest->getAudioPortIndices()),
-          m_controlPortIndices(pManifest->getControlPortIndices()) {
+          m_controlPortIndices(pManifest->getControlPortIndices()),
+          m_reportRunTime(CmdlineArgs::Instance().getDeveloper()),
+          m_runTimer(QStringLiteral("LV2EffectProcessor::run ") + pManifest->id()),
+          m_bypassCounter(QStringLiteral("LV2EffectProcessor bypassed ") +
+                  pManifest->id()) {
     m_inputL = new float[kMaxEngineSamples];
     m_inputR = new float[kMaxEngineSamples];
     m_outputL = new float[kMaxEngineSamples];
@@ -48,6 +137,17 @@ void LV2EffectProcessor::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
+    if (enableState == EffectEnableState::Enabling) {
+        channelState->swapInstances();
+    }
+    LilvInstance* instance = channelState->lilvInstance();
+    if (!instance || channelState->isBypassed()) {
+        if (pOutput != pInput) {
+            SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+        }
+        return;
+    }
+
     for (int i = 0; i < m_engineEffectParameters.size(); i++) {
         m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
     }
@@ -59,13 +159,14 @@ void LV2EffectProcessor::processChannel(
         m_inputR[i] = pInput[i * 2 + 1];
     }
 
-    LilvInstance* instance = channelState->lilvInstance(m_pPlugin, engineParameters);
-
-    if (enableState == EffectEnableState::Enabling) {
-        lilv_instance_activate(instance);
-    }
-
+    // The plugin has been activated when the state was created. Activating
+    // it here would not be realtime safe, plugins reset their internal
+    // state when being activated and might allocate memory. The spare
+    // instance is reset by the worker thread instead.
+    m_runTimer.start();
     lilv_instance_run(instance, framesPerBuffer);
+    channelState->worker()->deliverResponses();
+    const mixxx::Duration runTime = m_runTimer.elapsed(m_reportRunTime);
 
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < framesPerBuffer; ++i) {
@@ -73,15 +174,19 @@ void LV2EffectProcessor::processChannel(
         pOutput[i * 2 + 1] = m_outputR[i];
     }
 
-    if (enableState == EffectEnableState::Disabling) {
-        lilv_instance_deactivate(instance);
+    const auto bufferDuration = mixxx::Duration::fromSeconds(
+            static_cast<double>(framesPerBuffer) / engineParameters.sampleRate());
+    if (channelState->reportRunTime(runTime > bufferDuration)) {
+        m_bypassCounter += 1;
     }
 }
 
 LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         const mixxx::EngineParameters& engineParameters) {
-    LV2EffectGroupState* pState = new LV2EffectGroupState(engineParameters);
-    LilvInstance* pInstance = pState->lilvInstance(m_pPlugin, engineParameters);
+    LV2EffectGroupState* pState = new LV2EffectGroupState(
+            engineParameters, m_pWorkerThread);
+    LilvInstance* pInstance = pState->instantiate(
+            m_pPlugin, engineParameters, *m_pUridMap);
     VERIFY_OR_DEBUG_ASSERT(pInstance) {
         return pState;
     }
@@ -90,20 +195,29 @@ LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         qDebug() << this << "LV2EffectProcessor creating LV2EffectGroupState" << pState;
     }
 
-    if (pInstance) {
+    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+        m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
+    }
+    // Both instances are connected to the same buffers
+    for (LilvInstance* pConnectedInstance : {pInstance, pState->spareLilvInstance()}) {
+        if (!pConnectedInstance) {
+            continue;
+        }
         for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-            m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
-            lilv_instance_connect_port(pInstance,
+            lilv_instance_connect_port(pConnectedInstance,
                     m_controlPortIndices[i],
                     &m_LV2parameters[i]);
         }
 
         // We assume the audio ports are in the following order:
         // input_left, input_right, output_left, output_right
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[0], m_inputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[1], m_inputR);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[2], m_outputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[3], m_outputR);
+        lilv_instance_connect_port(pConnectedInstance, m_audioPortIndices[0], m_inputL);
+        lilv_instance_connect_port(pConnectedInstance, m_audioPortIndices[1], m_inputR);
+        lilv_instance_connect_port(pConnectedInstance, m_audioPortIndices[2], m_outputL);
+        lilv_instance_connect_port(pConnectedInstance, m_audioPortIndices[3], m_outputR);
+
+        lilv_instance_activate(pConnectedInstance);
     }
+    pState->startWorkers();
     return pState;
 };
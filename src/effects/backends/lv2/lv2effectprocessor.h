@@ -2,42 +2,91 @@
 
 #include <lilv/lilv.h>
 
+#include <atomic>
+#include <memory>
+
 #include "effects/backends/effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
+#include "effects/backends/lv2/lv2uridmap.h"
+#include "effects/backends/lv2/lv2worker.h"
 #include "effects/defs.h"
 #include "engine/engine.h"
+#include "util/counter.h"
+#include "util/timer.h"
 
 // Refer to EffectProcessor for documentation
 class LV2EffectGroupState final : public EffectState {
   public:
-    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters)
+    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters,
+            const std::shared_ptr<LV2WorkerThread>& pWorkerThread)
             : EffectState(engineParameters),
-              m_pInstance(nullptr) {
+              m_pInstance(nullptr),
+              m_pSpareInstance(nullptr),
+              m_pWorker(std::make_unique<LV2Worker>(pWorkerThread)),
+              m_pSpareWorker(std::make_unique<LV2Worker>(pWorkerThread)),
+              m_overruns(0),
+              m_bypassed(false) {
     }
 
-    ~LV2EffectGroupState() override {
-        if (m_pInstance) {
-            lilv_instance_deactivate(m_pInstance);
-            lilv_instance_free(m_pInstance);
-        }
-    }
+    ~LV2EffectGroupState() override;
+
+    /// Instantiates the plugin twice, one instance is run and the other one
+    /// is kept as a spare with a clean state. Called from the main thread,
+    /// because plugins may allocate memory or do other non-realtime safe
+    /// operations when being instantiated and activated. Returns the
+    /// instance that is run, the spare may be missing.
+    LilvInstance* instantiate(const LilvPlugin* pPlugin,
+            const mixxx::EngineParameters& engineParameters,
+            const LV2UridMap& uridMap);
 
-    LilvInstance* lilvInstance(const LilvPlugin* pPlugin,
-            const mixxx::EngineParameters& engineParameters) {
-        if (!m_pInstance) {
-            m_pInstance = lilv_plugin_instantiate(
-                    pPlugin, engineParameters.sampleRate(), nullptr);
-        }
+    /// Connects the workers after the ports have been connected and the
+    /// instances have been activated
+    void startWorkers();
+
+    LilvInstance* lilvInstance() const {
         return m_pInstance;
     }
 
+    LilvInstance* spareLilvInstance() const {
+        return m_pSpareInstance;
+    }
+
+    LV2Worker* worker() {
+        return m_pWorker.get();
+    }
+
+    /// Called from the audio thread when the effect is enabled. Replaces the
+    /// instance that has been run before with the spare, so the plugin
+    /// starts without the state from the last time it was enabled, e.g. the
+    /// tail of a reverb. The replaced instance is reset by the worker
+    /// thread and becomes the next spare. Keeps the instance if the spare
+    /// is missing or has not been reset yet.
+    void swapInstances();
+
+    bool isBypassed() const {
+        return m_bypassed.load(std::memory_order_relaxed);
+    }
+
+    /// Bypasses the plugin after it exceeded the time budget of the audio
+    /// thread for several consecutive buffers. Returns true if the plugin
+    /// has just been bypassed.
+    bool reportRunTime(bool overrun);
+
   private:
+    // Only swapped by the audio thread
     LilvInstance* m_pInstance;
+    LilvInstance* m_pSpareInstance;
+    std::unique_ptr<LV2Worker> m_pWorker;
+    std::unique_ptr<LV2Worker> m_pSpareWorker;
+    int m_overruns;
+    std::atomic<bool> m_bypassed;
 };
 
 class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState> {
   public:
-    LV2EffectProcessor(LV2EffectManifestPointer pManifest);
+    LV2EffectProcessor(LV2EffectManifestPointer pManifest,
+            std::shared_ptr<LV2WorkerThread> pWorkerThread,
+            std::shared_ptr<LV2UridMap> pUridMap);
     ~LV2EffectProcessor() override;
 
     void loadEngineEffectParameters(
@@ -56,6 +105,8 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
             const mixxx::EngineParameters& engineParameters) override;
 
     LV2EffectManifestPointer m_pManifest;
+    const std::shared_ptr<LV2WorkerThread> m_pWorkerThread;
+    const std::shared_ptr<LV2UridMap> m_pUridMap;
     QList<EngineEffectParameterPointer> m_engineEffectParameters;
     float* m_inputL;
     float* m_inputR;
@@ -65,4 +116,7 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
     const LilvPlugin* m_pPlugin;
     const QList<int> m_audioPortIndices;
     const QList<int> m_controlPortIndices;
+    const bool m_reportRunTime;
+    Timer m_runTimer;
+    Counter m_bypassCounter;
 };
@@ -1,5 +1,8 @@
 #include "effects/backends/lv2/lv2manifest.h"
 
+#include <lv2/urid/urid.h>
+#include <lv2/worker/worker.h>
+
 #include "effects/backends/effectmanifestparameter.h"
 #include "util/fpclassify.h"
 
@@ -180,10 +183,14 @@ LV2Manifest::LV2Manifest(LilvWorld* world,
         m_status = IO_NOT_STEREO;
     }
 
-    // We don't support any features
+    // We only support the features that are provided by LV2EffectProcessor
     LilvNodes* features = lilv_plugin_get_required_features(m_pLV2plugin);
-    if (lilv_nodes_size(features) > 0) {
-        m_status = HAS_REQUIRED_FEATURES;
+    LILV_FOREACH(nodes, it, features) {
+        const char* uri = lilv_node_as_uri(lilv_nodes_get(features, it));
+        if (qstrcmp(uri, LV2_WORKER__schedule) != 0 &&
+                qstrcmp(uri, LV2_URID__map) != 0) {
+            m_status = HAS_REQUIRED_FEATURES;
+        }
     }
     lilv_nodes_free(features);
 }
@@ -0,0 +1,26 @@
+#include "effects/backends/lv2/lv2uridmap.h"
+
+#include "util/compatibility/qmutex.h"
+
+LV2UridMap::LV2UridMap() {
+    m_map.handle = this;
+    m_map.map = &LV2UridMap::mapUri;
+    m_feature.URI = LV2_URID__map;
+    m_feature.data = &m_map;
+}
+
+LV2_URID LV2UridMap::map(const char* uri) {
+    const auto locker = lockMutex(&m_mutex);
+    const QByteArray key(uri);
+    auto it = m_urids.constFind(key);
+    if (it == m_urids.constEnd()) {
+        // 0 is reserved to indicate that a URI could not be mapped
+        it = m_urids.insert(key, static_cast<LV2_URID>(m_urids.size() + 1));
+    }
+    return it.value();
+}
+
+// static
+LV2_URID LV2UridMap::mapUri(LV2_URID_Map_Handle handle, const char* uri) {
+    return static_cast<LV2UridMap*>(handle)->map(uri);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <lv2/urid/urid.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+/// Implements the LV2 URID Map feature, which is required by most plugins
+/// that use the LV2 Worker extension. The URIDs are shared by all plugin
+/// instances and may be mapped from any thread.
+class LV2UridMap {
+  public:
+    LV2UridMap();
+
+    const LV2_Feature* feature() const {
+        return &m_feature;
+    }
+
+    LV2_URID map(const char* uri);
+
+  private:
+    static LV2_URID mapUri(LV2_URID_Map_Handle handle, const char* uri);
+
+    LV2_URID_Map m_map;
+    LV2_Feature m_feature;
+
+    QMutex m_mutex;
+    QHash<QByteArray, LV2_URID> m_urids;
+};
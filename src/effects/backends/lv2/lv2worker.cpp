@@ -0,0 +1,209 @@
+#include "effects/backends/lv2/lv2worker.h"
+
+#include <cstring>
+
+#include "moc_lv2worker.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+// Large enough for the messages of typical plugins, e.g. the path of a
+// file to load or a pointer to memory that has been allocated
+constexpr int kFifoSize = 8192;
+
+constexpr auto kMessageHeaderSize = static_cast<int>(sizeof(uint32_t));
+
+} // namespace
+
+LV2WorkerThread::LV2WorkerThread()
+        : m_stop(false) {
+    setObjectName(QStringLiteral("LV2WorkerThread"));
+}
+
+LV2WorkerThread::~LV2WorkerThread() {
+    m_stop = true;
+    m_semaphore.release();
+    wait();
+}
+
+void LV2WorkerThread::addWorker(LV2Worker* pWorker) {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_workers.append(pWorker);
+    }
+    if (!isRunning()) {
+        start();
+    }
+}
+
+void LV2WorkerThread::removeWorker(LV2Worker* pWorker) {
+    // Waits until the worker is no longer processed
+    const auto locker = lockMutex(&m_mutex);
+    m_workers.removeAll(pWorker);
+}
+
+void LV2WorkerThread::run() {
+    while (true) {
+        m_semaphore.acquire();
+        if (m_stop) {
+            break;
+        }
+        const auto locker = lockMutex(&m_mutex);
+        for (LV2Worker* pWorker : std::as_const(m_workers)) {
+            pWorker->doWork();
+        }
+    }
+}
+
+LV2Worker::LV2Worker(std::shared_ptr<LV2WorkerThread> pThread)
+        : m_pThread(std::move(pThread)),
+          m_pInstance(nullptr),
+          m_pInterface(nullptr),
+          m_requests(kFifoSize),
+          m_responses(kFifoSize),
+          m_request(kFifoSize),
+          m_response(kFifoSize),
+          m_resetPending(false) {
+    m_schedule.handle = this;
+    m_schedule.schedule_work = &LV2Worker::scheduleWork;
+    m_feature.URI = LV2_WORKER__schedule;
+    m_feature.data = &m_schedule;
+}
+
+LV2Worker::~LV2Worker() {
+    stop();
+}
+
+void LV2Worker::setInstance(LilvInstance* pInstance) {
+    DEBUG_ASSERT(!m_pInstance);
+    m_pInstance = pInstance;
+    m_pInterface = static_cast<const LV2_Worker_Interface*>(
+            lilv_instance_get_extension_data(pInstance, LV2_WORKER__interface));
+    // Also registered without the extension, for resetting the instance
+    m_pThread->addWorker(this);
+}
+
+void LV2Worker::stop() {
+    if (m_pInstance) {
+        m_pThread->removeWorker(this);
+        m_pInstance = nullptr;
+    }
+    m_pInterface = nullptr;
+}
+
+void LV2Worker::requestReset() {
+    m_resetPending.store(true, std::memory_order_release);
+    m_pThread->wake();
+}
+
+// static
+LV2_Worker_Status LV2Worker::scheduleWork(
+        LV2_Worker_Schedule_Handle handle,
+        uint32_t size,
+        const void* pData) {
+    auto* pWorker = static_cast<LV2Worker*>(handle);
+    if (!pWorker->m_pInterface) {
+        return LV2_WORKER_ERR_UNKNOWN;
+    }
+    if (!writeMessage(&pWorker->m_requests, size, pData)) {
+        return LV2_WORKER_ERR_NO_SPACE;
+    }
+    pWorker->m_pThread->wake();
+    return LV2_WORKER_SUCCESS;
+}
+
+// static
+LV2_Worker_Status LV2Worker::respond(
+        LV2_Worker_Respond_Handle handle,
+        uint32_t size,
+        const void* pData) {
+    auto* pWorker = static_cast<LV2Worker*>(handle);
+    if (!writeMessage(&pWorker->m_responses, size, pData)) {
+        return LV2_WORKER_ERR_NO_SPACE;
+    }
+    return LV2_WORKER_SUCCESS;
+}
+
+void LV2Worker::doWork() {
+    if (m_resetPending.load(std::memory_order_acquire)) {
+        // The audio thread neither runs the instance nor reads the responses
+        // until the reset is published, so this thread owns both FIFOs
+        m_requests.flushReadData(m_requests.readAvailable());
+        m_responses.flushReadData(m_responses.readAvailable());
+        lilv_instance_deactivate(m_pInstance);
+        lilv_instance_activate(m_pInstance);
+        m_resetPending.store(false, std::memory_order_release);
+        return;
+    }
+    if (!m_pInterface) {
+        return;
+    }
+    uint32_t size;
+    while (readMessage(&m_requests, &m_request, &size)) {
+        m_pInterface->work(lilv_instance_get_handle(m_pInstance),
+                &LV2Worker::respond,
+                this,
+                size,
+                m_request.data());
+    }
+}
+
+void LV2Worker::deliverResponses() {
+    if (!m_pInterface) {
+        return;
+    }
+    uint32_t size;
+    while (readMessage(&m_responses, &m_response, &size)) {
+        m_pInterface->work_response(
+                lilv_instance_get_handle(m_pInstance), size, m_response.data());
+    }
+    if (m_pInterface->end_run) {
+        m_pInterface->end_run(lilv_instance_get_handle(m_pInstance));
+    }
+}
+
+// static
+bool LV2Worker::writeMessage(FIFO<char>* pFifo, uint32_t size, const void* pData) {
+    if (pFifo->writeAvailable() < kMessageHeaderSize + static_cast<int>(size)) {
+        return false;
+    }
+    pFifo->write(reinterpret_cast<const char*>(&size), kMessageHeaderSize);
+    pFifo->write(static_cast<const char*>(pData), static_cast<int>(size));
+    return true;
+}
+
+// static
+bool LV2Worker::readMessage(FIFO<char>* pFifo,
+        std::vector<char>* pMessage,
+        uint32_t* pSize) {
+    const int available = pFifo->readAvailable();
+    if (available < kMessageHeaderSize) {
+        return false;
+    }
+    // Peek at the size, the data might not have been written completely
+    char* pRegion1;
+    ring_buffer_size_t regionSize1;
+    char* pRegion2;
+    ring_buffer_size_t regionSize2;
+    pFifo->aquireReadRegions(kMessageHeaderSize,
+            &pRegion1,
+            &regionSize1,
+            &pRegion2,
+            &regionSize2);
+    char header[kMessageHeaderSize];
+    std::memcpy(header, pRegion1, regionSize1);
+    std::memcpy(header + regionSize1, pRegion2, regionSize2);
+    std::memcpy(pSize, header, kMessageHeaderSize);
+    if (available < kMessageHeaderSize + static_cast<int>(*pSize)) {
+        return false;
+    }
+    pFifo->releaseReadRegions(kMessageHeaderSize);
+    // Larger messages are rejected by writeMessage()
+    VERIFY_OR_DEBUG_ASSERT(*pSize <= pMessage->size()) {
+        pFifo->flushReadData(static_cast<int>(*pSize));
+        return false;
+    }
+    pFifo->read(pMessage->data(), static_cast<int>(*pSize));
+    return true;
+}
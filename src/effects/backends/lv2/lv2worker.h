@@ -0,0 +1,121 @@
+#pragma once
+
+#include <lilv/lilv.h>
+#include <lv2/worker/worker.h>
+
+#include <QList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "util/fifo.h"
+
+class LV2Worker;
+
+/// Executes the non-realtime work that LV2 plugins schedule from the audio
+/// thread, e.g. loading files or allocating memory, and resets the instances
+/// that the audio thread no longer uses. One thread is shared by all plugin
+/// instances and only started when the first plugin is instantiated.
+class LV2WorkerThread : public QThread {
+    Q_OBJECT
+  public:
+    LV2WorkerThread();
+    ~LV2WorkerThread() override;
+
+    /// Called from the main thread
+    void addWorker(LV2Worker* pWorker);
+    /// Called from the main thread. The worker is not accessed afterwards.
+    void removeWorker(LV2Worker* pWorker);
+
+    /// Called from the audio thread after scheduling work
+    void wake() {
+        m_semaphore.release();
+    }
+
+  protected:
+    void run() override;
+
+  private:
+    QSemaphore m_semaphore;
+    // Protects m_workers, which are processed while it is locked
+    QMutex m_mutex;
+    QList<LV2Worker*> m_workers;
+    std::atomic<bool> m_stop;
+};
+
+/// Implements the LV2 Worker extension for one plugin instance.
+///
+/// Requests are scheduled by the plugin during run() and passed to the
+/// LV2WorkerThread through a lock-free FIFO. The responses are passed back
+/// the same way and delivered to the plugin in the audio thread after its
+/// next run(), as required by the extension.
+class LV2Worker {
+  public:
+    explicit LV2Worker(std::shared_ptr<LV2WorkerThread> pThread);
+    ~LV2Worker();
+
+    /// The feature that needs to be passed when instantiating the plugin
+    const LV2_Feature* feature() const {
+        return &m_feature;
+    }
+
+    /// Called from the main thread after instantiating and activating the
+    /// plugin. Work is only scheduled if the plugin implements the extension.
+    void setInstance(LilvInstance* pInstance);
+
+    /// Called from the main thread before the instance is freed. No more
+    /// work is done and no responses are delivered afterwards.
+    void stop();
+
+    /// Called from the audio thread after each run() of the plugin
+    void deliverResponses();
+
+    /// Called from the audio thread after it has stopped running the
+    /// instance. The LV2WorkerThread deactivates and activates the instance,
+    /// which clears its internal state, e.g. the tail of a reverb, and
+    /// discards the pending work. The instance must not be run until
+    /// isResetPending() returns false.
+    void requestReset();
+
+    bool isResetPending() const {
+        return m_resetPending.load(std::memory_order_acquire);
+    }
+
+    /// Called from the LV2WorkerThread
+    void doWork();
+
+  private:
+    friend class LV2WorkerTest;
+
+    static LV2_Worker_Status scheduleWork(
+            LV2_Worker_Schedule_Handle handle,
+            uint32_t size,
+            const void* pData);
+    static LV2_Worker_Status respond(
+            LV2_Worker_Respond_Handle handle,
+            uint32_t size,
+            const void* pData);
+
+    // Each message is the size as uint32_t followed by the data
+    static bool writeMessage(FIFO<char>* pFifo, uint32_t size, const void* pData);
+    static bool readMessage(FIFO<char>* pFifo, std::vector<char>* pMessage, uint32_t* pSize);
+
+    const std::shared_ptr<LV2WorkerThread> m_pThread;
+    LV2_Worker_Schedule m_schedule;
+    LV2_Feature m_feature;
+    LilvInstance* m_pInstance;
+    const LV2_Worker_Interface* m_pInterface;
+
+    // Written by the audio thread, read by the worker thread
+    FIFO<char> m_requests;
+    // Written by the worker thread, read by the audio thread
+    FIFO<char> m_responses;
+    // Preallocated buffers for reading the messages of each thread
+    std::vector<char> m_request;
+    std::vector<char> m_response;
+    // Set by the audio thread, cleared by the worker thread after the reset
+    std::atomic<bool> m_resetPending;
+};
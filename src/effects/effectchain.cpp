@@ -1,5 +1,8 @@
 #include "effects/effectchain.h"
 
+#include <QTimer>
+#include <chrono>
+
 #include "control/controlencoder.h"
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
@@ -12,6 +15,12 @@
 #include "moc_effectchain.cpp"
 #include "util/sample.h"
 
+namespace {
+
+constexpr auto kReleaseEffectStatesDelay = std::chrono::seconds(30);
+
+} // namespace
+
 EffectChain::EffectChain(const QString& group,
         EffectsManager* pEffectsManager,
         EffectsMessengerPointer pEffectsMessenger,
@@ -24,7 +33,8 @@ EffectChain::EffectChain(const QString& group,
           m_pMessenger(pEffectsMessenger),
           m_group(group),
           m_signalProcessingStage(stage),
-          m_pEngineEffectChain(nullptr) {
+          m_pEngineEffectChain(nullptr),
+          m_pEngineEffectsReplacement(nullptr) {
     // qDebug() << "EffectChain::EffectChain " << group << ' ' << iChainNumber;
 
     m_pControlClear = std::make_unique<ControlPushButton>(ConfigKey(m_group, "clear"));
@@ -192,11 +202,29 @@ const QString& EffectChain::presetName() const {
 }
 
 void EffectChain::loadChainPreset(EffectChainPresetPointer pChainPreset) {
-    slotControlClear(1);
     VERIFY_OR_DEBUG_ASSERT(pChainPreset) {
+        slotControlClear(1);
         return;
     }
 
+    // Replace all EngineEffects at once, so the engine never processes a
+    // partially loaded chain and the old effects are deleted together when
+    // the response is received. The requests for the parameters of the new
+    // effects are deferred until the effects are part of the engine.
+    const bool replaceEngineEffects = !m_pEngineEffectsReplacement;
+    if (replaceEngineEffects) {
+        m_pEngineEffectsReplacement = new EngineEffectsReplacement;
+        m_pEngineEffectsReplacement->effects.reserve(EngineEffectChain::kEffectsCapacity);
+        m_pEngineEffectsReplacement->effects.resize(m_effectSlots.size());
+        m_pMessenger->deferRequests();
+    }
+
+    slotControlClear(1);
+
+    // Set before loading the effects, which would otherwise load an empty
+    // nameless preset, see EffectSlot::loadEffectInner()
+    m_presetName = pChainPreset->name();
+
     const QList effectPresets = pChainPreset->effectPresets();
 
     // TODO: use C++23 std::ranges::views::zip instead
@@ -213,12 +241,54 @@ void EffectChain::loadChainPreset(EffectChainPresetPointer pChainPreset) {
     setMixMode(pChainPreset->mixMode());
     m_pControlChainSuperParameter->setDefaultValue(pChainPreset->superKnob());
 
-    m_presetName = pChainPreset->name();
+    if (replaceEngineEffects) {
+        EffectsRequest* pRequest = new EffectsRequest();
+        pRequest->type = EffectsRequest::REPLACE_EFFECTS_OF_CHAIN;
+        pRequest->pTargetChain = m_pEngineEffectChain;
+        pRequest->ReplaceEffectsOfChain.pReplacement = m_pEngineEffectsReplacement;
+        m_pEngineEffectsReplacement = nullptr;
+        m_pMessenger->writeDeferredRequests(pRequest);
+    }
+
     emit chainPresetChanged(m_presetName);
 
     setControlLoadedPresetIndex(presetIndex());
 }
 
+bool EffectChain::addEngineEffectToReplacement(int slotNumber, EngineEffect* pEffect) {
+    if (!m_pEngineEffectsReplacement) {
+        return false;
+    }
+    QList<EngineEffect*>& effects = m_pEngineEffectsReplacement->effects;
+    VERIFY_OR_DEBUG_ASSERT(slotNumber >= 0 && slotNumber < effects.size() &&
+            !effects.at(slotNumber)) {
+        return false;
+    }
+    effects[slotNumber] = pEffect;
+    m_pEngineEffectsReplacement->addedEffects.append(pEffect);
+    return true;
+}
+
+bool EffectChain::removeEngineEffectFromReplacement(int slotNumber, EngineEffect* pEffect) {
+    if (!m_pEngineEffectsReplacement) {
+        return false;
+    }
+    QList<EngineEffect*>& effects = m_pEngineEffectsReplacement->effects;
+    VERIFY_OR_DEBUG_ASSERT(slotNumber >= 0 && slotNumber < effects.size()) {
+        return false;
+    }
+    if (effects.at(slotNumber) == pEffect) {
+        // Only loaded while loading the preset. This is avoided, because the
+        // deferred requests for its parameters are rejected by the engine.
+        DEBUG_ASSERT(!"EngineEffect replaced while loading a chain preset");
+        effects[slotNumber] = nullptr;
+        m_pEngineEffectsReplacement->addedEffects.removeAll(pEffect);
+    }
+    // Deleted after the response has been received
+    m_pEngineEffectsReplacement->removedEffects.append(pEffect);
+    return true;
+}
+
 bool EffectChain::isEmpty() {
     for (const auto& pEffectSlot : std::as_const(m_effectSlots)) {
         if (pEffectSlot->isLoaded()) {
@@ -430,6 +500,22 @@ void EffectChain::disableForInputChannel(const ChannelHandleAndGroup& handleGrou
     request->pTargetChain = m_pEngineEffectChain;
     request->DisableInputChannelForChain.channelHandle = handleGroup.handle();
     m_pMessenger->writeRequest(request);
+
+    // Keep the states while the channel might be enabled again soon, e.g.
+    // when toggling an effect unit on and off during a transition.
+    QTimer::singleShot(kReleaseEffectStatesDelay,
+            this,
+            [this, handleGroup]() { releaseEffectStatesForInputChannel(handleGroup); });
+}
+
+void EffectChain::releaseEffectStatesForInputChannel(
+        const ChannelHandleAndGroup& handleGroup) {
+    if (m_enabledInputChannels.contains(handleGroup) || !m_pEngineEffectChain) {
+        return;
+    }
+    for (const auto& pEffectSlot : std::as_const(m_effectSlots)) {
+        pEffectSlot->releaseInputChannel(handleGroup.handle());
+    }
 }
 
 int EffectChain::presetIndex() const {
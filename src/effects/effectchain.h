@@ -13,7 +13,9 @@ class ControlObject;
 class ControlPushButton;
 class ControlEncoder;
 class EffectsManager;
+class EngineEffect;
 class EngineEffectChain;
+struct EngineEffectsReplacement;
 
 /// EffectChain is the main thread representation of an effect chain.
 /// EffectChain owns the ControlObjects for the routing switches that assign
@@ -78,6 +80,13 @@ class EffectChain : public QObject {
 
     void loadEmptyNamelessPreset();
 
+    /// Called by EffectSlot. While a chain preset is loaded, the EngineEffects
+    /// of all slots are collected and replace the effects of the
+    /// EngineEffectChain with a single request. Returns false if no preset is
+    /// being loaded and the effect must be added or removed separately.
+    bool addEngineEffectToReplacement(int slotNumber, EngineEffect* pEffect);
+    bool removeEngineEffectFromReplacement(int slotNumber, EngineEffect* pEffect);
+
   public slots:
     void slotControlClear(double value);
 
@@ -130,6 +139,8 @@ class EffectChain : public QObject {
     void addToEngine();
     void removeFromEngine();
 
+    void releaseEffectStatesForInputChannel(const ChannelHandleAndGroup& handleGroup);
+
     const QString m_group;
 
     std::unique_ptr<ControlPushButton> m_pControlClear;
@@ -158,6 +169,8 @@ class EffectChain : public QObject {
     QHash<ChannelHandleAndGroup, std::shared_ptr<ControlPushButton>> m_channelEnableButtons;
     QSet<ChannelHandleAndGroup> m_enabledInputChannels;
     EngineEffectChain* m_pEngineEffectChain;
+    // Only set while loading a chain preset
+    EngineEffectsReplacement* m_pEngineEffectsReplacement;
 
     DISALLOW_COPY_AND_ASSIGN(EffectChain);
 };
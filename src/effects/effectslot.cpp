@@ -155,6 +155,10 @@ void EffectSlot::addToEngine() {
             m_pEffectsManager->registeredInputChannels(),
             m_pEffectsManager->registeredOutputChannels());
 
+    if (m_pChain->addEngineEffectToReplacement(m_iEffectNumber, m_pEngineEffect)) {
+        return;
+    }
+
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
@@ -168,6 +172,11 @@ void EffectSlot::removeFromEngine() {
         return;
     }
 
+    if (m_pChain->removeEngineEffectFromReplacement(m_iEffectNumber, m_pEngineEffect)) {
+        m_pEngineEffect = nullptr;
+        return;
+    }
+
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::REMOVE_EFFECT_FROM_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
@@ -203,6 +212,23 @@ void EffectSlot::initalizeInputChannel(ChannelHandle inputChannel) {
     m_pEngineEffect->initalizeInputChannel(inputChannel);
 };
 
+void EffectSlot::releaseInputChannel(ChannelHandle inputChannel) {
+    if (!m_pEngineEffect) {
+        return;
+    }
+
+    // The states are deleted when the response arrives and only if the
+    // chain is no longer processed for the input channel by then.
+    EffectsRequest* request = new EffectsRequest();
+    request->type = EffectsRequest::RELEASE_EFFECT_STATES_FOR_INPUT_CHANNEL;
+    request->pTargetChain = m_pEngineEffectChain;
+    request->ReleaseEffectStatesForInputChannel.channelHandle = inputChannel;
+    request->ReleaseEffectStatesForInputChannel.pEffect = m_pEngineEffect;
+    request->ReleaseEffectStatesForInputChannel.generation =
+            m_pEngineEffect->inputChannelGeneration(inputChannel);
+    m_pMessenger->writeRequest(request);
+}
+
 EffectManifestPointer EffectSlot::getManifest() const {
     return m_pManifest;
 }
@@ -118,6 +118,8 @@ class EffectSlot : public QObject {
     }
 
     void initalizeInputChannel(ChannelHandle inputChannel);
+    /// Deletes the EffectStates of a channel the chain has been disabled for
+    void releaseInputChannel(ChannelHandle inputChannel);
 
     EffectManifestPointer getManifest() const;
 
@@ -8,13 +8,15 @@ EffectsMessenger::EffectsMessenger(
         EffectsRequestPipe&& requestPipe)
         : m_requestPipe(std::move(requestPipe)),
           m_nextRequestId(0),
-          m_bShuttingDown(false) {
+          m_bShuttingDown(false),
+          m_bDeferRequests(false) {
 }
 
 EffectsMessenger::~EffectsMessenger() {
     for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); it++) {
         delete it.value();
     }
+    qDeleteAll(m_deferredRequests);
 }
 
 void EffectsMessenger::initiateShutdown() {
@@ -22,10 +24,15 @@ void EffectsMessenger::initiateShutdown() {
 }
 
 bool EffectsMessenger::writeRequest(EffectsRequest* request) {
+    if (m_bDeferRequests) {
+        m_deferredRequests.append(request);
+        return true;
+    }
+
     if (m_bShuttingDown) {
         // Catch all delete Messages since the engine is already down
         // and we cannot wait for a communication cycle
-        collectGarbage(request);
+        collectGarbage(request, false);
     }
 
     // This is effectively only garbage collection at this point so only deal
@@ -42,6 +49,22 @@ bool EffectsMessenger::writeRequest(EffectsRequest* request) {
     return false;
 }
 
+void EffectsMessenger::deferRequests() {
+    DEBUG_ASSERT(!m_bDeferRequests);
+    m_bDeferRequests = true;
+}
+
+void EffectsMessenger::writeDeferredRequests(EffectsRequest* pRequest) {
+    DEBUG_ASSERT(m_bDeferRequests);
+    m_bDeferRequests = false;
+    writeRequest(pRequest);
+    const QList<EffectsRequest*> deferredRequests = std::move(m_deferredRequests);
+    m_deferredRequests.clear();
+    for (EffectsRequest* pDeferredRequest : deferredRequests) {
+        writeRequest(pDeferredRequest);
+    }
+}
+
 void EffectsMessenger::processEffectsResponses() {
     EffectsResponse response;
     while (m_requestPipe.readMessage(&response)) {
@@ -61,7 +84,7 @@ void EffectsMessenger::processEffectsResponses() {
             // specific errors should be caught with DEBUG_ASSERTs in
             // EngineEffectsMessenger and functions it calls to handle requests.
 
-            collectGarbage(pRequest);
+            collectGarbage(pRequest, response.success);
 
             delete pRequest;
             it = constErase(&m_activeRequests, it);
@@ -69,7 +92,7 @@ void EffectsMessenger::processEffectsResponses() {
     }
 }
 
-void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
+void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest, bool success) {
     if (pRequest->type == EffectsRequest::REMOVE_EFFECT_FROM_CHAIN) {
         if (kEffectDebugOutput) {
             qDebug() << debugString() << "delete" << pRequest->RemoveEffectFromChain.pEffect;
@@ -80,5 +103,24 @@ void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
             qDebug() << debugString() << "delete" << pRequest->RemoveEffectChain.pChain;
         }
         delete pRequest->RemoveEffectChain.pChain;
+    } else if (pRequest->type == EffectsRequest::REPLACE_EFFECTS_OF_CHAIN) {
+        EngineEffectsReplacement* pReplacement =
+                pRequest->ReplaceEffectsOfChain.pReplacement;
+        // The removed effects are still processed if the chain has not
+        // been replaced
+        if (success || m_bShuttingDown) {
+            if (kEffectDebugOutput) {
+                qDebug() << debugString() << "delete" << pReplacement->removedEffects;
+            }
+            qDeleteAll(pReplacement->removedEffects);
+        }
+        delete pReplacement;
+    } else if (pRequest->type == EffectsRequest::RELEASE_EFFECT_STATES_FOR_INPUT_CHANNEL) {
+        // Only succeeds if the audio thread no longer accesses the states
+        if (success) {
+            pRequest->ReleaseEffectStatesForInputChannel.pEffect->releaseInputChannelStates(
+                    pRequest->ReleaseEffectStatesForInputChannel.channelHandle,
+                    pRequest->ReleaseEffectStatesForInputChannel.generation);
+        }
     }
 }
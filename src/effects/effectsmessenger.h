@@ -21,11 +21,19 @@ class EffectsMessenger {
     /// ownership of request and deletes it once a response is received.
     bool writeRequest(EffectsRequest* request);
 
+    /// Queues the following requests instead of writing them, until
+    /// writeDeferredRequests() is called.
+    void deferRequests();
+    /// Writes pRequest followed by the requests that have been queued since
+    /// deferRequests(). Used to send the requests for EngineEffects that
+    /// only become part of the engine with pRequest.
+    void writeDeferredRequests(EffectsRequest* pRequest);
+
     void initiateShutdown();
     void processEffectsResponses();
 
   private:
-    void collectGarbage(const EffectsRequest* pRequest);
+    void collectGarbage(const EffectsRequest* pRequest, bool success);
 
     QString debugString() const {
         return "EffectsMessenger";
@@ -35,4 +43,6 @@ class EffectsMessenger {
     EffectsRequestPipe m_requestPipe;
     qint64 m_nextRequestId;
     bool m_bShuttingDown;
+    bool m_bDeferRequests;
+    QList<EffectsRequest*> m_deferredRequests;
 };
@@ -13,6 +13,10 @@
 class EncoderCallback;
 
 /// Encoder for FLAC using libsndfile
+///
+/// The header isn't updated periodically like for WAVE files. This isn't
+/// needed, because FLAC frames can be decoded independently and the length
+/// of the stream is unknown in the header until the file is closed.
 class EncoderSndfileFlac : public EncoderWave {
   public:
     EncoderSndfileFlac(EncoderCallback* pCallback = nullptr);
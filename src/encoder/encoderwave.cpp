@@ -7,6 +7,13 @@
 #include "encoder/encoderwavesettings.h"
 #include "recording/defs_recording.h"
 
+namespace {
+
+// At most this much of the recording is lost if the file isn't closed
+constexpr int kHeaderUpdateIntervalSeconds = 1;
+
+} // namespace
+
 // The virtual file context must return the length of the virtual file in bytes.
 static sf_count_t  sf_f_get_filelen (void *user_data)
 {
@@ -25,13 +32,13 @@ static sf_count_t  sf_f_seek (sf_count_t offset, int whence, void *user_data)
     EncoderCallback* pCallback = static_cast<EncoderCallback*>(user_data);
     if (whence == SEEK_SET) {
         new_offset = offset;
-        pCallback->seek(static_cast<int>(new_offset));
+        pCallback->seek(new_offset);
     } else if (whence == SEEK_CUR) {
         new_offset = pCallback->tell()+offset;
-        pCallback->seek(static_cast<int>(new_offset));
+        pCallback->seek(new_offset);
     } else {
         new_offset =  pCallback->filelen()-offset;
-        pCallback->seek(static_cast<int>(new_offset));
+        pCallback->seek(new_offset);
     }
     return new_offset;
 }
@@ -67,7 +74,8 @@ static sf_count_t  sf_f_tell (void *user_data)
 
 EncoderWave::EncoderWave(EncoderCallback* pCallback)
         : m_pCallback(pCallback),
-          m_pSndfile(nullptr) {
+          m_pSndfile(nullptr),
+          m_framesUntilHeaderUpdate(0) {
     m_sfInfo.frames = 0;
     m_sfInfo.samplerate = 0;
     m_sfInfo.channels = 0;
@@ -95,16 +103,14 @@ void EncoderWave::setEncoderSettings(const EncoderSettings& settings) {
     const EncoderWaveSettings& wavesettings = reinterpret_cast<const EncoderWaveSettings&>(settings);
     QString format = wavesettings.getFormat();
     if (format == ENCODING_WAVE) {
-        m_sfInfo.format = SF_FORMAT_WAV;
+        // Allows recordings longer than 4 GiB, see initStream()
+        m_sfInfo.format = SF_FORMAT_RF64;
     } else if (format == ENCODING_AIFF) {
         m_sfInfo.format = SF_FORMAT_AIFF;
     } else {
         qWarning() << "Unexpected Format when setting EncoderWave: " << format << ". Reverting to wav";
         // Other possibly interesting formats
-        // There is a n option for RF64 to automatically downgrade to RIFF WAV if less than 4GB using an
-        // sf_command, so it could be interesting to use it in place of FORMAT_WAVE.
         // SF_FORMAT_W64          = 0x0B0000,     /* Sonic Foundry's 64 bit RIFF/WAV */
-        // SF_FORMAT_RF64         = 0x220000,     /* RF64 WAV file */
 
         // I guess this one is WAVEFORMATEXTENSIBLE, not WAVEFORMATEX.
         // Not really useful for us since it's mostly for multichannel setups.
@@ -138,6 +144,14 @@ void EncoderWave::flush() {
 
 void EncoderWave::encodeBuffer(const CSAMPLE* pBuffer, const std::size_t bufferSize) {
     sf_write_float(m_pSndfile, pBuffer, bufferSize);
+
+    // Otherwise the header is only written when closing the file, i.e. the
+    // length of the audio data would be missing after a crash
+    m_framesUntilHeaderUpdate -= static_cast<sf_count_t>(bufferSize) / m_sfInfo.channels;
+    if (m_framesUntilHeaderUpdate <= 0) {
+        sf_command(m_pSndfile, SFC_UPDATE_HEADER_NOW, nullptr, 0);
+        m_framesUntilHeaderUpdate = m_sfInfo.samplerate * kHeaderUpdateIntervalSeconds;
+    }
 }
 
 /* Originally called from enginebroadcast.cpp to update metadata information
@@ -161,6 +175,13 @@ void EncoderWave::initStream() {
     // Ensure CPU_CLIPS_NEGATIVE and CPU_CLIPS_POSITIVE is setup properly in the build.
     sf_command(m_pSndfile, SFC_SET_CLIPPING, nullptr, SF_TRUE);
 
+    if ((m_sfInfo.format & SF_FORMAT_TYPEMASK) == SF_FORMAT_RF64) {
+        // Write a regular WAVE header with a JUNK chunk in place of the
+        // RF64 chunk as long as the file is smaller than 4 GiB. This must be
+        // done before writing any samples.
+        sf_command(m_pSndfile, SFC_RF64_AUTO_DOWNGRADE, nullptr, SF_TRUE);
+    }
+
     // Strings passed to and retrieved from sf_get_string/sf_set_string are assumed to be utf-8.
     // However, while formats like Ogg/Vorbis and FLAC fully support utf-8, others like WAV and
     // AIFF officially only support ASCII. Writing utf-8 strings to WAV and AIF files with
@@ -202,6 +223,7 @@ int EncoderWave::initEncoder(mixxx::audio::SampleRate sampleRate, QString* pUser
     m_sfInfo.frames = 0;
     m_sfInfo.sections = 0;
     m_sfInfo.seekable = 0;
+    m_framesUntilHeaderUpdate = m_sfInfo.samplerate * kHeaderUpdateIntervalSeconds;
 
     // Opens a soundfile from a virtual file I/O context which is provided by the caller.
     // This is usually used to interface libsndfile to a stream or buffer based system.
@@ -15,6 +15,11 @@
 class EncoderCallback;
 
 // WAVE/AIFF "encoder"
+//
+// The header is updated periodically while recording, so the file can be
+// played even if Mixxx crashes before the recording is stopped. WAVE files
+// are written as RF64 that is downgraded to a regular RIFF header as long
+// as the file is smaller than 4 GiB.
 class EncoderWave : public Encoder {
   public:
     EncoderWave(EncoderCallback* pCallback = nullptr);
@@ -36,6 +41,7 @@ class EncoderWave : public Encoder {
 
     SNDFILE* m_pSndfile;
     SF_INFO m_sfInfo;
+    sf_count_t m_framesUntilHeaderUpdate;
 
     SF_VIRTUAL_IO m_virtualIo;
 };
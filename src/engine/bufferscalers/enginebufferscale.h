@@ -3,6 +3,7 @@
 #include <QObject>
 
 #include "audio/signalinfo.h"
+#include "engine/engine.h"
 
 // MAX_SEEK_SPEED needs to be good and high to allow room for the very high
 //  instantaneous velocities of advanced scratching (Uzi) and spin-backs.
@@ -51,6 +52,25 @@ class EngineBufferScale : public QObject {
         return m_signal;
     }
 
+#ifdef __STEM__
+    // True if the scaler can stretch the stems of a stem track as one
+    // stereo mix, see setStemPremixMask()
+    virtual bool supportsStemPremix() const {
+        return false;
+    }
+    // Selects the stems of a multi channel signal whose sum is stretched as
+    // one stereo signal instead of stretching all channels. The result is
+    // returned in the channels of the first stem of the mask, the other
+    // channels are silent. A mask of 0 stretches all channels. clear() must
+    // be called after changing the mask.
+    void setStemPremixMask(mixxx::StemChannelSelection mask) {
+        m_stemPremixMask = mask;
+    }
+    mixxx::StemChannelSelection getStemPremixMask() const {
+        return m_stemPremixMask;
+    }
+#endif
+
     // Called from EngineBuffer when seeking, to ensure the buffers are flushed */
     virtual void clear() = 0;
     // Scale buffer
@@ -76,4 +96,7 @@ class EngineBufferScale : public QObject {
     double m_dPitchRatio;
     // Due to the scaler latency, tempo and pitch changes are not immediately effective.
     double m_effectiveRate;
+#ifdef __STEM__
+    mixxx::StemChannelSelection m_stemPremixMask;
+#endif
 };
@@ -13,6 +13,8 @@ EngineBufferScaleLinear::EngineBufferScaleLinear(ReadAheadManager *pReadAheadMan
       m_bufferInt(SampleUtil::alloc(kiLinearScaleReadAheadLength)),
       m_bufferIntSize(0),
       m_bClear(false),
+      m_bHermite(false),
+      m_interpolateFrames(nullptr),
       m_dRate(1.0),
       m_dOldRate(1.0),
       m_dCurrentFrame(0.0),
@@ -29,6 +31,7 @@ void EngineBufferScaleLinear::onSignalChanged() {
     m_floorSampleOld = mixxx::SampleBuffer(getOutputSignal().getChannelCount());
     m_floorSample = mixxx::SampleBuffer(getOutputSignal().getChannelCount());
     m_ceilSample = mixxx::SampleBuffer(getOutputSignal().getChannelCount());
+    selectInterpolateFrames();
 }
 
 void EngineBufferScaleLinear::setScaleParameters(double base_rate,
@@ -59,6 +62,78 @@ inline float hermite4(float frac_pos, float xm1, float x0, float x1, float x2)
     return ((((a * frac_pos) - b_neg) * frac_pos + c) * frac_pos + x0);
 }
 
+namespace {
+
+// The number of output frames per iteration of interpolateFrames()
+constexpr SINT kBlockFrames = 4;
+
+// kChannels is the channel count if known at compile time, otherwise 0.
+// The positions are calculated exactly like in the frame loop of
+// EngineBufferScaleLinear::do_scale(), so the results are the same.
+template<int kChannels, bool kHermite>
+SINT interpolateFrames(CSAMPLE* pOutput,
+        const CSAMPLE* pInput,
+        SINT inputFrames,
+        int channelCount,
+        SINT maxFrames,
+        double* pCurrentFrame,
+        double* pNextFrame,
+        double* pRateAdd,
+        double rateDelta) {
+    const int chCount = kChannels > 0 ? kChannels : channelCount;
+    // The input frames around the position that are read
+    constexpr SINT kFramesBefore = kHermite ? 1 : 0;
+    constexpr SINT kFramesAfter = kHermite ? 2 : 1;
+
+    SINT frame = 0;
+    while (frame + kBlockFrames <= maxFrames) {
+        double positions[kBlockFrames];
+        double nextFrame = *pNextFrame;
+        double rateAdd = *pRateAdd;
+        for (SINT k = 0; k < kBlockFrames; ++k) {
+            positions[k] = nextFrame;
+            nextFrame = positions[k] + rateAdd;
+            rateAdd += rateDelta;
+        }
+        SINT floors[kBlockFrames];
+        CSAMPLE fracs[kBlockFrames];
+        for (SINT k = 0; k < kBlockFrames; ++k) {
+            floors[k] = static_cast<SINT>(floor(positions[k]));
+            fracs[k] = static_cast<CSAMPLE>(positions[k]) - floors[k];
+        }
+        // The positions are monotonic within the block
+        if (math_min(floors[0], floors[kBlockFrames - 1]) < kFramesBefore ||
+                math_max(floors[0], floors[kBlockFrames - 1]) + kFramesAfter >=
+                        inputFrames) {
+            break;
+        }
+        for (SINT k = 0; k < kBlockFrames; ++k) {
+            const CSAMPLE* pFloor = pInput + floors[k] * chCount;
+            CSAMPLE* pOut = pOutput + (frame + k) * chCount;
+            const CSAMPLE frac = fracs[k];
+            for (int chIdx = 0; chIdx < chCount; ++chIdx) {
+                if constexpr (kHermite) {
+                    pOut[chIdx] = hermite4(frac,
+                            pFloor[chIdx - chCount],
+                            pFloor[chIdx],
+                            pFloor[chIdx + chCount],
+                            pFloor[chIdx + 2 * chCount]);
+                } else {
+                    pOut[chIdx] = pFloor[chIdx] +
+                            frac * (pFloor[chIdx + chCount] - pFloor[chIdx]);
+                }
+            }
+        }
+        *pCurrentFrame = positions[kBlockFrames - 1];
+        *pNextFrame = nextFrame;
+        *pRateAdd = rateAdd;
+        frame += kBlockFrames;
+    }
+    return frame;
+}
+
+} // namespace
+
 // Determine if we're changing directions (scratching) and then perform
 // a stretch
 double EngineBufferScaleLinear::scaleBuffer(
@@ -183,6 +258,53 @@ SINT EngineBufferScaleLinear::do_copy(CSAMPLE* buf, SINT buf_size) {
     return read_samples;
 }
 
+void EngineBufferScaleLinear::selectInterpolateFrames() {
+    // Stereo and stem decks get inner loops with a constant channel
+    // count that are fully unrolled
+    switch (getOutputSignal().getChannelCount()) {
+    case mixxx::audio::ChannelCount::stereo():
+        m_interpolateFrames = m_bHermite
+                ? &interpolateFrames<mixxx::audio::ChannelCount::stereo(), true>
+                : &interpolateFrames<mixxx::audio::ChannelCount::stereo(), false>;
+        break;
+    case mixxx::audio::ChannelCount::stem():
+        m_interpolateFrames = m_bHermite
+                ? &interpolateFrames<mixxx::audio::ChannelCount::stem(), true>
+                : &interpolateFrames<mixxx::audio::ChannelCount::stem(), false>;
+        break;
+    default:
+        m_interpolateFrames = m_bHermite
+                ? &interpolateFrames<0, true>
+                : &interpolateFrames<0, false>;
+        break;
+    }
+}
+
+SINT EngineBufferScaleLinear::interpolateBuffered(CSAMPLE* buf,
+        SINT maxFrames,
+        double* pRateAdd,
+        double rateDelta) {
+    const int chCount = getOutputSignal().getChannelCount();
+    const SINT bufferFrames = getOutputSignal().samples2frames(m_bufferIntSize);
+    const SINT frames = m_interpolateFrames(buf,
+            m_bufferInt,
+            bufferFrames,
+            chCount,
+            maxFrames,
+            &m_dCurrentFrame,
+            &m_dNextFrame,
+            pRateAdd,
+            rateDelta);
+    if (frames > 0) {
+        // The frame loop continues with the floor sample of the last frame
+        const SINT floorFrame = static_cast<SINT>(floor(m_dCurrentFrame));
+        SampleUtil::copy(m_floorSampleOld.data(),
+                &m_bufferInt[getOutputSignal().frames2samples(floorFrame)],
+                chCount);
+    }
+    return frames;
+}
+
 // Stretch a specified buffer worth of audio using linear interpolation
 double EngineBufferScaleLinear::do_scale(CSAMPLE* buf, SINT buf_size) {
     double rate_old = m_dOldRate;
@@ -240,6 +362,15 @@ double EngineBufferScaleLinear::do_scale(CSAMPLE* buf, SINT buf_size) {
 
     // Hot frame loop
     while (i < buf_size) {
+        // Most frames are within the buffer, they are interpolated in blocks
+        i += getOutputSignal().frames2samples(interpolateBuffered(&buf[i],
+                getOutputSignal().samples2frames(buf_size - i),
+                &rate_add,
+                rate_delta_abs));
+        if (i >= buf_size) {
+            break;
+        }
+
         // shift indices
         m_dCurrentFrame = m_dNextFrame;
 
@@ -24,11 +24,41 @@ class EngineBufferScaleLinear : public EngineBufferScale  {
                             double* pTempoRatio,
                              double* pPitchRatio) override;
 
+    /// Uses cubic Hermite instead of linear interpolation. The frames next
+    /// to the boundaries of the read-ahead buffer are still interpolated
+    /// linearly.
+    void setHermiteInterpolation(bool enabled) {
+        if (m_bHermite != enabled) {
+            m_bHermite = enabled;
+            selectInterpolateFrames();
+        }
+    }
+
   private:
     void onSignalChanged() override;
 
+    using InterpolateFramesFn = SINT (*)(CSAMPLE* pOutput,
+            const CSAMPLE* pInput,
+            SINT inputFrames,
+            int channelCount,
+            SINT maxFrames,
+            double* pCurrentFrame,
+            double* pNextFrame,
+            double* pRateAdd,
+            double rateDelta);
+    // Selects the variant of the interpolation loop for the channel count
+    // and the interpolation, once when either changes
+    void selectInterpolateFrames();
+
     double do_scale(CSAMPLE* buf, SINT buf_size);
     SINT do_copy(CSAMPLE* buf, SINT buf_size);
+    // Interpolates the following frames that are completely within
+    // m_bufferInt without the boundary checks of do_scale(), several
+    // frames per iteration. Returns the number of frames written.
+    SINT interpolateBuffered(CSAMPLE* buf,
+            SINT maxFrames,
+            double* pRateAdd,
+            double rateDelta);
 
     // The read-ahead manager that we use to fetch samples
     ReadAheadManager* m_pReadAheadManager;
@@ -42,6 +72,8 @@ class EngineBufferScaleLinear : public EngineBufferScale  {
     mixxx::SampleBuffer m_ceilSample;
 
     bool m_bClear;
+    bool m_bHermite;
+    InterpolateFramesFn m_interpolateFrames;
     double m_dRate;
     double m_dOldRate;
 
@@ -88,6 +88,15 @@ void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
             *pTempoRatio = m_bBackwards ? -speed_abs : speed_abs;
         }
     }
+    // The premix instance takes over at any time without a new call
+    if (m_rubberBandPremix.isValid()) {
+        if (pitchScale > 0) {
+            m_rubberBandPremix.setPitchScale(pitchScale);
+        }
+        if (timeRatioInverse > 0) {
+            m_rubberBandPremix.setTimeRatio(1.0 / timeRatioInverse);
+        }
+    }
     // Used by other methods so we need to keep them up to date.
     m_dBaseRate = base_rate;
     m_dTempoRatio = speed_abs;
@@ -112,6 +121,7 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
     }
 
     m_rubberBand.clear();
+    m_rubberBandPremix.clear();
 
     for (int chIdx = 0; chIdx < channelCount; chIdx++) {
         if (m_buffers[chIdx].size() == MAX_BUFFER_LEN) {
@@ -142,10 +152,27 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
     // avoid memory reallocations during playback.
     m_rubberBand.setTimeRatio(2.0);
     m_rubberBand.setTimeRatio(1.0);
+
+    if (channelCount > mixxx::audio::ChannelCount::stereo()) {
+        m_rubberBandPremix.setup(
+                getOutputSignal().getSampleRate(),
+                mixxx::audio::ChannelCount::stereo(),
+                rubberbandOptions);
+        m_rubberBandPremix.setTimeRatio(2.0);
+        m_rubberBandPremix.setTimeRatio(1.0);
+    }
+}
+
+bool EngineBufferScaleRubberBand::isStemPremixActive() const {
+#ifdef __STEM__
+    return m_stemPremixMask && m_rubberBandPremix.isValid();
+#else
+    return false;
+#endif
 }
 
 void EngineBufferScaleRubberBand::clear() {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(rubberBand().isValid()) {
         return;
     }
     reset();
@@ -154,7 +181,7 @@ void EngineBufferScaleRubberBand::clear() {
 SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
         CSAMPLE* pBuffer,
         SINT frames) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(rubberBand().isValid()) {
         return 0;
     }
     // NOTE: If we still need to throw away padding, then we can also
@@ -163,7 +190,7 @@ SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
     SINT received_frames;
     {
         ScopedTimer t(QStringLiteral("RubberBand::retrieve"));
-        received_frames = static_cast<SINT>(m_rubberBand.retrieve(
+        received_frames = static_cast<SINT>(rubberBand().retrieve(
                 m_bufferPtrs.data(), frames + m_remainingPaddingInOutput, m_buffers[0].size()));
     }
     SINT frame_offset = 0;
@@ -181,6 +208,27 @@ SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
 
     DEBUG_ASSERT(received_frames <= frames);
 
+#ifdef __STEM__
+    if (isStemPremixActive()) {
+        // The mix is returned in the channels of the first selected stem
+        const int chCount = getOutputSignal().getChannelCount();
+        const uint mask = m_stemPremixMask;
+        int chOffset = 0;
+        while (chOffset + mixxx::audio::ChannelCount::stereo() < chCount &&
+                !(mask & (1 << (chOffset / mixxx::audio::ChannelCount::stereo())))) {
+            chOffset += mixxx::audio::ChannelCount::stereo();
+        }
+        SampleUtil::clear(pBuffer, received_frames * chCount);
+        const CSAMPLE* pLeft = m_buffers[0].data(frame_offset);
+        const CSAMPLE* pRight = m_buffers[1].data(frame_offset);
+        for (SINT frameIdx = 0; frameIdx < received_frames; ++frameIdx) {
+            pBuffer[frameIdx * chCount + chOffset] = pLeft[frameIdx];
+            pBuffer[frameIdx * chCount + chOffset + 1] = pRight[frameIdx];
+        }
+        return received_frames;
+    }
+#endif
+
     switch (getOutputSignal().getChannelCount()) {
     case mixxx::audio::ChannelCount::stereo():
         SampleUtil::interleaveBuffer(pBuffer,
@@ -227,11 +275,37 @@ SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
 void EngineBufferScaleRubberBand::deinterleaveAndProcess(
         const CSAMPLE* pBuffer,
         SINT frames) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(rubberBand().isValid()) {
         return;
     }
     DEBUG_ASSERT(frames <= static_cast<SINT>(m_buffers[0].size()));
 
+#ifdef __STEM__
+    if (isStemPremixActive()) {
+        // Mix the selected stems into the first two buffers
+        // (LR......LR...... -> LL.., RR..)
+        const int chCount = getOutputSignal().getChannelCount();
+        const uint mask = m_stemPremixMask;
+        CSAMPLE* pLeft = m_buffers[0].data();
+        CSAMPLE* pRight = m_buffers[1].data();
+        SampleUtil::clear(pLeft, frames);
+        SampleUtil::clear(pRight, frames);
+        for (int chOffset = 0; chOffset < chCount;
+                chOffset += mixxx::audio::ChannelCount::stereo()) {
+            if (!(mask & (1 << (chOffset / mixxx::audio::ChannelCount::stereo())))) {
+                continue;
+            }
+            for (SINT frameIdx = 0; frameIdx < frames; ++frameIdx) {
+                pLeft[frameIdx] += pBuffer[frameIdx * chCount + chOffset];
+                pRight[frameIdx] += pBuffer[frameIdx * chCount + chOffset + 1];
+            }
+        }
+        ScopedTimer t(QStringLiteral("RubberBand::process"));
+        m_rubberBandPremix.process(m_bufferPtrs.data(), frames, false);
+        return;
+    }
+#endif
+
     switch (getOutputSignal().getChannelCount()) {
     case mixxx::audio::ChannelCount::stereo():
         SampleUtil::deinterleaveBuffer(
@@ -286,7 +360,7 @@ void EngineBufferScaleRubberBand::deinterleaveAndProcess(
 double EngineBufferScaleRubberBand::scaleBuffer(
         CSAMPLE* pOutputBuffer,
         SINT iOutputBufferSize) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(rubberBand().isValid()) {
         return 0.0;
     }
     ScopedTimer t(QStringLiteral("EngineBufferScaleRubberBand::scaleBuffer"));
@@ -316,7 +390,7 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         read += getOutputSignal().frames2samples(received_frames);
 
         const SINT next_block_frames_required =
-                static_cast<SINT>(m_rubberBand.getSamplesRequired());
+                static_cast<SINT>(rubberBand().getSamplesRequired());
         if (remaining_frames > 0 && next_block_frames_required > 0) {
             // The requested setting becomes effective after all previous frames have been processed
             m_effectiveRate = m_dBaseRate * m_dTempoRatio;
@@ -378,11 +452,11 @@ void EngineBufferScaleRubberBand::useEngineFiner(bool enable) {
 }
 
 size_t EngineBufferScaleRubberBand::getPreferredStartPad() const {
-    return m_rubberBand.getPreferredStartPad();
+    return rubberBand().getPreferredStartPad();
 }
 
 size_t EngineBufferScaleRubberBand::getStartDelay() const {
-    return m_rubberBand.getStartDelay();
+    return rubberBand().getStartDelay();
 }
 
 int EngineBufferScaleRubberBand::runningEngineVersion() {
@@ -390,7 +464,7 @@ int EngineBufferScaleRubberBand::runningEngineVersion() {
 }
 
 void EngineBufferScaleRubberBand::reset() {
-    m_rubberBand.reset();
+    rubberBand().reset();
 
     // As mentioned in the docs (https://breakfastquay.com/rubberband/code-doc/)
     // and FAQ (https://breakfastquay.com/rubberband/integration.html#faqs), you
@@ -409,7 +483,7 @@ void EngineBufferScaleRubberBand::reset() {
         const size_t pad_samples = std::min<size_t>(remaining_padding, block_size);
         {
             ScopedTimer t(QStringLiteral("RubberBand::process"));
-            m_rubberBand.process(m_bufferPtrs.data(), pad_samples, false);
+            rubberBand().process(m_bufferPtrs.data(), pad_samples, false);
         }
 
         remaining_padding -= pad_samples;
@@ -41,6 +41,12 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     // Flush buffer.
     void clear() override;
 
+#ifdef __STEM__
+    bool supportsStemPremix() const override {
+        return true;
+    }
+#endif
+
   private:
     // Reset RubberBand library with new audio signal
     void onSignalChanged() override;
@@ -57,6 +63,17 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     /// `m_pRubberBand->reset()` directly.
     void reset();
 
+    /// True if only the stereo mix of the stems selected by the premix mask
+    /// is stretched by `m_rubberBandPremix`
+    bool isStemPremixActive() const;
+    /// The instance that stretches the signal
+    RubberBandWrapper& rubberBand() {
+        return isStemPremixActive() ? m_rubberBandPremix : m_rubberBand;
+    }
+    const RubberBandWrapper& rubberBand() const {
+        return isStemPremixActive() ? m_rubberBandPremix : m_rubberBand;
+    }
+
     void deinterleaveAndProcess(const CSAMPLE* pBuffer, SINT frames);
     SINT retrieveAndDeinterleave(CSAMPLE* pBuffer, SINT frames);
 
@@ -64,6 +81,9 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     ReadAheadManager* m_pReadAheadManager;
 
     RubberBandWrapper m_rubberBand;
+    /// A stereo instance for stem tracks, which is used instead of
+    /// `m_rubberBand` while the stems are premixed
+    RubberBandWrapper m_rubberBandPremix;
 
     /// The audio buffers samples used to send audio to Rubber Band and to
     /// receive processed audio from Rubber Band. This is needed because Mixxx
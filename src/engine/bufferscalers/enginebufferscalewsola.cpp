@@ -0,0 +1,311 @@
+#include "engine/bufferscalers/enginebufferscalewsola.h"
+
+#include "moc_enginebufferscalewsola.cpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "engine/readaheadmanager.h"
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// The synthesis hop, i.e. half the window size. Long enough to contain a
+// few periods of bass frequencies.
+constexpr double kHopSeconds = 0.012;
+// The maximum offset of a segment from its nominal position
+constexpr double kSearchSeconds = 0.005;
+// The coarse search only tests every n-th offset, the fine search all
+// offsets around the best coarse one
+constexpr SINT kCoarseSearchStep = 4;
+
+// The stretch factors are clamped to this range, the input buffer is sized
+// for it. The keylock is disabled far below and above these.
+constexpr double kMinStretch = 0.05;
+constexpr double kMaxStretch = 8.0;
+
+constexpr SINT kChunkFrames = 512;
+
+} // namespace
+
+EngineBufferScaleWsola::EngineBufferScaleWsola(ReadAheadManager* pReadAheadManager)
+        : m_pReadAheadManager(pReadAheadManager),
+          m_bBackwards(false),
+          m_hopFrames(0),
+          m_windowFrames(0),
+          m_searchFrames(0),
+          m_capacityFrames(0),
+          m_chunkFrames(0),
+          m_chunkPos(0),
+          m_lastReadFailed(false),
+          m_resamplePos(0.0),
+          m_inputFrames(0),
+          m_analysisPos(0.0),
+          m_continuationPos(-1),
+          m_outputPos(0) {
+    // Initialize the internal buffers to prevent re-allocations
+    // in the real-time thread.
+    onSignalChanged();
+}
+
+void EngineBufferScaleWsola::setScaleParameters(double base_rate,
+        double* pTempoRatio,
+        double* pPitchRatio) {
+    // Negative speed means we are going backwards. pitch does not affect
+    // the playback direction.
+    m_bBackwards = *pTempoRatio < 0;
+
+    double speed_abs = fabs(*pTempoRatio);
+    if (speed_abs > MAX_SEEK_SPEED) {
+        speed_abs = MAX_SEEK_SPEED;
+    } else if (speed_abs < MIN_SEEK_SPEED) {
+        speed_abs = 0;
+    }
+
+    // Let the caller know if we clamped their value.
+    *pTempoRatio = m_bBackwards ? -speed_abs : speed_abs;
+
+    m_dTempoRatio = speed_abs;
+    m_dBaseRate = base_rate;
+    // Note: pitch ratio must be positive
+    m_dPitchRatio = fabs(*pPitchRatio);
+}
+
+void EngineBufferScaleWsola::onSignalChanged() {
+    if (!getOutputSignal().isValid()) {
+        m_hopFrames = 0;
+        return;
+    }
+    const double sampleRate = getOutputSignal().getSampleRate().toDouble();
+    const int channelCount = getOutputSignal().getChannelCount();
+
+    m_hopFrames = static_cast<SINT>(std::round(sampleRate * kHopSeconds));
+    m_windowFrames = 2 * m_hopFrames;
+    m_searchFrames = static_cast<SINT>(std::round(sampleRate * kSearchSeconds));
+    // The nominal advance, the search range on both sides, the window, and
+    // one more window that is discarded lazily
+    m_capacityFrames = static_cast<SINT>(std::ceil(kMaxStretch * m_hopFrames)) +
+            2 * m_searchFrames + 2 * m_windowFrames;
+
+    // A periodic Hann window, the overlapping halves add up to 1
+    m_window.resize(m_windowFrames);
+    for (SINT i = 0; i < m_windowFrames; ++i) {
+        m_window[i] = static_cast<CSAMPLE>(
+                0.5 - 0.5 * std::cos(2 * M_PI * i / m_windowFrames));
+    }
+
+    m_chunk = mixxx::SampleBuffer(kChunkFrames * channelCount);
+    m_previousFrame.assign(channelCount, CSAMPLE_ZERO);
+    m_nextFrame.assign(channelCount, CSAMPLE_ZERO);
+    m_input = mixxx::SampleBuffer(m_capacityFrames * channelCount);
+    m_inputMono = mixxx::SampleBuffer(m_capacityFrames);
+    m_overlap = mixxx::SampleBuffer(m_hopFrames * channelCount);
+    m_output = mixxx::SampleBuffer(m_hopFrames * channelCount);
+    clear();
+}
+
+void EngineBufferScaleWsola::clear() {
+    m_chunkFrames = 0;
+    m_chunkPos = 0;
+    m_lastReadFailed = false;
+    std::fill(m_previousFrame.begin(), m_previousFrame.end(), CSAMPLE_ZERO);
+    std::fill(m_nextFrame.begin(), m_nextFrame.end(), CSAMPLE_ZERO);
+    // Read the first input frame before interpolating
+    m_resamplePos = 1.0;
+    m_inputFrames = 0;
+    m_analysisPos = 0.0;
+    m_continuationPos = -1;
+    m_overlap.clear();
+    m_outputPos = m_hopFrames;
+}
+
+void EngineBufferScaleWsola::readChunk() {
+    const int channelCount = getOutputSignal().getChannelCount();
+    const SINT numSamples = m_pReadAheadManager->getNextSamples(
+            // The value doesn't matter here. All that matters is we
+            // are going forward or backward.
+            (m_bBackwards ? -1.0 : 1.0) * m_dBaseRate * m_dTempoRatio,
+            m_chunk.data(),
+            m_chunk.size(),
+            getOutputSignal().getChannelCount());
+    m_chunkFrames = numSamples / channelCount;
+    m_chunkPos = 0;
+    if (m_chunkFrames > 0) {
+        m_lastReadFailed = false;
+        return;
+    }
+    // We may get 0 samples once if we just hit a loop trigger, e.g.
+    // when reloop_toggle jumps back to loop_in, or when moving a
+    // loop causes the play position to be moved along.
+    if (m_lastReadFailed) {
+        // If we get 0 samples repeatedly, continue with silence
+        qDebug() << "ReadAheadManager::getNextSamples() returned "
+                    "zero samples repeatedly. Padding with silence.";
+        m_chunk.clear();
+        m_chunkFrames = kChunkFrames;
+    }
+    m_lastReadFailed = true;
+}
+
+void EngineBufferScaleWsola::fillInput(SINT numFrames) {
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_capacityFrames) {
+        numFrames = m_capacityFrames;
+    }
+    const int channelCount = getOutputSignal().getChannelCount();
+    // The number of input frames per resampled frame, the sample rate
+    // conversion and the pitch shift
+    const double step = m_dBaseRate * m_dPitchRatio;
+    while (m_inputFrames < numFrames) {
+        if (m_resamplePos >= 1.0) {
+            if (m_chunkPos >= m_chunkFrames) {
+                readChunk();
+                continue;
+            }
+            m_previousFrame.swap(m_nextFrame);
+            const CSAMPLE* pFrame = m_chunk.data(m_chunkPos * channelCount);
+            std::copy(pFrame, pFrame + channelCount, m_nextFrame.begin());
+            ++m_chunkPos;
+            m_resamplePos -= 1.0;
+            continue;
+        }
+        const auto frac = static_cast<CSAMPLE>(m_resamplePos);
+        CSAMPLE* pFrame = m_input.data(m_inputFrames * channelCount);
+        CSAMPLE mono = CSAMPLE_ZERO;
+        for (int channel = 0; channel < channelCount; ++channel) {
+            const CSAMPLE sample = m_previousFrame[channel] +
+                    (m_nextFrame[channel] - m_previousFrame[channel]) * frac;
+            pFrame[channel] = sample;
+            mono += sample;
+        }
+        m_inputMono[m_inputFrames] = mono;
+        ++m_inputFrames;
+        m_resamplePos += step;
+    }
+}
+
+SINT EngineBufferScaleWsola::findSegment(SINT nominalPos) const {
+    if (m_continuationPos < 0) {
+        return nominalPos;
+    }
+    const CSAMPLE* pTemplate = m_inputMono.data(m_continuationPos);
+    auto similarity = [this, pTemplate](SINT pos) {
+        const CSAMPLE* pCandidate = m_inputMono.data(pos);
+        const CSAMPLE correlation =
+                SampleUtil::dotProduct(pTemplate, pCandidate, m_hopFrames);
+        const CSAMPLE energy =
+                SampleUtil::dotProduct(pCandidate, pCandidate, m_hopFrames);
+        // The sign is kept, only positive correlations are a match
+        return correlation / std::sqrt(energy + 1e-9f);
+    };
+
+    const SINT firstPos = std::max(nominalPos - m_searchFrames, SINT(0));
+    const SINT lastPos = nominalPos + m_searchFrames;
+    SINT bestPos = nominalPos;
+    CSAMPLE bestSimilarity = similarity(nominalPos);
+    for (SINT pos = firstPos; pos <= lastPos; pos += kCoarseSearchStep) {
+        const CSAMPLE value = similarity(pos);
+        if (value > bestSimilarity) {
+            bestSimilarity = value;
+            bestPos = pos;
+        }
+    }
+    const SINT coarsePos = bestPos;
+    for (SINT pos = std::max(coarsePos - kCoarseSearchStep + 1, firstPos);
+            pos <= std::min(coarsePos + kCoarseSearchStep - 1, lastPos);
+            ++pos) {
+        if (pos == coarsePos) {
+            continue;
+        }
+        const CSAMPLE value = similarity(pos);
+        if (value > bestSimilarity) {
+            bestSimilarity = value;
+            bestPos = pos;
+        }
+    }
+    return bestPos;
+}
+
+void EngineBufferScaleWsola::processSegment() {
+    const int channelCount = getOutputSignal().getChannelCount();
+    const SINT nominalPos = static_cast<SINT>(m_analysisPos);
+    // The segment and the template of the search must be available
+    SINT requiredFrames = nominalPos + m_searchFrames + m_windowFrames;
+    if (m_continuationPos >= 0) {
+        requiredFrames = std::max(requiredFrames, m_continuationPos + m_hopFrames);
+    }
+    fillInput(requiredFrames);
+
+    const SINT segmentPos = findSegment(nominalPos);
+    const CSAMPLE* pSegment = m_input.data(segmentPos * channelCount);
+    const CSAMPLE* pSecondHalf = pSegment + m_hopFrames * channelCount;
+    for (SINT frame = 0; frame < m_hopFrames; ++frame) {
+        const CSAMPLE fadeIn = m_window[frame];
+        const CSAMPLE fadeOut = m_window[m_hopFrames + frame];
+        for (int channel = 0; channel < channelCount; ++channel) {
+            const SINT i = frame * channelCount + channel;
+            m_output[i] = m_overlap[i] + pSegment[i] * fadeIn;
+            m_overlap[i] = pSecondHalf[i] * fadeOut;
+        }
+    }
+    m_outputPos = 0;
+    m_continuationPos = segmentPos + m_hopFrames;
+
+    // The resampled frames per output frame
+    const double stretch = std::clamp(
+            m_dTempoRatio / m_dPitchRatio, kMinStretch, kMaxStretch);
+    m_analysisPos += stretch * m_hopFrames;
+
+    // Discard the frames that are no longer needed, but not after every
+    // segment to limit the copying
+    const SINT keepPos = std::min(
+            static_cast<SINT>(m_analysisPos) - m_searchFrames, m_continuationPos);
+    if (keepPos >= m_windowFrames) {
+        const SINT remainingFrames = m_inputFrames - keepPos;
+        if (remainingFrames > 0) {
+            std::copy(m_input.data(keepPos * channelCount),
+                    m_input.data(m_inputFrames * channelCount),
+                    m_input.data());
+            std::copy(m_inputMono.data(keepPos),
+                    m_inputMono.data(m_inputFrames),
+                    m_inputMono.data());
+        }
+        m_inputFrames = std::max(remainingFrames, SINT(0));
+        m_analysisPos -= keepPos;
+        m_continuationPos -= keepPos;
+    }
+}
+
+double EngineBufferScaleWsola::scaleBuffer(
+        CSAMPLE* pOutputBuffer,
+        SINT iOutputBufferSize) {
+    if (m_dBaseRate == 0.0 || m_dTempoRatio == 0.0 || m_dPitchRatio == 0.0 ||
+            m_hopFrames == 0) {
+        SampleUtil::clear(pOutputBuffer, iOutputBufferSize);
+        // No actual samples/frames have been read from the
+        // unscaled input buffer!
+        return 0.0;
+    }
+
+    const int channelCount = getOutputSignal().getChannelCount();
+    const SINT numFrames = getOutputSignal().samples2frames(iOutputBufferSize);
+    SINT remainingFrames = numFrames;
+    CSAMPLE* pWrite = pOutputBuffer;
+    while (remainingFrames > 0) {
+        if (m_outputPos >= m_hopFrames) {
+            processSegment();
+        }
+        const SINT frames = std::min(remainingFrames, m_hopFrames - m_outputPos);
+        SampleUtil::copy(pWrite,
+                m_output.data(m_outputPos * channelCount),
+                frames * channelCount);
+        m_outputPos += frames;
+        pWrite += frames * channelCount;
+        remainingFrames -= frames;
+    }
+
+    // The input is consumed at the nominal rate, the offsets of the
+    // segments do not accumulate
+    return m_dBaseRate * m_dTempoRatio * numFrames;
+}
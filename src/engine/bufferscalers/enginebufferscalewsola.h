@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+
+#include "engine/bufferscalers/enginebufferscale.h"
+#include "util/samplebuffer.h"
+
+class ReadAheadManager;
+
+/// A low-cost time stretcher for small tempo changes, based on WSOLA
+/// (waveform similarity overlap-add).
+///
+/// The input is resampled by linear interpolation for the pitch and the
+/// sample rate of the track. The resampled signal is then cut into windowed
+/// segments, which are overlapped with half the window size. Each segment
+/// is taken from near its nominal position, at the offset where it matches
+/// best with the natural continuation of the previous segment. This avoids
+/// the phase cancellations of a plain overlap-add. The similarity is the
+/// normalized cross-correlation of the mono sum of all channels, which is
+/// calculated with the SIMD kernels of SampleUtil.
+///
+/// The artifacts are inaudible for stretch factors close to 1, but grow
+/// with larger ones. EngineBuffer uses it in the automatic keylock mode for
+/// the decks that are close to the original tempo and key.
+class EngineBufferScaleWsola : public EngineBufferScale {
+    Q_OBJECT
+  public:
+    explicit EngineBufferScaleWsola(
+            ReadAheadManager* pReadAheadManager);
+    ~EngineBufferScaleWsola() override = default;
+
+    void setScaleParameters(double base_rate,
+            double* pTempoRatio,
+            double* pPitchRatio) override;
+
+    double scaleBuffer(
+            CSAMPLE* pOutputBuffer,
+            SINT iOutputBufferSize) override;
+
+    void clear() override;
+
+  private:
+    void onSignalChanged() override;
+
+    // Resamples the next input frames until the input holds the given
+    // number of frames
+    void fillInput(SINT numFrames);
+    // Reads the next chunk from the read-ahead manager
+    void readChunk();
+    // Returns the start of the segment at the nominal position with the
+    // best match to the continuation of the previous segment
+    SINT findSegment(SINT nominalPos) const;
+    // Overlap-adds the next segment and makes m_hopFrames output frames
+    // available
+    void processSegment();
+
+    // The read-ahead manager that we use to fetch samples
+    ReadAheadManager* m_pReadAheadManager;
+
+    // Holds the playback direction.
+    bool m_bBackwards;
+
+    // Depend on the sample rate
+    SINT m_hopFrames;
+    SINT m_windowFrames;
+    SINT m_searchFrames;
+    SINT m_capacityFrames;
+    std::vector<CSAMPLE> m_window;
+
+    // The chunk read from the read-ahead manager
+    mixxx::SampleBuffer m_chunk;
+    SINT m_chunkFrames;
+    SINT m_chunkPos;
+    bool m_lastReadFailed;
+
+    // The two input frames around the resampling position
+    std::vector<CSAMPLE> m_previousFrame;
+    std::vector<CSAMPLE> m_nextFrame;
+    double m_resamplePos;
+
+    // The resampled signal and its mono sum for the similarity search
+    mixxx::SampleBuffer m_input;
+    mixxx::SampleBuffer m_inputMono;
+    SINT m_inputFrames;
+    // The nominal start of the next segment
+    double m_analysisPos;
+    // The continuation of the previous segment, negative if there is none
+    SINT m_continuationPos;
+
+    // The second half of the previous windowed segment
+    mixxx::SampleBuffer m_overlap;
+    // The finished output frames of the last segment
+    mixxx::SampleBuffer m_output;
+    SINT m_outputPos;
+};
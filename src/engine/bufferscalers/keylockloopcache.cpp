@@ -0,0 +1,137 @@
+#include "engine/bufferscalers/keylockloopcache.h"
+
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// The beginning of the cache fades over to the output of the first pass
+// within this many frames
+constexpr SINT kSeamFrames = 256;
+
+} // namespace
+
+KeylockLoopCache::KeylockLoopCache(SINT capacitySamples)
+        : m_buffer(capacitySamples),
+          m_state(State::Idle),
+          m_loopFrames(0),
+          m_recordedFrames(0),
+          m_replayFrame(0) {
+}
+
+void KeylockLoopCache::invalidate() {
+    m_state = State::Idle;
+    m_recordedFrames = 0;
+}
+
+void KeylockLoopCache::record(const Key& key,
+        const CSAMPLE* pOutput,
+        SINT numSamples,
+        mixxx::audio::FramePos startPosition,
+        mixxx::audio::FramePos endPosition) {
+    if (m_state != State::Idle && !(m_key == key)) {
+        invalidate();
+    }
+    const int channelCount = key.channelCount;
+    const SINT numFrames = numSamples / channelCount;
+    SINT firstFrame = 0;
+    if (m_state == State::Idle) {
+        // Wait for the wrap around at the end of the loop
+        if (!key.loopStartPosition.isValid() || !key.loopEndPosition.isValid() ||
+                !startPosition.isValid() || !endPosition.isValid() ||
+                endPosition >= startPosition || key.tempoRatio <= 0.0) {
+            return;
+        }
+        // The track frames per output frame
+        const double rate = key.baseRate * key.tempoRatio;
+        const mixxx::audio::FrameDiff_t loopLength =
+                key.loopEndPosition - key.loopStartPosition;
+        if (rate <= 0.0 || loopLength <= 0) {
+            return;
+        }
+        m_loopFrames = static_cast<SINT>(std::round(loopLength / rate));
+        // The frames after the second wrap around must not overlap with the
+        // end of the pass
+        if (m_loopFrames < kSeamFrames + numFrames ||
+                (m_loopFrames + kSeamFrames + numFrames) * channelCount >
+                        m_buffer.size()) {
+            // Too short to be worth it or too long for the cache
+            return;
+        }
+        firstFrame = math_clamp(
+                static_cast<SINT>(std::round(
+                        (key.loopEndPosition - startPosition) / rate)),
+                SINT(0),
+                numFrames);
+        m_key = key;
+        m_state = State::Recording;
+        m_recordedFrames = 0;
+    }
+    if (m_state != State::Recording) {
+        return;
+    }
+    const SINT frames = math_min(numFrames - firstFrame,
+            m_buffer.size() / channelCount - m_recordedFrames);
+    SampleUtil::copy(m_buffer.data(m_recordedFrames * channelCount),
+            pOutput + firstFrame * channelCount,
+            frames * channelCount);
+    m_recordedFrames += frames;
+    if (m_recordedFrames >= m_loopFrames + kSeamFrames) {
+        finishRecording();
+    }
+}
+
+void KeylockLoopCache::finishRecording() {
+    const int channelCount = m_key.channelCount;
+    // The frames after the second wrap around have already been played,
+    // the replay continues behind them. Copy them to the beginning, so the
+    // end of the cache continues seamlessly, and fade to the first pass
+    // before the replay position.
+    const SINT overlapFrames = m_recordedFrames - m_loopFrames;
+    const SINT fadeStart = overlapFrames - kSeamFrames;
+    SampleUtil::copy(m_buffer.data(),
+            m_buffer.data(m_loopFrames * channelCount),
+            fadeStart * channelCount);
+    for (SINT frame = fadeStart; frame < overlapFrames; ++frame) {
+        const auto fadeIn = static_cast<CSAMPLE>(frame - fadeStart) / kSeamFrames;
+        for (int channel = 0; channel < channelCount; ++channel) {
+            CSAMPLE* pSample = m_buffer.data(frame * channelCount + channel);
+            const CSAMPLE secondPass =
+                    m_buffer[(m_loopFrames + frame) * channelCount + channel];
+            *pSample = secondPass + (*pSample - secondPass) * fadeIn;
+        }
+    }
+    m_replayFrame = overlapFrames;
+    m_state = State::ReplayPending;
+}
+
+mixxx::audio::FramePos KeylockLoopCache::replay(CSAMPLE* pOutput, SINT numSamples) {
+    VERIFY_OR_DEBUG_ASSERT(m_state == State::ReplayPending ||
+            m_state == State::Replaying) {
+        SampleUtil::clear(pOutput, numSamples);
+        return m_key.loopStartPosition;
+    }
+    m_state = State::Replaying;
+    const int channelCount = m_key.channelCount;
+    SINT remainingFrames = numSamples / channelCount;
+    CSAMPLE* pWrite = pOutput;
+    while (remainingFrames > 0) {
+        const SINT frames = math_min(remainingFrames, m_loopFrames - m_replayFrame);
+        SampleUtil::copy(pWrite,
+                m_buffer.data(m_replayFrame * channelCount),
+                frames * channelCount);
+        pWrite += frames * channelCount;
+        remainingFrames -= frames;
+        m_replayFrame += frames;
+        if (m_replayFrame >= m_loopFrames) {
+            m_replayFrame = 0;
+        }
+    }
+    const mixxx::audio::FrameDiff_t loopLength =
+            m_key.loopEndPosition - m_key.loopStartPosition;
+    return m_key.loopStartPosition +
+            loopLength * m_replayFrame / static_cast<double>(m_loopFrames);
+}
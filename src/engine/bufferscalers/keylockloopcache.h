@@ -0,0 +1,84 @@
+#pragma once
+
+#include "audio/frame.h"
+#include "audio/types.h"
+#include "engine/engine.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+class EngineBufferScale;
+
+/// Caches the time-stretched output of one pass through a loop, so
+/// EngineBuffer can replay it instead of stretching the same audio again.
+///
+/// Recording starts when the play position wraps around at the end of the
+/// loop and stops after one pass. When the cache is complete, EngineBuffer
+/// crossfades from the scaler to the cache and replays it until one of the
+/// parameters of the key changes, the loop ends or the deck seeks. The
+/// beginning of the cache is replaced by the output after the second wrap,
+/// which is the continuation of the end of the cache.
+///
+/// The cache is only used by the engine thread and allocated up front.
+class KeylockLoopCache {
+  public:
+    /// The parameters the cached output depends on
+    struct Key {
+        const EngineBufferScale* pScale = nullptr;
+        double baseRate = 0.0;
+        double tempoRatio = 0.0;
+        double pitchRatio = 0.0;
+        mixxx::audio::FramePos loopStartPosition;
+        mixxx::audio::FramePos loopEndPosition;
+        mixxx::audio::ChannelCount channelCount;
+#ifdef __STEM__
+        mixxx::StemChannelSelection stemPremixMask;
+#endif
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    explicit KeylockLoopCache(SINT capacitySamples);
+
+    bool isReplaying() const {
+        return m_state == State::Replaying;
+    }
+    /// The cache is complete and EngineBuffer should start replaying it
+    /// with a crossfade from the scaler
+    bool isReplayPending() const {
+        return m_state == State::ReplayPending;
+    }
+    bool matches(const Key& key) const {
+        return m_state != State::Idle && m_key == key;
+    }
+
+    void invalidate();
+
+    /// Records a buffer that has been rendered by the scaler while the play
+    /// position moved from startPosition to endPosition
+    void record(const Key& key,
+            const CSAMPLE* pOutput,
+            SINT numSamples,
+            mixxx::audio::FramePos startPosition,
+            mixxx::audio::FramePos endPosition);
+
+    /// Replays the next buffer and returns the play position after it
+    mixxx::audio::FramePos replay(CSAMPLE* pOutput, SINT numSamples);
+
+  private:
+    enum class State {
+        Idle,
+        Recording,
+        ReplayPending,
+        Replaying,
+    };
+
+    void finishRecording();
+
+    mixxx::SampleBuffer m_buffer;
+    State m_state;
+    Key m_key;
+    // The output frames of one pass through the loop
+    SINT m_loopFrames;
+    SINT m_recordedFrames;
+    SINT m_replayFrame;
+};
@@ -1,18 +1,38 @@
 #include "engine/bufferscalers/rubberbandtask.h"
 
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
 #include "engine/engine.h"
 #include "util/assert.h"
-#include "util/compatibility/qmutex.h"
+
+namespace {
+
+// About 20 to 50 microseconds, depending on the CPU
+constexpr int kSpinCount = 4000;
+
+inline void pause() {
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+} // namespace
 
 RubberBandTask::RubberBandTask(
         size_t sampleRate, size_t channels, Options options)
         : RubberBand::RubberBandStretcher(sampleRate, channels, options),
-          QRunnable(),
+          m_ready(false),
           m_completedSema(0),
+          m_pSlot(nullptr),
           m_input(nullptr),
           m_samples(0),
           m_isFinal(false) {
-    setAutoDelete(false);
 }
 
 void RubberBandTask::set(const float* const* input,
@@ -22,12 +42,18 @@ void RubberBandTask::set(const float* const* input,
     m_input = input;
     m_samples = samples;
     m_isFinal = isFinal;
+    m_ready.store(false, std::memory_order_relaxed);
 }
 
 void RubberBandTask::waitReady() {
     VERIFY_OR_DEBUG_ASSERT(m_input && m_samples) {
         return;
     };
+    for (int i = 0; i < kSpinCount && !isReady(); ++i) {
+        pause();
+    }
+    // The semaphore is always acquired, also after spinning or if the task
+    // was run by the waiting thread, so it is reset for the next task
     m_completedSema.acquire();
 }
 
@@ -38,5 +64,6 @@ void RubberBandTask::run() {
     process(m_input,
             m_samples,
             m_isFinal);
+    m_ready.store(true, std::memory_order_release);
     m_completedSema.release();
 }
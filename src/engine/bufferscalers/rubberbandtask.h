@@ -2,7 +2,6 @@
 
 #include <rubberband/RubberBandStretcher.h>
 
-#include <QRunnable>
 #include <QSemaphore>
 #include <atomic>
 
@@ -10,7 +9,7 @@
 
 using RubberBand::RubberBandStretcher;
 
-class RubberBandTask : public RubberBandStretcher, public QRunnable {
+class RubberBandTask : public RubberBandStretcher {
   public:
     RubberBandTask(size_t sampleRate,
             size_t channels,
@@ -26,15 +25,28 @@ class RubberBandTask : public RubberBandStretcher, public QRunnable {
             size_t samples,
             bool isFinal);
 
-    // Wait for the current task to complete.
+    bool isReady() const {
+        return m_ready.load(std::memory_order_acquire);
+    }
+
+    /// Wait for the current task to complete. Spins for a short while,
+    /// because the remaining work is usually much shorter than a wake up
+    /// of a parked thread, and parks the calling thread after that.
     void waitReady();
 
     void run();
 
   private:
+    friend class RubberBandWorkerPool;
+
     // Whether or not the scheduled job as completed
+    std::atomic<bool> m_ready;
     QSemaphore m_completedSema;
 
+    // The queue slot of the RubberBandWorkerPool holding the task until
+    // it is claimed. Only accessed by the submitting thread.
+    std::atomic<RubberBandTask*>* m_pSlot;
+
     const float* const* m_input;
     size_t m_samples;
     bool m_isFinal;
@@ -2,11 +2,98 @@
 
 #include <rubberband/RubberBandStretcher.h>
 
+#include <QSemaphore>
+#include <QThread>
+#include <array>
+
+#include "engine/bufferscalers/rubberbandtask.h"
 #include "engine/engine.h"
 #include "util/assert.h"
+#include "util/realtime.h"
+#include "util/realtimecheck.h"
+#include "util/tracing.h"
+
+class RubberBandWorkerPool::Worker : public QThread {
+  public:
+    Worker(RubberBandWorkerPool* pPool, int index)
+            : m_pPool(pPool),
+              m_index(index),
+              m_busy(false) {
+        for (auto& slot : m_slots) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+        setObjectName(QStringLiteral("RubberBandWorker %1").arg(index));
+    }
+
+    bool isBusy() const {
+        return m_busy.load(std::memory_order_acquire);
+    }
+
+    /// Puts the task into a free slot and wakes the worker
+    std::atomic<RubberBandTask*>* enqueue(RubberBandTask* pTask) {
+        for (auto& slot : m_slots) {
+            RubberBandTask* pExpected = nullptr;
+            if (slot.compare_exchange_strong(pExpected,
+                        pTask,
+                        std::memory_order_release,
+                        std::memory_order_relaxed)) {
+                m_semaphore.release();
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    RubberBandTask* claim() {
+        for (auto& slot : m_slots) {
+            RubberBandTask* pTask = slot.load(std::memory_order_relaxed);
+            if (pTask &&
+                    slot.compare_exchange_strong(pTask,
+                            nullptr,
+                            std::memory_order_acq_rel,
+                            std::memory_order_relaxed)) {
+                return pTask;
+            }
+        }
+        return nullptr;
+    }
+
+    void wake() {
+        m_semaphore.release();
+    }
+
+  protected:
+    void run() override {
+        mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::EngineWorker);
+        mixxx::tracing::registerCurrentThread(objectName());
+        while (true) {
+            m_semaphore.acquire();
+            if (m_pPool->m_stop.load(std::memory_order_acquire)) {
+                break;
+            }
+            m_busy.store(true, std::memory_order_release);
+            // Process the own queue first, then steal from the others
+            for (RubberBandTask* pTask = m_pPool->claimTask(m_index); pTask;
+                    pTask = m_pPool->claimTask(m_index)) {
+                const mixxx::realtime::Check::ScopedSection realtimeSection;
+                pTask->run();
+            }
+            m_busy.store(false, std::memory_order_release);
+        }
+    }
+
+  private:
+    RubberBandWorkerPool* const m_pPool;
+    const int m_index;
+
+    std::array<std::atomic<RubberBandTask*>, kSlotsPerWorker> m_slots;
+    std::atomic<bool> m_busy;
+    QSemaphore m_semaphore;
+};
 
 RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
-        : QThreadPool() {
+        : m_nextAffinity(0),
+          m_stop(false) {
     bool multiThreadedOnStereo = pConfig &&
             pConfig->getValue(ConfigKey(QStringLiteral("[App]"),
                                       QStringLiteral("keylock_multithreading")),
@@ -21,16 +108,93 @@ RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
 
     qDebug() << "RubberBand will use" << numRBTasks << "tasks to scale the audio signal";
 
-    setThreadPriority(QThread::HighPriority);
-    // The RB pool will only be used to scale n-1 buffer sample, so the engine
-    // thread takes care of the last buffer and doesn't have to be idle.
-    setMaxThreadCount(numRBTasks - 1);
-
-    // We allocate one runner less than the total of maximum supported channel,
+    // We spawn one worker less than the total of maximum supported tasks,
     // so the engine thread will also perform a stretching operation, instead of
     // waiting all workers to complete. During performance testing, this ahas
     // show better results
-    for (int w = 0; w < maxThreadCount(); w++) {
-        reserveThread();
+    const int numWorkers = numRBTasks - 1;
+    m_workers.reserve(numWorkers);
+    for (int w = 0; w < numWorkers; w++) {
+        m_workers.push_back(std::make_unique<Worker>(this, w));
+    }
+    // The engine thread waits for the workers, so they must not be
+    // preempted by threads with a lower priority than the engine
+    for (const auto& pWorker : m_workers) {
+        pWorker->start(QThread::TimeCriticalPriority);
+    }
+}
+
+RubberBandWorkerPool::~RubberBandWorkerPool() {
+    m_stop.store(true, std::memory_order_release);
+    for (const auto& pWorker : m_workers) {
+        pWorker->wake();
+    }
+    for (const auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+}
+
+bool RubberBandWorkerPool::submit(RubberBandTask* pTask, int affinity) {
+    if (m_workers.empty()) {
+        return false;
+    }
+    const int numWorkers = static_cast<int>(m_workers.size());
+    const int preferred = affinity % numWorkers;
+    // Prefer an idle worker over the affinity, the task would have to be
+    // stolen from a busy one anyway
+    for (int i = 0; i < numWorkers; ++i) {
+        Worker* pWorker = m_workers[(preferred + i) % numWorkers].get();
+        if (!pWorker->isBusy()) {
+            pTask->m_pSlot = pWorker->enqueue(pTask);
+            if (pTask->m_pSlot) {
+                return true;
+            }
+        }
+    }
+    for (int i = 0; i < numWorkers; ++i) {
+        pTask->m_pSlot = m_workers[(preferred + i) % numWorkers]->enqueue(pTask);
+        if (pTask->m_pSlot) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RubberBandWorkerPool::runIfQueued(RubberBandTask* pTask) {
+    VERIFY_OR_DEBUG_ASSERT(pTask->m_pSlot) {
+        return false;
+    }
+    RubberBandTask* pExpected = pTask;
+    if (!pTask->m_pSlot->compare_exchange_strong(pExpected,
+                nullptr,
+                std::memory_order_acq_rel,
+                std::memory_order_relaxed)) {
+        return false;
+    }
+    pTask->run();
+    return true;
+}
+
+void RubberBandWorkerPool::waitReady(RubberBandTask* pTask) {
+    // Help while waiting. Only tasks in the queues are taken, which might
+    // be tasks of other decks that are also waited for.
+    while (!pTask->isReady()) {
+        RubberBandTask* pQueuedTask = claimTask(0);
+        if (!pQueuedTask) {
+            break;
+        }
+        pQueuedTask->run();
+    }
+    pTask->waitReady();
+}
+
+RubberBandTask* RubberBandWorkerPool::claimTask(int workerIndex) {
+    const int numWorkers = static_cast<int>(m_workers.size());
+    for (int i = 0; i < numWorkers; ++i) {
+        RubberBandTask* pTask = m_workers[(workerIndex + i) % numWorkers]->claim();
+        if (pTask) {
+            return pTask;
+        }
     }
+    return nullptr;
 }
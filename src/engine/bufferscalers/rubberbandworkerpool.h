@@ -1,26 +1,75 @@
 #pragma once
 
-#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "audio/types.h"
 #include "preferences/usersettings.h"
 #include "util/singleton.h"
 
-// RubberBandWorkerPool is a global pool manager for RubberBandWorkerPool. It
-// allows a the Engine thread to use a pool of agnostic RubberBandWorker which
-// can be distributed stretching job
-class RubberBandWorkerPool : public QThreadPool, public Singleton<RubberBandWorkerPool> {
+class RubberBandTask;
+
+// RubberBandWorkerPool is a global pool of worker threads, which allows the
+// Engine thread to distribute the stretching job of a multichannel track over
+// several agnostic RubberBandTask.
+//
+// Every worker has its own queue. A RubberBandWrapper prefers the same worker
+// for each of its tasks (the affinity), so the stretcher state stays in the
+// cache of that core. Idle workers steal tasks from the queues of the busy
+// ones, and a thread waiting for its tasks runs the queued tasks itself
+// instead of sleeping. A task is never stuck behind the work of another deck.
+//
+// The queues are arrays of atomic slots and a task is claimed by whoever
+// takes it out of its slot, so submitting and claiming is lock-free.
+class RubberBandWorkerPool : public Singleton<RubberBandWorkerPool> {
   public:
+    ~RubberBandWorkerPool() override;
+
     const mixxx::audio::ChannelCount& channelPerWorker() const {
         return m_channelPerWorker;
     }
 
+    int numWorkers() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    /// Returns a new affinity for the tasks of a RubberBandWrapper
+    int nextAffinity() {
+        return m_nextAffinity.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Queues the task, preferably for the worker of the given affinity.
+    /// Returns false if there is no free slot, the caller has to run the
+    /// task itself then.
+    bool submit(RubberBandTask* pTask, int affinity);
+
+    /// Runs the task in the calling thread if no worker has started it
+    /// yet. The task must have been submitted by the calling thread.
+    /// Returns false if the task has already been claimed by a worker.
+    bool runIfQueued(RubberBandTask* pTask);
+
+    /// Waits for a submitted task to complete. Until then, the calling
+    /// thread runs other queued tasks.
+    void waitReady(RubberBandTask* pTask);
+
   protected:
     RubberBandWorkerPool(UserSettingsPointer pConfig = nullptr);
 
   private:
-    ;
+    // More than the number of tasks of all decks
+    static constexpr int kSlotsPerWorker = 16;
+
+    class Worker;
+
+    // Claims a queued task, starting with the queue of the given worker
+    RubberBandTask* claimTask(int workerIndex);
+
     mixxx::audio::ChannelCount m_channelPerWorker;
 
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<int> m_nextAffinity;
+    std::atomic<bool> m_stop;
+
     friend class Singleton<RubberBandWorkerPool>;
 };
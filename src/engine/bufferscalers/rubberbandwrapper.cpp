@@ -53,7 +53,7 @@ mixxx::audio::ChannelCount getChannelPerWorker(mixxx::audio::ChannelCount chCoun
     }
     auto channelPerWorker = pPool->channelPerWorker();
     // The task count includes all the thread in the pool + the engine thread
-    auto maxThreadCount = pPool->maxThreadCount() + 1;
+    auto maxThreadCount = pPool->numWorkers() + 1;
     VERIFY_OR_DEBUG_ASSERT(chCount % channelPerWorker == 0) {
         return mixxx::kEngineChannelOutputCount;
     }
@@ -182,21 +182,35 @@ void RubberBandWrapper::process(const float* const* input, size_t samples, bool
         return m_pInstances[0]->process(input, samples, isFinal);
     } else {
         RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
-        for (auto& pInstance : m_pInstances) {
-            pInstance->set(input, samples, isFinal);
-            // We try to get the stretching job ran by the RBPool if there is a
-            // worker slot available
-            if (!pPool->tryStart(pInstance.get())) {
+        // The main thread takes care of the last task, all others are
+        // queued for the workers of this wrapper's affinity
+        const std::size_t numQueued = m_pInstances.size() - 1;
+        for (std::size_t i = 0; i < numQueued; ++i) {
+            m_pInstances[i]->set(input, samples, isFinal);
+            m_queued[i] = pPool->submit(m_pInstances[i].get(),
+                    m_affinity + static_cast<int>(i));
+            if (!m_queued[i]) {
                 // Otherwise, it means the main thread should take care of the stretching
-                pInstance->run();
+                m_pInstances[i]->run();
             }
             input += m_channelPerWorker;
         }
+        m_pInstances.back()->set(input, samples, isFinal);
+        m_pInstances.back()->run();
+        // Tasks that no worker has started yet, e.g. because the worker is
+        // still busy with another deck, are run by the main thread instead
+        // of waiting for them
+        for (std::size_t i = 0; i < numQueued; ++i) {
+            if (m_queued[i]) {
+                pPool->runIfQueued(m_pInstances[i].get());
+            }
+        }
         // We always perform a wait, even for task that were ran in the main
         // thread, so it resets the semaphore
-        for (auto& pInstance : m_pInstances) {
-            pInstance->waitReady();
+        for (std::size_t i = 0; i < numQueued; ++i) {
+            pPool->waitReady(m_pInstances[i].get());
         }
+        m_pInstances.back()->waitReady();
     }
 }
 void RubberBandWrapper::reset() {
@@ -206,6 +220,7 @@ void RubberBandWrapper::reset() {
 }
 void RubberBandWrapper::clear() {
     m_pInstances.clear();
+    m_queued.clear();
 }
 void RubberBandWrapper::setup(mixxx::audio::SampleRate sampleRate,
         mixxx::audio::ChannelCount chCount,
@@ -234,6 +249,12 @@ void RubberBandWrapper::setup(mixxx::audio::SampleRate sampleRate,
                 std::make_unique<RubberBandTask>(
                         sampleRate, m_channelPerWorker, opt));
     }
+    m_queued.resize(m_pInstances.size());
+    if (m_pInstances.size() > 1) {
+        // Keep the tasks of this deck on the same workers
+        m_affinity = RubberBandWorkerPool::instance()->nextAffinity() *
+                static_cast<int>(m_pInstances.size() - 1);
+    }
 }
 void RubberBandWrapper::setPitchScale(double scale) {
     for (auto& stretcher : m_pInstances) {
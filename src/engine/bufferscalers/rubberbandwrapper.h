@@ -32,6 +32,11 @@ class RubberBandWrapper {
   private:
     // copy constructor of RubberBand::RubberBandStretcher is implicitly deleted.
     std::vector<std::unique_ptr<RubberBandTask>> m_pInstances;
+    // Whether the task of the instance with the same index has been queued
+    // for a worker, instead of being run by the main thread
+    std::vector<bool> m_queued;
+    // The preferred worker of the first task
+    int m_affinity = 0;
     // Number of channel used for each instance. This may vary whether the track
     // is a stereo track or a stem track
     mixxx::audio::ChannelCount m_channelPerWorker;
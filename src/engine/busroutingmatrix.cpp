@@ -0,0 +1,72 @@
+#include "engine/busroutingmatrix.h"
+
+#include <QVarLengthArray>
+
+#include "engine/channelmixer.h"
+#include "util/assert.h"
+#include "util/sample.h"
+
+BusRoutingMatrix::BusRoutingMatrix(int numSources, int numBuses)
+        : m_numSources(numSources),
+          m_numBuses(numBuses),
+          m_gains(static_cast<std::size_t>(numSources) * numBuses, CSAMPLE_GAIN_ZERO),
+          m_oldGains(m_gains) {
+    DEBUG_ASSERT(numSources >= 0);
+    DEBUG_ASSERT(numBuses >= 0);
+}
+
+std::size_t BusRoutingMatrix::cell(int source, int bus) const {
+    DEBUG_ASSERT(source >= 0 && source < m_numSources);
+    DEBUG_ASSERT(bus >= 0 && bus < m_numBuses);
+    return static_cast<std::size_t>(bus) * m_numSources + source;
+}
+
+CSAMPLE_GAIN BusRoutingMatrix::gain(int source, int bus) const {
+    return m_gains[cell(source, bus)];
+}
+
+void BusRoutingMatrix::setGain(int source, int bus, CSAMPLE_GAIN gain) {
+    m_gains[cell(source, bus)] = gain;
+}
+
+void BusRoutingMatrix::setBusGain(int bus, CSAMPLE_GAIN gain) {
+    for (int source = 0; source < m_numSources; ++source) {
+        setGain(source, bus, gain);
+    }
+}
+
+void BusRoutingMatrix::skipGainRamps() {
+    m_oldGains = m_gains;
+}
+
+void BusRoutingMatrix::process(const CSAMPLE* const* pSources,
+        CSAMPLE* const* pOutputs,
+        std::size_t bufferSize) {
+    QVarLengthArray<ChannelMixer::RampingSource, kPreallocatedChannels> rampingSources;
+    for (int bus = 0; bus < m_numBuses; ++bus) {
+        CSAMPLE* pOutput = pOutputs[bus];
+        if (!pOutput) {
+            continue;
+        }
+        rampingSources.clear();
+        for (int source = 0; source < m_numSources; ++source) {
+            const std::size_t i = cell(source, bus);
+            const CSAMPLE_GAIN oldGain = m_oldGains[i];
+            const CSAMPLE_GAIN newGain = m_gains[i];
+            m_oldGains[i] = newGain;
+            if (oldGain == CSAMPLE_GAIN_ZERO && newGain == CSAMPLE_GAIN_ZERO) {
+                continue;
+            }
+            // Calculates the gains like SampleUtil::addWithRampingGain()
+            const CSAMPLE_GAIN gainDelta =
+                    (newGain - oldGain) / CSAMPLE_GAIN(bufferSize / 2);
+            rampingSources.append(ChannelMixer::RampingSource{
+                    pSources[source], oldGain + gainDelta, gainDelta});
+        }
+        SampleUtil::clear(pOutput, bufferSize);
+        ChannelMixer::addRampingSources(pOutput,
+                rampingSources.constData(),
+                static_cast<int>(rampingSources.size()),
+                bufferSize);
+    }
+}
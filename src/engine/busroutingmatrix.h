@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "util/types.h"
+
+/// Routes a number of stereo source buffers to a number of output buses
+/// with an individual gain for every cell of the matrix.
+///
+/// All sources of a bus are mixed in a single pass over its output buffer
+/// by ChannelMixer::addRampingSources(). Gain changes are ramped over one
+/// buffer like SampleUtil::addWithRampingGain(). Cells without gain are
+/// skipped, and buses without an output buffer are not processed at all,
+/// so adding a bus only costs a column of the matrix.
+class BusRoutingMatrix {
+  public:
+    BusRoutingMatrix(int numSources, int numBuses);
+
+    int numSources() const {
+        return m_numSources;
+    }
+    int numBuses() const {
+        return m_numBuses;
+    }
+
+    /// The gain that is applied when processing the next buffer
+    CSAMPLE_GAIN gain(int source, int bus) const;
+    void setGain(int source, int bus, CSAMPLE_GAIN gain);
+    void setBusGain(int bus, CSAMPLE_GAIN gain);
+    /// Applies the current gains to the next buffer without ramping, e.g.
+    /// for the initial gains.
+    void skipGainRamps();
+
+    /// Overwrites each bus in pOutputs, which holds numBuses() buffers, with
+    /// the mix of the numSources() buffers in pSources. Buses with a nullptr
+    /// output are skipped and keep ramping from their previous gains when
+    /// they are processed again.
+    void process(const CSAMPLE* const* pSources,
+            CSAMPLE* const* pOutputs,
+            std::size_t bufferSize);
+
+  private:
+    std::size_t cell(int source, int bus) const;
+
+    const int m_numSources;
+    const int m_numBuses;
+    // Bus-major, i.e. the sources of a bus are adjacent
+    std::vector<CSAMPLE_GAIN> m_gains;
+    std::vector<CSAMPLE_GAIN> m_oldGains;
+};
@@ -1,13 +1,24 @@
 #include "engine/cachingreader/cachingreader.h"
 
 #include <QtDebug>
+#include <limits>
 
+#if defined(__WINDOWS__)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "engine/engineprofiler.h"
+#include "mixer/playermanager.h"
 #include "moc_cachingreader.cpp"
+#include "track/track.h"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
-#include "util/counter.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/sample.h"
+#include "util/tracing.h"
 
 namespace {
 
@@ -23,7 +34,8 @@ constexpr SINT kDefaultHintFrames = 1024;
 //
 //     80 chunks ->  5120 KB =  5 MB
 //
-// Each deck (including sample decks) will use their own CachingReader.
+// Each deck (including sample decks) will use their own CachingReader,
+// samplers use fewer chunks by default, see below.
 // Consequently the total memory required for all allocated chunks depends
 // on the number of decks. The amount of memory reserved for a single
 // CachingReader must be multiplied by the number of decks to calculate
@@ -33,14 +45,130 @@ constexpr SINT kDefaultHintFrames = 1024;
 // (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
 // to verify that the MRU/LRU cache works as expected. Even though
 // massive drop outs are expected to occur Mixxx should run reliably!
-constexpr SINT kNumberOfCachedChunksInMemory = 80;
+//
+// This is only the initial number of chunks, it can be configured per
+// deck and grows when loading tracks with many cues.
+constexpr int kNumberOfCachedChunksInMemory = 80;
+
+// Samplers preload their tracks by default and only need the chunks until
+// the track buffer is complete. 16 chunks -> 1 MB
+constexpr int kNumberOfCachedChunksInSampler = 16;
+
+// Every cue (hot cue, loop, intro/outro marker) is hinted with a range
+// of kDefaultHintFrames that may span two chunks.
+constexpr int kChunksPerCue = 2;
+
+// Hints for the current and the predicted positions of the playback, which
+// underflow if their chunks are not read in time
+bool isPlaybackHint(Hint::Type type) {
+    switch (type) {
+    case Hint::Type::SlipPosition:
+    case Hint::Type::CurrentPosition:
+    case Hint::Type::Prefetch:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Grow the pool in steps to avoid frequent small allocations
+constexpr int kMinChunkGrowth = 16;
+
+// A single CachingReader must never use more than this fraction of the
+// physical memory.
+constexpr int kPhysicalMemoryFraction = 64;
+
+// Fallback if the physical memory could not be determined
+constexpr int kDefaultMaxChunkCount = 4 * kNumberOfCachedChunksInMemory;
+
+const QString kChunkCountKey = QStringLiteral("cachingreader_chunks");
+const QString kPreloadTrackKey = QStringLiteral("preload_track");
+
+quint64 physicalMemoryBytes() {
+#if defined(__WINDOWS__)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) {
+        return 0;
+    }
+    return status.ullTotalPhys;
+#elif defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) {
+        return 0;
+    }
+    return static_cast<quint64>(pages) * static_cast<quint64>(pageSize);
+#else
+    return 0;
+#endif
+}
+
+int initialChunkCount(const UserSettingsPointer& pConfig, const QString& group) {
+    if (!pConfig) {
+        return kNumberOfCachedChunksInMemory;
+    }
+    const int defaultChunkCount = PlayerManager::isSamplerGroup(group) &&
+                    pConfig->getValue(ConfigKey(group, kPreloadTrackKey), true)
+            ? kNumberOfCachedChunksInSampler
+            : kNumberOfCachedChunksInMemory;
+    const int chunkCount = pConfig->getValue(
+            ConfigKey(group, kChunkCountKey), defaultChunkCount);
+    VERIFY_OR_DEBUG_ASSERT(chunkCount > 0) {
+        return defaultChunkCount;
+    }
+    return chunkCount;
+}
+
+qint64 chunkBytes(int chunkCount, mixxx::audio::ChannelCount maxSupportedChannel) {
+    return static_cast<qint64>(CachingReaderChunk::kFrames) * chunkCount *
+            maxSupportedChannel * static_cast<qint64>(sizeof(CSAMPLE));
+}
+
+int maxChunkCount(mixxx::audio::ChannelCount maxSupportedChannel, int initialChunkCount) {
+    const auto bytesPerChunk = static_cast<quint64>(chunkBytes(1, maxSupportedChannel));
+    const quint64 memoryBytes = physicalMemoryBytes();
+    if (memoryBytes == 0) {
+        return math_max(kDefaultMaxChunkCount, initialChunkCount);
+    }
+    const auto maxCount = static_cast<int>(math_min<quint64>(
+            memoryBytes / kPhysicalMemoryFraction / bytesPerChunk,
+            std::numeric_limits<int>::max()));
+    // The configured number of chunks always takes precedence
+    return math_max(maxCount, initialChunkCount);
+}
 
 } // anonymous namespace
 
+CachingReader::ChunkBlock::ChunkBlock(
+        int chunkCount, mixxx::audio::ChannelCount maxSupportedChannel)
+        : sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel * chunkCount) {
+    chunks.reserve(chunkCount);
+    // Divide up the allocated raw memory buffer into chunkCount
+    // chunks. Initialize each chunk to hold nothing.
+    for (int i = 0; i < chunkCount; ++i) {
+        chunks.push_back(new CachingReaderChunkForOwner(
+                mixxx::SampleBuffer::WritableSlice(
+                        sampleBuffer,
+                        CachingReaderChunk::kFrames * maxSupportedChannel * i,
+                        CachingReaderChunk::kFrames * maxSupportedChannel)));
+    }
+}
+
+CachingReader::ChunkBlock::~ChunkBlock() {
+    qDeleteAll(chunks);
+}
+
 CachingReader::CachingReader(const QString& group,
         UserSettingsPointer config,
         mixxx::audio::ChannelCount maxSupportedChannel)
         : m_pConfig(config),
+          m_group(group),
+          m_maxSupportedChannel(maxSupportedChannel),
+          m_initialChunkCount(initialChunkCount(config, group)),
+          m_maxChunkCount(maxChunkCount(maxSupportedChannel, m_initialChunkCount)),
+          m_requestedChunkCount(m_initialChunkCount),
+          m_allocatedBytes(0),
           // Limit the number of in-flight requests to the worker. This should
           // prevent to overload the worker when it is not able to fetch those
           // requests from the FIFO timely. Otherwise outdated requests pile up
@@ -53,31 +181,37 @@ CachingReader::CachingReader(const QString& group,
           m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
           // The capacity of the back channel must be equal to the number of
           // allocated chunks, because the worker use writeBlocking(). Otherwise
-          // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          // the worker could get stuck in a hot loop!!! The number of chunks
+          // may grow up to m_maxChunkCount.
+          m_readerStatusUpdateFIFO(m_maxChunkCount),
+          m_pendingReadRequestCount(0),
+          m_chunkBlockFIFO(m_maxChunkCount / kMinChunkGrowth + 1),
+          m_cacheHitCounter(QStringLiteral("CachingReader %1 chunk cache hit").arg(group)),
+          m_cacheMissCounter(QStringLiteral("CachingReader %1 chunk cache miss").arg(group)),
+          m_cacheEvictionCounter(
+                  QStringLiteral("CachingReader %1 chunk cache eviction").arg(group)),
           m_state(STATE_IDLE),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel *
-                  kNumberOfCachedChunksInMemory),
+          m_pTrackBuffer(nullptr),
           m_worker(group,
                   &m_chunkReadRequestFIFO,
                   &m_readerStatusUpdateFIFO,
                   maxSupportedChannel) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
-    // Divide up the allocated raw memory buffer into total_chunks
-    // chunks. Initialize each chunk to hold nothing and add it to the free
-    // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
-        CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
-                        mixxx::SampleBuffer::WritableSlice(
-                                m_sampleBuffer,
-                                CachingReaderChunk::kFrames * maxSupportedChannel * i,
-                                CachingReaderChunk::kFrames * maxSupportedChannel));
-        m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
-    }
+    // Reserve all memory for book keeping upfront to avoid allocations
+    // when receiving new chunks in the engine thread.
+    m_chunks.reserve(m_maxChunkCount);
+    m_chunkBlocks.reserve(m_maxChunkCount / kMinChunkGrowth + 2);
+    m_freeChunks.reserve(m_maxChunkCount);
+    m_allocatedCachingReaderChunks.reserve(m_maxChunkCount);
+    addChunkBlock(std::make_unique<ChunkBlock>(
+            m_requestedChunkCount, m_maxSupportedChannel));
+    m_allocatedBytes += chunkBytes(m_requestedChunkCount, m_maxSupportedChannel);
+    // The chunk pool is never shrunk, because it is owned by the engine thread
+    m_memoryUsage = mixxx::MemoryUsage::registerSubsystem(
+            QStringLiteral("CachingReader"), [this] {
+                return m_allocatedBytes.load(std::memory_order_relaxed);
+            });
 
     // Forward signals from worker
     connect(&m_worker, &CachingReaderWorker::trackLoading,
@@ -95,7 +229,67 @@ CachingReader::CachingReader(const QString& group,
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
-    qDeleteAll(m_chunks);
+    ChunkBlock* pBlock;
+    while (m_chunkBlockFIFO.read(&pBlock, 1) == 1) {
+        delete pBlock;
+    }
+    // The chunks are owned and deleted by m_chunkBlocks
+    m_chunks.clear();
+}
+
+void CachingReader::addChunkBlock(std::unique_ptr<ChunkBlock> pBlock) {
+    DEBUG_ASSERT(m_chunks.size() + static_cast<int>(pBlock->chunks.size()) <=
+            m_maxChunkCount);
+    for (auto* pChunk : pBlock->chunks) {
+        m_chunks.push_back(pChunk);
+        m_freeChunks.push_back(pChunk);
+    }
+    m_chunkBlocks.push_back(std::move(pBlock));
+}
+
+void CachingReader::receiveChunkBlocks() {
+    ChunkBlock* pBlock;
+    while (m_chunkBlockFIFO.read(&pBlock, 1) == 1) {
+        if (kLogger.debugEnabled()) {
+            kLogger.debug()
+                    << "Adding" << pBlock->chunks.size()
+                    << "chunks to the pool of" << m_chunks.size() << "chunks";
+        }
+        addChunkBlock(std::unique_ptr<ChunkBlock>(pBlock));
+    }
+}
+
+void CachingReader::growChunkPool(const TrackPointer& pTrack) {
+    if (!pTrack) {
+        return;
+    }
+    const int requiredCount = math_min(
+            m_initialChunkCount + kChunksPerCue * static_cast<int>(pTrack->getEngineSnapshot()->cues.size()),
+            m_maxChunkCount);
+    if (requiredCount <= m_requestedChunkCount) {
+        return;
+    }
+    const int growth = math_min(
+            math_max(requiredCount - m_requestedChunkCount, kMinChunkGrowth),
+            m_maxChunkCount - m_requestedChunkCount);
+    // Allocated here, outside of the engine thread
+    auto* pBlock = new ChunkBlock(growth, m_maxSupportedChannel);
+    if (m_chunkBlockFIFO.write(&pBlock, 1) != 1) {
+        kLogger.warning()
+                << "Failed to hand over"
+                << growth
+                << "new chunks to the engine thread";
+        delete pBlock;
+        return;
+    }
+    kLogger.info()
+            << "Growing the chunk pool from"
+            << m_requestedChunkCount
+            << "to"
+            << m_requestedChunkCount + growth
+            << "chunks";
+    m_requestedChunkCount += growth;
+    m_allocatedBytes += chunkBytes(growth, m_maxSupportedChannel);
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
@@ -141,8 +335,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
     if (m_freeChunks.empty()) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
+    CachingReaderChunkForOwner* pChunk = m_freeChunks.back();
+    m_freeChunks.pop_back();
 
     pChunk->init(chunkIndex);
 
@@ -155,6 +349,7 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     auto* pChunk = allocateChunk(chunkIndex);
     if (!pChunk) {
         if (m_lruCachingReaderChunk) {
+            m_cacheEvictionCounter.increment();
             freeChunk(m_lruCachingReaderChunk);
             pChunk = allocateChunk(chunkIndex);
         } else {
@@ -224,6 +419,14 @@ void CachingReader::newTrack(TrackPointer pTrack) {
         kLogger.warning()
                 << "Loading a new track while loading a track may lead to inconsistent states";
     }
+    growChunkPool(pTrack);
+    if (m_pConfig) {
+        // Samplers are short and retriggered constantly, preload them
+        // by default.
+        m_worker.setPreloadTrack(m_pConfig->getValue(
+                ConfigKey(m_group, kPreloadTrackKey),
+                PlayerManager::isSamplerGroup(m_group)));
+    }
 #ifdef __STEM__
     m_worker.newTrack(std::move(pTrack), stemMask);
 #else
@@ -233,11 +436,14 @@ void CachingReader::newTrack(TrackPointer pTrack) {
 
 // Called from the engine thread
 void CachingReader::process() {
+    receiveChunkBlocks();
     ReaderStatusUpdate update;
     while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
         auto* pChunk = update.takeFromWorker();
         if (pChunk) {
             // Result of a read request (with a chunk)
+            DEBUG_ASSERT(m_pendingReadRequestCount > 0);
+            --m_pendingReadRequestCount;
             DEBUG_ASSERT(atomicLoadRelaxed(m_state) != STATE_IDLE);
             DEBUG_ASSERT(
                     update.status == CHUNK_READ_SUCCESS ||
@@ -284,9 +490,22 @@ void CachingReader::process() {
                 }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                // The track buffer of the previous track is gone
+                m_pTrackBuffer = nullptr;
                 m_state.storeRelease(STATE_TRACK_LOADED);
+            } else if (update.status == TRACK_PRELOADED) {
+                // Results for the previous track are discarded while
+                // loading the next track. The worker may already have
+                // deleted the track buffer.
+                if (m_state.loadAcquire() == STATE_TRACK_LOADED) {
+                    m_pTrackBuffer = update.getTrackBuffer();
+                    m_readableFrameIndexRange = intersect(
+                            m_readableFrameIndexRange,
+                            update.readableFrameIndexRange());
+                }
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
+                m_pTrackBuffer = nullptr;
                 // This message could be processed later when a new
                 // track is already loading! In this case the TRACK_LOADED will
                 // be the very next status update.
@@ -305,6 +524,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
         bool reverse,
         CSAMPLE* buffer,
         mixxx::audio::ChannelCount channelCount) {
+    MIXXX_TRACE_SCOPE("CachingReader::read");
     // Check for bad inputs
     // Refuse to read from an invalid position
     VERIFY_OR_DEBUG_ASSERT(startSample % channelCount == 0) {
@@ -448,8 +668,26 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
-                if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                const CachingReaderChunkForOwner* const pChunk =
+                        m_pTrackBuffer ? nullptr : lookupChunkAndFreshen(chunkIndex);
+                if (m_pTrackBuffer) {
+                    // The whole track is in memory. Read all remaining
+                    // frames at once and bypass the chunk cache.
+                    if (reverse) {
+                        bufferedFrameIndexRange =
+                                m_pTrackBuffer->readBufferedSampleFramesReverse(
+                                        &buffer[samplesRemaining],
+                                        channelCount,
+                                        remainingFrameIndexRange);
+                    } else {
+                        bufferedFrameIndexRange =
+                                m_pTrackBuffer->readBufferedSampleFrames(
+                                        buffer,
+                                        channelCount,
+                                        remainingFrameIndexRange);
+                    }
+                } else if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    m_cacheHitCounter.increment();
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -469,7 +707,8 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    m_cacheMissCounter.increment();
+                    EngineProfiler::ScopedChannelStage::countCacheMiss();
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -524,6 +763,10 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                 DEBUG_ASSERT(samplesRemaining >= chunkSamples);
                 samplesRemaining -= chunkSamples;
                 remainingFrameIndexRange.shrinkFront(bufferedFrameIndexRange.length());
+                if (m_pTrackBuffer) {
+                    // Everything readable has been read from the track buffer
+                    break;
+                }
             }
         }
     }
@@ -542,9 +785,18 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         return;
     }
 
+    // No chunks are needed if the whole track is in memory
+    if (m_pTrackBuffer) {
+        return;
+    }
+
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
+    // The frames until the first missing chunk is needed for playback. The
+    // direction of the playback is unknown, so the distance to the nearer
+    // end of the hinted range is used.
+    SINT deadlineFrames = EngineWorker::kNoDeadline;
 
     for (const auto& hint: hintList) {
         SINT hintFrame = hint.frame;
@@ -607,6 +859,16 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                     // Revoke the chunk from the worker and free it
                     pChunk->takeFromWorker();
                     freeChunk(pChunk);
+                    continue;
+                }
+                ++m_pendingReadRequestCount;
+                if (isPlaybackHint(hint.type)) {
+                    const SINT chunkStartFrame = chunkIndex * CachingReaderChunk::kFrames;
+                    const SINT chunkEndFrame = chunkStartFrame + CachingReaderChunk::kFrames;
+                    const SINT chunkDeadlineFrames = math_max<SINT>(0,
+                            math_min(chunkStartFrame - readableFrameIndexRange.start(),
+                                    readableFrameIndexRange.end() - chunkEndFrame));
+                    deadlineFrames = math_min(deadlineFrames, chunkDeadlineFrames);
                 }
             } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
                 // This will cause the chunk to be 'freshened' in the cache. The
@@ -618,6 +880,6 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
 
     // If there are chunks to be read, wake up.
     if (shouldWake) {
-        m_worker.workReady();
+        m_worker.workReady(deadlineFrames);
     }
 }
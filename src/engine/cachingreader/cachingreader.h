@@ -5,12 +5,16 @@
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
-#include <list>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
+#include "util/counter.h"
 #include "util/fifo.h"
+#include "util/memoryusage.h"
 #include "util/types.h"
 
 // A Hint is an indication to the CachingReader that a certain section of a
@@ -20,6 +24,7 @@ typedef struct Hint {
     enum class Type {
         SlipPosition,     // prio 1 (so far unused Mixxx 2.3 priority for reference)
         CurrentPosition,  // prio 1
+        Prefetch,         // prio 1, the predicted positions of the next callbacks
         LoopStartEnabled, // prio 2
         MainCue,          // prio 10
         HotCue,           // prio 10
@@ -76,6 +81,17 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// The number of chunks is not fixed. It starts with a configurable number of
+// chunks per deck and grows when a track with many cues is loaded, because
+// all those positions are kept in the cache by hints. The additional chunks
+// are allocated outside of the engine thread (see newTrack) and handed over
+// through a FIFO. The pool never shrinks and is limited by the amount of
+// physical memory.
+//
+// Players can be configured to decode the whole track into memory in the
+// background after loading it. Once complete, read() serves all requests
+// from that track buffer and bypasses the chunk cache.
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -86,6 +102,10 @@ class CachingReader : public QObject {
             mixxx::audio::ChannelCount maxSupportedChannel);
     ~CachingReader() override;
 
+    const QString& getGroup() const {
+        return m_group;
+    }
+
     void process();
 
     enum class ReadResult {
@@ -113,6 +133,13 @@ class CachingReader : public QObject {
     // from the engine callback.
     void hintAndMaybeWake(const HintVector& hintList);
 
+    // Returns true if the worker has not answered all read requests yet,
+    // including those whose results are waiting to be received by process().
+    // Must only be called from the engine thread.
+    bool hasPendingReadRequests() const {
+        return m_pendingReadRequestCount > 0;
+    }
+
     // Request that the CachingReader load a new track. These requests are
     // processed in the work thread, so the reader must be woken up via wake()
     // for this to take effect.
@@ -136,12 +163,53 @@ class CachingReader : public QObject {
     void trackLoadFailed(TrackPointer pTrack, const QString& reason);
 
   private:
+    friend class CachingReaderTest;
+
+    // A contiguous block of sample memory divided up into chunks
+    struct ChunkBlock {
+        ChunkBlock(int chunkCount, mixxx::audio::ChannelCount maxSupportedChannel);
+        ~ChunkBlock();
+
+        mixxx::SampleBuffer sampleBuffer;
+        std::vector<CachingReaderChunkForOwner*> chunks;
+    };
+
+    // Called from the thread that loads new tracks, never from the engine thread.
+    void growChunkPool(const TrackPointer& pTrack);
+
+    // Called from the engine thread to take ownership of new chunks.
+    void receiveChunkBlocks();
+    void addChunkBlock(std::unique_ptr<ChunkBlock> pBlock);
+
     const UserSettingsPointer m_pConfig;
+    const QString m_group;
+    const mixxx::audio::ChannelCount m_maxSupportedChannel;
+
+    // The configured number of chunks for this deck
+    const int m_initialChunkCount;
+    // Upper bound for the total number of chunks, calculated from the
+    // available physical memory.
+    const int m_maxChunkCount;
+    // Only accessed by the thread that calls newTrack()
+    int m_requestedChunkCount;
+    // The sample memory of all chunks, including those that are still on
+    // their way to the engine thread
+    std::atomic<qint64> m_allocatedBytes;
 
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
+    // The read requests whose chunks have not been returned by the worker.
+    // Only accessed from the engine thread.
+    int m_pendingReadRequestCount;
+
+    // New chunk blocks on their way to the engine thread.
+    FIFO<ChunkBlock*> m_chunkBlockFIFO;
+
+    Counter m_cacheHitCounter;
+    Counter m_cacheMissCounter;
+    Counter m_cacheEvictionCounter;
 
     // Looks for the provided chunk number in the index of in-memory chunks and
     // returns it if it is present. If not, returns nullptr. If it is present then
@@ -179,9 +247,14 @@ class CachingReader : public QObject {
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
+    // Owns the memory of all chunks in m_chunks. Only accessed from the
+    // engine thread.
+    std::vector<std::unique_ptr<ChunkBlock>> m_chunkBlocks;
+
+    // Stack of free chunks. Reserved for m_maxChunkCount chunks, so freeing
+    // and receiving chunks in the engine thread never allocates, unlike the
+    // nodes of a linked list. Iteration is not necessary.
+    std::vector<CachingReaderChunkForOwner*> m_freeChunks;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
@@ -191,11 +264,14 @@ class CachingReader : public QObject {
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
     CachingReaderChunkForOwner* m_lruCachingReaderChunk;
 
-    // The raw memory buffer which is divided up into chunks.
-    mixxx::SampleBuffer m_sampleBuffer;
-
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The preloaded track, owned by the worker. Only accessed from the
+    // engine thread.
+    const CachingReaderTrackBuffer* m_pTrackBuffer;
+
     CachingReaderWorker m_worker;
+
+    mixxx::MemoryUsage::Registration m_memoryUsage;
 };
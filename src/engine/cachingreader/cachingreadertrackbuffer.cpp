@@ -0,0 +1,122 @@
+#include "engine/cachingreader/cachingreadertrackbuffer.h"
+
+#include "sources/audiosourcestereoproxy.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderTrackBuffer");
+
+// Odd channel counts are converted to stereo, like in CachingReaderChunk
+mixxx::audio::ChannelCount bufferedChannelCount(
+        mixxx::audio::ChannelCount channelCount) {
+    if (channelCount % mixxx::audio::ChannelCount::stereo() != 0) {
+        return mixxx::audio::ChannelCount::stereo();
+    }
+    return channelCount;
+}
+
+} // anonymous namespace
+
+CachingReaderTrackBuffer::CachingReaderTrackBuffer(
+        mixxx::IndexRange frameIndexRange,
+        mixxx::audio::ChannelCount channelCount)
+        : m_frameIndexRange(frameIndexRange),
+          m_channelCount(bufferedChannelCount(channelCount)),
+          m_bufferedFrameIndexEnd(frameIndexRange.start()),
+          m_abandoned(false),
+          m_sampleBuffer(frameIndexRange.length() * m_channelCount) {
+}
+
+// static
+quint64 CachingReaderTrackBuffer::requiredBytes(
+        mixxx::IndexRange frameIndexRange,
+        mixxx::audio::ChannelCount channelCount) {
+    return static_cast<quint64>(frameIndexRange.length()) *
+            bufferedChannelCount(channelCount) * sizeof(CSAMPLE);
+}
+
+bool CachingReaderTrackBuffer::bufferNextSampleFrames(
+        const mixxx::AudioSourcePointer& pAudioSource,
+        mixxx::SampleBuffer::WritableSlice tempOutputBuffer,
+        SINT maxFrames) {
+    DEBUG_ASSERT(pAudioSource);
+    DEBUG_ASSERT(!isComplete());
+    const auto frameIndexRange = intersect(
+            mixxx::IndexRange::forward(
+                    m_bufferedFrameIndexEnd.load(std::memory_order_relaxed),
+                    maxFrames),
+            m_frameIndexRange);
+    const SINT sampleOffset =
+            (frameIndexRange.start() - m_frameIndexRange.start()) * m_channelCount;
+    const auto writableSlice = mixxx::SampleBuffer::WritableSlice(
+            m_sampleBuffer,
+            sampleOffset,
+            frameIndexRange.length() * m_channelCount);
+    mixxx::ReadableSampleFrames readableSampleFrames;
+    if (pAudioSource->getSignalInfo().getChannelCount() != m_channelCount) {
+        mixxx::AudioSourceStereoProxy audioSourceProxy(
+                pAudioSource,
+                tempOutputBuffer);
+        readableSampleFrames = audioSourceProxy.readSampleFrames(
+                mixxx::WritableSampleFrames(frameIndexRange, writableSlice));
+    } else {
+        readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(frameIndexRange, writableSlice));
+    }
+    if (readableSampleFrames.frameIndexRange() != frameIndexRange) {
+        kLogger.warning()
+                << "Failed to read sample frames:"
+                << "expected =" << frameIndexRange
+                << ", actual =" << readableSampleFrames.frameIndexRange();
+        return false;
+    }
+    // Publish the decoded samples
+    m_bufferedFrameIndexEnd.store(frameIndexRange.end(), std::memory_order_release);
+    return true;
+}
+
+mixxx::IndexRange CachingReaderTrackBuffer::readBufferedSampleFrames(
+        CSAMPLE* sampleBuffer,
+        mixxx::audio::ChannelCount channelCount,
+        const mixxx::IndexRange& frameIndexRange) const {
+    const auto copyableFrameIndexRange =
+            intersect(frameIndexRange, bufferedFrameIndexRange());
+    if (!copyableFrameIndexRange.empty()) {
+        const SINT dstSampleOffset =
+                (copyableFrameIndexRange.start() - frameIndexRange.start()) *
+                channelCount;
+        const SINT srcSampleOffset =
+                (copyableFrameIndexRange.start() - m_frameIndexRange.start()) *
+                channelCount;
+        SampleUtil::copy(
+                sampleBuffer + dstSampleOffset,
+                m_sampleBuffer.data(srcSampleOffset),
+                copyableFrameIndexRange.length() * channelCount);
+    }
+    return copyableFrameIndexRange;
+}
+
+mixxx::IndexRange CachingReaderTrackBuffer::readBufferedSampleFramesReverse(
+        CSAMPLE* reverseSampleBuffer,
+        mixxx::audio::ChannelCount channelCount,
+        const mixxx::IndexRange& frameIndexRange) const {
+    const auto copyableFrameIndexRange =
+            intersect(frameIndexRange, bufferedFrameIndexRange());
+    if (!copyableFrameIndexRange.empty()) {
+        const SINT dstSampleOffset =
+                (copyableFrameIndexRange.start() - frameIndexRange.start()) *
+                channelCount;
+        const SINT srcSampleOffset =
+                (copyableFrameIndexRange.start() - m_frameIndexRange.start()) *
+                channelCount;
+        const SINT sampleCount = copyableFrameIndexRange.length() * channelCount;
+        SampleUtil::copyReverse(
+                reverseSampleBuffer - dstSampleOffset - sampleCount,
+                m_sampleBuffer.data(srcSampleOffset),
+                sampleCount,
+                channelCount);
+    }
+    return copyableFrameIndexRange;
+}
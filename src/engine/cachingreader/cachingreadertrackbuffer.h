@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+
+#include "audio/types.h"
+#include "sources/audiosource.h"
+#include "util/indexrange.h"
+#include "util/samplebuffer.h"
+
+// The decoded sample data of a whole track in a single contiguous buffer.
+//
+// If a player is configured to preload tracks fully the CachingReaderWorker
+// fills this buffer in the background after loading a track. Once complete
+// it is handed over to the CachingReader, that reads directly from it
+// instead of looking up chunks in the cache.
+//
+// The worker keeps the ownership and must only delete the buffer while the
+// engine is not reading from it, i.e. after the engine has been stopped for
+// loading or unloading a track. A complete buffer is shared by all workers
+// that have loaded the same track.
+//
+// The buffered frames grow monotonically and are never modified thereafter.
+// This allows other threads that share the ownership, e.g. the analysis of
+// the loaded track, to read them while the worker is still decoding.
+class CachingReaderTrackBuffer {
+  public:
+    CachingReaderTrackBuffer(
+            mixxx::IndexRange frameIndexRange,
+            mixxx::audio::ChannelCount channelCount);
+
+    // Memory required for a track buffer with the given properties
+    static quint64 requiredBytes(
+            mixxx::IndexRange frameIndexRange,
+            mixxx::audio::ChannelCount channelCount);
+
+    mixxx::IndexRange frameIndexRange() const {
+        return m_frameIndexRange;
+    }
+
+    mixxx::audio::ChannelCount channelCount() const {
+        return m_channelCount;
+    }
+
+    // Thread-safe
+    mixxx::IndexRange bufferedFrameIndexRange() const {
+        return mixxx::IndexRange::between(m_frameIndexRange.start(),
+                m_bufferedFrameIndexEnd.load(std::memory_order_acquire));
+    }
+
+    bool isComplete() const {
+        return bufferedFrameIndexRange() == m_frameIndexRange;
+    }
+
+    // The worker abandons the buffer when it stops filling it, i.e. when
+    // unloading the track or after a read error. Thread-safe.
+    void abandon() {
+        m_abandoned.store(true, std::memory_order_release);
+    }
+    bool isAbandoned() const {
+        return m_abandoned.load(std::memory_order_acquire);
+    }
+
+    // Decode the next maxFrames frames from the audio source.
+    // Only used by the worker. Returns false if reading from
+    // the audio source failed.
+    bool bufferNextSampleFrames(
+            const mixxx::AudioSourcePointer& pAudioSource,
+            mixxx::SampleBuffer::WritableSlice tempOutputBuffer,
+            SINT maxFrames);
+
+    // Same semantics as the corresponding functions of
+    // CachingReaderChunk. Used by the engine after the buffer
+    // is complete and by readers that share the buffer.
+    mixxx::IndexRange readBufferedSampleFrames(CSAMPLE* sampleBuffer,
+            mixxx::audio::ChannelCount channelCount,
+            const mixxx::IndexRange& frameIndexRange) const;
+    mixxx::IndexRange readBufferedSampleFramesReverse(
+            CSAMPLE* reverseSampleBuffer,
+            mixxx::audio::ChannelCount channelCount,
+            const mixxx::IndexRange& frameIndexRange) const;
+
+  private:
+    const mixxx::IndexRange m_frameIndexRange;
+    const mixxx::audio::ChannelCount m_channelCount;
+
+    // Only written by the worker after the corresponding
+    // samples have been stored
+    std::atomic<SINT> m_bufferedFrameIndexEnd;
+    std::atomic<bool> m_abandoned;
+    mixxx::SampleBuffer m_sampleBuffer;
+};
@@ -0,0 +1,255 @@
+#include "engine/cachingreader/cachingreadertrackbuffersource.h"
+
+#include <QHash>
+#include <QThread>
+
+#include "engine/cachingreader/cachingreadertrackbuffer.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CachingReaderTrackBufferSource");
+
+// The interval for polling the progress of the worker
+constexpr unsigned long kPollMillis = 2;
+
+// Decode the file if the worker makes no progress for this duration,
+// e.g. while the engine continuously requests chunks
+const mixxx::Duration kMaxStallDuration = mixxx::Duration::fromMillis(1000);
+
+struct SharedTrackBuffer {
+    std::weak_ptr<CachingReaderTrackBuffer> pTrackBuffer;
+    mixxx::audio::ChannelCount requestedChannelCount;
+    mixxx::audio::SampleRate sampleRate;
+    mixxx::audio::Bitrate bitrate;
+};
+
+QMutex s_sharedTrackBuffersMutex;
+QHash<TrackId, SharedTrackBuffer> s_sharedTrackBuffers;
+
+} // anonymous namespace
+
+// static
+void CachingReaderTrackBufferSource::shareTrackBuffer(
+        TrackId trackId,
+        const mixxx::AudioSource::OpenParams& params,
+        const mixxx::AudioSource& audioSource,
+        const std::shared_ptr<CachingReaderTrackBuffer>& pTrackBuffer) {
+    DEBUG_ASSERT(pTrackBuffer);
+    if (!trackId.isValid() ||
+            audioSource.getSignalInfo().getChannelCount() !=
+                    pTrackBuffer->channelCount()) {
+        // The buffer contains a converted signal
+        return;
+    }
+    const auto locker = lockMutex(&s_sharedTrackBuffersMutex);
+    // Remove the entries of released buffers
+    for (auto it = s_sharedTrackBuffers.begin(); it != s_sharedTrackBuffers.end();) {
+        if (it.value().pTrackBuffer.expired()) {
+            it = s_sharedTrackBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // A track that is loaded into multiple decks is read from the most
+    // recently loaded buffer
+    s_sharedTrackBuffers.insert(trackId,
+            SharedTrackBuffer{
+                    pTrackBuffer,
+                    params.getSignalInfo().getChannelCount(),
+                    audioSource.getSignalInfo().getSampleRate(),
+                    audioSource.getBitrate()});
+}
+
+// static
+std::shared_ptr<CachingReaderTrackBuffer> CachingReaderTrackBufferSource::completeTrackBuffer(
+        TrackId trackId,
+        const mixxx::AudioSource::OpenParams& params,
+        const mixxx::AudioSource& audioSource) {
+    if (!trackId.isValid()) {
+        return nullptr;
+    }
+    SharedTrackBuffer sharedTrackBuffer;
+    {
+        const auto locker = lockMutex(&s_sharedTrackBuffersMutex);
+        const auto it = s_sharedTrackBuffers.constFind(trackId);
+        if (it == s_sharedTrackBuffers.constEnd()) {
+            return nullptr;
+        }
+        sharedTrackBuffer = it.value();
+    }
+    auto pTrackBuffer = sharedTrackBuffer.pTrackBuffer.lock();
+    if (!pTrackBuffer || !pTrackBuffer->isComplete() ||
+            sharedTrackBuffer.requestedChannelCount !=
+                    params.getSignalInfo().getChannelCount() ||
+            sharedTrackBuffer.sampleRate != audioSource.getSignalInfo().getSampleRate() ||
+            pTrackBuffer->channelCount() != audioSource.getSignalInfo().getChannelCount() ||
+            pTrackBuffer->frameIndexRange() != audioSource.frameIndexRange()) {
+        // The file might have been modified in the meantime
+        return nullptr;
+    }
+    return pTrackBuffer;
+}
+
+// static
+mixxx::AudioSourcePointer CachingReaderTrackBufferSource::open(
+        const TrackPointer& pTrack,
+        const mixxx::AudioSource::OpenParams& params) {
+    DEBUG_ASSERT(pTrack);
+    SharedTrackBuffer sharedTrackBuffer;
+    {
+        const auto locker = lockMutex(&s_sharedTrackBuffersMutex);
+        const auto it = s_sharedTrackBuffers.constFind(pTrack->getId());
+        if (it == s_sharedTrackBuffers.constEnd()) {
+            return nullptr;
+        }
+        sharedTrackBuffer = it.value();
+    }
+    auto pTrackBuffer = sharedTrackBuffer.pTrackBuffer.lock();
+    if (!pTrackBuffer || pTrackBuffer->isAbandoned() ||
+            sharedTrackBuffer.requestedChannelCount !=
+                    params.getSignalInfo().getChannelCount()) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<CachingReaderTrackBufferSource>(
+            pTrack,
+            params,
+            std::move(pTrackBuffer),
+            sharedTrackBuffer.sampleRate,
+            sharedTrackBuffer.bitrate);
+    if (pAudioSource->open(mixxx::AudioSource::OpenMode::Strict, params) !=
+            mixxx::AudioSource::OpenResult::Succeeded) {
+        return nullptr;
+    }
+    kLogger.debug()
+            << "Reading decoded audio data of"
+            << pTrack->getLocation()
+            << "from the track buffer of a deck";
+    return pAudioSource;
+}
+
+CachingReaderTrackBufferSource::CachingReaderTrackBufferSource(
+        TrackPointer pTrack,
+        const mixxx::AudioSource::OpenParams& params,
+        std::shared_ptr<CachingReaderTrackBuffer> pTrackBuffer,
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::Bitrate bitrate)
+        : AudioSource(pTrack->getFileInfo().toQUrl()),
+          m_pTrack(std::move(pTrack)),
+          m_params(params),
+          m_sampleRate(sampleRate),
+          m_bitrate(bitrate),
+          m_pTrackBuffer(std::move(pTrackBuffer)) {
+}
+
+CachingReaderTrackBufferSource::~CachingReaderTrackBufferSource() {
+    close();
+}
+
+mixxx::AudioSource::OpenResult CachingReaderTrackBufferSource::tryOpen(
+        OpenMode /*mode*/,
+        const OpenParams& /*params*/) {
+    VERIFY_OR_DEBUG_ASSERT(m_pTrackBuffer) {
+        return OpenResult::Failed;
+    }
+    if (!initChannelCountOnce(m_pTrackBuffer->channelCount())) {
+        return OpenResult::Failed;
+    }
+    if (!initSampleRateOnce(m_sampleRate)) {
+        return OpenResult::Failed;
+    }
+    if (m_bitrate.isValid()) {
+        initBitrateOnce(m_bitrate);
+    }
+    if (!initFrameIndexRangeOnce(m_pTrackBuffer->frameIndexRange())) {
+        return OpenResult::Failed;
+    }
+    return OpenResult::Succeeded;
+}
+
+void CachingReaderTrackBufferSource::close() {
+    if (m_pFileAudioSource) {
+        m_pFileAudioSource->close();
+        m_pFileAudioSource.reset();
+    }
+}
+
+mixxx::ReadableSampleFrames CachingReaderTrackBufferSource::readSampleFramesClamped(
+        const mixxx::WritableSampleFrames& writableSampleFrames) {
+    const mixxx::IndexRange frameIndexRange = writableSampleFrames.frameIndexRange();
+    // Only sequential reads wait for the worker
+    if (m_pTrackBuffer &&
+            frameIndexRange.start() <= m_pTrackBuffer->bufferedFrameIndexRange().end()) {
+        if (waitUntilBuffered(frameIndexRange.end())) {
+            if (writableSampleFrames.writableData()) {
+                m_pTrackBuffer->readBufferedSampleFrames(
+                        writableSampleFrames.writableData(),
+                        getSignalInfo().getChannelCount(),
+                        frameIndexRange);
+            }
+            return mixxx::ReadableSampleFrames(
+                    frameIndexRange,
+                    mixxx::SampleBuffer::ReadableSlice(
+                            writableSampleFrames.writableData(),
+                            getSignalInfo().frames2samples(frameIndexRange.length())));
+        }
+        // Release the memory as early as possible
+        m_pTrackBuffer.reset();
+    }
+    return readSampleFramesFromFile(writableSampleFrames);
+}
+
+bool CachingReaderTrackBufferSource::waitUntilBuffered(SINT frameIndexEnd) {
+    DEBUG_ASSERT(m_pTrackBuffer);
+    SINT bufferedFrameIndexEnd = m_pTrackBuffer->bufferedFrameIndexRange().end();
+    if (bufferedFrameIndexEnd >= frameIndexEnd) {
+        return true;
+    }
+    PerformanceTimer stallTimer;
+    stallTimer.start();
+    while (!m_pTrackBuffer->isAbandoned()) {
+        QThread::msleep(kPollMillis);
+        const SINT nextBufferedFrameIndexEnd =
+                m_pTrackBuffer->bufferedFrameIndexRange().end();
+        if (nextBufferedFrameIndexEnd >= frameIndexEnd) {
+            return true;
+        }
+        if (nextBufferedFrameIndexEnd > bufferedFrameIndexEnd) {
+            bufferedFrameIndexEnd = nextBufferedFrameIndexEnd;
+            stallTimer.restart();
+        } else if (stallTimer.elapsed() > kMaxStallDuration) {
+            kLogger.info()
+                    << "Decoding the file instead of waiting for the track buffer of"
+                    << m_pTrack->getLocation();
+            return false;
+        }
+    }
+    // The buffer might have been completed right before
+    return m_pTrackBuffer->bufferedFrameIndexRange().end() >= frameIndexEnd;
+}
+
+mixxx::ReadableSampleFrames CachingReaderTrackBufferSource::readSampleFramesFromFile(
+        const mixxx::WritableSampleFrames& writableSampleFrames) {
+    if (!m_pFileAudioSource) {
+        m_pFileAudioSource = SoundSourceProxy(m_pTrack).openAudioSource(m_params);
+        if (!m_pFileAudioSource) {
+            kLogger.warning()
+                    << "Failed to open file"
+                    << m_pTrack->getLocation();
+            return mixxx::ReadableSampleFrames(
+                    mixxx::IndexRange::forward(
+                            writableSampleFrames.frameIndexRange().start(), 0));
+        }
+        VERIFY_OR_DEBUG_ASSERT(m_pFileAudioSource->getSignalInfo() == getSignalInfo()) {
+            m_pFileAudioSource.reset();
+            return mixxx::ReadableSampleFrames(
+                    mixxx::IndexRange::forward(
+                            writableSampleFrames.frameIndexRange().start(), 0));
+        }
+    }
+    return m_pFileAudioSource->readSampleFrames(writableSampleFrames);
+}
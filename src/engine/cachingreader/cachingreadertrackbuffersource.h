@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+#include "track/trackid.h"
+
+class CachingReaderTrackBuffer;
+
+// Reads the audio data of a track from the track buffer of a
+// CachingReaderWorker that has loaded and preloads the same track,
+// instead of decoding the file a second time. This is used for
+// analyzing tracks while they are loaded into a deck.
+//
+// Sequential reads wait until the worker has buffered the requested
+// frames. Reads ahead of the buffered frames, e.g. for a preview, and
+// all reads after the worker has abandoned the buffer or stalled are
+// served by decoding the file.
+class CachingReaderTrackBufferSource : public mixxx::AudioSource {
+  public:
+    // Shares the track buffer of a worker until the worker releases it.
+    // Only buffers with the original signal of the audio source are
+    // shared. Thread-safe.
+    static void shareTrackBuffer(
+            TrackId trackId,
+            const mixxx::AudioSource::OpenParams& params,
+            const mixxx::AudioSource& audioSource,
+            const std::shared_ptr<CachingReaderTrackBuffer>& pTrackBuffer);
+
+    // Returns the shared track buffer of another worker if it has been
+    // opened with the same parameters and is complete, i.e. it can be
+    // played without decoding the track again. Otherwise nullptr.
+    // Thread-safe.
+    static std::shared_ptr<CachingReaderTrackBuffer> completeTrackBuffer(
+            TrackId trackId,
+            const mixxx::AudioSource::OpenParams& params,
+            const mixxx::AudioSource& audioSource);
+
+    // Returns nullptr if no track buffer opened with the same parameters
+    // is shared for the track. Thread-safe.
+    static mixxx::AudioSourcePointer open(
+            const TrackPointer& pTrack,
+            const mixxx::AudioSource::OpenParams& params);
+
+    CachingReaderTrackBufferSource(
+            TrackPointer pTrack,
+            const mixxx::AudioSource::OpenParams& params,
+            std::shared_ptr<CachingReaderTrackBuffer> pTrackBuffer,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::Bitrate bitrate);
+    ~CachingReaderTrackBufferSource() override;
+
+    void close() override;
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode mode,
+            const OpenParams& params) override;
+
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& sampleFrames) override;
+
+  private:
+    bool waitUntilBuffered(SINT frameIndexEnd);
+
+    mixxx::ReadableSampleFrames readSampleFramesFromFile(
+            const mixxx::WritableSampleFrames& sampleFrames);
+
+    const TrackPointer m_pTrack;
+    const mixxx::AudioSource::OpenParams m_params;
+    const mixxx::audio::SampleRate m_sampleRate;
+    const mixxx::audio::Bitrate m_bitrate;
+
+    std::shared_ptr<CachingReaderTrackBuffer> m_pTrackBuffer;
+    mixxx::AudioSourcePointer m_pFileAudioSource;
+};
@@ -0,0 +1,280 @@
+#include "engine/cachingreader/cachingreadertrackheadsource.h"
+
+#include <QThreadPool>
+#include <list>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+struct CachingReaderTrackHeadSource::TrackHead {
+    TrackId trackId;
+    mixxx::audio::ChannelCount requestedChannelCount;
+#ifdef __STEM__
+    mixxx::StemChannelSelection stemMask;
+#endif
+    mixxx::audio::SignalInfo signalInfo;
+    mixxx::audio::Bitrate bitrate;
+    mixxx::IndexRange frameIndexRange;
+    // The decoded frames, aligned to the chunks of the CachingReader
+    mixxx::IndexRange headFrameIndexRange;
+    mixxx::SampleBuffer sampleBuffer;
+};
+
+namespace {
+
+const mixxx::Logger kLogger("CachingReaderTrackHeadSource");
+
+// 16 chunks -> ~3 s at 44.1 kHz, 1 MB for a stereo track
+constexpr SINT kHeadChunks = 16;
+
+// The most recently browsed tracks
+constexpr std::size_t kMaxTrackHeads = 8;
+
+using TrackHead = CachingReaderTrackHeadSource::TrackHead;
+
+QMutex s_trackHeadsMutex;
+// Ordered from most to least recently used
+std::list<std::shared_ptr<const TrackHead>> s_trackHeads;
+
+bool matchesParams(
+        const TrackHead& trackHead,
+        const mixxx::AudioSource::OpenParams& params) {
+    return trackHead.requestedChannelCount == params.getSignalInfo().getChannelCount()
+#ifdef __STEM__
+            && trackHead.stemMask == params.stemMask()
+#endif
+            ;
+}
+
+// Returns the cached track head and marks it as the most recently used
+std::shared_ptr<const TrackHead> findTrackHead(
+        TrackId trackId,
+        const mixxx::AudioSource::OpenParams& params) {
+    const auto locker = lockMutex(&s_trackHeadsMutex);
+    for (auto it = s_trackHeads.begin(); it != s_trackHeads.end(); ++it) {
+        if ((*it)->trackId == trackId && matchesParams(**it, params)) {
+            s_trackHeads.splice(s_trackHeads.begin(), s_trackHeads, it);
+            return s_trackHeads.front();
+        }
+    }
+    return nullptr;
+}
+
+void insertTrackHead(std::shared_ptr<const TrackHead> pTrackHead) {
+    const auto locker = lockMutex(&s_trackHeadsMutex);
+    s_trackHeads.remove_if([&pTrackHead](const auto& pOther) {
+        return pOther->trackId == pTrackHead->trackId;
+    });
+    s_trackHeads.push_front(std::move(pTrackHead));
+    while (s_trackHeads.size() > kMaxTrackHeads) {
+        // Still owned by all sources that read from it
+        s_trackHeads.pop_back();
+    }
+}
+
+QThreadPool* trackHeadDecodingThreadPool() {
+    static QThreadPool* const pThreadPool = [] {
+        auto* pThreadPool = new QThreadPool();
+        // Decoding a few seconds doesn't take long, new requests
+        // replace the pending ones
+        pThreadPool->setMaxThreadCount(1);
+        return pThreadPool;
+    }();
+    return pThreadPool;
+}
+
+void decodeTrackHead(
+        const TrackPointer& pTrack,
+        const mixxx::AudioSource::OpenParams& params) {
+    if (findTrackHead(pTrack->getId(), params)) {
+        return;
+    }
+    const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(params);
+    if (!pAudioSource || pAudioSource->frameIndexRange().empty()) {
+        // The warning is logged when loading the track
+        return;
+    }
+    // The main cue is where playback starts by default
+    SINT headFrameIndexStart = pAudioSource->frameIndexMin();
+    const auto mainCuePosition = pTrack->getMainCuePosition();
+    if (mainCuePosition.isValid()) {
+        const auto mainCueFrameIndex = static_cast<SINT>(
+                mainCuePosition.toLowerFrameBoundary().value());
+        if (pAudioSource->frameIndexRange().containsIndex(mainCueFrameIndex)) {
+            headFrameIndexStart +=
+                    CachingReaderChunk::indexForFrame(
+                            mainCueFrameIndex - pAudioSource->frameIndexMin()) *
+                    CachingReaderChunk::kFrames;
+        }
+    }
+    const auto headFrameIndexRange = intersect(
+            mixxx::IndexRange::forward(headFrameIndexStart,
+                    kHeadChunks * CachingReaderChunk::kFrames),
+            pAudioSource->frameIndexRange());
+    mixxx::SampleBuffer sampleBuffer(
+            pAudioSource->getSignalInfo().frames2samples(headFrameIndexRange.length()));
+    const auto readableSampleFrames = pAudioSource->readSampleFrames(
+            mixxx::WritableSampleFrames(headFrameIndexRange,
+                    mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+    if (readableSampleFrames.frameIndexRange() != headFrameIndexRange) {
+        kLogger.warning()
+                << "Failed to decode"
+                << headFrameIndexRange
+                << "of"
+                << pTrack->getLocation();
+        return;
+    }
+    insertTrackHead(std::make_shared<const TrackHead>(TrackHead{
+            pTrack->getId(),
+            params.getSignalInfo().getChannelCount(),
+#ifdef __STEM__
+            params.stemMask(),
+#endif
+            pAudioSource->getSignalInfo(),
+            pAudioSource->getBitrate(),
+            pAudioSource->frameIndexRange(),
+            headFrameIndexRange,
+            std::move(sampleBuffer)}));
+}
+
+} // anonymous namespace
+
+// static
+void CachingReaderTrackHeadSource::decodeInBackground(
+        TrackPointer pTrack,
+        const mixxx::AudioSource::OpenParams& params) {
+    if (!pTrack || !pTrack->getId().isValid()) {
+        return;
+    }
+    auto* const pThreadPool = trackHeadDecodingThreadPool();
+    // The user has moved on to the next track
+    pThreadPool->clear();
+    pThreadPool->start([pTrack = std::move(pTrack), params] {
+        decodeTrackHead(pTrack, params);
+    });
+}
+
+// static
+void CachingReaderTrackHeadSource::stopDecoding() {
+    auto* const pThreadPool = trackHeadDecodingThreadPool();
+    pThreadPool->clear();
+    pThreadPool->waitForDone();
+}
+
+// static
+mixxx::AudioSourcePointer CachingReaderTrackHeadSource::open(
+        const TrackPointer& pTrack,
+        const mixxx::AudioSource::OpenParams& params) {
+    DEBUG_ASSERT(pTrack);
+    if (!pTrack->getId().isValid()) {
+        return nullptr;
+    }
+    auto pTrackHead = findTrackHead(pTrack->getId(), params);
+    if (!pTrackHead) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<CachingReaderTrackHeadSource>(
+            pTrack,
+            params,
+            std::move(pTrackHead));
+    if (pAudioSource->open(mixxx::AudioSource::OpenMode::Strict, params) !=
+            mixxx::AudioSource::OpenResult::Succeeded) {
+        return nullptr;
+    }
+    kLogger.debug()
+            << "Reading the decoded head of"
+            << pTrack->getLocation();
+    return pAudioSource;
+}
+
+CachingReaderTrackHeadSource::CachingReaderTrackHeadSource(
+        TrackPointer pTrack,
+        const mixxx::AudioSource::OpenParams& params,
+        std::shared_ptr<const TrackHead> pTrackHead)
+        : AudioSource(pTrack->getFileInfo().toQUrl()),
+          m_pTrack(std::move(pTrack)),
+          m_params(params),
+          m_pTrackHead(std::move(pTrackHead)),
+          m_fileOpenFailed(false) {
+}
+
+CachingReaderTrackHeadSource::~CachingReaderTrackHeadSource() {
+    close();
+}
+
+mixxx::AudioSource::OpenResult CachingReaderTrackHeadSource::tryOpen(
+        OpenMode /*mode*/,
+        const OpenParams& /*params*/) {
+    VERIFY_OR_DEBUG_ASSERT(m_pTrackHead) {
+        return OpenResult::Failed;
+    }
+    if (!initChannelCountOnce(m_pTrackHead->signalInfo.getChannelCount())) {
+        return OpenResult::Failed;
+    }
+    if (!initSampleRateOnce(m_pTrackHead->signalInfo.getSampleRate())) {
+        return OpenResult::Failed;
+    }
+    if (m_pTrackHead->bitrate.isValid()) {
+        initBitrateOnce(m_pTrackHead->bitrate);
+    }
+    if (!initFrameIndexRangeOnce(m_pTrackHead->frameIndexRange)) {
+        return OpenResult::Failed;
+    }
+    return OpenResult::Succeeded;
+}
+
+void CachingReaderTrackHeadSource::close() {
+    if (m_pFileAudioSource) {
+        m_pFileAudioSource->close();
+        m_pFileAudioSource.reset();
+    }
+}
+
+mixxx::ReadableSampleFrames CachingReaderTrackHeadSource::readSampleFramesClamped(
+        const mixxx::WritableSampleFrames& writableSampleFrames) {
+    const mixxx::IndexRange frameIndexRange = writableSampleFrames.frameIndexRange();
+    if (!frameIndexRange.isSubrangeOf(m_pTrackHead->headFrameIndexRange)) {
+        return readSampleFramesFromFile(writableSampleFrames);
+    }
+    const SINT sampleOffset = getSignalInfo().frames2samples(
+            frameIndexRange.start() - m_pTrackHead->headFrameIndexRange.start());
+    const SINT sampleCount = getSignalInfo().frames2samples(frameIndexRange.length());
+    if (writableSampleFrames.writableData()) {
+        SampleUtil::copy(writableSampleFrames.writableData(),
+                m_pTrackHead->sampleBuffer.data(sampleOffset),
+                sampleCount);
+    }
+    return mixxx::ReadableSampleFrames(
+            frameIndexRange,
+            mixxx::SampleBuffer::ReadableSlice(
+                    writableSampleFrames.writableData(),
+                    sampleCount));
+}
+
+mixxx::ReadableSampleFrames CachingReaderTrackHeadSource::readSampleFramesFromFile(
+        const mixxx::WritableSampleFrames& writableSampleFrames) {
+    if (!m_pFileAudioSource && !m_fileOpenFailed) {
+        m_pFileAudioSource = SoundSourceProxy(m_pTrack).openAudioSource(m_params);
+        // The file might have been modified since decoding its head
+        if (!m_pFileAudioSource ||
+                m_pFileAudioSource->getSignalInfo() != getSignalInfo() ||
+                m_pFileAudioSource->frameIndexRange() != frameIndexRange()) {
+            kLogger.warning()
+                    << "Failed to open file"
+                    << m_pTrack->getLocation();
+            m_pFileAudioSource.reset();
+            m_fileOpenFailed = true;
+        }
+    }
+    if (!m_pFileAudioSource) {
+        return mixxx::ReadableSampleFrames(
+                mixxx::IndexRange::forward(
+                        writableSampleFrames.frameIndexRange().start(), 0));
+    }
+    return m_pFileAudioSource->readSampleFrames(writableSampleFrames);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+
+// Reads the audio data around the main cue of a track, i.e. where playback
+// starts after loading, from memory. These frames are decoded speculatively
+// in the background for tracks that are browsed in the library, so that a
+// preview deck starts playing without waiting for the file to be opened.
+//
+// All other reads are served by decoding the file, which is only opened
+// when needed.
+class CachingReaderTrackHeadSource : public mixxx::AudioSource {
+  public:
+    // Decodes the frames around the main cue of the track in a background
+    // thread. Replaces all requests that have not been started yet, i.e.
+    // only the most recently browsed tracks are decoded. Thread-safe.
+    static void decodeInBackground(
+            TrackPointer pTrack,
+            const mixxx::AudioSource::OpenParams& params);
+
+    // Discards all pending requests and waits until the current one has
+    // finished, e.g. before shutting down. Thread-safe.
+    static void stopDecoding();
+
+    // Returns nullptr if the frames of the track have not been decoded
+    // with the same parameters. Thread-safe.
+    static mixxx::AudioSourcePointer open(
+            const TrackPointer& pTrack,
+            const mixxx::AudioSource::OpenParams& params);
+
+    struct TrackHead;
+
+    CachingReaderTrackHeadSource(
+            TrackPointer pTrack,
+            const mixxx::AudioSource::OpenParams& params,
+            std::shared_ptr<const TrackHead> pTrackHead);
+    ~CachingReaderTrackHeadSource() override;
+
+    void close() override;
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode mode,
+            const OpenParams& params) override;
+
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& sampleFrames) override;
+
+  private:
+    mixxx::ReadableSampleFrames readSampleFramesFromFile(
+            const mixxx::WritableSampleFrames& sampleFrames);
+
+    const TrackPointer m_pTrack;
+    const mixxx::AudioSource::OpenParams m_params;
+    const std::shared_ptr<const TrackHead> m_pTrackHead;
+
+    mixxx::AudioSourcePointer m_pFileAudioSource;
+    bool m_fileOpenFailed;
+};
@@ -4,6 +4,8 @@
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
+#include "engine/cachingreader/cachingreadertrackbuffersource.h"
+#include "engine/cachingreader/cachingreadertrackheadsource.h"
 #include "moc_cachingreaderworker.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -11,7 +13,10 @@
 #include "util/event.h"
 #include "util/fifo.h"
 #include "util/logger.h"
+#include "util/realtime.h"
 #include "util/span.h"
+#include "util/timer.h"
+#include "util/tracing.h"
 
 namespace {
 
@@ -20,6 +25,9 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// Tracks requiring more memory are never preloaded completely
+constexpr quint64 kMaxTrackBufferBytes = 512 * 1024 * 1024;
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
@@ -31,11 +39,13 @@ CachingReaderWorker::CachingReaderWorker(
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
-          m_maxSupportedChannel(maxSupportedChannel) {
+          m_maxSupportedChannel(maxSupportedChannel),
+          m_preloadTrack(0) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         const CachingReaderChunkReadRequest& request) {
+    MIXXX_TRACE_SCOPE("CachingReaderWorker::processReadRequest");
     CachingReaderChunk* pChunk = request.chunk;
     DEBUG_ASSERT(pChunk);
 
@@ -117,6 +127,8 @@ void CachingReaderWorker::run() {
     const auto id = lastId.fetchAndAddRelaxed(1) + 1;
     QThread::currentThread()->setObjectName(
             QStringLiteral("CachingReaderWorker ") + QString::number(id));
+    mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::Reader);
+    mixxx::tracing::registerCurrentThread(QThread::currentThread()->objectName());
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
@@ -146,10 +158,21 @@ void CachingReaderWorker::run() {
                 // here, the engine is already stopped
                 unloadTrack();
             }
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        } else if (m_pChunkReadRequestFIFO->readAvailable() > 0) {
+            prefetchPendingRequests();
+            const int readCount = m_pChunkReadRequestFIFO->read(&request, 1);
+            DEBUG_ASSERT(readCount == 1);
+            Q_UNUSED(readCount)
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
+            if (m_firstChunkTimer && update.status == CHUNK_READ_SUCCESS) {
+                m_firstChunkTimer->elapsed(true);
+                m_firstChunkTimer.reset();
+            }
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        } else if (m_pTrackBuffer && !m_pTrackBuffer->isComplete()) {
+            // Preload the track while no chunks are requested
+            preloadNextSampleFrames();
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -166,8 +189,70 @@ void CachingReaderWorker::discardAllPendingRequests() {
     }
 }
 
+void CachingReaderWorker::prefetchPendingRequests() {
+    if (!m_pAudioSource) {
+        return;
+    }
+    // The requests are ordered by the priority of their hints, i.e. the
+    // chunks around the playhead come first. Announcing all of them at
+    // once allows sources that read from slow storage to fetch them in
+    // the background while the first one is decoded.
+    CachingReaderChunkReadRequest* pRequests1;
+    ring_buffer_size_t requestCount1;
+    CachingReaderChunkReadRequest* pRequests2;
+    ring_buffer_size_t requestCount2;
+    m_pChunkReadRequestFIFO->aquireReadRegions(
+            m_pChunkReadRequestFIFO->readAvailable(),
+            &pRequests1,
+            &requestCount1,
+            &pRequests2,
+            &requestCount2);
+    for (ring_buffer_size_t i = 0; i < requestCount1; ++i) {
+        m_pAudioSource->prefetchSampleFrames(
+                pRequests1[i].chunk->frameIndexRange(m_pAudioSource));
+    }
+    for (ring_buffer_size_t i = 0; i < requestCount2; ++i) {
+        m_pAudioSource->prefetchSampleFrames(
+                pRequests2[i].chunk->frameIndexRange(m_pAudioSource));
+    }
+}
+
+void CachingReaderWorker::preloadNextSampleFrames() {
+    DEBUG_ASSERT(m_pAudioSource);
+    if (!m_pTrackBuffer->bufferNextSampleFrames(
+                m_pAudioSource,
+                mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer),
+                CachingReaderChunk::kFrames)) {
+        // Continue with reading chunks on demand. The buffer has not yet
+        // been published and can be deleted safely.
+        kLogger.warning()
+                << m_group
+                << "Failed to preload the whole track";
+        m_pTrackBuffer->abandon();
+        m_pTrackBuffer.reset();
+        return;
+    }
+    if (m_pTrackBuffer->isComplete()) {
+        kLogger.debug()
+                << m_group
+                << "Preloaded the whole track";
+        const auto update = ReaderStatusUpdate::trackPreloaded(m_pTrackBuffer.get());
+        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    }
+}
+
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
+    m_firstChunkTimer.reset();
+
+    // The engine is stopped and doesn't read from the track buffer
+    if (m_pTrackBuffer) {
+        // A complete buffer may still be played by other workers
+        if (!m_pTrackBuffer->isComplete()) {
+            m_pTrackBuffer->abandon();
+        }
+        m_pTrackBuffer.reset();
+    }
 
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
@@ -193,12 +278,19 @@ void CachingReaderWorker::loadTrack(
 #else
 void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 #endif
+    MIXXX_TRACE_SCOPE("CachingReaderWorker::loadTrack");
     // This emit is directly connected and returns synchronized
     // after the engine has been stopped.
     emit trackLoading();
 
     closeAudioSource();
 
+    if (CmdlineArgs::Instance().getDeveloper()) {
+        m_firstChunkTimer.emplace(QStringLiteral("CachingReaderWorker first chunk(%1)")
+                                          .arg(pTrack->getType()));
+        m_firstChunkTimer->start();
+    }
+
     if (!pTrack->getFileInfo().checkFileExists()) {
         kLogger.warning()
                 << m_group
@@ -217,7 +309,12 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 #ifdef __STEM__
     config.setStemMask(stemMask);
 #endif
-    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    // Tracks that have been browsed in the library recently are played
+    // from memory while the file is opened
+    m_pAudioSource = CachingReaderTrackHeadSource::open(pTrack, config);
+    if (!m_pAudioSource) {
+        m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    }
     if (!m_pAudioSource) {
         kLogger.warning()
                 << m_group
@@ -280,6 +377,50 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                     m_pAudioSource->frameIndexRange());
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 
+    if (m_preloadTrack.loadAcquire()) {
+        const auto requiredBytes = CachingReaderTrackBuffer::requiredBytes(
+                m_pAudioSource->frameIndexRange(),
+                m_pAudioSource->getSignalInfo().getChannelCount());
+        if (requiredBytes <= kMaxTrackBufferBytes) {
+#ifdef __STEM__
+            // The analysis needs the mix of all stems
+            const bool shareTrackBuffer = !stemMask;
+#else
+            const bool shareTrackBuffer = true;
+#endif
+            if (shareTrackBuffer) {
+                // The same sample is often loaded into multiple samplers.
+                // Play it from the buffer that has already been decoded.
+                m_pTrackBuffer = CachingReaderTrackBufferSource::completeTrackBuffer(
+                        pTrack->getId(), config, *m_pAudioSource);
+            }
+            if (m_pTrackBuffer) {
+                kLogger.debug()
+                        << m_group
+                        << "Sharing the preloaded track of another player";
+                const auto update = ReaderStatusUpdate::trackPreloaded(m_pTrackBuffer.get());
+                m_pReaderStatusFIFO->writeBlocking(&update, 1);
+            } else {
+                // Decoded in the background, see run()
+                m_pTrackBuffer = std::make_shared<CachingReaderTrackBuffer>(
+                        m_pAudioSource->frameIndexRange(),
+                        m_pAudioSource->getSignalInfo().getChannelCount());
+                if (shareTrackBuffer) {
+                    // Analyze the track while preloading it instead of
+                    // decoding it twice
+                    CachingReaderTrackBufferSource::shareTrackBuffer(
+                            pTrack->getId(), config, *m_pAudioSource, m_pTrackBuffer);
+                }
+            }
+        } else {
+            kLogger.info()
+                    << m_group
+                    << "Not preloading the whole track that requires"
+                    << requiredBytes / (1024 * 1024)
+                    << "MB of memory";
+        }
+    }
+
     // Emit that the track is loaded.
 
     // This code is a workaround until we have found a better solution to
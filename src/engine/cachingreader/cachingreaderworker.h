@@ -2,13 +2,17 @@
 
 #include <QMutex>
 #include <QString>
+#include <memory>
+#include <optional>
 
 #include "audio/frame.h"
 #include "audio/types.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreadertrackbuffer.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
+#include "util/timer.h"
 
 template<class DataType>
 class FIFO;
@@ -27,6 +31,7 @@ typedef struct CachingReaderChunkReadRequest {
 enum ReaderStatus {
     TRACK_LOADED,
     TRACK_UNLOADED,
+    TRACK_PRELOADED, // the whole track has been decoded into a track buffer
     CHUNK_READ_SUCCESS,
     CHUNK_READ_EOF,
     CHUNK_READ_INVALID,
@@ -37,6 +42,7 @@ enum ReaderStatus {
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
+    const CachingReaderTrackBuffer* trackBuffer;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
 
@@ -49,6 +55,7 @@ typedef struct ReaderStatusUpdate {
             const mixxx::IndexRange& readableFrameIndexRangeArg) {
         status = statusArg;
         chunk = chunkArg;
+        trackBuffer = nullptr;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
     }
@@ -74,6 +81,21 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    static ReaderStatusUpdate trackPreloaded(
+            const CachingReaderTrackBuffer* trackBufferArg) {
+        DEBUG_ASSERT(trackBufferArg);
+        DEBUG_ASSERT(trackBufferArg->isComplete());
+        ReaderStatusUpdate update;
+        update.init(TRACK_PRELOADED, nullptr, trackBufferArg->frameIndexRange());
+        update.trackBuffer = trackBufferArg;
+        return update;
+    }
+
+    // The track buffer remains owned by the worker
+    const CachingReaderTrackBuffer* getTrackBuffer() const {
+        return trackBuffer;
+    }
+
     CachingReaderChunkForOwner* takeFromWorker() {
         CachingReaderChunkForOwner* pChunk = nullptr;
         if (chunk) {
@@ -116,6 +138,12 @@ class CachingReaderWorker : public EngineWorker {
 
     void quitWait();
 
+    // Decode the whole track into memory after loading. Only affects
+    // tracks that are loaded afterwards.
+    void setPreloadTrack(bool preloadTrack) {
+        m_preloadTrack.storeRelease(preloadTrack ? 1 : 0);
+    }
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -170,6 +198,14 @@ class CachingReaderWorker : public EngineWorker {
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    // Announce the chunks of all pending requests to the audio source
+    // without removing them from the FIFO.
+    void prefetchPendingRequests();
+
+    // Decode the next part of the track into m_pTrackBuffer and hand it
+    // over to the CachingReader when complete.
+    void preloadNextSampleFrames();
+
     void verifyFirstSound(const CachingReaderChunk* pChunk,
             mixxx::audio::ChannelCount channelCount);
 
@@ -178,6 +214,10 @@ class CachingReaderWorker : public EngineWorker {
 
     mixxx::audio::FramePos m_firstSoundFrameToVerify;
 
+    // Measures the time from loading a track until the first chunk
+    // has been read. Only in developer mode.
+    std::optional<Timer> m_firstChunkTimer;
+
     // Temporary buffer for reading samples from all channels
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
@@ -185,5 +225,12 @@ class CachingReaderWorker : public EngineWorker {
     // The maximum number of channel that this reader can support
     mixxx::audio::ChannelCount m_maxSupportedChannel;
 
+    QAtomicInt m_preloadTrack;
+
+    // The whole decoded track if preloading is enabled. Released when closing
+    // the audio source while the engine is stopped. Shared with the analysis
+    // of the loaded track, that might keep it alive a little longer.
+    std::shared_ptr<CachingReaderTrackBuffer> m_pTrackBuffer;
+
     QAtomicInt m_stop;
 };
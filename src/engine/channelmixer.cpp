@@ -1,9 +1,83 @@
 #include "engine/channelmixer.h"
 
+#include <array>
+#include <utility>
+
 #include "engine/effects/engineeffectsmanager.h"
+#include "engine/engineprofiler.h"
 #include "util/sample.h"
 #include "util/timer.h"
 
+namespace {
+
+// The maximum number of sources summed up by a single kernel. More sources
+// are processed in multiple passes. 8 covers two stem decks per pass, while
+// keeping all source pointers and gains in registers.
+constexpr int kMaxSourcesPerPass = 8;
+
+template<int kNumSources>
+void addRampingSourcesKernel(CSAMPLE* M_RESTRICT pOutput,
+        const ChannelMixer::RampingSource* pSources,
+        SINT numFrames) {
+    // Local copies prevent the compiler from reloading them on each
+    // iteration, because it can't prove that pOutput doesn't alias them.
+    const CSAMPLE* M_RESTRICT pBuffers[kNumSources];
+    CSAMPLE_GAIN startGains[kNumSources];
+    CSAMPLE_GAIN gainDeltas[kNumSources];
+    for (int k = 0; k < kNumSources; ++k) {
+        pBuffers[k] = pSources[k].pBuffer;
+        startGains[k] = pSources[k].startGain;
+        gainDeltas[k] = pSources[k].gainDelta;
+    }
+    for (int i = 0; i < numFrames; ++i) {
+        CSAMPLE left = CSAMPLE_ZERO;
+        CSAMPLE right = CSAMPLE_ZERO;
+        for (int k = 0; k < kNumSources; ++k) {
+            const CSAMPLE_GAIN gain = startGains[k] + gainDeltas[k] * i;
+            left += pBuffers[k][i * 2] * gain;
+            right += pBuffers[k][i * 2 + 1] * gain;
+        }
+        pOutput[i * 2] += left;
+        pOutput[i * 2 + 1] += right;
+    }
+}
+
+using AddRampingSourcesKernel = void (*)(CSAMPLE*, const ChannelMixer::RampingSource*, SINT);
+
+// kKernels[n - 1] sums up n sources
+template<std::size_t... kIndices>
+constexpr std::array<AddRampingSourcesKernel, sizeof...(kIndices)> makeKernels(
+        std::index_sequence<kIndices...>) {
+    return {&addRampingSourcesKernel<static_cast<int>(kIndices) + 1>...};
+}
+
+constexpr auto kKernels = makeKernels(std::make_index_sequence<kMaxSourcesPerPass>());
+
+// Calculates the gains like SampleUtil::addWithRampingGain()
+ChannelMixer::RampingSource makeRampingSource(const CSAMPLE* pBuffer,
+        CSAMPLE_GAIN oldGain,
+        CSAMPLE_GAIN newGain,
+        std::size_t bufferSize) {
+    const CSAMPLE_GAIN gainDelta = (newGain - oldGain) / CSAMPLE_GAIN(bufferSize / 2);
+    return ChannelMixer::RampingSource{pBuffer, oldGain + gainDelta, gainDelta};
+}
+
+} // anonymous namespace
+
+// static
+void ChannelMixer::addRampingSources(CSAMPLE* pOutput,
+        const RampingSource* pSources,
+        int numSources,
+        std::size_t bufferSize) {
+    const auto numFrames = static_cast<SINT>(bufferSize / 2);
+    while (numSources > 0) {
+        const int numSourcesInPass = std::min(numSources, kMaxSourcesPerPass);
+        kKernels[numSourcesInPass - 1](pOutput, pSources, numFrames);
+        pSources += numSourcesInPass;
+        numSources -= numSourcesInPass;
+    }
+}
+
 // static
 void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator& gainCalculator,
         const QVarLengthArray<EngineMixer::ChannelInfo*, kPreallocatedChannels>& activeChannels,
@@ -24,6 +98,9 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
     // The original channel input buffers are not modified.
     SampleUtil::clear(pOutput, bufferSize);
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsAndMixChannels"));
+    // Channels without active effects skip steps A), C) and are mixed
+    // together in a single pass afterwards.
+    QVarLengthArray<RampingSource, kPreallocatedChannels> rampingSources;
     for (auto* pChannelInfo : activeChannels) {
         EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
         CSAMPLE_GAIN oldGain = gainCache.m_gain;
@@ -38,6 +115,16 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
             newGain = gainCalculator.getGain(pChannelInfo);
         }
         gainCache.m_gain = newGain;
+        if (pEngineEffectsManager->skipPostFaderIfInactive(
+                    pChannelInfo->m_handle, outputHandle, fadeout)) {
+            if (oldGain != CSAMPLE_GAIN_ZERO || newGain != CSAMPLE_GAIN_ZERO) {
+                rampingSources.append(makeRampingSource(
+                        pChannelInfo->m_pBuffer.data(), oldGain, newGain, bufferSize));
+            }
+            continue;
+        }
+        EngineProfiler::ScopedChannelStage stage(pChannelInfo->m_index,
+                EngineProfiler::ChannelStage::PostFaderEffects);
         pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
                 outputHandle,
                 pChannelInfo->m_pBuffer.data(),
@@ -49,6 +136,10 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
                 newGain,
                 fadeout);
     }
+    addRampingSources(pOutput,
+            rampingSources.constData(),
+            static_cast<int>(rampingSources.size()),
+            bufferSize);
 }
 
 void ChannelMixer::applyEffectsInPlaceAndMixChannels(
@@ -84,15 +175,19 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
             newGain = gainCalculator.getGain(pChannelInfo);
         }
         gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
-                outputHandle,
-                pChannelInfo->m_pBuffer.data(),
-                bufferSize,
-                sampleRate,
-                pChannelInfo->m_features,
-                oldGain,
-                newGain,
-                fadeout);
+        {
+            EngineProfiler::ScopedChannelStage stage(pChannelInfo->m_index,
+                    EngineProfiler::ChannelStage::PostFaderEffects);
+            pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
+                    outputHandle,
+                    pChannelInfo->m_pBuffer.data(),
+                    bufferSize,
+                    sampleRate,
+                    pChannelInfo->m_features,
+                    oldGain,
+                    newGain,
+                    fadeout);
+        }
         SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), bufferSize);
     }
 }
@@ -8,9 +8,26 @@
 
 class ChannelMixer {
   public:
+    /// A channel buffer that is mixed with a gain ramp from
+    /// startGain + gainDelta * 0 to startGain + gainDelta * (numFrames - 1)
+    struct RampingSource {
+        const CSAMPLE* pBuffer;
+        CSAMPLE_GAIN startGain;
+        CSAMPLE_GAIN gainDelta;
+    };
+
+    /// Adds all stereo sources with their ramping gains to pOutput. The
+    /// sources are summed up in a single pass over the output buffer,
+    /// using a kernel that is specialized for the number of sources.
+    static void addRampingSources(CSAMPLE* pOutput,
+            const RampingSource* pSources,
+            int numSources,
+            std::size_t bufferSize);
+
     // This does not modify the input channel buffers. All manipulation of the input
     // channel buffers is done after copying to a temporary buffer, then they are mixed
-    // to make the output buffer.
+    // to make the output buffer. Channels without active post-fader effects are
+    // mixed directly with addRampingSources().
     static void applyEffectsAndMixChannels(
             const EngineMixer::GainCalculator& gainCalculator,
             const QVarLengthArray<EngineMixer::ChannelInfo*,
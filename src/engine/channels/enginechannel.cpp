@@ -3,6 +3,7 @@
 #include "control/controlobject.h"
 #include "control/controlpushbutton.h"
 #include "effects/effectsmanager.h"
+#include "engine/effects/engineeffectsmanager.h"
 #include "moc_enginechannel.cpp"
 
 EngineChannel::EngineChannel(const ChannelHandleAndGroup& handleGroup,
@@ -55,6 +56,18 @@ EngineChannel::~EngineChannel() {
     delete m_pTalkover;
 }
 
+void EngineChannel::prepareEffectStates() {
+    if (m_pEffectsManager == nullptr) {
+        return;
+    }
+    EngineEffectsManager* pEngineEffectsManager =
+            m_pEffectsManager->getEngineEffectsManager();
+    if (pEngineEffectsManager != nullptr) {
+        pEngineEffectsManager->prepareInputChannel(
+                getHandle(), m_pEffectsManager->getMainHandle());
+    }
+}
+
 void EngineChannel::setPfl(bool enabled) {
     m_pPFL->set(enabled ? 1.0 : 0.0);
 }
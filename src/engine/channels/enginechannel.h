@@ -70,6 +70,12 @@ class EngineChannel : public EngineObject {
         Q_UNUSED(bufferSize)
     }
 
+    /// Called by the engine thread before the channel is processed
+    /// concurrently with other channels. Creates the states of the effect
+    /// chains for the inputs of the channel, which must not be created by
+    /// concurrently processed channels.
+    virtual void prepareEffectStates();
+
     // TODO(XXX) This hack needs to be removed.
     virtual EngineBuffer* getEngineBuffer() {
         return nullptr;
@@ -9,6 +9,7 @@
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginepregain.h"
+#include "engine/enginescratcharena.h"
 #include "engine/enginevumeter.h"
 #include "moc_enginedeck.cpp"
 #include "track/track.h"
@@ -120,6 +121,22 @@ void EngineDeck::addStemHandle(const ChannelHandleAndGroup& stemHandleGroup) {
     }
 }
 
+void EngineDeck::prepareEffectStates() {
+    EngineChannel::prepareEffectStates();
+    if (m_pEffectsManager == nullptr) {
+        return;
+    }
+    EngineEffectsManager* pEngineEffectsManager =
+            m_pEffectsManager->getEngineEffectsManager();
+    if (pEngineEffectsManager == nullptr) {
+        return;
+    }
+    for (const auto& stem : m_stems) {
+        pEngineEffectsManager->prepareInputChannel(
+                stem.handle(), m_pEffectsManager->getMainHandle());
+    }
+}
+
 void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
     mixxx::audio::ChannelCount chCount = m_pBuffer->getChannelCount();
     VERIFY_OR_DEBUG_ASSERT(m_stems.size() <= chCount &&
@@ -130,16 +147,16 @@ void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
     unsigned int stemCount = chCount / mixxx::kEngineChannelOutputCount;
     SINT numFrames = bufferSize / mixxx::kEngineChannelOutputCount;
     std::size_t allChannelBufferSize = bufferSize * stemCount;
-    if (m_stemBuffer.size() < static_cast<SINT>(allChannelBufferSize)) {
-        m_stemBuffer = mixxx::SampleBuffer(allChannelBufferSize);
-    }
-    m_pBuffer->process(m_stemBuffer.data(), allChannelBufferSize);
+    // Retrieves all the channels to mix them together
+    EngineScratchArena::Scope scratch;
+    CSAMPLE* const pIn = scratch.allocate(static_cast<SINT>(allChannelBufferSize));
 
-    CSAMPLE* pIn = m_stemBuffer.data();
+    EngineEffectsManager* pEngineEffectsManager = m_pEffectsManager->getEngineEffectsManager();
 
-    // TODO(XXX): process stem DSP
+    m_pBuffer->setStemPremixMask(stemPremixMask(stemCount, pEngineEffectsManager));
+    m_pBuffer->process(pIn, allChannelBufferSize);
 
-    EngineEffectsManager* pEngineEffectsManager = m_pEffectsManager->getEngineEffectsManager();
+    // TODO(XXX): process stem DSP
 
     VERIFY_OR_DEBUG_ASSERT(pEngineEffectsManager != nullptr) {
         // If we don't have an engine manager to mix the stem together, we mixed
@@ -194,6 +211,45 @@ void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
     SampleUtil::mixMultichannelToStereo(pOut, pIn, numFrames, chCount);
 }
 
+mixxx::StemChannelSelection EngineDeck::stemPremixMask(unsigned int stemCount,
+        EngineEffectsManager* pEngineEffectsManager) const {
+    if (!pEngineEffectsManager) {
+        return {};
+    }
+    // The stretched mix of the audible stems equals the mix of the stretched
+    // stems, as long as they are mixed with the same steady gain and no
+    // stem effect is processed. The gain itself is still applied below.
+    mixxx::StemChannelSelection mask;
+    float commonGain = 0.0f;
+    for (unsigned int stemIdx = 0; stemIdx < stemCount; stemIdx++) {
+        for (int chainIdx = 0; chainIdx < pEngineEffectsManager->numPostFaderChains();
+                chainIdx++) {
+            if (pEngineEffectsManager->isPostFaderChainActive(chainIdx,
+                        m_stems[stemIdx].handle(),
+                        m_pEffectsManager->getMainHandle(),
+                        false)) {
+                return {};
+            }
+        }
+        const float stemGain = m_stemMute[stemIdx]->toBool()
+                ? 0.0f
+                : static_cast<float>(m_stemGain[stemIdx]->get());
+        if (stemGain != m_stemsGainCache[stemIdx]) {
+            // The gain is ramping in this buffer
+            return {};
+        }
+        if (stemGain == 0.0f) {
+            continue;
+        }
+        if (mask && stemGain != commonGain) {
+            return {};
+        }
+        commonGain = stemGain;
+        mask |= static_cast<mixxx::StemChannel>(1 << stemIdx);
+    }
+    return mask;
+}
+
 void EngineDeck::cloneStemState(const EngineDeck* deckToClone) {
     VERIFY_OR_DEBUG_ASSERT(deckToClone) {
         return;
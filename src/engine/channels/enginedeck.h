@@ -3,13 +3,14 @@
 #include <QScopedPointer>
 
 #include "engine/channels/enginechannel.h"
+#include "engine/engine.h"
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
 #include "track/track_decl.h"
-#include "util/samplebuffer.h"
 
 class EnginePregain;
 class EngineBuffer;
+class EngineEffectsManager;
 class EngineMixer;
 class ControlPushButton;
 class ControlPotmeter;
@@ -45,6 +46,11 @@ class EngineDeck : public EngineChannel, public AudioDestination {
 
     EngineChannel::ActiveState updateActiveState() override;
 
+#ifdef __STEM__
+    // Also prepares the states of the stems
+    void prepareEffectStates() override;
+#endif
+
     // This is called by SoundManager whenever there are new samples from the
     // configured input to be processed. This is run in the callback thread of
     // the soundcard this AudioDestination was registered for! Beware, in the
@@ -88,6 +94,10 @@ class EngineDeck : public EngineChannel, public AudioDestination {
 #ifdef __STEM__
     // Process multiple channels and mix them together into the passed buffer
     void processStem(CSAMPLE* pOutput, const std::size_t bufferSize);
+    /// The stems that can be stretched as one stereo mix, because they are
+    /// the only audible stems and are mixed with the same gain
+    mixxx::StemChannelSelection stemPremixMask(unsigned int stemCount,
+            EngineEffectsManager* pEngineEffectsManager) const;
 #endif
 
     std::vector<ChannelHandleAndGroup> m_stems;
@@ -98,8 +108,6 @@ class EngineDeck : public EngineChannel, public AudioDestination {
     EnginePregain* m_pPregain;
 
 #ifdef __STEM__
-    // Stem buffer used to retrieve all the channel to mix together
-    mixxx::SampleBuffer m_stemBuffer;
     std::unique_ptr<ControlObject> m_pStemCount;
     std::vector<std::unique_ptr<ControlPotmeter>> m_stemGain;
     std::vector<std::unique_ptr<ControlPushButton>> m_stemMute;
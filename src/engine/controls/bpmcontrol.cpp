@@ -680,14 +680,19 @@ bool BpmControl::getBeatContext(
         mixxx::audio::FramePos* pPrevBeatPosition,
         mixxx::audio::FramePos* pNextBeatPosition,
         mixxx::audio::FrameDiff_t* pBeatLengthFrames,
-        double* pBeatPercentage) {
+        double* pBeatPercentage,
+        const mixxx::Beats::Cursor* pBeatsCursor) {
     if (!pBeats) {
         return false;
     }
 
     mixxx::audio::FramePos prevBeatPosition;
     mixxx::audio::FramePos nextBeatPosition;
-    if (!pBeats->findPrevNextBeats(position, &prevBeatPosition, &nextBeatPosition, false)) {
+    if (!pBeats->findPrevNextBeats(position,
+                &prevBeatPosition,
+                &nextBeatPosition,
+                false,
+                pBeatsCursor)) {
         return false;
     }
 
@@ -763,7 +768,8 @@ mixxx::audio::FramePos BpmControl::getNearestPositionInPhase(
                     &thisPrevBeatPosition,
                     &thisNextBeatPosition,
                     &thisBeatLengthFrames,
-                    nullptr)) {
+                    nullptr,
+                    &m_beatsCursor)) {
             return thisPosition;
         }
     } else {
@@ -798,8 +804,10 @@ mixxx::audio::FramePos BpmControl::getNearestPositionInPhase(
         }
 
         TrackPointer otherTrack = pOtherEngineBuffer->getLoadedTrack();
-        mixxx::BeatsPointer otherBeats =
-                otherTrack ? otherTrack->getBeats() : mixxx::BeatsPointer();
+        // Called for each buffer, don't contend with the other deck
+        mixxx::BeatsPointer otherBeats = otherTrack
+                ? otherTrack->getEngineSnapshot()->pBeats
+                : mixxx::BeatsPointer();
 
         // If either track does not have beats, then we can't adjust the phase.
         if (!otherBeats) {
@@ -961,7 +969,8 @@ mixxx::audio::FramePos BpmControl::getBeatMatchPosition(
                 &thisPrevBeatPosition,
                 &thisNextBeatPosition,
                 &thisBeatLengthFrames,
-                nullptr);
+                nullptr,
+                &m_beatsCursor);
         // now we either have a useful next beat or there is none
         if (!thisNextBeatPosition.isValid()) {
             // We can't match the next beat, give up.
@@ -983,7 +992,9 @@ mixxx::audio::FramePos BpmControl::getBeatMatchPosition(
     }
 
     TrackPointer otherTrack = pOtherEngineBuffer->getLoadedTrack();
-    mixxx::BeatsPointer otherBeats = otherTrack ? otherTrack->getBeats() : mixxx::BeatsPointer();
+    mixxx::BeatsPointer otherBeats = otherTrack
+            ? otherTrack->getEngineSnapshot()->pBeats
+            : mixxx::BeatsPointer();
 
     // If either track does not have beats, then we can't adjust the phase.
     if (!otherBeats) {
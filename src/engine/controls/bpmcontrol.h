@@ -70,13 +70,15 @@ class BpmControl : public EngineControl {
     // Calculates contextual information about beats: the previous beat, the
     // next beat, the current beat length, and the beat ratio (how far dPosition
     // lies within the current beat). Returns false if a previous or next beat
-    // does not exist. NULL arguments are safe and ignored.
+    // does not exist. NULL arguments are safe and ignored. The optional
+    // cursor speeds up repeated lookups near the previous position.
     static bool getBeatContext(const mixxx::BeatsPointer& pBeats,
             mixxx::audio::FramePos position,
             mixxx::audio::FramePos* pPrevBeatPosition,
             mixxx::audio::FramePos* pNextBeatPosition,
             mixxx::audio::FrameDiff_t* pBeatLengthFrames,
-            double* pBeatPercentage);
+            double* pBeatPercentage,
+            const mixxx::Beats::Cursor* pBeatsCursor = nullptr);
 
     // Alternative version that works if the next and previous beat positions
     // are already known.
@@ -195,6 +197,7 @@ class BpmControl : public EngineControl {
 
     // m_pBeats is written from an engine worker thread
     mixxx::BeatsPointer m_pBeats;
+    mixxx::Beats::Cursor m_beatsCursor;
 
     FRIEND_TEST(EngineSyncTest, UserTweakPreservedInSeek);
     FRIEND_TEST(EngineSyncTest, FollowerUserTweakPreservedInLeaderChange);
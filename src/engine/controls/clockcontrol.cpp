@@ -83,7 +83,8 @@ void ClockControl::updateIndicators(const double dRate,
             pBeats->findPrevNextBeats(currentPosition,
                     &m_prevBeatPosition,
                     &m_nextBeatPosition,
-                    false); // Precise compare without tolerance needed
+                    false, // Precise compare without tolerance needed
+                    &m_beatsCursor);
         }
     } else {
         m_prevBeatPosition = mixxx::audio::kInvalidFramePos;
@@ -59,4 +59,5 @@ class ClockControl: public EngineControl {
 
     // m_pBeats is written from an engine worker thread
     mixxx::BeatsPointer m_pBeats;
+    mixxx::Beats::Cursor m_beatsCursor;
 };
@@ -649,32 +649,34 @@ void CueControl::loadCuesFromTrack() {
     }
 
     QSet<int> active_hotcues;
-    CuePointer pMainCue;
-    CuePointer pIntroCue;
-    CuePointer pOutroCue;
-
-    const QList<CuePointer> cues = m_pLoadedTrack->getCuePoints();
-    for (const auto& pCue : cues) {
-        switch (pCue->getType()) {
+    const mixxx::CueSnapshot* pMainCue = nullptr;
+    const mixxx::CueSnapshot* pIntroCue = nullptr;
+    const mixxx::CueSnapshot* pOutroCue = nullptr;
+
+    // The snapshot is read without copying the cues under the lock of the
+    // track. The cue objects are only looked up for attaching new hot cues.
+    const auto pSnapshot = m_pLoadedTrack->getEngineSnapshot();
+    for (const auto& cue : pSnapshot->cues) {
+        switch (cue.type) {
         case mixxx::CueType::MainCue:
             DEBUG_ASSERT(!pMainCue); // There should be only one MainCue cue
-            pMainCue = pCue;
+            pMainCue = &cue;
             break;
         case mixxx::CueType::Intro:
             DEBUG_ASSERT(!pIntroCue); // There should be only one Intro cue
-            pIntroCue = pCue;
+            pIntroCue = &cue;
             break;
         case mixxx::CueType::Outro:
             DEBUG_ASSERT(!pOutroCue); // There should be only one Outro cue
-            pOutroCue = pCue;
+            pOutroCue = &cue;
             break;
         case mixxx::CueType::HotCue:
         case mixxx::CueType::Loop: {
-            if (pCue->getHotCue() == Cue::kNoHotCue) {
+            if (cue.hotCueIndex == Cue::kNoHotCue) {
                 continue;
             }
 
-            int hotcue = pCue->getHotCue();
+            int hotcue = cue.hotCueIndex;
             HotcueControl* pControl = m_hotcueControls.value(hotcue, nullptr);
 
             // Cue's hotcue doesn't have a hotcue control.
@@ -685,24 +687,27 @@ void CueControl::loadCuesFromTrack() {
             CuePointer pOldCue(pControl->getCue());
 
             // If the old hotcue is different than this one.
-            if (pOldCue != pCue) {
+            if (pOldCue.get() != cue.pCue) {
+                const CuePointer pCue = m_pLoadedTrack->findHotcueByIndex(hotcue);
+                if (!pCue) {
+                    // Removed after the snapshot has been published
+                    continue;
+                }
                 // old cue is detached if required
                 attachCue(pCue, pControl);
             } else {
                 // If the old hotcue is the same, then we only need to update
-                Cue::StartAndEndPositions pos = pCue->getStartAndEndPosition();
-                pControl->setPosition(pos.startPosition);
-                pControl->setEndPosition(pos.endPosition);
-                pControl->setColor(pCue->getColor());
-                pControl->setType(pCue->getType());
+                pControl->setPosition(cue.startPosition);
+                pControl->setEndPosition(cue.endPosition);
+                pControl->setColor(cue.color);
+                pControl->setType(cue.type);
             }
             // Add the hotcue to the list of active hotcues
             active_hotcues.insert(hotcue);
             break;
         }
         case mixxx::CueType::N60dBSound: {
-            Cue::StartAndEndPositions pos = pCue->getStartAndEndPosition();
-            m_n60dBSoundStartPosition.setValue(pos.startPosition.toEngineSamplePos());
+            m_n60dBSoundStartPosition.setValue(cue.startPosition.toEngineSamplePos());
             break;
         }
         case mixxx::CueType::Beat:
@@ -722,8 +727,8 @@ void CueControl::loadCuesFromTrack() {
     }
 
     if (pIntroCue) {
-        const auto startPosition = quantizeCuePoint(pIntroCue->getPosition());
-        const auto endPosition = quantizeCuePoint(pIntroCue->getEndPosition());
+        const auto startPosition = quantizeCuePoint(pIntroCue->startPosition);
+        const auto endPosition = quantizeCuePoint(pIntroCue->endPosition);
 
         m_pIntroStartPosition->set(startPosition.toEngineSamplePosMaybeInvalid());
         m_pIntroStartEnabled->forceSet(startPosition.isValid());
@@ -737,8 +742,8 @@ void CueControl::loadCuesFromTrack() {
     }
 
     if (pOutroCue) {
-        const auto startPosition = quantizeCuePoint(pOutroCue->getPosition());
-        const auto endPosition = quantizeCuePoint(pOutroCue->getEndPosition());
+        const auto startPosition = quantizeCuePoint(pOutroCue->startPosition);
+        const auto endPosition = quantizeCuePoint(pOutroCue->endPosition);
 
         m_pOutroStartPosition->set(startPosition.toEngineSamplePosMaybeInvalid());
         m_pOutroStartEnabled->forceSet(startPosition.isValid());
@@ -756,7 +761,7 @@ void CueControl::loadCuesFromTrack() {
     // The mixxx::CueType::MainCue from getCuePoints() has the priority
     mixxx::audio::FramePos mainCuePosition;
     if (pMainCue) {
-        mainCuePosition = pMainCue->getPosition();
+        mainCuePosition = pMainCue->startPosition;
         // adjust the track cue accordingly
         m_pLoadedTrack->setMainCuePosition(mainCuePosition);
     } else {
@@ -1,6 +1,7 @@
 #include "engine/controls/loopingcontrol.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "control/controlobject.h"
 #include "control/controlpushbutton.h"
@@ -560,7 +561,9 @@ void LoopingControl::hintReader(gsl::not_null<HintVector*> pHintList) {
             loop_hint.type = Hint::Type::LoopStartEnabled;
             loop_hint.frame = static_cast<SINT>(
                     loopInfo.startPosition.toLowerFrameBoundary().value());
-            loop_hint.frameCount = Hint::kFrameCountForward;
+            // A whole chunk, the reader may not catch up behind the loop
+            // start at high rates
+            loop_hint.frameCount = CachingReaderChunk::kFrames;
             pHintList->append(loop_hint);
         }
         if (loopInfo.endPosition.isValid()) {
@@ -810,6 +813,18 @@ void LoopingControl::slotLoopRemove() {
     if (!pLoadedTrack) {
         return;
     }
+    // The snapshot is searched without copying the cues under the lock of
+    // the track, which only needs to be done if there is a loop cue
+    const auto pSnapshot = pLoadedTrack->getEngineSnapshot();
+    const bool hasLoopCue = std::any_of(pSnapshot->cues.cbegin(),
+            pSnapshot->cues.cend(),
+            [](const mixxx::CueSnapshot& cue) {
+                return cue.type == mixxx::CueType::Loop &&
+                        cue.hotCueIndex == Cue::kNoHotCue;
+            });
+    if (!hasLoopCue) {
+        return;
+    }
     const QList<CuePointer> cuePoints = pLoadedTrack->getCuePoints();
     for (const auto& pCue : cuePoints) {
         if (pCue->getType() == mixxx::CueType::Loop && pCue->getHotCue() == Cue::kNoHotCue) {
@@ -88,7 +88,11 @@ void QuantizeControl::lookupBeatPositions(mixxx::audio::FramePos position) {
     if (pBeats) {
         mixxx::audio::FramePos prevBeatPosition;
         mixxx::audio::FramePos nextBeatPosition;
-        pBeats->findPrevNextBeats(position, &prevBeatPosition, &nextBeatPosition, false);
+        pBeats->findPrevNextBeats(position,
+                &prevBeatPosition,
+                &nextBeatPosition,
+                false,
+                &m_beatsCursor);
         // FIXME: -1.0 is a valid frame position, should we set the COs to NaN?
         m_pCOPrevBeat->set(prevBeatPosition.toEngineSamplePosMaybeInvalid());
         m_pCONextBeat->set(nextBeatPosition.toEngineSamplePosMaybeInvalid());
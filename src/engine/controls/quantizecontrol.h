@@ -35,4 +35,5 @@ class QuantizeControl : public EngineControl {
 
     // m_pBeats is written from an engine worker thread
     mixxx::BeatsPointer m_pBeats;
+    mixxx::Beats::Cursor m_beatsCursor;
 };
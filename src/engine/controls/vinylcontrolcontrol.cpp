@@ -121,26 +121,28 @@ void VinylControlControl::slotControlVinylSeek(double fractionalPos) {
             return;
         }
 
-        mixxx::audio::FrameDiff_t shortestDistance = 0;
-        mixxx::audio::FramePos nearestPlayPos;
-
-        const QList<CuePointer> cuePoints(pTrack->getCuePoints());
-        QListIterator<CuePointer> it(cuePoints);
-        while (it.hasNext()) {
-            CuePointer pCue(it.next());
-            if (pCue->getType() != mixxx::CueType::HotCue || pCue->getHotCue() == -1) {
-                continue;
-            }
+        // pick the hot cues around newPlayPos from the snapshot, which
+        // doesn't lock the track
+        const auto pSnapshot = pTrack->getEngineSnapshot();
+        const auto& hotCuePositions = pSnapshot->startPositions(mixxx::CueType::HotCue);
+        const mixxx::audio::FramePos prevPlayPos =
+                pSnapshot->findPrevCuePosition(mixxx::CueType::HotCue, newPlayPos);
+        // The first hot cue after the previous one, which might also be
+        // at newPlayPos
+        mixxx::audio::FramePos nextPlayPos;
+        if (prevPlayPos.isValid()) {
+            nextPlayPos = pSnapshot->findNextCuePosition(
+                    mixxx::CueType::HotCue, prevPlayPos);
+        } else if (!hotCuePositions.isEmpty()) {
+            nextPlayPos = hotCuePositions.first();
+        }
 
-            const mixxx::audio::FramePos cuePosition = pCue->getPosition();
-            if (!cuePosition.isValid()) {
-                continue;
-            }
-            // pick cues closest to newPlayPos
-            if (!nearestPlayPos.isValid() || (fabs(newPlayPos - cuePosition) < shortestDistance)) {
-                nearestPlayPos = cuePosition;
-                shortestDistance = fabs(newPlayPos - cuePosition);
-            }
+        mixxx::audio::FramePos nearestPlayPos = prevPlayPos;
+        if (nextPlayPos.isValid() &&
+                (!nearestPlayPos.isValid() ||
+                        fabs(nextPlayPos - newPlayPos) <
+                                fabs(newPlayPos - nearestPlayPos))) {
+            nearestPlayPos = nextPlayPos;
         }
 
         if (!nearestPlayPos.isValid()) {
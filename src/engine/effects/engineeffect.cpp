@@ -4,6 +4,7 @@
 #include "engine/effects/engineeffectparameter.h"
 #include "engine/engine.h"
 #include "util/defs.h"
+#include "util/realtimecheck.h"
 #include "util/sample.h"
 
 namespace {
@@ -20,7 +21,10 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_pManifest(pManifest),
           m_pProcessor(pBackendManager->createProcessor(pManifest)),
-          m_parameters(pManifest->parameters().size()) {
+          m_parameters(pManifest->parameters().size()),
+          m_underflowCheckContext(pManifest->id().toUtf8()),
+          m_stateCounter(QStringLiteral("EffectStates ") + pManifest->id()),
+          m_numStates(0) {
     const QList<EffectManifestParameterPointer>& parameters = m_pManifest->parameters();
     for (int i = 0; i < parameters.size(); ++i) {
         EffectManifestParameterPointer param = parameters.at(i);
@@ -44,16 +48,22 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
             kInitalSampleRate,
             kMaxEngineFrames);
     m_pProcessor->initialize(activeInputChannels, registeredOutputChannels, engineParameters);
+    updateStateCounter();
     m_effectRampsFromDry = pManifest->effectRampsFromDry();
+    m_tailLengthSeconds = pManifest->tailLengthSeconds();
 }
 
 EngineEffect::~EngineEffect() {
     if constexpr (kEffectDebugOutput) {
         qDebug() << debugString() << "destroyed";
     }
+    // The states are deleted together with the processor
+    m_stateCounter += -m_numStates;
 }
 
 void EngineEffect::initalizeInputChannel(ChannelHandle inputChannel) {
+    // Invalidates pending releases, even if the states still exist
+    ++m_inputChannelGenerations[inputChannel.handle()];
     if (m_pProcessor->hasStatesForInputChannel(inputChannel)) {
         // already initialized for this input channel
         return;
@@ -64,6 +74,29 @@ void EngineEffect::initalizeInputChannel(ChannelHandle inputChannel) {
             kInitalSampleRate,
             kMaxEngineFrames);
     m_pProcessor->initializeInputChannel(inputChannel, engineParameters);
+    updateStateCounter();
+}
+
+void EngineEffect::releaseInputChannelStates(
+        ChannelHandle inputChannel, quint64 generation) {
+    if (generation != inputChannelGeneration(inputChannel)) {
+        // Enabled again while the request was pending
+        return;
+    }
+    if (!m_pProcessor->hasStatesForInputChannel(inputChannel)) {
+        return;
+    }
+    if constexpr (kEffectDebugOutput) {
+        qDebug() << debugString() << "releasing states for" << inputChannel;
+    }
+    m_pProcessor->releaseInputChannel(inputChannel);
+    updateStateCounter();
+}
+
+void EngineEffect::updateStateCounter() {
+    const int numStates = m_pProcessor->numStates();
+    m_stateCounter += numStates - m_numStates;
+    m_numStates = numStates;
 }
 
 bool EngineEffect::processEffectsRequest(EffectsRequest& message,
@@ -182,13 +215,17 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
                 sampleRate,
                 numSamples / mixxx::kEngineChannelOutputCount);
 
-        m_pProcessor->process(inputHandle,
-                outputHandle,
-                pInput,
-                pOutput,
-                engineParameters,
-                effectiveEffectEnableState,
-                groupFeatures);
+        {
+            const mixxx::realtime::Check::ScopedUnderflowCheck underflowCheck(
+                    m_underflowCheckContext.constData());
+            m_pProcessor->process(inputHandle,
+                    outputHandle,
+                    pInput,
+                    pOutput,
+                    engineParameters,
+                    effectiveEffectEnableState,
+                    groupFeatures);
+        }
 
         processingOccured = true;
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QByteArray>
+#include <QHash>
 #include <QMap>
 #include <QSet>
 #include <QString>
@@ -11,6 +13,7 @@
 #include "effects/backends/effectprocessor.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
+#include "util/counter.h"
 #include "util/types.h"
 
 /// EngineEffect is a generic wrapper around an EffectProcessor which intermediates
@@ -32,6 +35,18 @@ class EngineEffect final : public EffectsRequestHandler {
     /// Called from the main thread to make sure that the channel already has states
     void initalizeInputChannel(ChannelHandle inputChannel);
 
+    /// Called from the main thread. Incremented by every initalizeInputChannel()
+    /// to detect if the channel has been enabled again after requesting the
+    /// release of its states.
+    quint64 inputChannelGeneration(ChannelHandle inputChannel) const {
+        return m_inputChannelGenerations.value(inputChannel.handle());
+    }
+
+    /// Called from the main thread after the audio thread has confirmed that
+    /// the input channel is no longer processed. The states are kept if the
+    /// channel has been initialized again in the meantime.
+    void releaseInputChannelStates(ChannelHandle inputChannel, quint64 generation);
+
     /// Called in audio thread
     bool processEffectsRequest(
             EffectsRequest& message,
@@ -47,6 +62,32 @@ class EngineEffect final : public EffectsRequestHandler {
             const EffectEnableState chainEnableState,
             const GroupFeatureState& groupFeatures);
 
+    /// Called in audio thread
+    /// The tail length of the effect or -1 if it is unbounded
+    SINT getTailFrames(mixxx::audio::SampleRate sampleRate) const {
+        if (m_tailLengthSeconds < 0) {
+            return -1;
+        }
+        return static_cast<SINT>(m_tailLengthSeconds * sampleRate.toDouble());
+    }
+
+    /// Called in audio thread
+    /// False if the effect is ramping out and must still be processed
+    /// to update its state, even if the tail has already decayed.
+    bool canSkipSilentInput(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) {
+        return m_effectEnableStateForChannelMatrix[inputHandle][outputHandle] !=
+                EffectEnableState::Disabling;
+    }
+
+    /// Called in audio thread
+    /// Creates the enable state of the channel if it doesn't exist yet, see
+    /// EngineEffectChain::prepareChannel()
+    void prepareChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) {
+        m_effectEnableStateForChannelMatrix[inputHandle][outputHandle];
+    }
+
     const EffectManifestPointer getManifest() const {
         return m_pManifest;
     }
@@ -64,12 +105,22 @@ class EngineEffect final : public EffectsRequestHandler {
         return QString("EngineEffect(%1)").arg(m_pManifest->name());
     }
 
+    void updateStateCounter();
+
     EffectManifestPointer m_pManifest;
     std::unique_ptr<EffectProcessor> m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
     bool m_effectRampsFromDry;
+    double m_tailLengthSeconds;
     // Must not be modified after construction.
     QVector<EngineEffectParameterPointer> m_parameters;
     QMap<QString, EngineEffectParameterPointer> m_parametersById;
+    // The id of the effect for the underflows detected by the realtime checks
+    const QByteArray m_underflowCheckContext;
+
+    // Only accessed from the main thread
+    QHash<int, quint64> m_inputChannelGenerations;
+    Counter m_stateCounter;
+    int m_numStates;
 
 };
@@ -1,20 +1,33 @@
 #include "engine/effects/engineeffectchain.h"
 
+#include <algorithm>
+
 #include "engine/effects/engineeffect.h"
+#include "engine/engine.h"
+#include "engine/enginescratcharena.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// -90 dBFS, below the resolution of 16 bit output
+constexpr CSAMPLE kSilenceThreshold = 3.1623e-5f;
+
+// Longer than any bounded tail
+constexpr SINT kMaxSilentFrames = 1 << 30;
+
+} // namespace
+
 EngineEffectChain::EngineEffectChain(const QString& group,
         const QSet<ChannelHandleAndGroup>& registeredInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_group(group),
           m_enableState(EffectEnableState::Enabled),
+          m_processedInCallback(false),
           m_mixMode(EffectChainMixMode::DrySlashWet),
-          m_dMix(0),
-          m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_dMix(0) {
     // Try to prevent memory allocation.
-    m_effects.reserve(256);
+    m_effects.reserve(kEffectsCapacity);
 
     for (const ChannelHandleAndGroup& inputChannel : registeredInputChannels) {
         ChannelHandleMap<ChannelStatus> outputChannelMap;
@@ -73,6 +86,17 @@ bool EngineEffectChain::removeEffect(EngineEffect* pEffect, int iIndex) {
     return true;
 }
 
+bool EngineEffectChain::replaceEffects(EngineEffectsReplacement* pReplacement) {
+    VERIFY_OR_DEBUG_ASSERT(pReplacement) {
+        return false;
+    }
+    // Only exchanges the pointers to the data of the lists. The list has been
+    // allocated in the main thread with the same capacity, and the replaced
+    // list is freed in the main thread.
+    m_effects.swap(pReplacement->effects);
+    return true;
+}
+
 // this is called from the engine thread onCallbackStart()
 bool EngineEffectChain::updateParameters(const EffectsRequest& message) {
     // TODO(rryan): Parameter interpolation.
@@ -109,6 +133,13 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
         response.success = removeEffect(message.RemoveEffectFromChain.pEffect,
                 message.RemoveEffectFromChain.iIndex);
         break;
+    case EffectsRequest::REPLACE_EFFECTS_OF_CHAIN:
+        if (kEffectDebugOutput) {
+            qDebug() << debugString() << this << "REPLACE_EFFECTS_OF_CHAIN"
+                     << message.ReplaceEffectsOfChain.pReplacement;
+        }
+        response.success = replaceEffects(message.ReplaceEffectsOfChain.pReplacement);
+        break;
     case EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS:
         if (kEffectDebugOutput) {
             qDebug() << debugString() << this << "SET_EFFECT_CHAIN_PARAMETERS"
@@ -138,6 +169,18 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
         response.success = disableForInputChannel(
                 message.DisableInputChannelForChain.channelHandle);
         break;
+    case EffectsRequest::RELEASE_EFFECT_STATES_FOR_INPUT_CHANNEL:
+        if (kEffectDebugOutput) {
+            qDebug() << debugString() << this
+                     << "RELEASE_EFFECT_STATES_FOR_INPUT_CHANNEL"
+                     << message.pTargetChain
+                     << message.ReleaseEffectStatesForInputChannel.channelHandle;
+        }
+        // Not an error if the chain has been enabled again or is still
+        // ramping out. The states are kept in this case.
+        response.success = isDisabledForInputChannel(
+                message.ReleaseEffectStatesForInputChannel.channelHandle);
+        break;
     default:
         return false;
     }
@@ -171,6 +214,16 @@ bool EngineEffectChain::disableForInputChannel(ChannelHandle inputHandle) {
     return true;
 }
 
+bool EngineEffectChain::isDisabledForInputChannel(ChannelHandle inputHandle) {
+    const auto& outputMap = m_chainStatusForChannelMatrix[inputHandle];
+    for (const auto& outputChannelStatus : outputMap) {
+        if (outputChannelStatus.enableState != EffectEnableState::Disabled) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -190,45 +243,63 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     // when it gets the intermediate disabling signal.
 
     ChannelStatus& channelStatus = m_chainStatusForChannelMatrix[inputHandle][outputHandle];
-    EffectEnableState effectiveChainEnableState = channelStatus.enableState;
-
-    if (fadeout && channelStatus.enableState == EffectEnableState::Enabled) {
-        // This is the last callback before pause
-        // It can start again without further notice
-        // make use the effect is paused
-        effectiveChainEnableState = EffectEnableState::Disabling;
-    }
-
-    // If the channel is fully disabled, do not let intermediate
-    // enabling/disabling signals from the chain's enable switch override
-    // the channel's state.
-    if (effectiveChainEnableState != EffectEnableState::Disabled) {
-        if (m_enableState != EffectEnableState::Enabled) {
-            effectiveChainEnableState = m_enableState;
-        }
-    }
+    const EffectEnableState effectiveChainEnableState =
+            effectiveEnableState(channelStatus, fadeout);
 
     CSAMPLE currentMixKnob = m_dMix;
     CSAMPLE lastCallbackMixKnob = channelStatus.oldMixKnob;
 
+    // Effects with a bounded tail are skipped while the input is silent
+    // and their output would be silent as well, e.g. for a paused deck.
+    // This is only done while the chain is fully enabled to not interfere
+    // with the enabling and disabling ramps.
+    if (effectiveChainEnableState == EffectEnableState::Enabled &&
+            SampleUtil::maxAbsAmplitude(pIn, static_cast<SINT>(numSamples)) <
+                    kSilenceThreshold) {
+        // Saturating, the tails are much shorter
+        channelStatus.silentFrames = std::min(
+                channelStatus.silentFrames +
+                        static_cast<SINT>(numSamples / mixxx::kEngineChannelOutputCount),
+                kMaxSilentFrames);
+    } else {
+        channelStatus.silentFrames = 0;
+    }
+
     bool processingOccured = false;
     if (effectiveChainEnableState != EffectEnableState::Disabled) {
         // Ramping code inside the effects need to access the original samples
         // after writing to the output buffer. This requires not to use the same buffer
         // for in and output: Also, ChannelMixer::applyEffectsAndMixChannels
         // requires that the input buffer does not get modified.
+        EngineScratchArena::Scope scratch;
+        CSAMPLE* const pBuffer1 = scratch.allocate(static_cast<SINT>(numSamples));
+        CSAMPLE* const pBuffer2 = scratch.allocate(static_cast<SINT>(numSamples));
         CSAMPLE* pIntermediateInput = pIn;
         CSAMPLE* pIntermediateOutput;
         SINT effectChainGroupDelayFrames = 0;
         bool firstAddDryToWetEffectProcessed = false;
+        // The tail of an effect includes the tails of the preceding effects,
+        // -1 if any of them is unbounded.
+        SINT chainTailFrames = 0;
 
         for (EngineEffect* pEffect : std::as_const(m_effects)) {
             if (pEffect != nullptr) {
+                if (chainTailFrames >= 0) {
+                    const SINT tailFrames = pEffect->getTailFrames(sampleRate);
+                    chainTailFrames = tailFrames >= 0 ? chainTailFrames + tailFrames : -1;
+                }
+                if (chainTailFrames >= 0 &&
+                        channelStatus.silentFrames > chainTailFrames &&
+                        pEffect->canSkipSilentInput(inputHandle, outputHandle)) {
+                    // The input of the next effect remains unchanged
+                    continue;
+                }
+
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pBuffer1) {
+                    pIntermediateOutput = pBuffer2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pBuffer1;
                 }
 
                 if (pEffect->process(inputHandle,
@@ -254,7 +325,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                                 m_mixMode == EffectChainMixMode::DryPlusWet;
 
                         if (!skipAddingDry) {
-                            for (SINT i = 0; i <= static_cast<SINT>(numSamples); ++i) {
+                            for (SINT i = 0; i < static_cast<SINT>(numSamples); ++i) {
                                 pIntermediateOutput[i] += pIntermediateInput[i];
                             }
                         }
@@ -305,9 +376,80 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
 
     channelStatus.oldMixKnob = currentMixKnob;
 
+    updateEnableStates(&channelStatus, fadeout);
+    m_processedInCallback.store(true, std::memory_order_relaxed);
+
+    return processingOccured;
+}
+
+bool EngineEffectChain::isActiveForChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        bool fadeout) {
+    // Might allocate the status, just like process()
+    const ChannelStatus& channelStatus =
+            m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    return effectiveEnableState(channelStatus, fadeout) != EffectEnableState::Disabled;
+}
+
+void EngineEffectChain::skipInactiveChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        bool fadeout) {
+    ChannelStatus& channelStatus = m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    DEBUG_ASSERT(effectiveEnableState(channelStatus, fadeout) == EffectEnableState::Disabled);
+    channelStatus.oldMixKnob = m_dMix;
+    updateEnableStates(&channelStatus, fadeout);
+    m_processedInCallback.store(true, std::memory_order_relaxed);
+}
+
+void EngineEffectChain::prepareChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    for (EngineEffect* pEffect : std::as_const(m_effects)) {
+        if (pEffect) {
+            pEffect->prepareChannel(inputHandle, outputHandle);
+        }
+    }
+}
+
+void EngineEffectChain::onCallbackEnd() {
+    if (!m_processedInCallback.exchange(false, std::memory_order_relaxed)) {
+        return;
+    }
+    if (m_enableState == EffectEnableState::Disabling) {
+        m_enableState = EffectEnableState::Disabled;
+    } else if (m_enableState == EffectEnableState::Enabling) {
+        m_enableState = EffectEnableState::Enabled;
+    }
+}
+
+EffectEnableState EngineEffectChain::effectiveEnableState(
+        const ChannelStatus& channelStatus, bool fadeout) const {
+    EffectEnableState effectiveChainEnableState = channelStatus.enableState;
+
+    if (fadeout && channelStatus.enableState == EffectEnableState::Enabled) {
+        // This is the last callback before pause
+        // It can start again without further notice
+        // make use the effect is paused
+        effectiveChainEnableState = EffectEnableState::Disabling;
+    }
+
+    // If the channel is fully disabled, do not let intermediate
+    // enabling/disabling signals from the chain's enable switch override
+    // the channel's state.
+    if (effectiveChainEnableState != EffectEnableState::Disabled) {
+        if (m_enableState != EffectEnableState::Enabled) {
+            effectiveChainEnableState = m_enableState;
+        }
+    }
+    return effectiveChainEnableState;
+}
+
+void EngineEffectChain::updateEnableStates(ChannelStatus* pChannelStatus, bool fadeout) {
+    ChannelStatus& channelStatus = *pChannelStatus;
+
     // If the EffectProcessors have been sent a signal for the intermediate
-    // enabling/disabling state, set the channel state or chain state
-    // to the fully enabled/disabled state for the next engine callback.
+    // enabling/disabling state, set the channel state to the fully
+    // enabled/disabled state for the next engine callback.
 
     if (channelStatus.enableState == EffectEnableState::Disabling) {
         channelStatus.enableState = EffectEnableState::Disabled;
@@ -320,11 +462,5 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         channelStatus.enableState = EffectEnableState::Enabling;
     }
 
-    if (m_enableState == EffectEnableState::Disabling) {
-        m_enableState = EffectEnableState::Disabled;
-    } else if (m_enableState == EffectEnableState::Enabling) {
-        m_enableState = EffectEnableState::Enabled;
-    }
-
-    return processingOccured;
+    // The state of the chain is advanced by onCallbackEnd()
 }
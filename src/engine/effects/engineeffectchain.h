@@ -2,13 +2,13 @@
 
 #include <QList>
 #include <QString>
+#include <atomic>
 
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/engineeffectsdelay.h"
 #include "engine/effects/message.h"
 #include "util/class.h"
-#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class EngineEffect;
@@ -23,6 +23,10 @@ class EngineEffect;
 /// the mix knob, and the chain enable switch.
 class EngineEffectChain final : public EffectsRequestHandler {
   public:
+    /// The capacity of the list of effects, which must not grow in the
+    /// audio thread. Also used for the lists of EngineEffectsReplacement.
+    static constexpr int kEffectsCapacity = 256;
+
     /// called from main thread
     EngineEffectChain(const QString& group,
             const QSet<ChannelHandleAndGroup>& registeredInputChannels,
@@ -45,33 +49,71 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const GroupFeatureState& groupFeatures,
             bool fadeout);
 
+    /// called from audio thread
+    /// Returns false if process() would not touch the audio buffers of
+    /// the channel, because the chain is disabled for it.
+    bool isActiveForChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            bool fadeout);
+
+    /// called from audio thread
+    /// Replaces process() for a channel that is not active. Only advances
+    /// the enable states like process() would do.
+    void skipInactiveChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            bool fadeout);
+
+    /// called from audio thread
+    /// Creates the status of the channel if it doesn't exist yet. Called
+    /// before the channel is processed concurrently with other channels,
+    /// which must not create their statuses at the same time.
+    void prepareChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+
+    /// called from audio thread, after all channels have been processed
+    /// Advances the intermediate enabling/disabling state of the chain, if
+    /// any channel has been processed in this callback. The channels might be
+    /// processed concurrently, so all of them see the same chain state.
+    void onCallbackEnd();
+
   private:
     struct ChannelStatus {
         ChannelStatus()
                 : oldMixKnob(0),
-                  enableState(EffectEnableState::Disabled) {
+                  enableState(EffectEnableState::Disabled),
+                  silentFrames(0) {
         }
         CSAMPLE oldMixKnob;
         EffectEnableState enableState;
+        // The number of frames the input has been silent for
+        SINT silentFrames;
     };
 
     QString debugString() const {
         return QString("EngineEffectChain(%1)").arg(m_group);
     }
 
+    EffectEnableState effectiveEnableState(
+            const ChannelStatus& channelStatus, bool fadeout) const;
+    void updateEnableStates(ChannelStatus* pChannelStatus, bool fadeout);
+
     bool updateParameters(const EffectsRequest& message);
     bool addEffect(EngineEffect* pEffect, int iIndex);
     bool removeEffect(EngineEffect* pEffect, int iIndex);
+    bool replaceEffects(EngineEffectsReplacement* pReplacement);
     bool enableForInputChannel(ChannelHandle inputHandle);
     bool disableForInputChannel(ChannelHandle inputHandle);
+    /// True if the effects are neither processed nor ramping out
+    /// for any output of the channel
+    bool isDisabledForInputChannel(ChannelHandle inputHandle);
 
     QString m_group;
+    // Only modified by the engine thread, while no channel is processed
     EffectEnableState m_enableState;
+    std::atomic<bool> m_processedInCallback;
     EffectChainMixMode::Type m_mixMode;
     CSAMPLE m_dMix;
     QList<EngineEffect*> m_effects;
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
     EngineEffectsDelay m_effectsDelay;
 
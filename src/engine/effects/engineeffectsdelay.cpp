@@ -1,5 +1,7 @@
 #include "engine/effects/engineeffectsdelay.h"
 
+#include <algorithm>
+
 #include "moc_engineeffectsdelay.cpp"
 #include "util/rampingvalue.h"
 #include "util/sample.h"
@@ -7,65 +9,72 @@
 EngineEffectsDelay::EngineEffectsDelay()
         : m_currentDelaySamples(0),
           m_prevDelaySamples(0),
-          m_delayBufferWritePos(0) {
-    m_pDelayBuffer = SampleUtil::alloc(kDelayBufferSize);
-    SampleUtil::clear(m_pDelayBuffer, kDelayBufferSize);
+          m_delayBufferWritePos(0),
+          m_delayBuffer(kInitialDelayBufferSize) {
 }
 
-EngineEffectsDelay::~EngineEffectsDelay() {
-    SampleUtil::free(m_pDelayBuffer);
-}
+EngineEffectsDelay::~EngineEffectsDelay() = default;
 
 void EngineEffectsDelay::process(CSAMPLE* pInOut,
         const std::size_t bufferSize) {
+    // The delayed samples must not be overwritten by the samples of the
+    // current frame before they are read
+    const SINT delayBufferSize = m_delayBuffer.reserve(
+            std::max(m_currentDelaySamples, m_prevDelaySamples) +
+                    mixxx::kEngineChannelOutputCount,
+            &m_delayBufferWritePos);
+    const SINT maxDelaySamples = delayBufferSize - mixxx::kEngineChannelOutputCount;
+    m_currentDelaySamples = std::min(m_currentDelaySamples, maxDelaySamples);
+    m_prevDelaySamples = std::min(m_prevDelaySamples, maxDelaySamples);
+
     if (m_prevDelaySamples == 0 && m_currentDelaySamples == 0) {
         for (std::size_t i = 0; i < bufferSize; ++i) {
             // Put samples into delay buffer.
-            m_pDelayBuffer[m_delayBufferWritePos] = pInOut[i];
-            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % kDelayBufferSize;
+            m_delayBuffer[m_delayBufferWritePos] = pInOut[i];
+            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % delayBufferSize;
         }
 
         return;
     }
 
-    // The "+ kDelayBufferSize" addition ensures positive values for the modulo calculation.
+    // The "+ delayBufferSize" addition ensures positive values for the modulo calculation.
     // From a mathematical point of view, this addition can be removed. Anyway,
     // from the cpp point of view, the modulo operator for negative values
     // (for example, x % y, where x is a negative value) produces negative results
     // (but in math the result value is positive).
     int delaySourcePos =
-            (m_delayBufferWritePos + kDelayBufferSize - m_currentDelaySamples) %
-            kDelayBufferSize;
+            (m_delayBufferWritePos + delayBufferSize - m_currentDelaySamples) %
+            delayBufferSize;
 
     if (m_prevDelaySamples == m_currentDelaySamples) {
         for (std::size_t i = 0; i < bufferSize; ++i) {
             // Put samples into delay buffer.
-            m_pDelayBuffer[m_delayBufferWritePos] = pInOut[i];
-            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % kDelayBufferSize;
+            m_delayBuffer[m_delayBufferWritePos] = pInOut[i];
+            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % delayBufferSize;
 
             // Take a delayed sample from the delay buffer
             // and copy it to the destination buffer.
-            pInOut[i] = m_pDelayBuffer[delaySourcePos];
-            delaySourcePos = (delaySourcePos + 1) % kDelayBufferSize;
+            pInOut[i] = m_delayBuffer[delaySourcePos];
+            delaySourcePos = (delaySourcePos + 1) % delayBufferSize;
         }
 
     } else {
-        // The "+ kDelayBufferSize" addition ensures positive values for the modulo calculation.
+        // The "+ delayBufferSize" addition ensures positive values for the modulo calculation.
         // From a mathematical point of view, this addition can be removed. Anyway,
         // from the cpp point of view, the modulo operator for negative values
         // (for example, x % y, where x is a negative value) produces negative results
         // (but in math the result value is positive).
         int oldDelaySourcePos =
-                (m_delayBufferWritePos + kDelayBufferSize - m_prevDelaySamples) %
-                kDelayBufferSize;
+                (m_delayBufferWritePos + delayBufferSize - m_prevDelaySamples) %
+                delayBufferSize;
 
         const RampingValue<CSAMPLE_GAIN> delayChangeRamped(
                 0.0f, 1.0f, static_cast<int>(bufferSize));
 
         for (std::size_t i = 0; i < bufferSize; ++i) {
             // Put samples into delay buffer.
-            m_pDelayBuffer[m_delayBufferWritePos] = pInOut[i];
-            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % kDelayBufferSize;
+            m_delayBuffer[m_delayBufferWritePos] = pInOut[i];
+            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % delayBufferSize;
 
             // Take delayed samples from the delay buffer
             // and with the use of ramping (cross-fading),
@@ -73,11 +82,11 @@ void EngineEffectsDelay::process(CSAMPLE* pInOut,
             // and put it into the dest buffer.
             CSAMPLE_GAIN crossMix = delayChangeRamped.getNth(static_cast<int>(i));
 
-            pInOut[i] = m_pDelayBuffer[oldDelaySourcePos] * (1.0f - crossMix);
-            pInOut[i] += m_pDelayBuffer[delaySourcePos] * crossMix;
+            pInOut[i] = m_delayBuffer[oldDelaySourcePos] * (1.0f - crossMix);
+            pInOut[i] += m_delayBuffer[delaySourcePos] * crossMix;
 
-            oldDelaySourcePos = (oldDelaySourcePos + 1) % kDelayBufferSize;
-            delaySourcePos = (delaySourcePos + 1) % kDelayBufferSize;
+            oldDelaySourcePos = (oldDelaySourcePos + 1) % delayBufferSize;
+            delaySourcePos = (delaySourcePos + 1) % delayBufferSize;
         }
 
         m_prevDelaySamples = m_currentDelaySamples;
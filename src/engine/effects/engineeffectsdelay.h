@@ -3,13 +3,15 @@
 #include "engine/engine.h"
 #include "engine/engineobject.h"
 #include "util/assert.h"
+#include "util/delaybufferpool.h"
 #include "util/types.h"
 
 namespace {
 static constexpr int kMaxDelayFrames =
         mixxx::audio::SampleRate::kValueMax - 1;
-static constexpr int kDelayBufferSize =
-        mixxx::audio::SampleRate::kValueMax * mixxx::kEngineChannelOutputCount;
+// Most chains have no or only a short delay, so the buffer only grows
+// beyond this size when a longer delay is required
+static constexpr int kInitialDelayBufferSize = DelayBufferPool::kSizeGranularity;
 } // anonymous namespace
 
 /// The effect can produce the output signal with a specific delay caused
@@ -71,11 +73,14 @@ class EngineEffectsDelay final : public EngineObject {
     /// as actual and the output buffer is filled using cross-fading
     /// of the presumed output buffer for the previous delay value
     /// and of the output buffer created using the new delay value.
+    ///
+    /// Delays that exceed the current size of the delay buffer are limited
+    /// to it until the DelayBufferPool has provided a larger buffer.
     void process(CSAMPLE* pInOut, const std::size_t bufferSize) override;
 
   private:
     SINT m_currentDelaySamples;
     SINT m_prevDelaySamples;
     SINT m_delayBufferWritePos;
-    CSAMPLE* m_pDelayBuffer;
+    DelayBuffer m_delayBuffer;
 };
@@ -3,13 +3,13 @@
 #include "audio/types.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/engineprofiler.h"
+#include "engine/enginescratcharena.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe&& responsePipe)
-        : m_responsePipe(std::move(responsePipe)),
-          m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+        : m_responsePipe(std::move(responsePipe)) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 }
@@ -28,9 +28,11 @@ void EngineEffectsManager::onCallbackStart() {
             break;
         case EffectsRequest::ADD_EFFECT_TO_CHAIN:
         case EffectsRequest::REMOVE_EFFECT_FROM_CHAIN:
+        case EffectsRequest::REPLACE_EFFECTS_OF_CHAIN:
         case EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS:
         case EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL:
-        case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL: {
+        case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL:
+        case EffectsRequest::RELEASE_EFFECT_STATES_FOR_INPUT_CHANNEL: {
             bool chainExists = false;
             for (const auto& chains : std::as_const(m_chainsByStage)) {
                 if (chains.contains(request->pTargetChain)) {
@@ -53,6 +55,15 @@ void EngineEffectsManager::onCallbackStart() {
                     m_effects.append(request->AddEffectToChain.pEffect);
                 } else if (request->type == EffectsRequest::REMOVE_EFFECT_FROM_CHAIN) {
                     m_effects.removeAll(request->RemoveEffectFromChain.pEffect);
+                } else if (request->type == EffectsRequest::REPLACE_EFFECTS_OF_CHAIN) {
+                    const EngineEffectsReplacement* pReplacement =
+                            request->ReplaceEffectsOfChain.pReplacement;
+                    for (EngineEffect* pEffect : pReplacement->removedEffects) {
+                        m_effects.removeAll(pEffect);
+                    }
+                    for (EngineEffect* pEffect : pReplacement->addedEffects) {
+                        m_effects.append(pEffect);
+                    }
                 }
             } else {
                 // If we got here, the message was not handled for
@@ -92,11 +103,33 @@ void EngineEffectsManager::onCallbackStart() {
     }
 }
 
+void EngineEffectsManager::onCallbackEnd() {
+    for (const auto& chains : std::as_const(m_chainsByStage)) {
+        for (EngineEffectChain* pChain : chains) {
+            if (pChain) {
+                pChain->onCallbackEnd();
+            }
+        }
+    }
+}
+
+void EngineEffectsManager::prepareInputChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    for (const auto& chains : std::as_const(m_chainsByStage)) {
+        for (EngineEffectChain* pChain : chains) {
+            if (pChain) {
+                pChain->prepareChannel(inputHandle, outputHandle);
+            }
+        }
+    }
+}
+
 void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pInOut,
         std::size_t numSamples,
         mixxx::audio::SampleRate sampleRate) {
+    EngineProfiler::ScopedChannelStage stage(EngineProfiler::ChannelStage::PreFaderEffects);
     // Feature state is gathered after prefader effects processing.
     // This is okay because the equalizer effects do not make use of it.
     GroupFeatureState featureState;
@@ -133,6 +166,40 @@ void EngineEffectsManager::processPostFaderInPlace(
             fadeout);
 }
 
+void EngineEffectsManager::processActivePostFaderInPlace(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        CSAMPLE* pInOut,
+        std::size_t numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        const GroupFeatureState& groupFeatures,
+        CSAMPLE_GAIN oldGain,
+        CSAMPLE_GAIN newGain,
+        bool fadeout) {
+    const QList<EngineEffectChain*>& chains =
+            m_chainsByStage.value(SignalProcessingStage::Postfader);
+    SampleUtil::applyRampingGain(pInOut, oldGain, newGain, numSamples);
+    for (EngineEffectChain* pChain : chains) {
+        if (!pChain) {
+            continue;
+        }
+        // Another channel might be processed by the inactive chains at the
+        // same time
+        if (pChain->isActiveForChannel(inputHandle, outputHandle, fadeout)) {
+            pChain->process(inputHandle,
+                    outputHandle,
+                    pInOut,
+                    pInOut,
+                    numSamples,
+                    sampleRate,
+                    groupFeatures,
+                    fadeout);
+        } else {
+            pChain->skipInactiveChannel(inputHandle, outputHandle, fadeout);
+        }
+    }
+}
+
 void EngineEffectsManager::processPostFaderAndMix(
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
@@ -157,6 +224,38 @@ void EngineEffectsManager::processPostFaderAndMix(
             fadeout);
 }
 
+bool EngineEffectsManager::skipPostFaderIfInactive(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        bool fadeout) {
+    const QList<EngineEffectChain*>& chains =
+            m_chainsByStage.value(SignalProcessingStage::Postfader);
+    for (EngineEffectChain* pChain : chains) {
+        if (pChain && pChain->isActiveForChannel(inputHandle, outputHandle, fadeout)) {
+            return false;
+        }
+    }
+    for (EngineEffectChain* pChain : chains) {
+        if (pChain) {
+            pChain->skipInactiveChannel(inputHandle, outputHandle, fadeout);
+        }
+    }
+    return true;
+}
+
+bool EngineEffectsManager::isPostFaderChainActive(int chainIndex,
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        bool fadeout) {
+    const QList<EngineEffectChain*>& chains =
+            m_chainsByStage.value(SignalProcessingStage::Postfader);
+    VERIFY_OR_DEBUG_ASSERT(chainIndex >= 0 && chainIndex < chains.size()) {
+        return false;
+    }
+    EngineEffectChain* pChain = chains.at(chainIndex);
+    return pChain && pChain->isActiveForChannel(inputHandle, outputHandle, fadeout);
+}
+
 void EngineEffectsManager::processInner(
         const SignalProcessingStage stage,
         const ChannelHandle& inputHandle,
@@ -196,7 +295,10 @@ void EngineEffectsManager::processInner(
         // 3. Mix the temporary buffer into pOut
         //    ChannelMixer::applyEffectsAndMixChannels use
         //    this to mix channels into pOut regardless of whether any effects were processed.
-        CSAMPLE* pIntermediateInput = m_buffer1.data();
+        EngineScratchArena::Scope scratch;
+        CSAMPLE* const pBuffer1 = scratch.allocate(static_cast<SINT>(numSamples));
+        CSAMPLE* const pBuffer2 = scratch.allocate(static_cast<SINT>(numSamples));
+        CSAMPLE* pIntermediateInput = pBuffer1;
         if (oldGain == CSAMPLE_GAIN_ONE && newGain == CSAMPLE_GAIN_ONE) {
             // Avoid an unnecessary copy. EngineEffectChain::process does not modify the
             // input buffer when its input & output buffers are different, so this is okay.
@@ -209,10 +311,10 @@ void EngineEffectsManager::processInner(
         for (EngineEffectChain* pChain : chains) {
             if (pChain) {
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pBuffer1) {
+                    pIntermediateOutput = pBuffer2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pBuffer1;
                 }
 
                 if (pChain->process(inputHandle,
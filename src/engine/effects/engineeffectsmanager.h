@@ -3,7 +3,6 @@
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
-#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class EngineEffectChain;
@@ -25,6 +24,15 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     ~EngineEffectsManager() override = default;
 
     void onCallbackStart();
+    /// Advances the enable states of the chains, after all channels of the
+    /// callback have been processed
+    void onCallbackEnd();
+
+    /// Creates the states of the channel in all EngineEffectChains. Invoked
+    /// from the engine thread for the channels that are processed
+    /// concurrently, before the concurrent processing starts.
+    void prepareInputChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
 
     /// Process the prefader EngineEffectChains on the pInOut buffer, modifying
     /// the contents of the input buffer.
@@ -48,6 +56,21 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Like processPostFaderInPlace(), but only the chains that are active for
+    /// the channel process it. The others only advance the state of the
+    /// channel. Used for channels that are processed concurrently, which
+    /// must not share an active chain, see isPostFaderChainActive().
+    void processActivePostFaderInPlace(
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pInOut,
+            std::size_t numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            const GroupFeatureState& groupFeatures,
+            CSAMPLE_GAIN oldGain,
+            CSAMPLE_GAIN newGain,
+            bool fadeout);
+
     /// Process the postfader EngineEffectChains, leaving the pIn buffer unmodified
     /// and mixing the output into the pOut buffer. Using EngineEffectsManager's
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
@@ -65,6 +88,32 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Returns true if no postfader EngineEffectChain needs to process the
+    /// channel. In this case the chains have been updated as if processed
+    /// and ChannelMixer can mix the channel directly, without invoking
+    /// processPostFaderAndMix(). Returns false without any side effects
+    /// otherwise.
+    bool skipPostFaderIfInactive(
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            bool fadeout);
+
+    /// The number of postfader EngineEffectChains, the valid indices for
+    /// isPostFaderChainActive().
+    int numPostFaderChains() const {
+        return m_chainsByStage.value(SignalProcessingStage::Postfader).size();
+    }
+
+    /// Returns true if the postfader EngineEffectChain with the given index
+    /// needs to process the channel. Channels that don't share an active
+    /// chain could be processed concurrently by processPostFaderInPlace().
+    /// Must be invoked from the engine thread for each chain before, because
+    /// it might allocate the state of the channel in the chain.
+    bool isPostFaderChainActive(int chainIndex,
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            bool fadeout);
+
     bool processEffectsRequest(
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
@@ -99,7 +148,4 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     EffectsResponsePipe m_responsePipe;
     QHash<SignalProcessingStage, QList<EngineEffectChain*>> m_chainsByStage;
     QList<EngineEffect*> m_effects;
-
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
 };
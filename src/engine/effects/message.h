@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QList>
 #include <QString>
 #include <QVariant>
 #include <QtGlobal>
@@ -13,6 +14,20 @@
 class EngineEffectChain;
 class EngineEffect;
 
+/// The complete list of EngineEffects of an EngineEffectChain, which is
+/// prepared in the main thread when loading a chain preset. The audio
+/// thread swaps the list with the effects of the chain, so the replaced list
+/// is returned with the request and freed in the main thread together with
+/// the removed effects.
+struct EngineEffectsReplacement {
+    /// Indexed by the number of the EffectSlot, nullptr for empty slots
+    QList<EngineEffect*> effects;
+    /// The effects of the list that are not yet part of the chain
+    QList<EngineEffect*> addedEffects;
+    /// The effects that are only part of the replaced list
+    QList<EngineEffect*> removedEffects;
+};
+
 struct EffectsRequest {
     enum MessageType {
         // Messages for EngineEffectChain
@@ -21,10 +36,16 @@ struct EffectsRequest {
         SET_EFFECT_CHAIN_PARAMETERS,
         ADD_EFFECT_TO_CHAIN,
         REMOVE_EFFECT_FROM_CHAIN,
+        // Replaces all effects of the chain at once, e.g. when loading a
+        // chain preset, so no buffer is processed with a partially loaded chain
+        REPLACE_EFFECTS_OF_CHAIN,
         // Effects cannot currently be toggled for output channels;
         // the outputs that effects are applied to are hardwired in EngineMixer
         ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
         DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
+        // Succeeds only if the chain is disabled for the input channel so
+        // the EffectStates of the effect can be deleted in the main thread
+        RELEASE_EFFECT_STATES_FOR_INPUT_CHANNEL,
 
         // Messages for EngineEffect
         SET_EFFECT_PARAMETERS,
@@ -52,9 +73,11 @@ struct EffectsRequest {
         // Used by:
         // - ADD_EFFECT_TO_CHAIN
         // - REMOVE_EFFECT_FROM_CHAIN
+        // - REPLACE_EFFECTS_OF_CHAIN
         // - SET_EFFECT_CHAIN_PARAMETERS
         // - ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
         // - DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
+        // - RELEASE_EFFECT_STATES_FOR_INPUT_CHANNEL
         EngineEffectChain* pTargetChain;
         // Used by:
         // - SET_EFFECT_PARAMETER
@@ -77,6 +100,11 @@ struct EffectsRequest {
         struct {
             ChannelHandle channelHandle;
         } DisableInputChannelForChain;
+        struct {
+            ChannelHandle channelHandle;
+            EngineEffect* pEffect;
+            quint64 generation;
+        } ReleaseEffectStatesForInputChannel;
         struct {
             EngineEffect* pEffect;
             int iIndex;
@@ -85,6 +113,9 @@ struct EffectsRequest {
             EngineEffect* pEffect;
             int iIndex;
         } RemoveEffectFromChain;
+        struct {
+            EngineEffectsReplacement* pReplacement;
+        } ReplaceEffectsOfChain;
         struct {
             bool enabled;
             EffectChainMixMode::Type mix_mode;
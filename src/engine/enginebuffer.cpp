@@ -1,6 +1,7 @@
 #include "engine/enginebuffer.h"
 
 #include <QtDebug>
+#include <limits>
 
 #include "control/controllinpotmeter.h"
 #include "control/controlpotmeter.h"
@@ -8,6 +9,8 @@
 #include "control/controlpushbutton.h"
 #include "engine/bufferscalers/enginebufferscalelinear.h"
 #include "engine/bufferscalers/enginebufferscalest.h"
+#include "engine/bufferscalers/enginebufferscalewsola.h"
+#include "engine/bufferscalers/keylockloopcache.h"
 #include "engine/cachingreader/cachingreader.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/controls/bpmcontrol.h"
@@ -28,9 +31,12 @@
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
 #include "util/defs.h"
+#include "util/inputtimestamp.h"
 #include "util/logger.h"
 #include "util/sample.h"
+#include "util/time.h"
 #include "util/timer.h"
+#include "util/tracing.h"
 #include "waveform/visualplayposition.h"
 
 #ifdef __RUBBERBAND__
@@ -47,6 +53,18 @@ const mixxx::Logger kLogger("EngineBuffer");
 constexpr double kLinearScalerElipsis =
         1.00058; // 2^(0.01/12): changes < 1 cent allows a linear scaler
 
+// The automatic keylock mode uses the WSOLA scaler up to a tempo change of
+// about 3% relative to the key, where its artifacts are small
+constexpr double kWsolaMaxStretchDeviationEnter = 0.03;
+constexpr double kWsolaMaxStretchDeviationLeave = 0.04;
+
+// 32 seconds of stereo audio at 48 kHz, about 12 MB per deck
+constexpr SINT kKeylockLoopCacheSamples = 32 * 48000 * 2;
+
+// Seeks of input events are not applied closer than this to the start or
+// the end of a buffer, where the fragment would be too short to be worth it
+constexpr SINT kMinTimedSeekFrames = 16;
+
 // Rate at which the playpos slider is updated
 constexpr int kPlaypositionUpdateRate = 15; // updates per second
 
@@ -87,6 +105,10 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_startButton(nullptr),
           m_endButton(nullptr),
           m_bScalerOverride(false),
+          m_bAutomaticKeylock(false),
+          m_bKeylockNearOriginal(false),
+          m_bTimedSeeks(false),
+          m_bQueuedSeekDeferred(false),
           m_iSeekPhaseQueued(0),
           m_iEnableSyncQueued(SYNC_REQUEST_NONE),
           m_iSyncModeQueued(static_cast<int>(SyncMode::Invalid)),
@@ -260,11 +282,20 @@ EngineBuffer::EngineBuffer(const QString& group,
             Qt::DirectConnection);
     // Construct scaling objects
     m_pScaleLinear = new EngineBufferScaleLinear(m_pReadAheadManager);
+    m_pScaleLinear->setHermiteInterpolation(m_pConfig->getValue(
+            ConfigKey(kAppGroup, QStringLiteral("vinyl_scaler_hermite")), false));
     m_pScaleST = new EngineBufferScaleST(m_pReadAheadManager);
 #ifdef __RUBBERBAND__
     m_pScaleRB = new EngineBufferScaleRubberBand(m_pReadAheadManager);
 #endif
+    m_pScaleWsola = new EngineBufferScaleWsola(m_pReadAheadManager);
+    if (m_pConfig->getValue(
+                ConfigKey(kAppGroup, QStringLiteral("keylock_loop_cache")), false)) {
+        m_pKeylockLoopCache = std::make_unique<KeylockLoopCache>(kKeylockLoopCacheSamples);
+    }
     slotKeylockEngineChanged(m_pKeylockEngine->get());
+    m_bTimedSeeks = m_pConfig->getValue(
+            ConfigKey(kAppGroup, QStringLiteral("timed_seeks")), false);
     m_pScaleVinyl = m_pScaleLinear;
     m_pScale = m_pScaleVinyl;
     m_pScale->clear();
@@ -317,6 +348,7 @@ EngineBuffer::~EngineBuffer() {
 #ifdef __RUBBERBAND__
     delete m_pScaleRB;
 #endif
+    delete m_pScaleWsola;
 
     delete m_pKeylock;
     delete m_pReplayGain;
@@ -341,6 +373,9 @@ void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
     // m_pScaleKeylock and m_pScaleVinyl could change out from under us,
     // so cache it.
     EngineBufferScale* keylock_scale = m_pScaleKeylock;
+    if (m_bAutomaticKeylock.load(std::memory_order_relaxed) && m_bKeylockNearOriginal) {
+        keylock_scale = m_pScaleWsola;
+    }
     EngineBufferScale* vinyl_scale = m_pScaleVinyl;
 
     if (bEnable && m_pScale != keylock_scale) {
@@ -398,7 +433,7 @@ void EngineBuffer::queueNewPlaypos(mixxx::audio::FramePos position, enum SeekReq
         // use SEEK_STANDARD for that
         seekType = SEEK_STANDARD;
     }
-    m_queuedSeek.setValue({position, seekType});
+    m_queuedSeek.setValue({position, seekType, mixxx::ScopedInputTimestamp::current()});
 }
 
 void EngineBuffer::requestSyncPhase() {
@@ -449,9 +484,17 @@ void EngineBuffer::requestSyncMode(SyncMode mode) {
 
 void EngineBuffer::readToCrossfadeBuffer(const std::size_t bufferSize) {
     if (!m_bCrossfadeReady) {
-        // Read buffer, as if there where no parameter change
-        // (Must be called only once per callback)
-        m_pScale->scaleBuffer(m_pCrossfadeBuffer, bufferSize);
+        if (m_pKeylockLoopCache && m_pKeylockLoopCache->isReplaying()) {
+            // The scaler has been bypassed while the loop was replayed and
+            // resumes at the current position
+            m_pKeylockLoopCache->replay(m_pCrossfadeBuffer, bufferSize);
+            m_pKeylockLoopCache->invalidate();
+            m_pScale->clear();
+        } else {
+            // Read buffer, as if there where no parameter change
+            // (Must be called only once per callback)
+            m_pScale->scaleBuffer(m_pCrossfadeBuffer, bufferSize);
+        }
         // Restore the original position that was lost due to scaleBuffer() above
         m_pReadAheadManager->notifySeek(m_playPos.toSamplePos(m_channelCount));
         m_bCrossfadeReady = true;
@@ -475,6 +518,9 @@ void EngineBuffer::setNewPlaypos(mixxx::audio::FramePos position) {
         m_pReadAheadManager->notifySeek(m_playPos.toSamplePos(m_channelCount));
     }
     m_pScale->clear();
+    if (m_pKeylockLoopCache) {
+        m_pKeylockLoopCache->invalidate();
+    }
 
     // Ensures that the playpos slider gets updated in next process call
     m_samplesSinceLastIndicatorUpdate = 1000000;
@@ -570,7 +616,7 @@ void EngineBuffer::slotTrackLoaded(TrackPointer pTrack,
     m_dSlipRate = 0;
     m_slipModeState = SlipModeState::Disabled;
 
-    m_pReplayGain->set(pTrack->getReplayGain().getRatio());
+    m_pReplayGain->set(pTrack->getEngineSnapshot()->replayGain.getRatio());
 
     m_queuedSeek.setValue(kNoQueuedSeek);
 
@@ -842,6 +888,7 @@ void EngineBuffer::slotKeylockEngineChanged(double dIndex) {
         return;
     }
     const KeylockEngine engine = static_cast<KeylockEngine>(dIndex);
+    m_bAutomaticKeylock.store(false, std::memory_order_relaxed);
     switch (engine) {
     case KeylockEngine::SoundTouch:
         m_pScaleKeylock = m_pScaleST;
@@ -857,6 +904,17 @@ void EngineBuffer::slotKeylockEngineChanged(double dIndex) {
         m_pScaleKeylock = m_pScaleRB;
         break;
 #endif
+    case KeylockEngine::Automatic:
+        // The cheap WSOLA scaler is chosen per deck in processTrackLocked(),
+        // this is the scaler for the larger tempo changes
+#ifdef __RUBBERBAND__
+        m_pScaleRB->useEngineFiner(false);
+        m_pScaleKeylock = m_pScaleRB;
+#else
+        m_pScaleKeylock = m_pScaleST;
+#endif
+        m_bAutomaticKeylock.store(true, std::memory_order_relaxed);
+        break;
     default:
         slotKeylockEngineChanged(static_cast<double>(defaultKeylockEngine()));
         break;
@@ -967,6 +1025,20 @@ void EngineBuffer::processTrackLocked(
         }
     }
 
+    if (useIndependentPitchAndTempoScaling) {
+        // The stretch of the automatic keylock mode. The threshold for
+        // leaving the WSOLA scaler is larger to avoid switching back and
+        // forth, every switch is crossfaded.
+        const double stretchDeviation = pitchRatio != 0.0
+                ? fabs(fabs(speed) / pitchRatio - 1.0)
+                : std::numeric_limits<double>::infinity();
+        if (m_bKeylockNearOriginal) {
+            m_bKeylockNearOriginal = stretchDeviation < kWsolaMaxStretchDeviationLeave;
+        } else {
+            m_bKeylockNearOriginal = stretchDeviation < kWsolaMaxStretchDeviationEnter;
+        }
+    }
+
     if (speed != 0.0) {
         // Do not switch scaler when we have no transport
         enableIndependentPitchTempoScaling(useIndependentPitchAndTempoScaling,
@@ -978,6 +1050,23 @@ void EngineBuffer::processTrackLocked(
         m_pScale->clear();
     }
 
+#ifdef __STEM__
+    // Stretching a premix of the stems is only possible while EngineDeck
+    // mixes them with the same gain. Switching crossfades like a seek.
+    const mixxx::StemChannelSelection stemPremixMask =
+            m_channelCount > mixxx::audio::ChannelCount::stereo() &&
+                    m_pScale->supportsStemPremix()
+            ? m_stemPremixMask
+            : mixxx::StemChannelSelection();
+    if (stemPremixMask != m_pScale->getStemPremixMask()) {
+        if (m_speed_old != 0.0) {
+            readToCrossfadeBuffer(bufferSize);
+        }
+        m_pScale->setStemPremixMask(stemPremixMask);
+        m_pScale->clear();
+    }
+#endif
+
     // How speed/tempo/pitch are related:
     // Processing is done in two parts, the first part is calculated inside
     // the KeyKontrol class and effects the visual key/pitch widgets.
@@ -1092,8 +1181,47 @@ void EngineBuffer::processTrackLocked(
 
     m_rate_old = rate;
 
+    // The stretched output of a loop can be cached if it only depends on
+    // the key
+    KeylockLoopCache::Key loopCacheKey;
+    if (m_pKeylockLoopCache) {
+        if (!bCurBufferPaused && !is_scratching && rate > 0 &&
+                m_pScale != m_pScaleVinyl && m_pLoopingControl->isLoopingEnabled()) {
+            const LoopingControl::LoopInfo loopInfo = m_pLoopingControl->getLoopInfo();
+            loopCacheKey.pScale = m_pScale;
+            loopCacheKey.baseRate = m_baserate_old;
+            loopCacheKey.tempoRatio = m_speed_old;
+            loopCacheKey.pitchRatio = m_pitch_old;
+            loopCacheKey.loopStartPosition = loopInfo.startPosition;
+            loopCacheKey.loopEndPosition = loopInfo.endPosition;
+            loopCacheKey.channelCount = m_channelCount;
+#ifdef __STEM__
+            loopCacheKey.stemPremixMask = m_pScale->getStemPremixMask();
+#endif
+        }
+        if (!m_pKeylockLoopCache->matches(loopCacheKey)) {
+            if (m_pKeylockLoopCache->isReplaying()) {
+                // Crossfade from the cache to the scaler
+                readToCrossfadeBuffer(bufferSize);
+            }
+            m_pKeylockLoopCache->invalidate();
+        }
+    }
+
     // If the buffer is not paused, then scale the audio.
-    if (!bCurBufferPaused) {
+    if (!bCurBufferPaused && m_pKeylockLoopCache &&
+            (m_pKeylockLoopCache->isReplayPending() ||
+                    m_pKeylockLoopCache->isReplaying())) {
+        if (m_pKeylockLoopCache->isReplayPending()) {
+            // Crossfade from the scaler to the cache
+            readToCrossfadeBuffer(bufferSize);
+        }
+        m_playPos = m_pKeylockLoopCache->replay(pOutput, bufferSize);
+        if (m_bCrossfadeReady) {
+            SampleUtil::linearCrossfadeBuffersIn(
+                    pOutput, m_pCrossfadeBuffer, bufferSize, m_channelCount);
+        }
+    } else if (!bCurBufferPaused) {
         // Perform scaling of Reader buffer into buffer.
         const double framesRead = m_pScale->scaleBuffer(pOutput, bufferSize);
 
@@ -1111,6 +1239,18 @@ void EngineBuffer::processTrackLocked(
             m_playPos = m_pReadAheadManager->getFilePlaypositionFromLog(
                     m_playPos, framesRead, m_channelCount);
         }
+        if (m_pKeylockLoopCache) {
+            if (m_bCrossfadeReady) {
+                // The parameters or the position have just changed
+                m_pKeylockLoopCache->invalidate();
+            } else if (loopCacheKey.pScale) {
+                m_pKeylockLoopCache->record(loopCacheKey,
+                        pOutput,
+                        bufferSize,
+                        playpos_old,
+                        m_playPos);
+            }
+        }
         // Note: The last buffer of a track is padded with silence.
         // This silence is played together with the last samples in the last
         // callback and the m_playPos is advanced behind the end of the track.
@@ -1179,6 +1319,7 @@ void EngineBuffer::processTrackLocked(
 }
 
 void EngineBuffer::process(CSAMPLE* pOutput, const std::size_t bufferSize) {
+    MIXXX_TRACE_SCOPE("EngineBuffer::process");
     // Bail if we receive a buffer size with incomplete sample frames. Assert in debug builds.
     VERIFY_OR_DEBUG_ASSERT((bufferSize % m_channelCount) == 0) {
         return;
@@ -1204,10 +1345,32 @@ void EngineBuffer::process(CSAMPLE* pOutput, const std::size_t bufferSize) {
 #ifdef __RUBBERBAND__
     m_pScaleRB->setSignal(m_sampleRate, m_channelCount);
 #endif
+    m_pScaleWsola->setSignal(m_sampleRate, m_channelCount);
+
+    const mixxx::Duration callbackTime = mixxx::Time::elapsed();
+
+    // EngineSync publishes the state of the leader instead of notifying
+    // each deck, pick it up before the rate is calculated.
+    m_pSyncControl->readLeaderSnapshot();
 
     bool hasStableTrack = m_pTrackLoaded->toBool() && m_iTrackLoading.loadAcquire() == 0;
     if (hasStableTrack && m_pause.tryLock()) {
-        processTrackLocked(pOutput, bufferSize, m_sampleRate);
+        const std::size_t seekOffset = queuedSeekOffset(bufferSize, callbackTime);
+        if (seekOffset > 0) {
+            // Play up to the frame of the input event that requested the
+            // seek, the remaining fragment starts with the seek
+            m_bQueuedSeekDeferred = true;
+            processTrackLocked(pOutput, seekOffset, m_sampleRate);
+            m_bQueuedSeekDeferred = false;
+            if (seekOffset < bufferSize) {
+                m_bCrossfadeReady = false;
+                processTrackLocked(pOutput + seekOffset,
+                        bufferSize - seekOffset,
+                        m_sampleRate);
+            }
+        } else {
+            processTrackLocked(pOutput, bufferSize, m_sampleRate);
+        }
         // release the pauselock
         m_pause.unlock();
     } else {
@@ -1244,9 +1407,42 @@ void EngineBuffer::process(CSAMPLE* pOutput, const std::size_t bufferSize) {
     m_pSyncControl->updateAudible();
 
     m_lastBufferSize = bufferSize;
+    m_lastCallbackTime = callbackTime;
     m_bCrossfadeReady = false;
 }
 
+std::size_t EngineBuffer::queuedSeekOffset(
+        std::size_t bufferSize, mixxx::Duration callbackTime) const {
+    if (!m_bTimedSeeks || !m_sampleRate.isValid() ||
+            m_lastCallbackTime == mixxx::Duration::empty()) {
+        return 0;
+    }
+    const QueuedSeek queuedSeek = m_queuedSeek.getValue();
+    if (queuedSeek.seekType == SEEK_NONE ||
+            queuedSeek.timestamp == mixxx::Duration::empty()) {
+        return 0;
+    }
+    // The events between the previous and this callback are played with a
+    // constant latency of one buffer, at their offset from the previous
+    // callback. Later events are left for the next callback.
+    if (queuedSeek.timestamp >= callbackTime) {
+        return bufferSize;
+    }
+    const std::size_t bufferFrames = bufferSize / m_channelCount;
+    const double offsetFrames = (queuedSeek.timestamp - m_lastCallbackTime).toDoubleSeconds() *
+            m_sampleRate.toDouble();
+    if (offsetFrames < kMinTimedSeekFrames) {
+        return 0;
+    }
+    const std::size_t seekFrames = std::min(static_cast<std::size_t>(offsetFrames), bufferFrames);
+    if (bufferFrames - seekFrames < kMinTimedSeekFrames) {
+        // The fragment with the seek would be too short, seek at the start
+        // of the next buffer instead
+        return bufferSize;
+    }
+    return seekFrames * m_channelCount;
+}
+
 void EngineBuffer::processSlip(std::size_t bufferSize) {
     // Do a single read from m_bSlipEnabled so we don't run in to race conditions.
     bool enabled = m_pSlipButton->toBool();
@@ -1323,6 +1519,11 @@ void EngineBuffer::processSyncRequests() {
 void EngineBuffer::processSeek(bool paused) {
     m_previousBufferSeek = false;
 
+    if (m_bQueuedSeekDeferred) {
+        // The seek is processed in the next fragment
+        return;
+    }
+
     const QueuedSeek queuedSeek = m_queuedSeek.getValue();
 
     SeekRequests seekType = queuedSeek.seekType;
@@ -1585,6 +1786,11 @@ bool EngineBuffer::isTrackLoaded() const {
     return false;
 }
 
+bool EngineBuffer::processPendingReads() {
+    m_pReader->process();
+    return m_pReader->hasPendingReadRequests();
+}
+
 TrackPointer EngineBuffer::getLoadedTrack() const {
     return m_pCurrentTrack;
 }
@@ -1631,7 +1837,7 @@ void EngineBuffer::slotUpdatedTrackBeats() {
     TrackPointer pTrack = m_pCurrentTrack;
     if (pTrack) {
         for (const auto& pControl : std::as_const(m_engineControls)) {
-            pControl->trackBeatsUpdated(pTrack->getBeats());
+            pControl->trackBeatsUpdated(pTrack->getEngineSnapshot()->pBeats);
         }
     }
 }
@@ -1641,6 +1847,7 @@ void EngineBuffer::setScalerForTest(
         EngineBufferScale* pScaleKeylock) {
     m_pScaleVinyl = pScaleVinyl;
     m_pScaleKeylock = pScaleKeylock;
+    m_bAutomaticKeylock.store(false, std::memory_order_relaxed);
     m_pScale = m_pScaleVinyl;
     m_pScale->clear();
     m_bScalerChanged = true;
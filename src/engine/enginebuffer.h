@@ -4,7 +4,9 @@
 
 #include <QAtomicInt>
 #include <QMutex>
+#include <atomic>
 #include <initializer_list>
+#include <memory>
 
 #include "audio/frame.h"
 #include "audio/types.h"
@@ -16,6 +18,7 @@
 #include "preferences/usersettings.h"
 #include "track/bpm.h"
 #include "track/track_decl.h"
+#include "util/duration.h"
 #include "util/types.h"
 
 #ifdef __RUBBERBAND__
@@ -46,6 +49,8 @@ class ControlPotmeter;
 class EngineBufferScale;
 class EngineBufferScaleLinear;
 class EngineBufferScaleST;
+class EngineBufferScaleWsola;
+class KeylockLoopCache;
 class EngineSync;
 class EngineWorkerScheduler;
 class VisualPlayPosition;
@@ -88,6 +93,8 @@ class EngineBuffer : public EngineObject {
         RubberBandFaster = 1,
         RubberBandFiner = 2,
 #endif
+        // WSOLA close to the original tempo, otherwise the default engine
+        Automatic = 3,
     };
 
     // intended for iteration over the KeylockEngine enum
@@ -95,8 +102,9 @@ class EngineBuffer : public EngineObject {
             KeylockEngine::SoundTouch,
 #ifdef __RUBBERBAND__
             KeylockEngine::RubberBandFaster,
-            KeylockEngine::RubberBandFiner
+            KeylockEngine::RubberBandFiner,
 #endif
+            KeylockEngine::Automatic,
     };
 
     EngineBuffer(const QString& group,
@@ -114,6 +122,15 @@ class EngineBuffer : public EngineObject {
     mixxx::audio::ChannelCount getChannelCount() const {
         return m_channelCount;
     }
+#ifdef __STEM__
+    /// Selects the stems that the keylock scaler may stretch as one stereo
+    /// mix, because they are mixed with the same gain. The mix is returned
+    /// in the channels of the first stem of the mask. Must be called from
+    /// the engine thread before process().
+    void setStemPremixMask(mixxx::StemChannelSelection mask) {
+        m_stemPremixMask = mask;
+    }
+#endif
     bool getScratching() const;
     bool isReverse() const;
     /// Returns current bpm value (not thread-safe)
@@ -146,6 +163,11 @@ class EngineBuffer : public EngineObject {
     mixxx::audio::FramePos queuedSeekPosition() const;
 
     bool isTrackLoaded() const;
+    /// Receives the chunks that have been read in the meantime and returns
+    /// true if the reader is still busy with requests. For offline rendering,
+    /// which can wait for the reader between the callbacks of the engine
+    /// thread instead of missing the chunks.
+    bool processPendingReads();
     TrackPointer getLoadedTrack() const;
     void ejectTrack();
 
@@ -171,6 +193,12 @@ class EngineBuffer : public EngineObject {
         switch (engine) {
         case KeylockEngine::SoundTouch:
             return tr("Soundtouch (faster)");
+        case KeylockEngine::Automatic:
+#ifdef __RUBBERBAND__
+            return tr("Automatic (WSOLA near original tempo, otherwise Rubberband)");
+#else
+            return tr("Automatic (WSOLA near original tempo, otherwise Soundtouch)");
+#endif
 #ifdef __RUBBERBAND__
         case KeylockEngine::RubberBandFaster:
             return tr("Rubberband (better)");
@@ -192,6 +220,7 @@ class EngineBuffer : public EngineObject {
     static bool isKeylockEngineAvailable(KeylockEngine engine) {
         switch (engine) {
         case KeylockEngine::SoundTouch:
+        case KeylockEngine::Automatic:
             return true;
 #ifdef __RUBBERBAND__
         case KeylockEngine::RubberBandFaster:
@@ -264,6 +293,8 @@ class EngineBuffer : public EngineObject {
     struct QueuedSeek {
         mixxx::audio::FramePos position;
         enum SeekRequest seekType;
+        // The time of the input event that requested the seek, if any
+        mixxx::Duration timestamp;
     };
 
     // Add an engine control to the EngineBuffer
@@ -275,6 +306,11 @@ class EngineBuffer : public EngineObject {
 
     void updateIndicators(double rate, std::size_t bufferSize);
 
+    /// The offset in samples at which the queued seek is due in the buffer
+    /// of this callback, according to the time of its input event. 0 if it
+    /// is due at the start, bufferSize if it is due in the next callback.
+    std::size_t queuedSeekOffset(std::size_t bufferSize, mixxx::Duration callbackTime) const;
+
     void hintReader(const double rate);
 
     double fractionalPlayposFromAbsolute(mixxx::audio::FramePos position);
@@ -440,6 +476,7 @@ class EngineBuffer : public EngineObject {
     FRIEND_TEST(EngineBufferTest, ReadFadeOut);
     FRIEND_TEST(EngineBufferTest, RateTempTest);
     FRIEND_TEST(EngineBufferTest, RatePermTest);
+    FRIEND_TEST(EngineBufferTest, TimedSeekOffset);
     EngineBufferScale* m_pScaleVinyl;
     // The keylock engine is configurable, so it could flip flop between
     // ScaleST and ScaleRB during a single callback.
@@ -452,6 +489,21 @@ class EngineBuffer : public EngineObject {
 #ifdef __RUBBERBAND__
     EngineBufferScaleRubberBand* m_pScaleRB;
 #endif
+    // A cheap scaler for small tempo changes, used in the automatic keylock
+    // mode
+    EngineBufferScaleWsola* m_pScaleWsola;
+    // Set by the automatic keylock mode, which uses m_pScaleWsola close to
+    // the original tempo and m_pScaleKeylock otherwise
+    std::atomic<bool> m_bAutomaticKeylock;
+    // Whether the current stretch is close enough to 1 for m_pScaleWsola,
+    // only used by the engine thread
+    bool m_bKeylockNearOriginal;
+    // Replays the stretched output of loops, if enabled in the preferences
+    std::unique_ptr<KeylockLoopCache> m_pKeylockLoopCache;
+#ifdef __STEM__
+    // Requested by EngineDeck, only used by the engine thread
+    mixxx::StemChannelSelection m_stemPremixMask;
+#endif
 
     // Indicates whether the scaler has changed since the last process()
     bool m_bScalerChanged;
@@ -462,12 +514,20 @@ class EngineBuffer : public EngineObject {
     QAtomicInt m_iEnableSyncQueued;
     QAtomicInt m_iSyncModeQueued;
     ControlValueAtomic<QueuedSeek> m_queuedSeek;
+    // Apply seeks at the frames of their input events, if enabled in the
+    // preferences
+    bool m_bTimedSeeks;
+    // Set while the part of the buffer before a timed seek is processed
+    bool m_bQueuedSeekDeferred;
+    mixxx::Duration m_lastCallbackTime;
     bool m_previousBufferSeek = false;
 
     /// Indicates that no seek is queued
-    static constexpr QueuedSeek kNoQueuedSeek = {mixxx::audio::kInvalidFramePos, SEEK_NONE};
+    static constexpr QueuedSeek kNoQueuedSeek = {
+            mixxx::audio::kInvalidFramePos, SEEK_NONE, mixxx::Duration::empty()};
     /// indicates a clone seek on a bosition from another deck
-    static constexpr QueuedSeek kCloneSeek = {mixxx::audio::kInvalidFramePos, SEEK_CLONE};
+    static constexpr QueuedSeek kCloneSeek = {
+            mixxx::audio::kInvalidFramePos, SEEK_CLONE, mixxx::Duration::empty()};
     QAtomicPointer<EngineChannel> m_pChannelToCloneFrom;
 
     // Is true if the previous buffer was silent due to pausing
@@ -0,0 +1,177 @@
+#include "engine/enginechannelworkerpool.h"
+
+#include <QThread>
+#include <QtDebug>
+#include <chrono>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#include "engine/enginescratcharena.h"
+#include "util/assert.h"
+#include "util/realtime.h"
+#include "util/realtimecheck.h"
+#include "util/tracing.h"
+
+namespace {
+
+// Longer than the gap between the channel and the postfader stage of a
+// callback, much shorter than the gap between two callbacks. Bounded by
+// the elapsed time, because the duration of a pause instruction varies by
+// more than a magnitude between CPUs, e.g. about 140 cycles since Skylake.
+constexpr auto kIdleSpinDuration = std::chrono::microseconds(50);
+// The clock is only read after this many pauses
+constexpr int kPausesPerClockRead = 16;
+
+constexpr std::uint64_t kMaxJobItems = 0xFFFF;
+
+inline void pause() {
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+inline std::uint64_t packJob(std::uint32_t generation, int count) {
+    return (static_cast<std::uint64_t>(generation) << 32) |
+            (static_cast<std::uint64_t>(count) << 16);
+}
+
+inline std::uint32_t jobGeneration(std::uint64_t job) {
+    return static_cast<std::uint32_t>(job >> 32);
+}
+
+inline int jobCount(std::uint64_t job) {
+    return static_cast<int>((job >> 16) & kMaxJobItems);
+}
+
+inline int jobNextIndex(std::uint64_t job) {
+    return static_cast<int>(job & kMaxJobItems);
+}
+
+} // namespace
+
+class EngineChannelWorkerPool::Worker : public QThread {
+  public:
+    explicit Worker(EngineChannelWorkerPool* pPool)
+            : m_pPool(pPool) {
+        setObjectName(QStringLiteral("EngineChannelWorker"));
+    }
+
+  protected:
+    void run() override {
+        mixxx::realtime::applyToCurrentThread(
+                mixxx::realtime::ThreadRole::EngineWorker);
+        mixxx::tracing::registerCurrentThread(objectName());
+        EngineScratchArena::setCurrent(&m_scratchArena);
+        m_pPool->runWorker();
+        EngineScratchArena::setCurrent(nullptr);
+    }
+
+  private:
+    EngineChannelWorkerPool* const m_pPool;
+    EngineScratchArena m_scratchArena;
+};
+
+EngineChannelWorkerPool::EngineChannelWorkerPool(int numWorkers)
+        : m_pContext(nullptr),
+          m_invoke(nullptr),
+          m_job(packJob(0, 0)),
+          m_generation(0),
+          m_numCompleted(0),
+          m_stop(false) {
+    DEBUG_ASSERT(numWorkers > 0);
+    qDebug() << "EngineChannelWorkerPool will use" << numWorkers
+             << "worker thread(s) to process engine channels";
+
+    m_workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>(this));
+        m_workers.back()->start(QThread::TimeCriticalPriority);
+    }
+}
+
+EngineChannelWorkerPool::~EngineChannelWorkerPool() {
+    m_stop.store(true, std::memory_order_release);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+    m_generation.notify_all();
+    for (const auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+}
+
+void EngineChannelWorkerPool::processItemsInternal(
+        int count, void* pContext, InvokeFunction invoke) {
+    if (count <= 0) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(static_cast<std::uint64_t>(count) <= kMaxJobItems) {
+        count = static_cast<int>(kMaxJobItems);
+    }
+    // No item of the previous job is being processed anymore, so nobody
+    // reads the job while it is replaced
+    m_pContext = pContext;
+    m_invoke = invoke;
+    m_numCompleted.store(0, std::memory_order_relaxed);
+    const std::uint32_t generation =
+            m_generation.load(std::memory_order_relaxed) + 1;
+    m_job.store(packJob(generation, count), std::memory_order_release);
+    m_generation.store(generation, std::memory_order_release);
+    // Only a system call if a worker has parked, which doesn't block
+    m_generation.notify_all();
+
+    drainItems(generation);
+
+    // Barrier: spin until the items claimed by the workers are done
+    while (m_numCompleted.load(std::memory_order_acquire) < count) {
+        pause();
+    }
+}
+
+void EngineChannelWorkerPool::drainItems(std::uint32_t generation) {
+    std::uint64_t job = m_job.load(std::memory_order_acquire);
+    while (jobGeneration(job) == generation && jobNextIndex(job) < jobCount(job)) {
+        // Fails if another thread has claimed the item or the job has been
+        // replaced, which reloads the job
+        if (!m_job.compare_exchange_weak(job,
+                    job + 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+            continue;
+        }
+        // The job can't be replaced before the claimed item is completed
+        m_invoke(m_pContext, jobNextIndex(job));
+        m_numCompleted.fetch_add(1, std::memory_order_release);
+        job = m_job.load(std::memory_order_acquire);
+    }
+}
+
+void EngineChannelWorkerPool::runWorker() {
+    std::uint32_t seenGeneration = m_generation.load(std::memory_order_acquire);
+    while (true) {
+        std::uint32_t generation = m_generation.load(std::memory_order_acquire);
+        const auto spinEnd = std::chrono::steady_clock::now() + kIdleSpinDuration;
+        for (int i = 1; generation == seenGeneration; ++i) {
+            pause();
+            generation = m_generation.load(std::memory_order_acquire);
+            if (i % kPausesPerClockRead == 0 &&
+                    std::chrono::steady_clock::now() >= spinEnd) {
+                break;
+            }
+        }
+        if (generation == seenGeneration) {
+            // Park until the next job is published
+            m_generation.wait(seenGeneration, std::memory_order_acquire);
+            continue;
+        }
+        seenGeneration = generation;
+        if (m_stop.load(std::memory_order_acquire)) {
+            return;
+        }
+        const mixxx::realtime::Check::ScopedSection realtimeSection;
+        drainItems(generation);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// EngineChannelWorkerPool is a fixed pool of pre-spawned, high priority
+/// threads that allows the engine thread to process independent engine
+/// channels concurrently.
+///
+/// The engine thread always participates in the processing itself and
+/// processItems() only returns after every item has been processed, so a call
+/// acts as a barrier between the fan-out and the following mixing stage.
+/// Items are handed out through an atomic counter, a slow item does not
+/// block the distribution of the remaining ones.
+///
+/// The engine thread neither locks nor blocks: it publishes a job with an
+/// atomic store and spins until all items are done. Idle workers spin for a
+/// short while before they park on an atomic wait, so back to back callbacks
+/// find them awake.
+class EngineChannelWorkerPool {
+  public:
+    /// Spawn numWorkers threads in addition to the calling (engine) thread.
+    explicit EngineChannelWorkerPool(int numWorkers);
+    ~EngineChannelWorkerPool();
+
+    EngineChannelWorkerPool(const EngineChannelWorkerPool&) = delete;
+    EngineChannelWorkerPool& operator=(const EngineChannelWorkerPool&) = delete;
+
+    int numWorkers() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    /// Invoke processItem(index) for each index in [0, count) and wait until
+    /// all invocations have returned. processItem must be safe to be called
+    /// concurrently for different indices. Must only be called from a single
+    /// thread at a time.
+    template<typename ProcessItem>
+    void processItems(int count, ProcessItem& processItem) {
+        processItemsInternal(count,
+                &processItem,
+                [](void* pContext, int index) {
+                    (*static_cast<ProcessItem*>(pContext))(index);
+                });
+    }
+
+  private:
+    using InvokeFunction = void (*)(void* pContext, int index);
+
+    class Worker;
+
+    void processItemsInternal(int count, void* pContext, InvokeFunction invoke);
+    // Process the items of the job of the generation until none are left.
+    // Called by the workers and the calling thread. Returns right away if the
+    // job has already been replaced by a newer one.
+    void drainItems(std::uint32_t generation);
+    // Called by the workers
+    void runWorker();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // The current job, only modified while no item is being processed. It is
+    // published by the release store to m_job.
+    void* m_pContext;
+    InvokeFunction m_invoke;
+
+    // The generation, the number of items and the next item of the current
+    // job, packed into a single word so a worker that is late for a job can
+    // never claim an item of the next one.
+    std::atomic<std::uint64_t> m_job;
+    // The generation of the latest job, which the idle workers wait for
+    std::atomic<std::uint32_t> m_generation;
+    std::atomic<int> m_numCompleted;
+    std::atomic<bool> m_stop;
+};
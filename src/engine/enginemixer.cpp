@@ -1,5 +1,6 @@
 #include "engine/enginemixer.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "audio/types.h"
@@ -12,7 +13,9 @@
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
+#include "engine/enginechannelworkerpool.h"
 #include "engine/enginedelay.h"
+#include "engine/engineprofiler.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
@@ -25,8 +28,10 @@
 #include "preferences/usersettings.h"
 #include "util/defs.h"
 #include "util/parented_ptr.h"
+#include "util/realtimecheck.h"
 #include "util/sample.h"
 #include "util/samplebuffer.h"
+#include "util/timer.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
@@ -34,6 +39,17 @@ const QString kLegacyGroup = QStringLiteral("[Master]");
 const QString kMainGroup = QStringLiteral("[Main]");
 
 const ConfigKey kInternalClockBpmKey{QStringLiteral("[InternalClock]"), QStringLiteral("bpm")};
+
+// Opt-in: process the channels (except the sync leader) concurrently
+const ConfigKey kEngineMultiThreadingKey{kAppGroup, QStringLiteral("engine_multithreading")};
+// Number of worker threads, 0 = number of cores minus one
+const ConfigKey kEngineWorkerThreadsKey{kAppGroup, QStringLiteral("engine_worker_threads")};
+
+// The output buses of m_busRouting, the sources are the crossfader
+// orientation buses
+constexpr int kRoutedMainBus = 0;
+constexpr int kRoutedBoothBus = 1;
+constexpr int kNumRoutedBuses = 2;
 } // namespace
 
 EngineMixer::EngineMixer(UserSettingsPointer pConfig,
@@ -55,6 +71,7 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
           m_outputBusBuffers({mixxx::SampleBuffer(kMaxEngineSamples),
                   mixxx::SampleBuffer(kMaxEngineSamples),
                   mixxx::SampleBuffer(kMaxEngineSamples)}),
+          m_busRouting(static_cast<int>(m_outputBusBuffers.size()), kNumRoutedBuses),
           m_booth(kMaxEngineSamples),
           m_head(kMaxEngineSamples),
           m_talkover(kMaxEngineSamples),
@@ -148,6 +165,10 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
                   ConfigKey(group, "mono_mixdown"), true, false, true)),
           m_pMicMonitorMode(std::make_unique<ControlObject>(
                   ConfigKey(group, "talkover_mix"), true, false, true)) {
+    m_busRouting.setBusGain(kRoutedMainBus, CSAMPLE_GAIN_ONE);
+    m_busRouting.setBusGain(kRoutedBoothBus, m_boothGainOld);
+    m_busRouting.skipGainRamps();
+
     pEffectsManager->registerInputChannel(m_mainHandle);
     pEffectsManager->registerInputChannel(m_headphoneHandle);
     pEffectsManager->registerOutputChannel(m_mainHandle);
@@ -164,6 +185,20 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
     m_bExternalRecordBroadcastInputConnected = false;
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    if (pConfig->getValue(kEngineMultiThreadingKey, false)) {
+        int numWorkers = pConfig->getValue(kEngineWorkerThreadsKey, 0);
+        if (numWorkers <= 0) {
+            // The engine thread processes channels as well
+            numWorkers = QThread::idealThreadCount() - 1;
+        }
+        if (numWorkers > 0) {
+            m_pChannelWorkerPool = std::make_unique<EngineChannelWorkerPool>(numWorkers);
+        } else {
+            qWarning() << "Parallel engine channel processing requires more "
+                          "than one CPU core, disabled";
+        }
+    }
+
     m_pSampleRate->addAlias(ConfigKey(group, QStringLiteral("samplerate")));
     m_pSampleRate->set(44100.);
 
@@ -232,7 +267,10 @@ std::span<const CSAMPLE> EngineMixer::getSidechainBuffer() const {
 
 void EngineMixer::processChannels(std::size_t bufferSize) {
     // Update internal sync lock rate.
-    m_pEngineSync->onCallbackStart(m_sampleRate, bufferSize);
+    {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::SyncStart);
+        m_pEngineSync->onCallbackStart(m_sampleRate, bufferSize);
+    }
 
     m_activeBusChannels[EngineChannel::LEFT].clear();
     m_activeBusChannels[EngineChannel::CENTER].clear();
@@ -319,28 +357,47 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        auto& pChannel = pChannelInfo->m_pChannel;
-        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
-        pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Channels);
+        if (m_pChannelWorkerPool &&
+                m_activeChannels.size() - activeChannelsStartIndex > 1) {
+            // The sync leader is still processed first, the remaining
+            // channels only depend on its state and are processed concurrently.
+            int parallelStartIndex = activeChannelsStartIndex;
+            if (activeChannelsStartIndex == 0) {
+                processChannel(m_activeChannels[0], bufferSize);
+                parallelStartIndex = 1;
+            }
+            // The chains are shared by all channels, so their states for
+            // the channels must not be created concurrently
+            for (int i = parallelStartIndex; i < m_activeChannels.size(); ++i) {
+                m_activeChannels[i]->m_pChannel->prepareEffectStates();
+            }
+            auto processItem = [this, parallelStartIndex, bufferSize](int index) {
+                processChannel(m_activeChannels[parallelStartIndex + index], bufferSize);
+            };
+            m_pChannelWorkerPool->processItems(
+                    m_activeChannels.size() - parallelStartIndex, processItem);
+        } else {
+            for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+                processChannel(m_activeChannels[i], bufferSize);
+            }
         }
     }
+
     // Do internal sync lock post-processing before the other
     // channels.
     // Note, because we call this on the internal clock first,
     // it will have an up-to-date beatDistance, whereas the other
     // Syncables will not.
-    m_pEngineSync->onCallbackEnd(m_sampleRate, bufferSize);
+    {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::SyncEnd);
+        m_pEngineSync->onCallbackEnd(m_sampleRate, bufferSize);
+    }
 
     // After all engines have been processed, trigger updates of local bpm values
     // which may have changed based on track position
+    EngineProfiler::ScopedStage postProcessStage(EngineProfiler::Stage::PostProcess);
     std::for_each(m_activeChannels.cbegin() + activeChannelsStartIndex,
             m_activeChannels.cend(),
             [](const auto& pChannelInfo) {
@@ -358,6 +415,148 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
             });
 }
 
+void EngineMixer::processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize) {
+    auto& pChannel = pChannelInfo->m_pChannel;
+    DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
+    EngineProfiler::ScopedChannelStage stage(pChannelInfo->m_index,
+            EngineProfiler::ChannelStage::Process);
+    pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
+void EngineMixer::applyEffectsInPlaceAndMixBusChannels(std::size_t bufferSize) {
+    ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsInPlaceAndMixBusChannels"));
+    const ChannelHandle& outputHandle = m_mainHandle.handle();
+
+    // Calculate the gains like ChannelMixer::applyEffectsInPlaceAndMixChannels()
+    m_busChannels.clear();
+    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+        for (ChannelInfo* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+            // no [o] because the old gain follows an orientation switch
+            GainCache& gainCache = m_channelMainGainCache[pChannelInfo->m_index];
+            BusChannel busChannel;
+            busChannel.pChannelInfo = pChannelInfo;
+            busChannel.oldGain = gainCache.m_gain;
+            busChannel.fadeout = gainCache.m_fadeout ||
+                    (pChannelInfo->m_pChannel &&
+                            !pChannelInfo->m_pChannel->isActive());
+            if (busChannel.fadeout) {
+                busChannel.newGain = 0;
+                gainCache.m_fadeout = false;
+            } else {
+                busChannel.newGain = m_mainGain.getGain(pChannelInfo);
+            }
+            gainCache.m_gain = busChannel.newGain;
+            busChannel.group = static_cast<int>(m_busChannels.size());
+            m_busChannels.append(busChannel);
+        }
+    }
+
+    // A chain processes its channels with shared buffers and effect states.
+    // All channels of a chain are merged into a group, that is processed
+    // sequentially in the original order. The groups only process the chains
+    // they are active for, and the chain-wide enable states are advanced by
+    // the engine thread in EngineEffectsManager::onCallbackEnd().
+    const int numChains = m_pEngineEffectsManager->numPostFaderChains();
+    m_busChannelOfChain.resize(numChains);
+    std::fill(m_busChannelOfChain.begin(), m_busChannelOfChain.end(), -1);
+    const auto findGroup = [this](int index) {
+        while (m_busChannels[index].group != index) {
+            index = m_busChannels[index].group;
+        }
+        return index;
+    };
+    const int numBusChannels = static_cast<int>(m_busChannels.size());
+    for (int i = 0; i < numBusChannels; ++i) {
+        const BusChannel& busChannel = m_busChannels[i];
+        for (int chainIndex = 0; chainIndex < numChains; ++chainIndex) {
+            if (!m_pEngineEffectsManager->isPostFaderChainActive(chainIndex,
+                        busChannel.pChannelInfo->m_handle,
+                        outputHandle,
+                        busChannel.fadeout)) {
+                continue;
+            }
+            const int otherIndex = m_busChannelOfChain[chainIndex];
+            if (otherIndex < 0) {
+                m_busChannelOfChain[chainIndex] = i;
+                continue;
+            }
+            const int group = findGroup(i);
+            const int otherGroup = findGroup(otherIndex);
+            // The group with the lower index is kept, so the group of a
+            // channel always refers to a channel before it
+            if (group < otherGroup) {
+                m_busChannels[otherGroup].group = group;
+            } else if (otherGroup < group) {
+                m_busChannels[group].group = otherGroup;
+            }
+        }
+    }
+    m_busChannelOrder.resize(numBusChannels);
+    for (int i = 0; i < numBusChannels; ++i) {
+        m_busChannels[i].group = m_busChannels[m_busChannels[i].group].group;
+        m_busChannelOrder[i] = i;
+    }
+    std::sort(m_busChannelOrder.begin(),
+            m_busChannelOrder.end(),
+            [this](int lhs, int rhs) {
+                const int lhsGroup = m_busChannels[lhs].group;
+                const int rhsGroup = m_busChannels[rhs].group;
+                return lhsGroup < rhsGroup || (lhsGroup == rhsGroup && lhs < rhs);
+            });
+    m_busChannelGroupStarts.clear();
+    for (int i = 0; i < numBusChannels; ++i) {
+        if (i == 0 ||
+                m_busChannels[m_busChannelOrder[i]].group !=
+                        m_busChannels[m_busChannelOrder[i - 1]].group) {
+            m_busChannelGroupStarts.append(i);
+        }
+    }
+    m_busChannelGroupStarts.append(numBusChannels);
+
+    auto processGroup = [this, bufferSize, &outputHandle](int group) {
+        for (int i = m_busChannelGroupStarts[group];
+                i < m_busChannelGroupStarts[group + 1];
+                ++i) {
+            const BusChannel& busChannel = m_busChannels[m_busChannelOrder[i]];
+            ChannelInfo* pChannelInfo = busChannel.pChannelInfo;
+            EngineProfiler::ScopedChannelStage stage(pChannelInfo->m_index,
+                    EngineProfiler::ChannelStage::PostFaderEffects);
+            m_pEngineEffectsManager->processActivePostFaderInPlace(
+                    pChannelInfo->m_handle,
+                    outputHandle,
+                    pChannelInfo->m_pBuffer.data(),
+                    bufferSize,
+                    m_sampleRate,
+                    pChannelInfo->m_features,
+                    busChannel.oldGain,
+                    busChannel.newGain,
+                    busChannel.fadeout);
+        }
+    };
+    const int numGroups = static_cast<int>(m_busChannelGroupStarts.size()) - 1;
+    if (numGroups > 1) {
+        m_pChannelWorkerPool->processItems(numGroups, processGroup);
+    } else if (numGroups == 1) {
+        processGroup(0);
+    }
+
+    // Mix in the same order as ChannelMixer
+    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+        CSAMPLE* pOutput = m_outputBusBuffers[o].data();
+        SampleUtil::clear(pOutput, bufferSize);
+        for (ChannelInfo* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+            SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), bufferSize);
+        }
+    }
+}
+
 void EngineMixer::process(const std::size_t bufferSize) {
     DEBUG_ASSERT(bufferSize <= static_cast<int>(kMaxEngineSamples));
 
@@ -367,6 +566,11 @@ void EngineMixer::process(const std::size_t bufferSize) {
         haveSetName = true;
     }
     // Trace t("EngineMixer::process");
+    const mixxx::realtime::Check::ScopedSection realtimeSection;
+
+    // The engine thread might be replaced by the audio API at any time
+    EngineScratchArena::setCurrent(&m_scratchArena);
+    m_scratchArena.reset();
 
     bool mainEnabled = m_pMainEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
@@ -377,6 +581,8 @@ void EngineMixer::process(const std::size_t bufferSize) {
     constexpr unsigned int kChannels = 2;
     const unsigned int iFrames = static_cast<unsigned int>(bufferSize) / kChannels;
 
+    const EngineProfiler::ScopedCallback profilerCallback(iFrames, m_sampleRate);
+
     if (m_pEngineEffectsManager) {
         m_pEngineEffectsManager->onCallbackStart();
     }
@@ -400,6 +606,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
     m_headphoneGain.setGain(pflMixGainInHeadphones);
 
     if (headphoneEnabled) {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::HeadphoneMix);
         // Process effects and mix PFL channels together for the headphones.
         // Effects will be reprocessed post-fader for the crossfader buses
         // and main mix, so the channel input buffers cannot be modified here.
@@ -437,30 +644,33 @@ void EngineMixer::process(const std::size_t bufferSize) {
 
     // Mix all the talkover enabled channels together.
     // Effects processing is done in place to avoid unnecessary buffer copying.
-    ChannelMixer::applyEffectsInPlaceAndMixChannels(
-            m_talkoverGain,
-            m_activeTalkoverChannels,
-            &m_channelTalkoverGainCache,
-            m_talkover.data(),
-            m_mainHandle.handle(),
-            bufferSize,
-            m_sampleRate,
-            m_pEngineEffectsManager);
-
-    // Process effects on all microphones mixed together
     // We have no metadata for mixed effect buses, so use an empty GroupFeatureState.
     GroupFeatureState busFeatures;
-    if (m_pEngineEffectsManager) {
-        m_pEngineEffectsManager->processPostFaderInPlace(
-                m_busTalkoverHandle.handle(),
-                m_mainHandle.handle(),
+    {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::TalkoverMix);
+        ChannelMixer::applyEffectsInPlaceAndMixChannels(
+                m_talkoverGain,
+                m_activeTalkoverChannels,
+                &m_channelTalkoverGainCache,
                 m_talkover.data(),
+                m_mainHandle.handle(),
                 bufferSize,
                 m_sampleRate,
-                busFeatures,
-                CSAMPLE_GAIN_ONE,
-                CSAMPLE_GAIN_ONE,
-                false);
+                m_pEngineEffectsManager);
+
+        // Process effects on all microphones mixed together
+        if (m_pEngineEffectsManager) {
+            m_pEngineEffectsManager->processPostFaderInPlace(
+                    m_busTalkoverHandle.handle(),
+                    m_mainHandle.handle(),
+                    m_talkover.data(),
+                    bufferSize,
+                    m_sampleRate,
+                    busFeatures,
+                    CSAMPLE_GAIN_ONE,
+                    CSAMPLE_GAIN_ONE,
+                    false);
+        }
     }
 
     switch (m_pTalkoverDucking->getMode()) {
@@ -492,20 +702,27 @@ void EngineMixer::process(const std::size_t bufferSize) {
     // channel volume faders and crossfader.
     m_mainGain.setGains(crossfaderLeftGain, 1.0f, crossfaderRightGain);
 
-    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
-        ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
-                m_activeBusChannels[o],
-                &m_channelMainGainCache, // no [o] because the old gain
-                                         // follows an orientation switch
-                m_outputBusBuffers[o].data(),
-                m_mainHandle.handle(),
-                bufferSize,
-                m_sampleRate,
-                m_pEngineEffectsManager);
+    if (m_pChannelWorkerPool && m_pEngineEffectsManager) {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::BusMix);
+        applyEffectsInPlaceAndMixBusChannels(bufferSize);
+    } else {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::BusMix);
+        for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+            ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
+                    m_activeBusChannels[o],
+                    &m_channelMainGainCache, // no [o] because the old gain
+                                             // follows an orientation switch
+                    m_outputBusBuffers[o].data(),
+                    m_mainHandle.handle(),
+                    bufferSize,
+                    m_sampleRate,
+                    m_pEngineEffectsManager);
+        }
     }
 
     // Process crossfader orientation bus channel effects
     if (m_pEngineEffectsManager) {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::BusEffects);
         m_pEngineEffectsManager->processPostFaderInPlace(
                 m_busCrossfaderLeftHandle.handle(),
                 m_mainHandle.handle(),
@@ -539,19 +756,28 @@ void EngineMixer::process(const std::size_t bufferSize) {
     }
 
     if (mainEnabled) {
-        // Mix the crossfader orientation buffers together into the main mix
-        SampleUtil::copy3WithGain(m_main.data(),
-                m_outputBusBuffers[EngineChannel::LEFT].data(),
-                1.0,
-                m_outputBusBuffers[EngineChannel::CENTER].data(),
-                1.0,
-                m_outputBusBuffers[EngineChannel::RIGHT].data(),
-                1.0,
-                static_cast<int>(bufferSize));
-
         MicMonitorMode configuredMicMonitorMode = static_cast<MicMonitorMode>(
             static_cast<int>(m_pMicMonitorMode->get()));
 
+        // Mix the crossfader orientation buffers together into the main mix.
+        // With direct monitoring the booth output doesn't depend on the
+        // main effects and talkover, so it is mixed in the same pass.
+        const bool boothRouted = boothEnabled &&
+                configuredMicMonitorMode == MicMonitorMode::DirectMonitor;
+        if (boothRouted) {
+            CSAMPLE_GAIN boothGain = static_cast<CSAMPLE_GAIN>(m_pBoothGain->get());
+            m_busRouting.setBusGain(kRoutedBoothBus, boothGain);
+            m_boothGainOld = boothGain;
+        }
+        const std::array<const CSAMPLE*, 3> routingSources{
+                m_outputBusBuffers[EngineChannel::LEFT].data(),
+                m_outputBusBuffers[EngineChannel::CENTER].data(),
+                m_outputBusBuffers[EngineChannel::RIGHT].data()};
+        std::array<CSAMPLE*, kNumRoutedBuses> routingOutputs{};
+        routingOutputs[kRoutedMainBus] = m_main.data();
+        routingOutputs[kRoutedBoothBus] = boothRouted ? m_booth.data() : nullptr;
+        m_busRouting.process(routingSources.data(), routingOutputs.data(), bufferSize);
+
         // Process main, booth, and record/broadcast buffers according to the
         // MicMonitorMode configured in DlgPrefSound
         // TODO(Be): make SampleUtil ramping functions update the old gain variable
@@ -656,18 +882,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
             // if using direct monitoring because it is being mixed in hardware
             // without the latency of sending the signal into Mixxx for processing.
             // However, include the talkover mix in the record/broadcast signal.
-
-            // Copy main mix to booth output with booth gain
-            if (boothEnabled) {
-                CSAMPLE_GAIN boothGain = static_cast<CSAMPLE_GAIN>(m_pBoothGain->get());
-                SampleUtil::copyWithRampingGain(
-                        m_booth.data(),
-                        m_main.data(),
-                        m_boothGainOld,
-                        boothGain,
-                        bufferSize);
-                m_boothGainOld = boothGain;
-            }
+            // The booth output has been mixed together with the main mix.
 
             // Process main channel effects
             // NOTE(Be): This should occur before mixing in talkover for the
@@ -730,12 +945,26 @@ void EngineMixer::process(const std::size_t bufferSize) {
         // EngineSideChain::receiveBuffer has copied the input buffer to m_pSidechainMix
         // via before (called by SoundManager::pushInputBuffers())
         if (m_pEngineSideChain) {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Sidechain);
+            // The pre-fader output of the channels for a multi-track recording.
+            // The channels that have not been processed are recorded as silence.
+            for (const auto& pChannelInfo : m_channels) {
+                if (pChannelInfo->m_sideChainTrack >= 0) {
+                    m_pEngineSideChain->writeChannelTrackSamples(
+                            pChannelInfo->m_sideChainTrack,
+                            pChannelInfo->m_pChannel->isActive()
+                                    ? pChannelInfo->m_pBuffer.data()
+                                    : nullptr,
+                            iFrames);
+                }
+            }
             m_pEngineSideChain->writeSamples(m_sidechainMix.data(), iFrames);
         }
 
         // Process effects that apply to main hardware output only but not
         // record/broadcast signal
         if (m_pEngineEffectsManager) {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::OutputEffects);
             GroupFeatureState mainFeatures;
             mainFeatures.gain = m_pMainGain->get();
             m_pEngineEffectsManager->processPostFaderInPlace(
@@ -791,6 +1020,10 @@ void EngineMixer::process(const std::size_t bufferSize) {
         m_pBoothDelay->process(m_booth.data(), bufferSize);
     }
 
+    if (m_pEngineEffectsManager) {
+        m_pEngineEffectsManager->onCallbackEnd();
+    }
+
     // We're close to the end of the callback. Wake up the engine worker
     // scheduler so that it runs the workers.
     m_pWorkerScheduler->runWorkers();
@@ -799,6 +1032,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
 void EngineMixer::applyMainEffects(std::size_t bufferSize) {
     // Apply main effects
     if (m_pEngineEffectsManager) {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::MainEffects);
         GroupFeatureState mainFeatures;
         mainFeatures.gain = m_pMainGain->get();
         m_pEngineEffectsManager->processPostFaderInPlace(m_mainHandle.handle(),
@@ -816,19 +1050,20 @@ void EngineMixer::applyMainEffects(std::size_t bufferSize) {
 void EngineMixer::processHeadphones(
         const CSAMPLE_GAIN mainMixGainInHeadphones,
         std::size_t bufferSize) {
-    // Add main mix to headphones
-    SampleUtil::addWithRampingGain(
-            m_head.data(),
-            m_main.data(),
-            m_headphoneMainGainOld,
-            mainMixGainInHeadphones,
-            bufferSize);
-    m_headphoneMainGainOld = mainMixGainInHeadphones;
+    const CSAMPLE_GAIN headphoneGain = static_cast<CSAMPLE_GAIN>(m_pHeadGain->get());
 
     // If Head Split is enabled, replace the left channel of the pfl buffer
     // with a mono mix of the headphone buffer, and the right channel of the pfl
     // buffer with a mono mix of the main output buffer.
     if (m_pHeadSplitEnabled->toBool()) {
+        // Add main mix to headphones
+        SampleUtil::addWithRampingGain(
+                m_head.data(),
+                m_main.data(),
+                m_headphoneMainGainOld,
+                mainMixGainInHeadphones,
+                bufferSize);
+
         // note: NOT VECTORIZED because of in place copy
         // with all compilers, except clang >= 14.
         auto* const ph = m_head.data();
@@ -837,15 +1072,26 @@ void EngineMixer::processHeadphones(
             ph[i] = (ph[i] + ph[i + 1]) / 2;
             ph[i + 1] = (pm[i] + pm[i + 1]) / 2;
         }
-    }
 
-    // Apply headphone gain
-    CSAMPLE_GAIN headphoneGain = static_cast<CSAMPLE_GAIN>(m_pHeadGain->get());
-    SampleUtil::applyRampingGain(
-            m_head.data(),
-            m_headphoneGainOld,
-            headphoneGain,
-            bufferSize);
+        // Apply headphone gain
+        SampleUtil::applyRampingGain(
+                m_head.data(),
+                m_headphoneGainOld,
+                headphoneGain,
+                bufferSize);
+    } else {
+        // Add the main mix and apply the headphone gain in a single pass
+        // over the headphone buffer
+        SampleUtil::applyRampingGainAndAddWithRampingGain(
+                m_head.data(),
+                m_headphoneGainOld,
+                headphoneGain,
+                m_main.data(),
+                m_headphoneMainGainOld * m_headphoneGainOld,
+                mainMixGainInHeadphones * headphoneGain,
+                bufferSize);
+    }
+    m_headphoneMainGainOld = mainMixGainInHeadphones;
     m_headphoneGainOld = headphoneGain;
 }
 
@@ -865,7 +1111,15 @@ void EngineMixer::addChannel(std::unique_ptr<EngineChannel> pChannel) {
     pChannelInfo->m_pMuteControl->setButtonMode(mixxx::control::ButtonMode::PowerWindow);
     pChannelInfo->m_pBuffer = mixxx::SampleBuffer(kMaxEngineSamples);
     pChannelInfo->m_pBuffer.clear();
+    EngineProfiler::registerChannel(pChannelInfo->m_index, group);
     EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+    // Samplers and preview decks are not recorded separately, they are
+    // only part of the mix
+    const bool isSamplerOrPreviewDeck =
+            pBuffer != nullptr && !pChannelInfo->m_pChannel->isPrimaryDeck();
+    if (m_pEngineSideChain && !isSamplerOrPreviewDeck) {
+        pChannelInfo->m_sideChainTrack = m_pEngineSideChain->addChannelTrack(group);
+    }
     m_channels.append(std::move(pChannelInfo));
     constexpr GainCache gainCacheDefault = {0, false};
     m_channelHeadphoneGainCache.append(gainCacheDefault);
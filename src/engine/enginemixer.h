@@ -9,10 +9,12 @@
 #include "audio/types.h"
 #include "control/controlobject.h"
 #include "control/controlpushbutton.h"
+#include "engine/busroutingmatrix.h"
 #include "engine/channelhandle.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/engineobject.h"
+#include "engine/enginescratcharena.h"
 #include "preferences/usersettings.h"
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
@@ -22,6 +24,7 @@
 #include "util/types.h"
 
 class EngineWorkerScheduler;
+class EngineChannelWorkerPool;
 class EngineVuMeter;
 class ControlPotmeter;
 class ControlPushButton;
@@ -120,6 +123,9 @@ class EngineMixer : public QObject, public AudioSource {
         std::unique_ptr<ControlPushButton> m_pMuteControl{nullptr};
         GroupFeatureState m_features{};
         int m_index;
+        // The channel track of a multi-track recording, -1 if the channel
+        // is not recorded separately
+        int m_sideChainTrack{-1};
     };
 
     struct GainCache {
@@ -254,6 +260,15 @@ class EngineMixer : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(std::size_t bufferSize);
+    // Processes a single channel and collects its features for effects.
+    // May be called concurrently from the workers of m_pChannelWorkerPool.
+    void processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize);
+
+    // Applies the postfader effects to the channels of all crossfader
+    // orientation buses in place and mixes them into m_outputBusBuffers.
+    // Channels that don't share an active effect chain are processed
+    // concurrently by the workers of m_pChannelWorkerPool.
+    void applyEffectsInPlaceAndMixBusChannels(std::size_t bufferSize);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(std::size_t bufferSize);
@@ -280,10 +295,28 @@ class EngineMixer : public QObject, public AudioSource {
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeHeadphoneChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeTalkoverChannels;
 
+    // Pre-allocated buffers for applyEffectsInPlaceAndMixBusChannels()
+    struct BusChannel {
+        ChannelInfo* pChannelInfo;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+        bool fadeout;
+        // The index of the first bus channel that shares an active chain
+        int group;
+    };
+    QVarLengthArray<BusChannel, kPreallocatedChannels> m_busChannels;
+    // The indices of m_busChannels, ordered by group
+    QVarLengthArray<int, kPreallocatedChannels> m_busChannelOrder;
+    QVarLengthArray<int, kPreallocatedChannels> m_busChannelGroupStarts;
+    // The first bus channel that is processed by each postfader chain
+    QVarLengthArray<int, kPreallocatedChannels> m_busChannelOfChain;
+
     mixxx::audio::SampleRate m_sampleRate;
 
     // Mixing buffers for each output.
     std::array<mixxx::SampleBuffer, 3> m_outputBusBuffers;
+    // Mixes the crossfader orientation buses into the main and booth outputs
+    BusRoutingMatrix m_busRouting;
     mixxx::SampleBuffer m_booth;
     mixxx::SampleBuffer m_head;
     mixxx::SampleBuffer m_talkover;
@@ -291,6 +324,10 @@ class EngineMixer : public QObject, public AudioSource {
     mixxx::SampleBuffer m_sidechainMix;
 
     parented_ptr<EngineWorkerScheduler> m_pWorkerScheduler;
+    // Only allocated if parallel channel processing is enabled
+    std::unique_ptr<EngineChannelWorkerPool> m_pChannelWorkerPool;
+    // The temporary buffers of the objects processed in the engine thread
+    EngineScratchArena m_scratchArena;
     std::unique_ptr<EngineSync> m_pEngineSync;
 
     std::unique_ptr<ControlObject> m_pMainGain;
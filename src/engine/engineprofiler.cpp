@@ -0,0 +1,422 @@
+#include "engine/engineprofiler.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr int kEngineTid = 0;
+
+// Marks a channel stage that does not change the current channel
+constexpr int kNoChannelChange = -2;
+
+qint64 nowNanos() {
+    return mixxx::Time::elapsed().toIntegerNanos();
+}
+
+quint32 toSpanNanos(qint64 nanos) {
+    return static_cast<quint32>(math_clamp(nanos,
+            qint64(0),
+            static_cast<qint64>(std::numeric_limits<quint32>::max())));
+}
+
+} // namespace
+
+EngineProfiler::ScopedCallback::ScopedCallback(
+        SINT frames, mixxx::audio::SampleRate sampleRate)
+        : m_pProfiler(EngineProfiler::enabledInstance()) {
+    if (m_pProfiler) {
+        m_pProfiler->beginCallback(frames, sampleRate);
+    }
+}
+
+EngineProfiler::ScopedCallback::~ScopedCallback() {
+    if (m_pProfiler) {
+        m_pProfiler->endCallback();
+    }
+}
+
+void EngineProfiler::ScopedStage::start(CallbackProfile* pProfile, Span* pSpan) {
+    m_pSpan = pSpan;
+    m_callbackStartNanos = pProfile->startNanos;
+    m_startNanos = nowNanos();
+}
+
+void EngineProfiler::ScopedStage::finish() {
+    const qint64 endNanos = nowNanos();
+    if (m_pSpan->durationNanos == 0) {
+        m_pSpan->startNanos = toSpanNanos(m_startNanos - m_callbackStartNanos);
+    }
+    // A stage that took less than a nanosecond still ran
+    m_pSpan->durationNanos = toSpanNanos(math_max(qint64(1),
+            m_pSpan->durationNanos + endNanos - m_startNanos));
+}
+
+EngineProfiler::ScopedChannelStage::ScopedChannelStage(
+        int channelIndex, ChannelStage stage)
+        : m_previousChannelIndex(kNoChannelChange) {
+    CallbackProfile* pProfile = s_pCurrentProfile.load(std::memory_order_relaxed);
+    if (!pProfile || channelIndex < 0 || channelIndex >= kMaxChannels) {
+        return;
+    }
+    if (stage == ChannelStage::Process) {
+        m_previousChannelIndex = s_currentChannelIndex;
+        s_currentChannelIndex = channelIndex;
+    }
+    start(pProfile, &pProfile->channels[channelIndex][static_cast<int>(stage)]);
+}
+
+EngineProfiler::ScopedChannelStage::~ScopedChannelStage() {
+    if (m_previousChannelIndex != kNoChannelChange) {
+        s_currentChannelIndex = m_previousChannelIndex;
+    }
+}
+
+EngineProfiler::EngineProfiler(int ringSize)
+        : m_ring(ringSize),
+          m_profile{},
+          m_droppedProfiles(0) {
+    s_pInstance.store(this);
+}
+
+EngineProfiler::~EngineProfiler() {
+    setEnabled(false);
+    s_pInstance.store(nullptr);
+}
+
+void EngineProfiler::addConsumer(Consumer* pConsumer) {
+    DEBUG_ASSERT(!hasConsumer(pConsumer));
+    if (m_consumers.empty()) {
+        // Discard what has been published for earlier consumers
+        dispatch();
+        setEnabled(true);
+    }
+    m_consumers.push_back(pConsumer);
+}
+
+void EngineProfiler::removeConsumer(Consumer* pConsumer) {
+    const auto it = std::find(m_consumers.begin(), m_consumers.end(), pConsumer);
+    if (it == m_consumers.end()) {
+        return;
+    }
+    m_consumers.erase(it);
+    if (m_consumers.empty()) {
+        setEnabled(false);
+    }
+}
+
+bool EngineProfiler::hasConsumer(const Consumer* pConsumer) const {
+    return std::find(m_consumers.begin(), m_consumers.end(), pConsumer) !=
+            m_consumers.end();
+}
+
+void EngineProfiler::setEnabled(bool enabled) {
+    if (enabled) {
+        s_pEnabled.store(this);
+    } else {
+        EngineProfiler* pExpected = this;
+        s_pEnabled.compare_exchange_strong(pExpected, nullptr);
+    }
+}
+
+// static
+void EngineProfiler::registerChannel(int channelIndex, const QString& group) {
+    EngineProfiler* pProfiler = s_pInstance.load();
+    if (!pProfiler || channelIndex < 0 || channelIndex >= kMaxChannels) {
+        return;
+    }
+    const auto locker = QMutexLocker(&pProfiler->m_channelNamesMutex);
+    while (pProfiler->m_channelNames.size() <= channelIndex) {
+        pProfiler->m_channelNames.append(QString());
+    }
+    pProfiler->m_channelNames[channelIndex] = group;
+}
+
+QStringList EngineProfiler::channelNames() const {
+    const auto locker = QMutexLocker(&m_channelNamesMutex);
+    return m_channelNames;
+}
+
+void EngineProfiler::beginCallback(SINT frames, mixxx::audio::SampleRate sampleRate) {
+    m_profile.startNanos = nowNanos();
+    m_profile.frames = static_cast<quint32>(frames);
+    m_profile.sampleRate = sampleRate.isValid() ? sampleRate.value() : 0;
+    m_profile.stages.fill(Span{});
+    for (auto& channel : m_profile.channels) {
+        channel.fill(Span{});
+    }
+    m_profile.cacheMisses.fill(0);
+    s_pCurrentProfile.store(&m_profile, std::memory_order_relaxed);
+}
+
+void EngineProfiler::endCallback() {
+    s_pCurrentProfile.store(nullptr, std::memory_order_relaxed);
+    Span& callback = m_profile.stages[static_cast<int>(Stage::Callback)];
+    callback.startNanos = 0;
+    callback.durationNanos = toSpanNanos(
+            math_max(qint64(1), nowNanos() - m_profile.startNanos));
+    if (m_ring.write(&m_profile, 1) != 1) {
+        m_droppedProfiles.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EngineProfiler::dispatch() {
+    const int available = m_ring.readAvailable();
+    m_drainedProfiles.resize(available);
+    m_drainedProfiles.resize(m_ring.read(m_drainedProfiles.data(), available));
+    const int droppedProfiles = m_droppedProfiles.exchange(0, std::memory_order_relaxed);
+    if (m_drainedProfiles.empty() && droppedProfiles == 0) {
+        return;
+    }
+    for (Consumer* pConsumer : m_consumers) {
+        pConsumer->consumeProfiles(m_drainedProfiles, droppedProfiles);
+    }
+}
+
+EngineProfileStatistics::Histogram::Histogram()
+        : m_buckets{},
+          m_count(0),
+          m_sumNanos(0),
+          m_maxNanos(0) {
+}
+
+void EngineProfileStatistics::Histogram::add(qint64 durationNanos) {
+    int bucket = 0;
+    if (durationNanos >= mixxx::Duration::kNanosPerMicro) {
+        const double micros = static_cast<double>(durationNanos) /
+                mixxx::Duration::kNanosPerMicro;
+        bucket = math_min(1 + static_cast<int>(std::floor(2 * std::log2(micros))),
+                kNumBuckets - 1);
+    }
+    m_buckets[bucket]++;
+    m_count++;
+    m_sumNanos += durationNanos;
+    m_maxNanos = math_max(m_maxNanos, durationNanos);
+}
+
+qint64 EngineProfileStatistics::Histogram::percentileNanos(double percentile) const {
+    const auto target = static_cast<int>(std::ceil(percentile * m_count));
+    int count = 0;
+    for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+        count += m_buckets[bucket];
+        if (count > 0 && count >= target) {
+            return math_min(bucketUpperBoundNanos(bucket), m_maxNanos);
+        }
+    }
+    return m_maxNanos;
+}
+
+// static
+qint64 EngineProfileStatistics::Histogram::bucketUpperBoundNanos(int bucket) {
+    return static_cast<qint64>(std::round(
+            mixxx::Duration::kNanosPerMicro * std::exp2(0.5 * bucket)));
+}
+
+EngineProfileStatistics::EngineProfileStatistics(int traceCapacity)
+        : m_lateCallbacks(0),
+          m_cacheMisses(0),
+          m_traceCapacity(traceCapacity),
+          m_traceNext(0) {
+}
+
+void EngineProfileStatistics::add(const EngineProfiler::CallbackProfile& profile) {
+    for (int stage = 0; stage < EngineProfiler::kNumStages; ++stage) {
+        const quint32 duration = profile.stages[stage].durationNanos;
+        if (duration > 0) {
+            m_stages[stage].add(duration);
+        }
+    }
+    for (int channel = 0; channel < EngineProfiler::kMaxChannels; ++channel) {
+        for (int stage = 0; stage < EngineProfiler::kNumChannelStages; ++stage) {
+            const quint32 duration = profile.channels[channel][stage].durationNanos;
+            if (duration > 0) {
+                m_channels[channel][stage].add(duration);
+            }
+        }
+        m_cacheMisses += profile.cacheMisses[channel];
+    }
+    if (profile.sampleRate > 0) {
+        const qint64 bufferNanos = mixxx::Duration::kNanosPerSecond *
+                profile.frames / profile.sampleRate;
+        const quint32 callbackNanos =
+                profile.stages[static_cast<int>(EngineProfiler::Stage::Callback)]
+                        .durationNanos;
+        if (callbackNanos > bufferNanos) {
+            m_lateCallbacks++;
+        }
+    }
+
+    if (m_traceCapacity == 0) {
+        return;
+    }
+    if (m_trace.size() < m_traceCapacity) {
+        m_trace.push_back(profile);
+    } else {
+        m_trace[m_traceNext] = profile;
+    }
+    m_traceNext = (m_traceNext + 1) % m_traceCapacity;
+}
+
+void EngineProfileStatistics::reset() {
+    m_stages.fill(Histogram());
+    for (auto& channel : m_channels) {
+        channel.fill(Histogram());
+    }
+    m_lateCallbacks = 0;
+    m_cacheMisses = 0;
+    m_trace.clear();
+    m_traceNext = 0;
+}
+
+// static
+QString EngineProfileStatistics::stageName(EngineProfiler::Stage stage) {
+    switch (stage) {
+    case EngineProfiler::Stage::Callback:
+        return QStringLiteral("Callback");
+    case EngineProfiler::Stage::SyncStart:
+        return QStringLiteral("Sync start");
+    case EngineProfiler::Stage::Channels:
+        return QStringLiteral("Channels");
+    case EngineProfiler::Stage::SyncEnd:
+        return QStringLiteral("Sync end");
+    case EngineProfiler::Stage::PostProcess:
+        return QStringLiteral("Post process");
+    case EngineProfiler::Stage::HeadphoneMix:
+        return QStringLiteral("Headphone mix");
+    case EngineProfiler::Stage::TalkoverMix:
+        return QStringLiteral("Talkover mix");
+    case EngineProfiler::Stage::BusMix:
+        return QStringLiteral("Bus mix");
+    case EngineProfiler::Stage::BusEffects:
+        return QStringLiteral("Bus effects");
+    case EngineProfiler::Stage::MainEffects:
+        return QStringLiteral("Main effects");
+    case EngineProfiler::Stage::Sidechain:
+        return QStringLiteral("Sidechain");
+    case EngineProfiler::Stage::OutputEffects:
+        return QStringLiteral("Output effects");
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QString();
+}
+
+// static
+QString EngineProfileStatistics::channelStageName(EngineProfiler::ChannelStage stage) {
+    switch (stage) {
+    case EngineProfiler::ChannelStage::Process:
+        return QStringLiteral("Process");
+    case EngineProfiler::ChannelStage::PreFaderEffects:
+        return QStringLiteral("Pre-fader effects");
+    case EngineProfiler::ChannelStage::PostFaderEffects:
+        return QStringLiteral("Post-fader effects");
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QString();
+}
+
+QJsonArray EngineProfileStatistics::toChromeTraceEvents(
+        const QStringList& channelNames) const {
+    QJsonArray events;
+    const auto makeEvent = [](const QString& name,
+                                   int tid,
+                                   qint64 callbackStartNanos,
+                                   const EngineProfiler::Span& span) {
+        QJsonObject event;
+        event.insert(QStringLiteral("name"), name);
+        event.insert(QStringLiteral("ph"), QStringLiteral("X"));
+        event.insert(QStringLiteral("pid"), 1);
+        event.insert(QStringLiteral("tid"), tid);
+        event.insert(QStringLiteral("ts"),
+                static_cast<double>(callbackStartNanos + span.startNanos) /
+                        mixxx::Duration::kNanosPerMicro);
+        event.insert(QStringLiteral("dur"),
+                static_cast<double>(span.durationNanos) /
+                        mixxx::Duration::kNanosPerMicro);
+        return event;
+    };
+    const auto makeThreadName = [](int tid, const QString& name) {
+        QJsonObject event;
+        event.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+        event.insert(QStringLiteral("ph"), QStringLiteral("M"));
+        event.insert(QStringLiteral("pid"), 1);
+        event.insert(QStringLiteral("tid"), tid);
+        QJsonObject args;
+        args.insert(QStringLiteral("name"), name);
+        event.insert(QStringLiteral("args"), args);
+        return event;
+    };
+
+    std::array<bool, EngineProfiler::kMaxChannels> channelSeen{};
+    events.append(makeThreadName(kEngineTid, QStringLiteral("Engine")));
+    // Start with the oldest profile
+    const std::size_t first = m_trace.size() < m_traceCapacity ? 0 : m_traceNext;
+    for (std::size_t i = 0; i < m_trace.size(); ++i) {
+        const EngineProfiler::CallbackProfile& profile =
+                m_trace[(first + i) % m_trace.size()];
+        for (int stage = 0; stage < EngineProfiler::kNumStages; ++stage) {
+            const EngineProfiler::Span& span = profile.stages[stage];
+            if (span.durationNanos > 0) {
+                events.append(makeEvent(
+                        stageName(static_cast<EngineProfiler::Stage>(stage)),
+                        kEngineTid,
+                        profile.startNanos,
+                        span));
+            }
+        }
+        for (int channel = 0; channel < EngineProfiler::kMaxChannels; ++channel) {
+            for (int stage = 0; stage < EngineProfiler::kNumChannelStages; ++stage) {
+                const EngineProfiler::Span& span = profile.channels[channel][stage];
+                if (span.durationNanos == 0) {
+                    continue;
+                }
+                if (!channelSeen[channel]) {
+                    channelSeen[channel] = true;
+                    const QString name = channel < channelNames.size()
+                            ? channelNames[channel]
+                            : QString();
+                    events.append(makeThreadName(channel + 1,
+                            name.isEmpty()
+                                    ? QStringLiteral("Channel %1").arg(channel)
+                                    : name));
+                }
+                events.append(makeEvent(
+                        channelStageName(
+                                static_cast<EngineProfiler::ChannelStage>(stage)),
+                        channel + 1,
+                        profile.startNanos,
+                        span));
+            }
+            if (profile.cacheMisses[channel] > 0) {
+                // The misses happen while the channel is processed
+                const EngineProfiler::Span& process = profile.channels[channel][
+                        static_cast<int>(EngineProfiler::ChannelStage::Process)];
+                QJsonObject event = makeEvent(QStringLiteral("Cache miss"),
+                        channel + 1,
+                        profile.startNanos,
+                        process);
+                event.remove(QStringLiteral("dur"));
+                event.insert(QStringLiteral("ph"), QStringLiteral("i"));
+                event.insert(QStringLiteral("s"), QStringLiteral("t"));
+                QJsonObject args;
+                args.insert(QStringLiteral("chunks"), profile.cacheMisses[channel]);
+                event.insert(QStringLiteral("args"), args);
+                events.append(event);
+            }
+        }
+    }
+    return events;
+}
+
+// static
+QByteArray EngineProfileStatistics::toChromeTrace(const QJsonArray& events) {
+    QJsonObject trace;
+    trace.insert(QStringLiteral("traceEvents"), events);
+    trace.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ns"));
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QMutex>
+#include <QStringList>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/fifo.h"
+#include "util/singleton.h"
+#include "util/time.h"
+#include "util/types.h"
+
+/// Records the time spent in the stages of each engine callback.
+///
+/// The profiler is always compiled in and is enabled at runtime while it has
+/// consumers, e.g. the developer tools or the XrunRecorder. While disabled,
+/// the stages cost a single relaxed atomic load. While enabled, the engine
+/// fills a preallocated CallbackProfile per callback and publishes it through
+/// a lock-free ring, that is drained by the GUI thread and passed to all
+/// consumers.
+///
+/// Channels may be processed concurrently by the EngineChannelWorkerPool.
+/// Each worker only writes the spans of its own channel, so no locking is
+/// required within the callback.
+class EngineProfiler : public Singleton<EngineProfiler> {
+  public:
+    /// The stages of EngineMixer::process
+    enum class Stage {
+        Callback,
+        SyncStart,
+        Channels,
+        SyncEnd,
+        PostProcess,
+        HeadphoneMix,
+        TalkoverMix,
+        BusMix,
+        BusEffects,
+        MainEffects,
+        Sidechain,
+        OutputEffects,
+    };
+    static constexpr int kNumStages = static_cast<int>(Stage::OutputEffects) + 1;
+
+    /// The stages of a single channel
+    enum class ChannelStage {
+        Process,
+        PreFaderEffects,
+        PostFaderEffects,
+    };
+    static constexpr int kNumChannelStages =
+            static_cast<int>(ChannelStage::PostFaderEffects) + 1;
+
+    /// Channels with a higher index are not profiled
+    static constexpr int kMaxChannels = 32;
+
+    /// A span relative to the start of the callback. A duration of 0 marks
+    /// a stage that did not run.
+    struct Span {
+        quint32 startNanos;
+        quint32 durationNanos;
+    };
+
+    struct CallbackProfile {
+        qint64 startNanos;
+        quint32 frames;
+        quint32 sampleRate;
+        std::array<Span, kNumStages> stages;
+        std::array<std::array<Span, kNumChannelStages>, kMaxChannels> channels;
+        /// The chunks that were not cached when a channel read them
+        std::array<quint16, kMaxChannels> cacheMisses;
+    };
+
+    /// Receives the profiles in the GUI thread
+    class Consumer {
+      public:
+        virtual ~Consumer() = default;
+        /// droppedProfiles is the number of profiles that have been lost
+        /// before the first one, because the ring was full
+        virtual void consumeProfiles(const std::vector<CallbackProfile>& profiles,
+                int droppedProfiles) = 0;
+    };
+
+    /// Times the whole callback. Does nothing if the profiler is disabled.
+    class ScopedCallback {
+      public:
+        ScopedCallback(SINT frames, mixxx::audio::SampleRate sampleRate);
+        ~ScopedCallback();
+
+        ScopedCallback(const ScopedCallback&) = delete;
+        ScopedCallback& operator=(const ScopedCallback&) = delete;
+
+      private:
+        EngineProfiler* const m_pProfiler;
+    };
+
+    /// Times a stage of the current callback
+    class ScopedStage {
+      public:
+        explicit ScopedStage(Stage stage)
+                : m_pSpan(nullptr) {
+            CallbackProfile* pProfile =
+                    s_pCurrentProfile.load(std::memory_order_relaxed);
+            if (pProfile) {
+                start(pProfile, &pProfile->stages[static_cast<int>(stage)]);
+            }
+        }
+        ~ScopedStage() {
+            if (m_pSpan) {
+                finish();
+            }
+        }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+      protected:
+        ScopedStage()
+                : m_pSpan(nullptr) {
+        }
+        void start(CallbackProfile* pProfile, Span* pSpan);
+        void finish();
+
+        Span* m_pSpan;
+
+      private:
+        qint64 m_callbackStartNanos;
+        qint64 m_startNanos;
+    };
+
+    /// Times a stage of a channel. The Process stage also makes the channel
+    /// the current one of the thread, so the stages within it, like the
+    /// pre-fader effects, don't need to know the channel index. A stage that
+    /// runs several times per callback, like the post-fader effects of the
+    /// headphone and main mix, accumulates the durations.
+    class ScopedChannelStage : public ScopedStage {
+      public:
+        ScopedChannelStage(int channelIndex, ChannelStage stage);
+        explicit ScopedChannelStage(ChannelStage stage)
+                : ScopedChannelStage(s_currentChannelIndex, stage) {
+        }
+        ~ScopedChannelStage();
+
+        /// Counts a cache miss of the current channel of the thread
+        static void countCacheMiss() {
+            CallbackProfile* pProfile =
+                    s_pCurrentProfile.load(std::memory_order_relaxed);
+            const int channelIndex = s_currentChannelIndex;
+            if (pProfile && channelIndex >= 0 && channelIndex < kMaxChannels) {
+                quint16& cacheMisses = pProfile->cacheMisses[channelIndex];
+                if (cacheMisses < std::numeric_limits<quint16>::max()) {
+                    cacheMisses++;
+                }
+            }
+        }
+
+      private:
+        // The current channel of the thread before a Process stage, that is
+        // restored when it ends
+        int m_previousChannelIndex;
+    };
+
+    explicit EngineProfiler(int ringSize = 1024);
+    ~EngineProfiler() override;
+
+    /// Returns nullptr if the profiler has not been created or is disabled
+    static EngineProfiler* enabledInstance() {
+        return s_pEnabled.load(std::memory_order_relaxed);
+    }
+
+    bool isEnabled() const {
+        return enabledInstance() == this;
+    }
+
+    /// Enables the profiler while it has consumers
+    void addConsumer(Consumer* pConsumer);
+    void removeConsumer(Consumer* pConsumer);
+    bool hasConsumer(const Consumer* pConsumer) const;
+
+    /// Records the group of a channel at an index of EngineMixer for display
+    static void registerChannel(int channelIndex, const QString& group);
+    QStringList channelNames() const;
+
+    /// Passes the published profiles to the consumers. Called periodically by
+    /// the consumers in the GUI thread.
+    void dispatch();
+
+  private:
+    static inline std::atomic<EngineProfiler*> s_pInstance = nullptr;
+    static inline std::atomic<EngineProfiler*> s_pEnabled = nullptr;
+    static inline std::atomic<CallbackProfile*> s_pCurrentProfile = nullptr;
+    static inline thread_local int s_currentChannelIndex = -1;
+
+    void setEnabled(bool enabled);
+    void beginCallback(SINT frames, mixxx::audio::SampleRate sampleRate);
+    void endCallback();
+
+    FIFO<CallbackProfile> m_ring;
+    CallbackProfile m_profile;
+    std::atomic<int> m_droppedProfiles;
+
+    // Only used by the GUI thread
+    std::vector<Consumer*> m_consumers;
+    std::vector<CallbackProfile> m_drainedProfiles;
+
+    mutable QMutex m_channelNamesMutex;
+    QStringList m_channelNames;
+};
+
+/// Aggregates the profiles of EngineProfiler into histograms and keeps the
+/// most recent ones for the export as Chrome trace, that can be loaded into
+/// chrome://tracing or https://ui.perfetto.dev
+class EngineProfileStatistics {
+  public:
+    /// Counts durations in buckets of half an octave from 1 us up
+    class Histogram {
+      public:
+        static constexpr int kNumBuckets = 36;
+
+        Histogram();
+
+        void add(qint64 durationNanos);
+
+        int count() const {
+            return m_count;
+        }
+        qint64 maxNanos() const {
+            return m_maxNanos;
+        }
+        double meanNanos() const {
+            return m_count > 0 ? static_cast<double>(m_sumNanos) / m_count : 0.0;
+        }
+        /// Returns the upper bound of the bucket of the percentile in [0, 1]
+        qint64 percentileNanos(double percentile) const;
+
+        int bucketCount(int bucket) const {
+            return m_buckets[bucket];
+        }
+        static qint64 bucketUpperBoundNanos(int bucket);
+
+      private:
+        std::array<int, kNumBuckets> m_buckets;
+        int m_count;
+        qint64 m_sumNanos;
+        qint64 m_maxNanos;
+    };
+
+    explicit EngineProfileStatistics(int traceCapacity = 4096);
+
+    void add(const EngineProfiler::CallbackProfile& profile);
+    void reset();
+
+    const Histogram& stage(EngineProfiler::Stage stage) const {
+        return m_stages[static_cast<int>(stage)];
+    }
+    const Histogram& channelStage(int channelIndex,
+            EngineProfiler::ChannelStage stage) const {
+        return m_channels[channelIndex][static_cast<int>(stage)];
+    }
+    /// The callbacks that took longer than the duration of their buffer
+    int lateCallbacks() const {
+        return m_lateCallbacks;
+    }
+    /// The chunks of all channels that were not read in time and are
+    /// missing from the output
+    qint64 cacheMisses() const {
+        return m_cacheMisses;
+    }
+
+    static QString stageName(EngineProfiler::Stage stage);
+    static QString channelStageName(EngineProfiler::ChannelStage stage);
+
+    /// Returns the events of the recent profiles in the Chrome trace event
+    /// format. Each channel is displayed as a thread of its own.
+    QJsonArray toChromeTraceEvents(const QStringList& channelNames) const;
+    /// Returns the Chrome trace file with the events
+    static QByteArray toChromeTrace(const QJsonArray& events);
+    QByteArray toChromeTrace(const QStringList& channelNames) const {
+        return toChromeTrace(toChromeTraceEvents(channelNames));
+    }
+
+  private:
+    std::array<Histogram, EngineProfiler::kNumStages> m_stages;
+    std::array<std::array<Histogram, EngineProfiler::kNumChannelStages>,
+            EngineProfiler::kMaxChannels>
+            m_channels;
+    int m_lateCallbacks;
+    qint64 m_cacheMisses;
+
+    std::vector<EngineProfiler::CallbackProfile> m_trace;
+    std::size_t m_traceCapacity;
+    std::size_t m_traceNext;
+};
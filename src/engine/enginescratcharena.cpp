@@ -0,0 +1,102 @@
+#include "engine/enginescratcharena.h"
+
+#include <limits>
+#include <memory>
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineScratchArena");
+
+// Allocations start at cache line boundaries, which keeps the alignment of
+// SampleUtil::alloc() for SIMD
+constexpr SINT kAlignmentSamples = 64 / sizeof(CSAMPLE);
+
+constexpr SINT alignedSize(SINT numSamples) {
+    return (numSamples + kAlignmentSamples - 1) / kAlignmentSamples * kAlignmentSamples;
+}
+
+thread_local EngineScratchArena* t_pCurrentArena = nullptr;
+
+} // anonymous namespace
+
+EngineScratchArena::EngineScratchArena(SINT capacity)
+        : m_buffer(alignedSize(capacity)),
+          m_used(0),
+          m_pInnermostScope(nullptr) {
+}
+
+EngineScratchArena::~EngineScratchArena() {
+    DEBUG_ASSERT(!m_pInnermostScope);
+    if (t_pCurrentArena == this) {
+        t_pCurrentArena = nullptr;
+    }
+}
+
+// static
+EngineScratchArena* EngineScratchArena::current() {
+    if (!t_pCurrentArena) [[unlikely]] {
+        // Owned by the thread, freed when it finishes
+        thread_local std::unique_ptr<EngineScratchArena> t_pFallbackArena;
+        if (!t_pFallbackArena) {
+            kLogger.debug() << "Allocating an arena for a thread without one";
+            t_pFallbackArena = std::make_unique<EngineScratchArena>();
+        }
+        t_pCurrentArena = t_pFallbackArena.get();
+    }
+    return t_pCurrentArena;
+}
+
+// static
+void EngineScratchArena::setCurrent(EngineScratchArena* pArena) {
+    DEBUG_ASSERT(!t_pCurrentArena || !t_pCurrentArena->m_pInnermostScope);
+    t_pCurrentArena = pArena;
+}
+
+void EngineScratchArena::reset() {
+    VERIFY_OR_DEBUG_ASSERT(!m_pInnermostScope) {
+        // The open scopes would hand out buffers twice
+        return;
+    }
+    DEBUG_ASSERT(m_used == 0);
+    m_used = 0;
+}
+
+EngineScratchArena::Scope::Scope(EngineScratchArena* pArena)
+        : m_pArena(pArena),
+          m_pParent(pArena->m_pInnermostScope),
+          m_begin(pArena->m_used) {
+    m_pArena->m_pInnermostScope = this;
+}
+
+EngineScratchArena::Scope::~Scope() {
+    // Scopes are released in reverse order
+    DEBUG_ASSERT(m_pArena->m_pInnermostScope == this);
+#ifdef MIXXX_DEBUG_ASSERTIONS_ENABLED
+    SampleUtil::fill(m_pArena->m_buffer.data(m_begin),
+            std::numeric_limits<CSAMPLE>::quiet_NaN(),
+            m_pArena->m_used - m_begin);
+#endif
+    m_pArena->m_used = m_begin;
+    m_pArena->m_pInnermostScope = m_pParent;
+}
+
+CSAMPLE* EngineScratchArena::Scope::allocate(SINT numSamples) {
+    DEBUG_ASSERT(numSamples >= 0);
+    // An outer scope would hand out the buffers of an inner scope again
+    DEBUG_ASSERT(m_pArena->m_pInnermostScope == this);
+    const SINT size = alignedSize(numSamples);
+    VERIFY_OR_DEBUG_ASSERT(m_pArena->m_used + size <= m_pArena->capacity()) {
+        // Not real-time safe, but still correct
+        kLogger.warning() << "Exhausted the arena of" << m_pArena->capacity()
+                          << "samples, allocating" << numSamples << "samples";
+        m_overflowBuffers.emplace_back(numSamples);
+        return m_overflowBuffers.back().data();
+    }
+    CSAMPLE* pBuffer = m_pArena->m_buffer.data(m_pArena->m_used);
+    m_pArena->m_used += size;
+    return pBuffer;
+}
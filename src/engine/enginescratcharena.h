@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include "util/defs.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// A bump allocator for the temporary sample buffers that engine objects
+/// need only while processing a callback, like the intermediate buffers of
+/// the effect chains.
+///
+/// Instead of every object owning buffers for the maximum buffer size, all
+/// of them borrow buffers of the actual size from the arena of the thread
+/// they are processed in. The arena is reused in every callback, so the
+/// scratch memory that is touched stays small and hot in the caches.
+///
+/// Every engine thread has its own arena: EngineMixer installs one for the
+/// engine thread and each thread of the EngineChannelWorkerPool installs
+/// its own. Buffers are allocated through a Scope and released in reverse
+/// order when it ends:
+///
+///     EngineScratchArena::Scope scratch;
+///     CSAMPLE* pTemp = scratch.allocate(numSamples);
+///
+/// Only the innermost scope of a thread may allocate, which is asserted in
+/// debug builds. Released buffers are poisoned with NaNs in debug builds to
+/// reveal reads after the end of their scope.
+class EngineScratchArena {
+  public:
+    /// Enough for the stems of a deck and the nested buffers of the effects
+    /// manager and an effect chain with the maximum buffer size.
+    static constexpr SINT kDefaultCapacity = 8 * kMaxEngineSamples;
+
+    explicit EngineScratchArena(SINT capacity = kDefaultCapacity);
+    ~EngineScratchArena();
+
+    EngineScratchArena(const EngineScratchArena&) = delete;
+    EngineScratchArena& operator=(const EngineScratchArena&) = delete;
+
+    /// The arena of the calling thread. An arena is allocated on the first
+    /// call in threads that have not installed one, e.g. in tests.
+    static EngineScratchArena* current();
+    /// Installs the arena for the calling thread. The arena must outlive
+    /// all scopes that are opened in the thread afterwards.
+    static void setCurrent(EngineScratchArena* pArena);
+
+    SINT capacity() const {
+        return m_buffer.size();
+    }
+    /// The number of samples that are currently allocated
+    SINT used() const {
+        return m_used;
+    }
+
+    /// Called at the start of every callback. All scopes must be closed.
+    void reset();
+
+    class Scope {
+      public:
+        Scope()
+                : Scope(current()) {
+        }
+        explicit Scope(EngineScratchArena* pArena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /// Returns an uninitialized, aligned buffer that is valid until
+        /// the end of the scope.
+        CSAMPLE* allocate(SINT numSamples);
+
+      private:
+        EngineScratchArena* const m_pArena;
+        Scope* const m_pParent;
+        const SINT m_begin;
+        // Only used if the arena is exhausted, which is a bug
+        std::vector<mixxx::SampleBuffer> m_overflowBuffers;
+    };
+
+  private:
+    mixxx::SampleBuffer m_buffer;
+    SINT m_used;
+    Scope* m_pInnermostScope;
+};
@@ -3,6 +3,15 @@
 #include <QtDebug>
 
 #include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+// The number of frames of the key signal that are reduced to their
+// maximum before comparing it with the threshold
+constexpr std::size_t kKeyBlockFrames = 64;
+
+} // anonymous namespace
 
 EngineSideChainCompressor::EngineSideChainCompressor(const QString& group)
         : m_compressRatio(1.0),
@@ -45,14 +54,22 @@ void EngineSideChainCompressor::setAboveThreshold(bool value) {
 }
 
 void EngineSideChainCompressor::processKey(const CSAMPLE* pIn, const std::size_t bufferSize) {
-    m_bAboveThreshold = false;
-    for (std::size_t i = 0; i + 1 < bufferSize; i += 2) {
-        CSAMPLE val = (pIn[i] + pIn[i + 1]) / 2;
-        if (val > m_threshold) {
+    // The mono mix is reduced to its maximum block by block without
+    // branching, so the inner loop can be vectorized. The threshold is
+    // only checked once per block.
+    const std::size_t numFrames = bufferSize / 2;
+    for (std::size_t blockStart = 0; blockStart < numFrames; blockStart += kKeyBlockFrames) {
+        const std::size_t blockEnd = math_min(blockStart + kKeyBlockFrames, numFrames);
+        CSAMPLE maxVal = (pIn[blockStart * 2] + pIn[blockStart * 2 + 1]) / 2;
+        for (std::size_t i = blockStart + 1; i < blockEnd; ++i) {
+            maxVal = math_max(maxVal, (pIn[i * 2] + pIn[i * 2 + 1]) / 2);
+        }
+        if (maxVal > m_threshold) {
             m_bAboveThreshold = true;
             return;
         }
     }
+    m_bAboveThreshold = false;
 }
 
 double EngineSideChainCompressor::calculateCompressedGain(int frames) {
@@ -15,6 +15,27 @@ constexpr int kPeakDuration = 500; // in ms
 constexpr CSAMPLE kAttackSmoothing = 1.0f; // .85
 constexpr CSAMPLE kDecaySmoothing = 0.1f;  //.16//.4
 
+// Returns true while the indicator is lit. It is only set when it changes,
+// which happens rarely compared to the number of callbacks, because each
+// set() of a control is an atomic write and may notify listeners.
+bool updatePeakIndicator(ControlObject* pIndicator,
+        int* pDuration,
+        bool clipped,
+        int peakDuration) {
+    bool lit = true;
+    if (clipped) {
+        *pDuration = peakDuration;
+    } else if (*pDuration <= 0) {
+        lit = false;
+    } else {
+        --*pDuration;
+    }
+    if (lit != pIndicator->toBool()) {
+        pIndicator->set(lit ? 1.0 : 0.0);
+    }
+    return lit;
+}
+
 } // namespace
 
 EngineVuMeter::EngineVuMeter(const QString& group, const QString& legacyGroup)
@@ -81,28 +102,19 @@ void EngineVuMeter::process(CSAMPLE* pIn, const std::size_t bufferSize) {
         m_fRMSvolumeSumR = 0;
     }
 
-    if (clipped & SampleUtil::CLIPPING_LEFT) {
-        m_peakIndicatorLeft.set(1.0);
-        m_peakDurationL = static_cast<int>(kPeakDuration * sampleRate / bufferSize / 2000);
-    } else if (m_peakDurationL <= 0) {
-        m_peakIndicatorLeft.set(0.0);
-    } else {
-        --m_peakDurationL;
+    const int peakDuration = static_cast<int>(kPeakDuration * sampleRate / bufferSize / 2000);
+    const bool peakLeft = updatePeakIndicator(&m_peakIndicatorLeft,
+            &m_peakDurationL,
+            clipped & SampleUtil::CLIPPING_LEFT,
+            peakDuration);
+    const bool peakRight = updatePeakIndicator(&m_peakIndicatorRight,
+            &m_peakDurationR,
+            clipped & SampleUtil::CLIPPING_RIGHT,
+            peakDuration);
+    const bool peak = peakLeft || peakRight;
+    if (peak != m_peakIndicator.toBool()) {
+        m_peakIndicator.set(peak ? 1.0 : 0.0);
     }
-
-    if (clipped & SampleUtil::CLIPPING_RIGHT) {
-        m_peakIndicatorRight.set(1.0);
-        m_peakDurationR = static_cast<int>(kPeakDuration * sampleRate / bufferSize / 2000);
-    } else if (m_peakDurationR <= 0) {
-        m_peakIndicatorRight.set(0.0);
-    } else {
-        --m_peakDurationR;
-    }
-
-    m_peakIndicator.set(
-            (m_peakIndicatorRight.toBool() || m_peakIndicatorLeft.toBool())
-                    ? 1.0
-                    : 0.0);
 }
 
 void EngineVuMeter::doSmooth(CSAMPLE &currentVolume, CSAMPLE newVolume)
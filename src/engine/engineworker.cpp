@@ -5,7 +5,8 @@
 #include "util/assert.h"
 
 EngineWorker::EngineWorker()
-    : m_pScheduler(nullptr) {
+    : m_pScheduler(nullptr),
+      m_deadlineFrames(kNoDeadline) {
     m_notReady.test_and_set();
 }
 
@@ -21,7 +22,13 @@ void EngineWorker::setScheduler(EngineWorkerScheduler* pScheduler) {
     pScheduler->addWorker(this);
 }
 
-void EngineWorker::workReady() {
+void EngineWorker::workReady(SINT deadlineFrames) {
+    SINT earliestDeadlineFrames = m_deadlineFrames.load(std::memory_order_relaxed);
+    while (deadlineFrames < earliestDeadlineFrames &&
+            !m_deadlineFrames.compare_exchange_weak(earliestDeadlineFrames,
+                    deadlineFrames,
+                    std::memory_order_relaxed)) {
+    }
     m_notReady.clear();
     VERIFY_OR_DEBUG_ASSERT(m_pScheduler) {
         return;     
@@ -29,8 +36,11 @@ void EngineWorker::workReady() {
     m_pScheduler->workerReady();
 }
 
-void EngineWorker::wakeIfReady() {
-    if (!m_notReady.test_and_set()) {
-        m_semaRun.release();
+bool EngineWorker::wakeIfReady() {
+    if (m_notReady.test_and_set()) {
+        return false;
     }
+    m_deadlineFrames.store(kNoDeadline, std::memory_order_relaxed);
+    m_semaRun.release();
+    return true;
 }
@@ -1,14 +1,21 @@
 #pragma once
 
-#include <atomic>
 #include <QObject>
 #include <QSemaphore>
 #include <QThread>
+#include <atomic>
+#include <limits>
+
+#include "util/types.h"
 
 // EngineWorker is an interface for running background processing work when the
 // audio callback is not active. While the audio callback is active, an
 // EngineWorker can emit its workReady signal, and an EngineWorkerManager will
 // schedule it for running after the audio callback has completed.
+//
+// Workers that are ready at the same time are woken up earliest deadline
+// first, e.g. the reader of a deck that is about to run out of cached
+// samples before the readers that only prefetch the hotcues of other decks.
 
 class EngineWorkerScheduler;
 
@@ -20,9 +27,20 @@ class EngineWorker : public QThread {
 
     virtual void run();
 
+    /// The deadline of work that is not needed for playback soon
+    static constexpr SINT kNoDeadline = std::numeric_limits<SINT>::max();
+
     void setScheduler(EngineWorkerScheduler* pScheduler);
-    void workReady();
-    void wakeIfReady();
+    /// The deadline is the number of frames that can be played before the
+    /// results of the work are needed. The earliest deadline is kept until
+    /// the worker is woken up.
+    void workReady(SINT deadlineFrames = kNoDeadline);
+    /// Returns true if the worker has been woken up
+    bool wakeIfReady();
+
+    SINT deadlineFrames() const {
+        return m_deadlineFrames.load(std::memory_order_relaxed);
+    }
 
   protected:
     QSemaphore m_semaRun;
@@ -30,4 +48,5 @@ class EngineWorker : public QThread {
   private:
     EngineWorkerScheduler* m_pScheduler;
     std::atomic_flag m_notReady;
+    std::atomic<SINT> m_deadlineFrames;
 };
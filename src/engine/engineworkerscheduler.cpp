@@ -1,5 +1,7 @@
 #include "engine/engineworkerscheduler.h"
 
+#include <algorithm>
+
 #include "engine/engineworker.h"
 #include "moc_engineworkerscheduler.cpp"
 #include "util/compatibility/qmutex.h"
@@ -8,7 +10,8 @@
 EngineWorkerScheduler::EngineWorkerScheduler(QObject* pParent)
         : QThread(pParent),
           m_bWakeScheduler(false),
-          m_bQuit(false) {
+          m_bQuit(false),
+          m_overdueWakeCounter(QStringLiteral("EngineWorkerScheduler overdue wake")) {
 }
 
 EngineWorkerScheduler::~EngineWorkerScheduler() {
@@ -30,6 +33,7 @@ void EngineWorkerScheduler::addWorker(EngineWorker* pWorker) {
     DEBUG_ASSERT(pWorker);
     const auto lock = lockMutex(&m_mutex);
     m_workers.push_back(pWorker);
+    m_wakeOrder.reserve(m_workers.size());
 }
 
 void EngineWorkerScheduler::runWorkers() {
@@ -48,8 +52,23 @@ void EngineWorkerScheduler::run() {
         Event::start(tag);
         {
             const auto lock = lockMutex(&m_mutex);
-            for(const auto& pWorker: m_workers) {
-                pWorker->wakeIfReady();
+            // Earliest deadline first, the workers without a deadline
+            // remain in the order in which they have been added. The
+            // deadlines are copied, because they might be updated by the
+            // engine while sorting.
+            m_wakeOrder.clear();
+            for (const auto& pWorker : m_workers) {
+                m_wakeOrder.emplace_back(pWorker->deadlineFrames(), pWorker);
+            }
+            std::stable_sort(m_wakeOrder.begin(),
+                    m_wakeOrder.end(),
+                    [](const auto& lhs, const auto& rhs) {
+                        return lhs.first < rhs.first;
+                    });
+            for (const auto& [deadlineFrames, pWorker] : m_wakeOrder) {
+                if (pWorker->wakeIfReady() && deadlineFrames <= 0) {
+                    m_overdueWakeCounter.increment();
+                }
             }
         }
         Event::end(tag);
@@ -3,6 +3,12 @@
 #include <QMutex>
 #include <QThread>
 #include <QWaitCondition>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "util/counter.h"
+#include "util/types.h"
 
 class EngineWorker;
 
@@ -31,4 +37,10 @@ class EngineWorkerScheduler : public QThread {
     // containing pointers are non-owning
     std::vector<EngineWorker*> m_workers;
     std::atomic<bool> m_bQuit;
+
+    // The deadlines and workers in the order in which they are woken up,
+    // only used by the scheduler thread
+    std::vector<std::pair<SINT, EngineWorker*>> m_wakeOrder;
+    // Workers that are woken up when their results are already needed
+    Counter m_overdueWakeCounter;
 };
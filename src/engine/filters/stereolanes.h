@@ -0,0 +1,165 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STEREOLANES_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define STEREOLANES_NEON
+#endif
+
+#include "util/types.h"
+
+/// The left and right channel of one frame in double precision, held in the
+/// two lanes of a SIMD register where available.
+///
+/// The recursion of an IIR filter prevents vectorizing over consecutive
+/// samples, but both channels of a stereo signal are filtered with the same
+/// coefficients. Processing them together halves the number of instructions
+/// for the filters of the EQs. The arithmetic is IEEE double precision in
+/// each lane, so the results are identical to processing the channels one
+/// after another.
+class StereoLanes {
+  public:
+    StereoLanes()
+            : StereoLanes(0.0) {
+    }
+
+    /// Both lanes are set to the same value
+    explicit StereoLanes(double value) {
+#if defined(STEREOLANES_SSE2)
+        m_lanes = _mm_set1_pd(value);
+#elif defined(STEREOLANES_NEON)
+        m_lanes = vdupq_n_f64(value);
+#else
+        m_left = value;
+        m_right = value;
+#endif
+    }
+
+    StereoLanes(double left, double right) {
+#if defined(STEREOLANES_SSE2)
+        m_lanes = _mm_set_pd(right, left);
+#elif defined(STEREOLANES_NEON)
+        m_lanes = vsetq_lane_f64(right, vdupq_n_f64(left), 1);
+#else
+        m_left = left;
+        m_right = right;
+#endif
+    }
+
+    /// Loads an interleaved stereo frame
+    static StereoLanes load(const CSAMPLE* pFrame) {
+#if defined(STEREOLANES_SSE2)
+        return StereoLanes(_mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)))));
+#elif defined(STEREOLANES_NEON)
+        return StereoLanes(vcvt_f64_f32(vld1_f32(pFrame)));
+#else
+        return StereoLanes(pFrame[0], pFrame[1]);
+#endif
+    }
+
+    /// Stores an interleaved stereo frame
+    void store(CSAMPLE* pFrame) const {
+#if defined(STEREOLANES_SSE2)
+        _mm_storel_pi(reinterpret_cast<__m64*>(pFrame), _mm_cvtpd_ps(m_lanes));
+#elif defined(STEREOLANES_NEON)
+        vst1_f32(pFrame, vcvt_f32_f64(m_lanes));
+#else
+        pFrame[0] = static_cast<CSAMPLE>(m_left);
+        pFrame[1] = static_cast<CSAMPLE>(m_right);
+#endif
+    }
+
+    double left() const {
+#if defined(STEREOLANES_SSE2)
+        return _mm_cvtsd_f64(m_lanes);
+#elif defined(STEREOLANES_NEON)
+        return vgetq_lane_f64(m_lanes, 0);
+#else
+        return m_left;
+#endif
+    }
+
+    double right() const {
+#if defined(STEREOLANES_SSE2)
+        return _mm_cvtsd_f64(_mm_unpackhi_pd(m_lanes, m_lanes));
+#elif defined(STEREOLANES_NEON)
+        return vgetq_lane_f64(m_lanes, 1);
+#else
+        return m_right;
+#endif
+    }
+
+    StereoLanes operator+(StereoLanes other) const {
+#if defined(STEREOLANES_SSE2)
+        return StereoLanes(_mm_add_pd(m_lanes, other.m_lanes));
+#elif defined(STEREOLANES_NEON)
+        return StereoLanes(vaddq_f64(m_lanes, other.m_lanes));
+#else
+        return StereoLanes(m_left + other.m_left, m_right + other.m_right);
+#endif
+    }
+
+    StereoLanes operator-(StereoLanes other) const {
+#if defined(STEREOLANES_SSE2)
+        return StereoLanes(_mm_sub_pd(m_lanes, other.m_lanes));
+#elif defined(STEREOLANES_NEON)
+        return StereoLanes(vsubq_f64(m_lanes, other.m_lanes));
+#else
+        return StereoLanes(m_left - other.m_left, m_right - other.m_right);
+#endif
+    }
+
+    StereoLanes operator-() const {
+#if defined(STEREOLANES_SSE2)
+        // Flips the sign bit like the scalar negation
+        return StereoLanes(_mm_xor_pd(m_lanes, _mm_set1_pd(-0.0)));
+#elif defined(STEREOLANES_NEON)
+        return StereoLanes(vnegq_f64(m_lanes));
+#else
+        return StereoLanes(-m_left, -m_right);
+#endif
+    }
+
+    StereoLanes operator*(double factor) const {
+#if defined(STEREOLANES_SSE2)
+        return StereoLanes(_mm_mul_pd(m_lanes, _mm_set1_pd(factor)));
+#elif defined(STEREOLANES_NEON)
+        return StereoLanes(vmulq_n_f64(m_lanes, factor));
+#else
+        return StereoLanes(m_left * factor, m_right * factor);
+#endif
+    }
+
+    friend StereoLanes operator*(double factor, StereoLanes lanes) {
+        return lanes * factor;
+    }
+
+    StereoLanes& operator+=(StereoLanes other) {
+        *this = *this + other;
+        return *this;
+    }
+
+    StereoLanes& operator-=(StereoLanes other) {
+        *this = *this - other;
+        return *this;
+    }
+
+  private:
+#if defined(STEREOLANES_SSE2)
+    explicit StereoLanes(__m128d lanes)
+            : m_lanes(lanes) {
+    }
+    __m128d m_lanes;
+#elif defined(STEREOLANES_NEON)
+    explicit StereoLanes(float64x2_t lanes)
+            : m_lanes(lanes) {
+    }
+    float64x2_t m_lanes;
+#else
+    double m_left;
+    double m_right;
+#endif
+};
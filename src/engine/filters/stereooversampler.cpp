@@ -0,0 +1,207 @@
+#include "engine/filters/stereooversampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// About 70 dB stopband attenuation
+constexpr double kKaiserBeta = 7.0;
+
+// The modified Bessel function of the first kind and order zero for the
+// Kaiser window. std::cyl_bessel_i() is not available on all platforms.
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 64; ++k) {
+        const double factor = x / (2.0 * k);
+        term *= factor * factor;
+        sum += term;
+        if (term < sum * 1e-15) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+StereoOversampler::HalfbandFilter::HalfbandFilter(int halfTaps, int inputDelay)
+        : m_halfTaps(halfTaps),
+          m_inputDelay(inputDelay),
+          m_taps(2 * halfTaps),
+          m_upHistory(2 * (2 * halfTaps + inputDelay)),
+          m_upPos(0),
+          m_evenHistory(2 * 2 * halfTaps),
+          m_oddHistory(2 * 2 * halfTaps),
+          m_downPos(0) {
+    // A windowed sinc with the cutoff at a quarter of the sample rate, which
+    // is zero at every other tap apart from the center
+    const int length = 4 * halfTaps - 1;
+    const int center = 2 * halfTaps - 1;
+    double sum = 0.0;
+    for (int i = 0; i < 2 * halfTaps; ++i) {
+        const int tap = 2 * i;
+        const double x = M_PI * (tap - center) / 2.0;
+        const double position = 2.0 * tap / (length - 1) - 1.0;
+        const double window =
+                besselI0(kKaiserBeta * std::sqrt(1.0 - position * position)) /
+                besselI0(kKaiserBeta);
+        const double value = std::sin(x) / x * window;
+        m_taps[2 * halfTaps - 1 - i] = value;
+        sum += value;
+    }
+    // Normalize the even phase to the gain of the center tap for a gain of
+    // exactly 1 at DC
+    for (auto& value : m_taps) {
+        value *= 0.5 / sum;
+    }
+}
+
+void StereoOversampler::HalfbandFilter::reset() {
+    std::fill(m_upHistory.begin(), m_upHistory.end(), StereoLanes());
+    std::fill(m_evenHistory.begin(), m_evenHistory.end(), StereoLanes());
+    std::fill(m_oddHistory.begin(), m_oddHistory.end(), StereoLanes());
+    m_upPos = 0;
+    m_downPos = 0;
+}
+
+void StereoOversampler::HalfbandFilter::upsample(
+        CSAMPLE* pOutput, const CSAMPLE* pInput, SINT inputFrames) {
+    const int numTaps = static_cast<int>(m_taps.size());
+    const int historySize = numTaps + m_inputDelay;
+    for (SINT frame = 0; frame < inputFrames; ++frame) {
+        // Read before writing, the output may overlap the input
+        const StereoLanes input = StereoLanes::load(pInput + 2 * frame);
+        m_upHistory[m_upPos] = input;
+        m_upHistory[m_upPos + historySize] = input;
+
+        // The window ends with the input delayed by m_inputDelay
+        const StereoLanes* pWindow = &m_upHistory[m_upPos + 1];
+        StereoLanes even;
+        for (int i = 0; i < numTaps; ++i) {
+            even += pWindow[i] * m_taps[i];
+        }
+        // The gain of 2 compensates the inserted zeros. The odd phase is the
+        // center tap, which is the delayed input.
+        (even * 2.0).store(pOutput + 4 * frame);
+        pWindow[numTaps - m_halfTaps].store(pOutput + 4 * frame + 2);
+
+        if (++m_upPos == historySize) {
+            m_upPos = 0;
+        }
+    }
+}
+
+void StereoOversampler::HalfbandFilter::downsample(
+        CSAMPLE* pOutput, const CSAMPLE* pInput, SINT outputFrames) {
+    const int numTaps = static_cast<int>(m_taps.size());
+    for (SINT frame = 0; frame < outputFrames; ++frame) {
+        const StereoLanes even = StereoLanes::load(pInput + 4 * frame);
+        const StereoLanes odd = StereoLanes::load(pInput + 4 * frame + 2);
+        m_evenHistory[m_downPos] = even;
+        m_evenHistory[m_downPos + numTaps] = even;
+        m_oddHistory[m_downPos] = odd;
+        m_oddHistory[m_downPos + numTaps] = odd;
+
+        const StereoLanes* pWindow = &m_evenHistory[m_downPos + 1];
+        StereoLanes output;
+        for (int i = 0; i < numTaps; ++i) {
+            output += pWindow[i] * m_taps[i];
+        }
+        output += m_oddHistory[m_downPos + numTaps - m_halfTaps] * 0.5;
+        output.store(pOutput + 2 * frame);
+
+        if (++m_downPos == numTaps) {
+            m_downPos = 0;
+        }
+    }
+}
+
+StereoOversampler::StereoOversampler(int factor)
+        : m_factor(1),
+          m_firstStage(kFirstStageHalfTaps, 0),
+          m_secondStage(kSecondStageHalfTaps, 1),
+          m_delayBuffer(2 * latencyFrames(kMaxFactor)),
+          m_delayPos(0) {
+    m_delayBuffer.clear();
+    setFactor(factor);
+}
+
+void StereoOversampler::setFactor(int factor) {
+    VERIFY_OR_DEBUG_ASSERT(factor == 1 || factor == 2 || factor == 4) {
+        factor = 1;
+    }
+    if (factor == m_factor) {
+        return;
+    }
+    m_factor = factor;
+    reset();
+}
+
+void StereoOversampler::reset() {
+    m_firstStage.reset();
+    m_secondStage.reset();
+    m_delayBuffer.clear();
+    m_delayPos = 0;
+}
+
+void StereoOversampler::upsample(
+        CSAMPLE* pOversampled, const CSAMPLE* pInput, SINT numFrames) {
+    switch (m_factor) {
+    case 2:
+        m_firstStage.upsample(pOversampled, pInput, numFrames);
+        break;
+    case 4:
+        // The first stage writes to the upper half, so the second stage can
+        // work in place
+        m_firstStage.upsample(pOversampled + 4 * numFrames, pInput, numFrames);
+        m_secondStage.upsample(pOversampled, pOversampled + 4 * numFrames, 2 * numFrames);
+        break;
+    default:
+        SampleUtil::copy(pOversampled, pInput, 2 * numFrames);
+        break;
+    }
+}
+
+void StereoOversampler::downsample(
+        CSAMPLE* pOutput, CSAMPLE* pOversampled, SINT numFrames) {
+    switch (m_factor) {
+    case 2:
+        m_firstStage.downsample(pOutput, pOversampled, numFrames);
+        break;
+    case 4:
+        m_secondStage.downsample(pOversampled, pOversampled, 2 * numFrames);
+        m_firstStage.downsample(pOutput, pOversampled, numFrames);
+        break;
+    default:
+        SampleUtil::copy(pOutput, pOversampled, 2 * numFrames);
+        break;
+    }
+}
+
+void StereoOversampler::delay(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames) {
+    const SINT latency = latencyFrames();
+    if (latency == 0) {
+        if (pOutput != pInput) {
+            SampleUtil::copy(pOutput, pInput, 2 * numFrames);
+        }
+        return;
+    }
+    for (SINT i = 0; i < 2 * numFrames; i += 2) {
+        CSAMPLE* pDelayed = m_delayBuffer.data(2 * m_delayPos);
+        const CSAMPLE left = pInput[i];
+        const CSAMPLE right = pInput[i + 1];
+        pOutput[i] = pDelayed[0];
+        pOutput[i + 1] = pDelayed[1];
+        pDelayed[0] = left;
+        pDelayed[1] = right;
+        if (++m_delayPos == latency) {
+            m_delayPos = 0;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+
+#include "engine/filters/stereolanes.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// Oversamples a stereo signal by a factor of 2 or 4, so a non-linear effect
+/// can create harmonics above the Nyquist frequency of the engine without
+/// aliasing. They are removed by the lowpass filter when downsampling.
+///
+/// Each factor of 2 is a halfband FIR filter in polyphase form. Every other
+/// coefficient of a halfband filter is zero, so only the non-zero taps of
+/// one phase are computed, and both channels are filtered together in
+/// StereoLanes. The filters are linear phase and the latency is a whole
+/// number of frames, which is reported by the effects as their group delay.
+///
+/// An instance holds the filter state of one stereo signal. The oversampled
+/// buffer is provided by the caller, so the effect can share it between all
+/// of its states.
+class StereoOversampler {
+  public:
+    static constexpr int kMaxFactor = 4;
+
+    /// The factor is 1, 2 or 4. A factor of 1 passes the signal through.
+    explicit StereoOversampler(int factor = 1);
+
+    static constexpr SINT latencyFrames(int factor) {
+        switch (factor) {
+        case 2:
+            return 2 * kFirstStageHalfTaps - 1;
+        case 4:
+            // The second stage is delayed by one sample of the doubled rate,
+            // which makes its latency kSecondStageHalfTaps frames
+            return 2 * kFirstStageHalfTaps - 1 + kSecondStageHalfTaps;
+        default:
+            return 0;
+        }
+    }
+
+    int factor() const {
+        return m_factor;
+    }
+    SINT latencyFrames() const {
+        return latencyFrames(m_factor);
+    }
+
+    /// Clears the state if the factor changes
+    void setFactor(int factor);
+    void reset();
+
+    /// Upsamples numFrames frames of pInput into pOversampled, which must
+    /// hold factor() * numFrames frames.
+    void upsample(CSAMPLE* pOversampled, const CSAMPLE* pInput, SINT numFrames);
+    /// Downsamples the factor() * numFrames frames of pOversampled into
+    /// numFrames frames of pOutput. The contents of pOversampled are
+    /// overwritten.
+    void downsample(CSAMPLE* pOutput, CSAMPLE* pOversampled, SINT numFrames);
+    /// Delays pInput by latencyFrames(), which aligns the dry signal with
+    /// the downsampled output. pOutput may be equal to pInput.
+    void delay(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames);
+
+  private:
+    // The first stage has 4 * 12 - 1 = 47 taps with a passband up to about
+    // 0.4 of the engine sample rate
+    static constexpr int kFirstStageHalfTaps = 12;
+    // The second stage only has to keep the harmonics above 0.75 of the
+    // doubled rate from aliasing into the passband of the first stage,
+    // which allows a much wider transition band
+    static constexpr int kSecondStageHalfTaps = 5;
+
+    /// A halfband lowpass filter with 4 * halfTaps - 1 taps that doubles or
+    /// halves the sample rate. The input of the upsampler can be delayed
+    /// by additional samples.
+    class HalfbandFilter {
+      public:
+        HalfbandFilter(int halfTaps, int inputDelay);
+
+        void reset();
+
+        /// Writes 2 * inputFrames frames. pOutput may overlap the upper
+        /// half of its range with pInput.
+        void upsample(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT inputFrames);
+        /// Reads 2 * outputFrames frames. pOutput may be equal to pInput.
+        void downsample(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT outputFrames);
+
+      private:
+        const int m_halfTaps;
+        const int m_inputDelay;
+        // The taps of the even phase in reverse order, the odd phase only
+        // consists of the center tap of 0.5
+        std::vector<double> m_taps;
+
+        // The histories are stored twice, so the taps always see a
+        // contiguous window of the ring
+        std::vector<StereoLanes> m_upHistory;
+        int m_upPos;
+        std::vector<StereoLanes> m_evenHistory;
+        std::vector<StereoLanes> m_oddHistory;
+        int m_downPos;
+    };
+
+    int m_factor;
+    HalfbandFilter m_firstStage;
+    HalfbandFilter m_secondStage;
+
+    mixxx::SampleBuffer m_delayBuffer;
+    SINT m_delayPos;
+};
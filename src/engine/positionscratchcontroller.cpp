@@ -5,6 +5,7 @@
 #include "engine/bufferscalers/enginebufferscale.h" // for MIN_SEEK_SPEED
 #include "moc_positionscratchcontroller.cpp"
 #include "preferences/configobject.h" // for ConfigKey
+#include "util/compatibility/qmutex.h"
 #include "util/math.h"
 #include "util/time.h"
 
@@ -79,6 +80,13 @@ constexpr double kMaxVelocity = 100;
 // Seconds to stop a throw at the max velocity.
 // TODO make configurable, eg. to customize spinbacks with controllers
 constexpr double kTimeToStop = 1.0;
+// The capacity of the queue of timestamped position events. Jog wheels
+// send up to 1000 events per second.
+constexpr int kPositionEventQueueSize = 256;
+// The position is interpolated this much in the past, so there is an event
+// on both sides of the interpolated time for event intervals up to it.
+// Mice are sampled every 8 ms, jog wheels more often.
+constexpr mixxx::Duration kInterpolationDelay = mixxx::Duration::fromMillis(8);
 
 } // anonymous namespace
 
@@ -92,6 +100,8 @@ PositionScratchController::PositionScratchController(const QString& group)
                   ConfigKey(QStringLiteral("[App]"), QStringLiteral("samplerate")))),
           m_pVelocityController(std::make_unique<VelocityController>()),
           m_pRateIIFilter(std::make_unique<RateIIFilter>()),
+          m_positionEvents(kPositionEventQueueSize),
+          m_numRecentPositionEvents(0),
           m_isScratching(false),
           m_inertiaEnabled(false),
           m_prevSamplePos(0),
@@ -113,6 +123,12 @@ PositionScratchController::PositionScratchController(const QString& group)
           m_f(0.4) {
     m_pMainSampleRate->connectValueChanged(this,
             &PositionScratchController::slotUpdateFilterParameters);
+    // Timestamp the positions in the thread that sets them
+    connect(m_pScratchPos.get(),
+            &ControlObject::valueChanged,
+            this,
+            &PositionScratchController::slotScratchPositionChanged,
+            Qt::DirectConnection);
 }
 
 PositionScratchController::~PositionScratchController() {
@@ -143,6 +159,54 @@ void PositionScratchController::slotUpdateFilterParameters(double sampleRate) {
     m_pRateIIFilter->setFactor(m_f);
 }
 
+void PositionScratchController::slotScratchPositionChanged(double position) {
+    const PositionEvent event{position, mixxx::Time::elapsed()};
+    const auto lock = lockMutex(&m_positionEventsWriteMutex);
+    // If the engine doesn't keep up, the event is dropped. The latest
+    // position is still read from the control.
+    m_positionEvents.write(&event, 1);
+}
+
+void PositionScratchController::receivePositionEvents() {
+    PositionEvent event;
+    while (m_positionEvents.read(&event, 1) == 1) {
+        if (m_numRecentPositionEvents == static_cast<int>(m_recentPositionEvents.size())) {
+            std::move(m_recentPositionEvents.begin() + 1,
+                    m_recentPositionEvents.end(),
+                    m_recentPositionEvents.begin());
+            --m_numRecentPositionEvents;
+        }
+        m_recentPositionEvents[m_numRecentPositionEvents++] = event;
+    }
+}
+
+double PositionScratchController::interpolatedScratchPosition(mixxx::Duration time) const {
+    // Find the events around the time
+    int next = m_numRecentPositionEvents;
+    while (next > 0 && m_recentPositionEvents[next - 1].time > time) {
+        --next;
+    }
+    if (next == m_numRecentPositionEvents) {
+        // No later event
+        return m_pScratchPos->get();
+    }
+    if (next == 0) {
+        // Before the first event of the scratch, unless the earlier events
+        // have been discarded already
+        return m_numRecentPositionEvents < static_cast<int>(m_recentPositionEvents.size())
+                ? m_scratchStartPos
+                : m_recentPositionEvents[0].position;
+    }
+    const PositionEvent& prevEvent = m_recentPositionEvents[next - 1];
+    const PositionEvent& nextEvent = m_recentPositionEvents[next];
+    const double interval = (nextEvent.time - prevEvent.time).toDoubleSeconds();
+    if (interval <= 0) {
+        return nextEvent.position;
+    }
+    const double fraction = (time - prevEvent.time).toDoubleSeconds() / interval;
+    return prevEvent.position + (nextEvent.position - prevEvent.position) * fraction;
+}
+
 void PositionScratchController::process(double currentSamplePos,
         double releaseRate,
         std::size_t bufferSize,
@@ -151,6 +215,7 @@ void PositionScratchController::process(double currentSamplePos,
         mixxx::audio::FramePos trigger,
         mixxx::audio::FramePos target) {
     bool scratchEnable = m_pScratchEnable->toBool();
+    receivePositionEvents();
 
     if (bufferSize != m_bufferSize) {
         m_bufferSize = bufferSize;
@@ -227,9 +292,13 @@ void PositionScratchController::process(double currentSamplePos,
             if (m_scratchPosSampleTime >= kDefaultSampleInterval) {
                 m_scratchPosSampleTime = 0;
 
-                // Set the scratch target to the current set position
-                // and normalize to one buffer
-                double scratchTargetDelta = (m_pScratchPos->get() - m_scratchStartPos) /
+                // Set the scratch target to the position interpolated
+                // between the events received so far, so the target moves
+                // smoothly even if several events arrive within a buffer.
+                // Normalize to one buffer.
+                const double scratchPos =
+                        interpolatedScratchPosition(mixxx::Time::elapsed() - kInterpolationDelay);
+                double scratchTargetDelta = (scratchPos - m_scratchStartPos) /
                         (bufferSize * baseSampleRate);
 
                 bool calcRate = true;
@@ -311,6 +380,8 @@ void PositionScratchController::process(double currentSamplePos,
         // may be entirely unrelated to audio frames.
         m_scratchStartPos = m_pScratchPos->get();
         m_scratchPosSampleTime = 0;
+        // Only interpolate between the events of this scratch
+        m_numRecentPositionEvents = 0;
         // qDebug() << "scratchEnable()" << currentSamplePos;
     }
 
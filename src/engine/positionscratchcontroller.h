@@ -1,9 +1,13 @@
 #pragma once
 
+#include <QMutex>
 #include <QObject>
 #include <QString>
+#include <array>
 
 #include "audio/frame.h"
+#include "util/duration.h"
+#include "util/fifo.h"
 
 class ControlObject;
 class ControlProxy;
@@ -36,14 +40,35 @@ class PositionScratchController : public QObject {
 
   private slots:
     void slotUpdateFilterParameters(double sampleRate);
+    void slotScratchPositionChanged(double position);
 
   private:
+    /// A value of "scratch_position" with the time when it has been set
+    struct PositionEvent {
+        double position;
+        mixxx::Duration time;
+    };
+
+    void receivePositionEvents();
+    /// The scratch position interpolated between the received events
+    double interpolatedScratchPosition(mixxx::Duration time) const;
+
     const QString m_group;
     std::unique_ptr<ControlObject> m_pScratchEnable;
     std::unique_ptr<ControlObject> m_pScratchPos;
     std::unique_ptr<ControlProxy> m_pMainSampleRate;
     std::unique_ptr<VelocityController> m_pVelocityController;
     std::unique_ptr<RateIIFilter> m_pRateIIFilter;
+
+    // The jog and mouse events are timestamped when they arrive and are
+    // queued to the engine, so the events within a buffer are not
+    // collapsed. Serializes the controller and the GUI thread.
+    QMutex m_positionEventsWriteMutex;
+    FIFO<PositionEvent> m_positionEvents;
+    // The received events, the most recent one last
+    std::array<PositionEvent, 16> m_recentPositionEvents;
+    int m_numRecentPositionEvents;
+
     bool m_isScratching;
     bool m_inertiaEnabled;
     double m_prevSamplePos;
@@ -3,16 +3,46 @@
 #include "engine/cachingreader/cachingreader.h"
 #include "engine/controls/loopingcontrol.h"
 #include "engine/controls/ratecontrol.h"
+#include "engine/engine.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// The prefetched range covers the next callbacks at the recent rate, which
+// gives the reader worker time to decode the chunks
+constexpr double kPrefetchCallbacks = 8.0;
+constexpr SINT kMaxPrefetchFrames = 4 * CachingReaderChunk::kFrames;
+// The weight of the latest callback in the rate history
+constexpr double kRateSmoothing = 0.25;
+
+// Stereo loops up to ~0.7 s at 48 kHz are played from the loop buffer, i.e.
+// one beat at 90 BPM and all beat rolls. The loops of stem files with more
+// channels must be shorter accordingly.
+constexpr SINT kMaxLoopBufferFrames = 32768;
+// The crossfade at the loop boundary reads the samples before the loop
+// start that correspond to the samples after the loop end in the same
+// callback, which covers callbacks of up to 2048 frames
+constexpr SINT kLoopBufferPreRollFrames = 2048;
+constexpr SINT kLoopBufferSize = (kMaxLoopBufferFrames + kLoopBufferPreRollFrames) *
+        mixxx::kEngineChannelOutputCount;
+
+} // namespace
+
 ReadAheadManager::ReadAheadManager()
         : m_pLoopingControl(nullptr),
           m_pRateControl(nullptr),
           m_currentPosition(0),
           m_pReader(nullptr),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
-          m_cacheMissHappened(false) {
+          m_cacheMissHappened(false),
+          m_pLoopBuffer(nullptr),
+          m_loopBufferStart(0),
+          m_loopBufferEnd(0),
+          m_samplesReadSinceHint(0.0),
+          m_samplesPerCallback(0.0),
+          m_readCounter(QStringLiteral("ReadAheadManager read")),
+          m_readMissCounter(QStringLiteral("ReadAheadManager read miss")) {
     // For testing only: ReadAheadManagerMock
 }
 
@@ -23,13 +53,77 @@ ReadAheadManager::ReadAheadManager(CachingReader* pReader,
           m_currentPosition(0),
           m_pReader(pReader),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
-          m_cacheMissHappened(false) {
+          m_cacheMissHappened(false),
+          m_pLoopBuffer(SampleUtil::alloc(kLoopBufferSize)),
+          m_loopBufferStart(0),
+          m_loopBufferEnd(0),
+          m_samplesReadSinceHint(0.0),
+          m_samplesPerCallback(0.0),
+          m_readCounter(QStringLiteral("ReadAheadManager %1 read")
+                          .arg(pReader->getGroup())),
+          m_readMissCounter(QStringLiteral("ReadAheadManager %1 read miss")
+                          .arg(pReader->getGroup())) {
     DEBUG_ASSERT(m_pLoopingControl != nullptr);
     DEBUG_ASSERT(m_pReader != nullptr);
 }
 
 ReadAheadManager::~ReadAheadManager() {
     SampleUtil::free(m_pCrossFadeBuffer);
+    if (m_pLoopBuffer) {
+        SampleUtil::free(m_pLoopBuffer);
+    }
+}
+
+CachingReader::ReadResult ReadAheadManager::read(SINT startSample,
+        SINT numSamples,
+        bool reverse,
+        CSAMPLE* pOutput,
+        mixxx::audio::ChannelCount channelCount) {
+    // Only forward reads are served from the loop buffer, the caching
+    // reader reverses the samples of backward reads
+    if (!reverse &&
+            startSample >= m_loopBufferStart &&
+            startSample + numSamples <= m_loopBufferEnd &&
+            m_loopBufferStart < m_loopBufferEnd) {
+        SampleUtil::copy(pOutput,
+                m_pLoopBuffer + (startSample - m_loopBufferStart),
+                numSamples);
+        return CachingReader::ReadResult::AVAILABLE;
+    }
+    return m_pReader->read(startSample, numSamples, reverse, pOutput, channelCount);
+}
+
+void ReadAheadManager::maybeFillLoopBuffer(double loopStartSample,
+        double loopEndSample,
+        mixxx::audio::ChannelCount channelCount) {
+    if (!m_pLoopBuffer) {
+        return;
+    }
+    const SINT fillStart = math_max<SINT>(0,
+            SampleUtil::roundPlayPosToFrameStart(loopStartSample, channelCount) -
+                    kLoopBufferPreRollFrames * channelCount);
+    // Including the frame that is read when overshooting the loop end
+    const SINT fillEnd =
+            SampleUtil::ceilPlayPosToFrameStart(loopEndSample, channelCount) +
+            channelCount;
+    if (fillStart == m_loopBufferStart && fillEnd == m_loopBufferEnd) {
+        return;
+    }
+    m_loopBufferStart = 0;
+    m_loopBufferEnd = 0;
+    const SINT fillSize = fillEnd - fillStart;
+    if (fillSize <= 0 || fillSize > kLoopBufferSize) {
+        // A long loop or track repeat, those are read by the caching reader
+        return;
+    }
+    if (m_pReader->read(fillStart, fillSize, false, m_pLoopBuffer, channelCount) !=
+            CachingReader::ReadResult::AVAILABLE) {
+        // Retry with the next wrap around when the worker has read the
+        // missing chunks
+        return;
+    }
+    m_loopBufferStart = fillStart;
+    m_loopBufferEnd = fillEnd;
 }
 
 SINT ReadAheadManager::getNextSamples(double dRate,
@@ -88,8 +182,12 @@ SINT ReadAheadManager::getNextSamples(double dRate,
     SINT start_sample = SampleUtil::roundPlayPosToFrameStart(
             m_currentPosition, channelCount);
 
-    const auto readResult = m_pReader->read(
+    const auto readResult = read(
             start_sample, samples_from_reader, in_reverse, pOutput, channelCount);
+    m_readCounter.increment();
+    if (readResult != CachingReader::ReadResult::AVAILABLE) {
+        m_readMissCounter.increment();
+    }
     if (readResult == CachingReader::ReadResult::UNAVAILABLE) {
         // Cache miss - no samples written
         SampleUtil::clear(pOutput, samples_from_reader);
@@ -127,6 +225,10 @@ SINT ReadAheadManager::getNextSamples(double dRate,
         }
         // TODO probably also useful for hotcue_X_indicator in CueControl::updateIndicators()
 
+        if (!in_reverse) {
+            maybeFillLoopBuffer(target, loop_trigger, channelCount);
+        }
+
         // Jump to other end of loop or track.
         m_currentPosition = target;
         if (preloop_samples > 0) {
@@ -172,7 +274,7 @@ SINT ReadAheadManager::getNextSamples(double dRate,
         }
 
         if (crossFadeSamples > 0) {
-            const auto readResult = m_pReader->read(loop_read_position +
+            const auto readResult = read(loop_read_position +
                             (in_reverse ? crossFadeStart : -crossFadeStart),
                     crossFadeSamples,
                     in_reverse,
@@ -217,6 +319,12 @@ void ReadAheadManager::notifySeek(double seekPosition) {
     m_currentPosition = seekPosition;
     m_cacheMissHappened = false;
     m_readAheadLog.clear();
+    // Might have been caused by loading another track
+    m_loopBufferStart = 0;
+    m_loopBufferEnd = 0;
+    // The rate history does not apply to the new position
+    m_samplesReadSinceHint = 0.0;
+    m_samplesPerCallback = 0.0;
 
     // TODO(XXX) notifySeek on the engine controls. EngineBuffer currently does
     // a fine job of this so it isn't really necessary but eventually I think
@@ -259,6 +367,37 @@ void ReadAheadManager::hintReader(double dRate,
     // top priority, we need to read this data immediately
     current_position.type = Hint::Type::CurrentPosition;
     pHintList->append(current_position);
+
+    // Predict the range of the next callbacks from the rate history, which
+    // detects fast scratching and reverse play before the current position
+    // reaches uncached chunks
+    m_samplesPerCallback += (m_samplesReadSinceHint - m_samplesPerCallback) * kRateSmoothing;
+    m_samplesReadSinceHint = 0.0;
+    const SINT prefetchFrames = math_min(kMaxPrefetchFrames,
+            static_cast<SINT>(kPrefetchCallbacks * fabs(m_samplesPerCallback) / channelCount));
+    if (prefetchFrames <= frameCountToCache) {
+        // Already covered by the current position
+        return;
+    }
+    // The range starts at the current position, overlapping chunks are
+    // only freshened in the cache
+    Hint prefetch;
+    prefetch.type = Hint::Type::Prefetch;
+    prefetch.frameCount = prefetchFrames;
+    if (m_samplesPerCallback < 0) {
+        prefetch.frame = static_cast<SINT>(ceil(m_currentPosition / channelCount)) -
+                prefetchFrames;
+        if (prefetch.frame < 0) {
+            prefetch.frameCount += prefetch.frame;
+            prefetch.frame = 0;
+            if (prefetch.frameCount <= 0) {
+                return;
+            }
+        }
+    } else {
+        prefetch.frame = static_cast<SINT>(floor(m_currentPosition / channelCount));
+    }
+    pHintList->append(prefetch);
 }
 
 // Not thread-save, call from engine thread only
@@ -266,6 +405,7 @@ void ReadAheadManager::addReadLogEntry(double virtualPlaypositionStart,
                                        double virtualPlaypositionEndNonInclusive) {
     ReadLogEntry newEntry(virtualPlaypositionStart,
                           virtualPlaypositionEndNonInclusive);
+    m_samplesReadSinceHint += virtualPlaypositionEndNonInclusive - virtualPlaypositionStart;
     if (m_readAheadLog.size() > 0) {
         ReadLogEntry& last = m_readAheadLog.back();
         if (last.merge(newEntry)) {
@@ -5,6 +5,7 @@
 
 #include "audio/frame.h"
 #include "engine/cachingreader/cachingreader.h"
+#include "util/counter.h"
 #include "util/math.h"
 #include "util/types.h"
 
@@ -50,7 +51,9 @@ class ReadAheadManager {
     virtual void notifySeek(double seekPosition);
 
     /// hintReader allows the ReadAheadManager to provide hints to the reader to
-    /// indicate that the given portion of a song is about to be read.
+    /// indicate that the given portion of a song is about to be read. Besides
+    /// the current position, the chunks that will be reached within the next
+    /// callbacks at the recent rate are prefetched.
     virtual void hintReader(double dRate,
             gsl::not_null<HintVector*> pHintList,
             mixxx::audio::ChannelCount channelCount);
@@ -121,6 +124,20 @@ class ReadAheadManager {
     void addReadLogEntry(double virtualPlaypositionStart,
                          double virtualPlaypositionEndNonInclusive);
 
+    /// Reads from the loop buffer if it contains the samples, otherwise
+    /// from the caching reader.
+    CachingReader::ReadResult read(SINT startSample,
+            SINT numSamples,
+            bool reverse,
+            CSAMPLE* pOutput,
+            mixxx::audio::ChannelCount channelCount);
+    /// Copies a short loop including the samples before the loop start that
+    /// are needed for the crossfade into the loop buffer, once all of them
+    /// are cached.
+    void maybeFillLoopBuffer(double loopStartSample,
+            double loopEndSample,
+            mixxx::audio::ChannelCount channelCount);
+
     LoopingControl* m_pLoopingControl;
     RateControl* m_pRateControl;
     std::list<ReadLogEntry> m_readAheadLog;
@@ -128,4 +145,23 @@ class ReadAheadManager {
     CachingReader* m_pReader;
     CSAMPLE* m_pCrossFadeBuffer;
     bool m_cacheMissHappened;
+
+    // Short loops like beat rolls are played from this buffer, which avoids
+    // to look up the chunks of the caching reader for every wrap around.
+    // It contains the samples [m_loopBufferStart, m_loopBufferEnd) of the
+    // track, it is empty if both are equal.
+    CSAMPLE* m_pLoopBuffer;
+    SINT m_loopBufferStart;
+    SINT m_loopBufferEnd;
+
+    // The signed number of samples in the read log entries added since the
+    // last hintReader() call, jumps are not included
+    double m_samplesReadSinceHint;
+    // The smoothed samples per callback, for predicting the positions of
+    // the next callbacks
+    double m_samplesPerCallback;
+
+    // The miss rate of the deck is the ratio of these
+    Counter m_readCounter;
+    Counter m_readMissCounter;
 };
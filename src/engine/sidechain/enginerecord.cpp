@@ -1,5 +1,7 @@
 #include "engine/sidechain/enginerecord.h"
 
+#include <QFileInfo>
+
 #include "control/controlproxy.h"
 #include "encoder/encoder.h"
 #include "mixer/playerinfo.h"
@@ -11,8 +13,10 @@
 
 constexpr int kMetaDataLifeTimeout = 16;
 
-EngineRecord::EngineRecord(UserSettingsPointer pConfig)
+EngineRecord::EngineRecord(UserSettingsPointer pConfig,
+        std::shared_ptr<RecordingDiskWriter> pDiskWriter)
         : m_pConfig(pConfig),
+          m_pDiskWriter(std::move(pDiskWriter)),
           m_sampleRateControl(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_frames(0),
           m_recordedDuration(0),
@@ -267,57 +271,45 @@ void EngineRecord::write(const unsigned char *header, const unsigned char *body,
     }
     // Relevant for OGG
     if (headerLen > 0) {
-        m_dataStream.writeRawData((const char*) header, headerLen);
+        m_pFile->write(reinterpret_cast<const char*>(header), headerLen);
     }
     // Always write body
-    m_dataStream.writeRawData((const char*) body, bodyLen);
+    m_pFile->write(reinterpret_cast<const char*>(body), bodyLen);
     emit bytesRecorded((headerLen+bodyLen));
 
 }
 // Encoder calls this method to write compressed audio
-int EngineRecord::tell() {
+qint64 EngineRecord::tell() {
     if (!fileOpen()) {
         return -1;
     }
-    return m_dataStream.device()->pos();
+    return m_pFile->position();
 }
 // Encoder calls this method to write compressed audio
-void EngineRecord::seek(int pos) {
+void EngineRecord::seek(qint64 pos) {
     if (!fileOpen()) {
         return;
     }
-    m_dataStream.device()->seek(static_cast<qint64>(pos));
+    m_pFile->seek(pos);
 }
 // These are not used for streaming, but the interface requires them
-int EngineRecord::filelen() {
+qint64 EngineRecord::filelen() {
     if (!fileOpen()) {
         return 0;
     }
-    return m_dataStream.device()->size();
+    return m_pFile->size();
 }
 
 bool EngineRecord::fileOpen() {
-    return (m_file.handle() != -1);
+    return m_pFile != nullptr;
 }
 
 bool EngineRecord::openFile() {
-    // We can use a QFile to write compressed audio.
-    if (m_pEncoder) {
-        m_file.setFileName(m_fileName);
-        if (!m_file.open(QIODevice::WriteOnly)) {
-            qDebug() << "EngineRecord::openFile() failed for"
-                     << m_fileName
-                     << m_file.errorString();
-            return false;
-        }
-        if (m_file.handle() != -1) {
-            m_dataStream.setDevice(&m_file);
-        }
-    } else {
+    if (!m_pEncoder) {
         return false;
     }
-
-    // Return whether the file is really open.
+    // The failure has been logged by the disk writer
+    m_pFile = m_pDiskWriter->createFile(m_fileName);
     return fileOpen();
 }
 
@@ -366,13 +358,15 @@ bool EngineRecord::openCueFile() {
 }
 
 void EngineRecord::closeFile() {
-    if (m_file.handle() != -1) {
-        // Close QFile and encoder, if open.
+    if (fileOpen()) {
+        // Close file and encoder, if open.
         if (m_pEncoder) {
             m_pEncoder->flush();
             m_pEncoder.reset();
         }
-        m_file.close();
+        // Closed by the disk writer after all pending blocks have been
+        // written, which also reports if that has failed
+        m_pFile.reset();
     }
 }
 
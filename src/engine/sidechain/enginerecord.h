@@ -1,7 +1,7 @@
 #pragma once
 
-#include <QDataStream>
 #include <QFile>
+#include <memory>
 
 #include "audio/types.h"
 #include "control/pollingcontrolproxy.h"
@@ -9,6 +9,7 @@
 #include "encoder/encodercallback.h"
 #include "engine/sidechain/sidechainworker.h"
 #include "preferences/usersettings.h"
+#include "recording/recordingdiskwriter.h"
 #include "track/track_decl.h"
 
 class ControlProxy;
@@ -16,7 +17,8 @@ class ControlProxy;
 class EngineRecord : public QObject, public EncoderCallback, public SideChainWorker {
     Q_OBJECT
   public:
-    EngineRecord(UserSettingsPointer pConfig);
+    EngineRecord(UserSettingsPointer pConfig,
+            std::shared_ptr<RecordingDiskWriter> pDiskWriter);
     ~EngineRecord() override;
 
     void process(const CSAMPLE* pBuffer, const std::size_t bufferSize) override;
@@ -25,11 +27,11 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     // writes compressed audio to file
     void write(const unsigned char *header, const unsigned char *body, int headerLen, int bodyLen) override;
     // gets stream position
-    int tell() override;
+    qint64 tell() override;
     // sets stream position
-    void seek(int pos) override;
+    void seek(qint64 pos) override;
     // gets stream length
-    int filelen()  override;
+    qint64 filelen() override;
 
     // creates or opens an audio file
     bool openFile();
@@ -68,9 +70,10 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     QString m_baAuthor;
     QString m_baAlbum;
 
-    QFile m_file;
+    // Written by a separate thread, so the encoder doesn't wait for the disk
+    const std::shared_ptr<RecordingDiskWriter> m_pDiskWriter;
+    std::unique_ptr<RecordingDiskWriter::File> m_pFile;
     QFile m_cueFile;
-    QDataStream m_dataStream;
 
     PollingControlProxy m_sampleRateControl;
     ControlProxy* m_pRecReady;
@@ -0,0 +1,175 @@
+#include "engine/sidechain/enginerecordtrack.h"
+
+#include <QFileInfo>
+#include <algorithm>
+
+#include "engine/engine.h"
+#include "recording/defs_recording.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineRecordTrack");
+
+constexpr std::uint64_t kChannelCount = mixxx::kEngineChannelOutputCount;
+
+} // anonymous namespace
+
+EngineRecordTrack::EngineRecordTrack(UserSettingsPointer pConfig,
+        const EngineSideChain::ChannelTrack& track,
+        std::shared_ptr<RecordingDiskWriter> pDiskWriter)
+        : m_pConfig(pConfig),
+          m_track(track),
+          m_pDiskWriter(std::move(pDiskWriter)),
+          m_sampleRateControl(QStringLiteral("[App]"), QStringLiteral("samplerate")),
+          m_samplesProcessed(0),
+          m_fileTakeStartFrame(EngineSideChain::kNoFrame),
+          m_failedTakeStartFrame(EngineSideChain::kNoFrame) {
+}
+
+EngineRecordTrack::~EngineRecordTrack() {
+    closeFile();
+}
+
+// static
+QString EngineRecordTrack::trackFileName(
+        const QString& mixFileName, const QString& group) {
+    const QFileInfo mixFileInfo(mixFileName);
+    QString trackName = group;
+    trackName.remove(QChar('[')).remove(QChar(']'));
+    return mixFileInfo.path() + QChar('/') + mixFileInfo.completeBaseName() +
+            QChar('_') + trackName + QChar('.') + mixFileInfo.suffix();
+}
+
+void EngineRecordTrack::process(const CSAMPLE* pBuffer, const std::size_t bufferSize) {
+    // The first call is always preceded by a write of the engine
+    const std::uint64_t firstFrame = m_track.firstFrame();
+    VERIFY_OR_DEBUG_ASSERT(firstFrame != EngineSideChain::kNoFrame) {
+        return;
+    }
+    // Lost samples are replaced by silence, so the frames of the samples
+    // are just counted
+    const std::uint64_t bufferStartFrame = firstFrame + m_samplesProcessed / kChannelCount;
+    const std::uint64_t bufferEndFrame = bufferStartFrame + bufferSize / kChannelCount;
+    m_samplesProcessed += bufferSize;
+
+    const auto [takeStartFrame, takeStopFrame] = m_track.takeFrames();
+    if (m_pFile && takeStartFrame != m_fileTakeStartFrame) {
+        // The next take has started before this track has caught up with
+        // the end of the previous one, which is cut here
+        closeFile();
+    }
+
+    const std::uint64_t recordStartFrame = std::max(bufferStartFrame, takeStartFrame);
+    const std::uint64_t recordEndFrame = std::min(bufferEndFrame, takeStopFrame);
+    if (recordStartFrame < recordEndFrame) {
+        if (!m_pFile && takeStartFrame != m_failedTakeStartFrame) {
+            if (openFile()) {
+                m_fileTakeStartFrame = takeStartFrame;
+            } else {
+                m_failedTakeStartFrame = takeStartFrame;
+            }
+        }
+        if (m_pFile) {
+            m_pEncoder->encodeBuffer(
+                    pBuffer + (recordStartFrame - bufferStartFrame) * kChannelCount,
+                    (recordEndFrame - recordStartFrame) * kChannelCount);
+        }
+    }
+
+    if (m_pFile && bufferEndFrame >= takeStopFrame) {
+        closeFile();
+    }
+}
+
+void EngineRecordTrack::shutdown() {
+    closeFile();
+}
+
+bool EngineRecordTrack::openFile() {
+    const QString mixFileName =
+            m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "Path"));
+    if (mixFileName.isEmpty()) {
+        return false;
+    }
+    const QString fileName = trackFileName(mixFileName, m_track.group());
+
+    const Encoder::Format format = EncoderFactory::getFactory().getSelectedFormat(m_pConfig);
+    m_pEncoder = EncoderFactory::getFactory().createRecordingEncoder(
+            format, m_pConfig, this);
+    if (!m_pEncoder) {
+        return false;
+    }
+    m_pEncoder->updateMetaData(
+            m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "Author")),
+            m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "Title")),
+            m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "Album")));
+
+    m_pFile = m_pDiskWriter->createFile(fileName);
+    if (!m_pFile) {
+        m_pEncoder.reset();
+        return false;
+    }
+    // The encoder writes the header when it is initialized
+    QString userErrorMsg;
+    if (m_pEncoder->initEncoder(
+                mixxx::audio::SampleRate::fromDouble(m_sampleRateControl.get()),
+                &userErrorMsg) < 0) {
+        // The error has been reported for the mix already
+        kLogger.warning() << "Failed to initialize the encoder for" << fileName
+                          << userErrorMsg;
+        m_pEncoder.reset();
+        m_pFile.reset();
+        return false;
+    }
+    kLogger.info() << "Recording" << m_track.group() << "to" << fileName;
+    return true;
+}
+
+void EngineRecordTrack::closeFile() {
+    if (!m_pFile) {
+        return;
+    }
+    if (m_pEncoder) {
+        m_pEncoder->flush();
+        m_pEncoder.reset();
+    }
+    // Closed by the disk writer after all blocks have been written, which
+    // also reports if that has failed
+    m_pFile.reset();
+}
+
+void EngineRecordTrack::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (!m_pFile) {
+        return;
+    }
+    // Relevant for OGG
+    if (headerLen > 0) {
+        m_pFile->write(reinterpret_cast<const char*>(header), headerLen);
+    }
+    m_pFile->write(reinterpret_cast<const char*>(body), bodyLen);
+}
+
+qint64 EngineRecordTrack::tell() {
+    if (!m_pFile) {
+        return -1;
+    }
+    return m_pFile->position();
+}
+
+void EngineRecordTrack::seek(qint64 pos) {
+    if (!m_pFile) {
+        return;
+    }
+    m_pFile->seek(pos);
+}
+
+qint64 EngineRecordTrack::filelen() {
+    if (!m_pFile) {
+        return 0;
+    }
+    return m_pFile->size();
+}
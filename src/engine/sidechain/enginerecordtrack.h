@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+
+#include "control/pollingcontrolproxy.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "engine/sidechain/enginesidechain.h"
+#include "engine/sidechain/sidechainworker.h"
+#include "preferences/usersettings.h"
+#include "recording/recordingdiskwriter.h"
+
+/// Records the pre-fader output of a single channel to a separate file
+/// while the mix is recorded by EngineRecord, e.g. for mixing the decks and
+/// microphones again in post-production.
+///
+/// Each track is encoded by its own sidechain thread, the files of all
+/// tracks are written by a shared RecordingDiskWriter. The tracks are named
+/// after the file of the mix and the group of the channel.
+class EngineRecordTrack : public SideChainWorker, public EncoderCallback {
+  public:
+    EngineRecordTrack(UserSettingsPointer pConfig,
+            const EngineSideChain::ChannelTrack& track,
+            std::shared_ptr<RecordingDiskWriter> pDiskWriter);
+    ~EngineRecordTrack() override;
+
+    void process(const CSAMPLE* pBuffer, const std::size_t bufferSize) override;
+    void shutdown() override;
+
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    qint64 tell() override;
+    void seek(qint64 pos) override;
+    qint64 filelen() override;
+
+    /// The file of the track that is recorded next to the mix file.
+    static QString trackFileName(const QString& mixFileName, const QString& group);
+
+  private:
+    bool openFile();
+    void closeFile();
+
+    const UserSettingsPointer m_pConfig;
+    const EngineSideChain::ChannelTrack& m_track;
+    const std::shared_ptr<RecordingDiskWriter> m_pDiskWriter;
+    PollingControlProxy m_sampleRateControl;
+
+    EncoderPointer m_pEncoder;
+    std::unique_ptr<RecordingDiskWriter::File> m_pFile;
+    // The number of samples that have been passed to process()
+    std::uint64_t m_samplesProcessed;
+    // The take that is recorded into m_pFile
+    std::uint64_t m_fileTakeStartFrame;
+    // Don't retry opening the file for a take that has failed
+    std::uint64_t m_failedTakeStartFrame;
+};
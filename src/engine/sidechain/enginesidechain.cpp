@@ -1,10 +1,9 @@
 // This class provides a way to do audio processing that does not need
 // to be executed in real-time. For example, broadcast encoding
-// and recording encoding can be done here. This class uses double-buffering
-// to increase the amount of time the CPU has to do whatever work needs to
-// be done, and that work is executed in a separate thread. (Threading
-// allows the next buffer to be filled while processing a buffer that's is
-// already full.)
+// and recording encoding can be done here. The engine thread writes the
+// samples into a lock-free ring buffer and never waits. Every worker is
+// fed by its own thread with its own read position, so a worker that
+// falls behind only loses its own samples and does not stall the others.
 
 #include "engine/sidechain/enginesidechain.h"
 
@@ -12,54 +11,155 @@
 
 #include "engine/engine.h"
 #include "engine/sidechain/sidechainworker.h"
-#include "moc_enginesidechain.cpp"
-#include "util/counter.h"
-#include "util/event.h"
+#include "engine/sidechain/sidechainworkerthread.h"
+#include "recording/defs_recording.h"
+#include "util/defs.h"
 #include "util/sample.h"
 #include "util/trace.h"
 
-#define SIDECHAIN_BUFFER_SIZE 65536
+namespace {
+
+// Holds a couple of seconds of audio for each worker to catch up. The workers
+// are woken up long before it is full, see SideChainWorkerThread.
+constexpr SINT kRingBufferSize = 4 * EngineSideChain::SIDECHAIN_BUFFER_SIZE;
+
+constexpr std::uint64_t kWakeUpInterval = EngineSideChain::SIDECHAIN_BUFFER_SIZE / 5;
+
+// For converting the stream positions of the ring buffers into frames
+constexpr std::uint64_t kChannelCount = mixxx::kEngineChannelOutputCount;
+
+} // anonymous namespace
 
 EngineSideChain::EngineSideChain(
         UserSettingsPointer pConfig,
         CSAMPLE* sidechainMix)
         : m_pConfig(pConfig),
-          m_bStopThread(false),
-          m_sampleFifo(SIDECHAIN_BUFFER_SIZE),
-          m_pWorkBuffer(SampleUtil::alloc(SIDECHAIN_BUFFER_SIZE)),
-          m_pSidechainMix(sidechainMix) {
-    // We use HighPriority to prevent starvation by lower-priority processes (Qt
-    // main thread, analysis, etc.). This used to be LowPriority but that is not
-    // a suitable choice since we do semi-realtime tasks
-    // in the sidechain thread. To get reliable timing, it's important
-    // that this work be prioritized over the GUI and non-realtime tasks. See
-    // discussion on issue #7272 and https://bugs.launchpad.net/mixxx/1.11/+bug/1194543.
-    start(QThread::HighPriority);
+          m_ringBuffer(kRingBufferSize),
+          m_lastWakeUpPosition(0),
+          m_pSidechainMix(sidechainMix),
+          m_numChannelTracks(0),
+          m_takeRecording(false),
+          m_silence(kMaxEngineSamples),
+          m_takeStartFrame(kNoFrame),
+          m_takeStopFrame(kNoFrame) {
+    m_silence.clear();
 }
 
 EngineSideChain::~EngineSideChain() {
-    m_waitLock.lock();
-    m_bStopThread = true;
-    m_waitForSamples.wakeAll();
-    m_waitLock.unlock();
-
-    // Wait until the thread has finished.
-    wait();
-
     MMutexLocker locker(&m_workerLock);
+    // Wait until all threads have finished.
+    for (const auto& pThread : m_workerThreads) {
+        pThread->stopProcessing();
+    }
+    m_workerThreads.clear();
+    for (const auto& pThread : m_channelTrackThreads) {
+        pThread->stopProcessing();
+    }
+    m_channelTrackThreads.clear();
+
     while (!m_workers.empty()) {
         SideChainWorker* pWorker = m_workers.takeLast();
         pWorker->shutdown();
         delete pWorker;
     }
-    locker.unlock();
+}
+
+void EngineSideChain::addSideChainWorker(SideChainWorker* pWorker, bool spillToDisk) {
+    MMutexLocker locker(&m_workerLock);
+    m_workers.append(pWorker);
+    auto pThread = std::make_unique<SideChainWorkerThread>(pWorker,
+            &m_ringBuffer,
+            &m_waitLock,
+            &m_waitForSamples,
+            static_cast<int>(m_workerThreads.size()) + 1,
+            spillToDisk);
+    pThread->startProcessing();
+    m_workerThreads.push_back(std::move(pThread));
+}
+
+QVector<std::uint64_t> EngineSideChain::workerLags() {
+    MMutexLocker locker(&m_workerLock);
+    QVector<std::uint64_t> lags;
+    lags.reserve(static_cast<int>(m_workerThreads.size()));
+    for (const auto& pThread : m_workerThreads) {
+        lags.append(pThread->lag());
+    }
+    return lags;
+}
+
+EngineSideChain::ChannelTrack::ChannelTrack(
+        const QString& group, const EngineSideChain* pSideChain)
+        : m_group(group),
+          m_pSideChain(pSideChain),
+          m_ringBuffer(kRingBufferSize),
+          m_firstFrame(kNoFrame) {
+}
+
+std::pair<std::uint64_t, std::uint64_t> EngineSideChain::ChannelTrack::takeFrames() const {
+    const std::uint64_t startFrame =
+            m_pSideChain->m_takeStartFrame.load(std::memory_order_acquire);
+    std::uint64_t stopFrame =
+            m_pSideChain->m_takeStopFrame.load(std::memory_order_acquire);
+    if (stopFrame < startFrame) {
+        // The next take has been started after loading the start
+        stopFrame = kNoFrame;
+    }
+    return {startFrame, stopFrame};
+}
 
-    SampleUtil::free(m_pWorkBuffer);
+void EngineSideChain::setChannelTrackWorkerFactory(
+        const ConfigKey& recordingStatusKey,
+        ChannelTrackWorkerFactory factory) {
+    DEBUG_ASSERT(m_numChannelTracks == 0);
+    m_recordingStatus.emplace(recordingStatusKey);
+    m_channelTrackWorkerFactory = std::move(factory);
 }
 
-void EngineSideChain::addSideChainWorker(SideChainWorker* pWorker) {
+int EngineSideChain::addChannelTrack(const QString& group) {
+    if (!m_channelTrackWorkerFactory) {
+        return -1;
+    }
+    if (m_numChannelTracks >= kMaxChannelTracks) {
+        qWarning() << "EngineSideChain: Not recording a separate track for"
+                   << group << "- only" << kMaxChannelTracks
+                   << "tracks are supported";
+        return -1;
+    }
+    auto pTrack = std::make_unique<ChannelTrack>(group, this);
+    SideChainWorker* pWorker = m_channelTrackWorkerFactory(*pTrack);
+    VERIFY_OR_DEBUG_ASSERT(pWorker) {
+        return -1;
+    }
     MMutexLocker locker(&m_workerLock);
     m_workers.append(pWorker);
+    // Created before the engine writes to the track, so the worker receives
+    // all samples starting with ChannelTrack::firstFrame()
+    auto pThread = std::make_unique<SideChainWorkerThread>(pWorker,
+            &pTrack->m_ringBuffer,
+            &m_waitLock,
+            &m_waitForSamples,
+            static_cast<int>(m_workerThreads.size() + m_channelTrackThreads.size()) + 1,
+            /*spillToDisk*/ false);
+    pThread->startProcessing();
+    m_channelTrackThreads.push_back(std::move(pThread));
+    const int track = m_numChannelTracks++;
+    m_channelTracks[track] = std::move(pTrack);
+    return track;
+}
+
+void EngineSideChain::writeChannelTrackSamples(
+        int track, const CSAMPLE* pBuffer, int iFrames) {
+    DEBUG_ASSERT(track >= 0 && track < kMaxChannelTracks);
+    ChannelTrack* pTrack = m_channelTracks[track].get();
+    DEBUG_ASSERT(pTrack);
+    if (pTrack->m_firstFrame.load(std::memory_order_relaxed) == kNoFrame) {
+        pTrack->m_firstFrame.store(
+                m_ringBuffer.writePosition() / kChannelCount,
+                std::memory_order_release);
+    }
+    const int numSamples = iFrames * mixxx::kEngineChannelOutputCount;
+    DEBUG_ASSERT(numSamples <= m_silence.size());
+    pTrack->m_ringBuffer.write(pBuffer ? pBuffer : m_silence.data(), numSamples);
 }
 
 void EngineSideChain::receiveBuffer(const AudioInput& input,
@@ -78,48 +178,30 @@ void EngineSideChain::writeSamples(const CSAMPLE* pBuffer, int iFrames) {
     Trace sidechain("EngineSideChain::writeSamples");
     // TODO: remove assumption of stereo buffer
     const int numSamples = iFrames * mixxx::kEngineChannelOutputCount;
-    const int numSamplesWritten = m_sampleFifo.write(pBuffer, numSamples);
-
-    if (numSamplesWritten != numSamples) {
-        Counter("EngineSideChain::writeSamples buffer overrun").increment();
+    if (m_recordingStatus) {
+        // The channel tracks start and stop recording at the same frame
+        const bool takeRecording = m_recordingStatus->get() == RECORD_ON;
+        if (takeRecording != m_takeRecording) {
+            m_takeRecording = takeRecording;
+            const std::uint64_t frame =
+                    m_ringBuffer.writePosition() / kChannelCount;
+            if (takeRecording) {
+                m_takeStopFrame.store(kNoFrame, std::memory_order_release);
+                m_takeStartFrame.store(frame, std::memory_order_release);
+            } else {
+                m_takeStopFrame.store(frame, std::memory_order_release);
+            }
+        }
     }
+    // Never blocks, a worker that is too far behind loses the oldest samples
+    m_ringBuffer.write(pBuffer, numSamples);
 
-    if (m_sampleFifo.writeAvailable() < SIDECHAIN_BUFFER_SIZE / 5) {
-        // Signal to the sidechain that samples are available.
+    const std::uint64_t writePosition = m_ringBuffer.writePosition();
+    if (writePosition - m_lastWakeUpPosition >= kWakeUpInterval) {
+        // Signal to the workers that samples are available. Each of them
+        // decides on its own if there is enough to process.
         Trace wakeup("EngineSideChain::writeSamples wake up");
+        m_lastWakeUpPosition = writePosition;
         m_waitForSamples.wakeAll();
     }
 }
-
-void EngineSideChain::run() {
-    // the id of this thread, for debugging purposes //XXX copypasta (should
-    // factor this out somehow), -kousu 2/2009
-    unsigned static id = 0;
-    QThread::currentThread()->setObjectName(QString("EngineSideChain %1").arg(++id));
-    static const QString tag("EngineSideChain");
-    Event::start(tag);
-    while (!m_bStopThread) {
-        // Sleep until samples are available.
-        m_waitLock.lock();
-
-        Event::end(tag);
-        m_waitForSamples.wait(&m_waitLock);
-        m_waitLock.unlock();
-        Event::start(tag);
-
-        int samples_read;
-        while ((samples_read = m_sampleFifo.read(m_pWorkBuffer,
-                                                 SIDECHAIN_BUFFER_SIZE))) {
-            Trace process("EngineSideChain::process");
-            MMutexLocker locker(&m_workerLock);
-            foreach (SideChainWorker* pWorker, m_workers) {
-                pWorker->process(m_pWorkBuffer, samples_read);
-            }
-        }
-
-        // Check to see if we're supposed to exit/stop this thread.
-        if (m_bStopThread) {
-            return;
-        }
-    }
-}
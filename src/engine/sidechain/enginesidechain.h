@@ -1,21 +1,70 @@
 #pragma once
 
-#include <QThread>
+#include <QList>
+#include <QVector>
 #include <QMutex>
 #include <QWaitCondition>
-#include <QList>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
 
+#include "control/pollingcontrolproxy.h"
+#include "engine/sidechain/sidechainringbuffer.h"
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
-#include "util/fifo.h"
 #include "util/mutex.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class SideChainWorker;
+class SideChainWorkerThread;
 
-class EngineSideChain : public QThread, public AudioDestination {
-    Q_OBJECT
+class EngineSideChain : public AudioDestination {
   public:
+    static constexpr std::uint64_t kNoFrame = std::numeric_limits<std::uint64_t>::max();
+
+    /// The pre-fader output of a single channel, e.g. a deck or a
+    /// microphone, that is recorded to a separate file next to the mix.
+    class ChannelTrack {
+      public:
+        ChannelTrack(const QString& group, const EngineSideChain* pSideChain);
+
+        const QString& group() const {
+            return m_group;
+        }
+
+        /// The sidechain frame of the first sample that is passed to the
+        /// worker of this track, i.e. the frame of the mix that has been
+        /// written at the same time. kNoFrame until the engine has written
+        /// to the track.
+        std::uint64_t firstFrame() const {
+            return m_firstFrame.load(std::memory_order_acquire);
+        }
+
+        /// The sidechain frames [start, stop) of the current or the last
+        /// take. The stop is kNoFrame while recording and both are kNoFrame
+        /// before the first take. Shared by all tracks, so they are sample
+        /// aligned with each other.
+        std::pair<std::uint64_t, std::uint64_t> takeFrames() const;
+
+      private:
+        friend class EngineSideChain;
+
+        const QString m_group;
+        const EngineSideChain* const m_pSideChain;
+        SideChainRingBuffer m_ringBuffer;
+        std::atomic<std::uint64_t> m_firstFrame;
+    };
+
+    /// Creates the worker that records a channel track. The worker is owned
+    /// by the sidechain, the track outlives it.
+    using ChannelTrackWorkerFactory =
+            std::function<SideChainWorker*(const ChannelTrack& track)>;
+
     EngineSideChain(UserSettingsPointer pConfig, CSAMPLE* sidechainMix);
     ~EngineSideChain() override;
 
@@ -30,28 +79,71 @@ class EngineSideChain : public QThread, public AudioDestination {
             const CSAMPLE* pBuffer,
             unsigned int iFrames) override;
 
-    // Thread-safe, blocking.
-    void addSideChainWorker(SideChainWorker* pWorker);
+    // Thread-safe, blocking. Takes ownership of the worker and starts a
+    // thread that feeds it. With spillToDisk the samples are buffered in a
+    // temporary file, so a slow worker never loses samples.
+    void addSideChainWorker(SideChainWorker* pWorker, bool spillToDisk = false);
+
+    // Thread-safe, blocking. The number of samples each worker is behind
+    // the engine, in the order the workers have been added.
+    QVector<std::uint64_t> workerLags();
+
+    // Not thread-safe, must be called before adding channels. Enables
+    // recording a separate track for channels, see addChannelTrack().
+    // All tracks are recorded while recordingStatusKey is RECORD_ON.
+    void setChannelTrackWorkerFactory(
+            const ConfigKey& recordingStatusKey,
+            ChannelTrackWorkerFactory factory);
 
+    // Not thread-safe, must be called by the same thread that adds channels
+    // to the engine, before the engine processes the channel. Creates a
+    // ring buffer for the channel and a thread that feeds it to a new
+    // worker. Returns the index of the track or -1 if no channel tracks are
+    // recorded.
+    int addChannelTrack(const QString& group);
+
+    // Not thread-safe, wait-free. Submits the buffer of a channel track, or
+    // silence if pBuffer is null, from the engine callback. Must be called
+    // for all tracks in each callback before writeSamples().
+    void writeChannelTrackSamples(int track, const CSAMPLE* pBuffer, int iFrames);
+
+    // The maximum number of samples passed to SideChainWorker::process()
     static constexpr int SIDECHAIN_BUFFER_SIZE = 65536;
 
   private:
-    void run() override;
-
     UserSettingsPointer m_pConfig;
-    // Indicates that the thread should exit.
-    volatile bool m_bStopThread;
 
-    FIFO<CSAMPLE> m_sampleFifo;
-    CSAMPLE* m_pWorkBuffer;
+    // Shared by all workers, each of them reads with its own cursor.
+    SideChainRingBuffer m_ringBuffer;
+    // Only accessed by the writer thread
+    std::uint64_t m_lastWakeUpPosition;
     CSAMPLE* m_pSidechainMix;
 
     // Provides thread safety around the wait condition below.
     QMutex m_waitLock;
-    // Allows sleeping until we have samples to process.
+    // Allows the worker threads to sleep until we have samples to process.
     QWaitCondition m_waitForSamples;
 
     // Sidechain workers registered with EngineSideChain.
     MMutex m_workerLock;
     QList<SideChainWorker*> m_workers GUARDED_BY(m_workerLock);
+    std::vector<std::unique_ptr<SideChainWorkerThread>> m_workerThreads
+            GUARDED_BY(m_workerLock);
+
+    // The workers of the channel tracks are not included in workerLags(),
+    // which only reports the consumers of the mix
+    static constexpr int kMaxChannelTracks = 16;
+    ChannelTrackWorkerFactory m_channelTrackWorkerFactory;
+    // Never reallocated, the engine thread accesses the tracks by index
+    std::array<std::unique_ptr<ChannelTrack>, kMaxChannelTracks> m_channelTracks;
+    int m_numChannelTracks;
+    std::vector<std::unique_ptr<SideChainWorkerThread>> m_channelTrackThreads
+            GUARDED_BY(m_workerLock);
+    // Only accessed by the writer thread
+    std::optional<PollingControlProxy> m_recordingStatus;
+    bool m_takeRecording;
+    mixxx::SampleBuffer m_silence;
+    // Published by the writer thread, see ChannelTrack::takeFrames()
+    std::atomic<std::uint64_t> m_takeStartFrame;
+    std::atomic<std::uint64_t> m_takeStopFrame;
 };
@@ -55,11 +55,17 @@ class NetworkOutputStreamWorker {
     virtual void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo);
     virtual QSharedPointer<FIFO<CSAMPLE>> getOutputFifo();
 
-    void startStream(mixxx::audio::SampleRate sampleRate,
+    virtual void startStream(mixxx::audio::SampleRate sampleRate,
             mixxx::audio::ChannelCount numOutputChannels);
-    void stopStream();
+    virtual void stopStream();
 
     virtual bool threadWaiting();
+    /// Returns true if the worker is woken up by outputAvailable() for every
+    /// chunk that is written to its FIFO, instead of once the FIFO holds the
+    /// latency the broadcast encoders need.
+    virtual bool lowLatency() const {
+        return false;
+    }
 
     qint64 getStreamTimeUs();
     qint64 getStreamTimeFrames();
@@ -0,0 +1,288 @@
+#include "engine/sidechain/rtpoutputstreamworker.h"
+
+#include <QRandomGenerator>
+#include <QUdpSocket>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <limits>
+
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/realtime.h"
+
+namespace {
+
+const mixxx::Logger kLogger("RtpOutputStreamWorker");
+
+const QString kConfigGroup = QStringLiteral("[RtpOutput]");
+
+// The default of AES67 for the L24 payload of dynamic type
+constexpr int kDefaultPayloadType = 98;
+constexpr int kDefaultPacketTimeUs = 1000;
+constexpr int kDefaultPort = 5004;
+const QString kDefaultAddress = QStringLiteral("239.69.0.1");
+
+// Keep the packets below the Ethernet MTU, including IP and UDP headers
+constexpr int kMaxPacketSize = 1440;
+
+// Wakes up the thread to check for a stop request if no samples arrive
+constexpr int kIdlePollMillis = 100;
+
+// The timestamps are compared with the media clock this often. The lowest
+// lag of an interval is only delayed by the sound device, not by the
+// scheduling of the thread.
+constexpr mixxx::Duration kAlignmentInterval = mixxx::Duration::fromSeconds(1);
+// Far below the link offsets of AES67 receivers, which are at least 1 ms
+constexpr double kMaxTimestampDriftSeconds = 0.00025;
+
+#ifndef __LINUX__
+// TAI is ahead of UTC by the leap seconds since 1972
+constexpr qint64 kTaiUtcOffsetSeconds = 37;
+#endif
+
+} // namespace
+
+RtpOutputStreamWorker::RtpOutputStreamWorker(UserSettingsPointer pConfig)
+        : m_pConfig(pConfig),
+          m_port(kDefaultPort),
+          m_ttl(16),
+          m_pSocket(nullptr),
+          m_bTimestampInitialized(false),
+          m_minLagFrames(std::numeric_limits<qint32>::max()),
+          m_referenceLagFrames(0),
+          m_bReferenceLagValid(false),
+          m_threadWaiting(false),
+          m_stopRequested(false),
+          m_packetsSent(0),
+          m_sendErrors(0) {
+}
+
+RtpOutputStreamWorker::~RtpOutputStreamWorker() {
+    stopThread();
+}
+
+// static
+bool RtpOutputStreamWorker::isEnabled(UserSettingsPointer pConfig) {
+    return pConfig->getValue(ConfigKey(kConfigGroup, QStringLiteral("enabled")), false);
+}
+
+// static
+quint32 RtpOutputStreamWorker::mediaClockTimestamp(mixxx::audio::SampleRate sampleRate) {
+    qint64 seconds;
+    qint64 nanos;
+#ifdef __LINUX__
+    // Equals CLOCK_REALTIME, unless the TAI offset of the kernel is set,
+    // which ptp4l and phc2sys do
+    struct timespec ts;
+    clock_gettime(CLOCK_TAI, &ts);
+    seconds = ts.tv_sec;
+    nanos = ts.tv_nsec;
+#else
+    const auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+    const auto wholeSeconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+    seconds = wholeSeconds.count() + kTaiUtcOffsetSeconds;
+    nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            sinceEpoch - wholeSeconds)
+                    .count();
+#endif
+    const auto rate = static_cast<quint64>(sampleRate.value());
+    const quint64 frames = static_cast<quint64>(seconds) * rate +
+            static_cast<quint64>(nanos) * rate / 1000000000;
+    return static_cast<quint32>(frames);
+}
+
+void RtpOutputStreamWorker::startStream(mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount numOutputChannels) {
+    // Called again when the network sound device is opened
+    stopThread();
+    NetworkOutputStreamWorker::startStream(sampleRate, numOutputChannels);
+    m_sampleRate = sampleRate;
+    m_channelCount = numOutputChannels;
+    if (!sampleRate.isValid() || !numOutputChannels.isValid()) {
+        return;
+    }
+
+    const QString address = m_pConfig->getValue(
+            ConfigKey(kConfigGroup, QStringLiteral("address")), kDefaultAddress);
+    if (!m_address.setAddress(address)) {
+        kLogger.warning() << "Invalid address" << address;
+        setState(NETWORKSTREAMWORKER_STATE_ERROR);
+        return;
+    }
+    m_port = static_cast<quint16>(m_pConfig->getValue(
+            ConfigKey(kConfigGroup, QStringLiteral("port")), kDefaultPort));
+    m_ttl = m_pConfig->getValue(ConfigKey(kConfigGroup, QStringLiteral("ttl")), 16);
+    const int payloadType = math_clamp(
+            m_pConfig->getValue(ConfigKey(kConfigGroup, QStringLiteral("payload_type")),
+                    kDefaultPayloadType),
+            96,
+            127);
+    const int packetTimeUs = math_max(1,
+            m_pConfig->getValue(ConfigKey(kConfigGroup, QStringLiteral("packet_time_us")),
+                    kDefaultPacketTimeUs));
+    const auto maxFramesPerPacket = static_cast<SINT>(
+            (kMaxPacketSize - RtpPacketizer::kHeaderSize) /
+            (numOutputChannels * RtpPacketizer::kBytesPerSample));
+    SINT framesPerPacket = math_max<SINT>(1,
+            static_cast<SINT>(std::lround(sampleRate.toDouble() * packetTimeUs / 1000000)));
+    if (framesPerPacket > maxFramesPerPacket) {
+        kLogger.warning() << "Packet time of" << packetTimeUs
+                          << "us exceeds the MTU, sending" << maxFramesPerPacket
+                          << "frames per packet";
+        framesPerPacket = maxFramesPerPacket;
+    }
+
+    m_pPacketizer = std::make_unique<RtpPacketizer>(payloadType,
+            QRandomGenerator::global()->generate(),
+            numOutputChannels,
+            framesPerPacket);
+    m_bTimestampInitialized = false;
+    m_bReferenceLagValid = false;
+    m_minLagFrames = std::numeric_limits<qint32>::max();
+
+    kLogger.info() << "Sending" << numOutputChannels << "channels L24 with"
+                   << framesPerPacket << "frames per packet to" << m_address.toString()
+                   << m_port;
+    m_stopRequested.store(false, std::memory_order_relaxed);
+    start(QThread::HighPriority);
+}
+
+void RtpOutputStreamWorker::stopStream() {
+    // The thread is the only user of the socket and the packetizer
+    stopThread();
+    NetworkOutputStreamWorker::stopStream();
+    setState(NETWORKSTREAMWORKER_STATE_DISCONNECTED);
+    m_pPacketizer.reset();
+}
+
+void RtpOutputStreamWorker::stopThread() {
+    m_stopRequested.store(true, std::memory_order_release);
+    m_readSema.release();
+    wait();
+    // Drop the wake ups that have not been consumed
+    m_readSema.tryAcquire(m_readSema.available());
+}
+
+void RtpOutputStreamWorker::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("RtpOutput"));
+    mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::SideChain);
+
+    VERIFY_OR_DEBUG_ASSERT(m_pOutputFifo && m_pPacketizer) {
+        return;
+    }
+
+    // Created by the thread that writes it. It never receives, so it does
+    // not depend on an event loop.
+    QUdpSocket socket;
+    if (m_address.isMulticast()) {
+        socket.setSocketOption(QAbstractSocket::MulticastTtlOption, m_ttl);
+    }
+    if (!socket.bind(QHostAddress(m_address.protocol() == QAbstractSocket::IPv6Protocol
+                                 ? QHostAddress::AnyIPv6
+                                 : QHostAddress::AnyIPv4))) {
+        kLogger.warning() << "Failed to bind the socket:" << socket.errorString();
+        setState(NETWORKSTREAMWORKER_STATE_ERROR);
+        return;
+    }
+    m_pSocket = &socket;
+    setState(NETWORKSTREAMWORKER_STATE_CONNECTED);
+
+    m_threadWaiting.store(true, std::memory_order_release);
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+        if (m_readSema.tryAcquire(1, kIdlePollMillis)) {
+            processOutputFifo();
+        }
+    }
+    m_threadWaiting.store(false, std::memory_order_release);
+    m_pSocket = nullptr;
+}
+
+void RtpOutputStreamWorker::processOutputFifo() {
+    const int readAvailable = m_pOutputFifo->readAvailable();
+    if (readAvailable <= 0) {
+        return;
+    }
+    CSAMPLE* dataPtr1;
+    ring_buffer_size_t size1;
+    CSAMPLE* dataPtr2;
+    ring_buffer_size_t size2;
+    // We use size1 and size2, so we can ignore the return value
+    (void)m_pOutputFifo->aquireReadRegions(readAvailable, &dataPtr1, &size1, &dataPtr2, &size2);
+    process(dataPtr1, size1);
+    if (size2 > 0) {
+        process(dataPtr2, size2);
+    }
+    m_pOutputFifo->releaseReadRegions(readAvailable);
+    alignTimestamps();
+}
+
+void RtpOutputStreamWorker::process(const CSAMPLE* pBuffer, const std::size_t bufferSize) {
+    if (getState() != NETWORKSTREAMWORKER_STATE_CONNECTED || !m_pSocket) {
+        return;
+    }
+    if (!m_bTimestampInitialized) {
+        m_pPacketizer->restart(mediaClockTimestamp(m_sampleRate));
+        m_bTimestampInitialized = true;
+        m_alignmentTimer.start();
+    }
+    const auto numFrames = static_cast<SINT>(bufferSize / m_channelCount);
+    m_pPacketizer->process(pBuffer, numFrames, [this](const char* pData, int size) {
+        if (m_pSocket->writeDatagram(pData, size, m_address, m_port) == size) {
+            m_packetsSent.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_sendErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+}
+
+void RtpOutputStreamWorker::alignTimestamps() {
+    if (!m_bTimestampInitialized) {
+        return;
+    }
+    // The pending frames have just been produced. The RTP timestamps wrap
+    // around, the signed difference does not.
+    const auto lagFrames = static_cast<qint32>(mediaClockTimestamp(m_sampleRate) -
+            static_cast<quint32>(m_pPacketizer->pendingFrames()) -
+            m_pPacketizer->timestamp());
+    m_minLagFrames = math_min(m_minLagFrames, lagFrames);
+    if (m_alignmentTimer.elapsed() < kAlignmentInterval) {
+        return;
+    }
+    m_alignmentTimer.start();
+    if (!m_bReferenceLagValid) {
+        m_referenceLagFrames = m_minLagFrames;
+        m_bReferenceLagValid = true;
+    } else {
+        const qint32 driftFrames = m_minLagFrames - m_referenceLagFrames;
+        const auto maxDriftFrames = static_cast<qint32>(
+                m_sampleRate.toDouble() * kMaxTimestampDriftSeconds);
+        if (std::abs(driftFrames) > maxDriftFrames) {
+            kLogger.debug() << "Realigning the timestamps with the media clock by"
+                            << driftFrames << "frames";
+            m_pPacketizer->shiftTimestamp(driftFrames);
+        }
+    }
+    m_minLagFrames = std::numeric_limits<qint32>::max();
+}
+
+void RtpOutputStreamWorker::shutdown() {
+    stopThread();
+    setState(NETWORKSTREAMWORKER_STATE_DISCONNECTED);
+}
+
+void RtpOutputStreamWorker::outputAvailable() {
+    m_readSema.release();
+}
+
+void RtpOutputStreamWorker::setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) {
+    m_pOutputFifo = pOutputFifo;
+}
+
+QSharedPointer<FIFO<CSAMPLE>> RtpOutputStreamWorker::getOutputFifo() {
+    return m_pOutputFifo;
+}
+
+bool RtpOutputStreamWorker::threadWaiting() {
+    return m_threadWaiting.load(std::memory_order_acquire);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QHostAddress>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThread>
+#include <atomic>
+#include <memory>
+
+#include "engine/sidechain/networkoutputstreamworker.h"
+#include "engine/sidechain/rtppacketizer.h"
+#include "preferences/usersettings.h"
+#include "util/fifo.h"
+#include "util/performancetimer.h"
+
+class QUdpSocket;
+
+/// Sends the stream of the network sound device as uncompressed PCM over
+/// RTP/UDP, e.g. to a stage DSP that receives AES67 streams.
+///
+/// Like the broadcast workers, the worker reads the output FIFO from its own
+/// thread, which is woken up for every chunk the network sound device writes.
+/// The samples are converted from the FIFO straight into the packets, so the
+/// FIFO is the only additional copy of the stream. The sound device fills
+/// underflows with silence, which is sent like any other samples.
+///
+/// The RTP timestamps follow the media clock of AES67, i.e. the frames since
+/// the PTP epoch. They are only aligned with the receivers if the system
+/// clock is synchronized with the PTP grandmaster, e.g. with phc2sys. The
+/// stream is produced by the clock of the sound card, so the timestamps are
+/// realigned with the media clock when they drift apart.
+///
+/// Configured in the [RtpOutput] group:
+/// enabled, address, port, packet_time_us, payload_type and ttl.
+class RtpOutputStreamWorker : public QThread, public NetworkOutputStreamWorker {
+  public:
+    explicit RtpOutputStreamWorker(UserSettingsPointer pConfig);
+    ~RtpOutputStreamWorker() override;
+
+    static bool isEnabled(UserSettingsPointer pConfig);
+
+    void startStream(mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount numOutputChannels) override;
+    void stopStream() override;
+
+    /// Called by the thread of the worker for the samples read from the FIFO
+    void process(const CSAMPLE* pBuffer, const std::size_t bufferSize) override;
+    void shutdown() override;
+
+    void outputAvailable() override;
+    void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) override;
+    QSharedPointer<FIFO<CSAMPLE>> getOutputFifo() override;
+    bool threadWaiting() override;
+    bool lowLatency() const override {
+        return true;
+    }
+
+    quint64 packetsSent() const {
+        return m_packetsSent.load(std::memory_order_relaxed);
+    }
+    quint64 sendErrors() const {
+        return m_sendErrors.load(std::memory_order_relaxed);
+    }
+
+    /// The AES67 media clock in frames since the PTP epoch, truncated to the
+    /// 32 bit RTP timestamp.
+    static quint32 mediaClockTimestamp(mixxx::audio::SampleRate sampleRate);
+
+  protected:
+    void run() override;
+
+  private:
+    void stopThread();
+    void processOutputFifo();
+    /// Compares the timestamps with the media clock and shifts them if they
+    /// have drifted apart by more than kMaxTimestampDrift.
+    void alignTimestamps();
+
+    UserSettingsPointer m_pConfig;
+    QSharedPointer<FIFO<CSAMPLE>> m_pOutputFifo;
+    QHostAddress m_address;
+    quint16 m_port;
+    int m_ttl;
+    mixxx::audio::SampleRate m_sampleRate;
+    mixxx::audio::ChannelCount m_channelCount;
+    std::unique_ptr<RtpPacketizer> m_pPacketizer;
+
+    // Only used by the thread of the worker
+    QUdpSocket* m_pSocket;
+    bool m_bTimestampInitialized;
+    PerformanceTimer m_alignmentTimer;
+    // The lowest lag of the timestamps behind the media clock since the last
+    // alignment, which excludes the scheduling delays of the thread
+    qint32 m_minLagFrames;
+    // The lag of the first interval, which is kept
+    qint32 m_referenceLagFrames;
+    bool m_bReferenceLagValid;
+
+    QSemaphore m_readSema;
+    std::atomic<bool> m_threadWaiting;
+    std::atomic<bool> m_stopRequested;
+    std::atomic<quint64> m_packetsSent;
+    std::atomic<quint64> m_sendErrors;
+};
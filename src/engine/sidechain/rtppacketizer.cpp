@@ -0,0 +1,80 @@
+#include "engine/sidechain/rtppacketizer.h"
+
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr int kRtpVersion = 2;
+
+// The largest 24 bit sample, CSAMPLE_PEAK maps to it
+constexpr double kL24Peak = 8388607.0;
+
+} // namespace
+
+RtpPacketizer::RtpPacketizer(int payloadType,
+        quint32 ssrc,
+        mixxx::audio::ChannelCount channelCount,
+        SINT framesPerPacket)
+        : m_payloadType(payloadType),
+          m_ssrc(ssrc),
+          m_channelCount(channelCount),
+          m_framesPerPacket(framesPerPacket),
+          m_packet(kHeaderSize + framesPerPacket * channelCount * kBytesPerSample),
+          m_pendingFrames(0),
+          m_sequenceNumber(0),
+          m_timestamp(0) {
+    DEBUG_ASSERT(payloadType >= 0 && payloadType < 128);
+    DEBUG_ASSERT(framesPerPacket > 0);
+    writeHeader();
+}
+
+void RtpPacketizer::restart(quint32 timestamp) {
+    m_pendingFrames = 0;
+    m_timestamp = timestamp;
+    writeHeader();
+}
+
+void RtpPacketizer::shiftTimestamp(qint32 frames) {
+    m_timestamp += static_cast<quint32>(frames);
+    writeHeader();
+}
+
+void RtpPacketizer::encode(const CSAMPLE* pBuffer, SINT numFrames) {
+    const SINT numSamples = numFrames * m_channelCount;
+    char* pOut = &m_packet[kHeaderSize +
+            m_pendingFrames * m_channelCount * kBytesPerSample];
+    for (SINT i = 0; i < numSamples; ++i) {
+        const auto value = static_cast<qint32>(std::lrint(
+                SampleUtil::clampSample(pBuffer[i]) * kL24Peak));
+        pOut[i * kBytesPerSample] = static_cast<char>((value >> 16) & 0xff);
+        pOut[i * kBytesPerSample + 1] = static_cast<char>((value >> 8) & 0xff);
+        pOut[i * kBytesPerSample + 2] = static_cast<char>(value & 0xff);
+    }
+    m_pendingFrames += numFrames;
+}
+
+void RtpPacketizer::nextPacket() {
+    m_pendingFrames = 0;
+    ++m_sequenceNumber;
+    m_timestamp += static_cast<quint32>(m_framesPerPacket);
+    writeHeader();
+}
+
+void RtpPacketizer::writeHeader() {
+    // No padding, extension, CSRCs or marker
+    m_packet[0] = static_cast<char>(kRtpVersion << 6);
+    m_packet[1] = static_cast<char>(m_payloadType & 0x7f);
+    m_packet[2] = static_cast<char>(m_sequenceNumber >> 8);
+    m_packet[3] = static_cast<char>(m_sequenceNumber & 0xff);
+    m_packet[4] = static_cast<char>(m_timestamp >> 24);
+    m_packet[5] = static_cast<char>((m_timestamp >> 16) & 0xff);
+    m_packet[6] = static_cast<char>((m_timestamp >> 8) & 0xff);
+    m_packet[7] = static_cast<char>(m_timestamp & 0xff);
+    m_packet[8] = static_cast<char>(m_ssrc >> 24);
+    m_packet[9] = static_cast<char>((m_ssrc >> 16) & 0xff);
+    m_packet[10] = static_cast<char>((m_ssrc >> 8) & 0xff);
+    m_packet[11] = static_cast<char>(m_ssrc & 0xff);
+}
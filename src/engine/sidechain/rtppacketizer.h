@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/math.h"
+#include "util/types.h"
+
+/// Splits an interleaved stream into RTP packets with uncompressed 24 bit
+/// big-endian PCM (L24, RFC 3190), like AES67 receivers expect it.
+///
+/// The samples are converted directly into the packet, which is the only
+/// copy of the stream. A packet that is not full yet is kept until the next
+/// call of process().
+class RtpPacketizer {
+  public:
+    static constexpr int kHeaderSize = 12;
+    static constexpr int kBytesPerSample = 3;
+
+    RtpPacketizer(int payloadType,
+            quint32 ssrc,
+            mixxx::audio::ChannelCount channelCount,
+            SINT framesPerPacket);
+
+    SINT framesPerPacket() const {
+        return m_framesPerPacket;
+    }
+    int packetSize() const {
+        return static_cast<int>(m_packet.size());
+    }
+
+    /// The RTP timestamp of the first frame of the next packet, which counts
+    /// frames of the media clock.
+    quint32 timestamp() const {
+        return m_timestamp;
+    }
+    quint16 sequenceNumber() const {
+        return m_sequenceNumber;
+    }
+    /// The frames of the next packet that have been encoded already
+    SINT pendingFrames() const {
+        return m_pendingFrames;
+    }
+
+    /// Drops the pending frames and continues the stream at the given
+    /// media clock time.
+    void restart(quint32 timestamp);
+
+    /// Moves the timestamps of the stream by the given number of frames,
+    /// starting with the next packet, to follow the media clock. The pending
+    /// frames are kept.
+    void shiftTimestamp(qint32 frames);
+
+    /// Calls sendPacket(const char* pData, int size) for every completed
+    /// packet.
+    template<typename SendPacket>
+    void process(const CSAMPLE* pBuffer, SINT numFrames, SendPacket&& sendPacket) {
+        while (numFrames > 0) {
+            const SINT frames = math_min(numFrames, m_framesPerPacket - m_pendingFrames);
+            encode(pBuffer, frames);
+            pBuffer += frames * m_channelCount;
+            numFrames -= frames;
+            if (m_pendingFrames == m_framesPerPacket) {
+                sendPacket(m_packet.data(), packetSize());
+                nextPacket();
+            }
+        }
+    }
+
+  private:
+    void encode(const CSAMPLE* pBuffer, SINT numFrames);
+    void nextPacket();
+    void writeHeader();
+
+    const int m_payloadType;
+    const quint32 m_ssrc;
+    const mixxx::audio::ChannelCount m_channelCount;
+    const SINT m_framesPerPacket;
+    std::vector<char> m_packet;
+    SINT m_pendingFrames;
+    quint16 m_sequenceNumber;
+    quint32 m_timestamp;
+};
@@ -0,0 +1,191 @@
+#include "engine/sidechain/sharedbroadcastencoder.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/counter.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedBroadcastEncoder");
+
+// Same limit as the network cache of a single connection: 10 s mp3 @ 192 kbit/s
+constexpr int kMaxQueuedBytes = 491520;
+
+QMutex s_registryMutex;
+QHash<QString, std::weak_ptr<SharedBroadcastEncoder>> s_registry;
+
+} // namespace
+
+SharedBroadcastEncoder::SharedBroadcastEncoder(const QString& key)
+        : m_key(key),
+          m_encodedSamples(0) {
+}
+
+SharedBroadcastEncoder::~SharedBroadcastEncoder() {
+    {
+        // Destroying the encoder might flush remaining data via write()
+        QMutexLocker locker(&m_encoderMutex);
+        m_pEncoder.reset();
+    }
+
+    QMutexLocker locker(&s_registryMutex);
+    auto it = s_registry.find(m_key);
+    // A new encoder might have been registered for the same key already
+    if (it != s_registry.end() && it.value().expired()) {
+        s_registry.erase(it);
+    }
+}
+
+// static
+QString SharedBroadcastEncoder::sharingKey(const EncoderSettings& settings,
+        mixxx::audio::SampleRate sampleRate) {
+    const QString format = settings.getFormat();
+    if (format != QLatin1String(ENCODING_MP3) &&
+            format != QLatin1String(ENCODING_AAC) &&
+            format != QLatin1String(ENCODING_HEAAC) &&
+            format != QLatin1String(ENCODING_HEAACV2)) {
+        return QString();
+    }
+    return QStringLiteral("%1/%2/%3/%4")
+            .arg(format,
+                    QString::number(settings.getQuality()),
+                    QString::number(static_cast<int>(settings.getChannelMode())),
+                    QString::number(sampleRate.value()));
+}
+
+// static
+std::shared_ptr<SharedBroadcastEncoder> SharedBroadcastEncoder::subscribe(
+        const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate,
+        const void* pSubscriber,
+        QString* pUserErrorMessage) {
+    const QString key = sharingKey(*pSettings, sampleRate);
+    VERIFY_OR_DEBUG_ASSERT(!key.isEmpty()) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&s_registryMutex);
+    std::shared_ptr<SharedBroadcastEncoder> pShared = s_registry.value(key).lock();
+    if (!pShared) {
+        // The constructor is private, std::make_shared can't be used
+        pShared = std::shared_ptr<SharedBroadcastEncoder>(new SharedBroadcastEncoder(key));
+        pShared->m_pEncoder = EncoderFactory::getFactory().createEncoder(
+                pSettings, pShared.get());
+        if (!pShared->m_pEncoder ||
+                pShared->m_pEncoder->initEncoder(sampleRate, pUserErrorMessage) < 0) {
+            // The destructor locks the registry
+            locker.unlock();
+            return nullptr;
+        }
+        s_registry.insert(key, pShared);
+        kLogger.debug() << "Created shared encoder" << key;
+    } else {
+        kLogger.debug() << "Sharing encoder" << key;
+    }
+    locker.unlock();
+
+    // The new subscriber continues the stream at the encoded position
+    QMutexLocker encoderLocker(&pShared->m_encoderMutex);
+    QMutexLocker subscriptionLocker(&pShared->m_subscriptionMutex);
+    pShared->m_subscriptions.append(
+            Subscription{pSubscriber, pShared->m_encodedSamples, QByteArray()});
+    return pShared;
+}
+
+void SharedBroadcastEncoder::unsubscribe(const void* pSubscriber) {
+    QMutexLocker locker(&m_subscriptionMutex);
+    for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it) {
+        if (it->pSubscriber == pSubscriber) {
+            m_subscriptions.erase(it);
+            break;
+        }
+    }
+}
+
+void SharedBroadcastEncoder::encodeBuffer(const void* pSubscriber,
+        const CSAMPLE* pBuffer,
+        const std::size_t bufferSize) {
+    // Held while encoding, so the samples are encoded in the order of
+    // their stream positions
+    QMutexLocker encoderLocker(&m_encoderMutex);
+    qint64 startSamples;
+    {
+        QMutexLocker locker(&m_subscriptionMutex);
+        Subscription* pSubscription = nullptr;
+        qint64 maxInputSamples = 0;
+        for (auto& subscription : m_subscriptions) {
+            if (subscription.pSubscriber == pSubscriber) {
+                pSubscription = &subscription;
+            }
+            maxInputSamples = std::max(maxInputSamples, subscription.inputSamples);
+        }
+        VERIFY_OR_DEBUG_ASSERT(pSubscription) {
+            return;
+        }
+        if (maxInputSamples < m_encodedSamples &&
+                pSubscription->inputSamples == maxInputSamples) {
+            // The subscribers that have encoded the previous samples are gone
+            kLogger.debug() << "Continuing" << m_key << "after"
+                            << m_encodedSamples - pSubscription->inputSamples
+                            << "samples";
+            pSubscription->inputSamples = m_encodedSamples;
+        }
+        startSamples = pSubscription->inputSamples;
+        pSubscription->inputSamples += static_cast<qint64>(bufferSize);
+    }
+
+    const qint64 endSamples = startSamples + static_cast<qint64>(bufferSize);
+    if (endSamples <= m_encodedSamples) {
+        // Another subscriber has encoded the same samples already
+        return;
+    }
+    // Only the part beyond the encoded position, the positions of all
+    // subscribers are aligned to frames
+    const auto offset = static_cast<std::size_t>(
+            std::max<qint64>(0, m_encodedSamples - startSamples));
+    m_encodedSamples = endSamples;
+
+    // The encoded frames are received by the write() callback.
+    if (m_pEncoder) {
+        m_pEncoder->encodeBuffer(pBuffer + offset, bufferSize - offset);
+    }
+}
+
+QByteArray SharedBroadcastEncoder::takeEncoded(const void* pSubscriber) {
+    QMutexLocker locker(&m_subscriptionMutex);
+    for (auto& subscription : m_subscriptions) {
+        if (subscription.pSubscriber == pSubscriber) {
+            QByteArray encoded;
+            encoded.swap(subscription.encoded);
+            return encoded;
+        }
+    }
+    return QByteArray();
+}
+
+void SharedBroadcastEncoder::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    QMutexLocker locker(&m_subscriptionMutex);
+    for (auto& subscription : m_subscriptions) {
+        if (subscription.encoded.size() + headerLen + bodyLen > kMaxQueuedBytes) {
+            // The connection does not send its data, MP3 and AAC decoders
+            // resynchronize on the next frame. This only affects the
+            // listeners of this connection.
+            Counter("SharedBroadcastEncoder queue overflow").increment();
+            kLogger.warning() << "Dropping" << subscription.encoded.size()
+                              << "bytes that have not been sent by a connection of"
+                              << m_key;
+            subscription.encoded.clear();
+        }
+        if (headerLen > 0) {
+            subscription.encoded.append(reinterpret_cast<const char*>(header), headerLen);
+        }
+        subscription.encoded.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <memory>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "encoder/encodersettings.h"
+#include "util/types.h"
+
+/// An encoder that is shared by all broadcast connections with identical
+/// encoder settings.
+///
+/// All connections receive the same mix from the sidechain, each through the
+/// FIFO of its own thread. Every subscriber counts the samples it delivers,
+/// and whichever subscriber first delivers the samples at a stream position
+/// encodes them. The encoded data is appended to a bounded queue of every
+/// subscriber, which sends it to the server from its own thread. A stalled
+/// server only stalls the thread of its connection, which neither encodes
+/// nor holds any lock meanwhile, so the other connections continue.
+///
+/// Only formats without per-stream headers or in-band metadata can be shared,
+/// i.e. MP3 and AAC. Ogg streams (Vorbis, Opus) need their own encoder.
+class SharedBroadcastEncoder : public EncoderCallback {
+  public:
+    ~SharedBroadcastEncoder() override;
+
+    /// Returns a key that identifies the encoder settings or an empty string
+    /// if the format can't be shared.
+    static QString sharingKey(const EncoderSettings& settings,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// Returns the shared encoder for the settings and subscribes to its
+    /// output. The encoder is created and initialized when the first
+    /// connection subscribes. Returns nullptr if initialization fails.
+    static std::shared_ptr<SharedBroadcastEncoder> subscribe(
+            const EncoderSettingsPointer& pSettings,
+            mixxx::audio::SampleRate sampleRate,
+            const void* pSubscriber,
+            QString* pUserErrorMessage);
+
+    /// Stop receiving encoded data. The encoder is destroyed when the last
+    /// shared pointer is released.
+    void unsubscribe(const void* pSubscriber);
+
+    /// Called by every subscriber with the samples it has received. Only the
+    /// samples beyond the encoded position are encoded. The other samples of
+    /// the subscriber are discarded, because the same samples of another
+    /// subscriber have been encoded already.
+    ///
+    /// A subscriber that falls behind, e.g. because its FIFO has overflowed
+    /// while its server stalled, keeps discarding its samples. It is only
+    /// moved to the encoded position if all subscribers that were ahead of
+    /// it have unsubscribed, so the stream continues without a gap.
+    void encodeBuffer(const void* pSubscriber,
+            const CSAMPLE* pBuffer,
+            const std::size_t bufferSize);
+
+    /// Moves the data that has been encoded for the subscriber out of its
+    /// queue. The queue of a subscriber that does not take its data is
+    /// dropped when it exceeds the network cache of a single connection, and
+    /// the MP3 or AAC decoders of its listeners resynchronize on the next
+    /// frame.
+    QByteArray takeEncoded(const void* pSubscriber);
+
+    // EncoderCallback
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    qint64 tell() override {
+        return -1;
+    }
+    void seek(qint64 pos) override {
+        Q_UNUSED(pos);
+    }
+    qint64 filelen() override {
+        return 0;
+    }
+
+  private:
+    explicit SharedBroadcastEncoder(const QString& key);
+
+    struct Subscription {
+        const void* pSubscriber;
+        // The stream position of the next samples of the subscriber
+        qint64 inputSamples;
+        QByteArray encoded;
+    };
+
+    const QString m_key;
+
+    // Guards the encoder and m_encodedSamples. Locked before
+    // m_subscriptionMutex, because the encoder calls write().
+    QMutex m_encoderMutex;
+    EncoderPointer m_pEncoder;
+    // The stream position up to which the samples have been encoded
+    qint64 m_encodedSamples;
+
+    QMutex m_subscriptionMutex;
+    QList<Subscription> m_subscriptions;
+};
@@ -12,9 +12,12 @@
 
 #include <shoutidjc/shout.h>
 
+#include <algorithm>
+
 #include "broadcast/defs_broadcast.h"
 #include "encoder/encoder.h"
 #include "encoder/encoderbroadcastsettings.h"
+#include "engine/sidechain/sharedbroadcastencoder.h"
 #ifdef __OPUS__
 #include "encoder/encoderopus.h"
 #endif
@@ -26,6 +29,7 @@
 #include "track/track.h"
 #include "util/compatibility/qatomic.h"
 #include "util/logger.h"
+#include "util/time.h"
 
 namespace {
 
@@ -35,6 +39,18 @@ constexpr int kMaxNetworkCache = 491520; // 10 s mp3 @ 192 kbit/s
 // http://wiki.shoutcast.com/wiki/SHOUTcast_DNAS_Server_2
 constexpr int kMaxShoutFailures = 3;
 
+// The backlog is sent at twice the bitrate after reconnecting, i.e. it is
+// caught up after the duration of the outage. Icecast forwards the data
+// as fast as it is received, so the listeners' buffers are refilled.
+constexpr double kBacklogSendSpeed = 2.0;
+
+constexpr mixxx::Duration kTransferStatusInterval = mixxx::Duration::fromSeconds(1);
+
+// While libshout has queued data that the socket didn't accept, the thread
+// wakes up this often to continue sending it, even if no new samples arrive
+constexpr int kSendQueuePollMillis = 10;
+constexpr int kIdlePollMillis = 1000;
+
 const QRegularExpression kArtistOrTitleRegex(QStringLiteral("\\$artist|\\$title"));
 const QRegularExpression kArtistRegex(QStringLiteral("\\$artist"));
 
@@ -68,6 +84,14 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_ogg_dynamic_update(false),
           m_threadWaiting(false),
           m_retryCount(0),
+          m_reconnectPending(false),
+          m_reconnecting(false),
+          m_bitrate(0),
+          m_maxBacklogBytes(0),
+          m_backlogBytes(0),
+          m_backlogSendBudget(0.0),
+          m_bytesSent(0),
+          m_lastQueueLen(0),
           m_reconnectFirstDelay(0.0),
           m_reconnectPeriod(5.0),
           m_noDelayFirstReconnect(true),
@@ -183,10 +207,16 @@ void ShoutConnection::updateFromPreferences() {
 
     setState(NETWORKSTREAMWORKER_STATE_BUSY);
 
+    // The stream that is encoded into the backlog is continued after
+    // reconnecting
+    const bool keepEncoder = collectsBacklog() && (m_encoder || m_pSharedEncoder);
+
     // Delete m_encoder if it has been initialized (with maybe) different bitrate.
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    if (!keepEncoder) {
+        resetEncoder();
+    }
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -391,6 +421,16 @@ void ShoutConnection::updateFromPreferences() {
     if (iBitrate < 0) {
         qWarning() << "Error: unknown bit rate:" << iBitrate;
     }
+    m_bitrate = iBitrate;
+
+    // Only MP3 and AAC streams consist of independent frames, which can be
+    // sent on a new connection. Ogg streams start with headers, so a new
+    // stream is encoded for every connection.
+    m_maxBacklogBytes = 0;
+    if (enableReconnect && (m_format_is_mp3 || m_format_is_aac) && iBitrate > 0) {
+        m_maxBacklogBytes = static_cast<qint64>(m_pProfile->getReconnectBacklog()) *
+                iBitrate * 1000 / 8;
+    }
 
     auto mainSamplerate = mixxx::audio::SampleRate::fromDouble(m_mainSamplerate.get());
     VERIFY_OR_DEBUG_ASSERT(mainSamplerate.isValid()) {
@@ -450,23 +490,38 @@ void ShoutConnection::updateFromPreferences() {
         return;
     }
 
+    if (keepEncoder) {
+        setState(NETWORKSTREAMWORKER_STATE_READY);
+        return;
+    }
+
     // Initialize m_encoder
     EncoderSettingsPointer pBroadcastSettings =
             std::make_shared<EncoderBroadcastSettings>(m_pProfile);
-    m_encoder = EncoderFactory::getFactory().createEncoder(
-                    pBroadcastSettings, this);
-
     QString userErrorMsg;
     int ret = -1;
-    if (m_encoder) {
-        ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+    if (m_pConfig->getValue(ConfigKey(BROADCAST_PREF_KEY, "share_encoders"), true) &&
+            !SharedBroadcastEncoder::sharingKey(*pBroadcastSettings, mainSamplerate)
+                     .isEmpty()) {
+        // Connections with identical settings encode the stream only once
+        m_pSharedEncoder = SharedBroadcastEncoder::subscribe(
+                pBroadcastSettings, mainSamplerate, this, &userErrorMsg);
+        if (m_pSharedEncoder) {
+            ret = 0;
+        }
+    } else {
+        m_encoder = EncoderFactory::getFactory().createEncoder(
+                pBroadcastSettings, this);
+        if (m_encoder) {
+            ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+        }
     }
 
     // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
     if (ret < 0) {
         // delete m_encoder calls write() make sure it will be exit early
         DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-        m_encoder.reset();
+        resetEncoder();
 
         setState(NETWORKSTREAMWORKER_STATE_ERROR);
 
@@ -499,7 +554,7 @@ bool ShoutConnection::processConnect() {
     // Make sure that we call updateFromPreferences always
     updateFromPreferences();
 
-    if (!m_encoder) {
+    if (!m_encoder && !m_pSharedEncoder) {
         // updateFromPreferences failed
         setStatus(BroadcastProfile::STATUS_FAILURE);
         kLogger.warning() << "ShoutOutput::processConnect() returning false";
@@ -508,6 +563,7 @@ bool ShoutConnection::processConnect() {
 
     setStatus(BroadcastProfile::STATUS_CONNECTING);
     m_iShoutFailures = 0;
+    m_reconnectPending = false;
     m_lastErrorStr.clear();
     // set to a high number to automatically update the metadata
     // on the first change
@@ -579,9 +635,7 @@ bool ShoutConnection::processConnect() {
 
             // If socket is busy then we wait half second
             if (m_iShoutStatus == SHOUTERR_BUSY) {
-                m_enabledMutex.lock();
-                m_waitEnabled.wait(&m_enabledMutex, 500);
-                m_enabledMutex.unlock();
+                waitWhileReconnecting(500);
             }
 
             ++ timeout;
@@ -592,8 +646,10 @@ bool ShoutConnection::processConnect() {
 
             m_retryCount = 0;
 
-            if(m_pOutputFifo->readAvailable()) {
-            	m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
+            // The samples since the connection has been lost are still
+            // needed if they are encoded into the backlog
+            if (!collectsBacklog() && m_pOutputFifo->readAvailable()) {
+                m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
             }
             m_threadWaiting = true;
 
@@ -625,7 +681,9 @@ bool ShoutConnection::processConnect() {
     shout_close(m_pShout);
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    if (!collectsBacklog()) {
+        resetEncoder();
+    }
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -639,7 +697,10 @@ bool ShoutConnection::processDisconnect() {
     kLogger.debug() << "processDisconnect()";
     bool disconnected = false;
     if (isConnected()) {
-    	m_threadWaiting = false;
+        // Keep receiving samples while encoding into the backlog
+        if (!collectsBacklog()) {
+            m_threadWaiting = false;
+        }
 
         // We are connected but broadcast is disabled. Disconnect.
         shout_close(m_pShout);
@@ -650,53 +711,159 @@ bool ShoutConnection::processDisconnect() {
     }
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    if (!collectsBacklog()) {
+        resetEncoder();
+        clearBacklog();
+    }
     return disconnected;
 }
 
+void ShoutConnection::resetEncoder() {
+    m_encoder.reset();
+    if (m_pSharedEncoder) {
+        m_pSharedEncoder->unsubscribe(this);
+        m_pSharedEncoder.reset();
+    }
+}
+
 void ShoutConnection::write(const unsigned char* header, const unsigned char* body,
                             int headerLen, int bodyLen) {
     setFunctionCode(7);
-	if (!m_pShout || m_iShoutStatus != SHOUTERR_CONNECTED) {
+    if (!m_pShout || m_iShoutStatus != SHOUTERR_CONNECTED || m_reconnectPending) {
+        if (collectsBacklog()) {
+            appendToBacklog(header, headerLen);
+            appendToBacklog(body, bodyLen);
+        }
         // This happens when the decoder calls flush() and the connection is
         // already down
         return;
     }
 
+    if (!m_backlog.empty()) {
+        // Keep the order of the stream until the backlog has been sent
+        appendToBacklog(header, headerLen);
+        appendToBacklog(body, bodyLen);
+        sendBacklog();
+        return;
+    }
+
     // Send header if there is one
     if (headerLen > 0) {
         if(!writeSingle(header, headerLen)) {
+            if (collectsBacklog()) {
+                appendToBacklog(header, headerLen);
+                appendToBacklog(body, bodyLen);
+            }
             return;
         }
     }
 
     if(!writeSingle(body, bodyLen)) {
+        if (collectsBacklog()) {
+            appendToBacklog(body, bodyLen);
+        }
         return;
     }
 
+    checkNetworkCache();
+}
+
+void ShoutConnection::checkNetworkCache() {
     ssize_t queuelen = shout_queuelen(m_pShout);
     if (queuelen > 0) {
         kLogger.debug() << "shout_queuelen" << queuelen;
         if (queuelen > kMaxNetworkCache) {
             m_lastErrorStr = tr("Network cache overflow");
-            tryReconnect();
+            m_reconnectPending = true;
+        }
+    }
+}
+
+void ShoutConnection::appendToBacklog(const unsigned char* data, int len) {
+    if (len <= 0) {
+        return;
+    }
+    m_backlog.emplace_back(reinterpret_cast<const char*>(data), len);
+    m_backlogBytes += len;
+    // Drop the oldest part of the stream if the outage lasts longer than
+    // the backlog. The decoders of the listeners resynchronize on the next
+    // frame.
+    while (m_backlogBytes > m_maxBacklogBytes && !m_backlog.empty()) {
+        m_backlogBytes -= m_backlog.front().size();
+        m_backlog.pop_front();
+    }
+}
+
+void ShoutConnection::sendBacklog() {
+    const double maxSendBudget = m_bitrate * 1000 / 8.0 * kBacklogSendSpeed;
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    // Allows to send at most a second at once, e.g. after reconnecting
+    m_backlogSendBudget = std::min(m_backlogSendBudget +
+                    (now - m_backlogSendTime).toDoubleSeconds() * maxSendBudget,
+            maxSendBudget);
+    m_backlogSendTime = now;
+
+    while (!m_backlog.empty() &&
+            (m_backlog.front().size() <= m_backlogSendBudget ||
+                    m_backlogSendBudget >= maxSendBudget)) {
+        const QByteArray& data = m_backlog.front();
+        if (!writeSingle(reinterpret_cast<const unsigned char*>(data.constData()),
+                    data.size())) {
+            // Kept for the next attempt
+            return;
+        }
+        m_backlogSendBudget -= data.size();
+        m_backlogBytes -= data.size();
+        m_backlog.pop_front();
+
+        checkNetworkCache();
+        if (m_reconnectPending) {
+            return;
         }
     }
 }
+
+void ShoutConnection::clearBacklog() {
+    m_backlog.clear();
+    m_backlogBytes = 0;
+}
+
+void ShoutConnection::updateTransferStatus() {
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    const mixxx::Duration elapsed = now - m_transferStatusTime;
+    if (elapsed < kTransferStatusInterval) {
+        return;
+    }
+    // The bytes that have been accepted by libshout but are still queued
+    // haven't been sent yet
+    const qint64 queueLen = m_pShout ? std::max<qint64>(shout_queuelen(m_pShout), 0) : 0;
+    const qint64 bytesSent = std::max<qint64>(m_bytesSent - (queueLen - m_lastQueueLen), 0);
+    // bytes * 8 / ms = kbit/s and bytes * 8 / (kbit/s) = ms
+    const int sendRateKbps = static_cast<int>(bytesSent * 8 / elapsed.toDoubleMillis());
+    const int backlogMillis = m_bitrate > 0
+            ? static_cast<int>(m_backlogBytes * 8 / m_bitrate)
+            : 0;
+    const int sendBufferPercent = static_cast<int>(
+            std::min<qint64>(queueLen * 100 / kMaxNetworkCache, 100));
+    m_pProfile->setTransferStatus(backlogMillis, sendRateKbps, sendBufferPercent);
+    m_bytesSent = 0;
+    m_lastQueueLen = queueLen;
+    m_transferStatusTime = now;
+}
 // These are not used for streaming, but the interface requires them
-int ShoutConnection::tell() {
+qint64 ShoutConnection::tell() {
     if (!m_pShout) {
         return -1;
     }
     return -1;
 }
 // These are not used for streaming, but the interface requires them
-void ShoutConnection::seek(int pos) {
+void ShoutConnection::seek(qint64 pos) {
     Q_UNUSED(pos)
     return;
 }
 // These are not used for streaming, but the interface requires them
-int ShoutConnection::filelen() {
+qint64 ShoutConnection::filelen() {
     return 0;
 }
 
@@ -704,27 +871,43 @@ bool ShoutConnection::writeSingle(const unsigned char* data, std::size_t len) {
     setFunctionCode(8);
     int ret = shout_send_raw(m_pShout, data, len);
     if (ret == SHOUTERR_BUSY) {
-        // in case of busy, frames are queued
-        // try to flush queue after a short sleep
-        kLogger.warning() << "writeSingle() SHOUTERR_BUSY, trying again";
-        usleep(10000); // wait 10 ms until "busy" is over. TODO() tweak for an optimum.
-        // if this fails, the queue is transmitted after the next regular shout_send_raw()
-        (void)shout_send_raw(m_pShout, nullptr, 0);
+        // The socket didn't accept all data, the rest has been queued by
+        // libshout. It is sent by flushSendQueue() while the thread waits
+        // for the next samples, so the encoder is never blocked here.
+        kLogger.debug() << "writeSingle() SHOUTERR_BUSY, queued"
+                        << shout_queuelen(m_pShout) << "bytes";
     } else if (ret < SHOUTERR_SUCCESS) {
         m_lastErrorStr = shout_get_error(m_pShout);
         kLogger.warning()
                 << "writeSingle() error:"
                 << ret << m_lastErrorStr;
         if (++m_iShoutFailures > kMaxShoutFailures) {
-            tryReconnect();
+            m_reconnectPending = true;
         }
         return false;
     } else {
         m_iShoutFailures = 0;
     }
+    m_bytesSent += len;
     return true;
 }
 
+void ShoutConnection::flushSendQueue() {
+    setFunctionCode(15);
+    // Only sends what the socket accepts without blocking
+    int ret = shout_send_raw(m_pShout, nullptr, 0);
+    if (ret < SHOUTERR_SUCCESS && ret != SHOUTERR_BUSY) {
+        m_lastErrorStr = shout_get_error(m_pShout);
+        kLogger.warning()
+                << "flushSendQueue() error:"
+                << ret << m_lastErrorStr;
+        if (++m_iShoutFailures > kMaxShoutFailures) {
+            m_reconnectPending = true;
+        }
+    }
+    updateTransferStatus();
+}
+
 void ShoutConnection::process(const CSAMPLE* pBuffer, const std::size_t bufferSize) {
     setFunctionCode(4);
     if (!m_pProfile->getEnabled()) {
@@ -733,8 +916,9 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const std::size_t bufferSi
 
     setState(NETWORKSTREAMWORKER_STATE_BUSY);
 
-    // If we aren't connected, bail.
-    if (m_iShoutStatus != SHOUTERR_CONNECTED) {
+    // If we aren't connected, bail. While reconnecting, the stream may be
+    // encoded into the backlog.
+    if (m_iShoutStatus != SHOUTERR_CONNECTED && !collectsBacklog()) {
         return;
     }
 
@@ -742,16 +926,32 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const std::size_t bufferSi
     // to prevent race conditions when resetting the member
     // pointer while disconnecting in the worker thread!
     const EncoderPointer pEncoder = m_encoder;
+    const std::shared_ptr<SharedBroadcastEncoder> pSharedEncoder = m_pSharedEncoder;
 
     // If we are connected, encode the samples.
     if (bufferSize > 0 && pEncoder) {
         setFunctionCode(6);
         pEncoder->encodeBuffer(pBuffer, bufferSize);
         // the encoded frames are received by the write() callback.
+    } else if (pSharedEncoder) {
+        setFunctionCode(6);
+        if (bufferSize > 0) {
+            pSharedEncoder->encodeBuffer(this, pBuffer, bufferSize);
+        }
+        // Send what has been encoded for us, either from our samples or from
+        // the samples of a connection that has received them earlier.
+        const QByteArray encoded = pSharedEncoder->takeEncoded(this);
+        if (!encoded.isEmpty()) {
+            write(nullptr,
+                    reinterpret_cast<const unsigned char*>(encoded.constData()),
+                    0,
+                    static_cast<int>(encoded.size()));
+        }
     }
 
-    // Check if track metadata has changed and if so, update.
-    if (metaDataHasChanged()) {
+    // Check if track metadata has changed and if so, update. It is sent
+    // again after reconnecting.
+    if (m_iShoutStatus == SHOUTERR_CONNECTED && metaDataHasChanged()) {
         updateMetaData();
     }
     setState(NETWORKSTREAMWORKER_STATE_READY);
@@ -940,9 +1140,7 @@ bool ShoutConnection::waitForRetry() {
     }
 
     if (delay > 0) {
-        m_enabledMutex.lock();
-        m_waitEnabled.wait(&m_enabledMutex, static_cast<unsigned long>(delay * 1000));
-        m_enabledMutex.unlock();
+        waitWhileReconnecting(static_cast<unsigned long>(delay * 1000));
         if (!m_pProfile->getEnabled()) {
             return false;
         }
@@ -950,18 +1148,46 @@ bool ShoutConnection::waitForRetry() {
     return true;
 }
 
+void ShoutConnection::waitWhileReconnecting(unsigned long timeoutMillis) {
+    if (!collectsBacklog()) {
+        m_enabledMutex.lock();
+        m_waitEnabled.wait(&m_enabledMutex, timeoutMillis);
+        m_enabledMutex.unlock();
+        return;
+    }
+    const mixxx::Duration deadline = mixxx::Time::elapsed() +
+            mixxx::Duration::fromMillis(static_cast<qint64>(timeoutMillis));
+    while (m_pProfile->getEnabled()) {
+        const qint64 remainingMillis = (deadline - mixxx::Time::elapsed()).toIntegerMillis();
+        if (remainingMillis <= 0) {
+            break;
+        }
+        if (m_readSema.tryAcquire(1, static_cast<int>(remainingMillis))) {
+            processOutputFifo();
+        }
+    }
+}
+
 void ShoutConnection::tryReconnect() {
     QString originalErrorStr = m_lastErrorStr;
     setStatus(BroadcastProfile::STATUS_FAILURE);
 
+    m_reconnecting = true;
+    m_reconnectPending = false;
     processDisconnect();
     while (waitForRetry()) {
         if (processConnect()) {
             break;
         }
     }
+    m_reconnecting = false;
 
     if (getStatus() == BroadcastProfile::STATUS_FAILURE) {
+        // Giving up, the thread stops
+        m_threadWaiting = false;
+        resetEncoder();
+        clearBacklog();
+
         QString errorText;
         if (m_retryCount > 0) {
             errorText = tr("Lost connection to streaming server and %1 attempts to reconnect have failed.")
@@ -1033,35 +1259,53 @@ void ShoutConnection::run() {
 
         setFunctionCode(1);
         incRunCount();
-        if(!m_readSema.tryAcquire(1, 1000)) {
+        const bool sendQueued = m_pShout &&
+                m_iShoutStatus == SHOUTERR_CONNECTED &&
+                shout_queuelen(m_pShout) > 0;
+        if (!m_readSema.tryAcquire(1, sendQueued ? kSendQueuePollMillis : kIdlePollMillis)) {
+            if (sendQueued) {
+                flushSendQueue();
+                if (m_reconnectPending) {
+                    tryReconnect();
+                }
+            }
             continue;
         }
 
-        int readAvailable = m_pOutputFifo->readAvailable();
-        if (readAvailable) {
-            setFunctionCode(3);
-            CSAMPLE* dataPtr1;
-            ring_buffer_size_t size1;
-            CSAMPLE* dataPtr2;
-            ring_buffer_size_t size2;
-
-            // We use size1 and size2, so we can ignore the return value
-            (void)m_pOutputFifo->aquireReadRegions(readAvailable, &dataPtr1, &size1,
-                    &dataPtr2, &size2);
-
-            // Push frames to the encoder.
-            process(dataPtr1, size1);
-            if (size2 > 0) {
-                process(dataPtr2, size2);
-            }
-
-            m_pOutputFifo->releaseReadRegions(readAvailable);
+        processOutputFifo();
+        if (m_reconnectPending) {
+            tryReconnect();
         }
     }
 
+    m_pProfile->setTransferStatus(0, 0, 0);
     kLogger.debug() << "run: Thread stopped";
 }
 
+void ShoutConnection::processOutputFifo() {
+    int readAvailable = m_pOutputFifo->readAvailable();
+    if (readAvailable) {
+        setFunctionCode(3);
+        CSAMPLE* dataPtr1;
+        ring_buffer_size_t size1;
+        CSAMPLE* dataPtr2;
+        ring_buffer_size_t size2;
+
+        // We use size1 and size2, so we can ignore the return value
+        (void)m_pOutputFifo->aquireReadRegions(readAvailable, &dataPtr1, &size1,
+                &dataPtr2, &size2);
+
+        // Push frames to the encoder.
+        process(dataPtr1, size1);
+        if (size2 > 0) {
+            process(dataPtr2, size2);
+        }
+
+        m_pOutputFifo->releaseReadRegions(readAvailable);
+    }
+    updateTransferStatus();
+}
+
 #ifndef __WINDOWS__
 void ShoutConnection::ignoreSigpipe() {
     // If the remote connection is closed, shout_send_raw() can cause a
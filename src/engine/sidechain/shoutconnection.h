@@ -8,6 +8,8 @@
 #include <QThread>
 #include <QVector>
 #include <QWaitCondition>
+#include <deque>
+#include <memory>
 
 #include "control/pollingcontrolproxy.h"
 #include "encoder/encoder.h"
@@ -15,6 +17,7 @@
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
+#include "util/duration.h"
 #include "util/fifo.h"
 
 // Forward declare libshout structures to prevent leaking shout.h definitions
@@ -23,6 +26,7 @@ typedef struct shout shout_t;
 typedef struct _util_dict shout_metadata_t;
 
 class QTextCodec;
+class SharedBroadcastEncoder;
 
 class ShoutConnection
         : public QThread, public EncoderCallback, public NetworkOutputStreamWorker {
@@ -43,11 +47,11 @@ class ShoutConnection
     void write(const unsigned char* header, const unsigned char* body,
                int headerLen, int bodyLen) override;
     // gets stream position
-    int tell() override;
+    qint64 tell() override;
     // sets stream position
-    void seek(int pos) override;
+    void seek(qint64 pos) override;
     // gets stream length
-    int filelen() override;
+    qint64 filelen() override;
 
     /** connects to server **/
     bool serverConnect();
@@ -79,6 +83,28 @@ class ShoutConnection
     bool processConnect();
     bool processDisconnect();
 
+    // Encodes and sends the samples that are available in the output FIFO
+    void processOutputFifo();
+    // Waits before the next connection attempt. While reconnecting with a
+    // backlog, the stream is encoded into the backlog meanwhile.
+    void waitWhileReconnecting(unsigned long timeoutMillis);
+
+    // While reconnecting, the encoded stream is kept in the backlog if it
+    // is enabled in the profile
+    bool collectsBacklog() const {
+        return m_maxBacklogBytes > 0 && (m_reconnecting || m_reconnectPending);
+    }
+    void appendToBacklog(const unsigned char* data, int len);
+    // Sends the backlog after reconnecting, limited to a multiple of the
+    // bitrate of the stream
+    void sendBacklog();
+    void clearBacklog();
+    void checkNetworkCache();
+    void updateTransferStatus();
+
+    // Release m_encoder or the subscription of m_pSharedEncoder
+    void resetEncoder();
+
     // Update the libshout struct with info from the current broadcast profile.
     void updateFromPreferences();
     int getActiveTracks();
@@ -102,6 +128,9 @@ class ShoutConnection
 #endif
 
     bool writeSingle(const unsigned char *data, size_t len);
+    // Continues sending the data that libshout has queued because the
+    // socket was busy
+    void flushSendQueue();
 
     QByteArray encodeString(const QString& string);
 
@@ -120,6 +149,9 @@ class ShoutConnection
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
     EncoderPointer m_encoder;
+    // Used instead of m_encoder if another connection has the same encoder
+    // settings, see SharedBroadcastEncoder
+    std::shared_ptr<SharedBroadcastEncoder> m_pSharedEncoder;
     PollingControlProxy m_mainSamplerate;
     PollingControlProxy m_broadcastEnabled;
     // static metadata according to prefereneces
@@ -146,6 +178,21 @@ class ShoutConnection
 
     QString m_lastErrorStr;
     int m_retryCount;
+    // Set when sending fails. The connection is reestablished after the
+    // samples that are currently processed have been encoded.
+    bool m_reconnectPending;
+    bool m_reconnecting;
+
+    int m_bitrate;
+    qint64 m_maxBacklogBytes;
+    std::deque<QByteArray> m_backlog;
+    qint64 m_backlogBytes;
+    double m_backlogSendBudget;
+    mixxx::Duration m_backlogSendTime;
+
+    qint64 m_bytesSent;
+    qint64 m_lastQueueLen;
+    mixxx::Duration m_transferStatusTime;
 
     double m_reconnectFirstDelay;
     double m_reconnectPeriod;
@@ -0,0 +1,113 @@
+#include "engine/sidechain/sidechainringbuffer.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+SideChainRingBuffer::SideChainRingBuffer(SINT capacity)
+        : m_mask(roundUpToPowerOf2(static_cast<unsigned int>(capacity)) - 1),
+          m_pBuffer(SampleUtil::alloc(static_cast<SINT>(m_mask + 1))),
+          m_reservedPosition(0),
+          m_writePosition(0) {
+    DEBUG_ASSERT(capacity > 0);
+    SampleUtil::clear(m_pBuffer, static_cast<SINT>(m_mask + 1));
+}
+
+SideChainRingBuffer::~SideChainRingBuffer() {
+    SampleUtil::free(m_pBuffer);
+}
+
+void SideChainRingBuffer::write(const CSAMPLE* pBuffer, SINT numSamples) {
+    DEBUG_ASSERT(numSamples >= 0);
+    const std::uint64_t cap = m_mask + 1;
+    // Only the most recent samples fit into the buffer. They are still
+    // written in order, so the readers see the skipped ones as overwritten.
+    while (static_cast<std::uint64_t>(numSamples) > cap) {
+        write(pBuffer, static_cast<SINT>(cap));
+        pBuffer += cap;
+        numSamples -= static_cast<SINT>(cap);
+    }
+
+    const std::uint64_t position = m_writePosition.load(std::memory_order_relaxed);
+    const std::uint64_t endPosition = position + numSamples;
+    m_reservedPosition.store(endPosition, std::memory_order_relaxed);
+    // Make the reservation visible before any sample is overwritten
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const SINT offset = static_cast<SINT>(position & m_mask);
+    const SINT firstPart = std::min(numSamples, static_cast<SINT>(cap) - offset);
+    SampleUtil::copy(m_pBuffer + offset, pBuffer, firstPart);
+    if (firstPart < numSamples) {
+        SampleUtil::copy(m_pBuffer, pBuffer + firstPart, numSamples - firstPart);
+    }
+
+    m_writePosition.store(endPosition, std::memory_order_release);
+}
+
+void SideChainRingBuffer::copyOut(
+        CSAMPLE* pBuffer, std::uint64_t position, SINT numSamples) const {
+    const SINT cap = static_cast<SINT>(m_mask + 1);
+    const SINT offset = static_cast<SINT>(position & m_mask);
+    const SINT firstPart = std::min(numSamples, cap - offset);
+    SampleUtil::copy(pBuffer, m_pBuffer + offset, firstPart);
+    if (firstPart < numSamples) {
+        SampleUtil::copy(pBuffer + firstPart, m_pBuffer, numSamples - firstPart);
+    }
+}
+
+SideChainRingBuffer::Reader::Reader(const SideChainRingBuffer* pRingBuffer)
+        : m_pRingBuffer(pRingBuffer),
+          m_position(pRingBuffer->writePosition()),
+          m_droppedSamples(0) {
+}
+
+SINT SideChainRingBuffer::Reader::read(CSAMPLE* pBuffer,
+        SINT maxSamples,
+        std::uint64_t* pDroppedSamples) {
+    const std::uint64_t cap = m_pRingBuffer->m_mask + 1;
+    const std::uint64_t writePosition = m_pRingBuffer->writePosition();
+    std::uint64_t position = m_position.load(std::memory_order_relaxed);
+    std::uint64_t dropped = 0;
+
+    if (writePosition - position > cap) {
+        // The oldest samples have been overwritten already
+        dropped = writePosition - cap - position;
+        position += dropped;
+    }
+
+    SINT numSamples = static_cast<SINT>(std::min(
+            writePosition - position, static_cast<std::uint64_t>(maxSamples)));
+    if (numSamples > 0) {
+        m_pRingBuffer->copyOut(pBuffer, position, numSamples);
+
+        // Check if the producer has started to overwrite the samples while
+        // we were copying them.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t reservedPosition =
+                m_pRingBuffer->m_reservedPosition.load(std::memory_order_relaxed);
+        if (reservedPosition - position > cap) {
+            const std::uint64_t overwritten = std::min(
+                    reservedPosition - cap - position,
+                    static_cast<std::uint64_t>(numSamples));
+            numSamples -= static_cast<SINT>(overwritten);
+            std::move(pBuffer + overwritten,
+                    pBuffer + overwritten + numSamples,
+                    pBuffer);
+            position += overwritten;
+            dropped += overwritten;
+        }
+    }
+
+    m_position.store(position + numSamples, std::memory_order_relaxed);
+    if (dropped > 0) {
+        m_droppedSamples.store(
+                m_droppedSamples.load(std::memory_order_relaxed) + dropped,
+                std::memory_order_relaxed);
+    }
+    if (pDroppedSamples) {
+        *pDroppedSamples = dropped;
+    }
+    return numSamples;
+}
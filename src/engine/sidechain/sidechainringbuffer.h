@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "util/types.h"
+
+/// A lock-free sample ring buffer with a single producer and any number of
+/// consumers.
+///
+/// Every sample is identified by its position in the stream, a 64 bit
+/// counter that starts at 0 and never wraps. The producer is wait-free and
+/// never blocks. If a consumer falls behind by more than the capacity, the
+/// producer overwrites the oldest samples and the consumer skips them when
+/// it reads next. Consumers read independently, a slow consumer does not
+/// disturb the others.
+///
+/// The producer announces the range it is about to overwrite before it
+/// touches the memory, similar to a sequence lock. This allows a consumer to
+/// detect after copying whether samples got overwritten while copying and
+/// to discard them.
+class SideChainRingBuffer {
+  public:
+    /// The capacity is rounded up to the next power of two.
+    explicit SideChainRingBuffer(SINT capacity);
+    ~SideChainRingBuffer();
+
+    SideChainRingBuffer(const SideChainRingBuffer&) = delete;
+    SideChainRingBuffer& operator=(const SideChainRingBuffer&) = delete;
+
+    SINT capacity() const {
+        return static_cast<SINT>(m_mask + 1);
+    }
+
+    /// Wait-free. Must only be called from a single producer thread.
+    void write(const CSAMPLE* pBuffer, SINT numSamples);
+
+    /// The stream position after the last written sample.
+    std::uint64_t writePosition() const {
+        return m_writePosition.load(std::memory_order_acquire);
+    }
+
+    /// A read cursor. Each consumer needs its own reader, a single reader
+    /// must not be used by multiple threads concurrently.
+    class Reader {
+      public:
+        /// Starts reading at the current write position, i.e. samples that
+        /// have been written before are not seen by the new reader.
+        explicit Reader(const SideChainRingBuffer* pRingBuffer);
+
+        /// The stream position of the next sample to read.
+        std::uint64_t position() const {
+            return m_position.load(std::memory_order_relaxed);
+        }
+
+        /// The number of samples that are ready to be read, including the
+        /// ones that have already been overwritten.
+        std::uint64_t readAvailable() const {
+            return m_pRingBuffer->writePosition() - position();
+        }
+
+        /// The total number of samples that have been lost, because the
+        /// reader fell behind the producer.
+        std::uint64_t droppedSamples() const {
+            return m_droppedSamples.load(std::memory_order_relaxed);
+        }
+
+        /// Copies up to maxSamples consecutive samples into pBuffer and
+        /// returns how many have been copied. Overwritten samples before the
+        /// copied ones are skipped and are accounted in *pDroppedSamples,
+        /// if provided.
+        SINT read(CSAMPLE* pBuffer,
+                SINT maxSamples,
+                std::uint64_t* pDroppedSamples = nullptr);
+
+      private:
+        const SideChainRingBuffer* const m_pRingBuffer;
+        // Only written by the consumer thread, atomic to allow monitoring
+        // the reader from other threads.
+        std::atomic<std::uint64_t> m_position;
+        std::atomic<std::uint64_t> m_droppedSamples;
+    };
+
+  private:
+    void copyOut(CSAMPLE* pBuffer, std::uint64_t position, SINT numSamples) const;
+
+    const std::uint64_t m_mask;
+    CSAMPLE* const m_pBuffer;
+
+    // The end of the range that the producer is going to overwrite next.
+    // Published before the samples are written.
+    std::atomic<std::uint64_t> m_reservedPosition;
+    // The end of the range that has been written completely.
+    std::atomic<std::uint64_t> m_writePosition;
+};
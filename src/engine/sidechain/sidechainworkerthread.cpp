@@ -0,0 +1,310 @@
+#include "engine/sidechain/sidechainworkerthread.h"
+
+#include <QDir>
+#include <QMutexLocker>
+#include <QTemporaryFile>
+#include <algorithm>
+
+#include "engine/sidechain/enginesidechain.h"
+#include "engine/sidechain/sidechainworker.h"
+#include "util/event.h"
+#include "util/logger.h"
+#include "util/realtime.h"
+#include "util/sample.h"
+#include "util/trace.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SideChainWorkerThread");
+
+// Wake up the consumers when this many samples are pending. This matches the
+// fill level at which the sidechain thread has been woken up before.
+constexpr std::uint64_t kWakeUpThreshold =
+        EngineSideChain::SIDECHAIN_BUFFER_SIZE * 4 / 5;
+
+// Upper bound for sleeping without a wake up. A producer notification might
+// get lost if it arrives just before a consumer starts waiting.
+constexpr unsigned long kMaxWaitMillis = 200;
+
+constexpr qint64 kSampleSize = sizeof(CSAMPLE);
+
+} // anonymous namespace
+
+// An unbounded sample FIFO on disk. The file is truncated whenever the
+// reader has caught up with the writer.
+class SideChainWorkerThread::SpillFile {
+  public:
+    SpillFile()
+            : m_file(QDir::tempPath() + QStringLiteral("/mixxx-sidechain-XXXXXX.pcm")),
+              m_readPosition(0),
+              m_writePosition(0) {
+    }
+
+    bool open() {
+        return m_file.open();
+    }
+
+    QString fileName() const {
+        return m_file.fileName();
+    }
+
+    bool append(const CSAMPLE* pBuffer, SINT numSamples) {
+        const qint64 numBytes = numSamples * kSampleSize;
+        QMutexLocker locker(&m_mutex);
+        if (!m_file.seek(m_writePosition) ||
+                m_file.write(reinterpret_cast<const char*>(pBuffer), numBytes) !=
+                        numBytes) {
+            return false;
+        }
+        m_writePosition += numBytes;
+        locker.unlock();
+        m_samplesAvailable.wakeAll();
+        return true;
+    }
+
+    SINT read(CSAMPLE* pBuffer, SINT maxSamples) {
+        QMutexLocker locker(&m_mutex);
+        const qint64 numBytes = std::min(
+                m_writePosition - m_readPosition, static_cast<qint64>(maxSamples) * kSampleSize);
+        if (numBytes <= 0) {
+            return 0;
+        }
+        // Written data is still buffered by QFile and not visible otherwise
+        m_file.flush();
+        if (!m_file.seek(m_readPosition)) {
+            return 0;
+        }
+        const qint64 bytesRead = m_file.read(reinterpret_cast<char*>(pBuffer), numBytes);
+        if (bytesRead <= 0) {
+            return 0;
+        }
+        m_readPosition += bytesRead;
+        if (m_readPosition == m_writePosition) {
+            // Caught up, start over to keep the file small
+            m_file.resize(0);
+            m_readPosition = 0;
+            m_writePosition = 0;
+        }
+        return static_cast<SINT>(bytesRead / kSampleSize);
+    }
+
+    std::uint64_t pendingSamples() {
+        QMutexLocker locker(&m_mutex);
+        return static_cast<std::uint64_t>(
+                (m_writePosition - m_readPosition) / kSampleSize);
+    }
+
+    // Sleeps until samples have been appended or the timeout has elapsed.
+    void waitForSamples() {
+        QMutexLocker locker(&m_mutex);
+        if (m_readPosition == m_writePosition) {
+            m_samplesAvailable.wait(&m_mutex, kMaxWaitMillis);
+        }
+    }
+
+    void wakeAll() {
+        QMutexLocker locker(&m_mutex);
+        m_samplesAvailable.wakeAll();
+    }
+
+  private:
+    QMutex m_mutex;
+    QWaitCondition m_samplesAvailable;
+    QTemporaryFile m_file;
+    qint64 m_readPosition;
+    qint64 m_writePosition;
+};
+
+// Moves the samples from the ring buffer into the spill file. It never waits
+// for the worker, so it keeps up with the producer unless the disk stalls.
+class SideChainWorkerThread::SpillThread : public QThread {
+  public:
+    explicit SpillThread(SideChainWorkerThread* pOwner)
+            : m_pOwner(pOwner),
+              m_pBuffer(SampleUtil::alloc(EngineSideChain::SIDECHAIN_BUFFER_SIZE)) {
+    }
+
+    ~SpillThread() override {
+        SampleUtil::free(m_pBuffer);
+    }
+
+  private:
+    void run() override {
+        QThread::currentThread()->setObjectName(
+                QStringLiteral("EngineSideChain spill %1").arg(m_pOwner->m_index));
+        mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::SideChain);
+        SpillFile* pSpillFile = m_pOwner->m_pSpillFile.get();
+        while (!m_pOwner->m_stop.load(std::memory_order_acquire)) {
+            m_pOwner->m_pWaitLock->lock();
+            if (m_pOwner->m_reader.readAvailable() < kWakeUpThreshold) {
+                m_pOwner->m_pWaitForSamples->wait(m_pOwner->m_pWaitLock, kMaxWaitMillis);
+            }
+            m_pOwner->m_pWaitLock->unlock();
+
+            std::uint64_t droppedSamples = 0;
+            SINT samplesRead;
+            while ((samplesRead = m_pOwner->m_reader.read(m_pBuffer,
+                            EngineSideChain::SIDECHAIN_BUFFER_SIZE,
+                            &droppedSamples)) > 0 ||
+                    droppedSamples > 0) {
+                if (droppedSamples > 0) {
+                    m_pOwner->m_overrunCounter.increment();
+                    appendSilence(pSpillFile, droppedSamples);
+                }
+                if (samplesRead > 0 && !pSpillFile->append(m_pBuffer, samplesRead)) {
+                    kLogger.warning() << "Failed to write to" << pSpillFile->fileName();
+                }
+            }
+        }
+    }
+
+    void appendSilence(SpillFile* pSpillFile, std::uint64_t numSamples) {
+        SampleUtil::clear(m_pBuffer, EngineSideChain::SIDECHAIN_BUFFER_SIZE);
+        while (numSamples > 0) {
+            const SINT chunkSize = static_cast<SINT>(std::min(numSamples,
+                    static_cast<std::uint64_t>(EngineSideChain::SIDECHAIN_BUFFER_SIZE)));
+            if (!pSpillFile->append(m_pBuffer, chunkSize)) {
+                return;
+            }
+            numSamples -= chunkSize;
+        }
+    }
+
+    SideChainWorkerThread* const m_pOwner;
+    CSAMPLE* const m_pBuffer;
+};
+
+SideChainWorkerThread::SideChainWorkerThread(SideChainWorker* pWorker,
+        const SideChainRingBuffer* pRingBuffer,
+        QMutex* pWaitLock,
+        QWaitCondition* pWaitForSamples,
+        int index,
+        bool spillToDisk)
+        : m_pWorker(pWorker),
+          m_pWaitLock(pWaitLock),
+          m_pWaitForSamples(pWaitForSamples),
+          m_index(index),
+          m_reader(pRingBuffer),
+          m_pWorkBuffer(SampleUtil::alloc(EngineSideChain::SIDECHAIN_BUFFER_SIZE)),
+          m_overrunCounter(QStringLiteral("EngineSideChain worker %1 overrun").arg(index)),
+          m_stop(false) {
+    if (spillToDisk) {
+        auto pSpillFile = std::make_unique<SpillFile>();
+        if (pSpillFile->open()) {
+            kLogger.info() << "Spilling sidechain samples of worker" << index
+                           << "to" << pSpillFile->fileName();
+            m_pSpillFile = std::move(pSpillFile);
+            m_pSpillThread = std::make_unique<SpillThread>(this);
+        } else {
+            kLogger.warning() << "Failed to create a spill file, worker" << index
+                              << "reads from memory only";
+        }
+    }
+}
+
+SideChainWorkerThread::~SideChainWorkerThread() {
+    stopProcessing();
+    SampleUtil::free(m_pWorkBuffer);
+}
+
+void SideChainWorkerThread::startProcessing() {
+    // We use HighPriority to prevent starvation by lower-priority processes (Qt
+    // main thread, analysis, etc.). This used to be LowPriority but that is not
+    // a suitable choice since we do semi-realtime tasks
+    // in the sidechain thread. To get reliable timing, it's important
+    // that this work be prioritized over the GUI and non-realtime tasks. See
+    // discussion on issue #7272 and https://bugs.launchpad.net/mixxx/1.11/+bug/1194543.
+    if (m_pSpillThread) {
+        m_pSpillThread->start(QThread::HighPriority);
+    }
+    start(QThread::HighPriority);
+}
+
+void SideChainWorkerThread::stopProcessing() {
+    m_stop.store(true, std::memory_order_release);
+    m_pWaitLock->lock();
+    m_pWaitForSamples->wakeAll();
+    m_pWaitLock->unlock();
+    if (m_pSpillFile) {
+        m_pSpillFile->wakeAll();
+    }
+
+    if (m_pSpillThread) {
+        m_pSpillThread->wait();
+    }
+    wait();
+}
+
+std::uint64_t SideChainWorkerThread::lag() const {
+    std::uint64_t lag = m_reader.readAvailable();
+    if (m_pSpillFile) {
+        lag += m_pSpillFile->pendingSamples();
+    }
+    return lag;
+}
+
+void SideChainWorkerThread::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("EngineSideChain %1").arg(m_index));
+    mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::SideChain);
+    if (m_pSpillFile) {
+        processFromSpillFile();
+    } else {
+        processFromRingBuffer();
+    }
+}
+
+void SideChainWorkerThread::processFromRingBuffer() {
+    const QString tag = QStringLiteral("EngineSideChain %1").arg(m_index);
+    Event::start(tag);
+    while (!m_stop.load(std::memory_order_acquire)) {
+        // Sleep until samples are available.
+        m_pWaitLock->lock();
+        Event::end(tag);
+        if (m_reader.readAvailable() < kWakeUpThreshold) {
+            m_pWaitForSamples->wait(m_pWaitLock, kMaxWaitMillis);
+        }
+        m_pWaitLock->unlock();
+        Event::start(tag);
+
+        std::uint64_t droppedSamples = 0;
+        SINT samplesRead;
+        while (!m_stop.load(std::memory_order_acquire) &&
+                ((samplesRead = m_reader.read(m_pWorkBuffer,
+                          EngineSideChain::SIDECHAIN_BUFFER_SIZE,
+                          &droppedSamples)) > 0 ||
+                        droppedSamples > 0)) {
+            if (droppedSamples > 0) {
+                // This worker fell behind, the others are not affected
+                m_overrunCounter.increment();
+                processSilence(droppedSamples);
+            }
+            if (samplesRead > 0) {
+                Trace process("EngineSideChain::process");
+                m_pWorker->process(m_pWorkBuffer, samplesRead);
+            }
+        }
+    }
+}
+
+void SideChainWorkerThread::processFromSpillFile() {
+    while (!m_stop.load(std::memory_order_acquire)) {
+        m_pSpillFile->waitForSamples();
+        SINT samplesRead;
+        while (!m_stop.load(std::memory_order_acquire) &&
+                (samplesRead = m_pSpillFile->read(m_pWorkBuffer,
+                         EngineSideChain::SIDECHAIN_BUFFER_SIZE)) > 0) {
+            Trace process("EngineSideChain::process");
+            m_pWorker->process(m_pWorkBuffer, samplesRead);
+        }
+    }
+}
+
+void SideChainWorkerThread::processSilence(std::uint64_t numSamples) {
+    SampleUtil::clear(m_pWorkBuffer, EngineSideChain::SIDECHAIN_BUFFER_SIZE);
+    while (numSamples > 0 && !m_stop.load(std::memory_order_acquire)) {
+        const SINT chunkSize = static_cast<SINT>(std::min(numSamples,
+                static_cast<std::uint64_t>(EngineSideChain::SIDECHAIN_BUFFER_SIZE)));
+        m_pWorker->process(m_pWorkBuffer, chunkSize);
+        numSamples -= chunkSize;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+#include "engine/sidechain/sidechainringbuffer.h"
+#include "util/counter.h"
+#include "util/types.h"
+
+class SideChainWorker;
+
+/// Feeds a single SideChainWorker from the sidechain ring buffer in a
+/// dedicated thread.
+///
+/// Each worker has its own read cursor. If a worker does not keep up, only
+/// that worker loses samples. Lost samples are replaced by silence, so the
+/// output stays aligned with the stream positions of the ring buffer.
+///
+/// With spill-to-disk enabled, a second thread moves the samples from the
+/// ring buffer into a temporary file and the worker reads them from there.
+/// A slow worker then delays the processing instead of losing samples.
+class SideChainWorkerThread : public QThread {
+  public:
+    /// The wait condition is woken by the producer when new samples are
+    /// available. The worker is not owned by this thread.
+    SideChainWorkerThread(SideChainWorker* pWorker,
+            const SideChainRingBuffer* pRingBuffer,
+            QMutex* pWaitLock,
+            QWaitCondition* pWaitForSamples,
+            int index,
+            bool spillToDisk);
+    ~SideChainWorkerThread() override;
+
+    /// Start the thread(s) with the priority used for all sidechain work.
+    void startProcessing();
+
+    /// Ask the thread(s) to exit and wait until they have finished.
+    void stopProcessing();
+
+    /// The number of samples the worker is behind the producer.
+    std::uint64_t lag() const;
+
+  private:
+    class SpillFile;
+    class SpillThread;
+
+    void run() override;
+
+    void processFromRingBuffer();
+    void processFromSpillFile();
+    void processSilence(std::uint64_t numSamples);
+
+    SideChainWorker* const m_pWorker;
+    QMutex* const m_pWaitLock;
+    QWaitCondition* const m_pWaitForSamples;
+    const int m_index;
+
+    SideChainRingBuffer::Reader m_reader;
+    CSAMPLE* const m_pWorkBuffer;
+    Counter m_overrunCounter;
+    std::atomic<bool> m_stop;
+
+    // Only set in spill-to-disk mode
+    std::unique_ptr<SpillFile> m_pSpillFile;
+    std::unique_ptr<SpillThread> m_pSpillThread;
+};
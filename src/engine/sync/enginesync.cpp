@@ -672,13 +672,10 @@ void EngineSync::updateLeaderInstantaneousBpm(Syncable* pSource, mixxx::Bpm bpm)
     if (pSource != m_pInternalClock) {
         m_pInternalClock->updateInstantaneousBpm(bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
-            continue;
-        }
-        pSyncable->updateInstantaneousBpm(bpm);
-    }
+    // This happens on every callback. Instead of notifying every Syncable,
+    // the SyncControls read the snapshot before they calculate their rate.
+    m_leaderSnapshot.instantaneousBpm = bpm;
+    m_leaderSnapshot.instantaneousBpmSequence++;
 }
 
 void EngineSync::updateLeaderBeatDistance(Syncable* pSource, double beatDistance) {
@@ -687,16 +684,13 @@ void EngineSync::updateLeaderBeatDistance(Syncable* pSource, double beatDistance
                         << (pSource ? pSource->getGroup() : "null")
                         << beatDistance;
     }
+    // Publish before the internal clock is updated. It publishes the
+    // same beat distance again, so the source receives it as well.
+    m_leaderSnapshot.beatDistance = beatDistance;
+    m_leaderSnapshot.beatDistanceSequence++;
     if (pSource != m_pInternalClock) {
         m_pInternalClock->updateLeaderBeatDistance(beatDistance);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
-            continue;
-        }
-        pSyncable->updateLeaderBeatDistance(beatDistance);
-    }
 }
 
 void EngineSync::reinitLeaderParams(Syncable* pSource) {
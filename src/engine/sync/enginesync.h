@@ -69,6 +69,12 @@ class EngineSync : public SyncableListener {
     /// are not audible.
     bool otherSyncedPlaying(const QString& group);
 
+    /// The latest beat distance and instantaneous BPM of the leader, read by
+    /// the synchronized SyncControls instead of being notified one by one.
+    const SyncLeaderSnapshot& getLeaderSnapshot() const {
+        return m_leaderSnapshot;
+    }
+
     void addSyncableDeck(Syncable* pSyncable);
     EngineChannel* getLeaderChannel() const;
     void onCallbackStart(mixxx::audio::SampleRate sampleRate, std::size_t bufferSize);
@@ -119,12 +125,12 @@ class EngineSync : public SyncableListener {
     /// Set the BPM on every sync-enabled Syncable except pSource.
     void updateLeaderBpm(Syncable* pSource, mixxx::Bpm bpm);
 
-    /// Set the Leader instantaneous BPM on every sync-enabled Syncable except
-    /// pSource.
+    /// Publish the Leader instantaneous BPM in the snapshot for the
+    /// sync-enabled Syncables.
     void updateLeaderInstantaneousBpm(Syncable* pSource, mixxx::Bpm bpm);
 
-    /// Set the Leader beat distance on every sync-enabled Syncable except
-    /// pSource.
+    /// Publish the Leader beat distance in the snapshot for the sync-enabled
+    /// Syncables.
     void updateLeaderBeatDistance(Syncable* pSource, double beatDistance);
 
     /// Initialize the leader parameters using the provided syncable as the source.
@@ -167,4 +173,6 @@ class EngineSync : public SyncableListener {
     Syncable* m_pLeaderSyncable;
     /// The list of all Syncables registered via addSyncableDeck.
     QList<Syncable*> m_syncables;
+    /// The per-callback state of the leader.
+    SyncLeaderSnapshot m_leaderSnapshot;
 };
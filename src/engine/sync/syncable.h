@@ -152,6 +152,19 @@ class Syncable {
     virtual void updateInstantaneousBpm(mixxx::Bpm bpm) = 0;
 };
 
+/// The state of the leader that changes with every callback. EngineSync
+/// publishes it once per change instead of notifying every synchronized
+/// Syncable. The Syncables read it when they need it, and compare the
+/// sequence numbers with the ones they have already applied.
+struct SyncLeaderSnapshot {
+    /// Incremented whenever the beat distance is published
+    quint64 beatDistanceSequence = 0;
+    double beatDistance = 0.0;
+    /// Incremented whenever the instantaneous BPM is published
+    quint64 instantaneousBpmSequence = 0;
+    mixxx::Bpm instantaneousBpm;
+};
+
 /// SyncableListener is an interface class used by EngineSync to receive
 /// information about sync change requests.
 class SyncableListener {
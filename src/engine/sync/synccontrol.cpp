@@ -34,6 +34,8 @@ SyncControl::SyncControl(const QString& group,
           m_bOldScratching(false),
           m_leaderBpmAdjustFactor(kBpmUnity),
           m_unmultipliedTargetBeatDistance(0.0),
+          m_leaderBeatDistanceSequence(0),
+          m_leaderInstantaneousBpmSequence(0),
           m_pBpm(nullptr),
           m_pLocalBpm(nullptr),
           m_pRateRatio(nullptr),
@@ -209,7 +211,7 @@ double SyncControl::adjustSyncBeatDistance(double beatDistance) const {
     // This is the inverse of the updateTargetBeatDistance function below.
     if (m_leaderBpmAdjustFactor == kBpmDouble) {
         beatDistance /= kBpmDouble;
-        if (m_unmultipliedTargetBeatDistance >= 0.5) {
+        if (unmultipliedTargetBeatDistance() >= 0.5) {
             beatDistance += 0.5;
         }
     } else if (m_leaderBpmAdjustFactor == kBpmHalve) {
@@ -243,6 +245,8 @@ void SyncControl::updateLeaderBeatDistance(double beatDistance) {
     // the multiplier if in effect.  This way all of the multiplier logic
     // is contained in this single class.
     m_unmultipliedTargetBeatDistance = beatDistance;
+    // This value is newer than the snapshot
+    m_leaderBeatDistanceSequence = m_pEngineSync->getLeaderSnapshot().beatDistanceSequence;
     // Update the target beat distance based on the multiplier.
     updateTargetBeatDistance();
 }
@@ -303,8 +307,30 @@ void SyncControl::updateTargetBeatDistance() {
     updateTargetBeatDistance(frameInfo().currentPosition);
 }
 
+void SyncControl::readLeaderSnapshot() {
+    if (!isSynchronized()) {
+        return;
+    }
+    const SyncLeaderSnapshot& snapshot = m_pEngineSync->getLeaderSnapshot();
+    if (snapshot.instantaneousBpmSequence != m_leaderInstantaneousBpmSequence) {
+        updateInstantaneousBpm(snapshot.instantaneousBpm);
+    }
+    if (snapshot.beatDistanceSequence != m_leaderBeatDistanceSequence) {
+        updateLeaderBeatDistance(snapshot.beatDistance);
+    }
+}
+
+double SyncControl::unmultipliedTargetBeatDistance() const {
+    const SyncLeaderSnapshot& snapshot = m_pEngineSync->getLeaderSnapshot();
+    if (snapshot.beatDistanceSequence != m_leaderBeatDistanceSequence &&
+            isSynchronized()) {
+        return snapshot.beatDistance;
+    }
+    return m_unmultipliedTargetBeatDistance;
+}
+
 void SyncControl::updateTargetBeatDistance(mixxx::audio::FramePos refPosition) {
-    double targetDistance = m_unmultipliedTargetBeatDistance;
+    double targetDistance = unmultipliedTargetBeatDistance();
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << getGroup()
@@ -354,6 +380,8 @@ mixxx::Bpm SyncControl::getBpm() const {
 }
 
 void SyncControl::updateInstantaneousBpm(mixxx::Bpm bpm) {
+    m_leaderInstantaneousBpmSequence =
+            m_pEngineSync->getLeaderSnapshot().instantaneousBpmSequence;
     // Adjust the incoming bpm by the multiplier.
     const double bpmValue = bpm.valueOr(0.0) * m_leaderBpmAdjustFactor;
     m_pBpmControl->updateInstantaneousBpm(bpmValue);
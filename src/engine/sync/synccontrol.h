@@ -53,6 +53,10 @@ class SyncControl : public EngineControl, public Syncable {
     void updateTargetBeatDistance();
     /// This override uses the provided position, and is used after seeks.
     void updateTargetBeatDistance(mixxx::audio::FramePos position);
+    /// Applies the beat distance and instantaneous BPM that the leader has
+    /// published since the last call. Called at the start of each callback
+    /// before the rate is calculated.
+    void readLeaderSnapshot();
     mixxx::Bpm getBaseBpm() const override;
 
     // The local bpm is the base bpm of the track around the current position.
@@ -112,6 +116,9 @@ class SyncControl : public EngineControl, public Syncable {
     double determineBpmMultiplier(mixxx::Bpm myBpm, mixxx::Bpm targetBpm) const;
     mixxx::Bpm fileBpm() const;
     mixxx::Bpm getLocalBpm() const;
+    /// Returns the latest beat distance of the leader, which may have been
+    /// published after it was last applied.
+    double unmultipliedTargetBeatDistance() const;
 
     QString m_sGroup;
     // The only reason we have this pointer is an optimization so that the
@@ -133,6 +140,9 @@ class SyncControl : public EngineControl, public Syncable {
     // It is handy to store the raw reported target beat distance in case the
     // multiplier changes and we need to recalculate the target distance.
     double m_unmultipliedTargetBeatDistance;
+    // The sequence numbers of the SyncLeaderSnapshot values applied last.
+    quint64 m_leaderBeatDistanceSequence;
+    quint64 m_leaderInstantaneousBpmSequence;
     ControlValueAtomic<mixxx::Bpm> m_prevLocalBpm;
     QAtomicInt m_audible;
 
@@ -6,7 +6,9 @@
 #include "analyzer/analyzerscheduledtrack.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "library/analysis/dlganalysis.h"
+#include "library/dao/analysisdao.h"
 #include "library/library.h"
+#include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "moc_analysisfeature.cpp"
 #include "sources/soundsourceproxy.h"
@@ -50,6 +52,7 @@ AnalysisFeature::AnalysisFeature(
         : LibraryFeature(pLibrary, pConfig, QStringLiteral("prepare")),
           m_baseTitle(tr("Analyze")),
           m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_pausedByUser(false),
           m_pSidebarModel(make_parented<TreeItemModel>(this)),
           m_pAnalysisView(nullptr),
           m_title(m_baseTitle) {
@@ -94,7 +97,15 @@ void AnalysisFeature::bindLibraryWidget(WLibrary* libraryWidget,
     connect(m_pAnalysisView,
             &DlgAnalysis::stopAnalysis,
             this,
-            &AnalysisFeature::stopAnalysis);
+            &AnalysisFeature::cancelAnalysis);
+    connect(m_pAnalysisView,
+            &DlgAnalysis::pauseAnalysis,
+            this,
+            &AnalysisFeature::pauseAnalysis);
+    connect(m_pAnalysisView,
+            &DlgAnalysis::continueQueuedAnalysis,
+            this,
+            &AnalysisFeature::continueQueuedAnalysis);
 
     connect(m_pAnalysisView,
             &DlgAnalysis::trackSelected,
@@ -110,6 +121,8 @@ void AnalysisFeature::bindLibraryWidget(WLibrary* libraryWidget,
 
     // Let the DlgAnalysis know whether or not analysis is active.
     emit analysisActive(static_cast<bool>(m_pTrackAnalysisScheduler));
+    // Tracks that have not been analyzed before the last shutdown
+    m_pAnalysisView->setQueuedTracksCount(analysisDao().countQueuedTracks());
 
     libraryWidget->registerView(kViewName, m_pAnalysisView);
 }
@@ -133,7 +146,25 @@ void AnalysisFeature::activate() {
     emit enableCoverArtDisplay(true);
 }
 
+AnalysisDao& AnalysisFeature::analysisDao() const {
+    return m_pLibrary->trackCollectionManager()->internalCollection()->getAnalysisDAO();
+}
+
 void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks) {
+    analysisDao().enqueueTracks(tracks);
+    scheduleTracks(tracks);
+}
+
+void AnalysisFeature::continueQueuedAnalysis() {
+    const QList<AnalyzerScheduledTrack> tracks = analysisDao().getQueuedTracks();
+    kLogger.info()
+            << "Continuing analysis of"
+            << tracks.size()
+            << "queued tracks";
+    scheduleTracks(tracks);
+}
+
+void AnalysisFeature::scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks) {
     if (!m_pTrackAnalysisScheduler) {
         const int numAnalyzerThreads = numberOfAnalyzerThreads();
         kLogger.info()
@@ -168,6 +199,10 @@ void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks)
                 &TrackAnalysisScheduler::trackProgress,
                 this,
                 &AnalysisFeature::trackProgress);
+        connect(m_pTrackAnalysisScheduler.get(),
+                &TrackAnalysisScheduler::trackProgress,
+                this,
+                &AnalysisFeature::onTrackAnalysisSchedulerTrackProgress);
 
         emit analysisActive(true);
     }
@@ -189,6 +224,9 @@ void AnalysisFeature::resumeAnalysis() {
     if (!m_pTrackAnalysisScheduler) {
         return; // inactive
     }
+    if (m_pausedByUser) {
+        return;
+    }
     kLogger.info() << "Resuming analysis";
     m_pTrackAnalysisScheduler->resume();
 }
@@ -201,6 +239,33 @@ void AnalysisFeature::stopAnalysis() {
     m_pTrackAnalysisScheduler->stop();
 }
 
+void AnalysisFeature::pauseAnalysis(bool paused) {
+    if (!m_pTrackAnalysisScheduler) {
+        return; // inactive
+    }
+    m_pausedByUser = paused;
+    if (paused) {
+        suspendAnalysis();
+    } else {
+        resumeAnalysis();
+    }
+}
+
+void AnalysisFeature::cancelAnalysis() {
+    // All remaining tracks are discarded
+    analysisDao().clearQueue();
+    stopAnalysis();
+}
+
+void AnalysisFeature::onTrackAnalysisSchedulerTrackProgress(
+        TrackId trackId, AnalyzerProgress progress) {
+    // Failed tracks are not analyzed again like during the same session.
+    // Tracks that are cancelled by stopping don't report any progress.
+    if (progress == kAnalyzerProgressDone || progress == kAnalyzerProgressUnknown) {
+        analysisDao().dequeueTrack(trackId);
+    }
+}
+
 void AnalysisFeature::onTrackAnalysisSchedulerProgress(
         AnalyzerProgress /*currentTrackProgress*/,
         int currentTrackNumber,
@@ -230,8 +295,12 @@ void AnalysisFeature::onTrackAnalysisSchedulerFinished() {
         // for creating the queue with its worker threads are acceptable.
         m_pTrackAnalysisScheduler.reset();
     }
+    m_pausedByUser = false;
     resetTitle();
     emit analysisActive(false);
+    if (m_pAnalysisView) {
+        m_pAnalysisView->setQueuedTracksCount(analysisDao().countQueuedTracks());
+    }
 }
 
 bool AnalysisFeature::dropAccept(const QList<QUrl>& urls, QObject* pSource) {
@@ -11,6 +11,7 @@
 #include "preferences/usersettings.h"
 #include "util/parented_ptr.h"
 
+class AnalysisDao;
 class DlgAnalysis;
 
 class AnalysisFeature : public LibraryFeature {
@@ -42,13 +43,24 @@ class AnalysisFeature : public LibraryFeature {
 
     void suspendAnalysis();
     void resumeAnalysis();
+    // Stops the analysis and keeps the queue for continuing it later,
+    // e.g. when shutting down
     void stopAnalysis();
 
   private slots:
     void onTrackAnalysisSchedulerProgress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
+    void onTrackAnalysisSchedulerTrackProgress(TrackId trackId, AnalyzerProgress progress);
     void onTrackAnalysisSchedulerFinished();
 
+    // Triggered by the user
+    void pauseAnalysis(bool paused);
+    void continueQueuedAnalysis();
+    void cancelAnalysis();
+
   private:
+    AnalysisDao& analysisDao() const;
+    void scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
+
     // Sets the title of this feature to the default name, given by
     // m_sAnalysisTitleName
     void resetTitle();
@@ -61,6 +73,8 @@ class AnalysisFeature : public LibraryFeature {
     const QString m_baseTitle;
 
     TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+    // Prevents resuming when an ad-hoc analysis of loaded tracks finishes
+    bool m_pausedByUser;
 
     parented_ptr<TreeItemModel> m_pSidebarModel;
     DlgAnalysis* m_pAnalysisView;
@@ -1,5 +1,7 @@
 #include "library/analysis/dlganalysis.h"
 
+#include <QSignalBlocker>
+
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzerscheduledtrack.h"
 #include "library/analysis/ui_dlganalysis.h"
@@ -15,7 +17,8 @@ DlgAnalysis::DlgAnalysis(WLibrary* parent,
                        Library* pLibrary)
         : QWidget(parent),
           m_pConfig(pConfig),
-          m_bAnalysisActive(false) {
+          m_bAnalysisActive(false),
+          m_queuedTracksCount(0) {
     setupUi(this);
     m_songsButtonGroup.addButton(radioButtonRecentlyAdded);
     m_songsButtonGroup.addButton(radioButtonAllSongs);
@@ -68,6 +71,18 @@ DlgAnalysis::DlgAnalysis(WLibrary* parent,
             &DlgAnalysis::analyze);
     pushButtonAnalyze->setEnabled(false);
 
+    connect(pushButtonPause,
+            &QPushButton::toggled,
+            this,
+            [this](bool checked) {
+                pushButtonPause->setText(checked ? tr("Resume") : tr("Pause"));
+                emit pauseAnalysis(checked);
+            });
+    connect(pushButtonContinue,
+            &QPushButton::clicked,
+            this,
+            &DlgAnalysis::continueQueuedAnalysis);
+
     connect(pushButtonSelectAll,
             &QPushButton::clicked,
             this,
@@ -161,7 +176,19 @@ void DlgAnalysis::slotAnalysisActive(bool bActive) {
         pushButtonAnalyze->setText(tr("Analyze"));
         labelProgress->setText("");
         labelProgress->setEnabled(false);
+        // Without emitting pauseAnalysis()
+        const QSignalBlocker blocker(pushButtonPause);
+        pushButtonPause->setChecked(false);
+        pushButtonPause->setText(tr("Pause"));
     }
+    pushButtonPause->setVisible(bActive);
+    pushButtonContinue->setVisible(!bActive && m_queuedTracksCount > 0);
+}
+
+void DlgAnalysis::setQueuedTracksCount(int count) {
+    m_queuedTracksCount = count;
+    pushButtonContinue->setText(tr("Continue (%1 left)").arg(QString::number(count)));
+    pushButtonContinue->setVisible(!m_bAnalysisActive && m_queuedTracksCount > 0);
 }
 
 void DlgAnalysis::onTrackAnalysisSchedulerProgress(
@@ -40,6 +40,8 @@ class DlgAnalysis : public QWidget, public Ui::DlgAnalysis, public virtual Libra
     void slotAnalysisActive(bool bActive);
     void onTrackAnalysisSchedulerProgress(AnalyzerProgress analyzerProgress, int finishedCount, int totalCount);
     void onTrackAnalysisSchedulerFinished();
+    // The number of tracks that remain from a previous analysis
+    void setQueuedTracksCount(int count);
     void showRecentSongs();
     void showAllSongs();
     void installEventFilter(QObject* pFilter);
@@ -49,12 +51,15 @@ class DlgAnalysis : public QWidget, public Ui::DlgAnalysis, public virtual Libra
     void loadTrackToPlayer(TrackPointer pTrack, const QString& player);
     void analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks);
     void stopAnalysis();
+    void pauseAnalysis(bool paused);
+    void continueQueuedAnalysis();
     void trackSelected(TrackPointer pTrack);
 
   private:
     //Note m_pTrackTablePlaceholder is defined in the .ui file
     UserSettingsPointer m_pConfig;
     bool m_bAnalysisActive;
+    int m_queuedTracksCount;
     QButtonGroup m_songsButtonGroup;
     WAnalysisLibraryTableView* m_pAnalysisLibraryTableView;
     AnalysisLibraryTableModel* m_pAnalysisLibraryTableModel;
@@ -1,6 +1,7 @@
 #include "library/baseexternallibraryfeature.h"
 
 #include <QMenu>
+#include <QSqlError>
 
 #include "library/basesqltablemodel.h"
 #include "library/library.h"
@@ -54,6 +55,24 @@ BaseExternalLibraryFeature::BaseExternalLibraryFeature(
             &BaseExternalLibraryFeature::slotImportAsMixxxCrate);
 }
 
+bool BaseExternalLibraryFeature::openWorkerDatabase(
+        QSqlDatabase* pDatabase, const QString& connectionName) const {
+    if (!pDatabase->isValid()) {
+        *pDatabase = QSqlDatabase::cloneDatabase(
+                m_pTrackCollection->database(), connectionName);
+    }
+    if (pDatabase->isOpen()) {
+        return true;
+    }
+    // Open the database connection in this thread.
+    if (!pDatabase->open()) {
+        kLogger.warning() << "Failed to open database connection"
+                          << connectionName << pDatabase->lastError();
+        return false;
+    }
+    return true;
+}
+
 void BaseExternalLibraryFeature::bindSidebarWidget(WLibrarySidebar* pSidebarWidget) {
     // store the sidebar widget pointer for later use in onRightClickChild
     m_pSidebarWidget = pSidebarWidget;
@@ -3,6 +3,7 @@
 #include <QAction>
 #include <QModelIndex>
 #include <QPointer>
+#include <QSqlDatabase>
 #include <memory>
 
 #include "library/dao/playlistdao.h"
@@ -33,6 +34,11 @@ class BaseExternalLibraryFeature : public LibraryFeature {
     // Must be implemented by external Libraries not copied to Mixxx DB
     virtual void appendTrackIdsFromRightClickIndex(QList<TrackId>* trackIds, QString* pPlaylist);
 
+    /// Clones and opens the database connection of the import worker on
+    /// first use. Features are constructed when building the sidebar, but
+    /// this connection is only needed once the import has been started.
+    bool openWorkerDatabase(QSqlDatabase* pDatabase, const QString& connectionName) const;
+
   private slots:
     void slotAddToAutoDJ();
     void slotAddToAutoDJTop();
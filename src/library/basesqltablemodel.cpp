@@ -6,6 +6,7 @@
 
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
+#include "library/searchqueryparser.h"
 #include "library/starrating.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
@@ -20,6 +21,7 @@
 #include "util/duration.h"
 #include "util/performancetimer.h"
 #include "util/platform.h"
+#include "util/tracing.h"
 
 namespace {
 
@@ -45,10 +47,18 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_bSelectAsync(false),
+          m_selectQueryId(0),
+          m_bAppendFetchedRows(false),
+          m_bFetchedFirstRows(false),
+          m_bShowingSnapshot(false),
+          m_bInitialized(false),
+          m_bRowsRefinable(false),
+          m_rowsTrackSourceGeneration(0) {
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    abortSelect();
 }
 
 void BaseSqlTableModel::initHeaderProperties() {
@@ -165,6 +175,7 @@ void BaseSqlTableModel::clearRows() {
         m_rowInfo.clear();
         m_trackIdToRows.clear();
         m_trackPosToRow.clear();
+        m_bShowingSnapshot = false;
         endRemoveRows();
     }
     DEBUG_ASSERT(m_rowInfo.isEmpty());
@@ -190,40 +201,87 @@ void BaseSqlTableModel::replaceRows(
     }
     if (rows.isEmpty()) {
         clearRows();
-    } else {
-        beginInsertRows(QModelIndex(), 0, rows.size() - 1);
-        m_rowInfo = rows;
-        m_trackIdToRows = trackIdToRows;
-        m_trackPosToRow = trackPosToRows;
-        endInsertRows();
-    }
-}
-
-void BaseSqlTableModel::select() {
-    if (!m_bInitialized) {
         return;
     }
-    // We should be able to detect when a select() would be a no-op. The DAO's
-    // do not currently broadcast signals for when common things happen. In the
-    // future, we can turn this check on and avoid a lot of needless
-    // select()'s. rryan 9/2011
-    // if (!m_bDirty) {
-    //     if (sDebug) {
-    //         qDebug() << this << "Skipping non-dirty select()";
-    //     }
-    //     return;
-    // }
 
-    if (sDebug) {
-        qDebug() << this << "select()";
+    // Only the rows between the unchanged first and last rows are replaced.
+    // This preserves the selection and the delegates of views if only a few
+    // tracks have been added or removed, e.g. after editing a playlist. The
+    // current rows are only removed after(!) the new rows have been queried
+    // successfully. See issue #6782.
+    const auto isSameRow = [](const RowInfo& lhs, const RowInfo& rhs) {
+        return lhs.trackId == rhs.trackId && lhs.columnValues == rhs.columnValues;
+    };
+    const int oldRowCount = m_rowInfo.size();
+    const int newRowCount = rows.size();
+    int firstChangedRow = 0;
+    while (firstChangedRow < oldRowCount && firstChangedRow < newRowCount &&
+            isSameRow(m_rowInfo[firstChangedRow], rows[firstChangedRow])) {
+        ++firstChangedRow;
+    }
+    int unchangedTailRows = 0;
+    while (unchangedTailRows < oldRowCount - firstChangedRow &&
+            unchangedTailRows < newRowCount - firstChangedRow &&
+            isSameRow(m_rowInfo[oldRowCount - 1 - unchangedTailRows],
+                    rows[newRowCount - 1 - unchangedTailRows])) {
+        ++unchangedTailRows;
+    }
+    const int removedRowCount = oldRowCount - firstChangedRow - unchangedTailRows;
+    const int insertedRowCount = newRowCount - firstChangedRow - unchangedTailRows;
+
+    if (removedRowCount > 0) {
+        beginRemoveRows(QModelIndex(), firstChangedRow, firstChangedRow + removedRowCount - 1);
+        m_rowInfo.remove(firstChangedRow, removedRowCount);
+        // The rows of a snapshot never match the actual rows
+        m_bShowingSnapshot = false;
+        endRemoveRows();
+    }
+    if (insertedRowCount > 0) {
+        beginInsertRows(QModelIndex(),
+                firstChangedRow,
+                firstChangedRow + insertedRowCount - 1);
+    }
+    m_rowInfo = rows;
+    m_trackIdToRows = trackIdToRows;
+    m_trackPosToRow = trackPosToRows;
+    if (insertedRowCount > 0) {
+        endInsertRows();
+    }
+    // Only the table columns have been compared, the values of the track
+    // source might have changed
+    const int lastColumn = columnCount() - 1;
+    if (firstChangedRow > 0) {
+        emit dataChanged(index(0, 0), index(firstChangedRow - 1, lastColumn));
+    }
+    if (unchangedTailRows > 0) {
+        emit dataChanged(index(newRowCount - unchangedTailRows, 0),
+                index(newRowCount - 1, lastColumn));
     }
+}
 
-    PerformanceTimer time;
-    time.start();
+QString BaseSqlTableModel::selectQueryString() const {
+    // Query for id and all columns not in m_trackSource
+    return QString("SELECT %1 FROM %2 %3")
+            .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+}
 
-    // Prepare query for id and all columns not in m_trackSource
-    QString queryString = QString("SELECT %1 FROM %2 %3")
-                                  .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+BaseSqlTableModel::RowInfo BaseSqlTableModel::rowInfoFromColumnValues(
+        QVector<QVariant>&& columnValues,
+        int row) const {
+    RowInfo rowInfo;
+    // TODO(XXX): Can we get rid of the hard-coded assumption that
+    // the the first column always contains the id?
+    rowInfo.trackId = TrackId(columnValues.value(kIdColumn));
+    rowInfo.row = row;
+    rowInfo.columnValues = std::move(columnValues);
+    rowInfo.columnValues.resize(m_tableColumns.size());
+    return rowInfo;
+}
+
+bool BaseSqlTableModel::queryRows(QVector<RowInfo>* pRowInfos,
+        QSet<TrackId>* pTrackIds,
+        int* pPosColumn) {
+    const QString queryString = selectQueryString();
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -235,25 +293,17 @@ void BaseSqlTableModel::select() {
     query.setForwardOnly(true);
     if (!query.prepare(queryString)) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
-    QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
     int idColumn = -1;
-    int posColumn = -1;
     while (query.next()) {
         QSqlRecord sqlRecord = query.record();
 
@@ -261,8 +311,8 @@ void BaseSqlTableModel::select() {
             idColumn = sqlRecord.indexOf(m_idColumn);
         }
 
-        if (posColumn == -1 && hasPositionColumn()) {
-            posColumn = sqlRecord.indexOf(PLAYLISTTABLE_POSITION);
+        if (*pPosColumn == -1 && hasPositionColumn()) {
+            *pPosColumn = sqlRecord.indexOf(PLAYLISTTABLE_POSITION);
         }
 
         // TODO(XXX): Can we get rid of the hard-coded assumption that
@@ -273,27 +323,252 @@ void BaseSqlTableModel::select() {
             qCritical()
                     << "ID column not available in database query results:"
                     << m_idColumn;
-            return;
+            return false;
         }
 
         TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
+        pTrackIds->insert(trackId);
 
         RowInfo rowInfo;
         rowInfo.trackId = trackId;
-        rowInfo.row = rowInfos.size();
+        rowInfo.row = pRowInfos->size();
 
         rowInfo.columnValues.reserve(sqlRecord.count());
         for (int i = 0; i < m_tableColumns.size(); ++i) {
             rowInfo.columnValues.push_back(sqlRecord.value(i));
         }
-        rowInfos.push_back(rowInfo);
+        pRowInfos->push_back(rowInfo);
+    }
+
+    if (sDebug) {
+        qDebug() << "Rows actually received:" << pRowInfos->size();
+    }
+    return true;
+}
+
+void BaseSqlTableModel::select() {
+    MIXXX_TRACE_SCOPE("BaseSqlTableModel::select");
+    if (!m_bInitialized) {
+        return;
+    }
+    // We should be able to detect when a select() would be a no-op. The DAO's
+    // do not currently broadcast signals for when common things happen. In the
+    // future, we can turn this check on and avoid a lot of needless
+    // select()'s. rryan 9/2011
+    // if (!m_bDirty) {
+    //     if (sDebug) {
+    //         qDebug() << this << "Skipping non-dirty select()";
+    //     }
+    //     return;
+    // }
+
+    if (sDebug) {
+        qDebug() << this << "select()";
+    }
+
+    // The outstanding rows are outdated
+    abortSelect();
+
+    m_selectTimer.start();
+
+    QVector<RowInfo> rowInfos;
+    QSet<TrackId> trackIds;
+    int posColumn = -1;
+    if (canRefineRows()) {
+        // The search has been extended, e.g. by typing into the search box.
+        // Tracks that didn't match the previous search can't match now, so
+        // only the current rows need to be filtered and the table doesn't
+        // need to be queried again.
+        rowInfos = m_rowInfo;
+        trackIds.reserve(m_trackIdToRows.size());
+        for (auto it = m_trackIdToRows.constBegin(); it != m_trackIdToRows.constEnd(); ++it) {
+            trackIds.insert(it.key());
+        }
+        if (hasPositionColumn()) {
+            posColumn = m_tableColumns.indexOf(PLAYLISTTABLE_POSITION);
+        }
+    } else if (m_bSelectAsync && startSelectAsync()) {
+        showStartupSnapshot();
+        return;
+    } else if (!queryRows(&rowInfos, &trackIds, &posColumn)) {
+        return;
+    }
+
+    applyRows(std::move(rowInfos), trackIds, posColumn);
+}
+
+void BaseSqlTableModel::abortSelect() {
+    if (m_selectQueryId == 0) {
+        return;
+    }
+    m_selectQueryId = 0;
+    TrackTableQueryThread* pQueryThread =
+            m_pTrackCollectionManager->trackTableQueryThread();
+    VERIFY_OR_DEBUG_ASSERT(pQueryThread) {
+        return;
+    }
+    pQueryThread->abort(this);
+    m_fetchedRows.clear();
+    m_fetchedTrackIds.clear();
+    // The current rows might be incomplete
+    m_bRowsRefinable = false;
+    if (sDebug) {
+        qDebug() << this << "select() aborted";
+    }
+}
+
+bool BaseSqlTableModel::startSelectAsync() {
+    DEBUG_ASSERT(m_selectQueryId == 0);
+    TrackTableQueryThread* pQueryThread =
+            m_pTrackCollectionManager->trackTableQueryThread();
+    if (!pQueryThread) {
+        return false;
+    }
+    TrackTableQueryThread::Query query;
+    query.queryString = selectQueryString();
+    query.temporaryViewSql = TrackTableQueryThread::temporaryViewSql(
+            m_database, m_tableName);
+    if (!query.temporaryViewSql.isEmpty()) {
+        query.temporaryViewName = m_tableName;
     }
 
     if (sDebug) {
-        qDebug() << "Rows actually received:" << rowInfos.size();
+        qDebug() << this << "select() fetching:" << query.queryString;
+    }
+
+    // The order of tracks that are sorted by the track source is only
+    // known after all rows have been fetched.
+    m_bAppendFetchedRows = m_trackSourceOrderBy.isEmpty();
+    m_bFetchedFirstRows = false;
+    m_bRowsRefinable = false;
+    m_fetchedRows.clear();
+    m_fetchedTrackIds.clear();
+    // Rows of outdated queries are ignored, see onRowsFetched()
+    const quint64 queryId = pQueryThread->submit(this,
+            std::move(query),
+            [this](quint64 queryId,
+                    TrackTableQueryThread::Rows rows,
+                    TrackTableQueryThread::Status status) {
+                onRowsFetched(queryId, std::move(rows), status);
+            });
+    m_selectQueryId = queryId;
+    return true;
+}
+
+void BaseSqlTableModel::onRowsFetched(
+        quint64 queryId,
+        TrackTableQueryThread::Rows&& rows,
+        TrackTableQueryThread::Status status) {
+    if (queryId != m_selectQueryId) {
+        // Outdated
+        return;
+    }
+    if (status == TrackTableQueryThread::Status::Failed) {
+        qDebug() << this << "select() falls back to querying synchronously";
+        m_selectQueryId = 0;
+        m_fetchedRows.clear();
+        m_fetchedTrackIds.clear();
+        QVector<RowInfo> rowInfos;
+        QSet<TrackId> trackIds;
+        int posColumn = -1;
+        if (queryRows(&rowInfos, &trackIds, &posColumn)) {
+            applyRows(std::move(rowInfos), trackIds, posColumn);
+        }
+        return;
+    }
+
+    QVector<RowInfo> rowInfos;
+    rowInfos.reserve(rows.size());
+    QSet<TrackId> trackIds;
+    trackIds.reserve(rows.size());
+    for (auto& columnValues : rows) {
+        RowInfo rowInfo = rowInfoFromColumnValues(
+                std::move(columnValues),
+                m_fetchedRows.size() + rowInfos.size());
+        trackIds.insert(rowInfo.trackId);
+        rowInfos.push_back(std::move(rowInfo));
+    }
+
+    if (m_bAppendFetchedRows) {
+        if (!m_bFetchedFirstRows) {
+            // Remove the previous rows only after(!) the query has been
+            // executed successfully. See issue #6782.
+            clearRows();
+            m_bFetchedFirstRows = true;
+        }
+        appendFilteredRows(std::move(rowInfos), trackIds);
+    } else {
+        m_fetchedRows += rowInfos;
+        m_fetchedTrackIds += trackIds;
+    }
+
+    if (status != TrackTableQueryThread::Status::Complete) {
+        return;
+    }
+    m_selectQueryId = 0;
+    if (m_bAppendFetchedRows) {
+        finishSelect();
+    } else {
+        const int posColumn = hasPositionColumn()
+                ? m_tableColumns.indexOf(PLAYLISTTABLE_POSITION)
+                : -1;
+        QVector<RowInfo> fetchedRows = std::move(m_fetchedRows);
+        m_fetchedRows.clear();
+        const QSet<TrackId> fetchedTrackIds = std::move(m_fetchedTrackIds);
+        m_fetchedTrackIds.clear();
+        applyRows(std::move(fetchedRows), fetchedTrackIds, posColumn);
     }
+}
+
+void BaseSqlTableModel::appendFilteredRows(
+        QVector<RowInfo>&& rowInfos,
+        const QSet<TrackId>& trackIds) {
+    DEBUG_ASSERT(m_trackSourceOrderBy.isEmpty());
+    if (m_trackSource && !trackIds.isEmpty()) {
+        // Only used for filtering, the order of the table is preserved
+        QHash<TrackId, int> matchingTracks;
+        m_trackSource->filterAndSort(trackIds,
+                m_currentSearch,
+                m_currentSearchFilter,
+                m_trackSourceOrderBy,
+                m_sortColumns,
+                m_tableColumns.size() - 1, // exclude the 1st column with the id
+                &matchingTracks);
+        rowInfos.erase(
+                std::remove_if(
+                        rowInfos.begin(),
+                        rowInfos.end(),
+                        [&matchingTracks](const RowInfo& rowInfo) {
+                            return !matchingTracks.contains(rowInfo.trackId);
+                        }),
+                rowInfos.end());
+    }
+    if (rowInfos.isEmpty()) {
+        return;
+    }
+
+    const int posColumn = hasPositionColumn()
+            ? m_tableColumns.indexOf(PLAYLISTTABLE_POSITION)
+            : -1;
+    const int firstRow = m_rowInfo.size();
+    beginInsertRows(QModelIndex(), firstRow, firstRow + rowInfos.size() - 1);
+    m_rowInfo.reserve(firstRow + rowInfos.size());
+    for (auto& rowInfo : rowInfos) {
+        const int row = m_rowInfo.size();
+        rowInfo.row = row;
+        m_trackIdToRows[rowInfo.trackId].push_back(row);
+        if (posColumn >= 0) {
+            m_trackPosToRow.insert(rowInfo.getPosition(posColumn), row);
+        }
+        m_rowInfo.push_back(std::move(rowInfo));
+    }
+    endInsertRows();
+}
 
+void BaseSqlTableModel::applyRows(
+        QVector<RowInfo>&& rowInfos,
+        const QSet<TrackId>& trackIds,
+        int posColumn) {
     if (m_trackSource) {
         m_trackSource->filterAndSort(trackIds,
                 m_currentSearch,
@@ -360,8 +635,105 @@ void BaseSqlTableModel::select() {
     // Both rowInfo and trackIdToRows (might) have been moved and
     // must not be used afterwards!
 
+    finishSelect();
+}
+
+void BaseSqlTableModel::finishSelect() {
+    m_bRowsRefinable = true;
+    m_rowsSearch = m_currentSearch;
+    m_rowsSearchFilter = m_currentSearchFilter;
+    m_rowsTableOrderBy = m_tableOrderBy;
+    m_rowsTrackSourceGeneration = m_trackSource ? m_trackSource->generation() : 0;
+
     qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
+             << "results in" << m_selectTimer.elapsed().debugMillisWithUnit();
+    emit selectFinished();
+}
+
+QStringList BaseSqlTableModel::columnNames() const {
+    QStringList names = m_tableColumns;
+    if (m_trackSource) {
+        // Skip the id column of the track source
+        for (int i = 1; i < m_trackSource->columnCount(); ++i) {
+            names.append(m_trackSource->columnNameForFieldIndex(i));
+        }
+    }
+    return names;
+}
+
+QString BaseSqlTableModel::snapshotOrderBy() const {
+    return m_tableOrderBy + QChar(';') + m_trackSourceOrderBy;
+}
+
+TrackTableSnapshot BaseSqlTableModel::takeSnapshot(int maxRows) const {
+    if (!m_bInitialized || isSelecting() || m_bShowingSnapshot ||
+            m_tableOrderBy.contains(QStringLiteral("RANDOM()")) ||
+            m_trackSourceOrderBy.contains(QStringLiteral("RANDOM()"))) {
+        return {};
+    }
+    TrackTableSnapshot snapshot;
+    snapshot.modelKey = modelKey(false);
+    snapshot.orderBy = snapshotOrderBy();
+    snapshot.columns = columnNames();
+    const int rowCount = std::min(maxRows, static_cast<int>(m_rowInfo.size()));
+    snapshot.rows.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        QVector<QVariant> values;
+        values.reserve(snapshot.columns.size());
+        for (int column = 0; column < snapshot.columns.size(); ++column) {
+            QVariant value = rawValue(index(row, column));
+            if (value.userType() >= QMetaType::User) {
+                // Custom types can't be serialized
+                value = QVariant();
+            }
+            values.push_back(std::move(value));
+        }
+        snapshot.rows.push_back(std::move(values));
+    }
+    return snapshot;
+}
+
+void BaseSqlTableModel::showStartupSnapshot() {
+    if (m_startupSnapshot.isEmpty()) {
+        return;
+    }
+    // Only shown once, the snapshot is outdated when the model is selected
+    // again
+    const TrackTableSnapshot snapshot = std::move(m_startupSnapshot);
+    m_startupSnapshot = TrackTableSnapshot();
+    if (!m_rowInfo.isEmpty() ||
+            snapshot.modelKey != modelKey(false) ||
+            snapshot.orderBy != snapshotOrderBy() ||
+            snapshot.columns != columnNames()) {
+        qDebug() << this << "Ignoring the outdated startup snapshot";
+        return;
+    }
+
+    const int posColumn = hasPositionColumn()
+            ? m_tableColumns.indexOf(PLAYLISTTABLE_POSITION)
+            : -1;
+    QVector<RowInfo> rowInfos;
+    rowInfos.reserve(snapshot.rows.size());
+    TrackId2Rows trackIdToRows;
+    TrackPos2Row trackPosToRows;
+    for (const auto& values : snapshot.rows) {
+        RowInfo rowInfo;
+        rowInfo.trackId = TrackId(values.value(kIdColumn));
+        rowInfo.row = rowInfos.size();
+        rowInfo.columnValues = values;
+        trackIdToRows[rowInfo.trackId].push_back(rowInfo.row);
+        if (posColumn >= 0) {
+            trackPosToRows.insert(rowInfo.getPosition(posColumn), rowInfo.row);
+        }
+        rowInfos.push_back(std::move(rowInfo));
+    }
+    replaceRows(
+            std::move(rowInfos),
+            std::move(trackIdToRows),
+            std::move(trackPosToRows));
+    m_bShowingSnapshot = true;
+    qDebug() << this << "Showing" << m_rowInfo.size()
+             << "rows of the startup snapshot";
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -371,8 +743,11 @@ void BaseSqlTableModel::setTable(QString tableName,
     if (sDebug) {
         qDebug() << this << "setTable" << tableName << tableColumns << idColumn;
     }
+    // The outstanding rows belong to the previous table
+    abortSelect();
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
+    m_bRowsRefinable = false;
     m_tableColumns = std::move(tableColumns);
 
     if (m_trackSource) {
@@ -419,6 +794,21 @@ const QString BaseSqlTableModel::currentSearch() const {
     return m_currentSearch;
 }
 
+bool BaseSqlTableModel::canRefineRows() const {
+    if (!m_bRowsRefinable || !m_trackSource) {
+        return false;
+    }
+    // Changes of the track data might let tracks match that are not listed
+    // in the current rows.
+    return m_trackSource->generation() == m_rowsTrackSourceGeneration &&
+            m_currentSearchFilter == m_rowsSearchFilter &&
+            m_tableOrderBy == m_rowsTableOrderBy &&
+            // Always query the table if the search didn't change, because
+            // select() is also invoked after the contents of the table changed.
+            m_currentSearch != m_rowsSearch &&
+            SearchQueryParser::queryIsMoreSpecific(m_rowsSearch, m_currentSearch);
+}
+
 void BaseSqlTableModel::setSearch(const QString& searchText, const QString& extraFilter) {
     if (sDebug) {
         qDebug() << this << "setSearch" << searchText;
@@ -683,6 +1073,11 @@ QVariant BaseSqlTableModel::rawValue(
         return columnValues[column];
     }
 
+    if (m_bShowingSnapshot) {
+        // The track source might not have been indexed yet
+        return rowInfo.columnValues.value(column);
+    }
+
     // Otherwise, return the information from the track record cache for the
     // given track ID
     if (!m_trackSource) {
@@ -856,15 +1251,22 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
         qDebug() << this << "trackChanged" << trackIds.size();
     }
 
-    const int numColumns = columnCount();
+    QVector<int> changedRows;
     for (const auto& trackId : trackIds) {
-        const auto rows = getTrackRows(trackId);
-        for (int row : rows) {
-            //qDebug() << "Row in this result set was updated. Signalling update. track:" << trackId << "row:" << row;
-            QModelIndex topLeft = index(row, 0);
-            QModelIndex bottomRight = index(row, numColumns);
-            emit dataChanged(topLeft, bottomRight);
+        changedRows += getTrackRows(trackId);
+    }
+    std::sort(changedRows.begin(), changedRows.end());
+
+    // Signal adjacent rows at once, e.g. all tracks of an album after
+    // editing its title
+    const int lastColumn = columnCount() - 1;
+    for (int i = 0; i < changedRows.size();) {
+        const int firstRow = changedRows[i];
+        int lastRow = firstRow;
+        while (++i < changedRows.size() && changedRows[i] <= lastRow + 1) {
+            lastRow = changedRows[i];
         }
+        emit dataChanged(index(firstRow, 0), index(lastRow, lastColumn));
     }
 }
 
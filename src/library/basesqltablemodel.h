@@ -6,7 +6,10 @@
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
 #include "library/columncache.h"
+#include "library/tracktablequerythread.h"
+#include "library/tracktablesnapshot.h"
 #include "util/class.h"
+#include "util/performancetimer.h"
 
 class TrackCollectionManager;
 
@@ -69,6 +72,30 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     void select() override;
 
+    // Returns true while the rows are fetched in the background
+    bool isSelecting() const {
+        return m_selectQueryId != 0;
+    }
+    // Discards the rows that have not been fetched yet, e.g. when the
+    // view switches to a different model. The model keeps the rows that
+    // have been fetched so far until the next select().
+    void abortSelect();
+
+    /// Takes a snapshot of the first rows for showing them at the next
+    /// startup. Returns an empty snapshot if the rows are incomplete or
+    /// their order is random.
+    TrackTableSnapshot takeSnapshot(int maxRows) const;
+    /// The snapshot is shown by the first select() that fetches the rows in
+    /// the background, if it matches the state of the model. It is replaced
+    /// as soon as the actual rows are available.
+    void setStartupSnapshot(TrackTableSnapshot snapshot) {
+        m_startupSnapshot = std::move(snapshot);
+    }
+    /// Returns true while the rows of the startup snapshot are shown
+    bool isShowingSnapshot() const {
+        return m_bShowingSnapshot;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from BaseTrackTableModel
     ///////////////////////////////////////////////////////////////////////////
@@ -77,6 +104,10 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     QString modelKey(bool noSearch) const override;
 
+  signals:
+    // Emitted when all rows have been selected
+    void selectFinished();
+
   protected:
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from BaseTrackTableModel
@@ -97,6 +128,14 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     void initHeaderProperties() override;
     virtual void initSortColumnMapping();
 
+    // Lets select() fetch the rows in the background and return immediately.
+    // Only for models that are shown in a view and accessed by the user.
+    // Callers of select() that access the rows afterwards need to wait for
+    // selectFinished().
+    void setSelectAsync(bool selectAsync) {
+        m_bSelectAsync = selectAsync;
+    }
+
     TrackCollectionManager* const m_pTrackCollectionManager;
 
     QList<TrackRef> getTrackRefs(const QModelIndexList& indices) const;
@@ -155,6 +194,41 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     typedef QHash<TrackId, QVector<int>> TrackId2Rows;
     typedef QHash<int, int> TrackPos2Row;
 
+    QString selectQueryString() const;
+    // Reads all rows of the table. Returns false if the query failed.
+    bool queryRows(QVector<RowInfo>* pRowInfos,
+            QSet<TrackId>* pTrackIds,
+            int* pPosColumn);
+    RowInfo rowInfoFromColumnValues(
+            QVector<QVariant>&& columnValues,
+            int row) const;
+
+    // Returns false if the rows need to be selected synchronously
+    bool startSelectAsync();
+    void onRowsFetched(
+            quint64 queryId,
+            TrackTableQueryThread::Rows&& rows,
+            TrackTableQueryThread::Status status);
+    // Filters and sorts the rows of the table before replacing
+    // the current rows
+    void applyRows(
+            QVector<RowInfo>&& rowInfos,
+            const QSet<TrackId>& trackIds,
+            int posColumn);
+    // Appends the rows of the table that match the search
+    void appendFilteredRows(
+            QVector<RowInfo>&& rowInfos,
+            const QSet<TrackId>& trackIds);
+    void finishSelect();
+    // The names of the table columns followed by those of the track source
+    QStringList columnNames() const;
+    QString snapshotOrderBy() const;
+    // Shows the rows of the startup snapshot while the rows are fetched
+    void showStartupSnapshot();
+    // Returns true if the current search is an extension of the search
+    // that produced the current rows.
+    bool canRefineRows() const;
+
     void clearRows();
     void replaceRows(
             QVector<RowInfo>&& rows,
@@ -163,6 +237,22 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     QVector<RowInfo> m_rowInfo;
 
+    // State of the select() that fetches rows in the background
+    bool m_bSelectAsync;
+    quint64 m_selectQueryId;
+    // Rows are appended while fetching if the track source doesn't sort
+    bool m_bAppendFetchedRows;
+    bool m_bFetchedFirstRows;
+    QVector<RowInfo> m_fetchedRows;
+    QSet<TrackId> m_fetchedTrackIds;
+    PerformanceTimer m_selectTimer;
+
+    // Consumed by the first asynchronous select()
+    TrackTableSnapshot m_startupSnapshot;
+    // The rows contain the values of all columns instead of only those
+    // of the table
+    bool m_bShowingSnapshot;
+
     QString m_idColumn;
     QSharedPointer<BaseTrackCache> m_trackSource;
     QStringList m_tableColumns;
@@ -176,5 +266,12 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    // The state that produced the current rows
+    bool m_bRowsRefinable;
+    QString m_rowsSearch;
+    QString m_rowsSearchFilter;
+    QString m_rowsTableOrderBy;
+    quint64 m_rowsTrackSourceGeneration;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
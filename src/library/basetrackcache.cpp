@@ -1,5 +1,11 @@
 #include "library/basetrackcache.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "library/queryutil.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
@@ -9,11 +15,96 @@
 #include "track/keyutils.h"
 #include "track/track.h"
 #include "util/performancetimer.h"
+#include "util/tracing.h"
 
 namespace {
 
 constexpr bool sDebug = false;
 
+// Enough for the searches of the recently visited views
+constexpr int kQueryCacheSize = 16;
+
+// The same as lower() of SQLite, which only converts ASCII characters
+QString toLowerAscii(QString value) {
+    QChar* pChar = value.data();
+    for (int i = 0; i < value.size(); ++i) {
+        const ushort c = pChar[i].unicode();
+        if (c >= 'A' && c <= 'Z') {
+            pChar[i] = QChar(c + ('a' - 'A'));
+        }
+    }
+    return value;
+}
+
+// The same as CAST(value AS INTEGER) of SQLite, which uses the longest
+// prefix that is an integer and 0 if there is none
+qint64 castToInteger(const QString& value) {
+    int i = 0;
+    while (i < value.size() &&
+            (value.at(i) == ' ' || (value.at(i) >= '\t' && value.at(i) <= '\r'))) {
+        ++i;
+    }
+    bool negative = false;
+    if (i < value.size() && (value.at(i) == '-' || value.at(i) == '+')) {
+        negative = value.at(i) == '-';
+        ++i;
+    }
+    constexpr quint64 kMaxMagnitude = std::numeric_limits<qint64>::max();
+    quint64 magnitude = 0;
+    for (; i < value.size() && value.at(i) >= '0' && value.at(i) <= '9'; ++i) {
+        const quint64 digit = value.at(i).unicode() - '0';
+        if (magnitude > (kMaxMagnitude + 1 - digit) / 10) {
+            // Out of range values are clamped
+            return negative ? std::numeric_limits<qint64>::min()
+                            : std::numeric_limits<qint64>::max();
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    if (negative) {
+        return magnitude > kMaxMagnitude
+                ? std::numeric_limits<qint64>::min()
+                : -static_cast<qint64>(magnitude);
+    }
+    return magnitude > kMaxMagnitude
+            ? std::numeric_limits<qint64>::max()
+            : static_cast<qint64>(magnitude);
+}
+
+qint64 castToInteger(double value) {
+    if (value >= static_cast<double>(std::numeric_limits<qint64>::max())) {
+        return std::numeric_limits<qint64>::max();
+    }
+    if (value <= static_cast<double>(std::numeric_limits<qint64>::min())) {
+        return std::numeric_limits<qint64>::min();
+    }
+    return static_cast<qint64>(std::trunc(value));
+}
+
+template<typename T>
+int compareValues(const T& lhs, const T& rhs) {
+    return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
+
+// Sorts the values by compare() and stores their rank at the index that
+// is paired with each value. Equal values get the same rank.
+template<typename T, typename Compare>
+void assignSortRanks(std::vector<std::pair<T, int>>* pValues,
+        Compare compare,
+        QVector<int>* pRanks) {
+    std::sort(pValues->begin(),
+            pValues->end(),
+            [&compare](const std::pair<T, int>& lhs, const std::pair<T, int>& rhs) {
+                return compare(lhs.first, rhs.first) < 0;
+            });
+    int rank = -1;
+    for (std::size_t i = 0; i < pValues->size(); ++i) {
+        if (i == 0 || compare((*pValues)[i - 1].first, (*pValues)[i].first) != 0) {
+            ++rank;
+        }
+        (*pRanks)[(*pValues)[i].second] = rank;
+    }
+}
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -26,12 +117,32 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_idColumn(std::move(idColumn)),
           m_columnCount(columns.size()),
           m_columnsJoined(columns.join(",")),
-          m_columnCache(std::move(columns)),
+          m_columnCache(columns),
           m_pQueryParser(std::make_unique<SearchQueryParser>(
                   pTrackCollection, std::move(searchColumns))),
+          m_queryCache(kQueryCacheSize),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
-          m_database(pTrackCollection->database()) {
+          m_generation(0),
+          m_trackIndex(std::move(columns)),
+          m_database(pTrackCollection->database()),
+          m_sortRanks(m_columnCount) {
+    m_pQueryParser->enableFullTextSearch(m_idColumn);
+    m_memoryUsage = mixxx::MemoryUsage::registerSubsystem(
+            QStringLiteral("TrackCache"),
+            [this] {
+                qint64 bytes = m_trackIndex.estimatedMemoryUsage();
+                for (const auto& sortRanks : std::as_const(m_sortRanks)) {
+                    bytes += sortRanks.ranks.capacity() * sizeof(int);
+                }
+                return bytes;
+            },
+            [this](qint64 budgetBytes) {
+                Q_UNUSED(budgetBytes);
+                for (auto& sortRanks : m_sortRanks) {
+                    sortRanks = SortRanks();
+                }
+            });
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -77,8 +188,9 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     if (sDebug) {
         qDebug() << this << "slotTracksRemoved" << trackIds.size();
     }
+    ++m_generation;
     for (const auto& trackId : std::as_const(trackIds)) {
-        m_trackInfo.remove(trackId);
+        m_trackIndex.removeTrack(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -87,20 +199,26 @@ void BaseTrackCache::slotTrackDirty(TrackId trackId) {
     if (sDebug) {
         qDebug() << this << "slotTrackDirty" << trackId;
     }
+    ++m_generation;
     m_dirtyTracks.insert(trackId);
 }
 
+void BaseTrackCache::slotCratesChanged() {
+    m_queryCache.clear();
+}
+
 void BaseTrackCache::slotTrackClean(TrackId trackId) {
     if (sDebug) {
         qDebug() << this << "slotTrackClean" << trackId;
     }
+    ++m_generation;
     m_dirtyTracks.remove(trackId);
     // The track might have been reloaded from the database
     updateTrackInIndex(trackId);
 }
 
 bool BaseTrackCache::isCached(TrackId trackId) const {
-    return m_trackInfo.contains(trackId);
+    return m_trackIndex.contains(trackId);
 }
 
 void BaseTrackCache::ensureCached(TrackId trackId) {
@@ -196,18 +314,21 @@ bool BaseTrackCache::updateTrackInIndex(
     if (sDebug) {
         qDebug() << "updateTrackInIndex:" << pTrack->getLocation();
     }
+    ++m_generation;
 
     int numColumns = columnCount();
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        // preallocate memory for all columns at once
-        record.resize(numColumns);
+        const int row = m_trackIndex.insertTrack(trackId);
+        const int locationColumn = fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
         for (int i = 0; i < numColumns; ++i) {
-            record[i] = getTrackValueForColumn(pTrack, i);
+            if (i == locationColumn) {
+                // The index stores the location like the database
+                m_trackIndex.setValue(row, i, QDir::fromNativeSeparators(pTrack->getLocation()));
+            } else {
+                m_trackIndex.setValue(row, i, getTrackValueForColumn(pTrack, i));
+            }
         }
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), pTrack);
@@ -243,26 +364,18 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
         return false;
     }
 
+    ++m_generation;
     int numColumns = columnCount();
     int idColumn = query.record().indexOf(m_idColumn);
 
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
 
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
-
+        // The location is stored with Qt separators "/" like in the
+        // database, data() returns it with native separators.
+        const int row = m_trackIndex.insertTrack(trackId);
         for (int i = 0; i < numColumns; ++i) {
-            if (fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION) == i) {
-                // Database stores all locations with Qt separators: "/"
-                // Here we want to cache the display string with native separators.
-                QString location = query.value(i).toString();
-                record[i] = QDir::toNativeSeparators(location);
-            } else {
-                record[i] = query.value(i);
-            }
+            m_trackIndex.setValue(row, i, query.value(i));
         }
     }
 
@@ -285,7 +398,7 @@ void BaseTrackCache::buildIndex() {
     // TODO(rryan) for very large tables, it probably makes more sense to NOT
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
-    m_trackInfo.clear();
+    m_trackIndex.clear();
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -461,20 +574,28 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // TODO(rryan) this code is flawed for columns that contains row-specific
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
-    auto it = m_trackInfo.constFind(trackId);
-    if (it == m_trackInfo.constEnd()) {
+    const int row = m_trackIndex.row(trackId);
+    if (row < 0) {
         return QVariant{};
     }
 
-    const QVector<QVariant>& fields = it.value();
     if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
         // The Key value is determined by either the KEY_ID or KEY column
         const auto columnForKeyId = fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID);
         return KeyUtils::keyFromKeyTextAndIdFields(
-                fields.value(column, QVariant{}),
-                fields.value(columnForKeyId, QVariant{}));
+                m_trackIndex.value(row, column),
+                m_trackIndex.value(row, columnForKeyId));
+    }
+    if (column == fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION)) {
+        // Database stores all locations with Qt separators: "/"
+        // Here we want to return the display string with native separators.
+        const QVariant location = m_trackIndex.value(row, column);
+        if (location.isNull()) {
+            return location;
+        }
+        return QDir::toNativeSeparators(location.toString());
     }
-    return fields.value(column, QVariant{});
+    return m_trackIndex.value(row, column);
 }
 
 void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
@@ -484,6 +605,7 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
                                    const QList<SortColumn>& sortColumns,
                                    const int columnOffset,
                                    QHash<TrackId, int>* trackToIndex) {
+    MIXXX_TRACE_SCOPE("BaseTrackCache::filterAndSort");
     // Skip processing if there are no tracks to filter or sort.
     if (trackIds.size() == 0) {
         return;
@@ -493,71 +615,93 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
-    QStringList idStrings;
     // TODO(rryan) consider making this the data passed in and a separate
     // QVector for output
     QSet<TrackId> dirtyTracks;
-    for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
-        if (m_dirtyTracks.contains(trackId)) {
+    for (const auto& trackId : std::as_const(m_dirtyTracks)) {
+        if (trackIds.contains(trackId)) {
             dirtyTracks.insert(trackId);
         }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
+    std::unique_ptr<QueryNode> pParsedQuery;
+    const QueryNode* pQuery = nullptr;
+    if (extraFilter.isEmpty()) {
+        // The extra filter is an SQL expression that only the database
+        // is able to evaluate.
+        pQuery = parseCachedQuery(searchQuery);
+        if (!filterAndSortIndexed(trackIds,
+                    *pQuery,
+                    orderByClause,
+                    sortColumns,
+                    columnOffset,
+                    trackToIndex)) {
+            pQuery = nullptr;
+        }
     }
 
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
+    if (!pQuery) {
+        QStringList idStrings;
+        idStrings.reserve(trackIds.size());
+        for (const auto& trackId : trackIds) {
+            idStrings << trackId.toString();
+        }
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
+        QStringList queryFragments;
+        if (!extraFilter.isEmpty()) {
+            queryFragments << QString("(%1)").arg(extraFilter);
+        }
+        if (idStrings.size() > 0) {
+            queryFragments << QString("%1 in (%2)")
+                    .arg(m_idColumn, idStrings.join(","));
+        }
 
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+        pParsedQuery = m_pQueryParser->parseQuery(
+                searchQuery,
+                queryFragments.join(" AND "));
+        pQuery = pParsedQuery.get();
 
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
-    }
+        QString filter = pQuery->toSql();
+        if (!filter.isEmpty()) {
+            filter.prepend("WHERE ");
+        }
 
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
+        QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+                .arg(m_idColumn, m_tableName, filter, orderByClause);
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
+        if (sDebug) {
+            qDebug() << this << "select() executing:" << queryString;
+        }
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+        QSqlQuery query(m_database);
+        // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+        // won't allocate a giant in-memory table that we won't use at all.
+        query.setForwardOnly(true);
+        query.prepare(queryString);
 
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
-    }
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+        }
 
-    m_trackOrder.resize(0); // keeps allocated memory
-    trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
-    }
+        int idColumn = query.record().indexOf(m_idColumn);
+        int rows = query.size();
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+        if (sDebug) {
+            qDebug() << "Rows returned:" << rows;
+        }
+
+        m_trackOrder.resize(0); // keeps allocated memory
+        trackToIndex->clear();
+        if (rows > 0) {
+            trackToIndex->reserve(rows);
+            m_trackOrder.reserve(rows);
+        }
+
+        while (query.next()) {
+            TrackId trackId(query.value(idColumn));
+            (*trackToIndex)[trackId] = m_trackOrder.size();
+            m_trackOrder.append(trackId);
+        }
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -635,6 +779,233 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+const QueryNode* BaseTrackCache::parseCachedQuery(const QString& searchQuery) {
+    QueryNode* pQuery = m_queryCache.object(searchQuery);
+    if (!pQuery) {
+        pQuery = m_pQueryParser->parseQuery(searchQuery, QString()).release();
+        // Takes ownership, never fails with a cost of 1
+        m_queryCache.insert(searchQuery, pQuery);
+    }
+    return pQuery;
+}
+
+bool BaseTrackCache::filterAndSortIndexed(const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        const QString& orderByClause,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QHash<TrackId, int>* trackToIndex) {
+    PerformanceTimer timer;
+    timer.start();
+
+    if (!query.prepareEvaluate(m_trackIndex)) {
+        return false;
+    }
+
+    // The columns of the track source follow the columns of the table
+    // except for the shared id column, see BaseSqlTableModel::setSort().
+    std::vector<std::pair<const QVector<int>*, bool>> sortRanksAscending;
+    if (!orderByClause.isEmpty()) {
+        if (orderByClause.contains(QLatin1String("RANDOM()"))) {
+            return false;
+        }
+        for (const auto& sortColumn : sortColumns) {
+            int column;
+            if (sortColumn.m_column > columnOffset) {
+                column = sortColumn.m_column - columnOffset;
+            } else if (sortColumn.m_column == 0) {
+                column = 0;
+            } else {
+                // Other columns of the table are not sorted by the track source
+                continue;
+            }
+            const QVector<int>* pRanks = sortRanks(column);
+            if (!pRanks) {
+                return false;
+            }
+            sortRanksAscending.emplace_back(
+                    pRanks, sortColumn.m_order == Qt::AscendingOrder);
+        }
+    }
+
+    std::vector<int> rows;
+    rows.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        const int row = m_trackIndex.row(trackId);
+        if (row < 0) {
+            // Only the database knows this track
+            return false;
+        }
+        const SqlBool result = query.evaluate(m_trackIndex, row);
+        if (result == SqlBool::True || result == SqlBool::Empty) {
+            rows.push_back(row);
+        }
+    }
+
+    // Ties are ordered by id, which is close to the order of the
+    // database's table scan.
+    std::sort(rows.begin(),
+            rows.end(),
+            [this, &sortRanksAscending](int lhs, int rhs) {
+                for (const auto& [pRanks, ascending] : sortRanksAscending) {
+                    const int lhsRank = pRanks->at(lhs);
+                    const int rhsRank = pRanks->at(rhs);
+                    if (lhsRank != rhsRank) {
+                        return ascending ? lhsRank < rhsRank : lhsRank > rhsRank;
+                    }
+                }
+                return m_trackIndex.trackId(lhs) < m_trackIndex.trackId(rhs);
+            });
+
+    m_trackOrder.resize(0); // keeps allocated memory
+    trackToIndex->clear();
+    trackToIndex->reserve(static_cast<int>(rows.size()));
+    m_trackOrder.reserve(static_cast<int>(rows.size()));
+    for (const int row : rows) {
+        const TrackId trackId = m_trackIndex.trackId(row);
+        (*trackToIndex)[trackId] = m_trackOrder.size();
+        m_trackOrder.append(trackId);
+    }
+
+    if (sDebug) {
+        qDebug() << this << "filterAndSortIndexed returned" << rows.size()
+                 << "of" << trackIds.size() << "tracks after"
+                 << timer.elapsed().debugMillisWithUnit();
+    }
+    return true;
+}
+
+const QVector<int>* BaseTrackCache::sortRanks(int column) {
+    VERIFY_OR_DEBUG_ASSERT(column >= 0 && column < m_sortRanks.size()) {
+        return nullptr;
+    }
+    const ColumnCache::SortMode sortMode = m_columnCache.columnSortModeForFieldIndex(column);
+    if (sortMode == ColumnCache::SortMode::Custom) {
+        return nullptr;
+    }
+    // The key is sorted by the key_id column, see ColumnCache
+    const int valueColumn = sortMode == ColumnCache::SortMode::Key
+            ? fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID)
+            : column;
+    if (valueColumn < 0 || valueColumn >= m_trackIndex.columnCount()) {
+        return nullptr;
+    }
+    const KeyUtils::KeyNotation keyNotation = m_columnCache.keyNotation();
+    const quint64 generation = m_trackIndex.columnGeneration(valueColumn);
+
+    SortRanks& cachedRanks = m_sortRanks[column];
+    if (cachedRanks.valueColumn == valueColumn &&
+            cachedRanks.generation == generation &&
+            (sortMode != ColumnCache::SortMode::Key ||
+                    cachedRanks.keyNotation == keyNotation)) {
+        return &cachedRanks.ranks;
+    }
+
+    // NULL values come first, like in the database
+    QVector<int> ranks(m_trackIndex.rowCount(), -1);
+    switch (m_trackIndex.columnType(valueColumn)) {
+    case ColumnarTrackIndex::ColumnType::Null:
+        break;
+    case ColumnarTrackIndex::ColumnType::Text: {
+        if (sortMode == ColumnCache::SortMode::Key) {
+            return nullptr;
+        }
+        // Rank every distinct string of the column only once
+        QVector<int> stringRanks(m_trackIndex.stringCount(), -1);
+        std::vector<int> stringIds;
+        for (int row = 0; row < m_trackIndex.rowCount(); ++row) {
+            const int stringId = m_trackIndex.stringId(row, valueColumn);
+            if (stringId != ColumnarTrackIndex::kNullStringId && stringRanks[stringId] < 0) {
+                stringRanks[stringId] = 0;
+                stringIds.push_back(stringId);
+            }
+        }
+        if (sortMode == ColumnCache::SortMode::Integer) {
+            std::vector<std::pair<qint64, int>> values;
+            values.reserve(stringIds.size());
+            for (const int stringId : stringIds) {
+                values.emplace_back(castToInteger(m_trackIndex.string(stringId)), stringId);
+            }
+            assignSortRanks(&values, compareValues<qint64>, &stringRanks);
+        } else {
+            std::vector<std::pair<QString, int>> values;
+            values.reserve(stringIds.size());
+            for (const int stringId : stringIds) {
+                QString value = m_trackIndex.string(stringId);
+                values.emplace_back(
+                        sortMode == ColumnCache::SortMode::Default
+                                ? std::move(value)
+                                : toLowerAscii(value),
+                        stringId);
+            }
+            if (sortMode == ColumnCache::SortMode::NoCaseLexicographic) {
+                assignSortRanks(
+                        &values,
+                        [this](const QString& lhs, const QString& rhs) {
+                            return m_collator.compare(lhs, rhs);
+                        },
+                        &stringRanks);
+            } else {
+                assignSortRanks(
+                        &values,
+                        [](const QString& lhs, const QString& rhs) {
+                            return QString::compare(lhs, rhs);
+                        },
+                        &stringRanks);
+            }
+        }
+        for (int row = 0; row < m_trackIndex.rowCount(); ++row) {
+            const int stringId = m_trackIndex.stringId(row, valueColumn);
+            if (stringId != ColumnarTrackIndex::kNullStringId) {
+                ranks[row] = stringRanks[stringId];
+            }
+        }
+        break;
+    }
+    case ColumnarTrackIndex::ColumnType::Number: {
+        if (sortMode == ColumnCache::SortMode::NoCase ||
+                sortMode == ColumnCache::SortMode::NoCaseLexicographic) {
+            // lower() converts numbers to text
+            return nullptr;
+        }
+        if (sortMode == ColumnCache::SortMode::Key) {
+            for (int row = 0; row < m_trackIndex.rowCount(); ++row) {
+                const double keyId = m_trackIndex.number(row, valueColumn);
+                // CASE ... END is NULL for all other values
+                if (keyId >= 0 && keyId <= 24 && keyId == std::trunc(keyId)) {
+                    ranks[row] = KeyUtils::keyToCircleOfFifthsOrder(
+                            static_cast<mixxx::track::io::key::ChromaticKey>(
+                                    static_cast<int>(keyId)),
+                            keyNotation);
+                }
+            }
+            break;
+        }
+        std::vector<std::pair<double, int>> values;
+        values.reserve(m_trackIndex.rowCount());
+        for (int row = 0; row < m_trackIndex.rowCount(); ++row) {
+            const double value = m_trackIndex.number(row, valueColumn);
+            if (!std::isnan(value)) {
+                values.emplace_back(sortMode == ColumnCache::SortMode::Integer
+                                ? static_cast<double>(castToInteger(value))
+                                : value,
+                        row);
+            }
+        }
+        assignSortRanks(&values, compareValues<double>, &ranks);
+        break;
+    }
+    case ColumnarTrackIndex::ColumnType::Variant:
+        return nullptr;
+    }
+
+    cachedRanks.valueColumn = valueColumn;
+    cachedRanks.generation = generation;
+    cachedRanks.keyNotation = keyNotation;
+    cachedRanks.ranks = std::move(ranks);
+    return &cachedRanks.ranks;
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
@@ -663,7 +1034,7 @@ int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
 
         // This should not happen, but it's a recoverable error so we should
         // only log it.
-        if (!m_trackInfo.contains(otherTrackId)) {
+        if (!m_trackIndex.contains(otherTrackId)) {
             qDebug() << "WARNING: track" << otherTrackId << "was not in index";
             //updateTrackInIndex(otherTrackId);
         }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QCache>
 #include <QHash>
 #include <QList>
 #include <QObject>
@@ -10,12 +11,15 @@
 #include <QVector>
 #include <memory>
 
+#include "library/columnartrackindex.h"
 #include "library/columncache.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
+#include "util/memoryusage.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -75,6 +79,13 @@ class BaseTrackCache : public QObject {
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(const QSet<TrackId>& trackIds);
 
+    /// Changes whenever the cached data of any track might have changed.
+    /// Allows models to detect if the result of a previous filterAndSort()
+    /// is still valid.
+    quint64 generation() const {
+        return m_generation;
+    }
+
   signals:
     void tracksChanged(const QSet<TrackId>& trackIds);
 
@@ -85,6 +96,9 @@ class BaseTrackCache : public QObject {
     void slotTracksRemoved(const QSet<TrackId>& trackId);
     void slotTrackDirty(TrackId trackId);
     void slotTrackClean(TrackId trackId);
+    /// Invalidates the parsed search queries, because crate filters
+    /// remember the tracks of the matching crates.
+    void slotCratesChanged();
 
   private:
     const TrackPointer& getRecentTrack(TrackId trackId) const;
@@ -98,6 +112,21 @@ class BaseTrackCache : public QObject {
     void updateTracksInIndex(const QSet<TrackId>& trackIds);
     QVariant getTrackValueForColumn(TrackPointer pTrack, int column) const;
 
+    // Returns the parsed search query from the cache or parses it. The
+    // pointer stays valid until the next invocation.
+    const QueryNode* parseCachedQuery(const QString& searchQuery);
+
+    // Filters and sorts the tracks without querying the database. Returns
+    // false if the query or the sort order is not supported by the index.
+    bool filterAndSortIndexed(const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            const QString& orderByClause,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QHash<TrackId, int>* trackToIndex);
+    // Returns nullptr if the column can only be sorted by the database.
+    const QVector<int>* sortRanks(int column);
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -123,6 +152,11 @@ class BaseTrackCache : public QObject {
 
     const std::unique_ptr<SearchQueryParser> m_pQueryParser;
 
+    // The same searches are repeated whenever a view is revisited or the
+    // tracks have been modified. Only contains queries without an extra
+    // filter that are evaluated by the index.
+    QCache<QString, QueryNode> m_queryCache;
+
     const mixxx::StringCollator m_collator;
 
     // Temporary storage for filterAndSort()
@@ -143,8 +177,26 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant>> m_trackInfo;
+    quint64 m_generation;
+    ColumnarTrackIndex m_trackIndex;
     QSqlDatabase m_database;
 
+    // The rank of every row of the index in the sort order of a column,
+    // i.e. rows that the database considers equal have the same rank
+    // and NULL values the lowest one. See sortRanks().
+    struct SortRanks {
+        int valueColumn = -1;
+        quint64 generation = 0;
+        KeyUtils::KeyNotation keyNotation = KeyUtils::KeyNotation::Invalid;
+        QVector<int> ranks;
+    };
+    // Indexed by column
+    QVector<SortRanks> m_sortRanks;
+
+    // The index is reported as the TrackCache subsystem. Only the sort
+    // ranks are released to stay within the budget, because they are
+    // recomputed on demand.
+    mixxx::MemoryUsage::Registration m_memoryUsage;
+
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
 };
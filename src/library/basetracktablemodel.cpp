@@ -1172,7 +1172,7 @@ void BaseTrackTableModel::slotTrackChanged(
             m_previewDeckTrackId = TrackId(); // invalidate
             for (int row : rows) {
                 QModelIndex topLeft = index(row, 0);
-                QModelIndex bottomRight = index(row, numColumns);
+                QModelIndex bottomRight = index(row, numColumns - 1);
                 emit dataChanged(topLeft, bottomRight);
             }
         }
@@ -0,0 +1,413 @@
+#include "library/columnartrackindex.h"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+// QVariant::isNull() is also true for null strings in Qt 5, which are
+// stored as NULL like by the database.
+bool isNullValue(const QVariant& value) {
+    return !value.isValid() || value.isNull();
+}
+
+bool isNumberType(int type) {
+    switch (type) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isFloatingPointType(int type) {
+    return type == QMetaType::Double || type == QMetaType::Float;
+}
+
+// The minimum is reserved for NULL values
+bool fitsIntoPackedInteger(const QVariant& value) {
+    if (isFloatingPointType(value.userType())) {
+        return false;
+    }
+    const qlonglong integer = value.toLongLong();
+    // Unsigned values beyond the range of qlonglong wrap around
+    return integer > std::numeric_limits<qint32>::min() &&
+            integer <= std::numeric_limits<qint32>::max() &&
+            (value.userType() != QMetaType::ULongLong ||
+                    value.toULongLong() <= std::numeric_limits<qint32>::max());
+}
+
+bool isSameNumber(double lhs, double rhs) {
+    return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
+}
+
+} // anonymous namespace
+
+// static
+constexpr int ColumnarTrackIndex::kNullStringId;
+
+// static
+constexpr double ColumnarTrackIndex::kNullNumber;
+
+// static
+constexpr qint32 ColumnarTrackIndex::kNullInteger;
+
+ColumnarTrackIndex::ColumnarTrackIndex(QStringList columnNames)
+        : m_columns(columnNames.size()) {
+    for (int i = 0; i < columnNames.size(); ++i) {
+        m_columnIndexByName.insert(columnNames.at(i), i);
+    }
+}
+
+void ColumnarTrackIndex::clear() {
+    for (auto& column : m_columns) {
+        column.type = ColumnType::Null;
+        column.numberType = QMetaType::UnknownType;
+        column.packed = false;
+        column.stringIds.clear();
+        column.integers.clear();
+        column.numbers.clear();
+        column.variants.clear();
+        // Keep counting to invalidate everything derived from the old values
+        ++column.generation;
+    }
+    m_trackIds.clear();
+    m_rowsByTrackId.clear();
+    m_unusedRows.clear();
+    m_stringIdsByHash.clear();
+    m_stringEntries.clear();
+    m_stringData.clear();
+}
+
+int ColumnarTrackIndex::insertTrack(TrackId trackId) {
+    DEBUG_ASSERT(trackId.isValid());
+    const auto it = m_rowsByTrackId.constFind(trackId);
+    if (it != m_rowsByTrackId.constEnd()) {
+        return it.value();
+    }
+    int row;
+    if (m_unusedRows.isEmpty()) {
+        row = m_trackIds.size();
+        m_trackIds.append(trackId);
+        for (auto& column : m_columns) {
+            // Derived per row data needs to be resized
+            ++column.generation;
+            switch (column.type) {
+            case ColumnType::Null:
+                break;
+            case ColumnType::Text:
+                column.stringIds.append(kNullStringId);
+                break;
+            case ColumnType::Number:
+                if (column.packed) {
+                    column.integers.append(kNullInteger);
+                } else {
+                    column.numbers.append(kNullNumber);
+                }
+                break;
+            case ColumnType::Variant:
+                column.variants.append(QVariant());
+                break;
+            }
+        }
+    } else {
+        // All values have been reset to NULL by removeTrack()
+        row = m_unusedRows.takeLast();
+        m_trackIds[row] = trackId;
+    }
+    m_rowsByTrackId.insert(trackId, row);
+    return row;
+}
+
+void ColumnarTrackIndex::removeTrack(TrackId trackId) {
+    const auto it = m_rowsByTrackId.find(trackId);
+    if (it == m_rowsByTrackId.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_rowsByTrackId.erase(it);
+    for (auto& column : m_columns) {
+        setNull(row, &column);
+    }
+    m_trackIds[row] = TrackId();
+    m_unusedRows.append(row);
+}
+
+QVariant ColumnarTrackIndex::value(int row, int column) const {
+    if (column < 0 || column >= m_columns.size()) {
+        return QVariant();
+    }
+    const Column& col = m_columns.at(column);
+    switch (col.type) {
+    case ColumnType::Null:
+        return QVariant();
+    case ColumnType::Text: {
+        const int stringId = col.stringIds.at(row);
+        if (stringId == kNullStringId) {
+            return QVariant();
+        }
+        return QVariant(string(stringId));
+    }
+    case ColumnType::Number: {
+        const double number = this->number(row, column);
+        if (std::isnan(number)) {
+            return QVariant();
+        }
+        switch (col.numberType) {
+        case QMetaType::Bool:
+            return QVariant(number != 0);
+        case QMetaType::Int:
+            return QVariant(static_cast<int>(number));
+        case QMetaType::UInt:
+            return QVariant(static_cast<uint>(number));
+        case QMetaType::LongLong:
+            return QVariant(static_cast<qlonglong>(number));
+        case QMetaType::ULongLong:
+            return QVariant(static_cast<qulonglong>(number));
+        default:
+            return QVariant(number);
+        }
+    }
+    case ColumnType::Variant:
+        return col.variants.at(row);
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QVariant();
+}
+
+void ColumnarTrackIndex::setValue(int row, int column, const QVariant& value) {
+    VERIFY_OR_DEBUG_ASSERT(row >= 0 && row < m_trackIds.size() &&
+            column >= 0 && column < m_columns.size()) {
+        return;
+    }
+    Column* pColumn = &m_columns[column];
+    if (isNullValue(value)) {
+        setNull(row, pColumn);
+        return;
+    }
+
+    const int type = value.userType();
+    ColumnType valueType = ColumnType::Variant;
+    if (type == QMetaType::QString) {
+        valueType = ColumnType::Text;
+    } else if (isNumberType(type)) {
+        valueType = ColumnType::Number;
+    }
+
+    if (pColumn->type == ColumnType::Null) {
+        pColumn->type = valueType;
+        switch (valueType) {
+        case ColumnType::Text:
+            pColumn->stringIds.fill(kNullStringId, m_trackIds.size());
+            break;
+        case ColumnType::Number:
+            pColumn->numberType = type;
+            pColumn->packed = !isFloatingPointType(type);
+            if (pColumn->packed) {
+                pColumn->integers.fill(kNullInteger, m_trackIds.size());
+            } else {
+                pColumn->numbers.fill(kNullNumber, m_trackIds.size());
+            }
+            break;
+        default:
+            pColumn->variants.resize(m_trackIds.size());
+            break;
+        }
+        ++pColumn->generation;
+    } else if (pColumn->type != valueType && pColumn->type != ColumnType::Variant) {
+        convertToVariant(column);
+    }
+
+    switch (pColumn->type) {
+    case ColumnType::Text: {
+        const int stringId = internString(value.toString());
+        if (pColumn->stringIds.at(row) != stringId) {
+            pColumn->stringIds[row] = stringId;
+            ++pColumn->generation;
+        }
+        return;
+    }
+    case ColumnType::Number: {
+        if (isFloatingPointType(type) && !isFloatingPointType(pColumn->numberType)) {
+            // Otherwise the fraction would be lost when reading the values
+            pColumn->numberType = QMetaType::Double;
+            ++pColumn->generation;
+        }
+        if (pColumn->packed && !fitsIntoPackedInteger(value)) {
+            unpackIntegers(pColumn);
+        }
+        if (pColumn->packed) {
+            const qint32 integer = static_cast<qint32>(value.toLongLong());
+            if (pColumn->integers.at(row) != integer) {
+                pColumn->integers[row] = integer;
+                ++pColumn->generation;
+            }
+            return;
+        }
+        const double number = value.toDouble();
+        if (!isSameNumber(pColumn->numbers.at(row), number)) {
+            pColumn->numbers[row] = number;
+            ++pColumn->generation;
+        }
+        return;
+    }
+    case ColumnType::Variant:
+        if (pColumn->variants.at(row) != value) {
+            pColumn->variants[row] = value;
+            ++pColumn->generation;
+        }
+        return;
+    case ColumnType::Null:
+        break;
+    }
+    DEBUG_ASSERT(!"unreachable");
+}
+
+bool ColumnarTrackIndex::isNull(int row, int column) const {
+    const Column& col = m_columns.at(column);
+    switch (col.type) {
+    case ColumnType::Null:
+        return true;
+    case ColumnType::Text:
+        return col.stringIds.at(row) == kNullStringId;
+    case ColumnType::Number:
+        return std::isnan(number(row, column));
+    case ColumnType::Variant:
+        return isNullValue(col.variants.at(row));
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return true;
+}
+
+int ColumnarTrackIndex::internString(const QString& string) {
+    const QByteArray utf8String = string.toUtf8();
+    const uint hash = qHash(utf8String);
+    for (auto it = m_stringIdsByHash.constFind(hash);
+            it != m_stringIdsByHash.constEnd() && it.key() == hash;
+            ++it) {
+        const StringEntry& entry = m_stringEntries.at(it.value());
+        if (entry.size == utf8String.size() &&
+                std::memcmp(m_stringData.constData() + entry.offset,
+                        utf8String.constData(),
+                        utf8String.size()) == 0) {
+            return it.value();
+        }
+    }
+    StringEntry entry;
+    entry.offset = appendStringData(utf8String);
+    entry.size = utf8String.size();
+    QString foldedString = string;
+    mixxx::DbConnection::makeStringLatinLow(&foldedString);
+    if (foldedString == string) {
+        entry.foldedOffset = entry.offset;
+        entry.foldedSize = entry.size;
+    } else {
+        const QByteArray foldedUtf8String = foldedString.toUtf8();
+        entry.foldedOffset = appendStringData(foldedUtf8String);
+        entry.foldedSize = foldedUtf8String.size();
+    }
+    const int stringId = m_stringEntries.size();
+    m_stringEntries.append(entry);
+    m_stringIdsByHash.insert(hash, stringId);
+    return stringId;
+}
+
+int ColumnarTrackIndex::appendStringData(const QByteArray& utf8String) {
+    const int offset = m_stringData.size();
+    m_stringData.append(utf8String);
+    return offset;
+}
+
+void ColumnarTrackIndex::setNull(int row, Column* pColumn) {
+    switch (pColumn->type) {
+    case ColumnType::Null:
+        return;
+    case ColumnType::Text:
+        if (pColumn->stringIds.at(row) != kNullStringId) {
+            pColumn->stringIds[row] = kNullStringId;
+            ++pColumn->generation;
+        }
+        return;
+    case ColumnType::Number:
+        if (pColumn->packed) {
+            if (pColumn->integers.at(row) != kNullInteger) {
+                pColumn->integers[row] = kNullInteger;
+                ++pColumn->generation;
+            }
+        } else if (!std::isnan(pColumn->numbers.at(row))) {
+            pColumn->numbers[row] = kNullNumber;
+            ++pColumn->generation;
+        }
+        return;
+    case ColumnType::Variant:
+        if (pColumn->variants.at(row).isValid()) {
+            pColumn->variants[row] = QVariant();
+            ++pColumn->generation;
+        }
+        return;
+    }
+}
+
+void ColumnarTrackIndex::unpackIntegers(Column* pColumn) {
+    DEBUG_ASSERT(pColumn->packed);
+    QVector<double> numbers;
+    numbers.reserve(pColumn->integers.size());
+    for (const qint32 integer : std::as_const(pColumn->integers)) {
+        numbers.append(integer == kNullInteger ? kNullNumber : integer);
+    }
+    pColumn->packed = false;
+    pColumn->integers.clear();
+    pColumn->numbers = std::move(numbers);
+    // The values are unchanged
+}
+
+void ColumnarTrackIndex::convertToVariant(int column) {
+    QVector<QVariant> variants;
+    variants.reserve(m_trackIds.size());
+    for (int row = 0; row < m_trackIds.size(); ++row) {
+        variants.append(value(row, column));
+    }
+    Column& col = m_columns[column];
+    col.type = ColumnType::Variant;
+    col.numberType = QMetaType::UnknownType;
+    col.packed = false;
+    col.stringIds.clear();
+    col.integers.clear();
+    col.numbers.clear();
+    col.variants = std::move(variants);
+    ++col.generation;
+}
+
+qint64 ColumnarTrackIndex::estimatedMemoryUsage() const {
+    qint64 bytes = m_trackIds.capacity() * sizeof(TrackId) +
+            m_unusedRows.capacity() * sizeof(int) +
+            // Keys, values and the next pointer of each node
+            m_rowsByTrackId.size() * (sizeof(TrackId) + sizeof(int) + sizeof(void*)) +
+            m_stringIdsByHash.size() * (sizeof(uint) + sizeof(int) + sizeof(void*)) +
+            m_stringEntries.capacity() * sizeof(StringEntry) +
+            m_stringData.capacity();
+    for (const auto& column : m_columns) {
+        bytes += column.stringIds.capacity() * sizeof(int) +
+                column.integers.capacity() * sizeof(qint32) +
+                column.numbers.capacity() * sizeof(double) +
+                column.variants.capacity() * sizeof(QVariant);
+        for (const auto& variant : column.variants) {
+            if (variant.userType() == QMetaType::QString) {
+                bytes += variant.toString().capacity() * sizeof(QChar);
+            } else if (variant.userType() == QMetaType::QByteArray) {
+                bytes += variant.toByteArray().capacity();
+            }
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <limits>
+
+#include "track/trackid.h"
+
+/// Column-oriented storage for the values that BaseTrackCache caches per
+/// track.
+///
+/// Each column is a typed array indexed by row. Text is interned into a
+/// string pool that also keeps the folded form compared by LIKE, so that
+/// searching and sorting only need to read an integer or a double per cell
+/// instead of unboxing a QVariant. The storage type of a column is chosen
+/// by its first non-null value. Columns that receive values of different
+/// types fall back to storing QVariants.
+///
+/// The footprint per track is kept small for large libraries: Integers
+/// are packed into 32 bits as long as they fit, and the string pool stores
+/// all strings as UTF-8 in a single buffer that is only decoded when a
+/// value is read. The folded form shares the bytes of the string if
+/// folding doesn't change it.
+class ColumnarTrackIndex {
+  public:
+    enum class ColumnType {
+        /// No value other than NULL has been stored yet
+        Null,
+        Text,
+        Number,
+        /// Mixed or other types, e.g. dates or binary data
+        Variant,
+    };
+
+    static constexpr int kNullStringId = -1;
+
+    explicit ColumnarTrackIndex(QStringList columnNames = QStringList());
+
+    /// Removes all tracks and strings. The columns are kept.
+    void clear();
+
+    int columnCount() const {
+        return m_columns.size();
+    }
+    /// Returns -1 if there is no column with this name.
+    int columnIndex(const QString& columnName) const {
+        return m_columnIndexByName.value(columnName, -1);
+    }
+
+    /// All rows including the unused ones of removed tracks.
+    int rowCount() const {
+        return m_trackIds.size();
+    }
+    int trackCount() const {
+        return m_rowsByTrackId.size();
+    }
+
+    bool contains(TrackId trackId) const {
+        return m_rowsByTrackId.contains(trackId);
+    }
+    /// Returns -1 if the track is not stored.
+    int row(TrackId trackId) const {
+        return m_rowsByTrackId.value(trackId, -1);
+    }
+    /// Returns an invalid id for the unused rows of removed tracks.
+    TrackId trackId(int row) const {
+        return m_trackIds.at(row);
+    }
+
+    /// Returns the row of the track. A new row with only NULL values is
+    /// allocated if the track has not been stored yet.
+    int insertTrack(TrackId trackId);
+    void removeTrack(TrackId trackId);
+
+    /// Returns an invalid QVariant for NULL values and invalid columns.
+    QVariant value(int row, int column) const;
+    void setValue(int row, int column, const QVariant& value);
+
+    ColumnType columnType(int column) const {
+        return m_columns.at(column).type;
+    }
+    /// Changes whenever a value or the type of the column changes.
+    quint64 columnGeneration(int column) const {
+        return m_columns.at(column).generation;
+    }
+
+    bool isNull(int row, int column) const;
+
+    /// Only for Text columns. Returns kNullStringId for NULL values.
+    int stringId(int row, int column) const {
+        return m_columns.at(column).stringIds.at(row);
+    }
+    /// The string pool is shared by all columns.
+    int stringCount() const {
+        return m_stringEntries.size();
+    }
+    /// Decodes the string from the pool.
+    QString string(int stringId) const {
+        const StringEntry& entry = m_stringEntries.at(stringId);
+        return QString::fromUtf8(m_stringData.constData() + entry.offset, entry.size);
+    }
+    bool isEmptyString(int stringId) const {
+        return m_stringEntries.at(stringId).size == 0;
+    }
+    /// The UTF-8 encoded string as folded by
+    /// DbConnection::makeStringLatinLow(). The returned array references
+    /// the pool and must not be used after modifying the index.
+    QByteArray foldedUtf8String(int stringId) const {
+        const StringEntry& entry = m_stringEntries.at(stringId);
+        return QByteArray::fromRawData(
+                m_stringData.constData() + entry.foldedOffset, entry.foldedSize);
+    }
+
+    /// Only for Number columns. Returns NaN for NULL values.
+    double number(int row, int column) const {
+        const Column& col = m_columns.at(column);
+        if (col.packed) {
+            const qint32 integer = col.integers.at(row);
+            return integer == kNullInteger ? kNullNumber : integer;
+        }
+        return col.numbers.at(row);
+    }
+
+    /// The number of bytes allocated for the values, excluding the
+    /// overhead of the allocator.
+    qint64 estimatedMemoryUsage() const;
+
+  private:
+    struct Column {
+        ColumnType type = ColumnType::Null;
+        // The type of the values returned by value() for Number columns
+        int numberType = QMetaType::UnknownType;
+        // Number columns store integers until the first value that
+        // doesn't fit into 32 bits or has a fraction
+        bool packed = false;
+        quint64 generation = 0;
+        QVector<int> stringIds;
+        QVector<qint32> integers;
+        QVector<double> numbers;
+        QVector<QVariant> variants;
+    };
+
+    struct StringEntry {
+        int offset;
+        int size;
+        int foldedOffset;
+        int foldedSize;
+    };
+
+    static constexpr double kNullNumber = std::numeric_limits<double>::quiet_NaN();
+    static constexpr qint32 kNullInteger = std::numeric_limits<qint32>::min();
+
+    int internString(const QString& string);
+    int appendStringData(const QByteArray& utf8String);
+    void setNull(int row, Column* pColumn);
+    void unpackIntegers(Column* pColumn);
+    void convertToVariant(int column);
+
+    QHash<QString, int> m_columnIndexByName;
+    QVector<Column> m_columns;
+
+    QVector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowsByTrackId;
+    QVector<int> m_unusedRows;
+
+    // Only the hashes are kept to find the ids of equal strings
+    QMultiHash<uint, int> m_stringIdsByHash;
+    QVector<StringEntry> m_stringEntries;
+    QByteArray m_stringData;
+};
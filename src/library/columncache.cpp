@@ -124,6 +124,26 @@ void ColumnCache::setColumns(const QStringList& columns) {
     slotSetKeySortOrder(m_pKeyNotationCP->get());
 }
 
+ColumnCache::SortMode ColumnCache::columnSortModeForFieldIndex(int index) const {
+    const auto it = m_columnSortByIndex.constFind(index);
+    if (it == m_columnSortByIndex.constEnd()) {
+        return SortMode::Default;
+    }
+    if (index == m_columnIndexByEnum[COLUMN_LIBRARYTABLE_KEY]) {
+        return SortMode::Key;
+    }
+    if (it.value() == kSortInt) {
+        return SortMode::Integer;
+    }
+    if (it.value() == kSortNoCase) {
+        return SortMode::NoCase;
+    }
+    if (it.value() == kSortNoCaseLex) {
+        return SortMode::NoCaseLexicographic;
+    }
+    return SortMode::Custom;
+}
+
 void ColumnCache::slotSetKeySortOrder(double notationValue) {
     const int keyColumnIndex = m_columnIndexByEnum[COLUMN_LIBRARYTABLE_KEY];
     if (keyColumnIndex < 0) {
@@ -101,6 +101,24 @@ class ColumnCache : public QObject {
         return format.arg(columnNameForFieldIndex(index));
     }
 
+    /// The SQL expression used by columnSortForFieldIndex()
+    enum class SortMode {
+        /// The plain column value
+        Default,
+        /// cast(column as integer)
+        Integer,
+        /// lower(column)
+        NoCase,
+        /// lower(column) with the lexicographical collation
+        NoCaseLexicographic,
+        /// The circle of fifths order of the key_id column
+        Key,
+        /// Any other sort clause inserted by insertColumnSortByEnum()
+        Custom,
+    };
+
+    SortMode columnSortModeForFieldIndex(int index) const;
+
     void insertColumnSortByEnum(
             Column column,
             const QString& sortFormat) {
@@ -1,6 +1,7 @@
 #include "library/coverart.h"
 
 #include <QDebugStateSaver>
+#include <QImageReader>
 
 #include "library/coverartutils.h"
 #include "track/track.h"
@@ -59,6 +60,20 @@ quint16 calculateLegacyHash(
     return legacyHash;
 }
 
+/// The properties of the most recent image for which the digest has been
+/// calculated. Tracks of an album usually share the same embedded cover
+/// image, which is decoded only once by loadImageFromByteVector() and
+/// therefore has the same cache key when the tracks are imported one
+/// after another.
+struct ImageDigestMemo {
+    qint64 imageCacheKey = 0;
+    mixxx::RgbColor::optional_t color;
+    QByteArray imageDigest;
+    quint16 legacyHash = CoverInfo::defaultLegacyHash();
+};
+
+thread_local ImageDigestMemo t_imageDigestMemo;
+
 } // anonymous namespace
 
 CoverInfoRelative::CoverInfoRelative()
@@ -69,10 +84,22 @@ CoverInfoRelative::CoverInfoRelative()
 
 void CoverInfoRelative::setImageDigest(
         const QImage& image) {
+    // The cache key of an image is unique and never reused, even
+    // after the image has been modified or destroyed
+    if (!image.isNull() && image.cacheKey() == t_imageDigestMemo.imageCacheKey) {
+        color = t_imageDigestMemo.color;
+        m_imageDigest = t_imageDigestMemo.imageDigest;
+        m_legacyHash = t_imageDigestMemo.legacyHash;
+        return;
+    }
     color = CoverImageUtils::extractBackgroundColor(image);
     m_imageDigest = CoverImageUtils::calculateDigest(image);
     DEBUG_ASSERT(image.isNull() == m_imageDigest.isEmpty());
     m_legacyHash = calculateLegacyHash(image);
+    if (!image.isNull()) {
+        t_imageDigestMemo = ImageDigestMemo{
+                image.cacheKey(), color, m_imageDigest, m_legacyHash};
+    }
     DEBUG_ASSERT(image.isNull() == (m_legacyHash == defaultLegacyHash()));
     DEBUG_ASSERT(image.isNull() != hasCacheKey());
     DEBUG_ASSERT(image.isNull() == (type == NONE));
@@ -106,7 +133,9 @@ QDebug operator<<(QDebug dbg, const CoverInfoRelative& info) {
             << '}';
 }
 
-CoverInfo::LoadedImage CoverInfo::loadImage(TrackPointer pTrack) const {
+CoverInfo::LoadedImage CoverInfo::loadImage(
+        TrackPointer pTrack,
+        int maxWidth) const {
     LoadedImage loadedImage(LoadedImage::Result::ErrorUnknown);
     if (type == CoverInfo::METADATA) {
         VERIFY_OR_DEBUG_ASSERT(!trackLocation.isEmpty()) {
@@ -157,7 +186,17 @@ CoverInfo::LoadedImage CoverInfo::loadImage(TrackPointer pTrack) const {
                 Sandbox::openSecurityToken(
                         &coverFile,
                         true);
-        if (loadedImage.image.load(loadedImage.location)) {
+        QImageReader imageReader(loadedImage.location);
+        if (maxWidth > 0) {
+            // Decoders like JPEG are able to skip most of the work when
+            // decoding at a reduced size.
+            const QSize imageSize = imageReader.size();
+            if (imageSize.width() > maxWidth) {
+                imageReader.setScaledSize(imageSize.scaled(
+                        maxWidth, imageSize.height(), Qt::KeepAspectRatio));
+            }
+        }
+        if (imageReader.read(&loadedImage.image)) {
             DEBUG_ASSERT(!loadedImage.image.isNull());
             loadedImage.result = LoadedImage::Result::Ok;
         } else {
@@ -176,12 +176,18 @@ class CoverInfo : public CoverInfoRelative {
 
       private:
         friend class CoverArt;
+        friend class CoverArtCache;
         friend class CoverInfo;
         LoadedImage(Result result)
                 : result(result) {
         }
     };
-    LoadedImage loadImage(TrackPointer pTrack = {}) const;
+    /// Image files that are wider than maxWidth > 0 are decoded at a
+    /// reduced size, preserving the aspect ratio. Embedded images are
+    /// always decoded at their original size.
+    LoadedImage loadImage(
+            TrackPointer pTrack = {},
+            int maxWidth = 0) const;
 
     QString trackLocation;
 };
@@ -4,6 +4,7 @@
 #include <QPixmapCache>
 #include <QtConcurrentRun>
 #include <QtDebug>
+#include <algorithm>
 
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
@@ -27,9 +28,34 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
     return image.scaledToWidth(width, kTransformationMode);
 }
 
+// Only assigned when the instance is created, before the library is scanned
+std::weak_ptr<const CoverArtThumbnailCache> s_pInstanceThumbnailCache;
+
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
+CoverArtCache::CoverArtCache(
+        const QString& thumbnailDirectory,
+        qint64 maxThumbnailBytes)
+        : m_runningLoadCount(0),
+          m_pThumbnailCache(std::make_shared<const CoverArtThumbnailCache>(
+                  thumbnailDirectory, maxThumbnailBytes)) {
+    s_pInstanceThumbnailCache = m_pThumbnailCache;
+    if (m_pThumbnailCache->isEnabled()) {
+        kLogger.info()
+                << "Caching cover art thumbnails in"
+                << m_pThumbnailCache->directory();
+        const auto future = QtConcurrent::run(
+                [pThumbnailCache = m_pThumbnailCache] {
+                    pThumbnailCache->evictLeastRecentlyUsed();
+                });
+        // Don't wait for the result and keep running in the background
+        Q_UNUSED(future)
+    }
+}
+
+//static
+std::shared_ptr<const CoverArtThumbnailCache> CoverArtCache::thumbnailCache() {
+    return s_pInstanceThumbnailCache.lock();
 }
 
 //static
@@ -51,7 +77,8 @@ void CoverArtCache::requestCoverImpl(
             pRequester,
             pTrack,
             coverInfo,
-            desiredWidth);
+            desiredWidth,
+            Priority::High);
 }
 
 //static
@@ -108,7 +135,8 @@ void CoverArtCache::requestUncachedCover(
             pRequester,
             TrackPointer(),
             coverInfo,
-            desiredWidth);
+            desiredWidth,
+            Priority::Normal);
 }
 
 // static
@@ -128,14 +156,52 @@ void CoverArtCache::requestUncachedCover(
             pRequester,
             pTrack,
             pTrack->getCoverInfoWithLocation(),
-            desiredWidth);
+            desiredWidth,
+            Priority::Normal);
+}
+
+// static
+void CoverArtCache::cancelRequest(
+        const QObject* pRequester,
+        mixxx::cache_key_t requestedCacheKey) {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    VERIFY_OR_DEBUG_ASSERT(pCache) {
+        return;
+    }
+    pCache->m_queuedRequests.erase(
+            std::remove_if(
+                    pCache->m_queuedRequests.begin(),
+                    pCache->m_queuedRequests.end(),
+                    [pRequester, requestedCacheKey](const QueuedRequest& request) {
+                        return request.data.pRequester == pRequester &&
+                                request.coverInfo.cacheKey() == requestedCacheKey;
+                    }),
+            pCache->m_queuedRequests.end());
+}
+
+// static
+void CoverArtCache::cancelRequests(
+        const QObject* pRequester) {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    VERIFY_OR_DEBUG_ASSERT(pCache) {
+        return;
+    }
+    pCache->m_queuedRequests.erase(
+            std::remove_if(
+                    pCache->m_queuedRequests.begin(),
+                    pCache->m_queuedRequests.end(),
+                    [pRequester](const QueuedRequest& request) {
+                        return request.data.pRequester == pRequester;
+                    }),
+            pCache->m_queuedRequests.end());
 }
 
 void CoverArtCache::tryLoadCover(
         const QObject* pRequester,
         const TrackPointer& pTrack,
         const CoverInfo& coverInfo,
-        int desiredWidth) {
+        int desiredWidth,
+        Priority priority) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "requestCover"
@@ -156,12 +222,55 @@ void CoverArtCache::tryLoadCover(
     // to avoid loading the same picture again while we are loading it.
     // This fixes also https://github.com/mixxxdj/mixxx/issues/11131 on
     // Windows where simultaneous open the same file from two threads fails.
-    bool requestPending = m_runningRequests.contains(requestedCacheKey);
-    m_runningRequests.insert(requestedCacheKey, {pRequester, desiredWidth});
-    if (requestPending) {
+    if (m_runningRequests.contains(requestedCacheKey)) {
+        m_runningRequests.insert(requestedCacheKey, {pRequester, desiredWidth, priority});
+        return;
+    }
+
+    if (m_runningLoadCount >= kMaxRunningLoads) {
+        for (const auto& queuedRequest : std::as_const(m_queuedRequests)) {
+            if (queuedRequest.data.pRequester == pRequester &&
+                    queuedRequest.data.desiredWidth == desiredWidth &&
+                    queuedRequest.data.priority == priority &&
+                    queuedRequest.coverInfo.cacheKey() == requestedCacheKey) {
+                // Already queued, e.g. if the same row has been painted
+                // again
+                return;
+            }
+        }
+        auto queuedRequest = QueuedRequest{
+                {pRequester, desiredWidth, priority},
+                pTrack,
+                coverInfo};
+        if (priority == Priority::High) {
+            const auto firstNormal = std::find_if(
+                    m_queuedRequests.begin(),
+                    m_queuedRequests.end(),
+                    [](const QueuedRequest& request) {
+                        return request.data.priority != Priority::High;
+                    });
+            m_queuedRequests.insert(firstNormal, std::move(queuedRequest));
+        } else {
+            m_queuedRequests.append(std::move(queuedRequest));
+        }
+        if (kLogger.traceEnabled()) {
+            kLogger.trace()
+                    << "requestCover queued"
+                    << m_queuedRequests.size()
+                    << "requests";
+        }
         return;
     }
 
+    m_runningRequests.insert(requestedCacheKey, {pRequester, desiredWidth, priority});
+    startLoadingCover(pTrack, coverInfo, desiredWidth);
+}
+
+void CoverArtCache::startLoadingCover(
+        const TrackPointer& pTrack,
+        const CoverInfo& coverInfo,
+        int desiredWidth) {
+    ++m_runningLoadCount;
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "requestCover starting future for"
@@ -174,20 +283,40 @@ void CoverArtCache::tryLoadCover(
             &CoverArtCache::loadCover,
             pTrack,
             coverInfo,
-            desiredWidth);
+            desiredWidth,
+            m_pThumbnailCache);
     connect(watcher,
             &QFutureWatcher<FutureResult>::finished,
             this,
             &CoverArtCache::coverLoaded);
     watcher->setFuture(future);
-    return;
+}
+
+void CoverArtCache::startQueuedRequests() {
+    while (m_runningLoadCount < kMaxRunningLoads && !m_queuedRequests.isEmpty()) {
+        const QueuedRequest request = m_queuedRequests.takeFirst();
+        // The cover might have been loaded while the request was queued
+        QPixmap pixmap = getCachedCover(
+                request.coverInfo, request.data.desiredWidth);
+        if (!pixmap.isNull()) {
+            emit coverFound(request.data.pRequester, request.coverInfo, pixmap);
+            continue;
+        }
+        tryLoadCover(
+                request.data.pRequester,
+                request.pTrack,
+                request.coverInfo,
+                request.data.desiredWidth,
+                request.data.priority);
+    }
 }
 
 //static
 CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
-        int desiredWidth) {
+        int desiredWidth,
+        const std::shared_ptr<const CoverArtThumbnailCache>& pThumbnailCache) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -200,7 +329,49 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     auto res = FutureResult(
             coverInfo.cacheKey());
 
-    CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack);
+    // The legacy hash needs to be replaced by the digest of the
+    // original image.
+    const bool useThumbnailCache = pThumbnailCache &&
+            pThumbnailCache->isEnabled() &&
+            !coverInfo.imageDigest().isEmpty() &&
+            CoverArtThumbnailCache::canServe(desiredWidth);
+    if (useThumbnailCache) {
+        QImage thumbnail = pThumbnailCache->load(coverInfo.cacheKey());
+        if (!thumbnail.isNull()) {
+            if (kLogger.traceEnabled()) {
+                kLogger.trace()
+                        << "loadCover thumbnail cache hit"
+                        << coverInfo;
+            }
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.location = pThumbnailCache->filePath(coverInfo.cacheKey());
+            loadedImage.image = resizeImageWidth(thumbnail, desiredWidth);
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
+    // Image files are decoded directly at the size of the thumbnail
+    // if it will be cached. Otherwise the original image is needed to
+    // refresh the digest.
+    int maxDecodedWidth = 0;
+    if (useThumbnailCache) {
+        maxDecodedWidth = CoverArtThumbnailCache::kThumbnailWidth;
+    } else if (desiredWidth > 0 && !coverInfo.imageDigest().isEmpty()) {
+        maxDecodedWidth = desiredWidth;
+    }
+    CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack, maxDecodedWidth);
+    if (useThumbnailCache && loadedImage.result == CoverInfo::LoadedImage::Result::Ok) {
+        const QImage thumbnail = pThumbnailCache->store(
+                coverInfo.cacheKey(), loadedImage.image);
+        if (!thumbnail.isNull()) {
+            // Scale down from the thumbnail like on a cache hit
+            loadedImage.image = thumbnail;
+        }
+    }
     if (!loadedImage.image.isNull()) {
         if (coverInfo.imageDigest().isEmpty()) {
             // This happens if we have loaded the cover art via the legacy hash
@@ -248,6 +419,9 @@ void CoverArtCache::coverLoaded() {
         kLogger.trace() << "coverLoaded" << res.coverArt;
     }
 
+    DEBUG_ASSERT(m_runningLoadCount > 0);
+    --m_runningLoadCount;
+
     QString cacheKey = pixmapCacheKey(
             res.coverArt.cacheKey(), res.coverArt.resizedToWidth);
     QPixmap pixmap;
@@ -306,8 +480,11 @@ void CoverArtCache::coverLoaded() {
                     i.value().pRequester,
                     nullptr,
                     res.coverArt,
-                    i.value().desiredWidth);
+                    i.value().desiredWidth,
+                    i.value().priority);
         }
         ++i;
     }
+
+    startQueuedRequests();
 }
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <QList>
 #include <QObject>
 #include <QPair>
 #include <QPixmap>
 #include <QSet>
 #include <QtDebug>
+#include <memory>
 
 #include "library/coverart.h"
+#include "library/coverartthumbnailcache.h"
 #include "track/track_decl.h"
 #include "util/singleton.h"
 
@@ -19,6 +22,12 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
         requestCoverImpl(pRequester, TrackPointer(), coverInfo);
     }
 
+    // Not more than this number of covers are loaded concurrently.
+    // All other requests are queued and could be canceled, e.g. when
+    // scrolling through the library table. Requests of the full size
+    // covers for the skin widgets are served first.
+    static constexpr int kMaxRunningLoads = 4;
+
     static void requestTrackCover(
             const QObject* pRequester,
             const TrackPointer& pTrack);
@@ -37,6 +46,22 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const TrackPointer& pTrack,
             int desiredWidth);
 
+    // Cancels all queued requests of the requester for the cover. The
+    // cover might still be found if loading has already been started.
+    static void cancelRequest(
+            const QObject* pRequester,
+            mixxx::cache_key_t requestedCacheKey);
+
+    // Cancels all queued requests of the requester, e.g. before it is
+    // destroyed.
+    static void cancelRequests(
+            const QObject* pRequester);
+
+    // The thumbnail cache of the instance, e.g. for storing the thumbnails
+    // of new tracks while scanning the library. Returns nullptr if there
+    // is no instance. Thread-safe.
+    static std::shared_ptr<const CoverArtThumbnailCache> thumbnailCache();
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -49,12 +74,14 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
         mixxx::cache_key_t requestedCacheKey;
         CoverArt coverArt;
     };
-    // Load cover from path indicated in coverInfo. WARNING: This is run in a
-    // worker thread.
+    // Load cover from path indicated in coverInfo. Small covers are
+    // served from and added to the thumbnail cache if available.
+    // WARNING: This is run in a worker thread.
     static FutureResult loadCover(
             TrackPointer pTrack,
             CoverInfo coverInfo,
-            int desiredWidth);
+            int desiredWidth,
+            const std::shared_ptr<const CoverArtThumbnailCache>& pThumbnailCache = {});
 
   private slots:
     // Called when loadCover is complete in the main thread.
@@ -67,7 +94,10 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const QPixmap& pixmap);
 
   protected:
-    CoverArtCache();
+    // The thumbnail cache is disabled if no directory is provided.
+    explicit CoverArtCache(
+            const QString& thumbnailDirectory = QString(),
+            qint64 maxThumbnailBytes = 0);
     ~CoverArtCache() override = default;
     friend class Singleton<CoverArtCache>;
 
@@ -78,15 +108,38 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const CoverInfo& coverInfo,
             int desiredWidth = 0); // <= 0: original size
 
+    enum class Priority {
+        Normal,
+        High,
+    };
+
     void tryLoadCover(
             const QObject* pRequester,
+            const TrackPointer& pTrack,
+            const CoverInfo& info,
+            int desiredWidth,
+            Priority priority);
+    void startLoadingCover(
             const TrackPointer& pTrack,
             const CoverInfo& info,
             int desiredWidth);
+    void startQueuedRequests();
 
     struct RequestData {
         const QObject* pRequester;
         int desiredWidth;
+        Priority priority;
     };
     QMultiHash<mixxx::cache_key_t, RequestData> m_runningRequests;
+    int m_runningLoadCount;
+
+    struct QueuedRequest {
+        RequestData data;
+        TrackPointer pTrack;
+        CoverInfo coverInfo;
+    };
+    // High priority requests are queued before all normal requests
+    QList<QueuedRequest> m_queuedRequests;
+
+    const std::shared_ptr<const CoverArtThumbnailCache> m_pThumbnailCache;
 };
@@ -0,0 +1,158 @@
+#include "library/coverartthumbnailcache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <utility>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtThumbnailCache");
+
+// The image format is detected when reading the file
+const QString kFileSuffix = QStringLiteral(".thumbnail");
+
+// Photos are much smaller as JPEG, but JPEG doesn't support transparency
+const QByteArray kOpaqueImageFormat = QByteArrayLiteral("jpg");
+const QByteArray kTransparentImageFormat = QByteArrayLiteral("png");
+constexpr int kJpegQuality = 90;
+
+} // anonymous namespace
+
+CoverArtThumbnailCache::CoverArtThumbnailCache(
+        QString directory,
+        qint64 maxTotalBytes)
+        : m_directory(std::move(directory)),
+          m_maxTotalBytes(maxTotalBytes) {
+    if (!isEnabled()) {
+        return;
+    }
+    DEBUG_ASSERT(m_maxTotalBytes > 0);
+    if (!QDir(m_directory).mkpath(QStringLiteral("."))) {
+        kLogger.warning()
+                << "Failed to create thumbnail directory"
+                << m_directory;
+    }
+}
+
+QString CoverArtThumbnailCache::filePath(mixxx::cache_key_t cacheKey) const {
+    DEBUG_ASSERT(isEnabled());
+    return QDir(m_directory)
+            .filePath(QStringLiteral("%1").arg(cacheKey, 16, 16, QLatin1Char('0')) +
+                    kFileSuffix);
+}
+
+QImage CoverArtThumbnailCache::load(mixxx::cache_key_t cacheKey) const {
+    if (!isEnabled() || !mixxx::isValidCacheKey(cacheKey)) {
+        return QImage();
+    }
+    const QString thumbnailPath = filePath(cacheKey);
+    QFile file(thumbnailPath);
+    if (!file.exists()) {
+        // Not cached yet
+        return QImage();
+    }
+    // Opened for writing to update the modification time
+    if (!file.open(QIODevice::ReadWrite)) {
+        kLogger.warning()
+                << "Failed to open thumbnail"
+                << thumbnailPath
+                << file.errorString();
+        return QImage();
+    }
+    QImageReader reader(&file);
+    QImage thumbnail = reader.read();
+    if (thumbnail.isNull()) {
+        kLogger.warning()
+                << "Discarding unreadable thumbnail"
+                << thumbnailPath
+                << reader.errorString();
+        file.close();
+        file.remove();
+        return QImage();
+    }
+    // Mark as recently used. Failing to do so is not critical.
+    file.setFileTime(QDateTime::currentDateTime(),
+            QFileDevice::FileModificationTime);
+    return thumbnail;
+}
+
+bool CoverArtThumbnailCache::contains(mixxx::cache_key_t cacheKey) const {
+    if (!isEnabled() || !mixxx::isValidCacheKey(cacheKey)) {
+        return false;
+    }
+    return QFile::exists(filePath(cacheKey));
+}
+
+QImage CoverArtThumbnailCache::store(
+        mixxx::cache_key_t cacheKey,
+        const QImage& image) const {
+    if (!isEnabled() || !mixxx::isValidCacheKey(cacheKey) || image.isNull()) {
+        return QImage();
+    }
+    // Images that are already small enough are stored unmodified
+    const QImage thumbnail = image.width() > kThumbnailWidth
+            ? image.scaledToWidth(kThumbnailWidth, Qt::SmoothTransformation)
+            : image;
+    const QString thumbnailPath = filePath(cacheKey);
+    // Concurrent readers never see an incomplete file
+    QSaveFile file(thumbnailPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to create thumbnail"
+                << thumbnailPath
+                << file.errorString();
+        return QImage();
+    }
+    QImageWriter writer(&file,
+            thumbnail.hasAlphaChannel()
+                    ? kTransparentImageFormat
+                    : kOpaqueImageFormat);
+    writer.setQuality(kJpegQuality);
+    if (!writer.write(thumbnail) || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write thumbnail"
+                << thumbnailPath
+                << writer.errorString();
+        return QImage();
+    }
+    return thumbnail;
+}
+
+int CoverArtThumbnailCache::evictLeastRecentlyUsed() const {
+    if (!isEnabled()) {
+        return 0;
+    }
+    // Sorted by modification time, newest first
+    const QFileInfoList fileInfos = QDir(m_directory)
+                                            .entryInfoList(
+                                                    QStringList{QStringLiteral("*") +
+                                                            kFileSuffix},
+                                                    QDir::Files,
+                                                    QDir::Time);
+    qint64 totalSize = 0;
+    int evictedCount = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+        if (totalSize > m_maxTotalBytes) {
+            if (QFile::remove(fileInfo.filePath())) {
+                ++evictedCount;
+            }
+        }
+    }
+    if (evictedCount > 0) {
+        kLogger.debug()
+                << "Evicted"
+                << evictedCount
+                << "of"
+                << fileInfos.size()
+                << "thumbnails";
+    }
+    return evictedCount;
+}
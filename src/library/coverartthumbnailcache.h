@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+#include "util/cache.h"
+
+/// Persists small, fixed-size thumbnails of cover images on disk.
+///
+/// Thumbnails are keyed by the cache key of the cover image, i.e. by
+/// the digest of the image contents, and remain valid if the same image
+/// is found at a different location. Loading a thumbnail is much cheaper
+/// than extracting and scaling the embedded cover image of an audio file
+/// when populating the library table.
+///
+/// All operations only access the file system and may be invoked
+/// concurrently from worker threads.
+class CoverArtThumbnailCache final {
+  public:
+    /// The width of the persisted thumbnails. Only requests for images
+    /// that are not wider could be served from this cache.
+    static constexpr int kThumbnailWidth = 128;
+
+    /// An empty directory disables the cache.
+    CoverArtThumbnailCache(
+            QString directory,
+            qint64 maxTotalBytes);
+
+    bool isEnabled() const {
+        return !m_directory.isEmpty();
+    }
+
+    const QString& directory() const {
+        return m_directory;
+    }
+
+    static bool canServe(int desiredWidth) {
+        return desiredWidth > 0 && desiredWidth <= kThumbnailWidth;
+    }
+
+    /// Returns a null image if no thumbnail has been stored.
+    QImage load(mixxx::cache_key_t cacheKey) const;
+
+    /// Checks if a thumbnail has been stored without reading it.
+    bool contains(mixxx::cache_key_t cacheKey) const;
+
+    /// Downscales and stores the image. Returns the stored thumbnail
+    /// or a null image on failure.
+    QImage store(mixxx::cache_key_t cacheKey, const QImage& image) const;
+
+    /// Deletes the least recently used thumbnails until the total size
+    /// doesn't exceed the limit. Returns the number of deleted files.
+    int evictLeastRecentlyUsed() const;
+
+    QString filePath(mixxx::cache_key_t cacheKey) const;
+
+  private:
+    const QString m_directory;
+    const qint64 m_maxTotalBytes;
+};
@@ -5,6 +5,7 @@
 #include <QRegularExpression>
 #include <QtConcurrentRun>
 
+#include "library/coverartthumbnailcache.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/logger.h"
@@ -111,8 +112,27 @@ CoverInfoRelative CoverArtUtils::selectCoverArtForTrack(
     DEBUG_ASSERT(coverInfoRelative.imageDigest().isNull());
     DEBUG_ASSERT(coverInfoRelative.coverLocation.isNull());
     coverInfoRelative.source = CoverInfo::GUESSED;
+
+    const QFileInfo* bestInfo = selectCoverFileForTrack(trackFile, albumName, covers);
+    if (bestInfo) {
+        const QImage image(bestInfo->filePath());
+        if (!image.isNull()) {
+            coverInfoRelative.type = CoverInfo::FILE;
+            coverInfoRelative.coverLocation = bestInfo->fileName();
+            coverInfoRelative.setImageDigest(image);
+        }
+    }
+
+    return coverInfoRelative;
+}
+
+//static
+const QFileInfo* CoverArtUtils::selectCoverFileForTrack(
+        const mixxx::FileInfo& trackFile,
+        const QString& albumName,
+        const QList<QFileInfo>& covers) {
     if (covers.isEmpty()) {
-        return coverInfoRelative;
+        return nullptr;
     }
 
     PreferredCoverType bestType = NONE;
@@ -171,16 +191,25 @@ CoverInfoRelative CoverArtUtils::selectCoverArtForTrack(
         }
     }
 
-    if (bestInfo) {
-        const QImage image(bestInfo->filePath());
-        if (!image.isNull()) {
-            coverInfoRelative.type = CoverInfo::FILE;
-            coverInfoRelative.coverLocation = bestInfo->fileName();
-            coverInfoRelative.setImageDigest(image);
-        }
-    }
+    return bestInfo;
+}
 
-    return coverInfoRelative;
+CoverInfoGuesser::CoverInfoGuesser(
+        std::shared_ptr<const CoverArtThumbnailCache> pThumbnailCache)
+        : m_pThumbnailCache(std::move(pThumbnailCache)) {
+}
+
+void CoverInfoGuesser::storeThumbnail(
+        const CoverInfoRelative& coverInfo, const QImage& image) const {
+    if (!m_pThumbnailCache || !m_pThumbnailCache->isEnabled()) {
+        return;
+    }
+    const auto cacheKey = coverInfo.cacheKey();
+    if (m_pThumbnailCache->contains(cacheKey)) {
+        // Shared by multiple tracks, e.g. of the same album
+        return;
+    }
+    m_pThumbnailCache->store(cacheKey, image);
 }
 
 CoverInfoRelative CoverInfoGuesser::guessCoverInfo(
@@ -193,6 +222,7 @@ CoverInfoRelative CoverInfoGuesser::guessCoverInfo(
         coverInfo.type = CoverInfo::METADATA;
         coverInfo.setImageDigest(embeddedCover);
         DEBUG_ASSERT(coverInfo.coverLocation.isNull());
+        storeThumbnail(coverInfo, embeddedCover);
         return coverInfo;
     }
 
@@ -202,11 +232,33 @@ CoverInfoRelative CoverInfoGuesser::guessCoverInfo(
         m_cachedPossibleCoversInFolder =
                 CoverArtUtils::findPossibleCoversInFolder(
                         m_cachedFolder);
+        m_cachedCoverFilesInFolder.clear();
     }
-    return CoverArtUtils::selectCoverArtForTrack(
+
+    const QFileInfo* pCoverFile = CoverArtUtils::selectCoverFileForTrack(
             trackFile,
             albumName,
             m_cachedPossibleCoversInFolder);
+    if (!pCoverFile) {
+        CoverInfoRelative coverInfo;
+        coverInfo.source = CoverInfo::GUESSED;
+        return coverInfo;
+    }
+    const auto cached = m_cachedCoverFilesInFolder.constFind(pCoverFile->fileName());
+    if (cached != m_cachedCoverFilesInFolder.constEnd()) {
+        return cached.value();
+    }
+    CoverInfoRelative coverInfo;
+    coverInfo.source = CoverInfo::GUESSED;
+    const QImage image(pCoverFile->filePath());
+    if (!image.isNull()) {
+        coverInfo.type = CoverInfo::FILE;
+        coverInfo.coverLocation = pCoverFile->fileName();
+        coverInfo.setImageDigest(image);
+        storeThumbnail(coverInfo, image);
+    }
+    m_cachedCoverFilesInFolder.insert(pCoverFile->fileName(), coverInfo);
+    return coverInfo;
 }
 
 CoverInfoRelative CoverInfoGuesser::guessCoverInfoForTrack(
@@ -2,15 +2,18 @@
 
 #include <QFileInfo>
 #include <QFuture>
+#include <QHash>
 #include <QImage>
 #include <QList>
 #include <QSize>
 #include <QString>
 #include <QStringList>
+#include <memory>
 
+#include "library/coverart.h"
 #include "track/track_decl.h"
 
-class CoverInfoRelative;
+class CoverArtThumbnailCache;
 
 namespace mixxx {
 
@@ -63,12 +66,26 @@ class CoverArtUtils {
             const mixxx::FileInfo& trackFile,
             const QString& albumName,
             const QList<QFileInfo>& covers);
+
+    // Selects the cover file without reading it. Returns nullptr if none
+    // of the provided files is appropriate.
+    static const QFileInfo* selectCoverFileForTrack(
+            const mixxx::FileInfo& trackFile,
+            const QString& albumName,
+            const QList<QFileInfo>& covers);
 };
 
 // Stateful guessing of cover art by caching the possible
 // covers from the last visited folder.
 class CoverInfoGuesser {
   public:
+    // If a thumbnail cache is provided, the thumbnails of all images that
+    // are read while guessing are stored, e.g. while scanning the library.
+    // The covers of the library table are then never extracted from the
+    // files when they are displayed for the first time.
+    explicit CoverInfoGuesser(
+            std::shared_ptr<const CoverArtThumbnailCache> pThumbnailCache = {});
+
     // Guesses the cover art for the provided track.
     // An embedded cover must be extracted beforehand and provided.
     CoverInfoRelative guessCoverInfo(
@@ -86,8 +103,14 @@ class CoverInfoGuesser {
             const TrackPointerList& tracks);
 
   private:
+    void storeThumbnail(const CoverInfoRelative& coverInfo, const QImage& image) const;
+
+    const std::shared_ptr<const CoverArtThumbnailCache> m_pThumbnailCache;
     QString m_cachedFolder;
     QList<QFileInfo> m_cachedPossibleCoversInFolder;
+    // All tracks in a folder usually share the same cover file, which
+    // is only read once, keyed by the file name
+    QHash<QString, CoverInfoRelative> m_cachedCoverFilesInFolder;
 };
 
 // Guesses the cover art for the provided tracks by searching the tracks'
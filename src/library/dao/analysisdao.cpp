@@ -3,14 +3,27 @@
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QtDebug>
+#include <limits>
+#include <utility>
 
 #include "library/queryutil.h"
 #include "preferences/waveformsettings.h"
+#include "track/beats.h"
+#include "track/keyfactory.h"
+#include "track/track.h"
+#include "util/db/sqltransaction.h"
 #include "util/performancetimer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformcache.h"
 
 const QString AnalysisDao::s_analysisTableName = "track_analysis";
 
+namespace {
+
+const QString kQueueTableName = QStringLiteral("analysis_queue");
+
+} // anonymous namespace
+
 // For a track that takes 1.2MB to store the big waveform, the default
 // compression level (-1) takes the size down to about 600KB. The difference
 // between the default and 9 (the max) was only about 1-2KB for a lot of extra
@@ -84,21 +97,28 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         int checksum = query->value(dataChecksumColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
-        const QByteArray compressedData = loadDataFromFile(dataPath);
+        QSharedPointer<QFile> pMappedFile;
+        const QByteArray storedData = mapDataFromFile(dataPath, &pMappedFile);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
         const int file_checksum = qChecksum(
-                compressedData);
+                storedData);
 #else
         const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
+                storedData.constData(),
+                storedData.length());
 #endif
         if (checksum != file_checksum) {
             qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
-                     << "length" << compressedData.length();
+                     << "length" << storedData.length();
             continue;
         }
-        info.data = qUncompress(compressedData);
+        if (Waveform::isPackedByteArray(storedData)) {
+            // Decoded directly from the mapped file
+            info.data = storedData;
+            info.mappedFile = std::move(pMappedFile);
+        } else {
+            info.data = qUncompress(storedData);
+        }
         bytes += info.data.length();
         analyses.append(info);
     }
@@ -120,14 +140,21 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    const QByteArray compressedData = qCompress(info->data, kCompressionLevel);
+    // Packed waveforms are already compressed and stored as is, such that
+    // they could be loaded from a memory mapped file. The data of qCompress()
+    // starts with the uncompressed size in big-endian byte order and can't be
+    // mistaken for a packed waveform, unless it is larger than 1.2 GB.
+    const bool isPacked = Waveform::isPackedByteArray(info->data);
+    const QByteArray storedData = isPacked
+            ? info->data
+            : qCompress(info->data, kCompressionLevel);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     const int checksum = qChecksum(
-            compressedData);
+            storedData);
 #else
     const int checksum = qChecksum(
-            compressedData.constData(),
-            compressedData.length());
+            storedData.constData(),
+            storedData.length());
 #endif
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
@@ -172,14 +199,15 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
 
     QString dataPath = getAnalysisStoragePath().absoluteFilePath(
         QString::number(info->analysisId));
-    if (!saveDataToFile(dataPath, compressedData)) {
+    if (!saveDataToFile(dataPath, storedData)) {
         qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
         return false;
     }
 
     qDebug() << "AnalysisDAO saved analysis" << info->analysisId
-             << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
-                                                  QString::number(compressedData.length()))
+             << QString("%1 (%2 %3)").arg(QString::number(info->data.length()),
+                                                  QString::number(storedData.length()),
+                                                  isPacked ? "packed" : "compressed")
              << "bytes for track"
              << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
     return true;
@@ -209,6 +237,7 @@ void AnalysisDao::deleteAnalyses(const QList<TrackId>& trackIds) {
     QStringList idList;
     for (const auto& trackId: trackIds) {
         idList << trackId.toString();
+        WaveformCache::remove(trackId);
     }
     QSqlQuery query(m_database);
     query.prepare(QString("SELECT track_analysis.id FROM track_analysis WHERE "
@@ -228,12 +257,18 @@ void AnalysisDao::deleteAnalyses(const QList<TrackId>& trackIds) {
     if (!query.exec()) {
         LOG_FAILED_QUERY(query) << "couldn't delete analysis";
     }
+    query.prepare(QString("DELETE FROM %1 WHERE track_id in (%2)")
+                          .arg(kQueueTableName, idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't dequeue tracks";
+    }
 }
 
 bool AnalysisDao::deleteAnalysesForTrack(TrackId trackId) {
     if (!trackId.isValid()) {
         return false;
     }
+    WaveformCache::remove(trackId);
     QSqlQuery query(m_database);
     query.prepare(QString(
         "SELECT id FROM %1 where track_id = :track_id").arg(s_analysisTableName));
@@ -262,15 +297,27 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
-QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
-    QFile file(filename);
-    if (!file.exists()) {
+QByteArray AnalysisDao::mapDataFromFile(
+        const QString& fileName,
+        QSharedPointer<QFile>* pMappedFile) const {
+    auto pFile = QSharedPointer<QFile>::create(fileName);
+    if (!pFile->exists()) {
         return QByteArray();
     }
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!pFile->open(QIODevice::ReadOnly)) {
         return QByteArray();
     }
-    return file.readAll();
+    const qint64 size = pFile->size();
+    // Closing the file would unmap the memory
+    const uchar* pData = size > 0 && size <= std::numeric_limits<int>::max()
+            ? pFile->map(0, size)
+            : nullptr;
+    if (!pData) {
+        return pFile->readAll();
+    }
+    *pMappedFile = pFile;
+    return QByteArray::fromRawData(
+            reinterpret_cast<const char*>(pData), static_cast<int>(size));
 }
 
 bool AnalysisDao::deleteFile(const QString& fileName) const {
@@ -340,7 +387,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    analysis.data = pWaveform->toPackedByteArray();
     bool success = saveAnalysis(&analysis);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
@@ -355,7 +402,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
-    analysis.data = pWaveSummary->toByteArray();
+    analysis.data = pWaveSummary->toPackedByteArray();
 
     success = saveAnalysis(&analysis);
     if (success) {
@@ -392,6 +439,9 @@ size_t AnalysisDao::getDiskUsageInBytes(
 bool AnalysisDao::deleteAnalysesByType(
         const QSqlDatabase& database,
         AnalysisType type) const {
+    if (type == TYPE_WAVEFORM || type == TYPE_WAVESUMMARY) {
+        WaveformCache::clear();
+    }
     QDir analysisPath(getAnalysisStoragePath());
 
     QSqlQuery query(database);
@@ -416,3 +466,245 @@ bool AnalysisDao::deleteAnalysesByType(
 
     return true;
 }
+
+bool AnalysisDao::hasAnalysesForTrack(TrackId trackId) {
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "SELECT 1 FROM %1 WHERE track_id=:trackId LIMIT 1")
+                    .arg(s_analysisTableName));
+    query.bindValue(":trackId", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get analyses for track" << trackId;
+        return false;
+    }
+    return query.next();
+}
+
+bool AnalysisDao::copyAnalyses(TrackId fromTrackId, TrackId toTrackId) {
+    // Only waveforms are stored as analyses, see saveTrackAnalyses()
+    WaveformSettings waveformSettings(m_pConfig);
+    if (!waveformSettings.waveformCachingEnabled()) {
+        return false;
+    }
+    const QList<AnalysisInfo> analyses = getAnalysesForTrack(fromTrackId);
+    bool success = !analyses.isEmpty();
+    for (AnalysisInfo analysis : analyses) {
+        analysis.analysisId = -1;
+        analysis.trackId = toTrackId;
+        if (!saveAnalysis(&analysis)) {
+            success = false;
+        }
+    }
+    return success;
+}
+
+QByteArray AnalysisDao::getAudioDigest(TrackId trackId) {
+    if (!m_database.isOpen() || !trackId.isValid()) {
+        return QByteArray();
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT audio_digest FROM library WHERE id=:trackId"));
+    query.bindValue(":trackId", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get audio digest of track" << trackId;
+        return QByteArray();
+    }
+    if (!query.next()) {
+        return QByteArray();
+    }
+    return query.value(0).toByteArray();
+}
+
+bool AnalysisDao::saveAudioDigest(TrackId trackId, const QByteArray& audioDigest) {
+    if (!m_database.isOpen() || !trackId.isValid()) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "UPDATE library SET audio_digest=:audioDigest WHERE id=:trackId"));
+    query.bindValue(":audioDigest", audioDigest.isEmpty() ? QVariant() : audioDigest);
+    query.bindValue(":trackId", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't save audio digest of track" << trackId;
+        return false;
+    }
+    return true;
+}
+
+bool AnalysisDao::restoreAnalysesFromDuplicates(
+        Track* pTrack,
+        const QByteArray& audioDigest) {
+    const TrackId trackId = pTrack->getId();
+    if (!m_database.isOpen() || !trackId.isValid() || audioDigest.isEmpty()) {
+        return false;
+    }
+    bool missingBeats = !pTrack->getBeats() && pTrack->getSampleRate().isValid();
+    bool missingKeys = pTrack->getKeys().getGlobalKey() == mixxx::track::io::key::INVALID;
+    bool missingReplayGain = !pTrack->getReplayGain().hasRatio();
+    bool missingWaveforms = !hasAnalysesForTrack(trackId);
+    if (!missingBeats && !missingKeys && !missingReplayGain && !missingWaveforms) {
+        return false;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT id,"
+            "beats_version,beats_sub_version,beats,"
+            "keys_version,keys_sub_version,keys,"
+            "replaygain,replaygain_peak "
+            "FROM library WHERE audio_digest=:audioDigest AND id<>:trackId"));
+    query.bindValue(":audioDigest", audioDigest);
+    query.bindValue(":trackId", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get duplicates of track" << trackId;
+        return false;
+    }
+
+    const QSqlRecord queryRecord = query.record();
+    const int idColumn = queryRecord.indexOf("id");
+    const int beatsVersionColumn = queryRecord.indexOf("beats_version");
+    const int beatsSubVersionColumn = queryRecord.indexOf("beats_sub_version");
+    const int beatsColumn = queryRecord.indexOf("beats");
+    const int keysVersionColumn = queryRecord.indexOf("keys_version");
+    const int keysSubVersionColumn = queryRecord.indexOf("keys_sub_version");
+    const int keysColumn = queryRecord.indexOf("keys");
+    const int replayGainColumn = queryRecord.indexOf("replaygain");
+    const int replayGainPeakColumn = queryRecord.indexOf("replaygain_peak");
+    bool restored = false;
+    // Each result is taken from the first duplicate that provides it
+    while (query.next() &&
+            (missingBeats || missingKeys || missingReplayGain || missingWaveforms)) {
+        const TrackId duplicateId(query.value(idColumn));
+        if (missingBeats) {
+            const QString beatsVersion = query.value(beatsVersionColumn).toString();
+            const mixxx::BeatsPointer pBeats = beatsVersion.isEmpty()
+                    ? nullptr
+                    : mixxx::Beats::fromByteArray(pTrack->getSampleRate(),
+                              beatsVersion,
+                              query.value(beatsSubVersionColumn).toString(),
+                              query.value(beatsColumn).toByteArray());
+            if (pBeats && pTrack->trySetBeats(pBeats)) {
+                qDebug() << "Restored beats of track" << trackId
+                         << "from duplicate" << duplicateId;
+                missingBeats = false;
+                restored = true;
+            }
+        }
+        if (missingKeys) {
+            const QString keysVersion = query.value(keysVersionColumn).toString();
+            if (!keysVersion.isEmpty()) {
+                QByteArray keysBlob = query.value(keysColumn).toByteArray();
+                const Keys keys = KeyFactory::loadKeysFromByteArray(
+                        keysVersion,
+                        query.value(keysSubVersionColumn).toString(),
+                        &keysBlob);
+                if (keys.getGlobalKey() != mixxx::track::io::key::INVALID) {
+                    pTrack->setKeys(keys);
+                    qDebug() << "Restored keys of track" << trackId
+                             << "from duplicate" << duplicateId;
+                    missingKeys = false;
+                    restored = true;
+                }
+            }
+        }
+        if (missingReplayGain) {
+            const double ratio = query.value(replayGainColumn).toDouble();
+            if (mixxx::ReplayGain::isValidRatio(ratio)) {
+                mixxx::ReplayGain replayGain(pTrack->getReplayGain());
+                replayGain.setRatio(ratio);
+                replayGain.setPeak(query.value(replayGainPeakColumn).toFloat());
+                pTrack->setReplayGain(replayGain);
+                qDebug() << "Restored ReplayGain of track" << trackId
+                         << "from duplicate" << duplicateId;
+                missingReplayGain = false;
+                restored = true;
+            }
+        }
+        if (missingWaveforms && copyAnalyses(duplicateId, trackId)) {
+            qDebug() << "Restored waveforms of track" << trackId
+                     << "from duplicate" << duplicateId;
+            missingWaveforms = false;
+            restored = true;
+        }
+    }
+    return restored;
+}
+
+void AnalysisDao::enqueueTracks(const QList<AnalyzerScheduledTrack>& tracks) {
+    if (!m_database.isOpen() || tracks.isEmpty()) {
+        return;
+    }
+    SqlTransaction transaction(m_database);
+    QSqlQuery query(m_database);
+    // Tracks that are already queued keep their position
+    query.prepare(QString(
+            "INSERT OR IGNORE INTO %1 (track_id, use_fixed_tempo) "
+            "VALUES (:trackId,:useFixedTempo)")
+                    .arg(kQueueTableName));
+    for (const auto& track : tracks) {
+        const auto& useFixedTempo = track.getOptions().useFixedTempo;
+        query.bindValue(":trackId", track.getTrackId().toVariant());
+        query.bindValue(":useFixedTempo",
+                useFixedTempo ? QVariant(*useFixedTempo) : QVariant());
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query) << "couldn't enqueue track" << track.getTrackId();
+            return;
+        }
+    }
+    transaction.commit();
+}
+
+void AnalysisDao::dequeueTrack(TrackId trackId) {
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "DELETE FROM %1 WHERE track_id=:trackId")
+                    .arg(kQueueTableName));
+    query.bindValue(":trackId", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't dequeue track" << trackId;
+    }
+}
+
+void AnalysisDao::clearQueue() {
+    QSqlQuery query(m_database);
+    query.prepare(QString("DELETE FROM %1").arg(kQueueTableName));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't clear analysis queue";
+    }
+}
+
+QList<AnalyzerScheduledTrack> AnalysisDao::getQueuedTracks() {
+    QList<AnalyzerScheduledTrack> tracks;
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "SELECT track_id, use_fixed_tempo FROM %1 ORDER BY id")
+                    .arg(kQueueTableName));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get analysis queue";
+        return tracks;
+    }
+    const QSqlRecord queryRecord = query.record();
+    const int trackIdColumn = queryRecord.indexOf("track_id");
+    const int useFixedTempoColumn = queryRecord.indexOf("use_fixed_tempo");
+    while (query.next()) {
+        AnalyzerTrack::Options options;
+        const QVariant useFixedTempo = query.value(useFixedTempoColumn);
+        if (!useFixedTempo.isNull()) {
+            options.useFixedTempo = useFixedTempo.toBool();
+        }
+        tracks.append(AnalyzerScheduledTrack(
+                TrackId(query.value(trackIdColumn)), options));
+    }
+    return tracks;
+}
+
+int AnalysisDao::countQueuedTracks() {
+    QSqlQuery query(m_database);
+    query.prepare(QString("SELECT COUNT(*) FROM %1").arg(kQueueTableName));
+    if (!query.exec() || !query.next()) {
+        LOG_FAILED_QUERY(query) << "couldn't count analysis queue";
+        return 0;
+    }
+    return query.value(0).toInt();
+}
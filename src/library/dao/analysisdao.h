@@ -1,13 +1,17 @@
 #pragma once
 
 #include <QDir>
+#include <QFile>
+#include <QSharedPointer>
 
-#include "preferences/usersettings.h"
+#include "analyzer/analyzerscheduledtrack.h"
 #include "library/dao/dao.h"
+#include "preferences/usersettings.h"
 #include "track/trackid.h"
 #include "waveform/waveform.h"
 
 class QSqlDatabase;
+class Track;
 
 class AnalysisDao : public DAO {
   public:
@@ -29,7 +33,9 @@ class AnalysisDao : public DAO {
         AnalysisType type;
         QString description;
         QString version;
+        // Might reference the memory of mappedFile
         QByteArray data;
+        QSharedPointer<QFile> mappedFile;
     };
 
     explicit AnalysisDao(UserSettingsPointer pConfig);
@@ -57,12 +63,38 @@ class AnalysisDao : public DAO {
             ConstWaveformPointer pWaveform,
             ConstWaveformPointer pWaveSummary);
 
+    // The digest of the decoded audio that identifies duplicate files,
+    // see mixxx::digestAudioSource(). Stored in the library table.
+    QByteArray getAudioDigest(TrackId trackId);
+    bool saveAudioDigest(TrackId trackId, const QByteArray& audioDigest);
+
+    // Restores the missing beats, keys, ReplayGain and waveforms of the
+    // track from other tracks in the library with the same audio digest.
+    // Results of the track itself are never replaced. Returns true if
+    // anything has been restored.
+    bool restoreAnalysesFromDuplicates(
+            Track* pTrack,
+            const QByteArray& audioDigest);
+
+    // The queue of the batch analysis in the order of scheduling. It is
+    // persisted for continuing the analysis after a restart.
+    void enqueueTracks(const QList<AnalyzerScheduledTrack>& tracks);
+    void dequeueTrack(TrackId trackId);
+    void clearQueue();
+    QList<AnalyzerScheduledTrack> getQueuedTracks();
+    int countQueuedTracks();
+
   private:
     QDir getAnalysisStoragePath() const;
-    QByteArray loadDataFromFile(const QString& fileName) const;
+    // Falls back to reading the file if it could not be mapped
+    QByteArray mapDataFromFile(
+            const QString& fileName,
+            QSharedPointer<QFile>* pMappedFile) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
+    bool hasAnalysesForTrack(TrackId trackId);
+    bool copyAnalyses(TrackId fromTrackId, TrackId toTrackId);
 
     const UserSettingsPointer m_pConfig;
 };
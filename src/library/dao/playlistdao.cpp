@@ -2,6 +2,8 @@
 
 #include <QRandomGenerator>
 #include <QtDebug>
+#include <algorithm>
+#include <limits>
 
 #include "library/autodj/autodjprocessor.h"
 #include "library/dao/trackschema.h"
@@ -577,10 +579,11 @@ void PlaylistDAO::removeHiddenTracks(const int playlistId) {
         return;
     }
 
+    QList<int> positions;
     while (query.next()) {
-        int position = query.value(query.record().indexOf("position")).toInt();
-        removeTracksFromPlaylistInner(playlistId, position);
+        positions.append(query.value(query.record().indexOf("position")).toInt());
     }
+    removeTracksFromPlaylistInner(playlistId, positions);
 
     transaction.commit();
     emit playlistContentChanged(QSet<int>{playlistId});
@@ -609,10 +612,11 @@ void PlaylistDAO::removeTracksFromPlaylistByIdInner(int playlistId, TrackId trac
         return;
     }
 
+    QList<int> positions;
     while (query.next()) {
-        int position = query.value(query.record().indexOf("position")).toInt();
-        removeTracksFromPlaylistInner(playlistId, position);
+        positions.append(query.value(query.record().indexOf("position")).toInt());
     }
+    removeTracksFromPlaylistInner(playlistId, positions);
 }
 
 void PlaylistDAO::removeTrackFromPlaylist(int playlistId, int position) {
@@ -626,22 +630,76 @@ void PlaylistDAO::removeTrackFromPlaylist(int playlistId, int position) {
 }
 
 void PlaylistDAO::removeTracksFromPlaylist(int playlistId, const QList<int>& positions) {
-    // get positions in reversed order
-    auto sortedPositons = positions;
-    std::sort(sortedPositons.begin(), sortedPositons.end(), std::greater<int>());
-
     //qDebug() << "PlaylistDAO::removeTrackFromPlaylist"
     //         << QThread::currentThread() << m_database.connectionName();
     ScopedTransaction transaction(m_database);
-    for (const auto position : std::as_const(sortedPositons)) {
-        removeTracksFromPlaylistInner(playlistId, position);
-    }
+    removeTracksFromPlaylistInner(playlistId, positions);
     transaction.commit();
     emit playlistContentChanged(QSet<int>{playlistId});
     emit tracksRemoved(QSet<int>{playlistId});
 }
 
+void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, const QList<int>& positions) {
+    // get positions in reversed order
+    auto sortedPositons = positions;
+    std::sort(sortedPositons.begin(), sortedPositons.end(), std::greater<int>());
+
+    QList<QPair<int, TrackId>> removedTracks;
+    removedTracks.reserve(sortedPositons.size());
+    for (const auto position : std::as_const(sortedPositons)) {
+        const TrackId trackId = deleteTrackAtPosition(playlistId, position);
+        if (trackId.isValid()) {
+            removedTracks.append(qMakePair(position, trackId));
+        }
+    }
+
+    // Instead of moving all following tracks up after each removal, which
+    // rewrites the whole remaining playlist once per removed track, the
+    // tracks between two removed positions are moved only once by the number
+    // of tracks that have been removed above them.
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "UPDATE PlaylistTracks SET position=position-:offset "
+            "WHERE position>:first AND position<:last AND playlist_id=:id"));
+    query.bindValue(":id", playlistId);
+    const int numRemovedTracks = static_cast<int>(removedTracks.size());
+    for (int i = numRemovedTracks - 1; i >= 0; --i) {
+        const int offset = numRemovedTracks - i;
+        query.bindValue(":offset", offset);
+        query.bindValue(":first", removedTracks[i].first);
+        query.bindValue(":last",
+                i > 0 ? removedTracks[i - 1].first : std::numeric_limits<int>::max());
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+        }
+    }
+
+    for (const auto& [position, trackId] : std::as_const(removedTracks)) {
+        onTrackRemoved(playlistId, trackId, position);
+    }
+}
+
 void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, int position) {
+    const TrackId trackId = deleteTrackAtPosition(playlistId, position);
+    if (!trackId.isValid()) {
+        return;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "UPDATE PlaylistTracks SET position=position-1 "
+            "WHERE position>=:position AND playlist_id=:id"));
+    query.bindValue(":id", playlistId);
+    query.bindValue(":position", position);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+
+    onTrackRemoved(playlistId, trackId, position);
+}
+
+TrackId PlaylistDAO::deleteTrackAtPosition(int playlistId, int position) {
     QSqlQuery query(m_database);
     query.prepare(QStringLiteral(
             "SELECT track_id FROM PlaylistTracks "
@@ -651,13 +709,13 @@ void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, int position) {
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
+        return TrackId();
     }
 
     if (!query.next()) {
         qDebug() << "removeTrackFromPlaylist no track exists at position:"
                  << position << "in playlist:" << playlistId;
-        return;
+        return TrackId();
     }
     TrackId trackId(query.value(query.record().indexOf("track_id")));
 
@@ -670,19 +728,12 @@ void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, int position) {
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
-    }
-
-    query.prepare(QStringLiteral(
-            "UPDATE PlaylistTracks SET position=position-1 "
-            "WHERE position>=:position AND playlist_id=:id"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+        return TrackId();
     }
+    return trackId;
+}
 
+void PlaylistDAO::onTrackRemoved(int playlistId, TrackId trackId, int position) {
     m_playlistsTrackIsIn.remove(trackId, playlistId);
 
     emit trackRemoved(playlistId, trackId, position);
@@ -754,50 +805,70 @@ int PlaylistDAO::insertTracksIntoPlaylist(const QList<TrackId>& trackIds,
         position = max_position;
     }
 
+    const int numValidTracks = static_cast<int>(std::count_if(
+            trackIds.cbegin(), trackIds.cend(), [](const TrackId& trackId) {
+                return trackId.isValid();
+            }));
+    if (numValidTracks == 0) {
+        return 0;
+    }
+
+    // Move all following tracks in playlist down at once to make room
+    // for the inserted tracks.
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "UPDATE PlaylistTracks SET position=position+:offset "
+            "WHERE position>=:position AND "
+            "playlist_id=:id"));
+    query.bindValue(":id", playlistId);
+    query.bindValue(":position", position);
+    query.bindValue(":offset", numValidTracks);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return 0;
+    }
+
     QSqlQuery insertQuery(m_database);
     insertQuery.prepare(QStringLiteral(
             "INSERT INTO PlaylistTracks (playlist_id, track_id, position)"
             "VALUES (:playlist_id, :track_id, :position)"));
-    QSqlQuery query(m_database);
-    int insertPositon = position;
+    insertQuery.bindValue(":playlist_id", playlistId);
+    QList<TrackId> addedTrackIds;
+    addedTrackIds.reserve(numValidTracks);
     for (const auto& trackId : trackIds) {
         if (!trackId.isValid()) {
             continue;
         }
-        // Move all tracks in playlist up by 1.
-        // TODO(XXX) We could do this in one query before the for loop.
-        query.prepare(QStringLiteral(
-                "UPDATE PlaylistTracks SET position=position+1 "
-                "WHERE position>=:position AND "
-                "playlist_id=:id"));
-        query.bindValue(":id", playlistId);
-        query.bindValue(":position", insertPositon);
-
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
-            continue;
-        }
-
         // Insert the track at the given position
-        insertQuery.bindValue(":playlist_id", playlistId);
         insertQuery.bindValue(":track_id", trackId.toVariant());
-        insertQuery.bindValue(":position", insertPositon);
+        insertQuery.bindValue(":position", position + numTracksAdded);
         if (!insertQuery.exec()) {
             LOG_FAILED_QUERY(insertQuery);
             continue;
         }
-
-        // Increment the insert position for the track.
-        ++insertPositon;
+        addedTrackIds.append(trackId);
         ++numTracksAdded;
     }
 
+    if (numTracksAdded < numValidTracks) {
+        // Close the gap that is left by the tracks that failed to insert
+        query.prepare(QStringLiteral(
+                "UPDATE PlaylistTracks SET position=position-:offset "
+                "WHERE position>=:position AND "
+                "playlist_id=:id"));
+        query.bindValue(":id", playlistId);
+        query.bindValue(":position", position + numValidTracks);
+        query.bindValue(":offset", numValidTracks - numTracksAdded);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+        }
+    }
+
     transaction.commit();
 
-    insertPositon = position;
-    for (const auto& trackId : trackIds) {
+    int insertPositon = position;
+    for (const auto& trackId : std::as_const(addedTrackIds)) {
         m_playlistsTrackIsIn.insert(trackId, playlistId);
-        // TODO(XXX) The position is wrong if any track failed to insert.
         emit trackAdded(playlistId, trackId, insertPositon++);
     }
     emit tracksAdded(QSet<int>{playlistId});
@@ -1085,6 +1156,72 @@ void PlaylistDAO::moveTrack(const int playlistId, const int oldPosition, const i
     emit tracksMoved(QSet<int>{playlistId});
 }
 
+void PlaylistDAO::moveTracks(const int playlistId,
+        const QList<int>& positions,
+        const int destPosition) {
+    if (positions.isEmpty()) {
+        return;
+    }
+    ScopedTransaction transaction(m_database);
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT id, position FROM PlaylistTracks "
+            "WHERE playlist_id=:id ORDER BY position"));
+    query.bindValue(":id", playlistId);
+    query.setForwardOnly(true);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+
+    // Rearrange the rows in memory and only write the positions that
+    // have actually changed, instead of moving the tracks one by one.
+    // The rows are identified by their id and their current position.
+    const QSet<int> movedPositions(positions.cbegin(), positions.cend());
+    QList<QPair<int, int>> movedRows;
+    QList<QPair<int, int>> otherRows;
+    int insertIndex = -1;
+    while (query.next()) {
+        const auto row = qMakePair(query.value(0).toInt(), query.value(1).toInt());
+        if (movedPositions.contains(row.second)) {
+            movedRows.append(row);
+        } else {
+            if (insertIndex < 0 && row.second >= destPosition) {
+                insertIndex = static_cast<int>(otherRows.size());
+            }
+            otherRows.append(row);
+        }
+    }
+    if (movedRows.isEmpty()) {
+        return;
+    }
+    if (insertIndex < 0) {
+        insertIndex = static_cast<int>(otherRows.size());
+    }
+    QList<QPair<int, int>> rows = otherRows.mid(0, insertIndex);
+    rows.append(movedRows);
+    rows.append(otherRows.mid(insertIndex));
+
+    query.prepare(QStringLiteral(
+            "UPDATE PlaylistTracks SET position=:position "
+            "WHERE id=:row_id"));
+    for (int i = 0; i < rows.size(); ++i) {
+        const int newPosition = i + 1;
+        if (rows[i].second == newPosition) {
+            continue;
+        }
+        query.bindValue(":position", newPosition);
+        query.bindValue(":row_id", rows[i].first);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return;
+        }
+    }
+    transaction.commit();
+
+    emit tracksMoved(QSet<int>{playlistId});
+}
+
 void PlaylistDAO::searchForDuplicateTrack(const int fromPosition,
         const int toPosition,
         TrackId trackID,
@@ -109,6 +109,13 @@ class PlaylistDAO : public QObject, public virtual DAO {
     // moved Track to a new position
     void moveTrack(const int playlistId,
             const int oldPosition, const int newPosition);
+    // Moves the tracks at the given positions in their current order in
+    // front of the track at destPosition, or to the end if destPosition
+    // is past the last track. All positions are updated within a single
+    // transaction with a single notification.
+    void moveTracks(const int playlistId,
+            const QList<int>& positions,
+            const int destPosition);
     // shuffles all tracks in the position List
     void shuffleTracks(const int playlistId, const QList<int>& positions, const QHash<int,TrackId>& allIds);
     bool isTrackInPlaylist(TrackId trackId, const int playlistId) const;
@@ -135,6 +142,13 @@ class PlaylistDAO : public QObject, public virtual DAO {
   private:
     bool removeTracksFromPlaylist(int playlistId, int startIndex);
     void removeTracksFromPlaylistInner(int playlistId, int position);
+    void removeTracksFromPlaylistInner(int playlistId, const QList<int>& positions);
+    /// Deletes the track at the given position without moving the
+    /// following tracks. Returns an invalid id if there is no track.
+    TrackId deleteTrackAtPosition(int playlistId, int position);
+    /// Updates the membership cache and emits the signals for a track
+    /// that has been removed from the given position.
+    void onTrackRemoved(int playlistId, TrackId trackId, int position);
     void removeTracksFromPlaylistByIdInner(int playlistId, TrackId trackId);
     void searchForDuplicateTrack(const int fromPosition,
                                  const int toPosition,
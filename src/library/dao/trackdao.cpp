@@ -5,19 +5,25 @@
 #include <QFileInfo>
 #include <QThread>
 #include <QtDebug>
+#include <cmath>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
 #endif // __SQLITE3__
 
 #include "library/coverart.h"
+#include "library/coverartcache.h"
 #include "library/coverartutils.h"
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
+#include "library/dao/trackschema.h"
+#include "library/dao/tracksnapshot.h"
 #include "library/library_prefs.h"
 #include "library/queryutil.h"
+#include "library/trackmetadataexportqueue.h"
+#include "library/trackwritebehindqueue.h"
 #include "moc_trackdao.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/beats.h"
@@ -27,6 +33,7 @@
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/datetime.h"
+#include "util/db/dbconnection.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/db/sqlite.h"
 #include "util/db/sqlstringformatter.h"
@@ -35,6 +42,7 @@
 #include "util/fileinfo.h"
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/performancetimer.h"
 #include "util/qt.h"
 #include "util/timer.h"
 
@@ -90,7 +98,10 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
           m_pConfig(pConfig),
           m_trackLocationIdColumn(UndefinedRecordIndex),
           m_queryLibraryIdColumn(UndefinedRecordIndex),
-          m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex) {
+          m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex),
+          m_bFullTextIndex(false),
+          m_pWriteBehindQueue(nullptr),
+          m_pMetadataExportQueue(nullptr) {
     connect(&m_playlistDao,
             &PlaylistDAO::tracksRemovedFromPlayedHistory,
             this,
@@ -111,6 +122,25 @@ TrackDAO::~TrackDAO() {
     addTracksFinish(true);
 }
 
+void TrackDAO::initialize(const QSqlDatabase& database) {
+    DAO::initialize(database);
+
+    // The index is recreated empty when the schema migration is reapplied,
+    // i.e. after an older version that doesn't know the index has used the
+    // database.
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT (SELECT COUNT(*) FROM library),"
+            "(SELECT COUNT(*) FROM " LIBRARYFTS_TABLE ")"));
+    if (!query.exec() || !query.next()) {
+        LOG_FAILED_QUERY(query);
+        m_bFullTextIndex = false;
+        return;
+    }
+    m_bFullTextIndex = query.value(0).toInt() == query.value(1).toInt() ||
+            rebuildFullTextIndex();
+}
+
 void TrackDAO::finish() {
     kLogger.debug() << "TrackDAO::finish()";
 
@@ -300,6 +330,25 @@ QSet<QString> TrackDAO::getAllTrackLocations() const {
     return locations;
 }
 
+QList<TrackId> TrackDAO::getAllTrackIds() const {
+    QList<TrackId> trackIds;
+    QSqlQuery query(m_database);
+    query.prepare("SELECT library.id FROM library "
+                  "INNER JOIN track_locations ON library.location = track_locations.id "
+                  "WHERE library.mixxx_deleted=0 AND track_locations.fs_deleted=0");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        DEBUG_ASSERT(!"Failed query");
+        return trackIds;
+    }
+
+    const int idColumn = query.record().indexOf("id");
+    while (query.next()) {
+        trackIds.append(TrackId(query.value(idColumn)));
+    }
+    return trackIds;
+}
+
 // Some code (eg. drag and drop) needs to just get a track's location, and it's
 // not worth retrieving a whole Track.
 QString TrackDAO::getTrackLocation(TrackId trackId) const {
@@ -349,8 +398,43 @@ bool TrackDAO::saveTrack(Track* pTrack) const {
     return true;
 }
 
+bool TrackDAO::saveEvictedTrack(Track* pTrack) const {
+    VERIFY_OR_DEBUG_ASSERT(pTrack) {
+        return false;
+    }
+    DEBUG_ASSERT(pTrack->isDirty());
+
+    // The evicted track object will be deleted and its state cannot
+    // change anymore. BaseTrackCache is informed after the snapshot
+    // has actually been written.
+    if (m_pWriteBehindQueue &&
+            m_pWriteBehindQueue->enqueue(TrackSnapshot(*pTrack))) {
+        pTrack->markClean();
+        return true;
+    }
+    return saveTrack(pTrack);
+}
+
+void TrackDAO::setWriteBehindQueue(TrackWriteBehindQueue* pWriteBehindQueue) {
+    if (m_pWriteBehindQueue) {
+        disconnect(m_pWriteBehindQueue, nullptr, this, nullptr);
+    }
+    m_pWriteBehindQueue = pWriteBehindQueue;
+    if (m_pWriteBehindQueue) {
+        connect(m_pWriteBehindQueue,
+                &TrackWriteBehindQueue::tracksSaved,
+                this,
+                [this](const QSet<TrackId>& trackIds) {
+                    for (const auto& trackId : trackIds) {
+                        emit trackClean(trackId);
+                    }
+                });
+    }
+}
+
 void TrackDAO::slotDatabaseTracksChanged(const QSet<TrackId>& changedTrackIds) {
     if (!changedTrackIds.isEmpty()) {
+        updateFullTextIndex(changedTrackIds);
         emit tracksChanged(changedTrackIds);
     }
 }
@@ -371,6 +455,8 @@ void TrackDAO::slotDatabaseTracksRelocated(const QList<RelocatedTrack>& relocate
     }
     DEBUG_ASSERT(removedTrackIds.size() <= changedTrackIds.size());
     DEBUG_ASSERT(!removedTrackIds.intersects(changedTrackIds));
+    // The locations have been changed directly in the database
+    updateFullTextIndex(changedTrackIds + removedTrackIds);
     if (!removedTrackIds.isEmpty()) {
         emit tracksRemoved(removedTrackIds);
     }
@@ -424,6 +510,7 @@ void TrackDAO::addTracksPrepare() {
             "color,"
             "comment,"
             "url,"
+            "fingerprint,"
             "rating,"
             "key,"
             "key_id,"
@@ -472,6 +559,7 @@ void TrackDAO::addTracksPrepare() {
             ":color,"
             ":comment,"
             ":url,"
+            ":fingerprint,"
             ":rating,"
             ":key,"
             ":key_id,"
@@ -576,6 +664,8 @@ void bindTrackLibraryValues(
     pTrackLibraryQuery->bindValue(":color", mixxx::RgbColor::toQVariant(track.getColor()));
     pTrackLibraryQuery->bindValue(":comment", trackInfo.getComment());
     pTrackLibraryQuery->bindValue(":url", track.getUrl());
+    pTrackLibraryQuery->bindValue(":fingerprint",
+            track.getFingerprint().isEmpty() ? QVariant() : track.getFingerprint());
     pTrackLibraryQuery->bindValue(":rating", track.getRating());
     pTrackLibraryQuery->bindValue(":cuepoint",
             track.getMainCuePosition().toEngineSamplePosMaybeInvalid());
@@ -827,6 +917,7 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
         m_cueDao.saveTrackCues(
                 trackId,
                 pTrack->getCuePoints());
+        updateFullTextIndex(QSet<TrackId>{trackId});
 
         DEBUG_ASSERT(!m_tracksAddedSet.contains(trackId));
         m_tracksAddedSet.insert(trackId);
@@ -837,7 +928,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const QString& filePath,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::ImportedTrackMetadata* pImportedMetadata) {
     const auto fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePath));
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
@@ -905,7 +997,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pImportedMetadata);
     if (!pTrack->checkSourceSynchronized()) {
         kLogger.warning() << "TrackDAO::addTracksAddFile:"
                           << "Failed to parse track metadata from file"
@@ -1081,6 +1174,9 @@ bool TrackDAO::onPurgingTracks(
             return false;
         }
     }
+    if (!writeFullTextIndex(idListJoined)) {
+        return false;
+    }
     {
         // invalidate the hash in LibraryHash,
         // in case the file was not deleted to detect it on a rescan
@@ -1175,6 +1271,10 @@ void setTrackUrl(const QSqlRecord& record, const int column, Track* pTrack) {
     pTrack->setURL(record.value(column).toString());
 }
 
+void setTrackFingerprint(const QSqlRecord& record, const int column, Track* pTrack) {
+    pTrack->setFingerprint(record.value(column).toString());
+}
+
 void setTrackRating(const QSqlRecord& record, const int column, Track* pTrack) {
     pTrack->setRating(record.value(column).toInt());
 }
@@ -1350,6 +1450,18 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         return pTrack;
     }
 
+    if (m_pMetadataExportQueue) {
+        // Evicted tracks are passed on to the write-behind queue after
+        // their metadata has been exported. This also prevents reading
+        // the file while its tags are written.
+        m_pMetadataExportQueue->flushTrack(trackId);
+    }
+    if (m_pWriteBehindQueue) {
+        // Otherwise the track would be loaded from outdated metadata
+        // in the database if it has just been evicted.
+        m_pWriteBehindQueue->flushTrack(trackId);
+    }
+
     constexpr ColumnPopulator columns[] = {
             // Location must be first and is populated manually!
             {"track_locations.location", nullptr},
@@ -1368,6 +1480,7 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
             {"color", setTrackColor},
             {"comment", setTrackComment},
             {"url", setTrackUrl},
+            {"fingerprint", setTrackFingerprint},
             {"cuepoint", setTrackCuePoint},
             {"replaygain", setTrackReplayGainRatio},
             {"replaygain_peak", setTrackReplayGainPeak},
@@ -1419,28 +1532,33 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
 
     QSqlRecord queryRecord;
     {
-        QString columnsStr;
-        int columnsSize = 0;
-        for (int i = 0; i < columnsCount; ++i) {
-            columnsSize += static_cast<int>(qstrlen(columns[i].name)) + 1;
-        }
-        columnsStr.reserve(columnsSize);
-        for (int i = 0; i < columnsCount; ++i) {
-            if (i > 0) {
-                columnsStr.append(QChar(','));
+        // The statement is always the same to reuse the prepared query
+        static const QString kSelectTrackStatement = [&columns] {
+            QString columnsStr;
+            int columnsSize = 0;
+            for (int i = 0; i < columnsCount; ++i) {
+                columnsSize += static_cast<int>(qstrlen(columns[i].name)) + 1;
             }
-            columnsStr.append(columns[i].name);
-        }
-
-        QSqlQuery query(m_database);
-        query.prepare(QString(
-                "SELECT %1 FROM Library "
-                "INNER JOIN track_locations ON library.location = track_locations.id "
-                "WHERE library.id = %2")
-                              .arg(columnsStr, trackId.toString()));
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query)
-                    << QString("getTrack(%1)").arg(trackId.toString());
+            columnsStr.reserve(columnsSize);
+            for (int i = 0; i < columnsCount; ++i) {
+                if (i > 0) {
+                    columnsStr.append(QChar(','));
+                }
+                columnsStr.append(columns[i].name);
+            }
+            return QStringLiteral(
+                    "SELECT %1 FROM Library "
+                    "INNER JOIN track_locations ON library.location = track_locations.id "
+                    "WHERE library.id=:trackId")
+                    .arg(columnsStr);
+        }();
+
+        FwdSqlQuery query(m_database, kSelectTrackStatement);
+        query.bindValue(QStringLiteral(":trackId"), trackId);
+        if (!query.execPrepared()) {
+            kLogger.warning()
+                    << "Failed to load track"
+                    << trackId;
             DEBUG_ASSERT(!"Failed query");
             return nullptr;
         }
@@ -1639,13 +1757,18 @@ TrackPointer TrackDAO::getTrackByRef(
 
 // Saves a track's info back to the database
 bool TrackDAO::updateTrack(const Track& track) const {
-    const TrackId trackId = track.getId();
-    DEBUG_ASSERT(trackId.isValid());
+    QSet<TrackId> updatedTrackIds;
+    return updateTracks(QList<TrackSnapshot>{TrackSnapshot(track)}, &updatedTrackIds) &&
+            !updatedTrackIds.isEmpty();
+}
 
-    kLogger.debug() << "TrackDAO:"
-                    << "Updating track in database"
-                    << trackId
-                    << track.getLocation();
+bool TrackDAO::updateTracks(
+        const QList<TrackSnapshot>& snapshots,
+        QSet<TrackId>* pUpdatedTrackIds) const {
+    DEBUG_ASSERT(pUpdatedTrackIds);
+    if (snapshots.isEmpty()) {
+        return true;
+    }
 
     SqlTransaction transaction(m_database);
     // PerformanceTimer time;
@@ -1670,6 +1793,7 @@ bool TrackDAO::updateTrack(const Track& track) const {
             "color=:color,"
             "comment=:comment,"
             "url=:url,"
+            "fingerprint=:fingerprint,"
             "rating=:rating,"
             "key=:key,"
             "key_id=:key_id,"
@@ -1702,38 +1826,53 @@ bool TrackDAO::updateTrack(const Track& track) const {
             "coverart_hash=:coverart_hash "
             "WHERE id=:track_id");
 
-    query.bindValue(":track_id", trackId.toVariant());
+    QSet<TrackId> updatedTrackIds;
+    for (const auto& snapshot : snapshots) {
+        const TrackId trackId = snapshot.trackId;
+        DEBUG_ASSERT(trackId.isValid());
 
-    const auto trackRecord = track.getRecord();
-    bindTrackLibraryValues(
-            &query,
-            trackRecord,
-            track.getBeats());
+        kLogger.debug() << "TrackDAO:"
+                        << "Updating track in database"
+                        << trackId
+                        << snapshot.location;
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        DEBUG_ASSERT(!"Failed query");
-        return false;
-    }
+        query.bindValue(":track_id", trackId.toVariant());
+        bindTrackLibraryValues(
+                &query,
+                snapshot.trackRecord,
+                snapshot.pBeats);
+
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            DEBUG_ASSERT(!"Failed query");
+            return false;
+        }
+
+        if (query.numRowsAffected() == 0) {
+            // The track might have been purged in the meantime
+            kLogger.warning() << "updateTrack had no effect: trackId" << trackId << "invalid";
+            continue;
+        }
 
-    if (query.numRowsAffected() == 0) {
-        kLogger.warning() << "updateTrack had no effect: trackId" << trackId << "invalid";
+        // kLogger.debug() << "Update track took : " <<
+        // time.elapsed().formatMillisWithUnit() << "Now updating cues";
+        // time.start();
+        m_analysisDao.saveTrackAnalyses(
+                trackId,
+                snapshot.pWaveform,
+                snapshot.pWaveformSummary);
+        m_cueDao.saveTrackCues(
+                trackId, snapshot.cuePoints);
+        updatedTrackIds.insert(trackId);
+    }
+    updateFullTextIndex(updatedTrackIds);
+    if (!transaction.commit()) {
         return false;
     }
 
-    // kLogger.debug() << "Update track took : " <<
-    // time.elapsed().formatMillisWithUnit() << "Now updating cues";
-    // time.start();
-    m_analysisDao.saveTrackAnalyses(
-            trackId,
-            track.getWaveform(),
-            track.getWaveformSummary());
-    m_cueDao.saveTrackCues(
-            trackId, track.getCuePoints());
-    transaction.commit();
-
     // kLogger.debug() << "Update track in database took: " <<
     // time.elapsed().formatMillisWithUnit(); time.start();
+    *pUpdatedTrackIds = std::move(updatedTrackIds);
     return true;
 }
 
@@ -1754,6 +1893,21 @@ void TrackDAO::invalidateTrackLocationsInLibrary() const {
     }
 }
 
+void TrackDAO::invalidateTrackLocationsInDirectories(const QStringList& directories) const {
+    QSqlQuery query(m_database);
+    query.prepare(
+            QString("UPDATE track_locations "
+                    "SET needs_verification=1 "
+                    "WHERE directory IN (%1)")
+                    .arg(SqlStringFormatter::formatList(m_database, directories)));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't mark tracks in" << directories.size()
+                << "directories as needing verification.";
+        DEBUG_ASSERT(!"Failed query");
+    }
+}
+
 void TrackDAO::markTrackLocationsAsVerified(const QStringList& locations) const {
     // kLogger.debug() << "TrackDAO::markTrackLocationsAsVerified" <<
     // QThread::currentThread() << m_database.connectionName();
@@ -1851,20 +2005,50 @@ bool TrackDAO::detectMovedTracks(
         return true;
     }
 
-    // Query possible successors
+    // Load all possible successors at once and index them by filename, which
+    // avoids to query the added tracks again for each missing track.
     // NOTE: Successors are identified by filename and duration (in seconds).
     // Since duration is stored as double-precision floating-point and since it
     // is sometimes truncated to nearest integer, tolerance of 1 second is used.
-    QSqlQuery newTrackQuery(m_database);
-    newTrackQuery.prepare(QString(
-            "SELECT library.id as track_id, track_locations.id as location_id, "
-            "track_locations.location "
-            "FROM library INNER JOIN track_locations ON library.location=track_locations.id "
-            "WHERE track_locations.location IN (%1) AND "
-            "filename=:filename AND "
-            "ABS(duration - :duration) < 1 AND "
-            "fs_deleted=0").arg(
-                    SqlStringFormatter::formatList(m_database, addedTracks)));
+    struct AddedTrackLocation {
+        TrackId trackId;
+        DbId locationId;
+        QString location;
+        double duration;
+    };
+    QHash<QString, QList<AddedTrackLocation>> addedTrackLocationsByFilename;
+    {
+        QSqlQuery newTrackQuery(m_database);
+        newTrackQuery.prepare(QString(
+                "SELECT library.id as track_id, track_locations.id as location_id, "
+                "track_locations.location, filename, duration "
+                "FROM library INNER JOIN track_locations ON library.location=track_locations.id "
+                "WHERE track_locations.location IN (%1) AND "
+                "fs_deleted=0").arg(
+                        SqlStringFormatter::formatList(m_database, addedTracks)));
+        if (!newTrackQuery.exec()) {
+            LOG_FAILED_QUERY(newTrackQuery);
+            DEBUG_ASSERT(!"Failed query");
+            return false;
+        }
+        const QSqlRecord newTrackQueryRecord = newTrackQuery.record();
+        const int newTrackIdColumn = newTrackQueryRecord.indexOf("track_id");
+        const int newLocationIdColumn = newTrackQueryRecord.indexOf("location_id");
+        const int newLocationColumn = newTrackQueryRecord.indexOf("location");
+        const int newFilenameColumn = newTrackQueryRecord.indexOf("filename");
+        const int newDurationColumn = newTrackQueryRecord.indexOf("duration");
+        while (newTrackQuery.next()) {
+            addedTrackLocationsByFilename[newTrackQuery.value(newFilenameColumn).toString()]
+                    .append(AddedTrackLocation{
+                            TrackId(newTrackQuery.value(newTrackIdColumn)),
+                            DbId(newTrackQuery.value(newLocationIdColumn)),
+                            newTrackQuery.value(newLocationColumn).toString(),
+                            newTrackQuery.value(newDurationColumn).toDouble()});
+        }
+    }
+    if (addedTrackLocationsByFilename.isEmpty()) {
+        return true;
+    }
 
     // Query tracks, where we need a successor for
     QSqlQuery oldTrackQuery(m_database);
@@ -1900,45 +2084,47 @@ bool TrackDAO::detectMovedTracks(
                 << "Looking for substitute of missing track location"
                 << oldTrackLocation;
 
-        newTrackQuery.bindValue(":filename", filename);
-        newTrackQuery.bindValue(":duration", duration);
-        if (!newTrackQuery.exec()) {
-            LOG_FAILED_QUERY(newTrackQuery);
-            DEBUG_ASSERT(!"Failed query");
+        const auto addedTrackLocationsIter = addedTrackLocationsByFilename.find(filename);
+        if (addedTrackLocationsIter == addedTrackLocationsByFilename.end()) {
+            kLogger.info()
+                    << "Found no substitute for missing track location"
+                    << oldTrackLocation;
             continue;
         }
-        const auto newTrackIdColumn = newTrackQuery.record().indexOf("track_id");
-        const auto newTrackLocationIdColumn = newTrackQuery.record().indexOf("location_id");
-        const auto newTrackLocationColumn = newTrackQuery.record().indexOf("location");
+        QList<AddedTrackLocation>& addedTrackLocations = addedTrackLocationsIter.value();
         int newTrackLocationSuffixMatch = 0;
-        TrackId newTrackId;
-        DbId newTrackLocationId;
-        QString newTrackLocation;
-        while (newTrackQuery.next()) {
-            const auto nextTrackLocation =
-                    newTrackQuery.value(newTrackLocationColumn).toString();
-            VERIFY_OR_DEBUG_ASSERT(nextTrackLocation != oldTrackLocation) {
+        int newTrackLocationIndex = -1;
+        for (int i = 0; i < addedTrackLocations.size(); ++i) {
+            const AddedTrackLocation& nextTrackLocation = addedTrackLocations.at(i);
+            if (std::abs(nextTrackLocation.duration - duration) >= 1) {
+                continue;
+            }
+            VERIFY_OR_DEBUG_ASSERT(nextTrackLocation.location != oldTrackLocation) {
                 continue;
             }
             kLogger.info()
                     << "Found potential moved track location:"
-                    << nextTrackLocation;
+                    << nextTrackLocation.location;
             const auto nextSuffixMatch =
-                    matchStringSuffix(nextTrackLocation, oldTrackLocation);
+                    matchStringSuffix(nextTrackLocation.location, oldTrackLocation);
             DEBUG_ASSERT(nextSuffixMatch >= filename.length());
             if (newTrackLocationSuffixMatch < nextSuffixMatch) {
                 newTrackLocationSuffixMatch = nextSuffixMatch;
-                newTrackId = TrackId(newTrackQuery.value(newTrackIdColumn));
-                newTrackLocationId = DbId(newTrackQuery.value(newTrackLocationIdColumn));
-                newTrackLocation = nextTrackLocation;
+                newTrackLocationIndex = i;
             }
         }
-        if (newTrackLocation.isEmpty()) {
+        if (newTrackLocationIndex < 0) {
             kLogger.info()
                     << "Found no substitute for missing track location"
                     << oldTrackLocation;
             continue;
         }
+        // Each added track can only be the successor of a single missing track
+        const AddedTrackLocation newTrackLocationInfo =
+                addedTrackLocations.takeAt(newTrackLocationIndex);
+        TrackId newTrackId = newTrackLocationInfo.trackId;
+        const DbId newTrackLocationId = newTrackLocationInfo.locationId;
+        const QString newTrackLocation = newTrackLocationInfo.location;
         DEBUG_ASSERT(newTrackId.isValid());
         DEBUG_ASSERT(newTrackLocationId.isValid());
         kLogger.info()
@@ -2192,7 +2378,7 @@ void TrackDAO::detectCoverArtForTracksWithoutCover(volatile const bool* pCancel,
             "coverart_hash=:coverart_hash "
             "WHERE id=:track_id");
 
-    CoverInfoGuesser coverInfoGuesser;
+    CoverInfoGuesser coverInfoGuesser(CoverArtCache::thumbnailCache());
     for (const auto& track: tracksWithoutCover) {
         if (*pCancel) {
             return;
@@ -2288,6 +2474,87 @@ TrackPointer TrackDAO::getOrAddTrack(
     return pAddedTrack;
 }
 
+bool TrackDAO::updateFullTextIndex(const QSet<TrackId>& trackIds) const {
+    if (trackIds.isEmpty()) {
+        return true;
+    }
+    return writeFullTextIndex(joinTrackIdList(trackIds));
+}
+
+bool TrackDAO::rebuildFullTextIndex() const {
+    kLogger.info() << "Rebuilding the full-text search index";
+    PerformanceTimer timer;
+    timer.start();
+    SqlTransaction transaction(m_database);
+    if (!writeFullTextIndex(QString())) {
+        transaction.rollback();
+        return false;
+    }
+    transaction.commit();
+    kLogger.info() << "Rebuilding the full-text search index took"
+                   << timer.elapsed().debugMillisWithUnit();
+    return true;
+}
+
+bool TrackDAO::writeFullTextIndex(const QString& trackIdList) const {
+    {
+        QString queryString = QStringLiteral("DELETE FROM " LIBRARYFTS_TABLE);
+        if (!trackIdList.isEmpty()) {
+            queryString += QStringLiteral(" WHERE rowid IN (%1)").arg(trackIdList);
+        }
+        FwdSqlQuery query(m_database, queryString);
+        if (query.hasError() || !query.execPrepared()) {
+            return false;
+        }
+    }
+
+    const QStringList& columns = mixxx::trackschema::fullTextColumns();
+    QStringList qualifiedColumns;
+    QStringList placeholders;
+    for (const auto& column : columns) {
+        qualifiedColumns.append(
+                mixxx::trackschema::tableForColumn(column) + QChar('.') + column);
+        placeholders.append(QStringLiteral("?"));
+    }
+    QString selectString = QStringLiteral(
+            "SELECT library.id,%1 FROM library "
+            "INNER JOIN track_locations ON library.location=track_locations.id")
+                                   .arg(qualifiedColumns.join(QChar(',')));
+    if (!trackIdList.isEmpty()) {
+        selectString += QStringLiteral(" WHERE library.id IN (%1)").arg(trackIdList);
+    }
+    QSqlQuery selectQuery(m_database);
+    selectQuery.setForwardOnly(true);
+    if (!selectQuery.prepare(selectString) || !selectQuery.exec()) {
+        LOG_FAILED_QUERY(selectQuery);
+        return false;
+    }
+
+    QSqlQuery insertQuery(m_database);
+    if (!insertQuery.prepare(QStringLiteral(
+                "INSERT INTO " LIBRARYFTS_TABLE " (rowid,%1) VALUES (?,%2)")
+                            .arg(columns.join(QChar(',')),
+                                    placeholders.join(QChar(','))))) {
+        LOG_FAILED_QUERY(insertQuery);
+        return false;
+    }
+    while (selectQuery.next()) {
+        insertQuery.bindValue(0, selectQuery.value(0));
+        for (int i = 1; i <= columns.size(); ++i) {
+            // Folded like the values and arguments of LIKE to find the
+            // same substrings
+            QString value = selectQuery.value(i).toString();
+            mixxx::DbConnection::makeStringLatinLow(&value);
+            insertQuery.bindValue(i, value);
+        }
+        if (!insertQuery.exec()) {
+            LOG_FAILED_QUERY(insertQuery);
+            return false;
+        }
+    }
+    return true;
+}
+
 mixxx::FileAccess TrackDAO::relocateCachedTrack(TrackId trackId) {
     QString trackLocation = getTrackLocation(trackId);
     if (trackLocation.isEmpty()) {
@@ -9,6 +9,7 @@
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 
@@ -17,6 +18,9 @@ class PlaylistDAO;
 class AnalysisDao;
 class CueDAO;
 class LibraryHashDAO;
+class TrackMetadataExportQueue;
+class TrackWriteBehindQueue;
+struct TrackSnapshot;
 
 namespace mixxx {
 class FileInfo;
@@ -45,8 +49,15 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             UserSettingsPointer pConfig);
     ~TrackDAO() override;
 
+    void initialize(const QSqlDatabase& database) override;
     void finish();
 
+    /// The full-text search index of the text columns is available and
+    /// in sync with the library.
+    bool hasFullTextIndex() const {
+        return m_bFullTextIndex;
+    }
+
     QList<TrackId> resolveTrackIds(
             const QList<QUrl>& urls,
             ResolveTrackIdFlags flags = ResolveTrackIdFlag::ResolveOnly);
@@ -62,6 +73,9 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     // Returns a set of all track locations in the library.
     QSet<QString> getAllTrackLocations() const;
+    // Returns the ids of all tracks that are visible in the library and
+    // whose files have not been deleted from the file system.
+    QList<TrackId> getAllTrackIds() const;
     QString getTrackLocation(TrackId trackId) const;
 
     // Only used by friend class LibraryScanner, but public for testing!
@@ -72,6 +86,19 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
+    /// Writes the track asynchronously if a write-behind queue is set.
+    ///
+    /// Only used by friend class TrackCollection, but public for testing!
+    bool saveEvictedTrack(Track* pTrack) const;
+
+    /// Evicted tracks are written by the queue until it is reset.
+    void setWriteBehindQueue(TrackWriteBehindQueue* pWriteBehindQueue);
+
+    /// Loading tracks waits until the queue has exported the metadata
+    /// of evicted tracks.
+    void setMetadataExportQueue(TrackMetadataExportQueue* pMetadataExportQueue) {
+        m_pMetadataExportQueue = pMetadataExportQueue;
+    }
 
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
@@ -129,6 +156,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     friend class LibraryScanner;
     friend class TrackCollection;
     friend class TrackAnalysisScheduler;
+    friend class TrackWriteBehindQueue;
 
     QList<TrackId> resolveTrackIds(
             const QStringList& pathList,
@@ -152,12 +180,20 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// The metadata of new tracks is parsed from the file unless it
+    /// has already been imported by the caller.
     TrackPointer addTracksAddFile(
             const QString& filePath,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::ImportedTrackMetadata* pImportedMetadata = nullptr);
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
+    /// Updates all tracks in a single transaction. Tracks that no
+    /// longer exist are skipped.
+    bool updateTracks(
+            const QList<TrackSnapshot>& snapshots,
+            QSet<TrackId>* pUpdatedTrackIds) const;
 
     void hideAllTracks(const QDir& rootDir) const;
 
@@ -180,6 +216,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void markTrackLocationsAsVerified(const QStringList& locations) const;
     void markTracksInDirectoriesAsVerified(const QStringList& directories) const;
     void invalidateTrackLocationsInLibrary() const;
+    void invalidateTrackLocationsInDirectories(const QStringList& directories) const;
     void markUnverifiedTracksAsDeleted();
 
     bool verifyRemainingTracks(
@@ -192,6 +229,13 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Callback for GlobalTrackCache
     mixxx::FileAccess relocateCachedTrack(TrackId trackId) override;
 
+    // Copies the text columns of the given tracks into the full-text search
+    // index and removes the tracks that have been deleted from the library.
+    bool updateFullTextIndex(const QSet<TrackId>& trackIds) const;
+    bool rebuildFullTextIndex() const;
+    // An empty list of ids writes all tracks
+    bool writeFullTextIndex(const QString& trackIdList) const;
+
     CueDAO& m_cueDao;
     PlaylistDAO& m_playlistDao;
     AnalysisDao& m_analysisDao;
@@ -208,6 +252,10 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     int m_trackLocationIdColumn;
     int m_queryLibraryIdColumn;
     int m_queryLibraryMixxxDeletedColumn;
+    bool m_bFullTextIndex;
+
+    TrackWriteBehindQueue* m_pWriteBehindQueue;
+    TrackMetadataExportQueue* m_pMetadataExportQueue;
 
     QSet<TrackId> m_tracksAddedSet;
 
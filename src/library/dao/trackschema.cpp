@@ -9,5 +9,19 @@ QString tableForColumn(const QString& columnName) {
     // This doesn't detect unknown columns, but that's not really important here.
     return QStringLiteral(LIBRARY_TABLE);
 }
+
+const QStringList& fullTextColumns() {
+    static const QStringList columns = {
+            LIBRARYTABLE_ARTIST,
+            LIBRARYTABLE_ALBUMARTIST,
+            LIBRARYTABLE_ALBUM,
+            LIBRARYTABLE_TITLE,
+            LIBRARYTABLE_GENRE,
+            LIBRARYTABLE_COMPOSER,
+            LIBRARYTABLE_GROUPING,
+            LIBRARYTABLE_COMMENT,
+            TRACKLOCATIONSTABLE_LOCATION};
+    return columns;
+}
 } // namespace trackschema
 } // namespace mixxx
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
 
 #define LIBRARY_TABLE "library"
 #define TRACKLOCATIONS_TABLE "track_locations"
+#define LIBRARYFTS_TABLE "library_fts"
 
 #define PLAYLIST_TABLE "Playlists"
 #define PLAYLIST_TRACKS_TABLE "PlaylistTracks"
@@ -79,5 +81,9 @@ namespace mixxx {
 namespace trackschema {
 // TableForColumn returns the name of the table that contains the named column.
 QString tableForColumn(const QString& columnName);
+// The text columns of the library and track_locations tables that are
+// indexed by the full-text search table LIBRARYFTS_TABLE. Its columns
+// have the same names.
+const QStringList& fullTextColumns();
 } // namespace trackschema
 } // namespace mixxx
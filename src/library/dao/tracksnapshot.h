@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include "track/track.h"
+
+/// The state of a track that is stored in the library database.
+///
+/// Evicted tracks are deleted right after they have been saved. A
+/// snapshot allows to write them into the database afterwards.
+struct TrackSnapshot {
+    TrackSnapshot() = default;
+    explicit TrackSnapshot(const Track& track)
+            : trackId(track.getId()),
+              location(track.getLocation()),
+              trackRecord(track.getRecord()),
+              pBeats(track.getBeats()),
+              pWaveform(track.getWaveform()),
+              pWaveformSummary(track.getWaveformSummary()),
+              cuePoints(track.getCuePoints()) {
+    }
+
+    TrackId trackId;
+    QString location;
+    mixxx::TrackRecord trackRecord;
+    mixxx::BeatsPointer pBeats;
+    ConstWaveformPointer pWaveform;
+    ConstWaveformPointer pWaveformSummary;
+    QList<CuePointer> cuePoints;
+};
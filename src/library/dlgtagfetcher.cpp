@@ -56,6 +56,9 @@ constexpr int kPercentForCoverArtImageTask = 70;
 // Original Index of the track tag, listed all the time below 'Original Tags'.
 constexpr int kOriginalTrackIndex = -1;
 
+// The number of following tracks that are fingerprinted in advance
+constexpr int kPrefetchTrackCount = 2;
+
 QStringList trackColumnValues(
         const Track& track) {
     const mixxx::TrackMetadata trackMetadata = track.getMetadata();
@@ -290,6 +293,16 @@ void DlgTagFetcher::loadTrack(const QModelIndex& index) {
     m_currentTrackIndex = index;
     TrackPointer pTrack = m_pTrackModel->getTrack(index);
     loadTrack(pTrack);
+
+    // Tracks are usually tagged one after another, so the following
+    // tracks are fingerprinted while this one is looked up
+    for (int i = 1; i <= kPrefetchTrackCount; ++i) {
+        const QModelIndex nextIndex = index.sibling(index.row() + i, index.column());
+        if (!nextIndex.isValid()) {
+            break;
+        }
+        m_tagFetcher.prefetchFingerprint(m_pTrackModel->getTrack(nextIndex));
+    }
 }
 
 void DlgTagFetcher::slotTrackChanged(TrackId trackId) {
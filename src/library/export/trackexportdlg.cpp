@@ -1,6 +1,7 @@
 #include "library/export/trackexportdlg.h"
 
 #include <QCheckBox>
+#include <QLocale>
 #include <QMessageBox>
 
 #include "moc_trackexportdlg.cpp"
@@ -12,7 +13,8 @@ TrackExportDlg::TrackExportDlg(QWidget *parent,
         : QDialog(parent),
           Ui::DlgTrackExport(),
           m_pConfig(pConfig),
-          m_worker(worker) {
+          m_worker(worker),
+          m_bytesPerSecond(0) {
     setupUi(this);
     connect(cancelButton,
             &QPushButton::clicked,
@@ -28,6 +30,10 @@ TrackExportDlg::TrackExportDlg(QWidget *parent,
             &TrackExportWorker::progress,
             this,
             &TrackExportDlg::slotProgress);
+    connect(m_worker,
+            &TrackExportWorker::throughput,
+            this,
+            &TrackExportDlg::slotThroughput);
     connect(m_worker,
             &TrackExportWorker::askOverwriteMode,
             this,
@@ -54,6 +60,11 @@ void TrackExportDlg::slotProgress(const QString& filename, int progress, int cou
     if (progress == count) {
         statusLabel->setText(tr("Export finished"));
         finish();
+    } else if (m_bytesPerSecond > 0) {
+        statusLabel->setText(tr("Exporting %1 (%2/s)")
+                                     .arg(filename,
+                                             QLocale().formattedDataSize(
+                                                     m_bytesPerSecond)));
     } else {
         statusLabel->setText(tr("Exporting %1").arg(filename));
     }
@@ -62,6 +73,11 @@ void TrackExportDlg::slotProgress(const QString& filename, int progress, int cou
     exportProgress->setValue(progress);
 }
 
+void TrackExportDlg::slotThroughput(qint64 bytesPerSecond) {
+    // Displayed with the next progress update
+    m_bytesPerSecond = bytesPerSecond;
+}
+
 void TrackExportDlg::slotAskOverwriteMode(
         const QString& filename,
         std::promise<TrackExportWorker::OverwriteAnswer>* promise) {
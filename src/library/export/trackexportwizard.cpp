@@ -31,7 +31,11 @@ bool TrackExportWizard::selectDestinationDirectory() {
     m_pConfig->set(ConfigKey("[Library]", "LastTrackCopyDirectory"),
                    ConfigValue(destDir));
 
-    m_worker.reset(new TrackExportWorker(destDir, m_tracks));
+    m_worker.reset(new TrackExportWorker(destDir,
+            m_tracks,
+            m_pConfig->getValue(
+                    ConfigKey("[Library]", "TrackCopyConcurrentFiles"),
+                    TrackExportWorker::kDefaultConcurrentCopies)));
     m_dialog.reset(new TrackExportDlg(m_parent, m_pConfig, m_worker.data()));
     return true;
 }
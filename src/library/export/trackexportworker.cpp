@@ -1,7 +1,12 @@
 #include "library/export/trackexportworker.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <deque>
 
 #include "moc_trackexportworker.cpp"
 #include "track/track.h"
@@ -71,28 +76,111 @@ QMap<QString, mixxx::FileInfo> createCopylist(const TrackPointerList& tracks) {
     return copylist;
 }
 
+struct PendingCopy {
+    QString fileName;
+    qint64 bytes;
+    // The error message if the copy has failed
+    QFuture<QString> future;
+};
+
+// Invoked concurrently. On failure returns the error message and stops the
+// export, the copies that have not been started yet are skipped.
+QString copyFile(const QString& source_path,
+        const QString& dest_path,
+        QAtomicInt& bStop) {
+    if (bStop.loadAcquire()) {
+        return QString();
+    }
+    kLogger.debug() << "copying" << source_path << "to" << dest_path;
+    // Clones the file on file systems that support it
+    QFile source_file(source_path);
+    if (!source_file.copy(dest_path)) {
+        const QString error_message = TrackExportWorker::tr(
+                "Error exporting track %1 to %2: %3. Stopping.")
+                                              .arg(source_path,
+                                                      dest_path,
+                                                      source_file.errorString());
+        kLogger.warning() << error_message;
+        bStop = true;
+        return error_message;
+    }
+    return QString();
+}
+
 }  // namespace
 
 void TrackExportWorker::run() {
+    const QMap<QString, mixxx::FileInfo> copy_list = createCopylist(m_tracks);
+    const int count = copy_list.size();
+    // The copies run concurrently while this thread asks about existing
+    // files and reports the progress, so that a question never has to wait
+    // for the pending copies.
+    QThreadPool copyThreadPool;
+    copyThreadPool.setMaxThreadCount(m_maxConcurrentCopies);
+    copyThreadPool.setObjectName(QStringLiteral("TrackExportWorker"));
+    std::deque<PendingCopy> pendingCopies;
+    QElapsedTimer timer;
+    timer.start();
+    qint64 copiedBytes = 0;
     int i = 0;
-    QMap<QString, mixxx::FileInfo> copy_list = createCopylist(m_tracks);
-    for (auto it = copy_list.constBegin(); it != copy_list.constEnd(); ++it) {
-        // We emit progress twice per loop, which may seem excessive, but it
-        // guarantees that we emit a sane progress before we start and after
-        // we end.  In between, each filename will get its own visible tick
-        // on the bar, which looks really nice.
-        emit progress(it->fileName(), i, copy_list.size());
-        copyFile(*it, it.key());
+
+    // Blocks until the copy has finished
+    const auto finishCopy = [&](const PendingCopy& copy) {
+        const QString error_message = copy.future.result();
+        if (!error_message.isEmpty() && m_errorMessage.isEmpty()) {
+            m_errorMessage = error_message;
+        }
         if (m_bStop.loadAcquire()) {
-            emit canceled();
             return;
         }
+        copiedBytes += copy.bytes;
+        const qint64 elapsedMillis = timer.elapsed();
+        if (elapsedMillis > 0) {
+            emit throughput(copiedBytes * 1000 / elapsedMillis);
+        }
         ++i;
-        emit progress(it->fileName(), i, copy_list.size());
+        emit progress(copy.fileName, i, count);
+    };
+
+    for (auto it = copy_list.constBegin(); it != copy_list.constEnd(); ++it) {
+        if (m_bStop.loadAcquire()) {
+            break;
+        }
+        // We emit progress before and after each file, which guarantees that
+        // we emit a sane progress before we start and after we end.  In
+        // between, each filename will get its own visible tick on the bar,
+        // which looks really nice.
+        emit progress(it->fileName(), i, count);
+        const QString dest_path = prepareDestination(*it, it.key());
+        if (m_bStop.loadAcquire()) {
+            break;
+        }
+        if (dest_path.isEmpty()) {
+            ++i;
+            emit progress(it->fileName(), i, count);
+        } else {
+            const QString source_path = it->canonicalLocation();
+            pendingCopies.push_back(PendingCopy{it->fileName(),
+                    it->sizeInBytes(),
+                    QtConcurrent::run(&copyThreadPool,
+                            [this, source_path, dest_path] {
+                                return copyFile(source_path, dest_path, m_bStop);
+                            })});
+        }
+        while (!pendingCopies.empty() && pendingCopies.front().future.isFinished()) {
+            finishCopy(pendingCopies.front());
+            pendingCopies.pop_front();
+        }
+    }
+    for (const auto& copy : pendingCopies) {
+        finishCopy(copy);
+    }
+    if (m_bStop.loadAcquire()) {
+        emit canceled();
     }
 }
 
-void TrackExportWorker::copyFile(
+QString TrackExportWorker::prepareDestination(
         const mixxx::FileInfo& source_fileinfo,
         const QString& dest_filename) {
     QString sourceFilename = source_fileinfo.canonicalLocation();
@@ -107,19 +195,19 @@ void TrackExportWorker::copyFile(
             case OverwriteAnswer::SKIP:
             case OverwriteAnswer::SKIP_ALL:
                 kLogger.debug() << "skipping" << sourceFilename;
-                return;
+                return QString();
             case OverwriteAnswer::OVERWRITE:
             case OverwriteAnswer::OVERWRITE_ALL:
                 break;
             case OverwriteAnswer::CANCEL:
                 m_errorMessage = tr("Export process was canceled");
                 stop();
-                return;
+                return QString();
             }
             break;
         case OverwriteMode::SKIP_ALL:
             kLogger.debug() << "skipping" << sourceFilename;
-            return;
+            return QString();
         case OverwriteMode::OVERWRITE_ALL:;
         }
 
@@ -133,21 +221,10 @@ void TrackExportWorker::copyFile(
             kLogger.warning() << error_message;
             m_errorMessage = error_message;
             stop();
-            return;
+            return QString();
         }
     }
-
-    kLogger.debug() << "copying" << sourceFilename << "to" << dest_path;
-    QFile source_file(sourceFilename);
-    if (!source_file.copy(dest_path)) {
-        const QString error_message = tr(
-                "Error exporting track %1 to %2: %3. Stopping.").arg(
-                sourceFilename, dest_path, source_file.errorString());
-        kLogger.warning() << error_message;
-        m_errorMessage = error_message;
-        stop();
-        return;
-    }
+    return dest_path;
 }
 
 TrackExportWorker::OverwriteAnswer TrackExportWorker::makeOverwriteRequest(
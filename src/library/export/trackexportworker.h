@@ -11,12 +11,16 @@ class FileInfo;
 } // namespace mixxx
 
 // A QThread class for copying a list of files to a single destination directory.
-// Currently does not preserve subdirectory relationships.  This class performs
-// all copies in a blocking style within its own thread.  May be canceled from
-// another thread.
+// Currently does not preserve subdirectory relationships.  This class asks
+// about existing files within its own thread and performs the copies on a
+// small number of threads concurrently.  May be canceled from another thread.
 class TrackExportWorker : public QThread {
     Q_OBJECT
   public:
+    // Flash drives and spinning disks get slower with more concurrent
+    // writes, but a second stream hides the latency of opening each file.
+    static constexpr int kDefaultConcurrentCopies = 2;
+
     enum class OverwriteMode {
         ASK,
         OVERWRITE_ALL,
@@ -35,8 +39,12 @@ class TrackExportWorker : public QThread {
 
     // Constructor does not validate the destination directory.  Calling classes
     // should do that.
-    TrackExportWorker(const QString& destDir, const TrackPointerList& tracks)
-            : m_destDir(destDir), m_tracks(tracks) {
+    TrackExportWorker(const QString& destDir,
+            const TrackPointerList& tracks,
+            int maxConcurrentCopies = kDefaultConcurrentCopies)
+            : m_destDir(destDir),
+              m_tracks(tracks),
+              m_maxConcurrentCopies(maxConcurrentCopies) {
     }
     virtual ~TrackExportWorker() { };
 
@@ -49,7 +57,7 @@ class TrackExportWorker : public QThread {
         return m_errorMessage;
     }
 
-    // Cancels the export after the current copy operation.
+    // Cancels the export after the current copy operations.
     // May be called from another thread.
     void stop();
 
@@ -63,15 +71,18 @@ class TrackExportWorker : public QThread {
             const QString& filename,
             std::promise<TrackExportWorker::OverwriteAnswer>* promise);
     void progress(const QString& filename, int progress, int count);
+    // The average number of bytes copied per second since the export started
+    void throughput(qint64 bytesPerSecond);
     void canceled();
 
   private:
-    // Copies the file at source_fileinfo to the destination directory with the
-    // name given by dest_filename (not a full path).  If the destination file
-    // exists, will emit an overwrite request signal to ask how to proceed.
+    // Prepares copying a file to the destination directory with the name
+    // given by dest_filename (not a full path) and returns the destination
+    // path, or an empty string if the file is skipped.  If the destination
+    // file exists, will emit an overwrite request signal to ask how to proceed.
     // On unrecoverable error, sets the error message and stops the export
     // process entirely.
-    void copyFile(const mixxx::FileInfo& source_fileinfo,
+    QString prepareDestination(const mixxx::FileInfo& source_fileinfo,
             const QString& dest_filename);
 
     // Emit a signal requesting overwrite mode, and block until we get an
@@ -84,4 +95,5 @@ class TrackExportWorker : public QThread {
     OverwriteMode m_overwriteMode = OverwriteMode::ASK;
     const QString m_destDir;
     const TrackPointerList m_tracks;
+    const int m_maxConcurrentCopies;
 };
@@ -107,16 +107,6 @@ ITunesFeature::ITunesFeature(Library* pLibrary, UserSettingsPointer pConfig)
     m_isActivated = false;
     m_title = tr("iTunes");
 
-    m_database =
-            QSqlDatabase::cloneDatabase(m_pLibrary->trackCollectionManager()
-                                                ->internalCollection()
-                                                ->database(),
-                    "ITUNES_SCANNER");
-
-    // Open the database connection in this thread.
-    if (!m_database.open()) {
-        qDebug() << "Failed to open database for iTunes scanner." << m_database.lastError();
-    }
     connect(&m_future_watcher,
             &QFutureWatcher<TreeItem*>::finished,
             this,
@@ -126,9 +116,9 @@ ITunesFeature::ITunesFeature(Library* pLibrary, UserSettingsPointer pConfig)
 }
 
 ITunesFeature::~ITunesFeature() {
-    m_database.close();
     m_cancelImport = true;
     m_future.waitForFinished();
+    m_database.close();
     delete m_pITunesTrackModel;
     delete m_pITunesPlaylistModel;
 }
@@ -172,6 +162,7 @@ void ITunesFeature::activate() {
 void ITunesFeature::activate(bool forceReload) {
     //qDebug("ITunesFeature::activate()");
     if (!m_isActivated || forceReload) {
+        openWorkerDatabase(&m_database, QStringLiteral("ITUNES_SCANNER"));
 
         //Delete all table entries of iTunes feature
         ScopedTransaction transaction(m_database);
@@ -269,11 +260,11 @@ void ITunesFeature::onRightClick(const QPoint& globalPos) {
     menu.addAction(&chooseNew);
     QAction *chosen(menu.exec(globalPos));
     if (chosen == &useDefault) {
-        SettingsDAO settings(m_database);
+        SettingsDAO settings(m_pTrackCollection->database());
         settings.setValue(kItdbPathKey, QString());
         activate(true); // clears tables before parsing
     } else if (chosen == &chooseNew) {
-        SettingsDAO settings(m_database);
+        SettingsDAO settings(m_pTrackCollection->database());
         QString dbfile = showOpenDialog();
 
         mixxx::FileInfo dbFileInfo(dbfile);
@@ -303,6 +303,10 @@ void Library::stopPendingTasks() {
     m_pBrowseFeature->releaseBrowseThread();
 }
 
+void Library::saveStartupSnapshot() {
+    m_pMixxxLibraryFeature->saveStartupSnapshot();
+}
+
 void Library::bindSearchboxWidget(WSearchLineEdit* pSearchboxWidget) {
     connect(pSearchboxWidget,
             &WSearchLineEdit::search,
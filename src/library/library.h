@@ -55,6 +55,9 @@ class Library: public QObject {
     ~Library() override;
 
     void stopPendingTasks();
+    /// Saves the first rows of the track table for showing them immediately
+    /// at the next startup. Called on shutdown.
+    void saveStartupSnapshot();
 
     const mixxx::DbConnectionPoolPtr& dbConnectionPool() const {
         return m_pDbConnectionPool;
@@ -14,6 +14,8 @@ extern const QString kConfigGroup;
 
 extern const ConfigKey kRescanOnStartupConfigKey;
 
+extern const ConfigKey kWatchDirectoriesConfigKey;
+
 extern const ConfigKey kKeyNotationConfigKey;
 
 extern const ConfigKey kTrackDoubleClickActionConfigKey;
@@ -56,6 +58,26 @@ extern const ConfigKey kTagFetcherApplyTagsConfigKey;
 
 extern const ConfigKey kTagFetcherApplyCoverConfigKey;
 
+// Calculate the fingerprints for the tag fetcher while analyzing tracks
+extern const ConfigKey kTagFetcherAnalyzeFingerprintConfigKey;
+
+const bool kTagFetcherAnalyzeFingerprintDefault = true;
+
+// Use a write-ahead log for the database instead of a rollback journal
+extern const ConfigKey kDatabaseWriteAheadLogConfigKey;
+
+const bool kDatabaseWriteAheadLogDefault = false;
+
+// The size of the page cache of each database connection
+extern const ConfigKey kDatabaseCacheSizeKiBConfigKey;
+
+const int kDatabaseCacheSizeKiBDefault = 16384;
+
+// The size of the memory-mapped range of the database file, 0 = disabled
+extern const ConfigKey kDatabaseMmapSizeMiBConfigKey;
+
+const int kDatabaseMmapSizeMiBDefault = 0;
+
 } // namespace prefs
 
 } // namespace library
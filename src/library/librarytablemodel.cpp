@@ -11,6 +11,8 @@ LibraryTableModel::LibraryTableModel(QObject* parent,
         TrackCollectionManager* pTrackCollectionManager,
         const char* settingsNamespace)
         : BaseSqlTableModel(parent, pTrackCollectionManager, settingsNamespace) {
+    // Reading the whole library would block the GUI
+    setSelectAsync(true);
     setTableModel();
 }
 
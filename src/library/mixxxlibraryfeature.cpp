@@ -1,5 +1,7 @@
 #include "library/mixxxlibraryfeature.h"
 
+#include <QDir>
+#include <QFile>
 #include <QtDebug>
 #ifdef __ENGINEPRIME__
 #include <QMenu>
@@ -15,6 +17,7 @@
 #include "library/queryutil.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
+#include "library/tracktablesnapshot.h"
 #include "library/treeitem.h"
 #include "moc_mixxxlibraryfeature.cpp"
 #include "sources/soundsourceproxy.h"
@@ -23,6 +26,12 @@
 #include "widget/wlibrarysidebar.h"
 #endif
 
+namespace {
+
+// Enough for the first page of rows on large screens
+constexpr int kStartupSnapshotRows = 100;
+
+} // namespace
 
 MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
         UserSettingsPointer pConfig)
@@ -113,6 +122,9 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
     m_pLibraryTableModel = new LibraryTableModel(this,
             pLibrary->trackCollectionManager(),
             "mixxx.db.model.library");
+    // Shown until the index of the track source has been built
+    m_pLibraryTableModel->setStartupSnapshot(
+            TrackTableSnapshot::read(startupSnapshotFilePath()));
 
     std::unique_ptr<TreeItem> pRootItem = TreeItem::newRoot(this);
     pRootItem->appendChild(kMissingTitle);
@@ -168,6 +180,25 @@ void MixxxLibraryFeature::refreshLibraryModels() {
     }
 }
 
+QString MixxxLibraryFeature::startupSnapshotFilePath() const {
+    return QDir(m_pConfig->getSettingsPath())
+            .filePath(QStringLiteral("library_snapshot.cache"));
+}
+
+void MixxxLibraryFeature::saveStartupSnapshot() {
+    VERIFY_OR_DEBUG_ASSERT(m_pLibraryTableModel) {
+        return;
+    }
+    const TrackTableSnapshot snapshot =
+            m_pLibraryTableModel->takeSnapshot(kStartupSnapshotRows);
+    if (snapshot.isEmpty()) {
+        // A stale snapshot would be ignored anyway
+        QFile::remove(startupSnapshotFilePath());
+        return;
+    }
+    snapshot.write(startupSnapshotFilePath());
+}
+
 void MixxxLibraryFeature::searchAndActivate(const QString& query) {
     VERIFY_OR_DEBUG_ASSERT(m_pLibraryTableModel) {
         return;
@@ -47,6 +47,10 @@ class MixxxLibraryFeature final : public LibraryFeature {
 
     void searchAndActivate(const QString& query);
 
+    /// The rows of the track table are restored from the snapshot at the
+    /// next startup
+    void saveStartupSnapshot();
+
   public slots:
     void activate() override;
     void activateChild(const QModelIndex& index) override;
@@ -62,6 +66,8 @@ class MixxxLibraryFeature final : public LibraryFeature {
 #endif
 
   private:
+    QString startupSnapshotFilePath() const;
+
     const QString kMissingTitle;
     const QString kHiddenTitle;
     TrackCollection* const m_pTrackCollection;
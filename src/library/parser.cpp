@@ -1,13 +1,29 @@
 #include "library/parser.h"
 
 #include <QDir>
+#include <QThreadPool>
 #include <QUrl>
+#include <QtConcurrentMap>
 #include <QtDebug>
 
 #include "library/parsercsv.h"
 #include "library/parserm3u.h"
 #include "library/parserpls.h"
 
+namespace {
+
+// Checking the existence of the files may take a while on network storage
+// for each entry, so many entries are checked concurrently. This also
+// bounds the number of requests that are sent to the storage at once.
+constexpr int kMaxConcurrentFileChecks = 8;
+
+struct ResolvedLocation {
+    QString location;
+    bool exists;
+};
+
+} // anonymous namespace
+
 // static
 bool Parser::isPlaylistFilenameSupported(const QString& playlistFile) {
     return ParserM3u::isPlaylistFilenameSupported(playlistFile) ||
@@ -36,16 +52,29 @@ QList<QString> Parser::parseAllLocations(const QString& playlistFile) {
 QList<QString> Parser::parse(const QString& playlistFile) {
     const QList<QString> allLocations = parseAllLocations(playlistFile);
 
-    QFileInfo fileInfo(playlistFile);
+    const QString basePath = QFileInfo(playlistFile).canonicalPath();
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(kMaxConcurrentFileChecks);
+    threadPool.setObjectName(QStringLiteral("Parser"));
+    // The results are in the order of the entries
+    const QList<ResolvedLocation> resolvedLocations = QtConcurrent::blockingMapped(
+            &threadPool,
+            allLocations,
+            [&basePath](const QString& location) {
+                mixxx::FileInfo trackFile =
+                        Parser::playlistEntryToFileInfo(location, basePath);
+                const bool exists = trackFile.checkFileExists();
+                return ResolvedLocation{trackFile.location(), exists};
+            });
 
     QList<QString> existingLocations;
-    for (const auto& location : allLocations) {
-        mixxx::FileInfo trackFile = Parser::playlistEntryToFileInfo(
-                location, fileInfo.canonicalPath());
-        if (trackFile.checkFileExists()) {
-            existingLocations.append(trackFile.location());
+    existingLocations.reserve(resolvedLocations.size());
+    for (const auto& resolvedLocation : resolvedLocations) {
+        if (resolvedLocation.exists) {
+            existingLocations.append(resolvedLocation.location);
         } else {
-            qInfo() << "File" << trackFile.location() << "from playlist"
+            qInfo() << "File" << resolvedLocation.location << "from playlist"
                     << playlistFile << "does not exist.";
         }
     }
@@ -79,13 +79,16 @@ QList<QString> ParserM3u::parseAllLocations(const QString& playlistFile) {
         qWarning() << "M3U playlist file" << playlistFile << "does not start with" << kM3uHeader;
     }
 
-    const QStringList fileLines = fileContents.split(kUniveralEndOfLineRegEx);
-    for (const QString& line : fileLines) {
-        if (line.startsWith(kM3uCommentPrefix)) {
+    // Views into fileContents, only the locations are copied
+    const QList<QStringView> fileLines =
+            QStringView(fileContents).split(kUniveralEndOfLineRegEx);
+    paths.reserve(fileLines.size());
+    for (const QStringView line : fileLines) {
+        if (line.startsWith(QLatin1String(kM3uCommentPrefix))) {
             // Skip lines with comments
             continue;
         }
-        paths.append(line);
+        paths.append(line.toString());
     }
     return paths;
 }
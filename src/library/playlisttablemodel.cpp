@@ -1,5 +1,7 @@
 #include "library/playlisttablemodel.h"
 
+#include <limits>
+
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
@@ -298,6 +300,33 @@ void PlaylistTableModel::moveTrack(const QModelIndex& sourceIndex,
     }
 }
 
+void PlaylistTableModel::moveTracks(const QModelIndexList& sourceIndices,
+        const QModelIndex& destIndex) {
+    if (sourceIndices.isEmpty()) {
+        return;
+    }
+    const int playlistPositionColumn =
+            fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION);
+
+    QList<int> positions;
+    positions.reserve(sourceIndices.size());
+    for (const auto& index : sourceIndices) {
+        positions.append(index.sibling(index.row(), playlistPositionColumn).data().toInt());
+    }
+    int destPosition = destIndex.sibling(destIndex.row(), playlistPositionColumn).data().toInt();
+    if (destPosition <= 0) {
+        // Dragged out of bounds, which is past the end of the rows...
+        destPosition = std::numeric_limits<int>::max();
+    }
+
+    m_pTrackCollectionManager->internalCollection()->getPlaylistDAO().moveTracks(
+            m_iPlaylistId, positions, destPosition);
+
+    if (positions.contains(1) || destPosition == 1) {
+        emit firstTrackChanged();
+    }
+}
+
 bool PlaylistTableModel::isLocked() {
     return m_pTrackCollectionManager->internalCollection()->getPlaylistDAO().isPlaylistLocked(m_iPlaylistId);
 }
@@ -133,6 +133,17 @@ void ProxyTrackModel::moveTrack(const QModelIndex& sourceIndex,
     }
 }
 
+void ProxyTrackModel::moveTracks(const QModelIndexList& sourceIndices,
+        const QModelIndex& destIndex) {
+    QModelIndexList translatedList;
+    for (const auto& index : sourceIndices) {
+        translatedList.append(mapToSource(index));
+    }
+    if (m_pTrackModel) {
+        m_pTrackModel->moveTracks(translatedList, mapToSource(destIndex));
+    }
+}
+
 QAbstractItemDelegate* ProxyTrackModel::delegateForColumn(const int i, QObject* pParent) {
     return m_pTrackModel ? m_pTrackModel->delegateForColumn(i, pParent) : nullptr;
 }
@@ -104,6 +104,17 @@ bool createLibraryTable(QSqlDatabase& database, const QString& tableName) {
         return false;
     }
 
+    // The tracks and playlist entries are resolved by their Rekordbox id
+    // while parsing, i.e. once per entry
+    query.prepare(
+            "CREATE INDEX IF NOT EXISTS " + tableName + "_rb_id_device_idx ON " +
+            tableName + " (rb_id, device);");
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
     return true;
 }
 
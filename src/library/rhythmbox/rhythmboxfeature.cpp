@@ -67,17 +67,6 @@ RhythmboxFeature::RhythmboxFeature(Library* pLibrary, UserSettingsPointer pConfi
     m_isActivated =  false;
     m_title = tr("Rhythmbox");
 
-    m_database =
-            QSqlDatabase::cloneDatabase(pLibrary->trackCollectionManager()
-                                                ->internalCollection()
-                                                ->database(),
-                    "RHYTHMBOX_SCANNER");
-
-    //Open the database connection in this thread.
-    if (!m_database.open()) {
-        qDebug() << "Failed to open database for Rhythmbox scanner."
-                 << m_database.lastError();
-    }
     connect(&m_track_watcher,
             &QFutureWatcher<TreeItem*>::finished,
             this,
@@ -88,10 +77,10 @@ RhythmboxFeature::RhythmboxFeature(Library* pLibrary, UserSettingsPointer pConfi
 }
 
 RhythmboxFeature::~RhythmboxFeature() {
-    m_database.close();
     // stop import thread, if still running
     m_cancelImport = true;
     m_track_future.waitForFinished();
+    m_database.close();
     delete m_pRhythmboxTrackModel;
     delete m_pRhythmboxPlaylistModel;
 }
@@ -126,6 +115,7 @@ void RhythmboxFeature::activate() {
 
     if (!m_isActivated) {
         m_isActivated =  true;
+        openWorkerDatabase(&m_database, QStringLiteral("RHYTHMBOX_SCANNER"));
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
         m_track_future = QtConcurrent::run(&RhythmboxFeature::importMusicCollection, this);
 #else
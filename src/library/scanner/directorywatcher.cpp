@@ -0,0 +1,129 @@
+#include "library/scanner/directorywatcher.h"
+
+#include <utility>
+
+#include "moc_directorywatcher.cpp"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("DirectoryWatcher");
+
+// Copying files into the library usually causes many changes in short
+// succession that should be picked up by a single rescan.
+constexpr int kSettleTimeoutMillis = 5000;
+
+// Scanning this many directories individually is not noticeably faster
+// than a full scan, which also catches changes that might have been
+// missed by the file system notifications.
+constexpr int kMaxChangedDirectories = 5000;
+
+} // anonymous namespace
+
+DirectoryWatcher::DirectoryWatcher(QObject* parent)
+        : QObject(parent),
+          m_watcher(this),
+          m_settleTimer(this),
+          m_complete(false),
+          m_overflowed(false) {
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(kSettleTimeoutMillis);
+    connect(&m_settleTimer,
+            &QTimer::timeout,
+            this,
+            &DirectoryWatcher::directoriesChanged);
+    connect(&m_watcher,
+            &QFileSystemWatcher::directoryChanged,
+            this,
+            &DirectoryWatcher::slotDirectoryChanged);
+}
+
+bool DirectoryWatcher::watchDirectories(const QStringList& directories) {
+    QSet<QString> newDirectories;
+    newDirectories.reserve(directories.size());
+    for (const auto& directory : directories) {
+        newDirectories.insert(directory);
+    }
+
+    // Paths that are already watched would be reported as failed
+    QSet<QString> watchedDirectories;
+    QStringList removedDirectories;
+    const QStringList currentDirectories = m_watcher.directories();
+    for (const auto& directory : currentDirectories) {
+        if (newDirectories.contains(directory)) {
+            watchedDirectories.insert(directory);
+        } else {
+            removedDirectories.append(directory);
+        }
+    }
+    if (!removedDirectories.isEmpty()) {
+        m_watcher.removePaths(removedDirectories);
+    }
+
+    QStringList addedDirectories;
+    for (const auto& directory : std::as_const(newDirectories)) {
+        if (!watchedDirectories.contains(directory)) {
+            addedDirectories.append(directory);
+        }
+    }
+    if (addedDirectories.isEmpty()) {
+        return true;
+    }
+    const QStringList failedDirectories = m_watcher.addPaths(addedDirectories);
+    if (failedDirectories.isEmpty()) {
+        kLogger.debug()
+                << "Watching" << m_watcher.directories().size() << "directories";
+        return true;
+    }
+    kLogger.warning()
+            << "Failed to watch" << failedDirectories.size()
+            << "of" << newDirectories.size()
+            << "directories, falling back to full library scans";
+    reset();
+    return false;
+}
+
+void DirectoryWatcher::reset() {
+    const QStringList watchedDirectories = m_watcher.directories();
+    if (!watchedDirectories.isEmpty()) {
+        m_watcher.removePaths(watchedDirectories);
+    }
+    m_settleTimer.stop();
+    m_changedDirectories.clear();
+    m_complete = false;
+    m_overflowed = false;
+}
+
+void DirectoryWatcher::beginFullScan() {
+    m_changedDirectories.clear();
+    m_complete = true;
+    m_overflowed = false;
+}
+
+QStringList DirectoryWatcher::takeChangedDirectories() {
+    const QStringList changedDirectories = m_changedDirectories.values();
+    m_changedDirectories.clear();
+    return changedDirectories;
+}
+
+void DirectoryWatcher::notifyPendingChanges() {
+    if ((hasChangedDirectories() || m_overflowed) && !m_settleTimer.isActive()) {
+        m_settleTimer.start();
+    }
+}
+
+void DirectoryWatcher::slotDirectoryChanged(const QString& directory) {
+    if (m_complete) {
+        m_changedDirectories.insert(directory);
+        if (m_changedDirectories.size() > kMaxChangedDirectories) {
+            kLogger.info()
+                    << "Too many changed directories, the next library "
+                       "scan will be a full scan";
+            m_changedDirectories.clear();
+            m_complete = false;
+            m_overflowed = true;
+        }
+    }
+    // Restart the timer to wait until the changes have settled
+    m_settleTimer.start();
+}
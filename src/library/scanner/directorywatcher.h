@@ -0,0 +1,76 @@
+#pragma once
+
+#include <gtest/gtest_prod.h>
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+/// Records the library directories that are changed while Mixxx is
+/// running, so that a rescan only needs to scan these directories
+/// instead of walking the whole library.
+///
+/// Only changes of the directory entries are reported, i.e. files and
+/// subdirectories that are added, removed or renamed. This matches the
+/// hashes of the file names that are compared by the library scanner.
+///
+/// The recorded changes are complete once a full scan has been started.
+/// They become incomplete if the changes overflow or if the scan that
+/// should have picked them up has been cancelled.
+class DirectoryWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit DirectoryWatcher(QObject* parent = nullptr);
+    ~DirectoryWatcher() override = default;
+
+    /// Watches exactly the given directories from now on. The recorded
+    /// changes are preserved.
+    ///
+    /// Returns false if the operating system doesn't allow to watch all
+    /// directories, e.g. due to the limits of inotify. All directories
+    /// are unwatched then and rescans need to walk the whole library.
+    bool watchDirectories(const QStringList& directories);
+
+    /// Stops watching all directories and discards the recorded changes.
+    void reset();
+
+    /// A full scan considers all changes from now on.
+    void beginFullScan();
+
+    /// Whether scanning the changed directories is sufficient for
+    /// rescanning the library.
+    bool isComplete() const {
+        return m_complete;
+    }
+
+    bool hasChangedDirectories() const {
+        return !m_changedDirectories.isEmpty();
+    }
+
+    /// Returns and forgets the directories that have changed.
+    QStringList takeChangedDirectories();
+
+    /// Emits directoriesChanged() again after changes that have not
+    /// been picked up, e.g. while a scan was already in progress.
+    void notifyPendingChanges();
+
+  signals:
+    /// Emitted when no more changes have been reported for a while.
+    void directoriesChanged();
+
+  private slots:
+    void slotDirectoryChanged(const QString& directory);
+
+  private:
+    FRIEND_TEST(DirectoryWatcherTest, recordsChangedDirectories);
+    FRIEND_TEST(DirectoryWatcherTest, fallsBackToFullScanOnOverflow);
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_settleTimer;
+    QSet<QString> m_changedDirectories;
+    bool m_complete;
+    // A full scan is needed to pick up the changes
+    bool m_overflowed;
+};
@@ -1,8 +1,19 @@
 #include "library/scanner/importfilestask.h"
 
+#include "library/coverartcache.h"
+#include "library/coverartutils.h"
 #include "moc_importfilestask.cpp"
 #include "util/timer.h"
 
+namespace {
+
+// The new tracks are passed in batches to the LibraryScanner that
+// adds them to the database. Smaller batches provide more frequent
+// progress updates, larger batches need less signals.
+constexpr int kNewTracksBatchSize = 64;
+
+} // anonymous namespace
+
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
         const ScannerGlobalPointer scannerGlobal,
         const QString& dirPath,
@@ -22,6 +33,11 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(QStringLiteral("ImportFilesTask::run"));
+    // All files are in the same directory. The thumbnails of the covers
+    // are stored while the images are at hand, so displaying the new
+    // tracks in the library doesn't need to read their files again.
+    CoverInfoGuesser coverInfoGuesser(CoverArtCache::thumbnailCache());
+    QList<ImportedTrackFile> newTrackFiles;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -49,9 +65,26 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            // Parsing the tags is the expensive part of adding a track
+            // and is done concurrently by the tasks. Only the database
+            // is updated by the LibraryScanner.
+            ImportedTrackFile trackFile;
+            trackFile.location = trackLocation;
+            trackFile.importedMetadata =
+                    SoundSourceProxy::importTrackMetadataAndCoverInfoFromFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            m_scannerGlobal->syncTrackMetadataParams(),
+                            &coverInfoGuesser);
+            newTrackFiles.append(std::move(trackFile));
+            if (newTrackFiles.size() >= kNewTracksBatchSize) {
+                emit addNewTracks(newTrackFiles);
+                newTrackFiles.clear();
+            }
         }
     }
+    if (!newTrackFiles.isEmpty()) {
+        emit addNewTracks(newTrackFiles);
+    }
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
     setSuccess(true);
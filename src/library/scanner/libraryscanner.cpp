@@ -1,7 +1,9 @@
 #include "library/scanner/libraryscanner.h"
 
 #include "library/coverartutils.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
+#include "library/scanner/directorywatcher.h"
 #include "library/scanner/libraryscannerdlg.h"
 #include "library/scanner/recursivescandirectorytask.h"
 #include "library/scanner/scannertask.h"
@@ -19,9 +21,6 @@
 
 namespace {
 
-// TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
-
 mixxx::Logger kLogger("LibraryScanner");
 
 QAtomicInt s_instanceCounter(0);
@@ -73,12 +72,17 @@ void cleanUpDatabase(const QSqlDatabase& database) {
 
 /// Update statistics for the query planner
 /// See also: https://www.sqlite.org/lang_analyze.html
-void updateQueryPlannerStatisticsForDatabase(const QSqlDatabase& database) {
+void updateQueryPlannerStatisticsForDatabase(
+        const QSqlDatabase& database, bool incrementalScan) {
     kLogger.info()
             << "Updating query planner statistics for database...";
     PerformanceTimer timer;
     timer.start();
-    const auto sqlStmt = QStringLiteral("ANALYZE");
+    // After an incremental scan only the statistics of the tables that have
+    // changed significantly are updated
+    const auto sqlStmt = incrementalScan
+            ? QStringLiteral("PRAGMA optimize")
+            : QStringLiteral("ANALYZE");
     FwdSqlQuery query(database, sqlStmt);
     const auto numRows = execRowCountQuery(query);
     VERIFY_OR_DEBUG_ASSERT(numRows >= 0) {
@@ -92,18 +96,86 @@ void updateQueryPlannerStatisticsForDatabase(const QSqlDatabase& database) {
     }
 }
 
+// Returns -1 on error
+int queryPragmaValue(const QSqlDatabase& database, const QString& pragma) {
+    FwdSqlQuery query(database, QStringLiteral("PRAGMA ") + pragma);
+    if (!query.execPrepared() || !query.next()) {
+        return -1;
+    }
+    return query.fieldValue(0).toInt();
+}
+
+// Deleting tracks and their analysis leaves free pages in the database
+// file, which become fragmented over time. Databases that have been
+// created without auto-vacuum are converted once a quarter of the pages
+// are free, which requires a full VACUUM. Afterwards the free pages are
+// released incrementally.
+void reclaimFreePagesOfDatabase(const QSqlDatabase& database, bool incrementalScan) {
+    constexpr int kAutoVacuumIncremental = 2;
+    const int freePageCount = queryPragmaValue(database, QStringLiteral("freelist_count"));
+    if (freePageCount <= 0) {
+        return;
+    }
+    const int autoVacuum = queryPragmaValue(database, QStringLiteral("auto_vacuum"));
+    QString sqlStmt;
+    if (autoVacuum == kAutoVacuumIncremental) {
+        sqlStmt = QStringLiteral("PRAGMA incremental_vacuum");
+    } else {
+        const int pageCount = queryPragmaValue(database, QStringLiteral("page_count"));
+        // The full VACUUM rewrites the whole file and is only done after
+        // full scans
+        if (incrementalScan || freePageCount < pageCount / 4) {
+            return;
+        }
+        FwdSqlQuery query(database, QStringLiteral("PRAGMA auto_vacuum=INCREMENTAL"));
+        if (!query.execPrepared()) {
+            return;
+        }
+        sqlStmt = QStringLiteral("VACUUM");
+    }
+    kLogger.info()
+            << "Reclaiming"
+            << freePageCount
+            << "free pages of database...";
+    PerformanceTimer timer;
+    timer.start();
+    FwdSqlQuery query(database, sqlStmt);
+    if (!query.execPrepared()) {
+        kLogger.warning()
+                << "Failed to reclaim free pages of database";
+        return;
+    }
+    // The incremental vacuum is only done when stepping through its results
+    while (query.next()) {
+    }
+    kLogger.info()
+            << "Finished reclaiming free pages of database:"
+            << timer.elapsed().debugMillisWithUnit();
+}
+
+QStringList locations(const QList<mixxx::FileInfo>& fileInfos) {
+    QStringList locations;
+    locations.reserve(fileInfos.size());
+    for (const auto& fileInfo : fileInfos) {
+        locations.append(fileInfo.location());
+    }
+    return locations;
+}
+
 } // anonymous namespace
 
 LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
                   pConfig),
           m_stateSema(1), // only one transaction is possible at a time
-          m_state(IDLE) {
+          m_state(IDLE),
+          m_bIncrementalScan(false) {
     // Move LibraryScanner to its own thread so that our signals/slots will
     // queue to our event loop.
     moveToThread(this);
@@ -112,7 +184,13 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    // The tasks parse the metadata of new files which is CPU bound.
+    // Directories on network shares also benefit from multiple pending
+    // requests. Only the scanner thread writes into the database.
+    // TODO(rryan) make configurable
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
+
+    qRegisterMetaType<QList<ImportedTrackFile>>();
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -127,6 +205,10 @@ LibraryScanner::LibraryScanner(
             &LibraryScanner::progressHashing,
             m_pProgressDlg.data(),
             &LibraryScannerDlg::slotUpdate);
+    connect(this,
+            &LibraryScanner::progressStatistics,
+            m_pProgressDlg.data(),
+            &LibraryScannerDlg::slotUpdateStatistics);
     connect(this,
             &LibraryScanner::scanStarted,
             m_pProgressDlg.data(),
@@ -178,6 +260,9 @@ void LibraryScanner::run() {
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        // The watcher lives in this thread
+        m_pDirectoryWatcher.reset();
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -186,8 +271,6 @@ void LibraryScanner::slotStartScan() {
     kLogger.debug() << "slotStartScan()";
     DEBUG_ASSERT(m_state == STARTING);
 
-    cleanUpDatabase(m_libraryHashDao.database());
-
     // Recursively scan each directory in the directories table.
     m_libraryRootDirs = m_directoryDao.loadAllDirectories();
     // If there are no directories then we have nothing to do. Cleanup and
@@ -196,6 +279,27 @@ void LibraryScanner::slotStartScan() {
         changeScannerState(IDLE);
         return;
     }
+
+    updateDirectoryWatcher();
+    m_bIncrementalScan = canScanIncrementally();
+    QStringList changedDirectories;
+    if (m_bIncrementalScan) {
+        changedDirectories = m_pDirectoryWatcher->takeChangedDirectories();
+        if (changedDirectories.isEmpty()) {
+            kLogger.info() << "No directories have changed since the last scan";
+            changeScannerState(IDLE);
+            return;
+        }
+        kLogger.info()
+                << "Scanning" << changedDirectories.size()
+                << "changed directories";
+    } else {
+        cleanUpDatabase(m_libraryHashDao.database());
+        if (m_pDirectoryWatcher) {
+            m_pDirectoryWatcher->beginFullScan();
+            m_watchedRootDirLocations = locations(m_libraryRootDirs);
+        }
+    }
     changeScannerState(SCANNING);
 
     QSet<QString> trackLocations = m_trackDao.getAllTrackLocations();
@@ -207,23 +311,34 @@ void LibraryScanner::slotStartScan() {
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
 
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackLocations,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)));
 
     m_scannerGlobal->startTimer();
 
     emit scanStarted();
 
-    // First, we're going to mark all the directories that we've previously
-    // hashed as needing verification. As we search through the directory tree
-    // when we rescan, we'll mark any directory that does still exist as
-    // verified.
-    m_libraryHashDao.invalidateAllDirectories();
-
-    // Mark all the tracks in the library as needing verification of their
-    // existence. (ie. we want to check they're still on your hard drive where
-    // we think they are)
-    m_trackDao.invalidateTrackLocationsInLibrary();
+    if (m_bIncrementalScan) {
+        // All other directories and their tracks are unchanged and stay
+        // verified.
+        m_libraryHashDao.updateDirectoryStatuses(changedDirectories, false, false);
+        m_trackDao.invalidateTrackLocationsInDirectories(changedDirectories);
+    } else {
+        // First, we're going to mark all the directories that we've previously
+        // hashed as needing verification. As we search through the directory tree
+        // when we rescan, we'll mark any directory that does still exist as
+        // verified.
+        m_libraryHashDao.invalidateAllDirectories();
+
+        // Mark all the tracks in the library as needing verification of their
+        // existence. (ie. we want to check they're still on your hard drive where
+        // we think they are)
+        m_trackDao.invalidateTrackLocationsInLibrary();
+    }
 
     kLogger.debug() << "Recursively scanning library.";
 
@@ -245,19 +360,39 @@ void LibraryScanner::slotStartScan() {
             this,
             &LibraryScanner::slotFinishHashedScan);
 
-    for (const mixxx::FileInfo& rootDir : std::as_const(m_libraryRootDirs)) {
-        // Acquire a security bookmark for this directory if we are in a
-        // sandbox. For speed we avoid opening security bookmarks when recursive
-        // scanning so that relies on having an open bookmark for the containing
-        // directory.
-        if (!rootDir.exists() || !rootDir.isDir()) {
-            qWarning() << "Skipping to scan" << rootDir;
-            continue;
+    if (m_bIncrementalScan) {
+        for (const QString& dirLocation : std::as_const(changedDirectories)) {
+            // Directories that don't exist anymore are marked as deleted
+            // together with their tracks after the scan.
+            const mixxx::FileInfo dirInfo(dirLocation);
+            if (!dirInfo.isDir()) {
+                continue;
+            }
+            // New subdirectories are scanned in the second stage. All other
+            // subdirectories are either unchanged or have changed themselves.
+            if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
+                queueTask(new RecursiveScanDirectoryTask(this,
+                        m_scannerGlobal,
+                        mixxx::FileAccess(dirInfo),
+                        false,
+                        false));
+            }
         }
-        auto dirAccess = mixxx::FileAccess(rootDir);
-        if (!m_scannerGlobal->testAndMarkDirectoryScanned(rootDir.toQDir())) {
-            queueTask(new RecursiveScanDirectoryTask(
-                    this, m_scannerGlobal, std::move(dirAccess), false));
+    } else {
+        for (const mixxx::FileInfo& rootDir : std::as_const(m_libraryRootDirs)) {
+            // Acquire a security bookmark for this directory if we are in a
+            // sandbox. For speed we avoid opening security bookmarks when recursive
+            // scanning so that relies on having an open bookmark for the containing
+            // directory.
+            if (!rootDir.exists() || !rootDir.isDir()) {
+                qWarning() << "Skipping to scan" << rootDir;
+                continue;
+            }
+            auto dirAccess = mixxx::FileAccess(rootDir);
+            if (!m_scannerGlobal->testAndMarkDirectoryScanned(rootDir.toQDir())) {
+                queueTask(new RecursiveScanDirectoryTask(
+                        this, m_scannerGlobal, std::move(dirAccess), false));
+            }
         }
     }
     pWatcher->taskDone();
@@ -413,26 +548,43 @@ void LibraryScanner::slotFinishUnhashedScan() {
 
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         const auto dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
-        updateQueryPlannerStatisticsForDatabase(dbConnection);
+        updateQueryPlannerStatisticsForDatabase(dbConnection, m_bIncrementalScan);
+        reclaimFreePagesOfDatabase(dbConnection, m_bIncrementalScan);
     }
 
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         kLogger.debug() << "Scan finished cleanly";
+        if (m_pDirectoryWatcher) {
+            // Also watch the directories that have been found by the scan
+            m_pDirectoryWatcher->watchDirectories(
+                    m_libraryHashDao.getDirectoryHashes().keys());
+            m_pDirectoryWatcher->notifyPendingChanges();
+        }
     } else {
         kLogger.debug() << "Scan cancelled";
+        if (m_pDirectoryWatcher) {
+            // The directories that have not been scanned are unknown
+            m_pDirectoryWatcher->reset();
+        }
     }
 
     // TODO(XXX) doesn't take into account verifyRemainingTracks.
-    qDebug("Scan took: %s. "
+    const mixxx::Duration scanDuration = m_scannerGlobal->timerElapsed();
+    const int numAddedTracks = static_cast<int>(m_scannerGlobal->addedTracks().size());
+    qDebug("%s scan took: %s. "
            "%d unchanged directories. "
            "%d changed/added directories. "
            "%d tracks verified from changed/added directories. "
-           "%d new tracks.",
-            m_scannerGlobal->timerElapsed().formatNanosWithUnit().toLocal8Bit().constData(),
+           "%d new tracks (%.1f tracks/s).",
+            m_bIncrementalScan ? "Incremental" : "Full",
+            scanDuration.formatNanosWithUnit().toLocal8Bit().constData(),
             static_cast<int>(m_scannerGlobal->verifiedDirectories().size()),
             m_scannerGlobal->numScannedDirectories(),
             static_cast<int>(m_scannerGlobal->verifiedTracks().size()),
-            static_cast<int>(m_scannerGlobal->addedTracks().size()));
+            numAddedTracks,
+            scanDuration.toDoubleSeconds() > 0
+                    ? numAddedTracks / scanDuration.toDoubleSeconds()
+                    : 0.0);
 
     m_scannerGlobal.clear();
     changeScannerState(FINISHED);
@@ -511,9 +663,9 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::slotTrackExists);
     connect(pTask,
-            &ScannerTask::addNewTrack,
+            &ScannerTask::addNewTracks,
             this,
-            &LibraryScanner::slotAddNewTrack);
+            &LibraryScanner::slotAddNewTracks);
 
     // Progress signals.
     // Pass directly to the main thread
@@ -547,6 +699,7 @@ void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
         m_libraryHashDao.updateDirectoryHash(directoryPath, hash, 0);
     }
     emit progressHashing(directoryPath);
+    emitProgressStatistics();
 }
 
 void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
@@ -556,6 +709,7 @@ void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
         m_scannerGlobal->addVerifiedDirectory(directoryPath);
     }
     emit progressHashing(directoryPath);
+    emitProgressStatistics();
 }
 
 void LibraryScanner::slotTrackExists(const QString& trackPath) {
@@ -566,31 +720,76 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
     }
 }
 
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
-    //kLogger.debug() << "slotAddNewTrack" << trackPath;
-    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTrack"));
-    // For statistics tracking and to detect moved tracks
-    TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
-    if (!pTrack) {
-        // This happens only when there is an issue with the database which
-        // has been logged already. No need for yet another warning here.
+void LibraryScanner::slotAddNewTracks(const QList<ImportedTrackFile>& trackFiles) {
+    //kLogger.debug() << "slotAddNewTracks" << trackFiles.size();
+    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTracks"));
+    // All tracks are added within the transaction of the scan
+    for (const auto& trackFile : trackFiles) {
+        if (m_scannerGlobal && m_scannerGlobal->shouldCancel()) {
+            return;
+        }
+        // The metadata has already been parsed from the file by the task
+        TrackPointer pTrack = m_trackDao.addTracksAddFile(
+                trackFile.location,
+                false,
+                &trackFile.importedMetadata);
+        if (!pTrack) {
+            // This happens only when there is an issue with the database which
+            // has been logged already. No need for yet another warning here.
+            continue;
+        }
+
+        DEBUG_ASSERT(!pTrack->isDirty());
+        // The track's actual location might differ from the
+        // given location
+        const QString trackLocation = pTrack->getLocation();
+        // Acknowledge successful track addition
+        // for statistics tracking and to detect moved tracks
+        if (m_scannerGlobal) {
+            m_scannerGlobal->trackAdded(trackLocation);
+        }
+        // Signal the main instance of TrackDAO, that there is
+        // a new track in the database.
+        emit trackAdded(pTrack);
+        emit progressLoading(trackLocation);
+    }
+    emitProgressStatistics();
+}
+
+void LibraryScanner::emitProgressStatistics() {
+    if (!m_scannerGlobal) {
         return;
     }
+    emit progressStatistics(
+            m_scannerGlobal->numScannedDirectories() +
+                    static_cast<int>(m_scannerGlobal->verifiedDirectories().size()),
+            static_cast<int>(m_scannerGlobal->addedTracks().size()));
+}
 
-    DEBUG_ASSERT(!pTrack->isDirty());
-    // The track's actual location might differ from the
-    // given trackPath
-    const QString trackLocation = pTrack->getLocation();
-    // Acknowledge successful track addition
-    if (m_scannerGlobal) {
-        m_scannerGlobal->trackAdded(trackLocation);
+void LibraryScanner::updateDirectoryWatcher() {
+    const bool watchDirectories = m_pConfig->getValue<bool>(
+            mixxx::library::prefs::kWatchDirectoriesConfigKey, false);
+    if (!watchDirectories) {
+        m_pDirectoryWatcher.reset();
+        return;
+    }
+    if (m_pDirectoryWatcher) {
+        return;
     }
-    // Signal the main instance of TrackDAO, that there is
-    // a new track in the database.
-    emit trackAdded(pTrack);
-    emit progressLoading(trackLocation);
+    // The directories are watched after the next full scan
+    m_pDirectoryWatcher = std::make_unique<DirectoryWatcher>();
+    connect(m_pDirectoryWatcher.get(),
+            &DirectoryWatcher::directoriesChanged,
+            this,
+            &LibraryScanner::scan);
+}
+
+bool LibraryScanner::canScanIncrementally() const {
+    // Directories that have been added to the library after the last
+    // full scan are not watched yet
+    return m_pDirectoryWatcher &&
+            m_pDirectoryWatcher->isComplete() &&
+            m_watchedRootDirLocations == locations(m_libraryRootDirs);
 }
 
 bool LibraryScanner::changeScannerState(ScannerState newState) {
@@ -7,6 +7,7 @@
 #include <QSemaphore>
 #include <QThread>
 #include <QThreadPool>
+#include <memory>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -15,10 +16,11 @@
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
 #include "library/scanner/scannerglobal.h"
+#include "library/scanner/scannertask.h"
 #include "track/track_decl.h"
 #include "util/db/dbconnectionpool.h"
 
-class ScannerTask;
+class DirectoryWatcher;
 class LibraryScannerDlg;
 class QString;
 
@@ -45,6 +47,7 @@ class LibraryScanner : public QThread {
     void progressHashing(const QString&);
     void progressLoading(const QString& path);
     void progressCoverArt(const QString& file);
+    void progressStatistics(int scannedDirectories, int addedTracks);
     void trackAdded(TrackPointer pTrack);
     void tracksChanged(const QSet<TrackId>& changedTrackIds);
     void tracksRelocated(const QList<RelocatedTrack>& relocatedTracks);
@@ -69,7 +72,7 @@ class LibraryScanner : public QThread {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
     void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotAddNewTracks(const QList<ImportedTrackFile>& trackFiles);
 
   private:
     enum ScannerState {
@@ -95,7 +98,15 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    // Creates or destroys the watcher depending on the preferences
+    void updateDirectoryWatcher();
+    // Only the changed directories need to be scanned
+    bool canScanIncrementally() const;
+
+    void emitProgressStatistics();
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
@@ -119,5 +130,11 @@ class LibraryScanner : public QThread {
     volatile ScannerState m_state;
 
     QList<mixxx::FileInfo> m_libraryRootDirs;
+
+    // Only accessed from the LibraryScanner thread
+    std::unique_ptr<DirectoryWatcher> m_pDirectoryWatcher;
+    // The root directories of the last full scan
+    QStringList m_watchedRootDirLocations;
+    bool m_bIncrementalScan;
     QScopedPointer<LibraryScannerDlg> m_pProgressDlg;
 };
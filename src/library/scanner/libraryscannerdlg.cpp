@@ -33,6 +33,11 @@ LibraryScannerDlg::LibraryScannerDlg(QWidget* parent, Qt::WindowFlags f)
     pCurrent->setWordWrap(true);
     connect(this, &LibraryScannerDlg::progress, pCurrent, &QLabel::setText);
     pLayout->addWidget(pCurrent);
+
+    QLabel* pStatistics = new QLabel(this);
+    pStatistics->setAlignment(Qt::AlignTop);
+    connect(this, &LibraryScannerDlg::statistics, pStatistics, &QLabel::setText);
+    pLayout->addWidget(pStatistics);
     setLayout(pLayout);
 }
 
@@ -63,6 +68,18 @@ void LibraryScannerDlg::slotUpdateCover(const QString& path) {
     }
 }
 
+void LibraryScannerDlg::slotUpdateStatistics(int scannedDirectories, int addedTracks) {
+    if (!isVisible()) {
+        return;
+    }
+    const double elapsedSeconds = m_timer.elapsed().toDoubleSeconds();
+    const double tracksPerSecond = elapsedSeconds > 0 ? addedTracks / elapsedSeconds : 0;
+    emit statistics(tr("%1 directories scanned, %2 tracks added (%3 tracks/s)")
+                            .arg(QString::number(scannedDirectories),
+                                    QString::number(addedTracks),
+                                    QString::number(tracksPerSecond, 'f', 1)));
+}
+
 void LibraryScannerDlg::slotCancel() {
     qDebug() << "Cancelling library scan...";
     m_bCancelled = true;
@@ -73,6 +90,7 @@ void LibraryScannerDlg::slotCancel() {
 void LibraryScannerDlg::slotScanStarted() {
     m_bCancelled = false;
     m_timer.start();
+    emit statistics(QString());
 }
 
 void LibraryScannerDlg::slotScanFinished() {
@@ -15,6 +15,7 @@ class LibraryScannerDlg : public QWidget {
   public slots:
     void slotUpdate(const QString& path);
     void slotUpdateCover(const QString& path);
+    void slotUpdateStatistics(int scannedDirectories, int addedTracks);
     void slotCancel();
     void slotScanFinished();
     void slotScanStarted();
@@ -22,6 +23,7 @@ class LibraryScannerDlg : public QWidget {
   signals:
     void scanCancelled();
     void progress(const QString&);
+    void statistics(const QString&);
 
   private:
     PerformanceTimer m_timer;
@@ -13,10 +13,12 @@ RecursiveScanDirectoryTask::RecursiveScanDirectoryTask(
         LibraryScanner* pScanner,
         const ScannerGlobalPointer& scannerGlobal,
         const mixxx::FileAccess&& dirAccess,
-        bool scanUnhashed)
+        bool scanUnhashed,
+        bool scanHashedSubdirs)
         : ScannerTask(pScanner, scannerGlobal),
           m_dirAccess(std::move(dirAccess)),
-          m_scanUnhashed(scanUnhashed) {
+          m_scanUnhashed(scanUnhashed),
+          m_scanHashedSubdirs(scanHashedSubdirs) {
 }
 
 void RecursiveScanDirectoryTask::run() {
@@ -117,6 +119,12 @@ void RecursiveScanDirectoryTask::run() {
 
     // Process all of the sub-directories.
     for (const mixxx::FileInfo& dirInfo : dirsToScan) {
+        if (!m_scanHashedSubdirs &&
+                mixxx::isValidCacheKey(
+                        m_scannerGlobal->directoryHashInDatabase(dirInfo.location()))) {
+            // Unchanged subdirectories don't need to be scanned again
+            continue;
+        }
         // Atomically test and mark the directory as scanned to avoid
         // that the same directory is scanned multiple times by different
         // tasks.
@@ -8,13 +8,18 @@
 /// performing a hash of the directory's file list, and those hashes are stored
 /// in the database. Successful if the scan completed without being
 /// cancelled. False if the scan was cancelled part-way through.
+///
+/// Subdirectories that have been hashed before are skipped unless
+/// scanHashedSubdirs is set. This is used for rescanning only the
+/// directories that have been reported as changed.
 class RecursiveScanDirectoryTask : public ScannerTask {
     Q_OBJECT
   public:
     RecursiveScanDirectoryTask(LibraryScanner* pScanner,
             const ScannerGlobalPointer& scannerGlobal,
             const mixxx::FileAccess&& dirAccess,
-            bool scanUnhashed);
+            bool scanUnhashed,
+            bool scanHashedSubdirs = true);
     ~RecursiveScanDirectoryTask() override = default;
 
     void run() override;
@@ -22,4 +27,5 @@ class RecursiveScanDirectoryTask : public ScannerTask {
   private:
     const mixxx::FileAccess m_dirAccess;
     const bool m_scanUnhashed;
+    const bool m_scanHashedSubdirs;
 };
@@ -8,6 +8,7 @@
 #include <QSharedPointer>
 #include <QStringList>
 
+#include "track/track_decl.h"
 #include "util/cache.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
@@ -20,12 +21,14 @@ class ScannerGlobal {
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            const SyncTrackMetadataParams& syncTrackMetadataParams)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_syncTrackMetadataParams(syncTrackMetadataParams),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
@@ -50,6 +53,11 @@ class ScannerGlobal {
         return m_directoriesBlacklist.contains(directoryPath);
     }
 
+    // Used for importing the metadata of new tracks
+    const SyncTrackMetadataParams& syncTrackMetadataParams() const {
+        return m_syncTrackMetadataParams;
+    }
+
     const QRegularExpression& supportedExtensionsRegex() const {
         return m_supportedExtensionsMatcher;
     }
@@ -182,6 +190,8 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const SyncTrackMetadataParams m_syncTrackMetadataParams;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -1,12 +1,24 @@
 #pragma once
 
+#include <QList>
+#include <QMetaType>
 #include <QObject>
 #include <QRunnable>
 
 #include "library/scanner/scannerglobal.h"
+#include "sources/soundsourceproxy.h"
 
 class LibraryScanner;
 
+/// A file that is not in the database yet and its metadata that has
+/// already been imported by the scanner task.
+struct ImportedTrackFile {
+    QString location;
+    SoundSourceProxy::ImportedTrackMetadata importedMetadata;
+};
+
+Q_DECLARE_METATYPE(ImportedTrackFile);
+
 class ScannerTask : public QObject, public QRunnable {
     Q_OBJECT
   public:
@@ -23,7 +35,7 @@ class ScannerTask : public QObject, public QRunnable {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
     void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    void addNewTracks(const QList<ImportedTrackFile>& trackFiles);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
@@ -1,7 +1,9 @@
 #include "library/searchquery.h"
 
 #include <QRegularExpression>
+#include <utility>
 
+#include "library/columnartrackindex.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
 #include "library/trackset/crate/crateschema.h"
@@ -15,6 +17,9 @@ namespace {
 
 constexpr double kLibraryRoundRange = 0.05;
 
+// Shorter substrings can't be found by the trigram tokenizer
+constexpr int kMinFullTextSearchLength = 3;
+
 const QRegularExpression kDurationRegex(QStringLiteral("^(\\d+)(m|:)?([0-5]?\\d)?s?$"));
 
 // The ordering of operator alternatives separated by '|' is crucial to avoid incomplete
@@ -84,6 +89,32 @@ QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& colum
     return QVariant();
 }
 
+// The database compares values of other storage types as text
+bool isIndexColumnOfType(const ColumnarTrackIndex& index,
+        int column,
+        ColumnarTrackIndex::ColumnType type) {
+    if (column < 0) {
+        return false;
+    }
+    const auto columnType = index.columnType(column);
+    return columnType == type || columnType == ColumnarTrackIndex::ColumnType::Null;
+}
+
+bool indexColumnsOfType(const ColumnarTrackIndex& index,
+        const QStringList& sqlColumns,
+        ColumnarTrackIndex::ColumnType type,
+        QVector<int>* pColumns) {
+    pColumns->clear();
+    for (const auto& sqlColumn : sqlColumns) {
+        const int column = index.columnIndex(sqlColumn);
+        if (!isIndexColumnOfType(index, column, type)) {
+            return false;
+        }
+        pColumns->append(column);
+    }
+    return true;
+}
+
 QString concatSqlClauses(
         const QStringList& sqlClauses, const QString& sqlConcatOp) {
     switch (sqlClauses.size()) {
@@ -127,6 +158,27 @@ QString AndNode::toSql() const {
     return concatSqlClauses(queryFragments, "AND");
 }
 
+SqlBool AndNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    SqlBool result = SqlBool::Empty;
+    for (const auto& pNode : m_nodes) {
+        switch (pNode->evaluate(index, row)) {
+        case SqlBool::False:
+            return SqlBool::False;
+        case SqlBool::True:
+            if (result == SqlBool::Empty) {
+                result = SqlBool::True;
+            }
+            break;
+        case SqlBool::Null:
+            result = SqlBool::Null;
+            break;
+        case SqlBool::Empty:
+            break;
+        }
+    }
+    return result;
+}
+
 bool OrNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (pNode->match(pTrack)) {
@@ -151,6 +203,39 @@ QString OrNode::toSql() const {
     return concatSqlClauses(queryFragments, "OR");
 }
 
+SqlBool OrNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    if (m_nodes.empty()) {
+        return SqlBool::False;
+    }
+    SqlBool result = SqlBool::Empty;
+    for (const auto& pNode : m_nodes) {
+        switch (pNode->evaluate(index, row)) {
+        case SqlBool::True:
+            return SqlBool::True;
+        case SqlBool::False:
+            if (result == SqlBool::Empty) {
+                result = SqlBool::False;
+            }
+            break;
+        case SqlBool::Null:
+            result = SqlBool::Null;
+            break;
+        case SqlBool::Empty:
+            break;
+        }
+    }
+    return result;
+}
+
+bool GroupNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    for (const auto& pNode : m_nodes) {
+        if (!pNode->prepareEvaluate(index)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
@@ -167,6 +252,25 @@ QString NotNode::toSql() const {
     }
 }
 
+bool NotNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    return m_pNode->prepareEvaluate(index);
+}
+
+SqlBool NotNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    switch (m_pNode->evaluate(index, row)) {
+    case SqlBool::False:
+        return SqlBool::True;
+    case SqlBool::True:
+        return SqlBool::False;
+    case SqlBool::Null:
+        return SqlBool::Null;
+    case SqlBool::Empty:
+        return SqlBool::Empty;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return SqlBool::Null;
+}
+
 TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QStringList& sqlColumns,
         const QString& argument,
@@ -228,6 +332,97 @@ QString TextFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+FullTextFilterNode::FullTextFilterNode(const QSqlDatabase& database,
+        const QStringList& sqlColumns,
+        const QString& argument,
+        QString idColumn)
+        : TextFilterNode(database, sqlColumns, argument),
+          m_idColumn(std::move(idColumn)) {
+}
+
+QString FullTextFilterNode::toSql() const {
+    const QString likeSql = TextFilterNode::toSql();
+    // The index doesn't know the wildcards of LIKE
+    if (m_matchMode != StringMatch::Contains ||
+            m_argument.toUcs4().size() < kMinFullTextSearchLength ||
+            m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne) ||
+            m_argument.contains(QChar('\0'))) {
+        return likeSql;
+    }
+    const QStringList& fullTextColumns = mixxx::trackschema::fullTextColumns();
+    for (const auto& sqlColumn : m_sqlColumns) {
+        if (!fullTextColumns.contains(sqlColumn)) {
+            return likeSql;
+        }
+    }
+    // The argument is already folded like the indexed values
+    QString phrase = m_argument;
+    phrase.replace(QChar('"'), QStringLiteral("\"\""));
+    const QString matchExpression = QStringLiteral("{%1} : \"%2\"")
+                                            .arg(m_sqlColumns.join(QChar(' ')), phrase);
+    FieldEscaper escaper(m_database);
+    // Evaluating the LIKE expressions only for the tracks found by the
+    // index preserves their exact semantics.
+    return QStringLiteral(
+            "%1 IN (SELECT rowid FROM " LIBRARYFTS_TABLE
+            " WHERE " LIBRARYFTS_TABLE " MATCH %2) AND (%3)")
+            .arg(m_idColumn, escaper.escapeString(matchExpression), likeSql);
+}
+
+bool TextFilterNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    // Wildcards and the delimiter that toSql() appends after a trailing
+    // space are only understood by LIKE
+    if (m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne) ||
+            m_argument.contains(QChar('\0')) ||
+            (m_argument.size() > 0 && m_argument[m_argument.size() - 1].isSpace())) {
+        return false;
+    }
+    if (!indexColumnsOfType(index,
+                m_sqlColumns,
+                ColumnarTrackIndex::ColumnType::Text,
+                &m_indexColumns)) {
+        return false;
+    }
+    m_utf8Argument = m_argument.toUtf8();
+    m_stringMatches.assign(index.stringCount(), -1);
+    return true;
+}
+
+bool TextFilterNode::matchesString(const ColumnarTrackIndex& index, int stringId) const {
+    signed char& matches = m_stringMatches[stringId];
+    if (matches < 0) {
+        // The argument has been folded by the constructor. Comparing the
+        // UTF-8 encoded bytes is equivalent to comparing the characters.
+        const QByteArray value = index.foldedUtf8String(stringId);
+        switch (m_matchMode) {
+        case StringMatch::Contains:
+            matches = value.contains(m_utf8Argument) ? 1 : 0;
+            break;
+        case StringMatch::Equals:
+            matches = value == m_utf8Argument ? 1 : 0;
+            break;
+        }
+    }
+    return matches > 0;
+}
+
+SqlBool TextFilterNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    if (m_indexColumns.isEmpty()) {
+        return SqlBool::Empty;
+    }
+    bool hasNull = false;
+    for (const int column : std::as_const(m_indexColumns)) {
+        if (index.isNull(row, column)) {
+            hasNull = true;
+        } else if (matchesString(index, index.stringId(row, column))) {
+            return SqlBool::True;
+        }
+    }
+    return hasNull ? SqlBool::Null : SqlBool::False;
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -248,6 +443,32 @@ QString NullOrEmptyTextFilterNode::toSql() const {
     return QString();
 }
 
+bool NullOrEmptyTextFilterNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    if (m_sqlColumns.isEmpty()) {
+        m_indexColumn = -1;
+        return true;
+    }
+    m_indexColumn = index.columnIndex(m_sqlColumns.first());
+    return m_indexColumn >= 0 &&
+            index.columnType(m_indexColumn) != ColumnarTrackIndex::ColumnType::Variant;
+}
+
+SqlBool NullOrEmptyTextFilterNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    if (m_indexColumn < 0) {
+        return SqlBool::Empty;
+    }
+    if (index.isNull(row, m_indexColumn)) {
+        return SqlBool::True;
+    }
+    if (index.columnType(m_indexColumn) != ColumnarTrackIndex::ColumnType::Text) {
+        // A number is never equal to ''
+        return SqlBool::False;
+    }
+    return index.isEmptyString(index.stringId(row, m_indexColumn))
+            ? SqlBool::True
+            : SqlBool::False;
+}
+
 CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
         const QString& crateNameLike)
         : m_pCrateStorage(pCrateStorage),
@@ -255,7 +476,7 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
           m_matchInitialized(false) {
 }
 
-bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+void CrateFilterNode::initMatchingTrackIds() const {
     if (!m_matchInitialized) {
         CrateTrackSelectResult crateTracks(
                 m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
@@ -266,7 +487,10 @@ bool CrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+}
 
+bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
@@ -276,12 +500,26 @@ QString CrateFilterNode::toSql() const {
                     m_crateNameLike));
 }
 
+bool CrateFilterNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    Q_UNUSED(index);
+    initMatchingTrackIds();
+    return true;
+}
+
+SqlBool CrateFilterNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    return std::binary_search(m_matchingTrackIds.begin(),
+                   m_matchingTrackIds.end(),
+                   index.trackId(row))
+            ? SqlBool::True
+            : SqlBool::False;
+}
+
 NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
         : m_pCrateStorage(pCrateStorage),
           m_matchInitialized(false) {
 }
 
-bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+void NoCrateFilterNode::initMatchingTrackIds() const {
     if (!m_matchInitialized) {
         TrackSelectResult tracks(
                 m_pCrateStorage->selectAllTracksSorted());
@@ -292,7 +530,10 @@ bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+}
 
+bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
@@ -302,6 +543,20 @@ QString NoCrateFilterNode::toSql() const {
                     CrateStorage::formatQueryForTrackIdsWithCrate());
 }
 
+bool NoCrateFilterNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    Q_UNUSED(index);
+    initMatchingTrackIds();
+    return true;
+}
+
+SqlBool NoCrateFilterNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    return std::binary_search(m_matchingTrackIds.begin(),
+                   m_matchingTrackIds.end(),
+                   index.trackId(row))
+            ? SqlBool::False
+            : SqlBool::True;
+}
+
 NumericFilterNode::NumericFilterNode(const QStringList& sqlColumns)
         : m_sqlColumns(sqlColumns),
           m_bOperatorQuery(false),
@@ -310,7 +565,10 @@ NumericFilterNode::NumericFilterNode(const QStringList& sqlColumns)
           m_dOperatorArgument(0.0),
           m_bRangeQuery(false),
           m_dRangeLow(0.0),
-          m_dRangeHigh(0.0) {
+          m_dRangeHigh(0.0),
+          m_dSqlOperatorArgument(0.0),
+          m_dSqlRangeLow(0.0),
+          m_dSqlRangeHigh(0.0) {
 }
 
 NumericFilterNode::NumericFilterNode(
@@ -417,8 +675,56 @@ QString NumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NumericFilterNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    if (!indexColumnsOfType(index,
+                m_sqlColumns,
+                ColumnarTrackIndex::ColumnType::Number,
+                &m_indexColumns)) {
+        return false;
+    }
+    // toSql() rounds the arguments
+    m_dSqlOperatorArgument = QString::number(m_dOperatorArgument).toDouble();
+    m_dSqlRangeLow = QString::number(m_dRangeLow).toDouble();
+    m_dSqlRangeHigh = QString::number(m_dRangeHigh).toDouble();
+    return true;
+}
+
+SqlBool NumericFilterNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    if (m_indexColumns.isEmpty()) {
+        return SqlBool::Empty;
+    }
+    if (m_bNullQuery) {
+        // only use the major column
+        return index.isNull(row, m_indexColumns.first()) ? SqlBool::True : SqlBool::False;
+    }
+    if (!m_bOperatorQuery && !m_bRangeQuery) {
+        return SqlBool::Empty;
+    }
+    bool hasNull = false;
+    for (const int column : std::as_const(m_indexColumns)) {
+        if (index.isNull(row, column)) {
+            hasNull = true;
+            continue;
+        }
+        const double dValue = index.number(row, column);
+        if (m_bOperatorQuery) {
+            if ((m_operator == "=" && dValue == m_dSqlOperatorArgument) ||
+                    (m_operator == "<" && dValue < m_dSqlOperatorArgument) ||
+                    (m_operator == ">" && dValue > m_dSqlOperatorArgument) ||
+                    (m_operator == "<=" && dValue <= m_dSqlOperatorArgument) ||
+                    (m_operator == ">=" && dValue >= m_dSqlOperatorArgument)) {
+                return SqlBool::True;
+            }
+        } else if (dValue >= m_dSqlRangeLow && dValue <= m_dSqlRangeHigh) {
+            return SqlBool::True;
+        }
+    }
+    return hasNull ? SqlBool::Null : SqlBool::False;
+}
+
 NullNumericFilterNode::NullNumericFilterNode(const QStringList& sqlColumns)
-        : m_sqlColumns(sqlColumns) {
+        : m_sqlColumns(sqlColumns),
+          m_indexColumn(-1) {
 }
 
 bool NullNumericFilterNode::match(const TrackPointer& pTrack) const {
@@ -440,6 +746,22 @@ QString NullNumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NullNumericFilterNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    if (m_sqlColumns.isEmpty()) {
+        m_indexColumn = -1;
+        return true;
+    }
+    m_indexColumn = index.columnIndex(m_sqlColumns.first());
+    return m_indexColumn >= 0;
+}
+
+SqlBool NullNumericFilterNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    if (m_indexColumn < 0) {
+        return SqlBool::Empty;
+    }
+    return index.isNull(row, m_indexColumn) ? SqlBool::True : SqlBool::False;
+}
+
 DurationFilterNode::DurationFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns) {
@@ -764,7 +1086,8 @@ QString BpmFilterNode::toSql() const {
 }
 
 KeyFilterNode::KeyFilterNode(mixxx::track::io::key::ChromaticKey key,
-        bool fuzzy) {
+        bool fuzzy)
+        : m_indexColumn(-1) {
     if (fuzzy) {
         m_matchKeys = KeyUtils::getCompatibleKeys(key);
     } else {
@@ -784,6 +1107,28 @@ QString KeyFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool KeyFilterNode::prepareEvaluate(const ColumnarTrackIndex& index) const {
+    m_indexColumn = index.columnIndex(LIBRARYTABLE_KEY_ID);
+    return isIndexColumnOfType(index, m_indexColumn, ColumnarTrackIndex::ColumnType::Number);
+}
+
+SqlBool KeyFilterNode::evaluate(const ColumnarTrackIndex& index, int row) const {
+    if (m_matchKeys.isEmpty()) {
+        return SqlBool::Empty;
+    }
+    // IS never evaluates to NULL
+    if (index.isNull(row, m_indexColumn)) {
+        return SqlBool::False;
+    }
+    const double keyId = index.number(row, m_indexColumn);
+    for (const auto& matchKey : m_matchKeys) {
+        if (keyId == matchKey) {
+            return SqlBool::True;
+        }
+    }
+    return SqlBool::False;
+}
+
 YearFilterNode::YearFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns, argument) {
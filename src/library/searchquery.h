@@ -13,6 +13,7 @@
 #include "track/track_decl.h"
 #include "util/assert.h"
 
+class ColumnarTrackIndex;
 class CrateStorage;
 class TrackId;
 
@@ -23,6 +24,16 @@ enum class StringMatch {
     Equals,
 };
 
+/// The result of a condition as evaluated by SQL. Comparisons with NULL
+/// are neither true nor false, and nodes without a condition (i.e. with an
+/// empty toSql()) are ignored by their parents.
+enum class SqlBool {
+    False = 0,
+    True,
+    Null,
+    Empty,
+};
+
 class QueryNode {
   public:
     QueryNode(const QueryNode&) = delete; // prevent copying
@@ -31,6 +42,23 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Prepares evaluate() for the columns of the index. Returns false if
+    /// the node can only be evaluated by the database.
+    virtual bool prepareEvaluate(const ColumnarTrackIndex& index) const {
+        Q_UNUSED(index);
+        return false;
+    }
+
+    /// Evaluates the node for a row of the index with the same result as
+    /// the database would produce for toSql(). Requires that
+    /// prepareEvaluate() has succeeded for the index.
+    virtual SqlBool evaluate(const ColumnarTrackIndex& index, int row) const {
+        Q_UNUSED(index);
+        Q_UNUSED(row);
+        DEBUG_ASSERT(!"not supported");
+        return SqlBool::Null;
+    }
+
   protected:
     QueryNode() = default;
 };
@@ -42,6 +70,8 @@ class GroupNode : public QueryNode {
         m_nodes.push_back(std::move(pNode));
     }
 
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+
   protected:
     // NOTE(uklotzde): std::vector is more suitable (efficiency)
     // than a QList for a private member. And QList from Qt 4
@@ -53,12 +83,14 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 };
 
 class NotNode : public QueryNode {
@@ -70,6 +102,8 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -84,12 +118,41 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
-  private:
+  protected:
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
     QString m_argument;
     StringMatch m_matchMode;
+
+  private:
+    bool matchesString(const ColumnarTrackIndex& index, int stringId) const;
+
+    // The indexed columns and per string of the index whether it matches,
+    // which is evaluated only once for strings that are shared by tracks.
+    mutable QVector<int> m_indexColumns;
+    mutable std::vector<signed char> m_stringMatches;
+    // The folded argument as stored in the string pool of the index
+    mutable QByteArray m_utf8Argument;
+};
+
+/// Looks up the argument in the full-text search index of the library
+/// before the LIKE expressions of TextFilterNode are evaluated. The index
+/// finds the same substrings, but without scanning all tracks. Arguments
+/// that the index can't find fall back to TextFilterNode.
+class FullTextFilterNode : public TextFilterNode {
+  public:
+    FullTextFilterNode(const QSqlDatabase& database,
+            const QStringList& sqlColumns,
+            const QString& argument,
+            QString idColumn);
+
+    QString toSql() const override;
+
+  private:
+    QString m_idColumn;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
@@ -97,15 +160,19 @@ class NullOrEmptyTextFilterNode : public QueryNode {
     NullOrEmptyTextFilterNode(const QSqlDatabase& database,
             const QStringList& sqlColumns)
             : m_database(database),
-              m_sqlColumns(sqlColumns) {
+              m_sqlColumns(sqlColumns),
+              m_indexColumn(-1) {
     }
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
   private:
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
+    mutable int m_indexColumn;
 };
 
 class CrateFilterNode : public QueryNode {
@@ -115,8 +182,12 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -129,8 +200,12 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -143,6 +218,8 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -164,6 +241,13 @@ class NumericFilterNode : public QueryNode {
     bool m_bRangeQuery;
     double m_dRangeLow;
     double m_dRangeHigh;
+
+  private:
+    // The indexed columns and the arguments as formatted by toSql()
+    mutable QVector<int> m_indexColumns;
+    mutable double m_dSqlOperatorArgument;
+    mutable double m_dSqlRangeLow;
+    mutable double m_dSqlRangeHigh;
 };
 
 class NullNumericFilterNode : public QueryNode {
@@ -172,8 +256,13 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
     QStringList m_sqlColumns;
+
+  private:
+    mutable int m_indexColumn;
 };
 
 class DurationFilterNode : public NumericFilterNode {
@@ -238,9 +327,12 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override;
+    SqlBool evaluate(const ColumnarTrackIndex& index, int row) const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
+    mutable int m_indexColumn;
 };
 
 class SqlNode : public QueryNode {
@@ -271,6 +363,12 @@ class YearFilterNode : public NumericFilterNode {
   public:
     YearFilterNode(const QStringList& sqlColumns, const QString& argument);
     QString toSql() const override;
+
+    bool prepareEvaluate(const ColumnarTrackIndex& index) const override {
+        // Only the year part of the text is compared by the database
+        Q_UNUSED(index);
+        return false;
+    }
 };
 
 #endif /* SEARCHQUERY_H */
@@ -1,6 +1,6 @@
 #include "library/searchqueryparser.h"
 
-#include <QRegularExpression>
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -53,49 +53,123 @@ std::pair<QString, Quoted> consumeQuotedArgument(QString argument,
     return {argument, Quoted::Complete};
 }
 
-} // anonymous namespace
+bool isWordChar(QChar c) {
+    return c.isLetterOrNumber() || c == '_';
+}
 
-constexpr char kNegatePrefix[] = "-";
-constexpr char kFuzzyPrefix[] = "~";
+/// Returns the length of the OR operator "|" or "OR" at the position or 0.
+/// A word needs to be delimited on both sides to be an operator.
+qsizetype orOperatorLengthAt(const QString& text, qsizetype pos) {
+    if (text[pos] == '|') {
+        return 1;
+    }
+    if (text[pos] == 'O' && pos + 1 < text.size() && text[pos + 1] == 'R' &&
+            (pos == 0 || !isWordChar(text[pos - 1])) &&
+            (pos + 2 == text.size() || !isWordChar(text[pos + 2]))) {
+        return 2;
+    }
+    return 0;
+}
 
-// see https://stackoverflow.com/questions/1310473/regex-matching-spaces-but-not-in-strings
-#define QUOTED_STRING_LOOKAHEAD "(?=[^\"]*(\"[^\"]*\"[^\"]*)*$)"
+qsizetype spaceLengthAt(const QString& text, qsizetype pos) {
+    return text[pos] == ' ' ? 1 : 0;
+}
 
-const QRegularExpression kSplitIntoWordsRegexp = QRegularExpression(
-        QStringLiteral(" " QUOTED_STRING_LOOKAHEAD));
+/// Scans the text once for separators that are not enclosed in quotes and
+/// invokes onSeparator(pos, length) for each of them until it returns false.
+/// A separator is outside of quotes if an even number of quotes follows it.
+template<typename SeparatorLengthAt, typename OnSeparator>
+void forEachSeparatorOutsideQuotes(const QString& text,
+        SeparatorLengthAt separatorLengthAt,
+        OnSeparator onSeparator) {
+    qsizetype quotesAfter = text.count('"');
+    qsizetype pos = 0;
+    while (pos < text.size()) {
+        if (text[pos] == '"') {
+            --quotesAfter;
+            ++pos;
+            continue;
+        }
+        const qsizetype length = quotesAfter % 2 == 0 ? separatorLengthAt(text, pos) : 0;
+        if (length == 0) {
+            ++pos;
+            continue;
+        }
+        if (!onSeparator(pos, length)) {
+            return;
+        }
+        pos += length;
+    }
+}
 
-const QRegularExpression kSplitOnOrOperatorRegexp = QRegularExpression(
-        QStringLiteral("(?:\\||\\bOR\\b)" QUOTED_STRING_LOOKAHEAD));
+/// Splits the text at the separators that are not enclosed in quotes and
+/// skips empty parts
+template<typename SeparatorLengthAt>
+QStringList splitOutsideQuotes(const QString& text, SeparatorLengthAt separatorLengthAt) {
+    QStringList parts;
+    qsizetype partStart = 0;
+    forEachSeparatorOutsideQuotes(text,
+            separatorLengthAt,
+            [&text, &parts, &partStart](qsizetype pos, qsizetype length) {
+                if (pos > partStart) {
+                    parts.append(text.mid(partStart, pos - partStart));
+                }
+                partStart = pos + length;
+                return true;
+            });
+    if (partStart < text.size()) {
+        parts.append(text.mid(partStart));
+    }
+    return parts;
+}
+
+bool containsOrOperator(const QString& text) {
+    bool found = false;
+    forEachSeparatorOutsideQuotes(text,
+            orOperatorLengthAt,
+            [&found](qsizetype, qsizetype) {
+                found = true;
+                return false;
+            });
+    return found;
+}
+
+} // anonymous namespace
+
+constexpr char kNegatePrefix[] = "-";
+constexpr char kFuzzyPrefix[] = "~";
 
 SearchQueryParser::SearchQueryParser(TrackCollection* pTrackCollection, QStringList searchColumns)
         : m_pTrackCollection(pTrackCollection),
           m_searchCrates(false) {
     setSearchColumns(std::move(searchColumns));
 
-    m_textFilters << "artist"
-                  << "album_artist"
-                  << "album"
-                  << "title"
-                  << "genre"
-                  << "composer"
-                  << "grouping"
-                  << "comment"
-                  << "location"
-                  << "crate"
-                  << "type";
-    m_numericFilters << "track"
-                     << "played"
-                     << "rating"
-                     << "bitrate"
-                     << "id";
-    m_specialFilters << "year"
-                     << "key"
-                     << "bpm"
-                     << "duration"
-                     << "added"
-                     << "dateadded"
-                     << "datetime_added"
-                     << "date_added";
+    for (const auto* field : {"artist",
+                 "album_artist",
+                 "album",
+                 "title",
+                 "genre",
+                 "composer",
+                 "grouping",
+                 "comment",
+                 "location",
+                 "crate",
+                 "type"}) {
+        m_filterTypes.insert(QString::fromLatin1(field), FilterType::Text);
+    }
+    for (const auto* field : {"track", "played", "rating", "bitrate", "id"}) {
+        m_filterTypes.insert(QString::fromLatin1(field), FilterType::Numeric);
+    }
+    for (const auto* field : {"year",
+                 "key",
+                 "bpm",
+                 "duration",
+                 "added",
+                 "dateadded",
+                 "datetime_added",
+                 "date_added"}) {
+        m_filterTypes.insert(QString::fromLatin1(field), FilterType::Special);
+    }
 
     m_fieldToSqlColumns["artist"] << "artist" << "album_artist";
     m_fieldToSqlColumns["album_artist"] << "album_artist";
@@ -119,12 +193,6 @@ SearchQueryParser::SearchQueryParser(TrackCollection* pTrackCollection, QStringL
     m_fieldToSqlColumns["type"] << "filetype";
     m_fieldToSqlColumns["datetime_added"] << "datetime_added";
     m_fieldToSqlColumns["id"] << "id";
-
-    m_textFilterMatcher = QRegularExpression(QString("^-?(%1):(.*)$").arg(m_textFilters.join("|")));
-    m_numericFilterMatcher = QRegularExpression(
-            QString("^-?(%1):(.*)$").arg(m_numericFilters.join("|")));
-    m_specialFilterMatcher = QRegularExpression(
-            QString("^[~-]?(%1):(.*)$").arg(m_specialFilters.join("|")));
 }
 
 void SearchQueryParser::setSearchColumns(QStringList searchColumns) {
@@ -140,6 +208,21 @@ void SearchQueryParser::setSearchColumns(QStringList searchColumns) {
     }
 }
 
+void SearchQueryParser::enableFullTextSearch(QString idColumn) {
+    m_fullTextIdColumn = std::move(idColumn);
+}
+
+std::unique_ptr<TextFilterNode> SearchQueryParser::newSearchTermNode(
+        const QString& argument) const {
+    if (!m_fullTextIdColumn.isEmpty() &&
+            m_pTrackCollection->getTrackDAO().hasFullTextIndex()) {
+        return std::make_unique<FullTextFilterNode>(
+                m_pTrackCollection->database(), m_queryColumns, argument, m_fullTextIdColumn);
+    }
+    return std::make_unique<TextFilterNode>(
+            m_pTrackCollection->database(), m_queryColumns, argument);
+}
+
 SearchQueryParser::TextArgumentResult SearchQueryParser::getTextArgument(QString argument,
         QStringList* tokens,
         bool removeLeadingEqualsSign) const {
@@ -168,6 +251,22 @@ SearchQueryParser::TextArgumentResult SearchQueryParser::getTextArgument(QString
     return {argument, mode};
 }
 
+SearchQueryParser::FilterMatch SearchQueryParser::matchFilter(const QString& token) const {
+    // Only the special filters can be fuzzy
+    const bool fuzzy = token.startsWith(kFuzzyPrefix);
+    const qsizetype fieldStart = (fuzzy || token.startsWith(kNegatePrefix)) ? 1 : 0;
+    const qsizetype colonIndex = token.indexOf(':', fieldStart);
+    if (colonIndex < 0) {
+        return {};
+    }
+    QString field = token.mid(fieldStart, colonIndex - fieldStart);
+    const FilterType type = m_filterTypes.value(field, FilterType::None);
+    if (type == FilterType::None || (fuzzy && type != FilterType::Special)) {
+        return {};
+    }
+    return {type, std::move(field), token.mid(colonIndex + 1)};
+}
+
 void SearchQueryParser::parseTokens(QStringList tokens,
                                     AndNode* pQuery) const {
     while (tokens.size() > 0) {
@@ -179,12 +278,10 @@ void SearchQueryParser::parseTokens(QStringList tokens,
         bool negate = token.startsWith(kNegatePrefix);
         std::unique_ptr<QueryNode> pNode;
 
-        const QRegularExpressionMatch textFilterMatch = m_textFilterMatcher.match(token);
-        const QRegularExpressionMatch numericFilterMatch = m_numericFilterMatcher.match(token);
-        const QRegularExpressionMatch specialFilterMatch = m_specialFilterMatcher.match(token);
-        if (textFilterMatch.hasMatch()) {
-            QString field = textFilterMatch.captured(1);
-            auto [argument, matchMode] = getTextArgument(textFilterMatch.captured(2), &tokens);
+        const FilterMatch filter = matchFilter(token);
+        if (filter.type == FilterType::Text) {
+            const QString& field = filter.field;
+            auto [argument, matchMode] = getTextArgument(filter.argument, &tokens);
 
             if (argument == kMissingFieldSearchTerm) {
                 qDebug() << "argument explicit empty";
@@ -209,9 +306,9 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                             matchMode);
                 }
             }
-        } else if (numericFilterMatch.hasMatch()) {
-            QString field = numericFilterMatch.captured(1);
-            QString argument = getTextArgument(numericFilterMatch.captured(2), &tokens).argument;
+        } else if (filter.type == FilterType::Numeric) {
+            const QString& field = filter.field;
+            QString argument = getTextArgument(filter.argument, &tokens).argument;
 
             if (!argument.isEmpty()) {
                 if (argument == kMissingFieldSearchTerm) {
@@ -222,12 +319,11 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                          m_fieldToSqlColumns[field], argument);
                 }
             }
-        } else if (specialFilterMatch.hasMatch()) {
+        } else if (filter.type == FilterType::Special) {
             bool fuzzy = token.startsWith(kFuzzyPrefix);
             bool negate = token.startsWith(kNegatePrefix);
-            QString field = specialFilterMatch.captured(1);
-            auto [argument, matchMode] = getTextArgument(
-                    specialFilterMatch.captured(2), &tokens);
+            QString field = filter.field;
+            auto [argument, matchMode] = getTextArgument(filter.argument, &tokens);
 
             if (!argument.isEmpty()) {
                 if (field == "key") {
@@ -280,12 +376,10 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     auto gNode = std::make_unique<OrNode>();
                     gNode->addNode(std::make_unique<CrateFilterNode>(
                                     &m_pTrackCollection->crates(), argument));
-                    gNode->addNode(std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument));
+                    gNode->addNode(newSearchTermNode(argument));
                     pNode = std::move(gNode);
                 } else {
-                    pNode = std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument);
+                    pNode = newSearchTermNode(argument);
                 }
             }
         }
@@ -310,12 +404,7 @@ std::unique_ptr<AndNode> SearchQueryParser::parseAndNode(const QString& query) c
 std::unique_ptr<OrNode> SearchQueryParser::parseOrNode(const QString& query) const {
     auto pQuery = std::make_unique<OrNode>();
 
-    const QStringList rawAndNodes = query.split(kSplitOnOrOperatorRegexp,
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-            Qt::SkipEmptyParts);
-#else
-            QString::SkipEmptyParts);
-#endif
+    const QStringList rawAndNodes = splitOutsideQuotes(query, orOperatorLengthAt);
     for (const QString& rawAndNode : rawAndNodes) {
         if (!rawAndNode.isEmpty()) {
             pQuery->addNode(parseAndNode(rawAndNode));
@@ -342,13 +431,7 @@ std::unique_ptr<QueryNode> SearchQueryParser::parseQuery(
 }
 
 QStringList SearchQueryParser::splitQueryIntoWords(const QString& query) {
-    QStringList queryWordList = query.split(kSplitIntoWordsRegexp,
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-            Qt::SkipEmptyParts);
-#else
-            QString::SkipEmptyParts);
-#endif
-    return queryWordList;
+    return splitOutsideQuotes(query, spaceLengthAt);
 }
 
 bool SearchQueryParser::queryIsLessSpecific(const QString& original, const QString& changed) {
@@ -385,3 +468,57 @@ bool SearchQueryParser::queryIsLessSpecific(const QString& original, const QStri
     }
     return false;
 }
+
+bool SearchQueryParser::queryIsMoreSpecific(const QString& original, const QString& changed) {
+    // Quotes may join multiple words into a single argument and alternatives
+    // match tracks that the original query doesn't match
+    if (original.contains('"') || changed.contains('"') ||
+            containsOrOperator(original) ||
+            containsOrOperator(changed)) {
+        return false;
+    }
+
+    QStringList oldWordList = SearchQueryParser::splitQueryIntoWords(original);
+    QStringList newWordList = SearchQueryParser::splitQueryIntoWords(changed);
+    const auto consumesNextWord = [](const QString& word) {
+        // A filter without argument takes the next word as its argument
+        return word.endsWith(':');
+    };
+    if (std::any_of(oldWordList.cbegin(), oldWordList.cend(), consumesNextWord) ||
+            std::any_of(newWordList.cbegin(), newWordList.cend(), consumesNextWord)) {
+        return false;
+    }
+
+    // Only extending a plain search term narrows down its matches. Extended
+    // negated terms exclude fewer tracks and the matches of filters or exact
+    // matches are unpredictable.
+    const auto isPlainSearchTerm = [](const QString& word) {
+        return !word.contains(':') &&
+                !word.startsWith(kNegatePrefix) &&
+                !word.startsWith(kFuzzyPrefix) &&
+                !word.startsWith('=');
+    };
+
+    // we sort the lists for length so the longest terms are refined first
+    std::sort(oldWordList.begin(), oldWordList.end(), [](const QString& v1, const QString& v2) {
+        return v1.length() > v2.length();
+    });
+    for (const auto& oldWord : std::as_const(oldWordList)) {
+        bool refined = false;
+        for (int j = 0; j < newWordList.length(); j++) {
+            const QString& newWord = newWordList.at(j);
+            if (newWord == oldWord ||
+                    (isPlainSearchTerm(oldWord) && isPlainSearchTerm(newWord) &&
+                            newWord.contains(oldWord))) {
+                newWordList.removeAt(j);
+                refined = true;
+                break;
+            }
+        }
+        if (!refined) {
+            return false;
+        }
+    }
+    // All remaining words are additional terms that are combined with AND
+    return true;
+}
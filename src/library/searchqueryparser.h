@@ -1,6 +1,6 @@
 #pragma once
 
-#include <QRegularExpression>
+#include <QHash>
 #include <QString>
 #include <memory>
 
@@ -17,6 +17,11 @@ class SearchQueryParser {
 
     void setSearchColumns(QStringList searchColumns);
 
+    /// Lets plain search terms use the full-text search index of the
+    /// library if available. The queries are applied to a table that
+    /// stores the ids of the tracks in idColumn.
+    void enableFullTextSearch(QString idColumn);
+
     std::unique_ptr<QueryNode> parseQuery(
             const QString& query,
             const QString& extraFilter) const;
@@ -25,11 +30,33 @@ class SearchQueryParser {
     static QStringList splitQueryIntoWords(const QString& query);
     /// checks if the changed search query is less specific then the original term
     static bool queryIsLessSpecific(const QString& original, const QString& changed);
+    /// checks if all tracks that match the changed search query are also
+    /// matched by the original query, e.g. if characters or terms have been
+    /// appended. Might return false negatives for complex queries.
+    static bool queryIsMoreSpecific(const QString& original, const QString& changed);
 
   private:
+    enum class FilterType {
+        None,
+        Text,
+        Numeric,
+        Special,
+    };
+
+    struct FilterMatch {
+        FilterType type = FilterType::None;
+        QString field;
+        QString argument;
+    };
+
+    /// Matches tokens like "-artist:argument" or "~bpm:argument"
+    FilterMatch matchFilter(const QString& token) const;
+
     void parseTokens(QStringList tokens,
                      AndNode* pQuery) const;
 
+    std::unique_ptr<TextFilterNode> newSearchTermNode(const QString& argument) const;
+
     std::unique_ptr<AndNode> parseAndNode(const QString& query) const;
     std::unique_ptr<OrNode> parseOrNode(const QString& query) const;
 
@@ -44,16 +71,10 @@ class SearchQueryParser {
 
     TrackCollection* m_pTrackCollection;
     QStringList m_queryColumns;
+    QString m_fullTextIdColumn;
     bool m_searchCrates;
-    QStringList m_textFilters;
-    QStringList m_numericFilters;
-    QStringList m_specialFilters;
+    QHash<QString, FilterType> m_filterTypes;
     QHash<QString, QStringList> m_fieldToSqlColumns;
 
-    QRegularExpression m_textFilterMatcher;
-    QRegularExpression m_crateFilterMatcher;
-    QRegularExpression m_numericFilterMatcher;
-    QRegularExpression m_specialFilterMatcher;
-
     DISALLOW_COPY_AND_ASSIGN(SearchQueryParser);
 };
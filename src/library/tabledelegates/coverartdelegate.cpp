@@ -1,6 +1,7 @@
 #include "library/tabledelegates/coverartdelegate.h"
 
 #include <QPainter>
+#include <QScrollBar>
 #include <QTableView>
 #include <algorithm>
 
@@ -37,12 +38,22 @@ CoverArtDelegate::CoverArtDelegate(QTableView* parent)
                 &CoverArtCache::coverFound,
                 this,
                 &CoverArtDelegate::slotCoverFound);
+        connect(m_pTableView->verticalScrollBar(),
+                &QScrollBar::valueChanged,
+                this,
+                &CoverArtDelegate::slotViewportChanged);
     } else {
         kLogger.warning()
                 << "Caching of cover art is not available";
     }
 }
 
+CoverArtDelegate::~CoverArtDelegate() {
+    if (m_pCache) {
+        CoverArtCache::cancelRequests(this);
+    }
+}
+
 void CoverArtDelegate::emitRowsChanged(
         QList<int>&& rows) {
     if (rows.isEmpty()) {
@@ -91,9 +102,8 @@ void CoverArtDelegate::slotInhibitLazyLoading(
     const int width = static_cast<int>(m_pTableView->columnWidth(m_column) * scaleFactor);
 
     for (int row : std::as_const(m_cacheMissRows)) {
-        const QModelIndex index = m_pTableView->model()->index(row, m_column);
-        const QRect rect = m_pTableView->visualRect(index);
-        if (rect.intersects(m_pTableView->rect())) {
+        if (isRowVisible(row)) {
+            const QModelIndex index = m_pTableView->model()->index(row, m_column);
             const CoverInfo coverInfo = m_pTrackModel->getCoverInfo(index);
             requestUncachedCover(coverInfo, width, row);
         }
@@ -121,6 +131,24 @@ void CoverArtDelegate::slotCoverFound(
     }
 }
 
+void CoverArtDelegate::slotViewportChanged() {
+    if (m_pendingCacheRows.isEmpty()) {
+        return;
+    }
+    const QList<mixxx::cache_key_t> pendingCacheKeys = m_pendingCacheRows.uniqueKeys();
+    for (const auto cacheKey : pendingCacheKeys) {
+        const QList<int> rows = m_pendingCacheRows.values(cacheKey);
+        if (std::any_of(rows.cbegin(),
+                    rows.cend(),
+                    [this](int row) { return isRowVisible(row); })) {
+            continue;
+        }
+        // Requested again when painted after scrolling back
+        CoverArtCache::cancelRequest(this, cacheKey);
+        m_pendingCacheRows.remove(cacheKey);
+    }
+}
+
 void CoverArtDelegate::paintItem(
         QPainter* painter,
         const QStyleOptionViewItem& option,
@@ -177,12 +205,16 @@ void CoverArtDelegate::paintItem(
     }
 }
 
+bool CoverArtDelegate::isRowVisible(int row) const {
+    const QModelIndex index = m_pTableView->model()->index(row, m_column);
+    const QRect rect = m_pTableView->visualRect(index);
+    return rect.intersects(m_pTableView->rect());
+}
+
 void CoverArtDelegate::cleanCacheMissRows() const {
     auto it = m_cacheMissRows.cbegin();
     while (it != m_cacheMissRows.cend()) {
-        const QModelIndex index = m_pTableView->model()->index(*it, m_column);
-        const QRect rect = m_pTableView->visualRect(index);
-        if (!rect.intersects(m_pTableView->rect())) {
+        if (!isRowVisible(*it)) {
             // Cover image row is no longer shown. We keep the set
             // small which likely reuses the allocatd memory later
             it = constErase(&m_cacheMissRows, it);
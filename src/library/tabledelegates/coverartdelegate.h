@@ -17,7 +17,7 @@ class CoverArtDelegate : public TableItemDelegate {
   public:
     explicit CoverArtDelegate(
             QTableView* parent);
-    ~CoverArtDelegate() override = default;
+    ~CoverArtDelegate() override;
 
     void paintItem(
             QPainter* painter,
@@ -49,12 +49,17 @@ class CoverArtDelegate : public TableItemDelegate {
             const CoverInfo& coverInfo,
             const QPixmap& pixmap);
 
+    // Cancels the queued requests of covers that are no longer
+    // shown after scrolling.
+    void slotViewportChanged();
+
   protected:
     TrackModel* const m_pTrackModel;
 
   private:
     void emitRowsChanged(
             QList<int>&& rows);
+    bool isRowVisible(int row) const;
     void cleanCacheMissRows() const;
     void requestUncachedCover(
             const CoverInfo& coverInfo,
@@ -28,7 +28,7 @@ void KeyDelegate::paintItem(
     }
 
     // Display the key text with the user-provided notation
-    QString elidedText = option.fontMetrics.elidedText(
+    const QString elided = elidedText(option,
             keyText,
             Qt::ElideRight,
             columnWidth(index) - rectWidth);
@@ -46,7 +46,7 @@ void KeyDelegate::paintItem(
             option.rect.width() - rectWidth,
             option.rect.height(),
             Qt::AlignVCenter,
-            elidedText);
+            elided);
 
     // Draw a border if the key cell has focus
     if (option.state & QStyle::State_HasFocus) {
@@ -21,9 +21,9 @@ void LocationDelegate::paintItem(
         // }
         painter->setPen(QPen(option.palette.highlightedText().color()));
     }
-    QString elidedText = option.fontMetrics.elidedText(
+    const QString elided = elidedText(option,
             index.data().toString(),
             Qt::ElideLeft,
             columnWidth(index));
-    painter->drawText(option.rect, Qt::AlignVCenter, elidedText);
+    painter->drawText(option.rect, Qt::AlignVCenter, elided);
 }
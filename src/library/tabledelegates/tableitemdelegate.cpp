@@ -6,6 +6,13 @@
 #include "util/painterscope.h"
 #include "widget/wtracktableview.h"
 
+namespace {
+
+// A few screens full of cells
+constexpr int kMaxElidedTexts = 2000;
+
+} // namespace
+
 TableItemDelegate::TableItemDelegate(QTableView* pTableView)
         : QStyledItemDelegate(pTableView),
           m_pTableView(pTableView) {
@@ -81,6 +88,25 @@ int TableItemDelegate::columnWidth(const QModelIndex &index) const {
     return m_pTableView->columnWidth(index.column());
 }
 
+QString TableItemDelegate::elidedText(
+        const QStyleOptionViewItem& option,
+        const QString& text,
+        Qt::TextElideMode mode,
+        int width) const {
+    if (option.font != m_elidedTextFont || m_elidedTexts.size() >= kMaxElidedTexts) {
+        m_elidedTexts.clear();
+        m_elidedTextFont = option.font;
+    }
+    const ElidedTextKey key{text, mode, width};
+    const auto it = m_elidedTexts.constFind(key);
+    if (it != m_elidedTexts.constEnd()) {
+        return it.value();
+    }
+    const QString elided = option.fontMetrics.elidedText(text, mode, width);
+    m_elidedTexts.insert(key, elided);
+    return elided;
+}
+
 void TableItemDelegate::paintItemBackground(
         QPainter* painter,
         const QStyleOptionViewItem& option,
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <QFont>
+#include <QHash>
 #include <QStyledItemDelegate>
 
+#include "util/compatibility/qhash.h"
+
 class QTableView;
 
 class TableItemDelegate : public QStyledItemDelegate {
@@ -36,6 +40,31 @@ class TableItemDelegate : public QStyledItemDelegate {
     // Having this here avoids including QTableView there.
     int columnWidth(const QModelIndex &index) const;
 
+    // Like QFontMetrics::elidedText(), but cached, because the same texts
+    // are elided again on every repaint, e.g. while scrolling
+    QString elidedText(
+            const QStyleOptionViewItem& option,
+            const QString& text,
+            Qt::TextElideMode mode,
+            int width) const;
+
     QColor m_focusBorderColor;
     QTableView* m_pTableView;
+
+  private:
+    struct ElidedTextKey {
+        QString text;
+        Qt::TextElideMode mode;
+        int width;
+
+        bool operator==(const ElidedTextKey& other) const = default;
+
+        friend qhash_seed_t qHash(const ElidedTextKey& key, qhash_seed_t seed = 0) {
+            return qHash(key.text, seed) ^ qHash(key.width, seed) ^
+                    qHash(static_cast<int>(key.mode), seed);
+        }
+    };
+
+    mutable QFont m_elidedTextFont;
+    mutable QHash<ElidedTextKey, QString> m_elidedTexts;
 };
@@ -127,6 +127,18 @@ void TrackCollection::connectTrackSource(QSharedPointer<BaseTrackCache> pTrackSo
             &TrackDAO::tracksRemoved,
             m_pTrackSource.data(),
             &BaseTrackCache::slotTracksRemoved);
+    connect(this,
+            &TrackCollection::crateUpdated,
+            m_pTrackSource.data(),
+            &BaseTrackCache::slotCratesChanged);
+    connect(this,
+            &TrackCollection::crateDeleted,
+            m_pTrackSource.data(),
+            &BaseTrackCache::slotCratesChanged);
+    connect(this,
+            &TrackCollection::crateTracksChanged,
+            m_pTrackSource.data(),
+            &BaseTrackCache::slotCratesChanged);
 }
 
 QWeakPointer<BaseTrackCache> TrackCollection::disconnectTrackSource() {
@@ -559,6 +571,12 @@ bool TrackCollection::saveTrack(Track* pTrack) const {
     return m_trackDao.saveTrack(pTrack);
 }
 
+bool TrackCollection::saveEvictedTrack(Track* pTrack) const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    return m_trackDao.saveEvictedTrack(pTrack);
+}
+
 TrackPointer TrackCollection::getTrackById(
         TrackId trackId) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
@@ -148,6 +148,8 @@ class TrackCollection : public QObject,
             bool* pAlreadyInLibrary = nullptr);
     FRIEND_TEST(DirectoryDAOTest, relocateDirectory);
     FRIEND_TEST(TrackDAOTest, detectMovedTracks);
+    FRIEND_TEST(TrackDAOTest, getAllTrackIds);
+    FRIEND_TEST(TrackDAOTest, maintainsFullTextIndex);
     TrackId addTrack(
             const TrackPointer& pTrack,
             bool unremove);
@@ -164,6 +166,7 @@ class TrackCollection : public QObject,
     DirectoryDAO::RelocateResult relocateDirectory(const QString& oldDir, const QString& newDir);
 
     bool saveTrack(Track* pTrack) const;
+    bool saveEvictedTrack(Track* pTrack) const;
 
     QSqlDatabase m_database;
 
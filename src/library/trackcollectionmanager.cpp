@@ -6,6 +6,9 @@
 #include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
+#include "library/trackmetadataexportqueue.h"
+#include "library/tracktablequerythread.h"
+#include "library/trackwritebehindqueue.h"
 #include "moc_trackcollectionmanager.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -126,9 +129,47 @@ TrackCollectionManager::TrackCollectionManager(
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
     }
+
+    // Tests expect that saved tracks are immediately visible in the database
+    if (deleteTrackForTestingFn) {
+        kLogger.info() << "Write-behind queue is disabled in test mode";
+    } else {
+        m_pWriteBehindQueue = std::make_unique<TrackWriteBehindQueue>(
+                pDbConnectionPool, pConfig);
+        m_pInternalCollection->getTrackDAO().setWriteBehindQueue(
+                m_pWriteBehindQueue.get());
+        kLogger.info() << "Starting write-behind queue thread";
+        m_pWriteBehindQueue->start(QThread::LowPriority);
+
+        m_pMetadataExportQueue = std::make_unique<TrackMetadataExportQueue>(
+                m_pWriteBehindQueue.get());
+        m_pInternalCollection->getTrackDAO().setMetadataExportQueue(
+                m_pMetadataExportQueue.get());
+        kLogger.info() << "Starting metadata export queue thread";
+        // Writing file tags must not compete with the caching readers
+        // for disk bandwidth
+        m_pMetadataExportQueue->start(QThread::IdlePriority);
+    }
+
+    // Tests expect that track tables are populated immediately
+    if (deleteTrackForTestingFn) {
+        kLogger.info() << "Track table query thread is disabled in test mode";
+    } else {
+        m_pTrackTableQueryThread = std::make_unique<TrackTableQueryThread>(
+                pDbConnectionPool);
+        kLogger.info() << "Starting track table query thread";
+        m_pTrackTableQueryThread->start();
+    }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    if (m_pTrackTableQueryThread) {
+        kLogger.info() << "Stopping track table query thread";
+        m_pTrackTableQueryThread->stop();
+        m_pTrackTableQueryThread->wait();
+        m_pTrackTableQueryThread.reset();
+    }
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
@@ -151,6 +192,24 @@ TrackCollectionManager::~TrackCollectionManager() {
     // components are accessing those files at this point.
     GlobalTrackCacheLocker().deactivateCache();
 
+    if (m_pMetadataExportQueue) {
+        // Passes all evicted tracks on to the write-behind queue
+        kLogger.info() << "Stopping metadata export queue thread";
+        m_pMetadataExportQueue->stop();
+        m_pMetadataExportQueue->wait();
+        m_pInternalCollection->getTrackDAO().setMetadataExportQueue(nullptr);
+        m_pMetadataExportQueue.reset();
+    }
+
+    if (m_pWriteBehindQueue) {
+        // Write all evicted tracks before disconnecting the database
+        kLogger.info() << "Stopping write-behind queue thread";
+        m_pWriteBehindQueue->stop();
+        m_pWriteBehindQueue->wait();
+        m_pInternalCollection->getTrackDAO().setWriteBehindQueue(nullptr);
+        m_pWriteBehindQueue.reset();
+    }
+
     for (const auto& externalCollection : std::as_const(m_externalCollections)) {
         kLogger.info()
                 << "Disconnecting from"
@@ -192,24 +251,47 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
 // Export metadata and save the track in both the internal database
 // and external libraries.
 void TrackCollectionManager::saveEvictedTrack(Track* pTrack) noexcept {
-    saveTrack(pTrack, TrackMetadataExportMode::Immediate);
+    saveTrack(pTrack, TrackMetadataExportMode::Immediate, TrackSaveMode::WriteBehind);
 }
 
 TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         Track* pTrack,
-        TrackMetadataExportMode mode) const {
+        TrackMetadataExportMode exportMode,
+        TrackSaveMode saveMode) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return SaveTrackResult::Skipped;
     }
     DEBUG_ASSERT(pTrack->getDateAdded().isValid());
 
+    if (saveMode == TrackSaveMode::WriteBehind &&
+            exportMode == TrackMetadataExportMode::Immediate &&
+            m_pMetadataExportQueue &&
+            pTrack->getId().isValid() &&
+            isTrackMetadataExportRequired(*pTrack) &&
+            m_pMetadataExportQueue->enqueue(*pTrack,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig))) {
+        // Writing file tags might block, e.g. on slow network shares.
+        // The evicted track is written into the database after its
+        // metadata has been exported in the background.
+        kLogger.debug()
+                << "Exporting metadata of evicted track"
+                << pTrack->getLocation()
+                << "in the background";
+        const bool dirty = pTrack->isDirty();
+        pTrack->markClean();
+        if (dirty) {
+            saveTrackInExternalCollections(*pTrack);
+        }
+        return SaveTrackResult::Saved;
+    }
+
     // Export track metadata regardless of the track's clean/dirty
     // status. An unmodified track might have been marked for metadata
     // export by the user or export of metadata was deferred during a
     // previous invocation.
     const auto exportTrackMetadataResult =
-            exportTrackMetadataBeforeSaving(pTrack, mode);
+            exportTrackMetadataBeforeSaving(pTrack, exportMode);
     DEBUG_ASSERT(
             exportTrackMetadataResult != ExportTrackMetadataResult::Succeeded ||
             pTrack->getSourceSynchronizedAt().isValid());
@@ -250,12 +332,17 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
 
     // This operation must be executed synchronously while the cache is
     // locked to prevent that a new track is created from outdated
-    // metadata in the database before saving has finished.
+    // metadata in the database before saving has finished. Evicted
+    // tracks might be written asynchronously, because TrackDAO waits
+    // for them before loading them again.
     kLogger.debug()
             << "Saving track"
             << pTrack->getLocation()
             << "in internal collection";
-    if (!m_pInternalCollection->saveTrack(pTrack)) {
+    const bool saved = saveMode == TrackSaveMode::WriteBehind
+            ? m_pInternalCollection->saveEvictedTrack(pTrack)
+            : m_pInternalCollection->saveTrack(pTrack);
+    if (!saved) {
         // The dirty flag is not reset when saving fails
         DEBUG_ASSERT(pTrack->isDirty());
         return SaveTrackResult::Failed;
@@ -263,24 +350,41 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
     // The dirty flag is reset after the track has been saved successfully
     DEBUG_ASSERT(!pTrack->isDirty());
 
-    if (!m_externalCollections.isEmpty()) {
-        // Track still exists in the internal collection/database
-        kLogger.debug()
-                << "Saving modified track"
-                << pTrack->getLocation()
-                << "in"
-                << m_externalCollections.size()
-                << "external collection(s)";
-        for (const auto& externalTrackCollection : std::as_const(m_externalCollections)) {
-            externalTrackCollection->saveTrack(
-                    *pTrack,
-                    ExternalTrackCollection::ChangeHint::Modified);
-        }
-    }
+    // Track still exists in the internal collection/database
+    saveTrackInExternalCollections(*pTrack);
 
     return SaveTrackResult::Saved;
 }
 
+void TrackCollectionManager::saveTrackInExternalCollections(const Track& track) const {
+    if (m_externalCollections.isEmpty()) {
+        return;
+    }
+    kLogger.debug()
+            << "Saving modified track"
+            << track.getLocation()
+            << "in"
+            << m_externalCollections.size()
+            << "external collection(s)";
+    for (const auto& externalTrackCollection : std::as_const(m_externalCollections)) {
+        externalTrackCollection->saveTrack(
+                track,
+                ExternalTrackCollection::ChangeHint::Modified);
+    }
+}
+
+bool TrackCollectionManager::isTrackMetadataExportRequired(const Track& track) const {
+    // Write audio meta data, if explicitly requested by the user
+    // for individual tracks or enabled in the preferences for all
+    // tracks.
+    return track.isMarkedForMetadataExport() ||
+            (track.isDirty() &&
+                    m_pConfig &&
+                    m_pConfig->getValueString(
+                                     mixxx::library::prefs::kSyncTrackMetadataConfigKey)
+                                    .toInt() == 1);
+}
+
 ExportTrackMetadataResult TrackCollectionManager::exportTrackMetadataBeforeSaving(
         Track* pTrack,
         TrackMetadataExportMode mode) const {
@@ -288,20 +392,11 @@ ExportTrackMetadataResult TrackCollectionManager::exportTrackMetadataBeforeSavin
         return ExportTrackMetadataResult::Skipped;
     }
 
-    // Write audio meta data, if explicitly requested by the user
-    // for individual tracks or enabled in the preferences for all
-    // tracks.
-    //
     // This must be done before updating the database, because
     // a timestamp is used to keep track of when metadata has been
     // last synchronized. Exporting metadata will update this time
     // stamp on the track object!
-    if (pTrack->isMarkedForMetadataExport() ||
-            (pTrack->isDirty() &&
-                    m_pConfig &&
-                    m_pConfig->getValueString(
-                                     mixxx::library::prefs::kSyncTrackMetadataConfigKey)
-                                    .toInt() == 1)) {
+    if (isTrackMetadataExportRequired(*pTrack)) {
         switch (mode) {
         case TrackMetadataExportMode::Immediate: {
             // Export track metadata now by saving as file tags.
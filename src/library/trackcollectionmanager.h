@@ -13,6 +13,9 @@
 #include "util/thread_affinity.h"
 
 class LibraryScanner;
+class TrackTableQueryThread;
+class TrackMetadataExportQueue;
+class TrackWriteBehindQueue;
 class TrackCollection;
 class ExternalTrackCollection;
 class RelocatedTrack;
@@ -47,6 +50,13 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    // Populates track tables in the background. Not available in tests
+    // that expect synchronous updates.
+    TrackTableQueryThread* trackTableQueryThread() const {
+        DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+        return m_pTrackTableQueryThread.get();
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
     TrackPointer getTrackByRef(
@@ -113,12 +123,20 @@ class TrackCollectionManager: public QObject,
         Immediate,
         Deferred,
     };
+    enum class TrackSaveMode {
+        Synchronous,
+        // Only for evicted tracks that are deleted after saving
+        WriteBehind,
+    };
     SaveTrackResult saveTrack(
             Track* pTrack,
-            TrackMetadataExportMode mode) const;
+            TrackMetadataExportMode exportMode,
+            TrackSaveMode saveMode = TrackSaveMode::Synchronous) const;
     ExportTrackMetadataResult exportTrackMetadataBeforeSaving(
             Track* pTrack,
             TrackMetadataExportMode mode) const;
+    bool isTrackMetadataExportRequired(const Track& track) const;
+    void saveTrackInExternalCollections(const Track& track) const;
 
     const UserSettingsPointer m_pConfig;
 
@@ -128,4 +146,11 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    std::unique_ptr<TrackWriteBehindQueue> m_pWriteBehindQueue;
+    // Exports metadata of evicted tracks before passing them on
+    // to m_pWriteBehindQueue
+    std::unique_ptr<TrackMetadataExportQueue> m_pMetadataExportQueue;
+
+    std::unique_ptr<TrackTableQueryThread> m_pTrackTableQueryThread;
 };
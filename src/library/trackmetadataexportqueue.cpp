@@ -0,0 +1,260 @@
+#include "library/trackmetadataexportqueue.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "library/trackwritebehindqueue.h"
+#include "moc_trackmetadataexportqueue.cpp"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackMetadataExportQueue");
+
+// Tracks that are evicted together, e.g. when unloading multiple decks
+// or closing a dialog, should be exported in a single batch.
+constexpr auto kCoalesceDelay = std::chrono::milliseconds(500);
+
+// Files might be locked temporarily by other applications or
+// unavailable while a network share reconnects.
+constexpr auto kRetryDelay = std::chrono::seconds(5);
+
+constexpr int kMaxFailedExports = 3;
+
+// The copy shares the immutable beats and the cue points with the
+// evicted track. It lives in the thread of the evicted track and
+// must be deleted there.
+TrackPointer newDetachedCopy(const Track& track) {
+    auto pCopy = TrackPointer(
+            new Track(track.getFileAccess(), track.getId()),
+            [](Track* pTrack) {
+                pTrack->deleteLater();
+            });
+    pCopy->blockSignals(true);
+    pCopy->replaceRecord(track.getRecord(), track.getBeats());
+    pCopy->setCuePoints(track.getCuePoints());
+    if (track.isMarkedForMetadataExport()) {
+        pCopy->markForMetadataExport();
+    }
+    return pCopy;
+}
+
+} // anonymous namespace
+
+TrackMetadataExportQueue::TrackMetadataExportQueue(
+        TrackWriteBehindQueue* pWriteBehindQueue)
+        : m_pWriteBehindQueue(pWriteBehindQueue),
+          m_flushRequested(false),
+          m_stopRequested(false),
+          m_accepting(false) {
+    DEBUG_ASSERT(m_pWriteBehindQueue);
+    setObjectName(QStringLiteral("TrackMetadataExportQueue"));
+}
+
+TrackMetadataExportQueue::~TrackMetadataExportQueue() {
+    stop();
+    wait();
+}
+
+bool TrackMetadataExportQueue::enqueue(
+        const Track& evictedTrack,
+        const SyncTrackMetadataParams& syncParams) {
+    const TrackId trackId = evictedTrack.getId();
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return false;
+    }
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        if (!m_accepting) {
+            return false;
+        }
+    }
+    // Copy the track outside of the critical section
+    PendingTrack pendingTrack;
+    pendingTrack.snapshot = TrackSnapshot(evictedTrack);
+    pendingTrack.pExportedTrack = newDetachedCopy(evictedTrack);
+    pendingTrack.syncParams = syncParams;
+    pendingTrack.wasDirty = evictedTrack.isDirty();
+    pendingTrack.markedForExport = evictedTrack.isMarkedForMetadataExport();
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        if (!m_accepting) {
+            return false;
+        }
+        pendingTrack.exportAt = Clock::now() + kCoalesceDelay;
+        const auto it = m_pendingTracks.find(trackId);
+        if (it != m_pendingTracks.end()) {
+            // Replaces the outdated snapshot of the same track
+            pendingTrack.wasDirty |= it->wasDirty;
+            pendingTrack.markedForExport |= it->markedForExport;
+            *it = std::move(pendingTrack);
+        } else {
+            m_pendingTracks.insert(trackId, std::move(pendingTrack));
+        }
+    }
+    m_pendingCond.notify_one();
+    return true;
+}
+
+void TrackMetadataExportQueue::flush() {
+    std::unique_lock<std::mutex> locked(m_mutex);
+    flushLocked(&locked);
+}
+
+void TrackMetadataExportQueue::flushTrack(TrackId trackId) {
+    std::unique_lock<std::mutex> locked(m_mutex);
+    if (!m_pendingTracks.contains(trackId) &&
+            !m_exportingTrackIds.contains(trackId)) {
+        return;
+    }
+    kLogger.debug()
+            << "Exporting pending tracks before loading track"
+            << trackId;
+    flushLocked(&locked);
+}
+
+void TrackMetadataExportQueue::flushLocked(std::unique_lock<std::mutex>* pLocked) {
+    DEBUG_ASSERT(QThread::currentThread() != this);
+    while (!m_pendingTracks.isEmpty() || !m_exportingTrackIds.isEmpty()) {
+        m_flushRequested = true;
+        m_pendingCond.notify_one();
+        m_exportedCond.wait(*pLocked);
+    }
+}
+
+void TrackMetadataExportQueue::stop() {
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        m_stopRequested = true;
+        m_accepting = false;
+    }
+    m_pendingCond.notify_one();
+}
+
+void TrackMetadataExportQueue::exportTrack(PendingTrack* pPendingTrack) const {
+    Track* pTrack = pPendingTrack->pExportedTrack.get();
+    if (pPendingTrack->markedForExport) {
+        // The marker is reset by every attempt
+        pTrack->markForMetadataExport();
+    }
+    const auto result = SoundSourceProxy::exportTrackMetadataBeforeSaving(
+            pTrack, pPendingTrack->syncParams);
+    switch (result) {
+    case ExportTrackMetadataResult::Succeeded:
+        DEBUG_ASSERT(pTrack->getSourceSynchronizedAt().isValid());
+        break;
+    case ExportTrackMetadataResult::Skipped:
+        break;
+    case ExportTrackMetadataResult::Failed:
+        if (++pPendingTrack->failedExports < kMaxFailedExports) {
+            return;
+        }
+        kLogger.warning()
+                << "Failed to export track metadata"
+                << pTrack->getLocation();
+        // The metadata in the library could no longer be considered
+        // as synchronized with the source, i.e. with the file tags.
+        pTrack->resetSourceSynchronizedAt();
+        break;
+    }
+    // Finished
+    pPendingTrack->failedExports = 0;
+    if (result == ExportTrackMetadataResult::Skipped &&
+            !pPendingTrack->wasDirty) {
+        // Nothing to save
+        pPendingTrack->snapshot.trackId = TrackId();
+        return;
+    }
+    // Exporting might have updated the record, e.g. the time stamp of
+    // the synchronization or extra metadata that has been merged from
+    // the file tags. All other properties are saved unmodified.
+    pPendingTrack->snapshot.trackRecord = pTrack->getRecord();
+}
+
+void TrackMetadataExportQueue::saveTrack(PendingTrack* pPendingTrack) const {
+    if (!pPendingTrack->snapshot.trackId.isValid()) {
+        return;
+    }
+    const QString location = pPendingTrack->snapshot.location;
+    if (!m_pWriteBehindQueue->enqueue(std::move(pPendingTrack->snapshot))) {
+        // Must never happen, see stop()
+        kLogger.critical()
+                << "Failed to save track"
+                << location
+                << "after exporting metadata";
+    }
+}
+
+void TrackMetadataExportQueue::run() {
+    kLogger.debug() << "Entering thread";
+
+    std::unique_lock<std::mutex> locked(m_mutex);
+    m_accepting = !m_stopRequested;
+    while (true) {
+        if (m_pendingTracks.isEmpty()) {
+            if (m_stopRequested) {
+                break;
+            }
+            m_pendingCond.wait(locked);
+            continue;
+        }
+        const bool exportAll = m_flushRequested || m_stopRequested;
+        const auto now = Clock::now();
+        if (!exportAll) {
+            auto exportAt = Clock::time_point::max();
+            for (const auto& pendingTrack : std::as_const(m_pendingTracks)) {
+                exportAt = std::min(exportAt, pendingTrack.exportAt);
+            }
+            if (now < exportAt) {
+                m_pendingCond.wait_until(locked, exportAt);
+                continue;
+            }
+        }
+
+        // Tracks that have not been tried yet join the batch early,
+        // tracks that failed are only exported when their retry is due.
+        m_flushRequested = false;
+        QHash<TrackId, PendingTrack> exportingTracks;
+        for (auto it = m_pendingTracks.begin(); it != m_pendingTracks.end();) {
+            if (exportAll || it->failedExports == 0 || it->exportAt <= now) {
+                m_exportingTrackIds.insert(it.key());
+                exportingTracks.insert(it.key(), std::move(it.value()));
+                it = m_pendingTracks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        locked.unlock();
+
+        kLogger.debug()
+                << "Exporting metadata of"
+                << exportingTracks.size()
+                << "track(s)";
+        for (auto& pendingTrack : exportingTracks) {
+            exportTrack(&pendingTrack);
+            if (pendingTrack.failedExports == 0) {
+                saveTrack(&pendingTrack);
+            }
+        }
+
+        locked.lock();
+        const auto retryAt = Clock::now() + kRetryDelay;
+        for (auto it = exportingTracks.begin(); it != exportingTracks.end(); ++it) {
+            if (it->failedExports == 0 || m_pendingTracks.contains(it.key())) {
+                // Either finished or superseded by a newer snapshot
+                continue;
+            }
+            it->exportAt = retryAt;
+            m_pendingTracks.insert(it.key(), std::move(it.value()));
+        }
+        m_exportingTrackIds.clear();
+        m_exportedCond.notify_all();
+    }
+    m_accepting = false;
+    locked.unlock();
+
+    kLogger.debug() << "Exiting thread";
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "library/dao/tracksnapshot.h"
+#include "track/track_decl.h"
+
+class TrackWriteBehindQueue;
+
+/// Exports the metadata of evicted tracks into their files on a
+/// background thread.
+///
+/// Writing file tags might block for a long time, e.g. on slow network
+/// shares. The queue runs with the lowest priority to not compete with
+/// the caching readers that decode the audio data for the decks.
+///
+/// Tracks that are evicted in short succession are exported together.
+/// Failed exports are retried after a delay, because they are often
+/// caused by files that are temporarily locked or unavailable. Once the
+/// export has finished the snapshot of each track is passed on to the
+/// TrackWriteBehindQueue. This order is required, because exporting
+/// metadata updates the synchronization time stamp that is stored in
+/// the database.
+///
+/// The queue must be stopped before stopping the TrackWriteBehindQueue,
+/// which exports all pending tracks.
+class TrackMetadataExportQueue : public QThread {
+    Q_OBJECT
+  public:
+    explicit TrackMetadataExportQueue(
+            TrackWriteBehindQueue* pWriteBehindQueue);
+    ~TrackMetadataExportQueue() override;
+
+    /// Returns false if the metadata must be exported synchronously,
+    /// because the thread is not (or no longer) running.
+    ///
+    /// Must be invoked from the thread of the evicted track.
+    bool enqueue(
+            const Track& evictedTrack,
+            const SyncTrackMetadataParams& syncParams);
+
+    /// Blocks until all tracks that have been enqueued so far are
+    /// exported and passed on to the TrackWriteBehindQueue.
+    void flush();
+
+    /// Only blocks while the track is pending.
+    void flushTrack(TrackId trackId);
+
+    /// Exports all pending tracks and exits the thread.
+    void stop();
+
+  protected:
+    void run() override;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingTrack {
+        TrackSnapshot snapshot;
+        // A detached copy of the evicted track that is only
+        // used for exporting the metadata
+        TrackPointer pExportedTrack;
+        SyncTrackMetadataParams syncParams;
+        bool wasDirty = false;
+        bool markedForExport = false;
+        int failedExports = 0;
+        Clock::time_point exportAt;
+    };
+
+    void flushLocked(std::unique_lock<std::mutex>* pLocked);
+    void exportTrack(PendingTrack* pPendingTrack) const;
+    void saveTrack(PendingTrack* pPendingTrack) const;
+
+    TrackWriteBehindQueue* const m_pWriteBehindQueue;
+
+    std::mutex m_mutex;
+    // Wakes up the exporting thread
+    std::condition_variable m_pendingCond;
+    // Wakes up threads that wait for tracks to be exported
+    std::condition_variable m_exportedCond;
+
+    QHash<TrackId, PendingTrack> m_pendingTracks;
+    // The ids of the tracks that are currently exported
+    QSet<TrackId> m_exportingTrackIds;
+    bool m_flushRequested;
+    bool m_stopRequested;
+    // Only while the thread is running and not stopping
+    bool m_accepting;
+};
@@ -187,6 +187,13 @@ class TrackModel {
         Q_UNUSED(sourceIndex);
         Q_UNUSED(destIndex);
     }
+    // Moves the tracks in their current order in front of destIndex
+    // or to the end if destIndex is invalid, all at once.
+    virtual void moveTracks(const QModelIndexList& sourceIndices,
+            const QModelIndex& destIndex) {
+        Q_UNUSED(sourceIndices);
+        Q_UNUSED(destIndex);
+    }
     virtual bool isLocked() {
         return false;
     }
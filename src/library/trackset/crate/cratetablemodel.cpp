@@ -23,6 +23,8 @@ CrateTableModel::CrateTableModel(
                   pParent,
                   pTrackCollectionManager,
                   "mixxx.db.model.crate") {
+    // Large crates would block the GUI while reading them
+    setSelectAsync(true);
 }
 
 void CrateTableModel::selectCrate(CrateId crateId) {
@@ -2,7 +2,7 @@
 
 #include <QDateTime>
 #include <QMenu>
-#include <QSqlTableModel>
+#include <QSqlRecord>
 
 #include "library/library.h"
 #include "library/library_prefs.h"
@@ -240,6 +240,7 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
             "  Playlists.id AS id, "
             "  Playlists.name AS name, "
             "  Playlists.date_created AS date_created, "
+            "  Playlists.locked AS locked, "
             "  LOWER(Playlists.name) AS sort_name, "
             "  max(PlaylistTracks.position) AS count,"
             "  SUM(library.duration) AS durationSeconds "
@@ -261,20 +262,23 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
         LOG_FAILED_QUERY(query);
     }
 
-    // Setup the sidebar playlist model
-    QSqlTableModel playlistTableModel(this, database);
-    playlistTableModel.setTable(m_countsDurationTableName);
-    playlistTableModel.setSort(playlistTableModel.fieldIndex("id"), Qt::DescendingOrder);
-    playlistTableModel.select();
-    while (playlistTableModel.canFetchMore()) {
-        playlistTableModel.fetchMore();
-    }
-    QSqlRecord record = playlistTableModel.record();
-    int nameColumn = record.indexOf("name");
-    int idColumn = record.indexOf("id");
-    int createdColumn = record.indexOf("date_created");
-    int countColumn = record.indexOf("count");
-    int durationColumn = record.indexOf("durationSeconds");
+    // A long history contains thousands of playlists. Iterate over the rows
+    // once instead of caching them in a QSqlTableModel and read the lock
+    // state along with the labels instead of querying it for each playlist.
+    query.setForwardOnly(true);
+    if (!query.exec(QStringLiteral(
+                "SELECT id, name, date_created, locked, count, durationSeconds "
+                "FROM %1 ORDER BY id DESC")
+                        .arg(m_countsDurationTableName))) {
+        LOG_FAILED_QUERY(query);
+    }
+    const QSqlRecord record = query.record();
+    const int nameColumn = record.indexOf("name");
+    const int idColumn = record.indexOf("id");
+    const int createdColumn = record.indexOf("date_created");
+    const int lockedColumn = record.indexOf("locked");
+    const int countColumn = record.indexOf("count");
+    const int durationColumn = record.indexOf("durationSeconds");
 
     // Nice to have: restore previous expanded/collapsed state of YEAR items
     clearChildModel();
@@ -283,26 +287,13 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
     // Generous estimate (number of years the db is used ;))
     itemList.reserve(kNumToplevelHistoryEntries + 15);
 
-    for (int row = 0; row < playlistTableModel.rowCount(); ++row) {
-        int id =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, idColumn))
-                        .toInt();
-        QString name =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, nameColumn))
-                        .toString();
-        QDateTime dateCreated =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, createdColumn))
-                        .toDateTime();
-        int count = playlistTableModel
-                            .data(playlistTableModel.index(row, countColumn))
-                            .toInt();
-        int duration =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, durationColumn))
-                        .toInt();
+    for (int row = 0; query.next(); ++row) {
+        int id = query.value(idColumn).toInt();
+        QString name = query.value(nameColumn).toString();
+        QDateTime dateCreated = query.value(createdColumn).toDateTime();
+        bool locked = query.value(lockedColumn).toBool();
+        int count = query.value(countColumn).toInt();
+        int duration = query.value(durationColumn).toInt();
         QString label = createPlaylistLabel(name, count, duration);
 
         // Create the TreeItem whose parent is the invisible root item.
@@ -329,12 +320,12 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
 
             TreeItem* pItem = pGroupItem->appendChild(label, id);
             pItem->setBold(m_playlistIdsOfSelectedTrack.contains(id));
-            decorateChild(pItem, id);
+            decorateChild(pItem, id, locked);
         } else {
             // add most recent top-level playlist
             auto pItem = std::make_unique<TreeItem>(label, id);
             pItem->setBold(m_playlistIdsOfSelectedTrack.contains(id));
-            decorateChild(pItem.get(), id);
+            decorateChild(pItem.get(), id, locked);
 
             itemList.push_back(std::move(pItem));
         }
@@ -347,9 +338,13 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
 }
 
 void SetlogFeature::decorateChild(TreeItem* item, int playlistId) {
+    decorateChild(item, playlistId, m_playlistDao.isPlaylistLocked(playlistId));
+}
+
+void SetlogFeature::decorateChild(TreeItem* item, int playlistId, bool locked) {
     if (playlistId == m_currentPlaylistId) {
         item->setIcon(QIcon(":/images/library/ic_library_history_current.svg"));
-    } else if (m_playlistDao.isPlaylistLocked(playlistId)) {
+    } else if (locked) {
         item->setIcon(QIcon(":/images/library/ic_library_locked.svg"));
     } else {
         item->setIcon(QIcon());
@@ -46,6 +46,7 @@ class SetlogFeature : public BasePlaylistFeature {
     void slotDeleteAllUnlockedChildPlaylists();
 
   private:
+    void decorateChild(TreeItem* pChild, int playlistId, bool locked);
     void deleteAllUnlockedPlaylistsWithFewerTracks();
     void lockOrUnlockAllChildPlaylists(bool lock);
     QString getRootViewHtml() const override;
@@ -0,0 +1,263 @@
+#include "library/tracktablequerythread.h"
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <algorithm>
+#include <utility>
+
+#include "library/queryutil.h"
+#include "moc_tracktablequerythread.cpp"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackTableQueryThread");
+
+// The first page should fill the visible part of the table
+constexpr int kFirstPageSize = 256;
+
+// Larger pages reduce the number of times the views are updated
+constexpr int kMaxPageSize = 16384;
+
+// SQLite normalizes the statement when storing it in sqlite_temp_master
+const QString kCreateViewPrefix = QStringLiteral("CREATE VIEW ");
+
+} // anonymous namespace
+
+TrackTableQueryThread::TrackTableQueryThread(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_nextQueryId(1),
+          m_runningQueryId(0),
+          m_pRunningReceiver(nullptr),
+          m_stopRequested(false) {
+    setObjectName(QStringLiteral("TrackTableQueryThread"));
+}
+
+TrackTableQueryThread::~TrackTableQueryThread() {
+    stop();
+    wait();
+}
+
+// static
+QString TrackTableQueryThread::temporaryViewSql(
+        const QSqlDatabase& database,
+        const QString& tableName) {
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral(
+            "SELECT sql FROM sqlite_temp_master "
+            "WHERE type='view' AND name=:name"));
+    query.bindValue(QStringLiteral(":name"), tableName);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return QString();
+    }
+    if (!query.next()) {
+        return QString();
+    }
+    return query.value(0).toString();
+}
+
+quint64 TrackTableQueryThread::submit(
+        QObject* pReceiver,
+        Query query,
+        RowsFetchedCallback callback) {
+    DEBUG_ASSERT(pReceiver);
+    DEBUG_ASSERT(callback);
+    quint64 queryId;
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        queryId = m_nextQueryId++;
+        // Replaces the outstanding query of the receiver
+        m_pendingQueries.erase(
+                std::remove_if(
+                        m_pendingQueries.begin(),
+                        m_pendingQueries.end(),
+                        [pReceiver](const PendingQuery& pendingQuery) {
+                            return pendingQuery.pReceiver == pReceiver;
+                        }),
+                m_pendingQueries.end());
+        if (m_pRunningReceiver == pReceiver) {
+            m_runningQueryId = 0;
+        }
+        m_pendingQueries.append(PendingQuery{
+                queryId,
+                pReceiver,
+                std::move(query),
+                std::move(callback)});
+    }
+    m_pendingCond.notify_one();
+    return queryId;
+}
+
+void TrackTableQueryThread::abort(const QObject* pReceiver) {
+    const std::lock_guard<std::mutex> locked(m_mutex);
+    m_pendingQueries.erase(
+            std::remove_if(
+                    m_pendingQueries.begin(),
+                    m_pendingQueries.end(),
+                    [pReceiver](const PendingQuery& pendingQuery) {
+                        return pendingQuery.pReceiver == pReceiver;
+                    }),
+            m_pendingQueries.end());
+    if (m_pRunningReceiver == pReceiver) {
+        m_runningQueryId = 0;
+    }
+}
+
+void TrackTableQueryThread::stop() {
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        m_stopRequested = true;
+        m_pendingQueries.clear();
+        m_runningQueryId = 0;
+    }
+    m_pendingCond.notify_one();
+}
+
+void TrackTableQueryThread::run() {
+    kLogger.debug() << "Entering thread";
+
+    // The thread-local database connection must not be closed
+    // before returning from this function.
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    if (!dbConnection.isOpen()) {
+        kLogger.warning()
+                << "Failed to open database connection, track tables will be "
+                   "populated synchronously";
+    }
+
+    std::unique_lock<std::mutex> locked(m_mutex);
+    while (!m_stopRequested) {
+        if (m_pendingQueries.isEmpty()) {
+            m_pendingCond.wait(locked);
+            continue;
+        }
+        const PendingQuery pendingQuery = m_pendingQueries.takeFirst();
+        m_runningQueryId = pendingQuery.id;
+        m_pRunningReceiver = pendingQuery.pReceiver;
+        locked.unlock();
+        if (dbConnection.isOpen()) {
+            executeQuery(dbConnection, pendingQuery);
+        } else {
+            deliverRows(pendingQuery, Rows(), Status::Failed);
+        }
+        locked.lock();
+        m_runningQueryId = 0;
+        m_pRunningReceiver = nullptr;
+    }
+    locked.unlock();
+
+    kLogger.debug() << "Exiting thread";
+}
+
+bool TrackTableQueryThread::prepareTemporaryView(
+        const QSqlDatabase& database,
+        const Query& query) {
+    if (query.temporaryViewName.isEmpty()) {
+        return true;
+    }
+    if (m_temporaryViews.value(query.temporaryViewName) == query.temporaryViewSql) {
+        // Unchanged since the previous query
+        return true;
+    }
+    m_temporaryViews.remove(query.temporaryViewName);
+    VERIFY_OR_DEBUG_ASSERT(query.temporaryViewSql.startsWith(kCreateViewPrefix)) {
+        return false;
+    }
+
+    // The view might have been created with a different definition
+    QSqlQuery dropQuery(database);
+    if (!dropQuery.exec(QStringLiteral("DROP VIEW IF EXISTS temp.") +
+                query.temporaryViewName)) {
+        LOG_FAILED_QUERY(dropQuery);
+        return false;
+    }
+    QString createSql = query.temporaryViewSql;
+    createSql.replace(0,
+            kCreateViewPrefix.size(),
+            QStringLiteral("CREATE TEMPORARY VIEW "));
+    QSqlQuery createQuery(database);
+    if (!createQuery.exec(createSql)) {
+        // Expected if the view depends on other temporary objects
+        kLogger.debug()
+                << "Failed to create temporary view"
+                << query.temporaryViewName
+                << createQuery.lastError();
+        return false;
+    }
+    m_temporaryViews.insert(query.temporaryViewName, query.temporaryViewSql);
+    return true;
+}
+
+void TrackTableQueryThread::executeQuery(
+        const QSqlDatabase& database,
+        const PendingQuery& pendingQuery) {
+    if (!prepareTemporaryView(database, pendingQuery.query)) {
+        deliverRows(pendingQuery, Rows(), Status::Failed);
+        return;
+    }
+
+    QSqlQuery query(database);
+    // Don't cache the results, they are only read once
+    query.setForwardOnly(true);
+    if (!query.prepare(pendingQuery.query.queryString) || !query.exec()) {
+        LOG_FAILED_QUERY(query);
+        deliverRows(pendingQuery, Rows(), Status::Failed);
+        return;
+    }
+
+    const int columnCount = query.record().count();
+    int pageSize = kFirstPageSize;
+    Rows rows;
+    rows.reserve(pageSize);
+    while (query.next()) {
+        QVector<QVariant> columnValues;
+        columnValues.reserve(columnCount);
+        for (int i = 0; i < columnCount; ++i) {
+            columnValues.push_back(query.value(i));
+        }
+        rows.push_back(std::move(columnValues));
+        if (rows.size() >= pageSize) {
+            if (!deliverRows(pendingQuery, std::move(rows), Status::Fetching)) {
+                // Aborted
+                return;
+            }
+            pageSize = std::min(2 * pageSize, kMaxPageSize);
+            rows = Rows();
+            rows.reserve(pageSize);
+        }
+    }
+    if (query.lastError().isValid()) {
+        LOG_FAILED_QUERY(query);
+        deliverRows(pendingQuery, Rows(), Status::Failed);
+        return;
+    }
+    deliverRows(pendingQuery, std::move(rows), Status::Complete);
+}
+
+bool TrackTableQueryThread::deliverRows(
+        const PendingQuery& pendingQuery,
+        Rows rows,
+        Status status) {
+    const std::lock_guard<std::mutex> locked(m_mutex);
+    if (m_runningQueryId != pendingQuery.id) {
+        return false;
+    }
+    // The receiver is not destroyed while holding the lock, see abort().
+    // Pending events are discarded when it is destroyed afterwards.
+    QMetaObject::invokeMethod(
+            pendingQuery.pReceiver,
+            [callback = pendingQuery.callback,
+                    queryId = pendingQuery.id,
+                    rows = std::move(rows),
+                    status]() mutable {
+                callback(queryId, std::move(rows), status);
+            },
+            Qt::QueuedConnection);
+    return true;
+}
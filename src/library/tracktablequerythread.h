@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QThread>
+#include <QVariant>
+#include <QVector>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "util/db/dbconnectionpool.h"
+
+/// Runs the queries that populate track tables on a pooled database
+/// connection, so that opening a large crate or the whole library
+/// doesn't block the GUI thread.
+///
+/// The rows are delivered in pages of increasing size to the thread of
+/// the receiver. The first rows could be shown immediately while the
+/// remaining rows are still fetched.
+///
+/// Only the latest query of each receiver is executed. Submitting
+/// another query or aborting discards the outstanding query of the
+/// receiver, including all pages that have not been delivered yet.
+class TrackTableQueryThread : public QThread {
+    Q_OBJECT
+  public:
+    using Rows = QVector<QVector<QVariant>>;
+
+    enum class Status {
+        /// More rows will follow
+        Fetching,
+        /// These are the last rows
+        Complete,
+        /// The query needs to be executed synchronously by the receiver,
+        /// e.g. if it depends on objects that are only available on the
+        /// connection of the receiver.
+        Failed,
+    };
+
+    /// Invoked on the thread of the receiver with the id returned by
+    /// submit()
+    using RowsFetchedCallback = std::function<void(
+            quint64 queryId, Rows rows, Status status)>;
+
+    struct Query {
+        /// A SELECT statement
+        QString queryString;
+        /// The table that is queried if it is a temporary view, that only
+        /// exists on the connection of the receiver.
+        QString temporaryViewName;
+        /// The CREATE VIEW statement as stored in sqlite_temp_master
+        QString temporaryViewSql;
+    };
+
+    explicit TrackTableQueryThread(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~TrackTableQueryThread() override;
+
+    /// Reads the definition of the temporary view from the connection
+    /// of the receiver. Returns an empty string if the table is not a
+    /// temporary view.
+    static QString temporaryViewSql(
+            const QSqlDatabase& database,
+            const QString& tableName);
+
+    /// Returns an id that is invalidated by the next query or abort of
+    /// the receiver.
+    quint64 submit(
+            QObject* pReceiver,
+            Query query,
+            RowsFetchedCallback callback);
+
+    /// No more rows are delivered to the receiver afterwards, except for
+    /// those that are already pending in its event queue. Must be invoked
+    /// before destroying the receiver.
+    void abort(const QObject* pReceiver);
+
+    /// Discards all outstanding queries and exits the thread.
+    void stop();
+
+  protected:
+    void run() override;
+
+  private:
+    struct PendingQuery {
+        quint64 id;
+        QObject* pReceiver;
+        Query query;
+        RowsFetchedCallback callback;
+    };
+
+    bool prepareTemporaryView(
+            const QSqlDatabase& database,
+            const Query& query);
+    void executeQuery(
+            const QSqlDatabase& database,
+            const PendingQuery& pendingQuery);
+    // Returns false if the query has been aborted
+    bool deliverRows(
+            const PendingQuery& pendingQuery,
+            Rows rows,
+            Status status);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    std::mutex m_mutex;
+    std::condition_variable m_pendingCond;
+    QList<PendingQuery> m_pendingQueries;
+    quint64 m_nextQueryId;
+    // The id of the query that is currently executed or 0 if it has
+    // been aborted
+    quint64 m_runningQueryId;
+    const QObject* m_pRunningReceiver;
+    bool m_stopRequested;
+
+    // Only accessed by this thread
+    QHash<QString, QString> m_temporaryViews;
+};
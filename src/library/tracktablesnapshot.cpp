@@ -0,0 +1,69 @@
+#include "library/tracktablesnapshot.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackTableSnapshot");
+
+constexpr quint32 kSnapshotFileMagic = 0x4d585453; // "MXTS"
+// Must be incremented whenever the serialization changes
+constexpr quint32 kSnapshotFileVersion = 1;
+constexpr QDataStream::Version kSnapshotStreamVersion = QDataStream::Qt_5_15;
+
+} // namespace
+
+// static
+TrackTableSnapshot TrackTableSnapshot::read(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not an error, the snapshot is written when Mixxx is closed
+        return {};
+    }
+    QDataStream stream(&file);
+    stream.setVersion(kSnapshotStreamVersion);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != kSnapshotFileMagic || version != kSnapshotFileVersion) {
+        kLogger.info() << "Ignoring outdated snapshot file" << filePath;
+        return {};
+    }
+    TrackTableSnapshot snapshot;
+    stream >> snapshot.modelKey >> snapshot.orderBy >> snapshot.columns >> snapshot.rows;
+    if (stream.status() != QDataStream::Ok) {
+        kLogger.warning() << "Ignoring corrupt snapshot file" << filePath;
+        return {};
+    }
+    for (const auto& row : std::as_const(snapshot.rows)) {
+        if (row.size() != snapshot.columns.size()) {
+            kLogger.warning() << "Ignoring corrupt snapshot file" << filePath;
+            return {};
+        }
+    }
+    return snapshot;
+}
+
+bool TrackTableSnapshot::write(const QString& filePath) const {
+    // Never leave a partially written snapshot behind
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to write snapshot file" << filePath
+                          << file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(kSnapshotStreamVersion);
+    stream << kSnapshotFileMagic << kSnapshotFileVersion
+           << modelKey << orderBy << columns << rows;
+    if (!file.commit()) {
+        kLogger.warning() << "Failed to write snapshot file" << filePath
+                          << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+/// The first rows of a track table as they have been shown when Mixxx was
+/// closed. They are shown at startup until the model has fetched the actual
+/// rows, which requires to build the index of the track source first.
+///
+/// A snapshot is only valid for the model state it has been taken from,
+/// i.e. for the same table, search, sort order and columns.
+struct TrackTableSnapshot {
+    /// See BaseSqlTableModel::modelKey()
+    QString modelKey;
+    QString orderBy;
+    /// The names of all columns of the model, in the order of the values
+    QStringList columns;
+    QList<QVector<QVariant>> rows;
+
+    bool isEmpty() const {
+        return rows.isEmpty();
+    }
+
+    /// Returns an empty snapshot if the file doesn't exist or is invalid
+    static TrackTableSnapshot read(const QString& filePath);
+    /// Replaces the file atomically. Returns false on failure.
+    bool write(const QString& filePath) const;
+};
@@ -0,0 +1,207 @@
+#include "library/trackwritebehindqueue.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "library/dao/analysisdao.h"
+#include "library/dao/cuedao.h"
+#include "library/dao/libraryhashdao.h"
+#include "library/dao/playlistdao.h"
+#include "library/dao/trackdao.h"
+#include "moc_trackwritebehindqueue.cpp"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackWriteBehindQueue");
+
+// Tracks that are evicted together, e.g. when unloading multiple decks
+// or closing a dialog, should be written in a single transaction.
+constexpr auto kCoalesceDelay = std::chrono::milliseconds(200);
+
+constexpr auto kMaxLatency =
+        std::chrono::milliseconds(TrackWriteBehindQueue::kMaxLatencyMillis);
+
+// Writing fails if the database stays locked by another connection,
+// e.g. by a running library scan.
+constexpr int kMaxFailedWrites = 3;
+
+} // anonymous namespace
+
+TrackWriteBehindQueue::TrackWriteBehindQueue(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        UserSettingsPointer pConfig)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(std::move(pConfig)),
+          m_flushRequested(false),
+          m_stopRequested(false),
+          m_accepting(false) {
+    setObjectName(QStringLiteral("TrackWriteBehindQueue"));
+}
+
+TrackWriteBehindQueue::~TrackWriteBehindQueue() {
+    stop();
+    wait();
+}
+
+bool TrackWriteBehindQueue::enqueue(TrackSnapshot snapshot) {
+    const TrackId trackId = snapshot.trackId;
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return false;
+    }
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        if (!m_accepting) {
+            return false;
+        }
+        const auto now = Clock::now();
+        if (m_pendingTracks.isEmpty()) {
+            m_oldestPendingAt = now;
+        }
+        m_latestPendingAt = now;
+        // Replaces the outdated snapshot of the same track
+        PendingTrack& pendingTrack = m_pendingTracks[trackId];
+        pendingTrack.snapshot = std::move(snapshot);
+        pendingTrack.failedWrites = 0;
+    }
+    m_pendingCond.notify_one();
+    return true;
+}
+
+void TrackWriteBehindQueue::flush() {
+    std::unique_lock<std::mutex> locked(m_mutex);
+    flushLocked(&locked);
+}
+
+void TrackWriteBehindQueue::flushTrack(TrackId trackId) {
+    std::unique_lock<std::mutex> locked(m_mutex);
+    if (!m_pendingTracks.contains(trackId) &&
+            !m_writingTrackIds.contains(trackId)) {
+        return;
+    }
+    kLogger.debug()
+            << "Writing pending tracks before loading track"
+            << trackId;
+    flushLocked(&locked);
+}
+
+void TrackWriteBehindQueue::flushLocked(std::unique_lock<std::mutex>* pLocked) {
+    DEBUG_ASSERT(QThread::currentThread() != this);
+    while (!m_pendingTracks.isEmpty() || !m_writingTrackIds.isEmpty()) {
+        m_flushRequested = true;
+        m_pendingCond.notify_one();
+        m_writtenCond.wait(*pLocked);
+    }
+}
+
+void TrackWriteBehindQueue::stop() {
+    {
+        const std::lock_guard<std::mutex> locked(m_mutex);
+        m_stopRequested = true;
+        m_accepting = false;
+    }
+    m_pendingCond.notify_one();
+}
+
+void TrackWriteBehindQueue::run() {
+    kLogger.debug() << "Entering thread";
+
+    // The thread-local database connection must not be closed
+    // before returning from this function.
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    if (!dbConnection.isOpen()) {
+        kLogger.warning()
+                << "Failed to open database connection, tracks will be saved synchronously";
+        kLogger.debug() << "Exiting thread";
+        return;
+    }
+
+    // Only the DAOs that are needed for updating tracks are initialized
+    LibraryHashDAO libraryHashDao;
+    CueDAO cueDao;
+    PlaylistDAO playlistDao;
+    AnalysisDao analysisDao(m_pConfig);
+    TrackDAO trackDao(cueDao, playlistDao, analysisDao, libraryHashDao, m_pConfig);
+    cueDao.initialize(dbConnection);
+    analysisDao.initialize(dbConnection);
+    trackDao.initialize(dbConnection);
+
+    std::unique_lock<std::mutex> locked(m_mutex);
+    m_accepting = !m_stopRequested;
+    while (true) {
+        if (m_pendingTracks.isEmpty()) {
+            if (m_stopRequested) {
+                break;
+            }
+            m_pendingCond.wait(locked);
+            continue;
+        }
+        if (!m_flushRequested && !m_stopRequested) {
+            // Give more tracks the chance to join this transaction
+            const auto writeAt = std::min(
+                    m_oldestPendingAt + kMaxLatency,
+                    m_latestPendingAt + kCoalesceDelay);
+            if (Clock::now() < writeAt) {
+                m_pendingCond.wait_until(locked, writeAt);
+                continue;
+            }
+        }
+
+        QHash<TrackId, PendingTrack> writingTracks;
+        writingTracks.swap(m_pendingTracks);
+        m_flushRequested = false;
+        DEBUG_ASSERT(m_writingTrackIds.isEmpty());
+        m_writingTrackIds.reserve(writingTracks.size());
+        QList<TrackSnapshot> snapshots;
+        snapshots.reserve(writingTracks.size());
+        for (auto it = writingTracks.constBegin(); it != writingTracks.constEnd(); ++it) {
+            m_writingTrackIds.insert(it.key());
+            snapshots.append(it.value().snapshot);
+        }
+        locked.unlock();
+
+        kLogger.debug()
+                << "Writing"
+                << snapshots.size()
+                << "track(s)";
+        QSet<TrackId> savedTrackIds;
+        const bool written = trackDao.updateTracks(snapshots, &savedTrackIds);
+        snapshots.clear();
+        if (written && !savedTrackIds.isEmpty()) {
+            emit tracksSaved(savedTrackIds);
+        }
+
+        locked.lock();
+        if (!written) {
+            const bool wasEmpty = m_pendingTracks.isEmpty();
+            for (auto it = writingTracks.begin(); it != writingTracks.end(); ++it) {
+                if (m_pendingTracks.contains(it.key())) {
+                    // Superseded by a newer snapshot
+                    continue;
+                }
+                if (++it.value().failedWrites >= kMaxFailedWrites) {
+                    kLogger.warning()
+                            << "Failed to save track"
+                            << it.key()
+                            << it.value().snapshot.location;
+                    continue;
+                }
+                m_pendingTracks.insert(it.key(), std::move(it.value()));
+            }
+            if (wasEmpty && !m_pendingTracks.isEmpty()) {
+                m_oldestPendingAt = Clock::now();
+            }
+            m_latestPendingAt = Clock::now();
+        }
+        m_writingTrackIds.clear();
+        m_writtenCond.notify_all();
+    }
+    m_accepting = false;
+    locked.unlock();
+
+    kLogger.debug() << "Exiting thread";
+}
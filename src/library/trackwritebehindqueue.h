@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "library/dao/tracksnapshot.h"
+#include "preferences/usersettings.h"
+#include "util/db/dbconnectionpool.h"
+
+/// Writes evicted tracks into the database on a background thread.
+///
+/// Snapshots of the same track replace each other while they are
+/// pending. Snapshots that are enqueued in short succession, e.g. when
+/// multiple decks are unloaded at once, are written together in a single
+/// transaction. Each snapshot is written at most kMaxLatencyMillis after
+/// it has been enqueued, unless the database is locked.
+///
+/// The queue must be stopped before disconnecting the database, which
+/// writes all pending snapshots.
+class TrackWriteBehindQueue : public QThread {
+    Q_OBJECT
+  public:
+    static constexpr int kMaxLatencyMillis = 1000;
+
+    TrackWriteBehindQueue(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            UserSettingsPointer pConfig);
+    ~TrackWriteBehindQueue() override;
+
+    /// Returns false if the snapshot must be written synchronously,
+    /// because the thread is not (or no longer) running.
+    bool enqueue(TrackSnapshot snapshot);
+
+    /// Blocks until all snapshots that have been enqueued so far are
+    /// written.
+    void flush();
+
+    /// Only blocks while a snapshot of the track is pending.
+    void flushTrack(TrackId trackId);
+
+    /// Writes all pending snapshots and exits the thread.
+    void stop();
+
+  signals:
+    void tracksSaved(const QSet<TrackId>& trackIds);
+
+  protected:
+    void run() override;
+
+  private:
+    struct PendingTrack {
+        TrackSnapshot snapshot;
+        int failedWrites = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    void flushLocked(std::unique_lock<std::mutex>* pLocked);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
+
+    std::mutex m_mutex;
+    // Wakes up the writing thread
+    std::condition_variable m_pendingCond;
+    // Wakes up threads that wait for snapshots to be written
+    std::condition_variable m_writtenCond;
+
+    QHash<TrackId, PendingTrack> m_pendingTracks;
+    // The ids of the snapshots that are currently written
+    QSet<TrackId> m_writingTrackIds;
+    Clock::time_point m_oldestPendingAt;
+    Clock::time_point m_latestPendingAt;
+    bool m_flushRequested;
+    bool m_stopRequested;
+    // Only while the thread is running and not stopping
+    bool m_accepting;
+};
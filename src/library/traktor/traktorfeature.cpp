@@ -109,17 +109,6 @@ TraktorFeature::TraktorFeature(Library* pLibrary, UserSettingsPointer pConfig)
 
     m_title = tr("Traktor");
 
-    m_database =
-            QSqlDatabase::cloneDatabase(pLibrary->trackCollectionManager()
-                                                ->internalCollection()
-                                                ->database(),
-                    "TRAKTOR_SCANNER");
-
-    //Open the database connection in this thread.
-    if (!m_database.open()) {
-        qDebug() << "Failed to open database for iTunes scanner."
-                 << m_database.lastError();
-    }
     connect(&m_future_watcher,
             &QFutureWatcher<TreeItem*>::finished,
             this,
@@ -129,9 +118,9 @@ TraktorFeature::TraktorFeature(Library* pLibrary, UserSettingsPointer pConfig)
 }
 
 TraktorFeature::~TraktorFeature() {
-    m_database.close();
     m_cancelImport = true;
     m_future.waitForFinished();
+    m_database.close();
     delete m_pTraktorTableModel;
     delete m_pTraktorPlaylistModel;
 }
@@ -164,6 +153,7 @@ void TraktorFeature::activate() {
 
     if (!m_isActivated) {
         m_isActivated =  true;
+        openWorkerDatabase(&m_database, QStringLiteral("TRAKTOR_SCANNER"));
         // Let a worker thread do the XML parsing
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
         m_future = QtConcurrent::run(&TraktorFeature::importLibrary,
@@ -233,6 +223,9 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     bool inPlaylistsTag = false;
     bool isRootFolderParsed = false;
     int nAudioFiles = 0;
+    // The ids of the inserted tracks by location for resolving the playlist
+    // entries without querying the database for each of them
+    QHash<QString, int> trackIdsByLocation;
 
     while (!xml.atEnd() && !m_cancelImport) {
         xml.readNext();
@@ -243,7 +236,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
             // Each "ENTRY" tag in <COLLECTION> represents a track
             if (inCollectionTag && xml.name() == QLatin1String("ENTRY")) {
                 //parse track
-                parseTrack(xml, query);
+                parseTrack(xml, query, &trackIdsByLocation);
                 ++nAudioFiles; //increment number of files in the music collection
             }
             if (xml.name() == QLatin1String("PLAYLISTS")) {
@@ -256,7 +249,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
 
                 if (nodetype == "FOLDER" && name == "$ROOT") {
                     //process all playlists
-                    root = parsePlaylists(xml);
+                    root = parsePlaylists(xml, trackIdsByLocation);
                     isRootFolderParsed = true;
                 }
             }
@@ -286,7 +279,9 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     return root;
 }
 
-void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
+void TraktorFeature::parseTrack(QXmlStreamReader& xml,
+        QSqlQuery& query,
+        QHash<QString, int>* pTrackIdsByLocation) {
     QString title;
     QString artist;
     QString album;
@@ -404,6 +399,7 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
                  << __LINE__ << " " << query.lastError();
         return;
     }
+    pTrackIdsByLocation->insert(location, query.lastInsertId().toInt());
 }
 
 // Purpose: Parsing all the folder and playlists of Traktor
@@ -411,7 +407,8 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
 // A folder can contain folders and playlists. A playlist contains entries but no folders.
 // In other words, Traktor uses a tree structure to organize music.
 // Inner nodes represent folders while leaves are playlists.
-TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
+TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader& xml,
+        const QHash<QString, int>& trackIdsByLocation) {
 
     qDebug() << "Process RootFolder";
     //Each playlist is unique and can be identified by a path in the tree structure.
@@ -459,8 +456,9 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
                     // process all the entries within the playlist 'name' having path 'current_path'
                     parsePlaylistEntries(xml,
                             current_path,
-                            std::move(query_insert_to_playlists),
-                            std::move(query_insert_to_playlist_tracks));
+                            trackIdsByLocation,
+                            query_insert_to_playlists,
+                            query_insert_to_playlist_tracks);
                 }
             }
         }
@@ -489,8 +487,9 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
 void TraktorFeature::parsePlaylistEntries(
         QXmlStreamReader& xml,
         const QString& playlist_path,
-        QSqlQuery query_insert_into_playlist,
-        QSqlQuery query_insert_into_playlisttracks) {
+        const QHash<QString, int>& trackIdsByLocation,
+        QSqlQuery& query_insert_into_playlist,
+        QSqlQuery& query_insert_into_playlisttracks) {
     // In the database, the name of a playlist is specified by the unique path,
     // e.g., /someFolderA/someFolderB/playlistA"
     query_insert_into_playlist.bindValue(":name", playlist_path);
@@ -502,23 +501,7 @@ void TraktorFeature::parsePlaylistEntries(
         return;
     }
 
-    // Get playlist id
-    QSqlQuery id_query(m_database);
-    id_query.prepare("select id from traktor_playlists where name=:path");
-    id_query.bindValue(":path", playlist_path);
-
-    if (!id_query.exec()) {
-        LOG_FAILED_QUERY(id_query) << "Could not get inserted playlist id for Traktor playlist::"
-                                   << playlist_path;
-        return;
-    }
-
-    //playlist_id = id_query.lastInsertId().toInt();
-    int playlist_id = kInvalidPlaylistId;
-    const int idColumn = id_query.record().indexOf("id");
-    while (id_query.next()) {
-        playlist_id = id_query.value(idColumn).toInt();
-    }
+    const int playlist_id = query_insert_into_playlist.lastInsertId().toInt();
 
     int playlist_position = 1;
     while (!xml.atEnd() && !m_cancelImport) {
@@ -536,20 +519,7 @@ void TraktorFeature::parsePlaylistEntries(
                     #endif
 
                     //insert to database
-                    int track_id = -1;
-                    QSqlQuery finder_query(m_database);
-                    finder_query.prepare("select id from traktor_library where location=:path");
-                    finder_query.bindValue(":path", key);
-
-                    if (!finder_query.exec()) {
-                        LOG_FAILED_QUERY(finder_query) << "Could not get track id:" << key;
-                        continue;
-                    }
-
-                    if (finder_query.next()) {
-                        track_id = finder_query.value(finder_query.record().indexOf("id")).toInt();
-                    }
-
+                    const int track_id = trackIdsByLocation.value(key, -1);
                     query_insert_into_playlisttracks.bindValue(":playlist_id", playlist_id);
                     query_insert_into_playlisttracks.bindValue(":track_id", track_id);
                     query_insert_into_playlisttracks.bindValue(":position", playlist_position++);
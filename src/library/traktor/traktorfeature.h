@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 #include <QFuture>
@@ -51,14 +52,19 @@ class TraktorFeature : public BaseExternalLibraryFeature {
             const QString& playlist) override;
     TreeItem* importLibrary(const QString& file);
     // parses a track in the music collection
-    void parseTrack(QXmlStreamReader &xml, QSqlQuery &query);
+    // and adds the id of the inserted track to pTrackIdsByLocation
+    void parseTrack(QXmlStreamReader& xml,
+            QSqlQuery& query,
+            QHash<QString, int>* pTrackIdsByLocation);
     // Iterates over all playliost and folders and constructs the childmodel
-    TreeItem* parsePlaylists(QXmlStreamReader &xml);
+    TreeItem* parsePlaylists(QXmlStreamReader& xml,
+            const QHash<QString, int>& trackIdsByLocation);
     // processes a particular playlist
     void parsePlaylistEntries(QXmlStreamReader& xml,
             const QString& playlist_path,
-            QSqlQuery query_insert_into_playlist,
-            QSqlQuery query_insert_into_playlisttracks);
+            const QHash<QString, int>& trackIdsByLocation,
+            QSqlQuery& query_insert_into_playlist,
+            QSqlQuery& query_insert_into_playlisttracks);
     void clearTable(const QString& table_name);
     static QString getTraktorMusicDatabase();
     // private fields
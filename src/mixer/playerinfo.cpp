@@ -7,6 +7,7 @@
 #include "moc_playerinfo.cpp"
 #include "track/track.h"
 #include "util/compatibility/qmutex.h"
+#include "util/realtime.h"
 
 namespace {
 
@@ -179,6 +180,7 @@ void PlayerInfo::updateCurrentPlayingDeck() {
 
     int oldDeck = m_currentlyPlayingDeck.fetchAndStoreRelease(maxDeck);
     if (maxDeck != oldDeck) {
+        mixxx::realtime::setDeckPlaying(maxDeck >= 0);
         emit currentPlayingDeckChanged(maxDeck);
         // Note: When starting Auto-DJ "play" might be processed before a new
         // is track is fully loaded. currentPlayingTrackChanged() is then emitted
@@ -5,6 +5,7 @@
 #include "audio/types.h"
 #include "control/controlobject.h"
 #include "effects/effectsmanager.h"
+#include "engine/cachingreader/cachingreadertrackheadsource.h"
 #include "engine/channels/enginedeck.h"
 #include "engine/enginemixer.h"
 #include "library/library.h"
@@ -167,6 +168,8 @@ PlayerManager::~PlayerManager() {
         m_pTrackAnalysisScheduler->stop();
         m_pTrackAnalysisScheduler.reset();
     }
+    // Release the tracks of pending requests
+    CachingReaderTrackHeadSource::stopDecoding();
 }
 
 void PlayerManager::bindToLibrary(Library* pLibrary) {
@@ -181,6 +184,10 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
             &PlayerManager::loadLocationToPlayer,
             pLibrary,
             &Library::slotLoadLocationToPlayer);
+    connect(pLibrary,
+            &Library::trackSelected,
+            this,
+            &PlayerManager::slotPrepareTrackPreview);
 
     DEBUG_ASSERT(!m_pTrackAnalysisScheduler);
     m_pTrackAnalysisScheduler = pLibrary->createTrackAnalysisScheduler(
@@ -195,7 +202,7 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
     // Connect the player to the analyzer queue so that loaded tracks are
     // analyzed.
     foreach(Deck* pDeck, m_decks) {
-        connect(pDeck, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeTrack);
+        connect(pDeck, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeDeckTrack);
     }
 
     // Connect the player to the analyzer queue so that loaded tracks are
@@ -429,7 +436,7 @@ void PlayerManager::addDeckInner() {
         connect(pDeck,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzeDeckTrack);
     }
 
     m_players[handleGroup.handle()] = pDeck;
@@ -821,11 +828,34 @@ void PlayerManager::slotLoadTrackIntoNextAvailableSampler(TrackPointer pTrack) {
 }
 
 void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
+    analyzeTrack(track, TrackAnalysisScheduler::Priority::Normal);
+}
+
+void PlayerManager::slotAnalyzeDeckTrack(TrackPointer track) {
+    analyzeTrack(track, TrackAnalysisScheduler::Priority::High);
+}
+
+void PlayerManager::slotPrepareTrackPreview(TrackPointer pTrack) {
+    if (!pTrack || numPreviewDecks() == 0) {
+        return;
+    }
+    // The parameters of the CachingReader of a preview deck
+    CachingReaderTrackHeadSource::decodeInBackground(std::move(pTrack),
+            mixxx::AudioSource::OpenParams(
+                    mixxx::audio::ChannelCount::stereo(),
+                    mixxx::audio::SampleRate()));
+}
+
+void PlayerManager::analyzeTrack(TrackPointer track, TrackAnalysisScheduler::Priority priority) {
     VERIFY_OR_DEBUG_ASSERT(track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId())) {
+        AnalyzerTrack::Options options;
+        // The overview of a deck should appear immediately
+        options.previewWaveform = priority == TrackAnalysisScheduler::Priority::High;
+        if (m_pTrackAnalysisScheduler->scheduleTrack(
+                    AnalyzerScheduledTrack(track->getId(), options), priority)) {
             m_pTrackAnalysisScheduler->resume();
         }
         // The first progress signal will suspend a running batch analysis
@@ -232,6 +232,11 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
 
   private slots:
     void slotAnalyzeTrack(TrackPointer track);
+    // Tracks loaded into a deck are analyzed before all others
+    void slotAnalyzeDeckTrack(TrackPointer track);
+    // Decodes the start of a track that has been selected in the library
+    // so that it can be previewed immediately
+    void slotPrepareTrackPreview(TrackPointer pTrack);
 
     void onTrackAnalysisProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
     void onTrackAnalysisFinished();
@@ -264,6 +269,7 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
 
   private:
     TrackPointer lookupTrack(QString location);
+    void analyzeTrack(TrackPointer track, TrackAnalysisScheduler::Priority priority);
     // Must hold m_mutex before calling this method. Internal method that
     // creates a new deck.
     void addDeckInner();
@@ -0,0 +1,269 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <QtDebug>
+#include <memory>
+
+#include "analyzer/analyzerscheduledtrack.h"
+#include "analyzer/trackanalysisscheduler.h"
+#include "config.h"
+#include "control/controlobject.h"
+#include "database/mixxxdb.h"
+#include "database/schemamanager.h"
+#include "library/dao/trackdao.h"
+#include "library/library_prefs.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
+#include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/logger.h"
+#include "util/logging.h"
+#include "util/performancetimer.h"
+#include "util/versionstore.h"
+
+// Analyzes all tracks of an existing Mixxx library without creating any
+// widgets, skins, sound devices or the engine. The results are stored in the
+// database and can be used by Mixxx instances that share this database.
+
+namespace {
+
+const mixxx::Logger kLogger("mixxx-analyze");
+
+// Exit codes
+constexpr int kSuccessExitCode = 0;
+constexpr int kAnalysisErrorExitCode = 1;
+constexpr int kParseCmdlineArgsErrorExitCode = 2;
+
+const QString kDefaultDbFileName = QStringLiteral("mixxxdb.sqlite");
+
+class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TrackAnalysisSchedulerEnvironmentImpl(
+            const TrackCollectionManager* pTrackCollectionManager)
+            : m_pTrackCollectionManager(pTrackCollectionManager) {
+        DEBUG_ASSERT(m_pTrackCollectionManager);
+    }
+    ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
+
+    TrackPointer loadTrackById(TrackId trackId) const final {
+        return m_pTrackCollectionManager->getTrackById(trackId);
+    }
+
+  private:
+    const TrackCollectionManager* const m_pTrackCollectionManager;
+};
+
+// MixxxDb::initDatabaseSchema() reports errors in message boxes that
+// can't be displayed without a QApplication.
+bool initDatabaseSchema(const QSqlDatabase& database) {
+    switch (SchemaManager(database).upgradeToSchemaVersion(
+            MixxxDb::kRequiredSchemaVersion, MixxxDb::kDefaultSchemaFile)) {
+    case SchemaManager::Result::CurrentVersion:
+    case SchemaManager::Result::UpgradeSucceeded:
+    case SchemaManager::Result::NewerVersionBackwardsCompatible:
+        return true;
+    case SchemaManager::Result::UpgradeFailed:
+        kLogger.critical() << "Failed to upgrade the database schema to version"
+                           << MixxxDb::kRequiredSchemaVersion;
+        return false;
+    case SchemaManager::Result::NewerVersionIncompatible:
+        kLogger.critical() << "The database has been created by a newer, "
+                              "incompatible version of Mixxx";
+        return false;
+    case SchemaManager::Result::SchemaError:
+        kLogger.critical() << "Failed to load the database schema";
+        return false;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return false;
+}
+
+// Accepts either the settings directory or the database file within
+// the settings directory. MixxxDb expects the database next to mixxx.cfg.
+QString settingsPathFromDatabasePath(const QString& databasePath) {
+    const QFileInfo fileInfo(databasePath);
+    if (fileInfo.isDir()) {
+        if (!QFileInfo::exists(QDir(databasePath).filePath(kDefaultDbFileName))) {
+            kLogger.critical() << "No" << kDefaultDbFileName << "found in" << databasePath;
+            return QString();
+        }
+        return fileInfo.absoluteFilePath();
+    }
+    if (!fileInfo.isFile()) {
+        kLogger.critical() << "Database not found:" << databasePath;
+        return QString();
+    }
+    if (fileInfo.fileName() != kDefaultDbFileName) {
+        kLogger.critical() << "The database file must be named" << kDefaultDbFileName;
+        return QString();
+    }
+    return fileInfo.absolutePath();
+}
+
+AnalyzerModeFlags analyzerModeFlags(bool withWaveforms) {
+    // Same as the batch analysis in the library, but the analysis
+    // is not supposed to leave room for the user interface.
+    int modeFlags = AnalyzerModeFlags::WithBeats;
+    if (withWaveforms) {
+        modeFlags |= AnalyzerModeFlags::WithWaveform;
+    }
+    return static_cast<AnalyzerModeFlags>(modeFlags);
+}
+
+int analyze(const UserSettingsPointer& pConfig, int numThreads, bool withWaveforms) {
+    mixxx::DbConnectionPoolPtr pDbConnectionPool = MixxxDb(pConfig).connectionPool();
+    if (!pDbConnectionPool) {
+        return kAnalysisErrorExitCode;
+    }
+    // Create a connection for the main thread
+    pDbConnectionPool->createThreadLocalConnection();
+    {
+        const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
+        if (!dbConnection.isOpen()) {
+            kLogger.critical() << "Failed to open the database";
+            return kAnalysisErrorExitCode;
+        }
+        if (!initDatabaseSchema(dbConnection)) {
+            return kAnalysisErrorExitCode;
+        }
+    }
+
+    int exitCode = kSuccessExitCode;
+    {
+        // Tracks need the key notation for formatting their keys
+        ControlObject keyNotation(mixxx::library::prefs::kKeyNotationConfigKey);
+
+        TrackCollectionManager trackCollectionManager(
+                nullptr,
+                pConfig,
+                pDbConnectionPool);
+
+        QList<AnalyzerScheduledTrack> tracks;
+        const QList<TrackId> trackIds =
+                trackCollectionManager.internalCollection()->getTrackDAO().getAllTrackIds();
+        tracks.reserve(trackIds.size());
+        for (const auto& trackId : trackIds) {
+            tracks.append(trackId);
+        }
+
+        TrackAnalysisScheduler::Pointer pScheduler = TrackAnalysisScheduler::createInstance(
+                std::make_unique<const TrackAnalysisSchedulerEnvironmentImpl>(
+                        &trackCollectionManager),
+                numThreads,
+                pDbConnectionPool,
+                pConfig,
+                analyzerModeFlags(withWaveforms));
+
+        int lastTrackNumber = 0;
+        QObject::connect(pScheduler.get(),
+                &TrackAnalysisScheduler::progress,
+                [&lastTrackNumber](AnalyzerProgress /*currentTrackProgress*/,
+                        int currentTrackNumber,
+                        int totalTracksCount) {
+                    if (currentTrackNumber > lastTrackNumber) {
+                        lastTrackNumber = currentTrackNumber;
+                        kLogger.info() << "Analyzing track" << currentTrackNumber
+                                       << "of" << totalTracksCount;
+                    }
+                });
+        QObject::connect(pScheduler.get(),
+                &TrackAnalysisScheduler::finished,
+                QCoreApplication::instance(),
+                &QCoreApplication::quit);
+
+        kLogger.info() << "Analyzing" << tracks.size() << "tracks using"
+                       << numThreads << "threads";
+        if (pScheduler->scheduleTracks(tracks) > 0) {
+            pScheduler->resume();
+            exitCode = QCoreApplication::exec();
+        }
+
+        // Release all tracks before the collection is detached
+        pScheduler->stop();
+        pScheduler->waitForWorkerThreads();
+        pScheduler.reset();
+        QCoreApplication::sendPostedEvents();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+
+    pDbConnectionPool->destroyThreadLocalConnection();
+    return exitCode;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication::setOrganizationDomain("mixxx.org");
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("mixxx-analyze"));
+    QCoreApplication::setApplicationVersion(VersionStore::version());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+            "Analyzes all tracks in a Mixxx library and stores the results "
+            "in its database."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument(QStringLiteral("database"),
+            QStringLiteral("The %1 file or the settings directory that contains it.")
+                    .arg(kDefaultDbFileName));
+    const QCommandLineOption threadsOption(
+            QStringList{QStringLiteral("j"), QStringLiteral("threads")},
+            QStringLiteral("Number of tracks that are analyzed concurrently. "
+                           "Defaults to the number of cores."),
+            QStringLiteral("count"),
+            QString::number(QThread::idealThreadCount()));
+    parser.addOption(threadsOption);
+    const QCommandLineOption noWaveformsOption(
+            QStringLiteral("no-waveforms"),
+            QStringLiteral("Do not generate waveforms."));
+    parser.addOption(noWaveformsOption);
+    const QCommandLineOption verboseOption(
+            QStringList{QStringLiteral("v"), QStringLiteral("verbose")},
+            QStringLiteral("Print debug messages."));
+    parser.addOption(verboseOption);
+    parser.process(app);
+
+    const QStringList positionalArguments = parser.positionalArguments();
+    if (positionalArguments.size() != 1) {
+        parser.showHelp(kParseCmdlineArgsErrorExitCode);
+    }
+    bool threadsValid = false;
+    const int numThreads = parser.value(threadsOption).toInt(&threadsValid);
+    if (!threadsValid || numThreads <= 0) {
+        qCritical() << "Invalid number of threads:" << parser.value(threadsOption);
+        return kParseCmdlineArgsErrorExitCode;
+    }
+
+    // Only log to the console, the log file in the settings directory
+    // belongs to Mixxx.
+    mixxx::Logging::initialize(QString(),
+            parser.isSet(verboseOption) ? mixxx::LogLevel::Debug : mixxx::LogLevel::Info,
+            mixxx::kLogFlushLevelDefault,
+            mixxx::LogFlag::None);
+
+    const QString settingsPath = settingsPathFromDatabasePath(positionalArguments.first());
+    if (settingsPath.isEmpty()) {
+        mixxx::Logging::shutdown();
+        return kAnalysisErrorExitCode;
+    }
+
+    int exitCode = kAnalysisErrorExitCode;
+    if (SoundSourceProxy::registerProviders()) {
+        // The analyzers read their preferences from mixxx.cfg
+        UserSettingsPointer pConfig(new UserSettings(
+                QDir(settingsPath).filePath(MIXXX_SETTINGS_FILE)));
+        PerformanceTimer timer;
+        timer.start();
+        exitCode = analyze(pConfig, numThreads, !parser.isSet(noWaveformsOption));
+        kLogger.info() << "Finished after" << timer.elapsed().formatSecondsWithUnit();
+    } else {
+        kLogger.critical() << "Failed to register any SoundSource providers";
+    }
+
+    mixxx::Logging::shutdown();
+    return exitCode;
+}
@@ -0,0 +1,568 @@
+#include <sndfile.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QtDebug>
+#include <cmath>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "config.h"
+#include "control/control.h"
+#include "control/controlindicatortimer.h"
+#include "control/controlobject.h"
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/filtereffect.h"
+#include "effects/backends/builtin/flangereffect.h"
+#include "effects/backends/builtin/reverbeffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "effects/defs.h"
+#include "effects/effectchain.h"
+#include "effects/effectslot.h"
+#include "effects/effectsmanager.h"
+#include "engine/channels/enginedeck.h"
+#include "engine/enginebuffer.h"
+#include "engine/enginemixer.h"
+#include "engine/engineprofiler.h"
+#include "mixer/deck.h"
+#include "mixer/playerinfo.h"
+#include "mixer/playermanager.h"
+#include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/logging.h"
+#include "util/performancetimer.h"
+#include "util/versionstore.h"
+#ifdef __RUBBERBAND__
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+#endif
+
+// Runs the engine without sound devices, widgets or a library: The decks
+// play the given tracks and EngineMixer::process() is called in a loop as
+// fast as possible instead of by the callbacks of a sound device. Reports
+// how much faster than realtime the engine is and the time spent in each
+// stage of the callback, and optionally writes the main mix to a file.
+//
+// When writing a file, each callback waits until the decks have received
+// the chunks that were requested by the previous callback, so the file is
+// not affected by the speed of the reader threads. The chunks that are
+// still missed, e.g. right after a seek, are reported.
+//
+// The settings are kept in a temporary directory, so the configuration of
+// Mixxx is neither used nor modified.
+
+namespace {
+
+const mixxx::Logger kLogger("mixxx-engine-bench");
+
+// Exit codes
+constexpr int kSuccessExitCode = 0;
+constexpr int kBenchErrorExitCode = 1;
+constexpr int kParseCmdlineArgsErrorExitCode = 2;
+
+const QString kMainGroup = QStringLiteral("[Master]");
+
+// Tracks are not analyzed, so those without a BPM in their tags get this one
+// for sync to have something to work with.
+constexpr double kDefaultBpm = 124.0;
+
+// The profiles are dispatched well before the ring of the profiler is full
+constexpr int kCallbacksPerDispatch = 256;
+
+constexpr int kTrackLoadTimeoutMillis = 10000;
+constexpr int kPendingReadsTimeoutMillis = 10000;
+
+struct Options {
+    int numDecks;
+    double seconds;
+    unsigned int framesPerBuffer;
+    mixxx::audio::SampleRate sampleRate;
+    bool keylock;
+    double rateRatio;
+    bool sync;
+    int numEffects;
+    QString outputPath;
+    QString tracePath;
+    QStringList trackPaths;
+};
+
+// SoundManager enables the main output while a device is configured for it
+class BenchEngineMixer : public EngineMixer {
+  public:
+    BenchEngineMixer(UserSettingsPointer pConfig,
+            EffectsManager* pEffectsManager,
+            ChannelHandleFactoryPointer pChannelHandleFactory)
+            : EngineMixer(pConfig,
+                      kMainGroup,
+                      pEffectsManager,
+                      pChannelHandleFactory,
+                      false) {
+        m_pMainEnabled->forceSet(1);
+    }
+};
+
+class StatisticsConsumer : public EngineProfiler::Consumer {
+  public:
+    StatisticsConsumer()
+            : m_droppedProfiles(0) {
+    }
+
+    void consumeProfiles(const std::vector<EngineProfiler::CallbackProfile>& profiles,
+            int droppedProfiles) override {
+        for (const auto& profile : profiles) {
+            m_statistics.add(profile);
+        }
+        m_droppedProfiles += droppedProfiles;
+    }
+
+    const EngineProfileStatistics& statistics() const {
+        return m_statistics;
+    }
+    int droppedProfiles() const {
+        return m_droppedProfiles;
+    }
+
+  private:
+    EngineProfileStatistics m_statistics;
+    int m_droppedProfiles;
+};
+
+// The decks are loaded asynchronously by their CachingReader, that needs
+// the engine to run for delivering the loaded track.
+bool loadTrack(EngineMixer* pEngineMixer,
+        Deck* pDeck,
+        const QString& trackPath,
+        unsigned int framesPerBuffer) {
+    const TrackPointer pTrack = Track::newTemporary(trackPath);
+    pDeck->slotLoadTrack(pTrack,
+#ifdef __STEM__
+            mixxx::StemChannelSelection(),
+#endif
+            false);
+    EngineBuffer* pEngineBuffer = pDeck->getEngineDeck()->getEngineBuffer();
+    PerformanceTimer timer;
+    timer.start();
+    while (!pEngineBuffer->isTrackLoaded()) {
+        if (timer.elapsed().toIntegerMillis() > kTrackLoadTimeoutMillis) {
+            kLogger.critical() << "Failed to load" << trackPath << "into" << pDeck->getGroup();
+            return false;
+        }
+        pEngineMixer->process(framesPerBuffer * mixxx::kEngineChannelOutputCount);
+        QCoreApplication::processEvents();
+        QThread::msleep(1);
+    }
+    if (pTrack->getBpm() <= 0) {
+        pTrack->trySetBpm(kDefaultBpm);
+    }
+    kLogger.info() << "Loaded" << trackPath << "into" << pDeck->getGroup()
+                   << "with" << pTrack->getBpm() << "BPM";
+    return true;
+}
+
+// Waits until the readers of all decks have answered their read requests,
+// outside of the measured engine time. Returns false on timeout.
+bool waitForPendingReads(const std::vector<std::unique_ptr<Deck>>& decks) {
+    PerformanceTimer timer;
+    timer.start();
+    for (const auto& pDeck : decks) {
+        EngineBuffer* pEngineBuffer = pDeck->getEngineDeck()->getEngineBuffer();
+        while (pEngineBuffer->processPendingReads()) {
+            if (timer.elapsed().toIntegerMillis() > kPendingReadsTimeoutMillis) {
+                kLogger.critical() << "Timed out waiting for the reader of"
+                                   << pDeck->getGroup();
+                return false;
+            }
+            QThread::msleep(1);
+        }
+    }
+    return true;
+}
+
+// Loads the effects into the slots of the effect units in order and routes
+// all decks through the units that are used.
+bool loadEffects(EffectsManager* pEffectsManager, const QStringList& groups, int numEffects) {
+    const QStringList effectIds = {
+            ReverbEffect::getId(),
+            EchoEffect::getId(),
+            FlangerEffect::getId(),
+            FilterEffect::getId(),
+    };
+    for (int i = 0; i < numEffects; ++i) {
+        const int unitNumber = i / kNumEffectsPerUnit;
+        const EffectChainPointer pChain = pEffectsManager->getStandardEffectChain(unitNumber);
+        VERIFY_OR_DEBUG_ASSERT(pChain) {
+            return false;
+        }
+        const EffectManifestPointer pManifest =
+                pEffectsManager->getBackendManager()->getManifest(
+                        effectIds.at(i % effectIds.size()), EffectBackendType::BuiltIn);
+        const EffectSlotPointer pSlot = pChain->getEffectSlot(i % kNumEffectsPerUnit);
+        if (!pManifest || !pSlot) {
+            kLogger.critical() << "Failed to load effect" << effectIds.at(i % effectIds.size());
+            return false;
+        }
+        pSlot->loadEffectWithDefaults(pManifest);
+        ControlObject::set(ConfigKey(pSlot->getGroup(), QStringLiteral("enabled")), 1.0);
+        ControlObject::set(ConfigKey(pChain->group(), QStringLiteral("mix")), 1.0);
+        for (const auto& group : groups) {
+            ControlObject::set(ConfigKey(pChain->group(),
+                                       QStringLiteral("group_%1_enable").arg(group)),
+                    1.0);
+        }
+    }
+    return true;
+}
+
+void report(const Options& options,
+        const StatisticsConsumer& consumer,
+        mixxx::Duration engineDuration,
+        double renderedSeconds) {
+    QTextStream out(stdout);
+    const double engineSeconds = engineDuration.toDoubleSeconds();
+    out << "Rendered " << renderedSeconds << " s with " << options.numDecks
+        << " decks in " << engineSeconds << " s, "
+        << (engineSeconds > 0 ? renderedSeconds / engineSeconds : 0.0)
+        << "x realtime\n";
+
+    const EngineProfileStatistics& statistics = consumer.statistics();
+    out << "Callbacks that took longer than their buffer: "
+        << statistics.lateCallbacks() << '\n';
+    out << "Chunks that were not read in time: " << statistics.cacheMisses() << '\n';
+    if (!options.outputPath.isEmpty() && statistics.cacheMisses() > 0) {
+        out << "The output contains silence for the missed chunks\n";
+    }
+    if (consumer.droppedProfiles() > 0) {
+        out << "Profiles dropped: " << consumer.droppedProfiles() << '\n';
+    }
+    out << "Stage\tcount\tmean us\tp99 us\tmax us\n";
+    for (int i = 0; i < EngineProfiler::kNumStages; ++i) {
+        const auto stage = static_cast<EngineProfiler::Stage>(i);
+        const EngineProfileStatistics::Histogram& histogram = statistics.stage(stage);
+        if (histogram.count() == 0) {
+            continue;
+        }
+        out << EngineProfileStatistics::stageName(stage) << '\t'
+            << histogram.count() << '\t'
+            << histogram.meanNanos() / 1000 << '\t'
+            << histogram.percentileNanos(0.99) / 1000.0 << '\t'
+            << histogram.maxNanos() / 1000.0 << '\n';
+    }
+}
+
+bool writeTrace(const QString& tracePath, const StatisticsConsumer& consumer) {
+    QFile file(tracePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(consumer.statistics().toChromeTrace(
+                    EngineProfiler::instance()->channelNames())) < 0) {
+        kLogger.critical() << "Failed to write the trace to" << tracePath;
+        return false;
+    }
+    return true;
+}
+
+int bench(const UserSettingsPointer& pConfig, const Options& options) {
+    ControlDoublePrivate::setUserConfig(pConfig);
+    int exitCode = kSuccessExitCode;
+    {
+        mixxx::ControlIndicatorTimer controlIndicatorTimer;
+        auto pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
+        ControlObject numDecks(ConfigKey(QStringLiteral("[App]"), QStringLiteral("num_decks")));
+        auto pEffectsManager = std::make_unique<EffectsManager>(pConfig, pChannelHandleFactory);
+        EngineProfiler::createInstance();
+        auto pEngineMixer = std::make_unique<BenchEngineMixer>(
+                pConfig, pEffectsManager.get(), pChannelHandleFactory);
+        ControlObject::set(ConfigKey(QStringLiteral("[App]"), QStringLiteral("samplerate")),
+                options.sampleRate.toDouble());
+#ifdef __RUBBERBAND__
+        RubberBandWorkerPool::createInstance(pConfig);
+#endif
+        PlayerInfo::create();
+
+        std::vector<std::unique_ptr<Deck>> decks;
+        QStringList groups;
+        for (int i = 0; i < options.numDecks; ++i) {
+            const QString group = PlayerManager::groupForDeck(i);
+            const ChannelHandleAndGroup handleGroup =
+                    pEngineMixer->registerChannelGroup(group);
+            decks.push_back(std::make_unique<Deck>(nullptr,
+                    pConfig,
+                    pEngineMixer.get(),
+                    pEffectsManager.get(),
+                    EngineChannel::CENTER,
+                    handleGroup));
+            pEffectsManager->addDeck(handleGroup);
+            decks.back()->setupEqControls();
+            ControlObject::set(ConfigKey(group, QStringLiteral("main_mix")), 1.0);
+            numDecks.set(numDecks.get() + 1);
+            groups.append(group);
+        }
+        pEffectsManager->setup();
+        ControlObject::set(ConfigKey(kMainGroup, QStringLiteral("enabled")), 1.0);
+
+        SNDFILE* pOutputFile = nullptr;
+        const bool ready = [&] {
+            if (!loadEffects(pEffectsManager.get(), groups, options.numEffects)) {
+                return false;
+            }
+            for (int i = 0; i < options.numDecks; ++i) {
+                if (!loadTrack(pEngineMixer.get(),
+                            decks[i].get(),
+                            options.trackPaths.at(i % options.trackPaths.size()),
+                            options.framesPerBuffer)) {
+                    return false;
+                }
+            }
+            if (!options.outputPath.isEmpty()) {
+                SF_INFO info{};
+                info.samplerate = static_cast<int>(options.sampleRate.value());
+                info.channels = mixxx::kEngineChannelOutputCount;
+                info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+                pOutputFile = sf_open(
+                        QFile::encodeName(options.outputPath).constData(), SFM_WRITE, &info);
+                if (!pOutputFile) {
+                    kLogger.critical() << "Failed to open" << options.outputPath << ':'
+                                       << sf_strerror(nullptr);
+                    return false;
+                }
+            }
+            return true;
+        }();
+
+        if (ready) {
+            for (int i = 0; i < options.numDecks; ++i) {
+                const QString& group = groups.at(i);
+                ControlObject::set(ConfigKey(group, QStringLiteral("keylock")),
+                        options.keylock ? 1.0 : 0.0);
+                ControlObject::set(ConfigKey(group, QStringLiteral("rate_ratio")),
+                        options.rateRatio);
+                // The first deck becomes the leader
+                ControlObject::set(ConfigKey(group, QStringLiteral("sync_enabled")),
+                        options.sync ? 1.0 : 0.0);
+                ControlObject::set(ConfigKey(group, QStringLiteral("repeat")), 1.0);
+                ControlObject::set(ConfigKey(group, QStringLiteral("play")), 1.0);
+            }
+
+            StatisticsConsumer consumer;
+            EngineProfiler::instance()->addConsumer(&consumer);
+
+            const std::size_t bufferSize =
+                    options.framesPerBuffer * mixxx::kEngineChannelOutputCount;
+            const qint64 numCallbacks = static_cast<qint64>(
+                    std::ceil(options.seconds * options.sampleRate.value() /
+                            options.framesPerBuffer));
+            mixxx::Duration engineDuration;
+            PerformanceTimer timer;
+            qint64 callback = 0;
+            for (; callback < numCallbacks; ++callback) {
+                if (pOutputFile && !waitForPendingReads(decks)) {
+                    exitCode = kBenchErrorExitCode;
+                    break;
+                }
+                timer.start();
+                pEngineMixer->process(bufferSize);
+                engineDuration += timer.elapsed();
+                if (pOutputFile) {
+                    const std::span<const CSAMPLE> mainBuffer = pEngineMixer->getMainBuffer();
+                    sf_writef_float(pOutputFile,
+                            mainBuffer.data(),
+                            options.framesPerBuffer);
+                }
+                if (callback % kCallbacksPerDispatch == 0) {
+                    EngineProfiler::instance()->dispatch();
+                    QCoreApplication::processEvents();
+                }
+            }
+            EngineProfiler::instance()->dispatch();
+            EngineProfiler::instance()->removeConsumer(&consumer);
+
+            report(options,
+                    consumer,
+                    engineDuration,
+                    static_cast<double>(callback) * options.framesPerBuffer /
+                            options.sampleRate.value());
+            if (!options.tracePath.isEmpty() && !writeTrace(options.tracePath, consumer)) {
+                exitCode = kBenchErrorExitCode;
+            }
+        } else {
+            exitCode = kBenchErrorExitCode;
+        }
+
+        if (pOutputFile && sf_close(pOutputFile) != 0) {
+            kLogger.critical() << "Failed to write" << options.outputPath;
+            exitCode = kBenchErrorExitCode;
+        }
+
+        // The decks must be gone before the engine they are registered with
+        decks.clear();
+        pEngineMixer.reset();
+        pEffectsManager.reset();
+        PlayerInfo::destroy();
+#ifdef __RUBBERBAND__
+        RubberBandWorkerPool::destroy();
+#endif
+        EngineProfiler::destroy();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+    ControlDoublePrivate::setUserConfig(UserSettingsPointer());
+    return exitCode;
+}
+
+template<typename T>
+bool parseNumber(const QCommandLineParser& parser,
+        const QCommandLineOption& option,
+        T minValue,
+        T* pValue) {
+    bool valid = false;
+    const double value = parser.value(option).toDouble(&valid);
+    if (!valid || value < minValue) {
+        qCritical() << "Invalid value of" << option.names().last() << ':'
+                    << parser.value(option);
+        return false;
+    }
+    *pValue = static_cast<T>(value);
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication::setOrganizationDomain("mixxx.org");
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("mixxx-engine-bench"));
+    QCoreApplication::setApplicationVersion(VersionStore::version());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+            "Plays tracks on decks of the Mixxx engine as fast as possible "
+            "and reports the time spent in each stage of the engine."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument(QStringLiteral("tracks"),
+            QStringLiteral("The tracks that are loaded into the decks in turn."),
+            QStringLiteral("track..."));
+    const QCommandLineOption decksOption(
+            QStringList{QStringLiteral("d"), QStringLiteral("decks")},
+            QStringLiteral("Number of playing decks."),
+            QStringLiteral("count"),
+            QStringLiteral("4"));
+    parser.addOption(decksOption);
+    const QCommandLineOption secondsOption(
+            QStringList{QStringLiteral("s"), QStringLiteral("seconds")},
+            QStringLiteral("Duration of the rendered audio."),
+            QStringLiteral("seconds"),
+            QStringLiteral("60"));
+    parser.addOption(secondsOption);
+    const QCommandLineOption bufferOption(
+            QStringList{QStringLiteral("b"), QStringLiteral("buffer")},
+            QStringLiteral("Frames per callback."),
+            QStringLiteral("frames"),
+            QStringLiteral("256"));
+    parser.addOption(bufferOption);
+    const QCommandLineOption sampleRateOption(
+            QStringList{QStringLiteral("r"), QStringLiteral("sample-rate")},
+            QStringLiteral("Sample rate of the engine."),
+            QStringLiteral("Hz"),
+            QStringLiteral("48000"));
+    parser.addOption(sampleRateOption);
+    const QCommandLineOption keylockOption(
+            QStringList{QStringLiteral("k"), QStringLiteral("keylock")},
+            QStringLiteral("Enable keylock on all decks."));
+    parser.addOption(keylockOption);
+    const QCommandLineOption rateOption(
+            QStringLiteral("rate"),
+            QStringLiteral("Playback speed of all decks, e.g. 1.08 for +8%."),
+            QStringLiteral("ratio"),
+            QStringLiteral("1"));
+    parser.addOption(rateOption);
+    const QCommandLineOption syncOption(
+            QStringLiteral("sync"),
+            QStringLiteral("Enable sync on all decks."));
+    parser.addOption(syncOption);
+    const QCommandLineOption effectsOption(
+            QStringList{QStringLiteral("e"), QStringLiteral("effects")},
+            QStringLiteral("Number of effects that are applied to all decks."),
+            QStringLiteral("count"),
+            QStringLiteral("0"));
+    parser.addOption(effectsOption);
+    const QCommandLineOption outputOption(
+            QStringList{QStringLiteral("o"), QStringLiteral("output")},
+            QStringLiteral("Write the main mix to a WAV file."),
+            QStringLiteral("file"));
+    parser.addOption(outputOption);
+    const QCommandLineOption traceOption(
+            QStringLiteral("trace"),
+            QStringLiteral("Write the last profiles as Chrome trace, "
+                           "that can be loaded into https://ui.perfetto.dev"),
+            QStringLiteral("file"));
+    parser.addOption(traceOption);
+    const QCommandLineOption verboseOption(
+            QStringList{QStringLiteral("v"), QStringLiteral("verbose")},
+            QStringLiteral("Print debug messages."));
+    parser.addOption(verboseOption);
+    parser.process(app);
+
+    Options options;
+    unsigned int sampleRate = 0;
+    options.trackPaths = parser.positionalArguments();
+    if (options.trackPaths.isEmpty()) {
+        parser.showHelp(kParseCmdlineArgsErrorExitCode);
+    }
+    if (!parseNumber(parser, decksOption, 1, &options.numDecks) ||
+            !parseNumber(parser, secondsOption, 0.0, &options.seconds) ||
+            !parseNumber(parser, bufferOption, 1u, &options.framesPerBuffer) ||
+            !parseNumber(parser, sampleRateOption, 8000u, &sampleRate) ||
+            !parseNumber(parser, rateOption, 0.0, &options.rateRatio) ||
+            !parseNumber(parser, effectsOption, 0, &options.numEffects)) {
+        return kParseCmdlineArgsErrorExitCode;
+    }
+    if (options.numDecks > EngineProfiler::kMaxChannels) {
+        qCritical() << "At most" << EngineProfiler::kMaxChannels << "decks are profiled";
+        return kParseCmdlineArgsErrorExitCode;
+    }
+    if (options.numEffects > kNumStandardEffectUnits * kNumEffectsPerUnit) {
+        qCritical() << "At most" << kNumStandardEffectUnits * kNumEffectsPerUnit
+                    << "effects fit into the effect units";
+        return kParseCmdlineArgsErrorExitCode;
+    }
+    options.sampleRate = mixxx::audio::SampleRate(sampleRate);
+    options.keylock = parser.isSet(keylockOption);
+    options.sync = parser.isSet(syncOption);
+    options.outputPath = parser.value(outputOption);
+    options.tracePath = parser.value(traceOption);
+
+    mixxx::Logging::initialize(QString(),
+            parser.isSet(verboseOption) ? mixxx::LogLevel::Debug : mixxx::LogLevel::Warning,
+            mixxx::kLogFlushLevelDefault,
+            mixxx::LogFlag::None);
+
+    for (const auto& trackPath : std::as_const(options.trackPaths)) {
+        if (!QFileInfo(trackPath).isFile()) {
+            kLogger.critical() << "Track not found:" << trackPath;
+            mixxx::Logging::shutdown();
+            return kBenchErrorExitCode;
+        }
+    }
+
+    int exitCode = kBenchErrorExitCode;
+    const QTemporaryDir settingsDir;
+    if (!settingsDir.isValid()) {
+        kLogger.critical() << "Failed to create a temporary settings directory";
+    } else if (SoundSourceProxy::registerProviders()) {
+        UserSettingsPointer pConfig(new UserSettings(
+                QDir(settingsDir.path()).filePath(MIXXX_SETTINGS_FILE)));
+        exitCode = bench(pConfig, options);
+    } else {
+        kLogger.critical() << "Failed to register any SoundSource providers";
+    }
+
+    mixxx::Logging::shutdown();
+    return exitCode;
+}
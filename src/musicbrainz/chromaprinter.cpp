@@ -1,7 +1,5 @@
 #include "musicbrainz/chromaprinter.h"
 
-#include <chromaprint.h>
-
 #include <QtDebug>
 #include <vector>
 
@@ -25,12 +23,6 @@ namespace
     typedef void* char_p;
 #endif
 
-// this is worth 2min of audio
-// AcoustID only stores a fingerprint for the first two minutes of a song
-// on their server so we need only a fingerprint of the first two minutes
-// --kain88 July 2012
-    constexpr SINT kFingerprintDuration = 120; // in seconds
-
 QString calcFingerprint(
         mixxx::AudioSourceStereoProxy& audioSourceProxy,
         mixxx::IndexRange fingerprintRange) {
@@ -80,23 +72,7 @@ QString calcFingerprint(
         return QString();
     }
 
-    uint32_p fprint = nullptr;
-    int size = 0;
-    int ret = chromaprint_get_raw_fingerprint(ctx, &fprint, &size);
-    QByteArray fingerprint;
-    if (ret == 1) {
-        char_p encoded = nullptr;
-        int encoded_size = 0;
-        chromaprint_encode_fingerprint(fprint, size,
-                                       CHROMAPRINT_ALGORITHM_DEFAULT,
-                                       &encoded,
-                                       &encoded_size, 1);
-
-        fingerprint.append(reinterpret_cast<char*>(encoded), encoded_size);
-
-        chromaprint_dealloc(fprint);
-        chromaprint_dealloc(encoded);
-    }
+    const QString fingerprint = ChromaPrinter::encodeFingerprint(ctx);
     chromaprint_free(ctx);
 
     qDebug() << "generating fingerprint took"
@@ -112,6 +88,11 @@ ChromaPrinter::ChromaPrinter(QObject* parent)
 }
 
 QString ChromaPrinter::getFingerprint(TrackPointer pTrack) {
+    const QString analyzedFingerprint = pTrack->getFingerprint();
+    if (!analyzedFingerprint.isEmpty()) {
+        return analyzedFingerprint;
+    }
+
     mixxx::AudioSource::OpenParams config;
     // always stereo / 2 channels (see below)
     config.setChannelCount(mixxx::audio::ChannelCount(2));
@@ -127,10 +108,33 @@ QString ChromaPrinter::getFingerprint(TrackPointer pTrack) {
             pAudioSource->frameIndexRange(),
             mixxx::IndexRange::forward(
                     pAudioSource->frameIndexMin(),
-                    kFingerprintDuration * pAudioSource->getSignalInfo().getSampleRate()));
+                    kFingerprintDurationSeconds *
+                            pAudioSource->getSignalInfo().getSampleRate()));
     mixxx::AudioSourceStereoProxy audioSourceProxy(
             pAudioSource,
             fingerprintRange.length());
 
     return calcFingerprint(audioSourceProxy, fingerprintRange);
 }
+
+// static
+QString ChromaPrinter::encodeFingerprint(ChromaprintContext* ctx) {
+    uint32_p fprint = nullptr;
+    int size = 0;
+    int ret = chromaprint_get_raw_fingerprint(ctx, &fprint, &size);
+    QByteArray fingerprint;
+    if (ret == 1) {
+        char_p encoded = nullptr;
+        int encoded_size = 0;
+        chromaprint_encode_fingerprint(fprint, size,
+                                       CHROMAPRINT_ALGORITHM_DEFAULT,
+                                       &encoded,
+                                       &encoded_size, 1);
+
+        fingerprint.append(reinterpret_cast<char*>(encoded), encoded_size);
+
+        chromaprint_dealloc(fprint);
+        chromaprint_dealloc(encoded);
+    }
+    return fingerprint;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chromaprint.h>
+
 #include <QObject>
 
 #include "track/track_decl.h"
@@ -8,6 +10,16 @@ class ChromaPrinter: public QObject {
   Q_OBJECT
 
 public:
+      // AcoustID only stores a fingerprint for the first two minutes of a
+      // song on their server so we need only a fingerprint of the first
+      // two minutes
+      static constexpr int kFingerprintDurationSeconds = 120;
+
       explicit ChromaPrinter(QObject* parent = NULL);
+      // Returns the fingerprint that has been stored by AnalyzerFingerprint
+      // or calculates it from the file otherwise
       QString getFingerprint(TrackPointer pTrack);
+
+      // Returns the encoded fingerprint of a finished context
+      static QString encodeFingerprint(ChromaprintContext* ctx);
 };
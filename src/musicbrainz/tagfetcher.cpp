@@ -1,6 +1,8 @@
 #include "musicbrainz/tagfetcher.h"
 
+#include <QCache>
 #include <QFuture>
+#include <QHash>
 #include <QtConcurrentRun>
 
 #include "moc_tagfetcher.cpp"
@@ -22,6 +24,24 @@ constexpr int kCoverArtArchiveLinksTimeoutMilis = 60000; // msec
 // Long timeout to cope with occasional server-side unresponsiveness
 constexpr int kCoverArtArchiveImageTimeoutMilis = 60000; // msec
 
+// The number of tracks whose fingerprints and lookup results are kept
+// while Mixxx is running. Each entry only needs a few KB.
+constexpr int kMaxCachedTracks = 1000;
+
+// The caches are shared by all instances, which are only used from the
+// main thread.
+QCache<TrackId, QString> s_fingerprintCache(kMaxCachedTracks);
+QCache<QString, QList<mixxx::musicbrainz::TrackRelease>> s_trackReleaseCache(
+        kMaxCachedTracks);
+// Fingerprints that are calculated in advance by prefetchFingerprint()
+QHash<TrackId, QFuture<QString>> s_pendingFingerprints;
+
+QFuture<QString> calculateFingerprint(TrackPointer pTrack) {
+    return QtConcurrent::run([pTrack] {
+        return ChromaPrinter().getFingerprint(pTrack);
+    });
+}
+
 } // anonymous namespace
 
 TagFetcher::TagFetcher(QObject* parent)
@@ -35,11 +55,27 @@ void TagFetcher::startFetch(
     terminate();
 
     m_pTrack = pTrack;
+    if (!m_pTrack) {
+        return;
+    }
+
+    const TrackId trackId = m_pTrack->getId();
+    const QString* pFingerprint =
+            trackId.isValid() ? s_fingerprintCache.object(trackId) : nullptr;
+    if (pFingerprint) {
+        m_fingerprint = *pFingerprint;
+        startAcoustIdLookup();
+        return;
+    }
 
     emit fetchProgress(tr("Fingerprinting track"));
-    const auto fingerprintTask = QtConcurrent::run([pTrack] {
-        return ChromaPrinter().getFingerprint(pTrack);
-    });
+    QFuture<QString> fingerprintTask;
+    if (trackId.isValid() && s_pendingFingerprints.contains(trackId)) {
+        // Continue with the fingerprint that is already being calculated
+        fingerprintTask = s_pendingFingerprints.take(trackId);
+    } else {
+        fingerprintTask = calculateFingerprint(pTrack);
+    }
     m_fingerprintWatcher.setFuture(fingerprintTask);
     DEBUG_ASSERT(!m_pAcoustIdTask);
     connect(
@@ -49,6 +85,39 @@ void TagFetcher::startFetch(
             &TagFetcher::slotFingerprintReady);
 }
 
+void TagFetcher::prefetchFingerprint(
+        const TrackPointer& pTrack) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    if (!pTrack) {
+        return;
+    }
+    const TrackId trackId = pTrack->getId();
+    if (!trackId.isValid() ||
+            s_fingerprintCache.contains(trackId) ||
+            s_pendingFingerprints.contains(trackId)) {
+        return;
+    }
+    const auto fingerprintTask = calculateFingerprint(pTrack);
+    s_pendingFingerprints.insert(trackId, fingerprintTask);
+    auto* pWatcher = new QFutureWatcher<QString>(this);
+    connect(pWatcher,
+            &QFutureWatcher<QString>::finished,
+            this,
+            [pWatcher, trackId]() {
+                const QString fingerprint = pWatcher->result();
+                if (!fingerprint.isEmpty()) {
+                    s_fingerprintCache.insert(trackId, new QString(fingerprint));
+                }
+                // Unless startFetch() has already taken over the calculation
+                const auto pending = s_pendingFingerprints.find(trackId);
+                if (pending != s_pendingFingerprints.end() && pending->isFinished()) {
+                    s_pendingFingerprints.erase(pending);
+                }
+                pWatcher->deleteLater();
+            });
+    pWatcher->setFuture(fingerprintTask);
+}
+
 void TagFetcher::cancel() {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
     m_pTrack.reset();
@@ -75,6 +144,7 @@ void TagFetcher::cancel() {
 void TagFetcher::terminate() {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
     m_pTrack.reset();
+    m_fingerprint.clear();
 
     m_fingerprintWatcher.disconnect(this);
     m_fingerprintWatcher.cancel();
@@ -112,20 +182,43 @@ void TagFetcher::slotFingerprintReady() {
     }
 
     DEBUG_ASSERT(m_fingerprintWatcher.isFinished());
-    const QString fingerprint = m_fingerprintWatcher.result();
-    if (fingerprint.isEmpty()) {
+    m_fingerprint = m_fingerprintWatcher.result();
+    if (m_fingerprint.isEmpty()) {
         emit resultAvailable(
                 m_pTrack,
                 {},
                 tr("Reading track for fingerprinting failed."));
         return;
     }
+    if (m_pTrack->getId().isValid()) {
+        s_fingerprintCache.insert(m_pTrack->getId(), new QString(m_fingerprint));
+    }
+
+    startAcoustIdLookup();
+}
+
+void TagFetcher::startAcoustIdLookup() {
+    DEBUG_ASSERT(m_pTrack);
+    DEBUG_ASSERT(!m_fingerprint.isEmpty());
+    if (const auto* pTrackReleases = s_trackReleaseCache.object(m_fingerprint)) {
+        // Fetched before, e.g. when retrying or returning to a track
+        auto pTrack = m_pTrack;
+        const auto trackReleases = *pTrackReleases;
+        terminate();
+        emit resultAvailable(
+                std::move(pTrack),
+                trackReleases,
+                trackReleases.isEmpty()
+                        ? tr("Could not find this track in the MusicBrainz database.")
+                        : QString());
+        return;
+    }
 
     emit fetchProgress(tr("Identifying track through AcoustID"));
     DEBUG_ASSERT(!m_pAcoustIdTask);
     m_pAcoustIdTask = make_parented<mixxx::AcoustIdLookupTask>(
             &m_network,
-            fingerprint,
+            m_fingerprint,
             m_pTrack->getDurationSecondsInt(),
             this);
     connect(m_pAcoustIdTask,
@@ -299,6 +392,8 @@ void TagFetcher::slotMusicBrainzTaskSucceeded(
         return;
     }
     auto pTrack = m_pTrack;
+    s_trackReleaseCache.insert(m_fingerprint,
+            new QList<mixxx::musicbrainz::TrackRelease>(guessedTrackReleases));
     terminate();
 
     if (guessedTrackReleases.empty()) {
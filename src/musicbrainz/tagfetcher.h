@@ -26,6 +26,14 @@ class TagFetcher : public QObject {
     void startFetch(
             TrackPointer pTrack);
 
+    // Calculates the fingerprint of a track in the background that is
+    // likely fetched next, e.g. the following track of a track model.
+    // The fingerprints and results are cached and shared by all instances,
+    // so fetching a track again doesn't need to decode the track or to
+    // query the web services.
+    void prefetchFingerprint(
+            const TrackPointer& pTrack);
+
     // This is called from dlgTagFetcher.
     // This starts the initial task for to find the cover art links
     // 4 Possible cover art links fetched in this task.
@@ -115,6 +123,8 @@ class TagFetcher : public QObject {
   private:
     void terminate();
 
+    void startAcoustIdLookup();
+
     QNetworkAccessManager m_network;
 
     QFutureWatcher<QString> m_fingerprintWatcher;
@@ -128,4 +138,7 @@ class TagFetcher : public QObject {
     parented_ptr<mixxx::CoverArtArchiveImageTask> m_pCoverArtArchiveImageTask;
 
     TrackPointer m_pTrack;
+
+    // The fingerprint of m_pTrack, the key of the cached results
+    QString m_fingerprint;
 };
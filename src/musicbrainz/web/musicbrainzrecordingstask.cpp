@@ -8,6 +8,7 @@
 #include "network/httpstatuscode.h"
 #include "util/assert.h"
 #include "util/logger.h"
+#include "util/performancetimer.h"
 #include "util/thread_affinity.h"
 #include "util/versionstore.h"
 
@@ -28,6 +29,23 @@ const QByteArray kUserAgentRawHeaderKey = "User-Agent";
 // See: <https://musicbrainz.org/doc/MusicBrainz_API/Rate_Limiting>
 constexpr Duration kMinDurationBetweenRequests = Duration::fromMillis(1000);
 
+// The limit applies to all requests of the application, e.g. when the tags
+// of different tracks are fetched at the same time, so the time of the last
+// request is shared by all tasks. The tasks are only used from the main
+// thread.
+PerformanceTimer s_lastRequestSentAt;
+
+// Ensure that at least kMinDurationBetweenRequests has passed
+// since the last request before starting the next request.
+Duration delayBeforeNextRequest() {
+    if (!s_lastRequestSentAt.running()) {
+        return Duration::empty();
+    }
+    const Duration elapsedSinceLastRequestSent = s_lastRequestSentAt.elapsed();
+    return kMinDurationBetweenRequests -
+            std::min(kMinDurationBetweenRequests, elapsedSinceLastRequestSent);
+}
+
 QString userAgentRawHeaderValue() {
     return VersionStore::applicationName() +
             QStringLiteral("/") +
@@ -103,7 +121,7 @@ QNetworkReply* MusicBrainzRecordingsTask::doStartNetworkRequest(
                 << "GET"
                 << networkRequest.url();
     }
-    m_lastRequestSentAt.start();
+    s_lastRequestSentAt.start();
     return networkAccessManager->get(networkRequest);
 }
 
@@ -177,15 +195,9 @@ void MusicBrainzRecordingsTask::doNetworkReplyFinished(
     // Continue with next recording id
     DEBUG_ASSERT(!m_queuedRecordingIds.isEmpty());
 
-    // Ensure that at least kMinDurationBetweenRequests has passed
-    // since the last request before starting the next request.
-    // This is achieved by adjusting the start delay adaptively.
-    const Duration elapsedSinceLastRequestSent = m_lastRequestSentAt.elapsed();
-    const Duration delayBeforeNextRequest =
-            kMinDurationBetweenRequests -
-            std::min(kMinDurationBetweenRequests, elapsedSinceLastRequestSent);
+    // The start delay is adjusted adaptively to respect the rate limit
     emit currentRecordingFetchedFromMusicBrainz();
-    slotStart(m_parentTimeoutMillis, delayBeforeNextRequest.toIntegerMillis());
+    slotStart(m_parentTimeoutMillis, delayBeforeNextRequest().toIntegerMillis());
 }
 
 void MusicBrainzRecordingsTask::onNetworkError(
@@ -8,7 +8,6 @@
 
 #include "musicbrainz/musicbrainz.h"
 #include "network/webtask.h"
-#include "util/performancetimer.h"
 
 namespace mixxx {
 
@@ -58,8 +57,6 @@ class MusicBrainzRecordingsTask : public network::WebTask {
 
     QMap<QUuid, musicbrainz::TrackRelease> m_trackReleases;
 
-    PerformanceTimer m_lastRequestSentAt;
-
     int m_parentTimeoutMillis;
 };
 
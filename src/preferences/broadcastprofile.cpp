@@ -54,6 +54,7 @@ constexpr const char* kPassword = "Password";
 constexpr const char* kPort = "Port";
 constexpr const char* kProfileName = "ProfileName";
 constexpr const char* kReconnectFirstDelay = "ReconnectFirstDelay";
+constexpr const char* kReconnectBacklog = "ReconnectBacklog";
 constexpr const char* kReconnectPeriod = "ReconnectPeriod";
 constexpr const char* kServertype = "Servertype";
 constexpr const char* kStreamDesc = "StreamDesc";
@@ -79,6 +80,7 @@ constexpr int kDefaultMaximumRetries = 10;
 const QString kDefaultMetadataFormat("$artist - $title");
 constexpr bool kDefaultNoDelayFirstReconnect = true;
 constexpr bool kDefaultOggDynamicupdate = false;
+constexpr int kDefaultReconnectBacklog = 0;
 constexpr double kDefaultReconnectFirstDelay = 0.0;
 constexpr double kDefaultReconnectPeriod = 5.0;
 const QString kDefaultStreamName = QStringLiteral("Mixxx");
@@ -154,6 +156,7 @@ bool BroadcastProfile::valuesEquals(BroadcastProfilePtr other) {
             && getMaximumRetries() == other->getMaximumRetries()
             && getNoDelayFirstReconnect() == other->getNoDelayFirstReconnect()
             && getReconnectFirstDelay() == other->getReconnectFirstDelay()
+            && getReconnectBacklog() == other->getReconnectBacklog()
             && getFormat() == other->getFormat()
             && getBitrate() == other->getBitrate()
             && getChannels() == other->getChannels()
@@ -203,6 +206,7 @@ void BroadcastProfile::copyValuesTo(BroadcastProfilePtr other) {
 
     other->setNoDelayFirstReconnect(this->getNoDelayFirstReconnect());
     other->setReconnectFirstDelay(this->getReconnectFirstDelay());
+    other->setReconnectBacklog(this->getReconnectBacklog());
 
     other->setFormat(this->getFormat());
     other->setBitrate(this->getBitrate());
@@ -266,6 +270,7 @@ void BroadcastProfile::adoptDefaultValues() {
     m_noDelayFirstReconnect = kDefaultNoDelayFirstReconnect;
     m_reconnectFirstDelay = kDefaultReconnectFirstDelay;
     m_maximumRetries = kDefaultMaximumRetries;
+    m_reconnectBacklog = kDefaultReconnectBacklog;
 }
 
 bool BroadcastProfile::loadValues(const QString& filename) {
@@ -320,6 +325,8 @@ bool BroadcastProfile::loadValues(const QString& filename) {
             (bool)XmlParse::selectNodeInt(doc, kNoDelayFirstReconnect);
     m_reconnectFirstDelay =
             XmlParse::selectNodeDouble(doc, kReconnectFirstDelay);
+    m_reconnectBacklog =
+            XmlParse::selectNodeInt(doc, kReconnectBacklog);
 
     m_mountpoint = XmlParse::selectNodeQString(doc, kMountPoint);
     m_streamName = XmlParse::selectNodeQString(doc, kStreamName);
@@ -386,6 +393,8 @@ bool BroadcastProfile::save(const QString& filename) {
                          QString::number((int)m_noDelayFirstReconnect));
     XmlParse::addElement(doc, docRoot, kReconnectFirstDelay,
                          QString::number(m_reconnectFirstDelay));
+    XmlParse::addElement(doc, docRoot, kReconnectBacklog,
+                         QString::number(m_reconnectBacklog));
 
     XmlParse::addElement(doc, docRoot, kMountPoint, m_mountpoint);
     XmlParse::addElement(doc, docRoot, kStreamName, m_streamName);
@@ -447,6 +456,26 @@ int BroadcastProfile::connectionStatus() {
     return atomicLoadRelaxed(m_connectionStatus);
 }
 
+void BroadcastProfile::setTransferStatus(
+        int backlogMillis, int sendRateKbps, int sendBufferPercent) {
+    m_backlogMillis = backlogMillis;
+    m_sendRateKbps = sendRateKbps;
+    m_sendBufferPercent = sendBufferPercent;
+    emit transferStatusChanged(backlogMillis, sendRateKbps, sendBufferPercent);
+}
+
+int BroadcastProfile::backlogMillis() {
+    return atomicLoadRelaxed(m_backlogMillis);
+}
+
+int BroadcastProfile::sendRateKbps() {
+    return atomicLoadRelaxed(m_sendRateKbps);
+}
+
+int BroadcastProfile::sendBufferPercent() {
+    return atomicLoadRelaxed(m_sendBufferPercent);
+}
+
 void BroadcastProfile::setSecureCredentialStorage(bool value) {
     m_secureCredentials = value;
 }
@@ -537,6 +566,11 @@ void BroadcastProfile::relayConnectionStatus(int newConnectionStatus) {
     setConnectionStatus(newConnectionStatus);
 }
 
+void BroadcastProfile::relayTransferStatus(
+        int backlogMillis, int sendRateKbps, int sendBufferPercent) {
+    setTransferStatus(backlogMillis, sendRateKbps, sendBufferPercent);
+}
+
 // This was useless before, but now comes in handy for multi-broadcasting,
 // where it means "this connection is enabled and will be started by Mixxx"
 bool BroadcastProfile::getEnabled() const {
@@ -642,6 +676,14 @@ void BroadcastProfile::setReconnectFirstDelay(double value) {
     m_reconnectFirstDelay = value;
 }
 
+int BroadcastProfile::getReconnectBacklog() const {
+    return m_reconnectBacklog;
+}
+
+void BroadcastProfile::setReconnectBacklog(int value) {
+    m_reconnectBacklog = value;
+}
+
 QString BroadcastProfile::getMountpoint() const {
     return m_mountpoint;
 }
@@ -36,6 +36,14 @@ class BroadcastProfile : public QObject {
     void setConnectionStatus(int newState);
     int connectionStatus();
 
+    /// Reported by the connection while it is running: the duration of the
+    /// audio that is waiting to be sent, the current data rate and how full
+    /// the send buffer of the connection is.
+    void setTransferStatus(int backlogMillis, int sendRateKbps, int sendBufferPercent);
+    int backlogMillis();
+    int sendRateKbps();
+    int sendBufferPercent();
+
     void setSecureCredentialStorage(bool enabled);
     bool secureCredentialStorage();
 
@@ -78,6 +86,11 @@ class BroadcastProfile : public QObject {
     double getReconnectFirstDelay() const;
     void setReconnectFirstDelay(double value);
 
+    /// The seconds of the encoded stream that are kept while reconnecting
+    /// and sent faster than real time afterwards. 0 disables the backlog.
+    int getReconnectBacklog() const;
+    void setReconnectBacklog(int value);
+
     QString getFormat() const;
     void setFormat(const QString& value);
 
@@ -136,10 +149,12 @@ class BroadcastProfile : public QObject {
     void profileNameChanged(const QString& oldName, const QString& newName);
     void statusChanged(bool newStatus);
     void connectionStatusChanged(int newConnectionStatus);
+    void transferStatusChanged(int backlogMillis, int sendRateKbps, int sendBufferPercent);
 
   public slots:
     void relayStatus(bool newStatus);
     void relayConnectionStatus(int newConnectionStatus);
+    void relayTransferStatus(int backlogMillis, int sendRateKbps, int sendBufferPercent);
 
   private:
     void adoptDefaultValues();
@@ -169,6 +184,7 @@ class BroadcastProfile : public QObject {
     int m_maximumRetries;
     bool m_noDelayFirstReconnect;
     double m_reconnectFirstDelay;
+    int m_reconnectBacklog;
 
     QString m_mountpoint;
     QString m_streamName;
@@ -192,4 +208,7 @@ class BroadcastProfile : public QObject {
     bool m_oggDynamicUpdate;
 
     QAtomicInt m_connectionStatus;
+    QAtomicInt m_backlogMillis;
+    QAtomicInt m_sendRateKbps;
+    QAtomicInt m_sendBufferPercent;
 };
@@ -8,6 +8,10 @@ namespace {
 constexpr int kColumnEnabled = 0;
 constexpr int kColumnName = 1;
 constexpr int kColumnStatus = 2;
+constexpr int kColumnBacklog = 3;
+constexpr int kColumnSendRate = 4;
+constexpr int kColumnSendBuffer = 5;
+constexpr int kColumnCount = 6;
 } // namespace
 
 BroadcastSettingsModel::BroadcastSettingsModel() {
@@ -28,6 +32,9 @@ void BroadcastSettingsModel::resetFromSettings(BroadcastSettingsPointer pSetting
     for (BroadcastProfilePtr profile : profiles) {
         BroadcastProfilePtr copy = profile->valuesCopy();
         copy->setConnectionStatus(profile->connectionStatus());
+        copy->setTransferStatus(profile->backlogMillis(),
+                profile->sendRateKbps(),
+                profile->sendBufferPercent());
         connect(profile.data(),
                 &BroadcastProfile::statusChanged,
                 copy.data(),
@@ -36,6 +43,10 @@ void BroadcastSettingsModel::resetFromSettings(BroadcastSettingsPointer pSetting
                 &BroadcastProfile::connectionStatusChanged,
                 copy.data(),
                 &BroadcastProfile::relayConnectionStatus);
+        connect(profile.data(),
+                &BroadcastProfile::transferStatusChanged,
+                copy.data(),
+                &BroadcastProfile::relayTransferStatus);
         addProfileToModel(copy);
     }
 }
@@ -61,6 +72,10 @@ bool BroadcastSettingsModel::addProfileToModel(BroadcastProfilePtr profile) {
             &BroadcastProfile::connectionStatusChanged,
             this,
             &BroadcastSettingsModel::onConnectionStatusChanged);
+    connect(profile.data(),
+            &BroadcastProfile::transferStatusChanged,
+            this,
+            &BroadcastSettingsModel::onTransferStatusChanged);
     m_profiles.insert(profile->getProfileName(), BroadcastProfilePtr(profile));
 
     endInsertRows();
@@ -95,7 +110,7 @@ int BroadcastSettingsModel::rowCount(const QModelIndex& parent) const {
 
 int BroadcastSettingsModel::columnCount(const QModelIndex& parent) const {
     Q_UNUSED(parent);
-    return 3;
+    return kColumnCount;
 }
 
 QVariant BroadcastSettingsModel::data(const QModelIndex& index, int role) const {
@@ -130,6 +145,24 @@ QVariant BroadcastSettingsModel::data(const QModelIndex& index, int role) const
                 return Qt::AlignCenter;
             }
         }
+        else if (column == kColumnBacklog ||
+                column == kColumnSendRate ||
+                column == kColumnSendBuffer) {
+            if (role == Qt::DisplayRole) {
+                // Only meaningful while the connection is running
+                if (profile->connectionStatus() == BroadcastProfile::STATUS_UNCONNECTED) {
+                    return QString();
+                }
+                if (column == kColumnBacklog) {
+                    return tr("%1 s").arg(profile->backlogMillis() / 1000.0, 0, 'f', 1);
+                } else if (column == kColumnSendRate) {
+                    return tr("%1 kbit/s").arg(profile->sendRateKbps());
+                }
+                return tr("%1 %").arg(profile->sendBufferPercent());
+            } else if (role == Qt::TextAlignmentRole) {
+                return Qt::AlignCenter;
+            }
+        }
     }
 
     return QVariant();
@@ -145,6 +178,12 @@ QVariant BroadcastSettingsModel::headerData(int section, Qt::Orientation orienta
                 return tr("Name");
             } else if (section == kColumnStatus) {
                 return tr("Status");
+            } else if (section == kColumnBacklog) {
+                return tr("Backlog");
+            } else if (section == kColumnSendRate) {
+                return tr("Send rate");
+            } else if (section == kColumnSendBuffer) {
+                return tr("Send buffer");
             }
         }
     }
@@ -241,8 +280,19 @@ void BroadcastSettingsModel::onProfileNameChanged(const QString& oldName, const
 
 void BroadcastSettingsModel::onConnectionStatusChanged(int newStatus) {
     Q_UNUSED(newStatus);
-    // Refresh the whole status column
+    // Refresh the whole status column and the transfer status, which is
+    // hidden while disconnected
     QModelIndex start = this->index(0, kColumnStatus);
-    QModelIndex end = this->index(this->rowCount()-1, kColumnStatus);
+    QModelIndex end = this->index(this->rowCount() - 1, kColumnSendBuffer);
+    emit dataChanged(start, end);
+}
+
+void BroadcastSettingsModel::onTransferStatusChanged(
+        int backlogMillis, int sendRateKbps, int sendBufferPercent) {
+    Q_UNUSED(backlogMillis);
+    Q_UNUSED(sendRateKbps);
+    Q_UNUSED(sendBufferPercent);
+    QModelIndex start = this->index(0, kColumnBacklog);
+    QModelIndex end = this->index(this->rowCount() - 1, kColumnSendBuffer);
     emit dataChanged(start, end);
 }
@@ -36,6 +36,7 @@ class BroadcastSettingsModel : public QAbstractTableModel {
   private slots:
     void onProfileNameChanged(const QString& oldName, const QString& newName);
     void onConnectionStatusChanged(int newStatus);
+    void onTransferStatusChanged(int backlogMillis, int sendRateKbps, int sendBufferPercent);
 
   private:
     static QString connectionStatusString(BroadcastProfilePtr profile);
@@ -3,20 +3,37 @@
 #include <QApplication>
 #include <QDir>
 #include <QIODevice>
+#include <QSaveFile>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 #include <QtDebug>
 
 #include "util/cmdlineargs.h"
 #include "util/color/rgbcolor.h"
+#include "util/compatibility/qmutex.h"
 #include "util/xml.h"
 #include "widget/wwidget.h"
 
 // TODO(rryan): Move to a utility file.
 namespace {
-const QString kTempFilenameExtension = QStringLiteral(".tmp");
+// Preferences are often changed in bursts, e.g. while dragging a slider
+constexpr unsigned long kSaveLaterDelayMillis = 1000;
 const QString kCMakeCacheFile = QStringLiteral("CMakeCache.txt");
 const QLatin1String kSourceDirLine = QLatin1String("mixxx_SOURCE_DIR:STATIC=");
 
+QThreadPool* saveThreadPool() {
+    static QThreadPool* const pThreadPool = [] {
+        auto* pThreadPool = new QThreadPool();
+        // Waits for the bursts of changes, so a single thread suffices for
+        // all config files
+        pThreadPool->setMaxThreadCount(1);
+        pThreadPool->setObjectName(QStringLiteral("ConfigObject"));
+        return pThreadPool;
+    }();
+    return pThreadPool;
+}
+
 QString computeResourcePathImpl() {
     // Try to read in the resource directory from the command line
     QString qResourcePath = CmdlineArgs::Instance().getResourcePath();
@@ -155,6 +172,7 @@ ConfigObject<ValueType>::ConfigObject(
 }
 
 template <class ValueType> ConfigObject<ValueType>::~ConfigObject() {
+    flushPendingSave();
 }
 
 template <class ValueType>
@@ -240,16 +258,26 @@ template <class ValueType> void ConfigObject<ValueType>::reopen(const QString& f
 /// Returns true on success
 template<class ValueType>
 bool ConfigObject<ValueType>::save() {
-    QReadLocker lock(&m_valuesLock); // we only read the m_values here.
-    QFile tmpFile(m_filename + kTempFilenameExtension);
-    if (!QDir(QFileInfo(tmpFile).absolutePath()).exists()) {
-        QDir().mkpath(QFileInfo(tmpFile).absolutePath());
+    const auto saveLock = lockMutex(&m_saveMutex);
+    // Written from a copy, so other threads aren't blocked by the IO
+    QMap<ConfigKey, ValueType> values;
+    QString filename;
+    {
+        QReadLocker lock(&m_valuesLock);
+        values = m_values;
+        filename = m_filename;
     }
-    if (!tmpFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Could not write config file: " << tmpFile.fileName();
+
+    // Replaces the file only after all data has been written and synced
+    QSaveFile file(filename);
+    if (!QDir(QFileInfo(filename).absolutePath()).exists()) {
+        QDir().mkpath(QFileInfo(filename).absolutePath());
+    }
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Could not write config file: " << filename;
         return false;
     }
-    QTextStream stream(&tmpFile);
+    QTextStream stream(&file);
     // UTF-8 is the default in Qt6.
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     DEBUG_ASSERT(stream.encoding() == QStringConverter::Utf8);
@@ -263,7 +291,7 @@ bool ConfigObject<ValueType>::save() {
     // the stream.pos alone will yield wrong warnings. We therefore estimate
     // a minimum length as an additional safety check.
     qint64 minLength = 0;
-    for (auto i = m_values.constBegin(); i != m_values.constEnd(); ++i) {
+    for (auto i = values.constBegin(); i != values.constEnd(); ++i) {
         //qDebug() << "group:" << it.key().group << "item" << it.key().item << "val" << it.value()->value;
         if (i.key().group != group) {
             group = i.key().group;
@@ -277,35 +305,67 @@ bool ConfigObject<ValueType>::save() {
 
     stream.flush();
     // the stream is usually longer, depending on the amount of encoded data.
-    if (stream.pos() < minLength || QFileInfo(tmpFile).size() != stream.pos()) {
-        qWarning().nospace() << "Error while writing configuration file: " << tmpFile.fileName();
+    if (stream.pos() < minLength || file.size() != stream.pos()) {
+        qWarning().nospace() << "Error while writing configuration file: " << filename;
+        file.cancelWriting();
         return false;
     }
 
-    tmpFile.close();
-    if (tmpFile.error() !=
-            QFile::NoError) { //could be better... should actually say what the error was..
+    if (!file.commit()) {
         qWarning().nospace() << "Error while writing configuration file: "
-                             << tmpFile.fileName() << ": " << tmpFile.errorString();
+                             << filename << ": " << file.errorString();
         return false;
     }
 
-    QFile oldConfig(m_filename);
-    // Trying to remove a file that does not exist would fail
-    if (oldConfig.exists()) {
-        if (!oldConfig.remove()) {
-            qWarning().nospace() << "Could not remove old config file: "
-                                 << oldConfig.fileName() << ": " << oldConfig.errorString();
-            return false;
-        }
+    return true;
+}
+
+template<class ValueType>
+void ConfigObject<ValueType>::saveLater() {
+    const auto lock = lockMutex(&m_pendingSaveMutex);
+    m_saveRequested = true;
+    if (m_saveTaskActive) {
+        // Coalesced with the pending save
+        return;
     }
-    if (!tmpFile.rename(m_filename)) {
-        qWarning().nospace() << "Could not rename tmp file to config file: "
-                             << tmpFile.fileName() << ": " << tmpFile.errorString();
-        return false;
+    m_saveTaskActive = true;
+    m_pendingSave = QtConcurrent::run(saveThreadPool(), [this] {
+        runPendingSaves();
+    });
+}
+
+template<class ValueType>
+void ConfigObject<ValueType>::runPendingSaves() {
+    auto lock = lockMutex(&m_pendingSaveMutex);
+    while (m_saveRequested) {
+        // Wait for the following changes, unless the save is flushed
+        m_pendingSaveCondition.wait(&m_pendingSaveMutex, kSaveLaterDelayMillis);
+        if (!m_saveRequested) {
+            break;
+        }
+        m_saveRequested = false;
+        lock.unlock();
+        save();
+        lock.relock();
     }
+    m_saveTaskActive = false;
+}
 
-    return true;
+template<class ValueType>
+void ConfigObject<ValueType>::flushPendingSave() {
+    bool saveRequested;
+    QFuture<void> pendingSave;
+    {
+        const auto lock = lockMutex(&m_pendingSaveMutex);
+        saveRequested = m_saveRequested;
+        m_saveRequested = false;
+        m_pendingSaveCondition.wakeAll();
+        pendingSave = m_pendingSave;
+    }
+    if (saveRequested) {
+        save();
+    }
+    pendingSave.waitForFinished();
 }
 
 template<class ValueType>
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <QDomNode>
+#include <QFuture>
 #include <QHash>
 #include <QKeySequence>
 #include <QMap>
 #include <QMetaType>
+#include <QMutex>
 #include <QReadWriteLock>
 #include <QString>
+#include <QWaitCondition>
 #include <type_traits>
 
 #include "util/assert.h"
@@ -190,7 +193,15 @@ template <class ValueType> class ConfigObject {
     QMultiHash<ValueType, ConfigKey> transpose() const;
 
     void reopen(const QString& file);
+    // Writes the file atomically. The values may be changed by other
+    // threads meanwhile.
     bool save();
+    // Saves in the background after a short delay. Requests that follow in
+    // the meantime or while saving are coalesced into a single write.
+    void saveLater();
+    // Writes a save requested by saveLater() immediately and waits until
+    // the background save has finished.
+    void flushPendingSave();
 
     static QString computeResourcePath();
 
@@ -220,6 +231,19 @@ template <class ValueType> class ConfigObject {
     // Loads and parses the configuration file. Returns false if the file could
     // not be opened; otherwise true.
     bool parse();
+
+  private:
+    void runPendingSaves();
+
+    // Serializes the writes of the file, so an older copy of the values
+    // never replaces a newer one
+    QMutex m_saveMutex;
+    // Guards the state of saveLater()
+    QMutex m_pendingSaveMutex;
+    QWaitCondition m_pendingSaveCondition;
+    QFuture<void> m_pendingSave;
+    bool m_saveRequested = false;
+    bool m_saveTaskActive = false;
 };
 
 // Specialization must be declared before the first use that would cause
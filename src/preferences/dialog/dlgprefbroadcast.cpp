@@ -21,6 +21,9 @@ namespace {
 const char* kSettingsGroupHeader = "Settings for %1";
 constexpr int kColumnEnabled = 0;
 constexpr int kColumnName = 1;
+constexpr int kColumnStatus = 2;
+constexpr int kColumnBacklog = 3;
+constexpr int kColumnSendRate = 4;
 const mixxx::Logger kLogger("DlgPrefBroadcast");
 } // namespace
 
@@ -468,6 +471,9 @@ void DlgPrefBroadcast::getValuesFromProfile(BroadcastProfilePtr profile) {
     // Maximum Retries
     spinBoxMaximumRetries->setValue(profile->getMaximumRetries());
 
+    // Backlog while reconnecting
+    spinBoxReconnectBacklog->setValue(profile->getReconnectBacklog());
+
     // Stream "public" checkbox
     stream_public->setChecked(profile->getStreamPublic());
 
@@ -567,6 +573,7 @@ void DlgPrefBroadcast::setValuesToProfile(BroadcastProfilePtr profile) {
     profile->setReconnectPeriod(spinBoxReconnectPeriod->value());
     profile->setLimitReconnects(checkBoxLimitReconnects->isChecked());
     profile->setMaximumRetries(spinBoxMaximumRetries->value());
+    profile->setReconnectBacklog(spinBoxReconnectBacklog->value());
     profile->setStreamName(stream_name->text());
     profile->setStreamWebsite(stream_website->text());
     profile->setStreamIRC(stream_IRC->text());
@@ -659,7 +666,10 @@ void DlgPrefBroadcast::onSectionResized() {
 
     sender()->blockSignals(true);
     connectionList->setColumnWidth(kColumnEnabled, 100);
-    connectionList->setColumnWidth(kColumnName, static_cast<int>(width * 0.65));
+    connectionList->setColumnWidth(kColumnName, static_cast<int>(width * 0.3));
+    connectionList->setColumnWidth(kColumnStatus, static_cast<int>(width * 0.12));
+    connectionList->setColumnWidth(kColumnBacklog, static_cast<int>(width * 0.12));
+    connectionList->setColumnWidth(kColumnSendRate, static_cast<int>(width * 0.12));
     // The last column is automatically resized to fill
     // the remaining width, thanks to stretchLastSection set to true.
     sender()->blockSignals(false);
@@ -12,6 +12,7 @@ DlgPrefKey::DlgPrefKey(QWidget* parent, UserSettingsPointer pConfig)
           m_keySettings(pConfig),
           m_bAnalyzerEnabled(m_keySettings.getKeyDetectionEnabledDefault()),
           m_bFastAnalysisEnabled(m_keySettings.getFastAnalysisDefault()),
+          m_bSegmentAnalysisEnabled(m_keySettings.getSegmentAnalysisDefault()),
           m_bReanalyzeEnabled(m_keySettings.getReanalyzeWhenSettingsChangeDefault()),
           m_stemStrategy(KeyDetectionSettings::StemStrategy::Disabled) {
     setupUi(this);
@@ -73,6 +74,13 @@ DlgPrefKey::DlgPrefKey(QWidget* parent, UserSettingsPointer pConfig)
 #endif
             this,
             &DlgPrefKey::fastAnalysisEnabled);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+    connect(bsegmentAnalysisEnabled, &QCheckBox::checkStateChanged,
+#else
+    connect(bsegmentAnalysisEnabled, &QCheckBox::stateChanged,
+#endif
+            this,
+            &DlgPrefKey::segmentAnalysisEnabled);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
     connect(breanalyzeEnabled, &QCheckBox::checkStateChanged,
 #else
@@ -112,6 +120,7 @@ void DlgPrefKey::loadSettings() {
 
     m_bAnalyzerEnabled = m_keySettings.getKeyDetectionEnabled();
     m_bFastAnalysisEnabled = m_keySettings.getFastAnalysis();
+    m_bSegmentAnalysisEnabled = m_keySettings.getSegmentAnalysis();
     m_bReanalyzeEnabled = m_keySettings.getReanalyzeWhenSettingsChange();
 
     KeyUtils::KeyNotation notation_type =
@@ -162,6 +171,7 @@ void DlgPrefKey::slotResetToDefaults() {
     // KeyDetectionSettings.
     m_bAnalyzerEnabled = m_keySettings.getKeyDetectionEnabledDefault();
     m_bFastAnalysisEnabled = m_keySettings.getFastAnalysisDefault();
+    m_bSegmentAnalysisEnabled = m_keySettings.getSegmentAnalysisDefault();
     m_bReanalyzeEnabled = m_keySettings.getReanalyzeWhenSettingsChangeDefault();
     if (m_availablePlugins.size() > 0) {
         m_selectedAnalyzerId = m_availablePlugins[0].id();
@@ -214,6 +224,16 @@ void DlgPrefKey::fastAnalysisEnabled(int i) {
     slotUpdate();
 }
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+void DlgPrefKey::segmentAnalysisEnabled(Qt::CheckState state) {
+    m_bSegmentAnalysisEnabled = (state == Qt::Checked);
+#else
+void DlgPrefKey::segmentAnalysisEnabled(int i) {
+    m_bSegmentAnalysisEnabled = static_cast<bool>(i);
+#endif
+    slotUpdate();
+}
+
 #if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
 void DlgPrefKey::reanalyzeEnabled(Qt::CheckState state) {
     m_bReanalyzeEnabled = (state == Qt::Checked);
@@ -240,6 +260,7 @@ void DlgPrefKey::slotApply() {
     m_keySettings.setKeyPluginId(m_selectedAnalyzerId);
     m_keySettings.setKeyDetectionEnabled(m_bAnalyzerEnabled);
     m_keySettings.setFastAnalysis(m_bFastAnalysisEnabled);
+    m_keySettings.setSegmentAnalysis(m_bSegmentAnalysisEnabled);
     m_keySettings.setReanalyzeWhenSettingsChange(m_bReanalyzeEnabled);
 
     QString notation_name;
@@ -290,6 +311,9 @@ void DlgPrefKey::slotUpdate() {
     banalyzerenabled->setChecked(m_bAnalyzerEnabled);
     bfastAnalysisEnabled->setChecked(m_bFastAnalysisEnabled);
     bfastAnalysisEnabled->setEnabled(m_bAnalyzerEnabled);
+    bsegmentAnalysisEnabled->setChecked(m_bSegmentAnalysisEnabled);
+    // Fast analysis only analyzes the beginning of the track anyway
+    bsegmentAnalysisEnabled->setEnabled(m_bAnalyzerEnabled && !m_bFastAnalysisEnabled);
     breanalyzeEnabled->setChecked(m_bReanalyzeEnabled);
     breanalyzeEnabled->setEnabled(m_bAnalyzerEnabled);
 
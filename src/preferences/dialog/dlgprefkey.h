@@ -31,10 +31,12 @@ class DlgPrefKey : public DlgPreferencePage, Ui::DlgPrefKeyDlg {
 #if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
     void analyzerEnabled(Qt::CheckState state);
     void fastAnalysisEnabled(Qt::CheckState state);
+    void segmentAnalysisEnabled(Qt::CheckState state);
     void reanalyzeEnabled(Qt::CheckState state);
 #else
     void analyzerEnabled(int i);
     void fastAnalysisEnabled(int i);
+    void segmentAnalysisEnabled(int i);
     void reanalyzeEnabled(int i);
 #endif
 
@@ -57,6 +59,7 @@ class DlgPrefKey : public DlgPreferencePage, Ui::DlgPrefKeyDlg {
     ControlProxy* m_pKeyNotation;
     bool m_bAnalyzerEnabled;
     bool m_bFastAnalysisEnabled;
+    bool m_bSegmentAnalysisEnabled;
     bool m_bReanalyzeEnabled;
     KeyDetectionSettings::StemStrategy m_stemStrategy;
 };
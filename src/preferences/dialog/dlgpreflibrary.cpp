@@ -241,6 +241,7 @@ void DlgPrefLibrary::populateDirList() {
 
 void DlgPrefLibrary::slotResetToDefaults() {
     checkBox_library_scan->setChecked(false);
+    checkBox_watch_directories->setChecked(false);
     spinbox_history_track_duplicate_distance->setValue(
             kHistoryTrackDuplicateDistanceDefault);
     spinbox_history_min_tracks_to_keep->setValue(1);
@@ -277,6 +278,8 @@ void DlgPrefLibrary::slotUpdate() {
     populateDirList();
     checkBox_library_scan->setChecked(m_pConfig->getValue(
             kRescanOnStartupConfigKey, false));
+    checkBox_watch_directories->setChecked(m_pConfig->getValue(
+            kWatchDirectoriesConfigKey, false));
 
     spinbox_history_track_duplicate_distance->setValue(m_pConfig->getValue(
             kHistoryTrackDuplicateDistanceConfigKey,
@@ -508,6 +511,8 @@ void DlgPrefLibrary::slotSeratoMetadataExportClicked(bool checked) {
 void DlgPrefLibrary::slotApply() {
     m_pConfig->set(kRescanOnStartupConfigKey,
             ConfigValue((int)checkBox_library_scan->isChecked()));
+    m_pConfig->set(kWatchDirectoriesConfigKey,
+            ConfigValue((int)checkBox_watch_directories->isChecked()));
 
     m_pConfig->set(kHistoryTrackDuplicateDistanceConfigKey,
             ConfigValue(spinbox_history_track_duplicate_distance->value()));
@@ -591,8 +596,9 @@ void DlgPrefLibrary::slotApply() {
             mixxx::library::prefs::kApplyPlayedTrackColorConfigKey,
             ConfigValue(checkbox_played_track_color->isChecked()));
 
-    // TODO(rryan): Don't save here.
-    m_pConfig->save();
+    // Written in the background, the changes of several preference pages
+    // that are applied together are coalesced
+    m_pConfig->saveLater();
 }
 
 void DlgPrefLibrary::slotRowHeightValueChanged(int height) {
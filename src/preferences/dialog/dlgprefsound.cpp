@@ -12,6 +12,7 @@
 #include "moc_dlgprefsound.cpp"
 #include "preferences/dialog/dlgprefsounditem.h"
 #include "soundio/soundmanager.h"
+#include "util/realtime.h"
 #include "util/rlimit.h"
 #include "util/scopedoverridecursor.h"
 
@@ -82,6 +83,7 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
           m_pKeylockEngine(kKeylockEngingeCfgkey),
           m_settingsModified(false),
           m_bLatencyChanged(false),
+          m_bApplyingMeasuredLatency(false),
           m_bSkipConfigClear(true),
           m_loading(false) {
     setupUi(this);
@@ -231,6 +233,15 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
 
     connect(queryButton, &QAbstractButton::clicked, this, &DlgPrefSound::queryClicked);
 
+    connect(measureLatencyButton,
+            &QAbstractButton::clicked,
+            this,
+            &DlgPrefSound::measureLatencyClicked);
+    connect(m_pSoundManager.get(),
+            &SoundManager::latencyMeasurementFinished,
+            this,
+            &DlgPrefSound::latencyMeasurementFinished);
+
     connect(m_pSoundManager.get(),
             &SoundManager::outputRegistered,
             this,
@@ -257,6 +268,9 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
             kAppGroup, QStringLiteral("output_latency_ms"), this);
     m_pOutputLatencyMs->connectValueChanged(this, &DlgPrefSound::outputLatencyChanged);
 
+    m_clockDriftTimer.setInterval(1000);
+    connect(&m_clockDriftTimer, &QTimer::timeout, this, &DlgPrefSound::updateClockDrift);
+
     // TODO: remove this option by automatically disabling/enabling the main mix
     // when recording, broadcasting, headphone, and main outputs are enabled/disabled
     m_pMainEnabled =
@@ -298,6 +312,8 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
 #else
     // the limits warning is a Linux only thing
     realtimeHint->hide();
+    // Pinning, priorities and memory locking are only implemented for Linux
+    realtimeGroupBox->hide();
 #endif // __LINUX__
 
     setScrollSafeGuardForAllInputWidgets(this);
@@ -315,12 +331,16 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
 void DlgPrefSound::slotUpdate() {
     m_bSkipConfigClear = true;
     loadSettings();
+    loadRealtimeSettings(mixxx::realtime::Settings::fromConfig(m_pSettings));
     checkLatencyCompensation();
     m_bSkipConfigClear = false;
 }
 
 /// Slot called when the Apply or OK button is pressed.
 void DlgPrefSound::slotApply() {
+    // Independent of the sound devices, which don't need to be reopened
+    applyRealtimeSettings();
+
     if (!m_settingsModified) {
         return;
     }
@@ -335,14 +355,19 @@ void DlgPrefSound::slotApply() {
         const auto keylockEngine =
                 keylockComboBox->currentData().value<EngineBuffer::KeylockEngine>();
 
-        // Temporary set an empty config to force the audio thread to stop and
-        // stay off while we are swapping the keylock settings. This is
-        // necessary because the audio thread doesn't have any synchronisation
-        // mechanism due to its realtime nature and editing the RubberBand
-        // config while it is running leads to race conditions.
-        m_pSoundManager->closeActiveConfig();
-
-        m_pKeylockEngine.set(static_cast<double>(keylockEngine));
+        if (keylockEngine !=
+                static_cast<EngineBuffer::KeylockEngine>(
+                        static_cast<int>(m_pKeylockEngine.get()))) {
+            // Temporary set an empty config to force the audio thread to stop and
+            // stay off while we are swapping the keylock settings. This is
+            // necessary because the audio thread doesn't have any synchronisation
+            // mechanism due to its realtime nature and editing the RubberBand
+            // config while it is running leads to race conditions.
+            // Otherwise the devices may keep running, e.g. if only the buffer
+            // size changes and the backend can renegotiate it.
+            m_pSoundManager->closeActiveConfig();
+            m_pKeylockEngine.set(static_cast<double>(keylockEngine));
+        }
         m_pSettings->set(kKeylockEngingeCfgkey,
                 ConfigValue(static_cast<int>(keylockEngine)));
 
@@ -370,6 +395,10 @@ void DlgPrefSound::slotApply() {
         m_settingsModified = false;
         m_bLatencyChanged = false;
     }
+    // SoundManager applies a measured latency of the new setup
+    m_bApplyingMeasuredLatency = true;
+    latencyCompensationSpinBox->setValue(m_pLatencyCompensation.get());
+    m_bApplyingMeasuredLatency = false;
     m_bSkipConfigClear = true;
     loadSettings(); // in case SM decided to change anything it didn't like
     checkLatencyCompensation();
@@ -612,7 +641,12 @@ void DlgPrefSound::apiChanged(int index) {
     // For bigger buffers the user has to manually match the value with Jack.
     // TODO(Be): Get the buffer size from JACK and update audioBufferComboBox.
     // PortAudio as off v19.7.0 does not have a way to get the buffer size from JACK.
-    bool enable = m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING ? false : true;
+    // The native JACK device always runs with the buffer of the server,
+    // which is changed on the server while the audio keeps running.
+    bool enable = m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING ||
+                    m_config.getAPI() == MIXXX_JACK_NATIVE_STRING
+            ? false
+            : true;
     sampleRateComboBox->setEnabled(enable);
     deviceSyncComboBox->setEnabled(enable);
     engineClockComboBox->setEnabled(enable);
@@ -717,7 +751,15 @@ void DlgPrefSound::updateAudioBufferSizes(int sampleRateIndex) {
         for (unsigned int i = 0; i < SoundManagerConfig::kMaxAudioBufferSizeIndex; ++i) {
             const auto latency = static_cast<float>(framesPerBuffer / sampleRate * 1000);
             // i + 1 in the next line is a latency index as described in SSConfig
-            audioBufferComboBox->addItem(tr("%1 ms").arg(latency, 0, 'g', 3), i + 1);
+            if (m_config.getAPI() == MIXXX_JACK_NATIVE_STRING) {
+                // The frames per period of the server, like in other JACK tools
+                audioBufferComboBox->addItem(tr("%1 frames/period (%2 ms)")
+                                                     .arg(framesPerBuffer)
+                                                     .arg(latency, 0, 'g', 3),
+                        i + 1);
+            } else {
+                audioBufferComboBox->addItem(tr("%1 ms").arg(latency, 0, 'g', 3), i + 1);
+            }
             framesPerBuffer <<= 1; // *= 2
         }
     }
@@ -918,12 +960,66 @@ void DlgPrefSound::slotResetToDefaults() {
 
     latencyCompensationSpinBox->setValue(latencyCompensationSpinBox->minimum());
 
+    loadRealtimeSettings(mixxx::realtime::Settings());
+
     settingChanged();
 #ifdef __RUBBERBAND__
     updateKeylockDualThreadingCheckbox();
 #endif
 }
 
+void DlgPrefSound::slotShow() {
+    updateClockDrift();
+    const QString realtimeStatusText = mixxx::realtime::statusText();
+    realtimeStatus->setText(realtimeStatusText.isEmpty() ? tr("Default") : realtimeStatusText);
+    m_clockDriftTimer.start();
+}
+
+void DlgPrefSound::slotHide() {
+    m_clockDriftTimer.stop();
+}
+
+/// Shows the drift of the sound cards that are resampled to the clock
+/// reference device.
+void DlgPrefSound::updateClockDrift() {
+    QStringList drifts;
+    const QList<SoundDevicePointer> devices =
+            m_pSoundManager->getDeviceList(m_config.getAPI(), true, true);
+    for (const auto& pDevice : devices) {
+        const std::optional<double> driftPpm = pDevice->getClockDriftPpm();
+        if (driftPpm) {
+            drifts.append(tr("%1: %2 ppm")
+                            .arg(pDevice->getDisplayName())
+                            .arg(*driftPpm, 0, 'f', 1));
+        }
+    }
+    clockDrift->setText(drifts.isEmpty() ? tr("None") : drifts.join(QChar('\n')));
+}
+
+void DlgPrefSound::loadRealtimeSettings(const mixxx::realtime::Settings& settings) {
+    engineCpusLineEdit->setText(mixxx::realtime::formatCpuList(settings.engineCpus));
+    raiseHelperThreadsCheckBox->setChecked(settings.raiseHelperThreads);
+    idleAnalyzersCheckBox->setChecked(settings.idleAnalyzersWhilePlaying);
+    lockMemoryCheckBox->setChecked(settings.lockMemory);
+}
+
+void DlgPrefSound::applyRealtimeSettings() {
+    mixxx::realtime::Settings settings;
+    settings.engineCpus = mixxx::realtime::parseCpuList(engineCpusLineEdit->text());
+    if (settings.engineCpus.isEmpty() && !engineCpusLineEdit->text().trimmed().isEmpty()) {
+        QMessageBox::warning(this,
+                tr("Invalid Engine CPUs"),
+                tr("\"%1\" is not a list of CPUs like \"2,3\" or \"2-3\". "
+                   "The engine is not pinned.")
+                        .arg(engineCpusLineEdit->text()));
+        engineCpusLineEdit->clear();
+    }
+    settings.raiseHelperThreads = raiseHelperThreadsCheckBox->isChecked();
+    settings.idleAnalyzersWhilePlaying = idleAnalyzersCheckBox->isChecked();
+    settings.lockMemory = lockMemoryCheckBox->isChecked();
+    settings.toConfig(m_pSettings);
+}
+
 void DlgPrefSound::bufferUnderflow(double count) {
     bufferUnderflowCount->setText(QString::number(count));
     update();
@@ -936,9 +1032,68 @@ void DlgPrefSound::outputLatencyChanged(double latency) {
 
 void DlgPrefSound::latencyCompensationSpinboxChanged(double value) {
     m_pLatencyCompensation.set(value);
+    if (!m_bApplyingMeasuredLatency) {
+        m_pSoundManager->forgetMeasuredLatency();
+    }
     checkLatencyCompensation();
 }
 
+void DlgPrefSound::measureLatencyClicked() {
+    if (m_pSoundManager->isLatencyMeasurementRunning()) {
+        m_pSoundManager->cancelLatencyMeasurement();
+        return;
+    }
+    if (m_settingsModified) {
+        latencyMeasurementLabel->setText(tr("Apply the changed settings first."));
+        return;
+    }
+    if (!m_pSoundManager->startLatencyMeasurement()) {
+        latencyMeasurementLabel->setText(
+                tr("A microphone input and the main output must be configured."));
+        return;
+    }
+    measureLatencyButton->setText(tr("Cancel"));
+    latencyMeasurementLabel->setText(tr("Measuring..."));
+}
+
+void DlgPrefSound::latencyMeasurementFinished(
+        LatencyMeasurement::State state, double roundTripMs) {
+    measureLatencyButton->setText(tr("Measure Round Trip Latency"));
+    switch (state) {
+    case LatencyMeasurement::State::Succeeded:
+        latencyMeasurementLabel->setText(
+                tr("Measured %1 ms, applied whenever these devices are used "
+                   "with this sample rate and buffer size.")
+                        .arg(QString::number(roundTripMs, 'f', 3)));
+        m_bApplyingMeasuredLatency = true;
+        latencyCompensationSpinBox->setValue(roundTripMs);
+        m_bApplyingMeasuredLatency = false;
+        m_bLatencyChanged = false;
+        checkLatencyCompensation();
+        return;
+    case LatencyMeasurement::State::NoSignal:
+        latencyMeasurementLabel->setText(
+                tr("The clicks did not arrive at the input. Check the "
+                   "loopback and the input gain."));
+        return;
+    case LatencyMeasurement::State::NoisyInput:
+        latencyMeasurementLabel->setText(
+                tr("The input is too noisy. Lower the input gain or the noise "
+                   "in the room."));
+        return;
+    case LatencyMeasurement::State::Inconsistent:
+        latencyMeasurementLabel->setText(
+                tr("The latency was not stable, possibly because of buffer "
+                   "underflows. Try again or increase the audio buffer."));
+        return;
+    case LatencyMeasurement::State::Idle:
+    case LatencyMeasurement::State::Pending:
+    case LatencyMeasurement::State::Running:
+        latencyMeasurementLabel->clear();
+        return;
+    }
+}
+
 void DlgPrefSound::mainDelaySpinboxChanged(double value) {
     m_pMainDelay.set(value);
 }
@@ -1000,6 +1155,7 @@ void DlgPrefSound::checkLatencyCompensation() {
         micMonitorModeComboBox->setEnabled(true);
         if (configuredMicMonitorMode == EngineMixer::MicMonitorMode::DirectMonitor) {
             latencyCompensationSpinBox->setEnabled(true);
+            measureLatencyButton->setEnabled(true);
             QString lineBreak("<br/>");
             // TODO(Be): Make the "User Manual" text link to the manual.
             if (m_pLatencyCompensation.get() == 0.0) {
@@ -1007,8 +1163,8 @@ void DlgPrefSound::checkLatencyCompensation() {
                         tr("Microphone inputs are out of time in the record & "
                            "broadcast signal compared to what you hear.") +
                         lineBreak +
-                        tr("Measure round trip latency and enter it above for "
-                           "Microphone Latency Compensation to align "
+                        tr("Measure round trip latency with a loopback to "
+                           "set the Microphone Latency Compensation and align "
                            "microphone timing.") +
                         lineBreak +
                         tr("Refer to the Mixxx User Manual for details.") +
@@ -1017,9 +1173,8 @@ void DlgPrefSound::checkLatencyCompensation() {
             } else if (m_bLatencyChanged) {
                 latencyCompensationWarningLabel->setText(kWarningIconHtmlString +
                         tr("Configured latency has changed.") + lineBreak +
-                        tr("Remeasure round trip latency and enter it above "
-                           "for Microphone Latency Compensation to align "
-                           "microphone timing.") +
+                        tr("Remeasure round trip latency with a loopback to "
+                           "align microphone timing.") +
                         lineBreak +
                         tr("Refer to the Mixxx User Manual for details.") +
                         "</html>");
@@ -1029,11 +1184,13 @@ void DlgPrefSound::checkLatencyCompensation() {
             }
         } else {
             latencyCompensationSpinBox->setEnabled(false);
+            measureLatencyButton->setEnabled(false);
             latencyCompensationWarningLabel->hide();
         }
     } else {
         micMonitorModeComboBox->setEnabled(false);
         latencyCompensationSpinBox->setEnabled(false);
+        measureLatencyButton->setEnabled(false);
         latencyCompensationWarningLabel->hide();
     }
 }
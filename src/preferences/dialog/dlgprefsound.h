@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QTimer>
 #include <memory>
 
 #include "control/pollingcontrolproxy.h"
@@ -7,10 +8,12 @@
 #include "preferences/dialog/dlgpreferencepage.h"
 #include "preferences/dialog/ui_dlgprefsounddlg.h"
 #include "preferences/usersettings.h"
+#include "soundio/latencymeasurement.h"
 #include "soundio/sounddevice.h"
 #include "soundio/sounddevicestatus.h"
 #include "soundio/soundmanagerconfig.h"
 #include "util/parented_ptr.h"
+#include "util/realtime.h"
 
 class SoundManager;
 class PlayerManager;
@@ -45,6 +48,8 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     void slotUpdate() override; // called on show
     void slotApply() override;  // called on ok button
     void slotResetToDefaults() override;
+    void slotShow() override;
+    void slotHide() override;
     void bufferUnderflow(double count);
     void outputLatencyChanged(double latency);
     void latencyCompensationSpinboxChanged(double value);
@@ -74,6 +79,9 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     void deviceChannelsChanged();
     void configuredDeviceNotFound();
     void queryClicked();
+    void updateClockDrift();
+    void measureLatencyClicked();
+    void latencyMeasurementFinished(LatencyMeasurement::State state, double roundTripMs);
 #ifdef __RUBBERBAND__
     void updateKeylockDualThreadingCheckbox();
     void updateKeylockMultithreading(bool enabled);
@@ -81,6 +89,8 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
 
   private:
     void initializePaths();
+    void loadRealtimeSettings(const mixxx::realtime::Settings& settings);
+    void applyRealtimeSettings();
     void connectSoundItem(DlgPrefSoundItem *item);
     void loadSettings(const SoundManagerConfig &config);
     void insertItem(DlgPrefSoundItem *pItem, QVBoxLayout *pLayout);
@@ -102,12 +112,17 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     parented_ptr<ControlProxy> m_pMainEnabled;
     parented_ptr<ControlProxy> m_pMainMonoMixdown;
 
+    QTimer m_clockDriftTimer;
+
     QList<SoundDevicePointer> m_inputDevices;
     QList<SoundDevicePointer> m_outputDevices;
     QHash<DlgPrefSoundItem*, QPair<SoundDeviceId, int>> m_selectedOutputChannelIndices;
     QHash<DlgPrefSoundItem*, QPair<SoundDeviceId, int>> m_selectedInputChannelIndices;
     bool m_settingsModified;
     bool m_bLatencyChanged;
+    // Set while the spin box follows a measurement, that must not be
+    // forgotten like a value entered manually
+    bool m_bApplyingMeasuredLatency;
     bool m_bSkipConfigClear;
     bool m_loading;
 };
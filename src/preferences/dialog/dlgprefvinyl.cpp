@@ -165,6 +165,7 @@ void DlgPrefVinyl::slotResetToDefaults() {
     }
 
     SignalQualityEnable->setChecked(true);
+    ProcessInCallbackEnable->setChecked(false);
     SliderVinylGain->setValue(0);
     slotUpdateVinylGain();
 }
@@ -178,6 +179,8 @@ void DlgPrefVinyl::slotUpdate() {
 
     SignalQualityEnable->setChecked(
             (bool)config->getValue<bool>(ConfigKey(VINYL_PREF_KEY, "show_signal_quality")));
+    ProcessInCallbackEnable->setChecked(
+            config->getValue(ConfigKey(VINYL_PREF_KEY, "process_in_callback"), false));
 
     for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
         QString group = PlayerManager::groupForDeck(i);
@@ -271,6 +274,8 @@ void DlgPrefVinyl::slotApply() {
 
     config->set(ConfigKey(VINYL_PREF_KEY,"show_signal_quality"),
                 ConfigValue((int)(SignalQualityEnable->isChecked())));
+    config->setValue(ConfigKey(VINYL_PREF_KEY, "process_in_callback"),
+            ProcessInCallbackEnable->isChecked());
 
     m_pVCManager->requestReloadConfig();
     slotUpdate();
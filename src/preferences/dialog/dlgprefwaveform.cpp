@@ -149,6 +149,10 @@ DlgPrefWaveform::DlgPrefWaveform(
             &QCheckBox::clicked,
             this,
             &DlgPrefWaveform::slotSetWaveformOptionHighDetail);
+    connect(adaptiveToEngineLoadCheckBox,
+            &QCheckBox::toggled,
+            this,
+            &DlgPrefWaveform::slotSetAdaptiveToEngineLoad);
     connect(defaultZoomComboBox,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this,
@@ -185,6 +189,10 @@ DlgPrefWaveform::DlgPrefWaveform(
             &WaveformWidgetFactory::waveformMeasured,
             this,
             &DlgPrefWaveform::slotWaveformMeasured);
+    connect(factory,
+            &WaveformWidgetFactory::frameTimingsMeasured,
+            this,
+            &DlgPrefWaveform::slotFrameTimingsMeasured);
     connect(waveformOverviewComboBox,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this,
@@ -282,6 +290,7 @@ void DlgPrefWaveform::slotUpdate() {
 
     frameRateSpinBox->setValue(factory->getFrameRate());
     frameRateSlider->setValue(factory->getFrameRate());
+    adaptiveToEngineLoadCheckBox->setChecked(factory->isAdaptiveToEngineLoad());
     endOfTrackWarningTimeSpinBox->setValue(factory->getEndOfTrackWarningTime());
     endOfTrackWarningTimeSlider->setValue(factory->getEndOfTrackWarningTime());
     synchronizeZoomCheckBox->setChecked(factory->isZoomSync());
@@ -382,6 +391,7 @@ void DlgPrefWaveform::slotResetToDefaults() {
 
     // 60FPS is the default
     frameRateSlider->setValue(60);
+    adaptiveToEngineLoadCheckBox->setChecked(true);
     endOfTrackWarningTimeSlider->setValue(30);
 
     // Waveform caching enabled.
@@ -589,6 +599,10 @@ void DlgPrefWaveform::slotSetWaveformOverviewType() {
     m_pTypeControl->forceSet(static_cast<double>(type));
 }
 
+void DlgPrefWaveform::slotSetAdaptiveToEngineLoad(bool adaptive) {
+    WaveformWidgetFactory::instance()->setAdaptiveToEngineLoad(adaptive);
+}
+
 void DlgPrefWaveform::slotSetDefaultZoom(int index) {
     WaveformWidgetFactory::instance()->setDefaultZoom(index + 1);
 }
@@ -624,9 +638,18 @@ void DlgPrefWaveform::slotSetOverviewMinuteMarkers(bool draw) {
 }
 
 void DlgPrefWaveform::slotWaveformMeasured(float frameRate, int droppedFrames) {
-    frameRateAverage->setText(
-            QString::number((double)frameRate, 'f', 2) + " : " +
-            tr("dropped frames") + " " + QString::number(droppedFrames));
+    m_frameRateText = QString::number((double)frameRate, 'f', 2) + " : " +
+            tr("dropped frames") + " " + QString::number(droppedFrames);
+    frameRateAverage->setText(m_frameRateText);
+}
+
+void DlgPrefWaveform::slotFrameTimingsMeasured(
+        double renderMillis, double maxGuiLatencyMillis) {
+    // Always emitted after waveformMeasured()
+    frameRateAverage->setText(m_frameRateText + " : " +
+            tr("render time %1 ms, max. latency %2 ms")
+                    .arg(QString::number(renderMillis, 'f', 2),
+                            QString::number(maxGuiLatencyMillis, 'f', 2)));
 }
 
 void DlgPrefWaveform::slotClearCachedWaveforms() {
@@ -46,6 +46,7 @@ class DlgPrefWaveform : public DlgPreferencePage, public Ui::DlgPrefWaveformDlg
     }
 #endif
     void slotSetWaveformOverviewType();
+    void slotSetAdaptiveToEngineLoad(bool adaptive);
     void slotSetDefaultZoom(int index);
     void slotSetZoomSynchronization(bool checked);
     void slotSetVisualGainAll(double gain);
@@ -55,6 +56,7 @@ class DlgPrefWaveform : public DlgPreferencePage, public Ui::DlgPrefWaveformDlg
     void slotSetNormalizeOverview(bool normalize);
     void slotSetOverviewMinuteMarkers(bool minuteMarkers);
     void slotWaveformMeasured(float frameRate, int droppedFrames);
+    void slotFrameTimingsMeasured(double renderMillis, double maxGuiLatencyMillis);
     void slotClearCachedWaveforms();
     void slotSetBeatGridAlpha(int alpha);
     void slotSetPlayMarkerPosition(int position);
@@ -82,4 +84,5 @@ class DlgPrefWaveform : public DlgPreferencePage, public Ui::DlgPrefWaveformDlg
 
     UserSettingsPointer m_pConfig;
     std::shared_ptr<Library> m_pLibrary;
+    QString m_frameRateText;
 };
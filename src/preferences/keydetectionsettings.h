@@ -13,6 +13,7 @@
 // KEY_CONFIG_KEY Preferences
 #define KEY_DETECTION_ENABLED "KeyDetectionEnabled"
 #define KEY_FAST_ANALYSIS "FastAnalysisEnabled"
+#define KEY_SEGMENT_ANALYSIS "SegmentAnalysisEnabled"
 #define KEY_REANALYZE_WHEN_SETTINGS_CHANGE "ReanalyzeWhenSettingsChange"
 
 #define KEY_NOTATION "KeyNotation"
@@ -43,6 +44,9 @@ class KeyDetectionSettings {
     DEFINE_PREFERENCE_HELPERS(FastAnalysis, bool,
                               KEY_CONFIG_KEY, KEY_FAST_ANALYSIS, false);
 
+    DEFINE_PREFERENCE_HELPERS(SegmentAnalysis, bool,
+                              KEY_CONFIG_KEY, KEY_SEGMENT_ANALYSIS, false);
+
     DEFINE_PREFERENCE_HELPERS(ReanalyzeWhenSettingsChange, bool,
                               KEY_CONFIG_KEY, KEY_REANALYZE_WHEN_SETTINGS_CHANGE, false);
 
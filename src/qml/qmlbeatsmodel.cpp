@@ -16,13 +16,28 @@ QmlBeatsModel::QmlBeatsModel(
 }
 
 void QmlBeatsModel::setBeats(const BeatsPointer pBeats, audio::FramePos trackEndPosition) {
-    beginResetModel();
-    m_numBeats = 0;
+    const int numBeats = pBeats
+            ? pBeats->numBeatsInRange(audio::kStartFramePos, trackEndPosition)
+            : 0;
+    if (pBeats == m_pBeats && numBeats == m_numBeats) {
+        return;
+    }
+
+    if (numBeats < m_numBeats) {
+        beginRemoveRows(QModelIndex(), numBeats, m_numBeats - 1);
+        m_numBeats = numBeats;
+        endRemoveRows();
+    }
     m_pBeats = pBeats;
-    if (pBeats != nullptr) {
-        m_numBeats = pBeats->numBeatsInRange(audio::kStartFramePos, trackEndPosition);
+    // Every beat might have moved, e.g. when adjusting the beatgrid
+    if (m_numBeats > 0) {
+        emit dataChanged(index(0), index(m_numBeats - 1));
+    }
+    if (numBeats > m_numBeats) {
+        beginInsertRows(QModelIndex(), m_numBeats, numBeats - 1);
+        m_numBeats = numBeats;
+        endInsertRows();
     }
-    endResetModel();
 }
 
 QVariant QmlBeatsModel::data(const QModelIndex& index, int role) const {
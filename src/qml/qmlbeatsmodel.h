@@ -17,6 +17,8 @@ class QmlBeatsModel : public QAbstractListModel {
 
     explicit QmlBeatsModel(QObject* parent = nullptr);
 
+    /// Only the rows at the end are inserted or removed if the number of
+    /// beats changes, the delegates of the other beats are updated in place.
     void setBeats(const BeatsPointer pBeats, audio::FramePos trackEndPosition);
 
     QVariant data(const QModelIndex& index, int role) const override;
@@ -23,9 +23,61 @@ QmlCuesModel::QmlCuesModel(
 }
 
 void QmlCuesModel::setCues(QList<CuePointer> cues) {
-    beginResetModel();
-    m_cues = QList<CuePointer>(std::move(cues));
-    endResetModel();
+    // Remove the rows of the cues that are gone, in ranges from the end
+    for (int row = m_cues.size() - 1; row >= 0;) {
+        if (cues.contains(m_cues.at(row))) {
+            --row;
+            continue;
+        }
+        const int lastRow = row;
+        while (row > 0 && !cues.contains(m_cues.at(row - 1))) {
+            --row;
+        }
+        beginRemoveRows(QModelIndex(), row, lastRow);
+        m_cues.erase(m_cues.begin() + row, m_cues.begin() + lastRow + 1);
+        endRemoveRows();
+        --row;
+    }
+
+    // The remaining cues must keep their order, which is the order of
+    // their positions in the track and rarely changes
+    int remainingIndex = 0;
+    for (const auto& pCue : std::as_const(cues)) {
+        if (remainingIndex < m_cues.size() && m_cues.at(remainingIndex) == pCue) {
+            ++remainingIndex;
+        } else if (m_cues.contains(pCue)) {
+            beginResetModel();
+            m_cues = std::move(cues);
+            endResetModel();
+            return;
+        }
+    }
+
+    // Insert the rows of the new cues
+    for (int row = 0; row < cues.size();) {
+        if (row < m_cues.size() && m_cues.at(row) == cues.at(row)) {
+            ++row;
+            continue;
+        }
+        // Up to the next remaining cue
+        const int firstRow = row;
+        const bool hasNextRow = firstRow < m_cues.size();
+        while (row < cues.size() &&
+                (!hasNextRow || cues.at(row) != m_cues.at(firstRow))) {
+            ++row;
+        }
+        beginInsertRows(QModelIndex(), firstRow, row - 1);
+        for (int i = firstRow; i < row; ++i) {
+            m_cues.insert(i, cues.at(i));
+        }
+        endInsertRows();
+    }
+    DEBUG_ASSERT(m_cues == cues);
+
+    // The properties of the remaining cues might have changed
+    if (!m_cues.isEmpty()) {
+        emit dataChanged(index(0), index(m_cues.size() - 1));
+    }
 }
 
 QVariant QmlCuesModel::data(const QModelIndex& index, int role) const {
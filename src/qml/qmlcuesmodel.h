@@ -21,6 +21,8 @@ class QmlCuesModel : public QAbstractListModel {
 
     explicit QmlCuesModel(QObject* pParent = nullptr);
 
+    /// Only inserts and removes the rows of cues that have been added or
+    /// removed, the delegates of the other cues are updated in place.
     void setCues(QList<CuePointer> cues);
 
     QVariant data(const QModelIndex& index, int role) const override;
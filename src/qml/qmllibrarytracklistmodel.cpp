@@ -13,12 +13,56 @@ const QHash<int, QByteArray> kRoleNames = {
         {QmlLibraryTrackListModel::AlbumArtistRole, "albumArtist"},
         {QmlLibraryTrackListModel::FileUrlRole, "fileUrl"},
 };
+
+constexpr int kUnresolvedColumn = -2;
+
+ColumnCache::Column columnForRole(int role) {
+    switch (role) {
+    case QmlLibraryTrackListModel::TitleRole:
+        return ColumnCache::COLUMN_LIBRARYTABLE_TITLE;
+    case QmlLibraryTrackListModel::ArtistRole:
+        return ColumnCache::COLUMN_LIBRARYTABLE_ARTIST;
+    case QmlLibraryTrackListModel::AlbumRole:
+        return ColumnCache::COLUMN_LIBRARYTABLE_ALBUM;
+    case QmlLibraryTrackListModel::AlbumArtistRole:
+        return ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST;
+    case QmlLibraryTrackListModel::FileUrlRole:
+        return ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION;
+    default:
+        DEBUG_ASSERT(!"unknown role");
+        return ColumnCache::COLUMN_LIBRARYTABLE_INVALID;
+    }
 }
+} // namespace
 
 QmlLibraryTrackListModel::QmlLibraryTrackListModel(LibraryTableModel* pModel, QObject* pParent)
         : QIdentityProxyModel(pParent) {
+    m_sourceColumns.fill(kUnresolvedColumn);
     pModel->select();
     setSourceModel(pModel);
+    // The columns might change. Rows are inserted and removed in ranges
+    // by the source model and forwarded as is.
+    connect(pModel,
+            &QAbstractItemModel::modelReset,
+            this,
+            [this]() {
+                m_sourceColumns.fill(kUnresolvedColumn);
+            });
+}
+
+int QmlLibraryTrackListModel::sourceColumn(int role) const {
+    if (role < TitleRole || role >= TitleRole + kRoleCount) {
+        return -1;
+    }
+    int& column = m_sourceColumns[role - TitleRole];
+    if (column == kUnresolvedColumn) {
+        const auto pSourceModel = static_cast<LibraryTableModel*>(sourceModel());
+        VERIFY_OR_DEBUG_ASSERT(pSourceModel) {
+            return -1;
+        }
+        column = pSourceModel->fieldIndex(columnForRole(role));
+    }
+    return column;
 }
 
 QVariant QmlLibraryTrackListModel::data(const QModelIndex& proxyIndex, int role) const {
@@ -30,48 +74,25 @@ QVariant QmlLibraryTrackListModel::data(const QModelIndex& proxyIndex, int role)
         return {};
     }
 
-    const auto pSourceModel = static_cast<LibraryTableModel*>(sourceModel());
-    VERIFY_OR_DEBUG_ASSERT(pSourceModel) {
+    if (proxyIndex.column() > 0) {
         return {};
     }
 
-    if (proxyIndex.column() > 0) {
+    const int column = sourceColumn(role);
+    if (column < 0) {
         return {};
     }
 
-    int column = -1;
-    switch (role) {
-    case TitleRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TITLE);
-        break;
-    case ArtistRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ARTIST);
-        break;
-    case AlbumRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ALBUM);
-        break;
-    case AlbumArtistRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST);
-        break;
-    case FileUrlRole: {
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
-        const QString location = QIdentityProxyModel::data(
-                proxyIndex.siblingAtColumn(column), Qt::DisplayRole)
-                                         .toString();
+    const QVariant value =
+            QIdentityProxyModel::data(proxyIndex.siblingAtColumn(column), Qt::DisplayRole);
+    if (role == FileUrlRole) {
+        const QString location = value.toString();
         if (location.isEmpty()) {
             return {};
         }
         return QUrl::fromLocalFile(location);
     }
-    default:
-        break;
-    }
-
-    if (column < 0) {
-        return {};
-    }
-
-    return QIdentityProxyModel::data(proxyIndex.siblingAtColumn(column), Qt::DisplayRole);
+    return value;
 }
 
 int QmlLibraryTrackListModel::columnCount(const QModelIndex& parent) const {
@@ -1,6 +1,7 @@
 #pragma once
 #include <QIdentityProxyModel>
 #include <QQmlEngine>
+#include <array>
 
 class LibraryTableModel;
 
@@ -21,6 +22,7 @@ class QmlLibraryTrackListModel : public QIdentityProxyModel {
         FileUrlRole,
     };
     Q_ENUM(Roles);
+    static constexpr int kRoleCount = FileUrlRole - TitleRole + 1;
 
     QmlLibraryTrackListModel(LibraryTableModel* pModel, QObject* pParent = nullptr);
     ~QmlLibraryTrackListModel() = default;
@@ -29,6 +31,14 @@ class QmlLibraryTrackListModel : public QIdentityProxyModel {
     int columnCount(const QModelIndex& index = QModelIndex()) const override;
     QHash<int, QByteArray> roleNames() const override;
     Q_INVOKABLE QVariant get(int row) const;
+
+  private:
+    /// Returns the column of the source model for a role. Resolved when the
+    /// role is requested for the first time, because delegates request the
+    /// roles of every row while scrolling.
+    int sourceColumn(int role) const;
+
+    mutable std::array<int, kRoleCount> m_sourceColumns;
 };
 
 } // namespace qml
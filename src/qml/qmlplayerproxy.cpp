@@ -27,16 +27,31 @@
 namespace mixxx {
 namespace qml {
 
+namespace {
+
+// About one frame at 60 Hz
+constexpr int kModelUpdateIntervalMillis = 16;
+
+} // namespace
+
 QmlPlayerProxy::QmlPlayerProxy(BaseTrackPlayer* pTrackPlayer, QObject* parent)
         : QObject(parent),
           m_pTrackPlayer(pTrackPlayer),
           m_pBeatsModel(new QmlBeatsModel(this)),
-          m_pHotcuesModel(new QmlCuesModel(this))
+          m_pHotcuesModel(new QmlCuesModel(this)),
+          m_bBeatsModelDirty(false),
+          m_bHotcuesModelDirty(false)
 #ifdef __STEM__
           ,
           m_pStemsModel(std::make_unique<QmlStemsModel>(this))
 #endif
 {
+    m_modelUpdateTimer.setSingleShot(true);
+    m_modelUpdateTimer.setInterval(kModelUpdateIntervalMillis);
+    connect(&m_modelUpdateTimer,
+            &QTimer::timeout,
+            this,
+            &QmlPlayerProxy::slotUpdateModels);
     connect(m_pTrackPlayer,
             &BaseTrackPlayer::loadingTrack,
             this,
@@ -236,6 +251,33 @@ void QmlPlayerProxy::slotWaveformChanged() {
 }
 
 void QmlPlayerProxy::slotBeatsChanged() {
+    m_bBeatsModelDirty = true;
+    scheduleModelUpdate();
+}
+
+void QmlPlayerProxy::slotHotcuesChanged() {
+    m_bHotcuesModelDirty = true;
+    scheduleModelUpdate();
+}
+
+void QmlPlayerProxy::scheduleModelUpdate() {
+    if (!m_modelUpdateTimer.isActive()) {
+        m_modelUpdateTimer.start();
+    }
+}
+
+void QmlPlayerProxy::slotUpdateModels() {
+    if (m_bBeatsModelDirty) {
+        m_bBeatsModelDirty = false;
+        updateBeatsModel();
+    }
+    if (m_bHotcuesModelDirty) {
+        m_bHotcuesModelDirty = false;
+        updateHotcuesModel();
+    }
+}
+
+void QmlPlayerProxy::updateBeatsModel() {
     VERIFY_OR_DEBUG_ASSERT(m_pBeatsModel != nullptr) {
         return;
     }
@@ -265,7 +307,7 @@ void QmlPlayerProxy::slotStemsChanged() {
 }
 #endif
 
-void QmlPlayerProxy::slotHotcuesChanged() {
+void QmlPlayerProxy::updateHotcuesModel() {
     VERIFY_OR_DEBUG_ASSERT(m_pHotcuesModel != nullptr) {
         return;
     }
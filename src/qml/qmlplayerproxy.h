@@ -4,6 +4,7 @@
 #include <QPointer>
 #include <QQmlEngine>
 #include <QString>
+#include <QTimer>
 #include <QUrl>
 
 #include "mixer/basetrackplayer.h"
@@ -151,13 +152,25 @@ class QmlPlayerProxy : public QObject {
     void waveformTextureSizeChanged();
     void waveformTextureStrideChanged();
 
+  private slots:
+    void slotUpdateModels();
+
   private:
+    // The track emits many updates in a row, e.g. while analyzing or
+    // dragging a cue. The models are updated at most once per frame.
+    void scheduleModelUpdate();
+    void updateBeatsModel();
+    void updateHotcuesModel();
+
     std::vector<WaveformFilteredData> m_waveformData;
     QImage m_waveformTexture;
     QPointer<BaseTrackPlayer> m_pTrackPlayer;
     TrackPointer m_pCurrentTrack;
     QmlBeatsModel* m_pBeatsModel;
     QmlCuesModel* m_pHotcuesModel;
+    QTimer m_modelUpdateTimer;
+    bool m_bBeatsModelDirty;
+    bool m_bHotcuesModelDirty;
 #ifdef __STEM__
     std::unique_ptr<QmlStemsModel> m_pStemsModel;
 #endif
@@ -0,0 +1,390 @@
+#include "recording/recordingdiskwriter.h"
+
+#include <QFile>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("RecordingDiskWriter");
+
+// The offset, size and memory of O_DIRECT writes must be aligned to the
+// logical block size of the file system, which doesn't exceed a page.
+constexpr qint64 kAlignment = 4096;
+
+// Up to 8 MiB are queued per file, i.e. about 20 seconds of a stereo
+// recording with 32 bit float samples at 48 kHz, e.g. while the disk stalls.
+// The small blocks of the header updates are not counted.
+constexpr int kMaxBlocksPerFile = 8;
+
+// The capacity of the blocks for patches at an earlier position, e.g. the
+// header of a WAV or AIFF file
+constexpr qint64 kPatchBlockSize = kAlignment;
+
+} // anonymous namespace
+
+struct RecordingDiskWriter::FileState {
+    explicit FileState(const QString& fileName)
+            : file(fileName),
+              directFd(-1),
+              failed(false) {
+    }
+
+    ~FileState() {
+        closeFile();
+    }
+
+    void closeFile() {
+#ifdef __linux__
+        if (directFd >= 0) {
+            ::close(directFd);
+            directFd = -1;
+        }
+#endif
+        file.close();
+    }
+
+    QFile file;
+    // A second descriptor of the same file that is opened with O_DIRECT
+    int directFd;
+    std::atomic<bool> failed;
+};
+
+struct RecordingDiskWriter::Block {
+    explicit Block(qint64 capacity = kBlockSize)
+            : capacity(capacity),
+              offset(0),
+              size(0),
+              queuedSize(0),
+              closeFile(false),
+              // Memory is allocated with the alignment as padding
+              storage(std::make_unique<char[]>(capacity + kAlignment)),
+              pData(reinterpret_cast<char*>(
+                      (reinterpret_cast<std::uintptr_t>(storage.get()) + kAlignment - 1) &
+                      ~static_cast<std::uintptr_t>(kAlignment - 1))) {
+    }
+
+    // kBlockSize for the blocks of the budget
+    const qint64 capacity;
+    std::shared_ptr<FileState> pFile;
+    qint64 offset;
+    qint64 size;
+    // The leading bytes that have already been queued by File::sync()
+    qint64 queuedSize;
+    bool closeFile;
+    const std::unique_ptr<char[]> storage;
+    char* const pData;
+};
+
+RecordingDiskWriter::RecordingDiskWriter(bool directIO)
+        : m_directIO(directIO),
+          m_allocatedBlocks(0),
+          m_openFiles(0),
+          m_stop(false) {
+#ifndef __linux__
+    if (m_directIO) {
+        kLogger.info() << "Direct I/O is only supported on Linux";
+    }
+#endif
+}
+
+RecordingDiskWriter::~RecordingDiskWriter() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_stop = true;
+        m_blockQueued.wakeAll();
+    }
+    wait();
+    // The thread was never started
+    for (const auto& pBlock : m_pendingBlocks) {
+        writeBlock(*pBlock);
+    }
+}
+
+std::unique_ptr<RecordingDiskWriter::File> RecordingDiskWriter::createFile(
+        const QString& fileName) {
+    auto pState = std::make_shared<FileState>(fileName);
+    // Unbuffered, because the blocks are large and O_DIRECT writes must not
+    // be reordered with the buffered ones
+    if (!pState->file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        kLogger.warning()
+                << "Failed to open"
+                << fileName
+                << pState->file.errorString();
+        return nullptr;
+    }
+#ifdef __linux__
+    if (m_directIO) {
+        pState->directFd = ::open(QFile::encodeName(fileName).constData(),
+                O_WRONLY | O_DIRECT);
+        if (pState->directFd < 0) {
+            // E.g. tmpfs doesn't support O_DIRECT
+            kLogger.info()
+                    << "Failed to open"
+                    << fileName
+                    << "for direct I/O, writing it through the page cache";
+        }
+    }
+#endif
+    {
+        const auto locker = lockMutex(&m_mutex);
+        ++m_openFiles;
+    }
+    return std::unique_ptr<File>(new File(this, std::move(pState)));
+}
+
+std::unique_ptr<RecordingDiskWriter::Block> RecordingDiskWriter::takeFreeBlock(
+        const std::shared_ptr<FileState>& pFile, qint64 offset) {
+    auto locker = lockMutex(&m_mutex);
+    // Every open file has a partial block, so there is always one more
+    // block than the limit for those that are queued
+    while (m_freeBlocks.empty() &&
+            m_allocatedBlocks >= std::max(m_openFiles, 1) * kMaxBlocksPerFile &&
+            isRunning()) {
+        m_blockWritten.wait(&m_mutex);
+    }
+    std::unique_ptr<Block> pBlock;
+    if (!m_freeBlocks.empty()) {
+        pBlock = std::move(m_freeBlocks.back());
+        m_freeBlocks.pop_back();
+    } else {
+        ++m_allocatedBlocks;
+        locker.unlock();
+        pBlock = std::make_unique<Block>();
+    }
+    pBlock->pFile = pFile;
+    pBlock->offset = offset;
+    pBlock->size = 0;
+    pBlock->queuedSize = 0;
+    pBlock->closeFile = false;
+    return pBlock;
+}
+
+// static
+std::unique_ptr<RecordingDiskWriter::Block> RecordingDiskWriter::makeSmallBlock(
+        const std::shared_ptr<FileState>& pFile, qint64 offset, qint64 capacity) {
+    DEBUG_ASSERT(capacity < kBlockSize);
+    auto pBlock = std::make_unique<Block>(capacity);
+    pBlock->pFile = pFile;
+    pBlock->offset = offset;
+    return pBlock;
+}
+
+void RecordingDiskWriter::enqueueBlock(std::unique_ptr<Block> pBlock) {
+    const auto locker = lockMutex(&m_mutex);
+    if (pBlock->closeFile) {
+        --m_openFiles;
+    }
+    m_pendingBlocks.push_back(std::move(pBlock));
+    m_blockQueued.wakeOne();
+}
+
+void RecordingDiskWriter::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("RecordingDiskWriter"));
+    auto locker = lockMutex(&m_mutex);
+    while (true) {
+        while (m_pendingBlocks.empty() && !m_stop) {
+            m_blockQueued.wait(&m_mutex);
+        }
+        if (m_pendingBlocks.empty()) {
+            // Only stop after all pending blocks have been written
+            break;
+        }
+        auto pBlock = std::move(m_pendingBlocks.front());
+        m_pendingBlocks.pop_front();
+        locker.unlock();
+
+        writeBlock(*pBlock);
+        pBlock->pFile.reset();
+        if (pBlock->capacity < kBlockSize) {
+            // Not part of the budget
+            pBlock.reset();
+            locker.relock();
+            continue;
+        }
+
+        locker.relock();
+        m_freeBlocks.push_back(std::move(pBlock));
+        m_blockWritten.wakeAll();
+    }
+}
+
+void RecordingDiskWriter::writeBlock(const Block& block) {
+    FileState* const pFile = block.pFile.get();
+    VERIFY_OR_DEBUG_ASSERT(pFile) {
+        return;
+    }
+    if (block.size > 0 && !pFile->failed.load(std::memory_order_relaxed)) {
+        bool written = false;
+#ifdef __linux__
+        if (pFile->directFd >= 0 &&
+                block.offset % kAlignment == 0 &&
+                block.size % kAlignment == 0) {
+            written = ::pwrite(pFile->directFd,
+                              block.pData,
+                              static_cast<std::size_t>(block.size),
+                              static_cast<off_t>(block.offset)) == block.size;
+            if (!written) {
+                // E.g. the file system requires a larger alignment
+                kLogger.info()
+                        << "Direct I/O failed for"
+                        << pFile->file.fileName()
+                        << "- writing it through the page cache";
+                ::close(pFile->directFd);
+                pFile->directFd = -1;
+            }
+        }
+#endif
+        if (!written) {
+            written = pFile->file.seek(block.offset) &&
+                    pFile->file.write(block.pData, block.size) == block.size;
+        }
+        if (!written) {
+            kLogger.warning()
+                    << "Failed to write"
+                    << block.size
+                    << "bytes to"
+                    << pFile->file.fileName();
+            pFile->failed.store(true, std::memory_order_relaxed);
+        }
+    }
+    if (block.closeFile) {
+        if (pFile->failed.load(std::memory_order_relaxed)) {
+            kLogger.warning()
+                    << "The recording"
+                    << pFile->file.fileName()
+                    << "is incomplete";
+        }
+        pFile->closeFile();
+    }
+}
+
+RecordingDiskWriter::File::File(
+        RecordingDiskWriter* pWriter, std::shared_ptr<FileState> pState)
+        : m_pWriter(pWriter),
+          m_pState(std::move(pState)),
+          m_position(0),
+          m_size(0),
+          m_closed(false) {
+}
+
+RecordingDiskWriter::File::~File() {
+    close();
+}
+
+void RecordingDiskWriter::File::write(const char* pData, qint64 size) {
+    VERIFY_OR_DEBUG_ASSERT(!m_closed) {
+        return;
+    }
+    while (size > 0) {
+        if (!m_pBlock) {
+            // Patches of an earlier range, e.g. the header, are small
+            m_pBlock = (m_pAppendBlock || m_position < m_size)
+                    ? makeSmallBlock(m_pState, m_position, kPatchBlockSize)
+                    : m_pWriter->takeFreeBlock(m_pState, m_position);
+        }
+        const qint64 blockPosition = m_position - m_pBlock->offset;
+        qint64 chunkSize = std::min(size, m_pBlock->capacity - blockPosition);
+        if (m_pAppendBlock) {
+            // Don't overwrite the bytes that are still collected for the
+            // aligned block
+            chunkSize = std::min(chunkSize, m_pAppendBlock->offset - m_position);
+        }
+        std::memcpy(m_pBlock->pData + blockPosition, pData, chunkSize);
+        m_pBlock->size = std::max(m_pBlock->size, blockPosition + chunkSize);
+        m_position += chunkSize;
+        pData += chunkSize;
+        size -= chunkSize;
+        if (blockPosition + chunkSize == m_pBlock->capacity) {
+            m_pWriter->enqueueBlock(std::move(m_pBlock));
+        }
+        if (m_pAppendBlock && m_position == m_pAppendBlock->offset) {
+            if (m_pBlock) {
+                m_pWriter->enqueueBlock(std::move(m_pBlock));
+            }
+            m_pBlock = std::move(m_pAppendBlock);
+        }
+    }
+    m_size = std::max(m_size, m_position);
+}
+
+void RecordingDiskWriter::File::seek(qint64 position) {
+    if (position == m_position) {
+        return;
+    }
+    if (m_pBlock &&
+            position >= m_pBlock->offset &&
+            position <= m_pBlock->offset + m_pBlock->size) {
+        m_position = position;
+        return;
+    }
+    if (m_pAppendBlock) {
+        // Leaving a patched range, e.g. the header of a WAV file
+        if (m_pBlock) {
+            m_pWriter->enqueueBlock(std::move(m_pBlock));
+        }
+        if (position >= m_pAppendBlock->offset) {
+            if (position <= m_pAppendBlock->offset + m_pAppendBlock->size) {
+                m_pBlock = std::move(m_pAppendBlock);
+            } else {
+                m_pWriter->enqueueBlock(std::move(m_pAppendBlock));
+            }
+        }
+    } else if (m_pBlock) {
+        if (position < m_pBlock->offset) {
+            // The partial block is kept for the writes that continue at
+            // its end, which keeps the following blocks aligned. The bytes
+            // that have been collected so far are queued before the patch,
+            // so the file is consistent if it isn't closed properly.
+            sync();
+            m_pAppendBlock = std::move(m_pBlock);
+        } else {
+            m_pWriter->enqueueBlock(std::move(m_pBlock));
+        }
+    }
+    m_position = position;
+}
+
+void RecordingDiskWriter::File::sync() {
+    DEBUG_ASSERT(m_pBlock);
+    const qint64 unqueuedSize = m_pBlock->size - m_pBlock->queuedSize;
+    if (unqueuedSize <= 0) {
+        return;
+    }
+    auto pCopy = makeSmallBlock(
+            m_pState, m_pBlock->offset + m_pBlock->queuedSize, unqueuedSize);
+    std::memcpy(pCopy->pData, m_pBlock->pData + m_pBlock->queuedSize, unqueuedSize);
+    pCopy->size = unqueuedSize;
+    m_pBlock->queuedSize = m_pBlock->size;
+    m_pWriter->enqueueBlock(std::move(pCopy));
+}
+
+void RecordingDiskWriter::File::close() {
+    if (m_closed) {
+        return;
+    }
+    if (m_pAppendBlock) {
+        if (m_pBlock) {
+            m_pWriter->enqueueBlock(std::move(m_pBlock));
+        }
+        m_pBlock = std::move(m_pAppendBlock);
+    }
+    if (!m_pBlock) {
+        // Only closes the file
+        m_pBlock = makeSmallBlock(m_pState, m_position, 0);
+    }
+    m_pBlock->closeFile = true;
+    m_pWriter->enqueueBlock(std::move(m_pBlock));
+    m_closed = true;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/// Writes the files of a multi-track recording in a dedicated thread.
+///
+/// The encoder of each track appends to its own File, which collects the
+/// encoded bytes in large blocks. Full blocks are queued and written by the
+/// writer thread, so the encoders never wait for the disk until the queue
+/// is full.
+///
+/// The blocks are aligned in memory and in the file. Writes at an earlier
+/// position, e.g. the header that is updated periodically, are queued as
+/// separate blocks while the block at the end of the file is kept
+/// collecting. On Linux this allows to bypass the page cache with O_DIRECT,
+/// which avoids that long recordings evict the library and the decoded
+/// tracks from the cache. All other writes are written normally.
+///
+/// The number of queued blocks is limited per open file, so each track of
+/// a multi-track recording has the same reserve for stalls of the disk.
+/// The patches and the copies of the partial block that are queued when the
+/// header is updated are small and are kept out of this budget.
+///
+/// Write failures are logged by the writer thread, when they occur and
+/// again when the incomplete file is closed.
+///
+/// All methods are thread-safe.
+class RecordingDiskWriter : public QThread {
+  public:
+    class File;
+
+    explicit RecordingDiskWriter(bool directIO);
+    /// Writes all pending blocks and closes their files.
+    ~RecordingDiskWriter() override;
+
+    /// Truncates or creates the file. Returns nullptr if it can't be
+    /// opened for writing.
+    std::unique_ptr<File> createFile(const QString& fileName);
+
+    /// The size of the blocks that are written at once.
+    static constexpr qint64 kBlockSize = 1024 * 1024;
+
+  private:
+    struct Block;
+    struct FileState;
+
+    void run() override;
+
+    // Blocks while too many blocks are pending
+    std::unique_ptr<Block> takeFreeBlock(
+            const std::shared_ptr<FileState>& pFile, qint64 offset);
+    // Allocates a block outside of the budget that is freed after it has
+    // been written
+    static std::unique_ptr<Block> makeSmallBlock(
+            const std::shared_ptr<FileState>& pFile, qint64 offset, qint64 capacity);
+    void enqueueBlock(std::unique_ptr<Block> pBlock);
+    void writeBlock(const Block& block);
+
+    const bool m_directIO;
+
+    QMutex m_mutex;
+    QWaitCondition m_blockQueued;
+    QWaitCondition m_blockWritten;
+    std::deque<std::unique_ptr<Block>> m_pendingBlocks;
+    std::vector<std::unique_ptr<Block>> m_freeBlocks;
+    int m_allocatedBlocks;
+    int m_openFiles;
+    bool m_stop;
+
+    friend class RecordingDiskWriterTest;
+};
+
+/// The encoder side of a file that is written by a RecordingDiskWriter.
+/// Not thread-safe, must only be used by a single thread.
+class RecordingDiskWriter::File {
+  public:
+    /// Closes the file
+    ~File();
+
+    void write(const char* pData, qint64 size);
+    /// Subsequent writes overwrite the file at this byte position.
+    void seek(qint64 position);
+    qint64 position() const {
+        return m_position;
+    }
+    qint64 size() const {
+        return m_size;
+    }
+
+    /// Queues the remaining bytes. The file is closed by the writer thread
+    /// after they have been written.
+    void close();
+
+  private:
+    friend class RecordingDiskWriter;
+
+    File(RecordingDiskWriter* pWriter, std::shared_ptr<FileState> pState);
+
+    // Queues the bytes of m_pBlock that haven't been queued yet
+    void sync();
+
+    RecordingDiskWriter* const m_pWriter;
+    const std::shared_ptr<FileState> m_pState;
+    // The block that is currently written
+    std::unique_ptr<Block> m_pBlock;
+    // The block at the end of the file while an earlier range is written
+    std::unique_ptr<Block> m_pAppendBlock;
+    qint64 m_position;
+    qint64 m_size;
+    bool m_closed;
+};
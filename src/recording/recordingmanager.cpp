@@ -9,10 +9,12 @@
 #include "control/controlpushbutton.h"
 #include "engine/enginemixer.h"
 #include "engine/sidechain/enginerecord.h"
+#include "engine/sidechain/enginerecordtrack.h"
 #include "engine/sidechain/enginesidechain.h"
 #include "errordialoghandler.h"
 #include "moc_recordingmanager.cpp"
 #include "recording/defs_recording.h"
+#include "recording/recordingdiskwriter.h"
 
 #define MIN_DISK_FREE 1024 * 1024 * 1024ll // one gibibyte
 
@@ -44,7 +46,13 @@ RecordingManager::RecordingManager(UserSettingsPointer pConfig, EngineMixer* pEn
     // Register EngineRecord with the engine sidechain.
     EngineSideChain* pSidechain = pEngine->getSideChain();
     if (pSidechain) {
-        EngineRecord* pEngineRecord = new EngineRecord(m_pConfig);
+        // Writes the files of the mix and of all tracks. Bypassing the page
+        // cache requires a restart, like the settings below.
+        auto pDiskWriter = std::make_shared<RecordingDiskWriter>(
+                m_pConfig->getValue(ConfigKey(RECORDING_PREF_KEY, "direct_io"), false));
+        pDiskWriter->start();
+
+        EngineRecord* pEngineRecord = new EngineRecord(m_pConfig, pDiskWriter);
         connect(pEngineRecord,
                 &EngineRecord::isRecording,
                 this,
@@ -57,7 +65,23 @@ RecordingManager::RecordingManager(UserSettingsPointer pConfig, EngineMixer* pEn
                 &EngineRecord::durationRecorded,
                 this,
                 &RecordingManager::slotDurationRecorded);
-        pSidechain->addSideChainWorker(pEngineRecord);
+        // Buffer the recorded audio in a temporary file instead of losing
+        // it when the encoder or the disk can't keep up.
+        const bool spillToDisk = m_pConfig->getValue(
+                ConfigKey(RECORDING_PREF_KEY, "sidechain_spill_to_disk"), false);
+        pSidechain->addSideChainWorker(pEngineRecord, spillToDisk);
+
+        // Record the decks, microphones and auxiliary inputs to separate
+        // files next to the mix. Must be enabled before the channels are
+        // added to the engine, i.e. changing it requires a restart.
+        if (m_pConfig->getValue(ConfigKey(RECORDING_PREF_KEY, "multitrack"), false)) {
+            pSidechain->setChannelTrackWorkerFactory(
+                    ConfigKey(RECORDING_PREF_KEY, "status"),
+                    [pConfig = m_pConfig, pDiskWriter](
+                            const EngineSideChain::ChannelTrack& track) {
+                        return new EngineRecordTrack(pConfig, track, pDiskWriter);
+                    });
+        }
     }
 }
 
@@ -43,19 +43,27 @@ class rendergraph::Material : public rendergraph::BaseMaterial {
 
     virtual std::unique_ptr<MaterialShader> createShader() const = 0;
 
+    /// Setting a uniform to its current value doesn't mark the cache dirty,
+    /// so that it isn't uploaded again
     template<typename T>
     void setUniform(int uniformIndex, const T& value) {
-        m_uniformsCache.set(uniformIndex, value);
-        m_uniformsCacheDirty = true;
+        if (m_uniformsCache.set(uniformIndex, value)) {
+            m_uniformsCacheDirty = true;
+        }
     }
 
     const UniformsCache& uniformsCache() const {
         return m_uniformsCache;
     }
 
+    bool isUniformsCacheDirty() const {
+        return m_uniformsCacheDirty;
+    }
+
     bool clearUniformsCacheDirty() {
         if (m_uniformsCacheDirty) {
             m_uniformsCacheDirty = false;
+            m_uniformsCache.clearDirty();
             return true;
         }
         return false;
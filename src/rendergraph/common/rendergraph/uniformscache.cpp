@@ -12,14 +12,22 @@ UniformsCache::UniformsCache(const UniformSet& uniformSet) {
         m_infos.push_back({uniform.m_type, offset});
         offset += size;
     }
+    // Nothing has been uploaded yet
+    m_dirty.resize(m_infos.size(), true);
     m_byteArray.resize(offset);
     m_byteArray.fill('\0');
 }
 
 UniformsCache::~UniformsCache() = default;
 
-void UniformsCache::set(int uniformIndex, const void* ptr, int size) {
-    memcpy(m_byteArray.data() + m_infos[uniformIndex].m_offset, ptr, size);
+bool UniformsCache::set(int uniformIndex, const void* ptr, int size) {
+    char* pData = m_byteArray.data() + m_infos[uniformIndex].m_offset;
+    if (memcmp(pData, ptr, size) == 0) {
+        return false;
+    }
+    memcpy(pData, ptr, size);
+    m_dirty[uniformIndex] = true;
+    return true;
 }
 
 void UniformsCache::get(int uniformIndex, void* ptr, int size) const {
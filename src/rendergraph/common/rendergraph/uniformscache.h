@@ -4,7 +4,9 @@
 #include <QColor>
 #include <QMatrix4x4>
 #include <QVector4D>
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 #include "rendergraph/assert.h"
 #include "rendergraph/types.h"
@@ -19,11 +21,12 @@ class rendergraph::UniformsCache {
     UniformsCache(const UniformSet& uniformSet);
     ~UniformsCache();
 
+    /// Returns false if the uniform already had this value
     template<typename T>
-    void set(int uniformIndex, const T& value) {
+    bool set(int uniformIndex, const T& value) {
         DEBUG_ASSERT(type(uniformIndex) == typeOf<T>());
         DEBUG_ASSERT(std::is_trivially_copyable<T>());
-        set(uniformIndex, static_cast<const void*>(&value), sizeOf(typeOf<T>()));
+        return set(uniformIndex, static_cast<const void*>(&value), sizeOf(typeOf<T>()));
     }
 
     template<typename T>
@@ -48,8 +51,17 @@ class rendergraph::UniformsCache {
         return static_cast<int>(m_infos.size());
     }
 
+    /// True if the uniform has been changed since the last clearDirty(),
+    /// which allows to upload only the changed uniforms
+    bool isDirty(int uniformIndex) const {
+        return m_dirty[uniformIndex];
+    }
+    void clearDirty() {
+        std::fill(m_dirty.begin(), m_dirty.end(), false);
+    }
+
   private:
-    void set(int uniformIndex, const void* ptr, int size);
+    bool set(int uniformIndex, const void* ptr, int size);
     void get(int uniformIndex, void* ptr, int size) const;
 
     struct Info {
@@ -58,17 +70,19 @@ class rendergraph::UniformsCache {
     };
 
     std::vector<Info> m_infos;
+    std::vector<bool> m_dirty;
     QByteArray m_byteArray;
 };
 
 template<>
-inline void rendergraph::UniformsCache::set<QColor>(int uniformIndex, const QColor& color) {
-    set(uniformIndex, QVector4D{color.redF(), color.greenF(), color.blueF(), color.alphaF()});
+inline bool rendergraph::UniformsCache::set<QColor>(int uniformIndex, const QColor& color) {
+    return set(uniformIndex,
+            QVector4D{color.redF(), color.greenF(), color.blueF(), color.alphaF()});
 }
 
 template<>
-inline void rendergraph::UniformsCache::set<QMatrix4x4>(
+inline bool rendergraph::UniformsCache::set<QMatrix4x4>(
         int uniformIndex, const QMatrix4x4& matrix) {
     DEBUG_ASSERT(type(uniformIndex) == typeOf<QMatrix4x4>());
-    set(uniformIndex, matrix.constData(), sizeOf(typeOf<QMatrix4x4>()));
+    return set(uniformIndex, matrix.constData(), sizeOf(typeOf<QMatrix4x4>()));
 }
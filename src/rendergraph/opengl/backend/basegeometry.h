@@ -24,6 +24,8 @@ class rendergraph::BaseGeometry {
     };
 
     float* vertexData() {
+        // The caller may write the vertices
+        m_vertexDataDirty = true;
         return m_vertexData.data();
     }
     const float* vertexData() const {
@@ -47,6 +49,16 @@ class rendergraph::BaseGeometry {
         }
         m_vertexCount = vertexCount;
         m_vertexData.resize(m_vertexCount * sizeOfVertex() / sizeof(float));
+        m_vertexDataDirty = true;
+    }
+    // Returns true if the vertex data may have changed since the last call,
+    // i.e. if the vertex buffer needs to be uploaded again
+    bool clearVertexDataDirty() {
+        if (m_vertexDataDirty) {
+            m_vertexDataDirty = false;
+            return true;
+        }
+        return false;
     }
 
   protected:
@@ -56,4 +68,5 @@ class rendergraph::BaseGeometry {
     DrawingMode m_drawingMode;
     int m_vertexCount;
     std::vector<float> m_vertexData;
+    bool m_vertexDataDirty{true};
 };
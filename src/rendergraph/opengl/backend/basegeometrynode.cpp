@@ -2,6 +2,7 @@
 
 #include <QOpenGLTexture>
 #include <stdexcept>
+#include <utility>
 
 #include "backend/shadercache.h"
 #include "rendergraph/engine.h"
@@ -28,6 +29,19 @@ void BaseGeometryNode::initialize() {
     GeometryNode* pThis = static_cast<GeometryNode*>(this);
     pThis->material().setShader(ShaderCache::getShaderForMaterial(&pThis->material()));
     pThis->material().setUniform(0, engine()->matrix());
+    if (m_vertexBuffer.create()) {
+        m_vertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    }
+}
+
+void BaseGeometryNode::uploadVertexData(const Geometry& geometry) {
+    const int byteCount = geometry.vertexCount() * geometry.sizeOfVertex();
+    if (byteCount > m_vertexBuffer.size()) {
+        m_vertexBuffer.allocate(geometry.vertexData(), byteCount);
+    } else {
+        // Reuse the storage, only the vertices that are drawn are written
+        m_vertexBuffer.write(0, geometry.vertexData(), byteCount);
+    }
 }
 
 void BaseGeometryNode::render() {
@@ -39,18 +53,25 @@ void BaseGeometryNode::render() {
         return;
     }
 
-    glEnable(GL_BLEND);
-    // Note: Qt scenegraph uses premultiplied alpha color in the shader,
-    // so we need to do the same.
-    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-
     QOpenGLShaderProgram& shader = material.shader();
-    shader.bind();
+    if (engine()->bindShader(&shader)) {
+        glEnable(GL_BLEND);
+        // Note: Qt scenegraph uses premultiplied alpha color in the shader,
+        // so we need to do the same.
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    }
 
-    if (material.clearUniformsCacheDirty() || !material.isLastModifierOfShader()) {
+    // Another material of the same type may have modified the shader since
+    // this material has been rendered, otherwise only the changed uniforms
+    // are uploaded
+    const bool uploadAllUniforms = !material.isLastModifierOfShader();
+    if (uploadAllUniforms || material.isUniformsCacheDirty()) {
         material.modifyShader();
         const UniformsCache& cache = material.uniformsCache();
         for (int i = 0; i < cache.count(); i++) {
+            if (!uploadAllUniforms && !cache.isDirty(i)) {
+                continue;
+            }
             int location = material.uniformLocation(i);
             switch (cache.type(i)) {
             case Type::UInt:
@@ -73,6 +94,15 @@ void BaseGeometryNode::render() {
                 break;
             }
         }
+        material.clearUniformsCacheDirty();
+    }
+
+    const bool useVertexBuffer = m_vertexBuffer.isCreated();
+    if (useVertexBuffer) {
+        m_vertexBuffer.bind();
+        if (geometry.clearVertexDataDirty()) {
+            uploadVertexData(geometry);
+        }
     }
 
     // TODO this code assumes all vertices are floats
@@ -81,10 +111,20 @@ void BaseGeometryNode::render() {
         const Geometry::Attribute& attribute = geometry.attributes()[i];
         int location = material.attributeLocation(i);
         shader.enableAttributeArray(location);
-        shader.setAttributeArray(location,
-                geometry.vertexDataAs<float>() + vertexOffset,
-                attribute.m_tupleSize,
-                geometry.sizeOfVertex());
+        if (useVertexBuffer) {
+            shader.setAttributeBuffer(location,
+                    GL_FLOAT,
+                    vertexOffset * static_cast<int>(sizeof(float)),
+                    attribute.m_tupleSize,
+                    geometry.sizeOfVertex());
+        } else {
+            // Must not call the non-const vertexData(), which marks the
+            // geometry dirty
+            shader.setAttributeArray(location,
+                    std::as_const(geometry).vertexData() + vertexOffset,
+                    attribute.m_tupleSize,
+                    geometry.sizeOfVertex());
+        }
         vertexOffset += attribute.m_tupleSize;
     }
 
@@ -105,7 +145,11 @@ void BaseGeometryNode::render() {
         shader.disableAttributeArray(location);
     }
 
-    shader.release();
+    if (useVertexBuffer) {
+        // Other renderers pass their vertices from client memory
+        m_vertexBuffer.release();
+    }
+    // The shader is released by the engine when the batch ends
 }
 
 void BaseGeometryNode::resize(int, int) {
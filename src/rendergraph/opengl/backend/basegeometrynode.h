@@ -1,12 +1,14 @@
 #pragma once
 
+#include <QOpenGLBuffer>
 #include <QOpenGLFunctions>
 
 #include "backend/basenode.h"
 
 namespace rendergraph {
 class BaseGeometryNode;
-}
+class Geometry;
+} // namespace rendergraph
 
 class rendergraph::BaseGeometryNode : public rendergraph::BaseNode,
                                       public QOpenGLFunctions {
@@ -18,4 +20,12 @@ class rendergraph::BaseGeometryNode : public rendergraph::BaseNode,
     void initialize() override;
     void render() override;
     void resize(int w, int h) override;
+
+  private:
+    void uploadVertexData(const Geometry& geometry);
+
+    // Keeps the vertices on the GPU, they are only uploaded again when the
+    // geometry has been written. Unlike a vertex array object, the buffer
+    // can be used by all sharing contexts.
+    QOpenGLBuffer m_vertexBuffer{QOpenGLBuffer::VertexBuffer};
 };
@@ -1,5 +1,6 @@
 #include "backend/baseopenglnode.h"
 
+#include "rendergraph/engine.h"
 #include "rendergraph/openglnode.h"
 
 using namespace rendergraph;
@@ -10,6 +11,8 @@ void BaseOpenGLNode::initialize() {
 }
 
 void BaseOpenGLNode::render() {
+    // paintGL() may change any state
+    engine()->releaseShader();
     paintGL();
 }
 
@@ -1,6 +1,7 @@
 #include "rendergraph/engine.h"
 
 #include <QDebug>
+#include <QOpenGLShaderProgram>
 #include <cassert>
 
 using namespace rendergraph;
@@ -53,6 +54,7 @@ void Engine::render() {
     if (m_pRootNode && !m_pRootNode->isSubtreeBlocked()) {
         render(m_pRootNode.get());
     }
+    releaseShader();
 }
 
 void Engine::render(BaseNode* pNode) {
@@ -66,6 +68,22 @@ void Engine::render(BaseNode* pNode) {
     }
 }
 
+bool Engine::bindShader(QOpenGLShaderProgram* pShader) {
+    if (m_pBoundShader == pShader) {
+        return false;
+    }
+    pShader->bind();
+    m_pBoundShader = pShader;
+    return true;
+}
+
+void Engine::releaseShader() {
+    if (m_pBoundShader) {
+        m_pBoundShader->release();
+        m_pBoundShader = nullptr;
+    }
+}
+
 void Engine::preprocess() {
     for (auto pNode : m_pPreprocessNodes) {
         if (!pNode->isSubtreeBlocked()) {
@@ -25,7 +25,7 @@ void Geometry::setAttributeValues(int attributePosition, const float* from, int
         return;
     }
 
-    float* to = m_vertexData.data();
+    float* to = vertexData();
     to += vertexOffset;
 
     while (numTuples--) {
@@ -6,6 +6,8 @@
 
 #include "rendergraph/node.h"
 
+class QOpenGLShaderProgram;
+
 namespace rendergraph {
 class Engine;
 } // namespace rendergraph
@@ -24,11 +26,21 @@ class rendergraph::Engine {
         return m_matrix;
     }
 
+    /// Binds the shader unless it is still bound by the previously rendered
+    /// node. Consecutive nodes of the same MaterialType share their shader,
+    /// so they are rendered as a batch without rebinding it. Returns true
+    /// if a new batch has been started.
+    bool bindShader(QOpenGLShaderProgram* pShader);
+    /// Ends the current batch, e.g. before a node that issues its own
+    /// OpenGL calls
+    void releaseShader();
+
   private:
     void render(BaseNode* pNode);
     void resize(BaseNode* pNode, int, int);
 
     QMatrix4x4 m_matrix;
+    QOpenGLShaderProgram* m_pBoundShader{};
     std::unique_ptr<BaseNode> m_pRootNode;
     std::vector<BaseNode*> m_pPreprocessNodes;
     std::vector<BaseNode*> m_pInitializeNodes;
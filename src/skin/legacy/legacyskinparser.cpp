@@ -1,11 +1,13 @@
 #include "skin/legacy/legacyskinparser.h"
 
 #include <QDir>
+#include <QDirIterator>
 #include <QGridLayout>
 #include <QLabel>
 #include <QSplitter>
 #include <QStackedWidget>
 #include <QVBoxLayout>
+#include <QtConcurrentMap>
 #include <QtDebug>
 #include <QtGlobal>
 #include <memory>
@@ -98,8 +100,49 @@ using mixxx::skin::SkinManifest;
 /// of QString instead of every widget keeping its own copy.
 QSet<QString> LegacySkinParser::s_sharedGroupStrings;
 
+QHash<QString, LegacySkinParser::CachedTemplate> LegacySkinParser::s_templateCache;
+
 static bool sDebug = false;
 
+namespace {
+
+/// Reentrant, invoked concurrently by LegacySkinParser::preloadTemplates()
+QDomElement parseTemplateFile(const QString& absolutePath) {
+    QFile templateFile(absolutePath);
+
+    if (!templateFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open template file:" << absolutePath;
+        return QDomElement();
+    }
+
+    QDomDocument tmpl("template");
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    const auto parseResult = tmpl.setContent(&templateFile);
+    if (!parseResult) {
+        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
+                   << absolutePath << "line:" << parseResult.errorLine
+                   << "column:" << parseResult.errorColumn;
+        qWarning() << "LegacySkinParser::loadTemplate - message:" << parseResult.errorMessage;
+#else
+    QString errorMessage;
+    int errorLine;
+    int errorColumn;
+
+    if (!tmpl.setContent(&templateFile, &errorMessage,
+                         &errorLine, &errorColumn)) {
+        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
+                   << absolutePath << "line:" << errorLine << "column:" << errorColumn;
+        qWarning() << "LegacySkinParser::loadTemplate - message:" << errorMessage;
+#endif
+        return QDomElement();
+    }
+
+    return tmpl.documentElement();
+}
+
+} // namespace
+
 ControlObject* LegacySkinParser::controlFromConfigKey(
         const ConfigKey& key, bool bPersist, bool* pCreated) {
     if (!key.isValid()) {
@@ -341,13 +384,19 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     if (m_pParent) {
         qDebug() << "ERROR: Somehow a parent already exists -- you are probably re-using a LegacySkinParser which is not advisable!";
     }
-    QDomElement skinDocument = openSkin(skinPath);
+    QDomElement skinDocument;
+    {
+        ScopedTimer openTimer(QStringLiteral("LegacySkinParser::openSkin"));
+        skinDocument = openSkin(skinPath);
+    }
 
     if (skinDocument.isNull()) {
         qDebug() << "LegacySkinParser::parseSkin - failed for skin:" << skinPath;
         return nullptr;
     }
 
+    preloadTemplates(skinPath);
+
     SkinManifest manifest = getSkinManifest(skinDocument);
 
     // Apply SkinManifest attributes by looping through the proto.
@@ -416,7 +465,11 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     QString systemSkinsPath(m_pConfig->getResourcePath() + "skins/");
     QDir::setSearchPaths("skins", QStringList{systemSkinsPath});
 
-    ColorSchemeParser::setupLegacyColorSchemes(skinDocument, m_pConfig, &m_style, m_pContext.get());
+    {
+        ScopedTimer colorSchemeTimer(QStringLiteral("LegacySkinParser::setupLegacyColorSchemes"));
+        ColorSchemeParser::setupLegacyColorSchemes(
+                skinDocument, m_pConfig, &m_style, m_pContext.get());
+    }
 
     // don't parent till here so the first opengl waveform doesn't screw
     // up --bkgood
@@ -424,7 +477,11 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     // created parent so MixxxMainWindow can use it for various purposes
     // (fullscreen mostly) --bkgood
     m_pParent = pParent;
-    QList<QWidget*> widgets = parseNode(skinDocument);
+    QList<QWidget*> widgets;
+    {
+        ScopedTimer widgetTimer(QStringLiteral("LegacySkinParser::createWidgets"));
+        widgets = parseNode(skinDocument);
+    }
 
     if (widgets.empty()) {
         SKIN_WARNING(skinDocument, *m_pContext, QStringLiteral("Skin produced no widgets!"));
@@ -1807,47 +1864,75 @@ QDomElement LegacySkinParser::loadTemplate(const QString& path) {
     QFileInfo templateFileInfo(path);
 
     QString absolutePath = templateFileInfo.absoluteFilePath();
+    const QDateTime lastModified = templateFileInfo.lastModified();
 
-    auto it = m_templateCache.constFind(absolutePath);
-    if (it != m_templateCache.constEnd()) {
-        return it.value();
+    QDomElement documentElement;
+    auto it = s_templateCache.constFind(absolutePath);
+    if (it != s_templateCache.constEnd() && it->lastModified == lastModified) {
+        documentElement = it->documentElement;
+    } else {
+        documentElement = parseTemplateFile(absolutePath);
+        if (documentElement.isNull()) {
+            s_templateCache.remove(absolutePath);
+            return QDomElement();
+        }
+        s_templateCache.insert(absolutePath,
+                CachedTemplate{lastModified, documentElement});
     }
 
-    QFile templateFile(absolutePath);
-
-    if (!templateFile.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not open template file:" << absolutePath;
-        return QDomElement();
+    // Only the first instantiation while parsing this skin updates
+    // the search path
+    if (!m_loadedTemplates.contains(absolutePath)) {
+        m_loadedTemplates.insert(absolutePath);
+        m_pContext->setSkinTemplatePath(templateFileInfo.absoluteDir().absolutePath());
     }
+    return documentElement;
+}
 
-    QDomDocument tmpl("template");
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-    const auto parseResult = tmpl.setContent(&templateFile);
-    if (!parseResult) {
-        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
-                   << absolutePath << "line:" << parseResult.errorLine
-                   << "column:" << parseResult.errorColumn;
-        qWarning() << "LegacySkinParser::loadTemplate - message:" << parseResult.errorMessage;
-#else
-    QString errorMessage;
-    int errorLine;
-    int errorColumn;
-
-    if (!tmpl.setContent(&templateFile, &errorMessage,
-                         &errorLine, &errorColumn)) {
-        qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
-                   << absolutePath << "line:" << errorLine << "column:" << errorColumn;
-        qWarning() << "LegacySkinParser::loadTemplate - message:" << errorMessage;
-#endif
-        return QDomElement();
+// static
+void LegacySkinParser::preloadTemplates(const QString& skinPath) {
+    ScopedTimer timer(QStringLiteral("LegacySkinParser::preloadTemplates"));
+    const QString skinXmlPath = QDir(skinPath).absoluteFilePath(QStringLiteral("skin.xml"));
+    QStringList templatePaths;
+    QList<QDateTime> lastModified;
+    QDirIterator it(skinPath,
+            QStringList{QStringLiteral("*.xml")},
+            QDir::Files,
+            QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        const QString absolutePath = fileInfo.absoluteFilePath();
+        if (absolutePath == skinXmlPath) {
+            continue;
+        }
+        const auto cached = s_templateCache.constFind(absolutePath);
+        if (cached != s_templateCache.constEnd() &&
+                cached->lastModified == fileInfo.lastModified()) {
+            continue;
+        }
+        templatePaths.append(absolutePath);
+        lastModified.append(fileInfo.lastModified());
+    }
+    if (templatePaths.isEmpty()) {
+        return;
     }
 
-    m_templateCache[absolutePath] = tmpl.documentElement();
-    m_pContext->setSkinTemplatePath(templateFileInfo.absoluteDir().absolutePath());
-    return tmpl.documentElement();
+    // Each document is only accessed by a single thread at a time
+    const QList<QDomElement> documentElements =
+            QtConcurrent::blockingMapped<QList<QDomElement>>(
+                    templatePaths, parseTemplateFile);
+    for (int i = 0; i < templatePaths.size(); ++i) {
+        if (documentElements[i].isNull()) {
+            // Might not be a template, parsed again when instantiated
+            continue;
+        }
+        s_templateCache.insert(templatePaths[i],
+                CachedTemplate{lastModified[i], documentElements[i]});
+    }
 }
 
+
 QList<QWidget*> LegacySkinParser::parseTemplate(const QDomElement& node) {
     if (!node.hasAttribute("src")) {
         SKIN_WARNING(node,
@@ -2411,15 +2496,31 @@ void LegacySkinParser::setupConnections(const QDomNode& node, WBaseWidget* pWidg
                     ValueTransformer::parseFromXml(transform, *m_pContext);
         }
 
+        // Fast changing controls like the play position could be sampled
+        // once per GUI tick instead
+        int maxUpdateRate = 0;
+        if (m_pContext->hasNodeSelectInt(con, "MaxUpdateRate", &maxUpdateRate) &&
+                maxUpdateRate <= 0) {
+            SKIN_WARNING(con,
+                    *m_pContext,
+                    QStringLiteral("LegacySkinParser::setupConnections(): "
+                                   "MaxUpdateRate must be positive."));
+            maxUpdateRate = 0;
+        }
+
         QString property;
         if (m_pContext->hasNodeSelectString(con, "BindProperty", &property)) {
             //qDebug() << "Making property connection for" << property;
 
-            pWidget->addPropertyConnection(
-                    std::make_unique<ControlWidgetPropertyConnection>(pWidget,
-                            control->getKey(),
-                            std::move(pTransformer),
-                            property));
+            auto pConnection = std::make_unique<ControlWidgetPropertyConnection>(
+                    pWidget,
+                    control->getKey(),
+                    std::move(pTransformer),
+                    property);
+            if (maxUpdateRate > 0) {
+                pConnection->setMaxUpdateRate(maxUpdateRate);
+            }
+            pWidget->addPropertyConnection(std::move(pConnection));
         } else {
             bool nodeValue;
             Qt::MouseButton state = parseButtonState(con, *m_pContext);
@@ -2488,6 +2589,9 @@ void LegacySkinParser::setupConnections(const QDomNode& node, WBaseWidget* pWidg
                                             DirectionOption>(directionOption),
                             static_cast<ControlParameterWidgetConnection::
                                             EmitOption>(emitOption));
+            if (maxUpdateRate > 0) {
+                pConnection->setMaxUpdateRate(maxUpdateRate);
+            }
 
             switch (state) {
             case Qt::NoButton:
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QDateTime>
 #include <QDomElement>
 #include <QList>
 #include <QObject>
@@ -66,6 +67,10 @@ class LegacySkinParser : public QObject, public SkinParser {
     // Load the given template from file and return its document element.
     QDomElement loadTemplate(const QString& path);
 
+    // Parses all templates in the skin directory concurrently, that are
+    // not cached yet or have been modified since.
+    static void preloadTemplates(const QString& skinPath);
+
     // Parsers for each node
 
     // Most widgets can use parseStandardWidget.
@@ -171,6 +176,15 @@ class LegacySkinParser : public QObject, public SkinParser {
     std::unique_ptr<SkinContext> m_pContext;
     QString m_style;
     Tooltips m_tooltips;
-    QHash<QString, QDomElement> m_templateCache;
+    // The templates that have been instantiated while parsing this skin
+    QSet<QString> m_loadedTemplates;
     static QSet<QString> s_sharedGroupStrings;
+
+    struct CachedTemplate {
+        QDateTime lastModified;
+        QDomElement documentElement;
+    };
+    // Parsed templates of all skins that have been loaded before, which
+    // speeds up switching between skins. Only accessed from the main thread.
+    static QHash<QString, CachedTemplate> s_templateCache;
 };
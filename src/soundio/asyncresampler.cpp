@@ -0,0 +1,185 @@
+#include "soundio/asyncresampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// The filter has kTaps input frames around the output position. It is
+// sampled at kPhases fractional positions, the coefficients in between are
+// interpolated linearly.
+constexpr int kHalfTaps = 8;
+constexpr int kTaps = 2 * kHalfTaps;
+constexpr int kPhases = 256;
+
+// Drift compensation does not shift the spectrum notably, so the cutoff can
+// be close to Nyquist.
+constexpr double kCutoff = 0.92;
+constexpr double kKaiserBeta = 8.0;
+
+// The ratio of two sound card clocks never differs by more than a few
+// hundred ppm. Larger ratios would need a lower cutoff.
+constexpr double kMaxRatioDeviation = 0.01;
+
+using FilterTable = std::array<std::array<CSAMPLE, kTaps>, kPhases + 1>;
+
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+FilterTable makeFilterTable() {
+    FilterTable table;
+    const double windowNorm = besselI0(kKaiserBeta);
+    for (int phase = 0; phase <= kPhases; ++phase) {
+        const double frac = static_cast<double>(phase) / kPhases;
+        double sum = 0.0;
+        std::array<double, kTaps> coefficients;
+        for (int tap = 0; tap < kTaps; ++tap) {
+            // The distance of the input frame from the output position
+            const double distance = tap - kHalfTaps + 1 - frac;
+            const double x = M_PI * kCutoff * distance;
+            const double sinc = distance == 0.0 ? 1.0 : std::sin(x) / x;
+            const double w = distance / kHalfTaps;
+            const double window = std::abs(w) >= 1.0
+                    ? 0.0
+                    : besselI0(kKaiserBeta * std::sqrt(1.0 - w * w)) / windowNorm;
+            coefficients[tap] = sinc * window;
+            sum += coefficients[tap];
+        }
+        // Unity gain at DC for every phase
+        for (int tap = 0; tap < kTaps; ++tap) {
+            table[phase][tap] = static_cast<CSAMPLE>(coefficients[tap] / sum);
+        }
+    }
+    return table;
+}
+
+const FilterTable& filterTable() {
+    static const FilterTable s_table = makeFilterTable();
+    return s_table;
+}
+
+} // anonymous namespace
+
+AsyncResampler::AsyncResampler(
+        mixxx::audio::ChannelCount channelCount, SINT maxInputFrames)
+        : m_channelCount(channelCount),
+          m_capacityFrames(maxInputFrames + kTaps),
+          m_buffer(m_capacityFrames * channelCount),
+          m_bufferedFrames(0),
+          m_position(0.0),
+          m_ratio(1.0) {
+    // Initialize the table outside of the real-time thread
+    filterTable();
+    reset();
+}
+
+void AsyncResampler::setRatio(double ratio) {
+    m_ratio = math_clamp(ratio, 1.0 - kMaxRatioDeviation, 1.0 + kMaxRatioDeviation);
+}
+
+void AsyncResampler::reset() {
+    // The first output frame is preceded by silence
+    m_bufferedFrames = kHalfTaps - 1;
+    SampleUtil::clear(m_buffer.data(), m_bufferedFrames * m_channelCount);
+    m_position = kHalfTaps - 1;
+}
+
+SINT AsyncResampler::framesRequired(SINT numOutputFrames) const {
+    if (numOutputFrames <= 0) {
+        return 0;
+    }
+    const double lastPosition = m_position + (numOutputFrames - 1) * m_ratio;
+    const auto framesNeeded = static_cast<SINT>(std::floor(lastPosition)) + kHalfTaps + 1;
+    return math_max<SINT>(0, framesNeeded - m_bufferedFrames);
+}
+
+SINT AsyncResampler::framesAvailable() const {
+    // Output frame n needs floor(m_position + n * m_ratio) + kHalfTaps
+    // frames after it.
+    const double maxPosition = m_bufferedFrames - kHalfTaps;
+    if (m_position >= maxPosition) {
+        return 0;
+    }
+    auto frames = static_cast<SINT>(std::ceil((maxPosition - m_position) / m_ratio));
+    // Correct rounding errors at the boundary
+    while (frames > 0 && framesRequired(frames) > 0) {
+        --frames;
+    }
+    return frames;
+}
+
+SINT AsyncResampler::write(const CSAMPLE* pIn, SINT numFrames) {
+    const SINT framesWritten = math_min(numFrames, m_capacityFrames - m_bufferedFrames);
+    DEBUG_ASSERT(framesWritten == numFrames);
+    SampleUtil::copy(&m_buffer[m_bufferedFrames * m_channelCount],
+            pIn,
+            framesWritten * m_channelCount);
+    m_bufferedFrames += framesWritten;
+    return framesWritten;
+}
+
+void AsyncResampler::read(CSAMPLE* pOut, SINT numOutputFrames) {
+    VERIFY_OR_DEBUG_ASSERT(numOutputFrames <= framesAvailable()) {
+        SampleUtil::clear(pOut, numOutputFrames * m_channelCount);
+        return;
+    }
+    const FilterTable& table = filterTable();
+    const int channelCount = m_channelCount;
+    std::array<CSAMPLE, kTaps> coefficients;
+    for (SINT frame = 0; frame < numOutputFrames; ++frame) {
+        const auto index = static_cast<SINT>(m_position);
+        const double phase = (m_position - index) * kPhases;
+        const auto phaseIndex = static_cast<int>(phase);
+        const auto t = static_cast<CSAMPLE>(phase - phaseIndex);
+        const auto& coefficients1 = table[phaseIndex];
+        const auto& coefficients2 = table[phaseIndex + 1];
+        for (int tap = 0; tap < kTaps; ++tap) {
+            coefficients[tap] = coefficients1[tap] +
+                    (coefficients2[tap] - coefficients1[tap]) * t;
+        }
+        const CSAMPLE* pFirst = &m_buffer[(index - kHalfTaps + 1) * channelCount];
+        CSAMPLE* pOutFrame = &pOut[frame * channelCount];
+        if (channelCount == 2) {
+            CSAMPLE left = 0;
+            CSAMPLE right = 0;
+            for (int tap = 0; tap < kTaps; ++tap) {
+                left += coefficients[tap] * pFirst[tap * 2];
+                right += coefficients[tap] * pFirst[tap * 2 + 1];
+            }
+            pOutFrame[0] = left;
+            pOutFrame[1] = right;
+        } else {
+            for (int channel = 0; channel < channelCount; ++channel) {
+                CSAMPLE sum = 0;
+                for (int tap = 0; tap < kTaps; ++tap) {
+                    sum += coefficients[tap] * pFirst[tap * channelCount + channel];
+                }
+                pOutFrame[channel] = sum;
+            }
+        }
+        m_position += m_ratio;
+    }
+
+    // Drop the input that is no longer in reach of the filter
+    const SINT framesConsumed = static_cast<SINT>(m_position) - (kHalfTaps - 1);
+    if (framesConsumed > 0) {
+        const SINT framesRemaining = m_bufferedFrames - framesConsumed;
+        std::copy(m_buffer.begin() + framesConsumed * channelCount,
+                m_buffer.begin() + m_bufferedFrames * channelCount,
+                m_buffer.begin());
+        m_bufferedFrames = framesRemaining;
+        m_position -= framesConsumed;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "audio/types.h"
+#include "util/types.h"
+
+/// A polyphase windowed sinc resampler for small, slowly changing ratios,
+/// used to compensate the clock drift between two sound cards. The input is
+/// written in arbitrary chunks and the output is read in the chunks the
+/// reading side needs.
+///
+/// All buffers are allocated in the constructor, so write() and read() are
+/// real-time safe.
+class AsyncResampler {
+  public:
+    /// maxInputFrames is the maximum number of frames that are buffered
+    /// before they are read.
+    AsyncResampler(mixxx::audio::ChannelCount channelCount, SINT maxInputFrames);
+
+    /// Sets the number of input frames consumed per output frame. Must be
+    /// close to 1.
+    void setRatio(double ratio);
+    double ratio() const {
+        return m_ratio;
+    }
+
+    /// Returns the number of frames that need to be written before
+    /// numOutputFrames can be read.
+    SINT framesRequired(SINT numOutputFrames) const;
+    /// Returns the number of frames that can be read.
+    SINT framesAvailable() const;
+
+    /// Returns the number of frames written, which is less than numFrames
+    /// only if more than maxInputFrames are buffered.
+    SINT write(const CSAMPLE* pIn, SINT numFrames);
+    /// Reads numOutputFrames, which must not exceed framesAvailable().
+    void read(CSAMPLE* pOut, SINT numOutputFrames);
+
+    /// Drops the buffered input.
+    void reset();
+
+  private:
+    const mixxx::audio::ChannelCount m_channelCount;
+    const SINT m_capacityFrames;
+    std::vector<CSAMPLE> m_buffer;
+    SINT m_bufferedFrames;
+    // The position of the next output frame in buffered input frames
+    double m_position;
+    double m_ratio;
+};
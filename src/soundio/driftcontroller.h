@@ -0,0 +1,79 @@
+#pragma once
+
+#include "util/math.h"
+
+/// A PI controller that estimates the resampling ratio between two clocks
+/// from the fill level of the FIFO that connects them.
+///
+/// The level jitters by up to a buffer, because both sides process whole
+/// buffers at independent times. The jitter is smoothed, and the average
+/// level after the warm up is kept as target. A level above the target
+/// means the consuming side is too slow and results in a ratio above 1.
+class DriftController {
+  public:
+    DriftController()
+            : m_callbackCount(0),
+              m_smoothedLevel(0.0),
+              m_targetLevel(0.0),
+              m_integral(0.0),
+              m_ratio(1.0) {
+    }
+
+    void reset() {
+        *this = DriftController();
+    }
+
+    /// Called once per callback with the FIFO level and the buffer size of
+    /// the callback, both in frames. Returns the new ratio.
+    double update(double levelFrames, double framesPerBuffer) {
+        if (m_callbackCount == 0) {
+            m_smoothedLevel = levelFrames;
+        } else {
+            m_smoothedLevel += kSmoothing * (levelFrames - m_smoothedLevel);
+        }
+        if (m_callbackCount < kWarmUpCallbacks) {
+            ++m_callbackCount;
+            m_targetLevel = m_smoothedLevel;
+            return m_ratio;
+        }
+        const double error = (m_smoothedLevel - m_targetLevel) / framesPerBuffer;
+        m_integral = math_clamp(m_integral + kIntegralGain * error,
+                -kMaxDeviation,
+                kMaxDeviation);
+        m_ratio = 1.0 +
+                math_clamp(kProportionalGain * error + m_integral,
+                        -kMaxDeviation,
+                        kMaxDeviation);
+        return m_ratio;
+    }
+
+    double ratio() const {
+        return m_ratio;
+    }
+
+    /// The long term drift, without the short term correction of the level.
+    double driftPpm() const {
+        return m_integral * 1000000;
+    }
+
+    bool isLocked() const {
+        return m_callbackCount >= kWarmUpCallbacks;
+    }
+
+  private:
+    // About 1 s with 1024 frames at 44.1 kHz
+    static constexpr int kWarmUpCallbacks = 50;
+    static constexpr double kSmoothing = 0.05;
+    // A damping of about 0.8, so a drift is compensated within about 1000
+    // callbacks without overshooting notably
+    static constexpr double kIntegralGain = 0.000002;
+    static constexpr double kProportionalGain = 0.00225;
+    // Crystals are rated with +-100 ppm or better
+    static constexpr double kMaxDeviation = 0.002;
+
+    int m_callbackCount;
+    double m_smoothedLevel;
+    double m_targetLevel;
+    double m_integral;
+    double m_ratio;
+};
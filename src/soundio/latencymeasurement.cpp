@@ -0,0 +1,179 @@
+#include "soundio/latencymeasurement.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// The input is measured before the first impulse to find the threshold
+constexpr double kNoiseSeconds = 0.25;
+// Long enough for the echo of a room to decay before the next impulse
+constexpr double kPauseSeconds = 0.3;
+constexpr double kTimeoutSeconds = 1.0;
+// The latencies of all impulses must agree within this tolerance
+constexpr double kMaxSpreadSeconds = 0.001;
+
+constexpr CSAMPLE kMinThreshold = 0.05f;
+constexpr CSAMPLE kNoiseFactor = 4.0f;
+
+SINT secondsToFrames(SINT sampleRate, double seconds) {
+    return static_cast<SINT>(std::lround(sampleRate * seconds));
+}
+
+} // namespace
+
+LatencyMeasurement::LatencyMeasurement()
+        : m_state(State::Idle),
+          m_requestedRun(0),
+          m_requestedSampleRate(0),
+          m_roundTripFrames(0),
+          m_currentRun(0),
+          m_active(false),
+          m_inputFrame(0),
+          m_outputFrame(0),
+          m_firstImpulseFrame(0),
+          m_impulseFrame(0),
+          m_impulsePlayed(false),
+          m_timeoutFrames(0),
+          m_pauseFrames(0),
+          m_noisePeak(0),
+          m_threshold(kMinThreshold),
+          m_numDetected(0),
+          m_latencies{} {
+}
+
+void LatencyMeasurement::start(mixxx::audio::SampleRate sampleRate) {
+    m_requestedSampleRate.store(sampleRate.value(), std::memory_order_relaxed);
+    m_state.store(State::Pending, std::memory_order_release);
+    m_requestedRun.fetch_add(1, std::memory_order_release);
+}
+
+void LatencyMeasurement::cancel() {
+    m_state.store(State::Idle, std::memory_order_release);
+    m_requestedRun.fetch_add(1, std::memory_order_release);
+}
+
+bool LatencyMeasurement::isFinished() const {
+    switch (state()) {
+    case State::Idle:
+    case State::Pending:
+    case State::Running:
+        return false;
+    case State::Succeeded:
+    case State::NoSignal:
+    case State::NoisyInput:
+    case State::Inconsistent:
+        return true;
+    }
+    return false;
+}
+
+void LatencyMeasurement::restart() {
+    const SINT sampleRate = m_requestedSampleRate.load(std::memory_order_relaxed);
+    m_inputFrame = 0;
+    m_outputFrame = 0;
+    m_firstImpulseFrame = secondsToFrames(sampleRate, kNoiseSeconds);
+    m_impulseFrame = m_firstImpulseFrame;
+    m_impulsePlayed = false;
+    m_timeoutFrames = secondsToFrames(sampleRate, kTimeoutSeconds);
+    m_pauseFrames = secondsToFrames(sampleRate, kPauseSeconds);
+    m_noisePeak = 0;
+    m_threshold = kMinThreshold;
+    m_numDetected = 0;
+}
+
+void LatencyMeasurement::finish(State state) {
+    m_active = false;
+    // Unless it has been cancelled or restarted in the meantime
+    State expected = State::Running;
+    m_state.compare_exchange_strong(expected, state, std::memory_order_acq_rel);
+}
+
+void LatencyMeasurement::processInput(
+        const CSAMPLE* pBuffer, SINT numFrames, int frameSize) {
+    const int run = m_requestedRun.load(std::memory_order_acquire);
+    if (run != m_currentRun) {
+        m_currentRun = run;
+        State expected = State::Pending;
+        m_active = m_state.compare_exchange_strong(
+                expected, State::Running, std::memory_order_acq_rel);
+        if (m_active) {
+            restart();
+        }
+    }
+    if (!m_active) {
+        return;
+    }
+
+    for (SINT i = 0; i < numFrames; ++i) {
+        const SINT frame = m_inputFrame + i;
+        CSAMPLE peak = 0;
+        if (pBuffer) {
+            for (int channel = 0; channel < frameSize; ++channel) {
+                peak = std::max(peak, std::abs(pBuffer[i * frameSize + channel]));
+            }
+        }
+        if (frame < m_firstImpulseFrame) {
+            m_noisePeak = std::max(m_noisePeak, peak);
+            continue;
+        }
+        if (frame == m_firstImpulseFrame) {
+            m_threshold = std::max(kMinThreshold, kNoiseFactor * m_noisePeak);
+            if (m_threshold > kImpulseAmplitude / 2) {
+                finish(State::NoisyInput);
+                return;
+            }
+        }
+        if (frame >= m_impulseFrame + m_timeoutFrames) {
+            finish(State::NoSignal);
+            return;
+        }
+        if (!m_impulsePlayed || frame < m_impulseFrame || peak < m_threshold) {
+            continue;
+        }
+
+        m_latencies[m_numDetected++] = frame - m_impulseFrame;
+        if (m_numDetected == kNumImpulses) {
+            std::array<SINT, kNumImpulses> sorted = m_latencies;
+            std::sort(sorted.begin(), sorted.end());
+            const SINT sampleRate = m_requestedSampleRate.load(std::memory_order_relaxed);
+            if (sorted.back() - sorted.front() >
+                    secondsToFrames(sampleRate, kMaxSpreadSeconds)) {
+                finish(State::Inconsistent);
+                return;
+            }
+            m_roundTripFrames.store(sorted[kNumImpulses / 2], std::memory_order_relaxed);
+            finish(State::Succeeded);
+            return;
+        }
+        // The outputs of this callback are processed after the inputs, so
+        // the next impulse can be played by them at the earliest.
+        m_impulseFrame = std::max(frame + m_pauseFrames, m_outputFrame);
+        m_impulsePlayed = false;
+    }
+    m_inputFrame += numFrames;
+}
+
+void LatencyMeasurement::addImpulse(CSAMPLE* pBuffer, SINT numFrames, int frameSize) const {
+    if (!m_active || m_impulsePlayed) {
+        return;
+    }
+    const SINT offset = m_impulseFrame - m_outputFrame;
+    if (offset < 0 || offset >= numFrames) {
+        return;
+    }
+    for (int channel = 0; channel < frameSize; ++channel) {
+        pBuffer[offset * frameSize + channel] = kImpulseAmplitude;
+    }
+}
+
+void LatencyMeasurement::advanceOutput(SINT numFrames) {
+    if (!m_active) {
+        return;
+    }
+    if (!m_impulsePlayed && m_impulseFrame >= m_outputFrame &&
+            m_impulseFrame < m_outputFrame + numFrames) {
+        m_impulsePlayed = true;
+    }
+    m_outputFrame += numFrames;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "audio/types.h"
+#include "util/types.h"
+
+/// Measures the round trip latency from the output of the engine to its
+/// input with a loopback: It plays a few impulses on an output device and
+/// detects them on an input device, which are connected with a cable or
+/// are the speaker and the microphone of the same room.
+///
+/// start(), cancel() and the getters are called by the GUI thread, the
+/// process*() functions by the engine thread. In each callback all inputs
+/// are processed before the outputs, so the frame counters of both sides
+/// start at the same callback and the difference of the frame at which an
+/// impulse is detected and the frame at which it was played is the round
+/// trip latency, including the FIFOs of secondary devices.
+class LatencyMeasurement {
+  public:
+    enum class State {
+        Idle,
+        /// Started, but not picked up by the engine thread yet
+        Pending,
+        Running,
+        Succeeded,
+        /// At least one impulse was not detected on the input
+        NoSignal,
+        /// The noise on the input was too loud before the first impulse
+        NoisyInput,
+        /// The latencies of the impulses differ, e.g. because of an xrun
+        Inconsistent,
+    };
+
+    static constexpr int kNumImpulses = 5;
+    static constexpr CSAMPLE kImpulseAmplitude = 0.9f;
+
+    LatencyMeasurement();
+
+    void start(mixxx::audio::SampleRate sampleRate);
+    void cancel();
+
+    State state() const {
+        return m_state.load(std::memory_order_acquire);
+    }
+    bool isFinished() const;
+    /// The median of the latencies of the impulses, if succeeded.
+    SINT roundTripFrames() const {
+        return m_roundTripFrames.load(std::memory_order_relaxed);
+    }
+
+    /// Detects the impulse in an interleaved buffer of the input device.
+    /// A nullptr buffer counts as silence, for underflows.
+    void processInput(const CSAMPLE* pBuffer, SINT numFrames, int frameSize);
+    /// Adds the impulse to all channels of an interleaved buffer of the
+    /// output device, if it is due within the next numFrames frames.
+    /// advanceOutput() must follow, once per callback.
+    void addImpulse(CSAMPLE* pBuffer, SINT numFrames, int frameSize) const;
+    void advanceOutput(SINT numFrames);
+    void processOutput(CSAMPLE* pBuffer, SINT numFrames, int frameSize) {
+        addImpulse(pBuffer, numFrames, frameSize);
+        advanceOutput(numFrames);
+    }
+
+  private:
+    void restart();
+    void finish(State state);
+
+    // Shared with the GUI thread
+    std::atomic<State> m_state;
+    std::atomic<int> m_requestedRun;
+    std::atomic<SINT> m_requestedSampleRate;
+    std::atomic<SINT> m_roundTripFrames;
+
+    // Only accessed by the engine thread
+    int m_currentRun;
+    bool m_active;
+    SINT m_inputFrame;
+    SINT m_outputFrame;
+    /// Noise is measured until the first impulse is played
+    SINT m_firstImpulseFrame;
+    /// The frame at which the current impulse is played, or when it has
+    /// been played, until it is detected
+    SINT m_impulseFrame;
+    bool m_impulsePlayed;
+    SINT m_timeoutFrames;
+    SINT m_pauseFrames;
+    CSAMPLE m_noisePeak;
+    CSAMPLE m_threshold;
+    int m_numDetected;
+    std::array<SINT, kNumImpulses> m_latencies;
+};
@@ -0,0 +1,383 @@
+#include "soundio/metricsserver.h"
+
+#include <QFile>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "engine/enginemixer.h"
+#include "engine/sidechain/enginenetworkstream.h"
+#include "engine/sidechain/enginesidechain.h"
+#include "moc_metricsserver.cpp"
+#include "soundio/soundmanager.h"
+#include "util/logger.h"
+#include "util/statsmanager.h"
+
+#ifdef __LINUX__
+#include <unistd.h>
+#endif
+
+namespace {
+
+const mixxx::Logger kLogger("MetricsServer");
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+// The engine profiler ring holds 1024 callbacks, which are at least 1 s
+constexpr int kDispatchIntervalMillis = 100;
+
+// Scrapers send a short GET request, anything longer is not for us
+constexpr qint64 kMaxRequestSize = 8192;
+
+constexpr int kRequestTimeoutMillis = 5000;
+
+qint64 residentMemoryBytes() {
+#ifdef __LINUX__
+    // The second field is the resident set size in pages
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return -1;
+}
+
+QByteArray escapeLabelValue(const QString& value) {
+    QByteArray escaped = value.toUtf8();
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    escaped.replace('\n', "\\n");
+    return escaped;
+}
+
+void appendHeader(QByteArray* pOutput,
+        const char* name,
+        const char* type,
+        const char* help) {
+    *pOutput += QByteArrayLiteral("# HELP ") + name + ' ' + help + '\n';
+    *pOutput += QByteArrayLiteral("# TYPE ") + name + ' ' + type + '\n';
+}
+
+void appendSample(QByteArray* pOutput,
+        const QByteArray& name,
+        double value,
+        const QByteArray& labels = QByteArray()) {
+    *pOutput += name;
+    if (!labels.isEmpty()) {
+        *pOutput += '{' + labels + '}';
+    }
+    *pOutput += ' ' + QByteArray::number(value, 'g', 17) + '\n';
+}
+
+void appendMetric(QByteArray* pOutput,
+        const char* name,
+        const char* type,
+        const char* help,
+        double value) {
+    appendHeader(pOutput, name, type, help);
+    appendSample(pOutput, name, value);
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(UserSettingsPointer pConfig,
+        SoundManager* pSoundManager,
+        EngineMixer* pEngine,
+        QObject* pParent)
+        : QObject(pParent),
+          m_pSoundManager(pSoundManager),
+          m_pEngine(pEngine),
+          m_pServer(make_parented<QTcpServer>(this)),
+          m_engineLoad(kAppGroup,
+                  QStringLiteral("audio_latency_usage"),
+                  ControlFlag::AllowMissingOrInvalid),
+          m_xrunCount(kAppGroup,
+                  QStringLiteral("audio_latency_overload_count"),
+                  ControlFlag::AllowMissingOrInvalid) {
+    connect(m_pServer,
+            &QTcpServer::newConnection,
+            this,
+            &MetricsServer::slotNewConnection);
+    const QHostAddress address(pConfig->getValue(
+            ConfigKey(kAppGroup, QStringLiteral("metrics_address")),
+            QStringLiteral("127.0.0.1")));
+    const auto port = static_cast<quint16>(pConfig->getValue(
+            ConfigKey(kAppGroup, QStringLiteral("metrics_port")), 0));
+    if (!m_pServer->listen(address, port)) {
+        kLogger.warning() << "Failed to listen on" << address << port
+                          << m_pServer->errorString();
+        return;
+    }
+    kLogger.info() << "Serving metrics on" << address << m_pServer->serverPort();
+
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler) {
+        pProfiler->addConsumer(this);
+    }
+    StatsManager* pStatsManager = StatsManager::instance();
+    if (pStatsManager) {
+        connect(pStatsManager,
+                &StatsManager::statUpdated,
+                this,
+                &MetricsServer::slotStatUpdated);
+        pStatsManager->emitAllStats();
+    }
+    startTimer(kDispatchIntervalMillis);
+}
+
+MetricsServer::~MetricsServer() {
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler) {
+        pProfiler->removeConsumer(this);
+    }
+}
+
+bool MetricsServer::isListening() const {
+    return m_pServer->isListening();
+}
+
+quint16 MetricsServer::serverPort() const {
+    return m_pServer->serverPort();
+}
+
+void MetricsServer::timerEvent(QTimerEvent* pTimerEvent) {
+    Q_UNUSED(pTimerEvent);
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler) {
+        pProfiler->dispatch();
+    }
+}
+
+void MetricsServer::consumeProfiles(
+        const std::vector<EngineProfiler::CallbackProfile>& profiles,
+        int droppedProfiles) {
+    m_engineMetrics.droppedProfiles += droppedProfiles;
+    // The histogram of a batch is merged into 64 bit counters that don't
+    // overflow while running for months
+    EngineProfileStatistics::Histogram histogram;
+    for (const auto& profile : profiles) {
+        const auto& callback =
+                profile.stages[static_cast<int>(EngineProfiler::Stage::Callback)];
+        histogram.add(callback.durationNanos);
+        m_engineMetrics.callbackSeconds +=
+                static_cast<double>(callback.durationNanos) / mixxx::Duration::kNanosPerSecond;
+        if (profile.sampleRate > 0 &&
+                static_cast<double>(callback.durationNanos) * profile.sampleRate >
+                        static_cast<double>(profile.frames) *
+                                mixxx::Duration::kNanosPerSecond) {
+            m_engineMetrics.lateCallbacks++;
+        }
+        for (const auto cacheMisses : profile.cacheMisses) {
+            m_engineMetrics.cacheMisses += cacheMisses;
+        }
+    }
+    for (int bucket = 0; bucket < EngineProfileStatistics::Histogram::kNumBuckets; ++bucket) {
+        m_engineMetrics.callbackBuckets[bucket] += histogram.bucketCount(bucket);
+    }
+    m_engineMetrics.callbackCount += histogram.count();
+}
+
+void MetricsServer::slotStatUpdated(const Stat& stat) {
+    m_stats.insert(stat.m_tag, stat);
+}
+
+MetricsServer::Snapshot MetricsServer::snapshot() const {
+    Snapshot snapshot = m_engineMetrics;
+    snapshot.engineLoad = m_engineLoad.get();
+    snapshot.xruns = m_xrunCount.get();
+    if (m_pSoundManager && m_pSoundManager->getNetworkStream()) {
+        const auto workers = m_pSoundManager->getNetworkStream()->outputWorkers();
+        for (const auto& pWorker : workers) {
+            if (!pWorker) {
+                continue;
+            }
+            const auto pFifo = pWorker->getOutputFifo();
+            if (!pFifo) {
+                continue;
+            }
+            const int size = pFifo->readAvailable() + pFifo->writeAvailable();
+            snapshot.networkOutputFillLevels.append(
+                    size > 0 ? static_cast<double>(pFifo->readAvailable()) / size : 0.0);
+        }
+    }
+    if (m_pEngine && m_pEngine->getSideChain()) {
+        snapshot.sideChainLags = m_pEngine->getSideChain()->workerLags();
+    }
+    snapshot.residentMemoryBytes = residentMemoryBytes();
+    snapshot.memoryUsage = mixxx::MemoryUsage::report();
+    snapshot.stats = m_stats.values();
+    return snapshot;
+}
+
+// static
+QByteArray MetricsServer::formatMetrics(const Snapshot& snapshot) {
+    QByteArray output;
+
+    const char* const kCallbackDuration = "mixxx_engine_callback_duration_seconds";
+    appendHeader(&output,
+            kCallbackDuration,
+            "histogram",
+            "Duration of the audio engine callbacks.");
+    quint64 cumulativeCount = 0;
+    for (int bucket = 0; bucket < EngineProfileStatistics::Histogram::kNumBuckets; ++bucket) {
+        cumulativeCount += snapshot.callbackBuckets[bucket];
+        // The last bucket holds all longer durations
+        const QByteArray upperBound =
+                bucket < EngineProfileStatistics::Histogram::kNumBuckets - 1
+                ? QByteArray::number(
+                          static_cast<double>(EngineProfileStatistics::Histogram::
+                                          bucketUpperBoundNanos(bucket)) /
+                                  mixxx::Duration::kNanosPerSecond,
+                          'g',
+                          6)
+                : QByteArrayLiteral("+Inf");
+        appendSample(&output,
+                QByteArray(kCallbackDuration) + "_bucket",
+                static_cast<double>(cumulativeCount),
+                "le=\"" + upperBound + '"');
+    }
+    appendSample(&output, QByteArray(kCallbackDuration) + "_sum", snapshot.callbackSeconds);
+    appendSample(&output,
+            QByteArray(kCallbackDuration) + "_count",
+            static_cast<double>(snapshot.callbackCount));
+
+    appendMetric(&output,
+            "mixxx_engine_late_callbacks_total",
+            "counter",
+            "Callbacks that took longer than the duration of their buffer.",
+            static_cast<double>(snapshot.lateCallbacks));
+    appendMetric(&output,
+            "mixxx_engine_dropped_profiles_total",
+            "counter",
+            "Callbacks that are missing in the callback duration histogram.",
+            static_cast<double>(snapshot.droppedProfiles));
+    appendMetric(&output,
+            "mixxx_engine_load_ratio",
+            "gauge",
+            "Share of the buffer duration spent in the audio callback.",
+            snapshot.engineLoad);
+    appendMetric(&output,
+            "mixxx_engine_xruns_total",
+            "counter",
+            "Buffer underflows and overflows of the audio interface.",
+            snapshot.xruns);
+    appendMetric(&output,
+            "mixxx_caching_reader_misses_total",
+            "counter",
+            "Chunks that were not cached when a deck read them.",
+            static_cast<double>(snapshot.cacheMisses));
+
+    const char* const kNetworkOutputFill = "mixxx_network_output_buffer_fill_ratio";
+    appendHeader(&output,
+            kNetworkOutputFill,
+            "gauge",
+            "Fill level of the buffer of each broadcast or network output.");
+    for (int i = 0; i < snapshot.networkOutputFillLevels.size(); ++i) {
+        appendSample(&output,
+                kNetworkOutputFill,
+                snapshot.networkOutputFillLevels[i],
+                "output=\"" + QByteArray::number(i + 1) + '"');
+    }
+
+    const char* const kSideChainLag = "mixxx_sidechain_worker_lag_samples";
+    appendHeader(&output,
+            kSideChainLag,
+            "gauge",
+            "Samples the recording and broadcast workers are behind the engine.");
+    for (int i = 0; i < snapshot.sideChainLags.size(); ++i) {
+        appendSample(&output,
+                kSideChainLag,
+                static_cast<double>(snapshot.sideChainLags[i]),
+                "worker=\"" + QByteArray::number(i + 1) + '"');
+    }
+
+    if (snapshot.residentMemoryBytes >= 0) {
+        appendMetric(&output,
+                "mixxx_resident_memory_bytes",
+                "gauge",
+                "Resident memory size of the process.",
+                static_cast<double>(snapshot.residentMemoryBytes));
+    }
+
+    const char* const kMemoryUsage = "mixxx_memory_bytes";
+    appendHeader(&output,
+            kMemoryUsage,
+            "gauge",
+            "Estimated memory held by each subsystem.");
+    for (const auto& subsystem : snapshot.memoryUsage) {
+        appendSample(&output,
+                kMemoryUsage,
+                static_cast<double>(subsystem.bytes),
+                "subsystem=\"" + escapeLabelValue(subsystem.name) + '"');
+    }
+
+    if (!snapshot.stats.isEmpty()) {
+        const struct {
+            const char* name;
+            const char* help;
+            double Stat::*pValue;
+        } statFields[] = {
+                {"mixxx_stat_reports", "Reports of the developer stats.", &Stat::m_report_count},
+                {"mixxx_stat_sum", "Sum of the developer stats.", &Stat::m_sum},
+                {"mixxx_stat_min", "Minimum of the developer stats.", &Stat::m_min},
+                {"mixxx_stat_max", "Maximum of the developer stats.", &Stat::m_max},
+        };
+        for (const auto& field : statFields) {
+            appendHeader(&output, field.name, "gauge", field.help);
+            for (const auto& stat : snapshot.stats) {
+                appendSample(&output,
+                        field.name,
+                        stat.*field.pValue,
+                        "tag=\"" + escapeLabelValue(stat.m_tag) + "\",unit=\"" +
+                                escapeLabelValue(stat.valueUnits()) + '"');
+            }
+        }
+    }
+    return output;
+}
+
+void MetricsServer::slotNewConnection() {
+    while (m_pServer->hasPendingConnections()) {
+        QTcpSocket* pSocket = m_pServer->nextPendingConnection();
+        connect(pSocket, &QTcpSocket::disconnected, pSocket, &QObject::deleteLater);
+        connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket] {
+            respond(pSocket);
+        });
+        // Don't keep connections of clients that never finish their request
+        QTimer::singleShot(kRequestTimeoutMillis, pSocket, &QTcpSocket::abort);
+    }
+}
+
+void MetricsServer::respond(QTcpSocket* pSocket) {
+    const QByteArray request = pSocket->peek(kMaxRequestSize);
+    if (!request.contains("\r\n\r\n")) {
+        if (request.size() >= kMaxRequestSize) {
+            pSocket->abort();
+        }
+        // Wait for the rest of the request
+        return;
+    }
+    pSocket->readAll();
+
+    const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    QByteArray status;
+    QByteArray body;
+    if (requestLine.size() < 2 || requestLine[0] != "GET") {
+        status = QByteArrayLiteral("405 Method Not Allowed");
+    } else if (requestLine[1] != "/metrics") {
+        status = QByteArrayLiteral("404 Not Found");
+    } else {
+        status = QByteArrayLiteral("200 OK");
+        body = formatMetrics(snapshot());
+    }
+    pSocket->write(QByteArrayLiteral("HTTP/1.1 ") + status +
+            "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8"
+            "\r\nContent-Length: " +
+            QByteArray::number(body.size()) +
+            "\r\nConnection: close\r\n\r\n" + body);
+    pSocket->disconnectFromHost();
+}
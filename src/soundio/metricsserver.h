@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QVector>
+#include <array>
+
+#include "control/pollingcontrolproxy.h"
+#include "engine/engineprofiler.h"
+#include "preferences/usersettings.h"
+#include "util/memoryusage.h"
+#include "util/parented_ptr.h"
+#include "util/stat.h"
+
+class EngineMixer;
+class QTcpServer;
+class QTcpSocket;
+class SoundManager;
+
+/// Serves the health of the engine in the Prometheus text format under
+/// http://<address>:<port>/metrics, for monitoring many unattended
+/// instances like venues and radio streams from a central place.
+///
+/// The engine timings are taken from the EngineProfiler and drained in the
+/// GUI thread like for the XrunRecorder, the other values are polled when
+/// scraped. Nothing is computed in the engine thread beyond the profiler.
+/// The stats of the StatsManager are included in developer mode.
+///
+/// Enabled with [App],metrics_port. [App],metrics_address is the address to
+/// listen on, only the local host by default.
+class MetricsServer : public QObject, public EngineProfiler::Consumer {
+    Q_OBJECT
+  public:
+    /// The values of a single scrape
+    struct Snapshot {
+        /// Callback durations per bucket of EngineProfileStatistics::Histogram,
+        /// not cumulative
+        std::array<quint64, EngineProfileStatistics::Histogram::kNumBuckets>
+                callbackBuckets{};
+        quint64 callbackCount = 0;
+        double callbackSeconds = 0;
+        quint64 lateCallbacks = 0;
+        quint64 droppedProfiles = 0;
+        quint64 cacheMisses = 0;
+        double engineLoad = 0;
+        double xruns = 0;
+        /// The fill level of the FIFO of every network output in [0, 1]
+        QVector<double> networkOutputFillLevels;
+        /// Samples each sidechain worker (recording, broadcast) is behind
+        QVector<std::uint64_t> sideChainLags;
+        /// Negative if not available on this platform
+        qint64 residentMemoryBytes = -1;
+        QList<mixxx::MemoryUsage::Subsystem> memoryUsage;
+        QList<Stat> stats;
+    };
+
+    /// The sound manager and the engine may be null, their metrics are
+    /// omitted then.
+    MetricsServer(UserSettingsPointer pConfig,
+            SoundManager* pSoundManager,
+            EngineMixer* pEngine,
+            QObject* pParent = nullptr);
+    ~MetricsServer() override;
+
+    bool isListening() const;
+    quint16 serverPort() const;
+
+    void consumeProfiles(const std::vector<EngineProfiler::CallbackProfile>& profiles,
+            int droppedProfiles) override;
+
+    Snapshot snapshot() const;
+
+    static QByteArray formatMetrics(const Snapshot& snapshot);
+
+  protected:
+    void timerEvent(QTimerEvent* pTimerEvent) override;
+
+  private slots:
+    void slotNewConnection();
+    void slotStatUpdated(const Stat& stat);
+
+  private:
+    void respond(QTcpSocket* pSocket);
+
+    SoundManager* const m_pSoundManager;
+    EngineMixer* const m_pEngine;
+    parented_ptr<QTcpServer> m_pServer;
+
+    PollingControlProxy m_engineLoad;
+    PollingControlProxy m_xrunCount;
+
+    Snapshot m_engineMetrics;
+    QMap<QString, Stat> m_stats;
+};
@@ -1,5 +1,6 @@
 #include "soundio/sounddevice.h"
 
+#include "soundio/latencymeasurement.h"
 #include "soundio/soundmanagerconfig.h"
 #include "soundio/soundmanagerutil.h"
 #include "soundmanagerconfig.h"
@@ -15,7 +16,10 @@ SoundDevice::SoundDevice(UserSettingsPointer config, SoundManager* sm)
           m_numInputChannels(mixxx::audio::ChannelCount::stereo()),
           m_sampleRate(SoundManagerConfig::kMixxxDefaultSampleRate),
           m_hostAPI("Unknown API"),
-          m_configFramesPerBuffer(0) {
+          m_configFramesPerBuffer(0),
+          m_pInputLatencyMeasurement(nullptr),
+          m_pOutputLatencyMeasurement(nullptr),
+          m_numUsedOutputChannels(0) {
 }
 
 mixxx::audio::ChannelCount SoundDevice::getNumInputChannels() const {
@@ -53,11 +57,14 @@ SoundDeviceStatus SoundDevice::addOutput(const AudioOutputBuffer& out) {
         return SoundDeviceStatus::ErrorExcessiveOutputChannel;
     }
     m_audioOutputs.append(out);
+    // Outputs do not share channels, see above
+    m_numUsedOutputChannels += out.getChannelGroup().getChannelCount();
     return SoundDeviceStatus::Ok;
 }
 
 void SoundDevice::clearOutputs() {
     m_audioOutputs.clear();
+    m_numUsedOutputChannels = 0;
 }
 
 SoundDeviceStatus SoundDevice::addInput(const AudioInputBuffer& in) {
@@ -76,6 +83,12 @@ void SoundDevice::clearInputs() {
     m_audioInputs.clear();
 }
 
+void SoundDevice::setLatencyMeasurement(LatencyMeasurement* pInputMeasurement,
+        LatencyMeasurement* pOutputMeasurement) {
+    m_pInputLatencyMeasurement.store(pInputMeasurement, std::memory_order_release);
+    m_pOutputLatencyMeasurement.store(pOutputMeasurement, std::memory_order_release);
+}
+
 bool SoundDevice::operator==(const SoundDevice &other) const {
     return m_deviceId == other.getDeviceId();
 }
@@ -90,64 +103,45 @@ void SoundDevice::composeOutputBuffer(CSAMPLE* outputBuffer,
 
     // Interlace Audio data onto portaudio buffer.  We iterate through the
     // source list to find out what goes in the buffer data is interlaced in
-    // the order of the list
-
-    if (iFrameSize == 2 && m_audioOutputs.size() == 1 &&
-            m_audioOutputs.at(0).getChannelGroup().getChannelCount() == 2) {
-        // Special case for one stereo device only
-        const AudioOutputBuffer& out = m_audioOutputs.at(0);
-        const CSAMPLE* pAudioOutputBuffer = out.getBuffer(); // Always Stereo
-        pAudioOutputBuffer = &pAudioOutputBuffer[framesReadOffset*2];
-        SampleUtil::copyClampBuffer(outputBuffer, pAudioOutputBuffer,
-               framesToCompose * 2);
-    } else {
-        // Reset sample for each open channel
+    // the order of the list. Each output is written directly to its channels
+    // of the device buffer, so the only copy is the one that clamps the
+    // engine output, which is shared with the recording and broadcasting.
+
+    if (m_numUsedOutputChannels < iFrameSize) {
+        // Silence the channels that no output writes to
         SampleUtil::clear(outputBuffer, framesToCompose * iFrameSize);
+    }
 
-        for (QList<AudioOutputBuffer>::iterator i = m_audioOutputs.begin(),
-                     e = m_audioOutputs.end(); i != e; ++i) {
-            AudioOutputBuffer& out = *i;
-
-            const ChannelGroup outChans = out.getChannelGroup();
-            const int iChannelCount = outChans.getChannelCount();
-            const int iChannelBase = outChans.getChannelBase();
-
-            const CSAMPLE* pAudioOutputBuffer = out.getBuffer();
-            // advanced to offset; pAudioOutputBuffer is always stereo
-            pAudioOutputBuffer = &pAudioOutputBuffer[framesReadOffset*2];
-            if (iChannelCount == 1) {
-                // All AudioOutputs are stereo as of Mixxx 1.12.0. If we have a mono
-                // output then we need to downsample.
-                for (SINT iFrameNo = 0; iFrameNo < framesToCompose; ++iFrameNo) {
-                    // iFrameBase is the "base sample" in a frame (ie. the first
-                    // sample in a frame)
-                    const SINT iFrameBase = iFrameNo * iFrameSize;
-                    outputBuffer[iFrameBase + iChannelBase] = SampleUtil::clampSample(
-                            (pAudioOutputBuffer[iFrameNo * 2] +
-                                    pAudioOutputBuffer[iFrameNo * 2 + 1]) / 2.0f);
-                }
-            } else {
-                for (SINT iFrameNo = 0; iFrameNo < framesToCompose; ++iFrameNo) {
-                    // iFrameBase is the "base sample" in a frame (ie. the first
-                    // sample in a frame)
-                    const SINT iFrameBase = iFrameNo * iFrameSize;
-                    const SINT iLocalFrameBase = iFrameNo * iChannelCount;
-
-                    // this will make sure a sample from each channel is copied
-                    for (int iChannel = 0; iChannel < iChannelCount; ++iChannel) {
-                        outputBuffer[iFrameBase + iChannelBase + iChannel] =
-                                SampleUtil::clampSample(
-                                        pAudioOutputBuffer[iLocalFrameBase + iChannel]);
-
-                        // Input audio pass-through (useful for debugging)
-                        //if (in)
-                        //    output[iFrameBase + src.channelBase + iChannel] =
-                        //    in[iFrameBase + src.channelBase + iChannel];
-                    }
-                }
-            }
+    const auto frameSize = mixxx::audio::ChannelCount(iFrameSize);
+    for (const AudioOutputBuffer& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup outChans = out.getChannelGroup();
+        const int iChannelCount = outChans.getChannelCount();
+        const int iChannelBase = outChans.getChannelBase();
+
+        // advanced to offset; pAudioOutputBuffer is always stereo
+        const CSAMPLE* pAudioOutputBuffer = &out.getBuffer()[framesReadOffset * 2];
+        if (iChannelCount == 1) {
+            // All AudioOutputs are stereo as of Mixxx 1.12.0. If we have a mono
+            // output then we need to downsample.
+            SampleUtil::insertClampStereoToMonoInMulti(outputBuffer,
+                    pAudioOutputBuffer,
+                    framesToCompose,
+                    frameSize,
+                    iChannelBase);
+        } else {
+            SampleUtil::insertClampStereoToMulti(outputBuffer,
+                    pAudioOutputBuffer,
+                    framesToCompose,
+                    frameSize,
+                    iChannelBase);
         }
     }
+
+    LatencyMeasurement* pMeasurement =
+            m_pOutputLatencyMeasurement.load(std::memory_order_acquire);
+    if (pMeasurement) {
+        pMeasurement->processOutput(outputBuffer, framesToCompose, iFrameSize);
+    }
 }
 
 void SoundDevice::composeInputBuffer(const CSAMPLE* inputBuffer,
@@ -159,64 +153,48 @@ void SoundDevice::composeInputBuffer(const CSAMPLE* inputBuffer,
     // This function is called a *lot* and is a big source of CPU usage.
     // It needs to be very fast.
 
-    // If the framesize is only 2, then we only have one pair of input channels
-    //  That means we don't have to do any deinterlacing, and we can pass
-    //  the audio on to its intended destination.
-    if (iFrameSize == 1 && m_audioInputs.size() == 1 &&
-            m_audioInputs.at(0).getChannelGroup().getChannelCount() == 1) {
-        // One mono device only
-        const AudioInputBuffer& in = m_audioInputs.at(0);
-        CSAMPLE* pInputBuffer = in.getBuffer(); // Always Stereo
-        pInputBuffer = &pInputBuffer[framesWriteOffset * 2];
-        for (SINT iFrameNo = 0; iFrameNo < framesToPush; ++iFrameNo) {
-            pInputBuffer[iFrameNo * 2] =
-                    inputBuffer[iFrameNo];
-            pInputBuffer[iFrameNo * 2 + 1] =
-                    inputBuffer[iFrameNo];
-        }
-    } else if (iFrameSize == 2 && m_audioInputs.size() == 1 &&
-            m_audioInputs.at(0).getChannelGroup().getChannelCount() == 2) {
-        // One stereo device only
-        const AudioInputBuffer& in = m_audioInputs.at(0);
-        CSAMPLE* pInputBuffer = in.getBuffer(); // Always Stereo
-        pInputBuffer = &pInputBuffer[framesWriteOffset * 2];
-        SampleUtil::copy(pInputBuffer, inputBuffer, framesToPush * 2);
-    } else {
-        // Non Stereo input (iFrameSize != 2)
-        // Do crazy deinterleaving of the audio into the correct m_inputBuffers.
-
-        for (auto i = m_audioInputs.constBegin(), e = m_audioInputs.constEnd(); i != e; ++i) {
-            const AudioInputBuffer& in = *i;
-            ChannelGroup chanGroup = in.getChannelGroup();
-            int iChannelCount = chanGroup.getChannelCount();
-            int iChannelBase = chanGroup.getChannelBase();
-            CSAMPLE* pInputBuffer = in.getBuffer();
-            pInputBuffer = &pInputBuffer[framesWriteOffset * 2];
-
-            for (SINT iFrameNo = 0; iFrameNo < framesToPush; ++iFrameNo) {
-                // iFrameBase is the "base sample" in a frame (ie. the first
-                // sample in a frame)
-                SINT iFrameBase = iFrameNo * iFrameSize;
-                SINT iLocalFrameBase = iFrameNo * 2;
-
-                if (iChannelCount == 1) {
-                    pInputBuffer[iLocalFrameBase] =
-                            inputBuffer[iFrameBase + iChannelBase];
-                    pInputBuffer[iLocalFrameBase + 1] =
-                            inputBuffer[iFrameBase + iChannelBase];
-                } else if (iChannelCount > 1) {
-                    pInputBuffer[iLocalFrameBase] =
-                            inputBuffer[iFrameBase + iChannelBase];
-                    pInputBuffer[iLocalFrameBase + 1] =
-                            inputBuffer[iFrameBase + iChannelBase + 1];
-                }
-            }
+    LatencyMeasurement* pMeasurement =
+            m_pInputLatencyMeasurement.load(std::memory_order_acquire);
+    if (pMeasurement) {
+        pMeasurement->processInput(inputBuffer, framesToPush, iFrameSize);
+    }
+
+    // Deinterleave the channels of each input from the device buffer into
+    // its stereo buffer. The buffer is passed by pointer to all destinations
+    // of the input, like the microphone or auxiliary channel, the vinyl
+    // control processor and the passthrough of the deck, so this is the
+    // only copy on the input path.
+    const auto frameSize = mixxx::audio::ChannelCount(iFrameSize);
+    for (const AudioInputBuffer& in : std::as_const(m_audioInputs)) {
+        const ChannelGroup chanGroup = in.getChannelGroup();
+        const int iChannelCount = chanGroup.getChannelCount();
+        const int iChannelBase = chanGroup.getChannelBase();
+
+        // advanced to offset; pInputBuffer is always stereo
+        CSAMPLE* pInputBuffer = &in.getBuffer()[framesWriteOffset * 2];
+        if (iChannelCount == 1) {
+            SampleUtil::copyMonoInMultiToDualMono(pInputBuffer,
+                    inputBuffer,
+                    framesToPush,
+                    frameSize,
+                    iChannelBase);
+        } else if (iChannelCount > 1) {
+            SampleUtil::copyOneStereoFromMulti(pInputBuffer,
+                    inputBuffer,
+                    framesToPush,
+                    frameSize,
+                    iChannelBase);
         }
     }
 }
 
 void SoundDevice::clearInputBuffer(const SINT framesToPush,
                                    const SINT framesWriteOffset) {
+    LatencyMeasurement* pMeasurement =
+            m_pInputLatencyMeasurement.load(std::memory_order_acquire);
+    if (pMeasurement) {
+        pMeasurement->processInput(nullptr, framesToPush, 0);
+    }
     for (auto i = m_audioInputs.constBegin(), e = m_audioInputs.constEnd(); i != e; ++i) {
         const AudioInputBuffer& in = *i;
         CSAMPLE* pInputBuffer = in.getBuffer();  // Always stereo
@@ -2,6 +2,8 @@
 
 #include <QList>
 #include <QString>
+#include <atomic>
+#include <optional>
 
 #include "audio/types.h"
 #include "preferences/usersettings.h"
@@ -12,6 +14,7 @@
 class SoundManager;
 class AudioOutputBuffer;
 class AudioInputBuffer;
+class LatencyMeasurement;
 
 const QString kNetworkDeviceInternalName = "Network stream";
 
@@ -38,6 +41,23 @@ class SoundDevice {
     virtual void writeProcess(SINT framesPerBuffer) = 0;
     virtual QString getError() const = 0;
     virtual mixxx::audio::SampleRate getDefaultSampleRate() const = 0;
+    // The estimated clock drift to the clock reference device in ppm, if the
+    // device compensates it.
+    virtual std::optional<double> getClockDriftPpm() const {
+        return std::nullopt;
+    }
+    // Changes the buffer size of the open device without reopening it, if
+    // the backend is able to renegotiate it. Returns false if the device
+    // must be reopened instead.
+    virtual bool changeFramesPerBuffer(unsigned int framesPerBuffer) {
+        Q_UNUSED(framesPerBuffer);
+        return false;
+    }
+    // The buffer size of the open device, if the server of the backend
+    // decides about it instead of the configuration.
+    virtual std::optional<unsigned int> getServerFramesPerBuffer() const {
+        return std::nullopt;
+    }
     mixxx::audio::ChannelCount getNumOutputChannels() const;
     mixxx::audio::ChannelCount getNumInputChannels() const;
     SoundDeviceStatus addOutput(const AudioOutputBuffer& out);
@@ -51,6 +71,10 @@ class SoundDevice {
 
     void clearOutputs();
     void clearInputs();
+    /// Set by SoundManager while the loopback of the output device to the
+    /// input device is measured, nullptr otherwise.
+    void setLatencyMeasurement(LatencyMeasurement* pInputMeasurement,
+            LatencyMeasurement* pOutputMeasurement);
     bool operator==(const SoundDevice &other) const;
     bool operator==(const QString &other) const;
 
@@ -90,6 +114,13 @@ class SoundDevice {
     SINT m_configFramesPerBuffer;
     QList<AudioOutputBuffer> m_audioOutputs;
     QList<AudioInputBuffer> m_audioInputs;
+    std::atomic<LatencyMeasurement*> m_pInputLatencyMeasurement;
+    std::atomic<LatencyMeasurement*> m_pOutputLatencyMeasurement;
+
+  private:
+    // The number of device channels written by m_audioOutputs. If all
+    // channels are written, the device buffer does not need to be cleared.
+    int m_numUsedOutputChannels;
 };
 
 typedef QSharedPointer<SoundDevice> SoundDevicePointer;
@@ -0,0 +1,560 @@
+#include "soundio/sounddevicejack.h"
+
+#include <float.h>
+
+#include <cerrno>
+
+#include <QThread>
+#include <QtDebug>
+
+#include "control/controlobject.h"
+#include "soundio/latencymeasurement.h"
+#include "soundio/soundmanager.h"
+#include "soundio/soundmanagerutil.h"
+#include "util/assert.h"
+#include "util/defs.h"
+#include "util/denormalsarezero.h"
+#include "util/math.h"
+#include "util/realtime.h"
+#include "util/sample.h"
+#include "util/tracing.h"
+#include "util/versionstore.h"
+#include "waveform/visualplayposition.h"
+
+#ifdef __LINUX__
+// for sched_getscheduler
+#include <sched.h>
+#endif
+
+namespace {
+
+constexpr int kCpuUsageUpdateRate = 30; // in 1/s, fits to display frame rate
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+QByteArray clientName() {
+    return VersionStore::applicationName().toLocal8Bit();
+}
+
+int countPhysicalPorts(jack_client_t* pClient, unsigned long flags) {
+    const char** ppPorts = jack_get_ports(
+            pClient, nullptr, JACK_DEFAULT_AUDIO_TYPE, JackPortIsPhysical | flags);
+    if (!ppPorts) {
+        return 0;
+    }
+    int count = 0;
+    while (ppPorts[count]) {
+        ++count;
+    }
+    jack_free(ppPorts);
+    return count;
+}
+
+int jackProcessCallback(jack_nframes_t frames, void* pSoundDevice) {
+    return static_cast<SoundDeviceJack*>(pSoundDevice)->callbackProcess(frames);
+}
+
+int jackBufferSizeCallback(jack_nframes_t frames, void* pSoundDevice) {
+    return static_cast<SoundDeviceJack*>(pSoundDevice)->callbackBufferSize(frames);
+}
+
+int jackXrunCallback(void* pSoundDevice) {
+    return static_cast<SoundDeviceJack*>(pSoundDevice)->callbackXrun();
+}
+
+void jackLatencyCallback(jack_latency_callback_mode_t mode, void* pSoundDevice) {
+    if (mode == JackPlaybackLatency) {
+        static_cast<SoundDeviceJack*>(pSoundDevice)->callbackLatency();
+    }
+}
+
+void jackShutdownCallback(void* pSoundDevice) {
+    static_cast<SoundDeviceJack*>(pSoundDevice)->callbackShutdown();
+}
+
+} // anonymous namespace
+
+SoundDeviceJack::SoundDeviceJack(UserSettingsPointer config,
+        SoundManager* sm,
+        mixxx::audio::SampleRate serverSampleRate,
+        mixxx::audio::ChannelCount numOutputChannels,
+        mixxx::audio::ChannelCount numInputChannels)
+        : SoundDevice(config, sm),
+          m_serverSampleRate(serverSampleRate),
+          m_pClient(nullptr),
+          m_outputLatencyFrames(0),
+          m_active(false),
+          m_bCallbackThreadInitialized(false),
+          m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
+          m_framesSinceAudioLatencyUsageUpdate(0) {
+    // Setting parent class members:
+    m_hostAPI = MIXXX_JACK_NATIVE_STRING;
+    m_sampleRate = serverSampleRate;
+    m_deviceId.name = QStringLiteral("JACK");
+    m_strDisplayName = QStringLiteral("JACK");
+    m_numOutputChannels = numOutputChannels;
+    m_numInputChannels = numInputChannels;
+}
+
+SoundDeviceJack::~SoundDeviceJack() {
+    close();
+}
+
+// static
+SoundDevicePointer SoundDeviceJack::query(UserSettingsPointer config, SoundManager* sm) {
+    jack_status_t status;
+    jack_client_t* pClient = jack_client_open(
+            clientName().constData(), JackNoStartServer, &status);
+    if (!pClient) {
+        qDebug() << "No JACK server is running, status" << Qt::hex << status;
+        return {};
+    }
+    const auto sampleRate = mixxx::audio::SampleRate(jack_get_sample_rate(pClient));
+    // The playback ports of the hardware are inputs of the JACK graph.
+    // Without hardware ports, e.g. if only other clients are connected, we
+    // offer a stereo pair that can be connected manually.
+    const auto numOutputChannels = mixxx::audio::ChannelCount(
+            math_max(countPhysicalPorts(pClient, JackPortIsInput), 2));
+    const auto numInputChannels = mixxx::audio::ChannelCount(
+            math_max(countPhysicalPorts(pClient, JackPortIsOutput), 2));
+    jack_client_close(pClient);
+    qDebug() << "Found a JACK server running at" << sampleRate;
+    return SoundDevicePointer(new SoundDeviceJack(
+            config, sm, sampleRate, numOutputChannels, numInputChannels));
+}
+
+SoundDeviceStatus SoundDeviceJack::open(bool isClkRefDevice, int syncBuffers) {
+    Q_UNUSED(syncBuffers);
+    qDebug() << "SoundDeviceJack::open()" << m_deviceId;
+
+    if (m_audioOutputs.empty() && m_audioInputs.empty()) {
+        m_lastError = QStringLiteral(
+                "No inputs or outputs in SDJ::open() "
+                "(THIS IS A BUG, this should be filtered by SM::setupDevices)");
+        return SoundDeviceStatus::Error;
+    }
+    if (!isClkRefDevice) {
+        m_lastError = QStringLiteral(
+                "The JACK server drives the engine. Connect additional sound "
+                "cards within JACK instead of opening them next to it.");
+        return SoundDeviceStatus::Error;
+    }
+
+    int numOutputChannels = 0;
+    for (const auto& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup channelGroup = out.getChannelGroup();
+        numOutputChannels = math_max(numOutputChannels,
+                channelGroup.getChannelBase() + channelGroup.getChannelCount());
+    }
+    int numInputChannels = 0;
+    for (const auto& in : std::as_const(m_audioInputs)) {
+        const ChannelGroup channelGroup = in.getChannelGroup();
+        numInputChannels = math_max(numInputChannels,
+                channelGroup.getChannelBase() + channelGroup.getChannelCount());
+    }
+
+    jack_status_t status;
+    jack_client_t* pClient = jack_client_open(
+            clientName().constData(), JackNoStartServer, &status);
+    if (!pClient) {
+        m_lastError = QStringLiteral("Failed to connect to the JACK server, status 0x%1")
+                              .arg(static_cast<int>(status), 0, 16);
+        return SoundDeviceStatus::Error;
+    }
+    m_pClient.store(pClient, std::memory_order_relaxed);
+
+    if (!registerPorts(&m_outputPorts, numOutputChannels, "out_%1", JackPortIsOutput) ||
+            !registerPorts(&m_inputPorts, numInputChannels, "in_%1", JackPortIsInput)) {
+        close();
+        return SoundDeviceStatus::Error;
+    }
+    // The ports between the channels of the outputs are silent
+    m_unusedOutputPorts.clear();
+    for (int port = 0; port < m_outputPorts.size(); ++port) {
+        bool used = false;
+        for (const auto& out : std::as_const(m_audioOutputs)) {
+            const ChannelGroup channelGroup = out.getChannelGroup();
+            if (port >= channelGroup.getChannelBase() &&
+                    port < channelGroup.getChannelBase() + channelGroup.getChannelCount()) {
+                used = true;
+                break;
+            }
+        }
+        if (!used) {
+            m_unusedOutputPorts.append(m_outputPorts[port]);
+        }
+    }
+
+    jack_set_process_callback(pClient, jackProcessCallback, this);
+    jack_set_buffer_size_callback(pClient, jackBufferSizeCallback, this);
+    jack_set_latency_callback(pClient, jackLatencyCallback, this);
+    jack_set_xrun_callback(pClient, jackXrunCallback, this);
+    jack_on_shutdown(pClient, jackShutdownCallback, this);
+
+    // The server decides about the sample rate and the buffer size
+    const auto sampleRate = mixxx::audio::SampleRate(jack_get_sample_rate(pClient));
+    if (sampleRate != m_sampleRate) {
+        qWarning() << "Using the JACK server's sample rate" << sampleRate
+                   << "instead of" << m_sampleRate;
+    }
+    m_sampleRate = sampleRate;
+    const jack_nframes_t bufferSize = jack_get_buffer_size(pClient);
+    qDebug() << "Sample rate:" << m_sampleRate << "Hz, frames per period:" << bufferSize
+             << "| Output channels:" << numOutputChannels
+             << "| Input channels:" << numInputChannels;
+
+    m_bCallbackThreadInitialized = false;
+    m_framesSinceAudioLatencyUsageUpdate = 0;
+    m_timeInAudioCallback = mixxx::Duration::fromSeconds(0);
+    m_clkRefTimer.start();
+    m_active.store(true, std::memory_order_release);
+    if (jack_activate(pClient) != 0) {
+        m_lastError = QStringLiteral("Failed to activate the JACK client");
+        close();
+        return SoundDeviceStatus::Error;
+    }
+
+    // Like PortAudio, connect the ports to the hardware in order. The user
+    // may reroute them with any JACK patchbay.
+    connectPhysicalPorts(m_outputPorts, JackPortIsInput);
+    connectPhysicalPorts(m_inputPorts, JackPortIsOutput);
+    updateOutputLatency();
+    publishOutputLatency(bufferSize);
+    ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("samplerate")), m_sampleRate);
+    return SoundDeviceStatus::Ok;
+}
+
+void SoundDeviceJack::publishOutputLatency(jack_nframes_t bufferSize) {
+    const double latencyMSec = (bufferSize + m_outputLatencyFrames.load()) /
+            m_sampleRate.toDouble() * 1000;
+    qDebug() << "JACK output latency:" << latencyMSec << "ms";
+
+    // Update the latency ControlObject, which allows the waveform view to
+    // properly correct for the latency.
+    ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("output_latency_ms")), latencyMSec);
+}
+
+bool SoundDeviceJack::changeFramesPerBuffer(unsigned int framesPerBuffer) {
+    jack_client_t* pClient = m_pClient.load(std::memory_order_relaxed);
+    if (!pClient) {
+        return false;
+    }
+    if (jack_get_buffer_size(pClient) == framesPerBuffer) {
+        return true;
+    }
+    // Changes the period of the whole graph. The server calls
+    // callbackBufferSize() between two cycles, the next process callback
+    // already runs with the new size, so the audio is not interrupted.
+    const int result = jack_set_buffer_size(pClient, framesPerBuffer);
+    if (result != 0) {
+        qWarning() << "The JACK server refused the buffer size" << framesPerBuffer
+                   << "error" << result;
+        return false;
+    }
+    qDebug() << "Changed the JACK frames per period to" << framesPerBuffer;
+    m_configFramesPerBuffer = framesPerBuffer;
+    updateOutputLatency();
+    publishOutputLatency(framesPerBuffer);
+    return true;
+}
+
+std::optional<unsigned int> SoundDeviceJack::getServerFramesPerBuffer() const {
+    jack_client_t* pClient = m_pClient.load(std::memory_order_relaxed);
+    if (!pClient) {
+        return std::nullopt;
+    }
+    return jack_get_buffer_size(pClient);
+}
+
+bool SoundDeviceJack::registerPorts(QVector<jack_port_t*>* pPorts,
+        int count,
+        const char* pNameFormat,
+        unsigned long flags) {
+    jack_client_t* pClient = m_pClient.load(std::memory_order_relaxed);
+    pPorts->clear();
+    for (int i = 0; i < count; ++i) {
+        const QByteArray name = QString::fromLatin1(pNameFormat).arg(i + 1).toLatin1();
+        jack_port_t* pPort = jack_port_register(
+                pClient, name.constData(), JACK_DEFAULT_AUDIO_TYPE, flags, 0);
+        if (!pPort) {
+            m_lastError = QStringLiteral("Failed to register the JACK port %1")
+                                  .arg(QString::fromLatin1(name));
+            return false;
+        }
+        pPorts->append(pPort);
+    }
+    return true;
+}
+
+void SoundDeviceJack::connectPhysicalPorts(
+        const QVector<jack_port_t*>& ports, unsigned long flags) {
+    jack_client_t* pClient = m_pClient.load(std::memory_order_relaxed);
+    const char** ppPhysicalPorts = jack_get_ports(
+            pClient, nullptr, JACK_DEFAULT_AUDIO_TYPE, JackPortIsPhysical | flags);
+    if (!ppPhysicalPorts) {
+        return;
+    }
+    for (int i = 0; i < ports.size() && ppPhysicalPorts[i]; ++i) {
+        const char* pPortName = jack_port_name(ports[i]);
+        const int result = (flags & JackPortIsInput)
+                ? jack_connect(pClient, pPortName, ppPhysicalPorts[i])
+                : jack_connect(pClient, ppPhysicalPorts[i], pPortName);
+        if (result != 0 && result != EEXIST) {
+            qWarning() << "Failed to connect" << pPortName << "to" << ppPhysicalPorts[i];
+        }
+    }
+    jack_free(ppPhysicalPorts);
+}
+
+void SoundDeviceJack::updateOutputLatency() {
+    jack_nframes_t latencyFrames = 0;
+    for (jack_port_t* pPort : std::as_const(m_outputPorts)) {
+        jack_latency_range_t range;
+        jack_port_get_latency_range(pPort, JackPlaybackLatency, &range);
+        latencyFrames = math_max(latencyFrames, range.max);
+    }
+    m_outputLatencyFrames.store(latencyFrames, std::memory_order_relaxed);
+}
+
+bool SoundDeviceJack::isOpen() const {
+    return m_pClient.load() != nullptr;
+}
+
+SoundDeviceStatus SoundDeviceJack::close() {
+    jack_client_t* pClient = m_pClient.exchange(nullptr);
+    if (!pClient) {
+        return SoundDeviceStatus::Ok;
+    }
+    qDebug() << "SoundDeviceJack::close()" << m_deviceId;
+    // Returns after the current process callback has finished
+    m_active.store(false, std::memory_order_release);
+    jack_deactivate(pClient);
+    if (jack_client_close(pClient) != 0) {
+        qWarning() << "Failed to close the JACK client";
+    }
+    m_outputPorts.clear();
+    m_unusedOutputPorts.clear();
+    m_inputPorts.clear();
+    return SoundDeviceStatus::Ok;
+}
+
+void SoundDeviceJack::readProcess(SINT framesPerBuffer) {
+    // The inputs are read in callbackProcess(), the device cannot be opened
+    // as a follower of another clock reference.
+    Q_UNUSED(framesPerBuffer);
+}
+
+void SoundDeviceJack::writeProcess(SINT framesPerBuffer) {
+    // The outputs are written in callbackProcess()
+    Q_UNUSED(framesPerBuffer);
+}
+
+QString SoundDeviceJack::getError() const {
+    return m_lastError;
+}
+
+int SoundDeviceJack::callbackProcess(jack_nframes_t frames) {
+    // This must be the very first call for accurate timing
+    updateCallbackEntryToDacTime(frames);
+
+    const bool active = m_active.load(std::memory_order_acquire);
+    if (!active || frames > kMaxEngineFrames) {
+        if (active) {
+            m_pSoundManager->underflowHappened(27);
+        }
+        for (jack_port_t* pPort : std::as_const(m_outputPorts)) {
+            SampleUtil::clear(static_cast<CSAMPLE*>(jack_port_get_buffer(pPort, frames)),
+                    frames);
+        }
+        return 0;
+    }
+
+    if (!m_bCallbackThreadInitialized) {
+        initializeCallbackThread();
+        m_bCallbackThreadInitialized = true;
+    }
+
+    const auto framesPerBuffer = static_cast<SINT>(frames);
+    m_pSoundManager->processUnderflowHappened(framesPerBuffer);
+
+    // Note: Input is processed first so that any ControlObject changes made
+    // in response to input are processed as soon as possible.
+    if (!m_inputPorts.isEmpty()) {
+        // Interleave the mono port buffers into the stereo input buffers
+        for (const auto& in : std::as_const(m_audioInputs)) {
+            const ChannelGroup channelGroup = in.getChannelGroup();
+            const int channelBase = channelGroup.getChannelBase();
+            const auto* pLeft = static_cast<const CSAMPLE*>(
+                    jack_port_get_buffer(m_inputPorts[channelBase], frames));
+            const auto* pRight = channelGroup.getChannelCount() > 1
+                    ? static_cast<const CSAMPLE*>(jack_port_get_buffer(
+                              m_inputPorts[channelBase + 1], frames))
+                    : pLeft;
+            CSAMPLE* pInputBuffer = in.getBuffer(); // Always stereo
+            for (SINT i = 0; i < framesPerBuffer; ++i) {
+                pInputBuffer[i * 2] = pLeft[i];
+                pInputBuffer[i * 2 + 1] = pRight[i];
+            }
+        }
+        LatencyMeasurement* pInputMeasurement =
+                m_pInputLatencyMeasurement.load(std::memory_order_acquire);
+        if (pInputMeasurement && !m_audioInputs.isEmpty()) {
+            // Detected on the first input only, because the ports are not
+            // interleaved
+            pInputMeasurement->processInput(m_audioInputs.first().getBuffer(),
+                    framesPerBuffer,
+                    mixxx::audio::ChannelCount::stereo());
+        }
+        m_pSoundManager->pushInputBuffers(m_audioInputs, framesPerBuffer);
+    }
+
+    m_pSoundManager->readProcess(framesPerBuffer);
+
+    m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
+
+    // Write the engine outputs directly to the port buffers of the server
+    LatencyMeasurement* pOutputMeasurement =
+            m_pOutputLatencyMeasurement.load(std::memory_order_acquire);
+    for (jack_port_t* pPort : std::as_const(m_unusedOutputPorts)) {
+        SampleUtil::clear(static_cast<CSAMPLE*>(jack_port_get_buffer(pPort, frames)),
+                framesPerBuffer);
+    }
+    for (const auto& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup channelGroup = out.getChannelGroup();
+        const int channelCount = channelGroup.getChannelCount();
+        const int channelBase = channelGroup.getChannelBase();
+        const CSAMPLE* pAudioOutputBuffer = out.getBuffer();
+        if (channelCount == 1) {
+            // All AudioOutputs are stereo, mix them down for a mono output
+            auto* pPortBuffer = static_cast<CSAMPLE*>(
+                    jack_port_get_buffer(m_outputPorts[channelBase], frames));
+            for (SINT i = 0; i < framesPerBuffer; ++i) {
+                pPortBuffer[i] = SampleUtil::clampSample(
+                        (pAudioOutputBuffer[i * 2] + pAudioOutputBuffer[i * 2 + 1]) / 2.0f);
+            }
+            if (pOutputMeasurement) {
+                pOutputMeasurement->addImpulse(pPortBuffer, framesPerBuffer, 1);
+            }
+            continue;
+        }
+        for (int channel = 0; channel < channelCount; ++channel) {
+            auto* pPortBuffer = static_cast<CSAMPLE*>(
+                    jack_port_get_buffer(m_outputPorts[channelBase + channel], frames));
+            for (SINT i = 0; i < framesPerBuffer; ++i) {
+                pPortBuffer[i] = SampleUtil::clampSample(
+                        pAudioOutputBuffer[i * channelCount + channel]);
+            }
+            if (pOutputMeasurement) {
+                pOutputMeasurement->addImpulse(pPortBuffer, framesPerBuffer, 1);
+            }
+        }
+    }
+    if (pOutputMeasurement) {
+        pOutputMeasurement->advanceOutput(framesPerBuffer);
+    }
+
+    m_pSoundManager->writeProcess(framesPerBuffer);
+
+    updateAudioLatencyUsage(frames);
+    return 0;
+}
+
+int SoundDeviceJack::callbackBufferSize(jack_nframes_t frames) {
+    // The engine follows the buffer size with the next callback
+    qDebug() << "JACK frames per period changed to" << frames;
+    updateOutputLatency();
+    return 0;
+}
+
+void SoundDeviceJack::callbackLatency() {
+    updateOutputLatency();
+}
+
+int SoundDeviceJack::callbackXrun() {
+    m_pSoundManager->underflowHappened(26);
+    return 0;
+}
+
+void SoundDeviceJack::callbackShutdown() {
+    // The server has gone and the client must not be used anymore, but it
+    // still needs to be closed to free it.
+    qWarning() << "The JACK server has been shut down";
+    m_active.store(false, std::memory_order_release);
+}
+
+void SoundDeviceJack::initializeCallbackThread() {
+#ifdef __LINUX__
+    // JACK creates the thread with the real-time policy if the server runs
+    // with it, verify if it worked.
+    if ((sched_getscheduler(0) & SCHED_FIFO) == 0) {
+        qWarning() << "JACK thread not scheduled with the real-time policy SCHED_FIFO";
+    }
+#else
+    QThread::currentThread()->setPriority(QThread::TimeCriticalPriority);
+#endif
+    mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::Engine);
+    mixxx::tracing::registerCallbackThread(QStringLiteral("Engine"));
+
+    // This disables the denormals calculations, to avoid a
+    // performance penalty of ~20
+    // https://github.com/mixxxdj/mixxx/issues/7747
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+#if defined(__aarch64__)
+    // Bit 24 of the Floating-point Control Register flushes denormals to 0
+    int64_t savedFPCR;
+    asm volatile("mrs %[savedFPCR], FPCR"
+                 : [ savedFPCR ] "=r"(savedFPCR));
+    asm volatile("msr FPCR, %[src]"
+                 :
+                 : [ src ] "r"(savedFPCR | (1 << 24)));
+#endif
+
+    volatile double doubleMin = DBL_MIN; // the smallest normalized double
+    VERIFY_OR_DEBUG_ASSERT(doubleMin / 2 == 0.0) {
+        qWarning() << "Denormals to zero mode is not working. EQs and effects may suffer high CPU load";
+    }
+}
+
+void SoundDeviceJack::updateCallbackEntryToDacTime(jack_nframes_t frames) {
+    m_clkRefTimer.restart();
+    jack_client_t* pClient = m_pClient.load(std::memory_order_relaxed);
+    if (!pClient) {
+        return;
+    }
+    // The buffer of this cycle is played when the next cycle starts, plus
+    // the playback latency of the ports. Unlike the time info of PortAudio
+    // this is exact, because the server tracks the DAC clock.
+    jack_nframes_t currentFrames;
+    jack_time_t currentUsecs;
+    jack_time_t nextUsecs;
+    float periodUsecs;
+    double callbackEntryToDacSecs;
+    if (jack_get_cycle_times(pClient, &currentFrames, &currentUsecs, &nextUsecs, &periodUsecs) ==
+            0) {
+        const jack_time_t nowUsecs = jack_get_time();
+        const double untilNextCycleSecs =
+                nextUsecs > nowUsecs ? (nextUsecs - nowUsecs) / 1000000.0 : 0.0;
+        callbackEntryToDacSecs = untilNextCycleSecs +
+                m_outputLatencyFrames.load(std::memory_order_relaxed) /
+                        m_sampleRate.toDouble();
+    } else {
+        callbackEntryToDacSecs = frames / m_sampleRate.toDouble();
+    }
+    VisualPlayPosition::setCallbackEntryToDacSecs(callbackEntryToDacSecs, m_clkRefTimer);
+}
+
+void SoundDeviceJack::updateAudioLatencyUsage(jack_nframes_t frames) {
+    m_framesSinceAudioLatencyUsageUpdate += frames;
+    if (m_framesSinceAudioLatencyUsageUpdate > (m_sampleRate.toDouble() / kCpuUsageUpdateRate)) {
+        double secInAudioCb = m_timeInAudioCallback.toDoubleSeconds();
+        m_audioLatencyUsage.set(
+                secInAudioCb / (m_framesSinceAudioLatencyUsageUpdate / m_sampleRate.toDouble()));
+        m_timeInAudioCallback = mixxx::Duration::fromSeconds(0);
+        m_framesSinceAudioLatencyUsageUpdate = 0;
+    }
+    // measure time in Audio callback at the very last
+    m_timeInAudioCallback += m_clkRefTimer.elapsed();
+}
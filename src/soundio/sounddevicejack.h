@@ -0,0 +1,85 @@
+#pragma once
+
+#include <jack/jack.h>
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+#include "control/pollingcontrolproxy.h"
+#include "soundio/sounddevice.h"
+#include "util/duration.h"
+#include "util/performancetimer.h"
+
+class SoundManager;
+
+/// A JACK client that runs the engine directly in the process callback of
+/// the JACK server, bypassing PortAudio and its ring buffers. PipeWire
+/// provides the same API through pipewire-jack, so this is also the native
+/// backend for PipeWire.
+///
+/// The server owns the clock, the sample rate and the buffer size, so the
+/// device can only be opened as clock reference. Additional sound cards are
+/// connected within JACK.
+class SoundDeviceJack : public SoundDevice {
+  public:
+    SoundDeviceJack(UserSettingsPointer config,
+            SoundManager* sm,
+            mixxx::audio::SampleRate serverSampleRate,
+            mixxx::audio::ChannelCount numOutputChannels,
+            mixxx::audio::ChannelCount numInputChannels);
+    ~SoundDeviceJack() override;
+
+    /// Returns the device of a running JACK server or nullptr. The server is
+    /// not started if it does not run.
+    static SoundDevicePointer query(UserSettingsPointer config, SoundManager* sm);
+
+    SoundDeviceStatus open(bool isClkRefDevice, int syncBuffers) override;
+    bool isOpen() const override;
+    SoundDeviceStatus close() override;
+    void readProcess(SINT framesPerBuffer) override;
+    void writeProcess(SINT framesPerBuffer) override;
+    QString getError() const override;
+
+    mixxx::audio::SampleRate getDefaultSampleRate() const override {
+        return m_serverSampleRate;
+    }
+    bool changeFramesPerBuffer(unsigned int framesPerBuffer) override;
+    std::optional<unsigned int> getServerFramesPerBuffer() const override;
+
+    // Called by the JACK server in its real-time thread
+    int callbackProcess(jack_nframes_t frames);
+    int callbackBufferSize(jack_nframes_t frames);
+    void callbackLatency();
+    int callbackXrun();
+    void callbackShutdown();
+
+  private:
+    bool registerPorts(QVector<jack_port_t*>* pPorts,
+            int count,
+            const char* pNameFormat,
+            unsigned long flags);
+    void connectPhysicalPorts(const QVector<jack_port_t*>& ports, unsigned long flags);
+    void updateOutputLatency();
+    void publishOutputLatency(jack_nframes_t bufferSize);
+    void initializeCallbackThread();
+    void updateCallbackEntryToDacTime(jack_nframes_t frames);
+    void updateAudioLatencyUsage(jack_nframes_t frames);
+
+    const mixxx::audio::SampleRate m_serverSampleRate;
+    std::atomic<jack_client_t*> m_pClient;
+    QVector<jack_port_t*> m_outputPorts;
+    QVector<jack_port_t*> m_unusedOutputPorts;
+    QVector<jack_port_t*> m_inputPorts;
+    // The playback latency of the output ports in frames, after the
+    // buffer that is processed
+    std::atomic<jack_nframes_t> m_outputLatencyFrames;
+    std::atomic<bool> m_active;
+    bool m_bCallbackThreadInitialized;
+
+    QString m_lastError;
+    PollingControlProxy m_audioLatencyUsage;
+    mixxx::Duration m_timeInAudioCallback;
+    int m_framesSinceAudioLatencyUsageUpdate;
+    PerformanceTimer m_clkRefTimer;
+};
@@ -113,12 +113,13 @@ bool SoundDeviceNetwork::isOpen() const {
 
 SoundDeviceStatus SoundDeviceNetwork::close() {
     //kLogger.debug() << "close:" << getInternalName();
-    m_pNetworkStream->stopStream();
+    // Stop writing to the workers before they are stopped
     if (m_pThread) {
         m_pThread->stop();
         m_pThread->wait();
         m_pThread.reset();
     }
+    m_pNetworkStream->stopStream();
 
     m_outputFifo.reset();
     m_inputFifo.reset();
@@ -356,8 +357,9 @@ void SoundDeviceNetwork::workerWriteProcess(NetworkOutputStreamWorkerPtr pWorker
             // interval = copyCount
             // Check for desired kNetworkLatencyFrames + 1/2 interval to
             // avoid big jitter due to interferences with sync code
-            if (pFifo->readAvailable() + copyCount / 2 >=
-                    (m_numOutputChannels * kNetworkLatencyFrames)) {
+            if (pWorker->lowLatency() ||
+                    pFifo->readAvailable() + copyCount / 2 >=
+                            (m_numOutputChannels * kNetworkLatencyFrames)) {
                 pWorker->outputAvailable();
             }
         }
@@ -5,6 +5,7 @@
 #include <QRegularExpression>
 #include <QThread>
 #include <QtDebug>
+#include <limits>
 
 #include "control/controlobject.h"
 #include "sounddevicenetwork.h"
@@ -15,9 +16,12 @@
 #include "util/denormalsarezero.h"
 #include "util/fifo.h"
 #include "util/math.h"
+#include "util/realtime.h"
 #include "util/sample.h"
+#include "util/time.h"
 #include "util/timer.h"
 #include "util/trace.h"
+#include "util/tracing.h"
 #include "waveform/visualplayposition.h"
 
 #ifdef PA_USE_ALSA
@@ -91,6 +95,9 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
           m_inputFifo(nullptr),
           m_outputDrift(false),
           m_inputDrift(false),
+          m_outputFifoWriteNanos(0),
+          m_inputFifoReadNanos(0),
+          m_clockDriftPpm(std::numeric_limits<double>::quiet_NaN()),
           m_bSetThreadPriority(false),
           m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
           m_framesSinceAudioLatencyUsageUpdate(0),
@@ -253,6 +260,9 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
     m_lastCallbackEntrytoDacSecs = bufferMSec / 1000.0;
 
     m_syncBuffers = syncBuffers;
+    m_pOutputResampler.reset();
+    m_pInputResampler.reset();
+    m_clockDriftPpm.store(std::numeric_limits<double>::quiet_NaN());
 
     // Create the callback function pointer.
     PaStreamCallback* pCallback = nullptr;
@@ -296,8 +306,16 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
             SampleUtil::clear(dataPtr1, size1);
             SampleUtil::clear(dataPtr2, size2);
             m_outputFifo->releaseWriteRegions(writeCount);
+            m_pOutputResampler = std::make_unique<AsyncResampler>(
+                    mixxx::audio::ChannelCount(m_outputParams.channelCount),
+                    kMaxEngineFrames);
+            m_outputDriftController.reset();
         }
         if (m_inputParams.channelCount > 0) {
+            m_pInputResampler = std::make_unique<AsyncResampler>(
+                    mixxx::audio::ChannelCount(m_inputParams.channelCount),
+                    kMaxEngineFrames);
+            m_inputDriftController.reset();
             m_inputFifo = std::make_unique<FIFO<CSAMPLE>>(
                     m_inputParams.channelCount * framesPerBuffer * kFifoSize);
             // Clear first 1.5 chunks (see above)
@@ -495,6 +513,9 @@ SoundDeviceStatus SoundDevicePortAudio::close() {
 
     m_outputFifo.reset();
     m_inputFifo.reset();
+    m_pOutputResampler.reset();
+    m_pInputResampler.reset();
+    m_clockDriftPpm.store(std::numeric_limits<double>::quiet_NaN());
     m_bSetThreadPriority = false;
 
     return SoundDeviceStatus::Ok;
@@ -628,6 +649,8 @@ void SoundDevicePortAudio::readProcess(SINT framesPerBuffer) {
                         m_inputParams.channelCount);
             }
             m_inputFifo->releaseReadRegions(readCount);
+            m_inputFifoReadNanos.store(mixxx::Time::elapsed().toIntegerNanos(),
+                    std::memory_order_release);
         }
         if (readCount < inChunkSize) {
             // Fill remaining buffers with zeros
@@ -670,6 +693,8 @@ void SoundDevicePortAudio::writeProcess(SINT framesPerBuffer) {
                         m_outputParams.channelCount);
             }
             m_outputFifo->releaseWriteRegions(writeCount);
+            m_outputFifoWriteNanos.store(mixxx::Time::elapsed().toIntegerNanos(),
+                    std::memory_order_release);
         }
 
         if (m_syncBuffers == 0) { // "Experimental (no delay)"
@@ -762,122 +787,131 @@ int SoundDevicePortAudio::callbackProcessDrift(
     //
     // There is a delay of up to one latency between composing a chunk in the Clock
     // Reference callback and write it to the device. So we need at lest one buffer.
-    // Unfortunately this delay is somehow random, an WILL produce a delay slow
-    // shift without we can avoid it. (That's the price for using a cheap USB soundcard).
+    // Unfortunately this delay is somehow random.
     //
     // Additional we need an filled chunk and an empty chunk. These are used when on
-    // sound card overtakes the other. This always happens, if they are driven form
-    // two crystals. In a test case every 30 s @ 23 ms. After they are consumed,
-    // the drift correction takes place and fills or clears the reserve buffers.
-    // If this is finished before another overtake happens, we do not face any
-    // dropouts or clicks.
-    // So that's why we need a Fifo of 3 chunks.
+    // sound card overtakes the other, and for the jitter effect, when one callback
+    // is delayed and the other fires two times to catch up. That's why we need a
+    // Fifo of 3 chunks.
     //
-    // In addition there is a jitter effect. It happens that one callback is delayed,
-    // in this case the second one fires two times and then the first one fires two
-    // time as well to catch up. This is also fixed by the additional buffers. If this
-    // happens just after an regular overtake, we will have clicks again.
-    //
-    // I the tests it turns out that it only happens in the opposite direction, so
-    // 3 chunks are just fine.
+    // The drift itself is compensated by resampling the chunks with the ratio of
+    // both clocks. The ratio is controlled by the fill level of the FIFOs, which
+    // is interpolated with the time of the last transfer of the clock reference
+    // device. Otherwise the level would jump by a chunk, whenever one callback
+    // overtakes the other.
 
     if (m_inputParams.channelCount) {
-        int inChunkSize = framesPerBuffer * m_inputParams.channelCount;
-        int readAvailable = m_inputFifo->readAvailable();
-        int writeAvailable = m_inputFifo->writeAvailable();
-        if (readAvailable < inChunkSize * kDriftReserve) {
-            // risk of an underflow, duplicate one frame
-            m_inputFifo->write(in, inChunkSize);
-            if (m_inputDrift) {
-                // Do not compensate the first delay, because it is likely a jitter
-                // corrected in the next cycle
-                // Duplicate one frame
-                m_inputFifo->write(
-                        &in[inChunkSize - m_inputParams.channelCount],
-                        m_inputParams.channelCount);
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Skip";
-            } else {
-                m_inputDrift = true;
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Jitter Skip";
-            }
-        } else if (readAvailable == inChunkSize * kDriftReserve) {
-            // Everything Ok
-            m_inputFifo->write(in, inChunkSize);
-            m_inputDrift = false;
-            //qDebug() << "callbackProcess write:" << (float) readAvailable / inChunkSize << "Normal";
-        } else if (writeAvailable >= inChunkSize) {
-            // Risk of overflow, skip one frame
-            if (m_inputDrift) {
-                m_inputFifo->write(in, inChunkSize - m_inputParams.channelCount);
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Skip";
-            } else {
-                m_inputFifo->write(in, inChunkSize);
-                m_inputDrift = true;
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Jitter Skip";
+        const int channelCount = m_inputParams.channelCount;
+        const double level = interpolatedFifoLevel(m_inputFifoReadNanos,
+                m_inputFifo->readAvailable() / channelCount,
+                framesPerBuffer,
+                false);
+        // Resample the device frames into engine frames
+        m_pInputResampler->setRatio(
+                m_inputDriftController.update(level, framesPerBuffer));
+        m_pInputResampler->write(in, framesPerBuffer);
+        const SINT framesAvailable = m_pInputResampler->framesAvailable();
+        const SINT writeAvailable = m_inputFifo->writeAvailable() / channelCount;
+        if (framesAvailable <= writeAvailable) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+            (void)m_inputFifo->aquireWriteRegions(framesAvailable * channelCount,
+                    &dataPtr1,
+                    &size1,
+                    &dataPtr2,
+                    &size2);
+            m_pInputResampler->read(dataPtr1, size1 / channelCount);
+            if (size2 > 0) {
+                m_pInputResampler->read(dataPtr2, size2 / channelCount);
             }
-        } else if (writeAvailable) {
+            m_inputFifo->releaseWriteRegions(framesAvailable * channelCount);
+        } else {
             // Fifo Overflow
-            m_inputFifo->write(in, writeAvailable);
+            m_pInputResampler->reset();
             m_pSoundManager->underflowHappened(8);
-            //qDebug() << "callbackProcessDrift write:" << (float) readAvailable / inChunkSize << "Overflow";
-        } else {
-            // Buffer full
-            m_pSoundManager->underflowHappened(9);
-            //qDebug() << "callbackProcessDrift write:" << (float) readAvailable / inChunkSize << "Buffer full";
+            //qDebug() << "callbackProcessDrift write:" << level / framesPerBuffer << "Overflow";
         }
     }
 
     if (m_outputParams.channelCount > 0) {
-        int outChunkSize = framesPerBuffer * m_outputParams.channelCount;
-        int readAvailable = m_outputFifo->readAvailable();
-
-        if (readAvailable > outChunkSize * (kDriftReserve + 1)) {
-            m_outputFifo->read(out, outChunkSize);
-            if (m_outputDrift) {
-                // Risk of overflow, skip one frame
-                m_outputFifo->releaseReadRegions(m_outputParams.channelCount);
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Skip";
-            } else {
-                m_outputDrift = true;
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Jitter Skip";
-            }
-        } else if (readAvailable == outChunkSize * (kDriftReserve + 1)) {
-            m_outputFifo->read(out, outChunkSize);
-            m_outputDrift = false;
-            //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Normal";
-        } else if (readAvailable >= outChunkSize) {
-            if (m_outputDrift) {
-                // Risk of underflow, duplicate one frame
-                m_outputFifo->read(out,
-                        outChunkSize - m_outputParams.channelCount);
-                SampleUtil::copy(
-                        &out[outChunkSize - m_outputParams.channelCount],
-                        &out[outChunkSize - (2 * m_outputParams.channelCount)],
-                        m_outputParams.channelCount);
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Save";
-            } else {
-                m_outputFifo->read(out, outChunkSize);
-                m_outputDrift = true;
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Jitter Save";
+        const int channelCount = m_outputParams.channelCount;
+        const int readAvailable = m_outputFifo->readAvailable() / channelCount;
+        const double level = interpolatedFifoLevel(m_outputFifoWriteNanos,
+                readAvailable,
+                framesPerBuffer,
+                true);
+        // Resample the engine frames into device frames
+        m_pOutputResampler->setRatio(
+                m_outputDriftController.update(level, framesPerBuffer));
+        const SINT readCount = math_min<SINT>(
+                m_pOutputResampler->framesRequired(framesPerBuffer), readAvailable);
+        if (readCount > 0) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+            (void)m_outputFifo->aquireReadRegions(readCount * channelCount,
+                    &dataPtr1,
+                    &size1,
+                    &dataPtr2,
+                    &size2);
+            m_pOutputResampler->write(dataPtr1, size1 / channelCount);
+            if (size2 > 0) {
+                m_pOutputResampler->write(dataPtr2, size2 / channelCount);
             }
-        } else if (readAvailable) {
-            m_outputFifo->read(out,
-                    readAvailable);
-            // underflow
-            SampleUtil::clear(&out[readAvailable],
-                    outChunkSize - readAvailable);
-            m_pSoundManager->underflowHappened(10);
-            //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Underflow";
-        } else {
+            m_outputFifo->releaseReadRegions(readCount * channelCount);
+        }
+        const SINT framesAvailable = math_min<SINT>(
+                m_pOutputResampler->framesAvailable(), framesPerBuffer);
+        m_pOutputResampler->read(out, framesAvailable);
+        if (framesAvailable < framesPerBuffer) {
             // underflow
-            SampleUtil::clear(out, outChunkSize);
-            m_pSoundManager->underflowHappened(11);
-            //qDebug() << "callbackProcess read:" << (float)readAvailable / outChunkSize << "Buffer empty";
+            SampleUtil::clear(&out[framesAvailable * channelCount],
+                    (framesPerBuffer - framesAvailable) * channelCount);
+            m_pSoundManager->underflowHappened(framesAvailable > 0 ? 10 : 11);
+            //qDebug() << "callbackProcessDrift read:" << level / framesPerBuffer << "Underflow";
         }
     }
+
+    const DriftController& driftController = m_outputParams.channelCount > 0
+            ? m_outputDriftController
+            : m_inputDriftController;
+    m_clockDriftPpm.store(driftController.isLocked()
+                    ? driftController.driftPpm()
+                    : std::numeric_limits<double>::quiet_NaN(),
+            std::memory_order_relaxed);
     return m_callbackResult.load(std::memory_order_acquire);
 }
 
+double SoundDevicePortAudio::interpolatedFifoLevel(
+        const std::atomic<qint64>& transferNanos,
+        int fifoFrames,
+        int framesPerBuffer,
+        bool isOutput) const {
+    const qint64 elapsedNanos = mixxx::Time::elapsed().toIntegerNanos() -
+            transferNanos.load(std::memory_order_acquire);
+    const double elapsedFrames = math_clamp(m_sampleRate.toDouble() * elapsedNanos /
+                    mixxx::Duration::kNanosPerSecond,
+            0.0,
+            static_cast<double>(framesPerBuffer));
+    // The last output buffer was written ahead of time and the last input
+    // buffer was read ahead of time
+    if (isOutput) {
+        return fifoFrames - framesPerBuffer + elapsedFrames;
+    }
+    return fifoFrames + framesPerBuffer - elapsedFrames;
+}
+
+std::optional<double> SoundDevicePortAudio::getClockDriftPpm() const {
+    const double driftPpm = m_clockDriftPpm.load(std::memory_order_relaxed);
+    if (std::isnan(driftPpm)) {
+        return std::nullopt;
+    }
+    return driftPpm;
+}
+
 int SoundDevicePortAudio::callbackProcess(const SINT framesPerBuffer,
         CSAMPLE *out, const CSAMPLE *in,
         const PaStreamCallbackTimeInfo *timeInfo,
@@ -959,6 +993,8 @@ int SoundDevicePortAudio::callbackProcessClkRef(
         // the SCHED_OTHER policy in which case the call also wouldn't do anything.
         QThread::currentThread()->setPriority(QThread::TimeCriticalPriority);
 #endif
+        mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::Engine);
+        mixxx::tracing::registerCallbackThread(QStringLiteral("Engine"));
         m_bSetThreadPriority = true;
 
         // This disables the denormals calculations, to avoid a
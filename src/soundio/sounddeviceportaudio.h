@@ -3,10 +3,13 @@
 #include <portaudio.h>
 
 #include <QString>
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 
 #include "control/pollingcontrolproxy.h"
+#include "soundio/asyncresampler.h"
+#include "soundio/driftcontroller.h"
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanagerconfig.h"
 #include "util/duration.h"
@@ -57,6 +60,8 @@ class SoundDevicePortAudio : public SoundDevice {
                             : SoundManagerConfig::kMixxxDefaultSampleRate;
     }
 
+    std::optional<double> getClockDriftPpm() const override;
+
   private:
     void updateCallbackEntryToDacTime(
             SINT framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo);
@@ -64,6 +69,13 @@ class SoundDevicePortAudio : public SoundDevice {
 
     void makeStreamInactiveAndWait();
 
+    // The FIFO level in frames, as if the clock reference device transferred
+    // the last buffer continuously instead of at once.
+    double interpolatedFifoLevel(const std::atomic<qint64>& transferNanos,
+            int fifoFrames,
+            int framesPerBuffer,
+            bool isOutput) const;
+
     // PortAudio stream for this device.
     std::atomic<PaStream*> m_pStream;
     // Struct containing information about this device. Don't free() it, it
@@ -78,6 +90,18 @@ class SoundDevicePortAudio : public SoundDevice {
     std::unique_ptr<FIFO<CSAMPLE>> m_inputFifo;
     bool m_outputDrift;
     bool m_inputDrift;
+    // Resample the FIFOs with "Default (long delay)" to compensate the drift
+    // to the clock reference device
+    std::unique_ptr<AsyncResampler> m_pOutputResampler;
+    std::unique_ptr<AsyncResampler> m_pInputResampler;
+    DriftController m_outputDriftController;
+    DriftController m_inputDriftController;
+    // When the clock reference device wrote the last output buffer or read
+    // the last input buffer
+    std::atomic<qint64> m_outputFifoWriteNanos;
+    std::atomic<qint64> m_inputFifoReadNanos;
+    // NaN until the drift controller is locked
+    std::atomic<double> m_clockDriftPpm;
 
     // A string describing the last PortAudio error to occur.
     QString m_lastError;
@@ -10,6 +10,7 @@
 #include "control/controlobject.h"
 #include "engine/enginemixer.h"
 #include "engine/sidechain/enginenetworkstream.h"
+#include "engine/sidechain/rtpoutputstreamworker.h"
 #include "moc_soundmanager.cpp"
 #include "soundio/sounddevice.h"
 #include "soundio/sounddevicenetwork.h"
@@ -27,11 +28,22 @@
 #include "soundio/soundmanagerios.h"
 #endif
 
+#ifdef __JACK__
+#include "soundio/sounddevicejack.h"
+#endif
+
 typedef PaError (*SetJackClientName)(const char *name);
 
 namespace {
 
 const QString kAppGroup = QStringLiteral("[App]");
+const QString kMasterGroup = QStringLiteral("[Master]");
+const QString kLatencyMeasurementGroup = QStringLiteral("[LatencyMeasurement]");
+
+constexpr int kLatencyMeasurementPollIntervalMillis = 100;
+// The engine has not picked up the measurement within this time if the
+// devices are stalled
+constexpr int kLatencyMeasurementMaxPendingPolls = 20;
 
 #define CPU_OVERLOAD_DURATION 500 // in ms
 
@@ -56,7 +68,10 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
           m_underflowHappened(0),
           m_underflowUpdateCount(0),
           m_audioLatencyOverloadCount(kAppGroup, QStringLiteral("audio_latency_overload_count")),
-          m_audioLatencyOverload(kAppGroup, QStringLiteral("audio_latency_overload")) {
+          m_audioLatencyOverload(kAppGroup, QStringLiteral("audio_latency_overload")),
+          m_latencyMeasurementPendingPolls(0),
+          m_microphoneLatencyCompensation(
+                  kMasterGroup, QStringLiteral("microphoneLatencyCompensation")) {
     // TODO(xxx) some of these ControlObject are not needed by soundmanager, or are unused here.
     // It is possible to take them out?
     m_pControlObjectSoundStatusCO = new ControlObject(
@@ -71,8 +86,18 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
     m_samplerates.push_back(mixxx::audio::SampleRate(48000));
     m_samplerates.push_back(mixxx::audio::SampleRate(96000));
 
+    m_latencyMeasurementTimer.setInterval(kLatencyMeasurementPollIntervalMillis);
+    connect(&m_latencyMeasurementTimer,
+            &QTimer::timeout,
+            this,
+            &SoundManager::slotPollLatencyMeasurement);
+
     m_pNetworkStream = QSharedPointer<EngineNetworkStream>(
             new EngineNetworkStream(2, 0));
+    if (RtpOutputStreamWorker::isEnabled(m_pConfig)) {
+        m_pNetworkStream->addOutputWorker(
+                NetworkOutputStreamWorkerPtr(new RtpOutputStreamWorker(m_pConfig)));
+    }
 
     queryDevices();
 
@@ -142,12 +167,23 @@ QList<QString> SoundManager::getHostAPIList() const {
         }
     }
 
+#ifdef __JACK__
+    for (const auto& pDevice : m_devices) {
+        if (pDevice->getHostAPI() == MIXXX_JACK_NATIVE_STRING) {
+            apiList.push_back(MIXXX_JACK_NATIVE_STRING);
+            break;
+        }
+    }
+#endif
+
     return apiList;
 }
 
 void SoundManager::closeDevices(bool sleepAfterClosing) {
     //qDebug() << "SoundManager::closeDevices()";
 
+    cancelLatencyMeasurement();
+
     bool closed = false;
     for (const auto& pDevice : std::as_const(m_devices)) {
         if (pDevice->isOpen()) {
@@ -218,7 +254,7 @@ void SoundManager::clearDeviceList(bool sleepAfterClosing) {
 }
 
 QList<mixxx::audio::SampleRate> SoundManager::getSampleRates(const QString& api) const {
-    if (api == MIXXX_PORTAUDIO_JACK_STRING) {
+    if (api == MIXXX_PORTAUDIO_JACK_STRING || api == MIXXX_JACK_NATIVE_STRING) {
         // queryDevices must have been called for this to work, but the
         // ctor calls it -bkgood
         QList<mixxx::audio::SampleRate> samplerates;
@@ -237,6 +273,9 @@ QList<mixxx::audio::SampleRate> SoundManager::getSampleRates() const {
 void SoundManager::queryDevices() {
     //qDebug() << "SoundManager::queryDevices()";
     queryDevicesPortaudio();
+#ifdef __JACK__
+    queryDevicesJack();
+#endif
     queryDevicesMixxx();
 
     // now tell the prefs that we updated the device list -- bkgood
@@ -315,6 +354,18 @@ void SoundManager::queryDevicesPortaudio() {
     }
 }
 
+#ifdef __JACK__
+void SoundManager::queryDevicesJack() {
+    auto currentDevice = SoundDeviceJack::query(m_pConfig, this);
+    if (!currentDevice) {
+        return;
+    }
+    m_devices.push_back(currentDevice);
+    // Both JACK APIs are connected to the same server
+    m_jackSampleRate = currentDevice->getDefaultSampleRate();
+}
+#endif
+
 void SoundManager::queryDevicesMixxx() {
     auto currentDevice = SoundDevicePointer(new SoundDeviceNetwork(
             m_pConfig, this, m_pNetworkStream));
@@ -485,6 +536,18 @@ SoundDeviceStatus SoundManager::setupDevices() {
         }
     }
 
+    for (const auto& mode : std::as_const(toOpen)) {
+        // Show the buffer size of a server that decides about it, so it can
+        // be changed from there
+        const auto serverFramesPerBuffer = mode.pDevice->getServerFramesPerBuffer();
+        if (serverFramesPerBuffer &&
+                *serverFramesPerBuffer != m_config.getFramesPerBuffer() &&
+                m_config.setFramesPerBuffer(*serverFramesPerBuffer)) {
+            qDebug() << "Following the buffer size of the server:"
+                     << *serverFramesPerBuffer << "frames";
+        }
+    }
+
     if (pNewMainClockRef) {
         qDebug() << "Using" << pNewMainClockRef->getDisplayName()
                  << "as output sound device clock reference";
@@ -502,6 +565,8 @@ SoundDeviceStatus SoundManager::setupDevices() {
             outputDevicesOpened > 0 ?
                     SOUNDMANAGER_CONNECTED : SOUNDMANAGER_DISCONNECTED);
 
+    applyMeasuredLatency();
+
     // returns OK if we were able to open all the devices the user wanted
     if (devicesNotFound.isEmpty()) {
         emit devicesSetup();
@@ -563,9 +628,19 @@ void SoundManager::closeActiveConfig() {
 
 SoundDeviceStatus SoundManager::setConfig(const SoundManagerConfig& config) {
     SoundDeviceStatus status = SoundDeviceStatus::Ok;
+    const SoundManagerConfig previousConfig = m_config;
     m_config = config;
     checkConfig();
 
+    if (m_config.isEqualExceptAudioBufferSize(previousConfig) &&
+            changeFramesPerBufferOfOpenDevices()) {
+        qDebug() << "Changed the buffer size to" << m_config.getFramesPerBuffer()
+                 << "frames without reopening the sound devices";
+        applyMeasuredLatency();
+        m_config.writeToDisk();
+        return status;
+    }
+
     closeActiveConfig();
 
     status = setupDevices();
@@ -575,6 +650,24 @@ SoundDeviceStatus SoundManager::setConfig(const SoundManagerConfig& config) {
     return status;
 }
 
+bool SoundManager::changeFramesPerBufferOfOpenDevices() {
+    const unsigned int framesPerBuffer = m_config.getFramesPerBuffer();
+    bool anyDeviceOpen = false;
+    for (const auto& pDevice : std::as_const(m_devices)) {
+        if (!pDevice->isOpen()) {
+            continue;
+        }
+        anyDeviceOpen = true;
+        // If a device fails after others have changed, all are reopened
+        // with the new size below
+        if (!pDevice->changeFramesPerBuffer(framesPerBuffer)) {
+            return false;
+        }
+        pDevice->setConfigFramesPerBuffer(framesPerBuffer);
+    }
+    return anyDeviceOpen;
+}
+
 void SoundManager::checkConfig() {
     if (!m_config.checkAPI()) {
         m_config.setAPI(SoundManagerConfig::kDefaultAPI);
@@ -709,3 +802,166 @@ void SoundManager::processUnderflowHappened(SINT framesPerBuffer) {
         --m_underflowUpdateCount;
     }
 }
+
+SoundDevicePointer SoundManager::latencyMeasurementInputDevice() const {
+    // The microphone that is compensated, or an auxiliary input
+    SoundDevicePointer pAuxiliaryDevice;
+    for (const auto& pDevice : std::as_const(m_devices)) {
+        if (!pDevice->isOpen() || pDevice->getDeviceId().name == kNetworkDeviceInternalName) {
+            continue;
+        }
+        for (const auto& in : pDevice->inputs()) {
+            if (in.getType() == AudioPathType::Microphone) {
+                return pDevice;
+            }
+            if (in.getType() == AudioPathType::Auxiliary && !pAuxiliaryDevice) {
+                pAuxiliaryDevice = pDevice;
+            }
+        }
+    }
+    return pAuxiliaryDevice;
+}
+
+SoundDevicePointer SoundManager::latencyMeasurementOutputDevice() const {
+    // The main output the microphone is heard with, or the booth output
+    SoundDevicePointer pBoothDevice;
+    for (const auto& pDevice : std::as_const(m_devices)) {
+        if (!pDevice->isOpen() || pDevice->getDeviceId().name == kNetworkDeviceInternalName) {
+            continue;
+        }
+        for (const auto& out : pDevice->outputs()) {
+            if (out.getType() == AudioPathType::Main) {
+                return pDevice;
+            }
+            if (out.getType() == AudioPathType::Booth && !pBoothDevice) {
+                pBoothDevice = pDevice;
+            }
+        }
+    }
+    return pBoothDevice;
+}
+
+QString SoundManager::latencyMeasurementKey(const SoundDevicePointer& pInputDevice,
+        const SoundDevicePointer& pOutputDevice) const {
+    // The keys of the config file must not contain whitespace
+    QString key = QStringLiteral("%1_%2_%3_%4_%5")
+                          .arg(m_config.getAPI(),
+                                  pOutputDevice->getDeviceId().name,
+                                  pInputDevice->getDeviceId().name,
+                                  QString::number(m_config.getSampleRate().value()),
+                                  QString::number(m_config.getFramesPerBuffer()));
+    for (QChar& c : key) {
+        if (!c.isLetterOrNumber()) {
+            c = QChar('_');
+        }
+    }
+    return key;
+}
+
+bool SoundManager::startLatencyMeasurement() {
+    cancelLatencyMeasurement();
+    m_pLatencyMeasurementInputDevice = latencyMeasurementInputDevice();
+    m_pLatencyMeasurementOutputDevice = latencyMeasurementOutputDevice();
+    if (!m_pLatencyMeasurementInputDevice || !m_pLatencyMeasurementOutputDevice) {
+        m_pLatencyMeasurementInputDevice.clear();
+        m_pLatencyMeasurementOutputDevice.clear();
+        return false;
+    }
+    qInfo() << "Measuring the latency from" << m_pLatencyMeasurementOutputDevice->getDisplayName()
+            << "to" << m_pLatencyMeasurementInputDevice->getDisplayName();
+
+    m_latencyMeasurement.start(m_config.getSampleRate());
+    if (m_pLatencyMeasurementInputDevice == m_pLatencyMeasurementOutputDevice) {
+        m_pLatencyMeasurementInputDevice->setLatencyMeasurement(
+                &m_latencyMeasurement, &m_latencyMeasurement);
+    } else {
+        m_pLatencyMeasurementInputDevice->setLatencyMeasurement(&m_latencyMeasurement, nullptr);
+        m_pLatencyMeasurementOutputDevice->setLatencyMeasurement(nullptr, &m_latencyMeasurement);
+    }
+    m_latencyMeasurementPendingPolls = 0;
+    m_latencyMeasurementTimer.start();
+    return true;
+}
+
+void SoundManager::cancelLatencyMeasurement() {
+    if (!m_latencyMeasurementTimer.isActive()) {
+        return;
+    }
+    m_latencyMeasurement.cancel();
+    finishLatencyMeasurement();
+    emit latencyMeasurementFinished(LatencyMeasurement::State::Idle, 0);
+}
+
+void SoundManager::finishLatencyMeasurement() {
+    m_latencyMeasurementTimer.stop();
+    // The measurement does not touch the buffers anymore, even if the engine
+    // is still processing the devices
+    if (m_pLatencyMeasurementInputDevice) {
+        m_pLatencyMeasurementInputDevice->setLatencyMeasurement(nullptr, nullptr);
+        m_pLatencyMeasurementInputDevice.clear();
+    }
+    if (m_pLatencyMeasurementOutputDevice) {
+        m_pLatencyMeasurementOutputDevice->setLatencyMeasurement(nullptr, nullptr);
+        m_pLatencyMeasurementOutputDevice.clear();
+    }
+}
+
+void SoundManager::slotPollLatencyMeasurement() {
+    const LatencyMeasurement::State state = m_latencyMeasurement.state();
+    if (state == LatencyMeasurement::State::Pending &&
+            ++m_latencyMeasurementPendingPolls > kLatencyMeasurementMaxPendingPolls) {
+        m_latencyMeasurement.cancel();
+        finishLatencyMeasurement();
+        emit latencyMeasurementFinished(LatencyMeasurement::State::NoSignal, 0);
+        return;
+    }
+    if (!m_latencyMeasurement.isFinished()) {
+        return;
+    }
+
+    if (state != LatencyMeasurement::State::Succeeded) {
+        qWarning() << "Latency measurement failed" << static_cast<int>(state);
+        finishLatencyMeasurement();
+        emit latencyMeasurementFinished(state, 0);
+        return;
+    }
+    const SINT roundTripFrames = m_latencyMeasurement.roundTripFrames();
+    const QString key = latencyMeasurementKey(
+            m_pLatencyMeasurementInputDevice, m_pLatencyMeasurementOutputDevice);
+    finishLatencyMeasurement();
+
+    m_pConfig->setValue(ConfigKey(kLatencyMeasurementGroup, key), roundTripFrames);
+    const double roundTripMs = 1000.0 * roundTripFrames / m_config.getSampleRate().toDouble();
+    qInfo() << "Measured a round trip latency of" << roundTripFrames << "frames,"
+            << roundTripMs << "ms";
+    m_microphoneLatencyCompensation.set(roundTripMs);
+    emit latencyMeasurementFinished(state, roundTripMs);
+}
+
+void SoundManager::applyMeasuredLatency() {
+    const SoundDevicePointer pInputDevice = latencyMeasurementInputDevice();
+    const SoundDevicePointer pOutputDevice = latencyMeasurementOutputDevice();
+    if (!pInputDevice || !pOutputDevice) {
+        return;
+    }
+    const ConfigKey key(kLatencyMeasurementGroup,
+            latencyMeasurementKey(pInputDevice, pOutputDevice));
+    if (!m_pConfig->exists(key)) {
+        // Keep the compensation that has been entered manually
+        return;
+    }
+    const int roundTripFrames = m_pConfig->getValue(key, 0);
+    const double roundTripMs = 1000.0 * roundTripFrames / m_config.getSampleRate().toDouble();
+    qDebug() << "Applying the measured round trip latency of" << roundTripMs << "ms";
+    m_microphoneLatencyCompensation.set(roundTripMs);
+}
+
+void SoundManager::forgetMeasuredLatency() {
+    const SoundDevicePointer pInputDevice = latencyMeasurementInputDevice();
+    const SoundDevicePointer pOutputDevice = latencyMeasurementOutputDevice();
+    if (!pInputDevice || !pOutputDevice) {
+        return;
+    }
+    m_pConfig->remove(ConfigKey(kLatencyMeasurementGroup,
+            latencyMeasurementKey(pInputDevice, pOutputDevice)));
+}
@@ -5,11 +5,13 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <QTimer>
 
 #include "audio/types.h"
 #include "control/pollingcontrolproxy.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "preferences/usersettings.h"
+#include "soundio/latencymeasurement.h"
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanagerconfig.h"
 #include "util/cmdlineargs.h"
@@ -19,6 +21,8 @@ class EngineMixer;
 class ControlObject;
 
 #define MIXXX_PORTAUDIO_JACK_STRING "JACK Audio Connection Kit"
+// The JACK client of SoundDeviceJack, that bypasses PortAudio
+#define MIXXX_JACK_NATIVE_STRING "JACK (native)"
 #define MIXXX_PORTAUDIO_ALSA_STRING "ALSA"
 #define MIXXX_PORTAUDIO_OSS_STRING "OSS"
 #define MIXXX_PORTAUDIO_ASIO_STRING "ASIO"
@@ -50,6 +54,9 @@ class SoundManager : public QObject {
     void clearAndQueryDevices();
     void queryDevices();
     void queryDevicesPortaudio();
+#ifdef __JACK__
+    void queryDevicesJack();
+#endif
     void queryDevicesMixxx();
 
     // Opens all the devices chosen by the user in the preferences dialog, and
@@ -107,11 +114,26 @@ class SoundManager : public QObject {
 
     void processUnderflowHappened(SINT framesPerBuffer);
 
+    /// Plays impulses on the device of the main output and detects them on
+    /// the device of the microphone, connected with a loopback. The result
+    /// is stored for the devices, sample rate and buffer size, and applied
+    /// to the microphone latency compensation, now and whenever the same
+    /// setup is opened again. Returns false if no such devices are open.
+    bool startLatencyMeasurement();
+    void cancelLatencyMeasurement();
+    bool isLatencyMeasurementRunning() const {
+        return m_latencyMeasurementTimer.isActive();
+    }
+    /// Forgets the measurement of the open setup, so a compensation that
+    /// has been entered manually is kept.
+    void forgetMeasuredLatency();
+
   signals:
     void devicesUpdated(); // emitted when pointers to SoundDevices go stale
     void devicesSetup(); // emitted when the sound devices have been set up
     void outputRegistered(const AudioOutput& output, AudioSource* src);
     void inputRegistered(const AudioInput& input, AudioDestination* dest);
+    void latencyMeasurementFinished(LatencyMeasurement::State state, double roundTripMs);
 
   private:
     // Closes all the devices and empties the list of devices we have.
@@ -123,9 +145,23 @@ class SoundManager : public QObject {
     // isn't open is safe.
     void closeDevices(bool sleepAfterClosing);
 
+    void slotPollLatencyMeasurement();
+    void finishLatencyMeasurement();
+    /// The devices whose loopback is measured, or nullptr if not open
+    SoundDevicePointer latencyMeasurementInputDevice() const;
+    SoundDevicePointer latencyMeasurementOutputDevice() const;
+    QString latencyMeasurementKey(const SoundDevicePointer& pInputDevice,
+            const SoundDevicePointer& pOutputDevice) const;
+    void applyMeasuredLatency();
+
+    /// Returns false if a device needs to be reopened for the buffer size
+    /// of m_config, or no device is open.
+    bool changeFramesPerBufferOfOpenDevices();
+
     void setJACKName() const;
     bool jackApiUsed() const {
-        return m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING;
+        return m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING ||
+                m_config.getAPI() == MIXXX_JACK_NATIVE_STRING;
     }
 
     EngineMixer* m_pEngineMixer;
@@ -149,4 +185,11 @@ class SoundManager : public QObject {
     int m_underflowUpdateCount;
     PollingControlProxy m_audioLatencyOverloadCount;
     PollingControlProxy m_audioLatencyOverload;
+
+    LatencyMeasurement m_latencyMeasurement;
+    QTimer m_latencyMeasurementTimer;
+    int m_latencyMeasurementPendingPolls;
+    SoundDevicePointer m_pLatencyMeasurementInputDevice;
+    SoundDevicePointer m_pLatencyMeasurementOutputDevice;
+    PollingControlProxy m_microphoneLatencyCompensation;
 };
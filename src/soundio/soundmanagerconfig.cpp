@@ -426,6 +426,32 @@ void SoundManagerConfig::setAudioBufferSizeIndex(unsigned int sizeIndex) {
     m_audioBufferSizeIndex = sizeIndex != 0 ? math_min(sizeIndex, kMaxAudioBufferSizeIndex) : 1;
 }
 
+bool SoundManagerConfig::setFramesPerBuffer(unsigned int framesPerBuffer) {
+    if (m_api == MIXXX_PORTAUDIO_JACK_STRING) {
+        // The indices are not frames per buffer, see getFramesPerBuffer()
+        return false;
+    }
+    const unsigned int previousIndex = m_audioBufferSizeIndex;
+    for (unsigned int index = 1; index <= kMaxAudioBufferSizeIndex; ++index) {
+        m_audioBufferSizeIndex = index;
+        if (getFramesPerBuffer() == framesPerBuffer) {
+            return true;
+        }
+    }
+    m_audioBufferSizeIndex = previousIndex;
+    return false;
+}
+
+bool SoundManagerConfig::isEqualExceptAudioBufferSize(const SoundManagerConfig& other) const {
+    return m_api == other.m_api &&
+            m_sampleRate == other.m_sampleRate &&
+            m_deckCount == other.m_deckCount &&
+            m_syncBuffers == other.m_syncBuffers &&
+            m_forceNetworkClock == other.m_forceNetworkClock &&
+            m_outputs == other.m_outputs &&
+            m_inputs == other.m_inputs;
+}
+
 void SoundManagerConfig::addOutput(const SoundDeviceId &device, const AudioOutput &out) {
     m_outputs.insert(device, out);
 }
@@ -82,6 +82,9 @@ class SoundManagerConfig {
     unsigned int getAudioBufferSizeIndex() const;
     unsigned int getFramesPerBuffer() const;
     void setAudioBufferSizeIndex(unsigned int latency);
+    // Selects the audio buffer size index of a buffer size reported by the
+    // device. Returns false if no index corresponds to it.
+    bool setFramesPerBuffer(unsigned int framesPerBuffer);
     unsigned int getSyncBuffers() const;
     void setSyncBuffers(unsigned int syncBuffers);
     bool getForceNetworkClock() const;
@@ -95,6 +98,9 @@ class SoundManagerConfig {
     bool hasMicInputs();
     bool hasExternalRecordBroadcast();
     void loadDefaults(SoundManager* soundManager, unsigned int flags);
+    // True if the open devices only need a new buffer size to follow this
+    // config, instead of being reopened.
+    bool isEqualExceptAudioBufferSize(const SoundManagerConfig& other) const;
 
   private:
     QFileInfo m_configFile;
@@ -0,0 +1,252 @@
+#include "soundio/xrunrecorder.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonObject>
+#include <QTimer>
+
+#include "control/controlproxy.h"
+#include "moc_xrunrecorder.cpp"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/time.h"
+
+namespace {
+
+const mixxx::Logger kLogger("XrunRecorder");
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+// The engine profiler ring holds 1024 callbacks, which are at least 1 s
+constexpr int kDispatchIntervalMillis = 100;
+
+// The callbacks after the xrun are part of the dump
+constexpr int kDumpDelayMillis = 1000;
+
+// Bounds the memory if controllers flood the log between two trims
+constexpr std::size_t kMaxControlEvents = 16384;
+
+constexpr int kControllersTid = 1000;
+
+qint64 nowNanos() {
+    return mixxx::Time::elapsed().toIntegerNanos();
+}
+
+double toTraceMicros(qint64 nanos) {
+    return static_cast<double>(nanos) / mixxx::Duration::kNanosPerMicro;
+}
+
+} // namespace
+
+XrunRecorder::XrunRecorder(UserSettingsPointer pConfig, QObject* pParent)
+        : QObject(pParent),
+          m_pConfig(pConfig),
+          m_durationNanos(mixxx::Duration::kNanosPerSecond *
+                  math_max(1,
+                          pConfig->getValue(
+                                  ConfigKey(kAppGroup,
+                                          QStringLiteral("xrun_capture_seconds")),
+                                  10))),
+          m_pXrunCount(make_parented<ControlProxy>(kAppGroup,
+                  QStringLiteral("audio_latency_overload_count"),
+                  this)),
+          m_droppedProfiles(0),
+          m_xrunNanos(0),
+          m_dumpPending(false) {
+    m_pXrunCount->connectValueChanged(this, &XrunRecorder::slotXrunCountChanged);
+
+#ifdef __LINUX__
+    const QDir cpuDir(QStringLiteral("/sys/devices/system/cpu"));
+    const QStringList cpus = cpuDir.entryList(
+            QStringList{QStringLiteral("cpu[0-9]*")}, QDir::Dirs);
+    for (const QString& cpu : cpus) {
+        const QString fileName = cpuDir.filePath(cpu + "/cpufreq/scaling_cur_freq");
+        if (QFile::exists(fileName)) {
+            m_cpuFrequencyFiles.append(fileName);
+        }
+    }
+#endif
+
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler) {
+        pProfiler->addConsumer(this);
+    }
+    s_pInstance.store(this);
+    startTimer(kDispatchIntervalMillis);
+    kLogger.info() << "Capturing the last" << m_durationNanos / mixxx::Duration::kNanosPerSecond
+                   << "seconds before xruns";
+}
+
+XrunRecorder::~XrunRecorder() {
+    s_pInstance.store(nullptr);
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler) {
+        pProfiler->removeConsumer(this);
+    }
+}
+
+void XrunRecorder::addControlEvent(const ConfigKey& key, double value) {
+    const auto locker = QMutexLocker(&m_controlEventsMutex);
+    if (m_controlEvents.size() >= kMaxControlEvents) {
+        m_controlEvents.pop_front();
+    }
+    m_controlEvents.push_back(ControlEvent{nowNanos(), key, value});
+}
+
+void XrunRecorder::consumeProfiles(
+        const std::vector<EngineProfiler::CallbackProfile>& profiles,
+        int droppedProfiles) {
+    m_droppedProfiles += droppedProfiles;
+    m_profiles.insert(m_profiles.end(), profiles.begin(), profiles.end());
+}
+
+void XrunRecorder::timerEvent(QTimerEvent* pTimerEvent) {
+    Q_UNUSED(pTimerEvent);
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    if (pProfiler) {
+        pProfiler->dispatch();
+    }
+    sampleCpuFrequencies();
+    if (!m_dumpPending) {
+        trim();
+    }
+}
+
+void XrunRecorder::sampleCpuFrequencies() {
+    if (m_cpuFrequencyFiles.isEmpty()) {
+        return;
+    }
+    CpuFrequencies sample;
+    sample.nanos = nowNanos();
+    sample.megahertz.reserve(m_cpuFrequencyFiles.size());
+    for (const QString& fileName : std::as_const(m_cpuFrequencyFiles)) {
+        QFile file(fileName);
+        int kilohertz = 0;
+        if (file.open(QIODevice::ReadOnly)) {
+            kilohertz = file.readAll().trimmed().toInt();
+        }
+        sample.megahertz.append(kilohertz / 1000);
+    }
+    m_cpuFrequencies.push_back(std::move(sample));
+}
+
+void XrunRecorder::trim() {
+    const qint64 startNanos = nowNanos() - m_durationNanos;
+    while (!m_profiles.empty() && m_profiles.front().startNanos < startNanos) {
+        m_profiles.pop_front();
+    }
+    while (!m_cpuFrequencies.empty() && m_cpuFrequencies.front().nanos < startNanos) {
+        m_cpuFrequencies.pop_front();
+    }
+    const auto locker = QMutexLocker(&m_controlEventsMutex);
+    while (!m_controlEvents.empty() && m_controlEvents.front().nanos < startNanos) {
+        m_controlEvents.pop_front();
+    }
+}
+
+void XrunRecorder::slotXrunCountChanged(double count) {
+    if (count <= 0 || m_dumpPending) {
+        // Reset or the xrun is already part of the next dump
+        return;
+    }
+    // SoundManager reports at most one xrun every 500 ms
+    m_xrunNanos = nowNanos();
+    m_dumpPending = true;
+    QTimer::singleShot(kDumpDelayMillis, this, [this] {
+        EngineProfiler* pProfiler = EngineProfiler::instance();
+        if (pProfiler) {
+            pProfiler->dispatch();
+        }
+        writeDump();
+        m_dumpPending = false;
+        trim();
+    });
+}
+
+void XrunRecorder::writeDump() {
+    EngineProfiler* pProfiler = EngineProfiler::instance();
+    const QStringList channelNames =
+            pProfiler ? pProfiler->channelNames() : QStringList();
+
+    EngineProfileStatistics statistics(static_cast<int>(m_profiles.size()));
+    for (const auto& profile : m_profiles) {
+        statistics.add(profile);
+    }
+    QJsonArray events = statistics.toChromeTraceEvents(channelNames);
+
+    QJsonObject xrun;
+    xrun.insert(QStringLiteral("name"), QStringLiteral("Xrun reported"));
+    xrun.insert(QStringLiteral("ph"), QStringLiteral("i"));
+    xrun.insert(QStringLiteral("s"), QStringLiteral("g"));
+    xrun.insert(QStringLiteral("pid"), 1);
+    xrun.insert(QStringLiteral("tid"), 0);
+    xrun.insert(QStringLiteral("ts"), toTraceMicros(m_xrunNanos));
+    QJsonObject xrunArgs;
+    xrunArgs.insert(QStringLiteral("count"), m_pXrunCount->get());
+    xrunArgs.insert(QStringLiteral("late_callbacks"), statistics.lateCallbacks());
+    xrunArgs.insert(QStringLiteral("dropped_profiles"), m_droppedProfiles);
+    xrun.insert(QStringLiteral("args"), xrunArgs);
+    events.append(xrun);
+
+    for (const auto& sample : m_cpuFrequencies) {
+        QJsonObject counter;
+        counter.insert(QStringLiteral("name"), QStringLiteral("CPU frequency [MHz]"));
+        counter.insert(QStringLiteral("ph"), QStringLiteral("C"));
+        counter.insert(QStringLiteral("pid"), 1);
+        counter.insert(QStringLiteral("ts"), toTraceMicros(sample.nanos));
+        QJsonObject args;
+        for (int cpu = 0; cpu < sample.megahertz.size(); ++cpu) {
+            args.insert(QStringLiteral("cpu%1").arg(cpu), sample.megahertz[cpu]);
+        }
+        counter.insert(QStringLiteral("args"), args);
+        events.append(counter);
+    }
+
+    {
+        const auto locker = QMutexLocker(&m_controlEventsMutex);
+        if (!m_controlEvents.empty()) {
+            QJsonObject threadName;
+            threadName.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+            threadName.insert(QStringLiteral("ph"), QStringLiteral("M"));
+            threadName.insert(QStringLiteral("pid"), 1);
+            threadName.insert(QStringLiteral("tid"), kControllersTid);
+            QJsonObject args;
+            args.insert(QStringLiteral("name"), QStringLiteral("Controllers"));
+            threadName.insert(QStringLiteral("args"), args);
+            events.append(threadName);
+        }
+        for (const auto& controlEvent : m_controlEvents) {
+            QJsonObject event;
+            event.insert(QStringLiteral("name"),
+                    controlEvent.key.group + QChar(',') + controlEvent.key.item);
+            event.insert(QStringLiteral("ph"), QStringLiteral("i"));
+            event.insert(QStringLiteral("s"), QStringLiteral("t"));
+            event.insert(QStringLiteral("pid"), 1);
+            event.insert(QStringLiteral("tid"), kControllersTid);
+            event.insert(QStringLiteral("ts"), toTraceMicros(controlEvent.nanos));
+            QJsonObject args;
+            args.insert(QStringLiteral("value"), controlEvent.value);
+            event.insert(QStringLiteral("args"), args);
+            events.append(event);
+        }
+    }
+
+    const QDir dir(QDir(m_pConfig->getSettingsPath()).filePath(QStringLiteral("xruns")));
+    if (!dir.mkpath(QStringLiteral("."))) {
+        kLogger.warning() << "Failed to create" << dir.path();
+        return;
+    }
+    const QString timestamp = QDateTime::currentDateTime().toString(
+            "yyyy-MM-dd_hh'h'mm'm'ss's'zzz");
+    const QString fileName = dir.filePath(QStringLiteral("xrun_%1.json").arg(timestamp));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to open" << fileName;
+        return;
+    }
+    file.write(EngineProfileStatistics::toChromeTrace(events));
+    kLogger.info() << "Saved the last" << m_profiles.size() << "callbacks before the xrun to"
+                   << fileName;
+    m_droppedProfiles = 0;
+}
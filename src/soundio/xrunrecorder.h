@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <deque>
+
+#include "engine/engineprofiler.h"
+#include "preferences/configobject.h"
+#include "preferences/usersettings.h"
+#include "util/parented_ptr.h"
+
+class ControlProxy;
+
+/// Keeps the engine stage timings of the last seconds together with the CPU
+/// frequencies, the cache misses of the decks and the control events of the
+/// controllers in memory, and writes them to a file in the xruns directory
+/// of the settings after each xrun. The files use the Chrome trace format
+/// and can be loaded into chrome://tracing or https://ui.perfetto.dev to
+/// tell whether decoding, time stretching, effects or the OS scheduling
+/// delayed the callback.
+///
+/// Enabled with [App],xrun_capture. [App],xrun_capture_seconds sets the
+/// length of the log.
+class XrunRecorder : public QObject, public EngineProfiler::Consumer {
+    Q_OBJECT
+  public:
+    explicit XrunRecorder(UserSettingsPointer pConfig, QObject* pParent = nullptr);
+    ~XrunRecorder() override;
+
+    /// Records a control change by a controller. Thread safe, does nothing
+    /// without a recorder.
+    static void recordControlEvent(const ConfigKey& key, double value) {
+        XrunRecorder* pRecorder = s_pInstance.load(std::memory_order_relaxed);
+        if (pRecorder) {
+            pRecorder->addControlEvent(key, value);
+        }
+    }
+
+    void consumeProfiles(const std::vector<EngineProfiler::CallbackProfile>& profiles,
+            int droppedProfiles) override;
+
+  protected:
+    void timerEvent(QTimerEvent* pTimerEvent) override;
+
+  private slots:
+    void slotXrunCountChanged(double count);
+
+  private:
+    struct ControlEvent {
+        qint64 nanos;
+        ConfigKey key;
+        double value;
+    };
+    struct CpuFrequencies {
+        qint64 nanos;
+        QVector<int> megahertz;
+    };
+
+    static inline std::atomic<XrunRecorder*> s_pInstance = nullptr;
+
+    void addControlEvent(const ConfigKey& key, double value);
+    void sampleCpuFrequencies();
+    void trim();
+    void writeDump();
+
+    const UserSettingsPointer m_pConfig;
+    const qint64 m_durationNanos;
+    parented_ptr<ControlProxy> m_pXrunCount;
+
+    std::deque<EngineProfiler::CallbackProfile> m_profiles;
+    int m_droppedProfiles;
+    QStringList m_cpuFrequencyFiles;
+    std::deque<CpuFrequencies> m_cpuFrequencies;
+    qint64 m_xrunNanos;
+    bool m_dumpPending;
+
+    QMutex m_controlEventsMutex;
+    std::deque<ControlEvent> m_controlEvents;
+};
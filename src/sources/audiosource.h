@@ -339,6 +339,14 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     ReadableSampleFrames readSampleFrames(
             const WritableSampleFrames& sampleFrames);
 
+    /// Hints that the given frames will be read soon. Sources that read
+    /// from slow storage may start fetching them in the background. The
+    /// default implementation does nothing.
+    virtual void prefetchSampleFrames(
+            IndexRange frameIndexRange) {
+        Q_UNUSED(frameIndexRange)
+    }
+
   protected:
     explicit AudioSource(const QUrl& url);
 
@@ -0,0 +1,143 @@
+#include "sources/audiosourcepcmcache.h"
+
+#include <cstring>
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("AudioSourcePcmCache");
+
+constexpr char kMagic[8] = {'M', 'X', 'X', 'P', 'C', 'M', '0', '1'};
+
+} // anonymous namespace
+
+// static
+PcmCacheFileHeader PcmCacheFileHeader::create(
+        const audio::SignalInfo& signalInfo,
+        audio::Bitrate bitrate,
+        IndexRange frameIndexRange) {
+    PcmCacheFileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.channelCount = signalInfo.getChannelCount().value();
+    header.sampleRate = signalInfo.getSampleRate().value();
+    header.bitrate = bitrate.value();
+    header.firstFrameIndex = frameIndexRange.start();
+    header.frameCount = frameIndexRange.length();
+    return header;
+}
+
+bool PcmCacheFileHeader::isValid() const {
+    return std::memcmp(magic, kMagic, sizeof(magic)) == 0 &&
+            version == kVersion &&
+            channelCount > 0 &&
+            sampleRate > 0 &&
+            firstFrameIndex >= 0 &&
+            frameCount > 0;
+}
+
+AudioSourcePcmCache::AudioSourcePcmCache(
+        const QUrl& url,
+        const QString& cacheFilePath)
+        : AudioSource(url),
+          m_file(cacheFilePath),
+          m_pSamples(nullptr) {
+}
+
+AudioSourcePcmCache::~AudioSourcePcmCache() {
+    close();
+}
+
+AudioSource::OpenResult AudioSourcePcmCache::tryOpen(
+        OpenMode /*mode*/,
+        const OpenParams& params) {
+    DEBUG_ASSERT(!m_pSamples);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open cache file"
+                << m_file.fileName()
+                << m_file.errorString();
+        return OpenResult::Failed;
+    }
+    PcmCacheFileHeader header;
+    if (m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+            !header.isValid()) {
+        kLogger.warning()
+                << "Invalid cache file"
+                << m_file.fileName();
+        return OpenResult::Failed;
+    }
+    // The cached signal could only be reduced by a proxy. Let the caller
+    // decode the original file instead.
+    if (params.getSignalInfo().getChannelCount().isValid() &&
+            header.channelCount > params.getSignalInfo().getChannelCount().value()) {
+        return OpenResult::Aborted;
+    }
+    const qint64 sampleBytes = header.frameCount * header.channelCount *
+            static_cast<qint64>(sizeof(CSAMPLE));
+    if (m_file.size() != static_cast<qint64>(sizeof(header)) + sampleBytes) {
+        kLogger.warning()
+                << "Truncated cache file"
+                << m_file.fileName();
+        return OpenResult::Failed;
+    }
+    const uchar* pMapped = m_file.map(sizeof(header), sampleBytes);
+    if (!pMapped) {
+        kLogger.warning()
+                << "Failed to map cache file"
+                << m_file.fileName()
+                << m_file.errorString();
+        return OpenResult::Failed;
+    }
+    m_pSamples = reinterpret_cast<const CSAMPLE*>(pMapped);
+
+    if (!initChannelCountOnce(static_cast<int>(header.channelCount))) {
+        return OpenResult::Failed;
+    }
+    if (!initSampleRateOnce(static_cast<SINT>(header.sampleRate))) {
+        return OpenResult::Failed;
+    }
+    if (header.bitrate > 0) {
+        initBitrateOnce(static_cast<SINT>(header.bitrate));
+    }
+    if (!initFrameIndexRangeOnce(IndexRange::forward(
+                static_cast<SINT>(header.firstFrameIndex),
+                static_cast<SINT>(header.frameCount)))) {
+        return OpenResult::Failed;
+    }
+    return OpenResult::Succeeded;
+}
+
+void AudioSourcePcmCache::close() {
+    if (m_pSamples) {
+        m_file.unmap(const_cast<uchar*>(reinterpret_cast<const uchar*>(m_pSamples)));
+        m_pSamples = nullptr;
+    }
+    m_file.close();
+}
+
+ReadableSampleFrames AudioSourcePcmCache::readSampleFramesClamped(
+        const WritableSampleFrames& writableSampleFrames) {
+    DEBUG_ASSERT(m_pSamples);
+    const IndexRange frameIndexRange = writableSampleFrames.frameIndexRange();
+    const SINT sampleOffset = getSignalInfo().frames2samples(
+            frameIndexRange.start() - frameIndexMin());
+    const SINT sampleCount = getSignalInfo().frames2samples(frameIndexRange.length());
+    // The caller owns the buffer, so the samples need to be copied.
+    // An empty slice only skips the frames.
+    if (writableSampleFrames.writableData()) {
+        std::memcpy(writableSampleFrames.writableData(),
+                m_pSamples + sampleOffset,
+                sampleCount * sizeof(CSAMPLE));
+    }
+    return ReadableSampleFrames(
+            frameIndexRange,
+            SampleBuffer::ReadableSlice(
+                    writableSampleFrames.writableData(),
+                    sampleCount));
+}
+
+} // namespace mixxx
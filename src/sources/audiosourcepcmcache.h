@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QFile>
+
+#include "sources/audiosource.h"
+
+namespace mixxx {
+
+/// The file header of cache files written by PcmCache::Writer. All values
+/// are stored in native byte order, because cache files are never shared
+/// between hosts.
+struct PcmCacheFileHeader {
+    static constexpr quint32 kVersion = 1;
+
+    char magic[8];
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 firstFrameIndex;
+    qint64 frameCount;
+
+    static PcmCacheFileHeader create(
+            const audio::SignalInfo& signalInfo,
+            audio::Bitrate bitrate,
+            IndexRange frameIndexRange);
+
+    bool isValid() const;
+};
+
+/// Reads decoded samples from a memory-mapped cache file of PcmCache
+/// instead of decoding the original file.
+class AudioSourcePcmCache : public AudioSource {
+  public:
+    AudioSourcePcmCache(
+            const QUrl& url,
+            const QString& cacheFilePath);
+    ~AudioSourcePcmCache() override;
+
+    void close() override;
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode mode,
+            const OpenParams& params) override;
+
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& sampleFrames) override;
+
+  private:
+    QFile m_file;
+    const CSAMPLE* m_pSamples;
+};
+
+} // namespace mixxx
@@ -23,6 +23,11 @@ class AudioSourceProxy : public AudioSource {
         m_pAudioSource->close();
     }
 
+    void prefetchSampleFrames(
+            IndexRange frameIndexRange) override {
+        m_pAudioSource->prefetchSampleFrames(frameIndexRange);
+    }
+
   protected:
     OpenResult tryOpen(
             OpenMode mode,
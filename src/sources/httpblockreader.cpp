@@ -0,0 +1,470 @@
+#include "sources/httpblockreader.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTemporaryFile>
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("HttpBlockReader");
+
+const QString kBlockFileSuffix = QStringLiteral(".httpblocks");
+const QString kIndexFileSuffix = QStringLiteral(".httpindex");
+
+constexpr char kIndexMagic[] = "MXXHTTP1";
+
+// Enough to keep a connection busy while the previous block is written
+constexpr int kMaxPendingRequestCount = 2;
+
+// About 24 seconds of a 320 kbps MP3 file
+constexpr qint64 kReadAheadBlockCount = 4;
+
+constexpr int kMaxRetryCount = 3;
+
+constexpr unsigned long kFetchTimeoutMillis = 30000;
+
+// Serializes the eviction of cache files between multiple readers
+QMutex s_evictionMutex;
+
+/// Parses "bytes <first>-<last>/<total>"
+bool parseContentRange(const QByteArray& header,
+        qint64* pFirst,
+        qint64* pLast,
+        qint64* pTotal) {
+    static const QRegularExpression kContentRangeRegex(
+            QStringLiteral("^bytes\\s+(\\d+)-(\\d+)/(\\d+)$"));
+    const auto match = kContentRangeRegex.match(QString::fromLatin1(header).trimmed());
+    if (!match.hasMatch()) {
+        return false;
+    }
+    *pFirst = match.captured(1).toLongLong();
+    *pLast = match.captured(2).toLongLong();
+    *pTotal = match.captured(3).toLongLong();
+    return *pFirst <= *pLast && *pLast < *pTotal;
+}
+
+} // anonymous namespace
+
+QString HttpBlockReader::s_directoryPath;
+qint64 HttpBlockReader::s_maxSizeInBytes = 0;
+
+// static
+void HttpBlockReader::initialize(const QString& directoryPath, qint64 maxSizeInBytes) {
+    s_directoryPath.clear();
+    s_maxSizeInBytes = 0;
+    if (directoryPath.isEmpty() || maxSizeInBytes <= 0) {
+        return;
+    }
+    QDir directory(directoryPath);
+    if (!directory.mkpath(QStringLiteral("."))) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << directoryPath;
+        return;
+    }
+    s_directoryPath = directory.absolutePath();
+    s_maxSizeInBytes = maxSizeInBytes;
+    evictLeastRecentlyUsed();
+}
+
+// static
+QString HttpBlockReader::cacheFilePath(const QUrl& url, const QString& suffix) {
+    DEBUG_ASSERT(isCacheEnabled());
+    const QByteArray hash = QCryptographicHash::hash(
+            url.toEncoded(), QCryptographicHash::Sha1);
+    return QDir(s_directoryPath)
+            .filePath(QString::fromLatin1(hash.toHex()) + suffix);
+}
+
+// static
+void HttpBlockReader::evictLeastRecentlyUsed() {
+    const auto locker = lockMutex(&s_evictionMutex);
+    // Sorted by modification time, newest first
+    const QFileInfoList fileInfos = QDir(s_directoryPath)
+                                            .entryInfoList(
+                                                    QStringList{QStringLiteral("*") +
+                                                            kBlockFileSuffix},
+                                                    QDir::Files,
+                                                    QDir::Time);
+    qint64 totalSize = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+        if (totalSize > s_maxSizeInBytes) {
+            kLogger.debug()
+                    << "Evicting"
+                    << fileInfo.fileName();
+            QFile::remove(fileInfo.filePath());
+            QFile::remove(QDir(s_directoryPath)
+                                  .filePath(fileInfo.completeBaseName() +
+                                          kIndexFileSuffix));
+        }
+    }
+}
+
+HttpBlockReader::HttpBlockReader(QUrl url)
+        : m_url(std::move(url)),
+          m_pContext(new QObject()),
+          m_pNetworkAccessManager(nullptr),
+          m_size(-1),
+          m_pendingRequestCount(0),
+          m_retryCount(0),
+          m_fetchScheduled(false) {
+    m_thread.setObjectName(QStringLiteral("HttpBlockReader"));
+    m_pContext->moveToThread(&m_thread);
+    m_thread.start();
+}
+
+HttpBlockReader::~HttpBlockReader() {
+    // Abort all pending requests from the network thread
+    QMetaObject::invokeMethod(
+            m_pContext,
+            [this] {
+                delete m_pNetworkAccessManager;
+                m_pNetworkAccessManager = nullptr;
+            },
+            Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_pContext;
+    storeCacheIndex();
+}
+
+bool HttpBlockReader::open() {
+    auto locker = lockMutex(&m_mutex);
+    DEBUG_ASSERT(m_size < 0);
+    scheduleFetches();
+    while (m_size < 0) {
+        if (!m_errorString.isEmpty()) {
+            return false;
+        }
+        if (!m_blockFetched.wait(&m_mutex, kFetchTimeoutMillis)) {
+            fail(QStringLiteral("Timeout"));
+            return false;
+        }
+    }
+    return waitForBlock(0);
+}
+
+qint64 HttpBlockReader::read(qint64 pos, char* pData, qint64 maxSize) {
+    auto locker = lockMutex(&m_mutex);
+    if (m_size < 0 || !m_errorString.isEmpty()) {
+        return -1;
+    }
+    if (pos >= m_size || maxSize <= 0) {
+        return 0;
+    }
+    const qint64 end = std::min(pos + maxSize, m_size);
+    const qint64 firstBlockIndex = pos / kBlockSize;
+    const qint64 readAheadEnd = std::min(
+            firstBlockIndex + 1 + kReadAheadBlockCount, blockCount());
+    for (qint64 blockIndex = firstBlockIndex + 1; blockIndex < readAheadEnd; ++blockIndex) {
+        enqueueBlock(&m_readAheadQueue, blockIndex);
+    }
+    if (!waitForBlock(firstBlockIndex)) {
+        return -1;
+    }
+    // Continue with all subsequent blocks that are already available
+    qint64 readEnd = std::min(end, (firstBlockIndex + 1) * kBlockSize);
+    while (readEnd < end &&
+            m_blockStates[readEnd / kBlockSize] == BlockState::Available) {
+        readEnd = std::min(end, readEnd + kBlockSize);
+    }
+    const qint64 length = readEnd - pos;
+    if (!m_pBlockFile->seek(pos) || m_pBlockFile->read(pData, length) != length) {
+        fail(m_pBlockFile->errorString());
+        return -1;
+    }
+    return length;
+}
+
+void HttpBlockReader::prefetch(qint64 pos, qint64 length) {
+    auto locker = lockMutex(&m_mutex);
+    if (m_size < 0 || length <= 0) {
+        return;
+    }
+    const qint64 firstBlockIndex = std::max(pos, qint64{0}) / kBlockSize;
+    const qint64 endBlockIndex = std::min(
+            (pos + length + kBlockSize - 1) / kBlockSize, blockCount());
+    for (qint64 blockIndex = firstBlockIndex; blockIndex < endBlockIndex; ++blockIndex) {
+        enqueueBlock(&m_hintQueue, blockIndex);
+    }
+}
+
+void HttpBlockReader::enqueueBlock(std::deque<qint64>* pQueue, qint64 blockIndex) {
+    DEBUG_ASSERT(blockIndex >= 0 && blockIndex < blockCount());
+    if (m_blockStates[blockIndex] != BlockState::Missing) {
+        return;
+    }
+    m_blockStates[blockIndex] = BlockState::Queued;
+    pQueue->push_back(blockIndex);
+    scheduleFetches();
+}
+
+bool HttpBlockReader::waitForBlock(qint64 blockIndex) {
+    DEBUG_ASSERT(blockIndex >= 0 && blockIndex < blockCount());
+    // A block that is only queued for prefetching is moved to the front
+    if (m_blockStates[blockIndex] == BlockState::Missing ||
+            m_blockStates[blockIndex] == BlockState::Queued) {
+        m_blockStates[blockIndex] = BlockState::Queued;
+        m_demandQueue.push_back(blockIndex);
+        scheduleFetches();
+    }
+    while (m_blockStates[blockIndex] != BlockState::Available) {
+        if (!m_errorString.isEmpty()) {
+            return false;
+        }
+        if (!m_blockFetched.wait(&m_mutex, kFetchTimeoutMillis)) {
+            fail(QStringLiteral("Timeout"));
+            return false;
+        }
+    }
+    return true;
+}
+
+void HttpBlockReader::scheduleFetches() {
+    if (m_fetchScheduled) {
+        return;
+    }
+    m_fetchScheduled = true;
+    QMetaObject::invokeMethod(
+            m_pContext,
+            [this] {
+                startFetches();
+            },
+            Qt::QueuedConnection);
+}
+
+void HttpBlockReader::startFetches() {
+    if (!m_pNetworkAccessManager) {
+        m_pNetworkAccessManager = new QNetworkAccessManager(m_pContext);
+    }
+    const auto locker = lockMutex(&m_mutex);
+    m_fetchScheduled = false;
+    while (m_pendingRequestCount < kMaxPendingRequestCount && m_errorString.isEmpty()) {
+        qint64 blockIndex = -1;
+        if (m_size < 0) {
+            // The size is only known after the first response
+            if (m_pendingRequestCount > 0) {
+                return;
+            }
+            blockIndex = 0;
+        } else {
+            for (auto* pQueue : {&m_demandQueue, &m_hintQueue, &m_readAheadQueue}) {
+                while (blockIndex < 0 && !pQueue->empty()) {
+                    if (m_blockStates[pQueue->front()] == BlockState::Queued) {
+                        blockIndex = pQueue->front();
+                    }
+                    pQueue->pop_front();
+                }
+            }
+            if (blockIndex < 0) {
+                return;
+            }
+            m_blockStates[blockIndex] = BlockState::Pending;
+        }
+
+        const qint64 first = blockIndex * kBlockSize;
+        const qint64 last = (m_size < 0 ? first + kBlockSize
+                                        : std::min(first + kBlockSize, m_size)) -
+                1;
+        QNetworkRequest request(m_url);
+        request.setRawHeader("Range",
+                "bytes=" + QByteArray::number(first) + '-' + QByteArray::number(last));
+        // The byte positions refer to the unencoded file
+        request.setRawHeader("Accept-Encoding", "identity");
+        QNetworkReply* pReply = m_pNetworkAccessManager->get(request);
+        ++m_pendingRequestCount;
+        QObject::connect(pReply,
+                &QNetworkReply::finished,
+                m_pContext,
+                [this, pReply, blockIndex] {
+                    onBlockFetched(pReply, blockIndex);
+                });
+    }
+}
+
+void HttpBlockReader::onBlockFetched(QNetworkReply* pReply, qint64 blockIndex) {
+    pReply->deleteLater();
+    const QByteArray data = pReply->readAll();
+    const auto locker = lockMutex(&m_mutex);
+    DEBUG_ASSERT(m_pendingRequestCount > 0);
+    --m_pendingRequestCount;
+    if (!m_errorString.isEmpty()) {
+        return;
+    }
+    if (pReply->error() != QNetworkReply::NoError) {
+        kLogger.warning()
+                << "Failed to fetch block"
+                << blockIndex
+                << "of"
+                << m_url
+                << pReply->errorString();
+        if (m_size >= 0 && m_retryCount < kMaxRetryCount) {
+            ++m_retryCount;
+            m_blockStates[blockIndex] = BlockState::Queued;
+            m_demandQueue.push_front(blockIndex);
+            scheduleFetches();
+        } else {
+            fail(pReply->errorString());
+        }
+        return;
+    }
+    m_retryCount = 0;
+
+    const int statusCode = pReply->attribute(
+                                         QNetworkRequest::HttpStatusCodeAttribute)
+                                   .toInt();
+    qint64 first;
+    qint64 last;
+    qint64 total;
+    if (statusCode != 206 ||
+            !parseContentRange(pReply->rawHeader("Content-Range"), &first, &last, &total)) {
+        fail(QStringLiteral("Range requests are not supported by the server"));
+        return;
+    }
+    if (m_size < 0) {
+        QByteArray validator = pReply->rawHeader("ETag");
+        if (validator.isEmpty()) {
+            validator = pReply->rawHeader("Last-Modified");
+        }
+        initBlocks(total, validator);
+        if (!m_errorString.isEmpty()) {
+            return;
+        }
+        m_blockStates[blockIndex] = BlockState::Pending;
+    } else if (total != m_size) {
+        fail(QStringLiteral("The remote file has been modified"));
+        return;
+    }
+    const qint64 expectedFirst = blockIndex * kBlockSize;
+    const qint64 expectedLength = std::min(kBlockSize, m_size - expectedFirst);
+    if (first != expectedFirst ||
+            last - first + 1 != expectedLength ||
+            data.size() != expectedLength) {
+        fail(QStringLiteral("Unexpected response for block ") + QString::number(blockIndex));
+        return;
+    }
+    if (!m_pBlockFile->seek(expectedFirst) || m_pBlockFile->write(data) != data.size()) {
+        fail(m_pBlockFile->errorString());
+        return;
+    }
+    m_blockStates[blockIndex] = BlockState::Available;
+    m_blockFetched.wakeAll();
+    scheduleFetches();
+}
+
+void HttpBlockReader::initBlocks(qint64 size, const QByteArray& validator) {
+    DEBUG_ASSERT(m_size < 0);
+    m_size = size;
+    m_validator = validator;
+    m_blockStates.assign(blockCount(), BlockState::Missing);
+    if (!isCacheEnabled()) {
+        auto pTemporaryFile = std::make_unique<QTemporaryFile>();
+        if (!pTemporaryFile->open()) {
+            fail(pTemporaryFile->errorString());
+            return;
+        }
+        m_pBlockFile = std::move(pTemporaryFile);
+        return;
+    }
+
+    m_pBlockFile = std::make_unique<QFile>(cacheFilePath(m_url, kBlockFileSuffix));
+    QFile indexFile(cacheFilePath(m_url, kIndexFileSuffix));
+    bool reuseBlocks = false;
+    if (!validator.isEmpty() && indexFile.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&indexFile);
+        stream.setVersion(QDataStream::Qt_5_15);
+        QByteArray magic;
+        qint64 cachedSize;
+        QByteArray cachedValidator;
+        QByteArray bitmap;
+        stream >> magic >> cachedSize >> cachedValidator >> bitmap;
+        reuseBlocks = stream.status() == QDataStream::Ok &&
+                magic == kIndexMagic &&
+                cachedSize == size &&
+                cachedValidator == validator &&
+                bitmap.size() == (blockCount() + 7) / 8 &&
+                m_pBlockFile->exists();
+        if (reuseBlocks) {
+            for (qint64 blockIndex = 0; blockIndex < blockCount(); ++blockIndex) {
+                if (bitmap.at(blockIndex / 8) & (1 << (blockIndex % 8))) {
+                    m_blockStates[blockIndex] = BlockState::Available;
+                }
+            }
+            kLogger.debug()
+                    << "Reusing cached blocks of"
+                    << m_url;
+        }
+    }
+    if (!reuseBlocks) {
+        QFile::remove(m_pBlockFile->fileName());
+        indexFile.remove();
+    }
+    if (!m_pBlockFile->open(QIODevice::ReadWrite)) {
+        fail(m_pBlockFile->errorString());
+        return;
+    }
+    // Mark as recently used. Failing to do so is not critical.
+    m_pBlockFile->setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+}
+
+void HttpBlockReader::fail(const QString& errorString) {
+    if (m_errorString.isEmpty()) {
+        kLogger.warning()
+                << "Failed to read"
+                << m_url
+                << errorString;
+        m_errorString = errorString.isEmpty() ? QStringLiteral("Unknown error") : errorString;
+    }
+    m_blockFetched.wakeAll();
+}
+
+void HttpBlockReader::storeCacheIndex() {
+    if (!isCacheEnabled() || !m_pBlockFile || !m_pBlockFile->isOpen() ||
+            m_validator.isEmpty()) {
+        return;
+    }
+    m_pBlockFile->close();
+    QByteArray bitmap((blockCount() + 7) / 8, '\0');
+    for (qint64 blockIndex = 0; blockIndex < blockCount(); ++blockIndex) {
+        if (m_blockStates[blockIndex] == BlockState::Available) {
+            bitmap[blockIndex / 8] = static_cast<char>(
+                    bitmap[blockIndex / 8] | (1 << (blockIndex % 8)));
+        }
+    }
+    QSaveFile indexFile(cacheFilePath(m_url, kIndexFileSuffix));
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to write cache file"
+                << indexFile.fileName()
+                << indexFile.errorString();
+        return;
+    }
+    QDataStream stream(&indexFile);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << QByteArray(kIndexMagic) << m_size << m_validator << bitmap;
+    if (stream.status() != QDataStream::Ok || !indexFile.commit()) {
+        kLogger.warning()
+                << "Failed to write cache file"
+                << indexFile.fileName()
+                << indexFile.errorString();
+        return;
+    }
+    evictLeastRecentlyUsed();
+}
+
+} // namespace mixxx
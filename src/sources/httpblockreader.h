@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QUrl>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QObject;
+
+namespace mixxx {
+
+/// Reads a remote file through HTTP range requests.
+///
+/// The file is fetched in blocks of a fixed size that are stored in a
+/// disk-backed block cache. Only read() blocks until the requested bytes
+/// have been fetched, all other requests are asynchronous. Blocks are
+/// fetched in the following order:
+///  1. Blocks that are needed by a blocking read
+///  2. Blocks that have been hinted by prefetch(), e.g. around the playhead
+///     and the hotcues
+///  3. A read-ahead window after the most recent read
+///
+/// If the cache has been enabled by initialize() the fetched blocks survive
+/// closing the reader and are reused when the same URL is opened again, as
+/// long as the size and the ETag or Last-Modified header of the response
+/// don't change. Otherwise the blocks are kept in a temporary file. The total
+/// size of the cache is limited, the least recently used files are evicted
+/// first.
+///
+/// All network requests are made from a dedicated thread that is owned by
+/// the reader. read() and prefetch() may be called from any thread.
+class HttpBlockReader final {
+  public:
+    static constexpr qint64 kBlockSize = 256 * 1024;
+
+    /// Enables the persistent block cache, or disables it with an empty
+    /// path. Not thread-safe, must be called while no readers exist.
+    static void initialize(const QString& directoryPath, qint64 maxSizeInBytes);
+
+    static bool isCacheEnabled() {
+        return !s_directoryPath.isEmpty();
+    }
+
+    explicit HttpBlockReader(QUrl url);
+    ~HttpBlockReader();
+
+    /// Fetches the first block and the size of the file. Fails if the
+    /// server doesn't support range requests.
+    bool open();
+
+    /// The size of the remote file in bytes, only valid after open()
+    qint64 size() const {
+        return m_size;
+    }
+
+    /// Reads up to maxSize bytes at the given position. Returns
+    /// the number of bytes read, 0 at the end of the file, or -1
+    /// if the data could not be fetched.
+    qint64 read(qint64 pos, char* pData, qint64 maxSize);
+
+    /// Requests to fetch the given bytes in the background
+    /// without waiting for them.
+    void prefetch(qint64 pos, qint64 length);
+
+  private:
+    enum class BlockState {
+        Missing,
+        Queued,
+        Pending,
+        Available,
+    };
+
+    /// Requires m_mutex
+    void enqueueBlock(std::deque<qint64>* pQueue, qint64 blockIndex);
+    /// Requires m_mutex
+    void scheduleFetches();
+    /// Runs in m_thread
+    void startFetches();
+    /// Runs in m_thread
+    void onBlockFetched(QNetworkReply* pReply, qint64 blockIndex);
+    /// Requires m_mutex
+    void initBlocks(qint64 size, const QByteArray& validator);
+    /// Requires m_mutex
+    bool waitForBlock(qint64 blockIndex);
+    /// Requires m_mutex
+    void fail(const QString& errorString);
+    void storeCacheIndex();
+
+    qint64 blockCount() const {
+        return (m_size + kBlockSize - 1) / kBlockSize;
+    }
+
+    static QString cacheFilePath(const QUrl& url, const QString& suffix);
+    static void evictLeastRecentlyUsed();
+
+    static QString s_directoryPath;
+    static qint64 s_maxSizeInBytes;
+
+    const QUrl m_url;
+
+    QThread m_thread;
+    // Lives in m_thread and owns all network objects
+    QObject* m_pContext;
+    QNetworkAccessManager* m_pNetworkAccessManager;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_blockFetched;
+
+    // Everything below is guarded by m_mutex
+    qint64 m_size;
+    QByteArray m_validator;
+    std::unique_ptr<QFile> m_pBlockFile;
+
+    std::vector<BlockState> m_blockStates;
+    std::deque<qint64> m_demandQueue;
+    std::deque<qint64> m_hintQueue;
+    std::deque<qint64> m_readAheadQueue;
+    int m_pendingRequestCount;
+    // Consecutive failed requests
+    int m_retryCount;
+    bool m_fetchScheduled;
+
+    QString m_errorString;
+};
+
+} // namespace mixxx
@@ -0,0 +1,284 @@
+#include "sources/mp3seekindexcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QSaveFile>
+#include <cstring>
+#include <limits>
+
+#include "util/fileinfo.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("Mp3SeekIndexCache");
+
+const QString kFileSuffix = QStringLiteral(".mp3seek");
+
+constexpr char kMagic[8] = {'M', 'X', 'X', 'S', 'E', 'E', 'K', '1'};
+
+// Serializes the eviction of cache files between multiple writers
+QMutex s_evictionMutex;
+
+// Unsigned LEB128
+void appendVarint(QByteArray* pData, quint64 value) {
+    while (value >= 0x80) {
+        pData->append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    pData->append(static_cast<char>(value));
+}
+
+bool readVarint(const QByteArray& data, qsizetype* pPos, quint64* pValue) {
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pPos >= data.size()) {
+            return false;
+        }
+        const auto byte = static_cast<quint8>(data[(*pPos)++]);
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *pValue = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Small positive and negative differences are both encoded in a single byte
+quint64 zigZagEncode(qint64 value) {
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+qint64 zigZagDecode(quint64 value) {
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+} // anonymous namespace
+
+QString Mp3SeekIndexCache::s_directoryPath;
+qint64 Mp3SeekIndexCache::s_maxSizeInBytes = 0;
+
+// static
+void Mp3SeekIndexCache::initialize(const QString& directoryPath, qint64 maxSizeInBytes) {
+    s_directoryPath.clear();
+    s_maxSizeInBytes = 0;
+    if (directoryPath.isEmpty() || maxSizeInBytes <= 0) {
+        return;
+    }
+    QDir directory(directoryPath);
+    if (!directory.mkpath(QStringLiteral("."))) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << directoryPath;
+        return;
+    }
+    s_directoryPath = directory.absolutePath();
+    s_maxSizeInBytes = maxSizeInBytes;
+    evictLeastRecentlyUsed();
+}
+
+// static
+QString Mp3SeekIndexCache::cacheFilePath(const FileInfo& fileInfo) {
+    DEBUG_ASSERT(isEnabled());
+    // The size and modification time are validated when reading, so a
+    // modified file replaces its stale entry.
+    const QByteArray hash = QCryptographicHash::hash(
+            fileInfo.canonicalLocation().toUtf8(), QCryptographicHash::Sha1);
+    return QDir(s_directoryPath)
+            .filePath(QString::fromLatin1(hash.toHex()) + kFileSuffix);
+}
+
+// static
+QByteArray Mp3SeekIndexCache::encode(
+        const Entry& entry,
+        qint64 fileSize,
+        qint64 lastModifiedMillis) {
+    QByteArray data;
+    // Most MP3 frames need one byte for each value
+    data.reserve(sizeof(kMagic) + 64 + 2 * entry.seekFrames.size());
+    data.append(kMagic, sizeof(kMagic));
+    appendVarint(&data, static_cast<quint64>(fileSize));
+    appendVarint(&data, zigZagEncode(lastModifiedMillis));
+    appendVarint(&data, entry.channelCount.value());
+    appendVarint(&data, entry.sampleRate.value());
+    appendVarint(&data, entry.bitrate.value());
+    appendVarint(&data, static_cast<quint64>(entry.frameIndexEnd));
+    appendVarint(&data, entry.seekFrames.size());
+    // The MP3 frames of a file tend to have the same duration and size,
+    // so the deltas are encoded as their difference to the previous delta.
+    SeekFrame previous{0, 0};
+    SeekFrame previousDelta{0, 0};
+    for (const auto& seekFrame : entry.seekFrames) {
+        const SeekFrame delta{seekFrame.frameIndex - previous.frameIndex,
+                seekFrame.byteOffset - previous.byteOffset};
+        appendVarint(&data, zigZagEncode(delta.frameIndex - previousDelta.frameIndex));
+        appendVarint(&data, zigZagEncode(delta.byteOffset - previousDelta.byteOffset));
+        previous = seekFrame;
+        previousDelta = delta;
+    }
+    return data;
+}
+
+// static
+bool Mp3SeekIndexCache::decode(
+        const QByteArray& data,
+        qint64 fileSize,
+        qint64 lastModifiedMillis,
+        Entry* pEntry) {
+    DEBUG_ASSERT(pEntry);
+    if (data.size() < static_cast<qsizetype>(sizeof(kMagic)) ||
+            std::memcmp(data.constData(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    qsizetype pos = sizeof(kMagic);
+    quint64 cachedFileSize;
+    quint64 cachedLastModified;
+    quint64 channelCount;
+    quint64 sampleRate;
+    quint64 bitrate;
+    quint64 frameIndexEnd;
+    quint64 seekFrameCount;
+    if (!readVarint(data, &pos, &cachedFileSize) ||
+            !readVarint(data, &pos, &cachedLastModified) ||
+            !readVarint(data, &pos, &channelCount) ||
+            !readVarint(data, &pos, &sampleRate) ||
+            !readVarint(data, &pos, &bitrate) ||
+            !readVarint(data, &pos, &frameIndexEnd) ||
+            !readVarint(data, &pos, &seekFrameCount)) {
+        return false;
+    }
+    if (cachedFileSize != static_cast<quint64>(fileSize) ||
+            zigZagDecode(cachedLastModified) != lastModifiedMillis) {
+        // Stale
+        return false;
+    }
+    // Each seek frame needs at least 2 bytes
+    if (channelCount == 0 || channelCount > audio::ChannelCount::max().value() ||
+            sampleRate == 0 || sampleRate > audio::SampleRate::max().value() ||
+            bitrate > std::numeric_limits<audio::Bitrate::value_t>::max() ||
+            seekFrameCount == 0 ||
+            seekFrameCount > static_cast<quint64>(data.size() - pos) / 2 ||
+            frameIndexEnd > static_cast<quint64>(std::numeric_limits<SINT>::max())) {
+        return false;
+    }
+
+    std::vector<SeekFrame> seekFrames;
+    seekFrames.reserve(seekFrameCount);
+    SeekFrame previous{0, 0};
+    SeekFrame previousDelta{0, 0};
+    for (quint64 i = 0; i < seekFrameCount; ++i) {
+        quint64 frameIndexDelta;
+        quint64 byteOffsetDelta;
+        if (!readVarint(data, &pos, &frameIndexDelta) ||
+                !readVarint(data, &pos, &byteOffsetDelta)) {
+            return false;
+        }
+        const SeekFrame delta{
+                static_cast<SINT>(previousDelta.frameIndex + zigZagDecode(frameIndexDelta)),
+                previousDelta.byteOffset + zigZagDecode(byteOffsetDelta)};
+        const SeekFrame seekFrame{previous.frameIndex + delta.frameIndex,
+                previous.byteOffset + delta.byteOffset};
+        // The frames must start at 0 and be strictly ordered within the file
+        if (i == 0 ? (seekFrame.frameIndex != 0 || seekFrame.byteOffset < 0)
+                   : (delta.frameIndex <= 0 || delta.byteOffset <= 0)) {
+            return false;
+        }
+        if (seekFrame.byteOffset >= fileSize ||
+                seekFrame.frameIndex >= static_cast<SINT>(frameIndexEnd)) {
+            return false;
+        }
+        seekFrames.push_back(seekFrame);
+        previous = seekFrame;
+        previousDelta = delta;
+    }
+    if (pos != data.size()) {
+        return false;
+    }
+
+    pEntry->channelCount = audio::ChannelCount(static_cast<int>(channelCount));
+    pEntry->sampleRate = audio::SampleRate(static_cast<audio::SampleRate::value_t>(sampleRate));
+    pEntry->bitrate = audio::Bitrate(static_cast<audio::Bitrate::value_t>(bitrate));
+    pEntry->frameIndexEnd = static_cast<SINT>(frameIndexEnd);
+    pEntry->seekFrames = std::move(seekFrames);
+    return true;
+}
+
+// static
+bool Mp3SeekIndexCache::load(const FileInfo& fileInfo, Entry* pEntry) {
+    if (!isEnabled() || !fileInfo.exists()) {
+        return false;
+    }
+    QFile file(cacheFilePath(fileInfo));
+    if (!file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    if (!decode(file.readAll(),
+                fileInfo.sizeInBytes(),
+                fileInfo.lastModified().toMSecsSinceEpoch(),
+                pEntry)) {
+        kLogger.debug()
+                << "Ignoring stale or invalid cache file"
+                << file.fileName();
+        return false;
+    }
+    // Mark as recently used. Failing to do so is not critical.
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    kLogger.debug()
+            << "Read the seek frames of"
+            << fileInfo.location()
+            << "from"
+            << file.fileName();
+    return true;
+}
+
+// static
+void Mp3SeekIndexCache::store(const FileInfo& fileInfo, const Entry& entry) {
+    if (!isEnabled() || !fileInfo.exists()) {
+        return;
+    }
+    // Concurrent writers for the same file don't corrupt the cache file
+    QSaveFile file(cacheFilePath(fileInfo));
+    const QByteArray data = encode(entry,
+            fileInfo.sizeInBytes(),
+            fileInfo.lastModified().toMSecsSinceEpoch());
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(data) != data.size() ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to write cache file"
+                << file.fileName()
+                << file.errorString();
+        return;
+    }
+    evictLeastRecentlyUsed();
+}
+
+// static
+void Mp3SeekIndexCache::evictLeastRecentlyUsed() {
+    const auto locker = QMutexLocker(&s_evictionMutex);
+    // Sorted by modification time, newest first
+    const QFileInfoList fileInfos = QDir(s_directoryPath)
+                                            .entryInfoList(
+                                                    QStringList{QStringLiteral("*") +
+                                                            kFileSuffix},
+                                                    QDir::Files,
+                                                    QDir::Time);
+    qint64 totalSize = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+        if (totalSize > s_maxSizeInBytes) {
+            kLogger.debug()
+                    << "Evicting"
+                    << fileInfo.fileName();
+            QFile::remove(fileInfo.filePath());
+        }
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+class FileInfo;
+
+/// An on-disk cache of the seek frame lists of MP3 files.
+///
+/// SoundSourceMp3 needs to scan the headers of all MP3 frames before a file
+/// can be played, which takes seconds for long mixes on slow media. The
+/// result of the scan is stored in a compact, delta encoded file that is
+/// just a few bytes per MP3 frame and read instead of scanning the file
+/// again when it is opened the next time.
+///
+/// Entries are identified by the location of the file and only valid as
+/// long as its size and modification time don't change. Stale entries are
+/// replaced when the file is scanned again. The total size of the cache is
+/// limited, the least recently used entries are evicted first.
+class Mp3SeekIndexCache {
+  public:
+    struct SeekFrame {
+        SINT frameIndex;
+        /// The position of the MP3 frame in the file
+        qint64 byteOffset;
+    };
+
+    struct Entry {
+        audio::ChannelCount channelCount;
+        audio::SampleRate sampleRate;
+        audio::Bitrate bitrate;
+        /// The first frame index after the last MP3 frame
+        SINT frameIndexEnd = 0;
+        /// Ordered by frame index and byte offset
+        std::vector<SeekFrame> seekFrames;
+    };
+
+    /// Enables the cache, or disables it with an empty path. Not
+    /// thread-safe, must be called while no MP3 files are opened.
+    static void initialize(const QString& directoryPath, qint64 maxSizeInBytes);
+
+    static bool isEnabled() {
+        return !s_directoryPath.isEmpty();
+    }
+
+    /// Returns false on a cache miss or if the cached entry is stale
+    static bool load(const FileInfo& fileInfo, Entry* pEntry);
+    static void store(const FileInfo& fileInfo, const Entry& entry);
+
+    /// The cached file without the validation of the location, which is
+    /// already part of the file name.
+    static QByteArray encode(
+            const Entry& entry,
+            qint64 fileSize,
+            qint64 lastModifiedMillis);
+    static bool decode(
+            const QByteArray& data,
+            qint64 fileSize,
+            qint64 lastModifiedMillis,
+            Entry* pEntry);
+
+  private:
+    static QString cacheFilePath(const FileInfo& fileInfo);
+
+    static void evictLeastRecentlyUsed();
+
+    static QString s_directoryPath;
+    static qint64 s_maxSizeInBytes;
+};
+
+} // namespace mixxx
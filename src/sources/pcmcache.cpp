@@ -0,0 +1,272 @@
+#include "sources/pcmcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QMutex>
+#include <QTemporaryFile>
+
+#include "sources/audiosourcepcmcache.h"
+#include "util/fileinfo.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("PcmCache");
+
+const QString kFileSuffix = QStringLiteral(".pcm");
+const QString kTempFileSuffix = QStringLiteral(".tmp");
+
+// Uncompressed or cheap to decode formats are read directly
+const QStringList kCacheableFileTypes = {
+        QStringLiteral("aac"),
+        QStringLiteral("m4a"),
+        QStringLiteral("mp3"),
+        QStringLiteral("mp4"),
+        QStringLiteral("ogg"),
+        QStringLiteral("opus"),
+        QStringLiteral("stem.m4a"),
+        QStringLiteral("stem.mp4"),
+        QStringLiteral("wma"),
+};
+
+// Serializes the eviction of cache files between multiple writers
+QMutex s_evictionMutex;
+
+} // anonymous namespace
+
+QString PcmCache::s_directoryPath;
+qint64 PcmCache::s_maxSizeInBytes = 0;
+
+// static
+void PcmCache::initialize(const QString& directoryPath, qint64 maxSizeInBytes) {
+    DEBUG_ASSERT(!isEnabled());
+    VERIFY_OR_DEBUG_ASSERT(maxSizeInBytes > 0) {
+        return;
+    }
+    QDir directory(directoryPath);
+    if (!directory.mkpath(QStringLiteral("."))) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << directoryPath;
+        return;
+    }
+    // Discard incomplete files that have been left behind
+    const QStringList tempFileNames = directory.entryList(
+            QStringList{QStringLiteral("*") + kTempFileSuffix}, QDir::Files);
+    for (const auto& tempFileName : tempFileNames) {
+        directory.remove(tempFileName);
+    }
+    s_directoryPath = directory.absolutePath();
+    s_maxSizeInBytes = maxSizeInBytes;
+    kLogger.info()
+            << "Caching decoded audio data in"
+            << s_directoryPath
+            << "with a limit of"
+            << maxSizeInBytes / (1024 * 1024)
+            << "MB";
+    evictLeastRecentlyUsed();
+}
+
+// static
+bool PcmCache::isCacheableFileType(const QString& fileType) {
+    return kCacheableFileTypes.contains(fileType, Qt::CaseInsensitive);
+}
+
+// static
+QString PcmCache::cacheFilePath(
+        const FileInfo& fileInfo,
+        const AudioSource::OpenParams& params) {
+    DEBUG_ASSERT(isEnabled());
+    // The key changes whenever the file is modified and stale cache files
+    // will eventually be evicted.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.canonicalLocation().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.sizeInBytes()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    if (params.getSignalInfo().getSampleRate().isValid()) {
+        hash.addData(QByteArray::number(params.getSignalInfo().getSampleRate().value()));
+    }
+#ifdef __STEM__
+    hash.addData(QByteArray::number(static_cast<int>(params.stemMask())));
+#endif
+    return QDir(s_directoryPath)
+            .filePath(QString::fromLatin1(hash.result().toHex()) + kFileSuffix);
+}
+
+// static
+AudioSourcePointer PcmCache::openAudioSource(
+        const FileInfo& fileInfo,
+        const QUrl& url,
+        const AudioSource::OpenParams& params) {
+    if (!isEnabled() || !fileInfo.exists()) {
+        return nullptr;
+    }
+    const QString filePath = cacheFilePath(fileInfo, params);
+    QFile file(filePath);
+    if (!file.exists()) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<AudioSourcePcmCache>(url, filePath);
+    if (pAudioSource->open(AudioSource::OpenMode::Strict, params) !=
+            AudioSource::OpenResult::Succeeded) {
+        return nullptr;
+    }
+    // Mark as recently used. Failing to do so is not critical.
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(),
+                QFileDevice::FileModificationTime);
+    }
+    kLogger.debug()
+            << "Reading decoded audio data of"
+            << fileInfo.location()
+            << "from"
+            << filePath;
+    return pAudioSource;
+}
+
+// static
+void PcmCache::evictLeastRecentlyUsed() {
+    const auto locker = QMutexLocker(&s_evictionMutex);
+    // Sorted by modification time, newest first
+    const QFileInfoList fileInfos = QDir(s_directoryPath)
+                                            .entryInfoList(
+                                                    QStringList{QStringLiteral("*") +
+                                                            kFileSuffix},
+                                                    QDir::Files,
+                                                    QDir::Time);
+    qint64 totalSize = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+        if (totalSize > s_maxSizeInBytes) {
+            kLogger.debug()
+                    << "Evicting"
+                    << fileInfo.fileName();
+            QFile::remove(fileInfo.filePath());
+        }
+    }
+}
+
+// static
+std::unique_ptr<PcmCache::Writer> PcmCache::Writer::create(
+        const FileInfo& fileInfo,
+        const QString& fileType,
+        const AudioSource::OpenParams& params,
+        const AudioSource& audioSource) {
+    if (!isEnabled() || !isCacheableFileType(fileType) || !fileInfo.exists()) {
+        return nullptr;
+    }
+    const QString filePath = cacheFilePath(fileInfo, params);
+    if (QFile::exists(filePath)) {
+        return nullptr;
+    }
+    auto pWriter = std::unique_ptr<Writer>(new Writer(filePath, audioSource));
+    if (pWriter->m_aborted) {
+        return nullptr;
+    }
+    return pWriter;
+}
+
+PcmCache::Writer::Writer(
+        const QString& filePath,
+        const AudioSource& audioSource)
+        : m_filePath(filePath),
+          m_file(QDir(s_directoryPath)
+                          .filePath(QStringLiteral("XXXXXX") + kTempFileSuffix)),
+          m_signalInfo(audioSource.getSignalInfo()),
+          m_bitrate(audioSource.getBitrate()),
+          m_firstFrameIndex(audioSource.frameIndexMin()),
+          m_nextFrameIndex(m_firstFrameIndex),
+          m_aborted(false) {
+    m_file.setAutoRemove(true);
+    if (!m_file.open()) {
+        kLogger.warning()
+                << "Failed to create cache file"
+                << m_file.fileName()
+                << m_file.errorString();
+        m_aborted = true;
+        return;
+    }
+    // Placeholder, rewritten with the actual length when committing
+    const auto header = PcmCacheFileHeader::create(
+            m_signalInfo, m_bitrate, IndexRange());
+    if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) !=
+            sizeof(header)) {
+        abort();
+    }
+}
+
+PcmCache::Writer::~Writer() {
+    // An uncommitted temporary file is removed automatically
+    m_file.close();
+}
+
+void PcmCache::Writer::abort() {
+    if (m_aborted) {
+        return;
+    }
+    kLogger.debug()
+            << "Discarding cache file"
+            << m_file.fileName();
+    m_aborted = true;
+    m_file.close();
+    m_file.remove();
+}
+
+void PcmCache::Writer::write(const ReadableSampleFrames& sampleFrames) {
+    if (m_aborted || sampleFrames.frameIndexRange().empty()) {
+        return;
+    }
+    if (sampleFrames.frameIndexRange().start() != m_nextFrameIndex) {
+        // Missing frames, e.g. because the file is corrupt
+        abort();
+        return;
+    }
+    const qint64 byteCount = sampleFrames.readableLength() * sizeof(CSAMPLE);
+    if (m_file.write(reinterpret_cast<const char*>(sampleFrames.readableData()),
+                byteCount) != byteCount) {
+        kLogger.warning()
+                << "Failed to write cache file"
+                << m_file.fileName()
+                << m_file.errorString();
+        abort();
+        return;
+    }
+    m_nextFrameIndex = sampleFrames.frameIndexRange().end();
+}
+
+bool PcmCache::Writer::commit(IndexRange frameIndexRange) {
+    if (m_aborted) {
+        return false;
+    }
+    if (frameIndexRange.empty() ||
+            frameIndexRange != IndexRange::between(m_firstFrameIndex, m_nextFrameIndex)) {
+        abort();
+        return false;
+    }
+    const auto header = PcmCacheFileHeader::create(
+            m_signalInfo, m_bitrate, frameIndexRange);
+    if (!m_file.seek(0) ||
+            m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) !=
+                    sizeof(header) ||
+            !m_file.flush()) {
+        abort();
+        return false;
+    }
+    // Fails if another writer has committed the same file in the meantime
+    if (!m_file.rename(m_filePath)) {
+        abort();
+        return false;
+    }
+    m_file.setAutoRemove(false);
+    m_file.close();
+    kLogger.debug()
+            << "Committed cache file"
+            << m_filePath;
+    evictLeastRecentlyUsed();
+    return true;
+}
+
+} // namespace mixxx
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QTemporaryFile>
+#include <QString>
+#include <memory>
+
+#include "sources/audiosource.h"
+
+namespace mixxx {
+
+class FileInfo;
+
+/// An optional on-disk cache with the decoded PCM audio data of files,
+/// that are expensive to decode like MP3, AAC or Opus.
+///
+/// Cache files are filled while analyzing a track, i.e. while the whole
+/// file is decoded anyway. Subsequent loads (and analyses) open the cache
+/// file instead of the original file and read the samples from a memory
+/// mapping without decoding.
+///
+/// The cache is identified by the location, size and modification time of
+/// the original file. Stale entries are never read and eventually evicted.
+/// The total size of the cache is limited, the least recently used entries
+/// are evicted first.
+class PcmCache {
+  public:
+    /// Enables the cache. Not thread-safe, must be called only once upon
+    /// startup before opening any audio sources.
+    static void initialize(const QString& directoryPath, qint64 maxSizeInBytes);
+
+    static bool isEnabled() {
+        return !s_directoryPath.isEmpty();
+    }
+
+    /// Only compressed file types benefit from caching
+    static bool isCacheableFileType(const QString& fileType);
+
+    /// Opens the cached audio data for a file. Returns nullptr on a cache
+    /// miss or if the cached data doesn't match the requested parameters.
+    static AudioSourcePointer openAudioSource(
+            const FileInfo& fileInfo,
+            const QUrl& url,
+            const AudioSource::OpenParams& params);
+
+    /// Writes the decoded audio data of a file into the cache. The frames
+    /// must be written in order from the first to the last frame. The cache
+    /// file is only added to the cache after it has been committed, any
+    /// other outcome discards it.
+    class Writer {
+      public:
+        /// Returns nullptr if the cache is disabled, the file type is not
+        /// cacheable or if the file is already cached.
+        static std::unique_ptr<Writer> create(
+                const FileInfo& fileInfo,
+                const QString& fileType,
+                const AudioSource::OpenParams& params,
+                const AudioSource& audioSource);
+
+        ~Writer();
+
+        /// Appends the next sample frames. Writing is aborted if frames are
+        /// missing or on any I/O error.
+        void write(const ReadableSampleFrames& sampleFrames);
+
+        /// Finishes the cache file if all frames in the given range
+        /// have been written.
+        bool commit(IndexRange frameIndexRange);
+
+      private:
+        Writer(const QString& filePath,
+                const AudioSource& audioSource);
+
+        void abort();
+
+        const QString m_filePath;
+        QTemporaryFile m_file;
+        const audio::SignalInfo m_signalInfo;
+        const audio::Bitrate m_bitrate;
+        const SINT m_firstFrameIndex;
+        SINT m_nextFrameIndex;
+        bool m_aborted;
+    };
+
+  private:
+    static QString cacheFilePath(
+            const FileInfo& fileInfo,
+            const AudioSource::OpenParams& params);
+
+    /// Deletes the least recently used files until the total size is below
+    /// the limit.
+    static void evictLeastRecentlyUsed();
+
+    static QString s_directoryPath;
+    static qint64 s_maxSizeInBytes;
+};
+
+} // namespace mixxx
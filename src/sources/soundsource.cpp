@@ -13,9 +13,9 @@ namespace {
 
 const Logger kLogger("SoundSource");
 
-inline QUrl validateLocalFileUrl(QUrl url) {
+inline QUrl validateUrl(QUrl url) {
     DEBUG_ASSERT(url.isValid());
-    VERIFY_OR_DEBUG_ASSERT(url.isLocalFile()) {
+    VERIFY_OR_DEBUG_ASSERT(url.isLocalFile() || SoundSource::isRemoteUrl(url)) {
         kLogger.warning()
                 << "Unsupported URL:"
                 << url.toString();
@@ -25,9 +25,19 @@ inline QUrl validateLocalFileUrl(QUrl url) {
 
 } // anonymous namespace
 
+//static
+bool SoundSource::isRemoteUrl(const QUrl& url) {
+    return url.scheme() == QLatin1String("http") ||
+            url.scheme() == QLatin1String("https");
+}
+
 //static
 QString SoundSource::getTypeFromUrl(const QUrl& url) {
-    const QString filePath = validateLocalFileUrl(url).toLocalFile();
+    if (isRemoteUrl(url)) {
+        // The content is not available for detecting the MIME type
+        return QFileInfo(url.path()).suffix().toLower().trimmed();
+    }
+    const QString filePath = validateUrl(url).toLocalFile();
     return getTypeFromFile(QFileInfo(filePath));
 }
 
@@ -98,8 +108,9 @@ QString SoundSource::getTypeFromFile(const QFileInfo& fileInfo) {
 }
 
 SoundSource::SoundSource(const QUrl& url, const QString& type)
-        : AudioSource(validateLocalFileUrl(url)),
-          MetadataSourceTagLib(getLocalFileName(), type),
+        : AudioSource(validateUrl(url)),
+          // Metadata of remote files is not available
+          MetadataSourceTagLib(isLocalFile() ? getLocalFileName() : QString(), type),
           m_type(type) {
 }
 
@@ -15,9 +15,13 @@ class SoundSource
   public:
     /// Determine the type from an URL.
     ///
-    /// Only local file URLs are supported.
+    /// Only local file and HTTP(S) URLs are supported. The type of remote
+    /// files is determined by the suffix of the path.
     static QString getTypeFromUrl(const QUrl& url);
 
+    /// Remote files are read through HTTP(S), see SoundSourceHttp.
+    static bool isRemoteUrl(const QUrl& url);
+
     /// Determine the type from a (local) file.
     static QString getTypeFromFile(const QFileInfo& fileInfo);
 
@@ -9,6 +9,14 @@ extern "C" {
 
 } // extern "C"
 
+#include <QMutex>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <utility>
+
+#include "util/compatibility/qmutex.h"
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -53,6 +61,10 @@ constexpr int64_t kavStreamDecoderFrameDelayAAC = 2112;
 
 constexpr SINT kMaxSamplesPerMP3Frame = 1152;
 
+// Multiple files are usually decoded at the same time by the decks and
+// the analyzers, so only a few threads are used for each of them.
+constexpr int kMaxDecodingThreadCount = 4;
+
 const Logger kLogger("SoundSourceFFmpeg");
 
 int64_t getStreamStartTime(const AVStream& avStream) {
@@ -139,8 +151,149 @@ inline void avTrace(const QString& preamble, const AVFrame& avFrame) {
 }
 #endif // VERBOSE_DEBUG_LOG
 
+// Codecs that can continue decoding a different stream after
+// avcodec_flush_buffers(), as long as the codec parameters of
+// the new stream are identical. The extradata of FLAC and ALAC
+// streams contains properties of the individual file, e.g. the
+// MD5 checksum, and never matches.
+bool isCodecContextReusable(AVCodecID codecId) {
+    switch (codecId) {
+    case AV_CODEC_ID_AAC:
+    case AV_CODEC_ID_MP3:
+    case AV_CODEC_ID_OPUS:
+    case AV_CODEC_ID_VORBIS:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isSameDecoderConfiguration(
+        const AVCodecParameters& lhs,
+        const AVCodecParameters& rhs) {
+    return lhs.codec_id == rhs.codec_id &&
+            lhs.format == rhs.format &&
+            lhs.sample_rate == rhs.sample_rate &&
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
+            av_channel_layout_compare(&lhs.ch_layout, &rhs.ch_layout) == 0 &&
+#else
+            lhs.channels == rhs.channels &&
+            lhs.channel_layout == rhs.channel_layout &&
+#endif
+            lhs.block_align == rhs.block_align &&
+            lhs.bits_per_coded_sample == rhs.bits_per_coded_sample &&
+            lhs.frame_size == rhs.frame_size &&
+            lhs.extradata_size == rhs.extradata_size &&
+            (lhs.extradata_size == 0 ||
+                    std::memcmp(lhs.extradata, rhs.extradata, lhs.extradata_size) == 0);
+}
+
 } // anonymous namespace
 
+/// The decoding resources of a closed SoundSourceFFmpeg.
+///
+/// The codec context is only reused if the next stream has the same
+/// codec parameters. This is common when previewing tracks that have
+/// been encoded with the same settings and avoids to initialize the
+/// decoder, including its threads. All other resources are reused
+/// independent of the codec.
+struct SoundSourceFFmpeg::PooledDecoderContext {
+    PooledDecoderContext() = default;
+    PooledDecoderContext(PooledDecoderContext&& that)
+            : pavCodecParameters(std::exchange(that.pavCodecParameters, nullptr)),
+              requestedChannelCount(that.requestedChannelCount),
+              pavCodecContext(std::exchange(that.pavCodecContext, nullptr)),
+              pavDecodedFrame(std::exchange(that.pavDecodedFrame, nullptr)),
+              pavResampledFrame(std::exchange(that.pavResampledFrame, nullptr)),
+              pSwrContext(std::exchange(that.pSwrContext, nullptr)),
+              frameBuffer(std::move(that.frameBuffer)) {
+    }
+    PooledDecoderContext(const PooledDecoderContext&) = delete;
+    PooledDecoderContext& operator=(PooledDecoderContext&&) = delete;
+    PooledDecoderContext& operator=(const PooledDecoderContext&) = delete;
+    ~PooledDecoderContext() {
+        freeCodecContext();
+        av_frame_free(&pavDecodedFrame);
+        av_frame_free(&pavResampledFrame);
+        swr_free(&pSwrContext);
+    }
+
+    void freeCodecContext() {
+        avcodec_parameters_free(&pavCodecParameters);
+        avcodec_free_context(&pavCodecContext);
+    }
+
+    // The parameters of the stream that the codec context has been
+    // opened for
+    AVCodecParameters* pavCodecParameters = nullptr;
+    int requestedChannelCount = 0;
+    AVCodecContext* pavCodecContext = nullptr;
+    AVFrame* pavDecodedFrame = nullptr;
+    AVFrame* pavResampledFrame = nullptr;
+    SwrContext* pSwrContext = nullptr;
+    ReadAheadFrameBuffer frameBuffer;
+};
+
+namespace {
+
+// Enough for all decks and preview decks that are loaded in
+// short succession
+constexpr std::size_t kMaxPooledDecoderContexts = 8;
+
+} // anonymous namespace
+
+class SoundSourceFFmpeg::DecoderContextPool final {
+  public:
+    /// Prefers a context with a codec context that can be reused
+    /// for the given stream. Otherwise the codec context of the most
+    /// recently released context is freed.
+    PooledDecoderContext acquire(
+            const AVCodecParameters& avCodecParameters,
+            int requestedChannelCount) {
+        const auto locked = lockMutex(&m_mutex);
+        if (m_contexts.empty()) {
+            return PooledDecoderContext();
+        }
+        auto it = std::find_if(m_contexts.begin(),
+                m_contexts.end(),
+                [&](const PooledDecoderContext& context) {
+                    return context.pavCodecContext &&
+                            context.requestedChannelCount == requestedChannelCount &&
+                            isSameDecoderConfiguration(
+                                    *context.pavCodecParameters, avCodecParameters);
+                });
+        const bool codecContextReusable = it != m_contexts.end();
+        if (!codecContextReusable) {
+            it = m_contexts.begin();
+        }
+        PooledDecoderContext context(std::move(*it));
+        m_contexts.erase(it);
+        if (!codecContextReusable) {
+            context.freeCodecContext();
+        }
+        return context;
+    }
+
+    void release(PooledDecoderContext context) {
+        const auto locked = lockMutex(&m_mutex);
+        m_contexts.push_front(std::move(context));
+        if (m_contexts.size() > kMaxPooledDecoderContexts) {
+            m_contexts.pop_back();
+        }
+    }
+
+  private:
+    QMutex m_mutex;
+    // Most recently released first
+    std::deque<PooledDecoderContext> m_contexts;
+};
+
+//static
+SoundSourceFFmpeg::DecoderContextPool& SoundSourceFFmpeg::decoderContextPool() {
+    static DecoderContextPool s_pool;
+    return s_pool;
+}
+
 // FFmpeg API Changes:
 // https://github.com/FFmpeg/FFmpeg/blob/master/doc/APIchanges
 
@@ -301,6 +454,10 @@ AVFormatContext* SoundSourceFFmpeg::openInputFile(
     return pavInputFormatContext;
 }
 
+AVFormatContext* SoundSourceFFmpeg::openInput() {
+    return openInputFile(getLocalFileName());
+}
+
 void SoundSourceFFmpeg::InputAVFormatContextPtr::take(
         AVFormatContext** ppavInputFormatContext) {
     DEBUG_ASSERT(ppavInputFormatContext != nullptr);
@@ -481,9 +638,84 @@ QString SoundSourceProviderFFmpeg::getVersionString() const {
     return QString::fromUtf8(av_version_info());
 }
 
+namespace {
+
+std::optional<audio::StreamInfo> probeStreamInfoFromHeaders(
+        const AVFormatContext& avInputFormatContext) {
+    // Without avformat_find_stream_info() only the properties that have
+    // been read from the container headers are available. These are not
+    // modified by avformat_find_stream_info() when opening the file later,
+    // which only completes the missing properties by decoding the first
+    // packets.
+    const AVStream* pavStream = nullptr;
+    for (unsigned int i = 0; i < avInputFormatContext.nb_streams; ++i) {
+        const AVStream* pavCandidateStream = avInputFormatContext.streams[i];
+        if (pavCandidateStream->codecpar->codec_type != AVMEDIA_TYPE_AUDIO) {
+            continue;
+        }
+        if (pavStream) {
+            // The best stream is selected depending on the packets that
+            // have been decoded for probing
+            return std::nullopt;
+        }
+        pavStream = pavCandidateStream;
+    }
+    if (!pavStream ||
+            !avcodec_find_decoder(pavStream->codecpar->codec_id) ||
+            pavStream->start_time == AV_NOPTS_VALUE ||
+            pavStream->duration == AV_NOPTS_VALUE ||
+            pavStream->start_time > pavStream->duration) {
+        return std::nullopt;
+    }
+    switch (pavStream->codecpar->codec_id) {
+    case AV_CODEC_ID_AAC:
+    case AV_CODEC_ID_AAC_LATM:
+        // The decoder doubles the sample rate of HE-AAC streams with
+        // implicitly signaled SBR that is reported by the container
+        if (pavStream->codecpar->sample_rate <= 24000) {
+            return std::nullopt;
+        }
+        break;
+    default:
+        break;
+    }
+    const auto signalInfo = audio::SignalInfo(
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
+            audio::ChannelCount(pavStream->codecpar->ch_layout.nb_channels),
+#else
+            audio::ChannelCount(pavStream->codecpar->channels),
+#endif
+            audio::SampleRate(pavStream->codecpar->sample_rate));
+    if (!signalInfo.isValid()) {
+        return std::nullopt;
+    }
+    const auto frameLength =
+            SoundSourceFFmpeg::getStreamFrameIndexRange(*pavStream).length();
+    return audio::StreamInfo(
+            signalInfo,
+            audio::Bitrate(pavStream->codecpar->bit_rate / 1000), // kbps
+            Duration::fromSeconds(signalInfo.frames2secs(frameLength)));
+}
+
+} // anonymous namespace
+
+std::optional<audio::StreamInfo> SoundSourceProviderFFmpeg::probeStreamInfo(
+        const QUrl& url) const {
+    AVFormatContext* pavInputFormatContext =
+            SoundSourceFFmpeg::openInputFile(url.toLocalFile());
+    if (!pavInputFormatContext) {
+        return std::nullopt;
+    }
+    const auto streamInfo = probeStreamInfoFromHeaders(*pavInputFormatContext);
+    avformat_close_input(&pavInputFormatContext);
+    return streamInfo;
+}
+
 SoundSourceFFmpeg::SoundSourceFFmpeg(const QUrl& url)
         : SoundSource(url),
           m_pavStream(nullptr),
+          m_pavCodecParameters(nullptr),
+          m_requestedChannelCount(0),
           m_pavDecodedFrame(nullptr),
           m_seekPrerollFrameCount(0),
           m_pavPacket(av_packet_alloc()),
@@ -498,6 +730,7 @@ SoundSourceFFmpeg::SoundSourceFFmpeg(const QUrl& url)
 
 SoundSourceFFmpeg::~SoundSourceFFmpeg() {
     close();
+    avcodec_parameters_free(&m_pavCodecParameters);
     av_packet_free(&m_pavPacket);
     DEBUG_ASSERT(!m_pavPacket);
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
@@ -511,12 +744,11 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
         const OpenParams& params) {
     // Open input
     {
-        AVFormatContext* pavInputFormatContext =
-                openInputFile(getLocalFileName());
+        AVFormatContext* pavInputFormatContext = openInput();
         if (pavInputFormatContext == nullptr) {
             kLogger.warning()
-                    << "Failed to open input file"
-                    << getLocalFileName();
+                    << "Failed to open input"
+                    << getUrl().toString();
             return OpenResult::Failed;
         }
         m_pavInputFormatContext.take(&pavInputFormatContext);
@@ -583,30 +815,12 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
     DEBUG_ASSERT(pavStream != nullptr);
     DEBUG_ASSERT(pavStream->index == av_find_best_stream_result);
 
-    // Allocate decoding context
-    AVCodecContextPtr pavCodecContext = AVCodecContextPtr::alloc(pDecoder);
-    if (!pavCodecContext) {
-        return SoundSource::OpenResult::Aborted;
-    }
-
-    // Configure decoding context
-    const int avcodec_parameters_to_context_result =
-            avcodec_parameters_to_context(pavCodecContext, pavStream->codecpar);
-    if (avcodec_parameters_to_context_result != 0) {
-        DEBUG_ASSERT(avcodec_parameters_to_context_result < 0);
-        kLogger.warning().noquote()
-                << "avcodec_parameters_to_context() failed:"
-                << formatErrorString(avcodec_parameters_to_context_result);
-        return SoundSource::OpenResult::Aborted;
-    }
-
-    // Request output format
-    pavCodecContext->request_sample_fmt = s_avSampleFormat;
+    // A dedicated number of channels for the output signal might
+    // have been requested. This is forwarded to FFmpeg to avoid
+    // manual resampling or post-processing after decoding.
+    int requestedChannelCount = 0;
     if (params.getSignalInfo().getChannelCount().isValid()) {
-        // A dedicated number of channels for the output signal
-        // has been requested. Forward this to FFmpeg to avoid
-        // manual resampling or post-processing after decoding.
-        const int requestChannels = std::min(
+        requestedChannelCount = std::min(
                 static_cast<int>(params.getSignalInfo().getChannelCount()),
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
                 pavStream->codecpar->ch_layout.nb_channels
@@ -614,23 +828,76 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
                 av_get_channel_layout_nb_channels(pavStream->codecpar->channel_layout)
 #endif
         );
+    }
+
+    PooledDecoderContext pooledContext = decoderContextPool().acquire(
+            *pavStream->codecpar, requestedChannelCount);
+    if (pooledContext.pavCodecContext) {
+        // Discard the state of the previously decoded stream
+        avcodec_flush_buffers(pooledContext.pavCodecContext);
+        kLogger.debug()
+                << "Reusing decoding context for codec"
+                << pDecoder->name;
+        m_pavCodecContext.take(&pooledContext.pavCodecContext);
+        std::swap(m_pavCodecParameters, pooledContext.pavCodecParameters);
+    } else {
+        // Allocate decoding context
+        AVCodecContextPtr pavCodecContext = AVCodecContextPtr::alloc(pDecoder);
+        if (!pavCodecContext) {
+            return SoundSource::OpenResult::Aborted;
+        }
+
+        // Configure decoding context
+        const int avcodec_parameters_to_context_result =
+                avcodec_parameters_to_context(pavCodecContext, pavStream->codecpar);
+        if (avcodec_parameters_to_context_result != 0) {
+            DEBUG_ASSERT(avcodec_parameters_to_context_result < 0);
+            kLogger.warning().noquote()
+                    << "avcodec_parameters_to_context() failed:"
+                    << formatErrorString(avcodec_parameters_to_context_result);
+            return SoundSource::OpenResult::Aborted;
+        }
+
+        // Request output format
+        pavCodecContext->request_sample_fmt = s_avSampleFormat;
+        if (requestedChannelCount > 0) {
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
-        av_channel_layout_default(&pavCodecContext->ch_layout,
-                requestChannels);
+            av_channel_layout_default(&pavCodecContext->ch_layout,
+                    requestedChannelCount);
 #else
-        pavCodecContext->request_channel_layout =
-                av_get_default_channel_layout(requestChannels);
+            pavCodecContext->request_channel_layout =
+                    av_get_default_channel_layout(requestedChannelCount);
 #endif
-    }
+        }
 
-    // Open decoding context
-    if (!openDecodingContext(pavCodecContext)) {
-        // early exit on any error
-        return SoundSource::OpenResult::Failed;
+        // Decode multiple frames or slices in parallel if supported by the
+        // codec, e.g. for FLAC and ALAC. FFmpeg decodes on the calling thread
+        // by default.
+        if (pDecoder->capabilities &
+                (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS)) {
+            pavCodecContext->thread_count = std::min(
+                    QThread::idealThreadCount(), kMaxDecodingThreadCount);
+            pavCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+        }
+
+        // Open decoding context
+        if (!openDecodingContext(pavCodecContext)) {
+            // early exit on any error
+            return SoundSource::OpenResult::Failed;
+        }
+        m_pavCodecContext = std::move(pavCodecContext);
+        if (!m_pavCodecParameters) {
+            m_pavCodecParameters = avcodec_parameters_alloc();
+        }
+        if (!m_pavCodecParameters ||
+                avcodec_parameters_copy(m_pavCodecParameters, pavStream->codecpar) < 0) {
+            // The codec context will not be reused
+            avcodec_parameters_free(&m_pavCodecParameters);
+        }
     }
+    m_requestedChannelCount = requestedChannelCount;
 
     // Initialize members
-    m_pavCodecContext = std::move(pavCodecContext);
     m_pavStream = pavStream;
 
     if (kLogger.debugEnabled()) {
@@ -672,7 +939,7 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
 
     audio::ChannelCount channelCount;
     audio::SampleRate sampleRate;
-    if (!initResampling(&channelCount, &sampleRate)) {
+    if (!initResampling(&channelCount, &sampleRate, &pooledContext)) {
         return OpenResult::Failed;
     }
     if (!initChannelCountOnce(channelCount)) {
@@ -729,7 +996,11 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
     }
 
     DEBUG_ASSERT(!m_pavDecodedFrame);
-    m_pavDecodedFrame = av_frame_alloc();
+    if (pooledContext.pavDecodedFrame) {
+        m_pavDecodedFrame = std::exchange(pooledContext.pavDecodedFrame, nullptr);
+    } else {
+        m_pavDecodedFrame = av_frame_alloc();
+    }
 
     // FFmpeg does not provide sample-accurate decoding after random seeks
     // in the stream out of the box. Depending on the actual codec we need
@@ -739,19 +1010,30 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
     kLogger.debug() << "Seek preroll frame count:" << m_seekPrerollFrameCount;
 #endif
 
-    m_frameBuffer = ReadAheadFrameBuffer(
-            getSignalInfo(),
-            frameBufferCapacityForStream(*m_pavStream));
+    const auto frameBufferCapacity = frameBufferCapacityForStream(*m_pavStream);
+    if (pooledContext.frameBuffer.signalInfo() == getSignalInfo() &&
+            pooledContext.frameBuffer.capacity() >= frameBufferCapacity) {
+        // Avoid to allocate a large sample buffer
+        m_frameBuffer = std::move(pooledContext.frameBuffer);
+        m_frameBuffer.reset();
+    } else {
+        m_frameBuffer = ReadAheadFrameBuffer(
+                getSignalInfo(),
+                frameBufferCapacity);
+    }
 #if VERBOSE_DEBUG_LOG
     kLogger.debug() << "Frame buffer capacity:" << m_frameBuffer.capacity();
 #endif
 
+    // All resources of the pooled context that have not been
+    // reused are freed now
     return OpenResult::Succeeded;
 }
 
 bool SoundSourceFFmpeg::initResampling(
         audio::ChannelCount* pResampledChannelCount,
-        audio::SampleRate* pResampledSampleRate) {
+        audio::SampleRate* pResampledSampleRate,
+        PooledDecoderContext* pPooledContext) {
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
     AVChannelLayout avStreamChannelLayout;
     initChannelLayoutFromStream(&avStreamChannelLayout, *m_pavStream);
@@ -791,6 +1073,13 @@ bool SoundSourceFFmpeg::initResampling(
     const auto streamSampleRate =
             audio::SampleRate(m_pavStream->codecpar->sample_rate);
     const auto resampledSampleRate = streamSampleRate;
+    // Planar and interleaved samples of a single channel have the
+    // same memory layout and don't need to be converted.
+    const bool isStreamSampleFormatReadable =
+            avStreamSampleFormat == avResampledSampleFormat ||
+            (resampledChannelCount == 1 &&
+                    av_get_packed_sample_fmt(avStreamSampleFormat) ==
+                            avResampledSampleFormat);
     if (
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
             av_channel_layout_compare(&avResampledChannelLayout, &avStreamChannelLayout) != 0 ||
@@ -798,7 +1087,7 @@ bool SoundSourceFFmpeg::initResampling(
             (resampledChannelCount != streamChannelCount) ||
             (avResampledChannelLayout != avStreamChannelLayout) ||
 #endif
-            (avResampledSampleFormat != avStreamSampleFormat)) {
+            !isStreamSampleFormatReadable) {
 #if VERBOSE_DEBUG_LOG
         kLogger.debug()
                 << "Decoded stream needs to be resampled"
@@ -810,8 +1099,11 @@ bool SoundSourceFFmpeg::initResampling(
 #endif
                 << "| sample format =" << av_get_sample_fmt_name(avResampledSampleFormat);
 #endif
+        // An existing context is reconfigured instead of allocating a new one
+        SwrContext* pSwrContext = pPooledContext
+                ? std::exchange(pPooledContext->pSwrContext, nullptr)
+                : nullptr;
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
-        SwrContext* pSwrContext = nullptr;
         if (swr_alloc_set_opts2(
                     &pSwrContext,
                     &avResampledChannelLayout,
@@ -832,7 +1124,7 @@ bool SoundSourceFFmpeg::initResampling(
         m_pSwrContext = SwrContextPtr(pSwrContext);
 #else
         m_pSwrContext = SwrContextPtr(swr_alloc_set_opts(
-                nullptr,
+                pSwrContext,
                 avResampledChannelLayout,
                 avResampledSampleFormat,
                 resampledSampleRate,
@@ -860,7 +1152,11 @@ bool SoundSourceFFmpeg::initResampling(
             return false;
         }
         DEBUG_ASSERT(!m_pavResampledFrame);
-        m_pavResampledFrame = av_frame_alloc();
+        if (pPooledContext && pPooledContext->pavResampledFrame) {
+            m_pavResampledFrame = std::exchange(pPooledContext->pavResampledFrame, nullptr);
+        } else {
+            m_pavResampledFrame = av_frame_alloc();
+        }
     }
     // Finish initialization
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
@@ -881,16 +1177,43 @@ bool SoundSourceFFmpeg::initResampling(
 }
 
 void SoundSourceFFmpeg::close() {
-    av_frame_free(&m_pavResampledFrame);
+    releaseDecoderContext();
     DEBUG_ASSERT(!m_pavResampledFrame);
-    av_frame_free(&m_pavDecodedFrame);
     DEBUG_ASSERT(!m_pavDecodedFrame);
-    m_pSwrContext.close();
-    m_pavCodecContext.close();
+    DEBUG_ASSERT(!m_pSwrContext);
+    DEBUG_ASSERT(!m_pavCodecContext);
     m_pavInputFormatContext.close();
     m_pavStream = nullptr;
 }
 
+void SoundSourceFFmpeg::releaseDecoderContext() {
+    if (!m_pavCodecContext && !m_pavDecodedFrame) {
+        // Not opened or already released
+        return;
+    }
+    PooledDecoderContext context;
+    if (m_pavCodecContext &&
+            m_pavCodecParameters &&
+            isCodecContextReusable(m_pavCodecParameters->codec_id)) {
+        context.pavCodecContext = m_pavCodecContext.release();
+        context.pavCodecParameters = std::exchange(m_pavCodecParameters, nullptr);
+        context.requestedChannelCount = m_requestedChannelCount;
+    } else {
+        m_pavCodecContext.close();
+    }
+    if (m_pavDecodedFrame) {
+        av_frame_unref(m_pavDecodedFrame);
+        context.pavDecodedFrame = std::exchange(m_pavDecodedFrame, nullptr);
+    }
+    if (m_pavResampledFrame) {
+        av_frame_unref(m_pavResampledFrame);
+        context.pavResampledFrame = std::exchange(m_pavResampledFrame, nullptr);
+    }
+    context.pSwrContext = m_pSwrContext.release();
+    context.frameBuffer = std::exchange(m_frameBuffer, ReadAheadFrameBuffer());
+    decoderContextPool().release(std::move(context));
+}
+
 namespace {
 SINT readNextPacket(
         AVFormatContext* pavFormatContext,
@@ -1095,6 +1418,28 @@ const CSAMPLE* SoundSourceFFmpeg::resampleDecodedAVFrame() {
     }
 }
 
+bool SoundSourceFFmpeg::resampleDecodedAVFrameInto(CSAMPLE* pOutputSampleBuffer) {
+    DEBUG_ASSERT(m_pSwrContext);
+    DEBUG_ASSERT(pOutputSampleBuffer);
+    // The sample rate is not converted and all samples are available
+    // immediately without any delay
+    auto* pOutputData = reinterpret_cast<uint8_t*>(pOutputSampleBuffer);
+    const auto swr_convert_result = swr_convert(m_pSwrContext,
+            &pOutputData,
+            m_pavDecodedFrame->nb_samples,
+            const_cast<const uint8_t**>(m_pavDecodedFrame->extended_data),
+            m_pavDecodedFrame->nb_samples);
+    if (swr_convert_result != m_pavDecodedFrame->nb_samples) {
+        kLogger.warning().noquote()
+                << "swr_convert() failed:"
+                << (swr_convert_result < 0
+                                   ? formatErrorString(swr_convert_result)
+                                   : QString::number(swr_convert_result));
+        return false;
+    }
+    return true;
+}
+
 ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
         const WritableSampleFrames& originalWritableSampleFrames) {
     DEBUG_ASSERT(m_frameBuffer.signalInfo() == getSignalInfo());
@@ -1261,6 +1606,28 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
                     << "decodedFrameRange" << decodedFrameRange;
 #endif
 
+            if (m_pSwrContext && pOutputSampleBuffer &&
+                    m_frameBuffer.isReady() &&
+                    m_frameBuffer.isEmpty() &&
+                    decodedFrameRange.start() == m_frameBuffer.writeIndex() &&
+                    decodedFrameRange.start() == writableFrameRange.start() &&
+                    decodedFrameRange.isSubrangeOf(writableFrameRange) &&
+                    decodedFrameRange.isSubrangeOf(frameIndexRange())) {
+                // The whole decoded frame is consumed by the output buffer
+                if (!resampleDecodedAVFrameInto(pOutputSampleBuffer)) {
+                    // Invalidate current position and abort reading after unrecoverable error
+                    m_frameBuffer.invalidate();
+                    av_frame_unref(m_pavDecodedFrame);
+                    break;
+                }
+                pOutputSampleBuffer +=
+                        getSignalInfo().frames2samples(decodedFrameRange.length());
+                writableFrameRange.shrinkFront(decodedFrameRange.length());
+                m_frameBuffer.reset(decodedFrameRange.end());
+                av_frame_unref(m_pavDecodedFrame);
+                continue;
+            }
+
             const CSAMPLE* pDecodedSampleData = resampleDecodedAVFrame();
             if (!pDecodedSampleData) {
                 // Invalidate current position and abort reading after unrecoverable error
@@ -8,6 +8,8 @@ extern "C" {
 
 } // extern "C"
 
+#include <utility>
+
 #include "sources/readaheadframebuffer.h"
 #include "sources/soundsourceprovider.h"
 
@@ -30,8 +32,21 @@ class SoundSourceFFmpeg : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    /// Opens the input of tryOpen(). The default implementation
+    /// opens the local file.
+    virtual AVFormatContext* openInput();
+
   private:
+    class DecoderContextPool;
+    static DecoderContextPool& decoderContextPool();
+
+    /// Returns the decoding resources to the pool, see close()
+    void releaseDecoderContext();
+
     const CSAMPLE* resampleDecodedAVFrame();
+    // Resamples the decoded frame directly into the output buffer
+    // without an intermediate copy.
+    bool resampleDecodedAVFrameInto(CSAMPLE* pOutputSampleBuffer);
 
     // Seek to the requested start index (if needed) or return false
     // upon seek errors.
@@ -108,6 +123,10 @@ class SoundSourceFFmpeg : public SoundSource {
         void take(AVCodecContext** ppavCodecContext);
         void close();
 
+        AVCodecContext* release() {
+            return std::exchange(m_pavCodecContext, nullptr);
+        }
+
         friend void swap(AVCodecContextPtr& lhs, AVCodecContextPtr& rhs) {
             std::swap(lhs.m_pavCodecContext, rhs.m_pavCodecContext);
         }
@@ -129,9 +148,13 @@ class SoundSourceFFmpeg : public SoundSource {
         AVCodecContext* m_pavCodecContext;
     };
 
+    struct PooledDecoderContext;
+
+    /// Resources of the pooled context are reused if available.
     bool initResampling(
             audio::ChannelCount* pResampledChannelCount,
-            audio::SampleRate* pResampledSampleRate);
+            audio::SampleRate* pResampledSampleRate,
+            PooledDecoderContext* pPooledContext = nullptr);
 
   public:
     // The following static functions are used by children and closely related
@@ -153,6 +176,10 @@ class SoundSourceFFmpeg : public SoundSource {
     InputAVFormatContextPtr m_pavInputFormatContext;
     AVStream* m_pavStream;
     AVCodecContextPtr m_pavCodecContext;
+    // The parameters of the stream that m_pavCodecContext has been
+    // opened for, needed for reusing it after closing the stream
+    AVCodecParameters* m_pavCodecParameters;
+    int m_requestedChannelCount;
     AVFrame* m_pavDecodedFrame;
     FrameCount m_seekPrerollFrameCount;
     ReadAheadFrameBuffer m_frameBuffer;
@@ -179,6 +206,10 @@ class SoundSourceFFmpeg : public SoundSource {
 
         void close();
 
+        SwrContext* release() {
+            return std::exchange(m_pSwrContext, nullptr);
+        }
+
         friend void swap(SwrContextPtr& lhs, SwrContextPtr& rhs) {
             std::swap(lhs.m_pSwrContext, rhs.m_pSwrContext);
         }
@@ -235,6 +266,8 @@ class SoundSourceProviderFFmpeg : public SoundSourceProvider {
         return newSoundSourceFromUrl<SoundSourceFFmpeg>(url);
     }
 
+    std::optional<audio::StreamInfo> probeStreamInfo(const QUrl& url) const override;
+
     QString getVersionString() const;
 };
 
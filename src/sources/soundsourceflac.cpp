@@ -93,6 +93,9 @@ SoundSourceFLAC::SoundSourceFLAC(const QUrl& url)
           m_decoder(nullptr),
           m_maxBlocksize(0),
           m_bitsPerSample(kBitsPerSampleDefault),
+          m_pDirectOutputBuffer(nullptr),
+          m_directOutputFrameCapacity(0),
+          m_directOutputFrameCount(0),
           m_curFrameIndex(0) {
 }
 
@@ -261,11 +264,21 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
         if (m_sampleBuffer.empty()) {
             // Save the current frame index
             const SINT curFrameIndexBeforeProcessing = m_curFrameIndex;
+            // Avoid copying the decoded samples through m_sampleBuffer
+            if (writableSampleFrames.writableData()) {
+                m_pDirectOutputBuffer = writableSampleFrames.writableData(outputSampleOffset);
+                m_directOutputFrameCapacity =
+                        getSignalInfo().samples2frames(numberOfSamplesRemaining);
+            }
+            m_directOutputFrameCount = 0;
             // Documentation of FLAC__stream_decoder_process_single():
             // "Depending on what was decoded, the metadata or write callback
             // will be called with the decoded metadata block or audio frame."
             // See also: https://xiph.org/flac/api/group__flac__stream__decoder.html#ga9d6df4a39892c05955122cf7f987f856
-            if (!FLAC__stream_decoder_process_single(m_decoder)) {
+            const bool processed = FLAC__stream_decoder_process_single(m_decoder);
+            m_pDirectOutputBuffer = nullptr;
+            m_directOutputFrameCapacity = 0;
+            if (!processed) {
                 kLogger.warning()
                         << "Failed to decode FLAC file"
                         << m_file.fileName();
@@ -301,6 +314,16 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                 }
             }
             DEBUG_ASSERT(curFrameIndexBeforeProcessing == m_curFrameIndex);
+            if (m_directOutputFrameCount > 0) {
+                const SINT numberOfSamplesDecoded =
+                        getSignalInfo().frames2samples(m_directOutputFrameCount);
+                DEBUG_ASSERT(numberOfSamplesDecoded <= numberOfSamplesRemaining);
+                outputSampleOffset += numberOfSamplesDecoded;
+                m_curFrameIndex += m_directOutputFrameCount;
+                numberOfSamplesRemaining -= numberOfSamplesDecoded;
+                m_directOutputFrameCount = 0;
+                continue;
+            }
         }
         if (m_sampleBuffer.empty()) {
             break; // EOF
@@ -422,6 +445,41 @@ inline CSAMPLE convertDecodedSample(FLAC__int32 decodedSample, int bitsPerSample
     return upscaledSample * kSampleScaleFactor;
 }
 
+void convertDecodedSamples(
+        CSAMPLE* pSampleBuffer,
+        const FLAC__int32* const buffer[],
+        SINT firstFrame,
+        SINT frameCount,
+        mixxx::audio::ChannelCount channelCount,
+        int bitsPerSample) {
+    const SINT endFrame = firstFrame + frameCount;
+    switch (channelCount) {
+    case 1: {
+        // optimized code for 1 channel (mono)
+        for (SINT i = firstFrame; i < endFrame; ++i) {
+            *pSampleBuffer++ = convertDecodedSample(buffer[0][i], bitsPerSample);
+        }
+        break;
+    }
+    case 2: {
+        // optimized code for 2 channels (stereo)
+        for (SINT i = firstFrame; i < endFrame; ++i) {
+            *pSampleBuffer++ = convertDecodedSample(buffer[0][i], bitsPerSample);
+            *pSampleBuffer++ = convertDecodedSample(buffer[1][i], bitsPerSample);
+        }
+        break;
+    }
+    default: {
+        // generic code for multiple channels
+        for (SINT i = firstFrame; i < endFrame; ++i) {
+            for (SINT j = 0; j < channelCount; ++j) {
+                *pSampleBuffer++ = convertDecodedSample(buffer[j][i], bitsPerSample);
+            }
+        }
+    }
+    }
+}
+
 } // anonymous namespace
 
 FLAC__StreamDecoderWriteStatus SoundSourceFLAC::flacWrite(
@@ -460,50 +518,49 @@ FLAC__StreamDecoderWriteStatus SoundSourceFLAC::flacWrite(
     // According to the API docs the decoder will always report the current
     // position in "FLAC samples" (= "Mixxx frames") for convenience
     DEBUG_ASSERT(frame->header.number_type == FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER);
-    m_curFrameIndex = frame->header.number.sample_number;
+    const SINT frameIndex = frame->header.number.sample_number;
+    // Only decode directly into the output buffer if the frame continues
+    // at the current position. Otherwise the position is adjusted after
+    // decoding by skipping samples from m_sampleBuffer.
+    const SINT numDirectFrames =
+            (m_pDirectOutputBuffer && frameIndex == m_curFrameIndex)
+            ? std::min(numReadableFrames, m_directOutputFrameCapacity)
+            : 0;
+    m_curFrameIndex = frameIndex;
+
+    DEBUG_ASSERT(getSignalInfo().getChannelCount() <= channelCount);
+    convertDecodedSamples(m_pDirectOutputBuffer,
+            buffer,
+            0,
+            numDirectFrames,
+            getSignalInfo().getChannelCount(),
+            m_bitsPerSample);
+    m_directOutputFrameCount = numDirectFrames;
+    if (numDirectFrames == numReadableFrames) {
+        return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
 
     // Decode buffer should be empty before decoding the next frame
     DEBUG_ASSERT(m_sampleBuffer.empty());
     const SampleBuffer::WritableSlice writableSlice(
             m_sampleBuffer.growForWriting(
-                    getSignalInfo().frames2samples(numReadableFrames)));
+                    getSignalInfo().frames2samples(numReadableFrames - numDirectFrames)));
 
     const SINT numWritableFrames =
             getSignalInfo().samples2frames(writableSlice.length());
-    DEBUG_ASSERT(numWritableFrames <= numReadableFrames);
-    if (numWritableFrames < numReadableFrames) {
+    DEBUG_ASSERT(numWritableFrames <= numReadableFrames - numDirectFrames);
+    if (numWritableFrames < numReadableFrames - numDirectFrames) {
         kLogger.warning()
                 << "Sample buffer has not enough free space for all decoded FLAC samples:"
-                << numWritableFrames << "<" << numReadableFrames;
+                << numWritableFrames << "<" << numReadableFrames - numDirectFrames;
     }
 
-    CSAMPLE* pSampleBuffer = writableSlice.data();
-    DEBUG_ASSERT(getSignalInfo().getChannelCount() <= channelCount);
-    switch (getSignalInfo().getChannelCount()) {
-    case 1: {
-        // optimized code for 1 channel (mono)
-        for (SINT i = 0; i < numWritableFrames; ++i) {
-            *pSampleBuffer++ = convertDecodedSample(buffer[0][i], m_bitsPerSample);
-        }
-        break;
-    }
-    case 2: {
-        // optimized code for 2 channels (stereo)
-        for (SINT i = 0; i < numWritableFrames; ++i) {
-            *pSampleBuffer++ = convertDecodedSample(buffer[0][i], m_bitsPerSample);
-            *pSampleBuffer++ = convertDecodedSample(buffer[1][i], m_bitsPerSample);
-        }
-        break;
-    }
-    default: {
-        // generic code for multiple channels
-        for (SINT i = 0; i < numWritableFrames; ++i) {
-            for (SINT j = 0; j < getSignalInfo().getChannelCount(); ++j) {
-                *pSampleBuffer++ = convertDecodedSample(buffer[j][i], m_bitsPerSample);
-            }
-        }
-    }
-    }
+    convertDecodedSamples(writableSlice.data(),
+            buffer,
+            numDirectFrames,
+            numWritableFrames,
+            getSignalInfo().getChannelCount(),
+            m_bitsPerSample);
 
     return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
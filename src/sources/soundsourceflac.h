@@ -49,6 +49,13 @@ class SoundSourceFLAC final : public SoundSource {
 
     ReadAheadSampleBuffer m_sampleBuffer;
 
+    // The output buffer of the current read operation. The write callback
+    // decodes into this buffer directly while it is set and only buffers
+    // the remaining samples of a FLAC frame.
+    CSAMPLE* m_pDirectOutputBuffer;
+    SINT m_directOutputFrameCapacity;
+    SINT m_directOutputFrameCount;
+
     void invalidateCurFrameIndex() {
         m_curFrameIndex = frameIndexMax();
     }
@@ -0,0 +1,151 @@
+#include "sources/soundsourcehttp.h"
+
+#include "sources/httpblockreader.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourceHttp");
+
+// The size of the buffer that FFmpeg reads into
+constexpr int kIOBufferSize = 64 * 1024;
+
+} // anonymous namespace
+
+const QString SoundSourceProviderHttp::kDisplayName = QStringLiteral("HTTP with FFmpeg");
+
+SoundSourceProviderPriority SoundSourceProviderHttp::getPriorityHint(
+        const QString& supportedFileType) const {
+    Q_UNUSED(supportedFileType)
+    // The only provider for remote files
+    return SoundSourceProviderPriority::Default;
+}
+
+SoundSourceHttp::SoundSourceHttp(const QUrl& url)
+        : SoundSourceFFmpeg(url),
+          m_pavIOContext(nullptr),
+          m_position(0) {
+}
+
+SoundSourceHttp::~SoundSourceHttp() {
+    close();
+}
+
+AVFormatContext* SoundSourceHttp::openInput() {
+    DEBUG_ASSERT(!m_pReader);
+    DEBUG_ASSERT(!m_pavIOContext);
+    m_pReader = std::make_unique<HttpBlockReader>(getUrl());
+    if (!m_pReader->open()) {
+        return nullptr;
+    }
+    m_position = 0;
+    auto* pIOBuffer = static_cast<unsigned char*>(av_malloc(kIOBufferSize));
+    m_pavIOContext = avio_alloc_context(pIOBuffer,
+            kIOBufferSize,
+            /*write_flag*/ 0,
+            this,
+            &SoundSourceHttp::readPacket,
+            /*write_packet*/ nullptr,
+            &SoundSourceHttp::seekPacket);
+    if (!m_pavIOContext) {
+        av_free(pIOBuffer);
+        return nullptr;
+    }
+
+    AVFormatContext* pavInputFormatContext = avformat_alloc_context();
+    pavInputFormatContext->pb = m_pavIOContext;
+    pavInputFormatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+    // The file name is only used for guessing the format
+    const int avformat_open_input_result = avformat_open_input(
+            &pavInputFormatContext,
+            getUrl().path().toUtf8().constData(),
+            nullptr,
+            nullptr);
+    if (avformat_open_input_result != 0) {
+        DEBUG_ASSERT(avformat_open_input_result < 0);
+        kLogger.warning().noquote()
+                << "avformat_open_input() failed:"
+                << formatErrorString(avformat_open_input_result);
+        // Frees the context, but not the I/O context
+        DEBUG_ASSERT(pavInputFormatContext == nullptr);
+    }
+    return pavInputFormatContext;
+}
+
+void SoundSourceHttp::close() {
+    SoundSourceFFmpeg::close();
+    // Not owned by the closed format context due to AVFMT_FLAG_CUSTOM_IO
+    if (m_pavIOContext) {
+        // The buffer might have been replaced by FFmpeg
+        av_freep(&m_pavIOContext->buffer);
+        avio_context_free(&m_pavIOContext);
+        DEBUG_ASSERT(!m_pavIOContext);
+    }
+    m_pReader.reset();
+}
+
+void SoundSourceHttp::prefetchSampleFrames(
+        IndexRange frameIndexRange) {
+    if (!m_pReader || frameLength() <= 0) {
+        return;
+    }
+    const auto prefetchRange = intersect(frameIndexRange, this->frameIndexRange());
+    if (prefetchRange.empty()) {
+        return;
+    }
+    const double bytesPerFrame =
+            static_cast<double>(m_pReader->size()) / frameLength();
+    const auto pos = static_cast<qint64>(
+            (prefetchRange.start() - frameIndexMin()) * bytesPerFrame);
+    const auto length = static_cast<qint64>(prefetchRange.length() * bytesPerFrame);
+    // Extend the range by a block on each side to compensate for
+    // a variable bitrate
+    m_pReader->prefetch(pos - HttpBlockReader::kBlockSize,
+            length + 2 * HttpBlockReader::kBlockSize);
+}
+
+//static
+int SoundSourceHttp::readPacket(void* pOpaque, uint8_t* pBuffer, int bufferSize) {
+    auto* pThis = static_cast<SoundSourceHttp*>(pOpaque);
+    const qint64 readCount = pThis->m_pReader->read(
+            pThis->m_position, reinterpret_cast<char*>(pBuffer), bufferSize);
+    if (readCount < 0) {
+        return AVERROR(EIO);
+    }
+    if (readCount == 0) {
+        return AVERROR_EOF;
+    }
+    pThis->m_position += readCount;
+    return static_cast<int>(readCount);
+}
+
+//static
+int64_t SoundSourceHttp::seekPacket(void* pOpaque, int64_t offset, int whence) {
+    auto* pThis = static_cast<SoundSourceHttp*>(pOpaque);
+    const qint64 size = pThis->m_pReader->size();
+    qint64 position;
+    switch (whence & ~AVSEEK_FORCE) {
+    case AVSEEK_SIZE:
+        return size;
+    case SEEK_SET:
+        position = offset;
+        break;
+    case SEEK_CUR:
+        position = pThis->m_position + offset;
+        break;
+    case SEEK_END:
+        position = size + offset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (position < 0 || position > size) {
+        return AVERROR(EINVAL);
+    }
+    pThis->m_position = position;
+    return position;
+}
+
+} // namespace mixxx
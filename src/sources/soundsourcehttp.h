@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+
+#include "sources/soundsourceffmpeg.h"
+
+namespace mixxx {
+
+class HttpBlockReader;
+
+/// Decodes remote files with FFmpeg that are read through HTTP range
+/// requests by a HttpBlockReader.
+///
+/// Prefetch hints for frames are translated into byte ranges by assuming
+/// a constant bitrate, which is accurate enough to fetch the blocks around
+/// the playhead and hotcues before they are actually needed.
+class SoundSourceHttp final : public SoundSourceFFmpeg {
+  public:
+    explicit SoundSourceHttp(const QUrl& url);
+    ~SoundSourceHttp() override;
+
+    void close() override;
+
+    void prefetchSampleFrames(
+            IndexRange frameIndexRange) override;
+
+  protected:
+    AVFormatContext* openInput() override;
+
+  private:
+    static int readPacket(void* pOpaque, uint8_t* pBuffer, int bufferSize);
+    static int64_t seekPacket(void* pOpaque, int64_t offset, int whence);
+
+    std::unique_ptr<HttpBlockReader> m_pReader;
+    AVIOContext* m_pavIOContext;
+    qint64 m_position;
+};
+
+class SoundSourceProviderHttp : public SoundSourceProviderFFmpeg {
+  public:
+    static const QString kDisplayName;
+
+    QString getDisplayName() const override {
+        return kDisplayName + QChar(' ') + getVersionString();
+    }
+
+    SoundSourceProviderPriority getPriorityHint(
+            const QString& supportedFileType) const override;
+
+    SoundSourcePointer newSoundSource(const QUrl& url) override {
+        return newSoundSourceFromUrl<SoundSourceHttp>(url);
+    }
+
+    /// Would require to fetch the headers of the remote file
+    std::optional<audio::StreamInfo> probeStreamInfo(const QUrl& url) const override {
+        Q_UNUSED(url)
+        return std::nullopt;
+    }
+};
+
+} // namespace mixxx
@@ -1,6 +1,8 @@
 #include "sources/soundsourcemp3.h"
 #include "sources/mp3decoding.h"
+#include "sources/mp3seekindexcache.h"
 
+#include "util/fileinfo.h"
 #include "util/logger.h"
 #include "util/math.h"
 
@@ -175,6 +177,15 @@ bool decodeFrameHeader(
     return true;
 }
 
+// The entry has been validated against the file, but not against what
+// the decoder supports
+bool isDecodableSeekIndexCacheEntry(const Mp3SeekIndexCache::Entry& entry) {
+    return !entry.seekFrames.empty() &&
+            entry.channelCount.isValid() &&
+            entry.channelCount <= kChannelCountMax &&
+            getIndexBySampleRate(entry.sampleRate) < kSampleRateCount;
+}
+
 } // anonymous namespace
 
 //static
@@ -189,6 +200,24 @@ QString SoundSourceProviderMp3::getVersionString() const {
     return QString(QString(mad_version) + QChar(' ') + QString(mad_build)).trimmed();
 }
 
+std::optional<audio::StreamInfo> SoundSourceProviderMp3::probeStreamInfo(
+        const QUrl& url) const {
+    // Without scanning the file only the stream info of files that have
+    // been opened before is known
+    Mp3SeekIndexCache::Entry cachedEntry;
+    if (!Mp3SeekIndexCache::load(FileInfo(url.toLocalFile()), &cachedEntry) ||
+            !isDecodableSeekIndexCacheEntry(cachedEntry)) {
+        return std::nullopt;
+    }
+    const auto signalInfo = audio::SignalInfo(
+            cachedEntry.channelCount,
+            cachedEntry.sampleRate);
+    return audio::StreamInfo(
+            signalInfo,
+            cachedEntry.bitrate,
+            Duration::fromSeconds(signalInfo.frames2secs(cachedEntry.frameIndexEnd)));
+}
+
 SoundSourceMp3::SoundSourceMp3(const QUrl& url)
         : SoundSource(url),
           m_file(getLocalFileName()),
@@ -197,7 +226,8 @@ SoundSourceMp3::SoundSourceMp3(const QUrl& url)
           m_avgSeekFrameCount(0),
           m_curFrameIndex(0),
           m_madSynthCount(0),
-          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD) {
+          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD),
+          m_leftoverFileOffset(0) {
     m_seekFrameList.reserve(kSeekFrameListCapacity);
     initDecoding();
 }
@@ -247,6 +277,75 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
     m_curFrameIndex = 0;
+
+    // Only scan the whole file if it has not been seen before
+    const FileInfo fileInfo(m_file);
+    Mp3SeekIndexCache::Entry cachedEntry;
+    if (!Mp3SeekIndexCache::load(fileInfo, &cachedEntry) ||
+            !restoreSeekFrameList(cachedEntry)) {
+        const OpenResult result = scanSeekFrameList();
+        if (result != OpenResult::Succeeded) {
+            return result;
+        }
+        Mp3SeekIndexCache::store(fileInfo, seekIndexCacheEntry());
+    }
+
+    DEBUG_ASSERT(m_seekFrameList.size() > 0);
+    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
+
+    // Terminate m_seekFrameList
+    addSeekFrame(m_curFrameIndex, nullptr);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+
+    if (m_curFrameIndex != frameIndexMin()) {
+        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        // Abort
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+bool SoundSourceMp3::restoreSeekFrameList(const Mp3SeekIndexCache::Entry& entry) {
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    if (!isDecodableSeekIndexCacheEntry(entry) ||
+            entry.seekFrames.back().byteOffset >= static_cast<qint64>(m_fileSize)) {
+        return false;
+    }
+    for (const auto& seekFrame : entry.seekFrames) {
+        addSeekFrame(seekFrame.frameIndex, m_pFileData + seekFrame.byteOffset);
+    }
+    m_curFrameIndex = entry.frameIndexEnd;
+    initChannelCountOnce(entry.channelCount);
+    initSampleRateOnce(entry.sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+    if (entry.bitrate.isValid()) {
+        initBitrateOnce(entry.bitrate);
+    }
+    return true;
+}
+
+Mp3SeekIndexCache::Entry SoundSourceMp3::seekIndexCacheEntry() const {
+    Mp3SeekIndexCache::Entry entry;
+    entry.channelCount = getSignalInfo().getChannelCount();
+    entry.sampleRate = getSignalInfo().getSampleRate();
+    entry.bitrate = getBitrate();
+    entry.frameIndexEnd = m_curFrameIndex;
+    entry.seekFrames.reserve(m_seekFrameList.size());
+    for (const auto& seekFrame : m_seekFrameList) {
+        // The last MP3 frame may have been decoded from a padded copy
+        const qint64 byteOffset = seekFrame.pInputData == &*m_leftoverBuffer.begin()
+                ? m_leftoverFileOffset
+                : seekFrame.pInputData - m_pFileData;
+        entry.seekFrames.push_back({seekFrame.frameIndex, byteOffset});
+    }
+    return entry;
+}
+
+SoundSource::OpenResult SoundSourceMp3::scanSeekFrameList() {
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -462,8 +561,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
 
     // Calculate average bitrate values
-    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
-    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
     if (cntBitrateFrames > 0) {
         const unsigned long avgBitrate = sumBitrateFrames / cntBitrateFrames;
         initBitrateOnce(avgBitrate / 1000); // bps -> kbps
@@ -471,19 +568,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         kLogger.warning() << "Bitrate cannot be calculated from headers";
     }
 
-    // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, nullptr);
-    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
-
-    // Restart decoding at the beginning of the audio stream
-    restartDecoding(m_seekFrameList.front());
-
-    if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
-        // Abort
-        return OpenResult::Failed;
-    }
-
     return OpenResult::Succeeded;
 }
 
@@ -862,6 +946,7 @@ bool SoundSourceMp3::copyLeftoverFrame() {
         const SINT leftoverBytes = remainingBytes + MAD_BUFFER_GUARD;
         if ((remainingBytes > 0) && (leftoverBytes <= SINT(m_leftoverBuffer.size()))) {
             // Copy the data of the last MP3 frame into the leftover buffer...
+            m_leftoverFileOffset = m_madStream.next_frame - m_pFileData;
             std::copy(m_madStream.next_frame,
                     m_madStream.next_frame + remainingBytes,
                     pLeftoverBuffer);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sources/mp3seekindexcache.h"
 #include "sources/soundsourceprovider.h"
 
 #ifdef _MSC_VER
@@ -32,6 +33,12 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    /// Decodes the headers of all MP3 frames
+    OpenResult scanSeekFrameList();
+    /// Returns false if the cached entry doesn't fit this file
+    bool restoreSeekFrameList(const Mp3SeekIndexCache::Entry& entry);
+    Mp3SeekIndexCache::Entry seekIndexCacheEntry() const;
+
     QFile m_file;
     quint64 m_fileSize;
     unsigned char* m_pFileData;
@@ -74,6 +81,8 @@ class SoundSourceMp3 final : public SoundSource {
     SINT m_madSynthCount; // left overs from the previous read
 
     std::vector<unsigned char> m_leftoverBuffer;
+    // The position of the copied MP3 frame in the file
+    qint64 m_leftoverFileOffset;
 };
 
 class SoundSourceProviderMp3 : public SoundSourceProvider {
@@ -93,6 +102,8 @@ class SoundSourceProviderMp3 : public SoundSourceProvider {
         return newSoundSourceFromUrl<SoundSourceMp3>(url);
     }
 
+    std::optional<audio::StreamInfo> probeStreamInfo(const QUrl& url) const override;
+
     QString getVersionString() const;
 };
 
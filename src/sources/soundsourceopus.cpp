@@ -64,6 +64,19 @@ class OggOpusFileOwner {
     OggOpusFile* m_pFile;
 };
 
+QByteArray encodeFileName(const QString& fileName) {
+    // From opus/opusfile.h
+    // On Windows, this string must be UTF-8 (to allow access to
+    // files whose names cannot be represented in the current
+    // MBCS code page).
+    // All other systems use the native character encoding.
+#ifdef _WIN32
+    return fileName.toUtf8();
+#else
+    return QFile::encodeName(fileName);
+#endif
+}
+
 } // anonymous namespace
 
 //static
@@ -82,6 +95,32 @@ SoundSourceProviderPriority SoundSourceProviderOpus::getPriorityHint(
     return SoundSourceProviderPriority::Higher;
 }
 
+std::optional<audio::StreamInfo> SoundSourceProviderOpus::probeStreamInfo(
+        const QUrl& url) const {
+    // Opening the file reads the headers and the last page for the total
+    // length, but decoding only starts when reading samples
+    int errorCode = 0;
+    OggOpusFileOwner pOggOpusFile(
+            op_open_file(encodeFileName(url.toLocalFile()).constData(), &errorCode));
+    if (!pOggOpusFile || (errorCode != 0) || !op_seekable(pOggOpusFile)) {
+        return std::nullopt;
+    }
+    const int streamChannelCount = op_channel_count(pOggOpusFile, kCurrentStreamLink);
+    const ogg_int64_t pcmTotal = op_pcm_total(pOggOpusFile, kEntireStreamLink);
+    const opus_int32 bitrate = op_bitrate(pOggOpusFile, kEntireStreamLink);
+    if (streamChannelCount <= 0 || pcmTotal < 0 || bitrate <= 0) {
+        return std::nullopt;
+    }
+    // Same as SoundSourceOpus::tryOpen() without requesting a channel count
+    const auto signalInfo = audio::SignalInfo(
+            audio::ChannelCount(streamChannelCount),
+            kSampleRate);
+    return audio::StreamInfo(
+            signalInfo,
+            audio::Bitrate(bitrate / 1000),
+            Duration::fromSeconds(signalInfo.frames2secs(static_cast<SINT>(pcmTotal))));
+}
+
 SoundSourceOpus::SoundSourceOpus(const QUrl& url)
         : SoundSource(url),
           m_pOggOpusFile(nullptr),
@@ -95,16 +134,7 @@ SoundSourceOpus::~SoundSourceOpus() {
 SoundSource::OpenResult SoundSourceOpus::tryOpen(
         OpenMode /*mode*/,
         const OpenParams& params) {
-    // From opus/opusfile.h
-    // On Windows, this string must be UTF-8 (to allow access to
-    // files whose names cannot be represented in the current
-    // MBCS code page).
-    // All other systems use the native character encoding.
-#ifdef _WIN32
-    QByteArray qBAFilename = getLocalFileName().toUtf8();
-#else
-    QByteArray qBAFilename = QFile::encodeName(getLocalFileName());
-#endif
+    const QByteArray qBAFilename = encodeFileName(getLocalFileName());
 
     int errorCode = 0;
     OggOpusFileOwner pOggOpusFile(
@@ -50,6 +50,8 @@ class SoundSourceProviderOpus : public SoundSourceProvider {
     SoundSourcePointer newSoundSource(const QUrl& url) override {
         return newSoundSourceFromUrl<SoundSourceOpus>(url);
     }
+
+    std::optional<audio::StreamInfo> probeStreamInfo(const QUrl& url) const override;
 };
 
 } // namespace mixxx
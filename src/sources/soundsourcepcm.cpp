@@ -0,0 +1,392 @@
+#include "sources/soundsourcepcm.h"
+
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourcePcm");
+
+// The last 14 bytes of the GUIDs of the PCM and IEEE float sub formats
+// in WAVE_FORMAT_EXTENSIBLE. The first 2 bytes contain the format tag.
+constexpr uchar kWavSubFormatGuidTail[14] = {
+        0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+constexpr quint16 kWavFormatPcm = 0x0001;
+constexpr quint16 kWavFormatIeeeFloat = 0x0003;
+constexpr quint16 kWavFormatExtensible = 0xFFFE;
+
+// The same normalization as libsndfile
+constexpr CSAMPLE kInt8ScaleFactor = 1.0f / 0x80;
+constexpr CSAMPLE kInt16ScaleFactor = 1.0f / 0x8000;
+constexpr CSAMPLE kInt32ScaleFactor = 1.0f / 0x80000000u;
+
+bool hasChunkId(const uchar* pData, const char (&id)[5]) {
+    return std::memcmp(pData, id, 4) == 0;
+}
+
+// 80-bit IEEE 754 extended precision, big-endian
+double readExtended80(const uchar* pData) {
+    const int exponent = ((pData[0] & 0x7F) << 8) | pData[1];
+    const auto mantissa = qFromBigEndian<quint64>(pData + 2);
+    const double value = std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+    return (pData[0] & 0x80) ? -value : value;
+}
+
+// Scaled to the full range of a 32-bit integer
+template<bool bigEndian>
+inline qint32 readInt24(const uchar* pData) {
+    const quint32 value = bigEndian
+            ? (quint32(pData[0]) << 24) | (quint32(pData[1]) << 16) | (quint32(pData[2]) << 8)
+            : (quint32(pData[2]) << 24) | (quint32(pData[1]) << 16) | (quint32(pData[0]) << 8);
+    return static_cast<qint32>(value);
+}
+
+template<typename T, bool bigEndian>
+inline T readValue(const uchar* pData) {
+    return bigEndian ? qFromBigEndian<T>(pData) : qFromLittleEndian<T>(pData);
+}
+
+// Simple loops without dependencies between the iterations that are
+// vectorized by the compiler
+template<bool bigEndian>
+void convertSamples(
+        CSAMPLE* pOutput,
+        const uchar* pInput,
+        SINT sampleCount,
+        SoundSourcePcm::SampleFormat sampleFormat) {
+    using SampleFormat = SoundSourcePcm::SampleFormat;
+    switch (sampleFormat) {
+    case SampleFormat::UInt8:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOutput[i] = (static_cast<int>(pInput[i]) - 0x80) * kInt8ScaleFactor;
+        }
+        break;
+    case SampleFormat::Int8:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOutput[i] = static_cast<qint8>(pInput[i]) * kInt8ScaleFactor;
+        }
+        break;
+    case SampleFormat::Int16:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOutput[i] = readValue<qint16, bigEndian>(pInput + 2 * i) * kInt16ScaleFactor;
+        }
+        break;
+    case SampleFormat::Int24:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOutput[i] = readInt24<bigEndian>(pInput + 3 * i) * kInt32ScaleFactor;
+        }
+        break;
+    case SampleFormat::Int32:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOutput[i] = readValue<qint32, bigEndian>(pInput + 4 * i) * kInt32ScaleFactor;
+        }
+        break;
+    case SampleFormat::Float32:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOutput[i] = readValue<float, bigEndian>(pInput + 4 * i);
+        }
+        break;
+    }
+}
+
+SINT bytesPerSample(SoundSourcePcm::SampleFormat sampleFormat) {
+    using SampleFormat = SoundSourcePcm::SampleFormat;
+    switch (sampleFormat) {
+    case SampleFormat::UInt8:
+    case SampleFormat::Int8:
+        return 1;
+    case SampleFormat::Int16:
+        return 2;
+    case SampleFormat::Int24:
+        return 3;
+    case SampleFormat::Int32:
+    case SampleFormat::Float32:
+        return 4;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return 0;
+}
+
+} // anonymous namespace
+
+//static
+const QString SoundSourceProviderPcm::kDisplayName = QStringLiteral("Mapped PCM");
+
+//static
+const QStringList SoundSourceProviderPcm::kSupportedFileTypes = {
+        QStringLiteral("aiff"),
+        QStringLiteral("wav"),
+};
+
+SoundSourceProviderPriority SoundSourceProviderPcm::getPriorityHint(
+        const QString& supportedFileType) const {
+    Q_UNUSED(supportedFileType)
+    // Preferred over libsndfile, which is used as a fallback for
+    // unsupported sample formats
+    return SoundSourceProviderPriority::Higher;
+}
+
+SoundSourcePcm::SoundSourcePcm(const QUrl& url)
+        : SoundSource(url),
+          m_file(getLocalFileName()),
+          m_pFileData(nullptr),
+          m_pSampleData(nullptr),
+          m_sampleFormat(SampleFormat::Int16),
+          m_bigEndian(false),
+          m_bytesPerSample(0) {
+}
+
+SoundSourcePcm::~SoundSourcePcm() {
+    close();
+}
+
+//static
+std::optional<SoundSourcePcm::Layout> SoundSourcePcm::parseWav(
+        const uchar* pData, qint64 size) {
+    if (size < 12 || !hasChunkId(pData, "RIFF") || !hasChunkId(pData + 8, "WAVE")) {
+        return std::nullopt;
+    }
+    std::optional<Layout> layout;
+    SINT bytesPerFrame = 0;
+    qint64 pos = 12;
+    while (pos + 8 <= size) {
+        const uchar* pChunk = pData + pos;
+        const quint32 chunkSize = qFromLittleEndian<quint32>(pChunk + 4);
+        const qint64 chunkDataPos = pos + 8;
+        const qint64 availableSize = size - chunkDataPos;
+        if (hasChunkId(pChunk, "fmt ")) {
+            if (chunkSize < 16 || availableSize < 16) {
+                return std::nullopt;
+            }
+            auto formatTag = qFromLittleEndian<quint16>(pChunk + 8);
+            const auto channelCount = qFromLittleEndian<quint16>(pChunk + 10);
+            const auto sampleRate = qFromLittleEndian<quint32>(pChunk + 12);
+            const auto blockAlign = qFromLittleEndian<quint16>(pChunk + 20);
+            const auto bitsPerSample = qFromLittleEndian<quint16>(pChunk + 22);
+            if (formatTag == kWavFormatExtensible) {
+                if (chunkSize < 40 || availableSize < 40) {
+                    return std::nullopt;
+                }
+                const uchar* pSubFormat = pChunk + 32;
+                if (std::memcmp(pSubFormat + 2,
+                            kWavSubFormatGuidTail,
+                            sizeof(kWavSubFormatGuidTail)) != 0) {
+                    return std::nullopt;
+                }
+                formatTag = qFromLittleEndian<quint16>(pSubFormat);
+            }
+            Layout parsedLayout;
+            if (formatTag == kWavFormatPcm && bitsPerSample == 8) {
+                parsedLayout.sampleFormat = SampleFormat::UInt8;
+            } else if (formatTag == kWavFormatPcm && bitsPerSample == 16) {
+                parsedLayout.sampleFormat = SampleFormat::Int16;
+            } else if (formatTag == kWavFormatPcm && bitsPerSample == 24) {
+                parsedLayout.sampleFormat = SampleFormat::Int24;
+            } else if (formatTag == kWavFormatPcm && bitsPerSample == 32) {
+                parsedLayout.sampleFormat = SampleFormat::Int32;
+            } else if (formatTag == kWavFormatIeeeFloat && bitsPerSample == 32) {
+                parsedLayout.sampleFormat = SampleFormat::Float32;
+            } else {
+                return std::nullopt;
+            }
+            parsedLayout.channelCount = audio::ChannelCount(channelCount);
+            parsedLayout.sampleRate = audio::SampleRate(sampleRate);
+            bytesPerFrame = channelCount * bytesPerSample(parsedLayout.sampleFormat);
+            if (!parsedLayout.channelCount.isValid() ||
+                    !parsedLayout.sampleRate.isValid() ||
+                    blockAlign != bytesPerFrame) {
+                return std::nullopt;
+            }
+            layout = parsedLayout;
+        } else if (hasChunkId(pChunk, "data")) {
+            // The format must precede the data
+            if (!layout) {
+                return std::nullopt;
+            }
+            // The size of truncated files or files that have been recorded
+            // as a stream might exceed the actual file size
+            const qint64 dataSize = std::min<qint64>(chunkSize, availableSize);
+            layout->dataOffset = chunkDataPos;
+            layout->frameCount = static_cast<SINT>(dataSize / bytesPerFrame);
+            return layout;
+        }
+        // Chunks are padded to an even size
+        pos = chunkDataPos + chunkSize + (chunkSize & 1);
+    }
+    return std::nullopt;
+}
+
+//static
+std::optional<SoundSourcePcm::Layout> SoundSourcePcm::parseAiff(
+        const uchar* pData, qint64 size) {
+    if (size < 12 || !hasChunkId(pData, "FORM")) {
+        return std::nullopt;
+    }
+    const bool isAifc = hasChunkId(pData + 8, "AIFC");
+    if (!isAifc && !hasChunkId(pData + 8, "AIFF")) {
+        return std::nullopt;
+    }
+    // The COMM and SSND chunks may appear in any order
+    std::optional<Layout> layout;
+    SINT commFrameCount = 0;
+    qint64 dataOffset = -1;
+    qint64 dataEnd = -1;
+    qint64 pos = 12;
+    while (pos + 8 <= size) {
+        const uchar* pChunk = pData + pos;
+        const quint32 chunkSize = qFromBigEndian<quint32>(pChunk + 4);
+        const qint64 chunkDataPos = pos + 8;
+        const qint64 availableSize = size - chunkDataPos;
+        if (hasChunkId(pChunk, "COMM")) {
+            const quint32 minChunkSize = isAifc ? 22 : 18;
+            if (chunkSize < minChunkSize || availableSize < minChunkSize) {
+                return std::nullopt;
+            }
+            const auto channelCount = qFromBigEndian<quint16>(pChunk + 8);
+            commFrameCount = qFromBigEndian<quint32>(pChunk + 10);
+            const auto bitsPerSample = qFromBigEndian<quint16>(pChunk + 14);
+            const double sampleRate = readExtended80(pChunk + 16);
+            Layout parsedLayout;
+            parsedLayout.bigEndian = true;
+            bool isFloat = false;
+            if (isAifc) {
+                const uchar* pCompressionType = pChunk + 26;
+                if (hasChunkId(pCompressionType, "sowt")) {
+                    parsedLayout.bigEndian = false;
+                } else if (hasChunkId(pCompressionType, "fl32") ||
+                        hasChunkId(pCompressionType, "FL32")) {
+                    isFloat = true;
+                } else if (!hasChunkId(pCompressionType, "NONE")) {
+                    return std::nullopt;
+                }
+            }
+            // Integer samples are left-justified in whole bytes
+            if (isFloat) {
+                if (bitsPerSample != 32) {
+                    return std::nullopt;
+                }
+                parsedLayout.sampleFormat = SampleFormat::Float32;
+            } else if (bitsPerSample > 0 && bitsPerSample <= 8) {
+                parsedLayout.sampleFormat = SampleFormat::Int8;
+            } else if (bitsPerSample > 8 && bitsPerSample <= 16) {
+                parsedLayout.sampleFormat = SampleFormat::Int16;
+            } else if (bitsPerSample > 16 && bitsPerSample <= 24) {
+                parsedLayout.sampleFormat = SampleFormat::Int24;
+            } else if (bitsPerSample > 24 && bitsPerSample <= 32) {
+                parsedLayout.sampleFormat = SampleFormat::Int32;
+            } else {
+                return std::nullopt;
+            }
+            parsedLayout.channelCount = audio::ChannelCount(channelCount);
+            parsedLayout.sampleRate = audio::SampleRate(
+                    static_cast<audio::SampleRate::value_t>(std::lround(sampleRate)));
+            if (!parsedLayout.channelCount.isValid() ||
+                    !parsedLayout.sampleRate.isValid()) {
+                return std::nullopt;
+            }
+            layout = parsedLayout;
+        } else if (hasChunkId(pChunk, "SSND")) {
+            if (chunkSize < 8 || availableSize < 8) {
+                return std::nullopt;
+            }
+            dataOffset = chunkDataPos + 8 + qFromBigEndian<quint32>(pChunk + 8);
+            dataEnd = std::min<qint64>(chunkDataPos + chunkSize, size);
+        }
+        // Chunks are padded to an even size
+        pos = chunkDataPos + chunkSize + (chunkSize & 1);
+    }
+    if (!layout || dataOffset < 0 || dataOffset > dataEnd) {
+        return std::nullopt;
+    }
+    const SINT bytesPerFrame =
+            layout->channelCount * bytesPerSample(layout->sampleFormat);
+    layout->dataOffset = dataOffset;
+    // Truncated files contain less frames than declared
+    layout->frameCount = static_cast<SINT>(std::min<qint64>(
+            commFrameCount, (dataEnd - dataOffset) / bytesPerFrame));
+    return layout;
+}
+
+SoundSource::OpenResult SoundSourcePcm::tryOpen(
+        OpenMode /*mode*/,
+        const OpenParams& /*config*/) {
+    DEBUG_ASSERT(!m_file.isOpen());
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        kLogger.warning() << "Failed to open file:" << m_file.fileName();
+        return OpenResult::Failed;
+    }
+
+    const qint64 fileSize = m_file.size();
+    m_pFileData = m_file.map(0, fileSize);
+    // NOTE: Like for SoundSourceMp3 a SIGBUS error might occur if the
+    // file disappears unexpectedly while mapped.
+    if (!m_pFileData) {
+        kLogger.info()
+                << "Failed to map file into memory:"
+                << m_file.fileName()
+                << m_file.errorString();
+        return OpenResult::Aborted;
+    }
+
+    auto layout = parseWav(m_pFileData, fileSize);
+    if (!layout) {
+        layout = parseAiff(m_pFileData, fileSize);
+    }
+    if (!layout) {
+        // Compressed or unusual sample formats are decoded by libsndfile
+        kLogger.debug()
+                << "Unsupported file format:"
+                << m_file.fileName();
+        return OpenResult::Aborted;
+    }
+
+    m_pSampleData = m_pFileData + layout->dataOffset;
+    m_sampleFormat = layout->sampleFormat;
+    m_bigEndian = layout->bigEndian;
+    m_bytesPerSample = bytesPerSample(layout->sampleFormat);
+
+    initChannelCountOnce(layout->channelCount);
+    initSampleRateOnce(layout->sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, layout->frameCount));
+
+    return OpenResult::Succeeded;
+}
+
+void SoundSourcePcm::close() {
+    if (m_pFileData) {
+        m_file.unmap(m_pFileData);
+        m_pFileData = nullptr;
+    }
+    m_pSampleData = nullptr;
+    m_file.close();
+}
+
+ReadableSampleFrames SoundSourcePcm::readSampleFramesClamped(
+        const WritableSampleFrames& writableSampleFrames) {
+    const auto frameIndexRange = writableSampleFrames.frameIndexRange();
+    CSAMPLE* pOutput = writableSampleFrames.writableData();
+    // No I/O is needed for seeking or skipping
+    if (!pOutput) {
+        return ReadableSampleFrames(frameIndexRange);
+    }
+    DEBUG_ASSERT(m_pSampleData);
+    const SINT sampleCount = getSignalInfo().frames2samples(frameIndexRange.length());
+    const uchar* pInput = m_pSampleData +
+            getSignalInfo().frames2samples(frameIndexRange.start()) * m_bytesPerSample;
+    if (m_bigEndian) {
+        convertSamples<true>(pOutput, pInput, sampleCount, m_sampleFormat);
+    } else {
+        convertSamples<false>(pOutput, pInput, sampleCount, m_sampleFormat);
+    }
+    return ReadableSampleFrames(
+            frameIndexRange,
+            SampleBuffer::ReadableSlice(pOutput, sampleCount));
+}
+
+} // namespace mixxx
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QFile>
+
+#include "sources/soundsourceprovider.h"
+
+namespace mixxx {
+
+/// Reads uncompressed integer or floating point PCM samples from WAV and
+/// AIFF files that are mapped into memory.
+///
+/// Samples are converted directly from the mapped file into the output
+/// buffer and seeking doesn't need any I/O. Files with compressed or
+/// otherwise unsupported sample formats are left to other providers
+/// like libsndfile.
+class SoundSourcePcm final : public SoundSource {
+  public:
+    /// The encoding of a single sample in the file
+    enum class SampleFormat {
+        UInt8,
+        Int8,
+        Int16,
+        Int24,
+        Int32,
+        Float32,
+    };
+
+    explicit SoundSourcePcm(const QUrl& url);
+    ~SoundSourcePcm() override;
+
+    void close() override;
+
+  protected:
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& sampleFrames) override;
+
+  private:
+    OpenResult tryOpen(
+            OpenMode mode,
+            const OpenParams& params) override;
+
+    /// The samples of the file as stored in the data chunk
+    struct Layout {
+        audio::ChannelCount channelCount;
+        audio::SampleRate sampleRate;
+        SampleFormat sampleFormat = SampleFormat::Int16;
+        bool bigEndian = false;
+        qint64 dataOffset = 0;
+        SINT frameCount = 0;
+    };
+
+    static std::optional<Layout> parseWav(const uchar* pData, qint64 size);
+    static std::optional<Layout> parseAiff(const uchar* pData, qint64 size);
+
+    QFile m_file;
+    uchar* m_pFileData;
+
+    /// The first sample frame in the mapped file
+    const uchar* m_pSampleData;
+    SampleFormat m_sampleFormat;
+    bool m_bigEndian;
+    SINT m_bytesPerSample;
+};
+
+class SoundSourceProviderPcm : public SoundSourceProvider {
+  public:
+    static const QString kDisplayName;
+    static const QStringList kSupportedFileTypes;
+
+    QString getDisplayName() const override {
+        return kDisplayName;
+    }
+
+    QStringList getSupportedFileTypes() const override {
+        return kSupportedFileTypes;
+    }
+
+    SoundSourceProviderPriority getPriorityHint(
+            const QString& supportedFileType) const override;
+
+    SoundSourcePointer newSoundSource(const QUrl& url) override {
+        return newSoundSourceFromUrl<SoundSourcePcm>(url);
+    }
+};
+
+} // namespace mixxx
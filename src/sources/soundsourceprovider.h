@@ -3,9 +3,11 @@
 #include <QString>
 #include <QStringList>
 #include <QtDebug>
+#include <optional>
 
 QT_FORWARD_DECLARE_CLASS(QUrl);
 
+#include "audio/streaminfo.h"
 #include "sources/soundsource.h"
 
 namespace mixxx {
@@ -57,6 +59,21 @@ class SoundSourceProvider {
     /// able to decide that the file is not supported even though it
     /// has one of the supported file types.
     virtual SoundSourcePointer newSoundSource(const QUrl& url) = 0;
+
+    /// Reads the properties of the audio stream in the file referenced
+    /// by the URL from its headers, without preparing the file for
+    /// decoding.
+    ///
+    /// This is only an optimization when the stream properties are
+    /// needed but not the audio data, e.g. while importing files into
+    /// the library. A result must only be returned if it is exactly the
+    /// same as the stream info of a SoundSource that has been opened with
+    /// the default parameters. Otherwise the caller falls back to opening
+    /// the file.
+    virtual std::optional<audio::StreamInfo> probeStreamInfo(const QUrl& url) const {
+        Q_UNUSED(url)
+        return std::nullopt;
+    }
 };
 
 typedef std::shared_ptr<SoundSourceProvider> SoundSourceProviderPointer;
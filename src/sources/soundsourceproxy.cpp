@@ -4,13 +4,16 @@
 #include <QMimeType>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <tuple>
 
 #include "sources/audiosourcetrackproxy.h"
+#include "sources/pcmcache.h"
 
 #ifdef __MAD__
 #include "sources/soundsourcemp3.h"
 #endif
 #include "sources/soundsourceoggvorbis.h"
+#include "sources/soundsourcepcm.h"
 #ifdef __OPUS__
 #include "sources/soundsourceopus.h"
 #endif
@@ -22,6 +25,7 @@
 #endif
 #ifdef __FFMPEG__
 #include "sources/soundsourceffmpeg.h"
+#include "sources/soundsourcehttp.h"
 #endif
 #ifdef __MODPLUG__
 #include "sources/soundsourcemodplug.h"
@@ -45,9 +49,11 @@
 #include "track/track.h"
 #include "util/logger.h"
 #include "util/regex.h"
+#include "util/timer.h"
 
 //Static memory allocation
 /*static*/ mixxx::SoundSourceProviderRegistry SoundSourceProxy::s_soundSourceProviders;
+/*static*/ mixxx::SoundSourceProviderRegistry SoundSourceProxy::s_remoteSoundSourceProviders;
 /*static*/ QStringList SoundSourceProxy::s_supportedFileNamePatterns;
 /*static*/ QRegularExpression SoundSourceProxy::s_supportedFileNamesRegex;
 /*static*/ QHash<QMimeType, QString> SoundSourceProxy::s_fileTypeByMimeType;
@@ -156,6 +162,9 @@ void registerReferenceSoundSourceProviders(
     registerReferenceSoundSourceProvider(
             pProviderRegistry,
             std::make_shared<mixxx::SoundSourceProviderOggVorbis>());
+    registerReferenceSoundSourceProvider(
+            pProviderRegistry,
+            std::make_shared<mixxx::SoundSourceProviderPcm>());
 #ifdef __OPUS__
     registerReferenceSoundSourceProvider(
             pProviderRegistry,
@@ -245,6 +254,14 @@ bool SoundSourceProxy::registerProviders() {
     // providers to verify that their priorities are correct.
     registerReferenceSoundSourceProviders(&s_soundSourceProviders);
 
+#if defined(__FFMPEG__)
+    // Remote files are only supported by FFmpeg and are not
+    // included in the supported file types
+    registerSoundSourceProvider(
+            &s_remoteSoundSourceProviders,
+            std::make_shared<mixxx::SoundSourceProviderHttp>());
+#endif // __FFMPEG__
+
     const QStringList supportedFileTypes = getSupportedFileTypes();
     VERIFY_OR_DEBUG_ASSERT(!supportedFileTypes.isEmpty()) {
         kLogger.critical()
@@ -374,8 +391,9 @@ SoundSourceProxy::allProviderRegistrationsForUrl(
         return {};
     }
     const auto providerRegistrations =
-            allProviderRegistrationsForFileType(
-                    fileType);
+            mixxx::SoundSource::isRemoteUrl(url)
+            ? s_remoteSoundSourceProviders.getRegistrationsForFileType(fileType)
+            : allProviderRegistrationsForFileType(fileType);
     if (providerRegistrations.isEmpty()) {
         kLogger.warning()
                 << "Unsupported file type:"
@@ -399,7 +417,10 @@ SoundSourceProxy::exportTrackMetadataBeforeSaving(
         // This might be needed for converting sample positions
         // to time positions and vice versa.
         if (!pTrack->hasStreamInfoFromSource()) {
-            if (proxy.openSoundSource()) {
+            if (auto streamInfo = proxy.probeStreamInfo()) {
+                pTrack->updateStreamInfoFromSource(std::move(*streamInfo));
+                DEBUG_ASSERT(pTrack->hasStreamInfoFromSource());
+            } else if (proxy.openSoundSource()) {
                 pSoundSource = proxy.m_pSoundSource;
                 pTrack->updateStreamInfoFromSource(
                         pSoundSource->getStreamInfo());
@@ -591,6 +612,29 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
     }
 }
 
+// static
+SoundSourceProxy::ImportedTrackMetadata
+SoundSourceProxy::importTrackMetadataAndCoverInfoFromFile(
+        const mixxx::FileAccess& trackFileAccess,
+        const SyncTrackMetadataParams& syncParams,
+        CoverInfoGuesser* pCoverInfoGuesser) {
+    DEBUG_ASSERT(pCoverInfoGuesser);
+    ImportedTrackMetadata importedMetadata;
+    QImage coverImage;
+    std::tie(importedMetadata.importResult, importedMetadata.sourceSynchronizedAt) =
+            importTrackMetadataAndCoverImageFromFile(
+                    trackFileAccess,
+                    &importedMetadata.trackMetadata,
+                    &coverImage,
+                    syncParams.resetMissingTagMetadataOnImport);
+    // Only the digest of the embedded cover image is stored
+    importedMetadata.coverInfo = pCoverInfoGuesser->guessCoverInfo(
+            trackFileAccess.info(),
+            importedMetadata.trackMetadata.getAlbumInfo().getTitle(),
+            coverImage);
+    return importedMetadata;
+}
+
 std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
 SoundSourceProxy::importTrackMetadataAndCoverImage(
         mixxx::TrackMetadata* pTrackMetadata,
@@ -636,7 +680,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const ImportedTrackMetadata* pImportedMetadata) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -713,13 +758,27 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
+    // The existing metadata of a track that has never been synchronized
+    // is empty and the metadata that has been imported in advance can be
+    // used instead of parsing the file again.
+    const bool useImportedMetadata = pImportedMetadata &&
+            sourceSyncStatus == mixxx::TrackRecord::SourceSyncStatus::Void;
+
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    mixxx::MetadataSource::ImportResult metadataImportResult;
+    QDateTime sourceSynchronizedAt;
+    if (useImportedMetadata) {
+        trackMetadata = pImportedMetadata->trackMetadata;
+        metadataImportResult = pImportedMetadata->importResult;
+        sourceSynchronizedAt = pImportedMetadata->sourceSynchronizedAt;
+    } else {
+        std::tie(metadataImportResult, sourceSynchronizedAt) =
+                importTrackMetadataAndCoverImage(
+                        &trackMetadata,
+                        pCoverImg,
+                        syncParams.resetMissingTagMetadataOnImport);
+    }
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -850,30 +909,43 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
     const bool pendingCueImport =
             m_pTrack->getCueImportStatus() == Track::ImportStatus::Pending;
     if (pendingBeatsImport || pendingCueImport) {
-        // Try to open the audio source once to determine the actual
-        // stream properties for finishing the pending import.
-        kLogger.debug()
-                << "Opening audio source to finish import of beats/cues";
-        const auto pAudioSource = openAudioSource();
-        DEBUG_ASSERT(!pAudioSource ||
-                m_pTrack->getBeatsImportStatus() ==
-                        Track::ImportStatus::Complete);
-        DEBUG_ASSERT(!pAudioSource ||
-                m_pTrack->getCueImportStatus() ==
-                        Track::ImportStatus::Complete);
-        if (pAudioSource) {
-            // Close open file handles
-            pAudioSource->close();
+        // Reading the actual stream properties from the headers of the
+        // file is much faster than opening the audio source if supported.
+        if (auto streamInfo = probeStreamInfo()) {
+            kLogger.debug()
+                    << "Finishing import of beats/cues with probed stream info";
+            m_pTrack->updateStreamInfoFromSource(std::move(*streamInfo));
+            DEBUG_ASSERT(m_pTrack->getBeatsImportStatus() ==
+                    Track::ImportStatus::Complete);
+            DEBUG_ASSERT(m_pTrack->getCueImportStatus() ==
+                    Track::ImportStatus::Complete);
+        } else {
+            // Try to open the audio source once to determine the actual
+            // stream properties for finishing the pending import.
+            kLogger.debug()
+                    << "Opening audio source to finish import of beats/cues";
+            const auto pAudioSource = openAudioSource();
+            DEBUG_ASSERT(!pAudioSource ||
+                    m_pTrack->getBeatsImportStatus() ==
+                            Track::ImportStatus::Complete);
+            DEBUG_ASSERT(!pAudioSource ||
+                    m_pTrack->getCueImportStatus() ==
+                            Track::ImportStatus::Complete);
+            if (pAudioSource) {
+                // Close open file handles
+                pAudioSource->close();
+            }
         }
     }
 
     if (pCoverImg) {
         // If the pointer is not null then the cover art should be guessed
-        auto coverInfo =
-                CoverInfoGuesser().guessCoverInfo(
-                        m_pTrack->getFileInfo(),
-                        m_pTrack->getAlbum(),
-                        *pCoverImg);
+        auto coverInfo = useImportedMetadata
+                ? pImportedMetadata->coverInfo
+                : CoverInfoGuesser().guessCoverInfo(
+                          m_pTrack->getFileInfo(),
+                          m_pTrack->getAlbum(),
+                          *pCoverImg);
         DEBUG_ASSERT(coverInfo.source == CoverInfo::GUESSED);
         m_pTrack->setCoverInfo(coverInfo);
     }
@@ -887,8 +959,12 @@ bool SoundSourceProxy::openSoundSource(
     int attemptCount = 0;
     while (m_pProvider && m_pSoundSource) {
         ++attemptCount;
-        const mixxx::SoundSource::OpenResult openResult =
-                m_pSoundSource->open(openMode, params);
+        mixxx::SoundSource::OpenResult openResult;
+        {
+            ScopedTimer t(QStringLiteral("SoundSourceProxy::open(%1)"),
+                    m_pSoundSource->getType());
+            openResult = m_pSoundSource->open(openMode, params);
+        }
         if (openResult == mixxx::SoundSource::OpenResult::Succeeded) {
             if (m_pSoundSource->verifyReadable()) {
                 return true;
@@ -947,11 +1023,29 @@ bool SoundSourceProxy::openSoundSource(
     return false;
 }
 
+std::optional<mixxx::audio::StreamInfo> SoundSourceProxy::probeStreamInfo() const {
+    if (!m_pProvider) {
+        return std::nullopt;
+    }
+    return m_pProvider->probeStreamInfo(getUrl());
+}
+
 mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
         const mixxx::AudioSource::OpenParams& params) {
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return nullptr;
     }
+    if (mixxx::PcmCache::isEnabled() &&
+            mixxx::PcmCache::isCacheableFileType(m_pTrack->getType())) {
+        // Skip decoding if the audio data has been cached before
+        auto pCachedAudioSource = mixxx::PcmCache::openAudioSource(
+                m_pTrack->getFileInfo(), getUrl(), params);
+        if (pCachedAudioSource) {
+            m_pTrack->updateStreamInfoFromSource(
+                    pCachedAudioSource->getStreamInfo());
+            return mixxx::AudioSourceTrackProxy::create(m_pTrack, pCachedAudioSource);
+        }
+    }
     if (!openSoundSource(params)) {
         return nullptr;
     }
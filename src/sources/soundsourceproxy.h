@@ -4,9 +4,12 @@
 
 #include <QMimeType>
 
+#include "library/coverart.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
 
+class CoverInfoGuesser;
+
 namespace mixxx {
 
 class FileAccess;
@@ -123,6 +126,31 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata) const;
 
+    /// Track metadata and cover art of a new track that have been
+    /// imported from the file in advance, see
+    /// importTrackMetadataAndCoverInfoFromFile().
+    struct ImportedTrackMetadata {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        CoverInfoRelative coverInfo;
+    };
+
+    /// Import the track metadata and guess the cover art of a file that
+    /// is not in the library yet. The result is applied when passing it
+    /// to updateTrackFromSource() for the new track object, which then
+    /// doesn't need to read the file again. This allows to parse the
+    /// files of many new tracks concurrently.
+    ///
+    /// This function is thread-safe and can be invoked from any thread.
+    /// The guesser caches the cover files of the last folder and must
+    /// not be shared between threads.
+    static ImportedTrackMetadata importTrackMetadataAndCoverInfoFromFile(
+            const mixxx::FileAccess& trackFileAccess,
+            const SyncTrackMetadataParams& syncParams,
+            CoverInfoGuesser* pCoverInfoGuesser);
+
     /// Controls which (metadata/coverart) and how tags are (re-)imported from
     /// audio files when creating a SoundSourceProxy.
     ///
@@ -174,10 +202,15 @@ class SoundSourceProxy {
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
     ///
+    /// Metadata that has been imported in advance is only used if the
+    /// track object has never been synchronized with its file before.
+    /// Otherwise the file is read again.
+    ///
     /// Returns true if the track has been modified and false otherwise.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const ImportedTrackMetadata* pImportedMetadata = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
@@ -196,8 +229,18 @@ class SoundSourceProxy {
     mixxx::AudioSourcePointer openAudioSource(
             const mixxx::AudioSource::OpenParams& params = mixxx::AudioSource::OpenParams());
 
+    /// Reads the actual audio properties of the stream from the headers
+    /// of the file without opening the audio source, if supported by the
+    /// provider. Unlike openAudioSource() the track object is not updated.
+    ///
+    /// Returns std::nullopt if the audio source needs to be opened for
+    /// determining the stream properties.
+    std::optional<mixxx::audio::StreamInfo> probeStreamInfo() const;
+
   private:
     static mixxx::SoundSourceProviderRegistry s_soundSourceProviders;
+    // Providers for remote URLs, separate from the providers of local files
+    static mixxx::SoundSourceProviderRegistry s_remoteSoundSourceProviders;
     static QStringList s_supportedFileNamePatterns;
     static QRegularExpression s_supportedFileNamesRegex;
     static QHash<QMimeType, QString> s_fileTypeByMimeType;
@@ -1,5 +1,9 @@
 #include "sources/soundsourcestem.h"
 
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
 #include "sources/readaheadframebuffer.h"
 
 extern "C" {
@@ -29,6 +33,20 @@ constexpr int kRequiredStreamCount = kNumStreams - 1; // Stem count doesn't incl
 
 const Logger kLogger("SoundSourceSTEM");
 
+/// Shared by all stem files. Each read decodes one stem in the calling
+/// reader thread and the others in this pool, so a single stem deck uses
+/// at most kRequiredStreamCount - 1 threads of it.
+QThreadPool* stemDecodingThreadPool() {
+    static QThreadPool* const pThreadPool = [] {
+        auto* pThreadPool = new QThreadPool();
+        // Leave room for decoding the stems of two decks at once
+        pThreadPool->setMaxThreadCount(2 * (kRequiredStreamCount - 1));
+        pThreadPool->setObjectName(QStringLiteral("SoundSourceSTEM"));
+        return pThreadPool;
+    }();
+    return pThreadPool;
+}
+
 } // anonymous namespace
 
 const QString SoundSourceProviderSTEM::kDisplayName = QStringLiteral("STEM with FFmpeg");
@@ -440,13 +458,6 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
     SINT stemSampleLength = m_pStereoStreams.front()->getSignalInfo().frames2samples(
             globalSampleFrames.frameLength());
 
-    // The same buffer is reused between requests tp prevent reallocation, but
-    // it will be reallocated if a larger chunk is requested and will keep the
-    // new maximum size
-    if (stemSampleLength > m_buffer.size()) {
-        m_buffer = SampleBuffer(stemSampleLength);
-    }
-
     ReadableSampleFrames read(globalSampleFrames.frameIndexRange(),
             SampleBuffer::ReadableSlice(
                     globalSampleFrames.writableData(),
@@ -466,14 +477,38 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         return read;
     }
 
-    for (std::size_t streamIdx = 0; streamIdx < stemCount; streamIdx++) {
-        WritableSampleFrames currentStemFrame = WritableSampleFrames(
+    // Each stem has its own decoder and buffer, so the stems are decoded
+    // concurrently. The buffers are reused between requests to prevent
+    // reallocation, but will be reallocated if a larger chunk is requested
+    // and will keep the new maximum size.
+    m_stemBuffers.resize(stemCount);
+    for (auto& stemBuffer : m_stemBuffers) {
+        if (stemSampleLength > stemBuffer.size()) {
+            stemBuffer = SampleBuffer(stemSampleLength);
+        }
+    }
+    const auto decodeStem = [this, &globalSampleFrames, stemSampleLength](
+                                    std::size_t streamIdx) {
+        m_pStereoStreams[streamIdx]->readSampleFrames(WritableSampleFrames(
                 globalSampleFrames.frameIndexRange(),
                 SampleBuffer::WritableSlice(
-                        m_buffer.data(),
-                        stemSampleLength));
-        m_pStereoStreams[streamIdx]->readSampleFrames(currentStemFrame);
+                        m_stemBuffers[streamIdx].data(),
+                        stemSampleLength)));
+    };
+    std::vector<QFuture<void>> futures;
+    futures.reserve(stemCount - 1);
+    for (std::size_t streamIdx = 1; streamIdx < stemCount; streamIdx++) {
+        futures.push_back(QtConcurrent::run(
+                stemDecodingThreadPool(), decodeStem, streamIdx));
+    }
+    // The calling thread takes its share instead of idling
+    decodeStem(0);
+    for (auto& future : futures) {
+        future.waitForFinished();
+    }
 
+    for (std::size_t streamIdx = 0; streamIdx < stemCount; streamIdx++) {
+        const SampleBuffer& stemBuffer = m_stemBuffers[streamIdx];
         // TODO(XXX): currently, stem samples are interleaved and packed
         // next to each other as such:
         //    1L1R1L1R1L1R...2L2R2L2R2L2R2L2R......3L3R3L3R3L3R3L3R......4L4R4L4R4L4R4L4R....
@@ -482,14 +517,14 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         if (m_requestedChannelCount != mixxx::audio::ChannelCount::stereo()) {
             // Change the sample layout to interleave all channels together
             for (SINT i = 0; i < stemSampleLength / 2; i++) {
-                pBuffer[2 * stemCount * i + 2 * streamIdx] = m_buffer[2 * i];
-                pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = m_buffer[2 * i + 1];
+                pBuffer[2 * stemCount * i + 2 * streamIdx] = stemBuffer[2 * i];
+                pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = stemBuffer[2 * i + 1];
             }
         } else {
             // Change the sample layout to mix all channels together
             for (SINT i = 0; i < stemSampleLength / 2; i++) {
-                pBuffer[2 * i] += m_buffer[2 * i];
-                pBuffer[2 * i + 1] += m_buffer[2 * i + 1];
+                pBuffer[2 * i] += stemBuffer[2 * i];
+                pBuffer[2 * i + 1] += stemBuffer[2 * i + 1];
             }
         }
     }
@@ -35,7 +35,8 @@ class SoundSourceSTEM : public SoundSource {
   private:
     // Contains each stem source, or the main mix if opened in stereo mode
     std::vector<std::unique_ptr<SoundSourceSingleSTEM>> m_pStereoStreams;
-    SampleBuffer m_buffer;
+    // The decoded samples of each stream, indexed like m_pStereoStreams
+    std::vector<SampleBuffer> m_stemBuffers;
 
     mixxx::audio::ChannelCount m_requestedChannelCount;
 
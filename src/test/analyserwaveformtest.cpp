@@ -2,6 +2,7 @@
 
 #include <QDir>
 #include <QtDebug>
+#include <cmath>
 #include <vector>
 
 #include "analyzer/analyzertrack.h"
@@ -130,4 +131,77 @@ TEST_F(AnalyzerWaveformTest, canary) {
     EXPECT_DOUBLE_EQ(pWaveformSummary->getAudioVisualRatio(), 1.0);
 }
 
+// The preview is replaced by the same results as without a preview
+TEST_F(AnalyzerWaveformTest, preview) {
+    constexpr SINT kFrameLength = 44100;
+    constexpr SINT kExcerptFrames = 1024;
+    constexpr SINT kExcerptCount = 4;
+    std::vector<CSAMPLE> samples(kFrameLength * kChannelCount);
+    for (SINT i = 0; i < kFrameLength; ++i) {
+        const auto value = static_cast<CSAMPLE>(0.5 * std::sin(2 * M_PI * 440 * i / 44100));
+        samples[i * kChannelCount] = value;
+        samples[i * kChannelCount + 1] = value;
+    }
+
+    const auto analyze = [&](TrackPointer pTrack, bool preview) {
+        AnalyzerWaveform analyzer(config(), QSqlDatabase());
+        ASSERT_TRUE(analyzer.initialize(AnalyzerTrack(pTrack),
+                pTrack->getSampleRate(),
+                pTrack->getChannels(),
+                kFrameLength));
+        ASSERT_TRUE(analyzer.wantsPreview());
+        if (preview) {
+            for (SINT i = 0; i < kExcerptCount; ++i) {
+                const SINT start = kFrameLength * i / kExcerptCount;
+                analyzer.processPreviewExcerpt(
+                        mixxx::IndexRange::forward(start, kFrameLength * (i + 1) / kExcerptCount),
+                        &samples[start * kChannelCount],
+                        kExcerptFrames * kChannelCount);
+            }
+            analyzer.finishPreview();
+
+            ConstWaveformPointer pSummary = pTrack->getWaveformSummary();
+            ASSERT_NE(pSummary, nullptr);
+            EXPECT_TRUE(pSummary->hasPreview());
+            // The last visual sample might exceed the track
+            for (int i = 0; i < pSummary->getDataSize() - kChannelCount; ++i) {
+                EXPECT_GT(pSummary->getAll(i), 0) << i;
+            }
+        }
+        EXPECT_TRUE(analyzer.processSamples(samples.data(), static_cast<SINT>(samples.size())));
+        EXPECT_FALSE(analyzer.wantsPreview());
+        analyzer.storeResults(pTrack);
+        analyzer.cleanup();
+    };
+
+    const auto pPreviewTrack = Track::newTemporary();
+    pPreviewTrack->setAudioProperties(mixxx::audio::ChannelCount(kChannelCount),
+            mixxx::audio::SampleRate(44100),
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromMillis(1000));
+    analyze(pPreviewTrack, true);
+    analyze(m_pTrack, false);
+
+    EXPECT_FALSE(pPreviewTrack->getWaveformSummary()->hasPreview());
+    EXPECT_EQ(m_pTrack->getWaveformSummary()->toByteArray(),
+            pPreviewTrack->getWaveformSummary()->toByteArray());
+    EXPECT_EQ(m_pTrack->getWaveform()->toByteArray(),
+            pPreviewTrack->getWaveform()->toByteArray());
+}
+
+// The strides must be completed at the same positions as when checking
+// fmod(position, length) < 1 for every frame
+TEST(WaveformStrideTest, advance) {
+    for (const double length : {1.0, 2.5, 100.0, 44100.0 / 441 * 1.7, 48000.0 / 441}) {
+        WaveformStride stride(length, length * 13.3, 0);
+        for (int position = 1; position < 1000000; ++position) {
+            bool averageComplete = false;
+            ASSERT_EQ(std::fmod(position, length) < 1, stride.advance(&averageComplete))
+                    << "length" << length << "position" << position;
+            ASSERT_EQ(std::fmod(position, length * 13.3) < 1, averageComplete)
+                    << "length" << length << "position" << position;
+        }
+    }
+}
+
 } // namespace
@@ -0,0 +1,62 @@
+#include "library/dao/analysisdao.h"
+
+#include <gtest/gtest.h>
+
+#include "test/librarytest.h"
+#include "track/track.h"
+
+namespace {
+
+class AnalysisDaoTest : public LibraryTest {
+  protected:
+    TrackId addTrack(const QString& fileName) {
+        const TrackPointer pTrack = getOrAddTrackByLocation(
+                getTestDir().filePath(QStringLiteral("id3-test-data/") + fileName));
+        return pTrack ? pTrack->getId() : TrackId();
+    }
+
+    AnalysisDao& analysisDao() const {
+        return internalCollection()->getAnalysisDAO();
+    }
+};
+
+TEST_F(AnalysisDaoTest, queue) {
+    const TrackId trackId1 = addTrack(QStringLiteral("artist.mp3"));
+    const TrackId trackId2 = addTrack(QStringLiteral("empty.mp3"));
+    const TrackId trackId3 = addTrack(QStringLiteral("cover-test-png.mp3"));
+    ASSERT_TRUE(trackId1.isValid());
+    ASSERT_TRUE(trackId2.isValid());
+    ASSERT_TRUE(trackId3.isValid());
+
+    AnalyzerTrack::Options fixedTempo;
+    fixedTempo.useFixedTempo = true;
+    analysisDao().enqueueTracks({trackId2, AnalyzerScheduledTrack(trackId1, fixedTempo)});
+    // Already queued tracks keep their position and options
+    analysisDao().enqueueTracks({trackId3, trackId2, trackId1});
+    EXPECT_EQ(3, analysisDao().countQueuedTracks());
+
+    QList<AnalyzerScheduledTrack> tracks = analysisDao().getQueuedTracks();
+    ASSERT_EQ(3, tracks.size());
+    EXPECT_EQ(trackId2, tracks[0].getTrackId());
+    EXPECT_FALSE(tracks[0].getOptions().useFixedTempo.has_value());
+    EXPECT_EQ(trackId1, tracks[1].getTrackId());
+    EXPECT_EQ(std::optional<bool>(true), tracks[1].getOptions().useFixedTempo);
+    EXPECT_EQ(trackId3, tracks[2].getTrackId());
+
+    analysisDao().dequeueTrack(trackId1);
+    tracks = analysisDao().getQueuedTracks();
+    ASSERT_EQ(2, tracks.size());
+    EXPECT_EQ(trackId2, tracks[0].getTrackId());
+    EXPECT_EQ(trackId3, tracks[1].getTrackId());
+
+    // Purged tracks are removed from the queue
+    ASSERT_TRUE(internalCollection()->purgeTracks({trackId2}));
+    tracks = analysisDao().getQueuedTracks();
+    ASSERT_EQ(1, tracks.size());
+    EXPECT_EQ(trackId3, tracks[0].getTrackId());
+
+    analysisDao().clearQueue();
+    EXPECT_EQ(0, analysisDao().countQueuedTracks());
+}
+
+} // namespace
@@ -0,0 +1,285 @@
+#include "test/analyzer_benchmark.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QSemaphore>
+#include <QSqlDatabase>
+#include <QTemporaryDir>
+#include <QVariant>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzerdecimator.h"
+#include "analyzer/analyzerkey.h"
+#include "analyzer/analyzerloudness.h"
+#include "analyzer/analyzersilence.h"
+#include "analyzer/analyzerthread.h"
+#include "analyzer/analyzertrack.h"
+#include "analyzer/analyzerwaveform.h"
+#include "analyzer/constants.h"
+#include "preferences/waveformsettings.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+// Measures how fast tracks are analyzed: every analyzer on its own with a
+// synthesized signal, and decoding as well as the whole AnalyzerThread for
+// each of the bundled file formats. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_Analyzer
+//
+// The "realtime" counter reports how many seconds of audio have been
+// analyzed per second, i.e. 100 means that a track of 5 minutes takes 3 s.
+// The AnalyzerThread benchmarks run without a database and thus without
+// the waveform analyzer, the argument is the number of analyzer workers.
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+constexpr double kSignalSeconds = 60;
+
+const QString kTestFileNames[] = {
+        QStringLiteral("cover-test.aiff"),
+        QStringLiteral("cover-test.flac"),
+        QStringLiteral("cover-test.ogg"),
+        QStringLiteral("cover-test.opus"),
+        QStringLiteral("cover-test.wav"),
+        QStringLiteral("cover-test.wv"),
+        QStringLiteral("cover-test-png.mp3"),
+        QStringLiteral("cover-test-vbr.mp3"),
+        QStringLiteral("cover-test-ffmpeg-aac.m4a"),
+};
+
+using AnalyzerFactory = std::function<AnalyzerPtr(UserSettingsPointer)>;
+
+UserSettingsPointer benchmarkConfig() {
+    // The waveform analyzer creates its storage path in the settings path
+    static const QTemporaryDir s_settingsDir;
+    static const UserSettingsPointer s_pConfig = [] {
+        auto pConfig = UserSettingsPointer(new UserSettings(
+                s_settingsDir.filePath(QStringLiteral("mixxx.cfg"))));
+        // Only measure the analysis, not storing the results
+        WaveformSettings(pConfig).setWaveformCachingEnabled(false);
+        return pConfig;
+    }();
+    return s_pConfig;
+}
+
+// A pulse at 120 BPM on top of a chord with some noise, which gives the
+// beat and key detection something to work with
+const std::vector<CSAMPLE>& synthesizedSignal() {
+    static const std::vector<CSAMPLE> s_samples = [] {
+        constexpr double kChordFrequencies[] = {220.0, 261.63, 329.63};
+        const auto frameCount = static_cast<SINT>(kSignalSeconds * kSampleRate);
+        const SINT beatLength = kSampleRate / 2;
+        std::vector<CSAMPLE> samples;
+        samples.reserve(frameCount * mixxx::audio::ChannelCount::stereo());
+        std::minstd_rand generator(1);
+        std::uniform_real_distribution<CSAMPLE> noise(-0.05f, 0.05f);
+        for (SINT i = 0; i < frameCount; ++i) {
+            const double t = static_cast<double>(i) / kSampleRate;
+            double value = 0;
+            for (const double frequency : kChordFrequencies) {
+                value += 0.1 * std::sin(2 * M_PI * frequency * t);
+            }
+            const SINT beatPosition = i % beatLength;
+            value += 0.5 * std::exp(-beatPosition / (0.02 * kSampleRate)) *
+                    std::sin(2 * M_PI * 60 * t);
+            samples.push_back(static_cast<CSAMPLE>(value) + noise(generator));
+            samples.push_back(static_cast<CSAMPLE>(value) + noise(generator));
+        }
+        return samples;
+    }();
+    return s_samples;
+}
+
+void BM_Analyzer(benchmark::State& state, AnalyzerFactory createAnalyzer) {
+    const UserSettingsPointer pConfig = benchmarkConfig();
+    const std::vector<CSAMPLE>& samples = synthesizedSignal();
+    const auto sampleCount = static_cast<SINT>(samples.size());
+    const SINT frameCount = sampleCount / mixxx::audio::ChannelCount::stereo();
+    constexpr SINT kSamplesPerChunk =
+            mixxx::kAnalysisFramesPerChunk * mixxx::audio::ChannelCount::stereo();
+    for (auto _ : state) {
+        // A new track every time, otherwise the results would be reused
+        const auto pTrack = Track::newTemporary();
+        const AnalyzerPtr pAnalyzer = createAnalyzer(pConfig);
+        if (!pAnalyzer->initialize(AnalyzerTrack(pTrack),
+                    kSampleRate,
+                    mixxx::audio::ChannelCount::stereo(),
+                    frameCount)) {
+            state.SkipWithError("The analyzer has not been initialized");
+            break;
+        }
+        for (SINT offset = 0; offset < sampleCount; offset += kSamplesPerChunk) {
+            pAnalyzer->processSamples(samples.data() + offset,
+                    math_min(kSamplesPerChunk, sampleCount - offset));
+        }
+        pAnalyzer->storeResults(pTrack);
+        pAnalyzer->cleanup();
+    }
+    state.counters["realtime"] = benchmark::Counter(
+            kSignalSeconds, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+mixxx::AudioSourcePointer openTestFile(const QString& filePath) {
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setChannelCount(mixxx::kAnalysisChannels);
+    return SoundSourceProxy(Track::newTemporary(filePath)).openAudioSource(openParams);
+}
+
+void BM_AnalyzerDecode(benchmark::State& state, const QString& filePath) {
+    mixxx::AudioSourcePointer pAudioSource = openTestFile(filePath);
+    if (!pAudioSource) {
+        state.SkipWithError("Failed to open the file");
+        return;
+    }
+    const double seconds = pAudioSource->getDuration();
+    mixxx::SampleBuffer buffer(pAudioSource->getSignalInfo().frames2samples(
+            mixxx::kAnalysisFramesPerChunk));
+    for (auto _ : state) {
+        // Reopened every time like for each analyzed track
+        pAudioSource = openTestFile(filePath);
+        auto remainingFrameRange = pAudioSource->frameIndexRange();
+        while (!remainingFrameRange.empty()) {
+            const auto chunkFrameRange = remainingFrameRange.splitAndShrinkFront(
+                    math_min(mixxx::kAnalysisFramesPerChunk,
+                            remainingFrameRange.length()));
+            const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(chunkFrameRange,
+                            mixxx::SampleBuffer::WritableSlice(buffer)));
+            benchmark::DoNotOptimize(readableSampleFrames.readableData());
+        }
+    }
+    state.counters["realtime"] = benchmark::Counter(
+            seconds, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_AnalyzerThread(benchmark::State& state, const QString& filePath) {
+    const mixxx::AudioSourcePointer pAudioSource = openTestFile(filePath);
+    if (!pAudioSource) {
+        state.SkipWithError("Failed to open the file");
+        return;
+    }
+    const double seconds = pAudioSource->getDuration();
+
+    AnalyzerThread::Pointer pThread = AnalyzerThread::createInstance(0,
+            mixxx::DbConnectionPoolPtr(),
+            benchmarkConfig(),
+            AnalyzerModeFlags::WithBeats,
+            static_cast<int>(state.range(0)));
+    QSemaphore trackDone;
+    QObject::connect(
+            pThread.get(),
+            &AnalyzerThread::progress,
+            pThread.get(),
+            [&trackDone](int /*threadId*/,
+                    AnalyzerThreadState threadState,
+                    TrackId /*trackId*/,
+                    AnalyzerProgress /*trackProgress*/) {
+                if (threadState == AnalyzerThreadState::Done) {
+                    trackDone.release();
+                }
+            },
+            Qt::DirectConnection);
+    pThread->start();
+
+    // The ids are only needed to tell the analyzed tracks apart
+    static int s_lastTrackId = 0;
+    for (auto _ : state) {
+        const auto pTrack = Track::newDummy(
+                filePath, TrackId(QVariant(++s_lastTrackId)));
+        if (!pThread->submitNextTrack(AnalyzerTrack(pTrack))) {
+            state.SkipWithError("Failed to submit the track");
+            break;
+        }
+        trackDone.acquire();
+    }
+
+    pThread->stop();
+    pThread->wait();
+    pThread.reset();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    state.counters["realtime"] = benchmark::Counter(
+            seconds, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+} // namespace
+
+void registerAnalyzerBenchmarks() {
+    const std::pair<const char*, AnalyzerFactory> analyzers[] = {
+            {"Waveform",
+                    [](UserSettingsPointer pConfig) {
+                        return std::make_unique<AnalyzerWaveform>(
+                                pConfig, QSqlDatabase());
+                    }},
+            {"Loudness",
+                    [](UserSettingsPointer pConfig) {
+                        return std::make_unique<AnalyzerLoudness>(pConfig);
+                    }},
+            {"Beats",
+                    [](UserSettingsPointer pConfig) {
+                        return std::make_unique<AnalyzerBeats>(pConfig, true);
+                    }},
+            {"Key",
+                    [](UserSettingsPointer pConfig) {
+                        return std::make_unique<AnalyzerKey>(pConfig);
+                    }},
+            {"Silence",
+                    [](UserSettingsPointer pConfig) {
+                        return std::make_unique<AnalyzerSilence>(pConfig);
+                    }},
+            // Beats and key share the decimated signal in AnalyzerThread
+            {"Decimator",
+                    [](UserSettingsPointer pConfig) {
+                        std::vector<AnalyzerPtr> decimatedAnalyzers;
+                        decimatedAnalyzers.push_back(
+                                std::make_unique<AnalyzerBeats>(pConfig, true));
+                        decimatedAnalyzers.push_back(
+                                std::make_unique<AnalyzerKey>(pConfig));
+                        return std::make_unique<AnalyzerDecimator>(
+                                std::move(decimatedAnalyzers));
+                    }},
+    };
+    for (const auto& [name, createAnalyzer] : analyzers) {
+        benchmark::RegisterBenchmark(
+                QStringLiteral("BM_Analyzer/%1").arg(QLatin1String(name)).toStdString().c_str(),
+                BM_Analyzer,
+                createAnalyzer)
+                ->Unit(benchmark::kMillisecond);
+    }
+
+    // SoundSourceProxy does not support tear-down
+    if (!SoundSourceProxy::isFileSuffixSupported(QStringLiteral("wav"))) {
+        SoundSourceProxy::registerProviders();
+    }
+    const QDir testDir(MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("id3-test-data")));
+    for (const auto& fileName : kTestFileNames) {
+        // Not all formats are available in every build
+        if (!SoundSourceProxy::isFileNameSupported(fileName)) {
+            continue;
+        }
+        const QString filePath = testDir.filePath(fileName);
+        benchmark::RegisterBenchmark(
+                QStringLiteral("BM_AnalyzerDecode/%1").arg(fileName).toStdString().c_str(),
+                BM_AnalyzerDecode,
+                filePath)
+                ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(
+                QStringLiteral("BM_AnalyzerThread/%1").arg(fileName).toStdString().c_str(),
+                BM_AnalyzerThread,
+                filePath)
+                ->Arg(0)
+                ->Arg(2)
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+    }
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+/// Registers the benchmarks of all analyzers and of the AnalyzerThread for
+/// each bundled file format. Must be called after the QCoreApplication has
+/// been created and before running the benchmarks.
+void registerAnalyzerBenchmarks();
@@ -0,0 +1,151 @@
+#include "analyzer/analyzerdecimator.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(96000);
+
+// Records the received samples and the parameters of initialization
+class RecordingAnalyzer : public Analyzer {
+  public:
+    RecordingAnalyzer(std::vector<CSAMPLE>* pSamples,
+            int* pDecimationFactor,
+            bool acceptsDecimatedSignal)
+            : m_pSamples(pSamples),
+              m_pDecimationFactor(pDecimationFactor),
+              m_acceptsDecimatedSignal(acceptsDecimatedSignal) {
+    }
+
+    bool initialize(const AnalyzerTrack&,
+            mixxx::audio::SampleRate,
+            mixxx::audio::ChannelCount,
+            SINT) override {
+        *m_pDecimationFactor = 1;
+        return true;
+    }
+
+    bool acceptsDecimatedSignal() const override {
+        return m_acceptsDecimatedSignal;
+    }
+
+    bool initializeDecimated(const AnalyzerTrack&,
+            mixxx::audio::SampleRate,
+            SINT,
+            int decimationFactor) override {
+        *m_pDecimationFactor = decimationFactor;
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        m_pSamples->insert(m_pSamples->end(), pIn, pIn + count);
+        return true;
+    }
+
+    void storeResults(TrackPointer) override {
+    }
+
+    void cleanup() override {
+    }
+
+  private:
+    std::vector<CSAMPLE>* const m_pSamples;
+    int* const m_pDecimationFactor;
+    const bool m_acceptsDecimatedSignal;
+};
+
+class AnalyzerDecimatorTest : public testing::Test {
+  protected:
+    AnalyzerDecimatorTest()
+            : m_originalDecimationFactor(0),
+              m_decimatedDecimationFactor(0) {
+        std::vector<AnalyzerPtr> analyzers;
+        analyzers.push_back(std::make_unique<RecordingAnalyzer>(
+                &m_originalSamples, &m_originalDecimationFactor, false));
+        analyzers.push_back(std::make_unique<RecordingAnalyzer>(
+                &m_decimatedSamples, &m_decimatedDecimationFactor, true));
+        m_pDecimator = std::make_unique<AnalyzerWithState>(
+                std::make_unique<AnalyzerDecimator>(std::move(analyzers)));
+    }
+
+    // Analyzes a stereo sine wave in chunks
+    std::vector<CSAMPLE> analyzeSine(double frequency, SINT frameLength) {
+        const auto pTrack = Track::newTemporary();
+        const AnalyzerTrack track(pTrack);
+        EXPECT_TRUE(m_pDecimator->initialize(track,
+                kSampleRate,
+                mixxx::audio::ChannelCount::stereo(),
+                frameLength));
+        std::vector<CSAMPLE> samples(frameLength * mixxx::kAnalysisChannels);
+        for (SINT i = 0; i < frameLength; ++i) {
+            const auto value = static_cast<CSAMPLE>(
+                    std::sin(2 * M_PI * frequency * i / kSampleRate));
+            samples[i * 2] = value;
+            samples[i * 2 + 1] = value;
+        }
+        for (SINT frame = 0; frame < frameLength;) {
+            const SINT chunkFrames = math_min(
+                    frameLength - frame, mixxx::kAnalysisFramesPerChunk);
+            m_pDecimator->processSamples(
+                    samples.data() + frame * mixxx::kAnalysisChannels,
+                    static_cast<int>(chunkFrames * mixxx::kAnalysisChannels));
+            frame += chunkFrames;
+        }
+        m_pDecimator->finish(track);
+        return samples;
+    }
+
+    std::vector<CSAMPLE> m_originalSamples;
+    std::vector<CSAMPLE> m_decimatedSamples;
+    int m_originalDecimationFactor;
+    int m_decimatedDecimationFactor;
+    std::unique_ptr<AnalyzerWithState> m_pDecimator;
+};
+
+TEST_F(AnalyzerDecimatorTest, decimationFactor) {
+    const auto stereo = mixxx::audio::ChannelCount::stereo();
+    EXPECT_EQ(1, AnalyzerDecimator::decimationFactor(mixxx::audio::SampleRate(44100), stereo));
+    EXPECT_EQ(1, AnalyzerDecimator::decimationFactor(mixxx::audio::SampleRate(48000), stereo));
+    EXPECT_EQ(4, AnalyzerDecimator::decimationFactor(mixxx::audio::SampleRate(88200), stereo));
+    EXPECT_EQ(4, AnalyzerDecimator::decimationFactor(mixxx::audio::SampleRate(96000), stereo));
+    EXPECT_EQ(8, AnalyzerDecimator::decimationFactor(mixxx::audio::SampleRate(192000), stereo));
+    // The analyzers mix the stems themselves
+    EXPECT_EQ(1,
+            AnalyzerDecimator::decimationFactor(mixxx::audio::SampleRate(96000),
+                    mixxx::audio::ChannelCount::stem()));
+}
+
+TEST_F(AnalyzerDecimatorTest, passesLowFrequencies) {
+    constexpr SINT kFrameLength = 10 * mixxx::kAnalysisFramesPerChunk + 123;
+    const auto samples = analyzeSine(440, kFrameLength);
+
+    EXPECT_EQ(1, m_originalDecimationFactor);
+    EXPECT_EQ(samples, m_originalSamples);
+
+    EXPECT_EQ(4, m_decimatedDecimationFactor);
+    ASSERT_EQ(static_cast<std::size_t>((kFrameLength + 3) / 4), m_decimatedSamples.size());
+    // Aligned with the original signal, apart from the edges
+    for (std::size_t i = 100; i < m_decimatedSamples.size() - 100; ++i) {
+        EXPECT_NEAR(samples[i * 4 * 2], m_decimatedSamples[i], 0.01) << i;
+    }
+}
+
+TEST_F(AnalyzerDecimatorTest, suppressesHighFrequencies) {
+    constexpr SINT kFrameLength = 10 * mixxx::kAnalysisFramesPerChunk;
+    // Above the Nyquist frequency of the decimated signal
+    analyzeSine(15000, kFrameLength);
+
+    for (std::size_t i = 100; i < m_decimatedSamples.size() - 100; ++i) {
+        EXPECT_NEAR(0, m_decimatedSamples[i], 0.001) << i;
+    }
+}
+
+} // namespace
@@ -0,0 +1,151 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr SINT kSamplesPerBlock = 64;
+
+// Records the samples it receives and fails after a given number of blocks
+class RecordingAnalyzer : public Analyzer {
+  public:
+    RecordingAnalyzer(std::vector<CSAMPLE>* pSamples, int failAfterBlocks = -1)
+            : m_pSamples(pSamples),
+              m_remainingBlocks(failAfterBlocks) {
+    }
+
+    bool initialize(const AnalyzerTrack&,
+            mixxx::audio::SampleRate,
+            mixxx::audio::ChannelCount,
+            SINT) override {
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        if (m_remainingBlocks == 0) {
+            return false;
+        }
+        --m_remainingBlocks;
+        m_pSamples->insert(m_pSamples->end(), pIn, pIn + count);
+        return true;
+    }
+
+    void storeResults(TrackPointer) override {
+    }
+
+    void cleanup() override {
+    }
+
+  private:
+    std::vector<CSAMPLE>* const m_pSamples;
+    int m_remainingBlocks;
+};
+
+class AnalyzerPipelineTest : public testing::TestWithParam<int> {
+  protected:
+    void initializeAnalyzers(std::vector<AnalyzerWithState>* pAnalyzers) {
+        const auto pTrack = Track::newTemporary();
+        for (auto& analyzer : *pAnalyzers) {
+            analyzer.initialize(AnalyzerTrack(pTrack),
+                    mixxx::audio::SampleRate(44100),
+                    mixxx::audio::ChannelCount::stereo(),
+                    0);
+        }
+    }
+
+    // Feeds numBlocks blocks with consecutive sample values
+    std::vector<CSAMPLE> feedBlocks(AnalyzerPipeline* pPipeline, int numBlocks) {
+        std::vector<CSAMPLE> expected;
+        CSAMPLE value = 0;
+        for (int block = 0; block < numBlocks; ++block) {
+            CSAMPLE* pBlock = pPipeline->nextBlock();
+            // Vary the length and offset of the samples within the block
+            const SINT offset = block % 3;
+            const SINT length = kSamplesPerBlock - offset - (block % 5);
+            for (SINT i = 0; i < length; ++i) {
+                pBlock[offset + i] = value;
+                expected.push_back(value);
+                value += 1;
+            }
+            pPipeline->commitBlock(pBlock + offset, length);
+        }
+        return expected;
+    }
+};
+
+TEST_P(AnalyzerPipelineTest, allAnalyzersReceiveAllSamplesInOrder) {
+    constexpr int kNumAnalyzers = 5;
+    std::vector<std::vector<CSAMPLE>> received(kNumAnalyzers);
+    std::vector<AnalyzerWithState> analyzers;
+    for (auto& samples : received) {
+        analyzers.emplace_back(std::make_unique<RecordingAnalyzer>(&samples));
+    }
+    initializeAnalyzers(&analyzers);
+
+    AnalyzerPipeline pipeline(GetParam(), 4, kSamplesPerBlock, QThread::InheritPriority);
+    // Process two tracks with the same pipeline
+    for (int track = 0; track < 2; ++track) {
+        for (auto& samples : received) {
+            samples.clear();
+        }
+        pipeline.begin(&analyzers);
+        const auto expected = feedBlocks(&pipeline, 100);
+        pipeline.end();
+        for (const auto& samples : received) {
+            EXPECT_EQ(expected, samples);
+        }
+    }
+
+    for (auto& analyzer : analyzers) {
+        analyzer.cancel();
+    }
+}
+
+TEST_P(AnalyzerPipelineTest, failedAnalyzerDoesNotBlockOthers) {
+    std::vector<CSAMPLE> failedSamples;
+    std::vector<CSAMPLE> samples;
+    std::vector<AnalyzerWithState> analyzers;
+    analyzers.emplace_back(std::make_unique<RecordingAnalyzer>(&failedSamples, 3));
+    analyzers.emplace_back(std::make_unique<RecordingAnalyzer>(&samples));
+    initializeAnalyzers(&analyzers);
+
+    AnalyzerPipeline pipeline(GetParam(), 2, kSamplesPerBlock, QThread::InheritPriority);
+    pipeline.begin(&analyzers);
+    const auto expected = feedBlocks(&pipeline, 20);
+    pipeline.end();
+
+    EXPECT_FALSE(analyzers[0].isActive());
+    EXPECT_EQ(expected, samples);
+    analyzers[1].cancel();
+}
+
+TEST_P(AnalyzerPipelineTest, cancelSkipsPendingBlocks) {
+    std::vector<CSAMPLE> samples;
+    std::vector<AnalyzerWithState> analyzers;
+    analyzers.emplace_back(std::make_unique<RecordingAnalyzer>(&samples));
+    initializeAnalyzers(&analyzers);
+
+    AnalyzerPipeline pipeline(GetParam(), 4, kSamplesPerBlock, QThread::InheritPriority);
+    pipeline.begin(&analyzers);
+    feedBlocks(&pipeline, 10);
+    pipeline.end(true);
+
+    // The pipeline is ready for the next track
+    samples.clear();
+    pipeline.begin(&analyzers);
+    const auto expected = feedBlocks(&pipeline, 10);
+    pipeline.end();
+    EXPECT_EQ(expected, samples);
+    analyzers[0].cancel();
+}
+
+INSTANTIATE_TEST_SUITE_P(AnalyzerPipelineTest,
+        AnalyzerPipelineTest,
+        testing::Values(1, 2, 3));
+
+} // namespace
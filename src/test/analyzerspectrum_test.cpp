@@ -0,0 +1,126 @@
+#include "analyzer/analyzerspectrum.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr int kWindowSize = 1024;
+constexpr int kStepSize = 512;
+
+// A mono sine wave with a frequency that matches the center of a bin
+std::vector<CSAMPLE> sine(int bin, SINT length) {
+    std::vector<CSAMPLE> samples(length);
+    for (SINT i = 0; i < length; ++i) {
+        samples[i] = static_cast<CSAMPLE>(
+                std::sin(2 * M_PI * bin * i / kWindowSize));
+    }
+    return samples;
+}
+
+TEST(AnalyzerSpectrumTest, sharesTransform) {
+    AnalyzerSpectrum spectrum;
+    std::vector<SINT> firstCenters;
+    std::vector<SINT> secondCenters;
+    std::vector<const double*> firstMagnitudes;
+    std::vector<const double*> secondMagnitudes;
+    {
+        auto first = spectrum.subscribe(kWindowSize,
+                kStepSize,
+                [&](const AnalyzerSpectrumFrame& frame) {
+                    firstCenters.push_back(frame.centerFrame);
+                    firstMagnitudes.push_back(frame.magnitudes);
+                });
+        auto second = spectrum.subscribe(kWindowSize,
+                kStepSize,
+                [&](const AnalyzerSpectrumFrame& frame) {
+                    secondCenters.push_back(frame.centerFrame);
+                    secondMagnitudes.push_back(frame.magnitudes);
+                });
+        ASSERT_TRUE(first);
+        ASSERT_TRUE(second);
+        EXPECT_TRUE(spectrum.hasSubscribers());
+
+        const auto samples = sine(10, 4 * kWindowSize);
+        spectrum.processMonoSamples(samples.data(), static_cast<SINT>(samples.size()));
+        spectrum.finalize();
+    }
+    EXPECT_FALSE(spectrum.hasSubscribers());
+    spectrum.reset();
+
+    ASSERT_FALSE(firstCenters.empty());
+    EXPECT_EQ(firstCenters, secondCenters);
+    // Both subscribers received the very same frames
+    EXPECT_EQ(firstMagnitudes, secondMagnitudes);
+    for (std::size_t i = 0; i < firstCenters.size(); ++i) {
+        EXPECT_EQ(static_cast<SINT>(i) * kStepSize, firstCenters[i]);
+    }
+}
+
+TEST(AnalyzerSpectrumTest, findsFrequency) {
+    constexpr int kBin = 37;
+    AnalyzerSpectrum spectrum;
+    std::vector<int> peaks;
+    auto subscription = spectrum.subscribe(kWindowSize,
+            kStepSize,
+            [&](const AnalyzerSpectrumFrame& frame) {
+                EXPECT_EQ(kWindowSize / 2 + 1, frame.binCount);
+                peaks.push_back(static_cast<int>(
+                        std::max_element(frame.magnitudes,
+                                frame.magnitudes + frame.binCount) -
+                        frame.magnitudes));
+            });
+
+    // Downmixed from stereo like DownmixAndOverlapHelper does
+    const auto mono = sine(kBin, 8 * kWindowSize);
+    std::vector<CSAMPLE> stereo(mono.size() * 2);
+    for (std::size_t i = 0; i < mono.size(); ++i) {
+        stereo[i * 2] = mono[i];
+        stereo[i * 2 + 1] = mono[i];
+    }
+    spectrum.processStereoSamples(stereo.data(), static_cast<SINT>(stereo.size()));
+    spectrum.finalize();
+    subscription.reset();
+
+    // Ignore the first and last frames that are padded with silence
+    ASSERT_GT(peaks.size(), 4u);
+    for (std::size_t i = 2; i < peaks.size() - 2; ++i) {
+        EXPECT_EQ(kBin, peaks[i]) << i;
+    }
+}
+
+TEST(AnalyzerSpectrumTest, separatesConfigurations) {
+    AnalyzerSpectrum spectrum;
+    int smallFrames = 0;
+    int largeFrames = 0;
+    auto small = spectrum.subscribe(kWindowSize,
+            kStepSize,
+            [&](const AnalyzerSpectrumFrame& frame) {
+                EXPECT_EQ(kWindowSize / 2 + 1, frame.binCount);
+                ++smallFrames;
+            });
+    auto large = spectrum.subscribe(2 * kWindowSize,
+            kStepSize,
+            [&](const AnalyzerSpectrumFrame& frame) {
+                EXPECT_EQ(kWindowSize + 1, frame.binCount);
+                ++largeFrames;
+            });
+
+    const auto samples = sine(10, 4 * kWindowSize);
+    spectrum.processMonoSamples(samples.data(), static_cast<SINT>(samples.size()));
+    small.reset();
+    EXPECT_TRUE(spectrum.hasSubscribers());
+    spectrum.finalize();
+    large.reset();
+    EXPECT_FALSE(spectrum.hasSubscribers());
+
+    EXPECT_GT(smallFrames, 0);
+    EXPECT_GT(largeFrames, 0);
+}
+
+} // namespace
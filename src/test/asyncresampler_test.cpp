@@ -0,0 +1,128 @@
+#include "soundio/asyncresampler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "soundio/driftcontroller.h"
+
+namespace {
+
+constexpr auto kStereo = mixxx::audio::ChannelCount::stereo();
+constexpr SINT kFramesPerBuffer = 256;
+// The output depends on the silence before the first input frame
+constexpr SINT kSettlingFrames = 8;
+
+std::vector<CSAMPLE> makeSine(double omega, SINT firstFrame, SINT frames) {
+    std::vector<CSAMPLE> samples(frames * 2);
+    for (SINT i = 0; i < frames; ++i) {
+        samples[i * 2] = static_cast<CSAMPLE>(std::sin(omega * (firstFrame + i)));
+        samples[i * 2 + 1] = static_cast<CSAMPLE>(std::cos(omega * (firstFrame + i)));
+    }
+    return samples;
+}
+
+TEST(AsyncResamplerTest, unityRatioPassesInputThrough) {
+    AsyncResampler resampler(kStereo, 4 * kFramesPerBuffer);
+    const auto input = makeSine(0.1, 0, kFramesPerBuffer);
+    ASSERT_EQ(kFramesPerBuffer,
+            resampler.write(input.data(), kFramesPerBuffer));
+
+    const SINT frames = resampler.framesAvailable();
+    ASSERT_GT(frames, kSettlingFrames);
+    ASSERT_LT(frames, kFramesPerBuffer);
+    std::vector<CSAMPLE> output(frames * 2);
+    resampler.read(output.data(), frames);
+    // Without delay, after the silence before the first frame
+    for (SINT i = kSettlingFrames * 2; i < frames * 2; ++i) {
+        EXPECT_NEAR(input[i], output[i], 1e-4);
+    }
+}
+
+TEST(AsyncResamplerTest, framesRequiredMakesFramesAvailable) {
+    AsyncResampler resampler(kStereo, 4 * kFramesPerBuffer);
+    resampler.setRatio(1.0007);
+    SINT firstFrame = 0;
+    for (int i = 0; i < 100; ++i) {
+        const SINT required = resampler.framesRequired(kFramesPerBuffer);
+        const auto input = makeSine(0.01, firstFrame, required);
+        resampler.write(input.data(), required);
+        firstFrame += required;
+        ASSERT_EQ(kFramesPerBuffer, resampler.framesAvailable());
+        ASSERT_EQ(0, resampler.framesRequired(kFramesPerBuffer));
+
+        std::vector<CSAMPLE> output(kFramesPerBuffer * 2);
+        resampler.read(output.data(), kFramesPerBuffer);
+    }
+}
+
+TEST(AsyncResamplerTest, resampledSineMatches) {
+    constexpr double kRatio = 0.9995;
+    // 1 kHz at 44.1 kHz
+    const double omega = 2 * M_PI * 1000 / 44100;
+    AsyncResampler resampler(kStereo, 4 * kFramesPerBuffer);
+    resampler.setRatio(kRatio);
+    SINT firstFrame = 0;
+    SINT outputFrame = 0;
+    for (int i = 0; i < 50; ++i) {
+        const SINT required = resampler.framesRequired(kFramesPerBuffer);
+        const auto input = makeSine(omega, firstFrame, required);
+        resampler.write(input.data(), required);
+        firstFrame += required;
+
+        std::vector<CSAMPLE> output(kFramesPerBuffer * 2);
+        resampler.read(output.data(), kFramesPerBuffer);
+        const SINT firstComparedFrame = i == 0 ? kSettlingFrames : 0;
+        for (SINT frame = firstComparedFrame; frame < kFramesPerBuffer; ++frame) {
+            const double position = (outputFrame + frame) * kRatio;
+            EXPECT_NEAR(std::sin(omega * position), output[frame * 2], 5e-4);
+            EXPECT_NEAR(std::cos(omega * position), output[frame * 2 + 1], 5e-4);
+        }
+        outputFrame += kFramesPerBuffer;
+    }
+}
+
+// The clock reference device writes a buffer into the FIFO once per period,
+// the other device, whose clock is faster by 100 ppm, reads a resampled
+// buffer with the ratio of the controller.
+TEST(DriftControllerTest, compensatesClockDrift) {
+    constexpr double kDrift = 0.0001;
+    DriftController controller;
+    double level = 1.5 * kFramesPerBuffer;
+    double consumed = 0.0;
+    double writeTime = 0.0;
+    double readTime = 0.37;
+    double minLevel = level;
+    double maxLevel = level;
+    for (int i = 0; i < 100000; ++i) {
+        if (writeTime <= readTime) {
+            level += kFramesPerBuffer;
+            writeTime += 1.0;
+            continue;
+        }
+        // Interpolate the level like SoundDevicePortAudio
+        const double elapsed = std::min(readTime - (writeTime - 1.0), 1.0);
+        const double ratio = controller.update(
+                level - kFramesPerBuffer + elapsed * kFramesPerBuffer,
+                kFramesPerBuffer);
+        consumed += kFramesPerBuffer * ratio;
+        const double frames = std::floor(consumed);
+        consumed -= frames;
+        level -= frames;
+        readTime += 1.0 / (1.0 + kDrift);
+        if (i > 50000) {
+            minLevel = std::min(minLevel, level);
+            maxLevel = std::max(maxLevel, level);
+        }
+    }
+    EXPECT_TRUE(controller.isLocked());
+    EXPECT_NEAR(-kDrift * 1000000, controller.driftPpm(), 5.0);
+    // The level is kept and the FIFO of 3 buffers neither underflows nor
+    // overflows.
+    EXPECT_GE(minLevel, 0.5 * kFramesPerBuffer);
+    EXPECT_LE(maxLevel, 2.5 * kFramesPerBuffer);
+}
+
+} // namespace
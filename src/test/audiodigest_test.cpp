@@ -0,0 +1,49 @@
+#include "analyzer/audiodigest.h"
+
+#include <gtest/gtest.h>
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+class AudioDigestTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    AudioDigestTest()
+            : m_tempBuffer(1024 * mixxx::audio::ChannelCount::stereo()) {
+    }
+
+    QByteArray digestFile(const QString& fileName) {
+        const auto pTrack = Track::newTemporary(
+                getTestDir().filePath(QStringLiteral("id3-test-data/") + fileName));
+        mixxx::AudioSource::OpenParams openParams;
+        openParams.setChannelCount(mixxx::audio::ChannelCount::stereo());
+        const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+        EXPECT_TRUE(pAudioSource);
+        if (!pAudioSource) {
+            return QByteArray();
+        }
+        return mixxx::digestAudioSource(
+                pAudioSource, mixxx::SampleBuffer::WritableSlice(m_tempBuffer));
+    }
+
+    mixxx::SampleBuffer m_tempBuffer;
+};
+
+TEST_F(AudioDigestTest, sameAudioWithDifferentTags) {
+    // Both files only differ in their embedded cover art
+    const QByteArray digest = digestFile(QStringLiteral("cover-test-png.mp3"));
+    EXPECT_FALSE(digest.isEmpty());
+    EXPECT_EQ(digest, digestFile(QStringLiteral("cover-test-png.mp3")));
+    EXPECT_EQ(digest, digestFile(QStringLiteral("cover-test-jpg.mp3")));
+}
+
+TEST_F(AudioDigestTest, differentAudio) {
+    // Encoded from the same source, but with a variable bitrate
+    EXPECT_NE(digestFile(QStringLiteral("cover-test-png.mp3")),
+            digestFile(QStringLiteral("cover-test-vbr.mp3")));
+}
+
+} // namespace
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <QVector>
+
+#include "track/beats.h"
+
+// Measures the beat lookups of the engine controls while playing, i.e. for
+// positions that advance by a buffer each, for a beat grid and a beat map
+// with a marker per beat. The argument is the number of beats. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_Beats
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr auto kBpm = mixxx::Bpm(120);
+constexpr mixxx::audio::FrameDiff_t kFramesPerBuffer = 512;
+
+mixxx::BeatsPointer createBeats(bool constTempo, int beatCount) {
+    if (constTempo) {
+        return mixxx::Beats::fromConstTempo(
+                kSampleRate, mixxx::audio::kStartFramePos, kBpm);
+    }
+    // Like a beat map of a live recording, the beats are not evenly spaced
+    QVector<mixxx::audio::FramePos> beatPositions;
+    beatPositions.reserve(beatCount);
+    auto beatPosition = mixxx::audio::kStartFramePos;
+    for (int i = 0; i < beatCount; ++i) {
+        beatPositions.append(beatPosition);
+        beatPosition += kSampleRate.value() / 2 + (i % 5) * 20;
+    }
+    return mixxx::Beats::fromBeatPositions(kSampleRate, beatPositions);
+}
+
+void BM_Beats_FindPrevNextBeats(benchmark::State& state, bool constTempo, bool useCursor) {
+    const int beatCount = static_cast<int>(state.range(0));
+    const auto pBeats = createBeats(constTempo, beatCount);
+    const auto endPosition = mixxx::audio::kStartFramePos +
+            static_cast<double>(beatCount) * kSampleRate.value() / 2;
+    const mixxx::Beats::Cursor cursor;
+    auto position = mixxx::audio::kStartFramePos;
+    for (auto _ : state) {
+        mixxx::audio::FramePos prevBeatPosition;
+        mixxx::audio::FramePos nextBeatPosition;
+        benchmark::DoNotOptimize(pBeats->findPrevNextBeats(position,
+                &prevBeatPosition,
+                &nextBeatPosition,
+                false,
+                useCursor ? &cursor : nullptr));
+        benchmark::DoNotOptimize(prevBeatPosition);
+        benchmark::DoNotOptimize(nextBeatPosition);
+        position += kFramesPerBuffer;
+        if (position >= endPosition) {
+            position = mixxx::audio::kStartFramePos;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Beats_FindNthBeat(benchmark::State& state, bool constTempo, bool useCursor) {
+    const int beatCount = static_cast<int>(state.range(0));
+    const auto pBeats = createBeats(constTempo, beatCount);
+    const auto endPosition = mixxx::audio::kStartFramePos +
+            static_cast<double>(beatCount) * kSampleRate.value() / 2;
+    const mixxx::Beats::Cursor cursor;
+    auto position = mixxx::audio::kStartFramePos;
+    for (auto _ : state) {
+        // Like the quantized beat loops
+        benchmark::DoNotOptimize(pBeats->findNthBeat(
+                position, -2, useCursor ? &cursor : nullptr));
+        position += kFramesPerBuffer;
+        if (position >= endPosition) {
+            position = mixxx::audio::kStartFramePos;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_Beats_FindPrevNextBeats, BeatGrid, true, false)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_Beats_FindPrevNextBeats, BeatMap, false, false)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_Beats_FindPrevNextBeats, BeatMapCursor, false, true)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_Beats_FindNthBeat, BeatGrid, true, false)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_Beats_FindNthBeat, BeatMap, false, false)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_Beats_FindNthBeat, BeatMapCursor, false, true)->Range(64, 4096);
+
+} // namespace
@@ -537,4 +537,65 @@ TEST(BeatsTest, ConstTempoFindPrevNextBeatWhenNotOnBeat) {
     EXPECT_NEAR(nextBeat.value(), foundNextBeat.value(), kMaxBeatError);
 }
 
+TEST(BeatsTest, NonConstTempoCursor) {
+    // Beats with a slightly different length each, i.e. one marker per beat
+    QVector<audio::FramePos> beatPositions;
+    auto beatPosition = kStartPosition;
+    for (int i = 0; i < 500; ++i) {
+        beatPositions.append(beatPosition);
+        beatPosition += kSampleRate.value() / 2 + (i % 7) * 10;
+    }
+    const auto pBeats = Beats::fromBeatPositions(kSampleRate, beatPositions);
+    ASSERT_NE(nullptr, pBeats);
+
+    const auto expectSameAsWithoutCursor = [&pBeats](audio::FramePos position,
+                                                   const Beats::Cursor* pCursor) {
+        audio::FramePos prevBeat;
+        audio::FramePos nextBeat;
+        const bool found = pBeats->findPrevNextBeats(position, &prevBeat, &nextBeat, false);
+        audio::FramePos cursorPrevBeat;
+        audio::FramePos cursorNextBeat;
+        EXPECT_EQ(found,
+                pBeats->findPrevNextBeats(
+                        position, &cursorPrevBeat, &cursorNextBeat, false, pCursor));
+        EXPECT_EQ(prevBeat, cursorPrevBeat);
+        EXPECT_EQ(nextBeat, cursorNextBeat);
+        EXPECT_EQ(pBeats->findNthBeat(position, 3),
+                pBeats->findNthBeat(position, 3, pCursor));
+        EXPECT_EQ(pBeats->findClosestBeat(position),
+                pBeats->findClosestBeat(position, pCursor));
+    };
+
+    // Playing forward and backward, including positions exactly on beats
+    const Beats::Cursor cursor;
+    for (auto position = audio::FramePos(0); position < beatPosition + 2 * kSampleRate.value();
+            position += 1000) {
+        expectSameAsWithoutCursor(position, &cursor);
+    }
+    for (auto it = beatPositions.crbegin(); it != beatPositions.crend(); ++it) {
+        expectSameAsWithoutCursor(*it, &cursor);
+        expectSameAsWithoutCursor(*it - 1, &cursor);
+    }
+
+    // Seeking around
+    for (int i = 0; i < 100; ++i) {
+        expectSameAsWithoutCursor(beatPositions[(i * 137) % beatPositions.size()] + i, &cursor);
+    }
+
+    // The same cursor with other beats
+    const Beats::Cursor otherCursor;
+    for (auto position = kStartPosition; position < kEndPosition; position += 10000) {
+        audio::FramePos prevBeat;
+        audio::FramePos nextBeat;
+        kNonConstTempoBeats.findPrevNextBeats(position, &prevBeat, &nextBeat, false);
+        audio::FramePos cursorPrevBeat;
+        audio::FramePos cursorNextBeat;
+        kNonConstTempoBeats.findPrevNextBeats(
+                position, &cursorPrevBeat, &cursorNextBeat, false, &otherCursor);
+        EXPECT_EQ(prevBeat, cursorPrevBeat);
+        EXPECT_EQ(nextBeat, cursorNextBeat);
+        expectSameAsWithoutCursor(position, &otherCursor);
+    }
+}
+
 } // namespace
@@ -0,0 +1,219 @@
+#include "test/builtineffects_benchmark.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QSet>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "control/controlpotmeter.h"
+#include "effects/backends/builtin/builtinbackend.h"
+#include "effects/backends/effectmanifest.h"
+#include "effects/backends/effectprocessor.h"
+#include "effects/defs.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "engine/engine.h"
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+// Measures every built-in effect with its default parameters, with all
+// parameters at their minimum or maximum and while all parameters are swept
+// like knobs that are turned, for the common buffer sizes and sample rates.
+// The argument is the number of frames per buffer. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_BuiltInEffect
+//
+// Besides the time per frame, the "load" counter reports the fraction of
+// the real-time duration of the buffer that has been spent processing it.
+// If MIXXX_EFFECT_BENCHMARK_MAX_LOAD is set, e.g. to 0.02 for 2 %, every
+// benchmark that exceeds this load is reported as an error, which is
+// flagged with "error_occurred" in the JSON output for CI.
+//
+// The benchmarks are registered by main(), because the manifests must not
+// be created during static initialization.
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRates[] = {
+        mixxx::audio::SampleRate(44100),
+        mixxx::audio::SampleRate(48000),
+        mixxx::audio::SampleRate(96000),
+};
+
+enum class ParameterValues {
+    Default,
+    Minimum,
+    Maximum,
+    Sweep,
+};
+
+// The parameters are swept from their minimum to their maximum and back
+constexpr double kSweepPeriodSeconds = 2.0;
+
+const char* parameterValuesName(ParameterValues values) {
+    switch (values) {
+    case ParameterValues::Default:
+        return "Default";
+    case ParameterValues::Minimum:
+        return "Minimum";
+    case ParameterValues::Maximum:
+        return "Maximum";
+    case ParameterValues::Sweep:
+        return "Sweep";
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return "";
+}
+
+double maxLoad() {
+    const char* pMaxLoad = std::getenv("MIXXX_EFFECT_BENCHMARK_MAX_LOAD");
+    return pMaxLoad ? std::atof(pMaxLoad) : 0.0;
+}
+
+void BM_BuiltInEffect(benchmark::State& state,
+        const BuiltInBackend* pBackend,
+        EffectManifestPointer pManifest,
+        mixxx::audio::SampleRate sampleRate,
+        ParameterValues values) {
+    // Required by the EQ effects
+    ControlPotmeter loEqFrequency(ConfigKey(kMixerProfile, kLowEqFrequency), 0., 22040);
+    loEqFrequency.set(250.0);
+    ControlPotmeter hiEqFrequency(ConfigKey(kMixerProfile, kHighEqFrequency), 0., 22040);
+    hiEqFrequency.set(2500.0);
+
+    const mixxx::EngineParameters engineParameters(
+            sampleRate, static_cast<SINT>(state.range(0)));
+
+    std::unique_ptr<EffectProcessor> pProcessor = pBackend->createProcessor(pManifest);
+    QMap<QString, EngineEffectParameterPointer> parameters;
+    std::vector<std::pair<EngineEffectParameterPointer, EffectManifestParameterPointer>>
+            sweptParameters;
+    for (const auto& pParameterManifest : pManifest->parameters()) {
+        EngineEffectParameterPointer pParameter(new EngineEffectParameter(pParameterManifest));
+        switch (values) {
+        case ParameterValues::Default:
+            break;
+        case ParameterValues::Sweep:
+            sweptParameters.emplace_back(pParameter, pParameterManifest);
+            break;
+        case ParameterValues::Minimum:
+            pParameter->setValue(pParameterManifest->getMinimum());
+            break;
+        case ParameterValues::Maximum:
+            pParameter->setValue(pParameterManifest->getMaximum());
+            break;
+        }
+        parameters.insert(pParameterManifest->id(), pParameter);
+    }
+    pProcessor->loadEngineEffectParameters(parameters);
+
+    ChannelHandleFactory factory;
+    const QString group = QStringLiteral("[Channel1]");
+    const ChannelHandleAndGroup channel(factory.getOrCreateHandle(group), group);
+    const QSet<ChannelHandleAndGroup> channels = {channel};
+    pProcessor->initialize(channels, channels, engineParameters);
+
+    // A track at 128 BPM for the tempo synced effects
+    GroupFeatureState groupFeatures;
+    groupFeatures.beat_length = GroupFeatureBeatLength{
+            sampleRate.toDouble() * 60 / 128, 1.0};
+    groupFeatures.beat_fraction_buffer_end = 0.5;
+    groupFeatures.gain = 1.0;
+
+    mixxx::SampleBuffer input(engineParameters.samplesPerBuffer());
+    mixxx::SampleBuffer output(engineParameters.samplesPerBuffer());
+    std::mt19937 gen; // explicitly don't seed for reproducibility
+    std::uniform_real_distribution<CSAMPLE> value(-1.0f, 1.0f);
+    for (SINT i = 0; i < input.size(); ++i) {
+        input[i] = value(gen);
+    }
+
+    // Settle the effect, the first buffer is ramped
+    pProcessor->process(channel.handle(),
+            channel.handle(),
+            input.data(),
+            output.data(),
+            engineParameters,
+            EffectEnableState::Enabling,
+            groupFeatures);
+
+    const double sweepIncrement = values == ParameterValues::Sweep
+            ? 2.0 * state.range(0) / (kSweepPeriodSeconds * sampleRate.toDouble())
+            : 0.0;
+    double sweepPosition = 0.0;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        if (sweepIncrement > 0) {
+            // A triangle from 0 to 1 and back
+            sweepPosition = std::fmod(sweepPosition + sweepIncrement, 2.0);
+            const double fraction = sweepPosition <= 1.0 ? sweepPosition : 2.0 - sweepPosition;
+            for (const auto& [pParameter, pParameterManifest] : sweptParameters) {
+                const double minimum = pParameterManifest->getMinimum();
+                const double maximum = pParameterManifest->getMaximum();
+                pParameter->setValue(math_clamp(
+                        minimum + fraction * (maximum - minimum), minimum, maximum));
+            }
+        }
+        pProcessor->process(channel.handle(),
+                channel.handle(),
+                input.data(),
+                output.data(),
+                engineParameters,
+                EffectEnableState::Enabled,
+                groupFeatures);
+        benchmark::DoNotOptimize(output.data());
+    }
+    const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - startTime;
+
+    const double frames = static_cast<double>(state.iterations()) * state.range(0);
+    state.SetItemsProcessed(static_cast<int64_t>(frames));
+    state.counters["ns_per_frame"] = benchmark::Counter(frames * 1e-9,
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    // The processing time relative to the duration of the processed frames
+    state.counters["load"] = benchmark::Counter(frames / sampleRate.toDouble(),
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+
+    const double budget = maxLoad();
+    if (budget > 0 && elapsed.count() > budget * frames / sampleRate.toDouble()) {
+        state.SkipWithError("The load exceeds MIXXX_EFFECT_BENCHMARK_MAX_LOAD");
+    }
+}
+
+} // namespace
+
+void registerBuiltInEffectBenchmarks() {
+    // The manifests only describe the effects, the processors are created
+    // when the benchmarks run
+    static const BuiltInBackend s_backend;
+    for (const auto& pManifest : s_backend.getManifests()) {
+        for (const auto sampleRate : kSampleRates) {
+            for (const auto values : {ParameterValues::Default,
+                         ParameterValues::Minimum,
+                         ParameterValues::Maximum,
+                         ParameterValues::Sweep}) {
+                const QString name = QStringLiteral("BM_BuiltInEffect/%1/%2/%3")
+                                             .arg(pManifest->id(),
+                                                     QString::number(sampleRate.value()),
+                                                     QLatin1String(parameterValuesName(values)));
+                benchmark::RegisterBenchmark(name.toStdString().c_str(),
+                        BM_BuiltInEffect,
+                        &s_backend,
+                        pManifest,
+                        sampleRate,
+                        values)
+                        ->RangeMultiplier(2)
+                        ->Range(64, 4096);
+            }
+        }
+    }
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+/// Registers the benchmarks of all built-in effects. Must be called after
+/// static initialization and before running the benchmarks.
+void registerBuiltInEffectBenchmarks();
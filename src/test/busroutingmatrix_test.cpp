@@ -0,0 +1,83 @@
+#include "engine/busroutingmatrix.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr std::size_t kBufferSize = 256;
+constexpr int kNumSources = 3;
+constexpr int kNumBuses = 2;
+
+class BusRoutingMatrixTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        for (int k = 0; k < kNumSources; ++k) {
+            m_sources.emplace_back(kBufferSize);
+            for (std::size_t i = 0; i < kBufferSize; ++i) {
+                m_sources.back().data()[i] =
+                        static_cast<CSAMPLE>((i + k) % 13) / 13 - 0.5f;
+            }
+            m_pSources[k] = m_sources.back().data();
+        }
+    }
+
+    std::vector<mixxx::SampleBuffer> m_sources;
+    std::array<const CSAMPLE*, kNumSources> m_pSources{};
+};
+
+TEST_F(BusRoutingMatrixTest, mixesEachBusWithItsGains) {
+    BusRoutingMatrix matrix(kNumSources, kNumBuses);
+    matrix.setBusGain(0, CSAMPLE_GAIN_ONE);
+    matrix.setGain(1, 1, 0.5f);
+    matrix.skipGainRamps();
+
+    mixxx::SampleBuffer bus0(kBufferSize);
+    mixxx::SampleBuffer bus1(kBufferSize);
+    bus0.fill(1.0f);
+    bus1.fill(1.0f);
+    const std::array<CSAMPLE*, kNumBuses> outputs{bus0.data(), bus1.data()};
+    matrix.process(m_pSources.data(), outputs.data(), kBufferSize);
+
+    for (std::size_t i = 0; i < kBufferSize; ++i) {
+        EXPECT_FLOAT_EQ(m_pSources[0][i] + m_pSources[1][i] + m_pSources[2][i],
+                bus0.data()[i]);
+        EXPECT_FLOAT_EQ(m_pSources[1][i] * 0.5f, bus1.data()[i]);
+    }
+}
+
+TEST_F(BusRoutingMatrixTest, skippedBusRampsFromPreviousGain) {
+    BusRoutingMatrix matrix(kNumSources, kNumBuses);
+    matrix.setBusGain(1, 0.2f);
+    matrix.skipGainRamps();
+
+    // Not processed, so the gain change isn't applied
+    mixxx::SampleBuffer bus1(kBufferSize);
+    bus1.fill(1.0f);
+    std::array<CSAMPLE*, kNumBuses> outputs{nullptr, nullptr};
+    matrix.setBusGain(1, 0.8f);
+    matrix.process(m_pSources.data(), outputs.data(), kBufferSize);
+    for (std::size_t i = 0; i < kBufferSize; ++i) {
+        EXPECT_EQ(1.0f, bus1.data()[i]);
+    }
+
+    mixxx::SampleBuffer expected(kBufferSize);
+    expected.fill(0);
+    for (const CSAMPLE* pSource : m_pSources) {
+        SampleUtil::addWithRampingGain(
+                expected.data(), pSource, 0.2f, 0.8f, kBufferSize);
+    }
+    outputs[1] = bus1.data();
+    matrix.process(m_pSources.data(), outputs.data(), kBufferSize);
+    for (std::size_t i = 0; i < kBufferSize; ++i) {
+        // The summation order differs
+        EXPECT_NEAR(expected.data()[i], bus1.data()[i], 1e-5f) << "index " << i;
+    }
+}
+
+} // namespace
@@ -0,0 +1,81 @@
+#include "engine/cachingreader/cachingreader.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "test/mixxxtest.h"
+
+class CachingReaderTest : public MixxxTest {
+  protected:
+    static constexpr int kGrowth = 16;
+
+    void SetUp() override {
+        m_pReader = std::make_unique<CachingReader>(QStringLiteral("[Channel1]"),
+                config(),
+                mixxx::audio::ChannelCount::stereo());
+    }
+
+    void TearDown() override {
+        m_pReader.reset();
+    }
+
+    /// Hands over a new block of chunks like growChunkPool() and receives
+    /// it like the engine thread
+    bool growAndReceive(int chunkCount) {
+        auto* pBlock = new CachingReader::ChunkBlock(
+                chunkCount, mixxx::audio::ChannelCount::stereo());
+        if (m_pReader->m_chunkBlockFIFO.write(&pBlock, 1) != 1) {
+            delete pBlock;
+            return false;
+        }
+        m_pReader->receiveChunkBlocks();
+        return true;
+    }
+
+    /// Allocates all free chunks and frees them again
+    int allocateAndFreeAll() {
+        std::vector<CachingReaderChunkForOwner*> chunks;
+        while (auto* pChunk = m_pReader->allocateChunk(static_cast<SINT>(chunks.size()))) {
+            chunks.push_back(pChunk);
+        }
+        for (auto* pChunk : chunks) {
+            m_pReader->freeChunk(pChunk);
+        }
+        return static_cast<int>(chunks.size());
+    }
+
+    const std::vector<CachingReaderChunkForOwner*>& freeChunks() const {
+        return m_pReader->m_freeChunks;
+    }
+
+    int chunkCount() const {
+        return m_pReader->m_chunks.size();
+    }
+
+    int maxChunkCount() const {
+        return m_pReader->m_maxChunkCount;
+    }
+
+    std::unique_ptr<CachingReader> m_pReader;
+};
+
+TEST_F(CachingReaderTest, FreeListIsPreallocated) {
+    // The engine thread never reallocates the free list, neither when new
+    // chunks are received nor when chunks are allocated and freed
+    ASSERT_GE(static_cast<int>(freeChunks().capacity()), maxChunkCount());
+    const auto* pFreeChunks = freeChunks().data();
+    const int initialCount = chunkCount();
+    EXPECT_EQ(initialCount, static_cast<int>(freeChunks().size()));
+
+    ASSERT_LE(initialCount + kGrowth, maxChunkCount());
+    ASSERT_TRUE(growAndReceive(kGrowth));
+    EXPECT_EQ(initialCount + kGrowth, chunkCount());
+    EXPECT_EQ(initialCount + kGrowth, static_cast<int>(freeChunks().size()));
+    EXPECT_EQ(pFreeChunks, freeChunks().data());
+
+    EXPECT_EQ(initialCount + kGrowth, allocateAndFreeAll());
+    EXPECT_EQ(initialCount + kGrowth, static_cast<int>(freeChunks().size()));
+    EXPECT_EQ(pFreeChunks, freeChunks().data());
+}
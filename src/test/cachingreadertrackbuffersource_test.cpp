@@ -0,0 +1,133 @@
+#include "engine/cachingreader/cachingreadertrackbuffersource.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+#include "engine/cachingreader/cachingreadertrackbuffer.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kReadFrames = 4096;
+
+class CachingReaderTrackBufferSourceTest : public MixxxTest,
+                                           SoundSourceProviderRegistration {
+  protected:
+    CachingReaderTrackBufferSourceTest()
+            : m_openParams(mixxx::audio::ChannelCount::stereo(),
+                      mixxx::audio::SampleRate()) {
+        m_pTrack = Track::newDummy(
+                getTestDir().filePath(QStringLiteral("stems/mainmix.wav")),
+                TrackId(QVariant(1)));
+    }
+
+    mixxx::AudioSourcePointer openFile() const {
+        return SoundSourceProxy(m_pTrack).openAudioSource(m_openParams);
+    }
+
+    // Shares a buffer that has been filled with the given number of frames
+    std::shared_ptr<CachingReaderTrackBuffer> shareTrackBuffer(SINT frameCount) {
+        const auto pAudioSource = openFile();
+        EXPECT_TRUE(pAudioSource);
+        auto pTrackBuffer = std::make_shared<CachingReaderTrackBuffer>(
+                pAudioSource->frameIndexRange(),
+                pAudioSource->getSignalInfo().getChannelCount());
+        mixxx::SampleBuffer tempBuffer(
+                pAudioSource->getSignalInfo().frames2samples(kReadFrames));
+        while (pTrackBuffer->bufferedFrameIndexRange().length() < frameCount &&
+                !pTrackBuffer->isComplete()) {
+            EXPECT_TRUE(pTrackBuffer->bufferNextSampleFrames(pAudioSource,
+                    mixxx::SampleBuffer::WritableSlice(tempBuffer),
+                    kReadFrames));
+        }
+        CachingReaderTrackBufferSource::shareTrackBuffer(
+                m_pTrack->getId(), m_openParams, *pAudioSource, pTrackBuffer);
+        return pTrackBuffer;
+    }
+
+    static std::vector<CSAMPLE> readAll(const mixxx::AudioSourcePointer& pAudioSource) {
+        std::vector<CSAMPLE> samples;
+        mixxx::SampleBuffer buffer(
+                pAudioSource->getSignalInfo().frames2samples(kReadFrames));
+        mixxx::IndexRange remainingFrameRange = pAudioSource->frameIndexRange();
+        while (!remainingFrameRange.empty()) {
+            const auto frameRange = remainingFrameRange.splitAndShrinkFront(
+                    math_min(kReadFrames, remainingFrameRange.length()));
+            const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(frameRange,
+                            mixxx::SampleBuffer::WritableSlice(buffer)));
+            EXPECT_EQ(frameRange, readableSampleFrames.frameIndexRange());
+            samples.insert(samples.end(),
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableData() +
+                            readableSampleFrames.readableLength());
+        }
+        return samples;
+    }
+
+    const mixxx::AudioSource::OpenParams m_openParams;
+    TrackPointer m_pTrack;
+};
+
+TEST_F(CachingReaderTrackBufferSourceTest, readsSharedTrackBuffer) {
+    const auto pTrackBuffer = shareTrackBuffer(std::numeric_limits<SINT>::max());
+    ASSERT_TRUE(pTrackBuffer->isComplete());
+
+    const auto pAudioSource = CachingReaderTrackBufferSource::open(m_pTrack, m_openParams);
+    ASSERT_TRUE(pAudioSource);
+    EXPECT_EQ(pTrackBuffer->frameIndexRange(), pAudioSource->frameIndexRange());
+    EXPECT_EQ(readAll(openFile()), readAll(pAudioSource));
+}
+
+TEST_F(CachingReaderTrackBufferSourceTest, decodesFileWhenAbandoned) {
+    const auto pTrackBuffer = shareTrackBuffer(10 * kReadFrames);
+    ASSERT_FALSE(pTrackBuffer->isComplete());
+
+    const auto pAudioSource = CachingReaderTrackBufferSource::open(m_pTrack, m_openParams);
+    ASSERT_TRUE(pAudioSource);
+    // The remaining frames are decoded from the file without waiting
+    pTrackBuffer->abandon();
+    EXPECT_EQ(readAll(openFile()), readAll(pAudioSource));
+    // Not shared anymore
+    EXPECT_FALSE(CachingReaderTrackBufferSource::open(m_pTrack, m_openParams));
+}
+
+TEST_F(CachingReaderTrackBufferSourceTest, requiresMatchingParameters) {
+    auto pTrackBuffer = shareTrackBuffer(kReadFrames);
+
+    mixxx::AudioSource::OpenParams openParams = m_openParams;
+    openParams.setChannelCount(mixxx::audio::ChannelCount::stem());
+    EXPECT_FALSE(CachingReaderTrackBufferSource::open(m_pTrack, openParams));
+
+    // Released by the worker
+    pTrackBuffer.reset();
+    EXPECT_FALSE(CachingReaderTrackBufferSource::open(m_pTrack, m_openParams));
+}
+
+TEST_F(CachingReaderTrackBufferSourceTest, sharesOnlyCompleteTrackBuffers) {
+    const auto pAudioSource = openFile();
+    ASSERT_TRUE(pAudioSource);
+    auto pTrackBuffer = shareTrackBuffer(kReadFrames);
+    ASSERT_FALSE(pTrackBuffer->isComplete());
+    EXPECT_FALSE(CachingReaderTrackBufferSource::completeTrackBuffer(
+            m_pTrack->getId(), m_openParams, *pAudioSource));
+
+    pTrackBuffer = shareTrackBuffer(std::numeric_limits<SINT>::max());
+    ASSERT_TRUE(pTrackBuffer->isComplete());
+    EXPECT_EQ(pTrackBuffer,
+            CachingReaderTrackBufferSource::completeTrackBuffer(
+                    m_pTrack->getId(), m_openParams, *pAudioSource));
+
+    mixxx::AudioSource::OpenParams openParams = m_openParams;
+    openParams.setChannelCount(mixxx::audio::ChannelCount::stem());
+    EXPECT_FALSE(CachingReaderTrackBufferSource::completeTrackBuffer(
+            m_pTrack->getId(), openParams, *pAudioSource));
+}
+
+} // namespace
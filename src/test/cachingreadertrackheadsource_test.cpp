@@ -0,0 +1,82 @@
+#include "engine/cachingreader/cachingreadertrackheadsource.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <vector>
+
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kReadFrames = 4096;
+
+class CachingReaderTrackHeadSourceTest : public MixxxTest,
+                                         SoundSourceProviderRegistration {
+  protected:
+    CachingReaderTrackHeadSourceTest()
+            : m_openParams(mixxx::audio::ChannelCount::stereo(),
+                      mixxx::audio::SampleRate()) {
+        m_pTrack = Track::newDummy(
+                getTestDir().filePath(QStringLiteral("stems/mainmix.wav")),
+                TrackId(QVariant(2)));
+    }
+
+    ~CachingReaderTrackHeadSourceTest() override {
+        CachingReaderTrackHeadSource::stopDecoding();
+    }
+
+    mixxx::AudioSourcePointer waitForTrackHead() const {
+        for (int i = 0; i < 1000; ++i) {
+            auto pAudioSource = CachingReaderTrackHeadSource::open(m_pTrack, m_openParams);
+            if (pAudioSource) {
+                return pAudioSource;
+            }
+            QThread::msleep(5);
+        }
+        return nullptr;
+    }
+
+    static std::vector<CSAMPLE> read(
+            const mixxx::AudioSourcePointer& pAudioSource, SINT frameIndex) {
+        mixxx::SampleBuffer buffer(
+                pAudioSource->getSignalInfo().frames2samples(kReadFrames));
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        mixxx::IndexRange::forward(frameIndex, kReadFrames),
+                        mixxx::SampleBuffer::WritableSlice(buffer)));
+        EXPECT_EQ(kReadFrames, readableSampleFrames.frameIndexRange().length());
+        return std::vector<CSAMPLE>(readableSampleFrames.readableData(),
+                readableSampleFrames.readableData() +
+                        readableSampleFrames.readableLength());
+    }
+
+    const mixxx::AudioSource::OpenParams m_openParams;
+    TrackPointer m_pTrack;
+};
+
+TEST_F(CachingReaderTrackHeadSourceTest, readsDecodedHeadAndFile) {
+    EXPECT_FALSE(CachingReaderTrackHeadSource::open(m_pTrack, m_openParams));
+    CachingReaderTrackHeadSource::decodeInBackground(m_pTrack, m_openParams);
+    const auto pAudioSource = waitForTrackHead();
+    ASSERT_TRUE(pAudioSource);
+
+    const auto pFileAudioSource = SoundSourceProxy(m_pTrack).openAudioSource(m_openParams);
+    ASSERT_TRUE(pFileAudioSource);
+    EXPECT_EQ(pFileAudioSource->getSignalInfo(), pAudioSource->getSignalInfo());
+    EXPECT_EQ(pFileAudioSource->frameIndexRange(), pAudioSource->frameIndexRange());
+    // From memory
+    EXPECT_EQ(read(pFileAudioSource, 0), read(pAudioSource, 0));
+    // Decoded from the file
+    const SINT lastFrameIndex = pFileAudioSource->frameIndexRange().end() - kReadFrames;
+    EXPECT_EQ(read(pFileAudioSource, lastFrameIndex), read(pAudioSource, lastFrameIndex));
+
+    mixxx::AudioSource::OpenParams openParams = m_openParams;
+    openParams.setChannelCount(mixxx::audio::ChannelCount::stem());
+    EXPECT_FALSE(CachingReaderTrackHeadSource::open(m_pTrack, openParams));
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+#include "engine/channelmixer.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+namespace {
+
+constexpr std::size_t kBufferSize = 1024;
+
+// Fills the buffers and creates sources with individual gain ramps
+std::vector<ChannelMixer::RampingSource> makeSources(
+        std::vector<mixxx::SampleBuffer>* pBuffers, int numSources) {
+    std::vector<ChannelMixer::RampingSource> sources;
+    for (int k = 0; k < numSources; ++k) {
+        pBuffers->emplace_back(kBufferSize);
+        mixxx::SampleBuffer& buffer = pBuffers->back();
+        for (std::size_t i = 0; i < kBufferSize; ++i) {
+            buffer.data()[i] = static_cast<CSAMPLE>((i + k) % 17) / 17 - 0.5f;
+        }
+        const CSAMPLE_GAIN oldGain = 0.1f * (k % 10);
+        const CSAMPLE_GAIN newGain = 1.0f - 0.05f * (k % 20);
+        const CSAMPLE_GAIN gainDelta = (newGain - oldGain) / (kBufferSize / 2);
+        sources.push_back({buffer.data(), oldGain + gainDelta, gainDelta});
+    }
+    return sources;
+}
+
+class ChannelMixerTest : public testing::TestWithParam<int> {};
+
+TEST_P(ChannelMixerTest, addRampingSourcesMatchesAddWithRampingGain) {
+    const int numSources = GetParam();
+    std::vector<mixxx::SampleBuffer> buffers;
+    const auto sources = makeSources(&buffers, numSources);
+
+    mixxx::SampleBuffer expected(kBufferSize);
+    expected.fill(0.25f);
+    for (const auto& source : sources) {
+        const CSAMPLE_GAIN oldGain = source.startGain - source.gainDelta;
+        const CSAMPLE_GAIN newGain = oldGain + source.gainDelta * (kBufferSize / 2);
+        SampleUtil::addWithRampingGain(
+                expected.data(), source.pBuffer, oldGain, newGain, kBufferSize);
+    }
+
+    mixxx::SampleBuffer actual(kBufferSize);
+    actual.fill(0.25f);
+    ChannelMixer::addRampingSources(actual.data(), sources.data(), numSources, kBufferSize);
+
+    for (std::size_t i = 0; i < kBufferSize; ++i) {
+        // The summation order differs
+        EXPECT_NEAR(expected.data()[i], actual.data()[i], 1e-5f) << "index " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(ChannelMixerTest,
+        ChannelMixerTest,
+        testing::Values(0, 1, 2, 4, 7, 8, 9, 16, 17));
+
+static void BM_AddRampingSources(benchmark::State& state) {
+    const auto numSources = static_cast<int>(state.range(0));
+    std::vector<mixxx::SampleBuffer> buffers;
+    const auto sources = makeSources(&buffers, numSources);
+    mixxx::SampleBuffer output(kBufferSize);
+    output.fill(0);
+
+    for (auto _ : state) {
+        ChannelMixer::addRampingSources(output.data(), sources.data(), numSources, kBufferSize);
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+BENCHMARK(BM_AddRampingSources)->Arg(4)->Arg(8)->Arg(16);
+
+// The previous approach: mix each source separately
+static void BM_CopyWithRampingGainAndAddPerSource(benchmark::State& state) {
+    const auto numSources = static_cast<int>(state.range(0));
+    std::vector<mixxx::SampleBuffer> buffers;
+    const auto sources = makeSources(&buffers, numSources);
+    mixxx::SampleBuffer output(kBufferSize);
+    output.fill(0);
+    mixxx::SampleBuffer temp(kBufferSize);
+
+    for (auto _ : state) {
+        for (const auto& source : sources) {
+            const CSAMPLE_GAIN oldGain = source.startGain - source.gainDelta;
+            const CSAMPLE_GAIN newGain = oldGain + source.gainDelta * (kBufferSize / 2);
+            SampleUtil::copyWithRampingGain(
+                    temp.data(), source.pBuffer, oldGain, newGain, kBufferSize);
+            SampleUtil::add(output.data(), temp.data(), kBufferSize);
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+BENCHMARK(BM_CopyWithRampingGainAndAddPerSource)->Arg(4)->Arg(8)->Arg(16);
+
+} // namespace
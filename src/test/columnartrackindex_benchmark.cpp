@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <utility>
+#include <vector>
+
+#include "library/columnartrackindex.h"
+
+namespace {
+
+// Compares the memory that is needed per track by the index with storing
+// a QVector<QVariant> per track like before
+void BM_ColumnarTrackIndex_MemoryPerTrack(benchmark::State& state) {
+    const QStringList columnNames = {
+            QStringLiteral("artist"),
+            QStringLiteral("album"),
+            QStringLiteral("title"),
+            QStringLiteral("location"),
+            QStringLiteral("comment"),
+            QStringLiteral("bpm"),
+            QStringLiteral("duration"),
+            QStringLiteral("bitrate"),
+            QStringLiteral("timesplayed"),
+            QStringLiteral("rating")};
+    const int trackCount = state.range(0);
+    std::vector<QVector<QVariant>> rows;
+    rows.reserve(trackCount);
+    qint64 variantBytes = 0;
+    for (int i = 0; i < trackCount; ++i) {
+        QVector<QVariant> row = {
+                QStringLiteral("Artist %1").arg(i / 20),
+                QStringLiteral("Album %1").arg(i / 10),
+                QStringLiteral("Title of track %1").arg(i),
+                QStringLiteral("/home/user/Music/Artist %1/Album %2/%3 - Title.mp3")
+                        .arg(i / 20)
+                        .arg(i / 10)
+                        .arg(i % 10),
+                i % 4 == 0 ? QVariant(QStringLiteral("Ripped from vinyl %1").arg(i))
+                           : QVariant(),
+                QVariant(120.0 + i % 40),
+                QVariant(180.5 + i % 300),
+                QVariant(320),
+                QVariant(i % 100),
+                QVariant(i % 6)};
+        // The header of the vector and the QString data of each value
+        variantBytes += 2 * sizeof(void*) + row.capacity() * sizeof(QVariant);
+        for (const auto& value : std::as_const(row)) {
+            if (value.userType() == QMetaType::QString) {
+                variantBytes += 2 * sizeof(void*) +
+                        (value.toString().capacity() + 1) * sizeof(QChar);
+            }
+        }
+        rows.push_back(std::move(row));
+    }
+
+    qint64 indexBytes = 0;
+    for (auto _ : state) {
+        ColumnarTrackIndex index(columnNames);
+        for (int i = 0; i < trackCount; ++i) {
+            const int row = index.insertTrack(TrackId(i + 1));
+            for (int column = 0; column < columnNames.size(); ++column) {
+                index.setValue(row, column, rows[i].at(column));
+            }
+        }
+        indexBytes = index.estimatedMemoryUsage();
+        benchmark::DoNotOptimize(indexBytes);
+    }
+    state.counters["IndexBytesPerTrack"] =
+            static_cast<double>(indexBytes) / trackCount;
+    state.counters["VariantBytesPerTrack"] =
+            static_cast<double>(variantBytes) / trackCount;
+    state.SetItemsProcessed(state.iterations() * trackCount);
+}
+
+BENCHMARK(BM_ColumnarTrackIndex_MemoryPerTrack)
+        ->RangeMultiplier(8)
+        ->Range(1 << 10, 1 << 18)
+        ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,190 @@
+#include "library/columnartrackindex.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlDatabase>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#include "library/searchquery.h"
+
+namespace {
+
+const QString kArtist = QStringLiteral("artist");
+const QString kBpm = QStringLiteral("bpm");
+const QString kDateTimeAdded = QStringLiteral("datetime_added");
+
+class ColumnarTrackIndexTest : public testing::Test {
+  protected:
+    ColumnarTrackIndexTest()
+            : m_index(QStringList{kArtist, kBpm, kDateTimeAdded}),
+              m_artistColumn(m_index.columnIndex(kArtist)),
+              m_bpmColumn(m_index.columnIndex(kBpm)),
+              m_dateTimeAddedColumn(m_index.columnIndex(kDateTimeAdded)) {
+    }
+
+    int addTrack(int id, const QVariant& artist, const QVariant& bpm) {
+        const int row = m_index.insertTrack(TrackId(id));
+        m_index.setValue(row, m_artistColumn, artist);
+        m_index.setValue(row, m_bpmColumn, bpm);
+        return row;
+    }
+
+    SqlBool evaluate(const QueryNode& node, int row) {
+        EXPECT_TRUE(node.prepareEvaluate(m_index));
+        return node.evaluate(m_index, row);
+    }
+
+    ColumnarTrackIndex m_index;
+    const int m_artistColumn;
+    const int m_bpmColumn;
+    const int m_dateTimeAddedColumn;
+};
+
+TEST_F(ColumnarTrackIndexTest, storesTypedColumns) {
+    const int row1 = addTrack(1, QStringLiteral("Artist"), 120.5);
+    const int row2 = addTrack(2, QStringLiteral("Artist"), QVariant());
+
+    EXPECT_EQ(ColumnarTrackIndex::ColumnType::Text, m_index.columnType(m_artistColumn));
+    EXPECT_EQ(ColumnarTrackIndex::ColumnType::Number, m_index.columnType(m_bpmColumn));
+    EXPECT_EQ(ColumnarTrackIndex::ColumnType::Null, m_index.columnType(m_dateTimeAddedColumn));
+
+    // Equal strings are interned only once
+    EXPECT_EQ(m_index.stringId(row1, m_artistColumn), m_index.stringId(row2, m_artistColumn));
+    EXPECT_EQ(1, m_index.stringCount());
+    EXPECT_EQ(QByteArrayLiteral("artist"),
+            m_index.foldedUtf8String(m_index.stringId(row1, m_artistColumn)));
+
+    EXPECT_EQ(QVariant(QStringLiteral("Artist")), m_index.value(row1, m_artistColumn));
+    EXPECT_EQ(QVariant(120.5), m_index.value(row1, m_bpmColumn));
+    EXPECT_FALSE(m_index.isNull(row1, m_bpmColumn));
+    EXPECT_TRUE(m_index.isNull(row2, m_bpmColumn));
+    EXPECT_FALSE(m_index.value(row2, m_bpmColumn).isValid());
+    EXPECT_FALSE(m_index.value(row1, -1).isValid());
+}
+
+TEST_F(ColumnarTrackIndexTest, keepsTypeOfNumbers) {
+    const int row1 = addTrack(1, QVariant(), 120);
+    EXPECT_EQ(QMetaType::Int, m_index.value(row1, m_bpmColumn).userType());
+
+    // Fractions must not be truncated when reading integers later
+    const int row2 = addTrack(2, QVariant(), 99.5);
+    EXPECT_EQ(QVariant(120.0), m_index.value(row1, m_bpmColumn));
+    EXPECT_EQ(QVariant(99.5), m_index.value(row2, m_bpmColumn));
+}
+
+TEST_F(ColumnarTrackIndexTest, unpacksIntegersThatDontFit) {
+    const int row1 = addTrack(1, QVariant(), 120);
+    const int row2 = addTrack(2, QVariant(), QVariant());
+    EXPECT_EQ(120.0, m_index.number(row1, m_bpmColumn));
+    EXPECT_TRUE(std::isnan(m_index.number(row2, m_bpmColumn)));
+
+    // The minimum is reserved for NULL values
+    const qlonglong large = std::numeric_limits<qint32>::min();
+    const int row3 = addTrack(3, QVariant(), large);
+    EXPECT_EQ(large, m_index.value(row3, m_bpmColumn).toLongLong());
+    EXPECT_EQ(QVariant(120), m_index.value(row1, m_bpmColumn));
+    EXPECT_TRUE(m_index.isNull(row2, m_bpmColumn));
+}
+
+TEST_F(ColumnarTrackIndexTest, decodesStringsFromPool) {
+    const int row1 = addTrack(1, QStringLiteral("Ärtist"), QVariant());
+    const int row2 = addTrack(2, QStringLiteral("artist"), QVariant());
+    const int row3 = addTrack(3, QStringLiteral(""), QVariant());
+
+    EXPECT_EQ(QVariant(QStringLiteral("Ärtist")), m_index.value(row1, m_artistColumn));
+    EXPECT_EQ(QVariant(QStringLiteral("artist")), m_index.value(row2, m_artistColumn));
+    EXPECT_EQ(3, m_index.stringCount());
+    // Both are folded to the same string, even though they are interned
+    // separately
+    EXPECT_EQ(m_index.foldedUtf8String(m_index.stringId(row1, m_artistColumn)),
+            m_index.foldedUtf8String(m_index.stringId(row2, m_artistColumn)));
+    EXPECT_FALSE(m_index.isEmptyString(m_index.stringId(row1, m_artistColumn)));
+    EXPECT_TRUE(m_index.isEmptyString(m_index.stringId(row3, m_artistColumn)));
+}
+
+TEST_F(ColumnarTrackIndexTest, fallsBackToVariantsForMixedTypes) {
+    const int row1 = addTrack(1, QStringLiteral("Artist"), 120);
+    const int row2 = addTrack(2, 42, 121);
+
+    EXPECT_EQ(ColumnarTrackIndex::ColumnType::Variant, m_index.columnType(m_artistColumn));
+    EXPECT_EQ(QVariant(QStringLiteral("Artist")), m_index.value(row1, m_artistColumn));
+    EXPECT_EQ(QVariant(42), m_index.value(row2, m_artistColumn));
+}
+
+TEST_F(ColumnarTrackIndexTest, reusesRowsOfRemovedTracks) {
+    const int row1 = addTrack(1, QStringLiteral("Artist"), 120);
+    addTrack(2, QStringLiteral("Artist"), 121);
+
+    m_index.removeTrack(TrackId(1));
+    EXPECT_FALSE(m_index.contains(TrackId(1)));
+    EXPECT_EQ(-1, m_index.row(TrackId(1)));
+    EXPECT_EQ(1, m_index.trackCount());
+
+    const int row3 = m_index.insertTrack(TrackId(3));
+    EXPECT_EQ(row1, row3);
+    EXPECT_EQ(2, m_index.rowCount());
+    EXPECT_EQ(TrackId(3), m_index.trackId(row3));
+    EXPECT_TRUE(m_index.isNull(row3, m_artistColumn));
+    EXPECT_TRUE(m_index.isNull(row3, m_bpmColumn));
+}
+
+TEST_F(ColumnarTrackIndexTest, changesGenerationOnlyForChangedValues) {
+    const int row = addTrack(1, QStringLiteral("Artist"), 120);
+    const quint64 artistGeneration = m_index.columnGeneration(m_artistColumn);
+    const quint64 bpmGeneration = m_index.columnGeneration(m_bpmColumn);
+
+    m_index.setValue(row, m_artistColumn, QStringLiteral("Artist"));
+    m_index.setValue(row, m_bpmColumn, 121);
+    EXPECT_EQ(artistGeneration, m_index.columnGeneration(m_artistColumn));
+    EXPECT_NE(bpmGeneration, m_index.columnGeneration(m_bpmColumn));
+}
+
+TEST_F(ColumnarTrackIndexTest, evaluatesLikeSql) {
+    const int row1 = addTrack(1, QStringLiteral("Ärtist"), 120);
+    const int row2 = addTrack(2, QVariant(), 125);
+
+    const TextFilterNode textNode(QSqlDatabase(), QStringList{kArtist}, QStringLiteral("art"));
+    EXPECT_EQ(SqlBool::True, evaluate(textNode, row1));
+    // LIKE is NULL for NULL values ...
+    EXPECT_EQ(SqlBool::Null, evaluate(textNode, row2));
+    // ... and so is NOT LIKE
+    const NotNode notNode(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), QStringList{kArtist}, QStringLiteral("art")));
+    EXPECT_EQ(SqlBool::False, evaluate(notNode, row1));
+    EXPECT_EQ(SqlBool::Null, evaluate(notNode, row2));
+
+    const NumericFilterNode numericNode(QStringList{kBpm}, QStringLiteral(">121"));
+    EXPECT_EQ(SqlBool::False, evaluate(numericNode, row1));
+    EXPECT_EQ(SqlBool::True, evaluate(numericNode, row2));
+
+    AndNode andNode;
+    andNode.addNode(std::make_unique<NumericFilterNode>(
+            QStringList{kBpm}, QStringLiteral("100-130")));
+    andNode.addNode(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), QStringList{kArtist}, QStringLiteral("art")));
+    EXPECT_EQ(SqlBool::True, evaluate(andNode, row1));
+    EXPECT_EQ(SqlBool::Null, evaluate(andNode, row2));
+
+    // A node without SQL is ignored
+    AndNode emptyNode;
+    EXPECT_EQ(SqlBool::Empty, evaluate(emptyNode, row1));
+}
+
+TEST_F(ColumnarTrackIndexTest, leavesLikeWildcardsToTheDatabase) {
+    addTrack(1, QStringLiteral("Artist"), 120);
+
+    const TextFilterNode wildcardNode(
+            QSqlDatabase(), QStringList{kArtist}, QStringLiteral("a%t"));
+    EXPECT_FALSE(wildcardNode.prepareEvaluate(m_index));
+    const TextFilterNode missingColumnNode(
+            QSqlDatabase(), QStringList{QStringLiteral("title")}, QStringLiteral("a"));
+    EXPECT_FALSE(missingColumnNode.prepareEvaluate(m_index));
+    // The database would compare the numbers as text
+    const TextFilterNode numberColumnNode(
+            QSqlDatabase(), QStringList{kBpm}, QStringLiteral("12"));
+    EXPECT_FALSE(numberColumnNode.prepareEvaluate(m_index));
+}
+
+} // namespace
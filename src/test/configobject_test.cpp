@@ -139,4 +139,25 @@ TEST_F(ConfigObjectTest, Save) {
     }
 }
 
+TEST_F(ConfigObjectTest, SaveLater) {
+    for (int i = 0; i < 10; ++i) {
+        config()->setValue(ConfigKey(QStringLiteral("[Test]"),
+                                   QStringLiteral("control%1").arg(i)),
+                i);
+        // Coalesced into a single write
+        m_pConfig->saveLater();
+    }
+
+    m_pConfig->flushPendingSave();
+    m_pConfig = UserSettingsPointer(
+            new UserSettings(getTestDataDir().filePath("test.cfg")));
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i,
+                config()->getValue<int>(ConfigKey(QStringLiteral("[Test]"),
+                                                QStringLiteral("control%1").arg(i)),
+                        -1));
+    }
+}
+
 }  // namespace
@@ -0,0 +1,104 @@
+#include "controllers/controllermappinginfoenumerator.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "controllers/defs_controllers.h"
+
+namespace {
+
+void writeMapping(const QString& path, const QString& name) {
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(QStringLiteral(
+            "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+            "<MixxxControllerPreset schemaVersion=\"1\">\n"
+            "  <info>\n"
+            "    <name>%1</name>\n"
+            "    <author>Test</author>\n"
+            "    <devices>\n"
+            "      <product protocol=\"hid\" vendor_id=\"0x1\" product_id=\"0x2\"/>\n"
+            "    </devices>\n"
+            "  </info>\n"
+            "  <controller id=\"Test\"/>\n"
+            "</MixxxControllerPreset>\n")
+                    .arg(name)
+                    .toUtf8());
+}
+
+class MappingInfoEnumeratorTest : public testing::Test {
+  protected:
+    QString mappingPath(const QString& baseName) const {
+        return m_mappingDir.filePath(baseName + HID_MAPPING_EXTENSION);
+    }
+
+    QString cacheFilePath() const {
+        return m_cacheDir.filePath(QStringLiteral("mappinginfo.cache"));
+    }
+
+    QList<MappingInfo> enumerate() const {
+        return MappingInfoEnumerator(m_mappingDir.path(), cacheFilePath())
+                .getMappingsByExtension(HID_MAPPING_EXTENSION);
+    }
+
+    QTemporaryDir m_mappingDir;
+    QTemporaryDir m_cacheDir;
+};
+
+TEST_F(MappingInfoEnumeratorTest, cachedMappingInfo) {
+    writeMapping(mappingPath(QStringLiteral("a")), QStringLiteral("Mapping A"));
+    writeMapping(mappingPath(QStringLiteral("b")), QStringLiteral("Mapping B"));
+
+    const QList<MappingInfo> mappings = enumerate();
+    ASSERT_EQ(2, mappings.size());
+    EXPECT_TRUE(QFile::exists(cacheFilePath()));
+
+    // Restored from the cache
+    const QList<MappingInfo> cachedMappings = enumerate();
+    ASSERT_EQ(2, cachedMappings.size());
+    for (int i = 0; i < mappings.size(); ++i) {
+        EXPECT_TRUE(cachedMappings[i].isValid());
+        EXPECT_EQ(mappings[i].getPath(), cachedMappings[i].getPath());
+        EXPECT_EQ(mappings[i].getDirPath(), cachedMappings[i].getDirPath());
+        EXPECT_EQ(mappings[i].getName(), cachedMappings[i].getName());
+        EXPECT_EQ(mappings[i].getAuthor(), cachedMappings[i].getAuthor());
+        ASSERT_EQ(1, cachedMappings[i].getProducts().size());
+        EXPECT_EQ(QStringLiteral("0x2"), cachedMappings[i].getProducts().first().product_id);
+    }
+}
+
+TEST_F(MappingInfoEnumeratorTest, modifiedAndRemovedMappings) {
+    writeMapping(mappingPath(QStringLiteral("a")), QStringLiteral("Mapping A"));
+    writeMapping(mappingPath(QStringLiteral("b")), QStringLiteral("Mapping B"));
+    ASSERT_EQ(2, enumerate().size());
+
+    // Modify the size and the modification time
+    writeMapping(mappingPath(QStringLiteral("a")), QStringLiteral("Mapping A2"));
+    QFile file(mappingPath(QStringLiteral("a")));
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(
+            QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+    ASSERT_TRUE(QFile::remove(mappingPath(QStringLiteral("b"))));
+
+    const QList<MappingInfo> mappings = enumerate();
+    ASSERT_EQ(1, mappings.size());
+    EXPECT_EQ(QStringLiteral("Mapping A2"), mappings.first().getName());
+}
+
+TEST_F(MappingInfoEnumeratorTest, corruptCacheFile) {
+    writeMapping(mappingPath(QStringLiteral("a")), QStringLiteral("Mapping A"));
+    QFile cacheFile(cacheFilePath());
+    ASSERT_TRUE(cacheFile.open(QIODevice::WriteOnly));
+    cacheFile.write("not a cache");
+    cacheFile.close();
+
+    const QList<MappingInfo> mappings = enumerate();
+    ASSERT_EQ(1, mappings.size());
+    EXPECT_EQ(QStringLiteral("Mapping A"), mappings.first().getName());
+}
+
+} // namespace
@@ -9,6 +9,7 @@
 #include <QTemporaryFile>
 #include <QThread>
 #include <QtDebug>
+#include <algorithm>
 #include <bit>
 #include <memory>
 
@@ -121,6 +122,17 @@ TEST_F(ControllerScriptEngineLegacyTest, setValue) {
     EXPECT_DOUBLE_EQ(1.0, co->get());
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, setValues) {
+    auto co1 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co1"));
+    auto co2 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co2"));
+    co2->set(10.0);
+    EXPECT_TRUE(evaluateAndAssert(
+            "engine.setValues('[Test]', {co1: 1.0, co2: NaN, nothing: 2.0});"));
+    EXPECT_DOUBLE_EQ(1.0, co1->get());
+    // NaN is ignored like by setValue
+    EXPECT_DOUBLE_EQ(10.0, co2->get());
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, getValue_InvalidKey) {
     EXPECT_TRUE(evaluateAndAssert("engine.getValue('', '');"));
     EXPECT_TRUE(evaluateAndAssert("engine.getValue('', 'invalid');"));
@@ -291,6 +303,56 @@ TEST_F(ControllerScriptEngineLegacyTest, log) {
     EXPECT_TRUE(evaluateAndAssert("engine.log('Test that logging works.');"));
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, executeFunctionRecordsCallbackStatistics) {
+    EXPECT_TRUE(evaluateAndAssert("function handler() {}"));
+    QJSValue handler = jsEngine()->globalObject().property(QStringLiteral("handler"));
+    const auto pHandlerCounters = callbackCounters(QStringLiteral("handler"));
+    const auto pMidiCounters = callbackCounters(QStringLiteral("MIDI 0x90 0x10"));
+    // Registered once per name
+    EXPECT_EQ(pHandlerCounters, callbackCounters(QStringLiteral("handler")));
+    // Not listed before they have been executed
+    callbackCounters(QStringLiteral("unused"));
+    EXPECT_TRUE(executeFunction(&handler, {}, pHandlerCounters.get()));
+    EXPECT_TRUE(executeFunction(&handler, {}, pHandlerCounters.get()));
+    EXPECT_TRUE(executeFunction(&handler, {}, pMidiCounters.get()));
+    // Not recorded
+    EXPECT_TRUE(executeFunction(&handler));
+
+    auto statistics = callbackStatistics();
+    ASSERT_EQ(2, statistics.size());
+    std::sort(statistics.begin(), statistics.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.name < rhs.name;
+    });
+    EXPECT_EQ(QStringLiteral("MIDI 0x90 0x10"), statistics[0].name);
+    EXPECT_EQ(1, statistics[0].calls);
+    EXPECT_EQ(QStringLiteral("handler"), statistics[1].name);
+    EXPECT_EQ(2, statistics[1].calls);
+    EXPECT_LE(statistics[1].maxTime, statistics[1].totalTime);
+
+    resetCallbackStatistics();
+    EXPECT_TRUE(callbackStatistics().isEmpty());
+    // The registered counters are still used after the reset
+    EXPECT_TRUE(executeFunction(&handler, {}, pHandlerCounters.get()));
+    ASSERT_EQ(1, callbackStatistics().size());
+    EXPECT_EQ(1, callbackStatistics()[0].calls);
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, callbackCountersReportLongerOverruns) {
+    ScriptCallbackCounters counters(QStringLiteral("handler"));
+    const auto budget = ScriptCallbackCounters::kTimeBudget;
+    EXPECT_EQ(0, counters.record(budget));
+    // The warnings are only due for the first and for longer overruns
+    EXPECT_EQ(1, counters.record(budget * 2));
+    EXPECT_EQ(0, counters.record(budget * 2));
+    EXPECT_EQ(3, counters.record(budget * 3));
+
+    const ScriptCallbackStatistics statistics = counters.statistics();
+    EXPECT_EQ(4, statistics.calls);
+    EXPECT_EQ(3, statistics.overruns);
+    EXPECT_EQ(budget * 8, statistics.totalTime);
+    EXPECT_EQ(budget * 3, statistics.maxTime);
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, trigger) {
     auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
     auto pass = std::make_unique<ControlObject>(ConfigKey("[Test]", "passed"));
@@ -636,6 +698,34 @@ TEST_F(ControllerScriptEngineLegacyTest, connectionObject_trigger) {
     EXPECT_DOUBLE_EQ(1.0, counter->get());
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, connectionObject_minIntervalCoalescesCallbacks) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    auto counter = std::make_unique<ControlObject>(ConfigKey("[Test]", "counter"));
+    auto last = std::make_unique<ControlObject>(ConfigKey("[Test]", "last"));
+
+    EXPECT_TRUE(evaluateAndAssert(
+            "var reaction = function(value) {"
+            "  var counter = engine.getValue('[Test]', 'counter');"
+            "  engine.setValue('[Test]', 'counter', counter + 1);"
+            "  engine.setValue('[Test]', 'last', value);"
+            "};"
+            "var connection = engine.makeConnection('[Test]', 'co', reaction,"
+            "    {minInterval: 50});"
+            "connection.trigger();"));
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+
+    // Within the interval the changes are deferred and coalesced
+    co->set(1.0);
+    co->set(2.0);
+    processEvents();
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+
+    QThread::msleep(100);
+    processEvents();
+    EXPECT_DOUBLE_EQ(2.0, counter->get());
+    EXPECT_DOUBLE_EQ(2.0, last->get());
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, connectionExecutesWithCorrectThisObject) {
     // Test that callback functions are executed with JavaScript's
     // 'this' keyword referring to the object in which the connection
@@ -51,6 +51,29 @@ TEST_F(ControlObjectTest, AliasRetrieval) {
     EXPECT_EQ(ControlObject::getControl(ckAlias), co.get());
 }
 
+TEST_F(ControlObjectTest, getControlAfterRecreation) {
+    // Populates the lookup cache of this thread
+    EXPECT_EQ(ControlObject::getControl(ck1), co1.get());
+    co1.reset();
+    EXPECT_EQ(ControlObject::getControl(ck1, ControlFlag::NoAssertIfMissing),
+            (ControlObject*)nullptr);
+    co1 = std::make_unique<ControlObject>(ck1);
+    EXPECT_EQ(ControlObject::getControl(ck1), co1.get());
+}
+
+TEST_F(ControlObjectTest, AliasRetrievalAfterLookup) {
+    ConfigKey ck("[Microphone1]", "volume");
+    ConfigKey ckAlias("[Microphone]", "volume");
+
+    auto co = std::make_unique<ControlObject>(ck);
+    EXPECT_EQ(ControlObject::getControl(ck), co.get());
+    EXPECT_EQ(ControlObject::getControl(ckAlias, ControlFlag::NoAssertIfMissing),
+            (ControlObject*)nullptr);
+
+    co->addAlias(ckAlias);
+    EXPECT_EQ(ControlObject::getControl(ckAlias), co.get());
+}
+
 TEST_F(ControlObjectTest, Persistence_NotPresent) {
     ConfigKey ck("[Test]", "persist");
     ASSERT_FALSE(m_pConfig->exists(ck));
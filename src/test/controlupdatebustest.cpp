@@ -0,0 +1,73 @@
+#include "control/controlupdatebus.h"
+
+#include <gtest/gtest.h>
+
+#include <QObject>
+#include <QVector>
+#include <memory>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlUpdateBusTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pControl = std::make_unique<ControlObject>(
+                ConfigKey("[Test]", "update_bus"));
+        m_pReceiver = std::make_unique<QObject>();
+    }
+
+    void subscribe() {
+        ControlUpdateBus::instance().subscribe(m_pControl->getKey(),
+                m_pReceiver.get(),
+                [this](double value) {
+                    m_values.append(value);
+                });
+    }
+
+    std::unique_ptr<ControlObject> m_pControl;
+    std::unique_ptr<QObject> m_pReceiver;
+    QVector<double> m_values;
+};
+
+TEST_F(ControlUpdateBusTest, CoalescesChangesPerTick) {
+    subscribe();
+    m_pControl->set(1.0);
+    m_pControl->set(2.0);
+    m_pControl->set(3.0);
+    ControlUpdateBus::instance().process();
+    EXPECT_EQ(QVector<double>{3.0}, m_values);
+
+    // Unchanged values are not delivered again
+    ControlUpdateBus::instance().process();
+    EXPECT_EQ(QVector<double>{3.0}, m_values);
+
+    m_pControl->set(4.0);
+    ControlUpdateBus::instance().process();
+    EXPECT_EQ((QVector<double>{3.0, 4.0}), m_values);
+}
+
+TEST_F(ControlUpdateBusTest, StopsAfterReceiverIsDestroyed) {
+    subscribe();
+    m_pReceiver.reset();
+    m_pControl->set(1.0);
+    ControlUpdateBus::instance().process();
+    EXPECT_TRUE(m_values.isEmpty());
+}
+
+TEST_F(ControlUpdateBusTest, Unsubscribe) {
+    const quint64 id = ControlUpdateBus::instance().subscribe(
+            m_pControl->getKey(),
+            m_pReceiver.get(),
+            [this](double value) {
+                m_values.append(value);
+            });
+    ControlUpdateBus::instance().unsubscribe(id);
+    m_pControl->set(1.0);
+    ControlUpdateBus::instance().process();
+    EXPECT_TRUE(m_values.isEmpty());
+}
+
+} // namespace
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/pollingcontrolproxy.h"
+
+// Measures reading the values of as many controls as the engine reads in a
+// single callback. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_ControlValue
+
+namespace {
+
+const QString kGroup = QStringLiteral("[ControlValueBenchmark]");
+
+std::vector<std::unique_ptr<ControlObject>> createControls(int count) {
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    controls.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        controls.push_back(std::make_unique<ControlObject>(
+                ConfigKey(kGroup, QStringLiteral("control%1").arg(i)),
+                false,
+                false,
+                false,
+                static_cast<double>(i)));
+    }
+    return controls;
+}
+
+// The layout before the values were allocated from the ControlValueArena:
+// Each value was stored inside of its own heap allocated object
+struct ScatteredControl {
+    char object[sizeof(ControlDoublePrivate)];
+    ControlValueAtomic<double> value;
+};
+
+void BM_ControlValue_Scattered(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    std::vector<std::unique_ptr<ScatteredControl>> controls;
+    // Interleaved with other allocations like when creating the controls
+    // of the engine
+    std::vector<std::unique_ptr<char[]>> otherAllocations;
+    for (int i = 0; i < count; ++i) {
+        controls.push_back(std::make_unique<ScatteredControl>());
+        controls.back()->value.setValue(static_cast<double>(i));
+        otherAllocations.push_back(std::make_unique<char[]>(256));
+    }
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& pControl : controls) {
+            sum += pControl->value.getValue();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_ControlValue_ControlObject(benchmark::State& state) {
+    const auto controls = createControls(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& pControl : controls) {
+            sum += pControl->get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * controls.size());
+}
+
+void BM_ControlValue_PollingControlProxy(benchmark::State& state) {
+    const auto controls = createControls(static_cast<int>(state.range(0)));
+    std::vector<PollingControlProxy> proxies;
+    proxies.reserve(controls.size());
+    for (const auto& pControl : controls) {
+        proxies.emplace_back(pControl->getKey());
+    }
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& proxy : proxies) {
+            sum += proxy.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * proxies.size());
+}
+
+BENCHMARK(BM_ControlValue_Scattered)->Range(16, 1024);
+BENCHMARK(BM_ControlValue_ControlObject)->Range(16, 1024);
+BENCHMARK(BM_ControlValue_PollingControlProxy)->Range(16, 1024);
+
+} // namespace
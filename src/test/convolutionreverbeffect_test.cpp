@@ -0,0 +1,252 @@
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "effects/backends/builtin/convolutionreverbthread.h"
+#include "effects/backends/effectmanifest.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kChannels = ConvolutionImpulseResponse::kChannels;
+constexpr int kPartitionFrames = ConvolutionImpulseResponse::kPartitionFrames;
+constexpr int kTailOffsetFrames = ConvolutionImpulseResponse::kTailOffsetFrames;
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+// Not a divisor of the partition lengths, so the partitions end within
+// the buffers
+constexpr SINT kFramesPerBuffer = 96;
+// Long enough for several tail partitions
+constexpr double kDecaySeconds = 1.0;
+constexpr double kDamping = 0.0;
+// The input is a burst of noise that starts within a partition
+constexpr int kBurstOffsetFrames = 1000;
+constexpr int kBurstFrames = 32;
+
+constexpr auto kTimeout = std::chrono::seconds(10);
+
+} // namespace
+
+class ConvolutionReverbEffectTest : public testing::Test {
+  protected:
+    ConvolutionReverbEffectTest()
+            : m_engineParameters(kSampleRate, kFramesPerBuffer) {
+        const EffectManifestPointer pManifest = ConvolutionReverbEffect::getManifest();
+        QMap<QString, EngineEffectParameterPointer> parameters;
+        for (const auto& pParameterManifest : pManifest->parameters()) {
+            EngineEffectParameterPointer pParameter(
+                    new EngineEffectParameter(pParameterManifest));
+            parameters.insert(pParameterManifest->id(), pParameter);
+        }
+        parameters.value(QStringLiteral("decay"))->setValue(kDecaySeconds);
+        parameters.value(QStringLiteral("damping"))->setValue(kDamping);
+        parameters.value(QStringLiteral("send_amount"))->setValue(1.0);
+        m_effect.loadEngineEffectParameters(parameters);
+        m_pState = std::make_unique<ConvolutionReverbGroupState>(
+                m_engineParameters, m_effect.m_pThread);
+    }
+
+    void process(const CSAMPLE* pInput, CSAMPLE* pOutput) {
+        m_effect.processChannel(m_pState.get(),
+                pInput,
+                pOutput,
+                m_engineParameters,
+                EffectEnableState::Enabled,
+                GroupFeatureState());
+    }
+
+    /// Requests the impulse response and processes silence until it has
+    /// been created and the send parameter has ramped up
+    bool waitForImpulseResponse() {
+        mixxx::SampleBuffer silence(m_engineParameters.samplesPerBuffer());
+        mixxx::SampleBuffer output(m_engineParameters.samplesPerBuffer());
+        process(silence.data(), output.data());
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!m_effect.m_pThread->acquireImpulseResponse()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            QThread::msleep(1);
+        }
+        process(silence.data(), output.data());
+        return true;
+    }
+
+    /// Waits until the thread has convolved the tail partitions that have
+    /// been handed over, so the test doesn't depend on its timing
+    bool waitForTailPartitions() {
+        const quint64 inputSeq = m_pState->tailInputSeq.load(std::memory_order_acquire);
+        if (inputSeq == 0) {
+            return true;
+        }
+        const quint64 seq = inputSeq - 1;
+        const auto& slotSeq =
+                m_pState->tailOutputSlotSeqs[seq % ConvolutionReverbGroupState::kTailSlots];
+        const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (slotSeq.load(std::memory_order_acquire) < seq + 1) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            QThread::msleep(1);
+        }
+        return true;
+    }
+
+    const mixxx::EngineParameters m_engineParameters;
+    ConvolutionReverbEffect m_effect;
+    std::unique_ptr<ConvolutionReverbGroupState> m_pState;
+};
+
+TEST_F(ConvolutionReverbEffectTest, MatchesDirectConvolution) {
+    std::vector<float> impulseResponse[kChannels];
+    ConvolutionImpulseResponse::synthesize(
+            impulseResponse, kDecaySeconds, kDamping, kSampleRate);
+    const int impulseResponseFrames = static_cast<int>(impulseResponse[0].size());
+    // The impulse response must reach each layer of the convolution
+    ASSERT_GT(impulseResponseFrames,
+            kTailOffsetFrames + 2 * ConvolutionImpulseResponse::kTailPartitionFrames);
+
+    const int numBuffers =
+            (kBurstOffsetFrames + kBurstFrames + impulseResponseFrames +
+                    kFramesPerBuffer - 1) /
+                    kFramesPerBuffer +
+            1;
+    const int frames = numBuffers * kFramesPerBuffer;
+    std::vector<CSAMPLE> input(static_cast<std::size_t>(frames) * kChannels, 0);
+    std::minstd_rand generator(1);
+    std::uniform_real_distribution<CSAMPLE> noise(-1, 1);
+    for (int frame = kBurstOffsetFrames; frame < kBurstOffsetFrames + kBurstFrames; ++frame) {
+        for (int channel = 0; channel < kChannels; ++channel) {
+            input[frame * kChannels + channel] = noise(generator);
+        }
+    }
+
+    ASSERT_TRUE(waitForImpulseResponse());
+    std::vector<CSAMPLE> output(input.size());
+    for (int buffer = 0; buffer < numBuffers; ++buffer) {
+        const std::size_t offset = static_cast<std::size_t>(buffer) *
+                m_engineParameters.samplesPerBuffer();
+        process(&input[offset], &output[offset]);
+        ASSERT_TRUE(waitForTailPartitions());
+    }
+
+    // The largest error per layer of the convolution. A frame is assigned
+    // to the layer of the earliest frame of the impulse response that
+    // contributes to the frame, counted from the end of the burst.
+    const int layerEnds[] = {kPartitionFrames, kTailOffsetFrames, frames};
+    const char* const layerNames[] = {"head", "partitions", "tail partitions"};
+    double maxErrors[3] = {};
+    double maxExpected[3] = {};
+    for (int frame = 0; frame < frames; ++frame) {
+        const int layer = static_cast<int>(
+                std::upper_bound(std::begin(layerEnds),
+                        std::end(layerEnds),
+                        std::max(0, frame - (kBurstOffsetFrames + kBurstFrames - 1))) -
+                std::begin(layerEnds));
+        ASSERT_LT(layer, 3);
+        for (int channel = 0; channel < kChannels; ++channel) {
+            double expected = 0;
+            const int first = std::max(kBurstOffsetFrames, frame - impulseResponseFrames + 1);
+            const int last = std::min(kBurstOffsetFrames + kBurstFrames - 1, frame);
+            for (int i = first; i <= last; ++i) {
+                expected += static_cast<double>(input[i * kChannels + channel]) *
+                        impulseResponse[channel][frame - i];
+            }
+            const double error = std::abs(output[frame * kChannels + channel] - expected);
+            maxErrors[layer] = std::max(maxErrors[layer], error);
+            maxExpected[layer] = std::max(maxExpected[layer], std::abs(expected));
+        }
+    }
+    for (int layer = 0; layer < 3; ++layer) {
+        SCOPED_TRACE(layerNames[layer]);
+        EXPECT_GT(maxExpected[layer], 1e-3);
+        EXPECT_LT(maxErrors[layer], 1e-5);
+    }
+
+    // The reverberation has faded out after the end of the impulse response
+    const int end = kBurstOffsetFrames + kBurstFrames + impulseResponseFrames;
+    for (int sample = end * kChannels; sample < frames * kChannels; ++sample) {
+        EXPECT_NEAR(0, output[sample], 1e-6);
+    }
+}
+
+class ConvolutionImpulseResponseTest : public MixxxTest, SoundSourceProviderRegistration {
+};
+
+TEST_F(ConvolutionImpulseResponseTest, ResamplePreservesSine) {
+    constexpr auto kSourceSampleRate = mixxx::audio::SampleRate(44100);
+    constexpr auto kTargetSampleRate = mixxx::audio::SampleRate(48000);
+    constexpr double kFrequency = 1000.0;
+    std::vector<float> samples(kSourceSampleRate.value());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(
+                std::sin(2 * M_PI * kFrequency * i / kSourceSampleRate.toDouble()));
+    }
+
+    ConvolutionImpulseResponse::resample(&samples, kSourceSampleRate, kTargetSampleRate);
+    ASSERT_EQ(kTargetSampleRate.value(), samples.size());
+    // Apart from the edges, where the filter reaches beyond the input
+    for (std::size_t i = 100; i < samples.size() - 100; ++i) {
+        const double expected =
+                std::sin(2 * M_PI * kFrequency * i / kTargetSampleRate.toDouble());
+        EXPECT_NEAR(expected, samples[i], 1e-3);
+    }
+}
+
+TEST_F(ConvolutionImpulseResponseTest, ResampleRemovesAliases) {
+    constexpr auto kSourceSampleRate = mixxx::audio::SampleRate(96000);
+    constexpr auto kTargetSampleRate = mixxx::audio::SampleRate(44100);
+    // Above the Nyquist frequency of the target sample rate
+    constexpr double kFrequency = 30000.0;
+    std::vector<float> samples(kSourceSampleRate.value());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(
+                std::sin(2 * M_PI * kFrequency * i / kSourceSampleRate.toDouble()));
+    }
+
+    ConvolutionImpulseResponse::resample(&samples, kSourceSampleRate, kTargetSampleRate);
+    ASSERT_EQ(kTargetSampleRate.value(), samples.size());
+    for (std::size_t i = 100; i < samples.size() - 100; ++i) {
+        EXPECT_NEAR(0, samples[i], 1e-3);
+    }
+}
+
+TEST_F(ConvolutionImpulseResponseTest, LoadFile) {
+    // A mono file at 44.1 kHz that is longer than the maximum length
+    const QString filePath =
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.wav"));
+    std::vector<float> samples[kChannels];
+    ASSERT_TRUE(ConvolutionImpulseResponse::load(
+            samples, filePath, mixxx::audio::SampleRate(48000)));
+
+    EXPECT_EQ(std::size_t{6 * 48000}, samples[0].size());
+    EXPECT_EQ(samples[0], samples[1]);
+    // Normalized to unit energy per channel
+    double energy = 0.0;
+    for (const float sample : samples[0]) {
+        energy += static_cast<double>(sample) * sample;
+    }
+    EXPECT_NEAR(1.0, energy, 1e-3);
+}
+
+TEST_F(ConvolutionImpulseResponseTest, LoadMissingFile) {
+    const QString filePath =
+            getTestDir().filePath(QStringLiteral("id3-test-data/missing.wav"));
+    std::vector<float> samples[kChannels];
+    EXPECT_FALSE(ConvolutionImpulseResponse::load(
+            samples, filePath, mixxx::audio::SampleRate(48000)));
+    EXPECT_TRUE(samples[0].empty());
+    EXPECT_TRUE(samples[1].empty());
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
+
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include "library/coverartcache.h"
+#include "library/coverartthumbnailcache.h"
 #include "library/coverartutils.h"
 #include "library/trackcollection.h"
 #include "test/librarytest.h"
@@ -88,3 +91,70 @@ TEST_F(CoverArtCacheTest, loadCoverFromFileAbsolute) {
             getTestDir().filePath(kCoverLocationTest),
             getTestDir().filePath(kCoverLocationTest));
 }
+
+TEST_F(CoverArtCacheTest, storeAndLoadThumbnail) {
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const CoverArtThumbnailCache thumbnailCache(tempDir.path(), 1024 * 1024);
+    const QImage image = QImage(getTestDir().filePath(kCoverLocationTest))
+                                 .scaledToWidth(2 * CoverArtThumbnailCache::kThumbnailWidth);
+    ASSERT_FALSE(image.isNull());
+
+    constexpr mixxx::cache_key_t kCacheKey = 42;
+    EXPECT_TRUE(thumbnailCache.load(kCacheKey).isNull());
+
+    const QImage storedThumbnail = thumbnailCache.store(kCacheKey, image);
+    EXPECT_EQ(CoverArtThumbnailCache::kThumbnailWidth, storedThumbnail.width());
+    const QImage loadedThumbnail = thumbnailCache.load(kCacheKey);
+    EXPECT_EQ(storedThumbnail.size(), loadedThumbnail.size());
+}
+
+TEST_F(CoverArtCacheTest, loadCoverFromThumbnail) {
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const auto pThumbnailCache = std::make_shared<const CoverArtThumbnailCache>(
+            tempDir.path(), 1024 * 1024);
+    const QString coverLocation = getTestDir().filePath(kCoverLocationTest);
+    const QImage image(coverLocation);
+    ASSERT_FALSE(image.isNull());
+
+    CoverInfo info;
+    info.type = CoverInfo::FILE;
+    info.source = CoverInfo::GUESSED;
+    info.coverLocation = coverLocation;
+    info.setImageDigest(image);
+
+    constexpr int kDesiredWidth = 40;
+    const CoverArtCache::FutureResult decodedRes =
+            CoverArtCache::loadCover(TrackPointer(), info, kDesiredWidth, pThumbnailCache);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, decodedRes.coverArt.loadedImage.result);
+    EXPECT_EQ(kDesiredWidth, decodedRes.coverArt.loadedImage.image.width());
+    EXPECT_QSTRING_EQ(coverLocation, decodedRes.coverArt.loadedImage.location);
+
+    // The thumbnail is used even if the original file disappears
+    info.coverLocation = tempDir.filePath(kCoverFileTest);
+    const CoverArtCache::FutureResult cachedRes =
+            CoverArtCache::loadCover(TrackPointer(), info, kDesiredWidth, pThumbnailCache);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, cachedRes.coverArt.loadedImage.result);
+    EXPECT_EQ(kDesiredWidth, cachedRes.coverArt.loadedImage.image.width());
+    EXPECT_QSTRING_EQ(pThumbnailCache->filePath(info.cacheKey()),
+            cachedRes.coverArt.loadedImage.location);
+}
+
+TEST_F(CoverArtCacheTest, evictLeastRecentlyUsedThumbnails) {
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QImage image(getTestDir().filePath(kCoverLocationTest));
+    ASSERT_FALSE(image.isNull());
+
+    // Store two thumbnails without a limit to measure their size
+    const CoverArtThumbnailCache unlimitedCache(tempDir.path(), 1024 * 1024);
+    ASSERT_FALSE(unlimitedCache.store(1, image).isNull());
+    ASSERT_FALSE(unlimitedCache.store(2, image).isNull());
+    const qint64 thumbnailSize = QFileInfo(unlimitedCache.filePath(1)).size();
+    ASSERT_GT(thumbnailSize, 0);
+
+    const CoverArtThumbnailCache limitedCache(tempDir.path(), thumbnailSize);
+    EXPECT_EQ(1, limitedCache.evictLeastRecentlyUsed());
+    EXPECT_EQ(0, limitedCache.evictLeastRecentlyUsed());
+}
@@ -310,3 +310,32 @@ TEST_F(CoverArtUtilTest, searchImage) {
         QFile::remove(loc);
     }
 }
+
+TEST_F(CoverArtUtilTest, reuseDecodedEmbeddedCover) {
+    if (!SoundSourceProxy::isFileSuffixSupported(QStringLiteral("mp3"))) {
+        return;
+    }
+    const auto fileAccess = mixxx::FileAccess(mixxx::FileInfo(
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-png.mp3"))));
+    const QImage image = CoverArtUtils::extractEmbeddedCover(fileAccess);
+    ASSERT_FALSE(image.isNull());
+    // The identical embedded data is not decoded again
+    const QImage reusedImage = CoverArtUtils::extractEmbeddedCover(fileAccess);
+    EXPECT_EQ(image.cacheKey(), reusedImage.cacheKey());
+
+    // The digest of the reused image matches the digest of a
+    // separately decoded copy
+    CoverInfoRelative coverInfo;
+    coverInfo.type = CoverInfo::METADATA;
+    coverInfo.setImageDigest(image);
+    CoverInfoRelative reusedCoverInfo;
+    reusedCoverInfo.type = CoverInfo::METADATA;
+    reusedCoverInfo.setImageDigest(reusedImage);
+    const QImage copiedImage = image.copy();
+    ASSERT_NE(image.cacheKey(), copiedImage.cacheKey());
+    CoverInfoRelative copiedCoverInfo;
+    copiedCoverInfo.type = CoverInfo::METADATA;
+    copiedCoverInfo.setImageDigest(copiedImage);
+    EXPECT_EQ(copiedCoverInfo, coverInfo);
+    EXPECT_EQ(copiedCoverInfo, reusedCoverInfo);
+}
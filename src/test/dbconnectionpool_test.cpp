@@ -2,7 +2,9 @@
 
 #include "library/dao/settingsdao.h"
 #include "test/mixxxdbtest.h"
+#include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
+#include "util/db/fwdsqlquery.h"
 
 class DbConnectionPoolTest : public MixxxTest {};
 
@@ -20,3 +22,69 @@ TEST_F(DbConnectionPoolTest, MoveSemantics) {
     EXPECT_TRUE(p1.isPooling());
     EXPECT_FALSE(p2.isPooling());
 }
+
+TEST_F(DbConnectionPoolTest, ReusePreparedStatements) {
+    const MixxxDb mixxxDb(config(), /*inMemoryConnection*/ true);
+    const mixxx::DbConnectionPooler dbConnectionPooler(mixxxDb.connectionPool());
+    ASSERT_TRUE(dbConnectionPooler.isPooling());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+    const mixxx::SqlStatementCache* pStatementCache =
+            mixxx::DbConnection::statementCache(database.driver());
+    ASSERT_NE(nullptr, pStatementCache);
+    const quint64 hitCount = pStatementCache->hitCount();
+    const quint64 missCount = pStatementCache->missCount();
+
+    const QString statement = QStringLiteral("SELECT :value");
+    {
+        FwdSqlQuery query(database, statement);
+        ASSERT_TRUE(query.isPrepared());
+        query.bindValue(QStringLiteral(":value"), 1);
+        ASSERT_TRUE(query.execPrepared());
+        ASSERT_TRUE(query.next());
+        // The statement is in use and can't be reused
+        FwdSqlQuery concurrentQuery(database, statement);
+        EXPECT_TRUE(concurrentQuery.isPrepared());
+    }
+    EXPECT_EQ(hitCount, pStatementCache->hitCount());
+    EXPECT_EQ(missCount + 2, pStatementCache->missCount());
+
+    {
+        FwdSqlQuery query(database, statement);
+        ASSERT_TRUE(query.isPrepared());
+        query.bindValue(QStringLiteral(":value"), 2);
+        ASSERT_TRUE(query.execPrepared());
+        ASSERT_TRUE(query.next());
+        EXPECT_EQ(2, query.fieldValue(0).toInt());
+    }
+    EXPECT_EQ(hitCount + 1, pStatementCache->hitCount());
+    EXPECT_EQ(missCount + 2, pStatementCache->missCount());
+}
+
+TEST_F(DbConnectionPoolTest, EvictLeastRecentlyUsedStatements) {
+    const MixxxDb mixxxDb(config(), /*inMemoryConnection*/ true);
+    const mixxx::DbConnectionPooler dbConnectionPooler(mixxxDb.connectionPool());
+    ASSERT_TRUE(dbConnectionPooler.isPooling());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+
+    const QStringList statements = {
+            QStringLiteral("SELECT 1"),
+            QStringLiteral("SELECT 2"),
+            QStringLiteral("SELECT 3"),
+    };
+    mixxx::SqlStatementCache statementCache(QStringLiteral("test"), 2);
+    for (const auto& statement : statements) {
+        QSqlQuery query(database);
+        ASSERT_TRUE(query.prepare(statement));
+        statementCache.put(statement, std::move(query));
+    }
+    EXPECT_EQ(2, statementCache.size());
+
+    QSqlQuery query;
+    EXPECT_FALSE(statementCache.take(statements.at(0), &query));
+    EXPECT_TRUE(statementCache.take(statements.at(1), &query));
+    EXPECT_EQ(statements.at(1), query.lastQuery());
+    EXPECT_TRUE(statementCache.take(statements.at(2), &query));
+    EXPECT_EQ(0, statementCache.size());
+    EXPECT_EQ(2u, statementCache.hitCount());
+    EXPECT_EQ(1u, statementCache.missCount());
+}
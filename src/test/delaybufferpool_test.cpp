@@ -0,0 +1,84 @@
+// Tests for delaybufferpool.h
+
+#include "util/delaybufferpool.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "test/mixxxtest.h"
+#include "util/types.h"
+
+namespace {
+
+class DelayBufferPoolTest : public MixxxTest {
+  protected:
+    // Calls reserve() like an audio callback until the buffer has grown
+    SINT reserveAndWait(DelayBuffer* pBuffer, SINT size, SINT* pWritePos) {
+        QElapsedTimer timer;
+        timer.start();
+        SINT reservedSize = pBuffer->reserve(size, pWritePos);
+        while (reservedSize < size && timer.elapsed() < 5000) {
+            QThread::msleep(1);
+            reservedSize = pBuffer->reserve(size, pWritePos);
+        }
+        return reservedSize;
+    }
+};
+
+TEST_F(DelayBufferPoolTest, InitialSizeIsRoundedUp) {
+    DelayBuffer buffer(1);
+    EXPECT_EQ(DelayBufferPool::kSizeGranularity, buffer.size());
+    for (SINT i = 0; i < buffer.size(); ++i) {
+        ASSERT_EQ(0.0f, buffer[i]);
+    }
+
+    SINT writePos = 0;
+    EXPECT_EQ(buffer.size(), buffer.reserve(buffer.size(), &writePos));
+    EXPECT_EQ(0, writePos);
+}
+
+TEST_F(DelayBufferPoolTest, GrowPreservesHistory) {
+    DelayBuffer buffer(DelayBufferPool::kSizeGranularity);
+    const SINT oldSize = buffer.size();
+
+    // Fill the ring with a wrapped write position
+    SINT writePos = 0;
+    for (SINT i = 0; i < oldSize + 100; ++i) {
+        buffer[writePos] = static_cast<CSAMPLE>(i);
+        writePos = (writePos + 1) % oldSize;
+    }
+    const CSAMPLE lastSample = static_cast<CSAMPLE>(oldSize + 99);
+
+    const SINT newSize = reserveAndWait(&buffer, 3 * oldSize, &writePos);
+    ASSERT_GE(newSize, 3 * oldSize);
+    EXPECT_EQ(newSize, buffer.size());
+    EXPECT_EQ(oldSize, writePos);
+
+    // The same delays read the same samples
+    for (SINT delay = 1; delay <= oldSize; ++delay) {
+        ASSERT_EQ(lastSample - delay + 1,
+                buffer[(writePos + newSize - delay) % newSize]);
+    }
+    // Longer delays read silence
+    for (SINT delay = oldSize + 1; delay <= newSize; ++delay) {
+        ASSERT_EQ(0.0f, buffer[(writePos + newSize - delay) % newSize]);
+    }
+}
+
+TEST_F(DelayBufferPoolTest, RecycledBuffersAreCleared) {
+    const SINT size = 2 * DelayBufferPool::kSizeGranularity;
+    {
+        DelayBuffer buffer(size);
+        buffer.data()[0] = 1.0f;
+        buffer.data()[size - 1] = 1.0f;
+    }
+    DelayBuffer buffer(size);
+    EXPECT_EQ(size, buffer.size());
+    for (SINT i = 0; i < buffer.size(); ++i) {
+        ASSERT_EQ(0.0f, buffer[i]);
+    }
+}
+
+} // namespace
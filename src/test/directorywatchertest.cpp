@@ -0,0 +1,49 @@
+#include "library/scanner/directorywatcher.h"
+
+#include <gtest/gtest.h>
+
+#include "test/mixxxtest.h"
+
+class DirectoryWatcherTest : public MixxxTest {
+  protected:
+    DirectoryWatcher m_watcher;
+};
+
+TEST_F(DirectoryWatcherTest, recordsChangedDirectories) {
+    // Changes before the first full scan are not sufficient for rescanning
+    m_watcher.slotDirectoryChanged(QStringLiteral("/music/a"));
+    EXPECT_FALSE(m_watcher.isComplete());
+    EXPECT_FALSE(m_watcher.hasChangedDirectories());
+
+    m_watcher.beginFullScan();
+    EXPECT_TRUE(m_watcher.isComplete());
+    m_watcher.slotDirectoryChanged(QStringLiteral("/music/a"));
+    m_watcher.slotDirectoryChanged(QStringLiteral("/music/b"));
+    m_watcher.slotDirectoryChanged(QStringLiteral("/music/a"));
+    EXPECT_TRUE(m_watcher.hasChangedDirectories());
+
+    QStringList changedDirectories = m_watcher.takeChangedDirectories();
+    changedDirectories.sort();
+    EXPECT_EQ(QStringList({QStringLiteral("/music/a"), QStringLiteral("/music/b")}),
+            changedDirectories);
+    EXPECT_FALSE(m_watcher.hasChangedDirectories());
+    EXPECT_TRUE(m_watcher.isComplete());
+
+    // A cancelled scan may have missed the changes
+    m_watcher.slotDirectoryChanged(QStringLiteral("/music/c"));
+    m_watcher.reset();
+    EXPECT_FALSE(m_watcher.isComplete());
+    EXPECT_FALSE(m_watcher.hasChangedDirectories());
+}
+
+TEST_F(DirectoryWatcherTest, fallsBackToFullScanOnOverflow) {
+    m_watcher.beginFullScan();
+    for (int i = 0; i < 10000 && m_watcher.isComplete(); ++i) {
+        m_watcher.slotDirectoryChanged(QStringLiteral("/music/%1").arg(i));
+    }
+    EXPECT_FALSE(m_watcher.isComplete());
+    EXPECT_FALSE(m_watcher.hasChangedDirectories());
+
+    m_watcher.beginFullScan();
+    EXPECT_TRUE(m_watcher.isComplete());
+}
@@ -0,0 +1,300 @@
+#include "test/engine_benchmark.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "test/signalpathtest.h"
+#include "util/math.h"
+
+// Measures the audio callback of the whole engine in realistic scenarios
+// to catch slowdowns before a release. The engine runs without a sound
+// device, every iteration is one callback. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_Engine
+//       --benchmark_out=engine.json --benchmark_out_format=json
+//
+// Besides the mean time, the "mean_us", "p99_us" and "max_us" counters
+// report the distribution of the callback durations and "load" the mean
+// fraction of the real-time duration of a callback that has been spent.
+// tools/engine_benchmark_compare.py compares the JSON output against a
+// baseline that has been recorded on the same machine.
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+// 256 frames, about 5.8 ms
+constexpr std::size_t kBufferSize = 512;
+constexpr int kWarmUpCallbacks = 200;
+constexpr int kMeasuredCallbacks = 5000;
+
+const QString kMainGroup = QStringLiteral("[Master]");
+const QString kAppGroup = QStringLiteral("[App]");
+
+struct Scenario {
+    const char* name;
+    int deckCount;
+    int samplerCount;
+    bool keylock;
+    bool scratching;
+    bool effects;
+    bool sync;
+};
+
+const Scenario kScenarios[] = {
+        {"FourDecksKeylock", 4, 0, true, false, false, false},
+        {"TwoDecksScratching", 2, 0, false, true, false, false},
+        {"EightSamplersRetriggering", 0, 8, false, false, false, false},
+        {"FourDecksFullEffectUnits", 4, 0, false, false, true, false},
+        {"FourDecksSync", 4, 0, false, false, false, true},
+};
+
+constexpr int kEffectUnitCount = 4;
+constexpr int kEffectsPerUnit = 3;
+
+// Every sampler is retriggered once per this number of callbacks, one
+// after another
+constexpr int kRetriggerInterval = 25;
+
+UserSettingsPointer benchmarkConfig() {
+    static const QTemporaryDir s_settingsDir;
+    static const UserSettingsPointer s_pConfig = UserSettingsPointer(
+            new UserSettings(s_settingsDir.filePath(QStringLiteral("mixxx.cfg"))));
+    return s_pConfig;
+}
+
+void set(const QString& group, const QString& item, double value) {
+    ControlObject::set(ConfigKey(group, item), value);
+}
+
+/// The engine with the players and effects of a scenario, set up like by
+/// CoreServices and PlayerManager
+class EngineBench : public SoundSourceProviderRegistration {
+  public:
+    explicit EngineBench(const Scenario& scenario)
+            : m_scenario(scenario),
+              m_pConfig(benchmarkConfig()),
+              m_pChannelHandleFactory(std::make_shared<ChannelHandleFactory>()),
+              m_pControlIndicatorTimer(std::make_unique<mixxx::ControlIndicatorTimer>()),
+              m_numDecks(ConfigKey(kAppGroup, QStringLiteral("num_decks"))),
+              m_numSamplers(ConfigKey(kAppGroup, QStringLiteral("num_samplers"))) {
+#ifdef __RUBBERBAND__
+        RubberBandWorkerPool::createInstance(m_pConfig);
+#endif
+        m_pEffectsManager = std::make_unique<EffectsManager>(
+                m_pConfig, m_pChannelHandleFactory);
+        m_pEngineMixer = std::make_unique<TestEngineMixer>(m_pConfig,
+                kMainGroup,
+                m_pEffectsManager.get(),
+                m_pChannelHandleFactory,
+                false);
+        set(kMainGroup, QStringLiteral("samplerate"), kSampleRate.toDouble());
+        set(kMainGroup, QStringLiteral("enabled"), 1.0);
+        set(kAppGroup,
+                QStringLiteral("keylock_engine"),
+                static_cast<double>(
+#ifdef __RUBBERBAND__
+                        // R3
+                        EngineBuffer::KeylockEngine::RubberBandFiner
+#else
+                        EngineBuffer::KeylockEngine::SoundTouch
+#endif
+                        ));
+
+        for (int i = 0; i < m_scenario.deckCount; ++i) {
+            const auto handleGroup = m_pEngineMixer->registerChannelGroup(
+                    QStringLiteral("[Channel%1]").arg(i + 1));
+            m_players.push_back(std::make_unique<Deck>(nullptr,
+                    m_pConfig,
+                    m_pEngineMixer.get(),
+                    m_pEffectsManager.get(),
+                    i % 2 == 0 ? EngineChannel::LEFT : EngineChannel::RIGHT,
+                    handleGroup));
+            m_pEffectsManager->addDeck(handleGroup);
+            m_numDecks.set(i + 1);
+        }
+        for (int i = 0; i < m_scenario.samplerCount; ++i) {
+            m_players.push_back(std::make_unique<Sampler>(nullptr,
+                    m_pConfig,
+                    m_pEngineMixer.get(),
+                    m_pEffectsManager.get(),
+                    EngineChannel::CENTER,
+                    m_pEngineMixer->registerChannelGroup(
+                            QStringLiteral("[Sampler%1]").arg(i + 1))));
+            m_numSamplers.set(i + 1);
+        }
+        PlayerInfo::create();
+        m_pEffectsManager->setup();
+    }
+
+    ~EngineBench() {
+        m_players.clear();
+        // Deletes all EngineChannels
+        m_pEngineMixer.reset();
+        m_pEffectsManager.reset();
+        PlayerInfo::destroy();
+#ifdef __RUBBERBAND__
+        RubberBandWorkerPool::destroy();
+#endif
+    }
+
+    /// Returns false if a track could not be loaded
+    bool start() {
+        const QString trackLocation = MixxxTest::getOrInitTestDir().filePath(
+                QStringLiteral("sine-30.wav"));
+        for (std::size_t i = 0; i < m_players.size(); ++i) {
+            if (!loadTrack(m_players[i].get(), Track::newTemporary(trackLocation))) {
+                return false;
+            }
+            const QString& group = m_players[i]->getGroup();
+            set(group, QStringLiteral("main_mix"), 1.0);
+            set(group, QStringLiteral("repeat"), 1.0);
+            // Each deck at a slightly different tempo, so that none is
+            // processed by the fast path of the scalers
+            set(group, QStringLiteral("rate"), 0.1 * (static_cast<int>(i) + 1));
+            set(group, QStringLiteral("keylock"), m_scenario.keylock ? 1.0 : 0.0);
+            if (m_scenario.scratching) {
+                set(group, QStringLiteral("scratch2_enable"), 1.0);
+            }
+            if (m_scenario.sync) {
+                set(group, QStringLiteral("sync_enabled"), 1.0);
+            }
+            if (m_scenario.samplerCount == 0) {
+                set(group, QStringLiteral("play"), 1.0);
+            }
+        }
+        if (m_scenario.effects) {
+            enableAllEffects();
+        }
+        return true;
+    }
+
+    void process(int callback) {
+        if (m_scenario.scratching) {
+            // Back and forth like a baby scratch
+            const double phase = 2 * M_PI * callback / 100.0;
+            for (const auto& pPlayer : m_players) {
+                set(pPlayer->getGroup(), QStringLiteral("scratch2"), 3.0 * std::sin(phase));
+            }
+        }
+        if (m_scenario.samplerCount > 0 && callback % kRetriggerInterval == 0) {
+            const auto& pSampler =
+                    m_players[(callback / kRetriggerInterval) % m_players.size()];
+            set(pSampler->getGroup(), QStringLiteral("start_play"), 1.0);
+        }
+        m_pEngineMixer->process(kBufferSize);
+    }
+
+  private:
+    bool loadTrack(BaseTrackPlayer* pPlayer, TrackPointer pTrack) {
+        pPlayer->slotLoadTrack(pTrack,
+#ifdef __STEM__
+                mixxx::StemChannelSelection(),
+#endif
+                false);
+        EngineBuffer* pEngineBuffer =
+                m_pEngineMixer->getChannel(pPlayer->getGroup())->getEngineBuffer();
+        // Loading is finished in the engine thread
+        for (int i = 0; i < 2000; ++i) {
+            m_pEngineMixer->process(kBufferSize);
+            if (pEngineBuffer->isTrackLoaded()) {
+                return true;
+            }
+            QThread::msleep(1);
+        }
+        return false;
+    }
+
+    void enableAllEffects() {
+        for (int unit = 1; unit <= kEffectUnitCount; ++unit) {
+            const QString unitGroup = QStringLiteral("[EffectRack1_EffectUnit%1]").arg(unit);
+            set(unitGroup, QStringLiteral("enabled"), 1.0);
+            set(unitGroup, QStringLiteral("mix"), 1.0);
+            for (const auto& pPlayer : m_players) {
+                set(unitGroup,
+                        QStringLiteral("group_%1_enable").arg(pPlayer->getGroup()),
+                        1.0);
+            }
+            for (int effect = 1; effect <= kEffectsPerUnit; ++effect) {
+                const QString effectGroup = QStringLiteral("[EffectRack1_EffectUnit%1_Effect%2]")
+                                                    .arg(unit)
+                                                    .arg(effect);
+                // Different effects in every slot
+                for (int i = 0; i < (unit - 1) * kEffectsPerUnit + effect; ++i) {
+                    set(effectGroup, QStringLiteral("next_effect"), 1.0);
+                }
+                set(effectGroup, QStringLiteral("enabled"), 1.0);
+            }
+        }
+        // Deliver the requests to the engine
+        m_pEngineMixer->process(kBufferSize);
+    }
+
+    const Scenario& m_scenario;
+    const UserSettingsPointer m_pConfig;
+    const ChannelHandleFactoryPointer m_pChannelHandleFactory;
+    const std::unique_ptr<mixxx::ControlIndicatorTimer> m_pControlIndicatorTimer;
+    ControlObject m_numDecks;
+    ControlObject m_numSamplers;
+    std::unique_ptr<EffectsManager> m_pEffectsManager;
+    std::unique_ptr<TestEngineMixer> m_pEngineMixer;
+    std::vector<std::unique_ptr<BaseTrackPlayerImpl>> m_players;
+};
+
+void BM_Engine(benchmark::State& state, const Scenario& scenario) {
+    EngineBench bench(scenario);
+    if (!bench.start()) {
+        state.SkipWithError("Failed to load the tracks");
+        return;
+    }
+    int callback = 0;
+    for (; callback < kWarmUpCallbacks; ++callback) {
+        bench.process(callback);
+    }
+
+    std::vector<double> durationsMicros;
+    durationsMicros.reserve(kMeasuredCallbacks);
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        bench.process(callback++);
+        const auto end = std::chrono::steady_clock::now();
+        durationsMicros.push_back(
+                std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    if (durationsMicros.empty()) {
+        return;
+    }
+
+    const double meanMicros =
+            std::accumulate(durationsMicros.begin(), durationsMicros.end(), 0.0) /
+            durationsMicros.size();
+    const auto p99 = durationsMicros.begin() +
+            static_cast<std::ptrdiff_t>((durationsMicros.size() - 1) * 0.99);
+    std::nth_element(durationsMicros.begin(), p99, durationsMicros.end());
+    const double bufferMicros = 1e6 * kBufferSize /
+            mixxx::audio::ChannelCount::stereo() / kSampleRate.toDouble();
+    state.counters["mean_us"] = meanMicros;
+    state.counters["p99_us"] = *p99;
+    state.counters["max_us"] = *std::max_element(durationsMicros.begin(), durationsMicros.end());
+    state.counters["load"] = meanMicros / bufferMicros;
+}
+
+} // namespace
+
+void registerEngineBenchmarks() {
+    for (const auto& scenario : kScenarios) {
+        benchmark::RegisterBenchmark(
+                QStringLiteral("BM_Engine/%1").arg(scenario.name).toStdString(),
+                BM_Engine,
+                scenario)
+                ->Iterations(kMeasuredCallbacks)
+                ->Unit(benchmark::kMicrosecond);
+    }
+}
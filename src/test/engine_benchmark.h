@@ -0,0 +1,6 @@
+#pragma once
+
+/// Registers the benchmarks of the whole engine in realistic scenarios.
+/// Must be called after the QCoreApplication has been created and before
+/// running the benchmarks.
+void registerEngineBenchmarks();
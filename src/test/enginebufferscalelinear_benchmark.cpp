@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "engine/bufferscalers/enginebufferscalelinear.h"
+#include "engine/readaheadmanager.h"
+#include "util/samplebuffer.h"
+
+// Measures the vinyl scaler at the rates of pitch fader and scratching, for
+// stereo and stem decks. The argument is the number of frames per buffer.
+// Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_EngineBufferScaleLinear
+
+namespace {
+
+constexpr SINT kSourceSamples = 65536;
+
+// Endlessly reads the same noise
+class NoiseReadAheadManager : public ReadAheadManager {
+  public:
+    NoiseReadAheadManager()
+            : m_source(kSourceSamples),
+              m_position(0) {
+        std::mt19937 gen; // explicitly don't seed for reproducibility
+        std::uniform_real_distribution<CSAMPLE> value(-1.0f, 1.0f);
+        for (SINT i = 0; i < kSourceSamples; ++i) {
+            m_source[i] = value(gen);
+        }
+    }
+
+    SINT getNextSamples(double dRate,
+            CSAMPLE* buffer,
+            SINT requested_samples,
+            mixxx::audio::ChannelCount channelCount) override {
+        Q_UNUSED(dRate);
+        Q_UNUSED(channelCount);
+        for (SINT i = 0; i < requested_samples; ++i) {
+            buffer[i] = m_source[(m_position + i) % kSourceSamples];
+        }
+        m_position += requested_samples;
+        return requested_samples;
+    }
+
+  private:
+    mixxx::SampleBuffer m_source;
+    SINT m_position;
+};
+
+void runScaler(benchmark::State& state,
+        double rate,
+        bool hermite,
+        mixxx::audio::ChannelCount channelCount =
+                mixxx::audio::ChannelCount::stereo()) {
+    NoiseReadAheadManager readAheadManager;
+    EngineBufferScaleLinear scaler(&readAheadManager);
+    scaler.setSignal(mixxx::audio::SampleRate(44100), channelCount);
+    scaler.setHermiteInterpolation(hermite);
+    double tempoRatio = rate;
+    double pitchRatio = rate;
+    scaler.setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+
+    const auto numSamples = static_cast<SINT>(state.range(0)) * channelCount;
+    mixxx::SampleBuffer output(numSamples);
+    for (auto _ : state) {
+        scaler.scaleBuffer(output.data(), numSamples);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_EngineBufferScaleLinear_PitchFader(benchmark::State& state) {
+    runScaler(state, 1.08, false);
+}
+BENCHMARK(BM_EngineBufferScaleLinear_PitchFader)->Range(64, 4096);
+
+void BM_EngineBufferScaleLinear_Scratch(benchmark::State& state) {
+    runScaler(state, 3.7, false);
+}
+BENCHMARK(BM_EngineBufferScaleLinear_Scratch)->Range(64, 4096);
+
+void BM_EngineBufferScaleLinear_PitchFaderHermite(benchmark::State& state) {
+    runScaler(state, 1.08, true);
+}
+BENCHMARK(BM_EngineBufferScaleLinear_PitchFaderHermite)->Range(64, 4096);
+
+void BM_EngineBufferScaleLinear_PitchFaderStem(benchmark::State& state) {
+    runScaler(state, 1.08, false, mixxx::audio::ChannelCount::stem());
+}
+BENCHMARK(BM_EngineBufferScaleLinear_PitchFaderStem)->Range(64, 4096);
+
+} // namespace
@@ -305,4 +305,58 @@ TEST_F(EngineBufferScaleLinearTest, TestRepeatedScaleCalls) {
     SampleUtil::free(pOutput);
 }
 
+TEST_F(EngineBufferScaleLinearTest, HermiteScaleConstant) {
+    m_pScaler->setHermiteInterpolation(true);
+    SetRateNoLerp(0.75);
+
+    CSAMPLE readBuffer[1] = { 1.0f };
+    m_pReadAheadMock->setReadBuffer(readBuffer, 1);
+
+    // Tell the RAMAN mock to invoke getNextSamplesFake
+    EXPECT_CALL(*m_pReadAheadMock, getNextSamples(_, _, _, _))
+            .WillRepeatedly(Invoke(m_pReadAheadMock, &ReadAheadManagerMock::getNextSamplesFake));
+
+    CSAMPLE* pOutput = SampleUtil::alloc(kiLinearScaleReadAheadLength);
+    for (int i = 0; i < 4; ++i) {
+        m_pScaler->scaleBuffer(pOutput, kiLinearScaleReadAheadLength);
+        // The cubic interpolation must not overshoot on a constant signal,
+        // also across the boundaries of the read-ahead buffer. The first
+        // frame is faded in from the cleared state.
+        const int offset = i == 0 ? 2 : 0;
+        AssertWholeBufferEquals(pOutput + offset,
+                1.0f,
+                kiLinearScaleReadAheadLength - offset);
+    }
+
+    SampleUtil::free(pOutput);
+}
+
+TEST_F(EngineBufferScaleLinearTest, StemScaleConstant) {
+    // Uses the variant of the interpolation loop for stem decks
+    double tempoRatio = 0.75;
+    double pitchRatio = 0.75;
+    m_pScaler->setSignal(mixxx::audio::SampleRate(44100),
+            mixxx::audio::ChannelCount::stem());
+    m_pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    m_pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+
+    CSAMPLE readBuffer[1] = { 1.0f };
+    m_pReadAheadMock->setReadBuffer(readBuffer, 1);
+
+    EXPECT_CALL(*m_pReadAheadMock, getNextSamples(_, _, _, _))
+            .WillRepeatedly(Invoke(m_pReadAheadMock, &ReadAheadManagerMock::getNextSamplesFake));
+
+    CSAMPLE* pOutput = SampleUtil::alloc(kiLinearScaleReadAheadLength);
+    for (int i = 0; i < 4; ++i) {
+        m_pScaler->scaleBuffer(pOutput, kiLinearScaleReadAheadLength);
+        // The first frame is faded in from the cleared state
+        const int offset = i == 0 ? mixxx::audio::ChannelCount::stem() : 0;
+        AssertWholeBufferEquals(pOutput + offset,
+                1.0f,
+                kiLinearScaleReadAheadLength - offset);
+    }
+
+    SampleUtil::free(pOutput);
+}
+
 }  // namespace
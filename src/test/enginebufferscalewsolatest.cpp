@@ -0,0 +1,153 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QtDebug>
+#include <cmath>
+#include <vector>
+
+#include "engine/bufferscalers/enginebufferscalewsola.h"
+#include "engine/readaheadmanager.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/types.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+// Longer than the first windowed segment, which fades in
+constexpr SINT kSettleFrames = 2048;
+
+class ReadAheadManagerMock : public ReadAheadManager {
+  public:
+    ReadAheadManagerMock()
+            : ReadAheadManager(),
+              m_frequency(0.0),
+              m_amplitude(0.0),
+              m_framesRead(0) {
+    }
+
+    SINT getNextSamplesFake(double dRate,
+            CSAMPLE* buffer,
+            SINT requested_samples,
+            mixxx::audio::ChannelCount channelCount) {
+        Q_UNUSED(dRate);
+        const SINT frames = requested_samples / channelCount;
+        for (SINT frame = 0; frame < frames; ++frame) {
+            const double phase = 2 * M_PI * m_frequency * m_framesRead / kSampleRate;
+            const auto sample = static_cast<CSAMPLE>(m_amplitude * std::cos(phase));
+            for (int channel = 0; channel < channelCount; ++channel) {
+                buffer[frame * channelCount + channel] = sample;
+            }
+            ++m_framesRead;
+        }
+        return frames * channelCount;
+    }
+
+    void setSignal(double frequency, double amplitude) {
+        m_frequency = frequency;
+        m_amplitude = amplitude;
+    }
+
+    MOCK_METHOD4(getNextSamples,
+            SINT(double dRate,
+                    CSAMPLE* buffer,
+                    SINT requested_samples,
+                    mixxx::audio::ChannelCount channelCount));
+
+    double m_frequency;
+    double m_amplitude;
+    SINT m_framesRead;
+};
+
+class EngineBufferScaleWsolaTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pReadAheadMock = new NiceMock<ReadAheadManagerMock>();
+        ON_CALL(*m_pReadAheadMock, getNextSamples(_, _, _, _))
+                .WillByDefault(Invoke(m_pReadAheadMock,
+                        &ReadAheadManagerMock::getNextSamplesFake));
+        m_pScaler = new EngineBufferScaleWsola(m_pReadAheadMock);
+        m_pScaler->setSignal(mixxx::audio::SampleRate(kSampleRate),
+                mixxx::audio::ChannelCount::stereo());
+    }
+
+    void TearDown() override {
+        delete m_pScaler;
+        delete m_pReadAheadMock;
+    }
+
+    void setTempo(double tempoRatio) {
+        double pitchRatio = 1.0;
+        m_pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    }
+
+    // Scales numFrames and returns the stereo output
+    std::vector<CSAMPLE> scale(SINT numFrames, double* pFramesRead) {
+        std::vector<CSAMPLE> output(numFrames * mixxx::kEngineChannelOutputCount);
+        constexpr SINT kBufferFrames = 1024;
+        *pFramesRead = 0.0;
+        for (SINT frame = 0; frame < numFrames; frame += kBufferFrames) {
+            *pFramesRead += m_pScaler->scaleBuffer(
+                    output.data() + frame * mixxx::kEngineChannelOutputCount,
+                    std::min(kBufferFrames, numFrames - frame) *
+                            mixxx::kEngineChannelOutputCount);
+        }
+        return output;
+    }
+
+    NiceMock<ReadAheadManagerMock>* m_pReadAheadMock;
+    EngineBufferScaleWsola* m_pScaler;
+};
+
+TEST_F(EngineBufferScaleWsolaTest, ConstantSignalAtUnity) {
+    m_pReadAheadMock->setSignal(0.0, 0.5);
+    setTempo(1.0);
+
+    double framesRead = 0.0;
+    const std::vector<CSAMPLE> output = scale(kSettleFrames + 4096, &framesRead);
+    EXPECT_DOUBLE_EQ(kSettleFrames + 4096, framesRead);
+    // The overlapping windows add up to the original signal
+    for (std::size_t i = kSettleFrames * mixxx::kEngineChannelOutputCount;
+            i < output.size();
+            ++i) {
+        EXPECT_NEAR(0.5, output[i], 1e-5);
+    }
+}
+
+TEST_F(EngineBufferScaleWsolaTest, ConsumesInputAtTempo) {
+    m_pReadAheadMock->setSignal(440.0, 0.5);
+    setTempo(1.02);
+
+    constexpr SINT kFrames = 16 * 1024;
+    double framesRead = 0.0;
+    scale(kFrames, &framesRead);
+    EXPECT_DOUBLE_EQ(1.02 * kFrames, framesRead);
+    // The scaler may only read ahead by a few segments
+    EXPECT_NEAR(1.02 * kFrames, m_pReadAheadMock->m_framesRead, 0.05 * kSampleRate);
+}
+
+TEST_F(EngineBufferScaleWsolaTest, KeepsAmplitudeWhenStretching) {
+    m_pReadAheadMock->setSignal(440.0, 0.5);
+
+    for (const double tempo : {0.97, 1.03}) {
+        m_pScaler->clear();
+        setTempo(tempo);
+
+        constexpr SINT kFrames = 16 * 1024;
+        double framesRead = 0.0;
+        const std::vector<CSAMPLE> output = scale(kSettleFrames + kFrames, &framesRead);
+        // The segments are overlapped in phase, without them cancelling out
+        // each other
+        const CSAMPLE rms = SampleUtil::rms(
+                output.data() + kSettleFrames * mixxx::kEngineChannelOutputCount,
+                kFrames * mixxx::kEngineChannelOutputCount);
+        EXPECT_NEAR(0.5 / std::sqrt(2.0), rms, 0.02) << "tempo " << tempo;
+    }
+}
+
+} // namespace
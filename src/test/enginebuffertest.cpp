@@ -6,14 +6,18 @@
 #include <QString>
 #include <QTest>
 #include <QtDebug>
+#include <chrono>
 
 #include "control/controlobject.h"
 #include "engine/controls/ratecontrol.h"
+#include "engine/engine.h"
 #include "mixer/basetrackplayer.h"
 #include "preferences/usersettings.h"
 #include "test/mixxxtest.h"
 #include "test/mockedenginebackendtest.h"
 #include "test/signalpathtest.h"
+#include "util/inputtimestamp.h"
+#include "util/time.h"
 
 // In case any of the test in this file fail. You can use the audioplot.py tool
 // in the tools folder to visually compare the results of the enginebuffer
@@ -560,3 +564,41 @@ TEST_F(EngineBufferTest, RatePermTest) {
     ControlObject::set(ConfigKey(m_sGroup1, "rate_perm_up_small"), 0);
     EXPECT_EQ(1.06, m_pChannel1->getEngineBuffer()->m_speed_old);
 }
+
+TEST_F(EngineBufferTest, TimedSeekOffset) {
+    mixxx::Time::setTestMode(true);
+    // The time of the first callback must not be empty
+    mixxx::Time::addTestTime(std::chrono::seconds(1));
+    EngineBuffer* pEngineBuffer = m_pChannel1->getEngineBuffer();
+    pEngineBuffer->m_bTimedSeeks = true;
+    // Records the time of the callback, from which the offsets are measured
+    ProcessBuffer();
+    const mixxx::Duration lastCallbackTime = pEngineBuffer->m_lastCallbackTime;
+    const double sampleRate = pEngineBuffer->m_sampleRate.toDouble();
+    const std::size_t bufferSize = kProcessBufferSize;
+    const std::size_t channelCount = mixxx::kEngineChannelOutputCount;
+    const std::size_t bufferFrames = bufferSize / channelCount;
+    const mixxx::Duration callbackTime = lastCallbackTime +
+            mixxx::Duration::fromSeconds(bufferFrames / sampleRate);
+
+    const auto queuedSeekOffset = [&](double offsetFrames) {
+        // Half a frame later, so the offset is not rounded down
+        const mixxx::ScopedInputTimestamp timestamp(lastCallbackTime +
+                mixxx::Duration::fromSeconds((offsetFrames + 0.5) / sampleRate));
+        pEngineBuffer->queueNewPlaypos(
+                mixxx::audio::FramePos(500), EngineBuffer::SEEK_EXACT);
+        return pEngineBuffer->queuedSeekOffset(bufferSize, callbackTime);
+    };
+
+    // The buffer is split at the frame of the input event
+    EXPECT_EQ(100 * channelCount, queuedSeekOffset(100));
+    // Too close to the start, the whole buffer is played after the seek
+    EXPECT_EQ(0u, queuedSeekOffset(8));
+    // Too close to the end, the seek is deferred to the next buffer
+    EXPECT_EQ(bufferSize, queuedSeekOffset(bufferFrames - 8));
+    // Events after the start of the callback are due in the next buffer
+    EXPECT_EQ(bufferSize, queuedSeekOffset(bufferFrames + 8));
+
+    pEngineBuffer->m_bTimedSeeks = false;
+    mixxx::Time::setTestMode(false);
+}
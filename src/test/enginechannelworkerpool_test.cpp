@@ -0,0 +1,70 @@
+#include "engine/enginechannelworkerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <array>
+#include <atomic>
+
+namespace {
+
+class EngineChannelWorkerPoolTest : public testing::Test {
+  protected:
+    EngineChannelWorkerPoolTest()
+            : m_pool(3) {
+    }
+
+    EngineChannelWorkerPool m_pool;
+};
+
+TEST_F(EngineChannelWorkerPoolTest, processesEachItemExactlyOnce) {
+    std::array<std::atomic<int>, 16> counts{};
+    auto processItem = [&counts](int index) {
+        counts[index].fetch_add(1);
+    };
+    for (int round = 0; round < 100; ++round) {
+        m_pool.processItems(static_cast<int>(counts.size()), processItem);
+    }
+    for (const auto& count : counts) {
+        EXPECT_EQ(100, count.load());
+    }
+}
+
+TEST_F(EngineChannelWorkerPoolTest, returnsAfterAllItemsAreDone) {
+    std::array<int, 4> results{};
+    auto processItem = [&results](int index) {
+        // Make sure the workers do not finish in order
+        QThread::usleep((results.size() - index) * 1000);
+        results[index] = index + 1;
+    };
+    m_pool.processItems(static_cast<int>(results.size()), processItem);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(i) + 1, results[i]);
+    }
+}
+
+TEST_F(EngineChannelWorkerPoolTest, wakesUpParkedWorkers) {
+    std::array<std::atomic<int>, 8> counts{};
+    auto processItem = [&counts](int index) {
+        counts[index].fetch_add(1);
+    };
+    for (int round = 0; round < 5; ++round) {
+        // Longer than the workers spin before they park
+        QThread::msleep(20);
+        m_pool.processItems(static_cast<int>(counts.size()), processItem);
+    }
+    for (const auto& count : counts) {
+        EXPECT_EQ(5, count.load());
+    }
+}
+
+TEST_F(EngineChannelWorkerPoolTest, noItems) {
+    int calls = 0;
+    auto processItem = [&calls](int) {
+        ++calls;
+    };
+    m_pool.processItems(0, processItem);
+    EXPECT_EQ(0, calls);
+}
+
+} // namespace
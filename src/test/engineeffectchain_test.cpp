@@ -0,0 +1,153 @@
+#include "engine/effects/engineeffectchain.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "engine/channelhandle.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "engine/effects/message.h"
+
+namespace {
+
+class EngineEffectChainTest : public testing::Test {
+  protected:
+    EngineEffectChainTest()
+            : m_pipes(makeTwoWayMessagePipe<EffectsRequest*, EffectsResponse>(
+                      kPipeSize, kPipeSize)),
+              m_chain(QStringLiteral("[EffectRack1_EffectUnit1]"), {}, {}) {
+    }
+
+    bool sendRequest(EffectsRequest* pRequest) {
+        pRequest->pTargetChain = &m_chain;
+        if (!m_chain.processEffectsRequest(*pRequest, &m_pipes.second)) {
+            return false;
+        }
+        EffectsResponse response;
+        if (!m_pipes.first.readMessage(&response)) {
+            return false;
+        }
+        return response.success;
+    }
+
+    bool replaceEffects(EngineEffectsReplacement* pReplacement) {
+        EffectsRequest request;
+        request.type = EffectsRequest::REPLACE_EFFECTS_OF_CHAIN;
+        request.ReplaceEffectsOfChain.pReplacement = pReplacement;
+        return sendRequest(&request);
+    }
+
+    bool enableForInputChannel(const ChannelHandle& inputHandle) {
+        EffectsRequest request;
+        request.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+        request.EnableInputChannelForChain.channelHandle = inputHandle;
+        return sendRequest(&request);
+    }
+
+    bool setChainEnabled(bool enabled) {
+        EffectsRequest request;
+        request.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+        request.SetEffectChainParameters.enabled = enabled;
+        request.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+        request.SetEffectChainParameters.mix = 1.0;
+        return sendRequest(&request);
+    }
+
+    void process(const ChannelHandle& inputHandle, const ChannelHandle& outputHandle) {
+        std::array<CSAMPLE, 64> input{};
+        std::array<CSAMPLE, 64> output{};
+        m_chain.process(inputHandle,
+                outputHandle,
+                input.data(),
+                output.data(),
+                input.size(),
+                mixxx::audio::SampleRate(44100),
+                GroupFeatureState(),
+                false);
+    }
+
+    // The chain doesn't access the effects when replacing them
+    EngineEffect* fakeEffect(int index) {
+        return reinterpret_cast<EngineEffect*>(&m_fakeEffects[index]);
+    }
+
+    static constexpr int kPipeSize = 8;
+
+    std::array<int, 4> m_fakeEffects{};
+    std::pair<EffectsRequestPipe, EffectsResponsePipe> m_pipes;
+    EngineEffectChain m_chain;
+};
+
+TEST_F(EngineEffectChainTest, ReplaceEffectsReturnsReplacedList) {
+    EngineEffectsReplacement first;
+    first.effects = {fakeEffect(0), nullptr, fakeEffect(1)};
+    ASSERT_TRUE(replaceEffects(&first));
+    // The chain had no effects before
+    EXPECT_TRUE(first.effects.isEmpty());
+
+    EngineEffectsReplacement second;
+    second.effects = {nullptr, fakeEffect(2), fakeEffect(3)};
+    ASSERT_TRUE(replaceEffects(&second));
+    const QList<EngineEffect*> expected = {fakeEffect(0), nullptr, fakeEffect(1)};
+    EXPECT_EQ(expected, second.effects);
+}
+
+TEST_F(EngineEffectChainTest, ReplaceEffectsDoesNotCopyTheList) {
+    EngineEffectsReplacement first;
+    first.effects.reserve(EngineEffectChain::kEffectsCapacity);
+    first.effects.resize(4);
+    const auto* pFirstData = first.effects.constData();
+    ASSERT_TRUE(replaceEffects(&first));
+
+    // The audio thread only exchanges the pointers to the data of the lists,
+    // so the list that has been allocated in the main thread is returned
+    // without being copied or reallocated.
+    EngineEffectsReplacement second;
+    second.effects.resize(4);
+    ASSERT_TRUE(replaceEffects(&second));
+    EXPECT_EQ(pFirstData, second.effects.constData());
+    EXPECT_EQ(EngineEffectChain::kEffectsCapacity, second.effects.capacity());
+}
+
+TEST_F(EngineEffectChainTest, AllChannelsOfACallbackSeeTheSameChainState) {
+    ChannelHandleFactory factory;
+    const ChannelHandle channel1 = factory.getOrCreateHandle(QStringLiteral("[Channel1]"));
+    const ChannelHandle channel2 = factory.getOrCreateHandle(QStringLiteral("[Channel2]"));
+    const ChannelHandle main = factory.getOrCreateHandle(QStringLiteral("[Master]"));
+    ASSERT_TRUE(enableForInputChannel(channel1));
+    ASSERT_TRUE(enableForInputChannel(channel2));
+    process(channel1, main);
+    process(channel2, main);
+    m_chain.onCallbackEnd();
+
+    // Both channels ramp out in the callback after the chain has been
+    // disabled, regardless of the order they are processed in
+    ASSERT_TRUE(setChainEnabled(false));
+    EXPECT_TRUE(m_chain.isActiveForChannel(channel1, main, false));
+    process(channel1, main);
+    EXPECT_TRUE(m_chain.isActiveForChannel(channel2, main, false));
+    process(channel2, main);
+    m_chain.onCallbackEnd();
+
+    EXPECT_FALSE(m_chain.isActiveForChannel(channel1, main, false));
+    EXPECT_FALSE(m_chain.isActiveForChannel(channel2, main, false));
+}
+
+TEST_F(EngineEffectChainTest, ChainStateIsKeptWithoutProcessedChannels) {
+    ChannelHandleFactory factory;
+    const ChannelHandle channel1 = factory.getOrCreateHandle(QStringLiteral("[Channel1]"));
+    const ChannelHandle main = factory.getOrCreateHandle(QStringLiteral("[Master]"));
+    ASSERT_TRUE(enableForInputChannel(channel1));
+    process(channel1, main);
+    m_chain.onCallbackEnd();
+
+    ASSERT_TRUE(setChainEnabled(false));
+    // No channel has been processed, so the channel still ramps out later
+    m_chain.onCallbackEnd();
+    EXPECT_TRUE(m_chain.isActiveForChannel(channel1, main, false));
+    process(channel1, main);
+    m_chain.onCallbackEnd();
+    EXPECT_FALSE(m_chain.isActiveForChannel(channel1, main, false));
+}
+
+} // namespace
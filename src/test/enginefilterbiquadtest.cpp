@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "util/samplebuffer.h"
 
 namespace {
 
@@ -56,4 +58,32 @@ TEST_F(EngineFilterBiquadTest, analysisLpBe4) {
     free(filt);
 }
 
+TEST_F(EngineFilterBiquadTest, stereoChannelsAreIndependent) {
+    constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+    constexpr SINT kNumSamples = 512;
+    EngineFilterLinkwitzRiley8Low stereoFilter(kSampleRate, 250);
+    EngineFilterLinkwitzRiley8Low leftOnlyFilter(kSampleRate, 250);
+
+    mixxx::SampleBuffer stereoInput(kNumSamples);
+    mixxx::SampleBuffer leftOnlyInput(kNumSamples);
+    for (SINT i = 0; i < kNumSamples; i += 2) {
+        stereoInput[i] = static_cast<CSAMPLE>((i % 7) * 0.1 - 0.3);
+        stereoInput[i + 1] = static_cast<CSAMPLE>((i % 5) * -0.2 + 0.4);
+        leftOnlyInput[i] = stereoInput[i];
+        leftOnlyInput[i + 1] = 0;
+    }
+
+    mixxx::SampleBuffer stereoOutput(kNumSamples);
+    mixxx::SampleBuffer leftOnlyOutput(kNumSamples);
+    // The first buffer is ramped
+    for (int buffer = 0; buffer < 2; ++buffer) {
+        stereoFilter.process(stereoInput.data(), stereoOutput.data(), kNumSamples);
+        leftOnlyFilter.process(leftOnlyInput.data(), leftOnlyOutput.data(), kNumSamples);
+        for (SINT i = 0; i < kNumSamples; i += 2) {
+            EXPECT_EQ(stereoOutput[i], leftOnlyOutput[i]);
+            EXPECT_EQ(0, leftOnlyOutput[i + 1]);
+        }
+    }
+}
+
 } // namespace
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "util/samplebuffer.h"
+
+// Measures the filters that are used by the EQ effects of each deck.
+// The argument is the number of frames per buffer. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_EngineFilterIIR
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+template<typename T_Filter>
+void runFilter(benchmark::State& state, T_Filter* pFilter) {
+    const auto numSamples = static_cast<SINT>(state.range(0)) * 2;
+    mixxx::SampleBuffer input(numSamples);
+    mixxx::SampleBuffer output(numSamples);
+    std::mt19937 gen; // explicitly don't seed for reproducibility
+    std::uniform_real_distribution<CSAMPLE> value(-1.0f, 1.0f);
+    for (SINT i = 0; i < numSamples; ++i) {
+        input[i] = value(gen);
+    }
+    // Settle the filter, the first buffer is ramped
+    pFilter->process(input.data(), output.data(), numSamples);
+
+    for (auto _ : state) {
+        pFilter->process(input.data(), output.data(), numSamples);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// BiquadFullKillEQEffect
+void BM_EngineFilterIIR_Biquad1Peaking(benchmark::State& state) {
+    EngineFilterBiquad1Peaking filter(kSampleRate, 1000, 1.75);
+    filter.setFrequencyCorners(kSampleRate, 1000, 1.75, -6.0);
+    runFilter(state, &filter);
+}
+BENCHMARK(BM_EngineFilterIIR_Biquad1Peaking)->Range(64, 4096);
+
+// Bessel8LVMixEQEffect
+void BM_EngineFilterIIR_Bessel8Band(benchmark::State& state) {
+    EngineFilterBessel8Band filter(kSampleRate, 250, 2500);
+    runFilter(state, &filter);
+}
+BENCHMARK(BM_EngineFilterIIR_Bessel8Band)->Range(64, 4096);
+
+// LinkwitzRiley8EQEffect
+void BM_EngineFilterIIR_LinkwitzRiley8Low(benchmark::State& state) {
+    EngineFilterLinkwitzRiley8Low filter(kSampleRate, 250);
+    runFilter(state, &filter);
+}
+BENCHMARK(BM_EngineFilterIIR_LinkwitzRiley8Low)->Range(64, 4096);
+
+} // namespace
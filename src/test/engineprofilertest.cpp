@@ -0,0 +1,149 @@
+#include "engine/engineprofiler.h"
+
+#include <gtest/gtest.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+class EngineProfilerTest : public testing::Test, public EngineProfiler::Consumer {
+  protected:
+    void SetUp() override {
+        mixxx::Time::setTestMode(true);
+        m_pProfiler = EngineProfiler::createInstance(16);
+        m_pProfiler->addConsumer(this);
+        m_droppedProfiles = 0;
+    }
+
+    void TearDown() override {
+        EngineProfiler::destroy();
+        mixxx::Time::setTestMode(false);
+    }
+
+    // Runs a callback of 1 ms with a channel, that takes 300 us including
+    // 100 us of pre-fader effects and misses the cache
+    void runCallback() {
+        const EngineProfiler::ScopedCallback callback(
+                48, mixxx::audio::SampleRate(48000));
+        mixxx::Time::addTestTime(50us);
+        {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Channels);
+            EngineProfiler::ScopedChannelStage channelStage(
+                    2, EngineProfiler::ChannelStage::Process);
+            mixxx::Time::addTestTime(200us);
+            EngineProfiler::ScopedChannelStage::countCacheMiss();
+            EngineProfiler::ScopedChannelStage effectsStage(
+                    EngineProfiler::ChannelStage::PreFaderEffects);
+            mixxx::Time::addTestTime(100us);
+        }
+        mixxx::Time::addTestTime(650us);
+    }
+
+    void consumeProfiles(const std::vector<EngineProfiler::CallbackProfile>& profiles,
+            int droppedProfiles) override {
+        m_profiles.insert(m_profiles.end(), profiles.begin(), profiles.end());
+        m_droppedProfiles += droppedProfiles;
+    }
+
+    EngineProfiler* m_pProfiler;
+    std::vector<EngineProfiler::CallbackProfile> m_profiles;
+    int m_droppedProfiles;
+};
+
+TEST_F(EngineProfilerTest, RecordsStages) {
+    runCallback();
+
+    m_pProfiler->dispatch();
+    EXPECT_EQ(0, m_droppedProfiles);
+    ASSERT_EQ(1u, m_profiles.size());
+    const EngineProfiler::CallbackProfile& profile = m_profiles[0];
+    EXPECT_EQ(48u, profile.frames);
+    EXPECT_EQ(1000000u,
+            profile.stages[static_cast<int>(EngineProfiler::Stage::Callback)]
+                    .durationNanos);
+    const EngineProfiler::Span& channels =
+            profile.stages[static_cast<int>(EngineProfiler::Stage::Channels)];
+    EXPECT_EQ(50000u, channels.startNanos);
+    EXPECT_EQ(300000u, channels.durationNanos);
+    const EngineProfiler::Span& effects = profile.channels[2][static_cast<int>(
+            EngineProfiler::ChannelStage::PreFaderEffects)];
+    EXPECT_EQ(250000u, effects.startNanos);
+    EXPECT_EQ(100000u, effects.durationNanos);
+    EXPECT_EQ(1u, profile.cacheMisses[2]);
+    EXPECT_EQ(0u, profile.cacheMisses[0]);
+    EXPECT_EQ(0u,
+            profile.stages[static_cast<int>(EngineProfiler::Stage::Sidechain)]
+                    .durationNanos);
+}
+
+TEST_F(EngineProfilerTest, DisabledRecordsNothing) {
+    m_pProfiler->removeConsumer(this);
+    EXPECT_FALSE(m_pProfiler->isEnabled());
+    runCallback();
+
+    m_pProfiler->dispatch();
+    EXPECT_TRUE(m_profiles.empty());
+}
+
+TEST_F(EngineProfilerTest, CountsDroppedProfiles) {
+    for (int i = 0; i < 20; ++i) {
+        runCallback();
+    }
+
+    m_pProfiler->dispatch();
+    EXPECT_EQ(4, m_droppedProfiles);
+    EXPECT_EQ(16u, m_profiles.size());
+}
+
+TEST_F(EngineProfilerTest, Statistics) {
+    EngineProfileStatistics statistics;
+    for (int i = 0; i < 3; ++i) {
+        runCallback();
+    }
+    m_pProfiler->dispatch();
+    for (const auto& profile : m_profiles) {
+        statistics.add(profile);
+    }
+
+    // The callbacks took 1 ms of 1 ms buffers
+    EXPECT_EQ(0, statistics.lateCallbacks());
+    // A cache miss per callback
+    EXPECT_EQ(3, statistics.cacheMisses());
+    const EngineProfileStatistics::Histogram& callbacks =
+            statistics.stage(EngineProfiler::Stage::Callback);
+    EXPECT_EQ(3, callbacks.count());
+    EXPECT_EQ(1000000, callbacks.maxNanos());
+    EXPECT_DOUBLE_EQ(1000000.0, callbacks.meanNanos());
+    EXPECT_EQ(1000000, callbacks.percentileNanos(0.99));
+    const EngineProfileStatistics::Histogram& process = statistics.channelStage(
+            2, EngineProfiler::ChannelStage::Process);
+    EXPECT_EQ(3, process.count());
+    EXPECT_EQ(300000, process.maxNanos());
+    // The bucket of 300 us ends at 2^8.5 us, the percentile is limited by the max
+    EXPECT_EQ(300000, process.percentileNanos(0.5));
+    EXPECT_EQ(362039, EngineProfileStatistics::Histogram::bucketUpperBoundNanos(17));
+
+    const QJsonDocument trace = QJsonDocument::fromJson(
+            statistics.toChromeTrace(QStringList{
+                    QString(), QString(), QStringLiteral("[Channel2]")}));
+    const QJsonArray events = trace.object().value("traceEvents").toArray();
+    // Thread names of engine and channel, 4 spans and a cache miss per callback
+    EXPECT_EQ(2 + 3 * 5, events.size());
+    bool foundChannelName = false;
+    for (const auto& event : events) {
+        const QJsonObject object = event.toObject();
+        if (object.value("ph").toString() == "M" && object.value("tid").toInt() == 3) {
+            EXPECT_EQ(QStringLiteral("[Channel2]"),
+                    object.value("args").toObject().value("name").toString());
+            foundChannelName = true;
+        }
+    }
+    EXPECT_TRUE(foundChannelName);
+}
+
+} // namespace
@@ -0,0 +1,99 @@
+#include "engine/enginescratcharena.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "engine/enginechannelworkerpool.h"
+#include "util/sample.h"
+
+namespace {
+
+class EngineScratchArenaTest : public testing::Test {
+  protected:
+    EngineScratchArenaTest()
+            : m_arena(4096) {
+    }
+
+    EngineScratchArena m_arena;
+};
+
+TEST_F(EngineScratchArenaTest, allocatesAlignedBuffers) {
+    EngineScratchArena::Scope scratch(&m_arena);
+    CSAMPLE* pFirst = scratch.allocate(3);
+    CSAMPLE* pSecond = scratch.allocate(100);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(pSecond) % 16);
+    EXPECT_GE(pSecond, pFirst + 3);
+    // Rounded up to the alignment
+    EXPECT_GE(m_arena.used(), 103);
+    EXPECT_LE(m_arena.used(), m_arena.capacity());
+}
+
+TEST_F(EngineScratchArenaTest, releasesBuffersAtTheEndOfTheScope) {
+    CSAMPLE* pOuterBuffer;
+    CSAMPLE* pFirstInnerBuffer;
+    {
+        EngineScratchArena::Scope outer(&m_arena);
+        pOuterBuffer = outer.allocate(256);
+        SINT usedByOuter = m_arena.used();
+        {
+            EngineScratchArena::Scope inner(&m_arena);
+            pFirstInnerBuffer = inner.allocate(512);
+            EXPECT_NE(pOuterBuffer, pFirstInnerBuffer);
+        }
+        EXPECT_EQ(usedByOuter, m_arena.used());
+        {
+            // Reuses the memory of the previous inner scope
+            EngineScratchArena::Scope inner(&m_arena);
+            EXPECT_EQ(pFirstInnerBuffer, inner.allocate(512));
+        }
+    }
+    EXPECT_EQ(0, m_arena.used());
+
+    m_arena.reset();
+    EngineScratchArena::Scope scope(&m_arena);
+    EXPECT_EQ(pOuterBuffer, scope.allocate(256));
+}
+
+TEST_F(EngineScratchArenaTest, currentArenaPerThread) {
+    EngineScratchArena::setCurrent(&m_arena);
+    EXPECT_EQ(&m_arena, EngineScratchArena::current());
+
+    EngineScratchArena* pOtherThreadArena = nullptr;
+    std::thread thread([&pOtherThreadArena] {
+        pOtherThreadArena = EngineScratchArena::current();
+        // Allocated lazily
+        EngineScratchArena::Scope scratch;
+        EXPECT_NE(nullptr, scratch.allocate(EngineScratchArena::kDefaultCapacity));
+    });
+    thread.join();
+    EXPECT_NE(nullptr, pOtherThreadArena);
+    EXPECT_NE(&m_arena, pOtherThreadArena);
+
+    EngineScratchArena::setCurrent(nullptr);
+}
+
+TEST_F(EngineScratchArenaTest, workerThreadsHaveSeparateArenas) {
+    EngineChannelWorkerPool pool(3);
+    std::array<CSAMPLE*, 4> buffers{};
+    auto processItem = [&buffers](int index) {
+        EngineScratchArena::Scope scratch;
+        CSAMPLE* pBuffer = scratch.allocate(1024);
+        SampleUtil::fill(pBuffer, static_cast<CSAMPLE>(index), 1024);
+        // Give the other workers time to overwrite a shared buffer
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        for (int i = 0; i < 1024; ++i) {
+            ASSERT_EQ(static_cast<CSAMPLE>(index), pBuffer[i]);
+        }
+        buffers[index] = pBuffer;
+    };
+    pool.processItems(static_cast<int>(buffers.size()), processItem);
+    for (CSAMPLE* pBuffer : buffers) {
+        EXPECT_NE(nullptr, pBuffer);
+    }
+}
+
+} // namespace
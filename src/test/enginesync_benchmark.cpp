@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "engine/sync/enginesync.h"
+
+// Measures the sync work of a callback with a leader and many followers.
+// The argument is the number of synchronized decks. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_EngineSync
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr std::size_t kBufferSize = 1024;
+constexpr mixxx::Bpm kBpm = mixxx::Bpm(124.0);
+
+// A deck that reads the leader snapshot like SyncControl does
+class FakeSyncable : public Syncable {
+  public:
+    FakeSyncable(const QString& group, EngineSync* pEngineSync, bool playing)
+            : m_group(group),
+              m_pEngineSync(pEngineSync),
+              m_playing(playing),
+              m_mode(SyncMode::None),
+              m_beatDistance(0.0),
+              m_targetBeatDistance(0.0),
+              m_instantaneousBpm(0.0),
+              m_beatDistanceSequence(0),
+              m_instantaneousBpmSequence(0) {
+    }
+
+    const QString& getGroup() const override {
+        return m_group;
+    }
+    EngineChannel* getChannel() const override {
+        return nullptr;
+    }
+    void setSyncMode(SyncMode mode) override {
+        m_mode = mode;
+    }
+    void notifyUniquePlaying() override {
+    }
+    void requestSync() override {
+    }
+    SyncMode getSyncMode() const override {
+        return m_mode;
+    }
+    bool isPlaying() const override {
+        return m_playing;
+    }
+    bool isAudible() const override {
+        return m_playing;
+    }
+    bool isQuantized() const override {
+        return true;
+    }
+    mixxx::Bpm getBpm() const override {
+        return kBpm;
+    }
+    double getBeatDistance() const override {
+        return m_beatDistance;
+    }
+    mixxx::Bpm getBaseBpm() const override {
+        return kBpm;
+    }
+    void updateLeaderBeatDistance(double beatDistance) override {
+        m_targetBeatDistance = beatDistance;
+        m_beatDistanceSequence = m_pEngineSync->getLeaderSnapshot().beatDistanceSequence;
+    }
+    void updateLeaderBpm(mixxx::Bpm bpm) override {
+        Q_UNUSED(bpm);
+    }
+    void notifyLeaderParamSource() override {
+    }
+    void reinitLeaderParams(double beatDistance, mixxx::Bpm baseBpm, mixxx::Bpm bpm) override {
+        Q_UNUSED(baseBpm);
+        Q_UNUSED(bpm);
+        updateLeaderBeatDistance(beatDistance);
+    }
+    void updateInstantaneousBpm(mixxx::Bpm bpm) override {
+        m_instantaneousBpm = bpm.valueOr(0.0);
+        m_instantaneousBpmSequence =
+                m_pEngineSync->getLeaderSnapshot().instantaneousBpmSequence;
+    }
+
+    // Like SyncControl::readLeaderSnapshot()
+    void readLeaderSnapshot() {
+        const SyncLeaderSnapshot& snapshot = m_pEngineSync->getLeaderSnapshot();
+        if (snapshot.instantaneousBpmSequence != m_instantaneousBpmSequence) {
+            updateInstantaneousBpm(snapshot.instantaneousBpm);
+        }
+        if (snapshot.beatDistanceSequence != m_beatDistanceSequence) {
+            updateLeaderBeatDistance(snapshot.beatDistance);
+        }
+    }
+
+    double advance() {
+        m_beatDistance += kBufferSize / 2 * kBpm.value() / 60.0 / kSampleRate;
+        if (m_beatDistance >= 1.0) {
+            m_beatDistance -= 1.0;
+        }
+        return m_beatDistance;
+    }
+
+    double targetBeatDistance() const {
+        return m_targetBeatDistance;
+    }
+
+  private:
+    const QString m_group;
+    EngineSync* const m_pEngineSync;
+    const bool m_playing;
+    SyncMode m_mode;
+    double m_beatDistance;
+    double m_targetBeatDistance;
+    double m_instantaneousBpm;
+    quint64 m_beatDistanceSequence;
+    quint64 m_instantaneousBpmSequence;
+};
+
+// Only the leader is playing, so it publishes its beat distance in each
+// callback like the unique playing deck does.
+void BM_EngineSync_Callback(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    EngineSync engineSync(UserSettingsPointer(new UserSettings(QString())));
+    std::vector<std::unique_ptr<FakeSyncable>> decks;
+    decks.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        decks.push_back(std::make_unique<FakeSyncable>(
+                QStringLiteral("[Channel%1]").arg(i + 1), &engineSync, i == 0));
+        decks.back()->setSyncMode(i == 0 ? SyncMode::LeaderSoft : SyncMode::Follower);
+        engineSync.addSyncableDeck(decks.back().get());
+    }
+    FakeSyncable* pLeader = decks.front().get();
+
+    for (auto _ : state) {
+        engineSync.onCallbackStart(kSampleRate, kBufferSize);
+        for (const auto& pDeck : decks) {
+            pDeck->readLeaderSnapshot();
+        }
+        engineSync.notifyBeatDistanceChanged(pLeader, pLeader->advance());
+        engineSync.onCallbackEnd(kSampleRate, kBufferSize);
+        for (const auto& pDeck : decks) {
+            pDeck->readLeaderSnapshot();
+        }
+        benchmark::DoNotOptimize(decks.back()->targetBeatDistance());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_EngineSync_Callback)->Arg(4)->Arg(16)->Arg(32);
+
+} // namespace
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "pa_ringbuffer.h"
+#include "util/fifo.h"
+#include "util/types.h"
+
+// Compares FIFO with the PortAudio ring buffer that it used to wrap. The
+// samples are passed from a producer to a consumer thread in chunks like
+// those of the engine and the sidechain. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_Fifo
+
+namespace {
+
+constexpr int kFifoSize = 32768;
+constexpr int kSamplesPerIteration = 1024 * 1024;
+
+// The PortAudio ring buffer without the wrapper
+class PaFifo {
+  public:
+    explicit PaFifo(int size)
+            : m_data(size) {
+        PaUtil_InitializeRingBuffer(&m_ringBuffer,
+                static_cast<ring_buffer_size_t>(sizeof(CSAMPLE)),
+                static_cast<ring_buffer_size_t>(m_data.size()),
+                m_data.data());
+    }
+    int read(CSAMPLE* pData, int count) {
+        return PaUtil_ReadRingBuffer(&m_ringBuffer, pData, count);
+    }
+    int write(const CSAMPLE* pData, int count) {
+        return PaUtil_WriteRingBuffer(&m_ringBuffer, pData, count);
+    }
+
+  private:
+    std::vector<CSAMPLE> m_data;
+    PaUtilRingBuffer m_ringBuffer;
+};
+
+template<typename Fifo>
+void transferSamples(benchmark::State& state) {
+    const int chunkSize = static_cast<int>(state.range(0));
+    Fifo fifo(kFifoSize);
+    const std::vector<CSAMPLE> input(chunkSize, 1.0f);
+    std::vector<CSAMPLE> output(chunkSize);
+    for (auto _ : state) {
+        std::thread producer([&fifo, &input, chunkSize] {
+            int written = 0;
+            while (written < kSamplesPerIteration) {
+                written += fifo.write(input.data(),
+                        std::min(chunkSize, kSamplesPerIteration - written));
+            }
+        });
+        int read = 0;
+        while (read < kSamplesPerIteration) {
+            read += fifo.read(output.data(),
+                    std::min(chunkSize, kSamplesPerIteration - read));
+        }
+        producer.join();
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kSamplesPerIteration);
+}
+
+void BM_Fifo_PaUtilRingBuffer(benchmark::State& state) {
+    transferSamples<PaFifo>(state);
+}
+BENCHMARK(BM_Fifo_PaUtilRingBuffer)->Arg(16)->Arg(256)->Arg(2048);
+
+void BM_Fifo_FIFO(benchmark::State& state) {
+    transferSamples<FIFO<CSAMPLE>>(state);
+}
+BENCHMARK(BM_Fifo_FIFO)->Arg(16)->Arg(256)->Arg(2048);
+
+} // namespace
@@ -0,0 +1,56 @@
+#include "util/fifo.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+TEST(FifoTest, sizeIsRoundedUpToPowerOfTwo) {
+    FIFO<int> fifo(100);
+    EXPECT_EQ(0, fifo.readAvailable());
+    EXPECT_EQ(128, fifo.writeAvailable());
+}
+
+TEST(FifoTest, writeIsLimitedToWriteAvailable) {
+    FIFO<int> fifo(8);
+    const std::vector<int> input{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(8, fifo.write(input.data(), static_cast<int>(input.size())));
+    EXPECT_EQ(0, fifo.writeAvailable());
+    EXPECT_EQ(8, fifo.readAvailable());
+
+    std::vector<int> output(10);
+    EXPECT_EQ(8, fifo.read(output.data(), static_cast<int>(output.size())));
+    EXPECT_EQ(std::vector<int>(input.begin(), input.begin() + 8),
+            std::vector<int>(output.begin(), output.begin() + 8));
+    EXPECT_EQ(0, fifo.read(output.data(), 1));
+}
+
+TEST(FifoTest, regionsWrapAround) {
+    FIFO<int> fifo(8);
+    const std::vector<int> input{0, 1, 2, 3, 4, 5};
+    fifo.write(input.data(), 6);
+    fifo.flushReadData(4);
+
+    int* pRegion1;
+    ring_buffer_size_t size1;
+    int* pRegion2;
+    ring_buffer_size_t size2;
+    EXPECT_EQ(5, fifo.aquireWriteRegions(5, &pRegion1, &size1, &pRegion2, &size2));
+    EXPECT_EQ(2, size1);
+    EXPECT_EQ(3, size2);
+    for (int i = 0; i < size1; ++i) {
+        pRegion1[i] = 6 + i;
+    }
+    for (int i = 0; i < size2; ++i) {
+        pRegion2[i] = 6 + size1 + i;
+    }
+    fifo.releaseWriteRegions(5);
+    EXPECT_EQ(7, fifo.readAvailable());
+
+    std::vector<int> output(7);
+    EXPECT_EQ(7, fifo.read(output.data(), 7));
+    EXPECT_EQ((std::vector<int>{4, 5, 6, 7, 8, 9, 10}), output);
+}
+
+} // namespace
@@ -1,5 +1,6 @@
 #include "track/globaltrackcache.h"
 
+#include <QSemaphore>
 #include <QThread>
 #include <QtDebug>
 #include <atomic>
@@ -99,7 +100,7 @@ TEST_F(GlobalTrackCacheTest, resolveByFileInfo) {
         auto resolver = GlobalTrackCacheResolver(testFileAccess);
         pTrack = resolver.getTrack();
         EXPECT_TRUE(static_cast<bool>(pTrack));
-        // track, GlobalTrackCacheResolver::m_strongPtr and GlobalTrackCache::m_incompleteTrack
+        // track, GlobalTrackCacheResolver::m_strongPtr and GlobalTrackCache::m_incompleteTracks
         EXPECT_EQ(3, pTrack.use_count());
 
         resolver.initTrackIdAndUnlockCache(trackId);
@@ -209,6 +210,105 @@ TEST_F(GlobalTrackCacheTest, concurrentDelete) {
     workerThread.wait();
 }
 
+TEST_F(GlobalTrackCacheTest, resolveMultipleIncompleteTracks) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+
+    TrackPointer track1;
+    TrackPointer track2;
+    {
+        // Resolving a track must not wait until the metadata of
+        // another, unrelated track has been loaded
+        auto resolver1 = GlobalTrackCacheResolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile))));
+        auto resolver2 = GlobalTrackCacheResolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile2))));
+        EXPECT_EQ(GlobalTrackCacheLookupResult::Miss, resolver1.getLookupResult());
+        EXPECT_EQ(GlobalTrackCacheLookupResult::Miss, resolver2.getLookupResult());
+        track1 = resolver1.getTrack();
+        track2 = resolver2.getTrack();
+        ASSERT_TRUE(static_cast<bool>(track1));
+        ASSERT_TRUE(static_cast<bool>(track2));
+        EXPECT_NE(track1, track2);
+
+        resolver2.initTrackIdAndUnlockCache(trackId2);
+        resolver1.initTrackIdAndUnlockCache(trackId1);
+    }
+
+    {
+        GlobalTrackCacheLocker cacheLocker;
+        const auto tracks = cacheLocker.lookupTracksByIds(
+                QSet<TrackId>{trackId1, trackId2, TrackId(QVariant(3))});
+        EXPECT_EQ(2, tracks.size());
+        EXPECT_TRUE(tracks.contains(track1));
+        EXPECT_TRUE(tracks.contains(track2));
+    }
+
+    track1.reset();
+    track2.reset();
+
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
+
+TEST_F(GlobalTrackCacheTest, resolveIncompleteTracksOfEachOther) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const auto fileAccess1 =
+            mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile)));
+    const auto fileAccess2 =
+            mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile2)));
+
+    // Each thread resolves its own track and, while it is still
+    // incomplete, the incomplete track of the other thread. Waiting for
+    // the other track would never finish.
+    QSemaphore resolved;
+    TrackPointer tracks[2];
+    TrackPointer otherTracks[2];
+    GlobalTrackCacheLookupResult otherLookupResults[2] = {
+            GlobalTrackCacheLookupResult::None, GlobalTrackCacheLookupResult::None};
+    const auto resolveBoth = [&](int index,
+                                     const mixxx::FileAccess& fileAccess,
+                                     const mixxx::FileAccess& otherFileAccess) {
+        auto resolver = GlobalTrackCacheResolver(fileAccess);
+        tracks[index] = resolver.getTrack();
+        resolved.release();
+        // Both tracks are incomplete now
+        resolved.acquire(2);
+        resolved.release(2);
+        {
+            auto otherResolver = GlobalTrackCacheResolver(otherFileAccess);
+            otherLookupResults[index] = otherResolver.getLookupResult();
+            otherTracks[index] = otherResolver.getTrack();
+        }
+        resolver.initTrackIdAndUnlockCache(TrackId(QVariant(index + 1)));
+    };
+
+    std::unique_ptr<QThread> pThread1(QThread::create(resolveBoth, 0, fileAccess1, fileAccess2));
+    std::unique_ptr<QThread> pThread2(QThread::create(resolveBoth, 1, fileAccess2, fileAccess1));
+    pThread1->start();
+    pThread2->start();
+    ASSERT_TRUE(pThread1->wait(10000));
+    ASSERT_TRUE(pThread2->wait(10000));
+
+    ASSERT_TRUE(static_cast<bool>(tracks[0]));
+    ASSERT_TRUE(static_cast<bool>(tracks[1]));
+    // The incomplete tracks are returned as cache hits
+    EXPECT_EQ(GlobalTrackCacheLookupResult::Hit, otherLookupResults[0]);
+    EXPECT_EQ(GlobalTrackCacheLookupResult::Hit, otherLookupResults[1]);
+    EXPECT_EQ(tracks[1], otherTracks[0]);
+    EXPECT_EQ(tracks[0], otherTracks[1]);
+
+    for (auto& pTrack : tracks) {
+        pTrack.reset();
+    }
+    for (auto& pTrack : otherTracks) {
+        pTrack.reset();
+    }
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
+
 TEST_F(GlobalTrackCacheTest, evictWhileMoving) {
     ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
 
@@ -0,0 +1,173 @@
+#include "sources/httpblockreader.h"
+
+#include <gtest/gtest.h>
+
+#include <QRegularExpression>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QThread>
+#include <atomic>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+using mixxx::HttpBlockReader;
+
+/// Serves a single file from a separate thread, optionally
+/// without support for range requests.
+class RangeServer {
+  public:
+    RangeServer(QByteArray data, bool supportsRanges)
+            : m_data(std::move(data)),
+              m_supportsRanges(supportsRanges),
+              m_requestCount(0) {
+        m_server.listen(QHostAddress::LocalHost);
+        QObject::connect(&m_server, &QTcpServer::newConnection, &m_server, [this] {
+            while (QTcpSocket* pSocket = m_server.nextPendingConnection()) {
+                QObject::connect(pSocket, &QTcpSocket::readyRead, pSocket, [this, pSocket] {
+                    respond(pSocket);
+                });
+            }
+        });
+        m_server.moveToThread(&m_thread);
+        m_thread.start();
+    }
+
+    ~RangeServer() {
+        QMetaObject::invokeMethod(
+                &m_server, [this] { m_server.close(); }, Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    QUrl url() const {
+        return QUrl(QStringLiteral("http://127.0.0.1:%1/track.mp3")
+                            .arg(m_server.serverPort()));
+    }
+
+    int requestCount() const {
+        return m_requestCount.load();
+    }
+
+  private:
+    void respond(QTcpSocket* pSocket) {
+        QByteArray& request = m_pendingRequests[pSocket];
+        request += pSocket->readAll();
+        // Connections are reused for multiple requests
+        qsizetype headerEnd;
+        while ((headerEnd = request.indexOf("\r\n\r\n")) >= 0) {
+            const QString header = QString::fromLatin1(request.left(headerEnd));
+            request.remove(0, headerEnd + 4);
+            ++m_requestCount;
+            static const QRegularExpression kRangeRegex(
+                    QStringLiteral("Range: bytes=(\\d+)-(\\d+)"),
+                    QRegularExpression::CaseInsensitiveOption);
+            const auto match = kRangeRegex.match(header);
+            QByteArray response;
+            if (m_supportsRanges && match.hasMatch()) {
+                const qint64 first = match.captured(1).toLongLong();
+                const qint64 last = std::min(match.captured(2).toLongLong(),
+                        static_cast<qint64>(m_data.size()) - 1);
+                const QByteArray body = m_data.mid(first, last - first + 1);
+                response = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " +
+                        QByteArray::number(first) + '-' + QByteArray::number(last) +
+                        '/' + QByteArray::number(m_data.size()) +
+                        "\r\nETag: \"1\"\r\nContent-Length: " +
+                        QByteArray::number(body.size()) + "\r\n\r\n" + body;
+            } else {
+                response = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                        QByteArray::number(m_data.size()) + "\r\n\r\n" + m_data;
+            }
+            pSocket->write(response);
+        }
+    }
+
+    const QByteArray m_data;
+    const bool m_supportsRanges;
+    std::atomic<int> m_requestCount;
+    QHash<QTcpSocket*, QByteArray> m_pendingRequests;
+    QTcpServer m_server;
+    QThread m_thread;
+};
+
+QByteArray createData(qint64 size) {
+    QByteArray data(size, '\0');
+    quint32 value = 12345;
+    for (auto& byte : data) {
+        value = value * 1103515245 + 12345;
+        byte = static_cast<char>(value >> 24);
+    }
+    return data;
+}
+
+QByteArray readAll(HttpBlockReader* pReader, qint64 pos, qint64 size) {
+    QByteArray result(size, '\0');
+    qint64 readCount = 0;
+    while (readCount < size) {
+        const qint64 count = pReader->read(
+                pos + readCount, result.data() + readCount, size - readCount);
+        if (count <= 0) {
+            break;
+        }
+        readCount += count;
+    }
+    result.truncate(readCount);
+    return result;
+}
+
+class HttpBlockReaderTest : public MixxxTest {
+  protected:
+    void TearDown() override {
+        HttpBlockReader::initialize(QString(), 0);
+    }
+};
+
+TEST_F(HttpBlockReaderTest, readsAcrossBlocks) {
+    const QByteArray data = createData(3 * HttpBlockReader::kBlockSize + 1234);
+    RangeServer server(data, true);
+    HttpBlockReader reader(server.url());
+    ASSERT_TRUE(reader.open());
+    EXPECT_EQ(data.size(), reader.size());
+
+    const qint64 pos = HttpBlockReader::kBlockSize - 10;
+    EXPECT_EQ(data.mid(pos, 2 * HttpBlockReader::kBlockSize),
+            readAll(&reader, pos, 2 * HttpBlockReader::kBlockSize));
+    // Up to the end of the file
+    EXPECT_EQ(data.right(100), readAll(&reader, data.size() - 100, 1000));
+    char byte;
+    EXPECT_EQ(0, reader.read(data.size(), &byte, 1));
+}
+
+TEST_F(HttpBlockReaderTest, reusesCachedBlocks) {
+    QTemporaryDir cacheDir;
+    ASSERT_TRUE(cacheDir.isValid());
+    HttpBlockReader::initialize(cacheDir.path(), 64 * 1024 * 1024);
+
+    const QByteArray data = createData(2 * HttpBlockReader::kBlockSize + 1);
+    RangeServer server(data, true);
+    {
+        HttpBlockReader reader(server.url());
+        ASSERT_TRUE(reader.open());
+        EXPECT_EQ(data, readAll(&reader, 0, data.size()));
+    }
+    const int requestCount = server.requestCount();
+    EXPECT_EQ(3, requestCount);
+
+    // Only the first block is requested again for validating the file
+    HttpBlockReader reader(server.url());
+    ASSERT_TRUE(reader.open());
+    EXPECT_EQ(data, readAll(&reader, 0, data.size()));
+    EXPECT_EQ(requestCount + 1, server.requestCount());
+}
+
+TEST_F(HttpBlockReaderTest, failsWithoutRangeRequests) {
+    RangeServer server(createData(1000), false);
+    HttpBlockReader reader(server.url());
+    EXPECT_FALSE(reader.open());
+    char byte;
+    EXPECT_EQ(-1, reader.read(0, &byte, 1));
+}
+
+} // namespace
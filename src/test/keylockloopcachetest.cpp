@@ -0,0 +1,107 @@
+#include "engine/bufferscalers/keylockloopcache.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr SINT kBufferFrames = 512;
+constexpr double kLoopStart = 1000;
+constexpr double kLoopLength = 8000;
+
+// The output of a fake scaler at the given track position
+CSAMPLE signalAt(double position) {
+    return static_cast<CSAMPLE>(std::sin(2 * M_PI * position / 100.0));
+}
+
+class KeylockLoopCacheTest : public testing::Test {
+  protected:
+    KeylockLoopCacheTest()
+            : m_cache(2 * 48000 * 2),
+              m_position(kLoopStart + 5000) {
+        m_key.baseRate = 1.0;
+        m_key.tempoRatio = 1.0;
+        m_key.pitchRatio = 1.0;
+        m_key.loopStartPosition = mixxx::audio::FramePos(kLoopStart);
+        m_key.loopEndPosition = mixxx::audio::FramePos(kLoopStart + kLoopLength);
+        m_key.channelCount = mixxx::audio::ChannelCount::stereo();
+    }
+
+    // Renders and records a buffer like the scaler
+    void renderBuffer() {
+        std::vector<CSAMPLE> output(kBufferFrames * 2);
+        const mixxx::audio::FramePos startPosition(m_position);
+        for (SINT frame = 0; frame < kBufferFrames; ++frame) {
+            output[frame * 2] = signalAt(m_position);
+            output[frame * 2 + 1] = -signalAt(m_position);
+            m_position += 1;
+            if (m_position >= kLoopStart + kLoopLength) {
+                m_position -= kLoopLength;
+            }
+        }
+        m_cache.record(m_key,
+                output.data(),
+                kBufferFrames * 2,
+                startPosition,
+                mixxx::audio::FramePos(m_position));
+    }
+
+    KeylockLoopCache m_cache;
+    KeylockLoopCache::Key m_key;
+    double m_position;
+};
+
+TEST_F(KeylockLoopCacheTest, ReplaysLoop) {
+    // Recording starts after the first wrap around and takes one pass
+    int buffers = 0;
+    while (!m_cache.isReplayPending()) {
+        ASSERT_LT(buffers++, 3 * kLoopLength / kBufferFrames);
+        renderBuffer();
+    }
+    EXPECT_TRUE(m_cache.matches(m_key));
+
+    // Several passes through the loop continue where the scaler stopped
+    std::vector<CSAMPLE> output(kBufferFrames * 2);
+    for (int i = 0; i < 3 * kLoopLength / kBufferFrames; ++i) {
+        const mixxx::audio::FramePos position =
+                m_cache.replay(output.data(), kBufferFrames * 2);
+        EXPECT_TRUE(m_cache.isReplaying());
+        for (SINT frame = 0; frame < kBufferFrames; ++frame) {
+            ASSERT_NEAR(signalAt(m_position), output[frame * 2], 1e-5);
+            ASSERT_NEAR(-signalAt(m_position), output[frame * 2 + 1], 1e-5);
+            m_position += 1;
+            if (m_position >= kLoopStart + kLoopLength) {
+                m_position -= kLoopLength;
+            }
+        }
+        EXPECT_NEAR(m_position, position.value(), 1e-6);
+    }
+}
+
+TEST_F(KeylockLoopCacheTest, ChangedKeyInvalidates) {
+    while (!m_cache.isReplayPending()) {
+        renderBuffer();
+    }
+    KeylockLoopCache::Key key = m_key;
+    key.tempoRatio = 1.01;
+    EXPECT_FALSE(m_cache.matches(key));
+
+    m_key = key;
+    renderBuffer();
+    EXPECT_FALSE(m_cache.isReplayPending());
+    EXPECT_FALSE(m_cache.isReplaying());
+}
+
+TEST_F(KeylockLoopCacheTest, LongLoopIsNotCached) {
+    m_key.loopEndPosition = mixxx::audio::FramePos(kLoopStart + 10 * 48000);
+    for (int i = 0; i < 2 * kLoopLength / kBufferFrames; ++i) {
+        renderBuffer();
+    }
+    EXPECT_FALSE(m_cache.matches(m_key));
+}
+
+} // namespace
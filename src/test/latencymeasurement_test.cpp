@@ -0,0 +1,109 @@
+#include "soundio/latencymeasurement.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <vector>
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(48000);
+constexpr int kFrameSize = 2;
+constexpr SINT kFramesPerBuffer = 256;
+
+class LatencyMeasurementTest : public testing::Test {
+  protected:
+    /// Runs the callbacks of a device whose outputs are connected to its
+    /// inputs with a delay of latencyFrames, until the measurement has
+    /// finished or the number of callbacks is exceeded.
+    void runLoopback(SINT latencyFrames, CSAMPLE noise = 0, int maxCallbacks = 2000) {
+        std::deque<CSAMPLE> cable(latencyFrames * kFrameSize, 0.0f);
+        std::vector<CSAMPLE> input(kFramesPerBuffer * kFrameSize);
+        std::vector<CSAMPLE> output(kFramesPerBuffer * kFrameSize);
+        for (int callback = 0; callback < maxCallbacks && !m_measurement.isFinished();
+                ++callback) {
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                input[i] = cable.front() + (i % 2 ? noise : -noise);
+                cable.pop_front();
+            }
+            m_measurement.processInput(input.data(), kFramesPerBuffer, kFrameSize);
+            std::fill(output.begin(), output.end(), 0.0f);
+            m_measurement.processOutput(output.data(), kFramesPerBuffer, kFrameSize);
+            cable.insert(cable.end(), output.begin(), output.end());
+        }
+    }
+
+    LatencyMeasurement m_measurement;
+};
+
+TEST_F(LatencyMeasurementTest, idleUntilStarted) {
+    runLoopback(1000, 0, 100);
+    EXPECT_EQ(LatencyMeasurement::State::Idle, m_measurement.state());
+}
+
+TEST_F(LatencyMeasurementTest, measuresRoundTrip) {
+    m_measurement.start(kSampleRate);
+    EXPECT_EQ(LatencyMeasurement::State::Pending, m_measurement.state());
+    runLoopback(1234);
+    EXPECT_EQ(LatencyMeasurement::State::Succeeded, m_measurement.state());
+    EXPECT_EQ(1234, m_measurement.roundTripFrames());
+}
+
+TEST_F(LatencyMeasurementTest, measuresRoundTripOfMultipleBuffers) {
+    m_measurement.start(kSampleRate);
+    runLoopback(3 * kFramesPerBuffer);
+    EXPECT_EQ(LatencyMeasurement::State::Succeeded, m_measurement.state());
+    EXPECT_EQ(3 * kFramesPerBuffer, m_measurement.roundTripFrames());
+}
+
+TEST_F(LatencyMeasurementTest, toleratesNoise) {
+    m_measurement.start(kSampleRate);
+    runLoopback(500, 0.02f);
+    EXPECT_EQ(LatencyMeasurement::State::Succeeded, m_measurement.state());
+    EXPECT_EQ(500, m_measurement.roundTripFrames());
+}
+
+TEST_F(LatencyMeasurementTest, failsWithNoisyInput) {
+    m_measurement.start(kSampleRate);
+    runLoopback(500, 0.3f);
+    EXPECT_EQ(LatencyMeasurement::State::NoisyInput, m_measurement.state());
+}
+
+TEST_F(LatencyMeasurementTest, failsWithoutLoopback) {
+    m_measurement.start(kSampleRate);
+    std::vector<CSAMPLE> input(kFramesPerBuffer * kFrameSize, 0.0f);
+    std::vector<CSAMPLE> output(kFramesPerBuffer * kFrameSize, 0.0f);
+    for (int callback = 0; callback < 1000 && !m_measurement.isFinished(); ++callback) {
+        m_measurement.processInput(input.data(), kFramesPerBuffer, kFrameSize);
+        m_measurement.processOutput(output.data(), kFramesPerBuffer, kFrameSize);
+    }
+    EXPECT_EQ(LatencyMeasurement::State::NoSignal, m_measurement.state());
+}
+
+TEST_F(LatencyMeasurementTest, cancelStopsTheImpulses) {
+    m_measurement.start(kSampleRate);
+    runLoopback(500, 0, 10);
+    EXPECT_EQ(LatencyMeasurement::State::Running, m_measurement.state());
+    m_measurement.cancel();
+    std::vector<CSAMPLE> input(kFramesPerBuffer * kFrameSize, 0.0f);
+    std::vector<CSAMPLE> output(kFramesPerBuffer * kFrameSize, 0.0f);
+    for (int callback = 0; callback < 1000; ++callback) {
+        m_measurement.processInput(input.data(), kFramesPerBuffer, kFrameSize);
+        m_measurement.processOutput(output.data(), kFramesPerBuffer, kFrameSize);
+        for (const CSAMPLE sample : output) {
+            ASSERT_EQ(0.0f, sample);
+        }
+    }
+    EXPECT_EQ(LatencyMeasurement::State::Idle, m_measurement.state());
+}
+
+TEST_F(LatencyMeasurementTest, restartsWhenStartedAgain) {
+    m_measurement.start(kSampleRate);
+    runLoopback(500, 0, 60);
+    m_measurement.start(kSampleRate);
+    runLoopback(700);
+    EXPECT_EQ(LatencyMeasurement::State::Succeeded, m_measurement.state());
+    EXPECT_EQ(700, m_measurement.roundTripFrames());
+}
+
+} // namespace
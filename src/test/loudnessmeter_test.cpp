@@ -0,0 +1,96 @@
+#include "analyzer/loudnessmeter.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(48000);
+
+// Appends a stereo sine wave with the given peak level in dBFS
+void appendSine(std::vector<CSAMPLE>* pSamples,
+        double frequency,
+        double levelDb,
+        double seconds,
+        mixxx::audio::SampleRate sampleRate = kSampleRate,
+        double phase = 0) {
+    const double amplitude = db2ratio(levelDb);
+    const auto frameCount = static_cast<SINT>(seconds * sampleRate);
+    for (SINT i = 0; i < frameCount; ++i) {
+        const auto value = static_cast<CSAMPLE>(
+                amplitude * std::sin(2 * M_PI * frequency * i / sampleRate + phase));
+        pSamples->push_back(value);
+        pSamples->push_back(value);
+    }
+}
+
+// Processes the samples in chunks of an odd size
+LoudnessMeter measure(const std::vector<CSAMPLE>& samples,
+        mixxx::audio::SampleRate sampleRate = kSampleRate) {
+    LoudnessMeter meter(sampleRate);
+    constexpr SINT kChunkSamples = 2 * 1234;
+    for (std::size_t offset = 0; offset < samples.size(); offset += kChunkSamples) {
+        meter.processStereoSamples(samples.data() + offset,
+                math_min(kChunkSamples, static_cast<SINT>(samples.size() - offset)));
+    }
+    meter.finalize();
+    return meter;
+}
+
+// EBU Tech 3341, test case 1
+TEST(LoudnessMeterTest, sine) {
+    std::vector<CSAMPLE> samples;
+    appendSine(&samples, 1000, -23, 20);
+    const auto meter = measure(samples);
+    EXPECT_NEAR(-23, meter.integratedLoudness(), 0.1);
+}
+
+// EBU Tech 3341, test case 3
+TEST(LoudnessMeterTest, relativeGate) {
+    std::vector<CSAMPLE> samples;
+    appendSine(&samples, 1000, -36, 10);
+    appendSine(&samples, 1000, -23, 60);
+    appendSine(&samples, 1000, -36, 10);
+    const auto meter = measure(samples);
+    EXPECT_NEAR(-23, meter.integratedLoudness(), 0.1);
+}
+
+TEST(LoudnessMeterTest, absoluteGate) {
+    std::vector<CSAMPLE> samples(2 * 10 * kSampleRate, 0);
+    appendSine(&samples, 1000, -23, 10);
+    samples.resize(samples.size() + 2 * 10 * kSampleRate, 0);
+    const auto meter = measure(samples);
+    // Only the blocks that overlap with the edges of the sine are quieter
+    EXPECT_NEAR(-23, meter.integratedLoudness(), 0.2);
+}
+
+TEST(LoudnessMeterTest, silence) {
+    const std::vector<CSAMPLE> samples(2 * 10 * kSampleRate, 0);
+    const auto meter = measure(samples);
+    EXPECT_EQ(LoudnessMeter::kLoudnessUndefined, meter.integratedLoudness());
+    EXPECT_EQ(0, meter.truePeak());
+}
+
+TEST(LoudnessMeterTest, truePeak) {
+    // All samples of a sine at a quarter of the sample rate with this
+    // phase are 3 dB below the actual peak
+    std::vector<CSAMPLE> samples;
+    appendSine(&samples, kSampleRate / 4.0, -6, 1, kSampleRate, M_PI / 4);
+    const auto meter = measure(samples);
+    EXPECT_NEAR(db2ratio(-6.0), meter.truePeak(), 0.01);
+}
+
+TEST(LoudnessMeterTest, samplePeakAtHighSampleRate) {
+    constexpr mixxx::audio::SampleRate kHighSampleRate(192000);
+    EXPECT_EQ(1, LoudnessMeter::truePeakOversampling(kHighSampleRate));
+    std::vector<CSAMPLE> samples;
+    appendSine(&samples, kHighSampleRate / 4.0, -6, 1, kHighSampleRate, M_PI / 4);
+    const auto meter = measure(samples, kHighSampleRate);
+    EXPECT_NEAR(db2ratio(-9.0), meter.truePeak(), 0.01);
+}
+
+} // namespace
@@ -0,0 +1,104 @@
+#include "effects/backends/lv2/lv2worker.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+class LV2WorkerTest : public testing::Test {
+  protected:
+    static constexpr int kFifoSize = 64;
+
+    LV2WorkerTest()
+            : m_fifo(kFifoSize),
+              m_message(kFifoSize) {
+    }
+
+    bool writeMessage(const std::vector<char>& data) {
+        return LV2Worker::writeMessage(
+                &m_fifo, static_cast<uint32_t>(data.size()), data.data());
+    }
+
+    /// Returns false if no complete message is available
+    bool readMessage(std::vector<char>* pData) {
+        uint32_t size;
+        if (!LV2Worker::readMessage(&m_fifo, &m_message, &size)) {
+            return false;
+        }
+        pData->assign(m_message.begin(), m_message.begin() + size);
+        return true;
+    }
+
+    static std::vector<char> message(int size, char first) {
+        std::vector<char> data(size);
+        for (int i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(first + i);
+        }
+        return data;
+    }
+
+    FIFO<char> m_fifo;
+    std::vector<char> m_message;
+};
+
+TEST_F(LV2WorkerTest, MessagesKeepTheirBoundaries) {
+    const std::vector<char> first = message(5, 'a');
+    const std::vector<char> empty;
+    const std::vector<char> second = message(12, 'A');
+    ASSERT_TRUE(writeMessage(first));
+    ASSERT_TRUE(writeMessage(empty));
+    ASSERT_TRUE(writeMessage(second));
+
+    std::vector<char> data;
+    ASSERT_TRUE(readMessage(&data));
+    EXPECT_EQ(first, data);
+    ASSERT_TRUE(readMessage(&data));
+    EXPECT_EQ(empty, data);
+    ASSERT_TRUE(readMessage(&data));
+    EXPECT_EQ(second, data);
+    EXPECT_FALSE(readMessage(&data));
+    EXPECT_EQ(0, m_fifo.readAvailable());
+}
+
+TEST_F(LV2WorkerTest, MessagesWrapAroundTheFifo) {
+    // The header and the data of the messages are split at different offsets
+    // at the end of the ring buffer
+    std::vector<char> data;
+    for (int i = 0; i < 3 * kFifoSize; ++i) {
+        const std::vector<char> sent = message(1 + i % 13, static_cast<char>(i));
+        ASSERT_TRUE(writeMessage(sent));
+        ASSERT_TRUE(readMessage(&data));
+        EXPECT_EQ(sent, data);
+    }
+}
+
+TEST_F(LV2WorkerTest, RejectsMessagesWithoutSpace) {
+    const auto headerSize = static_cast<int>(sizeof(uint32_t));
+    ASSERT_TRUE(writeMessage(message(kFifoSize - 2 * headerSize, 'a')));
+    // Neither the header nor a part of the data are written
+    EXPECT_FALSE(writeMessage(message(1, 'b')));
+    EXPECT_EQ(kFifoSize - headerSize, m_fifo.readAvailable());
+    EXPECT_TRUE(writeMessage({}));
+
+    std::vector<char> data;
+    ASSERT_TRUE(readMessage(&data));
+    EXPECT_EQ(message(kFifoSize - 2 * headerSize, 'a'), data);
+    ASSERT_TRUE(readMessage(&data));
+    EXPECT_TRUE(data.empty());
+}
+
+TEST_F(LV2WorkerTest, WaitsForTheCompleteMessage) {
+    // The writer has only written the header and a part of the data yet
+    const uint32_t size = 8;
+    const std::vector<char> sent = message(size, 'a');
+    m_fifo.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    m_fifo.write(sent.data(), 3);
+
+    std::vector<char> data;
+    EXPECT_FALSE(readMessage(&data));
+    // The header has not been consumed
+    EXPECT_EQ(static_cast<int>(sizeof(size)) + 3, m_fifo.readAvailable());
+
+    m_fifo.write(sent.data() + 3, size - 3);
+    ASSERT_TRUE(readMessage(&data));
+    EXPECT_EQ(sent, data);
+}
@@ -1,5 +1,9 @@
 #ifdef USE_BENCH
 #include <benchmark/benchmark.h>
+
+#include "test/analyzer_benchmark.h"
+#include "test/builtineffects_benchmark.h"
+#include "test/engine_benchmark.h"
 #endif
 
 #include "errordialoghandler.h"
@@ -31,6 +35,9 @@ int main(int argc, char **argv) {
     MixxxTest::ApplicationScope applicationScope(argc, argv);
 
     if (run_benchmarks) {
+        registerAnalyzerBenchmarks();
+        registerBuiltInEffectBenchmarks();
+        registerEngineBenchmarks();
         benchmark::RunSpecifiedBenchmarks();
         return 0;
     } else {
@@ -0,0 +1,96 @@
+#include "util/memoryusage.h"
+
+#include <gtest/gtest.h>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+const QString kSubsystem = QStringLiteral("MemoryUsageTest");
+
+class MemoryUsageTest : public MixxxTest {
+  protected:
+    static mixxx::MemoryUsage::Subsystem findSubsystem(const QString& name) {
+        for (const auto& subsystem : mixxx::MemoryUsage::report()) {
+            if (subsystem.name == name) {
+                return subsystem;
+            }
+        }
+        return mixxx::MemoryUsage::Subsystem();
+    }
+};
+
+TEST_F(MemoryUsageTest, sumsInstances) {
+    const auto first = mixxx::MemoryUsage::registerSubsystem(kSubsystem, [] {
+        return qint64{1000};
+    });
+    auto second = mixxx::MemoryUsage::registerSubsystem(kSubsystem, [] {
+        return qint64{2000};
+    });
+
+    auto subsystem = findSubsystem(kSubsystem);
+    EXPECT_EQ(3000, subsystem.bytes);
+    EXPECT_EQ(2, subsystem.instanceCount);
+    EXPECT_FALSE(subsystem.evictable);
+
+    second.reset();
+    subsystem = findSubsystem(kSubsystem);
+    EXPECT_EQ(1000, subsystem.bytes);
+    EXPECT_EQ(1, subsystem.instanceCount);
+}
+
+TEST_F(MemoryUsageTest, unregistersWhenDestroyed) {
+    {
+        auto registration = mixxx::MemoryUsage::registerSubsystem(kSubsystem, [] {
+            return qint64{1000};
+        });
+        // Moving doesn't unregister
+        const auto movedRegistration = std::move(registration);
+        EXPECT_TRUE(movedRegistration.isRegistered());
+        EXPECT_EQ(1, findSubsystem(kSubsystem).instanceCount);
+    }
+    EXPECT_EQ(0, findSubsystem(kSubsystem).instanceCount);
+}
+
+TEST_F(MemoryUsageTest, evictSplitsBudget) {
+    qint64 firstBytes = 3000;
+    qint64 secondBytes = 1000;
+    const auto first = mixxx::MemoryUsage::registerSubsystem(
+            kSubsystem,
+            [&firstBytes] { return firstBytes; },
+            [&firstBytes](qint64 budgetBytes) { firstBytes = budgetBytes; });
+    const auto second = mixxx::MemoryUsage::registerSubsystem(
+            kSubsystem,
+            [&secondBytes] { return secondBytes; },
+            [&secondBytes](qint64 budgetBytes) { secondBytes = budgetBytes; });
+
+    // Within the budget
+    mixxx::MemoryUsage::evict(kSubsystem, 4000);
+    EXPECT_EQ(3000, firstBytes);
+    EXPECT_EQ(1000, secondBytes);
+
+    mixxx::MemoryUsage::evict(kSubsystem, 2000);
+    EXPECT_EQ(1500, firstBytes);
+    EXPECT_EQ(500, secondBytes);
+}
+
+TEST_F(MemoryUsageTest, monitorEnforcesBudget) {
+    constexpr qint64 kMegabyte = 1024 * 1024;
+    qint64 bytes = 3 * kMegabyte;
+    const auto registration = mixxx::MemoryUsage::registerSubsystem(
+            kSubsystem,
+            [&bytes] { return bytes; },
+            [&bytes](qint64 budgetBytes) { bytes = budgetBytes; });
+    mixxx::MemoryUsageMonitor monitor(config());
+
+    // No budget configured
+    monitor.update();
+    EXPECT_EQ(3 * kMegabyte, bytes);
+
+    config()->setValue(ConfigKey("[Memory]", kSubsystem + "_budget_mb"), 2);
+    EXPECT_EQ(2 * kMegabyte, mixxx::MemoryUsageMonitor::budgetBytes(config(), kSubsystem));
+    monitor.update();
+    EXPECT_EQ(2 * kMegabyte, bytes);
+}
+
+} // namespace
@@ -2,6 +2,8 @@
 #include <textidentificationframe.h>
 #include <tstring.h>
 
+#include <QBuffer>
+#include <QImage>
 #include <QtDebug>
 #include <memory>
 
@@ -179,4 +181,32 @@ TEST_F(MetadataTest, CalendarYear) {
     EXPECT_EQ("", mixxx::TrackMetadata::formatCalendarYear("year"));
 }
 
+TEST_F(MetadataTest, ReuseDecodedImages) {
+    const auto encodeImage = [](int size) {
+        QImage image(size, size, QImage::Format_ARGB32);
+        image.fill(Qt::red);
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        return TagLib::ByteVector(data.constData(), static_cast<unsigned int>(data.size()));
+    };
+
+    const TagLib::ByteVector smallImageData = encodeImage(16);
+    const QImage smallImage = mixxx::taglib::loadImageFromByteVector(smallImageData);
+    ASSERT_FALSE(smallImage.isNull());
+    EXPECT_EQ(smallImage.cacheKey(),
+            mixxx::taglib::loadImageFromByteVector(smallImageData).cacheKey());
+
+    // Too large to be kept, 16 MB when decoded
+    const TagLib::ByteVector largeImageData = encodeImage(2048);
+    const QImage largeImage = mixxx::taglib::loadImageFromByteVector(largeImageData);
+    ASSERT_FALSE(largeImage.isNull());
+    EXPECT_NE(largeImage.cacheKey(),
+            mixxx::taglib::loadImageFromByteVector(largeImageData).cacheKey());
+    // The small image has not been evicted by the large one
+    EXPECT_EQ(smallImage.cacheKey(),
+            mixxx::taglib::loadImageFromByteVector(smallImageData).cacheKey());
+}
+
 }  // namespace
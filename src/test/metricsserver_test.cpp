@@ -0,0 +1,95 @@
+#include "soundio/metricsserver.h"
+
+#include <gtest/gtest.h>
+
+#include <QDeadlineTimer>
+#include <QTcpSocket>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+class MetricsServerTest : public MixxxTest {
+};
+
+TEST_F(MetricsServerTest, formatsCumulativeHistogram) {
+    MetricsServer::Snapshot snapshot;
+    snapshot.callbackBuckets[0] = 1;
+    snapshot.callbackBuckets[2] = 2;
+    snapshot.callbackBuckets[EngineProfileStatistics::Histogram::kNumBuckets - 1] = 3;
+    snapshot.callbackCount = 6;
+
+    const QByteArray metrics = MetricsServer::formatMetrics(snapshot);
+    EXPECT_TRUE(metrics.contains(
+            "# TYPE mixxx_engine_callback_duration_seconds histogram\n"));
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_engine_callback_duration_seconds_bucket{le=\"1e-06\"} 1\n"));
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_engine_callback_duration_seconds_bucket{le=\"2e-06\"} 3\n"));
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_engine_callback_duration_seconds_bucket{le=\"+Inf\"} 6\n"));
+    EXPECT_TRUE(metrics.contains("mixxx_engine_callback_duration_seconds_count 6\n"));
+    // Not available
+    EXPECT_FALSE(metrics.contains("mixxx_resident_memory_bytes"));
+}
+
+TEST_F(MetricsServerTest, formatsLabels) {
+    MetricsServer::Snapshot snapshot;
+    snapshot.networkOutputFillLevels = {0.25};
+    snapshot.sideChainLags = {0, 4096};
+    mixxx::MemoryUsage::Subsystem subsystem;
+    subsystem.name = QStringLiteral("Waveforms");
+    subsystem.bytes = 1024;
+    snapshot.memoryUsage = {subsystem};
+    Stat stat;
+    stat.m_tag = QStringLiteral("Quoted \"tag\"");
+    stat.m_report_count = 2;
+    snapshot.stats = {stat};
+
+    const QByteArray metrics = MetricsServer::formatMetrics(snapshot);
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_network_output_buffer_fill_ratio{output=\"1\"} 0.25\n"));
+    EXPECT_TRUE(metrics.contains("mixxx_sidechain_worker_lag_samples{worker=\"2\"} 4096\n"));
+    EXPECT_TRUE(metrics.contains("mixxx_memory_bytes{subsystem=\"Waveforms\"} 1024\n"));
+    EXPECT_TRUE(metrics.contains("mixxx_stat_reports{tag=\"Quoted \\\"tag\\\"\""));
+}
+
+TEST_F(MetricsServerTest, accumulatesProfiles) {
+    MetricsServer server(config(), nullptr, nullptr);
+    EngineProfiler::CallbackProfile profile{};
+    profile.frames = 48;
+    profile.sampleRate = 48000;
+    profile.cacheMisses[1] = 2;
+    // Longer than the buffer of 1 ms
+    profile.stages[static_cast<int>(EngineProfiler::Stage::Callback)].durationNanos = 1500000;
+    server.consumeProfiles({profile, profile}, 3);
+
+    const auto snapshot = server.snapshot();
+    EXPECT_EQ(2u, snapshot.callbackCount);
+    EXPECT_EQ(2u, snapshot.lateCallbacks);
+    EXPECT_EQ(4u, snapshot.cacheMisses);
+    EXPECT_EQ(3u, snapshot.droppedProfiles);
+    EXPECT_DOUBLE_EQ(0.003, snapshot.callbackSeconds);
+}
+
+TEST_F(MetricsServerTest, servesMetrics) {
+    MetricsServer server(config(), nullptr, nullptr);
+    ASSERT_TRUE(server.isListening());
+
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    socket.write("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    // The server runs in this thread
+    QByteArray response;
+    const QDeadlineTimer deadline(5000);
+    while (socket.state() != QAbstractSocket::UnconnectedState && !deadline.hasExpired()) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        response += socket.readAll();
+    }
+    response += socket.readAll();
+
+    EXPECT_TRUE(response.startsWith("HTTP/1.1 200 OK\r\n"));
+    EXPECT_TRUE(response.contains("mixxx_engine_xruns_total 0\n"));
+}
+
+} // namespace
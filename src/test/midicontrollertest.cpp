@@ -96,6 +96,14 @@ class MidiControllerTest : public MixxxTest {
         return m_pController->m_pMapping->getInputMappings().count();
     }
 
+    void scheduleShortMsg(unsigned char status, unsigned char byte1, unsigned char byte2) {
+        m_pController->scheduleShortMsg(status, byte1, byte2);
+    }
+
+    void sendScheduledShortMsgs() {
+        m_pController->sendScheduledShortMsgs();
+    }
+
     void shutdownController() {
         m_pController->m_pScriptEngineLegacy->shutdown();
     }
@@ -663,6 +671,24 @@ TEST_F(MidiControllerTest, JSInputHandler_BindHandler) {
     EXPECT_DOUBLE_EQ(potmeter.get(), kMaxValue);
 }
 
+TEST_F(MidiControllerTest, JSInputHandler_BindAndDisconnectAfterDispatch) {
+    ControlPotmeter potmeter(ConfigKey("[Channel1]", "test_pot"), 0.0, 1.0);
+    m_pController->setMapping(m_pMapping);
+    // Dispatching compiles the mappings
+    receivedShortMessage(0x90, 0x43, 0x7F);
+    EXPECT_DOUBLE_EQ(potmeter.get(), 0.0);
+    evaluateAndAssert(
+            "var connection = midi.makeInputHandler(0x90, 0x43, "
+            "(channel, control, value, status) => {"
+            "engine.setParameter('[Channel1]', 'test_pot', value / 127);"
+            "})");
+    receivedShortMessage(0x90, 0x43, 0x7F);
+    EXPECT_DOUBLE_EQ(potmeter.get(), 1.0);
+    evaluateAndAssert("connection.disconnect()");
+    receivedShortMessage(0x90, 0x43, 0x00);
+    EXPECT_DOUBLE_EQ(potmeter.get(), 1.0);
+}
+
 TEST_F(MidiControllerTest, JSInputHandler_ControllerShutdownSlot) {
     m_pController->setMapping(m_pMapping);
     EXPECT_EQ(getInputMappingCount(), 0);
@@ -690,3 +716,47 @@ TEST_F(MidiControllerTest, JSInputHandler_ErrorWhenStatusIsTooSmall) {
     ASSERT_TRUE(isError);
     EXPECT_EQ(getInputMappingCount(), 0);
 }
+
+TEST_F(MidiControllerTest, ScheduledShortMsgs_ReplacePendingMessages) {
+    {
+        testing::InSequence sequence;
+        EXPECT_CALL(*m_pController, sendShortMsg(0x80, 0x10, 0x00));
+        EXPECT_CALL(*m_pController, sendShortMsg(0xB0, 0x07, 0x20));
+        EXPECT_CALL(*m_pController, sendShortMsg(0x91, 0x10, 0x7F));
+    }
+    scheduleShortMsg(0x90, 0x10, 0x7F);
+    scheduleShortMsg(0xB0, 0x07, 0x10);
+    scheduleShortMsg(0x80, 0x10, 0x00);
+    scheduleShortMsg(0xB0, 0x07, 0x20);
+    // Different channel
+    scheduleShortMsg(0x91, 0x10, 0x7F);
+    sendScheduledShortMsgs();
+}
+
+TEST_F(MidiControllerTest, ScheduledShortMsgs_KeepNrpnSequence) {
+    {
+        testing::InSequence sequence;
+        EXPECT_CALL(*m_pController, sendShortMsg(0xB0, 0x63, 0x01));
+        EXPECT_CALL(*m_pController, sendShortMsg(0xB0, 0x06, 0x05));
+        EXPECT_CALL(*m_pController, sendShortMsg(0xB0, 0x63, 0x02));
+        EXPECT_CALL(*m_pController, sendShortMsg(0xB0, 0x06, 0x06));
+    }
+    scheduleShortMsg(0xB0, 0x63, 0x01);
+    scheduleShortMsg(0xB0, 0x06, 0x05);
+    scheduleShortMsg(0xB0, 0x63, 0x02);
+    scheduleShortMsg(0xB0, 0x06, 0x06);
+    sendScheduledShortMsgs();
+}
+
+TEST_F(MidiControllerTest, ScheduledShortMsgs_SentBeforeSysex) {
+    {
+        testing::InSequence sequence;
+        EXPECT_CALL(*m_pController, sendShortMsg(0x90, 0x10, 0x7F));
+        EXPECT_CALL(*m_pController, sendBytes(QByteArray("\xF0\x7E\xF7", 3)))
+                .WillOnce(testing::Return(true));
+    }
+    scheduleShortMsg(0x90, 0x10, 0x7F);
+    m_pController->send({0xF0, 0x7E, 0xF7});
+    // Nothing left
+    sendScheduledShortMsgs();
+}
@@ -0,0 +1,142 @@
+#include "sources/mp3seekindexcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <vector>
+
+#include "sources/soundsourcemp3.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+using mixxx::Mp3SeekIndexCache;
+
+constexpr qint64 kFileSize = 10 * 1024 * 1024;
+constexpr qint64 kLastModifiedMillis = 1700000000000;
+
+Mp3SeekIndexCache::Entry createEntry() {
+    Mp3SeekIndexCache::Entry entry;
+    entry.channelCount = mixxx::audio::ChannelCount(2);
+    entry.sampleRate = mixxx::audio::SampleRate(44100);
+    entry.bitrate = mixxx::audio::Bitrate(192);
+    // Like a VBR file after a large tag
+    qint64 byteOffset = 4096;
+    for (int i = 0; i < 10000; ++i) {
+        entry.seekFrames.push_back({i * 1152, byteOffset});
+        byteOffset += 417 + (i * 7919) % 600;
+    }
+    entry.frameIndexEnd = 10000 * 1152;
+    return entry;
+}
+
+void expectEqual(const Mp3SeekIndexCache::Entry& expected,
+        const Mp3SeekIndexCache::Entry& actual) {
+    EXPECT_EQ(expected.channelCount, actual.channelCount);
+    EXPECT_EQ(expected.sampleRate, actual.sampleRate);
+    EXPECT_EQ(expected.bitrate, actual.bitrate);
+    EXPECT_EQ(expected.frameIndexEnd, actual.frameIndexEnd);
+    ASSERT_EQ(expected.seekFrames.size(), actual.seekFrames.size());
+    for (std::size_t i = 0; i < expected.seekFrames.size(); ++i) {
+        EXPECT_EQ(expected.seekFrames[i].frameIndex, actual.seekFrames[i].frameIndex);
+        EXPECT_EQ(expected.seekFrames[i].byteOffset, actual.seekFrames[i].byteOffset);
+    }
+}
+
+TEST(Mp3SeekIndexCacheTest, decodesEncodedEntry) {
+    const auto entry = createEntry();
+    const QByteArray data = Mp3SeekIndexCache::encode(entry, kFileSize, kLastModifiedMillis);
+    // The frames have the same duration, but differ in size by up to 600
+    // bytes, which needs 2 bytes
+    EXPECT_LE(data.size(), 3 * static_cast<qsizetype>(entry.seekFrames.size()) + 64);
+
+    Mp3SeekIndexCache::Entry decoded;
+    ASSERT_TRUE(Mp3SeekIndexCache::decode(data, kFileSize, kLastModifiedMillis, &decoded));
+    expectEqual(entry, decoded);
+}
+
+TEST(Mp3SeekIndexCacheTest, rejectsStaleEntry) {
+    const QByteArray data = Mp3SeekIndexCache::encode(
+            createEntry(), kFileSize, kLastModifiedMillis);
+    Mp3SeekIndexCache::Entry decoded;
+    EXPECT_FALSE(Mp3SeekIndexCache::decode(data, kFileSize + 1, kLastModifiedMillis, &decoded));
+    EXPECT_FALSE(Mp3SeekIndexCache::decode(data, kFileSize, kLastModifiedMillis + 1, &decoded));
+}
+
+TEST(Mp3SeekIndexCacheTest, rejectsCorruptEntry) {
+    const QByteArray data = Mp3SeekIndexCache::encode(
+            createEntry(), kFileSize, kLastModifiedMillis);
+    Mp3SeekIndexCache::Entry decoded;
+    EXPECT_FALSE(Mp3SeekIndexCache::decode(
+            data.left(data.size() - 1), kFileSize, kLastModifiedMillis, &decoded));
+    EXPECT_FALSE(Mp3SeekIndexCache::decode(
+            data + '\0', kFileSize, kLastModifiedMillis, &decoded));
+    // All frames must be within the file
+    const QByteArray truncatedFileData = Mp3SeekIndexCache::encode(
+            createEntry(), 4096, kLastModifiedMillis);
+    EXPECT_FALSE(Mp3SeekIndexCache::decode(
+            truncatedFileData, 4096, kLastModifiedMillis, &decoded));
+}
+
+class Mp3SeekIndexCacheFileTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_cacheDir.isValid());
+        Mp3SeekIndexCache::initialize(m_cacheDir.path(), 1024 * 1024);
+    }
+
+    void TearDown() override {
+        Mp3SeekIndexCache::initialize(QString(), 0);
+    }
+
+    int cacheFileCount() const {
+        return QDir(m_cacheDir.path()).entryList(QDir::Files).size();
+    }
+
+    QTemporaryDir m_cacheDir;
+};
+
+TEST_F(Mp3SeekIndexCacheFileTest, reopenedFileDecodesTheSameSamples) {
+    const QUrl url = QUrl::fromLocalFile(
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-vbr.mp3")));
+    mixxx::SoundSourceMp3 scanned(url);
+    ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+            scanned.open(mixxx::AudioSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams()));
+    EXPECT_EQ(1, cacheFileCount());
+
+    mixxx::SoundSourceMp3 restored(url);
+    ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+            restored.open(mixxx::AudioSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams()));
+    EXPECT_EQ(scanned.getSignalInfo(), restored.getSignalInfo());
+    EXPECT_EQ(scanned.getBitrate(), restored.getBitrate());
+    ASSERT_EQ(scanned.frameIndexRange(), restored.frameIndexRange());
+
+    // Seek into the middle and read up to the end, including the last
+    // MP3 frame that is decoded from a padded copy
+    const auto range = mixxx::IndexRange::between(
+            scanned.frameIndexRange().start() + scanned.frameLength() / 2,
+            scanned.frameIndexRange().end());
+    mixxx::SampleBuffer scannedSamples(scanned.getSignalInfo().frames2samples(range.length()));
+    mixxx::SampleBuffer restoredSamples(scannedSamples.size());
+    const auto scannedRange = scanned.readSampleFrames(
+                                             mixxx::WritableSampleFrames(range,
+                                                     mixxx::SampleBuffer::WritableSlice(
+                                                             scannedSamples)))
+                                      .frameIndexRange();
+    const auto restoredRange = restored.readSampleFrames(
+                                               mixxx::WritableSampleFrames(range,
+                                                       mixxx::SampleBuffer::WritableSlice(
+                                                               restoredSamples)))
+                                       .frameIndexRange();
+    ASSERT_EQ(scannedRange, restoredRange);
+    for (SINT i = 0; i < scanned.getSignalInfo().frames2samples(scannedRange.length()); ++i) {
+        ASSERT_EQ(scannedSamples[i], restoredSamples[i]);
+    }
+}
+
+} // namespace
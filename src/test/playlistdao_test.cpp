@@ -0,0 +1,114 @@
+#include "library/dao/playlistdao.h"
+
+#include <gtest/gtest.h>
+#include <limits>
+
+#include "library/trackcollection.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+class PlaylistDAOTest : public LibraryTest {
+  protected:
+    PlaylistDAOTest()
+            : m_playlistDAO(internalCollection()->getPlaylistDAO()) {
+        for (int i = 0; i < 6; ++i) {
+            const mixxx::FileInfo fileInfo(QDir(QDir::tempPath()),
+                    QStringLiteral("playlistdao%1.mp3").arg(QString::number(i)));
+            m_trackIds.append(internalCollection()->addTrack(
+                    Track::newTemporary(mixxx::FileAccess(fileInfo)), false));
+        }
+        m_playlistId = m_playlistDAO.createPlaylist(QStringLiteral("test"));
+    }
+
+    // The tracks of the playlist ordered by position, which must be contiguous
+    QList<TrackId> playlistTrackIds() const {
+        QSqlQuery query(dbConnection());
+        query.prepare(QStringLiteral(
+                "SELECT track_id, position FROM PlaylistTracks "
+                "WHERE playlist_id=:id ORDER BY position"));
+        query.bindValue(":id", m_playlistId);
+        EXPECT_TRUE(query.exec());
+        QList<TrackId> trackIds;
+        while (query.next()) {
+            EXPECT_EQ(trackIds.size() + 1, query.value(1).toInt());
+            trackIds.append(TrackId(query.value(0)));
+        }
+        return trackIds;
+    }
+
+    PlaylistDAO& m_playlistDAO;
+    QList<TrackId> m_trackIds;
+    int m_playlistId;
+};
+
+TEST_F(PlaylistDAOTest, insertTracks) {
+    ASSERT_TRUE(m_playlistDAO.appendTracksToPlaylist(
+            {m_trackIds[0], m_trackIds[1]}, m_playlistId));
+
+    EXPECT_EQ(3,
+            m_playlistDAO.insertTracksIntoPlaylist(
+                    {m_trackIds[2], TrackId(), m_trackIds[3], m_trackIds[4]},
+                    m_playlistId,
+                    2));
+    EXPECT_EQ(QList<TrackId>({m_trackIds[0],
+                      m_trackIds[2],
+                      m_trackIds[3],
+                      m_trackIds[4],
+                      m_trackIds[1]}),
+            playlistTrackIds());
+
+    // Positions behind the end are appended
+    EXPECT_EQ(1, m_playlistDAO.insertTracksIntoPlaylist({m_trackIds[5]}, m_playlistId, 100));
+    EXPECT_EQ(m_trackIds[5], playlistTrackIds().last());
+}
+
+TEST_F(PlaylistDAOTest, removeTracks) {
+    ASSERT_TRUE(m_playlistDAO.appendTracksToPlaylist(m_trackIds, m_playlistId));
+
+    // Unordered with a position that does not exist
+    m_playlistDAO.removeTracksFromPlaylist(m_playlistId, {5, 2, 99, 3});
+    EXPECT_EQ(QList<TrackId>({m_trackIds[0], m_trackIds[3], m_trackIds[5]}),
+            playlistTrackIds());
+
+    m_playlistDAO.removeTrackFromPlaylist(m_playlistId, 1);
+    EXPECT_EQ(QList<TrackId>({m_trackIds[3], m_trackIds[5]}), playlistTrackIds());
+}
+
+TEST_F(PlaylistDAOTest, removeTrackById) {
+    ASSERT_TRUE(m_playlistDAO.appendTracksToPlaylist(
+            {m_trackIds[0], m_trackIds[1], m_trackIds[0], m_trackIds[2], m_trackIds[0]},
+            m_playlistId));
+
+    m_playlistDAO.removeTracksFromPlaylistById(m_playlistId, m_trackIds[0]);
+    EXPECT_EQ(QList<TrackId>({m_trackIds[1], m_trackIds[2]}), playlistTrackIds());
+    EXPECT_FALSE(m_playlistDAO.isTrackInPlaylist(m_trackIds[0], m_playlistId));
+}
+
+TEST_F(PlaylistDAOTest, moveTracks) {
+    ASSERT_TRUE(m_playlistDAO.appendTracksToPlaylist(m_trackIds, m_playlistId));
+
+    // Up, the order of the given positions does not matter
+    m_playlistDAO.moveTracks(m_playlistId, {5, 3}, 2);
+    EXPECT_EQ(QList<TrackId>({m_trackIds[0],
+                      m_trackIds[2],
+                      m_trackIds[4],
+                      m_trackIds[1],
+                      m_trackIds[3],
+                      m_trackIds[5]}),
+            playlistTrackIds());
+
+    // Down in front of the last track
+    m_playlistDAO.moveTracks(m_playlistId, {1, 2}, 6);
+    EXPECT_EQ(QList<TrackId>({m_trackIds[4],
+                      m_trackIds[1],
+                      m_trackIds[3],
+                      m_trackIds[0],
+                      m_trackIds[2],
+                      m_trackIds[5]}),
+            playlistTrackIds());
+
+    // To the end
+    m_playlistDAO.moveTracks(m_playlistId, {1}, std::numeric_limits<int>::max());
+    EXPECT_EQ(m_trackIds[4], playlistTrackIds().last());
+    EXPECT_EQ(m_trackIds[1], playlistTrackIds().first());
+}
@@ -19,7 +19,8 @@ const QString kGroup = "[test]";
 class StubReader : public CachingReader {
   public:
     StubReader()
-            : CachingReader(kGroup, UserSettingsPointer(), mixxx::audio::ChannelCount::stereo()) {
+            : CachingReader(kGroup, UserSettingsPointer(), mixxx::audio::ChannelCount::stereo()),
+              m_readCount(0) {
     }
 
     CachingReader::ReadResult read(SINT startSample,
@@ -31,8 +32,16 @@ class StubReader : public CachingReader {
         Q_UNUSED(reverse);
         Q_UNUSED(channelCount);
         SampleUtil::clear(buffer, numSamples);
+        ++m_readCount;
         return CachingReader::ReadResult::AVAILABLE;
     }
+
+    int readCount() const {
+        return m_readCount;
+    }
+
+  private:
+    int m_readCount;
 };
 
 class StubLoopControl : public LoopingControl {
@@ -156,3 +165,83 @@ TEST_F(ReadAheadManagerTest, FractionalFrameLoop) {
     // The rounding error must not exceed a half frame (one samples in stereo)
     EXPECT_NEAR(16, m_pReadAheadManager->getPlaypos(), 1);
 }
+
+TEST_F(ReadAheadManagerTest, ShortLoopIsPlayedFromLoopBuffer) {
+    constexpr int kCallbacks = 10;
+    m_pReadAheadManager->notifySeek(100);
+    for (int i = 0; i < kCallbacks + 2; ++i) {
+        m_pLoopControl->pushTriggerReturnValue(200);
+        m_pLoopControl->pushTargetReturnValue(100);
+    }
+    // Up to the loop end
+    EXPECT_EQ(60,
+            m_pReadAheadManager->getNextSamples(
+                    1.0, m_pBuffer, 60, mixxx::audio::ChannelCount::stereo()));
+    // Wraps around and copies the loop into the loop buffer
+    EXPECT_EQ(40,
+            m_pReadAheadManager->getNextSamples(
+                    1.0, m_pBuffer, 60, mixxx::audio::ChannelCount::stereo()));
+    const int readCount = m_pReader->readCount();
+    for (int i = 0; i < kCallbacks; ++i) {
+        m_pReadAheadManager->getNextSamples(
+                1.0, m_pBuffer, 60, mixxx::audio::ChannelCount::stereo());
+    }
+    EXPECT_EQ(readCount, m_pReader->readCount());
+
+    // Seeking invalidates the loop buffer
+    m_pReadAheadManager->notifySeek(100);
+    m_pLoopControl->pushTriggerReturnValue(200);
+    m_pLoopControl->pushTargetReturnValue(100);
+    m_pReadAheadManager->getNextSamples(
+            1.0, m_pBuffer, 60, mixxx::audio::ChannelCount::stereo());
+    EXPECT_EQ(readCount + 1, m_pReader->readCount());
+}
+
+TEST_F(ReadAheadManagerTest, PrefetchInDirectionOfTravel) {
+    constexpr SINT kSamplesPerCallback = 8192;
+    constexpr double kStartPosition = 1000000;
+
+    auto readCallbacks = [this](double rate, int callbacks, HintVector* pHints) {
+        for (int i = 0; i < callbacks; ++i) {
+            m_pLoopControl->pushTriggerReturnValue(kNoTrigger);
+            m_pLoopControl->pushTargetReturnValue(kNoTrigger);
+            m_pReadAheadManager->getNextSamples(rate,
+                    m_pBuffer,
+                    kSamplesPerCallback,
+                    mixxx::audio::ChannelCount::stereo());
+            pHints->clear();
+            m_pReadAheadManager->hintReader(
+                    rate, pHints, mixxx::audio::ChannelCount::stereo());
+        }
+    };
+    auto findPrefetch = [](const HintVector& hints) -> const Hint* {
+        for (const auto& hint : hints) {
+            if (hint.type == Hint::Type::Prefetch) {
+                return &hint;
+            }
+        }
+        return nullptr;
+    };
+
+    // Fast forward reads prefetch ahead of the current position
+    m_pReadAheadManager->notifySeek(kStartPosition);
+    HintVector hints;
+    readCallbacks(1.0, 8, &hints);
+    const Hint* pPrefetch = findPrefetch(hints);
+    ASSERT_NE(nullptr, pPrefetch);
+    const SINT frame = static_cast<SINT>(m_pReadAheadManager->getPlaypos() / 2);
+    EXPECT_EQ(frame, pPrefetch->frame);
+    EXPECT_GT(pPrefetch->frameCount, 2 * CachingReaderChunk::kFrames);
+
+    // The history is reset on seeks, a single callback is not enough
+    m_pReadAheadManager->notifySeek(kStartPosition);
+    readCallbacks(-1.0, 1, &hints);
+    EXPECT_EQ(nullptr, findPrefetch(hints));
+
+    // Fast reverse reads prefetch behind the current position
+    readCallbacks(-1.0, 8, &hints);
+    pPrefetch = findPrefetch(hints);
+    ASSERT_NE(nullptr, pPrefetch);
+    EXPECT_EQ(static_cast<SINT>(m_pReadAheadManager->getPlaypos() / 2),
+            pPrefetch->frame + pPrefetch->frameCount);
+}
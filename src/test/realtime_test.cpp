@@ -0,0 +1,33 @@
+#include "util/realtime.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using mixxx::realtime::formatCpuList;
+using mixxx::realtime::parseCpuList;
+
+TEST(RealtimeTest, parseCpuList) {
+    EXPECT_EQ(QList<int>(), parseCpuList(QString()));
+    EXPECT_EQ(QList<int>({2}), parseCpuList(QStringLiteral("2")));
+    EXPECT_EQ(QList<int>({2, 3}), parseCpuList(QStringLiteral("2,3")));
+    EXPECT_EQ(QList<int>({2, 3, 4, 6}), parseCpuList(QStringLiteral(" 2-4, 6 ")));
+    // Duplicates are dropped
+    EXPECT_EQ(QList<int>({1, 2, 3}), parseCpuList(QStringLiteral("1-3,2")));
+}
+
+TEST(RealtimeTest, parseInvalidCpuList) {
+    EXPECT_EQ(QList<int>(), parseCpuList(QStringLiteral("a")));
+    EXPECT_EQ(QList<int>(), parseCpuList(QStringLiteral("2,x")));
+    EXPECT_EQ(QList<int>(), parseCpuList(QStringLiteral("3-2")));
+    EXPECT_EQ(QList<int>(), parseCpuList(QStringLiteral("1-2-3")));
+    EXPECT_EQ(QList<int>(), parseCpuList(QStringLiteral("-1")));
+}
+
+TEST(RealtimeTest, formatCpuList) {
+    EXPECT_EQ(QString(), formatCpuList({}));
+    EXPECT_EQ(QStringLiteral("2,3,5"), formatCpuList({2, 3, 5}));
+    EXPECT_EQ(QList<int>({0, 7}), parseCpuList(formatCpuList({0, 7})));
+}
+
+} // namespace
@@ -0,0 +1,63 @@
+#include "util/realtimecheck.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using mixxx::realtime::Check;
+
+class RealtimeCheckTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        if (!Check::isEnabled()) {
+            GTEST_SKIP() << "Requires the REALTIME_CHECKS build option";
+        }
+    }
+
+    // Only violations outside of an engine thread are ignored, so the
+    // assertions are evaluated after the sections have been left
+    static void checkLock(const char* pContext) {
+        Check::check(Check::Violation::Lock, pContext);
+    }
+};
+
+TEST_F(RealtimeCheckTest, nestedSections) {
+    const int totalCount = Check::totalCount(Check::Violation::Lock);
+    checkLock("RealtimeCheckTest::outside");
+    {
+        const Check::ScopedSection outerSection;
+        {
+            const Check::ScopedSection innerSection;
+            checkLock("RealtimeCheckTest::inner");
+        }
+        // Still within the outer section
+        checkLock("RealtimeCheckTest::outer");
+    }
+    checkLock("RealtimeCheckTest::outside");
+
+    EXPECT_EQ(totalCount + 2, Check::totalCount(Check::Violation::Lock));
+    EXPECT_EQ(0, Check::recordedCount(Check::Violation::Lock, "RealtimeCheckTest::outside"));
+}
+
+TEST_F(RealtimeCheckTest, recordsDistinctViolationsOnce) {
+    if (Check::numFreeRecords() < 2) {
+        GTEST_SKIP() << "All records have been used by other tests";
+    }
+    const int numFreeRecords = Check::numFreeRecords();
+    {
+        const Check::ScopedSection section;
+        for (int i = 0; i < 3; ++i) {
+            checkLock("RealtimeCheckTest::same");
+        }
+        checkLock("RealtimeCheckTest::other");
+    }
+
+    EXPECT_EQ(numFreeRecords - 2, Check::numFreeRecords());
+    EXPECT_EQ(3, Check::recordedCount(Check::Violation::Lock, "RealtimeCheckTest::same"));
+    EXPECT_EQ(1, Check::recordedCount(Check::Violation::Lock, "RealtimeCheckTest::other"));
+    EXPECT_EQ(0,
+            Check::recordedCount(
+                    Check::Violation::Underflow, "RealtimeCheckTest::same"));
+}
+
+} // namespace
@@ -0,0 +1,162 @@
+#include "recording/recordingdiskwriter.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <algorithm>
+
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+QByteArray makeData(qint64 size) {
+    QByteArray data(static_cast<int>(size), Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i % 251);
+    }
+    return data;
+}
+
+QByteArray readFile(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return file.readAll();
+}
+
+} // namespace
+
+class RecordingDiskWriterTest : public testing::TestWithParam<bool> {
+  protected:
+    static int allocatedBlocks(RecordingDiskWriter* pDiskWriter) {
+        const auto locker = lockMutex(&pDiskWriter->m_mutex);
+        return pDiskWriter->m_allocatedBlocks;
+    }
+};
+
+TEST_P(RecordingDiskWriterTest, writesBlocksAndRewrittenHeader) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("track.wav"));
+
+    // Spans multiple blocks with a partial block at the end
+    QByteArray expected = makeData(2 * RecordingDiskWriter::kBlockSize + 1000);
+    {
+        RecordingDiskWriter diskWriter(GetParam());
+        diskWriter.start();
+        auto pFile = diskWriter.createFile(fileName);
+        ASSERT_NE(nullptr, pFile);
+        // Written in small pieces like an encoder
+        for (qint64 offset = 0; offset < expected.size(); offset += 4000) {
+            const qint64 size = std::min<qint64>(4000, expected.size() - offset);
+            pFile->write(expected.constData() + offset, size);
+        }
+        EXPECT_EQ(expected.size(), pFile->position());
+        EXPECT_EQ(expected.size(), pFile->size());
+
+        // Like the header of a WAV file that is written when closing
+        const QByteArray header("RIFF");
+        pFile->seek(0);
+        pFile->write(header.constData(), header.size());
+        expected.replace(0, header.size(), header);
+        EXPECT_EQ(header.size(), pFile->position());
+        EXPECT_EQ(expected.size(), pFile->size());
+
+        pFile->close();
+    }
+    EXPECT_EQ(expected, readFile(fileName));
+}
+
+TEST_P(RecordingDiskWriterTest, updatesHeaderWhileWriting) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("track.wav"));
+
+    QByteArray expected = makeData(3 * RecordingDiskWriter::kBlockSize);
+    {
+        RecordingDiskWriter diskWriter(GetParam());
+        diskWriter.start();
+        auto pFile = diskWriter.createFile(fileName);
+        ASSERT_NE(nullptr, pFile);
+        const QByteArray header("RIFF");
+        for (qint64 offset = 0; offset < expected.size(); offset += 300000) {
+            const qint64 size = std::min<qint64>(300000, expected.size() - offset);
+            pFile->write(expected.constData() + offset, size);
+
+            // Like the periodic header updates of EncoderWave
+            const qint64 position = pFile->position();
+            pFile->seek(0);
+            pFile->write(header.constData(), header.size());
+            pFile->seek(position);
+            EXPECT_EQ(position, pFile->position());
+            EXPECT_EQ(position, pFile->size());
+        }
+        expected.replace(0, header.size(), header);
+        pFile->close();
+    }
+    EXPECT_EQ(expected, readFile(fileName));
+}
+
+TEST_P(RecordingDiskWriterTest, writesMultipleFiles) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString fileName1 = tempDir.filePath(QStringLiteral("track1.flac"));
+    const QString fileName2 = tempDir.filePath(QStringLiteral("track2.flac"));
+
+    const QByteArray data = makeData(RecordingDiskWriter::kBlockSize + 1);
+    {
+        RecordingDiskWriter diskWriter(GetParam());
+        diskWriter.start();
+        auto pFile1 = diskWriter.createFile(fileName1);
+        auto pFile2 = diskWriter.createFile(fileName2);
+        ASSERT_NE(nullptr, pFile1);
+        ASSERT_NE(nullptr, pFile2);
+        pFile1->write(data.constData(), data.size());
+        pFile2->write(data.constData(), 10);
+        // Closed when destroyed
+    }
+    EXPECT_EQ(data, readFile(fileName1));
+    EXPECT_EQ(data.left(10), readFile(fileName2));
+}
+
+TEST_P(RecordingDiskWriterTest, failsToCreateFileInMissingDirectory) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    RecordingDiskWriter diskWriter(GetParam());
+    diskWriter.start();
+    EXPECT_EQ(nullptr,
+            diskWriter.createFile(tempDir.filePath(QStringLiteral("missing/track.wav"))));
+}
+
+TEST_P(RecordingDiskWriterTest, headerUpdatesAreNotCountedInTheBudget) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("track.wav"));
+
+    QByteArray expected = makeData(3 * RecordingDiskWriter::kBlockSize);
+    {
+        // Not started, like a stalled disk. The queued blocks are written
+        // when it is destroyed.
+        RecordingDiskWriter diskWriter(GetParam());
+        auto pFile = diskWriter.createFile(fileName);
+        ASSERT_NE(nullptr, pFile);
+        const QByteArray header("RIFF");
+        for (qint64 offset = 0; offset < expected.size(); offset += 100000) {
+            const qint64 size = std::min<qint64>(100000, expected.size() - offset);
+            pFile->write(expected.constData() + offset, size);
+            const qint64 position = pFile->position();
+            pFile->seek(0);
+            pFile->write(header.constData(), header.size());
+            pFile->seek(position);
+        }
+        // Only the blocks of the data
+        EXPECT_EQ(3, allocatedBlocks(&diskWriter));
+        expected.replace(0, header.size(), header);
+        pFile->close();
+    }
+    EXPECT_EQ(expected, readFile(fileName));
+}
+
+INSTANTIATE_TEST_SUITE_P(DirectIO, RecordingDiskWriterTest, testing::Bool());
@@ -0,0 +1,135 @@
+#include "engine/sidechain/rtppacketizer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+constexpr auto kStereo = mixxx::audio::ChannelCount::stereo();
+constexpr int kPayloadType = 98;
+constexpr quint32 kSsrc = 0x12345678;
+
+using Packet = std::vector<unsigned char>;
+
+class RtpPacketizerTest : public testing::Test {
+  protected:
+    void process(RtpPacketizer* pPacketizer, const std::vector<CSAMPLE>& samples) {
+        pPacketizer->process(samples.data(),
+                static_cast<SINT>(samples.size() / kStereo),
+                [this](const char* pData, int size) {
+                    m_packets.emplace_back(pData, pData + size);
+                });
+    }
+
+    std::vector<Packet> m_packets;
+};
+
+TEST_F(RtpPacketizerTest, writesHeader) {
+    RtpPacketizer packetizer(kPayloadType, kSsrc, kStereo, 2);
+    packetizer.restart(0xA1B2C3D4);
+    process(&packetizer, std::vector<CSAMPLE>(4, 0.0f));
+
+    ASSERT_EQ(1u, m_packets.size());
+    const Packet& packet = m_packets[0];
+    ASSERT_EQ(RtpPacketizer::kHeaderSize + 2 * 2 * RtpPacketizer::kBytesPerSample,
+            static_cast<int>(packet.size()));
+    EXPECT_EQ(0x80, packet[0]);
+    EXPECT_EQ(kPayloadType, packet[1]);
+    EXPECT_EQ(0x00, packet[2]);
+    EXPECT_EQ(0x00, packet[3]);
+    EXPECT_EQ(0xA1, packet[4]);
+    EXPECT_EQ(0xB2, packet[5]);
+    EXPECT_EQ(0xC3, packet[6]);
+    EXPECT_EQ(0xD4, packet[7]);
+    EXPECT_EQ(0x12, packet[8]);
+    EXPECT_EQ(0x34, packet[9]);
+    EXPECT_EQ(0x56, packet[10]);
+    EXPECT_EQ(0x78, packet[11]);
+}
+
+TEST_F(RtpPacketizerTest, encodesL24BigEndian) {
+    RtpPacketizer packetizer(kPayloadType, kSsrc, kStereo, 2);
+    // Out of range samples are clipped
+    process(&packetizer, {1.0f, -1.0f, 0.5f, 2.0f});
+
+    ASSERT_EQ(1u, m_packets.size());
+    const Packet& packet = m_packets[0];
+    const Packet expected = {
+            0x7F, 0xFF, 0xFF, // 1.0
+            0x80, 0x00, 0x01, // -1.0
+            0x40, 0x00, 0x00, // 0.5
+            0x7F, 0xFF, 0xFF, // 2.0
+    };
+    EXPECT_EQ(expected,
+            Packet(packet.begin() + RtpPacketizer::kHeaderSize, packet.end()));
+}
+
+TEST_F(RtpPacketizerTest, keepsPartialPacket) {
+    RtpPacketizer packetizer(kPayloadType, kSsrc, kStereo, 3);
+    packetizer.restart(1000);
+    process(&packetizer, std::vector<CSAMPLE>(4, 0.25f));
+    EXPECT_TRUE(m_packets.empty());
+    EXPECT_EQ(1000u, packetizer.timestamp());
+
+    // Completes the first packet, a second one and leaves one frame
+    process(&packetizer, std::vector<CSAMPLE>(10, 0.25f));
+    ASSERT_EQ(2u, m_packets.size());
+    EXPECT_EQ(1006u, packetizer.timestamp());
+    EXPECT_EQ(2, packetizer.sequenceNumber());
+
+    const Packet& second = m_packets[1];
+    EXPECT_EQ(0x00, second[2]);
+    EXPECT_EQ(0x01, second[3]);
+    // 1003 = 0x03EB
+    EXPECT_EQ(0x03, second[6]);
+    EXPECT_EQ(0xEB, second[7]);
+}
+
+TEST_F(RtpPacketizerTest, restartDropsPendingFrames) {
+    RtpPacketizer packetizer(kPayloadType, kSsrc, kStereo, 2);
+    process(&packetizer, std::vector<CSAMPLE>(2, 0.5f));
+    packetizer.restart(500);
+    process(&packetizer, std::vector<CSAMPLE>(4, 0.0f));
+
+    ASSERT_EQ(1u, m_packets.size());
+    const Packet& packet = m_packets[0];
+    // 500 = 0x01F4
+    EXPECT_EQ(0x01, packet[6]);
+    EXPECT_EQ(0xF4, packet[7]);
+    for (auto it = packet.begin() + RtpPacketizer::kHeaderSize; it != packet.end(); ++it) {
+        EXPECT_EQ(0x00, *it);
+    }
+}
+
+TEST_F(RtpPacketizerTest, shiftTimestampKeepsPendingFrames) {
+    RtpPacketizer packetizer(kPayloadType, kSsrc, kStereo, 2);
+    packetizer.restart(1000);
+    process(&packetizer, std::vector<CSAMPLE>(2, 0.5f));
+    EXPECT_EQ(1, packetizer.pendingFrames());
+
+    packetizer.shiftTimestamp(-10);
+    EXPECT_EQ(990u, packetizer.timestamp());
+    process(&packetizer, std::vector<CSAMPLE>(2, 0.5f));
+
+    ASSERT_EQ(1u, m_packets.size());
+    const Packet& packet = m_packets[0];
+    // 990 = 0x03DE
+    EXPECT_EQ(0x03, packet[6]);
+    EXPECT_EQ(0xDE, packet[7]);
+    // Both frames have been kept
+    for (auto it = packet.begin() + RtpPacketizer::kHeaderSize; it != packet.end();
+            it += RtpPacketizer::kBytesPerSample) {
+        EXPECT_EQ(0x40, *it);
+    }
+    EXPECT_EQ(992u, packetizer.timestamp());
+}
+
+TEST_F(RtpPacketizerTest, wrapsAround) {
+    RtpPacketizer packetizer(kPayloadType, kSsrc, kStereo, 4);
+    packetizer.restart(0xFFFFFFFE);
+    process(&packetizer, std::vector<CSAMPLE>(8, 0.0f));
+    EXPECT_EQ(2u, packetizer.timestamp());
+}
+
+} // namespace
@@ -123,6 +123,30 @@ TEST_F(SampleUtilTest, addWithGain) {
 }
 
 
+TEST_F(SampleUtilTest, applyRampingGainAndAddWithRampingGain) {
+    for (int i : evenBuffers) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        FillBuffer(buffer, 1.0f, size);
+        CSAMPLE* buffer2 = SampleUtil::alloc(size);
+        FillBuffer(buffer2, 1.0f, size);
+        SampleUtil::applyRampingGainAndAddWithRampingGain(
+                buffer, 0.5f, 0.5f, buffer2, 2.0f, 2.0f, size);
+        AssertWholeBufferEquals(buffer, 2.5f, size);
+
+        // Same result as the separate passes
+        std::vector<CSAMPLE> expected(buffer, buffer + size);
+        SampleUtil::applyRampingGain(expected.data(), 0.2f, 0.8f, size);
+        SampleUtil::addWithRampingGain(expected.data(), buffer2, 0.4f, 0.1f, size);
+        SampleUtil::applyRampingGainAndAddWithRampingGain(
+                buffer, 0.2f, 0.8f, buffer2, 0.4f, 0.1f, size);
+        for (int s = 0; s < size; ++s) {
+            EXPECT_FLOAT_EQ(expected[s], buffer[s]);
+        }
+        SampleUtil::free(buffer2);
+    }
+}
+
 TEST_F(SampleUtilTest, add2WithGain) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -303,6 +327,20 @@ TEST_F(SampleUtilTest, sumAbsPerChannel) {
     }
 }
 
+TEST_F(SampleUtilTest, maxAbsAmplitude) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        EXPECT_FLOAT_EQ(0.0f, SampleUtil::maxAbsAmplitude(buffer, size));
+        // The first sample must not be treated differently
+        buffer[0] = -0.5f;
+        buffer[size - 1] = 0.25f;
+        EXPECT_FLOAT_EQ(0.5f, SampleUtil::maxAbsAmplitude(buffer, size));
+        buffer[size - 1] = -0.75f;
+        EXPECT_FLOAT_EQ(0.75f, SampleUtil::maxAbsAmplitude(buffer, size));
+    }
+}
+
 TEST_F(SampleUtilTest, interleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -397,6 +435,23 @@ TEST_F(SampleUtilTest, copyReverseStereo) {
     EXPECT_FLOAT_EQ(destination[9], 0.1f);
 }
 
+TEST_F(SampleUtilTest, copyReverseOtherChannelCount) {
+    EXPECT_TRUE(buffers.size() > 1 && sizes[0] > 12 && sizes[1] > 12);
+    CSAMPLE* source = buffers[0];
+    CSAMPLE* destination = buffers[1];
+    for (int i = 0; i < 12; ++i) {
+        source[i] = i * 0.1f;
+    }
+
+    // Not specialized at compile time
+    SampleUtil::copyReverse(destination, source, 12, 6);
+
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_FLOAT_EQ(destination[i], (6 + i) * 0.1f);
+        EXPECT_FLOAT_EQ(destination[6 + i], i * 0.1f);
+    }
+}
+
 TEST_F(SampleUtilTest, copyReverseStem) {
     EXPECT_TRUE(buffers.size() > 1 && sizes[0] > 16 && sizes[1] > 16);
     CSAMPLE* source = buffers[0];
@@ -466,6 +521,158 @@ TEST_F(SampleUtilTest, mixMultichannelToStereo) {
     EXPECT_FLOAT_EQ(destination[3], 0.9f + 1.1f + 1.3f /* + 1.5f*/);
 }
 
+TEST_F(SampleUtilTest, insertClampStereoToMulti) {
+    EXPECT_TRUE(buffers.size() > 1 && sizes[0] > 16 && sizes[1] > 16);
+    CSAMPLE* source = buffers[0];
+    CSAMPLE* destination = buffers[1];
+    FillBuffer(destination, 0.5f, 16);
+    source[0] = 0.1f;
+    source[1] = -0.2f;
+    source[2] = 2.0f;
+    source[3] = -2.0f;
+
+    SampleUtil::insertClampStereoToMulti(
+            destination, source, 2, mixxx::audio::ChannelCount(4), 2);
+
+    EXPECT_FLOAT_EQ(destination[0], 0.5f);
+    EXPECT_FLOAT_EQ(destination[1], 0.5f);
+    EXPECT_FLOAT_EQ(destination[2], 0.1f);
+    EXPECT_FLOAT_EQ(destination[3], -0.2f);
+    EXPECT_FLOAT_EQ(destination[4], 0.5f);
+    EXPECT_FLOAT_EQ(destination[5], 0.5f);
+    EXPECT_FLOAT_EQ(destination[6], CSAMPLE_PEAK);
+    EXPECT_FLOAT_EQ(destination[7], -CSAMPLE_PEAK);
+
+    SampleUtil::insertClampStereoToMonoInMulti(
+            destination, source, 2, mixxx::audio::ChannelCount(4), 1);
+
+    EXPECT_FLOAT_EQ(destination[0], 0.5f);
+    EXPECT_FLOAT_EQ(destination[1], -0.05f);
+    EXPECT_FLOAT_EQ(destination[2], 0.1f);
+    EXPECT_FLOAT_EQ(destination[5], 0.0f);
+    EXPECT_FLOAT_EQ(destination[6], CSAMPLE_PEAK);
+}
+
+TEST_F(SampleUtilTest, copyFromMultiToStereo) {
+    EXPECT_TRUE(buffers.size() > 1 && sizes[0] > 16 && sizes[1] > 16);
+    CSAMPLE* source = buffers[0];
+    CSAMPLE* destination = buffers[1];
+    for (int i = 0; i < 8; ++i) {
+        source[i] = 0.1f * i;
+    }
+
+    SampleUtil::copyOneStereoFromMulti(
+            destination, source, 2, mixxx::audio::ChannelCount(4), 2);
+
+    EXPECT_FLOAT_EQ(destination[0], 0.2f);
+    EXPECT_FLOAT_EQ(destination[1], 0.3f);
+    EXPECT_FLOAT_EQ(destination[2], 0.6f);
+    EXPECT_FLOAT_EQ(destination[3], 0.7f);
+
+    SampleUtil::copyOneStereoFromMulti(
+            destination, source, 2, mixxx::audio::ChannelCount::stereo());
+
+    EXPECT_FLOAT_EQ(destination[0], 0.0f);
+    EXPECT_FLOAT_EQ(destination[1], 0.1f);
+    EXPECT_FLOAT_EQ(destination[2], 0.2f);
+    EXPECT_FLOAT_EQ(destination[3], 0.3f);
+
+    SampleUtil::copyMonoInMultiToDualMono(
+            destination, source, 2, mixxx::audio::ChannelCount(4), 3);
+
+    EXPECT_FLOAT_EQ(destination[0], 0.3f);
+    EXPECT_FLOAT_EQ(destination[1], 0.3f);
+    EXPECT_FLOAT_EQ(destination[2], 0.7f);
+    EXPECT_FLOAT_EQ(destination[3], 0.7f);
+
+    SampleUtil::copyMonoInMultiToDualMono(
+            destination, source, 2, mixxx::audio::ChannelCount::mono(), 0);
+
+    EXPECT_FLOAT_EQ(destination[0], 0.0f);
+    EXPECT_FLOAT_EQ(destination[1], 0.0f);
+    EXPECT_FLOAT_EQ(destination[2], 0.1f);
+    EXPECT_FLOAT_EQ(destination[3], 0.1f);
+}
+
+TEST_F(SampleUtilTest, simdKernelsMatchGeneric) {
+    using SimdInstructionSet = SampleUtil::SimdInstructionSet;
+    const SimdInstructionSet detected = SampleUtil::simdInstructionSet();
+
+    // Calculates the results of all dispatched functions for a buffer size
+    const auto calculate = [](SimdInstructionSet instructionSet, int size) {
+        EXPECT_TRUE(SampleUtil::setSimdInstructionSet(instructionSet));
+        std::vector<CSAMPLE> source1(size);
+        std::vector<CSAMPLE> source2(size);
+        std::vector<CSAMPLE> source3(size);
+        std::vector<SAMPLE> source16(size);
+        for (int i = 0; i < size; ++i) {
+            source1[i] = static_cast<CSAMPLE>(i % 7) / 7 - 0.5f;
+            source2[i] = static_cast<CSAMPLE>(i % 11) / 11;
+            source3[i] = static_cast<CSAMPLE>(i % 13) / -13;
+            source16[i] = static_cast<SAMPLE>(i * 1009);
+        }
+        std::vector<CSAMPLE> results;
+        std::vector<CSAMPLE> buffer(source1);
+        SampleUtil::applyRampingGain(buffer.data(), 0.2f, 0.9f, size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        buffer = source1;
+        SampleUtil::applyRampingAlternatingGain(
+                buffer.data(), 0.9f, 0.1f, 0.3f, 0.7f, size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        buffer = source1;
+        SampleUtil::addWithGain(buffer.data(), source2.data(), 0.6f, size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        buffer = source1;
+        SampleUtil::addWithRampingGain(buffer.data(), source2.data(), 0.1f, 0.8f, size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        buffer = source1;
+        SampleUtil::add2WithGain(
+                buffer.data(), source2.data(), 0.3f, source3.data(), 0.4f, size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        buffer = source1;
+        SampleUtil::add3WithGain(buffer.data(),
+                source1.data(),
+                0.3f,
+                source2.data(),
+                0.4f,
+                source3.data(),
+                0.5f,
+                size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        SampleUtil::copyWithRampingGain(buffer.data(), source3.data(), 1.0f, 0.5f, size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        SampleUtil::convertS16ToFloat32(buffer.data(), source16.data(), size);
+        results.insert(results.end(), buffer.begin(), buffer.end());
+        // The sums are in a different order, compare the mean of the products
+        results.push_back(SampleUtil::dotProduct(source1.data(), source2.data(), size) /
+                std::max(size, 1));
+        return results;
+    };
+
+    for (const auto instructionSet : {
+                 SimdInstructionSet::Neon,
+                 SimdInstructionSet::Avx2,
+                 SimdInstructionSet::Avx512,
+         }) {
+        if (!SampleUtil::isSimdInstructionSetSupported(instructionSet)) {
+            continue;
+        }
+        for (int size : sizes) {
+            const auto expected = calculate(SimdInstructionSet::Generic, size);
+            const auto actual = calculate(instructionSet, size);
+            ASSERT_EQ(expected.size(), actual.size());
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                // The compiler might contract the generic loops differently
+                EXPECT_NEAR(expected[i], actual[i], 1e-6f)
+                        << "instruction set " << static_cast<int>(instructionSet)
+                        << ", size " << size << ", index " << i;
+            }
+        }
+    }
+
+    EXPECT_TRUE(SampleUtil::setSimdInstructionSet(detected));
+}
+
 static void BM_MemCpy(benchmark::State& state) {
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -652,4 +859,96 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+// The second argument selects the SampleUtil::SimdInstructionSet, so the
+// explicitly vectorized kernels can be compared with the generic ones.
+static void SimdInstructionSetArguments(benchmark::internal::Benchmark* pBenchmark) {
+    for (const auto instructionSet : {
+                 SampleUtil::SimdInstructionSet::Generic,
+                 SampleUtil::SimdInstructionSet::Neon,
+                 SampleUtil::SimdInstructionSet::Avx2,
+                 SampleUtil::SimdInstructionSet::Avx512,
+         }) {
+        if (!SampleUtil::isSimdInstructionSetSupported(instructionSet)) {
+            continue;
+        }
+        for (int size : {64, 512, 4096}) {
+            pBenchmark->Args({size, static_cast<int>(instructionSet)});
+        }
+    }
+}
+
+template<typename Function>
+static void runWithSimdInstructionSet(benchmark::State& state, Function function) {
+    const auto detected = SampleUtil::simdInstructionSet();
+    SampleUtil::setSimdInstructionSet(
+            static_cast<SampleUtil::SimdInstructionSet>(state.range(1)));
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.1f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.2f, size);
+    CSAMPLE* buffer4 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer4, 0.3f, size);
+
+    while (state.KeepRunning()) {
+        function(buffer, buffer2, buffer3, buffer4, size);
+        benchmark::DoNotOptimize(buffer);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+    SampleUtil::free(buffer4);
+    SampleUtil::setSimdInstructionSet(detected);
+}
+
+static void BM_AddWithRampingGain(benchmark::State& state) {
+    runWithSimdInstructionSet(state,
+            [](CSAMPLE* pDest, const CSAMPLE* pSrc, const CSAMPLE*, const CSAMPLE*, SINT size) {
+                SampleUtil::addWithRampingGain(pDest, pSrc, 0.5f, 0.6f, size);
+            });
+}
+BENCHMARK(BM_AddWithRampingGain)->Apply(SimdInstructionSetArguments);
+
+static void BM_CopyWithRampingGain(benchmark::State& state) {
+    runWithSimdInstructionSet(state,
+            [](CSAMPLE* pDest, const CSAMPLE* pSrc, const CSAMPLE*, const CSAMPLE*, SINT size) {
+                SampleUtil::copyWithRampingGain(pDest, pSrc, 0.5f, 0.6f, size);
+            });
+}
+BENCHMARK(BM_CopyWithRampingGain)->Apply(SimdInstructionSetArguments);
+
+static void BM_ApplyRampingAlternatingGain(benchmark::State& state) {
+    runWithSimdInstructionSet(state,
+            [](CSAMPLE* pBuffer, const CSAMPLE*, const CSAMPLE*, const CSAMPLE*, SINT size) {
+                SampleUtil::applyRampingAlternatingGain(
+                        pBuffer, 1.0f, 0.9f, 0.9f, 1.0f, size);
+            });
+}
+BENCHMARK(BM_ApplyRampingAlternatingGain)->Apply(SimdInstructionSetArguments);
+
+static void BM_Add3WithGain(benchmark::State& state) {
+    runWithSimdInstructionSet(state,
+            [](CSAMPLE* pDest,
+                    const CSAMPLE* pSrc1,
+                    const CSAMPLE* pSrc2,
+                    const CSAMPLE* pSrc3,
+                    SINT size) {
+                SampleUtil::add3WithGain(
+                        pDest, pSrc1, 0.3f, pSrc2, 0.4f, pSrc3, 0.5f, size);
+            });
+}
+BENCHMARK(BM_Add3WithGain)->Apply(SimdInstructionSetArguments);
+
+static void BM_ConvertS16ToFloat32(benchmark::State& state) {
+    std::vector<SAMPLE> source(static_cast<std::size_t>(state.range(0)), 1234);
+    runWithSimdInstructionSet(state,
+            [&source](CSAMPLE* pDest, const CSAMPLE*, const CSAMPLE*, const CSAMPLE*, SINT size) {
+                SampleUtil::convertS16ToFloat32(pDest, source.data(), size);
+            });
+}
+BENCHMARK(BM_ConvertS16ToFloat32)->Apply(SimdInstructionSetArguments);
+
 }  // namespace
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <QStringList>
+#include <QTemporaryDir>
+#include <memory>
+
+#include "database/mixxxdb.h"
+#include "library/searchquery.h"
+#include "library/searchqueryparser.h"
+#include "library/trackcollectionmanager.h"
+#include "preferences/usersettings.h"
+#include "track/track.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+
+// Measures the parsing of the search queries that are entered in the library
+// search box. The queries are parsed on every keystroke and whenever the
+// filter of a track table model is refreshed. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_SearchQueryParser
+
+namespace {
+
+const QStringList& queryCorpus() {
+    static const QStringList s_queries = {
+            QStringLiteral("daft punk"),
+            QStringLiteral("artist:\"daft punk\" -album:live"),
+            QStringLiteral("bpm:120-128 key:8A genre:house"),
+            QStringLiteral("~bpm:126 ~key:Am -crate:played"),
+            QStringLiteral("title:=\"Around The World\" year:1997"),
+            QStringLiteral("played:>10 rating:>=4 duration:<6:00"),
+            QStringLiteral("genre:techno | genre:house OR genre:\"deep house\""),
+            QStringLiteral("added:2024 type:flac bitrate:>=1000 -comment:\"\""),
+            QStringLiteral("\"the chemical brothers\" OR \"fatboy slim\" breaks"),
+            QStringLiteral("crate:warmup composer:\"\" album_artist:various"),
+    };
+    return s_queries;
+}
+
+// Like the search box while the longest query of the corpus is typed
+QStringList typedQueries() {
+    const QString query = QStringLiteral(
+            "artist:\"daft punk\" bpm:120-128 -album:live genre:house");
+    QStringList queries;
+    for (int length = 1; length <= query.size(); ++length) {
+        queries.append(query.left(length));
+    }
+    return queries;
+}
+
+void BM_SearchQueryParser_SplitQueryIntoWords(benchmark::State& state) {
+    const QStringList& queries = queryCorpus();
+    for (auto _ : state) {
+        for (const auto& query : queries) {
+            benchmark::DoNotOptimize(SearchQueryParser::splitQueryIntoWords(query));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+// The tokenizer doesn't share any state between threads
+BENCHMARK(BM_SearchQueryParser_SplitQueryIntoWords)->ThreadRange(1, 4);
+
+void BM_SearchQueryParser_QueryIsMoreSpecific(benchmark::State& state) {
+    const QStringList queries = typedQueries();
+    for (auto _ : state) {
+        for (int i = 1; i < queries.size(); ++i) {
+            benchmark::DoNotOptimize(SearchQueryParser::queryIsMoreSpecific(
+                    queries[i - 1], queries[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (queries.size() - 1));
+}
+BENCHMARK(BM_SearchQueryParser_QueryIsMoreSpecific)->ThreadRange(1, 4);
+
+/// The internal track collection with an empty in-memory database, set up
+/// like by LibraryTest
+class ParserBench {
+  public:
+    ParserBench()
+            : m_pConfig(new UserSettings(
+                      m_settingsDir.filePath(QStringLiteral("mixxx.cfg")))),
+              m_mixxxDb(m_pConfig, true),
+              m_dbConnectionPooler(m_mixxxDb.connectionPool()) {
+        const auto dbConnection = mixxx::DbConnectionPooled(m_mixxxDb.connectionPool());
+        if (MixxxDb::initDatabaseSchema(dbConnection)) {
+            m_pTrackCollectionManager = std::make_unique<TrackCollectionManager>(
+                    nullptr,
+                    m_pConfig,
+                    m_mixxxDb.connectionPool(),
+                    [](Track* pTrack) { delete pTrack; });
+        }
+    }
+
+    TrackCollection* internalCollection() const {
+        return m_pTrackCollectionManager
+                ? m_pTrackCollectionManager->internalCollection()
+                : nullptr;
+    }
+
+  private:
+    const QTemporaryDir m_settingsDir;
+    const UserSettingsPointer m_pConfig;
+    const MixxxDb m_mixxxDb;
+    const mixxx::DbConnectionPooler m_dbConnectionPooler;
+    std::unique_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+};
+
+void BM_SearchQueryParser_ParseQuery(benchmark::State& state) {
+    const ParserBench bench;
+    TrackCollection* pTrackCollection = bench.internalCollection();
+    if (!pTrackCollection) {
+        state.SkipWithError("Failed to initialize the database");
+        return;
+    }
+    const SearchQueryParser parser(pTrackCollection,
+            {QStringLiteral("artist"),
+                    QStringLiteral("album"),
+                    QStringLiteral("title"),
+                    QStringLiteral("crate")});
+    const QStringList& queries = queryCorpus();
+    for (auto _ : state) {
+        for (const auto& query : queries) {
+            benchmark::DoNotOptimize(parser.parseQuery(query, QString()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_SearchQueryParser_ParseQuery);
+
+} // namespace
@@ -1086,6 +1086,21 @@ TEST_F(SearchQueryParserTest, CrateFilterWithCrateFilterAndNegation){
                  qPrintable(pQueryB->toSql()));
 }
 
+TEST_F(SearchQueryParserTest, UnknownOrFuzzyFilterIsSearchTerm) {
+    m_parser.setSearchColumns({"artist"});
+
+    // Only the special filters can be fuzzy
+    auto pQuery = m_parser.parseQuery("~artist:asdf", QString());
+    EXPECT_STREQ(
+            qPrintable(QString("artist LIKE '%~artist:asdf%'")),
+            qPrintable(pQuery->toSql()));
+
+    pQuery = m_parser.parseQuery("artistx:asdf", QString());
+    EXPECT_STREQ(
+            qPrintable(QString("artist LIKE '%artistx:asdf%'")),
+            qPrintable(pQuery->toSql()));
+}
+
 TEST_F(SearchQueryParserTest, SplitQueryIntoWords) {
     QStringList rv = SearchQueryParser::splitQueryIntoWords(QString("a test b"));
     QStringList ex = QStringList() << "a"
@@ -1188,6 +1203,55 @@ TEST_F(SearchQueryParserTest, QueryIsLessSpecific) {
             QStringLiteral("crate:\"a b c\"")));
 }
 
+TEST_F(SearchQueryParserTest, QueryIsMoreSpecific) {
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QLatin1String(""),
+            QStringLiteral("a")));
+
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("searchm"),
+            QStringLiteral("searchme")));
+
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("A C"),
+            QStringLiteral("A B C")));
+
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("Abb bpm:>120"),
+            QStringLiteral("bpm:>120 Abba -crate:old")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("A B C"),
+            QStringLiteral("A D C")));
+
+    // Extending a negated term excludes fewer tracks
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("-Abb"),
+            QStringLiteral("-Abba")));
+
+    // Extending the argument of a filter changes its meaning
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("bpm:12"),
+            QStringLiteral("bpm:120")));
+
+    // The term becomes the argument of the preceding filter
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("bpm: 12"),
+            QStringLiteral("bpm: 120")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("Abb"),
+            QStringLiteral("=Abba")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("Abb"),
+            QStringLiteral("Abba | Beatles")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("\"Abba"),
+            QStringLiteral("\"Abba\"")));
+}
+
 TEST_F(SearchQueryParserTest, EmptyOrOperator) {
     auto pQuery = m_parser.parseQuery("|", QString());
 
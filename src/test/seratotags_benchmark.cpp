@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QFile>
+#include <QList>
+
+#include "test/mixxxtest.h"
+#include "track/serato/tags.h"
+
+// Measures the parsing of the Serato tags that are imported with the track
+// metadata, using the tag data of the Serato tests. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_SeratoTags
+
+namespace {
+
+enum class TagType {
+    BeatGrid,
+    Markers,
+    Markers2,
+};
+
+struct TagData {
+    TagType tagType;
+    mixxx::taglib::FileType fileType;
+    QByteArray data;
+};
+
+void appendTagDataInDirectory(QList<TagData>* pTagData,
+        const QString& path,
+        TagType tagType,
+        mixxx::taglib::FileType fileType) {
+    QDir dir(MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("serato/data/") + path));
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters({QStringLiteral("*.octet-stream")});
+    const QFileInfoList fileList = dir.entryInfoList();
+    for (const QFileInfo& fileInfo : fileList) {
+        QFile file(fileInfo.filePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            pTagData->append(TagData{tagType, fileType, file.readAll()});
+        }
+    }
+}
+
+QList<TagData> loadTagData() {
+    QList<TagData> tagData;
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("mp3/beatgrid"),
+            TagType::BeatGrid,
+            mixxx::taglib::FileType::MPEG);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("mp3/markers_"),
+            TagType::Markers,
+            mixxx::taglib::FileType::MPEG);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("mp3/markers2"),
+            TagType::Markers2,
+            mixxx::taglib::FileType::MPEG);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("mp4/beatgrid"),
+            TagType::BeatGrid,
+            mixxx::taglib::FileType::MP4);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("mp4/markers_"),
+            TagType::Markers,
+            mixxx::taglib::FileType::MP4);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("mp4/markers2"),
+            TagType::Markers2,
+            mixxx::taglib::FileType::MP4);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("flac/beatgrid"),
+            TagType::BeatGrid,
+            mixxx::taglib::FileType::FLAC);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("flac/markers2"),
+            TagType::Markers2,
+            mixxx::taglib::FileType::FLAC);
+    appendTagDataInDirectory(&tagData,
+            QStringLiteral("ogg/markers2"),
+            TagType::Markers2,
+            mixxx::taglib::FileType::OggVorbis);
+    return tagData;
+}
+
+bool parseTagData(mixxx::SeratoTags* pSeratoTags, const TagData& tagData) {
+    switch (tagData.tagType) {
+    case TagType::BeatGrid:
+        return pSeratoTags->parseBeatGrid(tagData.data, tagData.fileType);
+    case TagType::Markers:
+        return pSeratoTags->parseMarkers(tagData.data, tagData.fileType);
+    case TagType::Markers2:
+        return pSeratoTags->parseMarkers2(tagData.data, tagData.fileType);
+    }
+    return false;
+}
+
+void BM_SeratoTags_Parse(benchmark::State& state) {
+    const QList<TagData> tagData = loadTagData();
+    if (tagData.isEmpty()) {
+        state.SkipWithError("No Serato test data found");
+        return;
+    }
+    qint64 bytes = 0;
+    for (const auto& data : tagData) {
+        bytes += data.data.size();
+    }
+    for (auto _ : state) {
+        for (const auto& data : tagData) {
+            mixxx::SeratoTags seratoTags;
+            benchmark::DoNotOptimize(parseTagData(&seratoTags, data));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * tagData.size());
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_SeratoTags_Parse);
+
+} // namespace
@@ -0,0 +1,115 @@
+#include "engine/sidechain/sidechainringbuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+std::vector<CSAMPLE> makeSamples(CSAMPLE first, SINT count) {
+    std::vector<CSAMPLE> samples(count);
+    for (SINT i = 0; i < count; ++i) {
+        samples[i] = first + i;
+    }
+    return samples;
+}
+
+TEST(SideChainRingBufferTest, capacityIsRoundedUpToPowerOfTwo) {
+    SideChainRingBuffer ringBuffer(100);
+    EXPECT_EQ(128, ringBuffer.capacity());
+}
+
+TEST(SideChainRingBufferTest, readerStartsAtWritePosition) {
+    SideChainRingBuffer ringBuffer(16);
+    const auto samples = makeSamples(0, 4);
+    ringBuffer.write(samples.data(), 4);
+
+    SideChainRingBuffer::Reader reader(&ringBuffer);
+    EXPECT_EQ(4u, reader.position());
+    EXPECT_EQ(0u, reader.readAvailable());
+}
+
+TEST(SideChainRingBufferTest, readersAreIndependent) {
+    SideChainRingBuffer ringBuffer(16);
+    SideChainRingBuffer::Reader fastReader(&ringBuffer);
+    SideChainRingBuffer::Reader slowReader(&ringBuffer);
+
+    const auto samples = makeSamples(0, 12);
+    ringBuffer.write(samples.data(), 12);
+
+    std::vector<CSAMPLE> output(16);
+    ASSERT_EQ(12, fastReader.read(output.data(), 16));
+    for (SINT i = 0; i < 12; ++i) {
+        EXPECT_EQ(samples[i], output[i]);
+    }
+    EXPECT_EQ(0u, fastReader.readAvailable());
+    EXPECT_EQ(12u, slowReader.readAvailable());
+
+    ASSERT_EQ(5, slowReader.read(output.data(), 5));
+    EXPECT_EQ(0, output[0]);
+    EXPECT_EQ(4, output[4]);
+    EXPECT_EQ(5u, slowReader.position());
+}
+
+TEST(SideChainRingBufferTest, wrapAround) {
+    SideChainRingBuffer ringBuffer(8);
+    SideChainRingBuffer::Reader reader(&ringBuffer);
+    std::vector<CSAMPLE> output(8);
+
+    const auto first = makeSamples(0, 6);
+    ringBuffer.write(first.data(), 6);
+    ASSERT_EQ(6, reader.read(output.data(), 8));
+
+    const auto second = makeSamples(6, 6);
+    ringBuffer.write(second.data(), 6);
+    ASSERT_EQ(6, reader.read(output.data(), 8));
+    for (SINT i = 0; i < 6; ++i) {
+        EXPECT_EQ(6 + i, output[i]);
+    }
+    EXPECT_EQ(0u, reader.droppedSamples());
+}
+
+TEST(SideChainRingBufferTest, overrunSkipsOldestSamples) {
+    SideChainRingBuffer ringBuffer(8);
+    SideChainRingBuffer::Reader slowReader(&ringBuffer);
+    SideChainRingBuffer::Reader fastReader(&ringBuffer);
+    std::vector<CSAMPLE> output(8);
+
+    const auto samples = makeSamples(0, 12);
+    ringBuffer.write(samples.data(), 6);
+    ASSERT_EQ(6, fastReader.read(output.data(), 8));
+    ringBuffer.write(samples.data() + 6, 6);
+
+    std::uint64_t dropped = 0;
+    ASSERT_EQ(6, fastReader.read(output.data(), 8, &dropped));
+    EXPECT_EQ(0u, dropped);
+
+    // The slow reader has lost the first 4 samples
+    ASSERT_EQ(8, slowReader.read(output.data(), 8, &dropped));
+    EXPECT_EQ(4u, dropped);
+    EXPECT_EQ(4u, slowReader.droppedSamples());
+    for (SINT i = 0; i < 8; ++i) {
+        EXPECT_EQ(4 + i, output[i]);
+    }
+    EXPECT_EQ(12u, slowReader.position());
+    EXPECT_EQ(0u, fastReader.droppedSamples());
+}
+
+TEST(SideChainRingBufferTest, writeMoreThanCapacity) {
+    SideChainRingBuffer ringBuffer(8);
+    SideChainRingBuffer::Reader reader(&ringBuffer);
+    std::vector<CSAMPLE> output(8);
+
+    const auto samples = makeSamples(0, 20);
+    ringBuffer.write(samples.data(), 20);
+    EXPECT_EQ(20u, ringBuffer.writePosition());
+
+    std::uint64_t dropped = 0;
+    ASSERT_EQ(8, reader.read(output.data(), 8, &dropped));
+    EXPECT_EQ(12u, dropped);
+    for (SINT i = 0; i < 8; ++i) {
+        EXPECT_EQ(12 + i, output[i]);
+    }
+}
+
+} // namespace
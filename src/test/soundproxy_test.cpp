@@ -3,6 +3,7 @@
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
+#include "library/coverartutils.h"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
@@ -199,6 +200,33 @@ TEST_F(SoundSourceProxyTest, open) {
     }
 }
 
+TEST_F(SoundSourceProxyTest, probeStreamInfo) {
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        const auto fileUrl = QUrl::fromLocalFile(filePath);
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(fileUrl);
+        for (const auto& providerRegistration : providerRegistrations) {
+            const auto& pProvider = providerRegistration.getProvider();
+            const auto probedStreamInfo = pProvider->probeStreamInfo(fileUrl);
+            if (!probedStreamInfo) {
+                // Not supported by the provider or the file
+                continue;
+            }
+            // The probed properties must match the opened stream exactly
+            const auto pSoundSource = pProvider->newSoundSource(fileUrl);
+            ASSERT_TRUE(pSoundSource);
+            ASSERT_EQ(mixxx::SoundSource::OpenResult::Succeeded,
+                    pSoundSource->open(mixxx::SoundSource::OpenMode::Strict,
+                            mixxx::AudioSource::OpenParams()));
+            EXPECT_EQ(pSoundSource->getStreamInfo(), *probedStreamInfo)
+                    << filePath.toStdString() << " "
+                    << pProvider->getDisplayName().toStdString();
+            pSoundSource->close();
+        }
+    }
+}
+
 TEST_F(SoundSourceProxyTest, openEmptyFile) {
     const QStringList fileNameSuffixes = getFileNameSuffixes();
 
@@ -309,6 +337,37 @@ TEST_F(SoundSourceProxyTest, TOAL_TPE2) {
     EXPECT_TRUE(trackMetadata.getTrackInfo().getComment().isNull());
 }
 
+TEST_F(SoundSourceProxyTest, updateTrackFromImportedMetadata) {
+    const QString filePath =
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-png.mp3"));
+
+    auto pExpectedTrack = Track::newTemporary(filePath);
+    ASSERT_EQ(
+            SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pExpectedTrack)
+                    .updateTrackFromSource(
+                            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                            SyncTrackMetadataParams{}));
+
+    CoverInfoGuesser coverInfoGuesser;
+    const auto importedMetadata = SoundSourceProxy::importTrackMetadataAndCoverInfoFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)),
+            SyncTrackMetadataParams{},
+            &coverInfoGuesser);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded, importedMetadata.importResult);
+
+    auto pTrack = Track::newTemporary(filePath);
+    EXPECT_EQ(
+            SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                    SyncTrackMetadataParams{},
+                    &importedMetadata));
+    EXPECT_EQ(pExpectedTrack->getMetadata(), pTrack->getMetadata());
+    EXPECT_EQ(pExpectedTrack->getCoverInfo(), pTrack->getCoverInfo());
+    EXPECT_EQ(CoverInfo::METADATA, pTrack->getCoverInfo().type);
+}
+
 TEST_F(SoundSourceProxyTest, seekForwardBackward) {
     constexpr SINT kReadFrameCount = 10000;
 
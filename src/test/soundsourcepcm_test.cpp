@@ -0,0 +1,181 @@
+#include "sources/soundsourcepcm.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <QtEndian>
+#include <vector>
+
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+void appendId(QByteArray* pData, const char* id) {
+    pData->append(id, 4);
+}
+
+template<typename T>
+void appendLittleEndian(QByteArray* pData, T value) {
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    pData->append(bytes, sizeof(T));
+}
+
+template<typename T>
+void appendBigEndian(QByteArray* pData, T value) {
+    char bytes[sizeof(T)];
+    qToBigEndian(value, bytes);
+    pData->append(bytes, sizeof(T));
+}
+
+QByteArray createWav(quint16 formatTag,
+        quint16 channelCount,
+        quint16 bitsPerSample,
+        const QByteArray& samples) {
+    const quint16 blockAlign = channelCount * bitsPerSample / 8;
+    QByteArray data;
+    appendId(&data, "RIFF");
+    appendLittleEndian<quint32>(&data, 0); // not validated
+    appendId(&data, "WAVE");
+    // An odd-sized chunk that must be skipped including its padding
+    appendId(&data, "LIST");
+    appendLittleEndian<quint32>(&data, 3);
+    data.append("abc\0", 4);
+    appendId(&data, "fmt ");
+    appendLittleEndian<quint32>(&data, 16);
+    appendLittleEndian<quint16>(&data, formatTag);
+    appendLittleEndian<quint16>(&data, channelCount);
+    appendLittleEndian<quint32>(&data, 44100);
+    appendLittleEndian<quint32>(&data, 44100 * blockAlign);
+    appendLittleEndian<quint16>(&data, blockAlign);
+    appendLittleEndian<quint16>(&data, bitsPerSample);
+    appendId(&data, "data");
+    appendLittleEndian<quint32>(&data, static_cast<quint32>(samples.size()));
+    data.append(samples);
+    return data;
+}
+
+class SoundSourcePcmTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+    }
+
+    QUrl writeFile(const QString& fileName, const QByteArray& data) {
+        QFile file(m_tempDir.filePath(fileName));
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        EXPECT_EQ(data.size(), file.write(data));
+        return QUrl::fromLocalFile(file.fileName());
+    }
+
+    static std::vector<CSAMPLE> readAll(mixxx::SoundSourcePcm* pSoundSource) {
+        const auto range = pSoundSource->frameIndexRange();
+        mixxx::SampleBuffer buffer(
+                pSoundSource->getSignalInfo().frames2samples(range.length()));
+        const auto readRange = pSoundSource
+                                       ->readSampleFrames(mixxx::WritableSampleFrames(range,
+                                               mixxx::SampleBuffer::WritableSlice(buffer)))
+                                       .frameIndexRange();
+        EXPECT_EQ(range, readRange);
+        return std::vector<CSAMPLE>(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(SoundSourcePcmTest, readWav24Bit) {
+    QByteArray samples;
+    for (qint32 sample : {0x7FFFFF, -0x800000, 0x400000, -1}) {
+        samples.append(static_cast<char>(sample & 0xFF));
+        samples.append(static_cast<char>((sample >> 8) & 0xFF));
+        samples.append(static_cast<char>((sample >> 16) & 0xFF));
+    }
+    mixxx::SoundSourcePcm soundSource(
+            writeFile(QStringLiteral("24bit.wav"), createWav(1, 2, 24, samples)));
+    ASSERT_EQ(mixxx::SoundSource::OpenResult::Succeeded,
+            soundSource.open(mixxx::SoundSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams()));
+    EXPECT_EQ(mixxx::audio::ChannelCount::stereo(),
+            soundSource.getSignalInfo().getChannelCount());
+    EXPECT_EQ(mixxx::audio::SampleRate(44100),
+            soundSource.getSignalInfo().getSampleRate());
+    EXPECT_EQ(mixxx::IndexRange::forward(0, 2), soundSource.frameIndexRange());
+
+    const auto decoded = readAll(&soundSource);
+    EXPECT_FLOAT_EQ(8388607.0f / 8388608.0f, decoded[0]);
+    EXPECT_FLOAT_EQ(-1.0f, decoded[1]);
+    EXPECT_FLOAT_EQ(0.5f, decoded[2]);
+    EXPECT_FLOAT_EQ(-1.0f / 8388608.0f, decoded[3]);
+}
+
+TEST_F(SoundSourcePcmTest, readWavFloat) {
+    QByteArray samples;
+    for (float sample : {0.25f, -0.75f, 1.5f}) {
+        appendLittleEndian<float>(&samples, sample);
+    }
+    mixxx::SoundSourcePcm soundSource(
+            writeFile(QStringLiteral("float.wav"), createWav(3, 1, 32, samples)));
+    ASSERT_EQ(mixxx::SoundSource::OpenResult::Succeeded,
+            soundSource.open(mixxx::SoundSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams()));
+    // Seek into the middle
+    mixxx::SampleBuffer buffer(2);
+    const auto readRange = soundSource
+                                   .readSampleFrames(mixxx::WritableSampleFrames(
+                                           mixxx::IndexRange::forward(1, 2),
+                                           mixxx::SampleBuffer::WritableSlice(buffer)))
+                                   .frameIndexRange();
+    EXPECT_EQ(mixxx::IndexRange::forward(1, 2), readRange);
+    EXPECT_FLOAT_EQ(-0.75f, buffer[0]);
+    EXPECT_FLOAT_EQ(1.5f, buffer[1]);
+}
+
+TEST_F(SoundSourcePcmTest, readAiffWithCommAfterSsnd) {
+    QByteArray data;
+    appendId(&data, "FORM");
+    appendBigEndian<quint32>(&data, 0); // not validated
+    appendId(&data, "AIFF");
+    appendId(&data, "SSND");
+    appendBigEndian<quint32>(&data, 8 + 3 * 2);
+    appendBigEndian<quint32>(&data, 0); // offset
+    appendBigEndian<quint32>(&data, 0); // block size
+    for (qint16 sample : {qint16(-32768), qint16(16384), qint16(1)}) {
+        appendBigEndian<qint16>(&data, sample);
+    }
+    appendId(&data, "COMM");
+    appendBigEndian<quint32>(&data, 18);
+    appendBigEndian<quint16>(&data, 1);   // channels
+    appendBigEndian<quint32>(&data, 100); // more frames than available
+    appendBigEndian<quint16>(&data, 16);
+    // 44100 as 80-bit extended
+    data.append("\x40\x0E\xAC\x44\x00\x00\x00\x00\x00\x00", 10);
+
+    mixxx::SoundSourcePcm soundSource(writeFile(QStringLiteral("test.aiff"), data));
+    ASSERT_EQ(mixxx::SoundSource::OpenResult::Succeeded,
+            soundSource.open(mixxx::SoundSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams()));
+    EXPECT_EQ(mixxx::audio::ChannelCount::mono(),
+            soundSource.getSignalInfo().getChannelCount());
+    EXPECT_EQ(mixxx::audio::SampleRate(44100),
+            soundSource.getSignalInfo().getSampleRate());
+    EXPECT_EQ(mixxx::IndexRange::forward(0, 3), soundSource.frameIndexRange());
+
+    const auto decoded = readAll(&soundSource);
+    EXPECT_FLOAT_EQ(-1.0f, decoded[0]);
+    EXPECT_FLOAT_EQ(0.5f, decoded[1]);
+    EXPECT_FLOAT_EQ(1.0f / 32768.0f, decoded[2]);
+}
+
+TEST_F(SoundSourcePcmTest, abortUnsupportedFormat) {
+    // IMA ADPCM is left to libsndfile
+    mixxx::SoundSourcePcm soundSource(writeFile(QStringLiteral("adpcm.wav"),
+            createWav(0x11, 1, 4, QByteArray(16, '\0'))));
+    EXPECT_EQ(mixxx::SoundSource::OpenResult::Aborted,
+            soundSource.open(mixxx::SoundSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams()));
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+#include "engine/filters/stereooversampler.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr SINT kFramesPerBuffer = 256;
+constexpr int kNumBuffers = 16;
+
+class StereoOversamplerTest : public testing::TestWithParam<int> {
+};
+
+TEST_P(StereoOversamplerTest, PassbandIsDelayedByLatency) {
+    StereoOversampler oversampler(GetParam());
+    const SINT latency = oversampler.latencyFrames();
+    std::vector<CSAMPLE> input(2 * kFramesPerBuffer);
+    std::vector<CSAMPLE> output(2 * kFramesPerBuffer);
+    std::vector<CSAMPLE> oversampled(2 * kFramesPerBuffer * StereoOversampler::kMaxFactor);
+
+    // A quarter of the sample rate, i.e. 11 kHz at 44.1 kHz
+    const double frequency = 0.25;
+    auto signal = [frequency](SINT frame) {
+        return frame < 0 ? 0.0 : std::sin(2 * M_PI * frequency * frame);
+    };
+    for (int buffer = 0; buffer < kNumBuffers; ++buffer) {
+        const SINT start = buffer * kFramesPerBuffer;
+        for (SINT i = 0; i < kFramesPerBuffer; ++i) {
+            input[2 * i] = static_cast<CSAMPLE>(signal(start + i));
+            input[2 * i + 1] = -input[2 * i];
+        }
+        oversampler.upsample(oversampled.data(), input.data(), kFramesPerBuffer);
+        oversampler.downsample(output.data(), oversampled.data(), kFramesPerBuffer);
+        if (buffer == 0) {
+            // Wait for the filters to settle
+            continue;
+        }
+        for (SINT i = 0; i < kFramesPerBuffer; ++i) {
+            const double expected = signal(start + i - latency);
+            ASSERT_NEAR(expected, output[2 * i], 1e-3);
+            ASSERT_NEAR(-expected, output[2 * i + 1], 1e-3);
+        }
+    }
+}
+
+TEST_P(StereoOversamplerTest, HarmonicsAboveNyquistAreRemoved) {
+    StereoOversampler oversampler(GetParam());
+    const int factor = oversampler.factor();
+    std::vector<CSAMPLE> output(2 * kFramesPerBuffer);
+    std::vector<CSAMPLE> oversampled(2 * kFramesPerBuffer * factor);
+
+    // Would be aliased to 0.2 of the sample rate without filtering
+    const double frequency = 0.8 / factor;
+    double power = 0;
+    for (int buffer = 0; buffer < kNumBuffers; ++buffer) {
+        const SINT start = buffer * kFramesPerBuffer * factor;
+        for (SINT i = 0; i < kFramesPerBuffer * factor; ++i) {
+            oversampled[2 * i] = static_cast<CSAMPLE>(
+                    std::sin(2 * M_PI * frequency * (start + i)));
+            oversampled[2 * i + 1] = oversampled[2 * i];
+        }
+        oversampler.downsample(output.data(), oversampled.data(), kFramesPerBuffer);
+        if (buffer == 0) {
+            continue;
+        }
+        for (SINT i = 0; i < 2 * kFramesPerBuffer; ++i) {
+            power += output[i] * output[i];
+        }
+    }
+    power /= 2 * kFramesPerBuffer * (kNumBuffers - 1);
+    // At least 60 dB below the sine with its power of 0.5
+    EXPECT_LT(power, 0.5 * 1e-6);
+}
+
+TEST_P(StereoOversamplerTest, DelayMatchesLatency) {
+    StereoOversampler oversampler(GetParam());
+    const SINT latency = oversampler.latencyFrames();
+    std::vector<CSAMPLE> buffer(2 * kFramesPerBuffer);
+    for (SINT i = 0; i < kFramesPerBuffer; ++i) {
+        buffer[2 * i] = static_cast<CSAMPLE>(i + 1);
+        buffer[2 * i + 1] = -static_cast<CSAMPLE>(i + 1);
+    }
+    // In place
+    oversampler.delay(buffer.data(), buffer.data(), kFramesPerBuffer);
+    for (SINT i = 0; i < kFramesPerBuffer; ++i) {
+        const CSAMPLE expected = i < latency ? 0 : static_cast<CSAMPLE>(i + 1 - latency);
+        ASSERT_EQ(expected, buffer[2 * i]);
+        ASSERT_EQ(-expected, buffer[2 * i + 1]);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(StereoOversamplerTest,
+        StereoOversamplerTest,
+        testing::Values(2, 4));
+
+} // namespace
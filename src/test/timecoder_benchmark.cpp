@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include "util/types.h"
+#include "vinylcontrol/defs_vinylcontrol.h"
+#include "vinylcontrol/vinylcontrolxwax.h"
+
+// Measures decoding the timecode of a single deck at 96 kHz, in blocks of
+// the size of an audio buffer. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_Timecoder
+
+namespace {
+
+constexpr unsigned int kSampleRate = 96000;
+constexpr int kChannels = 2;
+constexpr int kFramesPerBuffer = 256;
+// One second of audio
+constexpr int kBufferCount = kSampleRate / kFramesPerBuffer;
+
+// Resembles a Serato timecode: A 1 kHz carrier in quadrature, whose
+// amplitude is modulated by the bits of an LFSR, played back at a varying
+// speed that includes short backspins.
+std::vector<CSAMPLE> generateTimecode() {
+    std::vector<CSAMPLE> samples(kBufferCount * kFramesPerBuffer * kChannels);
+    double phase = 0.0;
+    double bitPhase = 0.0;
+    unsigned int lfsr = 0xACE1u;
+    bool bit = true;
+    for (int frame = 0; frame < kBufferCount * kFramesPerBuffer; ++frame) {
+        const int buffer = frame / kFramesPerBuffer;
+        const double speed = 1.0 + 0.5 * std::sin(buffer * 0.01) +
+                (buffer % 120 < 8 ? -2.0 : 0.0);
+        phase += 2 * M_PI * 1000 * speed / kSampleRate;
+        bitPhase += speed * 1000 / kSampleRate;
+        if (bitPhase >= 1.0) {
+            bitPhase -= 1.0;
+            lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+            bit = (lfsr & 1u) != 0;
+        }
+        const double amplitude = bit ? 0.8 : 0.5;
+        samples[frame * kChannels] = static_cast<CSAMPLE>(amplitude * std::sin(phase));
+        samples[frame * kChannels + 1] = static_cast<CSAMPLE>(amplitude * std::cos(phase));
+    }
+    return samples;
+}
+
+void BM_Timecoder_ConvertSamples(benchmark::State& state) {
+    const std::vector<CSAMPLE> samples = generateTimecode();
+    std::vector<short> converted(kFramesPerBuffer * kChannels);
+    for (auto _ : state) {
+        for (int buffer = 0; buffer < kBufferCount; ++buffer) {
+            VinylControlXwax::convertSamples(converted.data(),
+                    &samples[buffer * kFramesPerBuffer * kChannels],
+                    kFramesPerBuffer * kChannels,
+                    1.0f);
+            benchmark::DoNotOptimize(converted.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kBufferCount * kFramesPerBuffer);
+}
+BENCHMARK(BM_Timecoder_ConvertSamples);
+
+// With the monitor of the signal quality scope if range(0) is 1
+void BM_Timecoder_Submit(benchmark::State& state) {
+    const bool withMonitor = state.range(0) != 0;
+    const std::vector<CSAMPLE> samples = generateTimecode();
+    std::vector<short> converted(samples.size());
+    VinylControlXwax::convertSamples(converted.data(), samples.data(), samples.size(), 1.0f);
+
+    timecode_def* pDef = timecoder_find_definition("serato_2a");
+    if (!pDef) {
+        state.SkipWithError("No timecode definition");
+        return;
+    }
+    struct timecoder timecoder;
+    // Builds the lookup table once, outside of the measurement
+    timecoder_init(&timecoder, pDef, 1.0, kSampleRate, false);
+    if (withMonitor) {
+        timecoder_monitor_init(&timecoder, MIXXX_VINYL_SCOPE_SIZE);
+    }
+    for (auto _ : state) {
+        for (int buffer = 0; buffer < kBufferCount; ++buffer) {
+            timecoder_submit(&timecoder,
+                    &converted[buffer * kFramesPerBuffer * kChannels],
+                    kFramesPerBuffer);
+        }
+        double when;
+        benchmark::DoNotOptimize(timecoder_get_position(&timecoder, &when));
+        benchmark::DoNotOptimize(timecoder_get_pitch(&timecoder));
+    }
+    state.SetItemsProcessed(state.iterations() * kBufferCount * kFramesPerBuffer);
+    if (withMonitor) {
+        timecoder_monitor_clear(&timecoder);
+    }
+    timecoder_clear(&timecoder);
+}
+BENCHMARK(BM_Timecoder_Submit)->Arg(0)->Arg(1);
+
+} // namespace
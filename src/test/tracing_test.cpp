@@ -0,0 +1,167 @@
+#include "util/tracing.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <thread>
+
+namespace {
+
+class TracingTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        mixxx::tracing::clearEvents();
+        mixxx::tracing::setEnabled(true);
+        mixxx::tracing::registerCurrentThread(QStringLiteral("TracingTest"));
+    }
+
+    void TearDown() override {
+        mixxx::tracing::setEnabled(false);
+        mixxx::tracing::clearEvents();
+    }
+
+    // All recorded events with this id of all threads
+    static std::vector<mixxx::tracing::Event> eventsWithId(mixxx::tracing::EventId id) {
+        std::vector<mixxx::tracing::Event> result;
+        for (const auto& threadEvents : mixxx::tracing::collectEvents()) {
+            for (const auto& event : threadEvents.events) {
+                if (event.id == id) {
+                    result.push_back(event);
+                }
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(TracingTest, internEvent) {
+    const auto id = mixxx::tracing::internEvent("TracingTest::internEvent");
+    EXPECT_EQ(id, mixxx::tracing::internEvent("TracingTest::internEvent"));
+    EXPECT_NE(id, mixxx::tracing::internEvent("TracingTest::internEvent2"));
+    EXPECT_STREQ("TracingTest::internEvent", mixxx::tracing::eventName(id));
+}
+
+TEST_F(TracingTest, nestedScopes) {
+    const auto outerId = mixxx::tracing::internEvent("TracingTest::outer");
+    const auto innerId = mixxx::tracing::internEvent("TracingTest::inner");
+    {
+        const mixxx::tracing::Scope outer(outerId);
+        const mixxx::tracing::Scope inner(innerId);
+    }
+
+    const auto outerEvents = eventsWithId(outerId);
+    const auto innerEvents = eventsWithId(innerId);
+    ASSERT_EQ(1u, outerEvents.size());
+    ASSERT_EQ(1u, innerEvents.size());
+    EXPECT_LE(outerEvents[0].startNanos, innerEvents[0].startNanos);
+    EXPECT_LE(innerEvents[0].startNanos, innerEvents[0].endNanos);
+    EXPECT_LE(innerEvents[0].endNanos, outerEvents[0].endNanos);
+}
+
+TEST_F(TracingTest, disabled) {
+    mixxx::tracing::setEnabled(false);
+    const auto id = mixxx::tracing::internEvent("TracingTest::disabled");
+    {
+        const mixxx::tracing::Scope scope(id);
+    }
+    EXPECT_TRUE(eventsWithId(id).empty());
+}
+
+TEST_F(TracingTest, ringBufferKeepsLatestEvents) {
+    const auto id = mixxx::tracing::internEvent("TracingTest::ringBuffer");
+    constexpr int kEventCount = mixxx::tracing::kEventsPerThread + 100;
+    for (int i = 0; i < kEventCount; ++i) {
+        const mixxx::tracing::Scope scope(id);
+    }
+
+    const auto events = eventsWithId(id);
+    EXPECT_EQ(static_cast<std::size_t>(mixxx::tracing::kEventsPerThread), events.size());
+    for (std::size_t i = 1; i < events.size(); ++i) {
+        EXPECT_LE(events[i - 1].endNanos, events[i].startNanos);
+    }
+}
+
+TEST_F(TracingTest, threads) {
+    const auto id = mixxx::tracing::internEvent("TracingTest::threads");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([] {
+            mixxx::tracing::registerCurrentThread(QStringLiteral("TracingTest::threads"));
+            for (int j = 0; j < 100; ++j) {
+                MIXXX_TRACE_SCOPE("TracingTest::threads");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    int threadCount = 0;
+    for (const auto& threadEvents : mixxx::tracing::collectEvents()) {
+        if (!threadEvents.events.empty() && threadEvents.events.front().id == id) {
+            EXPECT_EQ(100u, threadEvents.events.size());
+            ++threadCount;
+        }
+    }
+    EXPECT_EQ(4, threadCount);
+}
+
+TEST_F(TracingTest, unregisteredThreadsAreNotTraced) {
+    const auto id = mixxx::tracing::internEvent("TracingTest::unregistered");
+    std::thread thread([] {
+        MIXXX_TRACE_SCOPE("TracingTest::unregistered");
+    });
+    thread.join();
+    EXPECT_TRUE(eventsWithId(id).empty());
+}
+
+TEST_F(TracingTest, callbackThread) {
+    const auto id = mixxx::tracing::internEvent("TracingTest::callbackThread");
+    std::thread thread([] {
+        mixxx::tracing::registerCallbackThread(QStringLiteral("TracingTest::callbackThread"));
+        MIXXX_TRACE_SCOPE("TracingTest::callbackThread");
+    });
+    thread.join();
+
+    bool found = false;
+    for (const auto& threadEvents : mixxx::tracing::collectEvents()) {
+        if (threadEvents.threadName == QStringLiteral("TracingTest::callbackThread")) {
+            ASSERT_EQ(1u, threadEvents.events.size());
+            EXPECT_EQ(id, threadEvents.events.front().id);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST_F(TracingTest, writeChromeTrace) {
+    {
+        MIXXX_TRACE_SCOPE("TracingTest::writeChromeTrace");
+    }
+
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("trace.json"));
+    ASSERT_TRUE(mixxx::tracing::writeChromeTrace(filePath));
+
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QJsonArray traceEvents =
+            QJsonDocument::fromJson(file.readAll()).object().value("traceEvents").toArray();
+    bool found = false;
+    for (const auto& value : traceEvents) {
+        const QJsonObject traceEvent = value.toObject();
+        if (traceEvent.value("name").toString() == "TracingTest::writeChromeTrace") {
+            EXPECT_EQ("X", traceEvent.value("ph").toString());
+            EXPECT_GE(traceEvent.value("dur").toDouble(), 0);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+} // namespace
@@ -1,12 +1,34 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "library/dao/trackschema.h"
+#include "library/searchquery.h"
+#include "library/trackmetadataexportqueue.h"
+#include "library/trackwritebehindqueue.h"
+#include "sources/soundsourceproxy.h"
 #include "test/librarytest.h"
 #include "track/track.h"
 
+using ::testing::IsEmpty;
 using ::testing::UnorderedElementsAre;
 
 class TrackDAOTest : public LibraryTest {
+  protected:
+    QList<TrackId> selectTrackIds(const QueryNode& query) {
+        // Resolves the columns like the view that is used by the library
+        QSqlQuery sqlQuery(dbConnection());
+        EXPECT_TRUE(sqlQuery.exec(QStringLiteral(
+                "SELECT id FROM (SELECT library.id AS id,library.artist AS artist,"
+                "track_locations.location AS location FROM library "
+                "INNER JOIN track_locations ON library.location=track_locations.id) "
+                "WHERE %1")
+                                          .arg(query.toSql())));
+        QList<TrackId> trackIds;
+        while (sqlQuery.next()) {
+            trackIds.append(TrackId(sqlQuery.value(0)));
+        }
+        return trackIds;
+    }
 };
 
 
@@ -56,3 +78,204 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, detectMovedTracksOnlyOncePerAddedTrack) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    QString filename = QStringLiteral("file.mp3");
+
+    mixxx::FileInfo oldFile1(QDir(QDir::tempPath() + QStringLiteral("/old1/dir1")), filename);
+    mixxx::FileInfo oldFile2(QDir(QDir::tempPath() + QStringLiteral("/old2/dir1")), filename);
+    mixxx::FileInfo newFile(QDir(QDir::tempPath() + QStringLiteral("/new/dir1")), filename);
+
+    TrackPointer pOldTrack1 = Track::newTemporary(mixxx::FileAccess(oldFile1));
+    TrackPointer pOldTrack2 = Track::newTemporary(mixxx::FileAccess(oldFile2));
+    TrackPointer pNewTrack = Track::newTemporary(mixxx::FileAccess(newFile));
+
+    pOldTrack1->setDuration(135);
+    pOldTrack2->setDuration(135);
+    pNewTrack->setDuration(135.7);
+
+    TrackId oldId1 = internalCollection()->addTrack(pOldTrack1, false);
+    TrackId oldId2 = internalCollection()->addTrack(pOldTrack2, false);
+    TrackId newId = internalCollection()->addTrack(pNewTrack, false);
+
+    QSqlQuery query(dbConnection());
+    query.prepare("UPDATE track_locations SET fs_deleted=1 WHERE location IN "
+                  "(:location1,:location2)");
+    query.bindValue(":location1", oldFile1.location());
+    query.bindValue(":location2", oldFile2.location());
+    query.exec();
+
+    QList<RelocatedTrack> relocatedTracks;
+    QStringList addedTracks(newFile.location());
+    bool cancel = false;
+    EXPECT_TRUE(trackDAO.detectMovedTracks(&relocatedTracks, addedTracks, &cancel));
+
+    ASSERT_EQ(1, relocatedTracks.size());
+    EXPECT_THAT(QList<TrackId>{relocatedTracks.first().updatedTrackRef().getId()},
+            ::testing::AnyOf(
+                    ::testing::ElementsAre(oldId1), ::testing::ElementsAre(oldId2)));
+    EXPECT_EQ(newId, relocatedTracks.first().deletedTrackId());
+}
+
+TEST_F(TrackDAOTest, getAllTrackIds) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    const QDir dir(QDir::tempPath() + QStringLiteral("/alltrackids"));
+    TrackPointer pTrack = Track::newTemporary(
+            mixxx::FileAccess(mixxx::FileInfo(dir, QStringLiteral("visible.mp3"))));
+    TrackPointer pHiddenTrack = Track::newTemporary(
+            mixxx::FileAccess(mixxx::FileInfo(dir, QStringLiteral("hidden.mp3"))));
+    const mixxx::FileInfo missingFile(dir, QStringLiteral("missing.mp3"));
+    TrackPointer pMissingTrack = Track::newTemporary(mixxx::FileAccess(missingFile));
+
+    TrackId id = internalCollection()->addTrack(pTrack, false);
+    TrackId hiddenId = internalCollection()->addTrack(pHiddenTrack, false);
+    internalCollection()->addTrack(pMissingTrack, false);
+
+    ASSERT_TRUE(internalCollection()->hideTracks(QList<TrackId>{hiddenId}));
+    QSqlQuery query(dbConnection());
+    query.prepare("UPDATE track_locations SET fs_deleted=1 WHERE location=:location");
+    query.bindValue(":location", missingFile.location());
+    ASSERT_TRUE(query.exec());
+
+    EXPECT_THAT(trackDAO.getAllTrackIds(), UnorderedElementsAre(id));
+}
+
+TEST_F(TrackDAOTest, maintainsFullTextIndex) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+    EXPECT_TRUE(trackDAO.hasFullTextIndex());
+
+    const QDir dir(QDir::tempPath() + QStringLiteral("/fulltextindex"));
+    TrackPointer pTrack = Track::newTemporary(
+            mixxx::FileAccess(mixxx::FileInfo(dir, QStringLiteral("track.mp3"))));
+    pTrack->setArtist(QStringLiteral("ABBA"));
+    const TrackId id = internalCollection()->addTrack(pTrack, false);
+    ASSERT_TRUE(id.isValid());
+
+    const FullTextFilterNode artistNode(dbConnection(),
+            QStringList{LIBRARYTABLE_ARTIST},
+            QStringLiteral("bba"),
+            LIBRARYTABLE_ID);
+    EXPECT_TRUE(artistNode.toSql().contains(QStringLiteral("MATCH")));
+    EXPECT_THAT(selectTrackIds(artistNode), UnorderedElementsAre(id));
+    const FullTextFilterNode locationNode(dbConnection(),
+            QStringList{TRACKLOCATIONSTABLE_LOCATION},
+            QStringLiteral("fulltext"),
+            LIBRARYTABLE_ID);
+    EXPECT_THAT(selectTrackIds(locationNode), UnorderedElementsAre(id));
+
+    // The index can't find substrings with less than 3 characters
+    const FullTextFilterNode shortNode(dbConnection(),
+            QStringList{LIBRARYTABLE_ARTIST},
+            QStringLiteral("bb"),
+            LIBRARYTABLE_ID);
+    EXPECT_FALSE(shortNode.toSql().contains(QStringLiteral("MATCH")));
+    EXPECT_THAT(selectTrackIds(shortNode), UnorderedElementsAre(id));
+
+    pTrack->setArtist(QStringLiteral("Beatles"));
+    ASSERT_TRUE(trackDAO.saveTrack(pTrack.get()));
+    EXPECT_THAT(selectTrackIds(artistNode), IsEmpty());
+
+    ASSERT_TRUE(internalCollection()->purgeTracks(QList<TrackId>{id}));
+    EXPECT_THAT(selectTrackIds(locationNode), IsEmpty());
+}
+
+TEST_F(TrackDAOTest, writeBehindQueueCoalescesSnapshots) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+    TrackWriteBehindQueue writeBehindQueue(dbConnectionPooler(), config());
+    writeBehindQueue.start();
+    trackDAO.setWriteBehindQueue(&writeBehindQueue);
+
+    mixxx::FileInfo file(QDir(QDir::tempPath()), QStringLiteral("writebehind.mp3"));
+    TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(file));
+    const TrackId id = internalCollection()->addTrack(pTrack, false);
+    ASSERT_TRUE(id.isValid());
+
+    pTrack->setTitle(QStringLiteral("Outdated"));
+    const TrackSnapshot outdatedSnapshot(*pTrack);
+    pTrack->setTitle(QStringLiteral("Written"));
+    const TrackSnapshot snapshot(*pTrack);
+    TrackSnapshot deletedSnapshot(*pTrack);
+    deletedSnapshot.trackId = TrackId(QVariant(id.toVariant().toInt() + 1));
+
+    // Snapshots are only accepted after the thread has been connected
+    // to the database
+    for (int i = 0; i < 1000 && !writeBehindQueue.enqueue(outdatedSnapshot); ++i) {
+        QThread::msleep(1);
+    }
+    ASSERT_TRUE(writeBehindQueue.enqueue(deletedSnapshot));
+    ASSERT_TRUE(writeBehindQueue.enqueue(snapshot));
+    writeBehindQueue.flushTrack(id);
+
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral("SELECT title FROM library WHERE id=%1")
+                                   .arg(id.toString())));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(QStringLiteral("Written"), query.value(0).toString());
+
+    writeBehindQueue.stop();
+    writeBehindQueue.wait();
+    trackDAO.setWriteBehindQueue(nullptr);
+    EXPECT_FALSE(writeBehindQueue.enqueue(snapshot));
+}
+
+TEST_F(TrackDAOTest, metadataExportQueueExportsBeforeSaving) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+    TrackWriteBehindQueue writeBehindQueue(dbConnectionPooler(), config());
+    TrackMetadataExportQueue metadataExportQueue(&writeBehindQueue);
+    writeBehindQueue.start();
+    metadataExportQueue.start();
+    trackDAO.setWriteBehindQueue(&writeBehindQueue);
+    trackDAO.setMetadataExportQueue(&metadataExportQueue);
+
+    const QString filePath = getTestDataDir().filePath(QStringLiteral("export.mp3"));
+    mixxxtest::copyFile(
+            getTestDir().filePath(QStringLiteral("id3-test-data/empty.mp3")),
+            filePath);
+    TrackPointer pTrack = Track::newTemporary(filePath);
+    pTrack->replaceMetadataFromSource(
+            mixxx::TrackMetadata{},
+            QDateTime::currentDateTimeUtc());
+    const TrackId id = internalCollection()->addTrack(pTrack, false);
+    ASSERT_TRUE(id.isValid());
+    pTrack->setTitle(QStringLiteral("Exported"));
+    pTrack->markForMetadataExport();
+
+    // Tracks are only accepted after the thread has been started
+    for (int i = 0; i < 1000 &&
+            !metadataExportQueue.enqueue(*pTrack, SyncTrackMetadataParams{});
+            ++i) {
+        QThread::msleep(1);
+    }
+    metadataExportQueue.flushTrack(id);
+    writeBehindQueue.flushTrack(id);
+
+    mixxx::TrackMetadata exportedMetadata;
+    SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)),
+            &exportedMetadata,
+            nullptr,
+            false);
+    EXPECT_EQ(QStringLiteral("Exported"), exportedMetadata.getTrackInfo().getTitle());
+
+    // The synchronization time stamp of the export has been saved
+    const QDateTime fileSynchronizedAt =
+            mixxx::MetadataSource::getFileSynchronizedAt(QFile(filePath));
+    ASSERT_TRUE(fileSynchronizedAt.isValid());
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(
+            QStringLiteral("SELECT title,source_synchronized_ms FROM library WHERE id=%1")
+                    .arg(id.toString())));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(QStringLiteral("Exported"), query.value(0).toString());
+    EXPECT_EQ(fileSynchronizedAt.toMSecsSinceEpoch(), query.value(1).toLongLong());
+
+    metadataExportQueue.stop();
+    metadataExportQueue.wait();
+    writeBehindQueue.stop();
+    writeBehindQueue.wait();
+    trackDAO.setMetadataExportQueue(nullptr);
+    trackDAO.setWriteBehindQueue(nullptr);
+}
@@ -0,0 +1,134 @@
+#include "track/trackenginesnapshot.h"
+
+#include <gtest/gtest.h>
+
+#include "track/keyfactory.h"
+#include "track/track.h"
+
+namespace {
+
+class TrackEngineSnapshotTest : public testing::Test {
+  protected:
+    TrackEngineSnapshotTest()
+            : m_pTrack(Track::newTemporary()) {
+        m_pTrack->setAudioProperties(
+                mixxx::audio::ChannelCount(2),
+                mixxx::audio::SampleRate(44100),
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(180));
+    }
+
+    TrackPointer m_pTrack;
+};
+
+TEST_F(TrackEngineSnapshotTest, initialSnapshot) {
+    const auto pSnapshot = m_pTrack->getEngineSnapshot();
+    ASSERT_TRUE(pSnapshot);
+    EXPECT_FALSE(pSnapshot->pBeats);
+    EXPECT_TRUE(pSnapshot->cues.isEmpty());
+    EXPECT_EQ(mixxx::track::io::key::INVALID, pSnapshot->key);
+}
+
+TEST_F(TrackEngineSnapshotTest, beats) {
+    const auto pBeats = mixxx::Beats::fromConstTempo(
+            m_pTrack->getSampleRate(), mixxx::audio::kStartFramePos, mixxx::Bpm(120));
+    ASSERT_TRUE(m_pTrack->trySetBeats(pBeats));
+    EXPECT_EQ(pBeats, m_pTrack->getEngineSnapshot()->pBeats);
+}
+
+TEST_F(TrackEngineSnapshotTest, cues) {
+    const auto pPreviousSnapshot = m_pTrack->getEngineSnapshot();
+    const CuePointer pCue = m_pTrack->createAndAddCue(mixxx::CueType::HotCue,
+            3,
+            mixxx::audio::FramePos(1000),
+            mixxx::audio::kInvalidFramePos);
+    pCue->setLabel(QStringLiteral("Drop"));
+
+    auto pSnapshot = m_pTrack->getEngineSnapshot();
+    ASSERT_EQ(1, pSnapshot->cues.size());
+    EXPECT_EQ(mixxx::CueType::HotCue, pSnapshot->cues.first().type);
+    EXPECT_EQ(3, pSnapshot->cues.first().hotCueIndex);
+    EXPECT_EQ(mixxx::audio::FramePos(1000), pSnapshot->cues.first().startPosition);
+    EXPECT_EQ(QStringLiteral("Drop"), pSnapshot->cues.first().label);
+    EXPECT_EQ(pCue.get(), pSnapshot->cues.first().pCue);
+    // Published snapshots are never modified
+    EXPECT_TRUE(pPreviousSnapshot->cues.isEmpty());
+
+    // Modifying the cue itself publishes a new snapshot
+    pCue->setStartPosition(mixxx::audio::FramePos(2000));
+    EXPECT_EQ(mixxx::audio::FramePos(1000), pSnapshot->cues.first().startPosition);
+    pSnapshot = m_pTrack->getEngineSnapshot();
+    EXPECT_EQ(mixxx::audio::FramePos(2000), pSnapshot->cues.first().startPosition);
+
+    m_pTrack->removeCue(pCue);
+    EXPECT_TRUE(m_pTrack->getEngineSnapshot()->cues.isEmpty());
+}
+
+TEST_F(TrackEngineSnapshotTest, keyAndReplayGain) {
+    m_pTrack->setKey(mixxx::track::io::key::A_MINOR, mixxx::track::io::key::USER);
+    EXPECT_EQ(mixxx::track::io::key::A_MINOR, m_pTrack->getEngineSnapshot()->key);
+
+    mixxx::ReplayGain replayGain;
+    replayGain.setRatio(0.5);
+    m_pTrack->setReplayGain(replayGain);
+    EXPECT_EQ(0.5, m_pTrack->getEngineSnapshot()->replayGain.getRatio());
+}
+
+TEST_F(TrackEngineSnapshotTest, keyOfReplacedRecord) {
+    mixxx::TrackRecord record = m_pTrack->getRecord();
+    record.setKeys(KeyFactory::makeBasicKeys(
+            mixxx::track::io::key::C_MAJOR, mixxx::track::io::key::USER));
+    ASSERT_TRUE(m_pTrack->replaceRecord(std::move(record)));
+    EXPECT_EQ(mixxx::track::io::key::C_MAJOR, m_pTrack->getEngineSnapshot()->key);
+}
+
+TEST_F(TrackEngineSnapshotTest, sortedCues) {
+    m_pTrack->createAndAddCue(mixxx::CueType::HotCue,
+            2,
+            mixxx::audio::FramePos(3000),
+            mixxx::audio::kInvalidFramePos);
+    m_pTrack->createAndAddCue(mixxx::CueType::Loop,
+            1,
+            mixxx::audio::FramePos(2000),
+            mixxx::audio::FramePos(2500));
+    m_pTrack->createAndAddCue(mixxx::CueType::HotCue,
+            0,
+            mixxx::audio::FramePos(1000),
+            mixxx::audio::kInvalidFramePos);
+    // Only the end position is set
+    m_pTrack->createAndAddCue(mixxx::CueType::Intro,
+            Cue::kNoHotCue,
+            mixxx::audio::kInvalidFramePos,
+            mixxx::audio::FramePos(500));
+
+    const auto pSnapshot = m_pTrack->getEngineSnapshot();
+    ASSERT_EQ(4, pSnapshot->cues.size());
+    EXPECT_EQ(mixxx::audio::FramePos(1000), pSnapshot->cues[0].startPosition);
+    EXPECT_EQ(mixxx::audio::FramePos(2000), pSnapshot->cues[1].startPosition);
+    EXPECT_EQ(mixxx::audio::FramePos(3000), pSnapshot->cues[2].startPosition);
+    EXPECT_EQ(mixxx::CueType::Intro, pSnapshot->cues[3].type);
+    EXPECT_NE(nullptr, pSnapshot->findCueByType(mixxx::CueType::Intro));
+    EXPECT_TRUE(pSnapshot->startPositions(mixxx::CueType::Intro).isEmpty());
+
+    const QVector<mixxx::audio::FramePos> hotCuePositions = {
+            mixxx::audio::FramePos(1000), mixxx::audio::FramePos(3000)};
+    EXPECT_EQ(hotCuePositions, pSnapshot->startPositions(mixxx::CueType::HotCue));
+
+    EXPECT_EQ(mixxx::audio::FramePos(1000),
+            pSnapshot->findPrevCuePosition(
+                    mixxx::CueType::HotCue, mixxx::audio::FramePos(3000)));
+    EXPECT_EQ(mixxx::audio::FramePos(3000),
+            pSnapshot->findNextCuePosition(
+                    mixxx::CueType::HotCue, mixxx::audio::FramePos(1000)));
+    EXPECT_FALSE(pSnapshot->findPrevCuePosition(
+                                  mixxx::CueType::HotCue, mixxx::audio::FramePos(1000))
+                         .isValid());
+    EXPECT_FALSE(pSnapshot->findNextCuePosition(
+                                  mixxx::CueType::HotCue, mixxx::audio::FramePos(3000))
+                         .isValid());
+    EXPECT_EQ(mixxx::audio::FramePos(2000),
+            pSnapshot->findNextCuePosition(
+                    mixxx::CueType::Loop, mixxx::audio::FramePos(0)));
+}
+
+} // namespace
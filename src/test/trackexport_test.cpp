@@ -300,3 +300,34 @@ TEST_F(TrackExporterTest, MungeFilename) {
     // Remove the track we created.
     tempPath.remove("cover-test.ogg");
 }
+
+TEST_F(TrackExporterTest, ConcurrentExport) {
+    // Export more files than there are concurrent copies and check that
+    // all of them have been copied completely.
+    const QString fileNames[] = {
+            QStringLiteral("cover-test.aiff"),
+            QStringLiteral("cover-test.flac"),
+            QStringLiteral("cover-test.ogg"),
+            QStringLiteral("cover-test.wav"),
+            QStringLiteral("cover-test-itunes-12.3.0-aac.m4a"),
+    };
+    TrackPointerList tracks;
+    for (const auto& fileName : fileNames) {
+        mixxx::FileInfo fileinfo(m_testDataDir.filePath(fileName));
+        tracks.append(Track::newTemporary(mixxx::FileAccess(fileinfo)));
+    }
+    TrackExportWorker worker(m_exportDir.canonicalPath(), tracks, 3);
+    m_answerer.reset(new FakeOverwriteAnswerer(&worker));
+
+    worker.run();
+    EXPECT_TRUE(worker.wait(10000));
+
+    EXPECT_EQ(5, m_answerer->currentProgress());
+    EXPECT_EQ(5, m_answerer->currentProgressCount());
+
+    for (const auto& fileName : fileNames) {
+        QFileInfo newfile(m_exportDir.filePath(fileName));
+        EXPECT_TRUE(newfile.exists());
+        EXPECT_EQ(QFileInfo(m_testDataDir.filePath(fileName)).size(), newfile.size());
+    }
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QSqlQuery>
+
+#include "library/tracktablequerythread.h"
+#include "test/librarytest.h"
+
+class TrackTableQueryThreadTest : public LibraryTest {
+  protected:
+    // Returns all rows that have been delivered until the query is
+    // finished
+    TrackTableQueryThread::Rows fetchRows(
+            TrackTableQueryThread* pThread,
+            TrackTableQueryThread::Query query,
+            TrackTableQueryThread::Status* pStatus) {
+        QObject receiver;
+        TrackTableQueryThread::Rows fetchedRows;
+        bool finished = false;
+        pThread->submit(&receiver,
+                std::move(query),
+                [&](quint64 queryId,
+                        TrackTableQueryThread::Rows rows,
+                        TrackTableQueryThread::Status status) {
+                    Q_UNUSED(queryId);
+                    fetchedRows += rows;
+                    if (status != TrackTableQueryThread::Status::Fetching) {
+                        *pStatus = status;
+                        finished = true;
+                    }
+                });
+        for (int i = 0; i < 5000 && !finished; ++i) {
+            QCoreApplication::processEvents();
+            QThread::msleep(1);
+        }
+        EXPECT_TRUE(finished);
+        pThread->abort(&receiver);
+        return fetchedRows;
+    }
+};
+
+TEST_F(TrackTableQueryThreadTest, recreatesTemporaryViewOnWorkerConnection) {
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "CREATE TEMPORARY VIEW query_thread_test AS "
+            "SELECT 1 AS value UNION ALL SELECT 2")));
+    const QString viewSql = TrackTableQueryThread::temporaryViewSql(
+            dbConnection(), QStringLiteral("query_thread_test"));
+    ASSERT_FALSE(viewSql.isEmpty());
+    EXPECT_TRUE(TrackTableQueryThread::temporaryViewSql(
+            dbConnection(), QStringLiteral("library"))
+                        .isEmpty());
+
+    TrackTableQueryThread thread(dbConnectionPooler());
+    thread.start();
+
+    TrackTableQueryThread::Status status = TrackTableQueryThread::Status::Fetching;
+    const TrackTableQueryThread::Rows rows = fetchRows(&thread,
+            TrackTableQueryThread::Query{
+                    QStringLiteral("SELECT value FROM query_thread_test ORDER BY value"),
+                    QStringLiteral("query_thread_test"),
+                    viewSql},
+            &status);
+    EXPECT_EQ(TrackTableQueryThread::Status::Complete, status);
+    ASSERT_EQ(2, rows.size());
+    EXPECT_EQ(1, rows[0].value(0).toInt());
+    EXPECT_EQ(2, rows[1].value(0).toInt());
+
+    // Invalid statements must be executed by the receiver
+    fetchRows(&thread,
+            TrackTableQueryThread::Query{
+                    QStringLiteral("SELECT value FROM no_such_table"),
+                    QString(),
+                    QString()},
+            &status);
+    EXPECT_EQ(TrackTableQueryThread::Status::Failed, status);
+
+    thread.stop();
+    thread.wait();
+}
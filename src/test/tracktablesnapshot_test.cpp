@@ -0,0 +1,60 @@
+#include "library/tracktablesnapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class TrackTableSnapshotTest : public testing::Test {
+  protected:
+    QString snapshotFilePath() const {
+        return m_dir.filePath(QStringLiteral("library_snapshot.cache"));
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(TrackTableSnapshotTest, writeAndRead) {
+    TrackTableSnapshot snapshot;
+    snapshot.modelKey = QStringLiteral("table:library_view#");
+    snapshot.orderBy = QStringLiteral(";ORDER BY artist ASC");
+    snapshot.columns = QStringList{
+            QStringLiteral("id"), QStringLiteral("artist"), QStringLiteral("bpm")};
+    snapshot.rows.append(QVector<QVariant>{1, QStringLiteral("A"), 120.5});
+    snapshot.rows.append(QVector<QVariant>{2, QVariant(), 128.0});
+    ASSERT_TRUE(snapshot.write(snapshotFilePath()));
+
+    const TrackTableSnapshot restored = TrackTableSnapshot::read(snapshotFilePath());
+    EXPECT_EQ(snapshot.modelKey, restored.modelKey);
+    EXPECT_EQ(snapshot.orderBy, restored.orderBy);
+    EXPECT_EQ(snapshot.columns, restored.columns);
+    ASSERT_EQ(2, restored.rows.size());
+    EXPECT_EQ(QStringLiteral("A"), restored.rows[0][1].toString());
+    EXPECT_DOUBLE_EQ(120.5, restored.rows[0][2].toDouble());
+    // NULL values are preserved
+    EXPECT_FALSE(restored.rows[1][1].isValid());
+}
+
+TEST_F(TrackTableSnapshotTest, missingFile) {
+    EXPECT_TRUE(TrackTableSnapshot::read(snapshotFilePath()).isEmpty());
+}
+
+TEST_F(TrackTableSnapshotTest, corruptFile) {
+    QFile file(snapshotFilePath());
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("not a snapshot");
+    file.close();
+    EXPECT_TRUE(TrackTableSnapshot::read(snapshotFilePath()).isEmpty());
+}
+
+TEST_F(TrackTableSnapshotTest, rowsWithMissingColumns) {
+    TrackTableSnapshot snapshot;
+    snapshot.columns = QStringList{QStringLiteral("id"), QStringLiteral("artist")};
+    snapshot.rows.append(QVector<QVariant>{1});
+    ASSERT_TRUE(snapshot.write(snapshotFilePath()));
+    EXPECT_TRUE(TrackTableSnapshot::read(snapshotFilePath()).isEmpty());
+}
+
+} // namespace
@@ -0,0 +1,167 @@
+#include "waveform/waveform.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include "waveform/waveformfactory.h"
+
+namespace {
+
+class WaveformTest : public testing::Test {
+  protected:
+    static WaveformData scanMaxima(const Waveform& waveform,
+            int visualFrameStart,
+            int visualFrameStop,
+            int channel) {
+        WaveformData maxima{};
+        for (int frame = visualFrameStart; frame < visualFrameStop; ++frame) {
+            const WaveformData& data = waveform.get(frame * 2 + channel);
+            maxima.filtered.low = std::max(maxima.filtered.low, data.filtered.low);
+            maxima.filtered.mid = std::max(maxima.filtered.mid, data.filtered.mid);
+            maxima.filtered.high = std::max(maxima.filtered.high, data.filtered.high);
+            maxima.filtered.all = std::max(maxima.filtered.all, data.filtered.all);
+        }
+        return maxima;
+    }
+
+    static void expectEqualMaxima(const WaveformData& expected, const WaveformData& actual) {
+        EXPECT_EQ(expected.filtered.low, actual.filtered.low);
+        EXPECT_EQ(expected.filtered.mid, actual.filtered.mid);
+        EXPECT_EQ(expected.filtered.high, actual.filtered.high);
+        EXPECT_EQ(expected.filtered.all, actual.filtered.all);
+    }
+
+    static void expectEqualData(const Waveform& expected, const Waveform& actual, int stemCount) {
+        ASSERT_EQ(expected.getDataSize(), actual.getDataSize());
+        EXPECT_EQ(expected.getAudioVisualRatio(), actual.getAudioVisualRatio());
+        for (int i = 0; i < expected.getDataSize(); ++i) {
+            expectEqualMaxima(expected.get(i), actual.get(i));
+            for (int stem = 0; stem < stemCount; ++stem) {
+                EXPECT_EQ(expected.get(i).stems[stem], actual.get(i).stems[stem]);
+            }
+        }
+    }
+};
+
+TEST_F(WaveformTest, maxLevelsMatchScanningTheData) {
+    Waveform waveform(44100, 44100 * 10, 441, -1, 0);
+    const int frameCount = waveform.getDataSize() / 2;
+    ASSERT_GT(frameCount, 1000);
+
+    std::mt19937 gen; // explicitly don't seed for reproducibility
+    std::uniform_int_distribution<int> value(0, 255);
+    WaveformData* pData = waveform.data();
+    for (int i = 0; i < waveform.getDataSize(); ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(value(gen));
+        pData[i].filtered.mid = static_cast<unsigned char>(value(gen));
+        pData[i].filtered.high = static_cast<unsigned char>(value(gen));
+        pData[i].filtered.all = static_cast<unsigned char>(value(gen));
+    }
+
+    // Scanning before the levels are built
+    expectEqualMaxima(scanMaxima(waveform, 3, 700, 1), waveform.getMaxima(3, 700, 1));
+
+    waveform.buildMaxLevels();
+    std::uniform_int_distribution<int> frame(-10, frameCount + 10);
+    for (int i = 0; i < 1000; ++i) {
+        const int start = frame(gen);
+        const int stop = frame(gen);
+        for (int channel = 0; channel < 2; ++channel) {
+            expectEqualMaxima(scanMaxima(waveform,
+                                      std::max(start, 0),
+                                      std::min(stop, frameCount),
+                                      channel),
+                    waveform.getMaxima(start, stop, channel));
+        }
+    }
+    expectEqualMaxima(scanMaxima(waveform, 0, frameCount, 0),
+            waveform.getMaxima(0, frameCount, 0));
+}
+
+TEST_F(WaveformTest, packedByteArrayRoundTrip) {
+    constexpr int kStemCount = 4;
+    Waveform waveform(44100, 44100 * 10, 441, -1, kStemCount);
+    std::mt19937 gen; // explicitly don't seed for reproducibility
+    std::uniform_int_distribution<int> value(0, 255);
+    WaveformData* pData = waveform.data();
+    for (int i = 0; i < waveform.getDataSize(); ++i) {
+        // Noise in the high band, silence in the last stem and a slowly
+        // changing signal in all others
+        pData[i].filtered.low = static_cast<unsigned char>(i / 100);
+        pData[i].filtered.mid = static_cast<unsigned char>((i / 7) % 3);
+        pData[i].filtered.high = static_cast<unsigned char>(value(gen));
+        pData[i].filtered.all = static_cast<unsigned char>(i % 2 == 0 ? 200 : 10);
+        for (int stem = 0; stem < kStemCount - 1; ++stem) {
+            pData[i].stems[stem] = static_cast<unsigned char>(i / (stem + 20));
+        }
+    }
+
+    const QByteArray packed = waveform.toPackedByteArray();
+    EXPECT_TRUE(Waveform::isPackedByteArray(packed));
+    EXPECT_FALSE(Waveform::isPackedByteArray(waveform.toByteArray()));
+    // 8 columns with one byte per sample, only the noise doesn't compress
+    EXPECT_LT(packed.size(), 2 * waveform.getDataSize());
+
+    const Waveform unpacked(packed);
+    EXPECT_TRUE(unpacked.hasStem());
+    EXPECT_EQ(Waveform::SaveState::Saved, unpacked.saveState());
+    expectEqualData(waveform, unpacked, kStemCount);
+}
+
+TEST_F(WaveformTest, emptyWaveformFromCorruptPackedByteArray) {
+    Waveform waveform(44100, 44100, 441, -1, 0);
+    WaveformData* pData = waveform.data();
+    for (int i = 0; i < waveform.getDataSize(); ++i) {
+        pData[i].filtered.all = static_cast<unsigned char>(i / 10);
+    }
+    const QByteArray packed = waveform.toPackedByteArray();
+
+    for (int size : {8, 40, packed.size() / 2, packed.size() - 1}) {
+        const Waveform truncated(packed.left(size));
+        EXPECT_EQ(0, truncated.getDataSize());
+        EXPECT_EQ(Waveform::SaveState::NotSaved, truncated.saveState());
+    }
+
+    QByteArray invalidEncoding = packed;
+    // The encoding of the first column after the header
+    invalidEncoding[28] = 7;
+    EXPECT_EQ(0, Waveform(invalidEncoding).getDataSize());
+}
+
+TEST_F(WaveformTest, upgradeToPackedByteArray) {
+    EXPECT_EQ(WaveformFactory::VC_USE,
+            WaveformFactory::waveformVersionToVersionClass(
+                    WaveformFactory::currentWaveformVersion()));
+    EXPECT_EQ(WaveformFactory::VC_UPGRADE,
+            WaveformFactory::waveformVersionToVersionClass(
+                    WAVEFORM_UPGRADABLE_VERSION));
+    EXPECT_EQ(WaveformFactory::VC_UPGRADE,
+            WaveformFactory::waveformSummaryVersionToVersionClass(
+                    WAVEFORMSUMMARY_UPGRADABLE_VERSION));
+
+    Waveform waveform(44100, 44100 * 10, 441, -1, 0);
+    WaveformData* pData = waveform.data();
+    for (int i = 0; i < waveform.getDataSize(); ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(i / 3);
+        pData[i].filtered.all = static_cast<unsigned char>(i / 5);
+    }
+
+    AnalysisDao::AnalysisInfo analysis;
+    analysis.analysisId = 1;
+    analysis.type = AnalysisDao::TYPE_WAVEFORM;
+    analysis.version = WAVEFORM_UPGRADABLE_VERSION;
+    analysis.data = waveform.toByteArray();
+    const auto pUpgraded = std::unique_ptr<Waveform>(
+            WaveformFactory::upgradeWaveformFromAnalysis(&analysis));
+
+    EXPECT_EQ(WaveformFactory::currentWaveformVersion(), analysis.version);
+    EXPECT_EQ(WaveformFactory::currentWaveformDescription(), analysis.description);
+    EXPECT_TRUE(Waveform::isPackedByteArray(analysis.data));
+    expectEqualData(waveform, *pUpgraded, 0);
+    expectEqualData(waveform, Waveform(analysis.data), 0);
+}
+
+} // namespace
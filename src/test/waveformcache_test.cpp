@@ -0,0 +1,104 @@
+#include "waveform/waveformcache.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const QString kVersion = QStringLiteral("Waveform-1.0");
+const QString kSummaryVersion = QStringLiteral("WaveformSummary-1.0");
+
+class WaveformCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        // Room for the waveforms of two tracks
+        WaveformCache::initialize(2 * (waveformBytes() + summaryBytes()));
+    }
+
+    void TearDown() override {
+        WaveformCache::initialize(0);
+    }
+
+    static WaveformPointer createWaveform(int maxVisualSamples, const QString& version) {
+        auto pWaveform = WaveformPointer::create(
+                44100, 44100 * 60, 441, maxVisualSamples, 0);
+        pWaveform->setVersion(version);
+        return pWaveform;
+    }
+
+    static WaveformPointer createWaveform() {
+        return createWaveform(-1, kVersion);
+    }
+
+    static WaveformPointer createSummary() {
+        return createWaveform(2 * 1920, kSummaryVersion);
+    }
+
+    static qint64 waveformBytes() {
+        const auto pWaveform = createWaveform();
+        return (pWaveform->getTextureSize() + pWaveform->getDataSize()) *
+                static_cast<qint64>(sizeof(WaveformData));
+    }
+
+    static qint64 summaryBytes() {
+        const auto pWaveform = createSummary();
+        return (pWaveform->getTextureSize() + pWaveform->getDataSize()) *
+                static_cast<qint64>(sizeof(WaveformData));
+    }
+
+    static WaveformCache::Waveforms lookup(TrackId trackId) {
+        return WaveformCache::lookup(trackId, kVersion, kSummaryVersion);
+    }
+};
+
+TEST_F(WaveformCacheTest, retainsRecentlyUsedWaveforms) {
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+    const TrackId trackId3(QVariant(3));
+    WaveformCache::insert(trackId1, createWaveform(), createSummary());
+    WaveformCache::insert(trackId2, createWaveform(), createSummary());
+    EXPECT_EQ(2 * (waveformBytes() + summaryBytes()), WaveformCache::retainedBytes());
+
+    // Track 2 becomes the least recently used track
+    EXPECT_TRUE(lookup(trackId1).pWaveform);
+    WaveformCache::insert(trackId3, createWaveform(), createSummary());
+    EXPECT_EQ(2 * (waveformBytes() + summaryBytes()), WaveformCache::retainedBytes());
+
+    EXPECT_TRUE(lookup(trackId1).pWaveform);
+    EXPECT_TRUE(lookup(trackId1).pWaveformSummary);
+    EXPECT_FALSE(lookup(trackId2).pWaveform);
+    EXPECT_FALSE(lookup(trackId2).pWaveformSummary);
+    EXPECT_TRUE(lookup(trackId3).pWaveform);
+}
+
+TEST_F(WaveformCacheTest, sharesWaveformsInUse) {
+    const TrackId trackId1(QVariant(1));
+    const auto pWaveform = createWaveform();
+    WaveformCache::insert(trackId1, pWaveform, createSummary());
+    WaveformCache::insert(TrackId(QVariant(2)), createWaveform(), createSummary());
+    WaveformCache::insert(TrackId(QVariant(3)), createWaveform(), createSummary());
+
+    // No longer retained, but still in use
+    const auto waveforms = lookup(trackId1);
+    EXPECT_EQ(pWaveform, waveforms.pWaveform);
+    EXPECT_FALSE(waveforms.pWaveformSummary);
+}
+
+TEST_F(WaveformCacheTest, onlyReturnsMatchingVersions) {
+    const TrackId trackId(QVariant(1));
+    WaveformCache::insert(trackId, createWaveform(), createSummary());
+
+    const auto waveforms = WaveformCache::lookup(
+            trackId, QStringLiteral("Waveform-2.0"), kSummaryVersion);
+    EXPECT_FALSE(waveforms.pWaveform);
+    EXPECT_TRUE(waveforms.pWaveformSummary);
+}
+
+TEST_F(WaveformCacheTest, removeReleasesWaveforms) {
+    const TrackId trackId(QVariant(1));
+    WaveformCache::insert(trackId, createWaveform(), createSummary());
+    WaveformCache::remove(trackId);
+    EXPECT_EQ(0, WaveformCache::retainedBytes());
+    EXPECT_FALSE(lookup(trackId).pWaveform);
+}
+
+} // namespace
@@ -0,0 +1,222 @@
+#include <benchmark/benchmark.h>
+
+#include <QImage>
+#include <QPainter>
+#include <memory>
+#include <random>
+
+#include "control/controlobject.h"
+#include "track/track.h"
+#include "waveform/renderers/waveformrendererfilteredsignal.h"
+#include "waveform/renderers/waveformrendererhsv.h"
+#include "waveform/renderers/waveformrendererrgb.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/visualplayposition.h"
+#include "waveform/waveform.h"
+#ifdef MIXXX_USE_QOPENGL
+#include "waveform/renderers/allshader/waveformrendererfiltered.h"
+#include "waveform/renderers/allshader/waveformrendererhsv.h"
+#include "waveform/renderers/allshader/waveformrendererrgb.h"
+#include "waveform/renderers/allshader/waveformrenderersimple.h"
+#endif
+
+// Measures the CPU time that is needed to render a single frame of a
+// scrolling waveform, without a window or an OpenGL context. The allshader
+// renderers only generate their geometry, uploading and drawing it on the
+// GPU is not included.
+//
+// The arguments are the zoom factor and the length of the synthetic track in
+// seconds. Run with:
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_WaveformRenderer
+
+namespace {
+
+const QString kGroup = QStringLiteral("[Channel1]");
+
+constexpr int kSampleRate = 44100;
+constexpr int kVisualSampleRate = 441;
+constexpr int kWidth = 1920;
+constexpr int kHeight = 200;
+constexpr double kFramesPerSecond = 60.0;
+
+ConstWaveformPointer createWaveform(int trackSeconds) {
+    auto pWaveform = WaveformPointer::create(
+            kSampleRate,
+            static_cast<SINT>(kSampleRate) * trackSeconds,
+            kVisualSampleRate,
+            -1,
+            0);
+    std::mt19937 gen; // explicitly don't seed for reproducibility
+    std::uniform_int_distribution<int> value(0, 255);
+    WaveformData* pData = pWaveform->data();
+    for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(value(gen));
+        pData[i].filtered.mid = static_cast<unsigned char>(value(gen));
+        pData[i].filtered.high = static_cast<unsigned char>(value(gen));
+        pData[i].filtered.all = static_cast<unsigned char>(value(gen));
+    }
+    pWaveform->setCompletion(pWaveform->getDataSize());
+    return pWaveform;
+}
+
+// Provides the controls and the play position that are read by the renderers
+class WaveformRendererBenchmark {
+  public:
+    explicit WaveformRendererBenchmark(const benchmark::State& state)
+            : m_trackSeconds(static_cast<int>(state.range(1))),
+              m_rateRatio(ConfigKey(kGroup, QStringLiteral("rate_ratio"))),
+              m_totalGain(ConfigKey(kGroup, QStringLiteral("total_gain"))),
+              m_trackSamples(ConfigKey(kGroup, QStringLiteral("track_samples"))),
+              m_pVisualPlayPosition(VisualPlayPosition::getVisualPlayPosition(kGroup)),
+              m_playPosition(0.0) {
+        m_rateRatio.set(1.0);
+        m_totalGain.set(1.0);
+        m_trackSamples.set(static_cast<double>(kSampleRate) * 2 * m_trackSeconds);
+
+        m_pTrack = Track::newTemporary();
+        m_pTrack->setWaveform(createWaveform(m_trackSeconds));
+
+        m_renderer.setZoom(static_cast<double>(state.range(0)));
+    }
+
+    WaveformWidgetRenderer* renderer() {
+        return &m_renderer;
+    }
+
+    void init() {
+        m_renderer.init();
+        m_renderer.resizeRenderer(kWidth, kHeight, 1.0f);
+        m_renderer.setTrack(m_pTrack);
+    }
+
+    // Advances the play position by one frame at normal speed
+    void nextFrame() {
+        m_playPosition += 1.0 / kFramesPerSecond / m_trackSeconds;
+        if (m_playPosition >= 1.0) {
+            m_playPosition = 0.0;
+        }
+        m_pVisualPlayPosition->set(m_playPosition,
+                1.0,
+                0.0,
+                m_playPosition,
+                1.0,
+                SlipModeState::Disabled,
+                false,
+                false,
+                false,
+                0.0,
+                0.0,
+                m_trackSeconds,
+                0.0);
+        m_renderer.onPreRender(nullptr);
+    }
+
+  private:
+    const int m_trackSeconds;
+    ControlObject m_rateRatio;
+    ControlObject m_totalGain;
+    ControlObject m_trackSamples;
+    QSharedPointer<VisualPlayPosition> m_pVisualPlayPosition;
+    TrackPointer m_pTrack;
+    WaveformWidgetRenderer m_renderer{kGroup};
+    double m_playPosition;
+};
+
+void setFrameCounters(benchmark::State& state) {
+    state.counters["fps"] = benchmark::Counter(
+            static_cast<double>(state.iterations()),
+            benchmark::Counter::kIsRate);
+}
+
+// The software renderers paint on a QImage
+template<typename T_Renderer, typename... Args>
+void runSoftwareRenderer(benchmark::State& state, Args&&... args) {
+    WaveformRendererBenchmark bench(state);
+    bench.renderer()->addRenderer<T_Renderer>(std::forward<Args>(args)...);
+    bench.init();
+
+    QImage image(kWidth, kHeight, QImage::Format_ARGB32_Premultiplied);
+    for (auto _ : state) {
+        bench.nextFrame();
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        bench.renderer()->draw(&painter, nullptr);
+        painter.end();
+        benchmark::DoNotOptimize(image.constBits());
+    }
+    setFrameCounters(state);
+}
+
+void BM_WaveformRenderer_SoftwareFiltered(benchmark::State& state) {
+    runSoftwareRenderer<WaveformRendererFilteredSignal>(state);
+}
+
+void BM_WaveformRenderer_SoftwareHSV(benchmark::State& state) {
+    runSoftwareRenderer<WaveformRendererHSV>(state);
+}
+
+void BM_WaveformRenderer_SoftwareRGB(benchmark::State& state) {
+    runSoftwareRenderer<WaveformRendererRGB>(state);
+}
+
+#define WAVEFORM_RENDERER_BENCHMARK(name)                \
+    BENCHMARK(name)                                      \
+            ->ArgsProduct({{1, 3, 10}, {60, 360, 3600}}) \
+            ->ArgNames({"zoom", "seconds"})              \
+            ->Unit(benchmark::kMicrosecond)
+
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_SoftwareFiltered);
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_SoftwareHSV);
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_SoftwareRGB);
+
+#ifdef MIXXX_USE_QOPENGL
+// The allshader renderers generate the geometry of the frame in preprocess()
+template<typename T_Renderer, typename... Args>
+void runAllShaderRenderer(benchmark::State& state, Args&&... args) {
+    WaveformRendererBenchmark bench(state);
+    auto* pRenderer = bench.renderer()->addRenderer<T_Renderer>(
+            std::forward<Args>(args)...);
+    bench.init();
+
+    for (auto _ : state) {
+        bench.nextFrame();
+        pRenderer->preprocess();
+        benchmark::DoNotOptimize(pRenderer->geometry().vertexCount());
+    }
+    setFrameCounters(state);
+}
+
+// WaveformWidgetType::Simple
+void BM_WaveformRenderer_AllShaderSimple(benchmark::State& state) {
+    runAllShaderRenderer<allshader::WaveformRendererSimple>(state);
+}
+
+// WaveformWidgetType::Filtered
+void BM_WaveformRenderer_AllShaderFiltered(benchmark::State& state) {
+    runAllShaderRenderer<allshader::WaveformRendererFiltered>(state, false);
+}
+
+// WaveformWidgetType::HSV
+void BM_WaveformRenderer_AllShaderHSV(benchmark::State& state) {
+    runAllShaderRenderer<allshader::WaveformRendererHSV>(state);
+}
+
+// WaveformWidgetType::RGB
+void BM_WaveformRenderer_AllShaderRGB(benchmark::State& state) {
+    runAllShaderRenderer<allshader::WaveformRendererRGB>(state);
+}
+
+// WaveformWidgetType::Stacked
+void BM_WaveformRenderer_AllShaderStacked(benchmark::State& state) {
+    runAllShaderRenderer<allshader::WaveformRendererFiltered>(state, true);
+}
+
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_AllShaderSimple);
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_AllShaderFiltered);
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_AllShaderHSV);
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_AllShaderRGB);
+WAVEFORM_RENDERER_BENCHMARK(BM_WaveformRenderer_AllShaderStacked);
+#endif
+
+} // namespace
@@ -1,5 +1,6 @@
 #include "track/beats.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iterator>
 #include <unordered_map>
@@ -389,8 +390,9 @@ QString Beats::getVersion() const {
 bool Beats::findPrevNextBeats(audio::FramePos position,
         audio::FramePos* prevBeatPosition,
         audio::FramePos* nextBeatPosition,
-        bool snapToNearBeats) const {
-    auto it = iteratorFrom(position);
+        bool snapToNearBeats,
+        const Cursor* pCursor) const {
+    auto it = iteratorFrom(position, pCursor);
     if (it == cend()) {
         *prevBeatPosition = *it;
         *nextBeatPosition = audio::kInvalidFramePos;
@@ -428,7 +430,8 @@ bool Beats::findPrevNextBeats(audio::FramePos position,
 }
 
 // Find the next beat at or after the position
-Beats::ConstIterator Beats::iteratorFrom(audio::FramePos position) const {
+Beats::ConstIterator Beats::iteratorFrom(audio::FramePos position,
+        const Cursor* pCursor) const {
     DEBUG_ASSERT(isValid());
     auto it = cfirstmarker();
 
@@ -464,20 +467,96 @@ Beats::ConstIterator Beats::iteratorFrom(audio::FramePos position) const {
         }
         it -= static_cast<int>(n);
         it = previousIfNeeded(it, position);
+    } else if (m_markers.empty()) {
+        // Lookup position is exactly at the last marker position
+        it = clastmarker();
     } else {
-        it = std::lower_bound(cfirstmarker(), clastmarker() + 1, position);
+        it = iteratorFromMarker(findMarker(position, pCursor), position);
     }
     DEBUG_ASSERT(it == cbegin() || it == cend() || *it >= position);
     DEBUG_ASSERT(it == cbegin() || it == cend() || *it > *std::prev(it));
     return it;
 }
 
-audio::FramePos Beats::findNthBeat(audio::FramePos position, int n) const {
+bool Beats::isInMarkerSection(std::size_t markerIndex, audio::FramePos position) const {
+    if (markerIndex >= m_markers.size() || m_markers[markerIndex].position() > position) {
+        return false;
+    }
+    const auto nextMarkerPosition = (markerIndex + 1 < m_markers.size())
+            ? m_markers[markerIndex + 1].position()
+            : m_lastMarkerPosition;
+    return position < nextMarkerPosition ||
+            (markerIndex + 1 == m_markers.size() && position == nextMarkerPosition);
+}
+
+std::vector<BeatMarker>::const_iterator Beats::findMarker(
+        audio::FramePos position,
+        const Cursor* pCursor) const {
+    DEBUG_ASSERT(!m_markers.empty());
+    DEBUG_ASSERT(m_markers.front().position() <= position);
+    if (pCursor) {
+        // While playing the position usually stays in the same section or
+        // moves on to one of the adjacent sections. The index of the
+        // previous section wraps around for 0 and is rejected.
+        const std::size_t hintIndex = pCursor->m_markerIndex.load(std::memory_order_relaxed);
+        for (const std::size_t markerIndex : {hintIndex, hintIndex + 1, hintIndex - 1}) {
+            if (isInMarkerSection(markerIndex, position)) {
+                pCursor->m_markerIndex.store(markerIndex, std::memory_order_relaxed);
+                return m_markers.cbegin() + markerIndex;
+            }
+        }
+    }
+    // The last marker at or before the position
+    const auto markerIt = std::prev(std::upper_bound(m_markers.cbegin(),
+            m_markers.cend(),
+            position,
+            [](audio::FramePos position, const BeatMarker& marker) {
+                return position < marker.position();
+            }));
+    if (pCursor) {
+        pCursor->m_markerIndex.store(
+                static_cast<std::size_t>(markerIt - m_markers.cbegin()),
+                std::memory_order_relaxed);
+    }
+    return markerIt;
+}
+
+Beats::ConstIterator Beats::iteratorFromMarker(
+        std::vector<BeatMarker>::const_iterator markerIt,
+        audio::FramePos position) const {
+    DEBUG_ASSERT(markerIt != m_markers.cend());
+    DEBUG_ASSERT(markerIt->position() <= position);
+    const int beatsTillNextMarker = markerIt->beatsTillNextMarker();
+    const audio::FrameDiff_t beatLengthFrames =
+            ConstIterator(this, markerIt, 0).beatLengthFrames();
+    int beatOffset = static_cast<int>(std::min(
+            std::ceil((position - markerIt->position()) / beatLengthFrames),
+            static_cast<double>(beatsTillNextMarker)));
+    // The estimate might be off by one due to the same floating point
+    // errors as in iteratorFrom(). The beat positions are compared exactly
+    // like with a binary search over all beats.
+    while (beatOffset > 0 && *ConstIterator(this, markerIt, beatOffset - 1) >= position) {
+        beatOffset--;
+    }
+    while (beatOffset < beatsTillNextMarker &&
+            *ConstIterator(this, markerIt, beatOffset) < position) {
+        beatOffset++;
+    }
+    if (beatOffset == beatsTillNextMarker) {
+        // The first beat of the next section
+        return ConstIterator(this, std::next(markerIt), 0);
+    }
+    return ConstIterator(this, markerIt, beatOffset);
+}
+
+audio::FramePos Beats::findNthBeat(audio::FramePos position,
+        int n,
+        const Cursor* pCursor) const {
     if (n == 0) {
         return audio::kInvalidFramePos;
     }
 
-    auto it = iteratorFrom(position);
+    auto it = iteratorFrom(position, pCursor);
     const bool searchForward = n > 0;
     if (searchForward) {
         n--;
@@ -754,21 +833,24 @@ int Beats::numBeatsInRange(audio::FramePos startPosition, audio::FramePos endPos
     return i - 2;
 };
 
-audio::FramePos Beats::findNextBeat(audio::FramePos position) const {
-    return findNthBeat(position, 1);
+audio::FramePos Beats::findNextBeat(audio::FramePos position,
+        const Cursor* pCursor) const {
+    return findNthBeat(position, 1, pCursor);
 }
 
-audio::FramePos Beats::findPrevBeat(audio::FramePos position) const {
-    return findNthBeat(position, -1);
+audio::FramePos Beats::findPrevBeat(audio::FramePos position,
+        const Cursor* pCursor) const {
+    return findNthBeat(position, -1, pCursor);
 }
 
-audio::FramePos Beats::findClosestBeat(audio::FramePos position) const {
+audio::FramePos Beats::findClosestBeat(audio::FramePos position,
+        const Cursor* pCursor) const {
     if (!isValid()) {
         return audio::kInvalidFramePos;
     }
     audio::FramePos prevBeatPosition;
     audio::FramePos nextBeatPosition;
-    findPrevNextBeats(position, &prevBeatPosition, &nextBeatPosition, false);
+    findPrevNextBeats(position, &prevBeatPosition, &nextBeatPosition, false, pCursor);
     if (!prevBeatPosition.isValid()) {
         // If both positions are invalid, we correctly return an invalid position.
         return nextBeatPosition;
@@ -4,6 +4,7 @@
 #include <QList>
 #include <QString>
 #include <QVector>
+#include <atomic>
 #include <memory>
 #include <optional>
 
@@ -153,6 +154,25 @@ class Beats : private std::enable_shared_from_this<Beats> {
         int m_beatOffset;
     };
 
+    /// Remembers the tempo section, i.e. the beat marker, of the previous
+    /// lookup. Subsequent lookups in the same or an adjacent section, e.g.
+    /// for each buffer while playing, don't need to search all markers.
+    ///
+    /// The cursor is only a hint that is validated on each use. It may be
+    /// used with different Beats objects, e.g. after the beats of a deck
+    /// have been replaced, and by concurrent readers.
+    class Cursor {
+      public:
+        Cursor()
+                : m_markerIndex(0) {
+        }
+
+      private:
+        friend class Beats;
+
+        mutable std::atomic<std::size_t> m_markerIndex;
+    };
+
     Beats(std::vector<BeatMarker> markers,
             mixxx::audio::FramePos lastMarkerPosition,
             mixxx::Bpm lastMarkerBpm,
@@ -211,7 +231,9 @@ class Beats : private std::enable_shared_from_this<Beats> {
         return ConstIterator(this, m_markers.cend(), std::numeric_limits<int>::max());
     }
 
-    ConstIterator iteratorFrom(audio::FramePos position) const;
+    /// Returns an iterator pointing to the first beat at or after the position.
+    ConstIterator iteratorFrom(audio::FramePos position,
+            const Cursor* pCursor = nullptr) const;
 
     friend bool operator==(const Beats& lhs, const Beats& rhs) {
         return lhs.m_markers == rhs.m_markers &&
@@ -306,12 +328,14 @@ class Beats : private std::enable_shared_from_this<Beats> {
     /// Starting from frame position `position`, return the frame position of
     /// the next beat in the track, or an invalid position if none exists. If
     /// `position` refers to the location of a beat, `position` is returned.
-    audio::FramePos findNextBeat(audio::FramePos position) const;
+    audio::FramePos findNextBeat(audio::FramePos position,
+            const Cursor* pCursor = nullptr) const;
 
     /// Starting from frame position `position`, return the frame position of
     /// the previous beat in the track, or an invalid position if none exists.
     /// If `position` refers to the location of beat, `position` is returned.
-    audio::FramePos findPrevBeat(audio::FramePos position) const;
+    audio::FramePos findPrevBeat(audio::FramePos position,
+            const Cursor* pCursor = nullptr) const;
 
     /// Starting from frame position `position`, fill the frame position of the
     /// previous beat and next beat. Either can be invalid if none exists. If
@@ -321,7 +345,8 @@ class Beats : private std::enable_shared_from_this<Beats> {
     bool findPrevNextBeats(audio::FramePos position,
             audio::FramePos* prevBeatPosition,
             audio::FramePos* nextBeatPosition,
-            bool snapToNearBeats) const;
+            bool snapToNearBeats,
+            const Cursor* pCursor = nullptr) const;
 
     /// Return the frame position of the first beat in the track, or an invalid
     /// position if none exists.
@@ -331,7 +356,8 @@ class Beats : private std::enable_shared_from_this<Beats> {
 
     /// Starting from frame position `position`, return the frame position of
     /// the closest beat in the track, or an invalid position if none exists.
-    audio::FramePos findClosestBeat(audio::FramePos position) const;
+    audio::FramePos findClosestBeat(audio::FramePos position,
+            const Cursor* pCursor = nullptr) const;
 
     /// Find the Nth beat from frame position `position`. Works with both
     /// positive and negative values of n. Calling findNthBeat with `n=0` is
@@ -340,7 +366,9 @@ class Beats : private std::enable_shared_from_this<Beats> {
     /// `findNextBeat` and `findPrevBeat`, respectively. If `position` refers
     /// to the location of a beat, then `position` is returned. If no beat can
     /// be found, returns an invalid frame position.
-    audio::FramePos findNthBeat(audio::FramePos position, int n) const;
+    audio::FramePos findNthBeat(audio::FramePos position,
+            int n,
+            const Cursor* pCursor = nullptr) const;
 
     /// This function snaps the position to a beat if near.
     /// This is used for beat loops, where start and end positions might be slightly off
@@ -436,6 +464,19 @@ class Beats : private std::enable_shared_from_this<Beats> {
     mixxx::audio::FrameDiff_t firstBeatLengthFrames() const;
     mixxx::audio::FrameDiff_t lastBeatLengthFrames() const;
 
+    /// The marker of the tempo section that contains the position, which
+    /// must be between the first and the last marker.
+    std::vector<BeatMarker>::const_iterator findMarker(
+            audio::FramePos position,
+            const Cursor* pCursor) const;
+    bool isInMarkerSection(std::size_t markerIndex, audio::FramePos position) const;
+
+    /// The first beat at or after the position within the tempo section of
+    /// the marker.
+    ConstIterator iteratorFromMarker(
+            std::vector<BeatMarker>::const_iterator markerIt,
+            audio::FramePos position) const;
+
     std::vector<BeatMarker> m_markers;
     mixxx::audio::FramePos m_lastMarkerPosition;
     mixxx::Bpm m_lastMarkerBpm;
@@ -1,6 +1,8 @@
 #include "track/globaltrackcache.h"
 
 #include <QCoreApplication>
+#include <QThread>
+#include <algorithm>
 
 #include "moc_globaltrackcache.cpp"
 #include "track/track.h"
@@ -151,6 +153,12 @@ QSet<TrackId> GlobalTrackCacheLocker::getCachedTrackIds() const {
     return m_pInstance->getCachedTrackIds();
 }
 
+QList<TrackPointer> GlobalTrackCacheLocker::lookupTracksByIds(
+        const QSet<TrackId>& trackIds) const {
+    DEBUG_ASSERT(m_pInstance);
+    return m_pInstance->lookupByIds(trackIds);
+}
+
 GlobalTrackCacheResolver::GlobalTrackCacheResolver(
         mixxx::FileAccess fileAccess,
         bool temporary)
@@ -179,10 +187,10 @@ GlobalTrackCacheResolver::~GlobalTrackCacheResolver() {
         // Will be released by the parent class destructor
         // ~GlobalTrackCacheLocker().
         m_pInstance->m_mutex.lock();
-        // Only one GlobalTrackCacheResolver has access to the unique
-        // incomplete Track. Others are suspended during construction.
+        // Only this GlobalTrackCacheResolver has access to its incomplete
+        // Track. Lookups of the same track are suspended until then.
         // This call wakes them up.
-        m_pInstance->discardIncompleteTrack();
+        m_pInstance->discardIncompleteTrack(m_strongPtr);
     }
 }
 
@@ -427,9 +435,53 @@ bool GlobalTrackCache::isEmpty() const {
     return m_tracksById.empty() && m_tracksByCanonicalLocation.empty();
 }
 
+bool GlobalTrackCache::isIncompleteTrackId(const TrackId& trackId) const {
+    for (const auto& incompleteTrack : m_incompleteTracks) {
+        if (incompleteTrack.pTrack->getId() == trackId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GlobalTrackCache::isIncompleteTrackCanonicalLocation(
+        const QString& canonicalLocation) const {
+    for (const auto& incompleteTrack : m_incompleteTracks) {
+        if (incompleteTrack.pTrack->getFileInfo().canonicalLocationPath() ==
+                canonicalLocation) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GlobalTrackCache::hasIncompleteTrackOfCurrentThread() const {
+    const Qt::HANDLE threadId = QThread::currentThreadId();
+    for (const auto& incompleteTrack : m_incompleteTracks) {
+        if (incompleteTrack.threadId == threadId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GlobalTrackCache::waitForIncompleteTrack() {
+    if (hasIncompleteTrackOfCurrentThread()) {
+        // The track might be completed by another resolver that waits
+        // for the incomplete track of this thread, or even by this thread
+        // itself. Neither would ever finish.
+        kLogger.warning()
+                << "Not waiting for the completion of a track while"
+                << "the resolver of another track on this thread is pending";
+        return false;
+    }
+    m_isTrackCompleted.wait(&m_mutex);
+    return true;
+}
+
 TrackPointer GlobalTrackCache::lookupById(
         const TrackId& trackId) {
-    while (m_incompleteTrack && m_incompleteTrack->getId() == trackId) {
+    while (isIncompleteTrackId(trackId)) {
         // The requested track is currently locked by another thread
         // (despite us currently owning the global track cache lock aka. m_mutex).
         //
@@ -439,7 +491,12 @@ TrackPointer GlobalTrackCache::lookupById(
         //
         // Release the global lock, wait until the asynchronous loading
         // has completed; afterwards, reacquire the global lock and continue.
-        m_isTrackCompleted.wait(&m_mutex);
+        //
+        // If this thread has a pending resolver itself, the incomplete
+        // track is returned instead.
+        if (!waitForIncompleteTrack()) {
+            break;
+        }
     }
 
     TrackPointer trackPtr;
@@ -492,12 +549,13 @@ TrackPointer GlobalTrackCache::lookupByRef(
 
 TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
         const QString& canonicalLocation) {
-    while (m_incompleteTrack &&
-            m_incompleteTrack->getFileInfo().canonicalLocationPath() == canonicalLocation) {
+    while (isIncompleteTrackCanonicalLocation(canonicalLocation)) {
         // See GlobalTrackCache::lookupById for the comment on how
         // the synchronization with the background metadata loader
         // thread works.
-        m_isTrackCompleted.wait(&m_mutex);
+        if (!waitForIncompleteTrack()) {
+            break;
+        }
     }
 
     TrackPointer trackPtr;
@@ -532,6 +590,19 @@ QSet<TrackId> GlobalTrackCache::getCachedTrackIds() const {
     return trackIds;
 }
 
+QList<TrackPointer> GlobalTrackCache::lookupByIds(
+        const QSet<TrackId>& trackIds) {
+    QList<TrackPointer> tracks;
+    tracks.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        auto trackPtr = lookupById(trackId);
+        if (trackPtr) {
+            tracks.append(std::move(trackPtr));
+        }
+    }
+    return tracks;
+}
+
 TrackPointer GlobalTrackCache::revive(
         GlobalTrackCacheEntryPointer entryPtr) {
 
@@ -694,17 +765,12 @@ void GlobalTrackCache::resolve(
     // created object to the main thread.
     savingPtr->moveToThread(QCoreApplication::instance()->thread());
 
-    // Check if someone else is currently busy loading track metadata
-    // in the background, and wait until they are done.
+    // Lookups of this track will wait until the metadata has been loaded
+    // in the background. Resolving other tracks is not affected.
     //
     // See GlobalTrackCache::lookupById for more information on how
     // the locking is implemented.
-    while (m_incompleteTrack) {
-        // Wait for completion.
-        m_isTrackCompleted.wait(&m_mutex);
-        // now the track should be empty
-    }
-    m_incompleteTrack = savingPtr;
+    addIncompleteTrack(savingPtr);
 
     pCacheResolver->initLookupResult(
             GlobalTrackCacheLookupResult::Miss,
@@ -745,17 +811,8 @@ void GlobalTrackCache::resolveTemporary(
     }
 
     pTrack = Track::newTemporary(std::move(fileAccess));
-    // Check if someone else is currently busy loading track metadata
-    // in the background, and wait until they are done.
-    //
-    // See GlobalTrackCache::lookupById for more information on how
-    // the locking is implemented.
-    while (m_incompleteTrack) {
-        // Wait for completion.
-        m_isTrackCompleted.wait(&m_mutex);
-        // now the track should be empty
-    }
-    m_incompleteTrack = pTrack;
+    // See GlobalTrackCache::resolve()
+    addIncompleteTrack(pTrack);
     pCacheResolver->initLookupResult(
             GlobalTrackCacheLookupResult::Miss,
             std::move(pTrack),
@@ -775,9 +832,8 @@ TrackRef GlobalTrackCache::initTrackId(
     EvictAndSaveFunctor* pDel = std::get_deleter<EvictAndSaveFunctor>(strongPtr);
     DEBUG_ASSERT(pDel);
 
-    DEBUG_ASSERT(strongPtr == m_incompleteTrack);
-    m_incompleteTrack = nullptr;
-    m_isTrackCompleted.wakeAll();
+    DEBUG_ASSERT(findIncompleteTrack(strongPtr) != m_incompleteTracks.end());
+    discardIncompleteTrack(strongPtr);
 
     // Insert item by id
     DEBUG_ASSERT(m_tracksById.find(trackId) == m_tracksById.end());
@@ -792,8 +848,33 @@ TrackRef GlobalTrackCache::initTrackId(
     return trackRefWithId;
 }
 
-void GlobalTrackCache::discardIncompleteTrack() {
-    m_incompleteTrack = nullptr;
+std::vector<GlobalTrackCache::IncompleteTrack>::const_iterator
+GlobalTrackCache::findIncompleteTrack(const TrackPointer& strongPtr) const {
+    return std::find_if(m_incompleteTracks.cbegin(),
+            m_incompleteTracks.cend(),
+            [&strongPtr](const IncompleteTrack& incompleteTrack) {
+                return incompleteTrack.pTrack == strongPtr;
+            });
+}
+
+void GlobalTrackCache::addIncompleteTrack(TrackPointer strongPtr) {
+    DEBUG_ASSERT(strongPtr);
+    DEBUG_ASSERT(findIncompleteTrack(strongPtr) == m_incompleteTracks.end());
+    m_incompleteTracks.push_back(IncompleteTrack{
+            std::move(strongPtr), QThread::currentThreadId()});
+}
+
+void GlobalTrackCache::discardIncompleteTrack(const TrackPointer& strongPtr) {
+    if (!strongPtr) {
+        return;
+    }
+    const auto i = findIncompleteTrack(strongPtr);
+    if (i == m_incompleteTracks.end()) {
+        // Either a cache hit or the track has already been
+        // completed by initTrackId()
+        return;
+    }
+    m_incompleteTracks.erase(i);
     m_isTrackCompleted.wakeAll();
 }
 
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <QList>
 #include <QWaitCondition>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "track/track_decl.h"
 #include "track/trackref.h"
@@ -114,6 +116,13 @@ public:
             const TrackRef& trackRef) const;
     QSet<TrackId> getCachedTrackIds() const;
 
+    /// Lookup multiple existing Track objects while holding the lock
+    /// only once instead of once per track. Ids of tracks that are not
+    /// cached are skipped, i.e. the results might contain fewer tracks
+    /// than requested.
+    QList<TrackPointer> lookupTracksByIds(
+            const QSet<TrackId>& trackIds) const;
+
   private:
     void lockCache();
 
@@ -243,6 +252,17 @@ class GlobalTrackCache : public QObject {
 
     QSet<TrackId> getCachedTrackIds() const;
 
+    QList<TrackPointer> lookupByIds(
+            const QSet<TrackId>& trackIds);
+
+    bool isIncompleteTrackId(const TrackId& trackId) const;
+    bool isIncompleteTrackCanonicalLocation(const QString& canonicalLocation) const;
+    bool hasIncompleteTrackOfCurrentThread() const;
+    /// Waits until one of the incomplete tracks has been completed. Returns
+    /// false without waiting if the calling thread has an incomplete track
+    /// itself, see m_incompleteTracks.
+    bool waitForIncompleteTrack();
+
     TrackPointer revive(GlobalTrackCacheEntryPointer entryPtr);
 
     void resolve(
@@ -259,7 +279,16 @@ class GlobalTrackCache : public QObject {
             const TrackRef& trackRef,
             TrackId trackId);
 
-    void discardIncompleteTrack();
+    struct IncompleteTrack {
+        TrackPointer pTrack;
+        // The thread of the GlobalTrackCacheResolver
+        Qt::HANDLE threadId;
+    };
+
+    std::vector<IncompleteTrack>::const_iterator findIncompleteTrack(
+            const TrackPointer& strongPtr) const;
+    void addIncompleteTrack(TrackPointer strongPtr);
+    void discardIncompleteTrack(const TrackPointer& strongPtr);
 
     void purgeTrackId(TrackId trackId);
 
@@ -280,9 +309,17 @@ class GlobalTrackCache : public QObject {
     deleteTrackFn_t m_deleteTrackFn;
 
     // Managed by GlobalTrackCacheResolver.
-    // The track that is currently locked by the asynchronous metadata loader background thread.
-    // m_isTrackCompleted will be signaled once the asynchronous loading has been completed.
-    TrackPointer m_incompleteTrack;
+    // The tracks that are currently locked by asynchronous metadata loader
+    // background threads, one per pending GlobalTrackCacheResolver.
+    // m_isTrackCompleted will be signaled whenever one of them has
+    // been completed. Only lookups for one of these tracks need to wait,
+    // all other lookups and resolvers proceed without blocking.
+    //
+    // A thread never waits while it has an incomplete track itself. Two
+    // threads that resolve each other's incomplete track would otherwise
+    // wait for each other forever. These lookups return the incomplete
+    // track instead, as a cache hit.
+    std::vector<IncompleteTrack> m_incompleteTracks;
     QWaitCondition m_isTrackCompleted;
 
     // This caches the unsaved Tracks by ID
@@ -338,8 +338,9 @@ bool SeratoBeatGrid::parseBase64Encoded(
         return true;
     }
     char extraBase64Byte = base64EncodedData.at(base64EncodedData.size() - 1);
-    const auto decodedData = QByteArray::fromBase64(
-            base64EncodedData.left(base64EncodedData.size() - 1));
+    // Decoded from a view without the extra byte
+    const auto decodedData = QByteArray::fromBase64(QByteArray::fromRawData(
+            base64EncodedData.constData(), base64EncodedData.size() - 1));
     if (!decodedData.startsWith(kSeratoBeatGridBase64EncodedPrefix)) {
         kLogger.warning() << "Decoding SeratoBeatGrid from base64 failed:"
                           << "Unexpected prefix"
@@ -351,7 +352,9 @@ bool SeratoBeatGrid::parseBase64Encoded(
     DEBUG_ASSERT(decodedData.size() >= kSeratoBeatGridBase64EncodedPrefix.size());
     if (!parseID3(
                 seratoBeatGrid,
-                decodedData.mid(kSeratoBeatGridBase64EncodedPrefix.size()))) {
+                QByteArray::fromRawData(
+                        decodedData.constData() + kSeratoBeatGridBase64EncodedPrefix.size(),
+                        decodedData.size() - kSeratoBeatGridBase64EncodedPrefix.size()))) {
         kLogger.warning() << "Parsing base64encoded SeratoBeatGrid failed!";
         return false;
     }
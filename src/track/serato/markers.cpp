@@ -372,7 +372,7 @@ bool SeratoMarkers::parseID3(
             return false;
         }
 
-        QByteArray entryData = QByteArray(buffer, kEntrySizeID3);
+        const auto entryData = QByteArray::fromRawData(buffer, kEntrySizeID3);
         SeratoMarkersEntryPointer pEntry =
                 SeratoMarkersEntryPointer(SeratoMarkersEntry::parseID3(entryData));
         if (!pEntry) {
@@ -443,7 +443,9 @@ bool SeratoMarkers::parseMP4(
         return false;
     }
 
-    QDataStream stream(decodedData.mid(kSeratoMarkersBase64EncodedPrefix.length()));
+    QDataStream stream(QByteArray::fromRawData(
+            decodedData.constData() + kSeratoMarkersBase64EncodedPrefix.size(),
+            decodedData.size() - kSeratoMarkersBase64EncodedPrefix.size()));
     stream.setByteOrder(QDataStream::BigEndian);
 
     quint16 version;
@@ -473,7 +475,7 @@ bool SeratoMarkers::parseMP4(
             return false;
         }
 
-        QByteArray entryData = QByteArray(buffer, kEntrySizeMP4);
+        const auto entryData = QByteArray::fromRawData(buffer, kEntrySizeMP4);
         SeratoMarkersEntryPointer pEntry =
                 SeratoMarkersEntryPointer(SeratoMarkersEntry::parseMP4(entryData));
         if (!pEntry) {
@@ -1,6 +1,7 @@
 #include "track/serato/markers2.h"
 
 #include <QtEndian>
+#include <algorithm>
 
 #include "util/logger.h"
 
@@ -382,7 +383,9 @@ bool SeratoMarkers2::parseID3(
         return false;
     }
 
-    if (!parseCommon(seratoMarkers2, outerData.mid(2))) {
+    if (!parseCommon(seratoMarkers2,
+                QByteArray::fromRawData(
+                        outerData.constData() + 2, outerData.size() - 2))) {
         return false;
     }
 
@@ -403,11 +406,14 @@ bool SeratoMarkers2::parseCommon(
 
     QList<std::shared_ptr<SeratoMarkers2Entry>> entries;
 
+    // The entries are parsed from views into the decoded data without
+    // copying it. Only the data of unknown entries is kept.
     int offset = 2;
     int entryTypeEndPos;
     while ((entryTypeEndPos = data.indexOf('\x00', offset)) >= 0) {
         // Entry Name
-        QString entryType(data.mid(offset, entryTypeEndPos - offset));
+        const auto entryType = QByteArray::fromRawData(
+                data.constData() + offset, entryTypeEndPos - offset);
         offset = entryTypeEndPos + 1;
 
         if (entryType.isEmpty()) {
@@ -421,24 +427,33 @@ bool SeratoMarkers2::parseCommon(
         }
 
         // Entry Size
-        auto entrySize = qFromBigEndian<quint32>(data.mid(offset, 4));
+        if (data.size() - offset < 4) {
+            kLogger.warning() << "Parsing SeratoMarkers2 failed:"
+                              << "Missing size of entry of type" << entryType;
+            return false;
+        }
+        const auto entrySize = qFromBigEndian<quint32>(data.constData() + offset);
         offset += 4;
 
-        QByteArray entryData = data.mid(offset, entrySize);
+        const auto entryData = QByteArray::fromRawData(data.constData() + offset,
+                std::min<qsizetype>(entrySize, data.size() - offset));
         offset += entrySize;
 
         // Entry Content
         SeratoMarkers2EntryPointer pEntry;
-        if (entryType.compare("BPMLOCK") == 0) {
+        if (entryType == "BPMLOCK") {
             pEntry = SeratoMarkers2BpmLockEntry::parse(entryData);
-        } else if (entryType.compare("COLOR") == 0) {
+        } else if (entryType == "COLOR") {
             pEntry = SeratoMarkers2ColorEntry::parse(entryData);
-        } else if (entryType.compare("CUE") == 0) {
+        } else if (entryType == "CUE") {
             pEntry = SeratoMarkers2CueEntry::parse(entryData);
-        } else if (entryType.compare("LOOP") == 0) {
+        } else if (entryType == "LOOP") {
             pEntry = SeratoMarkers2LoopEntry::parse(entryData);
         } else {
-            pEntry = SeratoMarkers2EntryPointer(new SeratoMarkers2UnknownEntry(entryType, entryData));
+            // Detach from the decoded data
+            pEntry = SeratoMarkers2EntryPointer(new SeratoMarkers2UnknownEntry(
+                    QString::fromUtf8(entryType),
+                    QByteArray(entryData.constData(), entryData.size())));
             kLogger.trace() << "SeratoMarkers2UnknownEntry" << *pEntry;
         }
 
@@ -471,7 +486,9 @@ bool SeratoMarkers2::parseBase64Encoded(
     DEBUG_ASSERT(decodedData.size() >= kSeratoMarkers2Base64EncodedPrefix.size());
     if (!parseID3(
                 seratoMarkers2,
-                decodedData.mid(kSeratoMarkers2Base64EncodedPrefix.size()))) {
+                QByteArray::fromRawData(
+                        decodedData.constData() + kSeratoMarkers2Base64EncodedPrefix.size(),
+                        decodedData.size() - kSeratoMarkers2Base64EncodedPrefix.size()))) {
         kLogger.warning() << "Parsing base64encoded SeratoMarkers2 failed!";
         return false;
     }
@@ -1,5 +1,7 @@
 #include "track/taglib/trackmetadata_common.h"
 
+#include <deque>
+
 #include "track/tracknumbers.h"
 #include "util/assert.h"
 #include "util/logger.h"
@@ -10,6 +12,25 @@ namespace {
 
 Logger kLogger("TagLib");
 
+// Decoded images are large, only a few are kept. The cache lives as
+// long as its thread, so the memory of all images is bounded, too.
+constexpr std::size_t kDecodedImageCacheCapacity = 2;
+constexpr qint64 kDecodedImageCacheMaxBytes = 8 * 1024 * 1024;
+
+struct DecodedImage {
+    QByteArray imageData;
+    QByteArray format;
+    QImage image;
+
+    qint64 sizeInBytes() const {
+        return static_cast<qint64>(image.sizeInBytes()) + imageData.size();
+    }
+};
+
+// Most recently used first
+thread_local std::deque<DecodedImage> t_decodedImages;
+thread_local qint64 t_decodedImageBytes = 0;
+
 bool parseReplayGainGain(
         gsl::not_null<ReplayGain*> pReplayGain,
         const QString& dbGain,
@@ -339,6 +360,46 @@ void exportTrackMetadataIntoTag(
     }
 }
 
+QImage loadImageFromByteVector(
+        const TagLib::ByteVector& imageData,
+        const char* format) {
+    const auto data = QByteArray::fromRawData(imageData.data(), imageData.size());
+    const auto formatName = QByteArray(format);
+    for (auto i = t_decodedImages.begin(); i != t_decodedImages.end(); ++i) {
+        if (i->imageData == data && i->format == formatName) {
+            const QImage image = i->image;
+            if (i != t_decodedImages.begin()) {
+                auto decodedImage = std::move(*i);
+                t_decodedImages.erase(i);
+                t_decodedImages.push_front(std::move(decodedImage));
+            }
+            return image;
+        }
+    }
+    const QImage image = QImage::fromData(
+            // char -> uchar
+            reinterpret_cast<const uchar*>(imageData.data()),
+            imageData.size(),
+            format);
+    if (image.isNull() ||
+            static_cast<qint64>(image.sizeInBytes()) + data.size() >
+                    kDecodedImageCacheMaxBytes) {
+        return image;
+    }
+    // Deep copy, the data is owned by the tag
+    t_decodedImages.push_front(DecodedImage{
+            QByteArray(imageData.data(), imageData.size()),
+            formatName,
+            image});
+    t_decodedImageBytes += t_decodedImages.front().sizeInBytes();
+    while (t_decodedImages.size() > kDecodedImageCacheCapacity ||
+            t_decodedImageBytes > kDecodedImageCacheMaxBytes) {
+        t_decodedImageBytes -= t_decodedImages.back().sizeInBytes();
+        t_decodedImages.pop_back();
+    }
+    return image;
+}
+
 } // namespace taglib
 
 } // namespace mixxx
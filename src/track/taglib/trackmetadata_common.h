@@ -171,15 +171,16 @@ TagLib::String dumpSeratoMarkers2(
         const TrackMetadata& trackMetadata,
         FileType fileType);
 
-inline QImage loadImageFromByteVector(
+/// Decodes an embedded image.
+///
+/// The most recently decoded images of the calling thread are reused
+/// if the encoded data is identical. The tracks of an album usually
+/// embed the same cover image, which is then only decoded once. Only
+/// a few megabytes of images are kept per thread, larger ones are
+/// always decoded.
+QImage loadImageFromByteVector(
         const TagLib::ByteVector& imageData,
-        const char* format = nullptr) {
-    return QImage::fromData(
-            // char -> uchar
-            reinterpret_cast<const uchar*>(imageData.data()),
-            imageData.size(),
-            format);
-}
+        const char* format = nullptr);
 
 /// Bitmask of optional tag fields that should NOT be read from the
 /// common part of the tag through TagLib::Tag.
@@ -102,6 +102,31 @@ Track::Track(
                 << numberOfInstancesBefore + 1;
     }
     m_beatChangeTimer.start();
+
+    // Connected before any other receiver, i.e. the snapshot is up to date
+    // when they are notified. Direct connections, because the signals are
+    // emitted in the thread that has modified the track.
+    connect(this,
+            &Track::beatsUpdated,
+            this,
+            &Track::slotPublishEngineSnapshot,
+            Qt::DirectConnection);
+    connect(this,
+            &Track::cuesUpdated,
+            this,
+            &Track::slotPublishEngineSnapshot,
+            Qt::DirectConnection);
+    connect(this,
+            &Track::keyChanged,
+            this,
+            &Track::slotPublishEngineSnapshot,
+            Qt::DirectConnection);
+    connect(this,
+            &Track::replayGainUpdated,
+            this,
+            &Track::slotPublishEngineSnapshot,
+            Qt::DirectConnection);
+    slotPublishEngineSnapshot();
 }
 
 Track::~Track() {
@@ -309,6 +334,7 @@ bool Track::replaceRecord(
     const auto oldReplayGain = m_record.getMetadata().getTrackInfo().getReplayGain();
     const auto oldColor = m_record.getColor();
     const auto oldRating = m_record.getRating();
+    const bool keysUpdated = m_record.getKeys() != newRecord.getKeys();
 
     bool bpmUpdatedFlag;
     if (pOptionalBeats) {
@@ -335,6 +361,10 @@ bool Track::replaceRecord(
     if (bpmUpdatedFlag) {
         emit beatsUpdated();
     }
+    if (keysUpdated) {
+        // Publishes the key in the engine snapshot
+        emit keyChanged();
+    }
     if (oldReplayGain != newReplayGain) {
         emit replayGainUpdated(newReplayGain);
     }
@@ -537,7 +567,6 @@ void Track::emitChangedSignalsForAllMetadata() {
     emit timesPlayedChanged();
     emit durationChanged();
     emit infoChanged();
-    emit keyChanged();
 }
 
 bool Track::checkSourceSynchronized() const {
@@ -918,6 +947,18 @@ QString Track::getURL() const {
     return m_record.getUrl();
 }
 
+void Track::setFingerprint(const QString& fingerprint) {
+    auto locked = lockMutex(&m_qMutex);
+    if (compareAndSet(m_record.ptrFingerprint(), fingerprint)) {
+        markDirtyAndUnlock(&locked);
+    }
+}
+
+QString Track::getFingerprint() const {
+    const auto locked = lockMutex(&m_qMutex);
+    return m_record.getFingerprint();
+}
+
 const ConstWaveformPointer& Track::getWaveform() const {
     return m_waveform;
 }
@@ -1070,6 +1111,33 @@ void Track::slotCueUpdated() {
     emit cuesUpdated();
 }
 
+void Track::slotPublishEngineSnapshot() {
+    auto pSnapshot = std::make_shared<mixxx::TrackEngineSnapshot>();
+    {
+        const auto locked = lockMutex(&m_qMutex);
+        pSnapshot->pBeats = m_pBeats;
+        pSnapshot->cues.reserve(m_cuePoints.size());
+        for (const auto& pCue : std::as_const(m_cuePoints)) {
+            const auto positions = pCue->getStartAndEndPosition();
+            pSnapshot->cues.append(mixxx::CueSnapshot{
+                    pCue->getType(),
+                    positions.startPosition,
+                    positions.endPosition,
+                    pCue->getHotCue(),
+                    pCue->getColor(),
+                    pCue->getLabel(),
+                    pCue.get()});
+        }
+        pSnapshot->key = m_record.getKeys().getGlobalKey();
+        pSnapshot->replayGain = m_record.getMetadata().getTrackInfo().getReplayGain();
+    }
+    // Ordering the cues does not need to block the track
+    pSnapshot->sortCues();
+    // Replacing the previous snapshot is the only write, readers that
+    // still hold it keep it alive until they are done
+    m_engineSnapshot.setValue(std::move(pSnapshot));
+}
+
 CuePointer Track::createAndAddCue(
         mixxx::CueType type,
         int hotCueIndex,
@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "audio/streaminfo.h"
+#include "control/controlvalue.h"
 #include "sources/metadatasource.h"
 #include "track/beats.h"
 #include "track/cue.h"
@@ -16,6 +17,7 @@
 #include "track/steminfoimporter.h"
 #endif
 #include "track/track_decl.h"
+#include "track/trackenginesnapshot.h"
 #include "track/trackrecord.h"
 #include "util/color/predefinedcolorpalettes.h"
 #include "util/compatibility/qmutex.h"
@@ -91,6 +93,10 @@ class Track : public QObject {
         return m_fileAccess.info();
     }
 
+    mixxx::FileAccess getFileAccess() const {
+        return m_fileAccess;
+    }
+
     TrackId getId() const;
 
     // Returns absolute path to the file, including the filename.
@@ -272,6 +278,10 @@ class Track : public QObject {
     QString getURL() const;
     void setURL(const QString& url);
 
+    // The Chromaprint fingerprint for AcoustID lookups
+    QString getFingerprint() const;
+    void setFingerprint(const QString& fingerprint);
+
     /// Separator between artist and title string that is
     /// used for composing the track info.
     static const QString kArtistTitleSeparator;
@@ -451,6 +461,15 @@ class Track : public QObject {
         return m_record.hasStreamInfoFromSource();
     }
 
+    /// The most recently published snapshot of the beats, cues, key and
+    /// ReplayGain. Wait-free and never contends with modifications of the
+    /// track, i.e. it is safe to be called from the engine threads. The
+    /// snapshot is replaced before the corresponding change signals are
+    /// received by any other receiver.
+    mixxx::TrackEngineSnapshotPointer getEngineSnapshot() const {
+        return m_engineSnapshot.getValue();
+    }
+
   signals:
     void artistChanged(const QString&);
     void titleChanged(const QString&);
@@ -496,6 +515,7 @@ class Track : public QObject {
 
   private slots:
     void slotCueUpdated();
+    void slotPublishEngineSnapshot();
 
   private:
     /// Set a unique identifier for the track.
@@ -624,6 +644,9 @@ class Track : public QObject {
     mixxx::BeatsImporterPointer m_pBeatsImporterPending;
     std::unique_ptr<mixxx::CueInfoImporter> m_pCueInfoImporterPending;
 
+    // Published by slotPublishEngineSnapshot() for lock-free readers
+    ControlValueAtomic<mixxx::TrackEngineSnapshotPointer> m_engineSnapshot;
+
     friend class TrackDAO;
     void setHeaderParsedFromTrackDAO(bool headerParsed) {
         // Always operating on a newly created, exclusive instance! No need
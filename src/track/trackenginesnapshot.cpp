@@ -0,0 +1,66 @@
+#include "track/trackenginesnapshot.h"
+
+#include <algorithm>
+
+namespace mixxx {
+
+namespace {
+
+bool hasValidStartPosition(const CueSnapshot& cue) {
+    return cue.startPosition.isValid();
+}
+
+} // anonymous namespace
+
+void TrackEngineSnapshot::sortCues() {
+    // Invalid positions do not compare, so they are moved out of the way
+    // before sorting
+    const auto validEnd = std::stable_partition(
+            cues.begin(), cues.end(), hasValidStartPosition);
+    std::stable_sort(cues.begin(),
+            validEnd,
+            [](const CueSnapshot& lhs, const CueSnapshot& rhs) {
+                return lhs.startPosition < rhs.startPosition;
+            });
+    const int validCueCount = static_cast<int>(validEnd - cues.begin());
+
+    for (auto& positions : m_startPositionsByType) {
+        positions.clear();
+    }
+    for (int i = 0; i < validCueCount; ++i) {
+        const auto index = static_cast<std::size_t>(cues[i].type);
+        VERIFY_OR_DEBUG_ASSERT(index < m_startPositionsByType.size()) {
+            continue;
+        }
+        // Already in ascending order
+        m_startPositionsByType[index].append(cues[i].startPosition);
+    }
+}
+
+audio::FramePos TrackEngineSnapshot::findPrevCuePosition(
+        CueType type, audio::FramePos position) const {
+    VERIFY_OR_DEBUG_ASSERT(position.isValid()) {
+        return audio::kInvalidFramePos;
+    }
+    const auto& positions = startPositions(type);
+    const auto it = std::lower_bound(positions.cbegin(), positions.cend(), position);
+    if (it == positions.cbegin()) {
+        return audio::kInvalidFramePos;
+    }
+    return *(it - 1);
+}
+
+audio::FramePos TrackEngineSnapshot::findNextCuePosition(
+        CueType type, audio::FramePos position) const {
+    VERIFY_OR_DEBUG_ASSERT(position.isValid()) {
+        return audio::kInvalidFramePos;
+    }
+    const auto& positions = startPositions(type);
+    const auto it = std::upper_bound(positions.cbegin(), positions.cend(), position);
+    if (it == positions.cend()) {
+        return audio::kInvalidFramePos;
+    }
+    return *it;
+}
+
+} // namespace mixxx
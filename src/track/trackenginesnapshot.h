@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <array>
+#include <memory>
+
+#include "audio/frame.h"
+#include "proto/keys.pb.h"
+#include "track/beats.h"
+#include "track/cueinfo.h"
+#include "track/replaygain.h"
+#include "util/assert.h"
+#include "util/color/rgbcolor.h"
+
+class Cue;
+
+namespace mixxx {
+
+/// The properties of a cue point at the time the snapshot has been taken.
+struct CueSnapshot {
+    CueType type;
+    audio::FramePos startPosition;
+    audio::FramePos endPosition;
+    int hotCueIndex;
+    RgbColor color;
+    QString label;
+    /// Identifies the cue, e.g. to find out if a hot cue has been replaced.
+    /// Must not be dereferenced, because the cue might have been removed
+    /// from the track and deleted.
+    const Cue* pCue;
+};
+
+/// An immutable copy of the properties of a track that are read by the
+/// engine and the waveforms, i.e. the beats, cues, key and ReplayGain.
+///
+/// A new snapshot is published by the track whenever one of these properties
+/// has changed. Snapshots are shared and never modified, readers neither need
+/// to lock the track nor the individual cues.
+///
+/// The cues are ordered by their start position and indexed by type once
+/// when publishing the snapshot, so that finding the cues around the play
+/// position is a binary search.
+struct TrackEngineSnapshot {
+    BeatsPointer pBeats;
+    /// Ordered by start position, cues without a valid start position
+    /// are placed at the end.
+    QVector<CueSnapshot> cues;
+    track::io::key::ChromaticKey key = track::io::key::INVALID;
+    ReplayGain replayGain;
+
+    /// Orders the cues and builds the index by type. Must be invoked
+    /// after all cues have been added and before publishing the snapshot.
+    void sortCues();
+
+    /// The valid start positions of all cues of this type in ascending order.
+    /// Saved loops have their own type, i.e. CueType::HotCue only contains
+    /// the hot cues that are no loops.
+    const QVector<audio::FramePos>& startPositions(CueType type) const {
+        const auto index = static_cast<std::size_t>(type);
+        VERIFY_OR_DEBUG_ASSERT(index < m_startPositionsByType.size()) {
+            return m_startPositionsByType[static_cast<std::size_t>(CueType::Invalid)];
+        }
+        return m_startPositionsByType[index];
+    }
+
+    /// Returns the start position of the last cue of this type before
+    /// the given position or an invalid position if there is none.
+    audio::FramePos findPrevCuePosition(CueType type, audio::FramePos position) const;
+
+    /// Returns the start position of the first cue of this type after
+    /// the given position or an invalid position if there is none.
+    audio::FramePos findNextCuePosition(CueType type, audio::FramePos position) const;
+
+    /// Returns nullptr if there is no cue of this type. Cannot be used for
+    /// hot cues.
+    const CueSnapshot* findCueByType(CueType type) const {
+        for (const auto& cue : cues) {
+            if (cue.type == type) {
+                return &cue;
+            }
+        }
+        return nullptr;
+    }
+
+  private:
+    // Indexed by CueType
+    std::array<QVector<audio::FramePos>, static_cast<std::size_t>(CueType::N60dBSound) + 1>
+            m_startPositionsByType;
+};
+
+typedef std::shared_ptr<const TrackEngineSnapshot> TrackEngineSnapshotPointer;
+
+} // namespace mixxx
@@ -368,6 +368,7 @@ bool operator==(const TrackRecord& lhs, const TrackRecord& rhs) {
             lhs.getDateAdded() == rhs.getDateAdded() &&
             lhs.getFileType() == rhs.getFileType() &&
             lhs.getUrl() == rhs.getUrl() &&
+            lhs.getFingerprint() == rhs.getFingerprint() &&
             lhs.getPlayCounter() == rhs.getPlayCounter() &&
             lhs.getColor() == rhs.getColor() &&
             lhs.getMainCuePosition() == rhs.getMainCuePosition() &&
@@ -52,6 +52,9 @@ class TrackRecord final {
     MIXXX_DECL_PROPERTY(QDateTime, dateAdded, DateAdded)
     MIXXX_DECL_PROPERTY(QString, fileType, FileType)
     MIXXX_DECL_PROPERTY(QString, url, Url)
+    // The Chromaprint fingerprint of the beginning of the track, see
+    // ChromaPrinter. Empty until the track has been analyzed.
+    MIXXX_DECL_PROPERTY(QString, fingerprint, Fingerprint)
     MIXXX_DECL_PROPERTY(PlayCounter, playCounter, PlayCounter)
     MIXXX_DECL_PROPERTY(RgbColor::optional_t, color, Color)
     MIXXX_DECL_PROPERTY(mixxx::audio::FramePos, mainCuePosition, MainCuePosition)
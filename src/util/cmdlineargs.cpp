@@ -237,6 +237,14 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     parser.addOption(timelinePath);
     parser.addOption(timelinePathDeprecated);
 
+    const QCommandLineOption tracePath(QStringLiteral("trace-path"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Enables tracing and writes the trace to this path "
+                                      "in the Chrome trace format on exit")
+                            : QString(),
+            QStringLiteral("path"));
+    parser.addOption(tracePath);
+
     const QCommandLineOption enableLegacyVuMeter(QStringLiteral("enable-legacy-vumeter"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Use legacy vu meter")
@@ -451,6 +459,10 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_timelinePath = parser.value(timelinePathDeprecated);
     }
 
+    if (parser.isSet(tracePath)) {
+        m_tracePath = parser.value(tracePath);
+    }
+
     m_useLegacyVuMeter = parser.isSet(enableLegacyVuMeter);
     m_useLegacySpinny = parser.isSet(enableLegacySpinny);
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
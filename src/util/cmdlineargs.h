@@ -76,6 +76,12 @@ class CmdlineArgs final {
     }
     const QString& getResourcePath() const { return m_resourcePath; }
     const QString& getTimelinePath() const { return m_timelinePath; }
+    bool getTraceEnabled() const {
+        return !m_tracePath.isEmpty();
+    }
+    const QString& getTracePath() const {
+        return m_tracePath;
+    }
 
     const QString& getStyle() const {
         return m_styleName;
@@ -122,5 +128,6 @@ class CmdlineArgs final {
     QString m_settingsPath;
     QString m_resourcePath;
     QString m_timelinePath;
+    QString m_tracePath;
     QString m_styleName;
 };
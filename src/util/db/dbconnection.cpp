@@ -1,5 +1,8 @@
+#include <QHash>
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
+#include <utility>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -7,9 +10,11 @@
 
 #include "util/db/dbconnection.h"
 
+#include "util/cmdlineargs.h"
 #include "util/db/sqllikewildcards.h"
 #include "util/logger.h"
 #include "util/assert.h"
+#include "util/stat.h"
 
 
 // Originally from public domain code:
@@ -21,6 +26,9 @@ namespace {
 
 const mixxx::Logger kLogger("DbConnection");
 
+// The connections that have been opened by the current thread
+thread_local QHash<const QSqlDriver*, DbConnection*> s_openConnectionsByDriver;
+
 QSqlDatabase createDatabase(
         const DbConnection::Params& params,
         const QString& connectionName) {
@@ -230,9 +238,71 @@ void sqliteLikeUtf8(sqlite3_context* context,
     return;
 }
 
+// Statements that take longer are logged, independent of the log level
+constexpr sqlite3_int64 kSlowStatementThresholdNanos = 100 * 1000 * 1000;
+
+// Statements that contain inlined values, e.g. lists of ids, are
+// aggregated by their leading characters in the developer tools
+constexpr int kMaxStatementStatTagLength = 100;
+
+// Invoked by SQLite after each execution of a statement, including those
+// that are executed through QSqlQuery and BaseSqlTableModel.
+//
+// The number of steps in full table scans is reported for finding missing
+// indexes, the number of changed rows for modifying statements.
+int sqliteProfileStatement(
+        unsigned int type, void* pContext, void* pStatement, void* pNanos) {
+    DEBUG_ASSERT(type == SQLITE_TRACE_PROFILE);
+    Q_UNUSED(type);
+    const auto* pConnection = static_cast<const DbConnection*>(pContext);
+    auto* pStmt = static_cast<sqlite3_stmt*>(pStatement);
+    const auto nanos = *static_cast<const sqlite3_int64*>(pNanos);
+    const int fullScanSteps = sqlite3_stmt_status(
+            pStmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    const bool slow = nanos >= kSlowStatementThresholdNanos;
+    if (!slow && !CmdlineArgs::Instance().getDeveloper()) {
+        return 0;
+    }
+    const bool readOnly = sqlite3_stmt_readonly(pStmt) != 0;
+    const int changedRows = readOnly ? 0 : sqlite3_changes(sqlite3_db_handle(pStmt));
+    const QString statement = QString::fromUtf8(sqlite3_sql(pStmt)).simplified();
+    if (slow) {
+        kLogger.warning()
+                << "Slow statement on database connection"
+                << pConnection->name()
+                << "took"
+                << nanos / 1000000
+                << "ms with"
+                << fullScanSteps
+                << "full scan steps and"
+                << changedRows
+                << "changed rows:"
+                << statement;
+    }
+    const QString tag = QStringLiteral("SQL ") + statement.left(kMaxStatementStatTagLength);
+    const Stat::ComputeFlags flags = Stat::experimentFlags(
+            Stat::COUNT | Stat::SUM | Stat::AVERAGE | Stat::MIN | Stat::MAX);
+    Stat::track(tag, Stat::DURATION_NANOSEC, flags, static_cast<double>(nanos));
+    if (fullScanSteps > 0) {
+        Stat::track(tag + QStringLiteral(" [full scan steps]"),
+                Stat::COUNTER,
+                flags,
+                fullScanSteps);
+    }
+    if (!readOnly) {
+        Stat::track(tag + QStringLiteral(" [changed rows]"),
+                Stat::COUNTER,
+                flags,
+                changedRows);
+    }
+    return 0;
+}
+
 #endif // __SQLITE3__
 
-bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator) {
+bool initDatabase(const QSqlDatabase& database,
+        mixxx::StringCollator* pCollator,
+        const DbConnection* pConnection) {
     DEBUG_ASSERT(database.isOpen());
 #ifdef __SQLITE3__
     QVariant v = database.driver()->handle();
@@ -304,9 +374,21 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
                 << "Failed to install custom 3-arg LIKE function for SQLite3:"
                 << result;
     }
+
+    result = sqlite3_trace_v2(
+            handle,
+            SQLITE_TRACE_PROFILE,
+            sqliteProfileStatement,
+            const_cast<DbConnection*>(pConnection));
+    VERIFY_OR_DEBUG_ASSERT(result == SQLITE_OK) {
+        kLogger.warning()
+                << "Failed to install profiling callback for SQLite3:"
+                << result;
+    }
 #else
     Q_UNUSED(database);
     Q_UNUSED(pCollator);
+    Q_UNUSED(pConnection);
 #endif // __SQLITE3__
     return true;
 }
@@ -316,13 +398,17 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_initStatements(params.initStatements),
+      m_statementCache(connectionName) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_initStatements(prototype.m_initStatements),
+      m_statementCache(connectionName) {
 }
 
 DbConnection::~DbConnection() {
@@ -343,13 +429,26 @@ bool DbConnection::open() {
                 << m_sqlDatabase.lastError();
         return false; // abort
     }
-    if (!initDatabase(m_sqlDatabase, &m_collator)) {
+    if (!initDatabase(m_sqlDatabase, &m_collator, this)) {
         kLogger.warning()
                 << "Failed to initialize database connection"
                 << *this;
         m_sqlDatabase.close();
         return false; // abort
     }
+    for (const auto& statement : std::as_const(m_initStatements)) {
+        QSqlQuery query(m_sqlDatabase);
+        if (!query.exec(statement)) {
+            // Only affects the performance, the connection is still usable
+            kLogger.warning()
+                    << "Failed to execute"
+                    << statement
+                    << "for database connection"
+                    << *this
+                    << query.lastError();
+        }
+    }
+    s_openConnectionsByDriver.insert(m_sqlDatabase.driver(), this);
     return true;
 }
 
@@ -366,12 +465,33 @@ void DbConnection::close() {
         if (kLogger.debugEnabled()) {
             kLogger.debug()
                     << "Closing database connection:"
+                    << *this
+                    << "with"
+                    << m_statementCache.hitCount()
+                    << "hits and"
+                    << m_statementCache.missCount()
+                    << "misses of prepared statements";
+        }
+        // All prepared queries must be released before closing
+        m_statementCache.clear();
+        VERIFY_OR_DEBUG_ASSERT(s_openConnectionsByDriver.remove(m_sqlDatabase.driver()) > 0) {
+            kLogger.warning()
+                    << "Closing database connection from a different thread:"
                     << *this;
         }
         m_sqlDatabase.close();
     }
 }
 
+//static
+SqlStatementCache* DbConnection::statementCache(const QSqlDriver* pDriver) {
+    DbConnection* pConnection = s_openConnectionsByDriver.value(pDriver);
+    if (!pConnection) {
+        return nullptr;
+    }
+    return &pConnection->m_statementCache;
+}
+
 //static
 QString DbConnection::collateLexicographically(const QString& orderByQuery) {
 #ifdef __SQLITE3__
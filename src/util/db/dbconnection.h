@@ -1,10 +1,14 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <QStringList>
 #include <QtDebug>
 
+#include "util/db/sqlstatementcache.h"
 #include "util/string.h"
 
+class QSqlDriver;
+
 namespace mixxx {
 
 class DbConnection final {
@@ -29,6 +33,9 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        // Executed after opening each connection, e.g. for PRAGMA
+        // statements that are not persisted in the database file
+        QStringList initStatements;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -55,6 +62,16 @@ class DbConnection final {
         return m_sqlDatabase;
     }
 
+    /// Returns the cache of prepared statements of the open connection
+    /// that uses the given driver. Only connections that have been opened
+    /// in the current thread are considered, i.e. nullptr is returned for
+    /// all other connections.
+    static SqlStatementCache* statementCache(const QSqlDriver* pDriver);
+
+    const SqlStatementCache& statementCache() const {
+        return m_statementCache;
+    }
+
     friend QDebug operator<<(QDebug debug, const DbConnection& connection);
 
   private:
@@ -62,7 +79,9 @@ class DbConnection final {
     DbConnection(const DbConnection&&) = delete;
 
     QSqlDatabase m_sqlDatabase;
+    QStringList m_initStatements;
     mixxx::StringCollator m_collator;
+    SqlStatementCache m_statementCache;
 };
 
 } // namespace mixxx
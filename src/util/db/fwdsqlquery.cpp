@@ -1,8 +1,11 @@
 #include "util/db/fwdsqlquery.h"
 
-#include "util/performancetimer.h"
-#include "util/logger.h"
+#include <utility>
+
 #include "util/assert.h"
+#include "util/db/dbconnection.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
 
 
 namespace {
@@ -34,7 +37,16 @@ FwdSqlQuery::FwdSqlQuery(
         const QSqlDatabase& database,
         const QString& statement)
         : QSqlQuery(database),
-          m_prepared(prepareQuery(*this, statement)) {
+          m_prepared(false) {
+    mixxx::SqlStatementCache* pStatementCache =
+            mixxx::DbConnection::statementCache(database.driver());
+    if (pStatementCache && pStatementCache->take(statement, this)) {
+        DEBUG_ASSERT(!isActive());
+        DEBUG_ASSERT(isForwardOnly());
+        m_prepared = true;
+        return;
+    }
+    m_prepared = prepareQuery(*this, statement);
     if (!m_prepared) {
         DEBUG_ASSERT(!database.isOpen() || hasError());
         if (hasDuplicateColumnNameError()) {
@@ -56,6 +68,44 @@ FwdSqlQuery::FwdSqlQuery(
     }
 }
 
+FwdSqlQuery::FwdSqlQuery(FwdSqlQuery&& other)
+        : QSqlQuery(std::move(other)),
+          // Only a single instance must put the query back
+          m_prepared(std::exchange(other.m_prepared, false)) {
+}
+
+FwdSqlQuery::~FwdSqlQuery() {
+    recycle();
+}
+
+FwdSqlQuery& FwdSqlQuery::operator=(FwdSqlQuery&& other) {
+    if (this != &other) {
+        recycle();
+        QSqlQuery::operator=(std::move(other));
+        m_prepared = std::exchange(other.m_prepared, false);
+    }
+    return *this;
+}
+
+void FwdSqlQuery::recycle() {
+    if (!m_prepared) {
+        return;
+    }
+    m_prepared = false;
+    if (hasError()) {
+        // Don't reuse queries in an unknown state
+        return;
+    }
+    mixxx::SqlStatementCache* pStatementCache =
+            mixxx::DbConnection::statementCache(driver());
+    if (!pStatementCache) {
+        return;
+    }
+    // Free the resources of the result set until the next execution
+    finish();
+    pStatementCache->put(lastQuery(), std::move(static_cast<QSqlQuery&>(*this)));
+}
+
 bool FwdSqlQuery::hasDuplicateColumnNameError() const {
     return hasError() &&
             lastError().databaseText().startsWith(
@@ -30,6 +30,10 @@ class FwdSqlQuerySelectResult;
 /// Please note that forward-only queries don't provide information
 /// about the size of the result set!
 ///
+/// Prepared queries are reused if the same statement is prepared again
+/// on the same connection. They are put back into the statement cache
+/// of the connection upon destruction.
+///
 /// Since the destructor of the base class QSqlQuery is non-virtual
 /// FwdSqlQuery must not contain any members with a non-trivial
 /// destructor to prevent memory leaks!
@@ -46,9 +50,10 @@ class FwdSqlQuery final : protected QSqlQuery {
             const QString& statement);
     // The copy constructor of QSqlQuery is marked as deprecated in Qt6
     FwdSqlQuery(const FwdSqlQuery&) = delete;
-    FwdSqlQuery(FwdSqlQuery&&) = default;
+    FwdSqlQuery(FwdSqlQuery&& other);
+    ~FwdSqlQuery();
 
-    FwdSqlQuery& operator=(FwdSqlQuery&&) = default;
+    FwdSqlQuery& operator=(FwdSqlQuery&& other);
 
     bool isPrepared() const {
         return m_prepared;
@@ -118,5 +123,8 @@ class FwdSqlQuery final : protected QSqlQuery {
     bool fieldValueBoolean(DbFieldIndex fieldIndex) const;
 
   private:
+    // Puts the prepared query back into the statement cache
+    void recycle();
+
     bool m_prepared;
 };
@@ -0,0 +1,61 @@
+#include "util/db/sqlstatementcache.h"
+
+#include <utility>
+
+#include "util/assert.h"
+
+namespace mixxx {
+
+SqlStatementCache::SqlStatementCache(
+        const QString& connectionName,
+        int capacity)
+        : m_capacity(capacity),
+          m_hitCount(0),
+          m_missCount(0),
+          m_hitCounter(QStringLiteral("DbConnection %1 prepared statement cache hit")
+                               .arg(connectionName)),
+          m_missCounter(QStringLiteral("DbConnection %1 prepared statement cache miss")
+                                .arg(connectionName)) {
+    DEBUG_ASSERT(m_capacity > 0);
+}
+
+bool SqlStatementCache::take(const QString& statement, QSqlQuery* pQuery) {
+    DEBUG_ASSERT(pQuery);
+    const auto it = m_entriesByStatement.find(statement);
+    if (it == m_entriesByStatement.end()) {
+        ++m_missCount;
+        m_missCounter.increment();
+        return false;
+    }
+    const auto entry = it.value();
+    m_entriesByStatement.erase(it);
+    *pQuery = std::move(entry->query);
+    m_entries.erase(entry);
+    ++m_hitCount;
+    m_hitCounter.increment();
+    return true;
+}
+
+void SqlStatementCache::put(const QString& statement, QSqlQuery query) {
+    DEBUG_ASSERT(!query.isActive());
+    if (m_entriesByStatement.contains(statement)) {
+        // Another query with the same statement has been put back
+        // while this one was in use
+        return;
+    }
+    m_entries.push_front(Entry{statement, std::move(query)});
+    m_entriesByStatement.insert(statement, m_entries.begin());
+    if (size() > m_capacity) {
+        // Evict the least recently used query
+        m_entriesByStatement.remove(m_entries.back().statement);
+        m_entries.pop_back();
+    }
+    DEBUG_ASSERT(m_entriesByStatement.size() == size());
+}
+
+void SqlStatementCache::clear() {
+    m_entriesByStatement.clear();
+    m_entries.clear();
+}
+
+} // namespace mixxx
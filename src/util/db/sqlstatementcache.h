@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QHash>
+#include <QSqlQuery>
+#include <QString>
+#include <list>
+
+#include "util/counter.h"
+
+namespace mixxx {
+
+/// LRU cache of prepared queries that are keyed by their SQL statement.
+///
+/// A query is taken out of the cache while it is used and put back
+/// afterwards. Taking a statement that is currently in use is a miss
+/// and requires to prepare another query.
+///
+/// Each database connection has its own cache that must only be
+/// accessed from the thread that owns the connection.
+class SqlStatementCache final {
+  public:
+    static constexpr int kDefaultCapacity = 64;
+
+    explicit SqlStatementCache(
+            const QString& connectionName,
+            int capacity = kDefaultCapacity);
+
+    /// Moves the cached query into pQuery. Returns false on a cache miss
+    /// and leaves pQuery untouched.
+    bool take(const QString& statement, QSqlQuery* pQuery);
+
+    /// The query must have been prepared from the statement and should
+    /// already be finished. If the statement is already cached the
+    /// query is discarded.
+    void put(const QString& statement, QSqlQuery query);
+
+    /// Must be invoked before closing the connection.
+    void clear();
+
+    int size() const {
+        return static_cast<int>(m_entries.size());
+    }
+    int capacity() const {
+        return m_capacity;
+    }
+
+    quint64 hitCount() const {
+        return m_hitCount;
+    }
+    quint64 missCount() const {
+        return m_missCount;
+    }
+
+  private:
+    struct Entry {
+        QString statement;
+        QSqlQuery query;
+    };
+    using Entries = std::list<Entry>;
+
+    const int m_capacity;
+
+    // Most recently used first
+    Entries m_entries;
+    QHash<QString, Entries::iterator> m_entriesByStatement;
+
+    quint64 m_hitCount;
+    quint64 m_missCount;
+    Counter m_hitCounter;
+    Counter m_missCounter;
+};
+
+} // namespace mixxx
@@ -0,0 +1,180 @@
+#include "util/delaybufferpool.h"
+
+#include <algorithm>
+
+#include "moc_delaybufferpool.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/sample.h"
+
+DelayBuffer::DelayBuffer(SINT initialSize)
+        : m_pPool(DelayBufferPool::instance()),
+          m_buffer(m_pPool->allocate(initialSize)),
+          m_requestedSize(0),
+          m_size(m_buffer.size()),
+          m_pGrownBuffer(nullptr),
+          m_pReleasedBuffer(nullptr) {
+    m_pPool->addBuffer(this);
+}
+
+DelayBuffer::~DelayBuffer() {
+    m_pPool->removeBuffer(this);
+}
+
+SINT DelayBuffer::reserve(SINT size, SINT* pWritePos) {
+    if (size <= m_buffer.size()) {
+        return m_buffer.size();
+    }
+    mixxx::SampleBuffer* pGrownBuffer =
+            m_pGrownBuffer.exchange(nullptr, std::memory_order_acquire);
+    if (pGrownBuffer) {
+        const SINT oldSize = m_buffer.size();
+        DEBUG_ASSERT(pGrownBuffer->size() > oldSize);
+        DEBUG_ASSERT(*pWritePos >= 0 && *pWritePos <= oldSize);
+        const SINT writePos = std::min(*pWritePos, oldSize);
+        // Unroll the ring, so the oldest sample is at the start and the
+        // cleared remainder is read as silence for longer delays
+        SampleUtil::copy(pGrownBuffer->data(),
+                m_buffer.data(writePos),
+                oldSize - writePos);
+        SampleUtil::copy(pGrownBuffer->data(oldSize - writePos),
+                m_buffer.data(),
+                writePos);
+        m_buffer.swap(*pGrownBuffer);
+        *pWritePos = oldSize;
+        m_size.store(m_buffer.size(), std::memory_order_release);
+        m_pReleasedBuffer.store(pGrownBuffer, std::memory_order_release);
+        // Wakes the pool to recycle the old buffer, and to allocate another
+        // one if the size has been increased again in the meantime
+        m_pPool->wake();
+    }
+    if (size > m_buffer.size() &&
+            size > m_requestedSize.load(std::memory_order_relaxed)) {
+        m_requestedSize.store(size, std::memory_order_release);
+        m_pPool->wake();
+    }
+    return m_buffer.size();
+}
+
+DelayBufferPool::DelayBufferPool()
+        : m_stop(false),
+          m_freeSamples(0) {
+    setObjectName(QStringLiteral("DelayBufferPool"));
+    start(QThread::LowPriority);
+}
+
+DelayBufferPool::~DelayBufferPool() {
+    DEBUG_ASSERT(m_buffers.isEmpty());
+    m_stop = true;
+    m_semaphore.release();
+    wait();
+}
+
+// static
+std::shared_ptr<DelayBufferPool> DelayBufferPool::instance() {
+    static QMutex s_mutex;
+    static std::weak_ptr<DelayBufferPool> s_pInstance;
+
+    const auto locker = lockMutex(&s_mutex);
+    auto pInstance = s_pInstance.lock();
+    if (!pInstance) {
+        pInstance = std::make_shared<DelayBufferPool>();
+        s_pInstance = pInstance;
+    }
+    return pInstance;
+}
+
+mixxx::SampleBuffer DelayBufferPool::allocate(SINT size) {
+    const auto locker = lockMutex(&m_mutex);
+    return takeFreeBuffer(size);
+}
+
+void DelayBufferPool::addBuffer(DelayBuffer* pBuffer) {
+    const auto locker = lockMutex(&m_mutex);
+    m_buffers.append(pBuffer);
+}
+
+void DelayBufferPool::removeBuffer(DelayBuffer* pBuffer) {
+    // Waits until the buffer is no longer processed
+    const auto locker = lockMutex(&m_mutex);
+    m_buffers.removeAll(pBuffer);
+    for (mixxx::SampleBuffer* pPendingBuffer : {
+                 pBuffer->m_pGrownBuffer.exchange(nullptr),
+                 pBuffer->m_pReleasedBuffer.exchange(nullptr)}) {
+        if (pPendingBuffer) {
+            recycle(std::move(*pPendingBuffer));
+            delete pPendingBuffer;
+        }
+    }
+    recycle(std::move(pBuffer->m_buffer));
+}
+
+void DelayBufferPool::run() {
+    while (true) {
+        m_semaphore.acquire();
+        if (m_stop) {
+            break;
+        }
+        const auto locker = lockMutex(&m_mutex);
+        for (DelayBuffer* pBuffer : std::as_const(m_buffers)) {
+            processBuffer(pBuffer);
+        }
+    }
+}
+
+void DelayBufferPool::processBuffer(DelayBuffer* pBuffer) {
+    mixxx::SampleBuffer* pReleasedBuffer =
+            pBuffer->m_pReleasedBuffer.exchange(nullptr, std::memory_order_acquire);
+    if (pReleasedBuffer) {
+        recycle(std::move(*pReleasedBuffer));
+        delete pReleasedBuffer;
+    }
+    // Only one buffer is in flight at a time
+    if (pBuffer->m_pGrownBuffer.load(std::memory_order_acquire)) {
+        return;
+    }
+    const SINT requestedSize = pBuffer->m_requestedSize.load(std::memory_order_acquire);
+    if (requestedSize <= pBuffer->m_size.load(std::memory_order_acquire)) {
+        return;
+    }
+    pBuffer->m_pGrownBuffer.store(
+            new mixxx::SampleBuffer(takeFreeBuffer(requestedSize)),
+            std::memory_order_release);
+}
+
+mixxx::SampleBuffer DelayBufferPool::takeFreeBuffer(SINT size) {
+    size = roundUpSize(size);
+    // Reuse the smallest free buffer that is large enough, unless it would
+    // waste more memory than it saves
+    const auto it = std::lower_bound(m_freeBuffers.begin(),
+            m_freeBuffers.end(),
+            size,
+            [](const mixxx::SampleBuffer& buffer, SINT size) {
+                return buffer.size() < size;
+            });
+    if (it != m_freeBuffers.end() && it->size() <= 2 * size) {
+        mixxx::SampleBuffer buffer = std::move(*it);
+        m_freeBuffers.erase(it);
+        m_freeSamples -= buffer.size();
+        buffer.clear();
+        return buffer;
+    }
+    mixxx::SampleBuffer buffer(size);
+    buffer.clear();
+    return buffer;
+}
+
+void DelayBufferPool::recycle(mixxx::SampleBuffer buffer) {
+    if (buffer.size() == 0 || m_freeSamples + buffer.size() > kMaxFreeSamples) {
+        // Freed when going out of scope
+        return;
+    }
+    m_freeSamples += buffer.size();
+    const auto it = std::lower_bound(m_freeBuffers.begin(),
+            m_freeBuffers.end(),
+            buffer.size(),
+            [](const mixxx::SampleBuffer& freeBuffer, SINT size) {
+                return freeBuffer.size() < size;
+            });
+    m_freeBuffers.insert(it, std::move(buffer));
+}
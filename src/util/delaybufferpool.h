@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "util/class.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+class DelayBufferPool;
+
+/// The ring buffer of a delay line that starts small and grows on demand.
+///
+/// The buffer is created and destroyed in the main thread and used from
+/// the audio thread. A larger buffer is requested with reserve() and
+/// allocated by the DelayBufferPool in its own thread, so the audio thread
+/// never allocates or frees memory. Until the larger buffer is available,
+/// the delay line has to work with the current size.
+class DelayBuffer final {
+  public:
+    explicit DelayBuffer(SINT initialSize);
+    ~DelayBuffer();
+
+    /// Called from the audio thread
+    SINT size() const {
+        return m_buffer.size();
+    }
+    CSAMPLE* data() {
+        return m_buffer.data();
+    }
+    CSAMPLE& operator[](SINT index) {
+        return m_buffer[index];
+    }
+    void clear() {
+        m_buffer.clear();
+    }
+
+    /// Called from the audio thread. Requests a size of at least the given
+    /// number of samples and returns the current size, which might still
+    /// be smaller.
+    ///
+    /// If a larger buffer has become available, it replaces the current
+    /// one. The samples before the write position are preserved in order,
+    /// i.e. the same delay still reads the same samples, and the write
+    /// position is updated accordingly.
+    SINT reserve(SINT size, SINT* pWritePos);
+
+  private:
+    friend class DelayBufferPool;
+
+    const std::shared_ptr<DelayBufferPool> m_pPool;
+
+    // Only accessed from the audio thread
+    mixxx::SampleBuffer m_buffer;
+
+    // The size that the audio thread is waiting for
+    std::atomic<SINT> m_requestedSize;
+    std::atomic<SINT> m_size;
+    // Published by the pool, taken by the audio thread
+    std::atomic<mixxx::SampleBuffer*> m_pGrownBuffer;
+    // Handed back by the audio thread for recycling
+    std::atomic<mixxx::SampleBuffer*> m_pReleasedBuffer;
+
+    DISALLOW_COPY_AND_ASSIGN(DelayBuffer);
+};
+
+/// Allocates the buffers of all DelayBuffers in a low priority thread and
+/// recycles the memory of the replaced and destroyed buffers. The pool is
+/// shared by all delay buffers and only exists while there are any.
+class DelayBufferPool : public QThread {
+    Q_OBJECT
+  public:
+    /// Buffers are allocated in multiples of this number of samples
+    static constexpr SINT kSizeGranularity = 8192;
+    /// The total size of the unused buffers that are kept for reuse
+    static constexpr SINT kMaxFreeSamples = 1024 * 1024;
+
+    DelayBufferPool();
+    ~DelayBufferPool() override;
+
+    static std::shared_ptr<DelayBufferPool> instance();
+
+    static SINT roundUpSize(SINT size) {
+        return (size + kSizeGranularity - 1) / kSizeGranularity * kSizeGranularity;
+    }
+
+    /// Called from the main thread. Returns a cleared buffer.
+    mixxx::SampleBuffer allocate(SINT size);
+    /// Called from the main thread
+    void addBuffer(DelayBuffer* pBuffer);
+    /// Called from the main thread. The buffer is not accessed afterwards
+    /// and its memory is recycled.
+    void removeBuffer(DelayBuffer* pBuffer);
+
+    /// Called from the audio thread after a buffer has requested a larger
+    /// size or released a replaced one
+    void wake() {
+        m_semaphore.release();
+    }
+
+  protected:
+    void run() override;
+
+  private:
+    // Called with the mutex locked
+    mixxx::SampleBuffer takeFreeBuffer(SINT size);
+    void recycle(mixxx::SampleBuffer buffer);
+    void processBuffer(DelayBuffer* pBuffer);
+
+    QSemaphore m_semaphore;
+    std::atomic<bool> m_stop;
+
+    // Protects all members below
+    QMutex m_mutex;
+    QList<DelayBuffer*> m_buffers;
+    // Sorted by size
+    std::vector<mixxx::SampleBuffer> m_freeBuffers;
+    SINT m_freeSamples;
+};
@@ -1,37 +1,66 @@
 #pragma once
 
-#include "pa_ringbuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
 
+// Only for the ring_buffer_size_t of the region API
+#include "pa_ringbuffer.h"
 #include "util/class.h"
 #include "util/math.h"
 
-template <class DataType>
+/// A lock-free ring buffer for a single producer and a single consumer
+/// thread. Elements are written and read in bulk, either by copying or
+/// in-place through the (at most two) contiguous regions of the buffer.
+///
+/// The read and the write index are placed in separate cache lines, each
+/// together with a copy of the other index that is owned by the same
+/// thread. The copy is only refreshed when it doesn't suffice for the
+/// requested count, so the producer and the consumer don't invalidate the
+/// cache line of each other on every access.
+template<class DataType>
 class FIFO {
   public:
     explicit FIFO(int size)
-            : m_data(roundUpToPowerOf2(size)) {
-        // If we can't represent the next higher power of 2 then bail.
-        if (m_data.size() == 0) {
-            return;
-        }
-        PaUtil_InitializeRingBuffer(&m_ringBuffer,
-                static_cast<ring_buffer_size_t>(sizeof(DataType)),
-                static_cast<ring_buffer_size_t>(m_data.size()),
-                m_data.data());
+            : m_data(roundUpToPowerOf2(size)),
+              // If we can't represent the next higher power of 2 then
+              // the capacity is 0
+              m_mask(m_data.empty() ? 0 : m_data.size() - 1),
+              m_writeIndex(0),
+              m_cachedReadIndex(0),
+              m_readIndex(0),
+              m_cachedWriteIndex(0) {
     }
     virtual ~FIFO() {
     }
     int readAvailable() const {
-        return PaUtil_GetRingBufferReadAvailable(&m_ringBuffer);
+        return static_cast<int>(
+                m_writeIndex.load(std::memory_order_acquire) -
+                m_readIndex.load(std::memory_order_acquire));
     }
     int writeAvailable() const {
-        return PaUtil_GetRingBufferWriteAvailable(&m_ringBuffer);
+        return static_cast<int>(m_data.size()) - readAvailable();
     }
     int read(DataType* pData, int count) {
-        return PaUtil_ReadRingBuffer(&m_ringBuffer, pData, count);
+        DataType* pRegion1;
+        ring_buffer_size_t size1;
+        DataType* pRegion2;
+        ring_buffer_size_t size2;
+        const int read = aquireReadRegions(count, &pRegion1, &size1, &pRegion2, &size2);
+        std::copy(pRegion1, pRegion1 + size1, pData);
+        std::copy(pRegion2, pRegion2 + size2, pData + size1);
+        return releaseReadRegions(read);
     }
     int write(const DataType* pData, int count) {
-        return PaUtil_WriteRingBuffer(&m_ringBuffer, pData, count);
+        DataType* pRegion1;
+        ring_buffer_size_t size1;
+        DataType* pRegion2;
+        ring_buffer_size_t size2;
+        const int written = aquireWriteRegions(count, &pRegion1, &size1, &pRegion2, &size2);
+        std::copy(pData, pData + size1, pRegion1);
+        std::copy(pData + size1, pData + size1 + size2, pRegion2);
+        return releaseWriteRegions(written);
     }
     void writeBlocking(const DataType* pData, int count) {
         int written = 0;
@@ -42,28 +71,73 @@ class FIFO {
     int aquireWriteRegions(int count,
             DataType** dataPtr1, ring_buffer_size_t* sizePtr1,
             DataType** dataPtr2, ring_buffer_size_t* sizePtr2) {
-        return PaUtil_GetRingBufferWriteRegions(&m_ringBuffer, count,
-                (void**)dataPtr1, sizePtr1, (void**)dataPtr2, sizePtr2);
+        const std::size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        if (writeAvailable(writeIndex, m_cachedReadIndex) < count) {
+            m_cachedReadIndex = m_readIndex.load(std::memory_order_acquire);
+        }
+        count = math_min(count, writeAvailable(writeIndex, m_cachedReadIndex));
+        return regions(writeIndex, count, dataPtr1, sizePtr1, dataPtr2, sizePtr2);
     }
     int releaseWriteRegions(int count) {
-        return PaUtil_AdvanceRingBufferWriteIndex(&m_ringBuffer, count);
+        m_writeIndex.store(
+                m_writeIndex.load(std::memory_order_relaxed) + count,
+                std::memory_order_release);
+        return count;
     }
     int aquireReadRegions(int count,
             DataType** dataPtr1, ring_buffer_size_t* sizePtr1,
             DataType** dataPtr2, ring_buffer_size_t* sizePtr2) {
-        return PaUtil_GetRingBufferReadRegions(&m_ringBuffer, count,
-                (void**)dataPtr1, sizePtr1, (void**)dataPtr2, sizePtr2);
+        const std::size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        if (static_cast<int>(m_cachedWriteIndex - readIndex) < count) {
+            m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+        }
+        count = math_min(count, static_cast<int>(m_cachedWriteIndex - readIndex));
+        return regions(readIndex, count, dataPtr1, sizePtr1, dataPtr2, sizePtr2);
     }
     int releaseReadRegions(int count) {
-        return PaUtil_AdvanceRingBufferReadIndex(&m_ringBuffer, count);
+        m_readIndex.store(
+                m_readIndex.load(std::memory_order_relaxed) + count,
+                std::memory_order_release);
+        return count;
     }
     int flushReadData(int count) {
-        int flush = math_min(readAvailable(), count);
-        return PaUtil_AdvanceRingBufferReadIndex(&m_ringBuffer, flush);
+        return releaseReadRegions(math_min(readAvailable(), count));
     }
 
   private:
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    int writeAvailable(std::size_t writeIndex, std::size_t readIndex) const {
+        return static_cast<int>(m_data.size() - (writeIndex - readIndex));
+    }
+
+    // Splits count elements starting at index into the contiguous regions
+    int regions(std::size_t index,
+            int count,
+            DataType** dataPtr1,
+            ring_buffer_size_t* sizePtr1,
+            DataType** dataPtr2,
+            ring_buffer_size_t* sizePtr2) {
+        const std::size_t offset = index & m_mask;
+        const int size1 = math_min(count, static_cast<int>(m_data.size() - offset));
+        *dataPtr1 = m_data.data() + offset;
+        *sizePtr1 = size1;
+        *dataPtr2 = m_data.data();
+        *sizePtr2 = count - size1;
+        return count;
+    }
+
     std::vector<DataType> m_data;
-    PaUtilRingBuffer m_ringBuffer;
+    const std::size_t m_mask;
+
+    // Owned by the producer. The indices are never wrapped, only their
+    // difference needs to be valid.
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_writeIndex;
+    std::size_t m_cachedReadIndex;
+
+    // Owned by the consumer
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_readIndex;
+    std::size_t m_cachedWriteIndex;
+
     DISALLOW_COPY_AND_ASSIGN(FIFO);
 };
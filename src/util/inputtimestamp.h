@@ -0,0 +1,38 @@
+#pragma once
+
+#include "util/duration.h"
+
+namespace mixxx {
+
+/// Publishes the time of the input event, e.g. a MIDI message, that is
+/// processed by the current thread while the object is in scope. The
+/// timestamps are in the clock of mixxx::Time::elapsed().
+///
+/// Requests that are queued for the engine while processing the event, like
+/// seeks, can pick up the time with current() and be applied
+/// at the corresponding frame of the audio buffer.
+class ScopedInputTimestamp {
+  public:
+    explicit ScopedInputTimestamp(Duration timestamp)
+            : m_previousTimestamp(s_currentTimestamp) {
+        s_currentTimestamp = timestamp;
+    }
+    ~ScopedInputTimestamp() {
+        s_currentTimestamp = m_previousTimestamp;
+    }
+
+    ScopedInputTimestamp(const ScopedInputTimestamp&) = delete;
+    ScopedInputTimestamp& operator=(const ScopedInputTimestamp&) = delete;
+
+    /// Returns Duration::empty() if no input event is processed
+    static Duration current() {
+        return s_currentTimestamp;
+    }
+
+  private:
+    static inline thread_local Duration s_currentTimestamp = Duration::empty();
+
+    const Duration m_previousTimestamp;
+};
+
+} // namespace mixxx
@@ -0,0 +1,161 @@
+#include "util/memoryusage.h"
+
+#include <QMap>
+#include <QMutex>
+#include <QTimerEvent>
+#include <map>
+#include <vector>
+
+#include "moc_memoryusage.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/stat.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("MemoryUsage");
+
+const QString kMemoryGroup = QStringLiteral("[Memory]");
+
+constexpr int kUpdateIntervalMillis = 10000;
+
+constexpr qint64 kBytesPerMegabyte = 1024 * 1024;
+
+struct Entry {
+    QString name;
+    MemoryUsage::Reporter reporter;
+    MemoryUsage::Evictor evictor;
+};
+
+QMutex s_mutex;
+
+// Guarded by s_mutex
+quint64 s_nextId = 1;
+std::map<quint64, Entry> s_entries;
+
+void unregisterSubsystem(quint64 id) {
+    const auto locker = lockMutex(&s_mutex);
+    s_entries.erase(id);
+}
+
+} // namespace
+
+MemoryUsage::Registration::Registration(Registration&& other) noexcept
+        : m_id(other.m_id) {
+    other.m_id = 0;
+}
+
+MemoryUsage::Registration& MemoryUsage::Registration::operator=(
+        Registration&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_id = other.m_id;
+        other.m_id = 0;
+    }
+    return *this;
+}
+
+MemoryUsage::Registration::~Registration() {
+    reset();
+}
+
+void MemoryUsage::Registration::reset() {
+    if (m_id != 0) {
+        unregisterSubsystem(m_id);
+        m_id = 0;
+    }
+}
+
+// static
+MemoryUsage::Registration MemoryUsage::registerSubsystem(
+        const QString& name,
+        Reporter reporter,
+        Evictor evictor) {
+    VERIFY_OR_DEBUG_ASSERT(reporter) {
+        return Registration();
+    }
+    const auto locker = lockMutex(&s_mutex);
+    const quint64 id = s_nextId++;
+    s_entries.emplace(id, Entry{name, std::move(reporter), std::move(evictor)});
+    return Registration(id);
+}
+
+// static
+QList<MemoryUsage::Subsystem> MemoryUsage::report() {
+    QMap<QString, Subsystem> subsystems;
+    const auto locker = lockMutex(&s_mutex);
+    for (const auto& [id, entry] : s_entries) {
+        Subsystem& subsystem = subsystems[entry.name];
+        subsystem.name = entry.name;
+        subsystem.bytes += entry.reporter();
+        ++subsystem.instanceCount;
+        subsystem.evictable |= static_cast<bool>(entry.evictor);
+    }
+    return subsystems.values();
+}
+
+// static
+void MemoryUsage::evict(const QString& name, qint64 budgetBytes) {
+    DEBUG_ASSERT(budgetBytes >= 0);
+    const auto locker = lockMutex(&s_mutex);
+    std::vector<std::pair<const Entry*, qint64>> instances;
+    qint64 totalBytes = 0;
+    for (const auto& [id, entry] : s_entries) {
+        if (entry.name != name || !entry.evictor) {
+            continue;
+        }
+        const qint64 bytes = entry.reporter();
+        instances.emplace_back(&entry, bytes);
+        totalBytes += bytes;
+    }
+    if (totalBytes <= budgetBytes) {
+        return;
+    }
+    for (const auto& [pEntry, bytes] : instances) {
+        // Instances that hold more get a larger share of the budget
+        const auto instanceBudget = static_cast<qint64>(
+                static_cast<double>(budgetBytes) * bytes / totalBytes);
+        pEntry->evictor(instanceBudget);
+    }
+}
+
+MemoryUsageMonitor::MemoryUsageMonitor(UserSettingsPointer pConfig, QObject* pParent)
+        : QObject(pParent),
+          m_pConfig(std::move(pConfig)) {
+    startTimer(kUpdateIntervalMillis);
+}
+
+// static
+qint64 MemoryUsageMonitor::budgetBytes(const UserSettingsPointer& pConfig, const QString& name) {
+    const int budgetMB = pConfig->getValue(
+            ConfigKey(kMemoryGroup, name + QStringLiteral("_budget_mb")), 0);
+    return budgetMB > 0 ? budgetMB * kBytesPerMegabyte : 0;
+}
+
+QList<MemoryUsage::Subsystem> MemoryUsageMonitor::update() {
+    const auto subsystems = MemoryUsage::report();
+    for (const auto& subsystem : subsystems) {
+        Stat::track(QStringLiteral("Memory %1 (MiB)").arg(subsystem.name),
+                Stat::UNSPECIFIED,
+                Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+                static_cast<double>(subsystem.bytes) / kBytesPerMegabyte);
+        const qint64 budget = budgetBytes(m_pConfig, subsystem.name);
+        if (budget > 0 && subsystem.evictable && subsystem.bytes > budget) {
+            kLogger.info() << "Evicting" << subsystem.name << "from"
+                           << subsystem.bytes / kBytesPerMegabyte << "MiB to the budget of"
+                           << budget / kBytesPerMegabyte << "MiB";
+            MemoryUsage::evict(subsystem.name, budget);
+        }
+    }
+    return subsystems;
+}
+
+void MemoryUsageMonitor::timerEvent(QTimerEvent* pTimerEvent) {
+    Q_UNUSED(pTimerEvent);
+    update();
+}
+
+} // namespace mixxx
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <functional>
+
+#include "preferences/usersettings.h"
+
+namespace mixxx {
+
+/// Accounts the memory of the subsystems that hold large amounts of data,
+/// like the waveforms, the chunks of the caching readers and the track
+/// caches of the library, to find out where the memory of a long session
+/// is spent.
+///
+/// Subsystems register a reporter that estimates the bytes they currently
+/// hold. Subsystems that cache data additionally register an evictor that
+/// is invoked to release data when a budget is exceeded. Multiple instances
+/// may register with the same name, e.g. one per deck, and are reported
+/// as a single subsystem.
+///
+/// Reporters and evictors are invoked with the registry locked in the
+/// thread that calls report() or evict(), i.e. the thread of the
+/// MemoryUsageMonitor. They must not register or unregister themselves.
+class MemoryUsage {
+  public:
+    using Reporter = std::function<qint64()>;
+    /// Invoked with the number of bytes that the instance may keep
+    using Evictor = std::function<void(qint64 budgetBytes)>;
+
+    struct Subsystem {
+        QString name;
+        qint64 bytes = 0;
+        int instanceCount = 0;
+        bool evictable = false;
+    };
+
+    /// Unregisters the reporter when destroyed
+    class Registration {
+      public:
+        Registration() = default;
+        Registration(Registration&& other) noexcept;
+        Registration& operator=(Registration&& other) noexcept;
+        ~Registration();
+
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+
+        bool isRegistered() const {
+            return m_id != 0;
+        }
+
+        void reset();
+
+      private:
+        friend class MemoryUsage;
+        explicit Registration(quint64 id)
+                : m_id(id) {
+        }
+
+        quint64 m_id = 0;
+    };
+
+    [[nodiscard]] static Registration registerSubsystem(
+            const QString& name,
+            Reporter reporter,
+            Evictor evictor = Evictor());
+
+    /// All subsystems sorted by name
+    static QList<Subsystem> report();
+
+    /// Splits the budget among the instances of the subsystem in proportion
+    /// to their usage and invokes their evictors.
+    static void evict(const QString& name, qint64 budgetBytes);
+};
+
+/// Reports the memory usage of all subsystems to the StatsManager and
+/// enforces the budgets that are configured as [Memory],<name>_budget_mb
+/// in regular intervals.
+class MemoryUsageMonitor : public QObject {
+    Q_OBJECT
+  public:
+    explicit MemoryUsageMonitor(UserSettingsPointer pConfig, QObject* pParent = nullptr);
+
+    /// Returns 0 if there is no budget for the subsystem
+    static qint64 budgetBytes(const UserSettingsPointer& pConfig, const QString& name);
+
+    /// Reports and evicts immediately. Returns the usage before evicting.
+    QList<MemoryUsage::Subsystem> update();
+
+  protected:
+    void timerEvent(QTimerEvent* pTimerEvent) override;
+
+  private:
+    const UserSettingsPointer m_pConfig;
+};
+
+} // namespace mixxx
@@ -20,3 +20,35 @@ class RampingValue {
     T m_start;
     T m_increment;
 };
+
+/// A parameter that is ramped over each buffer from its value of the
+/// previous buffer to the new one, so each buffer only needs to evaluate
+/// the parameter once instead of smoothing it sample by sample.
+template<typename T>
+class SmoothedValue {
+  public:
+    explicit constexpr SmoothedValue(const T& initial)
+            : m_value(initial) {
+    }
+
+    /// Returns the ramp from the current to the target value over the steps
+    /// of a buffer. The target becomes the current value, which is the value
+    /// of the ramp at `steps`.
+    [[nodiscard]] constexpr RampingValue<T> rampTo(const T& target, int steps) {
+        const RampingValue<T> ramp(m_value, target, steps);
+        m_value = target;
+        return ramp;
+    }
+
+    /// Sets the value without ramping, e.g. when the effect is enabled
+    constexpr void reset(const T& value) {
+        m_value = value;
+    }
+
+    [[nodiscard]] constexpr const T& value() const {
+        return m_value;
+    }
+
+  private:
+    T m_value;
+};
@@ -0,0 +1,341 @@
+#include "util/realtime.h"
+
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace realtime {
+
+namespace {
+
+const Logger kLogger("realtime");
+
+const QString kConfigGroup = QStringLiteral("[Realtime]");
+const ConfigKey kEngineCpusKey(kConfigGroup, QStringLiteral("engine_cpus"));
+const ConfigKey kRaiseHelperThreadsKey(kConfigGroup, QStringLiteral("raise_helper_threads"));
+const ConfigKey kIdleAnalyzersWhilePlayingKey(
+        kConfigGroup, QStringLiteral("idle_analyzers_while_playing"));
+const ConfigKey kLockMemoryKey(kConfigGroup, QStringLiteral("lock_memory"));
+
+// Below the engine thread, which the audio server or the rtkit usually
+// schedules with a priority between 60 and 90. The vinyl control output is
+// needed by the next callback, the effect workers and the reader only a few
+// callbacks later, and the sidechain has seconds of buffer.
+constexpr int kVinylControlPriority = 30;
+constexpr int kEffectWorkerPriority = 25;
+constexpr int kReaderPriority = 20;
+constexpr int kSideChainPriority = 10;
+
+#ifdef __LINUX__
+// Enough for the deepest call stack of the engine, and well below the
+// stack size of the threads of JACK and PortAudio
+constexpr std::size_t kPrefaultStackBytes = 128 * 1024;
+#endif
+
+constexpr std::size_t kNumRoles = static_cast<std::size_t>(ThreadRole::Analyzer) + 1;
+
+// Written by configure() before the threads that read it are started
+Settings s_settings;
+std::atomic<bool> s_idleAnalyzersWhilePlaying(false);
+std::atomic<bool> s_deckPlaying(false);
+
+std::mutex s_statusMutex;
+std::array<QString, kNumRoles> s_threadStatus;
+QString s_memoryStatus;
+
+QString roleName(ThreadRole role) {
+    switch (role) {
+    case ThreadRole::Engine:
+        return QObject::tr("Engine");
+    case ThreadRole::EngineWorker:
+        return QObject::tr("Engine workers");
+    case ThreadRole::Reader:
+        return QObject::tr("Track reader");
+    case ThreadRole::VinylControl:
+        return QObject::tr("Vinyl control");
+    case ThreadRole::SideChain:
+        return QObject::tr("Recording and broadcasting");
+    case ThreadRole::EffectWorker:
+        return QObject::tr("Effect workers");
+    case ThreadRole::Analyzer:
+        return QObject::tr("Analyzers");
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QString();
+}
+
+void setThreadStatus(ThreadRole role, const QString& status) {
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    s_threadStatus[static_cast<std::size_t>(role)] = status;
+}
+
+#ifdef __LINUX__
+QString errorString(int error) {
+    return QString::fromLocal8Bit(std::strerror(error));
+}
+
+QString currentPolicy() {
+    int policy;
+    struct sched_param param;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) != 0) {
+        return QString();
+    }
+    switch (policy) {
+    case SCHED_FIFO:
+        return QStringLiteral("SCHED_FIFO %1").arg(param.sched_priority);
+    case SCHED_RR:
+        return QStringLiteral("SCHED_RR %1").arg(param.sched_priority);
+    case SCHED_IDLE:
+        return QStringLiteral("SCHED_IDLE");
+    default:
+        return QStringLiteral("SCHED_OTHER");
+    }
+}
+
+int setCurrentThreadPolicy(int policy, int priority) {
+    struct sched_param param = {};
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), policy, &param);
+}
+
+int pinCurrentThread(const QList<int>& cpus) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+}
+
+// Touches the stack once, so the pages are mapped before the first
+// callback that needs them and stay locked thanks to mlockall().
+__attribute__((noinline)) void prefaultStack() {
+    volatile char stack[kPrefaultStackBytes];
+    for (std::size_t i = 0; i < kPrefaultStackBytes; i += 4096) {
+        stack[i] = 0;
+    }
+}
+
+void applyPinning(ThreadRole role) {
+    if (s_settings.engineCpus.isEmpty()) {
+        setThreadStatus(role, currentPolicy());
+        return;
+    }
+    const int error = pinCurrentThread(s_settings.engineCpus);
+    if (error != 0) {
+        kLogger.warning() << "Failed to pin" << QThread::currentThread()->objectName()
+                          << "to the CPUs" << formatCpuList(s_settings.engineCpus)
+                          << ":" << errorString(error);
+        setThreadStatus(role,
+                QObject::tr("%1, pinning failed: %2")
+                        .arg(currentPolicy(), errorString(error)));
+        return;
+    }
+    setThreadStatus(role,
+            QObject::tr("%1, CPUs %2")
+                    .arg(currentPolicy(), formatCpuList(s_settings.engineCpus)));
+}
+
+void applyPriority(ThreadRole role, int priority) {
+    if (!s_settings.raiseHelperThreads) {
+        setThreadStatus(role, currentPolicy());
+        return;
+    }
+    const int error = setCurrentThreadPolicy(SCHED_FIFO, priority);
+    if (error != 0) {
+        // Usually the missing rtprio limit of the user
+        kLogger.warning() << "Failed to schedule"
+                          << QThread::currentThread()->objectName()
+                          << "with SCHED_FIFO" << priority << ":" << errorString(error);
+        setThreadStatus(role,
+                QObject::tr("%1, SCHED_FIFO failed: %2")
+                        .arg(currentPolicy(), errorString(error)));
+        return;
+    }
+    setThreadStatus(role, currentPolicy());
+}
+#endif
+
+} // namespace
+
+// static
+Settings Settings::fromConfig(const UserSettingsPointer& pConfig) {
+    Settings settings;
+    settings.engineCpus = parseCpuList(pConfig->getValueString(kEngineCpusKey));
+    settings.raiseHelperThreads = pConfig->getValue(kRaiseHelperThreadsKey, false);
+    settings.idleAnalyzersWhilePlaying = pConfig->getValue(kIdleAnalyzersWhilePlayingKey, false);
+    settings.lockMemory = pConfig->getValue(kLockMemoryKey, false);
+    return settings;
+}
+
+void Settings::toConfig(const UserSettingsPointer& pConfig) const {
+    pConfig->setValue(kEngineCpusKey, formatCpuList(engineCpus));
+    pConfig->setValue(kRaiseHelperThreadsKey, raiseHelperThreads);
+    pConfig->setValue(kIdleAnalyzersWhilePlayingKey, idleAnalyzersWhilePlaying);
+    pConfig->setValue(kLockMemoryKey, lockMemory);
+    // Applies immediately, the other settings need a restart
+    s_idleAnalyzersWhilePlaying.store(idleAnalyzersWhilePlaying, std::memory_order_relaxed);
+}
+
+QList<int> parseCpuList(const QString& cpus) {
+    QList<int> result;
+    const QStringList items = cpus.split(QChar(','), Qt::SkipEmptyParts);
+    for (const QString& item : items) {
+        const QStringList range = item.trimmed().split(QChar('-'));
+        if (range.size() > 2) {
+            return {};
+        }
+        bool firstOk;
+        bool lastOk = true;
+        const int first = range.first().toInt(&firstOk);
+        const int last = range.size() == 2 ? range.last().toInt(&lastOk) : first;
+        if (!firstOk || !lastOk || first < 0 || last < first) {
+            return {};
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            if (!result.contains(cpu)) {
+                result.append(cpu);
+            }
+        }
+    }
+    return result;
+}
+
+QString formatCpuList(const QList<int>& cpus) {
+    QStringList items;
+    items.reserve(cpus.size());
+    for (const int cpu : cpus) {
+        items.append(QString::number(cpu));
+    }
+    return items.join(QChar(','));
+}
+
+void configure(const Settings& settings) {
+    s_settings = settings;
+    s_idleAnalyzersWhilePlaying.store(
+            settings.idleAnalyzersWhilePlaying, std::memory_order_relaxed);
+    if (!settings.lockMemory) {
+        return;
+    }
+#ifdef __LINUX__
+    // The engine buffers are allocated afterwards, MCL_FUTURE maps and
+    // locks them on allocation, so they are never paged out or faulted in
+    // by the engine callback.
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        const int error = errno;
+        kLogger.warning() << "Failed to lock the memory:" << errorString(error);
+        std::lock_guard<std::mutex> lock(s_statusMutex);
+        s_memoryStatus = QObject::tr("Locking failed: %1").arg(errorString(error));
+        return;
+    }
+    kLogger.info() << "Locked the memory";
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    s_memoryStatus = QObject::tr("Locked");
+#else
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    s_memoryStatus = QObject::tr("Not supported on this platform");
+#endif
+}
+
+void applyToCurrentThread(ThreadRole role) {
+#ifdef __LINUX__
+    switch (role) {
+    case ThreadRole::Engine:
+        if (s_settings.lockMemory) {
+            prefaultStack();
+        }
+        applyPinning(role);
+        return;
+    case ThreadRole::EngineWorker:
+        applyPinning(role);
+        return;
+    case ThreadRole::Reader:
+        applyPriority(role, kReaderPriority);
+        return;
+    case ThreadRole::VinylControl:
+        applyPriority(role, kVinylControlPriority);
+        return;
+    case ThreadRole::SideChain:
+        applyPriority(role, kSideChainPriority);
+        return;
+    case ThreadRole::EffectWorker:
+        applyPriority(role, kEffectWorkerPriority);
+        return;
+    case ThreadRole::Analyzer:
+        setThreadStatus(role, currentPolicy());
+        return;
+    }
+#else
+    setThreadStatus(role, QObject::tr("Not supported on this platform"));
+#endif
+}
+
+void setDeckPlaying(bool playing) {
+    s_deckPlaying.store(playing, std::memory_order_relaxed);
+}
+
+QString statusText() {
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    QStringList lines;
+    for (std::size_t i = 0; i < kNumRoles; ++i) {
+        if (s_threadStatus[i].isEmpty()) {
+            continue;
+        }
+        lines.append(QStringLiteral("%1: %2").arg(
+                roleName(static_cast<ThreadRole>(i)), s_threadStatus[i]));
+    }
+    if (!s_memoryStatus.isEmpty()) {
+        lines.append(QObject::tr("Memory: %1").arg(s_memoryStatus));
+    }
+    return lines.join(QChar('\n'));
+}
+
+void IdleWhilePlaying::update() {
+    const bool idle = s_idleAnalyzersWhilePlaying.load(std::memory_order_relaxed) &&
+            s_deckPlaying.load(std::memory_order_relaxed);
+    if (idle == m_idle) {
+        return;
+    }
+#ifdef __LINUX__
+    const int error = idle ? setCurrentThreadPolicy(SCHED_IDLE, 0)
+                           : setCurrentThreadPolicy(SCHED_OTHER, 0);
+    if (error != 0) {
+        // Leaving SCHED_IDLE requires a nice limit that allows it, i.e.
+        // RLIMIT_NICE. The switch is retried with the next update, but
+        // only logged once.
+        if (!m_failureLogged) {
+            kLogger.warning() << "Failed to switch"
+                              << QThread::currentThread()->objectName()
+                              << (idle ? "to SCHED_IDLE" : "from SCHED_IDLE") << ":"
+                              << errorString(error);
+            m_failureLogged = true;
+        }
+        return;
+    }
+    m_failureLogged = false;
+    setThreadStatus(ThreadRole::Analyzer, currentPolicy());
+#endif
+    m_idle = idle;
+}
+
+} // namespace realtime
+
+} // namespace mixxx
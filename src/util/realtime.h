@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include "preferences/usersettings.h"
+
+namespace mixxx {
+
+namespace realtime {
+
+/// The threads that feed the engine or compete with it.
+enum class ThreadRole {
+    /// The sound device callback that runs the engine
+    Engine,
+    /// The worker pools that process channels and time stretching for the
+    /// engine callback, which waits for them
+    EngineWorker,
+    /// CachingReaderWorker, which decodes the chunks the engine needs next
+    Reader,
+    /// VinylControlProcessor, which turns the timecode into the position
+    VinylControl,
+    /// The sidechain threads that encode and record the main mix
+    SideChain,
+    /// The threads that process the latency tolerant part of effects, e.g.
+    /// the tail of ConvolutionReverbEffect, which is needed a partition later
+    EffectWorker,
+    /// The analyzer threads, see IdleWhilePlaying
+    Analyzer,
+};
+
+/// Configured in the [Realtime] group. All but idleAnalyzersWhilePlaying
+/// only take effect for threads started after configure(), i.e. after a
+/// restart.
+struct Settings {
+    /// The CPUs the engine and its worker pools are pinned to, ideally
+    /// isolated from the scheduler with isolcpus. Not pinned if empty.
+    QList<int> engineCpus;
+    /// Schedules the reader, vinyl control, effect worker and sidechain
+    /// threads with SCHED_FIFO below the engine.
+    bool raiseHelperThreads = false;
+    /// Schedules the analyzers with SCHED_IDLE while a deck is playing.
+    bool idleAnalyzersWhilePlaying = false;
+    /// Locks all current and future memory with mlockall() and pre-faults
+    /// the stack of the engine thread.
+    bool lockMemory = false;
+
+    static Settings fromConfig(const UserSettingsPointer& pConfig);
+    void toConfig(const UserSettingsPointer& pConfig) const;
+};
+
+/// Parses a list of CPUs like "2,3" or "2-5". Returns an empty list for
+/// invalid input.
+QList<int> parseCpuList(const QString& cpus);
+QString formatCpuList(const QList<int>& cpus);
+
+/// Stores the settings of the process and locks the memory, if enabled.
+/// Must be called before the engine and its helper threads are started.
+void configure(const Settings& settings);
+
+/// Applies the settings of the role to the calling thread. Called once by
+/// each thread at its start, or by the first engine callback.
+void applyToCurrentThread(ThreadRole role);
+
+/// Set by PlayerInfo when the first deck starts or the last deck stops
+/// playing.
+void setDeckPlaying(bool playing);
+
+/// Summarizes what has been applied for the status in the preferences.
+QString statusText();
+
+/// Switches an analyzer thread between SCHED_IDLE and the normal policy,
+/// following setDeckPlaying(). update() is called by the thread itself
+/// between two chunks, so it does not change while a chunk is processed.
+class IdleWhilePlaying {
+  public:
+    IdleWhilePlaying()
+            : m_idle(false),
+              m_failureLogged(false) {
+    }
+
+    void update();
+
+  private:
+    // The policy that is actually applied to the thread
+    bool m_idle;
+    bool m_failureLogged;
+};
+
+} // namespace realtime
+
+} // namespace mixxx
@@ -0,0 +1,352 @@
+#include "util/realtimecheck.h"
+
+#ifdef MIXXX_REALTIME_CHECKS
+
+#include <QStringList>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfenv>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define MIXXX_REALTIME_CHECKS_BACKTRACE
+#endif
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace mixxx {
+
+namespace realtime {
+
+namespace {
+
+const Logger kLogger("realtime.check");
+
+// Each record keeps the first occurrence of a distinct violation. The
+// violations that don't fit anymore are only counted.
+constexpr int kMaxRecords = 64;
+constexpr int kMaxFrames = 32;
+constexpr std::size_t kMaxContextLength = 48;
+constexpr int kNumViolations = static_cast<int>(Check::Violation::Underflow) + 1;
+
+// The totals are logged at most this often
+constexpr Duration kTotalsLogInterval = Duration::fromSeconds(10);
+
+struct Record {
+    std::atomic<bool> published;
+    std::atomic<int> count;
+    Check::Violation violation;
+    int numFrames;
+    std::array<void*, kMaxFrames> frames;
+    std::array<char, kMaxContextLength> context;
+};
+
+// Zero initialized, and never allocated or freed
+std::array<Record, kMaxRecords> s_records;
+std::atomic<int> s_numReservedRecords(0);
+std::array<std::atomic<int>, kNumViolations> s_totals;
+
+// Trivial, so accessing them from the allocator never allocates
+thread_local int t_sectionDepth = 0;
+thread_local bool t_recording = false;
+
+#ifdef MIXXX_REALTIME_CHECKS_BACKTRACE
+// The first backtrace() loads the unwinder, which allocates
+[[maybe_unused]] const bool s_backtraceLoaded = [] {
+    void* pFrame;
+    backtrace(&pFrame, 1);
+    return true;
+}();
+#endif
+
+QString violationName(Check::Violation violation) {
+    switch (violation) {
+    case Check::Violation::Allocation:
+        return QStringLiteral("Heap allocation");
+    case Check::Violation::Lock:
+        return QStringLiteral("Mutex lock");
+    case Check::Violation::Underflow:
+        return QStringLiteral("Floating point underflow");
+    }
+    return QString();
+}
+
+bool isRecordOf(const Record& record,
+        Check::Violation violation,
+        const void* const* pFrames,
+        int numFrames,
+        const char* pContext) {
+    return record.published.load(std::memory_order_acquire) &&
+            record.violation == violation &&
+            record.numFrames == numFrames &&
+            std::equal(pFrames, pFrames + numFrames, record.frames.cbegin()) &&
+            std::strncmp(record.context.data(), pContext, kMaxContextLength - 1) == 0;
+}
+
+void record(Check::Violation violation, const char* pContext) {
+    // Recording must neither record itself nor allocate, except for the
+    // unwinder that has been loaded already
+    t_recording = true;
+    s_totals[static_cast<int>(violation)].fetch_add(1, std::memory_order_relaxed);
+    if (!pContext) {
+        pContext = "";
+    }
+
+    std::array<void*, kMaxFrames> frames;
+    int numFrames = 0;
+#ifdef MIXXX_REALTIME_CHECKS_BACKTRACE
+    // The call stack of an underflow check only shows the scope, which is
+    // identified by the context
+    if (violation != Check::Violation::Underflow) {
+        numFrames = backtrace(frames.data(), kMaxFrames);
+    }
+#endif
+
+    const int numRecords = std::min(
+            s_numReservedRecords.load(std::memory_order_acquire), kMaxRecords);
+    for (int i = 0; i < numRecords; ++i) {
+        Record& existingRecord = s_records[i];
+        if (isRecordOf(existingRecord, violation, frames.data(), numFrames, pContext)) {
+            existingRecord.count.fetch_add(1, std::memory_order_relaxed);
+            t_recording = false;
+            return;
+        }
+    }
+    // Several engine threads might record the same violation concurrently,
+    // which then occupies more than one record
+    const int index = s_numReservedRecords.fetch_add(1, std::memory_order_acq_rel);
+    if (index < kMaxRecords) {
+        Record& newRecord = s_records[index];
+        newRecord.count.store(1, std::memory_order_relaxed);
+        newRecord.violation = violation;
+        newRecord.numFrames = numFrames;
+        std::copy(frames.cbegin(), frames.cbegin() + numFrames, newRecord.frames.begin());
+        std::strncpy(newRecord.context.data(), pContext, kMaxContextLength - 1);
+        newRecord.context[kMaxContextLength - 1] = '\0';
+        newRecord.published.store(true, std::memory_order_release);
+    }
+    t_recording = false;
+}
+
+void checkAllocation() {
+    if (t_sectionDepth > 0 && !t_recording) {
+        record(Check::Violation::Allocation, nullptr);
+    }
+}
+
+} // namespace
+
+Check::ScopedSection::ScopedSection() {
+    ++t_sectionDepth;
+}
+
+Check::ScopedSection::~ScopedSection() {
+    --t_sectionDepth;
+}
+
+Check::ScopedUnderflowCheck::ScopedUnderflowCheck(const char* pContext)
+        : m_pContext(pContext),
+          m_active(t_sectionDepth > 0) {
+#ifdef FE_UNDERFLOW
+    if (m_active) {
+        std::feclearexcept(FE_UNDERFLOW);
+    }
+#endif
+}
+
+Check::ScopedUnderflowCheck::~ScopedUnderflowCheck() {
+#ifdef FE_UNDERFLOW
+    // Also raised if the result has been flushed to zero
+    if (m_active && std::fetestexcept(FE_UNDERFLOW)) {
+        check(Violation::Underflow, m_pContext);
+    }
+#endif
+}
+
+// static
+void Check::check(Violation violation, const char* pContext) {
+    if (t_sectionDepth > 0 && !t_recording) {
+        record(violation, pContext);
+    }
+}
+
+// static
+int Check::totalCount(Violation violation) {
+    return s_totals[static_cast<int>(violation)].load(std::memory_order_relaxed);
+}
+
+// static
+int Check::recordedCount(Violation violation, const char* pContext) {
+    const int numRecords = std::min(
+            s_numReservedRecords.load(std::memory_order_acquire), kMaxRecords);
+    int count = 0;
+    for (int i = 0; i < numRecords; ++i) {
+        const Record& existingRecord = s_records[i];
+        if (existingRecord.published.load(std::memory_order_acquire) &&
+                existingRecord.violation == violation &&
+                std::strncmp(existingRecord.context.data(),
+                        pContext,
+                        kMaxContextLength - 1) == 0) {
+            count += existingRecord.count.load(std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+// static
+int Check::numFreeRecords() {
+    return std::max(0,
+            kMaxRecords - s_numReservedRecords.load(std::memory_order_acquire));
+}
+
+// static
+void Check::logViolations() {
+    // Only used by the GUI thread
+    static int s_numLoggedRecords = 0;
+    static std::array<int, kNumViolations> s_loggedTotals{};
+    static PerformanceTimer s_totalsTimer;
+
+    const int numRecords = std::min(
+            s_numReservedRecords.load(std::memory_order_acquire), kMaxRecords);
+    for (; s_numLoggedRecords < numRecords; ++s_numLoggedRecords) {
+        const Record& newRecord = s_records[s_numLoggedRecords];
+        if (!newRecord.published.load(std::memory_order_acquire)) {
+            // Logged by the next call
+            break;
+        }
+        QStringList callStack;
+#ifdef MIXXX_REALTIME_CHECKS_BACKTRACE
+        char** pSymbols = backtrace_symbols(newRecord.frames.data(), newRecord.numFrames);
+        if (pSymbols) {
+            for (int i = 0; i < newRecord.numFrames; ++i) {
+                callStack.append(QString::fromLocal8Bit(pSymbols[i]));
+            }
+            std::free(pSymbols);
+        }
+#endif
+        kLogger.warning()
+                << violationName(newRecord.violation) << "in an engine thread"
+                << newRecord.context.data()
+                << qPrintable(callStack.join(QStringLiteral("\n    ")));
+    }
+
+    if (s_totalsTimer.running() && s_totalsTimer.elapsed() < kTotalsLogInterval) {
+        return;
+    }
+    std::array<int, kNumViolations> totals;
+    for (int i = 0; i < kNumViolations; ++i) {
+        totals[i] = s_totals[i].load(std::memory_order_relaxed);
+    }
+    if (totals == s_loggedTotals) {
+        return;
+    }
+    s_loggedTotals = totals;
+    s_totalsTimer.start();
+    kLogger.warning() << "Violations in the engine threads so far:"
+                      << totals[static_cast<int>(Violation::Allocation)]
+                      << "heap allocations,"
+                      << totals[static_cast<int>(Violation::Lock)] << "mutex locks,"
+                      << totals[static_cast<int>(Violation::Underflow)]
+                      << "effect buffers with underflows";
+}
+
+} // namespace realtime
+
+} // namespace mixxx
+
+// The allocator is replaced for the whole process. With glibc malloc() is
+// interposed, which also covers the allocations of Qt and the other C
+// libraries. Elsewhere only the C++ allocations are detected.
+#if defined(__GLIBC__)
+
+extern "C" {
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pMemory, std::size_t size);
+void __libc_free(void* pMemory);
+
+void* malloc(std::size_t size) {
+    mixxx::realtime::checkAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+    mixxx::realtime::checkAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pMemory, std::size_t size) {
+    mixxx::realtime::checkAllocation();
+    return __libc_realloc(pMemory, size);
+}
+
+void free(void* pMemory) {
+    if (pMemory) {
+        mixxx::realtime::checkAllocation();
+    }
+    __libc_free(pMemory);
+}
+
+} // extern "C"
+
+#else
+
+// The array, nothrow and sized variants call these by default
+void* operator new(std::size_t size) {
+    mixxx::realtime::checkAllocation();
+    void* pMemory = std::malloc(size > 0 ? size : 1);
+    if (!pMemory) {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void operator delete(void* pMemory) noexcept {
+    if (pMemory) {
+        mixxx::realtime::checkAllocation();
+    }
+    std::free(pMemory);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    mixxx::realtime::checkAllocation();
+    const auto alignmentBytes = static_cast<std::size_t>(alignment);
+    // A multiple of the alignment, as required by aligned_alloc()
+    size = std::max(alignmentBytes,
+            (size + alignmentBytes - 1) / alignmentBytes * alignmentBytes);
+#ifdef _WIN32
+    void* pMemory = _aligned_malloc(size, alignmentBytes);
+#else
+    void* pMemory = std::aligned_alloc(alignmentBytes, size);
+#endif
+    if (!pMemory) {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void operator delete(void* pMemory, std::align_val_t alignment) noexcept {
+    Q_UNUSED(alignment);
+    if (pMemory) {
+        mixxx::realtime::checkAllocation();
+    }
+#ifdef _WIN32
+    _aligned_free(pMemory);
+#else
+    std::free(pMemory);
+#endif
+}
+
+#endif
+
+#endif // MIXXX_REALTIME_CHECKS
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace mixxx {
+
+namespace realtime {
+
+/// Detects operations in the engine threads that may block the callback
+/// until the next xrun: heap allocations, mutex locks and floating point
+/// underflows, which produce denormals wherever the denormals are not
+/// flushed to zero.
+///
+/// Only compiled in with the REALTIME_CHECKS build option, which defines
+/// MIXXX_REALTIME_CHECKS. Otherwise all checks are empty inline functions.
+///
+/// The engine threads mark the code that must not block with a
+/// ScopedSection. The heap allocations are detected by replacing the global
+/// allocator, the locks by lockMutex() and the underflows by the floating
+/// point exception flags around each effect. The violations are recorded
+/// with their call stack into a preallocated table without allocating or
+/// locking, and logged by the GUI thread with logViolations().
+class Check {
+  public:
+    enum class Violation {
+        Allocation,
+        Lock,
+        Underflow,
+    };
+
+    /// Marks the calling thread as an engine thread while it exists
+    class ScopedSection {
+      public:
+#ifdef MIXXX_REALTIME_CHECKS
+        ScopedSection();
+        ~ScopedSection();
+#else
+        ScopedSection() = default;
+#endif
+        ScopedSection(const ScopedSection&) = delete;
+        ScopedSection& operator=(const ScopedSection&) = delete;
+    };
+
+    /// Records an underflow that happened in its scope. The context, e.g.
+    /// the id of an effect, must outlive the scope and is copied when the
+    /// violation is recorded.
+    class ScopedUnderflowCheck {
+      public:
+#ifdef MIXXX_REALTIME_CHECKS
+        explicit ScopedUnderflowCheck(const char* pContext);
+        ~ScopedUnderflowCheck();
+#else
+        explicit ScopedUnderflowCheck(const char* pContext) {
+            Q_UNUSED(pContext);
+        }
+#endif
+        ScopedUnderflowCheck(const ScopedUnderflowCheck&) = delete;
+        ScopedUnderflowCheck& operator=(const ScopedUnderflowCheck&) = delete;
+
+#ifdef MIXXX_REALTIME_CHECKS
+      private:
+        const char* const m_pContext;
+        const bool m_active;
+#endif
+    };
+
+#ifdef MIXXX_REALTIME_CHECKS
+    static constexpr bool isEnabled() {
+        return true;
+    }
+    /// Records a violation if the calling thread is an engine thread
+    static void check(Violation violation, const char* pContext = nullptr);
+    /// Logs the violations that have been recorded since the last call.
+    /// Called periodically by the GUI thread.
+    static void logViolations();
+
+    /// The number of violations of this kind that have been detected,
+    /// including those that didn't fit into the table
+    static int totalCount(Violation violation);
+    /// The number of occurrences of the recorded violations of this kind
+    /// with this context
+    static int recordedCount(Violation violation, const char* pContext);
+    /// How many distinct violations can still be recorded
+    static int numFreeRecords();
+#else
+    static constexpr bool isEnabled() {
+        return false;
+    }
+    static void check(Violation violation, const char* pContext = nullptr) {
+        Q_UNUSED(violation);
+        Q_UNUSED(pContext);
+    }
+    static void logViolations() {
+    }
+
+    static int totalCount(Violation violation) {
+        Q_UNUSED(violation);
+        return 0;
+    }
+    static int recordedCount(Violation violation, const char* pContext) {
+        Q_UNUSED(violation);
+        Q_UNUSED(pContext);
+        return 0;
+    }
+    static int numFreeRecords() {
+        return 0;
+    }
+#endif
+};
+
+} // namespace realtime
+
+} // namespace mixxx
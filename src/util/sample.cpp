@@ -5,6 +5,12 @@
 
 #include "engine/engine.h"
 #include "util/math.h"
+#include "util/samplekernels.h"
+
+#if defined(__SAMPLE_KERNELS_X86__) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
 
 #ifdef __WINDOWS__
 #include <QtGlobal>
@@ -38,8 +44,126 @@ constexpr bool useAlignedAlloc() {
             sizeof(CSAMPLE*) == sizeof(size_t);
 }
 
+#ifdef __SAMPLE_KERNELS_X86__
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // The OS must save the XMM and YMM registers on context switches
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // Might be invoked during static initialization
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuSupportsAvx512() {
+#if defined(_MSC_VER)
+    if (!cpuSupportsAvx2()) {
+        return false;
+    }
+    // The OS must also save the opmask and ZMM registers
+    if ((_xgetbv(0) & 0xe6) != 0xe6) {
+        return false;
+    }
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+#endif // __SAMPLE_KERNELS_X86__
+
+const mixxx::samplekernels::Kernels* kernelsFor(
+        SampleUtil::SimdInstructionSet instructionSet) {
+    switch (instructionSet) {
+#ifdef __ARM_NEON
+    case SampleUtil::SimdInstructionSet::Neon:
+        return &mixxx::samplekernels::kNeonKernels;
+#endif
+#ifdef __SAMPLE_KERNELS_X86__
+    case SampleUtil::SimdInstructionSet::Avx2:
+        return cpuSupportsAvx2() ? &mixxx::samplekernels::kAvx2Kernels : nullptr;
+    case SampleUtil::SimdInstructionSet::Avx512:
+        return cpuSupportsAvx512() ? &mixxx::samplekernels::kAvx512Kernels : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+SampleUtil::SimdInstructionSet detectSimdInstructionSet() {
+    // Prefer the widest vectors
+    for (const auto instructionSet : {
+                 SampleUtil::SimdInstructionSet::Avx512,
+                 SampleUtil::SimdInstructionSet::Avx2,
+                 SampleUtil::SimdInstructionSet::Neon,
+         }) {
+        if (kernelsFor(instructionSet)) {
+            return instructionSet;
+        }
+    }
+    return SampleUtil::SimdInstructionSet::Generic;
+}
+
+SampleUtil::SimdInstructionSet s_simdInstructionSet = detectSimdInstructionSet();
+
+// nullptr selects the generic implementation. Functions that are invoked
+// during static initialization before this has been set may still use
+// the generic implementation, which is fine.
+const mixxx::samplekernels::Kernels* s_pKernels = kernelsFor(s_simdInstructionSet);
+
+// kChannels is the channel count if known at compile time, otherwise 0.
+// The inner loop of stereo and stem frames is fully unrolled.
+template<int kChannels>
+void copyReverseFrames(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples,
+        int channelCount) {
+    const int chCount = kChannels > 0 ? kChannels : channelCount;
+    const SINT numFrames = numSamples / chCount;
+    for (SINT frameIdx = 0; frameIdx < numFrames; ++frameIdx) {
+        const CSAMPLE* pSrcFrame = pSrc + (numFrames - 1 - frameIdx) * chCount;
+        CSAMPLE* pDestFrame = pDest + frameIdx * chCount;
+        // note: LOOP VECTORIZED.
+        for (int chIdx = 0; chIdx < chCount; chIdx++) {
+            pDestFrame[chIdx] = pSrcFrame[chIdx];
+        }
+    }
+}
+
 } // anonymous namespace
 
+// static
+bool SampleUtil::isSimdInstructionSetSupported(SimdInstructionSet instructionSet) {
+    return instructionSet == SimdInstructionSet::Generic ||
+            kernelsFor(instructionSet) != nullptr;
+}
+
+// static
+SampleUtil::SimdInstructionSet SampleUtil::simdInstructionSet() {
+    return s_simdInstructionSet;
+}
+
+// static
+bool SampleUtil::setSimdInstructionSet(SimdInstructionSet instructionSet) {
+    if (!isSimdInstructionSetSupported(instructionSet)) {
+        return false;
+    }
+    s_simdInstructionSet = instructionSet;
+    s_pKernels = kernelsFor(instructionSet);
+    return true;
+}
+
 // static
 CSAMPLE* SampleUtil::alloc(SINT size) {
     // To speed up vectorization we align our sample buffers to 16-byte (128
@@ -142,6 +266,10 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        if (s_pKernels) {
+            s_pKernels->applyRampingGain(pBuffer, start_gain, gain_delta, numSamples / 2);
+            return;
+        }
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples / 2; ++i) {
             const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
@@ -201,6 +329,20 @@ void SampleUtil::applyRampingAlternatingGain(CSAMPLE* pBuffer,
 
     const CSAMPLE_GAIN gain1Delta = (gain1 - gain1Old)
             / CSAMPLE_GAIN(numSamples / 2);
+    const CSAMPLE_GAIN gain2Delta = (gain2 - gain2Old)
+            / CSAMPLE_GAIN(numSamples / 2);
+    if (s_pKernels) {
+        // Ramps both channels in a single pass, a constant gain is just a
+        // ramp with a zero delta.
+        s_pKernels->applyRampingAlternatingGain(pBuffer,
+                gain1Old + gain1Delta,
+                gain1Delta,
+                gain2Old + gain2Delta,
+                gain2Delta,
+                numSamples / 2);
+        return;
+    }
+
     if (gain1Delta != 0) {
         const CSAMPLE_GAIN start_gain = gain1Old + gain1Delta;
         for (int i = 0; i < numSamples / 2; ++i) {
@@ -214,8 +356,6 @@ void SampleUtil::applyRampingAlternatingGain(CSAMPLE* pBuffer,
         }
     }
 
-    const CSAMPLE_GAIN gain2Delta = (gain2 - gain2Old)
-            / CSAMPLE_GAIN(numSamples / 2);
     if (gain2Delta != 0) {
         const CSAMPLE_GAIN start_gain = gain2Old + gain2Delta;
         // note: LOOP VECTORIZED. (gcc + clang >= 14)
@@ -248,6 +388,10 @@ void SampleUtil::addWithGain(CSAMPLE* M_RESTRICT pDest,
     if (gain == CSAMPLE_GAIN_ZERO) {
         return;
     }
+    if (s_pKernels) {
+        s_pKernels->addWithGain(pDest, pSrc, gain, numSamples);
+        return;
+    }
 
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < numSamples; ++i) {
@@ -267,6 +411,11 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        if (s_pKernels) {
+            s_pKernels->addWithRampingGain(
+                    pDest, pSrc, start_gain, gain_delta, numSamples / 2);
+            return;
+        }
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples / 2; ++i) {
             const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
@@ -274,6 +423,10 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
         }
     } else {
+        if (s_pKernels) {
+            s_pKernels->addWithGain(pDest, pSrc, old_gain, numSamples);
+            return;
+        }
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
             pDest[i] += pSrc[i] * old_gain;
@@ -281,6 +434,45 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
     }
 }
 
+// static
+void SampleUtil::applyRampingGainAndAddWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_srcGain,
+        CSAMPLE_GAIN new_srcGain,
+        SINT numSamples) {
+    if (old_gain == CSAMPLE_GAIN_ONE && new_gain == CSAMPLE_GAIN_ONE) {
+        addWithRampingGain(pDest, pSrc, old_srcGain, new_srcGain, numSamples);
+        return;
+    }
+    if (old_srcGain == CSAMPLE_GAIN_ZERO && new_srcGain == CSAMPLE_GAIN_ZERO) {
+        applyRampingGain(pDest, old_gain, new_gain, numSamples);
+        return;
+    }
+
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    const CSAMPLE_GAIN srcGain_delta = (new_srcGain - old_srcGain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    if (gain_delta != 0 || srcGain_delta != 0) {
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        const CSAMPLE_GAIN start_srcGain = old_srcGain + srcGain_delta;
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples / 2; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
+            const CSAMPLE_GAIN srcGain = start_srcGain + srcGain_delta * i;
+            pDest[i * 2] = pDest[i * 2] * gain + pSrc[i * 2] * srcGain;
+            pDest[i * 2 + 1] = pDest[i * 2 + 1] * gain + pSrc[i * 2 + 1] * srcGain;
+        }
+    } else {
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples; ++i) {
+            pDest[i] = pDest[i] * old_gain + pSrc[i] * old_srcGain;
+        }
+    }
+}
+
 // static
 void SampleUtil::add2WithGain(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1, CSAMPLE_GAIN gain1,
@@ -293,6 +485,10 @@ void SampleUtil::add2WithGain(CSAMPLE* M_RESTRICT pDest,
         addWithGain(pDest, pSrc1, gain1, numSamples);
         return;
     }
+    if (s_pKernels) {
+        s_pKernels->add2WithGain(pDest, pSrc1, gain1, pSrc2, gain2, numSamples);
+        return;
+    }
 
     // note: LOOP VECTORIZED.
     for (int i = 0; i < numSamples; ++i) {
@@ -316,6 +512,17 @@ void SampleUtil::add3WithGain(CSAMPLE* pDest,
         add2WithGain(pDest, pSrc1, gain1, pSrc2, gain2, numSamples);
         return;
     }
+    if (s_pKernels) {
+        s_pKernels->add3WithGain(pDest,
+                pSrc1,
+                gain1,
+                pSrc2,
+                gain2,
+                pSrc3,
+                gain3,
+                numSamples);
+        return;
+    }
 
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < numSamples; ++i) {
@@ -365,6 +572,11 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        if (s_pKernels) {
+            s_pKernels->copyWithRampingGain(
+                    pDest, pSrc, start_gain, gain_delta, numSamples / 2);
+            return;
+        }
         // note: LOOP VECTORIZED only with "int i" (not SINT i).
         for (int i = 0; i < numSamples / 2; ++i) {
             const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
@@ -390,6 +602,10 @@ void SampleUtil::convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
     // is the highest valid sample. Note that this means that although some
     // sample values convert to -1.0, none will convert to +1.0.
     DEBUG_ASSERT(-SAMPLE_MINIMUM >= SAMPLE_MAXIMUM);
+    if (s_pKernels) {
+        s_pKernels->convertS16ToFloat32(pDest, pSrc, numSamples);
+        return;
+    }
     const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < numSamples; ++i) {
@@ -455,13 +671,26 @@ CSAMPLE SampleUtil::sumSquared(const CSAMPLE* pBuffer, SINT numSamples) {
     return sumSq;
 }
 
+// static
+CSAMPLE SampleUtil::dotProduct(
+        const CSAMPLE* pSrc1, const CSAMPLE* pSrc2, SINT numSamples) {
+    if (s_pKernels) {
+        return s_pKernels->dotProduct(pSrc1, pSrc2, numSamples);
+    }
+    CSAMPLE sum = CSAMPLE_ZERO;
+    for (SINT i = 0; i < numSamples; ++i) {
+        sum += pSrc1[i] * pSrc2[i];
+    }
+    return sum;
+}
+
 // static
 CSAMPLE SampleUtil::rms(const CSAMPLE* pBuffer, SINT numSamples) {
     return sqrtf(sumSquared(pBuffer, numSamples) / numSamples);
 }
 
 CSAMPLE SampleUtil::maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE max = pBuffer[0];
+    CSAMPLE max = abs(pBuffer[0]);
     // note: LOOP VECTORIZED.
     for (SINT i = 1; i < numSamples; ++i) {
         CSAMPLE absValue = abs(pBuffer[i]);
@@ -887,7 +1116,11 @@ void SampleUtil::copyOneStereoFromMulti(
         SINT numFrames,
         mixxx::audio::ChannelCount numChannels,
         int sourceChannel) {
-    DEBUG_ASSERT(numChannels > mixxx::audio::ChannelCount::stereo());
+    DEBUG_ASSERT(sourceChannel + 2 <= numChannels);
+    if (numChannels == mixxx::audio::ChannelCount::stereo()) {
+        copy(pDest, pSrc, numFrames * 2);
+        return;
+    }
     // forward loop
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < numFrames; ++i) {
@@ -896,6 +1129,26 @@ void SampleUtil::copyOneStereoFromMulti(
     }
 }
 
+// static
+void SampleUtil::copyMonoInMultiToDualMono(
+        CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames,
+        mixxx::audio::ChannelCount numChannels,
+        int sourceChannel) {
+    DEBUG_ASSERT(sourceChannel < numChannels);
+    if (numChannels == mixxx::audio::ChannelCount::mono()) {
+        copyMonoToDualMono(pDest, pSrc, numFrames);
+        return;
+    }
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        const CSAMPLE s = pSrc[i * numChannels + sourceChannel];
+        pDest[i * 2] = s;
+        pDest[i * 2 + 1] = s;
+    }
+}
+
 // static
 void SampleUtil::insertStereoToMulti(
         CSAMPLE* M_RESTRICT pDest,
@@ -913,6 +1166,40 @@ void SampleUtil::insertStereoToMulti(
     }
 }
 
+// static
+void SampleUtil::insertClampStereoToMulti(
+        CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames,
+        mixxx::audio::ChannelCount numChannels,
+        int channelOffset) {
+    DEBUG_ASSERT(channelOffset + 2 <= numChannels);
+    if (numChannels == mixxx::audio::ChannelCount::stereo()) {
+        copyClampBuffer(pDest, pSrc, numFrames * 2);
+        return;
+    }
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[i * numChannels + channelOffset] = clampSample(pSrc[i * 2]);
+        pDest[i * numChannels + channelOffset + 1] = clampSample(pSrc[i * 2 + 1]);
+    }
+}
+
+// static
+void SampleUtil::insertClampStereoToMonoInMulti(
+        CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames,
+        mixxx::audio::ChannelCount numChannels,
+        int channelOffset) {
+    DEBUG_ASSERT(channelOffset < numChannels);
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[i * numChannels + channelOffset] =
+                clampSample((pSrc[i * 2] + pSrc[i * 2 + 1]) * 0.5f);
+    }
+}
+
 // static
 void SampleUtil::reverse(CSAMPLE* pBuffer, SINT numSamples) {
     for (SINT j = 0; j < numSamples / 4; ++j) {
@@ -932,12 +1219,18 @@ void SampleUtil::copyReverse(CSAMPLE* M_RESTRICT pDest,
         SINT numSamples,
         int channelCount) {
     DEBUG_ASSERT(numSamples % channelCount == 0);
-    for (SINT frameIdx = 0; frameIdx < numSamples / channelCount; ++frameIdx) {
-        const int endpos = (numSamples - 1) - frameIdx * channelCount;
-        // note: LOOP VECTORIZED.
-        for (int chIdx = 0; chIdx < channelCount; chIdx++) {
-            pDest[frameIdx * channelCount + chIdx] = pSrc[endpos - channelCount + chIdx + 1];
-        }
+    switch (channelCount) {
+    case mixxx::audio::ChannelCount::stereo():
+        copyReverseFrames<mixxx::audio::ChannelCount::stereo()>(
+                pDest, pSrc, numSamples, channelCount);
+        break;
+    case mixxx::audio::ChannelCount::stem():
+        copyReverseFrames<mixxx::audio::ChannelCount::stem()>(
+                pDest, pSrc, numSamples, channelCount);
+        break;
+    default:
+        copyReverseFrames<0>(pDest, pSrc, numSamples, channelCount);
+        break;
     }
 }
 // static
@@ -25,6 +25,26 @@ class SampleUtil {
     // This is some legacy, we cannot easily revert.
     static constexpr double kPlayPositionChannels = 2.0;
 
+    // The explicitly vectorized implementations of the most frequently used
+    // functions are selected at runtime, depending on the features of the
+    // CPU. Generic uses the auto-vectorized loops of the compiler.
+    enum class SimdInstructionSet {
+        Generic,
+        Neon,
+        Avx2,
+        Avx512,
+    };
+
+    static bool isSimdInstructionSetSupported(SimdInstructionSet instructionSet);
+
+    // The instruction set that is currently used
+    static SimdInstructionSet simdInstructionSet();
+
+    // Overrides the detected instruction set, intended for tests and
+    // benchmarks. Returns false if not supported. Not thread-safe, must
+    // not be called while audio is processed.
+    static bool setSimdInstructionSet(SimdInstructionSet instructionSet);
+
     // Allocated a buffer of CSAMPLE's with length size. Ensures that the buffer
     // is 16-byte aligned for SSE enhancement.
     [[nodiscard]] static CSAMPLE* alloc(SINT size);
@@ -199,6 +219,18 @@ class SampleUtil {
             CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain,
             SINT numSamples);
 
+    // Multiply each sample of pDest ramping from old_gain to new_gain and
+    // add pSrc multiplied by a gain ramping from old_srcGain to new_srcGain,
+    // in a single pass. Equivalent to addWithRampingGain() followed by
+    // applyRampingGain() with the gains combined.
+    static void applyRampingGainAndAddWithRampingGain(CSAMPLE* pDest,
+            CSAMPLE_GAIN old_gain,
+            CSAMPLE_GAIN new_gain,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN old_srcGain,
+            CSAMPLE_GAIN new_srcGain,
+            SINT numSamples);
+
     // Add to each sample of pDest, pSrc1 multiplied by gain1 plus pSrc2
     // multiplied by gain2
     static void add2WithGain(CSAMPLE* pDest, const CSAMPLE* pSrc1,
@@ -231,6 +263,10 @@ class SampleUtil {
     // Returns the sum of the squared values of the buffer.
     static CSAMPLE sumSquared(const CSAMPLE* pBuffer, SINT numSamples);
 
+    // Returns the sum of the products of the values of both buffers, e.g.
+    // for the cross-correlation of two signals.
+    static CSAMPLE dotProduct(const CSAMPLE* pSrc1, const CSAMPLE* pSrc2, SINT numSamples);
+
     // Returns the root mean square of the values of the buffer.
     static CSAMPLE rms(const CSAMPLE* pBuffer, SINT numSamples);
 
@@ -385,12 +421,23 @@ class SampleUtil {
     //    1L1R
     // With sourceChannel=3, dst will take the value of
     //    4L4R
+    // numChannels may be stereo.
     static void copyOneStereoFromMulti(CSAMPLE* pDest,
             const CSAMPLE* pSrc,
             SINT numFrames,
             mixxx::audio::ChannelCount numChannels,
             int sourceChannel = 0);
 
+    // Copies channel sourceChannel of the interleaved pSrc as dual mono
+    // samples into pDest. Used to read a mono input directly from an
+    // interleaved device buffer. numChannels may be mono.
+    // (numFrames * 2) samples will be written into pDest
+    static void copyMonoInMultiToDualMono(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            SINT numFrames,
+            mixxx::audio::ChannelCount numChannels,
+            int sourceChannel);
+
     // Copies and strips interleaved stereo sample data in pSrc with
     // down to multi-channel samples into pDest. Samples will be written at the
     // channel pointed by channelOffset. Samples from all other channels will be
@@ -411,6 +458,23 @@ class SampleUtil {
             mixxx::audio::ChannelCount numChannels,
             int channelOffset);
 
+    // Like insertStereoToMulti(), but limits the values to the valid range of
+    // CSAMPLE. Used to write an engine output directly into an interleaved
+    // device buffer. numChannels may be stereo.
+    static void insertClampStereoToMulti(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            SINT numFrames,
+            mixxx::audio::ChannelCount numChannels,
+            int channelOffset);
+
+    // Mixes the stereo pSrc down to mono and writes it with limited values
+    // into channel channelOffset of the interleaved pDest.
+    static void insertClampStereoToMonoInMulti(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            SINT numFrames,
+            mixxx::audio::ChannelCount numChannels,
+            int channelOffset);
+
     // reverses stereo sample in place
     static void reverse(CSAMPLE* pBuffer, SINT numSamples);
 
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "util/types.h"
+
+/// Explicitly vectorized implementations of the hot loops in SampleUtil.
+///
+/// Each instruction set is compiled in a separate translation unit with the
+/// corresponding compiler flags. SampleUtil selects the widest supported
+/// implementation at runtime, so portable builds still benefit from recent
+/// CPUs. The callers have already handled all special cases like zero or
+/// unity gains, the kernels only contain the loops.
+///
+/// Ramping kernels operate on interleaved stereo frames and calculate the
+/// gain of frame i as startGain + gainDelta * i, exactly like the generic
+/// implementation.
+namespace mixxx::samplekernels {
+
+struct Kernels {
+    void (*applyRampingGain)(CSAMPLE* pBuffer,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*applyRampingAlternatingGain)(CSAMPLE* pBuffer,
+            CSAMPLE_GAIN startGain1,
+            CSAMPLE_GAIN gain1Delta,
+            CSAMPLE_GAIN startGain2,
+            CSAMPLE_GAIN gain2Delta,
+            SINT numFrames);
+    void (*addWithGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN gain,
+            SINT numSamples);
+    void (*addWithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*add2WithGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* pSrc2,
+            CSAMPLE_GAIN gain2,
+            SINT numSamples);
+    void (*add3WithGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* pSrc2,
+            CSAMPLE_GAIN gain2,
+            const CSAMPLE* pSrc3,
+            CSAMPLE_GAIN gain3,
+            SINT numSamples);
+    void (*copyWithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*convertS16ToFloat32)(CSAMPLE* pDest,
+            const SAMPLE* pSrc,
+            SINT numSamples);
+    CSAMPLE (*dotProduct)(const CSAMPLE* pSrc1,
+            const CSAMPLE* pSrc2,
+            SINT numSamples);
+};
+
+#ifdef __SAMPLE_KERNELS_X86__
+extern const Kernels kAvx2Kernels;
+extern const Kernels kAvx512Kernels;
+#endif
+
+#ifdef __ARM_NEON
+extern const Kernels kNeonKernels;
+#endif
+
+} // namespace mixxx::samplekernels
@@ -0,0 +1,47 @@
+// Compiled with AVX2 enabled, see CMakeLists.txt. Only executed if
+// supported by the CPU.
+
+#include <immintrin.h>
+
+#include "util/samplekernels_impl.h"
+
+namespace mixxx::samplekernels {
+
+namespace {
+
+struct Avx2 {
+    using Type = __m256;
+    static constexpr SINT kWidth = 8;
+
+    static Type load(const CSAMPLE* p) {
+        return _mm256_loadu_ps(p);
+    }
+    static void store(CSAMPLE* p, Type v) {
+        _mm256_storeu_ps(p, v);
+    }
+    static Type set1(CSAMPLE value) {
+        return _mm256_set1_ps(value);
+    }
+    static Type add(Type lhs, Type rhs) {
+        return _mm256_add_ps(lhs, rhs);
+    }
+    static Type mul(Type lhs, Type rhs) {
+        return _mm256_mul_ps(lhs, rhs);
+    }
+    static Type stereo(CSAMPLE left, CSAMPLE right) {
+        return _mm256_setr_ps(left, right, left, right, left, right, left, right);
+    }
+    static Type frameOffsets() {
+        return _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+    }
+    static Type loadS16(const SAMPLE* p) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples));
+    }
+};
+
+} // anonymous namespace
+
+const Kernels kAvx2Kernels = makeKernels<Avx2>();
+
+} // namespace mixxx::samplekernels
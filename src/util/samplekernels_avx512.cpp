@@ -0,0 +1,62 @@
+// Compiled with AVX-512F enabled, see CMakeLists.txt. Only executed if
+// supported by the CPU.
+
+#include <immintrin.h>
+
+#include "util/samplekernels_impl.h"
+
+namespace mixxx::samplekernels {
+
+namespace {
+
+struct Avx512 {
+    using Type = __m512;
+    static constexpr SINT kWidth = 16;
+
+    static Type load(const CSAMPLE* p) {
+        return _mm512_loadu_ps(p);
+    }
+    static void store(CSAMPLE* p, Type v) {
+        _mm512_storeu_ps(p, v);
+    }
+    static Type set1(CSAMPLE value) {
+        return _mm512_set1_ps(value);
+    }
+    static Type add(Type lhs, Type rhs) {
+        return _mm512_add_ps(lhs, rhs);
+    }
+    static Type mul(Type lhs, Type rhs) {
+        return _mm512_mul_ps(lhs, rhs);
+    }
+    static Type stereo(CSAMPLE left, CSAMPLE right) {
+        return _mm512_setr_ps(left,
+                right,
+                left,
+                right,
+                left,
+                right,
+                left,
+                right,
+                left,
+                right,
+                left,
+                right,
+                left,
+                right,
+                left,
+                right);
+    }
+    static Type frameOffsets() {
+        return _mm512_setr_ps(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+    }
+    static Type loadS16(const SAMPLE* p) {
+        const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(samples));
+    }
+};
+
+} // anonymous namespace
+
+const Kernels kAvx512Kernels = makeKernels<Avx512>();
+
+} // namespace mixxx::samplekernels
@@ -0,0 +1,241 @@
+#pragma once
+
+// Generic kernel templates, only to be included by the translation units of
+// the individual instruction sets. The template parameter V provides the
+// vector operations of the instruction set:
+//
+//   V::Type, V::kWidth (number of floats per vector)
+//   V::load(), V::store(), V::set1(), V::add(), V::mul()
+//   V::stereo(left, right) -> { left, right, left, right, ... }
+//   V::frameOffsets() -> { 0, 0, 1, 1, 2, 2, ... }
+//   V::loadS16() (converts kWidth 16-bit samples to float)
+//
+// All definitions have internal linkage, because the same templates are
+// compiled with different flags in multiple translation units.
+
+#include "util/samplekernels.h"
+
+namespace mixxx::samplekernels {
+
+namespace {
+
+constexpr CSAMPLE kS16ConversionFactor = SAMPLE_MINIMUM * -1.0f;
+
+template<typename V>
+void applyRampingGain(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    constexpr SINT kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::set1(startGain);
+    const auto vGainDelta = V::set1(gainDelta);
+    const auto vFrameStep = V::set1(static_cast<CSAMPLE>(kFramesPerVector));
+    auto vFrame = V::frameOffsets();
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const auto vGain = V::add(vStartGain, V::mul(vGainDelta, vFrame));
+        CSAMPLE* p = pBuffer + i * 2;
+        V::store(p, V::mul(V::load(p), vGain));
+        vFrame = V::add(vFrame, vFrameStep);
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+template<typename V>
+void applyRampingAlternatingGain(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gain1Delta,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gain2Delta,
+        SINT numFrames) {
+    constexpr SINT kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::stereo(startGain1, startGain2);
+    const auto vGainDelta = V::stereo(gain1Delta, gain2Delta);
+    const auto vFrameStep = V::set1(static_cast<CSAMPLE>(kFramesPerVector));
+    auto vFrame = V::frameOffsets();
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const auto vGain = V::add(vStartGain, V::mul(vGainDelta, vFrame));
+        CSAMPLE* p = pBuffer + i * 2;
+        V::store(p, V::mul(V::load(p), vGain));
+        vFrame = V::add(vFrame, vFrameStep);
+    }
+    for (; i < numFrames; ++i) {
+        pBuffer[i * 2] *= startGain1 + gain1Delta * i;
+        pBuffer[i * 2 + 1] *= startGain2 + gain2Delta * i;
+    }
+}
+
+template<typename V>
+void addWithGain(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    const auto vGain = V::set1(gain);
+    SINT i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        V::store(pDest + i,
+                V::add(V::load(pDest + i), V::mul(V::load(pSrc + i), vGain)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+template<typename V>
+void addWithRampingGain(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    constexpr SINT kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::set1(startGain);
+    const auto vGainDelta = V::set1(gainDelta);
+    const auto vFrameStep = V::set1(static_cast<CSAMPLE>(kFramesPerVector));
+    auto vFrame = V::frameOffsets();
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const auto vGain = V::add(vStartGain, V::mul(vGainDelta, vFrame));
+        const SINT offset = i * 2;
+        V::store(pDest + offset,
+                V::add(V::load(pDest + offset),
+                        V::mul(V::load(pSrc + offset), vGain)));
+        vFrame = V::add(vFrame, vFrameStep);
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+template<typename V>
+void add2WithGain(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    const auto vGain1 = V::set1(gain1);
+    const auto vGain2 = V::set1(gain2);
+    SINT i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        const auto vSum = V::add(
+                V::mul(V::load(pSrc1 + i), vGain1),
+                V::mul(V::load(pSrc2 + i), vGain2));
+        V::store(pDest + i, V::add(V::load(pDest + i), vSum));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+template<typename V>
+void add3WithGain(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    const auto vGain1 = V::set1(gain1);
+    const auto vGain2 = V::set1(gain2);
+    const auto vGain3 = V::set1(gain3);
+    SINT i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        const auto vSum = V::add(
+                V::add(V::mul(V::load(pSrc1 + i), vGain1),
+                        V::mul(V::load(pSrc2 + i), vGain2)),
+                V::mul(V::load(pSrc3 + i), vGain3));
+        V::store(pDest + i, V::add(V::load(pDest + i), vSum));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+template<typename V>
+void copyWithRampingGain(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    constexpr SINT kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::set1(startGain);
+    const auto vGainDelta = V::set1(gainDelta);
+    const auto vFrameStep = V::set1(static_cast<CSAMPLE>(kFramesPerVector));
+    auto vFrame = V::frameOffsets();
+    SINT i = 0;
+    for (; i + kFramesPerVector <= numFrames; i += kFramesPerVector) {
+        const auto vGain = V::add(vStartGain, V::mul(vGainDelta, vFrame));
+        const SINT offset = i * 2;
+        V::store(pDest + offset, V::mul(V::load(pSrc + offset), vGain));
+        vFrame = V::add(vFrame, vFrameStep);
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+template<typename V>
+void convertS16ToFloat32(CSAMPLE* pDest,
+        const SAMPLE* pSrc,
+        SINT numSamples) {
+    // Multiplying with the reciprocal of a power of 2 is exact and gives
+    // the same results as the division in the generic implementation.
+    const auto vFactor = V::set1(1.0f / kS16ConversionFactor);
+    SINT i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        V::store(pDest + i, V::mul(V::loadS16(pSrc + i), vFactor));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) / kS16ConversionFactor;
+    }
+}
+
+template<typename V>
+CSAMPLE dotProduct(const CSAMPLE* pSrc1,
+        const CSAMPLE* pSrc2,
+        SINT numSamples) {
+    auto vSum = V::set1(CSAMPLE_ZERO);
+    SINT i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        vSum = V::add(vSum, V::mul(V::load(pSrc1 + i), V::load(pSrc2 + i)));
+    }
+    CSAMPLE lanes[V::kWidth];
+    V::store(lanes, vSum);
+    CSAMPLE sum = CSAMPLE_ZERO;
+    for (SINT lane = 0; lane < V::kWidth; ++lane) {
+        sum += lanes[lane];
+    }
+    for (; i < numSamples; ++i) {
+        sum += pSrc1[i] * pSrc2[i];
+    }
+    return sum;
+}
+
+template<typename V>
+constexpr Kernels makeKernels() {
+    return Kernels{
+            applyRampingGain<V>,
+            applyRampingAlternatingGain<V>,
+            addWithGain<V>,
+            addWithRampingGain<V>,
+            add2WithGain<V>,
+            add3WithGain<V>,
+            copyWithRampingGain<V>,
+            convertS16ToFloat32<V>,
+            dotProduct<V>,
+    };
+}
+
+} // anonymous namespace
+
+} // namespace mixxx::samplekernels
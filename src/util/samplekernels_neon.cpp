@@ -0,0 +1,52 @@
+// NEON is either part of the baseline (AArch64) or has been enabled for
+// the whole build (ARMv7 with -mfpu=neon), so no runtime detection is
+// needed.
+#ifdef __ARM_NEON
+
+#include <arm_neon.h>
+
+#include "util/samplekernels_impl.h"
+
+namespace mixxx::samplekernels {
+
+namespace {
+
+struct Neon {
+    using Type = float32x4_t;
+    static constexpr SINT kWidth = 4;
+
+    static Type load(const CSAMPLE* p) {
+        return vld1q_f32(p);
+    }
+    static void store(CSAMPLE* p, Type v) {
+        vst1q_f32(p, v);
+    }
+    static Type set1(CSAMPLE value) {
+        return vdupq_n_f32(value);
+    }
+    static Type add(Type lhs, Type rhs) {
+        return vaddq_f32(lhs, rhs);
+    }
+    static Type mul(Type lhs, Type rhs) {
+        return vmulq_f32(lhs, rhs);
+    }
+    static Type stereo(CSAMPLE left, CSAMPLE right) {
+        const CSAMPLE values[kWidth] = {left, right, left, right};
+        return vld1q_f32(values);
+    }
+    static Type frameOffsets() {
+        const CSAMPLE values[kWidth] = {0, 0, 1, 1};
+        return vld1q_f32(values);
+    }
+    static Type loadS16(const SAMPLE* p) {
+        return vcvtq_f32_s32(vmovl_s16(vld1_s16(p)));
+    }
+};
+
+} // anonymous namespace
+
+const Kernels kNeonKernels = makeKernels<Neon>();
+
+} // namespace mixxx::samplekernels
+
+#endif // __ARM_NEON
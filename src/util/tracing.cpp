@@ -0,0 +1,273 @@
+#include "util/tracing.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace tracing {
+
+namespace {
+
+const Logger kLogger("Tracing");
+
+constexpr int kMaxEventIds = 1024;
+
+// One for each sound device that runs a callback
+constexpr int kReservedThreadBuffers = 4;
+
+constexpr quint64 kCapacity = kEventsPerThread;
+
+// The fields are atomic, because the slots are read by collectEvents()
+// while the thread might overwrite them. Relaxed atomics are plain loads
+// and stores on all supported platforms.
+struct EventSlot {
+    std::atomic<EventId> id;
+    std::atomic<qint64> startNanos;
+    std::atomic<qint64> endNanos;
+};
+
+struct ThreadBuffer {
+    int threadId;
+    QString threadName;
+    // Only written by the owning thread
+    std::atomic<quint64> writeCount{0};
+    std::array<EventSlot, kEventsPerThread> slots;
+};
+
+// The names are interned by the call sites during the dynamic
+// initialization, before or after that of this file.
+struct EventRegistry {
+    QMutex mutex;
+    // Guarded by mutex
+    std::unordered_map<std::string_view, EventId> eventIdsByName;
+    int eventCount = 0;
+};
+
+EventRegistry& eventRegistry() {
+    static EventRegistry s_registry;
+    return s_registry;
+}
+
+// Constant initialized
+std::array<std::atomic<const char*>, kMaxEventIds> s_eventNames;
+
+QMutex s_mutex;
+
+// Guarded by s_mutex. Buffers are kept after their thread has finished
+// so that its events are still exported.
+std::vector<std::unique_ptr<ThreadBuffer>> s_threadBuffers;
+// Guarded by s_mutex. Allocated once by setEnabled(), the first ones
+// have been taken by registerCallbackThread().
+std::vector<std::unique_ptr<ThreadBuffer>> s_reservedThreadBuffers;
+std::size_t s_takenReservedThreadBufferCount = 0;
+int s_threadCount = 0;
+
+thread_local ThreadBuffer* t_pThreadBuffer = nullptr;
+
+/// Must be invoked with s_mutex locked
+void initThreadBuffer(ThreadBuffer* pBuffer, const QString& name) {
+    pBuffer->threadId = ++s_threadCount;
+    pBuffer->threadName = name;
+    t_pThreadBuffer = pBuffer;
+}
+
+/// Must be invoked with s_mutex locked
+template<typename F>
+void forEachThreadBuffer(F function) {
+    for (const auto& pBuffer : s_threadBuffers) {
+        function(pBuffer.get());
+    }
+    for (std::size_t i = 0; i < s_takenReservedThreadBufferCount; ++i) {
+        function(s_reservedThreadBuffers[i].get());
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+qint64 now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+void record(EventId id, qint64 startNanos, qint64 endNanos) {
+    ThreadBuffer* pBuffer = t_pThreadBuffer;
+    if (!pBuffer) {
+        // Not registered
+        return;
+    }
+    const quint64 index = pBuffer->writeCount.load(std::memory_order_relaxed);
+    EventSlot& slot = pBuffer->slots[index % kCapacity];
+    slot.id.store(id, std::memory_order_relaxed);
+    slot.startNanos.store(startNanos, std::memory_order_relaxed);
+    slot.endNanos.store(endNanos, std::memory_order_relaxed);
+    pBuffer->writeCount.store(index + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+EventId internEvent(const char* name) {
+    EventRegistry& registry = eventRegistry();
+    const auto locker = lockMutex(&registry.mutex);
+    const auto it = registry.eventIdsByName.find(name);
+    if (it != registry.eventIdsByName.end()) {
+        return it->second;
+    }
+    // Id 0 is used for all events that exceed the limit
+    VERIFY_OR_DEBUG_ASSERT(registry.eventCount < kMaxEventIds) {
+        return 0;
+    }
+    const auto id = static_cast<EventId>(registry.eventCount++);
+    s_eventNames[id].store(name, std::memory_order_release);
+    registry.eventIdsByName.emplace(name, id);
+    return id;
+}
+
+const char* eventName(EventId id) {
+    VERIFY_OR_DEBUG_ASSERT(id < kMaxEventIds) {
+        return "";
+    }
+    const char* pName = s_eventNames[id].load(std::memory_order_acquire);
+    return pName ? pName : "";
+}
+
+void registerCurrentThread(const QString& name) {
+    if (!isEnabled() || t_pThreadBuffer) {
+        return;
+    }
+    auto pBuffer = std::make_unique<ThreadBuffer>();
+    const auto locker = lockMutex(&s_mutex);
+    initThreadBuffer(pBuffer.get(), name);
+    s_threadBuffers.push_back(std::move(pBuffer));
+}
+
+void registerCallbackThread(const QString& name) {
+    if (!isEnabled() || t_pThreadBuffer) {
+        return;
+    }
+    const auto locker = lockMutex(&s_mutex);
+    if (s_takenReservedThreadBufferCount >= s_reservedThreadBuffers.size()) {
+        return;
+    }
+    initThreadBuffer(
+            s_reservedThreadBuffers[s_takenReservedThreadBufferCount++].get(),
+            name);
+}
+
+void setEnabled(bool enabled) {
+    if (enabled) {
+        const auto locker = lockMutex(&s_mutex);
+        if (s_reservedThreadBuffers.empty()) {
+            s_reservedThreadBuffers.reserve(kReservedThreadBuffers);
+            for (int i = 0; i < kReservedThreadBuffers; ++i) {
+                s_reservedThreadBuffers.push_back(std::make_unique<ThreadBuffer>());
+            }
+        }
+    }
+    detail::s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::vector<ThreadEvents> collectEvents() {
+    std::vector<ThreadEvents> result;
+    const auto locker = lockMutex(&s_mutex);
+    result.reserve(s_threadBuffers.size() + s_takenReservedThreadBufferCount);
+    forEachThreadBuffer([&result](const ThreadBuffer* pBuffer) {
+        ThreadEvents threadEvents;
+        threadEvents.threadId = pBuffer->threadId;
+        threadEvents.threadName = pBuffer->threadName;
+
+        const quint64 endIndex = pBuffer->writeCount.load(std::memory_order_acquire);
+        const quint64 beginIndex =
+                endIndex > kCapacity ? endIndex - kCapacity : 0;
+        threadEvents.events.reserve(endIndex - beginIndex);
+        for (quint64 index = beginIndex; index < endIndex; ++index) {
+            const EventSlot& slot = pBuffer->slots[index % kCapacity];
+            threadEvents.events.push_back(Event{
+                    slot.id.load(std::memory_order_relaxed),
+                    slot.startNanos.load(std::memory_order_relaxed),
+                    slot.endNanos.load(std::memory_order_relaxed)});
+        }
+
+        // Skip the slots that might have been overwritten while copying,
+        // including the one that is currently being written.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 writtenIndex = pBuffer->writeCount.load(std::memory_order_relaxed);
+        if (writtenIndex + 1 > beginIndex + kCapacity) {
+            const quint64 overwrittenCount = std::min(
+                    writtenIndex + 1 - (beginIndex + kCapacity),
+                    endIndex - beginIndex);
+            threadEvents.events.erase(threadEvents.events.begin(),
+                    threadEvents.events.begin() + overwrittenCount);
+        }
+        result.push_back(std::move(threadEvents));
+    });
+    return result;
+}
+
+void clearEvents() {
+    const auto locker = lockMutex(&s_mutex);
+    forEachThreadBuffer([](ThreadBuffer* pBuffer) {
+        pBuffer->writeCount.store(0, std::memory_order_relaxed);
+    });
+}
+
+bool writeChromeTrace(const QString& filePath) {
+    QJsonArray traceEvents;
+    for (const auto& threadEvents : collectEvents()) {
+        traceEvents.append(QJsonObject{
+                {QStringLiteral("name"), QStringLiteral("thread_name")},
+                {QStringLiteral("ph"), QStringLiteral("M")},
+                {QStringLiteral("pid"), 1},
+                {QStringLiteral("tid"), threadEvents.threadId},
+                {QStringLiteral("args"),
+                        QJsonObject{{QStringLiteral("name"), threadEvents.threadName}}},
+        });
+        for (const auto& event : threadEvents.events) {
+            // Complete events with timestamps in microseconds
+            traceEvents.append(QJsonObject{
+                    {QStringLiteral("name"), QString::fromUtf8(eventName(event.id))},
+                    {QStringLiteral("ph"), QStringLiteral("X")},
+                    {QStringLiteral("pid"), 1},
+                    {QStringLiteral("tid"), threadEvents.threadId},
+                    {QStringLiteral("ts"), event.startNanos / 1000.0},
+                    {QStringLiteral("dur"), (event.endNanos - event.startNanos) / 1000.0},
+            });
+        }
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        kLogger.warning() << "Failed to open trace file" << filePath << file.errorString();
+        return false;
+    }
+    const QJsonObject trace{
+            {QStringLiteral("traceEvents"), traceEvents},
+            {QStringLiteral("displayTimeUnit"), QStringLiteral("ns")},
+    };
+    if (file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0) {
+        kLogger.warning() << "Failed to write trace file" << filePath << file.errorString();
+        return false;
+    }
+    kLogger.info() << "Wrote" << traceEvents.size() << "trace events to" << filePath;
+    return true;
+}
+
+} // namespace tracing
+
+} // namespace mixxx
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/// Low overhead tracing of the execution time of code sections.
+///
+/// Every thread records the completed sections into its own ring buffer
+/// that is written without locks. The names of the call sites are interned
+/// before main() and not touched again when recording. A section costs a
+/// relaxed load while tracing is disabled and two clock reads when it is
+/// enabled, i.e. the instrumentation can stay in release builds.
+///
+/// Only the threads that have registered themselves with
+/// registerCurrentThread() or registerCallbackThread() are traced, the
+/// sections of other threads are not recorded.
+///
+/// Usage:
+///
+///   void EngineBuffer::process(...) {
+///       MIXXX_TRACE_SCOPE("EngineBuffer::process");
+///       ...
+///   }
+///
+/// The recorded events are exported in the Chrome trace format, which can be
+/// opened with https://ui.perfetto.dev or chrome://tracing.
+namespace mixxx {
+
+namespace tracing {
+
+typedef quint16 EventId;
+
+/// The number of events that are kept per thread, older events are
+/// overwritten.
+constexpr int kEventsPerThread = 1 << 13;
+
+/// Returns the id of the named event, the name is registered on first use.
+/// The name must outlive the tracing, i.e. it should be a string literal.
+EventId internEvent(const char* name);
+
+/// Returns the name that has been registered for this id.
+const char* eventName(EventId id);
+
+/// Allocates the ring buffer of the calling thread, which must not be
+/// a real-time thread. Does nothing if tracing is disabled or the thread
+/// has already been registered.
+void registerCurrentThread(const QString& name);
+
+/// Like registerCurrentThread(), but takes one of the ring buffers that
+/// have been allocated by setEnabled() for the sound device callbacks.
+/// Neither allocates nor queries the QThread, so it can be invoked from
+/// the first callback. The thread is not traced if all reserved ring buffers
+/// have been taken.
+void registerCallbackThread(const QString& name);
+
+namespace detail {
+
+inline std::atomic<bool> s_enabled = false;
+
+/// A string literal as a template argument.
+template<std::size_t N>
+struct EventName {
+    constexpr EventName(const char (&name)[N]) {
+        std::copy_n(name, N, chars);
+    }
+    char chars[N];
+};
+
+/// The id of the call sites of MIXXX_TRACE_SCOPE() with that name. The
+/// template argument objects live as long as the program, so can be
+/// interned. Initialized before main() like all variables with static
+/// storage duration, i.e. the first execution of a call site neither
+/// locks nor inserts into the map of the names.
+template<EventName name>
+inline const EventId kEventId = internEvent(name.chars);
+
+/// Nanoseconds of a monotonic clock.
+qint64 now();
+
+void record(EventId id, qint64 startNanos, qint64 endNanos);
+
+} // namespace detail
+
+inline bool isEnabled() {
+    return detail::s_enabled.load(std::memory_order_relaxed);
+}
+
+/// The first invocation with true allocates the ring buffers that are
+/// reserved for registerCallbackThread().
+void setEnabled(bool enabled);
+
+/// Records the execution time of the enclosing scope if tracing is enabled
+/// when entering it.
+class Scope final {
+  public:
+    explicit Scope(EventId id)
+            : m_id(id),
+              m_startNanos(isEnabled() ? detail::now() : -1) {
+    }
+    ~Scope() {
+        if (m_startNanos >= 0) {
+            detail::record(m_id, m_startNanos, detail::now());
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const EventId m_id;
+    const qint64 m_startNanos;
+};
+
+struct Event {
+    EventId id;
+    qint64 startNanos;
+    qint64 endNanos;
+};
+
+/// A copy of the events that have been recorded by a thread, ordered by
+/// the end of the events.
+struct ThreadEvents {
+    int threadId;
+    QString threadName;
+    std::vector<Event> events;
+};
+
+/// Copies the recorded events of all threads. Can be invoked while tracing,
+/// the events that are being overwritten by the writing threads are skipped.
+std::vector<ThreadEvents> collectEvents();
+
+/// Discards all recorded events, must not be invoked while tracing.
+void clearEvents();
+
+/// Writes the recorded events in the Chrome trace JSON format.
+bool writeChromeTrace(const QString& filePath);
+
+} // namespace tracing
+
+} // namespace mixxx
+
+#define MIXXX_TRACE_CONCAT_INNER(a, b) a##b
+#define MIXXX_TRACE_CONCAT(a, b) MIXXX_TRACE_CONCAT_INNER(a, b)
+
+/// Traces the execution time of the enclosing scope under the given name,
+/// which must be a string literal.
+#define MIXXX_TRACE_SCOPE(name)                                            \
+    const ::mixxx::tracing::Scope MIXXX_TRACE_CONCAT(traceScope, __LINE__)( \
+            ::mixxx::tracing::detail::kEventId<name>)
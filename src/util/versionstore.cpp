@@ -16,7 +16,6 @@
 
 #include <FLAC/format.h>
 #include <chromaprint.h>
-#include <ebur128.h>
 #include <lame/lame.h>
 #include <portaudio.h>
 #include <sndfile.h>
@@ -39,17 +38,6 @@ const QString kMixxxVersionSuffix = QStringLiteral(MIXXX_VERSION_SUFFIX);
 const QString kMixxx = QStringLiteral("Mixxx");
 const QString kBuildFlags = QStringLiteral(MIXXX_BUILD_FLAGS);
 
-QString ebur128Version() {
-    int major = 0;
-    int minor = 0;
-    int patch = 0;
-    ebur128_get_version(&major, &minor, &patch);
-    return QStringLiteral("%1.%2.%3")
-            .arg(QString::number(major),
-                    QString::number(minor),
-                    QString::number(patch));
-}
-
 } // namespace
 
 // static
@@ -195,7 +183,6 @@ QStringList VersionStore::dependencyVersions() {
             // The version of the ChromaPrint headers Mixxx was compiled with.
             QStringLiteral("ChromaPrint: " STR(CHROMAPRINT_VERSION_MAJOR) "." STR(
                     CHROMAPRINT_VERSION_MINOR) "." STR(CHROMAPRINT_VERSION_PATCH)),
-            QStringLiteral("libebur128: %1").arg(ebur128Version()),
             // Should be accurate.
             QStringLiteral("Vorbis: %1").arg(vorbis_version_string()),
             // Should be accurate.
@@ -3,6 +3,7 @@
 #include "control/controlpushbutton.h"
 #include "moc_vinylcontrolprocessor.cpp"
 #include "util/defs.h"
+#include "util/realtime.h"
 #include "util/sample.h"
 #include "util/timer.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
@@ -12,6 +13,12 @@
 #define SIGNAL_QUALITY_FIFO_SIZE 256
 #define SAMPLE_PIPE_FIFO_SIZE 65536
 
+namespace {
+
+const ConfigKey kProcessInCallbackKey(VINYL_PREF_KEY, QStringLiteral("process_in_callback"));
+
+} // namespace
+
 VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPointer pConfig)
         : QThread(pParent),
           m_pConfig(pConfig),
@@ -22,7 +29,11 @@ VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPoint
           m_signalQualityFifo(SIGNAL_QUALITY_FIFO_SIZE),
           m_bReportSignalQuality(false),
           m_bQuit(false),
-          m_bReloadConfig(false) {
+          m_bReloadConfig(false),
+          m_bProcessInCallback(m_pConfig->getValue(kProcessInCallbackKey, false)) {
+    for (auto& threadBusy : m_threadBusy) {
+        threadBusy.store(false, std::memory_order_relaxed);
+    }
     connect(m_pToggle,
             &ControlPushButton::valueChanged,
             this,
@@ -71,6 +82,8 @@ void VinylControlProcessor::shutdown() {
 }
 
 void VinylControlProcessor::requestReloadConfig() {
+    m_bProcessInCallback.store(
+            m_pConfig->getValue(kProcessInCallbackKey, false), std::memory_order_relaxed);
     m_bReloadConfig = true;
     m_samplesAvailableSignal.wakeAll();
 }
@@ -78,6 +91,7 @@ void VinylControlProcessor::requestReloadConfig() {
 void VinylControlProcessor::run() {
     unsigned static id = 0; //the id of this thread, for debugging purposes //XXX copypasta (should factor this out somehow), -kousu 2/2009
     QThread::currentThread()->setObjectName(QString("VinylControlProcessor %1").arg(++id));
+    mixxx::realtime::applyToCurrentThread(mixxx::realtime::ThreadRole::VinylControl);
 
     while (!m_bQuit) {
         if (m_bReloadConfig) {
@@ -91,6 +105,7 @@ void VinylControlProcessor::run() {
             locker.unlock();
             FIFO<CSAMPLE>* pSamplePipe = m_samplePipes[i];
 
+            m_threadBusy[i].store(true);
             if (pSamplePipe->readAvailable() > 0) {
                 int samplesRead = pSamplePipe->read(m_pWorkBuffer, MAX_BUFFER_LEN);
 
@@ -102,23 +117,15 @@ void VinylControlProcessor::run() {
 
                 if (pProcessor) {
                     pProcessor->analyzeSamples(m_pWorkBuffer, framesRead);
+                    // TODO(rryan) define a time-based update rate. This will update way
+                    // too quickly.
+                    reportSignalQuality(i, pProcessor);
                 } else {
                     // Samples are being written to a non-existent processor. Warning?
                     qWarning() << "Samples written to non-existent VinylControl processor:" << i;
                 }
             }
-
-            // TODO(rryan) define a time-based update rate. This will update way
-            // too quickly.
-            if (pProcessor && m_bReportSignalQuality) {
-                VinylSignalQualityReport report;
-                if (pProcessor->writeQualityReport(&report)) {
-                    report.processor = i;
-                    if (m_signalQualityFifo.write(&report, 1) != 1) {
-                        qWarning() << "VinylControlProcessor could not write signal quality report for VC index:" << i;
-                    }
-                }
-            }
+            m_threadBusy[i].store(false);
         }
 
         if (m_bQuit) {
@@ -197,6 +204,46 @@ void VinylControlProcessor::onInputUnconfigured(const AudioInput& input) {
     delete pVC;
 }
 
+void VinylControlProcessor::reportSignalQuality(int index, VinylControl* pProcessor) {
+    if (!m_bReportSignalQuality) {
+        return;
+    }
+    if (m_signalQualityFifoWriting.test_and_set(std::memory_order_acquire)) {
+        // Skip this report, the next one follows with the next buffer
+        return;
+    }
+    VinylSignalQualityReport report;
+    if (pProcessor->writeQualityReport(&report)) {
+        report.processor = index;
+        if (m_signalQualityFifo.write(&report, 1) != 1) {
+            qWarning() << "VinylControlProcessor could not write signal quality report for VC index:" << index;
+        }
+    }
+    m_signalQualityFifoWriting.clear(std::memory_order_release);
+}
+
+bool VinylControlProcessor::processInCallback(
+        int index, const CSAMPLE* pBuffer, unsigned int nFrames) {
+    // Samples queued before must be analyzed first and by the thread. The
+    // thread sets m_threadBusy before it looks at the pipe, which is only
+    // written by this callback, so both never analyze at the same time.
+    if (m_threadBusy[index].load() || m_samplePipes[index]->readAvailable() > 0) {
+        return false;
+    }
+    // Don't wait while the main thread replaces the processor
+    if (!m_processorsLock.tryLock()) {
+        return false;
+    }
+    VinylControl* pProcessor = m_processors.at(index);
+    if (pProcessor) {
+        pProcessor->analyzeSamples(pBuffer, nFrames);
+        reportSignalQuality(index, pProcessor);
+    }
+    // Keep the processor locked until it is done, so it is not deleted
+    m_processorsLock.unlock();
+    return true;
+}
+
 bool VinylControlProcessor::deckConfigured(int index) const {
     return m_processors[index] != nullptr;
 }
@@ -217,6 +264,11 @@ void VinylControlProcessor::receiveBuffer(const AudioInput& input,
         return;
     }
 
+    if (m_bProcessInCallback.load(std::memory_order_relaxed) &&
+            processInCallback(vcIndex, pBuffer, nFrames)) {
+        return;
+    }
+
     FIFO<CSAMPLE>* pSamplePipe = m_samplePipes[vcIndex];
 
     if (pSamplePipe == nullptr) {
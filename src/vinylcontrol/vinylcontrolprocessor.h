@@ -3,6 +3,7 @@
 #include <QThread>
 #include <QVector>
 #include <QWaitCondition>
+#include <atomic>
 
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
@@ -18,6 +19,11 @@ class QObject;
 // the engine callback and feeding those samples to the VinylControl
 // classes. The most important thing is that the connection between the engine
 // callback and VinylControlProcessor (the receiveBuffer method) is lock-free.
+//
+// With [VinylControl],process_in_callback the samples are analyzed directly in
+// receiveBuffer, so the engine applies the position and pitch of the timecode
+// in the same callback. The thread is the fallback whenever the processor is
+// being replaced or it still has samples queued.
 class VinylControlProcessor : public QThread, public AudioDestination {
     Q_OBJECT
   public:
@@ -62,6 +68,10 @@ class VinylControlProcessor : public QThread, public AudioDestination {
 
   private:
     void reloadConfig();
+    // Called by the engine callback, returns false if the samples need to be
+    // queued for the thread.
+    bool processInCallback(int index, const CSAMPLE* pBuffer, unsigned int iNumFrames);
+    void reportSignalQuality(int index, VinylControl* pProcessor);
 
     UserSettingsPointer m_pConfig;
     ControlPushButton* m_pToggle;
@@ -75,6 +85,13 @@ class VinylControlProcessor : public QThread, public AudioDestination {
     QT_RECURSIVE_MUTEX m_processorsLock;
     QVector<VinylControl*> m_processors;
     FIFO<VinylSignalQualityReport> m_signalQualityFifo;
+    // The thread and the callbacks of the sound cards take turns to write
+    // the single writer FIFO.
+    std::atomic_flag m_signalQualityFifoWriting = ATOMIC_FLAG_INIT;
+    // Set by the thread while it analyzes samples of an input, which must
+    // not be analyzed concurrently by the callback.
+    std::atomic<bool> m_threadBusy[kMaximumVinylControlInputs];
+    std::atomic<bool> m_bProcessInCallback;
     volatile bool m_bReportSignalQuality;
     volatile bool m_bQuit;
     volatile bool m_bReloadConfig;
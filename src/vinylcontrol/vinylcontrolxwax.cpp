@@ -201,7 +201,24 @@ bool VinylControlXwax::writeQualityReport(VinylSignalQualityReport* pReport) {
 }
 
 
-void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
+// static
+void VinylControlXwax::convertSamples(short* pDest,
+        const CSAMPLE* pSrc,
+        size_t numSamples,
+        CSAMPLE_GAIN gain) {
+    // Convert CSAMPLE samples to shorts, preventing overflow. Clamping
+    // before the truncating cast gives the same result as the comparisons
+    // with the limits, without branches.
+    // note: LOOP VECTORIZED only with "int i" (not SINT i).
+    for (int i = 0; i < static_cast<int>(numSamples); ++i) {
+        const CSAMPLE sample = pSrc[i] * gain * SAMPLE_MAXIMUM;
+        pDest[i] = static_cast<short>(math_clamp(sample,
+                static_cast<CSAMPLE>(SAMPLE_MINIMUM),
+                static_cast<CSAMPLE>(SAMPLE_MAXIMUM)));
+    }
+}
+
+void VinylControlXwax::analyzeSamples(const CSAMPLE* pSamples, size_t nFrames) {
     ScopedTimer t(QStringLiteral("VinylControlXwax::analyzeSamples"));
     auto gain = static_cast<CSAMPLE_GAIN>(m_pVinylControlInputGain->get());
 
@@ -217,18 +234,7 @@ void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
         m_workBufferSize = samplesSize;
     }
 
-    // Convert CSAMPLE samples to shorts, preventing overflow.
-    for (int i = 0; i < static_cast<int>(samplesSize); ++i) {
-        CSAMPLE sample = pSamples[i] * gain * SAMPLE_MAXIMUM;
-
-        if (sample > SAMPLE_MAXIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MAXIMUM;
-        } else if (sample < SAMPLE_MINIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MINIMUM;
-        } else {
-            m_pWorkBuffer[i] = static_cast<short>(sample);
-        }
-    }
+    convertSamples(m_pWorkBuffer.data(), pSamples, samplesSize, gain);
 
     // Submit the samples to the xwax timecode processor. The size argument is
     // in stereo frames.
@@ -29,7 +29,13 @@ class VinylControlXwax : public VinylControl {
     virtual ~VinylControlXwax();
 
     static void freeLUTs();
-    void analyzeSamples(CSAMPLE* pSamples, size_t nFrames);
+    void analyzeSamples(const CSAMPLE* pSamples, size_t nFrames);
+
+    /// Converts to the 16 bit samples xwax decodes, clipping at the limits.
+    static void convertSamples(short* pDest,
+            const CSAMPLE* pSrc,
+            size_t numSamples,
+            CSAMPLE_GAIN gain);
 
     virtual bool writeQualityReport(VinylSignalQualityReport* qualityReportFifo);
 
@@ -1,6 +1,8 @@
 #include "waveform/guitick.h"
 
 #include "control/controlobject.h"
+#include "control/controlupdatebus.h"
+#include "util/realtimecheck.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
@@ -28,4 +30,7 @@ void GuiTick::process() {
         m_lastUpdateTime = m_cpuTimeLastTick;
         m_pCOGuiTick50ms->set(cpuTimeLastTickSeconds);
     }
+
+    ControlUpdateBus::instance().process();
+    mixxx::realtime::Check::logViolations();
 }
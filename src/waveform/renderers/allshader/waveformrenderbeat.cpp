@@ -36,6 +36,7 @@ void WaveformRenderBeat::draw(QPainter* painter, QPaintEvent* event) {
 
 void WaveformRenderBeat::preprocess() {
     if (!preprocessInner()) {
+        m_geometryKey = GeometryKey{};
         geometry().allocate(0);
         markDirtyGeometry();
     }
@@ -86,6 +87,24 @@ bool WaveformRenderBeat::preprocessInner() {
 
     const float rendererBreadth = m_waveformRenderer->getBreadth();
 
+    // The beats don't move while paused
+    const GeometryKey geometryKey{trackBeats,
+            firstDisplayedPosition,
+            lastDisplayedPosition,
+            trackSamples,
+            m_waveformRenderer->getLength(),
+            rendererBreadth,
+            devicePixelRatio};
+    if (geometryKey == m_geometryKey) {
+        if (m_color != m_geometryColor) {
+            m_geometryColor = m_color;
+            material().setUniform(1, m_color);
+            markDirtyMaterial();
+        }
+        return true;
+    }
+    m_geometryKey = geometryKey;
+
     const int numVerticesPerLine = 6; // 2 triangles
 
     // Count the number of beats in the range to reserve space in the m_vertices vector.
@@ -124,6 +143,7 @@ bool WaveformRenderBeat::preprocessInner() {
 
     DEBUG_ASSERT(reserved == vertexUpdater.index());
 
+    m_geometryColor = m_color;
     material().setUniform(1, m_color);
     markDirtyMaterial();
 
@@ -3,6 +3,7 @@
 #include <QColor>
 
 #include "rendergraph/geometrynode.h"
+#include "track/beats.h"
 #include "util/class.h"
 #include "waveform/renderers/waveformrendererabstract.h"
 
@@ -37,8 +38,31 @@ class allshader::WaveformRenderBeat final
     }
 
   private:
+    // The inputs of the current geometry
+    struct GeometryKey {
+        mixxx::BeatsPointer pBeats;
+        double firstDisplayedPosition = 0.0;
+        double lastDisplayedPosition = 0.0;
+        double trackSamples = 0.0;
+        int length = 0;
+        float breadth = 0.f;
+        float devicePixelRatio = 0.f;
+
+        bool operator==(const GeometryKey& other) const {
+            return pBeats == other.pBeats &&
+                    firstDisplayedPosition == other.firstDisplayedPosition &&
+                    lastDisplayedPosition == other.lastDisplayedPosition &&
+                    trackSamples == other.trackSamples &&
+                    length == other.length &&
+                    breadth == other.breadth &&
+                    devicePixelRatio == other.devicePixelRatio;
+        }
+    };
+
     QColor m_color;
     bool m_isSlipRenderer;
+    GeometryKey m_geometryKey;
+    QColor m_geometryColor;
 
     bool preprocessInner();
 
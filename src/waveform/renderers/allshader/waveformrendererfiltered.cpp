@@ -154,19 +154,14 @@ bool WaveformRendererFiltered::preprocessInner() {
 
         // 3 bands, 2 channels
         float max[3][2]{};
-        uchar u8max[3][2]{};
         for (int chn = 0; chn < 2; chn++) {
-            for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
-
-                u8max[0][chn] = math_max(u8max[0][chn], waveformData.filtered.low);
-                u8max[1][chn] = math_max(u8max[1][chn], waveformData.filtered.mid);
-                u8max[2][chn] = math_max(u8max[2][chn], waveformData.filtered.high);
-            }
+            // data is interleaved left / right
+            const WaveformData waveformData = waveform->getMaxima(
+                    visualIndexStart / 2, (visualIndexStop + 1) / 2, chn);
             // Cast to float
-            max[0][chn] = static_cast<float>(u8max[0][chn]);
-            max[1][chn] = static_cast<float>(u8max[1][chn]);
-            max[2][chn] = static_cast<float>(u8max[2][chn]);
+            max[0][chn] = static_cast<float>(waveformData.filtered.low);
+            max[1][chn] = static_cast<float>(waveformData.filtered.mid);
+            max[2][chn] = static_cast<float>(waveformData.filtered.high);
         }
 
         // TODO: this can be optimized by using one geometrynode per band
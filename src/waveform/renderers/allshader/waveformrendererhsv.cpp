@@ -129,25 +129,15 @@ bool WaveformRendererHSV::preprocessInner() {
 
         for (int chn = 0; chn < 2; chn++) {
             // Find the max values for low, mid, high and all in the waveform data
-            uchar u8maxLow{};
-            uchar u8maxMid{};
-            uchar u8maxHigh{};
-            uchar u8maxAll{};
             // data is interleaved left / right
-            for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
-
-                u8maxLow = math_max(u8maxLow, waveformData.filtered.low);
-                u8maxMid = math_max(u8maxMid, waveformData.filtered.mid);
-                u8maxHigh = math_max(u8maxHigh, waveformData.filtered.high);
-                u8maxAll = math_max(u8maxAll, waveformData.filtered.all);
-            }
+            const WaveformData waveformData = waveform->getMaxima(
+                    visualIndexStart / 2, (visualIndexStop + 1) / 2, chn);
 
             // Cast to float
-            maxLow[chn] = static_cast<float>(u8maxLow);
-            maxMid[chn] = static_cast<float>(u8maxMid);
-            maxHigh[chn] = static_cast<float>(u8maxHigh);
-            maxAll[chn] = static_cast<float>(u8maxAll);
+            maxLow[chn] = static_cast<float>(waveformData.filtered.low);
+            maxMid[chn] = static_cast<float>(waveformData.filtered.mid);
+            maxHigh[chn] = static_cast<float>(waveformData.filtered.high);
+            maxAll[chn] = static_cast<float>(waveformData.filtered.all);
         }
 
         float total{};
@@ -174,14 +174,13 @@ bool WaveformRendererRGB::preprocessInner() {
             // the first field of the arrays to perform signal max
             int signalChn = splitLeftRight ? chn : 0;
             // data is interleaved left / right
-            for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
+            const WaveformData waveformData = waveform->getMaxima(
+                    visualIndexStart / 2, (visualIndexStop + 1) / 2, chn);
 
-                u8maxLow[signalChn] = math_max(u8maxLow[signalChn], waveformData.filtered.low);
-                u8maxMid[signalChn] = math_max(u8maxMid[signalChn], waveformData.filtered.mid);
-                u8maxHigh[signalChn] = math_max(u8maxHigh[signalChn], waveformData.filtered.high);
-                u8maxAllChn[chn] = math_max(u8maxAllChn[chn], waveformData.filtered.all);
-            }
+            u8maxLow[signalChn] = math_max(u8maxLow[signalChn], waveformData.filtered.low);
+            u8maxMid[signalChn] = math_max(u8maxMid[signalChn], waveformData.filtered.mid);
+            u8maxHigh[signalChn] = math_max(u8maxHigh[signalChn], waveformData.filtered.high);
+            u8maxAllChn[chn] = waveformData.filtered.all;
         }
         float maxAllChn[2]{static_cast<float>(u8maxAllChn[0]), static_cast<float>(u8maxAllChn[1])};
 
@@ -3,6 +3,7 @@
 #include <QFont>
 #include <QImage>
 #include <QOpenGLTexture>
+#include <array>
 
 #include "engine/channels/enginedeck.h"
 #include "engine/engine.h"
@@ -129,10 +130,6 @@ bool WaveformRendererStem::preprocessInner() {
 
     const float heightFactor = allGain * halfBreadth / m_maxValue;
 
-    // Effective visual frame for x
-    double xVisualFrame = qRound(firstVisualFrame / visualIncrementPerPixel) *
-            visualIncrementPerPixel;
-
     const int numVerticesPerLine = 6; // 2 triangles
 
     const int reserved = numVerticesPerLine *
@@ -149,49 +146,38 @@ bool WaveformRendererStem::preprocessInner() {
                     m_isSlipRenderer ? halfBreadth : halfBreadth + 0.5f},
             {0.f, 0.f, 0.f, 0.f});
 
-    const double maxSamplingRange = visualIncrementPerPixel / 2.0;
+    updateStemPeaks(waveform, firstVisualFrame, visualIncrementPerPixel, stripLength);
+
+    // The gains and colors are constant for all columns
+    std::array<float, mixxx::kMaxSupportedStems> stemGains;
+    std::array<QColor, mixxx::kMaxSupportedStems> stemColors;
+    for (int stemIdx = 0; stemIdx < mixxx::kMaxSupportedStems; stemIdx++) {
+        stemGains[stemIdx] = m_pStemMute[stemIdx]->toBool() ||
+                        (selectedStems && !(selectedStems & 1 << stemIdx))
+                ? 0.f
+                : static_cast<float>(m_pStemGain[stemIdx]->get());
+        stemColors[stemIdx] = stemInfo[stemIdx].getColor();
+    }
 
     for (int visualIdx = 0; visualIdx < stripLength; visualIdx++) {
+        const float fVisualIdx = static_cast<float>(visualIdx) * invDevicePixelRatio;
+        const StemPeaks& peaks = m_stemPeaks[visualIdx];
         for (int stemIdx = 0; stemIdx < mixxx::kMaxSupportedStems; stemIdx++) {
+            const QColor& stemColor = stemColors[stemIdx];
             // Stem is drawn twice with different opacity level, this allow to
             // see the maximum signal by transparency
             for (int layerIdx = 0; layerIdx < 2; layerIdx++) {
-                QColor stemColor = stemInfo[stemIdx].getColor();
                 float color_r = stemColor.redF(),
                       color_g = stemColor.greenF(),
                       color_b = stemColor.blueF(),
                       color_a = stemColor.alphaF() * (layerIdx ? 0.75f : 0.15f);
-                const int visualFrameStart = std::lround(xVisualFrame - maxSamplingRange);
-                const int visualFrameStop = std::lround(xVisualFrame + maxSamplingRange);
-
-                const int visualIndexStart = std::max(visualFrameStart * 2, 0);
-                const int visualIndexStop =
-                        std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
-
-                const float fVisualIdx = static_cast<float>(visualIdx) * invDevicePixelRatio;
-
-                // Find the max values for current eq in the waveform data.
-                // - Max of left and right
-                uchar u8max{};
-                for (int chn = 0; chn < 2; chn++) {
-                    // data is interleaved left / right
-                    for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                        const WaveformData& waveformData = data[i];
-
-                        u8max = math_max(u8max, waveformData.stems[stemIdx]);
-                    }
-                }
 
                 // Cast to float
-                float max = static_cast<float>(u8max);
+                float max = static_cast<float>(peaks[stemIdx]);
 
                 // Apply the gains
                 if (layerIdx) {
-                    max *= m_pStemMute[stemIdx]->toBool() ||
-                                    (selectedStems &&
-                                            !(selectedStems & 1 << stemIdx))
-                            ? 0.f
-                            : static_cast<float>(m_pStemGain[stemIdx]->get());
+                    max *= stemGains[stemIdx];
                 }
 
                 // Lines are thin rectangles
@@ -208,8 +194,6 @@ bool WaveformRendererStem::preprocessInner() {
                         {color_r, color_g, color_b, color_a});
             }
         }
-
-        xVisualFrame += visualIncrementPerPixel;
     }
 
     DEBUG_ASSERT(reserved == vertexUpdater.index());
@@ -219,4 +203,53 @@ bool WaveformRendererStem::preprocessInner() {
     return true;
 }
 
+void WaveformRendererStem::updateStemPeaks(
+        const ConstWaveformPointer& pWaveform,
+        double firstVisualFrame,
+        double visualIncrementPerPixel,
+        int stripLength) {
+    const int dataSize = pWaveform->getDataSize();
+    const StemPeaksKey key{pWaveform.data(),
+            pWaveform->getCompletion(),
+            firstVisualFrame,
+            visualIncrementPerPixel,
+            stripLength};
+    if (key == m_stemPeaksKey) {
+        // Only the gains or colors have changed
+        return;
+    }
+    m_stemPeaksKey = key;
+    m_stemPeaks.resize(stripLength);
+
+    const WaveformData* data = pWaveform->data();
+    const double maxSamplingRange = visualIncrementPerPixel / 2.0;
+
+    // Effective visual frame for x
+    double xVisualFrame = qRound(firstVisualFrame / visualIncrementPerPixel) *
+            visualIncrementPerPixel;
+
+    for (int visualIdx = 0; visualIdx < stripLength; visualIdx++) {
+        const int visualFrameStart = std::lround(xVisualFrame - maxSamplingRange);
+        const int visualFrameStop = std::lround(xVisualFrame + maxSamplingRange);
+
+        const int visualIndexStart = std::max(visualFrameStart * 2, 0);
+        const int visualIndexStop =
+                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+
+        // Find the max values of all stems in the waveform data in a
+        // single pass.
+        // - Max of left and right, data is interleaved left / right
+        StemPeaks peaks{};
+        for (int i = visualIndexStart; i < visualIndexStop + 1; i++) {
+            const WaveformData& waveformData = data[i];
+            for (int stemIdx = 0; stemIdx < mixxx::kMaxSupportedStems; stemIdx++) {
+                peaks[stemIdx] = math_max(peaks[stemIdx], waveformData.stems[stemIdx]);
+            }
+        }
+        m_stemPeaks[visualIdx] = peaks;
+
+        xVisualFrame += visualIncrementPerPixel;
+    }
+}
+
 } // namespace allshader
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "control/pollingcontrolproxy.h"
 #include "rendergraph/geometrynode.h"
 #include "util/class.h"
+#include "waveform/waveform.h"
 #include "waveform/renderers/allshader/waveformrenderersignalbase.h"
 
 class QOpenGLTexture;
@@ -39,13 +41,43 @@ class allshader::WaveformRendererStem final
     }
 
   private:
+    using StemPeaks = std::array<uchar, mixxx::kMaxSupportedStems>;
+
+    // The inputs of the current peaks
+    struct StemPeaksKey {
+        const Waveform* pWaveform = nullptr;
+        int completion = 0;
+        double firstVisualFrame = 0.0;
+        double visualIncrementPerPixel = 0.0;
+        int stripLength = 0;
+
+        bool operator==(const StemPeaksKey& other) const {
+            return pWaveform == other.pWaveform &&
+                    completion == other.completion &&
+                    firstVisualFrame == other.firstVisualFrame &&
+                    visualIncrementPerPixel == other.visualIncrementPerPixel &&
+                    stripLength == other.stripLength;
+        }
+    };
+
     bool m_isSlipRenderer;
     bool m_splitStemTracks;
 
+    // The peaks of all stems for each strip, before applying the stem
+    // gains. Changing the volume or muting a stem doesn't require to
+    // read the waveform data again.
+    std::vector<StemPeaks> m_stemPeaks;
+    StemPeaksKey m_stemPeaksKey;
+
     std::vector<std::unique_ptr<PollingControlProxy>> m_pStemGain;
     std::vector<std::unique_ptr<PollingControlProxy>> m_pStemMute;
 
     bool preprocessInner();
+    void updateStemPeaks(
+            const ConstWaveformPointer& pWaveform,
+            double firstVisualFrame,
+            double visualIncrementPerPixel,
+            int stripLength);
 
     DISALLOW_COPY_AND_ASSIGN(WaveformRendererStem);
 };
@@ -4,10 +4,20 @@
 
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLShaderProgram>
+#include <algorithm>
 
 #include "moc_waveformrenderertextured.cpp"
 #include "track/track.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/waveformwidgetfactory.h"
+
+namespace {
+
+// The size of the offset array in the shaders, enough for a waveform of
+// more than 10 hours
+constexpr int kMaxLevelCount = 24;
+
+} // anonymous namespace
 
 namespace allshader {
 
@@ -36,6 +46,10 @@ WaveformRendererTextured::WaveformRendererTextured(
           m_unitQuadListId(-1),
           m_textureId(0),
           m_textureRenderedWaveformCompletion(0),
+          m_maxLevelsTextureId(0),
+          m_maxLevelsTextureStride(0),
+          m_maxLevelCount(0),
+          m_maxLevelOffsets(kMaxLevelCount, 0.0f),
           m_isSlipRenderer(type == ::WaveformRendererAbstract::Slip),
           m_options(options),
           m_shadersValid(false),
@@ -47,6 +61,7 @@ WaveformRendererTextured::~WaveformRendererTextured() {
     if (m_textureId) {
         glDeleteTextures(1, &m_textureId);
     }
+    deleteMaxLevelsTexture();
 
     if (m_frameShaderProgram) {
         m_frameShaderProgram->removeAllShaders();
@@ -156,9 +171,11 @@ bool WaveformRendererTextured::loadTexture() {
         if (error) {
             qDebug() << "WaveformRendererTextured::loadTexture - glTexImage2D error" << error;
         }
+        loadMaxLevelsTexture(*pWaveform);
     } else {
         glDeleteTextures(1, &m_textureId);
         m_textureId = 0;
+        deleteMaxLevelsTexture();
     }
 
     glDisable(GL_TEXTURE_2D);
@@ -166,6 +183,65 @@ bool WaveformRendererTextured::loadTexture() {
     return true;
 }
 
+void WaveformRendererTextured::loadMaxLevelsTexture(const Waveform& waveform) {
+    const int levelCount = std::min(waveform.getMaxLevelCount(), kMaxLevelCount);
+    if (levelCount == 0 || levelCount == m_maxLevelCount) {
+        // Not analyzed completely yet or already uploaded
+        return;
+    }
+
+    int textureSize = 0;
+    for (int level = 1; level <= levelCount; ++level) {
+        m_maxLevelOffsets[level - 1] = static_cast<GLfloat>(textureSize);
+        textureSize += static_cast<int>(waveform.getMaxLevel(level).size());
+    }
+    int textureStride = 1;
+    while (textureStride * textureStride < textureSize) {
+        textureStride *= 2;
+    }
+    std::vector<WaveformFilteredData> levelsData(textureStride * textureStride);
+    auto pLevelData = levelsData.begin();
+    for (int level = 1; level <= levelCount; ++level) {
+        for (const auto& data : waveform.getMaxLevel(level)) {
+            *pLevelData++ = data.filtered;
+        }
+    }
+
+    if (m_maxLevelsTextureId == 0) {
+        glGenTextures(1, &m_maxLevelsTextureId);
+    }
+    glBindTexture(GL_TEXTURE_2D, m_maxLevelsTextureId);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D,
+            0,
+            GL_RGBA,
+            textureStride,
+            textureStride,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            levelsData.data());
+    int error = glGetError();
+    if (error) {
+        qDebug() << "WaveformRendererTextured::loadMaxLevelsTexture - glTexImage2D error"
+                 << error;
+        deleteMaxLevelsTexture();
+        return;
+    }
+    m_maxLevelsTextureStride = textureStride;
+    m_maxLevelCount = levelCount;
+}
+
+void WaveformRendererTextured::deleteMaxLevelsTexture() {
+    if (m_maxLevelsTextureId) {
+        glDeleteTextures(1, &m_maxLevelsTextureId);
+        m_maxLevelsTextureId = 0;
+    }
+    m_maxLevelsTextureStride = 0;
+    m_maxLevelCount = 0;
+}
+
 void WaveformRendererTextured::createGeometry() {
     if (m_unitQuadListId != -1) {
         return;
@@ -269,11 +345,20 @@ void WaveformRendererTextured::resizeGL(int, int) {
 }
 
 void WaveformRendererTextured::slotWaveformUpdated() {
+    auto* pWaveformWidgetFactory = WaveformWidgetFactory::instance();
+    const auto locked = pWaveformWidgetFactory->lockRendering();
     m_textureRenderedWaveformCompletion = 0;
     // initializeGL not called yet
     if (!m_frameShaderProgram) {
         return;
     }
+    // The levels of the new waveform need to be uploaded
+    m_maxLevelCount = 0;
+    if (pWaveformWidgetFactory->isRenderThreadEnabled()) {
+        // The context of the render thread is not current here. The texture
+        // is reloaded by paintGL(), because the completion has been reset.
+        return;
+    }
     loadTexture();
 }
 
@@ -373,6 +458,14 @@ void WaveformRendererTextured::paintGL() {
         m_frameShaderProgram->setUniformValue("firstVisualIndex", firstVisualIndex);
         m_frameShaderProgram->setUniformValue("lastVisualIndex", lastVisualIndex);
 
+        m_frameShaderProgram->setUniformValue("waveformDataTexture", 0);
+        m_frameShaderProgram->setUniformValue("waveformMaxLevelsTexture", 1);
+        m_frameShaderProgram->setUniformValue("maxLevelCount", m_maxLevelCount);
+        m_frameShaderProgram->setUniformValue(
+                "maxLevelsTextureStride", m_maxLevelsTextureStride);
+        m_frameShaderProgram->setUniformValueArray(
+                "maxLevelOffsets", m_maxLevelOffsets.data(), kMaxLevelCount, 1);
+
         m_frameShaderProgram->setUniformValue("allGain", allGain);
         m_frameShaderProgram->setUniformValue("lowGain", lowGain);
         m_frameShaderProgram->setUniformValue("midGain", midGain);
@@ -441,6 +534,11 @@ void WaveformRendererTextured::paintGL() {
         }
 
         glEnable(GL_TEXTURE_2D);
+        if (m_maxLevelsTextureId) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, m_maxLevelsTextureId);
+            glActiveTexture(GL_TEXTURE0);
+        }
         glBindTexture(GL_TEXTURE_2D, m_textureId);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -476,6 +574,12 @@ void WaveformRendererTextured::paintGL() {
 
         m_framebuffer->release();
 
+        if (m_maxLevelsTextureId) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glActiveTexture(GL_TEXTURE0);
+        }
+
         m_frameShaderProgram->release();
 
         glPopMatrix();
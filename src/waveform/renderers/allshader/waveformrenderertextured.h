@@ -55,6 +55,8 @@ class allshader::WaveformRendererTextured final : public allshader::WaveformRend
     static QString fragShaderForType(WaveformWidgetType::Type t);
     bool loadShaders();
     bool loadTexture();
+    void loadMaxLevelsTexture(const Waveform& waveform);
+    void deleteMaxLevelsTexture();
 
     void createGeometry();
     void createFrameBuffers();
@@ -67,6 +69,14 @@ class allshader::WaveformRendererTextured final : public allshader::WaveformRend
 
     std::vector<WaveformFilteredData> m_data;
 
+    // The levels of Waveform::getMaxLevel() that are sampled by the shaders
+    // when the waveform is zoomed out, so that no peaks are skipped. They
+    // are uploaded once after the analysis has finished.
+    GLuint m_maxLevelsTextureId;
+    int m_maxLevelsTextureStride;
+    int m_maxLevelCount;
+    std::vector<GLfloat> m_maxLevelOffsets;
+
     // Frame buffer for two pass rendering.
     std::unique_ptr<QOpenGLFramebufferObject> m_framebuffer;
 
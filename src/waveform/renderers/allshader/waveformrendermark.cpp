@@ -1,6 +1,8 @@
 #include "waveform/renderers/allshader/waveformrendermark.h"
 
 #include <QPainterPath>
+#include <algorithm>
+#include <utility>
 
 #include "moc_waveformrendermark.cpp"
 #include "rendergraph/context.h"
@@ -29,86 +31,41 @@ using namespace rendergraph;
 // only to draw on a QImage. This is only done once when needed and the images are
 // then used as textures to be drawn with a GLSL shader.
 
-namespace {
+namespace allshader {
 
-class WaveformMarkNode : public rendergraph::GeometryNode {
+// The image of a mark and its location in the atlas texture with the
+// images of all marks
+class WaveformMarkAtlasGraphics : public WaveformMark::Graphics {
   public:
-    WaveformMark* m_pOwner{};
-
-    WaveformMarkNode(WaveformMark* pOwner, rendergraph::Context* pContext, const QImage& image)
-            : m_pOwner(pOwner) {
-        initForRectangles<TextureMaterial>(1);
-        updateTexture(pContext, image);
+    explicit WaveformMarkAtlasGraphics(QImage image)
+            : m_image(std::move(image)) {
     }
-    void updateTexture(rendergraph::Context* pContext, const QImage& image) {
-        dynamic_cast<TextureMaterial&>(material())
-                .setTexture(std::make_unique<Texture>(pContext, image));
-        m_textureWidth = image.width();
-        m_textureHeight = image.height();
+    void setImage(QImage image) {
+        m_image = std::move(image);
+        m_obsolete = false;
     }
-    void update(float x, float y, float devicePixelRatio) {
-#ifdef MIXXX_DEBUG_ASSERTIONS_ENABLED
-        const float epsilon = 1e-6f;
-        auto roundToPixel = createFunctionRoundToPixel(devicePixelRatio);
-        DEBUG_ASSERT(std::abs(x - roundToPixel(x)) < epsilon);
-        DEBUG_ASSERT(std::abs(y - roundToPixel(y)) < epsilon);
-#endif
-        TexturedVertexUpdater vertexUpdater{
-                geometry().vertexDataAs<Geometry::TexturedPoint2D>()};
-        vertexUpdater.addRectangle({x, y},
-                {x + m_textureWidth / devicePixelRatio,
-                        y + m_textureHeight / devicePixelRatio},
-                {0.f, 0.f},
-                {1.f, 1.f});
+    const QImage& image() const {
+        return m_image;
     }
     float textureWidth() const {
-        return m_textureWidth;
-    }
-    float textureHeight() const {
-        return m_textureHeight;
+        return static_cast<float>(m_image.width());
     }
 
-  public:
-    float m_textureWidth{};
-    float m_textureHeight{};
+    // In physical pixels, only valid after the atlas has been updated
+    QRect m_atlasRect;
+
+  private:
+    QImage m_image;
 };
 
-class WaveformMarkNodeGraphics : public WaveformMark::Graphics {
-  public:
-    WaveformMarkNodeGraphics(WaveformMark* pOwner,
-            rendergraph::Context* pContext,
-            const QImage& image)
-            : m_pNode(std::make_unique<WaveformMarkNode>(
-                      pOwner, pContext, image)) {
-    }
-    void updateTexture(rendergraph::Context* pContext, const QImage& image) {
-        waveformMarkNode()->updateTexture(pContext, image);
-    }
-    void update(float x, float y, float devicePixelRatio) {
-        waveformMarkNode()->update(x, y, devicePixelRatio);
-    }
-    float textureWidth() const {
-        return waveformMarkNode()->textureWidth();
-    }
-    float textureHeight() const {
-        return waveformMarkNode()->textureHeight();
-    }
-    void attachNode(std::unique_ptr<rendergraph::BaseNode> pNode) {
-        DEBUG_ASSERT(!m_pNode);
-        m_pNode = std::move(pNode);
-    }
-    std::unique_ptr<rendergraph::BaseNode> detachNode() {
-        return std::move(m_pNode);
-    }
+} // namespace allshader
 
-  private:
-    WaveformMarkNode* waveformMarkNode() const {
-        DEBUG_ASSERT(m_pNode);
-        return static_cast<WaveformMarkNode*>(m_pNode.get());
-    }
+namespace {
 
-    std::unique_ptr<rendergraph::BaseNode> m_pNode;
-};
+// Wider atlases are split into multiple rows
+constexpr int kMaxAtlasWidth = 2048;
+// Prevents sampling the neighbouring images at the edges
+constexpr int kAtlasPadding = 1;
 
 constexpr float kPlayPosWidth{11.f};
 constexpr float kPlayPosOffset{-(kPlayPosWidth - 1.f) / 2.f};
@@ -145,6 +102,7 @@ allshader::WaveformRenderMark::WaveformRenderMark(
           m_timeUntilMark(0.0),
           m_pTimeRemainingControl(nullptr),
           m_isSlipRenderer(type == ::WaveformRendererAbstract::Slip),
+          m_atlasDirty(true),
           m_playPosHeight(0.f),
           m_playPosDevicePixelRatio(0.f),
           m_untilMarkShowBeats{false},
@@ -159,8 +117,9 @@ allshader::WaveformRenderMark::WaveformRenderMark(
     }
 
     {
-        auto pNode = std::make_unique<Node>();
-        m_pMarkNodesParent = pNode.get();
+        auto pNode = std::make_unique<GeometryNode>();
+        m_pMarksNode = pNode.get();
+        m_pMarksNode->initForRectangles<TextureMaterial>(0);
         appendChildNode(std::move(pNode));
     }
 
@@ -263,25 +222,10 @@ void allshader::WaveformRenderMark::update() {
         return;
     }
 
-    // For each WaveformMark we create a GeometryNode with Texture
-    // (in updateMarkImage). Of these GeometryNodes, we append the
-    // the ones that need to be shown on screen as children to
-    // m_pMarkNodesParent (transferring ownership).
-    //
-    // At the beginning of a new frame, we remove all the child nodes
-    // from m_pMarkNodesParent and store each with their mark
-    // (transferring ownership). Later in this function we move the
-    // visible nodes back to m_pMarkNodesParent children.
-    while (auto* pChild = m_pMarkNodesParent->firstChild()) {
-        auto pNode = m_pMarkNodesParent->detachChildNode(pChild);
-        WaveformMarkNode* pWaveformMarkNode = static_cast<WaveformMarkNode*>(pNode.get());
-        // Determine its WaveformMark
-        auto* pMark = pWaveformMarkNode->m_pOwner;
-        auto* pGraphics = static_cast<WaveformMarkNodeGraphics*>(pMark->m_pGraphics.get());
-        // Store the node with the WaveformMark
-        pGraphics->attachNode(std::move(pNode));
-    }
-
+    // The images of all marks are packed into a single texture, that is
+    // only updated when any of the images has been regenerated (in
+    // updateMarkImage). All visible marks are drawn as rectangles of
+    // m_pMarksNode with a single draw call.
     auto positionType = m_isSlipRenderer ? ::WaveformRendererAbstract::Slip
                                          : ::WaveformRendererAbstract::Play;
     bool slipActive = m_waveformRenderer->isSlipActive();
@@ -302,11 +246,15 @@ void allshader::WaveformRenderMark::update() {
     // the WaveformMarks (in which case updateMarkImage is called)
     // (Will create textures so requires OpenGL context)
     updateMarkImages();
+    if (m_atlasDirty) {
+        updateAtlas(m_waveformRenderer->getContext());
+    }
 
     const double playPosition = m_waveformRenderer->getTruePosSample(positionType);
     double nextMarkPosition = std::numeric_limits<double>::max();
 
     GeometryNode* pRangeChild = static_cast<GeometryNode*>(m_pRangeNodesParent->firstChild());
+    m_visibleMarks.clear();
 
     for (const auto& pMark : std::as_const(m_marks)) {
         if (!pMark->isValid()) {
@@ -320,7 +268,7 @@ void allshader::WaveformRenderMark::update() {
         }
 
         auto* pMarkGraphics = pMark->m_pGraphics.get();
-        auto* pMarkNodeGraphics = static_cast<WaveformMarkNodeGraphics*>(pMarkGraphics);
+        auto* pMarkAtlasGraphics = static_cast<WaveformMarkAtlasGraphics*>(pMarkGraphics);
         if (!pMarkGraphics) { // is this even possible?
             continue;
         }
@@ -335,22 +283,18 @@ void allshader::WaveformRenderMark::update() {
         }
         const double sampleEndPosition = pMark->getSampleEndPosition();
 
-        const float markWidth = pMarkNodeGraphics->textureWidth() / devicePixelRatio;
+        const float markWidth = pMarkAtlasGraphics->textureWidth() / devicePixelRatio;
         const float drawOffset = currentMarkPos + pMark->getOffset();
 
         bool visible = false;
         // Check if the current point needs to be displayed.
         if (drawOffset > -markWidth &&
                 drawOffset < m_waveformRenderer->getLength()) {
-            pMarkNodeGraphics->update(
+            m_visibleMarks.push_back(VisibleMark{pMarkAtlasGraphics,
                     roundToPixel(drawOffset),
                     !m_isSlipRenderer && slipActive
                             ? roundToPixel(m_waveformRenderer->getBreadth() / 2.f)
-                            : 0,
-                    devicePixelRatio);
-
-            // transfer back to m_pMarkNodesParent children, for rendering
-            m_pMarkNodesParent->appendChildNode(pMarkNodeGraphics->detachNode());
+                            : 0});
 
             visible = true;
         }
@@ -398,6 +342,7 @@ void allshader::WaveformRenderMark::update() {
     }
 
     m_waveformRenderer->setMarkPositions(marksOnScreen);
+    updateMarksGeometry(devicePixelRatio);
 
     const float playMarkerPos = static_cast<float>(m_waveformRenderer->getPlayMarkerPosition() *
             m_waveformRenderer->getLength());
@@ -555,18 +500,90 @@ void allshader::WaveformRenderMark::drawTriangle(QPainter* painter,
 }
 
 void allshader::WaveformRenderMark::updateMarkImage(WaveformMarkPointer pMark) {
+    QImage image = pMark->generateImage(m_waveformRenderer->getDevicePixelRatio());
     if (!pMark->m_pGraphics) {
-        pMark->m_pGraphics =
-                std::make_unique<WaveformMarkNodeGraphics>(pMark.get(),
-                        m_waveformRenderer->getContext(),
-                        pMark->generateImage(
-                                m_waveformRenderer->getDevicePixelRatio()));
+        pMark->m_pGraphics = std::make_unique<WaveformMarkAtlasGraphics>(std::move(image));
     } else {
-        auto* pGraphics = static_cast<WaveformMarkNodeGraphics*>(pMark->m_pGraphics.get());
-        pGraphics->updateTexture(m_waveformRenderer->getContext(),
-                pMark->generateImage(
-                        m_waveformRenderer->getDevicePixelRatio()));
+        auto* pGraphics = static_cast<WaveformMarkAtlasGraphics*>(pMark->m_pGraphics.get());
+        pGraphics->setImage(std::move(image));
+    }
+    m_atlasDirty = true;
+}
+
+void allshader::WaveformRenderMark::updateAtlas(rendergraph::Context* pContext) {
+    m_atlasDirty = false;
+
+    // Pack the images row by row in the order of the marks
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    int atlasWidth = 1;
+    for (const auto& pMark : std::as_const(m_marks)) {
+        auto* pGraphics = static_cast<WaveformMarkAtlasGraphics*>(pMark->m_pGraphics.get());
+        if (!pGraphics) {
+            continue;
+        }
+        const QSize imageSize = pGraphics->image().size();
+        if (x > 0 && x + imageSize.width() > kMaxAtlasWidth) {
+            x = 0;
+            y += rowHeight + kAtlasPadding;
+            rowHeight = 0;
+        }
+        pGraphics->m_atlasRect = QRect(QPoint(x, y), imageSize);
+        x += imageSize.width() + kAtlasPadding;
+        rowHeight = std::max(rowHeight, imageSize.height());
+        atlasWidth = std::max(atlasWidth, x);
     }
+    const int atlasHeight = std::max(1, y + rowHeight);
+
+    m_atlasSize = QSize(atlasWidth, atlasHeight);
+    QImage atlas(m_atlasSize, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+
+    // See comment on use of QPainter at top of file
+    QPainter painter(&atlas);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const auto& pMark : std::as_const(m_marks)) {
+        auto* pGraphics = static_cast<WaveformMarkAtlasGraphics*>(pMark->m_pGraphics.get());
+        if (!pGraphics || pGraphics->image().isNull()) {
+            continue;
+        }
+        // Copy the physical pixels, the atlas has no device pixel ratio
+        QImage image = pGraphics->image();
+        image.setDevicePixelRatio(1.0);
+        painter.drawImage(pGraphics->m_atlasRect.topLeft(), image);
+    }
+    painter.end();
+
+    dynamic_cast<TextureMaterial&>(m_pMarksNode->material())
+            .setTexture(std::make_unique<Texture>(pContext, atlas));
+    m_pMarksNode->markDirtyMaterial();
+}
+
+void allshader::WaveformRenderMark::updateMarksGeometry(float devicePixelRatio) {
+    const int verticesPerRectangle = 6; // 2 triangles
+    m_pMarksNode->geometry().allocate(
+            static_cast<int>(m_visibleMarks.size()) * verticesPerRectangle);
+    TexturedVertexUpdater vertexUpdater{
+            m_pMarksNode->geometry().vertexDataAs<Geometry::TexturedPoint2D>()};
+    const float atlasWidth = static_cast<float>(m_atlasSize.width());
+    const float atlasHeight = static_cast<float>(m_atlasSize.height());
+    for (const auto& visibleMark : m_visibleMarks) {
+#ifdef MIXXX_DEBUG_ASSERTIONS_ENABLED
+        const float epsilon = 1e-6f;
+        auto roundToPixel = createFunctionRoundToPixel(devicePixelRatio);
+        DEBUG_ASSERT(std::abs(visibleMark.x - roundToPixel(visibleMark.x)) < epsilon);
+        DEBUG_ASSERT(std::abs(visibleMark.y - roundToPixel(visibleMark.y)) < epsilon);
+#endif
+        const QRect& atlasRect = visibleMark.pGraphics->m_atlasRect;
+        vertexUpdater.addRectangle({visibleMark.x, visibleMark.y},
+                {visibleMark.x + atlasRect.width() / devicePixelRatio,
+                        visibleMark.y + atlasRect.height() / devicePixelRatio},
+                {atlasRect.x() / atlasWidth, atlasRect.y() / atlasHeight},
+                {(atlasRect.x() + atlasRect.width()) / atlasWidth,
+                        (atlasRect.y() + atlasRect.height()) / atlasHeight});
+    }
+    m_pMarksNode->markDirtyGeometry();
 }
 
 void allshader::WaveformRenderMark::updateUntilMark(
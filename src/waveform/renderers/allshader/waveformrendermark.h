@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QColor>
+#include <QSize>
+#include <vector>
 
 #include "rendergraph/geometrynode.h"
 #include "rendergraph/node.h"
@@ -15,6 +17,7 @@ class Context;
 
 namespace allshader {
 class DigitsRenderNode;
+class WaveformMarkAtlasGraphics;
 class WaveformRenderMark;
 } // namespace allshader
 
@@ -61,7 +64,15 @@ class allshader::WaveformRenderMark : public ::WaveformRenderMarkBase,
     }
 
   private:
+    struct VisibleMark {
+        const WaveformMarkAtlasGraphics* pGraphics;
+        float x;
+        float y;
+    };
+
     void updateMarkImage(WaveformMarkPointer pMark) override;
+    void updateAtlas(rendergraph::Context* pContext);
+    void updateMarksGeometry(float devicePixelRatio);
 
     void updatePlayPosMarkTexture(rendergraph::Context* pContext);
 
@@ -87,7 +98,11 @@ class allshader::WaveformRenderMark : public ::WaveformRenderMarkBase,
     bool m_isSlipRenderer;
 
     rendergraph::Node* m_pRangeNodesParent{};
-    rendergraph::Node* m_pMarkNodesParent{};
+    // Draws the images of all visible marks from the atlas texture
+    rendergraph::GeometryNode* m_pMarksNode{};
+    bool m_atlasDirty;
+    QSize m_atlasSize;
+    std::vector<VisibleMark> m_visibleMarks;
 
     rendergraph::GeometryNode* m_pPlayPosNode;
     float m_playPosHeight;
@@ -3,6 +3,7 @@
 #include "moc_waveformrendermarkbase.cpp"
 #include "track/track.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/waveformwidgetfactory.h"
 
 WaveformRenderMarkBase::WaveformRenderMarkBase(
         WaveformWidgetRenderer* pWaveformWidgetRenderer,
@@ -47,10 +48,12 @@ void WaveformRenderMarkBase::onResize() {
 void WaveformRenderMarkBase::onMarkChanged(double v) {
     Q_UNUSED(v);
 
+    const auto locked = WaveformWidgetFactory::instance()->lockRendering();
     updateMarks();
 }
 
 void WaveformRenderMarkBase::slotCuesUpdated() {
+    const auto locked = WaveformWidgetFactory::instance()->lockRendering();
     updateMarksFromCues();
 }
 
@@ -61,9 +64,10 @@ void WaveformRenderMarkBase::updateMarksFromCues() {
     }
 
     const int dimBrightThreshold = m_waveformRenderer->getDimBrightThreshold();
-    const QList<CuePointer> loadedCues = pTrackInfo->getCuePoints();
-    for (const CuePointer& pCue : loadedCues) {
-        const int hotCue = pCue->getHotCue();
+    // Neither locks the track nor the cues
+    const auto pSnapshot = pTrackInfo->getEngineSnapshot();
+    for (const auto& cue : pSnapshot->cues) {
+        const int hotCue = cue.hotCueIndex;
         if (hotCue == Cue::kNoHotCue) {
             continue;
         }
@@ -75,9 +79,8 @@ void WaveformRenderMarkBase::updateMarksFromCues() {
             continue;
         }
 
-        QString newLabel = pCue->getLabel();
-        QColor newColor = mixxx::RgbColor::toQColor(pCue->getColor());
-        pMark->setText(newLabel);
+        QColor newColor = mixxx::RgbColor::toQColor(cue.color);
+        pMark->setText(cue.label);
         pMark->setBaseColor(newColor, dimBrightThreshold);
     }
 
@@ -1,5 +1,8 @@
 #include "waveform/sharedglcontext.h"
 
+#ifdef MIXXX_USE_QOPENGL
+#include <QOpenGLContext>
+#endif
 #ifndef MIXXX_USE_QOPENGL
 #include <QDebug>
 #include <QGLContext>
@@ -9,6 +12,10 @@
 #endif
 
 WGLWidget* SharedGLContext::s_pSharedGLWidget = nullptr;
+#ifdef MIXXX_USE_QOPENGL
+QOpenGLContext* SharedGLContext::s_pRenderThreadContext = nullptr;
+QOpenGLContext* SharedGLContext::s_pGuiThreadContext = nullptr;
+#endif
 
 // static
 void SharedGLContext::setWidget(WGLWidget* pWidget) {
@@ -40,3 +47,35 @@ void SharedGLContext::setWidget(WGLWidget* pWidget) {
 WGLWidget* SharedGLContext::getWidget() {
     return s_pSharedGLWidget;
 }
+
+#ifdef MIXXX_USE_QOPENGL
+// static
+QOpenGLContext* SharedGLContext::getRenderThreadContext() {
+    return s_pRenderThreadContext;
+}
+
+// static
+void SharedGLContext::setRenderThreadContext(QOpenGLContext* pContext) {
+    s_pRenderThreadContext = pContext;
+}
+
+// static
+QOpenGLContext* SharedGLContext::getGuiThreadContext() {
+    return s_pGuiThreadContext;
+}
+
+// static
+void SharedGLContext::setGuiThreadContext(QOpenGLContext* pContext) {
+    s_pGuiThreadContext = pContext;
+}
+
+// static
+void SharedGLContext::doneCurrent() {
+    QOpenGLContext* pCurrentContext = QOpenGLContext::currentContext();
+    if (pCurrentContext &&
+            (pCurrentContext == s_pRenderThreadContext ||
+                    pCurrentContext == s_pGuiThreadContext)) {
+        pCurrentContext->doneCurrent();
+    }
+}
+#endif
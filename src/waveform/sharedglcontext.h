@@ -1,6 +1,9 @@
 #pragma once
 
 class WGLWidget;
+#ifdef MIXXX_USE_QOPENGL
+class QOpenGLContext;
+#endif
 
 // Creating a QGLContext on its own doesn't work. We've tried that. You can't
 // create a context on your own. It has to be associated with a real paint
@@ -11,7 +14,34 @@ class SharedGLContext {
     static WGLWidget* getWidget();
     static void setWidget(WGLWidget* pWidget);
 
+#ifdef MIXXX_USE_QOPENGL
+    // The context that is used by WGLWidgets that are rendered on the render
+    // thread of the WaveformWidgetFactory. It shares its resources with all
+    // other contexts and lives on the render thread. Null if all widgets are
+    // rendered on the GUI thread.
+    static QOpenGLContext* getRenderThreadContext();
+    static void setRenderThreadContext(QOpenGLContext* pContext);
+
+    // The context that is used on the GUI thread by the WGLWidgets that
+    // opted in with WGLWidget::setRenderedWithGuiThreadContext(). Rendering
+    // all of them with one context only switches the surface between the
+    // widgets instead of the whole context. Null if every widget uses the
+    // context of its own window.
+    static QOpenGLContext* getGuiThreadContext();
+    static void setGuiThreadContext(QOpenGLContext* pContext);
+
+    // Releases the render thread or GUI thread context if it is current on
+    // the calling thread. WGLWidget::doneCurrent() keeps these contexts
+    // current for the next widget, this is called once after all widgets
+    // have been rendered or swapped.
+    static void doneCurrent();
+#endif
+
   private:
     SharedGLContext() { }
     static WGLWidget* s_pSharedGLWidget;
+#ifdef MIXXX_USE_QOPENGL
+    static QOpenGLContext* s_pRenderThreadContext;
+    static QOpenGLContext* s_pGuiThreadContext;
+#endif
 };
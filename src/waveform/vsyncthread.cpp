@@ -3,6 +3,7 @@
 #include "moc_vsyncthread.cpp"
 #include "util/math.h"
 #include "util/performancetimer.h"
+#include "util/tracing.h"
 
 namespace {
 
@@ -29,12 +30,14 @@ VSyncThread::VSyncThread(QObject* pParent, VSyncThread::VSyncMode vSyncMode)
           m_swapWait(0),
           m_displayFrameRate(60.0),
           m_vSyncPerRendering(1),
+          m_lastSignalNanos(0),
           m_pllInitCnt(0),
           m_pllInitSum(0.0),
           m_pllPhaseOut(0.0),
           m_pllDeltaOut(16666.6),
           m_pllLogging(0.0) {
     m_pllTimer.start();
+    m_signalTimer.start();
 }
 
 VSyncThread::~VSyncThread() {
@@ -46,6 +49,7 @@ VSyncThread::~VSyncThread() {
 
 void VSyncThread::run() {
     QThread::currentThread()->setObjectName("VSyncThread");
+    mixxx::tracing::registerCurrentThread(QStringLiteral("VSyncThread"));
 
     m_waitToSwapMicros = m_syncIntervalTimeMicros;
     m_timer.start();
@@ -75,9 +79,11 @@ void VSyncThread::runFree() {
         // for benchmark only!
 
         // renders the waveform, Possible delayed due to anti tearing
+        markSignalEmitted();
         emit vsyncRender();
         m_semaVsyncSlot.acquire();
 
+        markSignalEmitted();
         emit vsyncSwap(); // swaps the new waveform to front
         m_semaVsyncSlot.acquire();
 
@@ -154,6 +160,7 @@ void VSyncThread::runPLL() {
         // Signal to swap the gl widgets (waveforms, spinnies, vumeters)
         // and render them for the next swap
         if (!pllInitializing() || m_pllPendingUpdate) {
+            markSignalEmitted();
             emit vsyncSwapAndRender();
             m_semaVsyncSlot.acquire();
             m_pllPendingUpdate = false;
@@ -183,6 +190,7 @@ void VSyncThread::runTimer() {
     assert(m_vSyncMode == ST_TIMER);
 
     while (m_bDoRendering) {
+        markSignalEmitted();
         emit vsyncRender(); // renders the new waveform.
 
         // wait until rendering was scheduled. It might be delayed due a
@@ -198,6 +206,7 @@ void VSyncThread::runTimer() {
         }
 
         // swaps the new waveform to front in case of gl-wf
+        markSignalEmitted();
         emit vsyncSwap();
 
         // wait until swap occurred. It might be delayed due to driver vSync
@@ -289,6 +298,17 @@ mixxx::Duration VSyncThread::sinceLastSwap() const {
     return m_sinceLastSwap;
 }
 
+void VSyncThread::markSignalEmitted() {
+    m_lastSignalNanos.store(m_signalTimer.elapsed().toIntegerNanos(),
+            std::memory_order_release);
+}
+
+mixxx::Duration VSyncThread::sinceLastSignal() const {
+    return m_signalTimer.elapsed() -
+            mixxx::Duration::fromNanos(
+                    m_lastSignalNanos.load(std::memory_order_acquire));
+}
+
 bool VSyncThread::pllInitializing() const {
     return m_pllInitCnt < kNumStableDeltasRequired;
 }
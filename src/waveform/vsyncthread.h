@@ -3,6 +3,7 @@
 #include <QPair>
 #include <QSemaphore>
 #include <QThread>
+#include <atomic>
 #include <mutex>
 
 #include "util/performancetimer.h"
@@ -41,6 +42,9 @@ class VSyncThread : public QThread, public VSyncTimeProvider {
     void setupSync(WGLWidget* glw, int index);
     void waitUntilSwap(WGLWidget* glw);
     mixxx::Duration sinceLastSwap() const;
+    /// The time since the last vsync signal has been emitted. Invoked at
+    /// the beginning of a slot it is the latency of the GUI thread.
+    mixxx::Duration sinceLastSignal() const;
     // VSyncTimerProvider
     std::chrono::microseconds getSyncInterval() const override {
         return std::chrono::microseconds(m_syncIntervalTimeMicros);
@@ -58,6 +62,7 @@ class VSyncThread : public QThread, public VSyncTimeProvider {
     void runFree();
     void runPLL();
     void runTimer();
+    void markSignalEmitted();
 
     bool m_bDoRendering;
     int m_syncIntervalTimeMicros;
@@ -71,6 +76,8 @@ class VSyncThread : public QThread, public VSyncTimeProvider {
     double m_displayFrameRate;
     int m_vSyncPerRendering;
     mixxx::Duration m_sinceLastSwap;
+    PerformanceTimer m_signalTimer;
+    std::atomic<qint64> m_lastSignalNanos;
     // phase locked loop
     std::mutex m_pllMutex;
     PerformanceTimer m_pllTimer;
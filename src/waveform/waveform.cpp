@@ -1,13 +1,166 @@
 #include "waveform/waveform.h"
 
+#include <QDataStream>
+#include <QVector>
 #include <QtDebug>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 
 #include "analyzer/constants.h"
 #include "engine/engine.h"
 #include "proto/waveform.pb.h"
+#include "util/assert.h"
 
 using namespace mixxx::track;
 
+namespace {
+
+inline void storeMaxima(WaveformData* pMaxima, const WaveformData& data) {
+    pMaxima->filtered.low = std::max(pMaxima->filtered.low, data.filtered.low);
+    pMaxima->filtered.mid = std::max(pMaxima->filtered.mid, data.filtered.mid);
+    pMaxima->filtered.high = std::max(pMaxima->filtered.high, data.filtered.high);
+    pMaxima->filtered.all = std::max(pMaxima->filtered.all, data.filtered.all);
+    for (int i = 0; i < mixxx::kMaxSupportedStems; ++i) {
+        pMaxima->stems[i] = std::max(pMaxima->stems[i], data.stems[i]);
+    }
+}
+
+// The packed format stores each band and stem as a separate column of all
+// visual samples, that are interleaved left / right like Waveform::data().
+// All values are little-endian:
+//
+//   magic "MXWF"
+//   quint16 layout version
+//   quint8 stem count
+//   quint8 reserved
+//   qint32 data size
+//   double visual sample rate
+//   double audio visual ratio
+//   (quint8 encoding, quint32 offset, quint32 size) for each column
+//   column data, offsets are relative to the start of the byte array
+const QByteArray kPackedMagic = QByteArrayLiteral("MXWF");
+constexpr quint16 kPackedLayoutVersion = 1;
+constexpr int kPackedHeaderSize = 4 + 2 + 1 + 1 + 4 + 8 + 8;
+constexpr int kPackedColumnInfoSize = 1 + 4 + 4;
+
+enum class PackedEncoding : quint8 {
+    Raw = 0,
+    // The difference to the previous value of the same channel modulo 256.
+    // A zero is followed by the number of consecutive zero differences.
+    DeltaZeroRuns = 1,
+};
+
+constexpr quint8 kMaxZeroRun = 255;
+
+// All bands followed by the stems
+int packedColumnCount(int stemCount) {
+    return BandCount + stemCount;
+}
+
+std::size_t packedColumnOffset(int column) {
+    switch (column) {
+    case AllBand:
+        return offsetof(WaveformData, filtered) + offsetof(WaveformFilteredData, all);
+    case Low:
+        return offsetof(WaveformData, filtered) + offsetof(WaveformFilteredData, low);
+    case Mid:
+        return offsetof(WaveformData, filtered) + offsetof(WaveformFilteredData, mid);
+    case High:
+        return offsetof(WaveformData, filtered) + offsetof(WaveformFilteredData, high);
+    default:
+        return offsetof(WaveformData, stems) + (column - BandCount);
+    }
+}
+
+QByteArray encodeDeltaZeroRuns(const WaveformData* pData, int dataSize, int column) {
+    const auto* pValues = reinterpret_cast<const unsigned char*>(pData) +
+            packedColumnOffset(column);
+    QByteArray encoded;
+    encoded.reserve(dataSize);
+    unsigned char previous[ChannelCount] = {0, 0};
+    int zeroRun = 0;
+    for (int i = 0; i < dataSize; ++i) {
+        const unsigned char value = pValues[i * sizeof(WaveformData)];
+        const auto delta = static_cast<unsigned char>(value - previous[i % ChannelCount]);
+        previous[i % ChannelCount] = value;
+        if (delta == 0) {
+            if (++zeroRun == kMaxZeroRun) {
+                encoded.append('\0');
+                encoded.append(static_cast<char>(zeroRun));
+                zeroRun = 0;
+            }
+            continue;
+        }
+        if (zeroRun > 0) {
+            encoded.append('\0');
+            encoded.append(static_cast<char>(zeroRun));
+            zeroRun = 0;
+        }
+        encoded.append(static_cast<char>(delta));
+    }
+    if (zeroRun > 0) {
+        encoded.append('\0');
+        encoded.append(static_cast<char>(zeroRun));
+    }
+    return encoded;
+}
+
+bool decodeDeltaZeroRuns(
+        const unsigned char* pEncoded,
+        int encodedSize,
+        WaveformData* pData,
+        int dataSize,
+        int column) {
+    auto* pValues = reinterpret_cast<unsigned char*>(pData) +
+            packedColumnOffset(column);
+    unsigned char previous[ChannelCount] = {0, 0};
+    int i = 0;
+    int pos = 0;
+    while (pos < encodedSize) {
+        const unsigned char delta = pEncoded[pos++];
+        int run = 1;
+        if (delta == 0) {
+            if (pos >= encodedSize) {
+                return false;
+            }
+            run = pEncoded[pos++];
+            if (run == 0) {
+                return false;
+            }
+        }
+        if (run > dataSize - i) {
+            return false;
+        }
+        for (const int stop = i + run; i < stop; ++i) {
+            const auto value = static_cast<unsigned char>(previous[i % ChannelCount] + delta);
+            previous[i % ChannelCount] = value;
+            pValues[i * sizeof(WaveformData)] = value;
+        }
+    }
+    return i == dataSize;
+}
+
+QByteArray gatherRaw(const WaveformData* pData, int dataSize, int column) {
+    const auto* pValues = reinterpret_cast<const unsigned char*>(pData) +
+            packedColumnOffset(column);
+    QByteArray raw(dataSize, Qt::Uninitialized);
+    for (int i = 0; i < dataSize; ++i) {
+        raw[i] = static_cast<char>(pValues[i * sizeof(WaveformData)]);
+    }
+    return raw;
+}
+
+void scatterRaw(const unsigned char* pRaw, WaveformData* pData, int dataSize, int column) {
+    auto* pValues = reinterpret_cast<unsigned char*>(pData) +
+            packedColumnOffset(column);
+    for (int i = 0; i < dataSize; ++i) {
+        pValues[i * sizeof(WaveformData)] = pRaw[i];
+    }
+}
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -25,8 +178,12 @@ Waveform::Waveform(const QByteArray& data)
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
-          m_completion(-1) {
+          m_completion(-1),
+          m_preview(0),
+          m_stemCount(0),
+          m_maxLevelCount(0) {
     readByteArray(data);
+    buildMaxLevels();
 }
 
 Waveform::Waveform(
@@ -42,7 +199,9 @@ Waveform::Waveform(
           m_audioVisualRatio(0),
           m_textureStride(1024),
           m_completion(-1),
-          m_stemCount(stemCount) {
+          m_preview(0),
+          m_stemCount(stemCount),
+          m_maxLevelCount(0) {
     int numberOfVisualSamples = 0;
     if (audioSampleRate > 0) {
         if (maxVisualSamples == -1) {
@@ -151,11 +310,156 @@ QByteArray Waveform::toByteArray() const {
     return QByteArray(output.data(), static_cast<int>(output.length()));
 }
 
+// static
+bool Waveform::isPackedByteArray(const QByteArray& data) {
+    return data.startsWith(kPackedMagic);
+}
+
+QByteArray Waveform::toPackedByteArray() const {
+    const int dataSize = getDataSize();
+    const int columnCount = packedColumnCount(m_stemCount);
+    QVector<QByteArray> columns;
+    QVector<PackedEncoding> encodings;
+    columns.reserve(columnCount);
+    encodings.reserve(columnCount);
+    for (int column = 0; column < columnCount; ++column) {
+        QByteArray encoded = encodeDeltaZeroRuns(m_data.data(), dataSize, column);
+        if (encoded.size() < dataSize) {
+            columns.append(std::move(encoded));
+            encodings.append(PackedEncoding::DeltaZeroRuns);
+        } else {
+            // Noise doesn't compress
+            columns.append(gatherRaw(m_data.data(), dataSize, column));
+            encodings.append(PackedEncoding::Raw);
+        }
+    }
+
+    QByteArray packed;
+    QDataStream stream(&packed, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    stream.writeRawData(kPackedMagic.constData(), kPackedMagic.size());
+    stream << kPackedLayoutVersion
+           << static_cast<quint8>(m_stemCount)
+           << static_cast<quint8>(0)
+           << static_cast<qint32>(dataSize)
+           << m_visualSampleRate
+           << m_audioVisualRatio;
+    quint32 offset = kPackedHeaderSize + columnCount * kPackedColumnInfoSize;
+    for (int column = 0; column < columnCount; ++column) {
+        stream << static_cast<quint8>(encodings[column])
+               << offset
+               << static_cast<quint32>(columns[column].size());
+        offset += columns[column].size();
+    }
+    for (const auto& columnData : std::as_const(columns)) {
+        stream.writeRawData(columnData.constData(), columnData.size());
+    }
+    DEBUG_ASSERT(packed.size() == static_cast<int>(offset));
+
+    qDebug() << "Writing packed waveform:"
+             << "dataSize" << dataSize
+             << "stemCount" << m_stemCount
+             << "packedSize" << packed.size()
+             << "visualSampleRate" << m_visualSampleRate
+             << "audioVisualRatio" << m_audioVisualRatio;
+    return packed;
+}
+
+bool Waveform::readPackedByteArray(const QByteArray& data) {
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    if (stream.skipRawData(kPackedMagic.size()) != kPackedMagic.size()) {
+        return false;
+    }
+    quint16 layoutVersion;
+    quint8 stemCount;
+    quint8 reserved;
+    qint32 dataSize;
+    double visualSampleRate;
+    double audioVisualRatio;
+    stream >> layoutVersion >> stemCount >> reserved >> dataSize >>
+            visualSampleRate >> audioVisualRatio;
+    if (stream.status() != QDataStream::Ok ||
+            layoutVersion != kPackedLayoutVersion ||
+            stemCount > mixxx::kMaxSupportedStems ||
+            dataSize < 0 ||
+            // Each column encodes at most kMaxZeroRun values per byte
+            dataSize > static_cast<qint64>(data.size()) * kMaxZeroRun) {
+        qDebug() << "ERROR: Unsupported packed waveform header";
+        return false;
+    }
+
+    const int columnCount = packedColumnCount(stemCount);
+    const auto* pBytes = reinterpret_cast<const unsigned char*>(data.constData());
+    resize(dataSize);
+    for (int column = 0; column < columnCount; ++column) {
+        quint8 encoding;
+        quint32 offset;
+        quint32 size;
+        stream >> encoding >> offset >> size;
+        if (stream.status() != QDataStream::Ok ||
+                offset > static_cast<quint32>(data.size()) ||
+                size > static_cast<quint32>(data.size()) - offset) {
+            qDebug() << "ERROR: Packed waveform column" << column
+                     << "exceeds the data of size" << data.size();
+            return false;
+        }
+        switch (static_cast<PackedEncoding>(encoding)) {
+        case PackedEncoding::Raw:
+            if (size != static_cast<quint32>(dataSize)) {
+                qDebug() << "ERROR: Packed waveform column" << column
+                         << "has an invalid size";
+                return false;
+            }
+            scatterRaw(pBytes + offset, m_data.data(), dataSize, column);
+            break;
+        case PackedEncoding::DeltaZeroRuns:
+            if (!decodeDeltaZeroRuns(pBytes + offset,
+                        static_cast<int>(size),
+                        m_data.data(),
+                        dataSize,
+                        column)) {
+                qDebug() << "ERROR: Packed waveform column" << column
+                         << "is corrupt";
+                return false;
+            }
+            break;
+        default:
+            qDebug() << "ERROR: Packed waveform column" << column
+                     << "has an unknown encoding" << encoding;
+            return false;
+        }
+    }
+
+    qDebug() << "Reading packed waveform:"
+             << "dataSize" << dataSize
+             << "stemCount" << stemCount
+             << "visualSampleRate" << visualSampleRate
+             << "audioVisualRatio" << audioVisualRatio;
+
+    m_visualSampleRate = visualSampleRate;
+    m_audioVisualRatio = audioVisualRatio;
+    m_stemCount = stemCount;
+    m_completion = dataSize;
+    m_saveState = SaveState::Saved;
+    return true;
+}
+
 void Waveform::readByteArray(const QByteArray& data) {
     if (data.isNull()) {
         return;
     }
 
+    if (isPackedByteArray(data)) {
+        if (!readPackedByteArray(data)) {
+            resize(0);
+            m_saveState = SaveState::NotSaved;
+        }
+        return;
+    }
+
     io::Waveform waveform;
 
     if (!waveform.ParseFromArray(data.constData(), data.size())) {
@@ -251,6 +555,61 @@ void Waveform::assign(int size) {
     m_saveState = SaveState::SavePending;
 }
 
+void Waveform::buildMaxLevels() {
+    const auto locker = lockMutex(&m_mutex);
+    if (m_maxLevelCount.loadAcquire() > 0) {
+        return;
+    }
+    std::vector<std::vector<WaveformData>> maxLevels;
+    const WaveformData* pLowerLevel = m_data.data();
+    int lowerFrameCount = m_dataSize / 2;
+    while (lowerFrameCount > 1) {
+        const int frameCount = (lowerFrameCount + 1) / 2;
+        std::vector<WaveformData> level(frameCount * 2, WaveformData{});
+        for (int frame = 0; frame < frameCount; ++frame) {
+            const int lowerFrameStop = std::min(2 * frame + 2, lowerFrameCount);
+            for (int lowerFrame = 2 * frame; lowerFrame < lowerFrameStop; ++lowerFrame) {
+                storeMaxima(&level[frame * 2], pLowerLevel[lowerFrame * 2]);
+                storeMaxima(&level[frame * 2 + 1], pLowerLevel[lowerFrame * 2 + 1]);
+            }
+        }
+        maxLevels.push_back(std::move(level));
+        pLowerLevel = maxLevels.back().data();
+        lowerFrameCount = frameCount;
+    }
+    m_maxLevels = std::move(maxLevels);
+    // Moving the vector of levels doesn't move the data of the levels
+    m_maxLevelCount.storeRelease(static_cast<int>(m_maxLevels.size()));
+}
+
+WaveformData Waveform::getMaxima(
+        int visualFrameStart,
+        int visualFrameStop,
+        int channel) const {
+    DEBUG_ASSERT(channel == ChannelIndex::Left || channel == ChannelIndex::Right);
+    WaveformData maxima{};
+    const int frameStop = std::min(visualFrameStop, m_dataSize / 2);
+    const int levelCount = m_maxLevelCount.loadAcquire();
+    int frame = std::max(visualFrameStart, 0);
+    while (frame < frameStop) {
+        // Use the largest block that starts at this frame and doesn't
+        // exceed the range
+        int level = 0;
+        while (level < levelCount &&
+                (frame & ((2 << level) - 1)) == 0 &&
+                frame + (2 << level) <= frameStop) {
+            ++level;
+        }
+        if (level == 0) {
+            storeMaxima(&maxima, m_data[frame * 2 + channel]);
+        } else {
+            storeMaxima(&maxima, m_maxLevels[level - 1][(frame >> level) * 2 + channel]);
+        }
+        frame += 1 << level;
+    }
+    return maxima;
+}
+
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size(" + QString::number(getDataSize()) + ")"
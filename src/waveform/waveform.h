@@ -79,8 +79,15 @@ class Waveform {
         m_description = description;
     }
 
+    /// The protobuf serialization, see proto/waveform.proto
     QByteArray toByteArray() const;
 
+    /// A compact serialization with a column for each band and stem, that
+    /// are delta and run-length encoded. It is stored uncompressed and
+    /// could be read directly from a memory mapped file.
+    QByteArray toPackedByteArray() const;
+    static bool isPackedByteArray(const QByteArray& data);
+
     SaveState saveState() const {
         return m_saveState;
     }
@@ -106,6 +113,15 @@ class Waveform {
         m_completion = completion;
     }
 
+    // Whether the data after the completion contains a coarse preview
+    // that is overwritten while the analysis proceeds.
+    bool hasPreview() const {
+        return m_preview.loadAcquire() != 0;
+    }
+    void setPreview(bool preview) {
+        m_preview.storeRelease(preview ? 1 : 0);
+    }
+
     // We do not lock the mutex since m_textureStride is not changed after
     // the constructor runs.
     inline int getTextureStride() const { return m_textureStride; }
@@ -137,10 +153,41 @@ class Waveform {
         return m_stemCount > 0;
     }
 
+    /// Builds a pyramid of levels with the maximum values of 2, 4, 8, ...
+    /// consecutive visual frames. It allows getMaxima() to find the maximum
+    /// values of a range in logarithmic time when the waveform is zoomed
+    /// out. Must be invoked after all data has been computed. Subsequent
+    /// invocations have no effect.
+    void buildMaxLevels();
+
+    /// The maximum of each band and stem of the channel in the visual frames
+    /// [visualFrameStart, visualFrameStop), i.e. of the data at the indices
+    /// 2 * visualFrame + channel.
+    ///
+    /// Falls back to scanning the data while the pyramid has not been built,
+    /// e.g. while the waveform is still being analyzed.
+    WaveformData getMaxima(
+            int visualFrameStart,
+            int visualFrameStop,
+            int channel) const;
+
+    /// The number of levels built by buildMaxLevels() or 0.
+    int getMaxLevelCount() const {
+        return m_maxLevelCount.loadAcquire();
+    }
+
+    /// Level n (starting at 1) contains the maxima of 2^n visual frames,
+    /// interleaved left / right like data(). Only valid for levels up to
+    /// getMaxLevelCount().
+    const std::vector<WaveformData>& getMaxLevel(int level) const {
+        return m_maxLevels[level - 1];
+    }
+
     void dump() const;
 
   private:
     void readByteArray(const QByteArray& data);
+    bool readPackedByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size);
 
@@ -182,9 +229,17 @@ class Waveform {
     // the mutex. The completion of the waveform calculation.
     QAtomicInt m_completion;
 
+    QAtomicInt m_preview;
+
     // The number of stem contained in waveform samples. 0 if not a stem waveform
     int m_stemCount;
 
+    // Level n (starting at 1) contains the maximum of 2^n visual frames per
+    // channel, interleaved like m_data. The levels are not modified after
+    // publishing their count.
+    std::vector<std::vector<WaveformData>> m_maxLevels;
+    QAtomicInt m_maxLevelCount;
+
     mutable QMutex m_mutex;
 
     DISALLOW_COPY_AND_ASSIGN(Waveform);
@@ -0,0 +1,169 @@
+#include "waveform/waveformcache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("WaveformCache");
+
+qint64 estimateMemoryUsage(const ConstWaveformPointer& pWaveform) {
+    if (!pWaveform) {
+        return 0;
+    }
+    // The levels of maxima are about as large as the data itself
+    return static_cast<qint64>(
+                   pWaveform->getTextureSize() + pWaveform->getDataSize()) *
+            static_cast<qint64>(sizeof(WaveformData));
+}
+
+ConstWaveformPointer matchingVersion(
+        const QWeakPointer<const Waveform>& pWeakWaveform,
+        const QString& version) {
+    ConstWaveformPointer pWaveform = pWeakWaveform.toStrongRef();
+    if (pWaveform && pWaveform->getVersion() != version) {
+        return ConstWaveformPointer();
+    }
+    return pWaveform;
+}
+
+} // anonymous namespace
+
+qint64 WaveformCache::s_maxRetainedBytes = 0;
+QMutex WaveformCache::s_mutex;
+QHash<TrackId, WaveformCache::Entry> WaveformCache::s_entries;
+qint64 WaveformCache::s_retainedBytes = 0;
+quint64 WaveformCache::s_useCounter = 0;
+
+// static
+void WaveformCache::initialize(qint64 maxRetainedBytes) {
+    DEBUG_ASSERT(maxRetainedBytes >= 0);
+    const auto locker = lockMutex(&s_mutex);
+    s_maxRetainedBytes = maxRetainedBytes;
+    s_entries.clear();
+    s_retainedBytes = 0;
+}
+
+// static
+WaveformCache::Waveforms WaveformCache::lookup(
+        TrackId trackId,
+        const QString& waveformVersion,
+        const QString& waveformSummaryVersion) {
+    if (!isEnabled() || !trackId.isValid()) {
+        return Waveforms{};
+    }
+    const auto locker = lockMutex(&s_mutex);
+    const auto it = s_entries.find(trackId);
+    if (it == s_entries.end()) {
+        return Waveforms{};
+    }
+    it->lastUsed = ++s_useCounter;
+    Waveforms waveforms{
+            matchingVersion(it->pWaveform, waveformVersion),
+            matchingVersion(it->pWaveformSummary, waveformSummaryVersion)};
+    if (waveforms.pWaveform || waveforms.pWaveformSummary) {
+        kLogger.debug() << "Found waveforms of track" << trackId;
+    }
+    return waveforms;
+}
+
+// static
+void WaveformCache::insert(
+        TrackId trackId,
+        const ConstWaveformPointer& pWaveform,
+        const ConstWaveformPointer& pWaveformSummary) {
+    if (!isEnabled() || !trackId.isValid()) {
+        return;
+    }
+    const auto locker = lockMutex(&s_mutex);
+    Entry& entry = s_entries[trackId];
+    s_retainedBytes -= entry.retainedBytes;
+    // Keep the previous waveforms if only one of them is replaced
+    if (pWaveform) {
+        entry.pWaveform = pWaveform;
+        entry.pRetainedWaveform = pWaveform;
+    }
+    if (pWaveformSummary) {
+        entry.pWaveformSummary = pWaveformSummary;
+        entry.pRetainedWaveformSummary = pWaveformSummary;
+    }
+    entry.retainedBytes = estimateMemoryUsage(entry.pRetainedWaveform) +
+            estimateMemoryUsage(entry.pRetainedWaveformSummary);
+    s_retainedBytes += entry.retainedBytes;
+    entry.lastUsed = ++s_useCounter;
+    releaseLeastRecentlyUsedLocked(s_maxRetainedBytes);
+}
+
+// static
+void WaveformCache::remove(TrackId trackId) {
+    const auto locker = lockMutex(&s_mutex);
+    const auto it = s_entries.find(trackId);
+    if (it == s_entries.end()) {
+        return;
+    }
+    s_retainedBytes -= it->retainedBytes;
+    s_entries.erase(it);
+}
+
+// static
+void WaveformCache::clear() {
+    const auto locker = lockMutex(&s_mutex);
+    s_entries.clear();
+    s_retainedBytes = 0;
+}
+
+// static
+qint64 WaveformCache::retainedBytes() {
+    const auto locker = lockMutex(&s_mutex);
+    return s_retainedBytes;
+}
+
+// static
+void WaveformCache::trim(qint64 maxRetainedBytes) {
+    DEBUG_ASSERT(maxRetainedBytes >= 0);
+    const auto locker = lockMutex(&s_mutex);
+    const qint64 retainedBytesBefore = s_retainedBytes;
+    releaseLeastRecentlyUsedLocked(std::min(maxRetainedBytes, s_maxRetainedBytes));
+    kLogger.debug() << "Trimmed from" << retainedBytesBefore << "to"
+                    << s_retainedBytes << "bytes";
+}
+
+// static
+void WaveformCache::releaseLeastRecentlyUsedLocked(qint64 maxRetainedBytes) {
+    if (s_retainedBytes > maxRetainedBytes) {
+        std::vector<QHash<TrackId, Entry>::iterator> retainedEntries;
+        for (auto it = s_entries.begin(); it != s_entries.end(); ++it) {
+            if (it->retainedBytes > 0) {
+                retainedEntries.push_back(it);
+            }
+        }
+        std::sort(retainedEntries.begin(),
+                retainedEntries.end(),
+                [](const auto& lhs, const auto& rhs) {
+                    return lhs->lastUsed < rhs->lastUsed;
+                });
+        for (const auto& it : retainedEntries) {
+            if (s_retainedBytes <= maxRetainedBytes) {
+                break;
+            }
+            // Still found while the track holds them
+            it->pRetainedWaveform.clear();
+            it->pRetainedWaveformSummary.clear();
+            s_retainedBytes -= it->retainedBytes;
+            it->retainedBytes = 0;
+        }
+    }
+    for (auto it = s_entries.begin(); it != s_entries.end();) {
+        if (it->retainedBytes == 0 &&
+                it->pWaveform.isNull() &&
+                it->pWaveformSummary.isNull()) {
+            it = s_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
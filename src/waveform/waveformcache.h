@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWeakPointer>
+
+#include "track/trackid.h"
+#include "waveform/waveform.h"
+
+/// Shares the waveforms of a track between all players and keeps the
+/// waveforms of recently unloaded tracks in memory.
+///
+/// The waveforms are referenced weakly while they are in use, i.e. they
+/// are found as long as any track holds them. Additionally the most
+/// recently used waveforms are held strongly until their total size
+/// exceeds the limit, such that loading a track again doesn't need to
+/// read and decode its waveforms from the analysis storage.
+///
+/// All functions are thread-safe.
+class WaveformCache {
+  public:
+    struct Waveforms {
+        ConstWaveformPointer pWaveform;
+        ConstWaveformPointer pWaveformSummary;
+    };
+
+    /// Enables the cache. Not thread-safe, must be called only once upon
+    /// startup before analyzing any tracks. The limit applies to the
+    /// waveforms that are held by the cache, including those that are
+    /// still in use.
+    static void initialize(qint64 maxRetainedBytes);
+
+    static bool isEnabled() {
+        return s_maxRetainedBytes > 0;
+    }
+
+    /// Only returns waveforms of the given versions. Either of them might
+    /// be null.
+    static Waveforms lookup(
+            TrackId trackId,
+            const QString& waveformVersion,
+            const QString& waveformSummaryVersion);
+
+    /// Replaces the cached waveforms of the track. Waveforms must not be
+    /// modified after they have been inserted.
+    static void insert(
+            TrackId trackId,
+            const ConstWaveformPointer& pWaveform,
+            const ConstWaveformPointer& pWaveformSummary);
+
+    /// Invoked when the stored analyses are deleted
+    static void remove(TrackId trackId);
+    static void clear();
+
+    /// The size of the waveforms that are held strongly
+    static qint64 retainedBytes();
+
+    /// Releases the least recently used waveforms until no more than the
+    /// given size is held, e.g. to stay within a memory budget that is
+    /// smaller than the limit.
+    static void trim(qint64 maxRetainedBytes);
+
+  private:
+    struct Entry {
+        QWeakPointer<const Waveform> pWaveform;
+        QWeakPointer<const Waveform> pWaveformSummary;
+        // null if not retained
+        ConstWaveformPointer pRetainedWaveform;
+        ConstWaveformPointer pRetainedWaveformSummary;
+        qint64 retainedBytes = 0;
+        quint64 lastUsed = 0;
+    };
+
+    /// Releases the least recently used waveforms until the total size
+    /// doesn't exceed maxRetainedBytes and removes entries that are no
+    /// longer referenced.
+    static void releaseLeastRecentlyUsedLocked(qint64 maxRetainedBytes);
+
+    static qint64 s_maxRetainedBytes;
+
+    static QMutex s_mutex;
+    static QHash<TrackId, Entry> s_entries;
+    static qint64 s_retainedBytes;
+    static quint64 s_useCounter;
+};
@@ -1,4 +1,6 @@
 #include "waveform/waveformfactory.h"
+
+#include "util/assert.h"
 #include "waveform/waveform.h"
 
 // static
@@ -11,6 +13,26 @@ Waveform* WaveformFactory::loadWaveformFromAnalysis(
     return pWaveform;
 }
 
+// static
+Waveform* WaveformFactory::upgradeWaveformFromAnalysis(
+        AnalysisDao::AnalysisInfo* pAnalysis) {
+    if (pAnalysis->type == AnalysisDao::TYPE_WAVEFORM) {
+        DEBUG_ASSERT(waveformVersionToVersionClass(pAnalysis->version) == VC_UPGRADE);
+        pAnalysis->version = currentWaveformVersion();
+        pAnalysis->description = currentWaveformDescription();
+    } else {
+        DEBUG_ASSERT(pAnalysis->type == AnalysisDao::TYPE_WAVESUMMARY);
+        DEBUG_ASSERT(waveformSummaryVersionToVersionClass(pAnalysis->version) == VC_UPGRADE);
+        pAnalysis->version = currentWaveformSummaryVersion();
+        pAnalysis->description = currentWaveformSummaryDescription();
+    }
+    Waveform* pWaveform = loadWaveformFromAnalysis(*pAnalysis);
+    pAnalysis->data = pWaveform->toPackedByteArray();
+    // Don't keep the memory mapped file of the previous data
+    pAnalysis->mappedFile.reset();
+    return pWaveform;
+}
+
 // static
 WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(const QString& version) {
     if (version == WAVEFORM_CURRENT_VERSION) {
@@ -18,6 +40,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(con
         return VC_USE;
     }
 
+    if (version == WAVEFORM_UPGRADABLE_VERSION) {
+        // same data, but not packed yet
+        return VC_UPGRADE;
+    }
+
     if (version == WAVEFORM_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug #7776
         return VC_REMOVE;
@@ -52,6 +79,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformSummaryVersionToVersionCl
         return VC_USE;
     }
 
+    if (version == WAVEFORMSUMMARY_UPGRADABLE_VERSION) {
+        // same data, but not packed yet
+        return VC_UPGRADE;
+    }
+
     if (version == WAVEFORMSUMMARY_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug #7776
         return VC_REMOVE;
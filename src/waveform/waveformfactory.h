@@ -36,25 +36,52 @@ class Waveform;
 #define WAVEFORM_6_DESCRIPTION "Waveform 6.1"
 #define WAVEFORMSUMMARY_6_DESCRIPTION "WaveformSummary 6.1"
 
-#define WAVEFORM_CURRENT_VERSION WAVEFORM_6_VERSION
-#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_6_DESCRIPTION
+
+// The data of 6.1 in the packed storage format, see
+// Waveform::toPackedByteArray()
+#define WAVEFORM_7_VERSION "Waveform-7.0"
+#define WAVEFORM_7_DESCRIPTION "Waveform 7.0"
+
+#define WAVEFORM_CURRENT_VERSION WAVEFORM_7_VERSION
+#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_7_DESCRIPTION
+// Converted to the current version without analyzing the track again
+#define WAVEFORM_UPGRADABLE_VERSION WAVEFORM_6_VERSION
 #else
-#define WAVEFORM_CURRENT_VERSION WAVEFORM_5_VERSION
-#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_5_DESCRIPTION
+// The data of 5.0 in the packed storage format, see
+// Waveform::toPackedByteArray()
+#define WAVEFORM_5_1_VERSION "Waveform-5.1"
+#define WAVEFORM_5_1_DESCRIPTION "Waveform 5.1"
+
+#define WAVEFORM_CURRENT_VERSION WAVEFORM_5_1_VERSION
+#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_5_1_DESCRIPTION
+#define WAVEFORM_UPGRADABLE_VERSION WAVEFORM_5_VERSION
 #endif
-#define WAVEFORMSUMMARY_CURRENT_VERSION WAVEFORMSUMMARY_5_VERSION
-#define WAVEFORMSUMMARY_CURRENT_DESCRIPTION WAVEFORMSUMMARY_5_DESCRIPTION
+
+// The data of 5.0 in the packed storage format
+#define WAVEFORMSUMMARY_7_VERSION "WaveformSummary-7.0"
+#define WAVEFORMSUMMARY_7_DESCRIPTION "WaveformSummary 7.0"
+
+#define WAVEFORMSUMMARY_CURRENT_VERSION WAVEFORMSUMMARY_7_VERSION
+#define WAVEFORMSUMMARY_CURRENT_DESCRIPTION WAVEFORMSUMMARY_7_DESCRIPTION
+#define WAVEFORMSUMMARY_UPGRADABLE_VERSION WAVEFORMSUMMARY_5_VERSION
 
 class WaveformFactory {
   public:
     enum VersionClass {
         VC_USE,
+        // Use after converting with upgradeWaveformFromAnalysis()
+        VC_UPGRADE,
         VC_KEEP,
         VC_REMOVE
     };
 
     static Waveform* loadWaveformFromAnalysis(
             const AnalysisDao::AnalysisInfo& analysis);
+    /// Loads a waveform of an upgradable version and replaces the data,
+    /// version and description of the analysis with the current ones.
+    /// The analysis needs to be saved by the caller.
+    static Waveform* upgradeWaveformFromAnalysis(
+            AnalysisDao::AnalysisInfo* pAnalysis);
     static VersionClass waveformVersionToVersionClass(const QString& version);
     static VersionClass waveformSummaryVersionToVersionClass(const QString& version);
     static QString currentWaveformVersion();
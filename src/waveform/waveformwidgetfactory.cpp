@@ -3,6 +3,7 @@
 #include "waveform/waveform.h"
 
 #ifdef MIXXX_USE_QOPENGL
+#include <QOpenGLContext>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLWindow>
 #else
@@ -21,6 +22,7 @@
 #include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/timer.h"
+#include "util/tracing.h"
 #include "waveform/guitick.h"
 #include "waveform/sharedglcontext.h"
 #include "waveform/visualsmanager.h"
@@ -59,6 +61,37 @@ bool shouldRenderWaveform(WaveformWidgetAbstract* pWaveformWidget) {
 }
 
 const QRegularExpression openGLVersionRegex(QStringLiteral("^(\\d+)\\.(\\d+).*$"));
+
+const QString kRenderTimeStatKey = QStringLiteral("WaveformWidgetFactory::renderTime");
+const QString kSwapTimeStatKey = QStringLiteral("WaveformWidgetFactory::swapTime");
+const QString kGuiLatencyStatKey = QStringLiteral("WaveformWidgetFactory::guiLatency");
+const QString kDroppedFramesStatKey = QStringLiteral("WaveformWidgetFactory::droppedFrames");
+
+// Weight of the latest frame in the moving average of the render load
+constexpr double kRenderLoadSmoothing = 0.05;
+// The hysteresis prevents that the overviews toggle between both rates
+constexpr double kRenderLoadExceededThreshold = 0.9;
+constexpr double kRenderLoadRecoveredThreshold = 0.6;
+
+// The engine load is smoothed at the GUI frame rate like the render load.
+// Above 1.0 the engine misses its deadline and the audio drops out.
+constexpr double kEngineLoadSmoothing = 0.05;
+constexpr double kEngineLoadBusyThreshold = 0.8;
+constexpr double kEngineLoadRecoveredThreshold = 0.6;
+
+// Returns true for every other frame while the engine is busy
+bool skipWaveformFrame(bool engineBusy, bool* pPreviousFrameSkipped) {
+    *pPreviousFrameSkipped = engineBusy && !*pPreviousFrameSkipped;
+    return *pPreviousFrameSkipped;
+}
+
+// Rounded to 0.1 ms, otherwise the histogram would have a bin per frame
+void trackFrameTime(const QString& key, mixxx::Duration duration) {
+    Stat::track(key,
+            Stat::DURATION_MSEC,
+            kDefaultComputeFlags | Stat::HISTOGRAM,
+            std::round(duration.toDoubleMillis() * 10) / 10);
+}
 }  // anonymous namespace
 
 ///////////////////////////////////////////
@@ -72,7 +105,8 @@ WaveformWidgetAbstractHandle::WaveformWidgetAbstractHandle()
 WaveformWidgetHolder::WaveformWidgetHolder()
         : m_waveformWidget(nullptr),
           m_waveformViewer(nullptr),
-          m_skinContextCache(UserSettingsPointer(), QString()) {
+          m_skinContextCache(UserSettingsPointer(), QString()),
+          m_renderOnThread(false) {
 }
 
 WaveformWidgetHolder::WaveformWidgetHolder(WaveformWidgetAbstract* waveformWidget,
@@ -82,7 +116,8 @@ WaveformWidgetHolder::WaveformWidgetHolder(WaveformWidgetAbstract* waveformWidge
     : m_waveformWidget(waveformWidget),
       m_waveformViewer(waveformViewer),
       m_skinNodeCache(node.cloneNode()),
-      m_skinContextCache(&parentContext) {
+      m_skinContextCache(&parentContext),
+      m_renderOnThread(false) {
 }
 
 ///////////////////////////////////////////
@@ -114,6 +149,18 @@ WaveformWidgetFactory::WaveformWidgetFactory()
           m_pVisualsManager(nullptr),
           m_frameCnt(0),
           m_actualFrameRate(0),
+          m_lastDroppedFrames(0),
+          m_renderLoad(0.0),
+          m_adaptiveOverviewFrameRate(true),
+          m_renderBudgetExceeded(false),
+          m_engineLoad(0.0),
+          m_adaptiveToEngineLoad(true),
+          m_engineBusy(false),
+          m_guiWaveformFrameSkipped(false),
+          m_renderThreadWaveformFrameSkipped(false),
+          m_renderThreadEnabled(false),
+          m_guiRenderPending(false),
+          m_guiSwapPending(false),
           m_playMarkerPosition(WaveformWidgetRenderer::s_defaultPlayMarkerPosition) {
     m_visualGain[AllBand] = 1.0;
     m_visualGain[Low] = 1.0;
@@ -331,6 +378,15 @@ WaveformWidgetFactory::~WaveformWidgetFactory() {
     if (m_vsyncThread) {
         delete m_vsyncThread;
     }
+#ifdef MIXXX_USE_QOPENGL
+    // Not used anymore after the render thread has been stopped
+    QOpenGLContext* pRenderThreadContext = SharedGLContext::getRenderThreadContext();
+    SharedGLContext::setRenderThreadContext(nullptr);
+    delete pRenderThreadContext;
+    QOpenGLContext* pGuiThreadContext = SharedGLContext::getGuiThreadContext();
+    SharedGLContext::setGuiThreadContext(nullptr);
+    delete pGuiThreadContext;
+#endif
 }
 
 bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
@@ -344,6 +400,12 @@ bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
     int frameRate = m_config->getValue(ConfigKey("[Waveform]","FrameRate"), m_frameRate);
     m_frameRate = math_clamp(frameRate, 1, 120);
 
+    m_adaptiveOverviewFrameRate = m_config->getValue(
+            ConfigKey("[Waveform]", "AdaptiveOverviewFrameRate"),
+            m_adaptiveOverviewFrameRate);
+    m_adaptiveToEngineLoad = m_config->getValue(
+            ConfigKey("[Waveform]", "AdaptiveToEngineLoad"),
+            m_adaptiveToEngineLoad);
 
     int endTime = m_config->getValueString(ConfigKey("[Waveform]","EndOfTrackWarningTime")).toInt(&ok);
     if (ok) {
@@ -432,6 +494,7 @@ bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
 }
 
 void WaveformWidgetFactory::destroyWidgets() {
+    const auto locked = lockRendering();
     for (auto& holder : m_waveformWidgetHolders) {
         WaveformWidgetAbstract* pWidget = holder.m_waveformWidget;
         holder.m_waveformWidget = nullptr;
@@ -477,6 +540,7 @@ void WaveformWidgetFactory::slotSkinLoaded() {
 bool WaveformWidgetFactory::setWaveformWidget(WWaveformViewer* viewer,
                                               const QDomElement& node,
                                               const SkinContext& parentContext) {
+    const auto locked = lockRendering();
     int index = findIndexOf(viewer);
     if (index != -1) {
         qDebug() << "WaveformWidgetFactory::setWaveformWidget - "\
@@ -492,6 +556,7 @@ bool WaveformWidgetFactory::setWaveformWidget(WWaveformViewer* viewer,
 
     // create new holder
     WaveformWidgetHolder holder(waveformWidget, viewer, node, &parentContext);
+    setupRenderThread(&holder);
     if (index == -1) {
         // add holder
         m_waveformWidgetHolders.push_back(std::move(holder));
@@ -601,6 +666,8 @@ bool WaveformWidgetFactory::setWidgetTypeFromHandle(int handleIndex, bool force)
         return true;
     }
 
+    const auto locked = lockRendering();
+
     // change the type
     setWidgetType(handle.m_type);
 
@@ -618,6 +685,7 @@ bool WaveformWidgetFactory::setWidgetTypeFromHandle(int handleIndex, bool force)
         WWaveformViewer* viewer = holder.m_waveformViewer;
         WaveformWidgetAbstract* widget = createWaveformWidget(m_type, holder.m_waveformViewer);
         holder.m_waveformWidget = widget;
+        setupRenderThread(&holder);
         viewer->setWaveformWidget(widget);
         viewer->setup(holder.m_skinNodeCache, holder.m_skinContextCache);
         viewer->setZoom(previousZoom);
@@ -637,6 +705,7 @@ bool WaveformWidgetFactory::setWidgetTypeFromHandle(int handleIndex, bool force)
 }
 
 void WaveformWidgetFactory::setDefaultZoom(double zoom) {
+    const auto locked = lockRendering();
     m_defaultZoom = math_clamp(zoom, WaveformWidgetRenderer::s_waveformMinZoom,
                                WaveformWidgetRenderer::s_waveformMaxZoom);
     if (m_config) {
@@ -649,6 +718,7 @@ void WaveformWidgetFactory::setDefaultZoom(double zoom) {
 }
 
 void WaveformWidgetFactory::setZoomSync(bool sync) {
+    const auto locked = lockRendering();
     m_zoomSync = sync;
     if (m_config) {
         m_config->set(ConfigKey("[Waveform]","ZoomSynchronization"), ConfigValue(m_zoomSync));
@@ -665,6 +735,7 @@ void WaveformWidgetFactory::setZoomSync(bool sync) {
 }
 
 void WaveformWidgetFactory::setDisplayBeatGridAlpha(int alpha) {
+    const auto locked = lockRendering();
     m_beatGridAlpha = alpha;
     if (m_waveformWidgetHolders.size() == 0) {
         return;
@@ -676,6 +747,7 @@ void WaveformWidgetFactory::setDisplayBeatGridAlpha(int alpha) {
 }
 
 void WaveformWidgetFactory::setVisualGain(BandIndex index, double gain) {
+    const auto locked = lockRendering();
     m_visualGain[index] = gain;
     if (m_config) {
         m_config->set(ConfigKey("[Waveform]","VisualGain_" + QString::number(index)), QString::number(m_visualGain[index]));
@@ -699,7 +771,17 @@ void WaveformWidgetFactory::setOverviewNormalized(bool normalize) {
     emit overviewNormalizeChanged();
 }
 
+void WaveformWidgetFactory::setAdaptiveToEngineLoad(bool adaptive) {
+    m_adaptiveToEngineLoad = adaptive;
+    if (m_config) {
+        m_config->setValue(ConfigKey("[Waveform]", "AdaptiveToEngineLoad"),
+                m_adaptiveToEngineLoad);
+    }
+    updateEngineLoad();
+}
+
 void WaveformWidgetFactory::setPlayMarkerPosition(double position) {
+    const auto locked = lockRendering();
     m_playMarkerPosition = position;
     if (m_config) {
         m_config->setValue(ConfigKey("[Waveform]", "PlayMarkerPosition"), m_playMarkerPosition);
@@ -711,6 +793,7 @@ void WaveformWidgetFactory::setPlayMarkerPosition(double position) {
 }
 
 void WaveformWidgetFactory::notifyZoomChange(WWaveformViewer* viewer) {
+    const auto locked = lockRendering();
     WaveformWidgetAbstract* pWaveformWidget = viewer->getWaveformWidget();
     if (pWaveformWidget == nullptr || !isZoomSync()) {
         return;
@@ -728,48 +811,32 @@ void WaveformWidgetFactory::renderSelf() {
     ScopedTimer t(QStringLiteral("WaveformWidgetFactory::render() %1waveforms"),
             static_cast<int>(m_waveformWidgetHolders.size()));
 
+    updateEngineLoad();
+
     if (!m_skipRender) {
-        if (m_type) {   // no regular updates for an empty waveform
-            // next rendered frame is displayed after next buffer swap and than after VSync
-            QVarLengthArray<bool, 10> shouldRenderWaveforms(
-                    static_cast<int>(m_waveformWidgetHolders.size()));
-            for (decltype(m_waveformWidgetHolders)::size_type i = 0;
-                    i < m_waveformWidgetHolders.size();
-                    i++) {
-                WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
-                // Don't bother doing the pre-render work if we aren't going to
-                // render this widget.
-                bool shouldRender = shouldRenderWaveform(pWaveformWidget);
-                shouldRenderWaveforms[static_cast<int>(i)] = shouldRender;
-                if (!shouldRender) {
-                    continue;
-                }
-                // Calculate play position for the new Frame in following run
-                pWaveformWidget->preRender(m_vsyncThread);
-            }
-            //qDebug() << "prerender" << m_vsyncThread->elapsed();
-
-            // It may happen that there is an artificially delayed due to
-            // anti tearing driver settings
-            // all render commands are delayed until the swap from the previous run is executed
-            for (decltype(m_waveformWidgetHolders)::size_type i = 0;
-                    i < m_waveformWidgetHolders.size();
-                    i++) {
-                WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
-                if (!shouldRenderWaveforms[static_cast<int>(i)]) {
-                    continue;
-                }
-                pWaveformWidget->render();
-                //qDebug() << "render" << i << m_vsyncThread->elapsed();
-            }
+        const mixxx::Duration guiLatency = m_vsyncThread->sinceLastSignal();
+        trackFrameTime(kGuiLatencyStatKey, guiLatency);
+
+        PerformanceTimer renderTimer;
+        renderTimer.start();
+        // no regular updates for an empty waveform
+        if (m_type && !skipWaveformFrame(m_engineBusy, &m_guiWaveformFrameSkipped)) {
+            renderWaveforms(false);
         }
 
         // WSpinnys are also double-buffered WGLWidgets, like all the waveform
-        // renderers. Render all the WSpinny widgets now.
-        emit renderSpinnies(m_vsyncThread);
+        // renderers. Render all the WSpinny widgets now. They only show
+        // the rotation, so they are the first to pause while the engine is
+        // busy.
+        if (!m_engineBusy) {
+            emit renderSpinnies(m_vsyncThread);
+        }
         // Same for WVuMeterGL. Note that we are either using WVuMeter or WVuMeterGL.
         // If we are using WVuMeter, this does nothing
         emit renderVuMeters(m_vsyncThread);
+#ifdef MIXXX_USE_QOPENGL
+        SharedGLContext::doneCurrent();
+#endif
 
         // Notify all other waveform-like widgets (e.g. WSpinny's) that they should
         // update.
@@ -777,13 +844,8 @@ void WaveformWidgetFactory::renderSelf() {
         emit waveformUpdateTick();
         //qDebug() << "emit" << m_vsyncThread->elapsed() - t1;
 
-        m_frameCnt += 1.0f;
-        mixxx::Duration timeCnt = m_time.elapsed();
-        if (timeCnt > mixxx::Duration::fromSeconds(1)) {
-            m_time.start();
-            m_frameCnt = m_frameCnt * 1000 / timeCnt.toIntegerMillis(); // latency correction
-            emit waveformMeasured(m_frameCnt, m_vsyncThread->droppedFrames());
-            m_frameCnt = 0.0;
+        if (!m_renderThreadEnabled) {
+            measureFrame(renderTimer.elapsed(), guiLatency);
         }
     }
 
@@ -793,6 +855,79 @@ void WaveformWidgetFactory::renderSelf() {
     //qDebug() << "refresh end" << m_vsyncThread->elapsed();
 }
 
+void WaveformWidgetFactory::renderWaveforms(bool onRenderThread) {
+    MIXXX_TRACE_SCOPE("WaveformWidgetFactory::renderWaveforms");
+    // next rendered frame is displayed after next buffer swap and than after VSync
+    QVarLengthArray<bool, 10> shouldRenderWaveforms(
+            static_cast<int>(m_waveformWidgetHolders.size()));
+    for (decltype(m_waveformWidgetHolders)::size_type i = 0;
+            i < m_waveformWidgetHolders.size();
+            i++) {
+        const WaveformWidgetHolder& holder = m_waveformWidgetHolders[i];
+        WaveformWidgetAbstract* pWaveformWidget = holder.m_waveformWidget;
+        // Don't bother doing the pre-render work if we aren't going to
+        // render this widget.
+        bool shouldRender = holder.m_renderOnThread == onRenderThread &&
+                shouldRenderWaveform(pWaveformWidget);
+        shouldRenderWaveforms[static_cast<int>(i)] = shouldRender;
+        if (!shouldRender) {
+            continue;
+        }
+        // Calculate play position for the new Frame in following run
+        pWaveformWidget->preRender(m_vsyncThread);
+    }
+    //qDebug() << "prerender" << m_vsyncThread->elapsed();
+
+    // It may happen that there is an artificially delayed due to
+    // anti tearing driver settings
+    // all render commands are delayed until the swap from the previous run is executed
+    for (decltype(m_waveformWidgetHolders)::size_type i = 0;
+            i < m_waveformWidgetHolders.size();
+            i++) {
+        WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
+        if (!shouldRenderWaveforms[static_cast<int>(i)]) {
+            continue;
+        }
+#ifdef MIXXX_USE_QOPENGL
+        if (onRenderThread) {
+            // Resizing needs the context of this thread
+            pWaveformWidget->getGLWidget()->resizeGLIfRequested();
+        }
+#endif
+        pWaveformWidget->render();
+        //qDebug() << "render" << i << m_vsyncThread->elapsed();
+    }
+}
+
+void WaveformWidgetFactory::measureFrame(
+        mixxx::Duration renderTime, mixxx::Duration latency) {
+    trackFrameTime(kRenderTimeStatKey, renderTime);
+    m_renderTimeSum += renderTime;
+    m_maxGuiLatency = math_max(m_maxGuiLatency, latency);
+    updateRenderBudget(renderTime);
+
+    m_frameCnt += 1.0f;
+    const float frameCnt = m_frameCnt;
+    mixxx::Duration timeCnt = m_time.elapsed();
+    if (timeCnt > mixxx::Duration::fromSeconds(1)) {
+        m_time.start();
+        m_frameCnt = m_frameCnt * 1000 / timeCnt.toIntegerMillis(); // latency correction
+        const int droppedFrames = m_vsyncThread->droppedFrames();
+        Stat::track(kDroppedFramesStatKey,
+                Stat::COUNTER,
+                Stat::COUNT | Stat::SUM | Stat::MAX,
+                droppedFrames - m_lastDroppedFrames);
+        m_lastDroppedFrames = droppedFrames;
+        emit waveformMeasured(m_frameCnt, droppedFrames);
+        emit frameTimingsMeasured(
+                m_renderTimeSum.toDoubleMillis() / frameCnt,
+                m_maxGuiLatency.toDoubleMillis());
+        m_frameCnt = 0.0;
+        m_renderTimeSum = mixxx::Duration();
+        m_maxGuiLatency = mixxx::Duration();
+    }
+}
+
 void WaveformWidgetFactory::render() {
     renderSelf();
     m_vsyncThread->vsyncSlotFinished();
@@ -804,34 +939,174 @@ void WaveformWidgetFactory::swapSelf() {
 
     // Do this in an extra slot to be sure to hit the desired interval
     if (!m_skipRender) {
-        if (m_type) {   // no regular updates for an empty waveform
-            // Show rendered buffer from last render() run
-            //qDebug() << "swap() start" << m_vsyncThread->elapsed();
-            for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
-                WaveformWidgetAbstract* pWaveformWidget = holder.m_waveformWidget;
-
-                // Don't swap invalid / invisible widgets or widgets with an
-                // unexposed window. Prevents continuous log spew of
-                // "QOpenGLContext::swapBuffers() called with non-exposed
-                // window, behavior is undefined" on Qt5. See issue #9360.
-                if (!shouldRenderWaveform(pWaveformWidget)) {
-                    continue;
-                }
-                WGLWidget* glw = pWaveformWidget->getGLWidget();
-                if (glw != nullptr) {
-                    glw->makeCurrentIfNeeded();
-                    glw->swapBuffers();
-                    glw->doneCurrent();
-                }
-                //qDebug() << "swap x" << m_vsyncThread->elapsed();
-            }
+        PerformanceTimer swapTimer;
+        swapTimer.start();
+        // no regular updates for an empty waveform, and nothing to show
+        // if the last frame was skipped
+        if (m_type && !m_guiWaveformFrameSkipped) {
+            swapWaveforms(false);
         }
         // WSpinnys are also double-buffered QGLWidgets, like all the waveform
         // renderers. Swap all the WSpinny widgets now.
-        emit swapSpinnies();
+        if (!m_engineBusy) {
+            emit swapSpinnies();
+        }
         // Same for WVuMeterGL. Note that we are either using WVuMeter or WVuMeterGL
         // If we are using WVuMeter, this does nothing
         emit swapVuMeters();
+#ifdef MIXXX_USE_QOPENGL
+        SharedGLContext::doneCurrent();
+#endif
+
+        if (!m_renderThreadEnabled) {
+            m_lastSwapTime = swapTimer.elapsed();
+            trackFrameTime(kSwapTimeStatKey, m_lastSwapTime);
+        }
+    }
+}
+
+void WaveformWidgetFactory::swapWaveforms(bool onRenderThread) {
+    // Show rendered buffer from last render() run
+    //qDebug() << "swap() start" << m_vsyncThread->elapsed();
+    for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
+        WaveformWidgetAbstract* pWaveformWidget = holder.m_waveformWidget;
+
+        // Don't swap invalid / invisible widgets or widgets with an
+        // unexposed window. Prevents continuous log spew of
+        // "QOpenGLContext::swapBuffers() called with non-exposed
+        // window, behavior is undefined" on Qt5. See issue #9360.
+        if (holder.m_renderOnThread != onRenderThread ||
+                !shouldRenderWaveform(pWaveformWidget)) {
+            continue;
+        }
+        WGLWidget* glw = pWaveformWidget->getGLWidget();
+        if (glw != nullptr) {
+            glw->makeCurrentIfNeeded();
+            glw->swapBuffers();
+            glw->doneCurrent();
+        }
+        //qDebug() << "swap x" << m_vsyncThread->elapsed();
+    }
+}
+
+#ifdef MIXXX_USE_QOPENGL
+void WaveformWidgetFactory::renderOnThread() {
+    {
+        const auto locked = lockRendering();
+        if (!m_skipRender && m_type &&
+                !skipWaveformFrame(m_engineBusy, &m_renderThreadWaveformFrameSkipped)) {
+            const mixxx::Duration latency = m_vsyncThread->sinceLastSignal();
+            PerformanceTimer renderTimer;
+            renderTimer.start();
+            renderWaveforms(true);
+            SharedGLContext::doneCurrent();
+            measureFrame(renderTimer.elapsed(), latency);
+        }
+    }
+    m_vsyncThread->vsyncSlotFinished();
+
+    // The remaining widgets are rendered on the GUI thread. Frames are
+    // skipped instead of queued up while the GUI thread is busy.
+    if (!m_guiRenderPending.exchange(true)) {
+        QMetaObject::invokeMethod(
+                this,
+                [this]() {
+                    m_guiRenderPending = false;
+                    renderSelf();
+                },
+                Qt::QueuedConnection);
+    }
+}
+
+void WaveformWidgetFactory::swapOnThread() {
+    {
+        const auto locked = lockRendering();
+        if (!m_skipRender && m_type && !m_renderThreadWaveformFrameSkipped) {
+            PerformanceTimer swapTimer;
+            swapTimer.start();
+            swapWaveforms(true);
+            SharedGLContext::doneCurrent();
+            m_lastSwapTime = swapTimer.elapsed();
+            trackFrameTime(kSwapTimeStatKey, m_lastSwapTime);
+        }
+    }
+    m_vsyncThread->vsyncSlotFinished();
+
+    if (!m_guiSwapPending.exchange(true)) {
+        QMetaObject::invokeMethod(
+                this,
+                [this]() {
+                    m_guiSwapPending = false;
+                    swapSelf();
+                },
+                Qt::QueuedConnection);
+    }
+}
+#endif
+
+std::unique_lock<std::recursive_mutex> WaveformWidgetFactory::lockRendering() {
+    if (!m_renderThreadEnabled) {
+        return std::unique_lock<std::recursive_mutex>();
+    }
+    return std::unique_lock<std::recursive_mutex>(m_renderMutex);
+}
+
+void WaveformWidgetFactory::setupRenderThread(WaveformWidgetHolder* pHolder) const {
+    pHolder->m_renderOnThread = false;
+#ifdef MIXXX_USE_QOPENGL
+    // Only the allshader widgets don't paint with a QPainter, which is
+    // restricted to the GUI thread
+    auto* pAllShaderWidget =
+            dynamic_cast<allshader::WaveformWidget*>(pHolder->m_waveformWidget);
+    if (pAllShaderWidget) {
+        pHolder->m_renderOnThread = m_renderThreadEnabled;
+        pAllShaderWidget->setRenderedOnRenderThread(m_renderThreadEnabled);
+    }
+#endif
+}
+
+void WaveformWidgetFactory::updateRenderBudget(mixxx::Duration renderTime) {
+    const auto syncInterval = m_vsyncThread->getSyncInterval();
+    if (syncInterval.count() <= 0) {
+        return;
+    }
+    // The swap of the previous frame blocks the rendering thread as well
+    const double load = (renderTime + m_lastSwapTime).toDoubleMicros() /
+            static_cast<double>(syncInterval.count());
+    m_renderLoad += kRenderLoadSmoothing * (load - m_renderLoad);
+
+    bool exceeded = m_renderBudgetExceeded;
+    if (!m_adaptiveOverviewFrameRate) {
+        exceeded = false;
+    } else if (m_renderLoad > kRenderLoadExceededThreshold) {
+        exceeded = true;
+    } else if (m_renderLoad < kRenderLoadRecoveredThreshold) {
+        exceeded = false;
+    }
+    if (exceeded != m_renderBudgetExceeded) {
+        m_renderBudgetExceeded = exceeded;
+        emit renderBudgetExceededChanged(exceeded);
+    }
+}
+
+void WaveformWidgetFactory::updateEngineLoad() {
+    if (!m_audioLatencyUsage) {
+        return;
+    }
+    m_engineLoad += kEngineLoadSmoothing * (m_audioLatencyUsage->get() - m_engineLoad);
+
+    bool busy = m_engineBusy;
+    if (!m_adaptiveToEngineLoad) {
+        busy = false;
+    } else if (m_engineLoad > kEngineLoadBusyThreshold) {
+        busy = true;
+    } else if (m_engineLoad < kEngineLoadRecoveredThreshold) {
+        busy = false;
+    }
+    if (busy != m_engineBusy) {
+        qDebug() << "WaveformWidgetFactory - engine busy:" << busy;
+        m_engineBusy = busy;
+        emit engineBusyChanged(busy);
     }
 }
 
@@ -1178,18 +1453,76 @@ int WaveformWidgetFactory::findIndexOf(WWaveformViewer* viewer) const {
 
 void WaveformWidgetFactory::startVSync(
         GuiTick* pGuiTick, VisualsManager* pVisualsManager, bool useQML) {
-    const auto vSyncMode = useQML
+    auto vSyncMode = useQML
             ? VSyncThread::ST_TIMER
             : static_cast<VSyncThread::VSyncMode>(
                       m_config->getValue(ConfigKey("[Waveform]", "VSync"), 0));
 
+#ifdef MIXXX_USE_QOPENGL
+    bool renderThread = !useQML &&
+            m_config->getValue(ConfigKey("[Waveform]", "RenderThread"), false);
+    if (renderThread && !QOpenGLContext::supportsThreadedOpenGL()) {
+        qWarning() << "WaveformWidgetFactory::startVSync - threaded OpenGL "
+                      "is not supported, rendering on the GUI thread";
+        renderThread = false;
+    }
+    if (renderThread && vSyncMode != VSyncThread::ST_FREE) {
+        // The PLL is driven by the buffer swaps on the GUI thread
+        vSyncMode = VSyncThread::ST_TIMER;
+    }
+#endif
+
     m_pGuiTick = pGuiTick;
     m_pVisualsManager = pVisualsManager;
+    m_audioLatencyUsage.emplace(
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("audio_latency_usage")),
+            ControlFlag::AllowMissingOrInvalid);
+    if (!m_audioLatencyUsage->valid()) {
+        m_audioLatencyUsage.reset();
+    }
     m_vsyncThread = new VSyncThread(this, vSyncMode);
     m_vsyncThread->setObjectName(QStringLiteral("VSync"));
     m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / m_frameRate));
 
 #ifdef MIXXX_USE_QOPENGL
+    if (renderThread) {
+        // The windows of all widgets share their resources through the
+        // global share context, see Qt::AA_ShareOpenGLContexts
+        auto* pRenderThreadContext = new QOpenGLContext();
+        pRenderThreadContext->setFormat(getSurfaceFormat(m_config));
+        pRenderThreadContext->setShareContext(QOpenGLContext::globalShareContext());
+        if (pRenderThreadContext->create()) {
+            pRenderThreadContext->moveToThread(m_vsyncThread);
+            SharedGLContext::setRenderThreadContext(pRenderThreadContext);
+            m_renderThreadEnabled = true;
+            qDebug() << "WaveformWidgetFactory::startVSync - rendering "
+                        "waveforms on the VSync thread";
+        } else {
+            qWarning() << "WaveformWidgetFactory::startVSync - failed to "
+                          "create the render thread context";
+            delete pRenderThreadContext;
+        }
+    }
+
+    if (!useQML &&
+            m_config->getValue(ConfigKey("[Waveform]", "SharedGuiContext"), false)) {
+        // Renders all opted in widgets on the GUI thread with one context,
+        // e.g. the spinnies and VU meters. Each of them still has its own
+        // window, but only the surface is switched between them.
+        auto* pGuiThreadContext = new QOpenGLContext();
+        pGuiThreadContext->setFormat(getSurfaceFormat(m_config));
+        pGuiThreadContext->setShareContext(QOpenGLContext::globalShareContext());
+        if (pGuiThreadContext->create()) {
+            SharedGLContext::setGuiThreadContext(pGuiThreadContext);
+            qDebug() << "WaveformWidgetFactory::startVSync - rendering "
+                        "spinnies and VU meters with a shared context";
+        } else {
+            qWarning() << "WaveformWidgetFactory::startVSync - failed to "
+                          "create the shared GUI thread context";
+            delete pGuiThreadContext;
+        }
+    }
+
     if (m_vsyncThread->vsyncMode() == VSyncThread::ST_PLL) {
         WGLWidget* widget = SharedGLContext::getWidget();
         if (widget) {
@@ -1201,6 +1534,21 @@ void WaveformWidgetFactory::startVSync(
             widget->show();
         }
     }
+
+    if (m_renderThreadEnabled) {
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncRender,
+                this,
+                &WaveformWidgetFactory::renderOnThread,
+                Qt::DirectConnection);
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncSwap,
+                this,
+                &WaveformWidgetFactory::swapOnThread,
+                Qt::DirectConnection);
+        m_vsyncThread->start(QThread::NormalPriority);
+        return;
+    }
 #endif
 
     connect(m_vsyncThread,
@@ -1318,6 +1666,7 @@ QSurfaceFormat WaveformWidgetFactory::getSurfaceFormat(UserSettingsPointer confi
 }
 
 void WaveformWidgetFactory::setUntilMarkShowBeats(bool value) {
+    const auto locked = lockRendering();
     m_untilMarkShowBeats = value;
     if (m_config) {
         m_config->set(ConfigKey("[Waveform]", "UntilMarkShowBeats"),
@@ -1327,6 +1676,7 @@ void WaveformWidgetFactory::setUntilMarkShowBeats(bool value) {
 }
 
 void WaveformWidgetFactory::setUntilMarkShowTime(bool value) {
+    const auto locked = lockRendering();
     m_untilMarkShowTime = value;
     if (m_config) {
         m_config->set(ConfigKey("[Waveform]", "UntilMarkShowTime"),
@@ -1336,6 +1686,7 @@ void WaveformWidgetFactory::setUntilMarkShowTime(bool value) {
 }
 
 void WaveformWidgetFactory::setUntilMarkAlign(Qt::Alignment align) {
+    const auto locked = lockRendering();
     m_untilMarkAlign = align;
     if (m_config) {
         m_config->setValue(ConfigKey("[Waveform]", "UntilMarkAlign"),
@@ -1345,6 +1696,7 @@ void WaveformWidgetFactory::setUntilMarkAlign(Qt::Alignment align) {
 }
 
 void WaveformWidgetFactory::setUntilMarkTextPointSize(int value) {
+    const auto locked = lockRendering();
     m_untilMarkTextPointSize = value;
     if (m_config) {
         m_config->setValue(ConfigKey("[Waveform]", "UntilMarkTextPointSize"),
@@ -1354,6 +1706,7 @@ void WaveformWidgetFactory::setUntilMarkTextPointSize(int value) {
 }
 
 void WaveformWidgetFactory::setUntilMarkTextHeightLimit(float value) {
+    const auto locked = lockRendering();
     m_untilMarkTextHeightLimit = value;
     if (m_config) {
         m_config->setValue(ConfigKey("[Waveform]", "UntilMarkTextHeightLimit"),
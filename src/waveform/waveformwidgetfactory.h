@@ -3,8 +3,12 @@
 #include <QObject>
 #include <QSurfaceFormat>
 #include <QVector>
+#include <atomic>
+#include <mutex>
+#include <optional>
 #include <vector>
 
+#include "control/pollingcontrolproxy.h"
 #include "preferences/usersettings.h"
 #include "skin/legacy/skincontext.h"
 #include "util/performancetimer.h"
@@ -98,6 +102,7 @@ class WaveformWidgetHolder {
     WWaveformViewer* m_waveformViewer;
     QDomNode m_skinNodeCache;
     SkinContext m_skinContextCache;
+    bool m_renderOnThread;
 
     friend class WaveformWidgetFactory;
 };
@@ -215,9 +220,47 @@ class WaveformWidgetFactory : public QObject,
     double getPlayMarkerPosition() const { return m_playMarkerPosition; }
 
     void notifyZoomChange(WWaveformViewer *viewer);
+
+    /// True while rendering the waveforms takes most of the sync interval.
+    /// Widgets that are less important than the scrolling waveforms, e.g.
+    /// the overviews, should reduce their repaint rate meanwhile.
+    bool isRenderBudgetExceeded() const {
+        return m_renderBudgetExceeded;
+    }
+
+    /// If enabled, the GUI reduces its load while the audio engine is
+    /// close to missing its deadline, see isEngineBusy().
+    void setAdaptiveToEngineLoad(bool adaptive);
+    bool isAdaptiveToEngineLoad() const {
+        return m_adaptiveToEngineLoad;
+    }
+    /// True while the audio engine uses most of its latency. Meanwhile the
+    /// waveforms are rendered at half the frame rate, the spinnies are not
+    /// rendered, and other widgets should reduce their repaint rate.
+    bool isEngineBusy() const {
+        return m_engineBusy;
+    }
+
+    /// True if the allshader waveform widgets are rendered on a dedicated
+    /// render thread instead of the GUI thread. All other widgets are still
+    /// rendered on the GUI thread.
+    bool isRenderThreadEnabled() const {
+        return m_renderThreadEnabled;
+    }
+    /// With a render thread, code on the GUI thread must hold this lock
+    /// while modifying waveform widgets or their renderers. Only control
+    /// values and the VisualPlayPosition are read by the render thread
+    /// without locking. Doesn't lock anything without a render thread.
+    std::unique_lock<std::recursive_mutex> lockRendering();
+
   signals:
     void waveformUpdateTick();
     void waveformMeasured(float frameRate, int droppedFrames);
+    /// The average render time and the maximum latency of the GUI thread
+    /// during the last second, emitted together with waveformMeasured().
+    void frameTimingsMeasured(double renderMillis, double maxGuiLatencyMillis);
+    void renderBudgetExceededChanged(bool exceeded);
+    void engineBusyChanged(bool busy);
     void renderSpinnies(VSyncThread*);
     void swapSpinnies();
     void renderVuMeters(VSyncThread*);
@@ -250,6 +293,17 @@ class WaveformWidgetFactory : public QObject,
   private:
     void renderSelf();
     void swapSelf();
+    void renderWaveforms(bool onRenderThread);
+    void swapWaveforms(bool onRenderThread);
+#ifdef MIXXX_USE_QOPENGL
+    // Invoked directly on the VSyncThread, which is the render thread
+    void renderOnThread();
+    void swapOnThread();
+#endif
+    void setupRenderThread(WaveformWidgetHolder* pHolder) const;
+    void measureFrame(mixxx::Duration renderTime, mixxx::Duration latency);
+    void updateRenderBudget(mixxx::Duration renderTime);
+    void updateEngineLoad();
 
     void addHandle(
             QHash<WaveformWidgetType::Type, QList<WaveformWidgetBackend>>&
@@ -314,6 +368,31 @@ class WaveformWidgetFactory : public QObject,
     PerformanceTimer m_time;
     float m_frameCnt;
     double m_actualFrameRate;
+    mixxx::Duration m_renderTimeSum;
+    mixxx::Duration m_maxGuiLatency;
+    mixxx::Duration m_lastSwapTime;
+    int m_lastDroppedFrames;
+    // Exponential moving average of the fraction of the sync interval
+    // that is spent for rendering and swapping
+    double m_renderLoad;
+    bool m_adaptiveOverviewFrameRate;
+    std::atomic<bool> m_renderBudgetExceeded;
+    // Missing without a sound device
+    std::optional<PollingControlProxy> m_audioLatencyUsage;
+    // Exponential moving average of [App],audio_latency_usage
+    double m_engineLoad;
+    bool m_adaptiveToEngineLoad;
+    std::atomic<bool> m_engineBusy;
+    // Every other frame of the waveforms is skipped while the engine is
+    // busy. Only accessed by the thread that renders the waveforms.
+    bool m_guiWaveformFrameSkipped;
+    bool m_renderThreadWaveformFrameSkipped;
+
+    bool m_renderThreadEnabled;
+    std::recursive_mutex m_renderMutex;
+    // The GUI thread has not yet processed the previous frame
+    std::atomic<bool> m_guiRenderPending;
+    std::atomic<bool> m_guiSwapPending;
     int m_vSyncType;
     double m_playMarkerPosition;
 };
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "control/controlproxy.h"
+#include "control/controlupdatebus.h"
 #include "moc_controlwidgetconnection.cpp"
 #include "util/assert.h"
 #include "util/parented_ptr.h"
@@ -39,12 +40,39 @@ ControlWidgetConnection::ControlWidgetConnection(
         : QObject(),
           m_pWidget(pBaseWidget),
           m_pControl(make_parented<ControlProxy>(key, this, ControlFlag::NoAssertIfMissing)),
-          m_pValueTransformer(std::move(pTransformer)) {
+          m_pValueTransformer(std::move(pTransformer)),
+          m_updateSubscriptionId(0) {
     m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
 }
 
 ControlWidgetConnection::~ControlWidgetConnection() = default;
 
+void ControlWidgetConnection::setMaxUpdateRate(int maxUpdatesPerSecond) {
+    VERIFY_OR_DEBUG_ASSERT(maxUpdatesPerSecond > 0) {
+        return;
+    }
+    if (m_updateSubscriptionId != 0) {
+        ControlUpdateBus::instance().unsubscribe(m_updateSubscriptionId);
+    } else {
+        m_pControl->disconnect(this);
+    }
+    m_updateSubscriptionId = ControlUpdateBus::instance().subscribe(
+            m_pControl->getKey(),
+            this,
+            [this](double value) {
+                slotControlValueChanged(value);
+            },
+            maxUpdatesPerSecond);
+}
+
+void ControlWidgetConnection::setPolled() {
+    if (m_updateSubscriptionId != 0) {
+        ControlUpdateBus::instance().unsubscribe(m_updateSubscriptionId);
+        m_updateSubscriptionId = 0;
+    }
+    m_pControl->disconnect(this);
+}
+
 void ControlWidgetConnection::setControlParameter(double parameter) {
     if (m_pValueTransformer != nullptr) {
         parameter = m_pValueTransformer->transformInverse(parameter);
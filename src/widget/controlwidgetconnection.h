@@ -26,6 +26,15 @@ class ControlWidgetConnection : public QObject {
         return m_pControl->getKey();
     }
 
+    /// Delivers the changes of the control once per GUI tick and at most
+    /// with the given rate instead of on every change. Intended for
+    /// controls that are changed continuously by the engine.
+    void setMaxUpdateRate(int maxUpdatesPerSecond);
+
+    /// Stops delivering the changes of the control. For widgets that read
+    /// the control once per rendered frame with getControlParameter().
+    void setPolled();
+
     virtual QString toDebugString() const = 0;
 
   protected slots:
@@ -43,6 +52,8 @@ class ControlWidgetConnection : public QObject {
 
   private:
     std::unique_ptr<ValueTransformer> m_pValueTransformer;
+    // 0 if connected to valueChanged() or polled
+    quint64 m_updateSubscriptionId;
 };
 
 class ControlParameterWidgetConnection final : public ControlWidgetConnection {
@@ -33,12 +33,20 @@ void OpenGLWindow::initializeGL() {
 }
 
 void OpenGLWindow::paintGL() {
-    if (m_pWidget && isExposed()) {
+    if (m_pWidget && isExposed() && !m_pWidget->isPaintedWithSharedContext()) {
         m_pWidget->paintGL();
     }
 }
 
 void OpenGLWindow::resizeGL(int w, int h) {
+    if (m_pWidget && m_pWidget->isPaintedWithSharedContext()) {
+        // The context of this window must not be used. The next frame
+        // with the shared context is painted with the new size.
+        m_pWidget->requestResizeGL(
+                static_cast<int>(static_cast<float>(w) * devicePixelRatio()),
+                static_cast<int>(static_cast<float>(h) * devicePixelRatio()));
+        return;
+    }
     if (m_pWidget) {
         // QGLWidget::resizeGL has a valid context (QOpenGLWindow::resizeGL does not), so we
         // mimic the same behaviour
@@ -7,12 +7,20 @@
 #include <QString>
 #include <QSvgRenderer>
 #include <QtDebug>
+#include <algorithm>
 #include <memory>
 
 #include "util/math.h"
 #include "util/painterscope.h"
 #include "widget/wpixmapstore.h"
 
+namespace {
+
+// Enough for the sizes of one image in a skin, on two screens
+constexpr std::size_t kMaxSvgRasters = 8;
+
+} // namespace
+
 // static
 Paintable::DrawMode Paintable::DrawModeFromString(const QString& str) {
     static const QMap<QString, DrawMode> stringMap = {
@@ -232,46 +240,15 @@ void Paintable::drawInternal(const QRectF& targetRect, QPainter* pPainter,
     // qDebug() << "Paintable::drawInternal" << DrawModeToString(m_drawMode)
     //          << targetRect << sourceRect;
     if (m_pSvg) {
+        const qreal devicePixelRatio = pPainter->device()->devicePixelRatio();
         if (m_drawMode == DrawMode::Tile) {
-            if (!m_pPixmap) {
-                // qDebug() << "Paintable cache miss";
-                qreal devicePixelRatio = pPainter->device()->devicePixelRatio();
-                m_pPixmap = std::make_unique<QPixmap>(m_pSvg->defaultSize() * devicePixelRatio);
-                m_pPixmap->setDevicePixelRatio(devicePixelRatio);
-                m_pPixmap->fill(Qt::transparent);
-                { // QPainter Scope
-                    auto pixmapPainter = QPainter(m_pPixmap.get());
-                    m_pSvg->render(&pixmapPainter);
-                }
-                mayCorrectColors();
-            }
             // The SVG renderer doesn't directly support tiling, so we render
             // it to a pixmap which will then get tiled.
-            pPainter->drawTiledPixmap(targetRect, *m_pPixmap);
+            pPainter->drawTiledPixmap(targetRect,
+                    svgRaster(m_pSvg->defaultSize(), QRectF(), devicePixelRatio));
         } else {
-            if (!m_pPixmap ||
-                    m_pPixmap->size() != targetRect.size().toSize() ||
-                    m_lastSourceRect != sourceRect) {
-                // qDebug() << "Paintable cache miss";
-                qreal devicePixelRatio = pPainter->device()->devicePixelRatio();
-                m_pPixmap = std::make_unique<QPixmap>(
-                        targetRect.size().toSize() * devicePixelRatio);
-                m_pPixmap->setDevicePixelRatio(devicePixelRatio);
-                m_pPixmap->fill(Qt::transparent);
-                { // QPainter Scope
-                    auto pixmapPainter = QPainter(m_pPixmap.get());
-                    QRectF deviceSourceRect = QRectF(
-                            sourceRect.x() * devicePixelRatio,
-                            sourceRect.y() * devicePixelRatio,
-                            sourceRect.width() * devicePixelRatio,
-                            sourceRect.height() * devicePixelRatio);
-                    m_pSvg->setViewBox(deviceSourceRect);
-                    m_pSvg->render(&pixmapPainter);
-                }
-                mayCorrectColors();
-                m_lastSourceRect = sourceRect;
-            }
-            pPainter->drawPixmap(targetRect.topLeft(), *m_pPixmap);
+            pPainter->drawPixmap(targetRect.topLeft(),
+                    svgRaster(targetRect.size().toSize(), sourceRect, devicePixelRatio));
         }
         return;
     }
@@ -295,11 +272,52 @@ void Paintable::drawInternal(const QRectF& targetRect, QPainter* pPainter,
     }
 }
 
+const QPixmap& Paintable::svgRaster(const QSize& size,
+        const QRectF& sourceRect,
+        qreal devicePixelRatio) {
+    const auto it = std::find_if(m_svgRasters.begin(),
+            m_svgRasters.end(),
+            [&](const SvgRaster& raster) {
+                return raster.size == size &&
+                        raster.sourceRect == sourceRect &&
+                        raster.devicePixelRatio == devicePixelRatio;
+            });
+    if (it != m_svgRasters.end()) {
+        std::rotate(m_svgRasters.begin(), it, it + 1);
+        return m_svgRasters.front().pixmap;
+    }
+
+    // qDebug() << "Paintable cache miss";
+    QPixmap pixmap(size * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    { // QPainter Scope
+        auto pixmapPainter = QPainter(&pixmap);
+        if (!sourceRect.isNull()) {
+            QRectF deviceSourceRect = QRectF(
+                    sourceRect.x() * devicePixelRatio,
+                    sourceRect.y() * devicePixelRatio,
+                    sourceRect.width() * devicePixelRatio,
+                    sourceRect.height() * devicePixelRatio);
+            m_pSvg->setViewBox(deviceSourceRect);
+        }
+        m_pSvg->render(&pixmapPainter);
+    }
+    mayCorrectColors(&pixmap);
 
-void Paintable::mayCorrectColors() {
+    if (m_svgRasters.size() >= kMaxSvgRasters) {
+        m_svgRasters.pop_back();
+    }
+    m_svgRasters.insert(m_svgRasters.begin(),
+            SvgRaster{size, sourceRect, devicePixelRatio, std::move(pixmap)});
+    return m_svgRasters.front().pixmap;
+}
+
+// static
+void Paintable::mayCorrectColors(QPixmap* pPixmap) {
     if (WPixmapStore::willCorrectColors()) {
-        QImage image = m_pPixmap->toImage();
+        QImage image = pPixmap->toImage();
         WPixmapStore::correctImageColors(&image);
-        m_pPixmap->convertFromImage(image);
+        pPixmap->convertFromImage(image);
     }
 }
@@ -1,16 +1,17 @@
 #pragma once
 
 #include <QImage>
+#include <QPixmap>
 #include <QRectF>
 #include <QScopedPointer>
 #include <QString>
 #include <memory>
+#include <vector>
 
 #include "skin/legacy/imgsource.h"
 #include "skin/legacy/pixmapsource.h"
 
 class QPainter;
-class QPixmap;
 class QSvgRenderer;
 
 // Wrapper around QImage and QSvgRenderer to support rendering SVG images in
@@ -52,10 +53,26 @@ class Paintable {
   private:
     void drawInternal(const QRectF& targetRect, QPainter* pPainter,
                       const QRectF& sourceRect);
-    void mayCorrectColors();
+    // Returns the SVG rasterized with the given logical size, which is
+    // rendered on a cache miss. A null sourceRect renders the whole image.
+    const QPixmap& svgRaster(const QSize& size,
+            const QRectF& sourceRect,
+            qreal devicePixelRatio);
+    static void mayCorrectColors(QPixmap* pPixmap);
+
+    struct SvgRaster {
+        QSize size;
+        QRectF sourceRect;
+        qreal devicePixelRatio;
+        QPixmap pixmap;
+    };
 
     std::unique_ptr<QPixmap> m_pPixmap;
     std::unique_ptr<QSvgRenderer> m_pSvg;
     DrawMode m_drawMode;
-    QRectF m_lastSourceRect;
+    // A Paintable is shared by all widgets that use the same image, e.g.
+    // knobs of different sizes or on screens with different scale factors.
+    // Keeping a few rasters avoids that they re-rasterize the SVG in turn.
+    // The most recently used raster is in front.
+    std::vector<SvgRaster> m_svgRasters;
 };
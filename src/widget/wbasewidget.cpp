@@ -76,6 +76,12 @@ double WBaseWidget::getControlParameterDisplay() const {
     return 0.0;
 }
 
+void WBaseWidget::pollDisplayConnection() {
+    if (m_pDisplayConnection) {
+        m_pDisplayConnection->setPolled();
+    }
+}
+
 void WBaseWidget::resetControlParameter() {
     for (const auto& pControlConnection : std::as_const(m_connections)) {
         pControlConnection->resetControl();
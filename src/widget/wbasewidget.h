@@ -63,6 +63,9 @@ class WBaseWidget {
     double getControlParameterRight() const;
     double getControlParameterDisplay() const;
 
+    // The display control is no longer delivered to onConnectedControlChanged,
+    // the widget polls getControlParameterDisplay() instead
+    void pollDisplayConnection();
 
   protected:
     // Whenever a connected control is changed, onConnectedControlChanged is
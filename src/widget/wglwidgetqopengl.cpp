@@ -1,5 +1,9 @@
+#include <QOpenGLContext>
 #include <QResizeEvent>
+#include <QThread>
+#include <utility>
 
+#include "waveform/sharedglcontext.h"
 #include "widget/openglwindow.h"
 #include "widget/tooltipqopengl.h"
 #include "widget/wglwidget.h"
@@ -8,7 +12,9 @@ WGLWidget::WGLWidget(QWidget* pParent)
         : QWidget(pParent),
           m_pOpenGLWindow(nullptr),
           m_pContainerWidget(nullptr),
-          m_pTrackDropTarget(nullptr) {
+          m_pTrackDropTarget(nullptr),
+          m_renderedOnRenderThread(false),
+          m_renderedWithGuiThreadContext(false) {
     // When the widget is resized or moved, the QOpenGLWindow visibly resizes
     // or moves before the widgets do. This can be solved by calling
     //   setAttribute(Qt::WA_PaintOnScreen);
@@ -18,6 +24,12 @@ WGLWidget::WGLWidget(QWidget* pParent)
 
 WGLWidget::~WGLWidget() {
     ToolTipQOpenGL::singleton().stop();
+    QOpenGLContext* pSharedContext = sharedContext();
+    if (pSharedContext && pSharedContext->surface() == m_pOpenGLWindow) {
+        // Shared contexts stay current after doneCurrent(), they must not
+        // outlive the surface
+        pSharedContext->doneCurrent();
+    }
     if (m_pOpenGLWindow) {
         m_pOpenGLWindow->widgetDestroyed();
     }
@@ -59,15 +71,34 @@ bool WGLWidget::isContextValid() const {
 }
 
 void WGLWidget::makeCurrentIfNeeded() {
-    if (m_pOpenGLWindow && m_pOpenGLWindow->context() != QOpenGLContext::currentContext()) {
+    if (!m_pOpenGLWindow) {
+        return;
+    }
+    QOpenGLContext* pSharedContext = sharedContext();
+    if (pSharedContext) {
+        // The context is shared by all windows that are rendered on this
+        // thread, only the surface needs to be switched
+        if (pSharedContext != QOpenGLContext::currentContext() ||
+                pSharedContext->surface() != m_pOpenGLWindow) {
+            pSharedContext->makeCurrent(m_pOpenGLWindow);
+        }
+        return;
+    }
+    if (m_pOpenGLWindow->context() != QOpenGLContext::currentContext()) {
         m_pOpenGLWindow->makeCurrent();
     }
 }
 
 void WGLWidget::doneCurrent() {
-    if (m_pOpenGLWindow) {
-        m_pOpenGLWindow->doneCurrent();
+    if (!m_pOpenGLWindow) {
+        return;
     }
+    if (sharedContext()) {
+        // Stays current for the next widget, which avoids a full context
+        // switch per widget. Released by SharedGLContext::doneCurrent().
+        return;
+    }
+    m_pOpenGLWindow->doneCurrent();
 }
 
 void WGLWidget::paintGL() {
@@ -86,10 +117,58 @@ void WGLWidget::resizeGL(int w, int h) {
 
 void WGLWidget::swapBuffers() {
     if (shouldRender()) {
+        QOpenGLContext* pSharedContext = sharedContext();
+        if (pSharedContext) {
+            pSharedContext->swapBuffers(m_pOpenGLWindow);
+            return;
+        }
         m_pOpenGLWindow->context()->swapBuffers(m_pOpenGLWindow->context()->surface());
     }
 }
 
+void WGLWidget::setRenderedOnRenderThread(bool renderedOnRenderThread) {
+    m_renderedOnRenderThread.store(renderedOnRenderThread, std::memory_order_release);
+}
+
+void WGLWidget::setRenderedWithGuiThreadContext(bool renderedWithGuiThreadContext) {
+    m_renderedWithGuiThreadContext = renderedWithGuiThreadContext;
+}
+
+bool WGLWidget::isPaintedWithSharedContext() const {
+    return isRenderedOnRenderThread() ||
+            (m_renderedWithGuiThreadContext && SharedGLContext::getGuiThreadContext());
+}
+
+QOpenGLContext* WGLWidget::sharedContext() const {
+    QOpenGLContext* pRenderContext = SharedGLContext::getRenderThreadContext();
+    if (pRenderContext && pRenderContext->thread() == QThread::currentThread()) {
+        return pRenderContext;
+    }
+    QOpenGLContext* pGuiContext = SharedGLContext::getGuiThreadContext();
+    if (m_renderedWithGuiThreadContext && pGuiContext &&
+            pGuiContext->thread() == QThread::currentThread()) {
+        return pGuiContext;
+    }
+    return nullptr;
+}
+
+void WGLWidget::requestResizeGL(int w, int h) {
+    const std::lock_guard<std::mutex> locked(m_requestedSizeMutex);
+    m_requestedSize = QSize(w, h);
+}
+
+void WGLWidget::resizeGLIfRequested() {
+    QSize requestedSize;
+    {
+        const std::lock_guard<std::mutex> locked(m_requestedSizeMutex);
+        std::swap(requestedSize, m_requestedSize);
+    }
+    if (requestedSize.isValid()) {
+        makeCurrentIfNeeded();
+        resizeGL(requestedSize.width(), requestedSize.height());
+    }
+}
+
 bool WGLWidget::shouldRender() const {
     return m_pOpenGLWindow && m_pOpenGLWindow->isExposed();
 }
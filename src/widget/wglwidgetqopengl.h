@@ -4,13 +4,17 @@
 #error "Do not include this file, include wglwidget.h instead"
 #endif
 
+#include <QSize>
 #include <QWidget>
+#include <atomic>
+#include <mutex>
 
 ////////////////////////////////
 // QOpenGLWindow based WGLWidget
 ////////////////////////////////
 
 class QPaintDevice;
+class QOpenGLContext;
 class QOpenGLWindow;
 class OpenGLWindow;
 class TrackDropTarget;
@@ -40,6 +44,28 @@ class WGLWidget : public QWidget {
 
     QOpenGLWindow* getOpenGLWindow() const;
 
+    // Widgets that are rendered on the render thread of the
+    // WaveformWidgetFactory use the render thread context instead of the
+    // context of their window, when invoked from that thread. They are
+    // no longer painted or resized by the window on the GUI thread.
+    void setRenderedOnRenderThread(bool renderedOnRenderThread);
+    bool isRenderedOnRenderThread() const {
+        return m_renderedOnRenderThread.load(std::memory_order_acquire);
+    }
+    // Widgets that are rendered with the GUI thread context of
+    // SharedGLContext, if it exists, share it with all other opted in
+    // widgets instead of the context of their window. Like widgets on the
+    // render thread, they are no longer painted or resized by the window
+    // and must call resizeGLIfRequested() before painting.
+    void setRenderedWithGuiThreadContext(bool renderedWithGuiThreadContext);
+    // True if the widget is painted with one of the contexts of
+    // SharedGLContext instead of the context of its window
+    bool isPaintedWithSharedContext() const;
+    // called by OpenGLWindow instead of resizeGL
+    void requestResizeGL(int w, int h);
+    // Invokes resizeGL with the shared context if the window has been resized
+    void resizeGLIfRequested();
+
   protected:
     void showEvent(QShowEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
@@ -47,7 +73,18 @@ class WGLWidget : public QWidget {
     QPaintDevice* paintDevice();
 
   private:
+    // Returns the shared context that is used by this widget on the
+    // calling thread, if any
+    QOpenGLContext* sharedContext() const;
+
     OpenGLWindow* m_pOpenGLWindow;
     QWidget* m_pContainerWidget;
     TrackDropTarget* m_pTrackDropTarget;
+
+    std::atomic<bool> m_renderedOnRenderThread;
+    // Only accessed on the GUI thread
+    bool m_renderedWithGuiThreadContext;
+    std::mutex m_requestedSizeMutex;
+    // Invalid if no resize is pending
+    QSize m_requestedSize;
 };
@@ -1,5 +1,6 @@
 #include "widget/wlibrarytableview.h"
 
+#include <QAccessible>
 #include <QApplication>
 #include <QFocusEvent>
 #include <QFontMetrics>
@@ -378,5 +379,59 @@ void WLibraryTableView::dataChanged(
             }
         }
     }
-    QAbstractItemView::dataChanged(topLeft, bottomRight, roles);
-};
+    if (topLeft == bottomRight || !topLeft.isValid() || !bottomRight.isValid() ||
+            state() == QAbstractItemView::EditingState) {
+        QAbstractItemView::dataChanged(topLeft, bottomRight, roles);
+        return;
+    }
+    // QAbstractItemView repaints the whole viewport for a range of indexes,
+    // e.g. for the changed play state of a track or the cover art column.
+    // Only the visible cells of the range are repainted instead.
+#if QT_CONFIG(accessibility)
+    if (QAccessible::isActive()) {
+        QAccessibleTableModelChangeEvent accessibleEvent(
+                this, QAccessibleTableModelChangeEvent::DataChanged);
+        accessibleEvent.setFirstRow(topLeft.row());
+        accessibleEvent.setFirstColumn(topLeft.column());
+        accessibleEvent.setLastRow(bottomRight.row());
+        accessibleEvent.setLastColumn(bottomRight.column());
+        QAccessible::updateAccessibility(&accessibleEvent);
+    }
+#endif
+    if (!isVisible()) {
+        return;
+    }
+    const int firstVisibleRow = rowAt(0);
+    if (firstVisibleRow < 0) {
+        return;
+    }
+    int lastVisibleRow = rowAt(viewport()->height() - 1);
+    if (lastVisibleRow < 0) {
+        // The rows end within the viewport
+        lastVisibleRow = model()->rowCount() - 1;
+    }
+    const int firstRow = math_max(topLeft.row(), firstVisibleRow);
+    const int lastRow = math_min(bottomRight.row(), lastVisibleRow);
+    if (firstRow > lastRow) {
+        return;
+    }
+    // The persistent editors, e.g. of the star rating, need the new data
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = topLeft.column(); column <= bottomRight.column(); ++column) {
+            const QModelIndex index = model()->index(row, column);
+            if (isPersistentEditorOpen(index)) {
+                QAbstractItemView::dataChanged(index, index, roles);
+            }
+        }
+    }
+    const int top = rowViewportPosition(firstRow);
+    QRect updateRect(0,
+            top,
+            viewport()->width(),
+            rowViewportPosition(lastRow) + rowHeight(lastRow) - top);
+    if (topLeft.column() == bottomRight.column()) {
+        updateRect.setLeft(columnViewportPosition(topLeft.column()));
+        updateRect.setWidth(columnWidth(topLeft.column()));
+    }
+    viewport()->update(updateRect);
+}
@@ -3,6 +3,7 @@
 #include <QMouseEvent>
 
 #include "control/controlproxy.h"
+#include "control/controlupdatebus.h"
 #include "moc_wnumberpos.cpp"
 #include "util/duration.h"
 
@@ -10,12 +11,21 @@ WNumberPos::WNumberPos(const QString& group, QWidget* parent)
         : WNumber(parent),
           m_displayFormat(TrackTime::DisplayFormat::TRADITIONAL),
           m_dOldTimeElapsed(0.0) {
+    // Both are updated by the engine in every audio callback, the text is
+    // only updated once per GUI tick
     m_pTimeElapsed = new ControlProxy(group, "time_elapsed", this, ControlFlag::NoAssertIfMissing);
-    m_pTimeElapsed->connectValueChanged(this, &WNumberPos::slotSetTimeElapsed);
+    ControlUpdateBus::instance().subscribe(m_pTimeElapsed->getKey(),
+            this,
+            [this](double value) {
+                slotSetTimeElapsed(value);
+            });
     m_pTimeRemaining = new ControlProxy(
             group, "time_remaining", this, ControlFlag::NoAssertIfMissing);
-    m_pTimeRemaining->connectValueChanged(
-            this, &WNumberPos::slotTimeRemainingUpdated);
+    ControlUpdateBus::instance().subscribe(m_pTimeRemaining->getKey(),
+            this,
+            [this](double value) {
+                slotTimeRemainingUpdated(value);
+            });
 
     m_pShowTrackTimeRemaining = new ControlProxy(
             "[Controls]", "ShowDurationRemaining", this);
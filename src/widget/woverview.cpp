@@ -7,6 +7,8 @@
 #include <QPainter>
 #include <QPen>
 #include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
 
 #include "analyzer/analyzerprogress.h"
 #include "control/controlproxy.h"
@@ -30,6 +32,9 @@ namespace {
 // Horizontal and vertical margin around the widget where we accept play pos dragging.
 constexpr int kDragOutsideLimitX = 100;
 constexpr int kDragOutsideLimitY = 50;
+
+// About 10 fps while the waveforms exceed their render budget
+constexpr int kThrottledUpdateIntervalMillis = 100;
 } // anonymous namespace
 
 WOverview::WOverview(
@@ -43,6 +48,7 @@ WOverview::WOverview(
           m_type(Type::RGB),
           m_actualCompletion(0),
           m_pixmapDone(false),
+          m_previewDrawn(false),
           m_waveformPeak(-1.0),
           m_diffGain(0),
           m_devicePixelRatio(1.0),
@@ -64,6 +70,8 @@ WOverview::WOverview(
           m_trackLoaded(false),
           m_pHoveredMark(nullptr),
           m_scaleFactor(1.0),
+          m_bWaveformLayerDirty(true),
+          m_bMarksLayerDirty(true),
           m_trackSampleRateControl(
                   m_group,
                   QStringLiteral("track_samplerate")),
@@ -111,6 +119,24 @@ WOverview::WOverview(
             &WaveformWidgetFactory::visualGainChanged,
             this,
             &WOverview::slotNormalizeOrVisualGainChanged);
+    // Reduce the repaint rate while the scrolling waveforms need the time
+    m_throttledUpdateTimer.setSingleShot(true);
+    connect(&m_throttledUpdateTimer,
+            &QTimer::timeout,
+            this,
+            &WOverview::slotUpdatePlayPosition);
+    connect(pWidgetFactory,
+            &WaveformWidgetFactory::renderBudgetExceededChanged,
+            this,
+            &WOverview::slotRenderBudgetExceededChanged);
+    // ...and while the audio engine needs the CPU
+    connect(pWidgetFactory,
+            &WaveformWidgetFactory::engineBusyChanged,
+            this,
+            &WOverview::slotEngineBusyChanged);
+    m_bRenderBudgetExceeded = pWidgetFactory->isRenderBudgetExceeded();
+    m_bEngineBusy = pWidgetFactory->isEngineBusy();
+    m_bThrottleRepaints = m_bRenderBudgetExceeded || m_bEngineBusy;
     // Also listen to ReplayGain changes to scale the waveform
     m_pReplayGain = make_parented<ControlProxy>(m_group, "replaygain", this);
     m_pReplayGain->connectValueChanged(this, &WOverview::slotNormalizeOrVisualGainChanged);
@@ -277,12 +303,9 @@ void WOverview::onConnectedControlChanged(double dParameter, double dValue) {
     // all we represent with this widget.
     dParameter = math_clamp(dParameter, 0.0, 1.0);
 
-    bool redraw = false;
-    int oldPos = m_iPlayPos;
+    const int oldPlayPos = m_iPlayPos;
+    const int oldPickupPos = m_iPickupPos;
     m_iPlayPos = valueToPosition(dParameter);
-    if (oldPos != m_iPlayPos) {
-        redraw = true;
-    }
 
     if (!m_bLeftClickDragging) {
         // if not dragged the pick-up moves with the play position
@@ -296,14 +319,79 @@ void WOverview::onConnectedControlChanged(double dParameter, double dValue) {
     int oldPositionSeconds = m_iPosSeconds;
     m_iPosSeconds = static_cast<int>(dParameter * getTrackSamples());
     if ((m_bTimeRulerActive || m_pHoveredMark != nullptr) && oldPositionSeconds != m_iPosSeconds) {
-        redraw = true;
+        // The time labels might be anywhere
+        updatePlayPosition(rect());
+    } else if (oldPlayPos != m_iPlayPos) {
+        // Only the strip between the old and the new position changes
+        updatePlayPosition(playPositionRect(oldPlayPos, m_iPlayPos) |
+                playPositionRect(oldPickupPos, m_iPickupPos));
     }
+}
 
-    if (redraw) {
-        update();
+QRect WOverview::playPositionRect(int fromPos, int toPos) const {
+    // Include the outlines and triangles of the pickup position
+    const int margin = static_cast<int>(std::ceil(m_scaleFactor)) + 3;
+    const int start = std::min(fromPos, toPos) - margin;
+    const int stop = std::max(fromPos, toPos) + margin;
+    if (m_orientation == Qt::Horizontal) {
+        return QRect(start, 0, stop - start + 1, height());
+    } else {
+        return QRect(0, start, width(), stop - start + 1);
+    }
+}
+
+void WOverview::updatePlayPosition(const QRect& dirtyRect) {
+    m_dirtyPlayPositionRect |= dirtyRect;
+    if (!m_bThrottleRepaints || !m_lastPaintTimer.running()) {
+        slotUpdatePlayPosition();
+        return;
+    }
+    if (m_throttledUpdateTimer.isActive()) {
+        return;
+    }
+    const int sinceLastPaintMillis =
+            static_cast<int>(m_lastPaintTimer.elapsed().toIntegerMillis());
+    if (sinceLastPaintMillis >= kThrottledUpdateIntervalMillis) {
+        slotUpdatePlayPosition();
+    } else {
+        m_throttledUpdateTimer.start(
+                kThrottledUpdateIntervalMillis - sinceLastPaintMillis);
+    }
+}
+
+void WOverview::slotUpdatePlayPosition() {
+    update(m_dirtyPlayPositionRect);
+    m_dirtyPlayPositionRect = QRect();
+}
+
+void WOverview::slotRenderBudgetExceededChanged(bool exceeded) {
+    m_bRenderBudgetExceeded = exceeded;
+    updateThrottleRepaints();
+}
+
+void WOverview::slotEngineBusyChanged(bool busy) {
+    m_bEngineBusy = busy;
+    updateThrottleRepaints();
+}
+
+void WOverview::updateThrottleRepaints() {
+    m_bThrottleRepaints = m_bRenderBudgetExceeded || m_bEngineBusy;
+    if (!m_bThrottleRepaints && m_throttledUpdateTimer.isActive()) {
+        m_throttledUpdateTimer.stop();
+        slotUpdatePlayPosition();
     }
 }
 
+void WOverview::invalidateWaveformLayer() {
+    m_bWaveformLayerDirty = true;
+    update();
+}
+
+void WOverview::invalidateMarksLayer() {
+    m_bMarksLayerDirty = true;
+    update();
+}
+
 void WOverview::slotWaveformSummaryUpdated() {
     //qDebug() << "WOverview::slotWaveformSummaryUpdated()";
 
@@ -317,7 +405,12 @@ void WOverview::slotWaveformSummaryUpdated() {
         if (m_pWaveform->getCompletion() == m_pWaveform->getDataSize()) {
             m_actualCompletion = 0;
             if (drawNextPixmapPart()) {
-                update();
+                invalidateWaveformLayer();
+            }
+        } else if (m_pWaveform->hasPreview() && !m_previewDrawn) {
+            // Drawn before the analysis has progressed any further
+            if (drawNextPixmapPart()) {
+                invalidateWaveformLayer();
             }
         }
     } else {
@@ -327,8 +420,9 @@ void WOverview::slotWaveformSummaryUpdated() {
         m_actualCompletion = 0;
         m_waveformPeak = -1.0;
         m_pixmapDone = false;
+        m_previewDrawn = false;
 
-        update();
+        invalidateWaveformLayer();
     }
 }
 
@@ -337,10 +431,12 @@ void WOverview::onTrackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyz
         return;
     }
 
-    bool updateNeeded = drawNextPixmapPart();
-    if (updateNeeded || (m_analyzerProgress != analyzerProgress)) {
+    if (drawNextPixmapPart()) {
+        invalidateWaveformLayer();
+    }
+    if (m_analyzerProgress != analyzerProgress) {
         m_analyzerProgress = analyzerProgress;
-        update();
+        invalidateMarksLayer();
     }
 }
 
@@ -352,7 +448,8 @@ void WOverview::slotTrackLoaded(TrackPointer pTrack) {
     if (m_pCurrentTrack) {
         updateCues(m_pCurrentTrack->getCuePoints());
     }
-    update();
+    // The marks are positioned relative to the track samples
+    invalidateMarksLayer();
 }
 
 void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack) {
@@ -375,6 +472,7 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
     m_actualCompletion = 0;
     m_waveformPeak = -1.0;
     m_pixmapDone = false;
+    m_previewDrawn = false;
     // Note: Here we already have the new track, but the engine and it's
     // Control Objects may still have the old one until the slotTrackLoaded()
     // signal has been received.
@@ -395,13 +493,15 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
         m_pCurrentTrack.reset();
         m_pWaveform.clear();
     }
-    update();
+    m_bWaveformLayerDirty = true;
+    invalidateMarksLayer();
 }
 
 void WOverview::onEndOfTrackChange(double v) {
     //qDebug() << "WOverview::onEndOfTrackChange()" << v;
     m_endOfTrack = v > 0.0;
-    update();
+    m_bWaveformLayerDirty = true;
+    invalidateMarksLayer();
 }
 
 void WOverview::onMarkChanged(double v) {
@@ -409,19 +509,20 @@ void WOverview::onMarkChanged(double v) {
     //qDebug() << "WOverview::onMarkChanged()" << v;
     if (m_pCurrentTrack) {
         updateCues(m_pCurrentTrack->getCuePoints());
-        update();
+        invalidateMarksLayer();
     }
 }
 
 void WOverview::onMarkRangeChange(double v) {
     Q_UNUSED(v);
     //qDebug() << "WOverview::onMarkRangeChange()" << v;
-    update();
+    invalidateMarksLayer();
 }
 
 void WOverview::onRateRatioChange(double v) {
     Q_UNUSED(v);
-    update();
+    // The minute markers and durations depend on the rate
+    invalidateMarksLayer();
 }
 
 void WOverview::onPassthroughChange(double v) {
@@ -454,11 +555,11 @@ void WOverview::slotTypeControlChanged(double v) {
 }
 
 void WOverview::slotMinuteMarkersChanged(bool /*unused*/) {
-    update();
+    invalidateMarksLayer();
 }
 
 void WOverview::slotNormalizeOrVisualGainChanged() {
-    update();
+    invalidateWaveformLayer();
 }
 
 void WOverview::updateCues(const QList<CuePointer> &loadedCues) {
@@ -537,7 +638,13 @@ void WOverview::mouseMoveEvent(QMouseEvent* e) {
         return;
     }
 
-    m_pHoveredMark = m_marks.findHoveredMark(e->pos(), m_orientation);
+    const WaveformMarkPointer pHoveredMark =
+            m_marks.findHoveredMark(e->pos(), m_orientation);
+    if (m_pHoveredMark != pHoveredMark) {
+        // The labels of the hovered mark are not elided
+        m_pHoveredMark = pHoveredMark;
+        m_bMarksLayerDirty = true;
+    }
 
     // qDebug() << "WOverview::mouseMoveEvent" << e->pos();
     update();
@@ -653,13 +760,14 @@ void WOverview::mousePressEvent(QMouseEvent* e) {
 
 void WOverview::slotCueMenuPopupAboutToHide() {
     m_pHoveredMark.clear();
-    update();
+    invalidateMarksLayer();
 }
 
 void WOverview::leaveEvent(QEvent* pEvent) {
     Q_UNUSED(pEvent);
-    if (!m_pCueMenuPopup->isVisible()) {
+    if (!m_pCueMenuPopup->isVisible() && m_pHoveredMark) {
         m_pHoveredMark.clear();
+        m_bMarksLayerDirty = true;
     }
     m_bLeftClickDragging = false;
     m_bTimeRulerActive = false;
@@ -669,25 +777,32 @@ void WOverview::leaveEvent(QEvent* pEvent) {
 void WOverview::paintEvent(QPaintEvent* pEvent) {
     Q_UNUSED(pEvent);
     ScopedTimer t(QStringLiteral("WOverview::paintEvent"));
+    m_lastPaintTimer.start();
+
+    const qreal devicePixelRatio = devicePixelRatioF();
+    if (m_bWaveformLayerDirty ||
+            m_waveformLayer.devicePixelRatio() != devicePixelRatio) {
+        renderWaveformLayer();
+    }
+    // The time distance of the hovered mark changes with the play position
+    if (m_bMarksLayerDirty || m_pHoveredMark ||
+            m_marksLayer.devicePixelRatio() != devicePixelRatio) {
+        renderMarksLayer();
+    }
 
+    // The painter is clipped to the updated region, e.g. to the strip of
+    // the play position
     QPainter painter(this);
-    painter.fillRect(rect(), m_backgroundColor);
+    painter.drawPixmap(0, 0, m_waveformLayer);
 
-    if (!m_backgroundPixmap.isNull()) {
-        painter.drawPixmap(rect(), m_backgroundPixmap);
+    if (m_pCurrentTrack) {
+        drawPlayedOverlay(&painter);
     }
 
+    painter.drawPixmap(0, 0, m_marksLayer);
+
     if (m_pCurrentTrack) {
-        // Refer to util/ScopePainter.h to understand the semantics of
-        // ScopePainter.
-        drawEndOfTrackBackground(&painter);
-        drawAxis(&painter);
-        drawWaveformPixmap(&painter);
-        drawPlayedOverlay(&painter);
-        drawMinuteMarkers(&painter);
         drawPlayPosition(&painter);
-        drawEndOfTrackFrame(&painter);
-        drawAnalyzerProgress(&painter);
 
         double trackSamples = getTrackSamples();
         if (trackSamples > 0) {
@@ -695,8 +810,6 @@ void WOverview::paintEvent(QPaintEvent* pEvent) {
             const auto gain = static_cast<CSAMPLE_GAIN>(length() - 2) /
                     static_cast<CSAMPLE_GAIN>(trackSamples);
 
-            drawRangeMarks(&painter, offset, gain);
-            drawMarks(&painter, offset, gain);
             drawPickupPosition(&painter);
             drawTimeRuler(&painter);
             drawMarkLabels(&painter, offset, gain);
@@ -712,6 +825,58 @@ void WOverview::paintEvent(QPaintEvent* pEvent) {
     }
 }
 
+void WOverview::renderWaveformLayer() {
+    const qreal devicePixelRatio = devicePixelRatioF();
+    m_waveformLayer = QPixmap(size() * devicePixelRatio);
+    m_waveformLayer.setDevicePixelRatio(devicePixelRatio);
+    m_waveformLayer.fill(Qt::transparent);
+    m_bWaveformLayerDirty = false;
+
+    QPainter painter(&m_waveformLayer);
+    painter.fillRect(rect(), m_backgroundColor);
+
+    if (!m_backgroundPixmap.isNull()) {
+        painter.drawPixmap(rect(), m_backgroundPixmap);
+    }
+
+    if (m_pCurrentTrack) {
+        // Refer to util/ScopePainter.h to understand the semantics of
+        // ScopePainter.
+        drawEndOfTrackBackground(&painter);
+        drawAxis(&painter);
+        drawWaveformPixmap(&painter);
+    }
+}
+
+void WOverview::renderMarksLayer() {
+    const qreal devicePixelRatio = devicePixelRatioF();
+    m_marksLayer = QPixmap(size() * devicePixelRatio);
+    m_marksLayer.setDevicePixelRatio(devicePixelRatio);
+    m_marksLayer.fill(Qt::transparent);
+    m_bMarksLayerDirty = false;
+
+    if (!m_pCurrentTrack) {
+        return;
+    }
+
+    QPainter painter(&m_marksLayer);
+    // The labels are measured with the font of the widget
+    painter.setFont(font());
+    drawMinuteMarkers(&painter);
+    drawEndOfTrackFrame(&painter);
+    drawAnalyzerProgress(&painter);
+
+    double trackSamples = getTrackSamples();
+    if (trackSamples > 0) {
+        const float offset = 1.0f;
+        const auto gain = static_cast<CSAMPLE_GAIN>(length() - 2) /
+                static_cast<CSAMPLE_GAIN>(trackSamples);
+
+        drawRangeMarks(&painter, offset, gain);
+        drawMarks(&painter, offset, gain);
+    }
+}
+
 void WOverview::drawEndOfTrackBackground(QPainter* pPainter) {
     if (m_endOfTrack) {
         PainterScope painterScope(pPainter);
@@ -1381,13 +1546,14 @@ bool WOverview::drawNextPixmapPart() {
     }
     DEBUG_ASSERT(!m_waveformSourceImage.isNull());
 
-    // Always multiple of 2
-    const int waveformCompletion = pWaveform->getCompletion();
+    // Always multiple of 2, but -1 before the analysis has stored any data
+    const int waveformCompletion = math_max(0, pWaveform->getCompletion());
     // Test if there is some new to draw (at least of pixel width)
     const int completionIncrement = waveformCompletion - m_actualCompletion;
 
     int visiblePixelIncrement = completionIncrement * length() / dataSize;
-    if (waveformCompletion < (dataSize - 2) &&
+    const bool drawPreview = pWaveform->hasPreview() && !m_previewDrawn;
+    if (!drawPreview && waveformCompletion < (dataSize - 2) &&
             (completionIncrement < 2 || visiblePixelIncrement == 0)) {
         return false;
     }
@@ -1403,12 +1569,34 @@ bool WOverview::drawNextPixmapPart() {
     QPainter painter(&m_waveformSourceImage);
     painter.translate(0.0, static_cast<double>(m_waveformSourceImage.height()) / 2.0);
 
-    if (m_type == Type::Filtered) {
-        drawNextPixmapPartLMH(&painter, pWaveform, nextCompletion);
-    } else if (m_type == Type::HSV) {
-        drawNextPixmapPartHSV(&painter, pWaveform, nextCompletion);
-    } else { // Type::RGB:
-        drawNextPixmapPartRGB(&painter, pWaveform, nextCompletion);
+    const auto drawPart = [&](int nextCompletion) {
+        if (m_type == Type::Filtered) {
+            drawNextPixmapPartLMH(&painter, pWaveform, nextCompletion);
+        } else if (m_type == Type::HSV) {
+            drawNextPixmapPartHSV(&painter, pWaveform, nextCompletion);
+        } else { // Type::RGB:
+            drawNextPixmapPartRGB(&painter, pWaveform, nextCompletion);
+        }
+    };
+
+    if (m_previewDrawn && nextCompletion > m_actualCompletion) {
+        // Replace the preview with the analyzed data
+        painter.save();
+        painter.setCompositionMode(QPainter::CompositionMode_Clear);
+        painter.fillRect(QRectF(m_actualCompletion / 2,
+                                 -m_waveformSourceImage.height() / 2.0,
+                                 (nextCompletion - m_actualCompletion) / 2,
+                                 m_waveformSourceImage.height()),
+                Qt::transparent);
+        painter.restore();
+    }
+    drawPart(nextCompletion);
+    if (drawPreview) {
+        // The preview is drawn once and replaced while the analysis proceeds
+        const int actualCompletion = m_actualCompletion;
+        drawPart(dataSize);
+        m_actualCompletion = actualCompletion;
+        m_previewDrawn = true;
     }
 
     m_waveformImageScaled = QImage();
@@ -1675,6 +1863,8 @@ void WOverview::resizeEvent(QResizeEvent* pEvent) {
 
     m_waveformImageScaled = QImage();
     m_diffGain = 0;
+    m_bWaveformLayerDirty = true;
+    m_bMarksLayerDirty = true;
     Init();
 }
 
@@ -3,11 +3,13 @@
 #include <QColor>
 #include <QList>
 #include <QPixmap>
+#include <QTimer>
 
 #include "analyzer/analyzerprogress.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/parented_ptr.h"
+#include "util/performancetimer.h"
 #include "waveform/renderers/waveformmarkrange.h"
 #include "waveform/renderers/waveformmarkset.h"
 #include "waveform/renderers/waveformsignalcolors.h"
@@ -76,6 +78,9 @@ class WOverview : public WWidget, public TrackDropTarget {
     void slotTypeControlChanged(double v);
     void slotMinuteMarkersChanged(bool v);
     void slotNormalizeOrVisualGainChanged();
+    void slotRenderBudgetExceededChanged(bool exceeded);
+    void slotEngineBusyChanged(bool busy);
+    void slotUpdatePlayPosition();
 
   private:
     // Append the waveform overview pixmap according to available data
@@ -91,6 +96,12 @@ class WOverview : public WWidget, public TrackDropTarget {
             ConstWaveformPointer pWaveform,
             const int nextCompletion);
 
+    // The layers are cached until invalidated
+    void renderWaveformLayer();
+    void renderMarksLayer();
+    void invalidateWaveformLayer();
+    void invalidateMarksLayer();
+
     void drawEndOfTrackBackground(QPainter* pPainter);
     void drawAxis(QPainter* pPainter);
     void drawWaveformPixmap(QPainter* pPainter);
@@ -116,6 +127,13 @@ class WOverview : public WWidget, public TrackDropTarget {
 
     void updateCues(const QList<CuePointer> &loadedCues);
 
+    // Repaints for the moving play position are deferred while the
+    // scrolling waveforms need the GUI thread or the engine is busy
+    void updatePlayPosition(const QRect& dirtyRect);
+    void updateThrottleRepaints();
+    // The area that changes if the play position moves
+    QRect playPositionRect(int fromPos, int toPos) const;
+
     inline int length() {
         return m_orientation == Qt::Horizontal ? width() : height();
     }
@@ -155,6 +173,8 @@ class WOverview : public WWidget, public TrackDropTarget {
     Type m_type;
     int m_actualCompletion;
     bool m_pixmapDone;
+    // The coarse preview after the completion has been drawn
+    bool m_previewDrawn;
     float m_waveformPeak;
     float m_diffGain;
     qreal m_devicePixelRatio;
@@ -192,6 +212,15 @@ class WOverview : public WWidget, public TrackDropTarget {
     QImage m_waveformSourceImage;
     QImage m_waveformImageScaled;
 
+    // Everything below the played overlay: background, axis and waveform
+    QPixmap m_waveformLayer;
+    // Everything that doesn't move with the play position above the played
+    // overlay: minute markers, end of track frame, analyzer progress, mark
+    // ranges and mark lines. The labels are prerendered along with it.
+    QPixmap m_marksLayer;
+    bool m_bWaveformLayerDirty;
+    bool m_bMarksLayerDirty;
+
     WaveformSignalColors m_signalColors;
 
     parented_ptr<ControlProxy> m_endOfTrackControl;
@@ -227,4 +256,11 @@ class WOverview : public WWidget, public TrackDropTarget {
     std::vector<WaveformMarkRange> m_markRanges;
     WaveformMarkLabel m_cuePositionLabel;
     WaveformMarkLabel m_cueTimeDistanceLabel;
+
+    bool m_bRenderBudgetExceeded;
+    bool m_bEngineBusy;
+    bool m_bThrottleRepaints;
+    QTimer m_throttledUpdateTimer;
+    PerformanceTimer m_lastPaintTimer;
+    QRect m_dirtyPlayPositionRect;
 };
@@ -20,7 +20,12 @@ PaintablePointer WPixmapStore::getPaintable(const PixmapSource& source,
     // Attempt to find the cached Paintable using the generated key.
     auto it = m_paintableCache.find(key);
     if (it != m_paintableCache.end()) {
-        return it.value().lock();
+        PaintablePointer pPaintable = it.value().lock();
+        if (pPaintable) {
+            return pPaintable;
+        }
+        // All widgets that used it have been destroyed, e.g. after a skin
+        // reload
     }
 
     // If not found, create a new Paintable, cache it, and return it.
@@ -29,6 +29,8 @@ WSpinnyBase::WSpinnyBase(
           WBaseWidget(this),
           m_group(group),
           m_pConfig(pConfig),
+          m_iPendingRenders(0),
+          m_bSwapNeeded(false),
           m_pPlayPos(nullptr),
           m_pVisualPlayPos(nullptr),
           m_pTrackSamples(nullptr),
@@ -129,6 +131,7 @@ void WSpinnyBase::onVinylSignalQualityUpdate(const VinylSignalQualityReport& rep
 
     updateVinylSignalQualityImage(qual_color, report.scope);
     m_bDrawVinylSignalQuality = true;
+    requestRender();
 #else
     Q_UNUSED(report);
 #endif
@@ -173,6 +176,7 @@ void WSpinnyBase::setup(const QDomNode& node,
                 this,
                 [this](double v) {
                     m_bShowCover = v > 0.0;
+                    requestRender();
                 });
         m_bShowCover = m_pShowCoverProxy->get() > 0.0;
     } else {
@@ -238,6 +242,7 @@ void WSpinnyBase::setup(const QDomNode& node,
 void WSpinnyBase::setLoadedCover(const QPixmap& pixmap) {
     m_loadedCover = pixmap;
     m_loadedCoverScaled = scaleToSize(pixmap);
+    requestRender();
 }
 
 void WSpinnyBase::slotLoadTrack(TrackPointer pTrack) {
@@ -328,25 +333,45 @@ void WSpinnyBase::render(VSyncThread* vSyncThread) {
     }
 
     if (m_dAngleCurrentPlaypos != m_dAngleLastPlaypos) {
-        m_fAngle = static_cast<float>(calculateAngle(m_dAngleCurrentPlaypos));
+        const auto angle = static_cast<float>(calculateAngle(m_dAngleCurrentPlaypos));
+        if (angle != m_fAngle) {
+            m_fAngle = angle;
+            requestRender();
+        }
         m_dAngleLastPlaypos = m_dAngleCurrentPlaypos;
     }
 
     if (m_dGhostAngleCurrentPlaypos != m_dGhostAngleLastPlaypos) {
-        m_fGhostAngle = static_cast<float>(calculateAngle(m_dGhostAngleCurrentPlaypos));
+        const auto ghostAngle = static_cast<float>(
+                calculateAngle(m_dGhostAngleCurrentPlaypos));
+        if (ghostAngle != m_fGhostAngle) {
+            m_fGhostAngle = ghostAngle;
+            if (m_bGhostPlayback) {
+                requestRender();
+            }
+        }
         m_dGhostAngleLastPlaypos = m_dGhostAngleCurrentPlaypos;
     }
 
+    // A stopped deck is not redrawn
+    if (m_iPendingRenders == 0) {
+        return;
+    }
+
     draw();
+
+    m_iPendingRenders--;
+    m_bSwapNeeded = true;
 }
 
 void WSpinnyBase::swap() {
-    if (!shouldRender()) {
+    if (!m_bSwapNeeded || !shouldRender()) {
         return;
     }
     makeCurrentIfNeeded();
     swapBuffers();
     doneCurrent();
+    m_bSwapNeeded = false;
 }
 
 QImage WSpinnyBase::scaleToSize(const QImage& image) const {
@@ -381,6 +406,9 @@ void WSpinnyBase::resizeEvent(QResizeEvent* event) {
     m_ghostImageScaled = scaleToSize(m_pGhostImage);
 
     WGLWidget::resizeEvent(event);
+    // The window doesn't repaint a widget that is rendered with a shared
+    // context when resized
+    requestRender();
 }
 
 /* Convert between a normalized playback position (0.0 - 1.0) and an angle
@@ -488,6 +516,7 @@ void WSpinnyBase::updateVinylControlSignalEnabled(double enabled) {
         m_pVCManager->removeSignalQualityListener(this);
         m_bDrawVinylSignalQuality = false;
     }
+    requestRender();
 #else
     Q_UNUSED(enabled);
 #endif
@@ -495,10 +524,12 @@ void WSpinnyBase::updateVinylControlSignalEnabled(double enabled) {
 
 void WSpinnyBase::updateVinylControlEnabled(double enabled) {
     m_bVinylActive = enabled != 0;
+    requestRender();
 }
 
 void WSpinnyBase::updateSlipEnabled(double enabled) {
     m_bGhostPlayback = static_cast<bool>(enabled);
+    requestRender();
 }
 
 void WSpinnyBase::mouseMoveEvent(QMouseEvent* e) {
@@ -633,6 +664,8 @@ void WSpinnyBase::showEvent(QShowEvent* event) {
     }
 #endif
     WGLWidget::showEvent(event);
+    // Force a rerender when exposed (needed when using QOpenGL)
+    requestRender();
 }
 
 void WSpinnyBase::hideEvent(QHideEvent* event) {
@@ -88,6 +88,12 @@ class WSpinnyBase : public WGLWidget,
 
     bool shouldDrawVinylQuality() const;
 
+    // Redraw the widget at the next vsync, even if it hasn't been rotated
+    void requestRender() {
+        // 2 passes, in case triple buffering is used
+        m_iPendingRenders = 2;
+    }
+
   private:
     virtual void draw() = 0;
     virtual void coverChanged() = 0;
@@ -99,6 +105,9 @@ class WSpinnyBase : public WGLWidget,
     const QString m_group;
     UserSettingsPointer m_pConfig;
 
+    int m_iPendingRenders;
+    bool m_bSwapNeeded;
+
   protected:
     std::shared_ptr<QImage> m_pBgImage;
     std::shared_ptr<QImage> m_pMaskImage;
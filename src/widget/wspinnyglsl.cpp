@@ -1,6 +1,7 @@
 #include "widget/wspinnyglsl.h"
 
 #include <QOpenGLTexture>
+#include <algorithm>
 #include <array>
 
 #include "moc_wspinnyglsl.cpp"
@@ -11,7 +12,12 @@ WSpinnyGLSL::WSpinnyGLSL(
         UserSettingsPointer pConfig,
         VinylControlManager* pVCMan,
         BaseTrackPlayer* pPlayer)
-        : WSpinnyBase(parent, group, pConfig, pVCMan, pPlayer) {
+        : WSpinnyBase(parent, group, pConfig, pVCMan, pPlayer),
+          m_bCoverTextureDirty(false),
+          m_bVinylQualityTextureDirty(false) {
+#ifdef MIXXX_USE_QOPENGL
+    setRenderedWithGuiThreadContext(true);
+#endif
 }
 
 WSpinnyGLSL::~WSpinnyGLSL() {
@@ -30,17 +36,24 @@ void WSpinnyGLSL::cleanupGL() {
 }
 
 void WSpinnyGLSL::coverChanged() {
-    if (isContextValid()) {
-        makeCurrentIfNeeded();
-        m_loadedCoverTextureScaled.setData(m_loadedCoverScaled);
-        doneCurrent();
-    }
-    // otherwise this will happen in initializeGL
+    // Uploaded in draw(), or in initializeGL() if the context
+    // is not valid yet
+    m_bCoverTextureDirty = true;
 }
 
 void WSpinnyGLSL::draw() {
     if (shouldRender()) {
         makeCurrentIfNeeded();
+#ifdef MIXXX_USE_QOPENGL
+        resizeGLIfRequested();
+#endif
+        if (m_bCoverTextureDirty) {
+            m_loadedCoverTextureScaled.setData(m_loadedCoverScaled);
+            m_bCoverTextureDirty = false;
+        }
+        if (m_bVinylQualityTextureDirty) {
+            uploadVinylQualityTexture();
+        }
         paintGL();
         doneCurrent();
     }
@@ -63,33 +76,40 @@ void WSpinnyGLSL::updateTextures() {
     m_fgTextureScaled.setData(m_fgImageScaled);
     m_ghostTextureScaled.setData(m_ghostImageScaled);
     m_loadedCoverTextureScaled.setData(m_loadedCoverScaled);
+    m_bCoverTextureDirty = false;
 }
 
 void WSpinnyGLSL::setupVinylSignalQuality() {
+    m_vinylQualityData.resize(m_iVinylScopeSize * m_iVinylScopeSize);
 }
 
 void WSpinnyGLSL::updateVinylSignalQualityImage(
         const QColor& qual_color, const unsigned char* data) {
     m_vinylQualityColor = qual_color;
     m_vinylQualityColor.setAlphaF(0.75f);
-    if (m_qTexture.isStorageAllocated()) {
-        makeCurrentIfNeeded();
-        m_qTexture.bind();
-        // Using a texture of one byte per pixel so we can store the vinyl
-        // signal quality data directly. The VinylQualityShader will draw this
-        // colorized with alpha transparency.
-        glTexSubImage2D(GL_TEXTURE_2D,
-                0,
-                0,
-                0,
-                m_iVinylScopeSize,
-                m_iVinylScopeSize,
-                GL_RED,
-                GL_UNSIGNED_BYTE,
-                data);
-        m_qTexture.release();
-        doneCurrent();
+    std::copy(data, data + m_vinylQualityData.size(), m_vinylQualityData.begin());
+    m_bVinylQualityTextureDirty = true;
+}
+
+void WSpinnyGLSL::uploadVinylQualityTexture() {
+    if (!m_qTexture.isStorageAllocated() || m_vinylQualityData.empty()) {
+        return;
     }
+    m_qTexture.bind();
+    // Using a texture of one byte per pixel so we can store the vinyl
+    // signal quality data directly. The VinylQualityShader will draw this
+    // colorized with alpha transparency.
+    glTexSubImage2D(GL_TEXTURE_2D,
+            0,
+            0,
+            0,
+            m_iVinylScopeSize,
+            m_iVinylScopeSize,
+            GL_RED,
+            GL_UNSIGNED_BYTE,
+            m_vinylQualityData.data());
+    m_qTexture.release();
+    m_bVinylQualityTextureDirty = false;
 }
 
 void WSpinnyGLSL::paintGL() {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QOpenGLFunctions>
+#include <vector>
 
 #include "shaders/textureshader.h"
 #include "shaders/vinylqualityshader.h"
@@ -33,6 +34,7 @@ class WSpinnyGLSL : public WSpinnyBase, private QOpenGLFunctions {
     void setupVinylSignalQuality() override;
     void updateVinylSignalQualityImage(
             const QColor& qual_color, const unsigned char* data) override;
+    void uploadVinylQualityTexture();
     void drawVinylQuality();
 
     mixxx::TextureShader m_textureShader;
@@ -44,4 +46,9 @@ class WSpinnyGLSL : public WSpinnyBase, private QOpenGLFunctions {
     OpenGLTexture2D m_loadedCoverTextureScaled;
     OpenGLTexture2D m_qTexture;
     QColor m_vinylQualityColor;
+    // The textures are uploaded when drawing the next frame, which
+    // coalesces multiple updates between two frames
+    bool m_bCoverTextureDirty;
+    std::vector<unsigned char> m_vinylQualityData;
+    bool m_bVinylQualityTextureDirty;
 };
@@ -185,11 +185,18 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
                 horizontalHeader()->sortIndicatorOrder());
 
         if (restoreState) {
-            restoreCurrentViewState();
+            restoreCurrentViewStateWhenSelected();
         }
         return;
     }
 
+    // The rows of the previous model are no longer needed
+    auto* pPreviousSqlTableModel = dynamic_cast<BaseSqlTableModel*>(getTrackModel());
+    if (pPreviousSqlTableModel) {
+        pPreviousSqlTableModel->abortSelect();
+    }
+    disconnect(m_restoreViewStateConnection);
+
     setVisible(false);
 
     // Save the previous track model's header state
@@ -342,11 +349,27 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
 
     // trigger restoring scrollBar position, selection etc.
     if (restoreState) {
-        restoreCurrentViewState();
+        restoreCurrentViewStateWhenSelected();
     }
     initTrackMenu();
 }
 
+void WTrackTableView::restoreCurrentViewStateWhenSelected() {
+    disconnect(m_restoreViewStateConnection);
+    auto* pSqlTableModel = dynamic_cast<BaseSqlTableModel*>(model());
+    if (!pSqlTableModel || !pSqlTableModel->isSelecting()) {
+        restoreCurrentViewState();
+        return;
+    }
+    m_restoreViewStateConnection = connect(pSqlTableModel,
+            &BaseSqlTableModel::selectFinished,
+            this,
+            [this]() {
+                disconnect(m_restoreViewStateConnection);
+                restoreCurrentViewState();
+            });
+}
+
 void WTrackTableView::initTrackMenu() {
     auto* pTrackModel = getTrackModel();
     DEBUG_ASSERT(pTrackModel);
@@ -965,38 +988,20 @@ void WTrackTableView::moveRows(QList<int> selectedRowsIn, int destRow) {
         }
     }
 
-    if (destRow < firstSelRow) {
-        // If we're moving the tracks UP, reverse the order of the row selection
-        // to make the algorithm below work as it is
-        std::sort(selectedRows.begin(),
-                selectedRows.end(),
-                std::greater<int>());
-    } else { // Down
-        if (destRow > lastSelRow) {
-            // If we're moving the tracks DOWN, adjust the first row to reselect
-            selectionRestoreStartRow =
-                    selectionRestoreStartRow - selectedRowCount;
-        }
+    if (destRow > lastSelRow) {
+        // If we're moving the tracks DOWN, adjust the first row to reselect
+        selectionRestoreStartRow =
+                selectionRestoreStartRow - selectedRowCount;
     }
 
-    // For each row that needs to be moved...
-    while (!selectedRows.isEmpty()) {
-        int movedRow = selectedRows.takeFirst(); // Remember it's row index
-        // Move it
-        pTrackModel->moveTrack(model()->index(movedRow, 0), model()->index(destRow, 0));
-
-        // Move the row indices for rows that got bumped up
-        // into the void we left, or down because of the new spot
-        // we're taking.
-        for (int i = 0; i < selectedRows.count(); i++) {
-            if ((selectedRows[i] > movedRow) && ((destRow > selectedRows[i]))) {
-                selectedRows[i] = selectedRows[i] - 1;
-            } else if ((selectedRows[i] < movedRow) &&
-                    (destRow < selectedRows[i])) {
-                selectedRows[i] = selectedRows[i] + 1;
-            }
-        }
+    // Move all rows at once in front of the destination row, this
+    // keeps their order and refreshes the model only once
+    QModelIndexList movedIndices;
+    movedIndices.reserve(selectedRows.size());
+    for (const int row : std::as_const(selectedRows)) {
+        movedIndices.append(model()->index(row, 0));
     }
+    pTrackModel->moveTracks(movedIndices, model()->index(destRow, 0));
 
     // Set current index.
     // TODO If we moved down, pick the last selected row?
@@ -173,6 +173,10 @@ class WTrackTableView : public WLibraryTableView {
 
     void initTrackMenu();
 
+    // Delays restoring the view state until the rows of the model
+    // have been fetched in the background
+    void restoreCurrentViewStateWhenSelected();
+
     void hideOrRemoveSelectedTracks();
 
     const UserSettingsPointer m_pConfig;
@@ -196,4 +200,6 @@ class WTrackTableView : public WLibraryTableView {
     ControlProxy* m_pKeyNotation;
     ControlProxy* m_pSortColumn;
     ControlProxy* m_pSortOrder;
+
+    QMetaObject::Connection m_restoreViewStateConnection;
 };
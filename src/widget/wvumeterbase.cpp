@@ -88,6 +88,10 @@ void WVuMeterBase::setup(const QDomNode& node, const SkinContext& context) {
     }
 
     setFocusPolicy(Qt::NoFocus);
+
+    // The engine updates the level continuously. It is read once per
+    // rendered frame instead of queuing a signal for each update.
+    pollDisplayConnection();
 }
 
 void WVuMeterBase::setPixmapBackground(
@@ -176,6 +180,13 @@ void WVuMeterBase::showEvent(QShowEvent* e) {
     m_iPendingRenders = 2;
 }
 
+void WVuMeterBase::resizeEvent(QResizeEvent* e) {
+    WGLWidget::resizeEvent(e);
+    // The window doesn't repaint a widget that is rendered with a shared
+    // context when resized
+    m_iPendingRenders = 2;
+}
+
 void WVuMeterBase::render(VSyncThread* vSyncThread) {
     if (!shouldRender()) {
         return;
@@ -183,6 +194,7 @@ void WVuMeterBase::render(VSyncThread* vSyncThread) {
 
     ScopedTimer t(QStringLiteral("WVuMeterBase::render"));
 
+    onConnectedControlChanged(getControlParameterDisplay(), 0.0);
     updateState(vSyncThread->sinceLastSwap());
 
     if (m_dParameter != m_dLastParameter || m_dPeakParameter != m_dLastPeakParameter) {
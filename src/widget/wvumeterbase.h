@@ -39,6 +39,7 @@ class WVuMeterBase : public WGLWidget, public WBaseWidget {
 
     void paintEvent(QPaintEvent* /*unused*/) override;
     void showEvent(QShowEvent* /*unused*/) override;
+    void resizeEvent(QResizeEvent* e) override;
     void setPeak(double parameter);
     void renderQPainter();
 
@@ -9,6 +9,9 @@
 
 WVuMeterGLSL::WVuMeterGLSL(QWidget* pParent)
         : WVuMeterBase(pParent) {
+#ifdef MIXXX_USE_QOPENGL
+    setRenderedWithGuiThreadContext(true);
+#endif
 }
 
 WVuMeterGLSL::~WVuMeterGLSL() {
@@ -18,6 +21,9 @@ WVuMeterGLSL::~WVuMeterGLSL() {
 void WVuMeterGLSL::draw() {
     if (shouldRender()) {
         makeCurrentIfNeeded();
+#ifdef MIXXX_USE_QOPENGL
+        resizeGLIfRequested();
+#endif
         paintGL();
         doneCurrent();
     }
@@ -74,6 +74,10 @@ void WVuMeterLegacy::setup(const QDomNode& node, const SkinContext& context) {
     }
 
     setFocusPolicy(Qt::NoFocus);
+
+    // The engine updates the level continuously. It is read once per GUI
+    // tick instead of queuing a signal for each update.
+    pollDisplayConnection();
 }
 
 void WVuMeterLegacy::setPixmapBackground(
@@ -147,6 +151,8 @@ void WVuMeterLegacy::updateState(mixxx::Duration elapsed) {
 }
 
 void WVuMeterLegacy::maybeUpdate() {
+    // Also lets the peak fall while the level doesn't change
+    onConnectedControlChanged(getControlParameterDisplay(), 0.0);
     if (m_dParameter != m_dLastParameter || m_dPeakParameter != m_dLastPeakParameter) {
         repaint();
     }
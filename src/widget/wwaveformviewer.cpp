@@ -54,6 +54,12 @@ void WWaveformViewer::setup(const QDomNode& node, const SkinContext& context) {
     }
 }
 
+bool WWaveformViewer::event(QEvent* pEvent) {
+    // The event handlers modify the waveform widget
+    const auto locked = WaveformWidgetFactory::instance()->lockRendering();
+    return WWidget::event(pEvent);
+}
+
 void WWaveformViewer::resizeEvent(QResizeEvent* event) {
     Q_UNUSED(event);
     if (m_waveformWidget) {
@@ -222,6 +228,7 @@ void WWaveformViewer::leaveEvent(QEvent*) {
 }
 
 void WWaveformViewer::slotTrackLoaded(TrackPointer track) {
+    const auto locked = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setTrack(track);
     }
@@ -229,6 +236,7 @@ void WWaveformViewer::slotTrackLoaded(TrackPointer track) {
 
 #ifdef __STEM__
 void WWaveformViewer::slotSelectStem(mixxx::StemChannelSelection stemMask) {
+    const auto locked = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->selectStem(stemMask);
         update();
@@ -243,12 +251,14 @@ void WWaveformViewer::slotTrackUnloaded(TrackPointer pOldTrack) {
 void WWaveformViewer::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack) {
     Q_UNUSED(pNewTrack);
     Q_UNUSED(pOldTrack);
+    const auto locked = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setTrack(TrackPointer());
     }
 }
 
 void WWaveformViewer::onZoomChange(double zoom) {
+    const auto locked = WaveformWidgetFactory::instance()->lockRendering();
     //qDebug() << "WaveformWidgetRenderer::onZoomChange" << this << zoom;
     setZoom(zoom);
     // notify back the factory to sync zoom if needed
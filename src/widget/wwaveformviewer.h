@@ -50,6 +50,7 @@ class WWaveformViewer : public WWidget, public TrackDropTarget {
 #endif
 
   protected:
+    bool event(QEvent* pEvent) override;
     void showEvent(QShowEvent* event) override;
     void resizeEvent(QResizeEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
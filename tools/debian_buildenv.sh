@@ -62,7 +62,6 @@ case "$1" in
             libbenchmark-dev \
             libchromaprint-dev \
             libdistro-info-perl \
-            libebur128-dev \
             libfaad-dev \
             libfftw3-dev \
             libflac-dev \
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Compares the results of the engine benchmarks against a baseline and fails if
+a scenario got slower than the given tolerance. Both files are written by
+
+    mixxx-test --benchmark --benchmark_filter=BM_Engine \
+        --benchmark_out=<file> --benchmark_out_format=json
+
+The durations depend on the machine, so the baseline must be recorded on the
+same machine, e.g. from the last release.
+"""
+import argparse
+import json
+import sys
+
+COUNTERS = ("mean_us", "p99_us")
+
+
+def load_results(path):
+    """returns the counters of the engine benchmarks by benchmark name"""
+    with open(path) as f:
+        data = json.load(f)
+    results = {}
+    for benchmark in data.get("benchmarks", []):
+        name = benchmark.get("name", "")
+        if not name.startswith("BM_Engine/") or benchmark.get("error_occurred"):
+            continue
+        results[name] = {
+            counter: benchmark[counter]
+            for counter in COUNTERS
+            if counter in benchmark
+        }
+    return results
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().split("\n")[0])
+    parser.add_argument("baseline", help="JSON output of the baseline run")
+    parser.add_argument("current", help="JSON output of the current run")
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=10.0,
+        help="allowed slowdown in percent (default: %(default)s)",
+    )
+    args = parser.parse_args(argv)
+
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+    if not current:
+        print("No engine benchmark results in %s" % args.current)
+        return 1
+
+    regressions = 0
+    for name in sorted(current):
+        if name not in baseline:
+            print("%s: no baseline" % name)
+            continue
+        for counter in COUNTERS:
+            if counter not in baseline[name] or counter not in current[name]:
+                continue
+            old = baseline[name][counter]
+            new = current[name][counter]
+            change = 100.0 * (new - old) / old if old > 0 else 0.0
+            regressed = change > args.tolerance
+            regressions += regressed
+            print(
+                "%s %s: %.1f -> %.1f (%+.1f %%)%s"
+                % (
+                    name,
+                    counter,
+                    old,
+                    new,
+                    change,
+                    " REGRESSION" if regressed else "",
+                )
+            )
+    for name in sorted(set(baseline) - set(current)):
+        print("%s: missing in the current results" % name)
+        regressions += 1
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
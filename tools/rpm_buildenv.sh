@@ -42,7 +42,6 @@ case "$1" in
             hidapi-devel \
             lame-devel \
             libchromaprint-devel \
-            libebur128-devel \
             libid3tag-devel \
             libmad-devel \
             libmodplug-devel \